@@ -325,6 +325,7 @@ void timecoder_init(struct timecoder *tc, struct timecode_def *def,
     tc->timecode = 0;
     tc->valid_counter = 0;
     tc->timecode_ticker = 0;
+    tc->lookup_valid = false;
 
     tc->mon = NULL;
 }
@@ -579,6 +580,7 @@ void timecoder_cycle_definition(struct timecoder *tc)
     tc->def = next_definition(tc->def);
     tc->valid_counter = 0;
     tc->timecode_ticker = 0;
+    tc->lookup_valid = false;
 }
 
 /*
@@ -589,24 +591,25 @@ void timecoder_cycle_definition(struct timecoder *tc)
 
 void timecoder_submit(struct timecoder *tc, signed short *pcm, size_t npcm)
 {
-    while (npcm--) {
-	signed int left, right, primary, secondary;
-
-        left = pcm[0] << 16;
-        right = pcm[1] << 16;
-
-        if (tc->def->flags & SWITCH_PRIMARY) {
-            primary = left;
-            secondary = right;
-        } else {
-            primary = right;
-            secondary = left;
+    /* The channel order and the monitor do not change within a block,
+     * so keep these checks out of the per-sample loop */
+
+    const int primary_offset = (tc->def->flags & SWITCH_PRIMARY) ? 0 : 1;
+    const int secondary_offset = 1 - primary_offset;
+
+    if (tc->mon) {
+        while (npcm--) {
+            process_sample(tc, pcm[primary_offset] << 16,
+                           pcm[secondary_offset] << 16);
+            update_monitor(tc, pcm[0] << 16, pcm[1] << 16);
+            pcm += TIMECODER_CHANNELS;
+        }
+    } else {
+        while (npcm--) {
+            process_sample(tc, pcm[primary_offset] << 16,
+                           pcm[secondary_offset] << 16);
+            pcm += TIMECODER_CHANNELS;
         }
-
-	process_sample(tc, primary, secondary);
-        update_monitor(tc, left, right);
-
-        pcm += TIMECODER_CHANNELS;
     }
 }
 
@@ -629,7 +632,18 @@ signed int timecoder_get_position(struct timecoder *tc, double *when)
     if (tc->valid_counter <= VALID_BITS)
         return -1;
 
-    r = lut_lookup(&tc->def->lut, tc->bitstream);
+    /* The position is polled once per block, but the bitstream changes
+     * only once per timecode cycle, so avoid walking the hash chain for
+     * an unchanged bitstream */
+
+    if (tc->lookup_valid && tc->lookup_bitstream == tc->bitstream) {
+        r = tc->lookup_position;
+    } else {
+        r = lut_lookup(&tc->def->lut, tc->bitstream);
+        tc->lookup_bitstream = tc->bitstream;
+        tc->lookup_position = r;
+        tc->lookup_valid = true;
+    }
     if (r == -1)
         return -1;
 
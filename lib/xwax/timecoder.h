@@ -76,6 +76,12 @@ struct timecoder {
     unsigned int valid_counter, /* number of successful error checks */
         timecode_ticker; /* samples since valid timecode was read */
 
+    /* Cache of the last position lookup */
+
+    bool lookup_valid;
+    bits_t lookup_bitstream;
+    signed int lookup_position;
+
     /* Feedback */
 
     unsigned char *mon; /* x-y array */
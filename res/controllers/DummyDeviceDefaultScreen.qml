@@ -40,6 +40,9 @@ Item {
     }
 
     // function transformFrame(input: ArrayBuffer, timestamp: date) {
+    // Devices that support partial updates can declare a third parameter
+    // that receives the rectangle of the pixels changed since the last frame:
+    // function transformFrame(input: ArrayBuffer, timestamp: date, damage: rect) {
     function transformFrame(input, timestamp) {
         return new ArrayBuffer(0);
     }
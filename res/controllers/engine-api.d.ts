@@ -290,4 +290,14 @@ declare namespace engine {
      *               SoftStart with low factors would take a while until sound is audible. [default = 1.0]
      */
     function softStart(deck: number, activate: boolean, factor?: number): void;
+
+    /**
+     * Skips incoming data packets that are identical to the previous packet,
+     * so that the incomingData function is only called if a byte changed.
+     * This is useful for HID and bulk controllers that send their whole state
+     * at a high rate.
+     *
+     * @param skip Set true to skip unchanged incoming data packets
+     */
+    function skipUnchangedIncomingData(skip: boolean): void;
 }
@@ -67,6 +67,28 @@ declare namespace controller {
      */
     function sendOutputReport(reportID: number, dataArray: ArrayBuffer, useNonSkippingFIFO?: boolean): void;
 
+    /**
+     * Sets the priority of the cached OutputReports with this ReportID
+     *
+     * Changed reports of a higher priority are sent first, e.g. to prevent
+     * the displays of jog wheels from delaying button LEDs.
+     * Reports sent with useNonSkippingFIFO are always sent first.
+     *
+     *  @param reportID 1...255 for HID devices that uses ReportIDs - or 0 for devices, which don't use ReportIDs
+     *  @param priority 0 (low), 1 (normal, default) or 2 (high)
+     */
+    function setOutputReportPriority(reportID: number, priority: number): void;
+
+    /**
+     * Limits the bandwidth of the cached OutputReports
+     *
+     * Devices that are flooded with OutputReports may delay their InputReports.
+     * Reports sent with useNonSkippingFIFO are not limited.
+     *
+     *  @param bytesPerSecond Bytes per second including the ReportIDs, 0 for no limit (default)
+     */
+    function setOutputBandwidth(bytesPerSecond: number): void;
+
     /**
      * getInputReport receives an InputReport from the HID device on request.
      *
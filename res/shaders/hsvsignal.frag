@@ -0,0 +1,84 @@
+#version 120
+
+uniform vec2 framebufferSize;
+uniform vec4 axesColor;
+uniform float baseColorHue;
+
+uniform int waveformLength;
+uniform int textureSize;
+uniform int textureStride;
+
+uniform float allGain;
+uniform float firstVisualIndex;
+uniform float lastVisualIndex;
+
+uniform sampler2D waveformDataTexture;
+
+vec4 getWaveformData(float index) {
+    vec2 uv_data;
+    uv_data.y = floor(index / float(textureStride));
+    uv_data.x = floor(index - uv_data.y * float(textureStride));
+    // Divide again to convert to normalized UV coordinates.
+    return texture2D(waveformDataTexture, uv_data / float(textureStride));
+}
+
+vec3 hsv2rgb(vec3 c) {
+    vec4 K = vec4(1.0, 2.0 / 3.0, 1.0 / 3.0, 3.0);
+    vec3 p = abs(fract(c.xxx + K.xyz) * 6.0 - K.www);
+    return c.z * mix(K.xxx, clamp(p - K.xxx, 0.0, 1.0), c.y);
+}
+
+void main(void) {
+    vec2 uv = gl_TexCoord[0].st;
+    vec4 pixel = gl_FragCoord;
+
+    float new_currentIndex = floor(firstVisualIndex + uv.x *
+                                   (lastVisualIndex - firstVisualIndex)) * 2;
+
+    vec4 outputColor = vec4(0.0, 0.0, 0.0, 0.0);
+    bool showing = false;
+    vec4 showingColor = vec4(0.0, 0.0, 0.0, 0.0);
+
+    // We don't exit early if the waveform data is not valid because we may want
+    // to show other things (e.g. the axes lines) even when we are on a pixel
+    // that does not have valid waveform data.
+    if (new_currentIndex >= 0 && new_currentIndex <= waveformLength - 2) {
+      vec4 leftData = getWaveformData(new_currentIndex);
+      vec4 rightData = getWaveformData(new_currentIndex + 1);
+
+      // Texture coordinates put (0,0) at the bottom left, so show the right
+      // channel if we are in the bottom half.
+      float signalAll = (uv.y < 0.5 ? rightData.w : leftData.w) * allGain;
+
+      // Represents the [-1, 1] distance of this pixel.
+      float ourDistance = abs((uv.y - 0.5) * 2.0);
+      showing = (signalAll - ourDistance) >= 0.0;
+
+      // Like the CPU renderer, the low and the high band reduce the value
+      // and the saturation of the base color. The sum is multiplied by 1.2
+      // to prevent very dark or light colors.
+      float lo = 0.0;
+      float hi = 0.0;
+      if (leftData.w != 0.0 && rightData.w != 0.0) {
+        float total = (leftData.x + rightData.x + leftData.y + rightData.y +
+                       leftData.z + rightData.z) * 1.2;
+        if (total != 0.0) {
+          lo = (leftData.x + rightData.x) / total;
+          hi = (leftData.z + rightData.z) / total;
+        }
+      }
+      showingColor.xyz = hsv2rgb(vec3(baseColorHue, 1.0 - hi, 1.0 - lo));
+      showingColor.w = 1.0;
+    }
+
+    // Draw the axes color as the lowest item on the screen.
+    if (abs(framebufferSize.y / 2 - pixel.y) <= 4) {
+      outputColor.xyz = mix(outputColor.xyz, axesColor.xyz, axesColor.w);
+      outputColor.w = 1.0;
+    }
+
+    if (showing) {
+      outputColor = showingColor;
+    }
+    gl_FragColor = outputColor;
+}
@@ -0,0 +1,149 @@
+#include "analyzer/analysisresultwriter.h"
+
+#include <chrono>
+
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/db/sqltransaction.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalysisResultWriter");
+
+} // anonymous namespace
+
+AnalysisResultWriter::AnalysisResultWriter(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        UserSettingsPointer pConfig)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(std::move(pConfig)),
+          m_stop(false),
+          m_unavailable(false) {
+    DEBUG_ASSERT(m_pDbConnectionPool);
+}
+
+AnalysisResultWriter::~AnalysisResultWriter() {
+    {
+        std::lock_guard<std::mutex> locked(m_mutex);
+        m_stop = true;
+    }
+    m_waitCond.notify_one();
+    wait();
+}
+
+void AnalysisResultWriter::saveTrackAnalyses(
+        TrackId trackId,
+        ConstWaveformPointer pWaveform,
+        ConstWaveformPointer pWaveSummary) {
+    // Claim the waveforms now, otherwise TrackDAO could save them again
+    // on the main thread while the write is pending
+    if (!AnalysisDao::tryBeginSaveTrackAnalyses(pWaveform, pWaveSummary)) {
+        return;
+    }
+    enqueueWrite([trackId, pWaveform, pWaveSummary](AnalysisDao* pAnalysisDao) {
+        if (!pAnalysisDao) {
+            // Leave them to TrackDAO
+            pWaveform->finishSave(false);
+            pWaveSummary->finishSave(false);
+            return;
+        }
+        pAnalysisDao->saveClaimedTrackAnalyses(trackId, pWaveform, pWaveSummary);
+    });
+}
+
+void AnalysisResultWriter::saveAnalyzerResult(
+        TrackId trackId,
+        const QString& analyzer,
+        const AnalysisDao::AnalyzerResultInfo& result) {
+    enqueueWrite([trackId, analyzer, result](AnalysisDao* pAnalysisDao) {
+        if (pAnalysisDao) {
+            pAnalysisDao->saveAnalyzerResult(trackId, analyzer, result);
+        }
+    });
+}
+
+void AnalysisResultWriter::enqueueWrite(Write write) {
+    bool notify;
+    {
+        std::unique_lock<std::mutex> locked(m_mutex);
+        DEBUG_ASSERT(!m_stop);
+        if (m_unavailable) {
+            locked.unlock();
+            write(nullptr);
+            return;
+        }
+        m_pendingWrites.push_back(std::move(write));
+        // Wake up the thread for the first write to start the commit
+        // delay and when the transaction is full
+        notify = m_pendingWrites.size() == 1 ||
+                m_pendingWrites.size() >= static_cast<size_t>(kMaxWritesPerTransaction);
+    }
+    if (notify) {
+        m_waitCond.notify_one();
+    }
+}
+
+void AnalysisResultWriter::run() {
+    // The thread-local database connection  must not be closed
+    // before returning from this function.
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    if (!dbConnectionPooler.isPooling()) {
+        // The waveforms remain pending and are saved together with the track
+        kLogger.warning()
+                << "Failed to obtain database connection for storing analysis results";
+        std::vector<Write> writes;
+        {
+            std::lock_guard<std::mutex> locked(m_mutex);
+            m_unavailable = true;
+            writes.swap(m_pendingWrites);
+        }
+        for (const auto& write : writes) {
+            write(nullptr);
+        }
+        return;
+    }
+    const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    AnalysisDao analysisDao(m_pConfig);
+    analysisDao.initialize(dbConnection);
+
+    std::unique_lock<std::mutex> locked(m_mutex);
+    while (true) {
+        m_waitCond.wait(locked, [this] {
+            return m_stop || !m_pendingWrites.empty();
+        });
+        if (m_pendingWrites.empty()) {
+            DEBUG_ASSERT(m_stop);
+            break;
+        }
+        // Collect more writes for the same transaction
+        m_waitCond.wait_for(locked,
+                std::chrono::microseconds(kMaxCommitDelay.toIntegerMicros()),
+                [this] {
+                    return m_stop ||
+                            m_pendingWrites.size() >=
+                            static_cast<size_t>(kMaxWritesPerTransaction);
+                });
+        std::vector<Write> writes;
+        writes.swap(m_pendingWrites);
+        locked.unlock();
+
+        SqlTransaction transaction(dbConnection);
+        for (const auto& write : writes) {
+            write(&analysisDao);
+        }
+        if (!transaction.commit()) {
+            kLogger.warning()
+                    << "Failed to commit"
+                    << writes.size()
+                    << "analysis results";
+        } else {
+            kLogger.debug()
+                    << "Committed"
+                    << writes.size()
+                    << "analysis results";
+        }
+
+        locked.lock();
+    }
+}
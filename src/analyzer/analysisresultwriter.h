@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QThread>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "library/dao/analysisdao.h"
+#include "preferences/usersettings.h"
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+#include "util/duration.h"
+#include "waveform/waveform.h"
+
+/// AnalysisResultWriter stores the results of an analyzer thread in the
+/// background and groups them into a few database transactions.
+///
+/// Committing each track separately lets the fsync of the database file
+/// dominate batch analysis on slow storage like SD cards or USB drives.
+/// Pending writes are collected for up to kMaxCommitDelay or until
+/// kMaxWritesPerTransaction writes are pending and then committed at once
+/// by a dedicated thread with its own database connection.
+class AnalysisResultWriter : public QThread {
+  public:
+    static constexpr int kMaxWritesPerTransaction = 64;
+    static constexpr mixxx::Duration kMaxCommitDelay = mixxx::Duration::fromSeconds(2);
+
+    AnalysisResultWriter(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            UserSettingsPointer pConfig);
+    /// Commits all pending writes before returning.
+    ~AnalysisResultWriter() override;
+
+    /// Schedules the waveforms for saving, see
+    /// AnalysisDao::saveTrackAnalyses().
+    void saveTrackAnalyses(
+            TrackId trackId,
+            ConstWaveformPointer pWaveform,
+            ConstWaveformPointer pWaveSummary);
+
+    /// Schedules the result info for saving, see
+    /// AnalysisDao::saveAnalyzerResult().
+    void saveAnalyzerResult(
+            TrackId trackId,
+            const QString& analyzer,
+            const AnalysisDao::AnalyzerResultInfo& result);
+
+  protected:
+    void run() override;
+
+  private:
+    // Invoked with nullptr if the write is discarded
+    typedef std::function<void(AnalysisDao* pAnalysisDao)> Write;
+
+    void enqueueWrite(Write write);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
+
+    std::mutex m_mutex;
+    std::condition_variable m_waitCond;
+    std::vector<Write> m_pendingWrites;
+    bool m_stop;
+    // Set if the thread could not connect to the database
+    bool m_unavailable;
+};
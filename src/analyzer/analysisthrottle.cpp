@@ -0,0 +1,90 @@
+#include "analyzer/analysisthrottle.h"
+
+#include "moc_analysisthrottle.cpp"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalysisThrottle");
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+constexpr int kPollIntervalMillis = 250;
+
+} // anonymous namespace
+
+AnalysisThrottle::AnalysisThrottle(QObject* pParent)
+        : QObject(pParent),
+          m_audioLatencyUsage(kAppGroup,
+                  QStringLiteral("audio_latency_usage"),
+                  ControlFlag::AllowMissingOrInvalid),
+          m_audioLatencyOverloadCount(kAppGroup,
+                  QStringLiteral("audio_latency_overload_count"),
+                  ControlFlag::AllowMissingOrInvalid),
+          m_lastOverloadCount(-1),
+          m_paused(false) {
+    m_pollTimer.setInterval(kPollIntervalMillis);
+    connect(&m_pollTimer,
+            &QTimer::timeout,
+            this,
+            &AnalysisThrottle::slotPoll);
+}
+
+void AnalysisThrottle::start() {
+    m_clock.start();
+    m_pollTimer.start();
+}
+
+void AnalysisThrottle::stop() {
+    m_pollTimer.stop();
+    m_lastOverloadCount = -1;
+    m_pausedUntil = mixxx::Duration::empty();
+    m_delayPerChunk = mixxx::Duration::empty();
+    m_paused = false;
+}
+
+void AnalysisThrottle::slotPoll() {
+    update(m_audioLatencyUsage.get(),
+            static_cast<int>(m_audioLatencyOverloadCount.get()),
+            m_clock.elapsed());
+}
+
+void AnalysisThrottle::update(
+        double audioLatencyUsage,
+        int overloadCount,
+        mixxx::Duration now) {
+    // Only underflows that occur while watching are taken into account.
+    // The counter is reset when the sound devices are reopened.
+    if (m_lastOverloadCount >= 0 && overloadCount > m_lastOverloadCount) {
+        m_pausedUntil = now + kPauseAfterOverload;
+    }
+    m_lastOverloadCount = overloadCount;
+
+    mixxx::Duration delayPerChunk = m_delayPerChunk;
+    if (audioLatencyUsage > kHighLatencyUsage) {
+        delayPerChunk = delayPerChunk < kMinDelayPerChunk
+                ? kMinDelayPerChunk
+                : delayPerChunk * 2;
+        if (delayPerChunk > kMaxDelayPerChunk) {
+            delayPerChunk = kMaxDelayPerChunk;
+        }
+    } else if (audioLatencyUsage < kLowLatencyUsage) {
+        delayPerChunk = mixxx::Duration::fromMicros(delayPerChunk.toIntegerMicros() / 2);
+        if (delayPerChunk < kMinDelayPerChunk) {
+            delayPerChunk = mixxx::Duration::empty();
+        }
+    }
+    const bool paused = now < m_pausedUntil;
+
+    if (delayPerChunk == m_delayPerChunk && paused == m_paused) {
+        return;
+    }
+    if (paused && !m_paused) {
+        kLogger.info() << "Pausing analysis after audio buffer underflow";
+    } else if (!paused && m_paused) {
+        kLogger.info() << "Continuing paused analysis";
+    }
+    m_delayPerChunk = delayPerChunk;
+    m_paused = paused;
+    emit throttleChanged(m_delayPerChunk, m_paused);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+#include "control/pollingcontrolproxy.h"
+#include "util/duration.h"
+#include "util/performancetimer.h"
+
+/// AnalysisThrottle watches the headroom of the audio callback and slows
+/// down or pauses a batch analysis while the audio engine is busy, so
+/// tracks can be analyzed during a live set without risking xruns.
+///
+/// While the audio callback uses more than kHighLatencyUsage of its time
+/// budget, the analyzer threads wait for a growing delay after each chunk.
+/// If a buffer underflow is detected the analysis is paused entirely for
+/// kPauseAfterOverload.
+class AnalysisThrottle : public QObject {
+    Q_OBJECT
+  public:
+    static constexpr double kHighLatencyUsage = 0.7;
+    static constexpr double kLowLatencyUsage = 0.5;
+    static constexpr mixxx::Duration kMinDelayPerChunk = mixxx::Duration::fromMillis(2);
+    static constexpr mixxx::Duration kMaxDelayPerChunk = mixxx::Duration::fromMillis(50);
+    static constexpr mixxx::Duration kPauseAfterOverload = mixxx::Duration::fromSeconds(10);
+
+    explicit AnalysisThrottle(QObject* pParent = nullptr);
+    ~AnalysisThrottle() override = default;
+
+    /// Starts watching the audio engine periodically.
+    void start();
+    /// Stops watching and resets the throttle.
+    void stop();
+
+    /// Updates the throttle from the current measurements and emits
+    /// throttleChanged() on changes. Invoked periodically after start().
+    void update(double audioLatencyUsage, int overloadCount, mixxx::Duration now);
+
+    mixxx::Duration delayPerChunk() const {
+        return m_delayPerChunk;
+    }
+
+    bool isPaused() const {
+        return m_paused;
+    }
+
+  signals:
+    void throttleChanged(mixxx::Duration delayPerChunk, bool paused);
+
+  private slots:
+    void slotPoll();
+
+  private:
+    PollingControlProxy m_audioLatencyUsage;
+    PollingControlProxy m_audioLatencyOverloadCount;
+
+    QTimer m_pollTimer;
+    PerformanceTimer m_clock;
+
+    int m_lastOverloadCount;
+    mixxx::Duration m_pausedUntil;
+
+    mixxx::Duration m_delayPerChunk;
+    bool m_paused;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QString>
+
 #include "analyzer/analyzertrack.h"
 #include "audio/signalinfo.h"
 #include "audio/types.h"
@@ -34,6 +36,16 @@ class Analyzer {
     // but not finalize()!
     virtual bool processSamples(const CSAMPLE* pIn, SINT count) = 0;
 
+    // Analyze the next chunk of audio samples like processSamples().
+    // pDownmix contains a mono downmix of the same chunk with one value
+    // per frame, which is shared by all analyzers of a track. Analyzers
+    // that work on a mono signal should override this function to avoid
+    // downmixing the samples again.
+    virtual bool processDownmixedSamples(
+            const CSAMPLE* pIn, const double* /*pDownmix*/, SINT count) {
+        return processSamples(pIn, count);
+    }
+
     // Update the track object with the analysis results after
     // processing finished successfully, i.e. all available audio
     // samples have been processed.
@@ -43,6 +55,18 @@ class Analyzer {
     // This function will be invoked after the results have been
     // stored or if processing aborted preliminary.
     virtual void cleanup() = 0;
+
+    // Analyzers that store results without a version of their own return
+    // a name and the current version for them. AnalyzerThread records the
+    // version per track and marks the results as outdated in AnalyzerTrack
+    // if they have been computed by a different version or from a different
+    // signal, so initialize() can decide to replace them.
+    virtual QString resultName() const {
+        return QString();
+    }
+    virtual QString resultVersion() const {
+        return QString();
+    }
 };
 
 typedef std::unique_ptr<Analyzer> AnalyzerPtr;
@@ -66,6 +90,14 @@ class AnalyzerWithState final {
         return m_active;
     }
 
+    QString resultName() const {
+        return m_analyzer->resultName();
+    }
+
+    QString resultVersion() const {
+        return m_analyzer->resultVersion();
+    }
+
     bool initialize(const AnalyzerTrack& track,
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) {
@@ -73,9 +105,10 @@ class AnalyzerWithState final {
         return m_active = m_analyzer->initialize(track, sampleRate, frameLength);
     }
 
-    void processSamples(const CSAMPLE* pIn, const int count) {
+    void processSamples(const CSAMPLE* pIn, const double* pDownmix, const int count) {
+        DEBUG_ASSERT(pDownmix);
         if (m_active) {
-            m_active = m_analyzer->processSamples(pIn, count);
+            m_active = m_analyzer->processDownmixedSamples(pIn, pDownmix, count);
             if (!m_active) {
                 // Ensure that cleanup() is invoked after processing
                 // failed and the analyzer became inactive!
@@ -5,6 +5,7 @@
 #include <QVector>
 #include <QtDebug>
 
+#include "analyzer/analyzerbeatspreview.h"
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "analyzer/plugins/analyzerqueenmarybeats.h"
@@ -144,6 +145,11 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
     if (!pBeats) {
         return true;
     }
+    if (AnalyzerBeatsPreview::isPreview(*pBeats)) {
+        // Provisional beat grids are always refined, independent of the
+        // preference settings
+        return true;
+    }
     if (!pBeats->getBpmInRange(mixxx::audio::kStartFramePos,
                        mixxx::audio::FramePos{
                                pTrack->getDuration() * pBeats->getSampleRate()})
@@ -195,6 +201,11 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
+    return processDownmixedSamples(pIn, nullptr, count);
+}
+
+bool AnalyzerBeats::processDownmixedSamples(
+        const CSAMPLE* pIn, const double* pDownmix, SINT count) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
@@ -204,7 +215,10 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
         return true; // silently ignore all remaining samples
     }
 
-    return m_pPlugin->processSamples(pIn, count);
+    if (!pDownmix) {
+        return m_pPlugin->processSamples(pIn, count);
+    }
+    return m_pPlugin->processDownmixedSamples(pIn, pDownmix, count);
 }
 
 void AnalyzerBeats::cleanup() {
@@ -245,7 +259,15 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
         pBeats = mixxx::Beats::fromConstTempo(m_sampleRate, mixxx::audio::kStartFramePos, bpm);
     }
 
-    pTrack->trySetBeats(pBeats);
+    const mixxx::BeatsPointer pPreviewBeats = pTrack->getBeats();
+    if (pTrack->trySetBeats(pBeats) && pPreviewBeats &&
+            AnalyzerBeatsPreview::isPreview(*pPreviewBeats)) {
+        qDebug() << "AnalyzerBeats refined provisional BPM"
+                 << pPreviewBeats->getBpmInRange(mixxx::audio::kStartFramePos,
+                            mixxx::audio::FramePos{
+                                    pTrack->getDuration() *
+                                    pPreviewBeats->getSampleRate()});
+    }
 }
 
 // static
@@ -0,0 +1,119 @@
+#include "analyzer/analyzerbeatspreview.h"
+
+#include <soundtouch/BPMDetect.h>
+
+#include <QHash>
+#include <QStringList>
+
+#include "analyzer/constants.h"
+#include "analyzer/plugins/analyzersoundtouchbeats.h"
+#include "sources/audiosourcestereoproxy.h"
+#include "track/beatfactory.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalyzerBeatsPreview");
+
+const QString kPreviewSubVersionFragment = QStringLiteral("preview=1");
+
+QString previewSubVersion() {
+    QHash<QString, QString> extraVersionInfo;
+    extraVersionInfo[QStringLiteral("vamp_plugin_id")] =
+            mixxx::AnalyzerSoundTouchBeats::pluginInfo().id();
+    extraVersionInfo[QStringLiteral("preview")] = QStringLiteral("1");
+    return BeatFactory::getPreferredSubVersion(extraVersionInfo);
+}
+
+/// Decodes the frame range and passes a downsampled mono mixdown
+/// to the detector
+void detectFrameRange(
+        soundtouch::BPMDetect* pDetector,
+        mixxx::AudioSourceStereoProxy* pAudioSource,
+        mixxx::IndexRange frameRange) {
+    mixxx::SampleBuffer sampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+    mixxx::SampleBuffer downmixBuffer(
+            mixxx::kAnalysisFramesPerChunk / AnalyzerBeatsPreview::kDownsampleFactor);
+    while (!frameRange.empty()) {
+        const auto chunkFrameRange = frameRange.splitAndShrinkFront(
+                math_min(mixxx::kAnalysisFramesPerChunk, frameRange.length()));
+        const auto readableSampleFrames =
+                pAudioSource->readSampleFrames(
+                        mixxx::WritableSampleFrames(
+                                chunkFrameRange,
+                                mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        if (readableSampleFrames.frameIndexRange().empty()) {
+            // The actual length of the audio source might be shorter
+            // than expected, the detector will work with what it got
+            break;
+        }
+        const CSAMPLE* pSamples = readableSampleFrames.readableData();
+        const SINT numDownmixFrames = readableSampleFrames.frameLength() /
+                AnalyzerBeatsPreview::kDownsampleFactor;
+        // Averaging the decimated frames is a sufficient low-pass filter,
+        // because the detector only looks at the envelope of the signal
+        for (SINT i = 0; i < numDownmixFrames; ++i) {
+            CSAMPLE sum = 0;
+            for (SINT j = 0; j < AnalyzerBeatsPreview::kDownsampleFactor * 2; ++j) {
+                sum += pSamples[i * AnalyzerBeatsPreview::kDownsampleFactor * 2 + j];
+            }
+            downmixBuffer[i] = sum / (AnalyzerBeatsPreview::kDownsampleFactor * 2);
+        }
+        pDetector->inputSamples(downmixBuffer.data(), static_cast<int>(numDownmixFrames));
+    }
+}
+
+} // anonymous namespace
+
+// static
+bool AnalyzerBeatsPreview::isPreview(const mixxx::Beats& beats) {
+    return beats.getSubVersion().split(QChar('|')).contains(kPreviewSubVersionFragment);
+}
+
+// static
+bool AnalyzerBeatsPreview::shouldAnalyze(
+        const BeatDetectionSettings& settings,
+        const TrackPointer& pTrack) {
+    return settings.getPreviewAnalysis() &&
+            settings.getBpmDetectionEnabled() &&
+            !pTrack->isBpmLocked() &&
+            !pTrack->getBeats();
+}
+
+// static
+mixxx::BeatsPointer AnalyzerBeatsPreview::analyze(
+        const mixxx::AudioSourcePointer& pAudioSource) {
+    const auto sampleRate = pAudioSource->getSignalInfo().getSampleRate();
+    const mixxx::IndexRange frameRange = pAudioSource->frameIndexRange();
+    const SINT framesToAnalyze = kSecondsToAnalyze * sampleRate;
+
+    mixxx::AudioSourceStereoProxy audioSourceProxy(
+            pAudioSource,
+            mixxx::kAnalysisFramesPerChunk);
+    soundtouch::BPMDetect detector(1, static_cast<int>(sampleRate / kDownsampleFactor));
+    if (frameRange.length() <= 2 * framesToAnalyze) {
+        detectFrameRange(&detector, &audioSourceProxy, frameRange);
+    } else {
+        // The intro and the outro are mixed most of the time, so they are
+        // more relevant for beatmatching than the part in between
+        detectFrameRange(&detector,
+                &audioSourceProxy,
+                mixxx::IndexRange::forward(frameRange.start(), framesToAnalyze));
+        detectFrameRange(&detector,
+                &audioSourceProxy,
+                mixxx::IndexRange::between(
+                        frameRange.end() - framesToAnalyze, frameRange.end()));
+    }
+
+    const auto bpm = mixxx::Bpm(detector.getBpm());
+    if (!bpm.isValid()) {
+        kLogger.debug() << "No tempo detected for preview";
+        return nullptr;
+    }
+    kLogger.debug() << "Detected provisional BPM" << bpm;
+    return mixxx::Beats::fromConstTempo(
+            sampleRate, mixxx::audio::kStartFramePos, bpm, previewSubVersion());
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "preferences/beatdetectionsettings.h"
+#include "sources/audiosource.h"
+#include "track/beats.h"
+#include "track/track_decl.h"
+#include "util/types.h"
+
+/// AnalyzerBeatsPreview estimates a provisional beat grid for a track that
+/// has just been loaded, long before the regular analysis of the whole track
+/// has finished.
+///
+/// Only the first and the last kSecondsToAnalyze seconds of the track are
+/// decoded, downsampled and passed to the SoundTouch BPM detector. The
+/// resulting constant tempo grid is marked as a preview, so AnalyzerBeats
+/// always replaces it with the result of the regular analysis.
+class AnalyzerBeatsPreview final {
+  public:
+    static constexpr SINT kSecondsToAnalyze = 15;
+    static constexpr SINT kDownsampleFactor = 4;
+
+    /// Returns true if the beats are a provisional grid created by
+    /// analyze() that has not been refined yet.
+    static bool isPreview(const mixxx::Beats& beats);
+
+    /// Returns true if a provisional grid should be estimated before
+    /// the track is analyzed regularly, i.e. if the track has no beats
+    /// at all.
+    static bool shouldAnalyze(
+            const BeatDetectionSettings& settings,
+            const TrackPointer& pTrack);
+
+    /// Decodes the beginning and the end of the audio source and returns
+    /// a provisional grid, or nullptr if no tempo could be detected.
+    static mixxx::BeatsPointer analyze(
+            const mixxx::AudioSourcePointer& pAudioSource);
+};
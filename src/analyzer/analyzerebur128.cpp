@@ -1,20 +1,32 @@
 #include "analyzer/analyzerebur128.h"
 
+#include <QThreadPool>
+#include <QtConcurrentRun>
 #include <QtDebug>
+#include <algorithm>
+#include <memory>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "track/track.h"
 #include "util/math.h"
+#include "util/sample.h"
 #include "util/timer.h"
 
 namespace {
 constexpr double kReplayGain2ReferenceLUFS = -18;
+
+// Tracks that are at least two segments long are measured in parallel
+constexpr SINT kSegmentSeconds = 20;
+// Limits the memory for the samples that are waiting to be measured
+constexpr int kMaxPendingSegments = 2;
 } // anonymous namespace
 
 AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig)
         : m_rgSettings(pConfig),
-          m_pState(nullptr) {
+          m_segmentFrames(0),
+          m_segmentFailed(false),
+          m_peak(CSAMPLE_ZERO) {
 }
 
 AnalyzerEbur128::~AnalyzerEbur128() {
@@ -25,46 +37,135 @@ bool AnalyzerEbur128::initialize(
         const AnalyzerTrack& track,
         mixxx::audio::SampleRate sampleRate,
         SINT frameLength) {
-    if (m_rgSettings.isAnalyzerDisabled(2, track.getTrack()) || frameLength <= 0) {
+    // The stored ReplayGain is kept unless it has been computed by another
+    // version of the analysis or from a different signal
+    if (!isEnabled(m_rgSettings) || frameLength <= 0 ||
+            (m_rgSettings.isAnalyzerDisabled(2, track.getTrack()) &&
+                    !track.isResultOutdated(resultName()))) {
         qDebug() << "Skipping AnalyzerEbur128";
         return false;
     }
-    DEBUG_ASSERT(m_pState == nullptr);
-    m_pState = ebur128_init(
-            mixxx::kAnalysisChannels,
-            sampleRate,
-            EBUR128_MODE_I);
-    return m_pState != nullptr;
+    DEBUG_ASSERT(m_states.empty());
+    m_sampleRate = sampleRate;
+    m_segmentFailed = false;
+    m_peak = CSAMPLE_ZERO;
+
+    const SINT segmentFrames = static_cast<SINT>(sampleRate.value()) * kSegmentSeconds;
+    if (frameLength >= 2 * segmentFrames &&
+            QThreadPool::globalInstance()->maxThreadCount() > 1) {
+        m_segmentFrames = segmentFrames;
+        m_segmentSamples.reserve(m_segmentFrames * mixxx::kAnalysisChannels);
+        return true;
+    }
+    m_segmentFrames = 0;
+    return addState() != nullptr;
 }
 
 void AnalyzerEbur128::cleanup() {
-    if (m_pState) {
-        ebur128_destroy(&m_pState);
-        // ebur128_destroy clears the pointer but let's not rely on that.
-        m_pState = nullptr;
+    // The pending segments still access their states
+    waitForSegments(0);
+    for (auto* pState : m_states) {
+        ebur128_destroy(&pState);
     }
+    m_states.clear();
+    // Release the memory of the segment buffer
+    m_segmentSamples = std::vector<CSAMPLE>();
+    m_segmentFrames = 0;
 }
 
 bool AnalyzerEbur128::processSamples(const CSAMPLE* pIn, SINT count) {
-    VERIFY_OR_DEBUG_ASSERT(m_pState) {
-        return false;
-    }
     ScopedTimer t(QStringLiteral("AnalyzerEbur128::processSamples()"));
-    size_t frames = count / mixxx::kAnalysisChannels;
-    int e = ebur128_add_frames_float(m_pState, pIn, frames);
-    VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
-        qWarning() << "AnalyzerEbur128::processSamples() failed with" << e;
-        return false;
+    if (count <= 0) {
+        return true;
+    }
+    m_peak = math_max(m_peak, SampleUtil::maxAbsAmplitude(pIn, count));
+
+    if (m_segmentFrames == 0) {
+        VERIFY_OR_DEBUG_ASSERT(!m_states.empty()) {
+            return false;
+        }
+        size_t frames = count / mixxx::kAnalysisChannels;
+        int e = ebur128_add_frames_float(m_states.back(), pIn, frames);
+        VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
+            qWarning() << "AnalyzerEbur128::processSamples() failed with" << e;
+            return false;
+        }
+        return true;
+    }
+
+    const auto segmentSamples = static_cast<std::size_t>(
+            m_segmentFrames * mixxx::kAnalysisChannels);
+    while (count > 0) {
+        const SINT numSamples = std::min(count,
+                static_cast<SINT>(segmentSamples - m_segmentSamples.size()));
+        m_segmentSamples.insert(m_segmentSamples.end(), pIn, pIn + numSamples);
+        pIn += numSamples;
+        count -= numSamples;
+        if (m_segmentSamples.size() == segmentSamples) {
+            measureSegment();
+        }
+    }
+    return !m_segmentFailed;
+}
+
+ebur128_state* AnalyzerEbur128::addState() {
+    ebur128_state* pState = ebur128_init(
+            mixxx::kAnalysisChannels,
+            m_sampleRate,
+            EBUR128_MODE_I);
+    if (pState) {
+        m_states.push_back(pState);
     }
-    return true;
+    return pState;
+}
+
+void AnalyzerEbur128::measureSegment() {
+    if (!waitForSegments(kMaxPendingSegments - 1)) {
+        m_segmentSamples.clear();
+        return;
+    }
+    ebur128_state* pState = addState();
+    if (!pState) {
+        m_segmentFailed = true;
+        m_segmentSamples.clear();
+        return;
+    }
+    auto pSamples = std::make_shared<std::vector<CSAMPLE>>(
+            std::move(m_segmentSamples));
+    m_segmentSamples = std::vector<CSAMPLE>();
+    m_segmentSamples.reserve(pSamples->size());
+    m_pendingSegments.append(QtConcurrent::run([pState, pSamples]() {
+        const size_t frames = pSamples->size() / mixxx::kAnalysisChannels;
+        return ebur128_add_frames_float(pState, pSamples->data(), frames) ==
+                EBUR128_SUCCESS;
+    }));
+}
+
+bool AnalyzerEbur128::waitForSegments(int maxPendingSegments) {
+    while (m_pendingSegments.size() > maxPendingSegments) {
+        QFuture<bool> future = m_pendingSegments.takeFirst();
+        future.waitForFinished();
+        if (!future.result()) {
+            qWarning() << "AnalyzerEbur128: Failed to measure a segment";
+            m_segmentFailed = true;
+        }
+    }
+    return !m_segmentFailed;
 }
 
 void AnalyzerEbur128::storeResults(TrackPointer pTrack) {
-    VERIFY_OR_DEBUG_ASSERT(m_pState) {
+    if (m_segmentFrames > 0 && !m_segmentSamples.empty()) {
+        measureSegment();
+    }
+    if (!waitForSegments(0)) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(!m_states.empty()) {
         return;
     }
     double averageLufs;
-    int e = ebur128_loudness_global(m_pState, &averageLufs);
+    int e = ebur128_loudness_global_multiple(
+            m_states.data(), m_states.size(), &averageLufs);
     VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
         qWarning() << "AnalyzerEbur128::storeResults() failed with" << e;
         return;
@@ -78,7 +179,9 @@ void AnalyzerEbur128::storeResults(TrackPointer pTrack) {
     const double fReplayGain2 = kReplayGain2ReferenceLUFS - averageLufs;
     mixxx::ReplayGain replayGain(pTrack->getReplayGain());
     replayGain.setRatio(db2ratio(fReplayGain2));
+    replayGain.setPeak(m_peak);
     pTrack->setReplayGain(replayGain);
     qDebug() << "ReplayGain 2.0 (libebur128) result is" << fReplayGain2
-             << "dB for" << pTrack->getFileInfo();
+             << "dB with peak" << m_peak << "from" << m_states.size()
+             << "segment(s) for" << pTrack->getFileInfo();
 }
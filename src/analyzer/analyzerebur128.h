@@ -2,9 +2,21 @@
 
 #include <ebur128.h>
 
+#include <QFuture>
+#include <QList>
+#include <vector>
+
 #include "analyzer/analyzer.h"
 #include "preferences/replaygainsettings.h"
 
+/// Computes the ReplayGain 2.0 from the EBU R128 integrated loudness and the
+/// sample peak of a track.
+///
+/// Long tracks are split into segments of kSegmentSeconds that are measured
+/// by separate ebur128 states on the global thread pool while the following
+/// segment is decoded. The gating blocks of all states are merged in
+/// storeResults(). The blocks that would overlap a segment boundary are
+/// missing, which changes the integrated loudness by far less than 0.1 LU.
 class AnalyzerEbur128 : public Analyzer {
   public:
     AnalyzerEbur128(UserSettingsPointer pConfig);
@@ -21,7 +33,25 @@ class AnalyzerEbur128 : public Analyzer {
     void storeResults(TrackPointer pTrack) override;
     void cleanup() override;
 
+    QString resultName() const override {
+        return QStringLiteral("replaygain");
+    }
+    QString resultVersion() const override {
+        return QStringLiteral("2");
+    }
+
   private:
+    ebur128_state* addState();
+    void measureSegment();
+    bool waitForSegments(int maxPendingSegments);
+
     ReplayGainSettings m_rgSettings;
-    ebur128_state* m_pState;
+    mixxx::audio::SampleRate m_sampleRate;
+    std::vector<ebur128_state*> m_states;
+    // Only used if the track is split into segments
+    SINT m_segmentFrames;
+    std::vector<CSAMPLE> m_segmentSamples;
+    QList<QFuture<bool>> m_pendingSegments;
+    bool m_segmentFailed;
+    CSAMPLE m_peak;
 };
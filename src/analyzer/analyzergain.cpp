@@ -12,7 +12,8 @@
 #include "util/timer.h"
 
 AnalyzerGain::AnalyzerGain(UserSettingsPointer pConfig)
-        : m_rgSettings(pConfig) {
+        : m_rgSettings(pConfig),
+          m_peak(CSAMPLE_ZERO) {
     m_pReplayGain = new ReplayGain();
 }
 
@@ -23,11 +24,16 @@ AnalyzerGain::~AnalyzerGain() {
 bool AnalyzerGain::initialize(const AnalyzerTrack& track,
         mixxx::audio::SampleRate sampleRate,
         SINT frameLength) {
-    if (m_rgSettings.isAnalyzerDisabled(1, track.getTrack()) || frameLength <= 0) {
+    // The stored ReplayGain is kept unless it has been computed by another
+    // version of the analysis or from a different signal
+    if (!isEnabled(m_rgSettings) || frameLength <= 0 ||
+            (m_rgSettings.isAnalyzerDisabled(1, track.getTrack()) &&
+                    !track.isResultOutdated(resultName()))) {
         qDebug() << "Skipping AnalyzerGain";
         return false;
     }
 
+    m_peak = CSAMPLE_ZERO;
     return m_pReplayGain->initialise(
             sampleRate,
             mixxx::kAnalysisChannels);
@@ -40,6 +46,10 @@ bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
     ScopedTimer t(QStringLiteral("AnalyzerGain::process()"));
 
     SINT numFrames = count / mixxx::kAnalysisChannels;
+    if (numFrames <= 0) {
+        return true;
+    }
+    m_peak = math_max(m_peak, SampleUtil::maxAbsAmplitude(pIn, count));
     if (numFrames > static_cast<SINT>(m_pLeftTempBuffer.size())) {
         m_pLeftTempBuffer.resize(numFrames);
         m_pRightTempBuffer.resize(numFrames);
@@ -68,7 +78,9 @@ void AnalyzerGain::storeResults(TrackPointer pTrack) {
 
     mixxx::ReplayGain replayGain(pTrack->getReplayGain());
     replayGain.setRatio(db2ratio(fReplayGainOutput));
+    replayGain.setPeak(m_peak);
     pTrack->setReplayGain(replayGain);
-    qDebug() << "ReplayGain 1.0 result is" << fReplayGainOutput << "dB for"
+    qDebug() << "ReplayGain 1.0 result is" << fReplayGainOutput
+             << "dB with peak" << m_peak << "for"
              << pTrack->getLocation();
 }
@@ -30,9 +30,17 @@ class AnalyzerGain : public Analyzer {
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
+    QString resultName() const override {
+        return QStringLiteral("replaygain");
+    }
+    QString resultVersion() const override {
+        return QStringLiteral("1");
+    }
+
   private:
     ReplayGainSettings m_rgSettings;
     std::vector<CSAMPLE> m_pLeftTempBuffer;
     std::vector<CSAMPLE> m_pRightTempBuffer;
     ReplayGain* m_pReplayGain;
+    CSAMPLE m_peak;
 };
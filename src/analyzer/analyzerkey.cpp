@@ -151,6 +151,11 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
+    return processDownmixedSamples(pIn, nullptr, count);
+}
+
+bool AnalyzerKey::processDownmixedSamples(
+        const CSAMPLE* pIn, const double* pDownmix, SINT count) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
@@ -160,7 +165,10 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
         return true; // silently ignore remaining samples
     }
 
-    return m_pPlugin->processSamples(pIn, count);
+    if (!pDownmix) {
+        return m_pPlugin->processSamples(pIn, count);
+    }
+    return m_pPlugin->processDownmixedSamples(pIn, pDownmix, count);
 }
 
 void AnalyzerKey::cleanup() {
@@ -22,6 +22,8 @@ class AnalyzerKey : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    bool processDownmixedSamples(
+            const CSAMPLE* pIn, const double* pDownmix, SINT count) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
@@ -0,0 +1,169 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <algorithm>
+
+#include "analyzer/constants.h"
+#include "analyzer/plugins/buffering_utils.h"
+#include "util/assert.h"
+#include "util/sample.h"
+
+AnalyzerPipeline::AnalyzerPipeline()
+        : m_numActiveHelpers(0),
+          m_numPushedChunks(0),
+          m_cancelled(false),
+          m_stopping(false) {
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    {
+        const std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cond.notify_all();
+    for (const auto& pThread : m_helperThreads) {
+        pThread->wait();
+    }
+}
+
+int AnalyzerPipeline::start(std::vector<AnalyzerWithState>* pAnalyzers, int numHelperThreads) {
+    DEBUG_ASSERT(pAnalyzers);
+    DEBUG_ASSERT(m_numActiveHelpers == 0);
+
+    // The active analyzers are dealt out to the lanes in turn. Each lane
+    // only ever accesses its own analyzers.
+    std::vector<AnalyzerWithState*> activeAnalyzers;
+    for (auto& analyzer : *pAnalyzers) {
+        if (analyzer.isActive()) {
+            activeAnalyzers.push_back(&analyzer);
+        }
+    }
+    const int numHelpers = std::clamp(numHelperThreads,
+            0,
+            std::max(0, static_cast<int>(activeAnalyzers.size()) - 1));
+    m_lanes.assign(numHelpers + 1, {});
+    for (std::size_t i = 0; i < activeAnalyzers.size(); ++i) {
+        m_lanes[i % m_lanes.size()].push_back(activeAnalyzers[i]);
+    }
+
+    if (numHelpers > 0 && m_chunks.empty()) {
+        m_chunks.resize(kNumChunks);
+        for (auto& chunk : m_chunks) {
+            chunk.samples = mixxx::SampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+            chunk.downmix.resize(mixxx::kAnalysisFramesPerChunk);
+        }
+    }
+    const auto priority = QThread::currentThread()->priority();
+    while (static_cast<int>(m_helperThreads.size()) < numHelpers) {
+        const int helper = static_cast<int>(m_helperThreads.size());
+        m_helperThreads.emplace_back(QThread::create([this, helper] {
+            runHelper(helper);
+        }));
+        m_helperThreads.back()->setObjectName(
+                QStringLiteral("AnalyzerPipeline %1").arg(helper));
+        m_helperThreads.back()->start(priority);
+    }
+
+    {
+        const std::lock_guard lock(m_mutex);
+        m_numPushedChunks = 0;
+        m_numConsumedChunks.assign(numHelpers, 0);
+        m_cancelled = false;
+        m_numActiveHelpers = numHelpers;
+    }
+    m_cond.notify_all();
+    return numHelpers;
+}
+
+void AnalyzerPipeline::processLane(int lane,
+        const CSAMPLE* pSamples,
+        const double* pDownmix,
+        SINT numSamples) {
+    for (auto* pAnalyzer : m_lanes[lane]) {
+        pAnalyzer->processSamples(pSamples, pDownmix, static_cast<int>(numSamples));
+    }
+}
+
+void AnalyzerPipeline::process(const CSAMPLE* pSamples, SINT numSamples) {
+    DEBUG_ASSERT(!m_lanes.empty());
+    if (m_lanes.size() == 1) {
+        if (static_cast<SINT>(m_downmix.size()) < numSamples / mixxx::kAnalysisChannels) {
+            m_downmix.resize(numSamples / mixxx::kAnalysisChannels);
+        }
+        mixxx::DownmixAndOverlapHelper::downmixStereoSamples(
+                m_downmix.data(), pSamples, numSamples);
+        processLane(0, pSamples, m_downmix.data(), numSamples);
+        return;
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_cond.wait(lock, [this] {
+        const auto slowest = *std::min_element(
+                m_numConsumedChunks.begin(), m_numConsumedChunks.end());
+        return m_numPushedChunks - slowest < kNumChunks;
+    });
+    // The slot is not accessed by any helper thread until it is pushed
+    Chunk& chunk = m_chunks[m_numPushedChunks % kNumChunks];
+    lock.unlock();
+    VERIFY_OR_DEBUG_ASSERT(numSamples <= chunk.samples.size()) {
+        numSamples = chunk.samples.size();
+    }
+    SampleUtil::copy(chunk.samples.data(), pSamples, numSamples);
+    mixxx::DownmixAndOverlapHelper::downmixStereoSamples(
+            chunk.downmix.data(), pSamples, numSamples);
+    chunk.numSamples = numSamples;
+    lock.lock();
+    ++m_numPushedChunks;
+    lock.unlock();
+    m_cond.notify_all();
+    // The slot is only overwritten by this thread when pushing subsequent
+    // chunks, so the first lane may read the shared downmix as well
+    processLane(0, pSamples, chunk.downmix.data(), numSamples);
+}
+
+bool AnalyzerPipeline::allChunksConsumed() const {
+    return std::all_of(m_numConsumedChunks.begin(),
+            m_numConsumedChunks.end(),
+            [this](std::uint64_t numConsumed) {
+                return numConsumed == m_numPushedChunks;
+            });
+}
+
+void AnalyzerPipeline::finish() {
+    std::unique_lock lock(m_mutex);
+    m_cond.wait(lock, [this] {
+        return allChunksConsumed();
+    });
+    m_numActiveHelpers = 0;
+}
+
+void AnalyzerPipeline::cancel() {
+    {
+        const std::lock_guard lock(m_mutex);
+        m_cancelled = true;
+    }
+    m_cond.notify_all();
+    finish();
+}
+
+void AnalyzerPipeline::runHelper(int helper) {
+    const int lane = helper + 1;
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_cond.wait(lock, [this, helper] {
+            return m_stopping ||
+                    (helper < m_numActiveHelpers &&
+                            m_numConsumedChunks[helper] < m_numPushedChunks);
+        });
+        if (m_stopping) {
+            return;
+        }
+        const Chunk& chunk = m_chunks[m_numConsumedChunks[helper] % kNumChunks];
+        if (!m_cancelled) {
+            lock.unlock();
+            processLane(lane, chunk.samples.data(), chunk.downmix.data(), chunk.numSamples);
+            lock.lock();
+        }
+        ++m_numConsumedChunks[helper];
+        m_cond.notify_all();
+    }
+}
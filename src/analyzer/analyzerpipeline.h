@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QThread>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// AnalyzerPipeline distributes the analyzers of a track across the calling
+/// thread and a number of helper threads, so a single track can be analyzed
+/// on multiple cores.
+///
+/// The analyzers are split into lanes. The first lane is processed by the
+/// calling thread, i.e. the AnalyzerThread that decodes the track, and every
+/// other lane by its own helper thread. Decoded chunks are copied into a
+/// bounded ring, so each lane may fall behind the decoder by up to kNumChunks
+/// chunks before the decoder has to wait.
+///
+/// The mono downmix of each chunk that is needed by the beat and key
+/// analyzers is computed only once and shared by all lanes.
+///
+/// All methods must be called from the same thread. The helper threads are
+/// kept alive until the pipeline is destroyed.
+class AnalyzerPipeline final {
+  public:
+    static constexpr int kNumChunks = 8;
+
+    AnalyzerPipeline();
+    ~AnalyzerPipeline();
+
+    /// Starts the analysis of a track with the active analyzers, using
+    /// up to numHelperThreads additional threads. Returns the number of
+    /// helper threads that are actually used.
+    int start(std::vector<AnalyzerWithState>* pAnalyzers, int numHelperThreads);
+
+    /// Passes the next chunk of decoded samples to all analyzers.
+    /// Blocks while the slowest lane is kNumChunks chunks behind.
+    void process(const CSAMPLE* pSamples, SINT numSamples);
+
+    /// Waits until all lanes have processed all chunks. Afterwards the
+    /// analyzers may be accessed by the calling thread again.
+    void finish();
+
+    /// Discards the chunks that have not been processed yet and waits until
+    /// the helper threads no longer access any analyzer.
+    void cancel();
+
+  private:
+    struct Chunk {
+        mixxx::SampleBuffer samples;
+        std::vector<double> downmix;
+        SINT numSamples = 0;
+    };
+
+    void processLane(int lane,
+            const CSAMPLE* pSamples,
+            const double* pDownmix,
+            SINT numSamples);
+    void runHelper(int helper);
+    // Requires m_mutex to be locked
+    bool allChunksConsumed() const;
+
+    std::vector<std::vector<AnalyzerWithState*>> m_lanes;
+
+    std::vector<std::unique_ptr<QThread>> m_helperThreads;
+    std::vector<Chunk> m_chunks;
+    // Only used when there are no helper threads
+    std::vector<double> m_downmix;
+
+    // Guarded by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    int m_numActiveHelpers;
+    std::uint64_t m_numPushedChunks;
+    std::vector<std::uint64_t> m_numConsumedChunks;
+    bool m_cancelled;
+    bool m_stopping;
+};
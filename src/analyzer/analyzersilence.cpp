@@ -1,8 +1,11 @@
 #include "analyzer/analyzersilence.h"
 
+#include <algorithm>
+
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "track/track.h"
+#include "util/sample.h"
 
 namespace {
 
@@ -12,6 +15,15 @@ constexpr CSAMPLE kSilenceThreshold = 0.001f; // -60 dB
 // TODO: Change the above line to:
 //constexpr CSAMPLE kSilenceThreshold = db2ratio(-60.0f);
 
+// Silence is skipped block by block, using the vectorized maximum of each
+// block. Only the block that contains the first or last sound is searched
+// sample by sample, so the result is exactly the same.
+constexpr SINT kBlockSamples = 64;
+
+bool isSilentBlock(const CSAMPLE* pSamples, SINT numSamples) {
+    return SampleUtil::maxAbsAmplitude(pSamples, numSamples) < kSilenceThreshold;
+}
+
 bool shouldAnalyze(TrackPointer pTrack) {
     CuePointer pIntroCue = pTrack->findCueByType(mixxx::CueType::Intro);
     CuePointer pOutroCue = pTrack->findCueByType(mixxx::CueType::Outro);
@@ -58,17 +70,39 @@ bool AnalyzerSilence::initialize(const AnalyzerTrack& track,
 
 // static
 SINT AnalyzerSilence::findFirstSoundInChunk(std::span<const CSAMPLE> samples) {
-    return std::distance(samples.begin(), first_sound(samples.begin(), samples.end()));
+    const auto numSamples = static_cast<SINT>(samples.size());
+    SINT blockStart = 0;
+    while (blockStart < numSamples) {
+        const SINT blockSamples = std::min(kBlockSamples, numSamples - blockStart);
+        if (!isSilentBlock(samples.data() + blockStart, blockSamples)) {
+            break;
+        }
+        blockStart += blockSamples;
+    }
+    return std::distance(samples.begin(),
+            first_sound(samples.begin() + blockStart, samples.end()));
 }
 
 // static
 SINT AnalyzerSilence::findLastSoundInChunk(std::span<const CSAMPLE> samples) {
-    // -1 is required, because the distance from the fist sample index (0) to crend() is 1,
-    SINT ret = std::distance(first_sound(samples.rbegin(), samples.rend()), samples.rend()) - 1;
-    if (ret == -1) {
-        ret = samples.size();
+    const auto numSamples = static_cast<SINT>(samples.size());
+    SINT blockEnd = numSamples;
+    while (blockEnd > 0) {
+        const SINT blockSamples = std::min(kBlockSamples, blockEnd);
+        if (!isSilentBlock(samples.data() + blockEnd - blockSamples, blockSamples)) {
+            break;
+        }
+        blockEnd -= blockSamples;
     }
-    return ret;
+    if (blockEnd == 0) {
+        return numSamples;
+    }
+    // -1 is required, because the distance from the fist sample index (0) to crend() is 1,
+    return std::distance(
+                   first_sound(samples.rbegin() + (numSamples - blockEnd),
+                           samples.rend()),
+                   samples.rend()) -
+            1;
 }
 
 // static
@@ -2,21 +2,30 @@
 
 #include <mutex>
 
+#include "analyzer/analysisresultwriter.h"
 #include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzerbeatspreview.h"
 #include "analyzer/analyzerebur128.h"
 #include "analyzer/analyzergain.h"
 #include "analyzer/analyzerkey.h"
 #include "analyzer/analyzersilence.h"
 #include "analyzer/analyzerwaveform.h"
 #include "analyzer/constants.h"
+#include "engine/cachingreader/cachingreaderpcmcache.h"
 #include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
+#include "sources/audiosourceparallelproxy.h"
 #include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceflac.h"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 #include "util/logger.h"
+#include "util/performancetimer.h"
+#include "util/stat.h"
+#include "util/threadplacement.h"
 
 namespace {
 
@@ -40,6 +49,66 @@ void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     }
 }
 
+const QString kAnalysisSpeedTag = QStringLiteral("AnalyzerThread analysis speed");
+
+/// Reports how many times faster than real time a track has been analyzed
+void trackAnalysisSpeed(const mixxx::AudioSource& audioSource, mixxx::Duration elapsed) {
+    const auto sampleRate = audioSource.getSignalInfo().getSampleRate();
+    if (!sampleRate.isValid() || elapsed <= mixxx::Duration::empty()) {
+        return;
+    }
+    const double trackSeconds = audioSource.frameLength() / sampleRate.toDouble();
+    Stat::track(kAnalysisSpeedTag,
+            Stat::UNSPECIFIED,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+            trackSeconds / elapsed.toDoubleSeconds());
+}
+
+/// Identifies the decoded signal that the recorded analyzer results
+/// have been computed from
+QString signalFingerprint(const mixxx::AudioSource& audioSource) {
+    return QStringLiteral("%1:%2:%3")
+            .arg(QString::number(audioSource.getSignalInfo().getSampleRate()),
+                    QString::number(audioSource.getSignalInfo().getChannelCount()),
+                    QString::number(audioSource.frameLength()));
+}
+
+/// Decodes FLAC files in segments on additional threads. FLAC frames can
+/// be decoded independently and sample accurately after seeking, unlike
+/// most lossy formats.
+mixxx::AudioSourcePointer openParallelDecoding(
+        const TrackPointer& pTrack,
+        mixxx::AudioSourcePointer pAudioSource,
+        const mixxx::AudioSource::OpenParams& openParams,
+        int numDecodeThreads) {
+    if (numDecodeThreads <= 0) {
+        return pAudioSource;
+    }
+    const auto fileInfo = pTrack->getFileInfo();
+    // The provider that has opened the file
+    const auto probe = mixxx::SoundSourcePool::probe(fileInfo.location());
+    if (!probe || !probe->pProvider ||
+            probe->pProvider->getDisplayName() !=
+                    mixxx::SoundSourceProviderFLAC::kDisplayName) {
+        return pAudioSource;
+    }
+    const auto pProvider = probe->pProvider;
+    const auto url = fileInfo.toQUrl();
+    return mixxx::AudioSourceParallelProxy::create(
+            std::move(pAudioSource),
+            [pProvider, url, openParams]() -> mixxx::AudioSourcePointer {
+                const auto pSoundSource = pProvider->newSoundSource(url);
+                if (!pSoundSource ||
+                        pSoundSource->open(mixxx::AudioSource::OpenMode::Strict,
+                                openParams) !=
+                                mixxx::AudioSource::OpenResult::Succeeded) {
+                    return nullptr;
+                }
+                return pSoundSource;
+            },
+            numDecodeThreads);
+}
+
 std::once_flag registerMetaTypesOnceFlag;
 
 void registerMetaTypesOnce() {
@@ -76,32 +145,54 @@ AnalyzerThread::AnalyzerThread(
         AnalyzerModeFlags modeFlags)
         : WorkerThread(
             QString("AnalyzerThread %1").arg(id),
-            (modeFlags & AnalyzerModeFlags::LowPriority ? QThread::LowPriority : QThread::InheritPriority)),
+            (modeFlags & AnalyzerModeFlags::IdlePriority
+                            ? QThread::IdlePriority
+                            : (modeFlags & AnalyzerModeFlags::LowPriority
+                                              ? QThread::LowPriority
+                                              : QThread::InheritPriority))),
           m_id(id),
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
           m_nextTrack(2), // minimum capacity
+          m_numPipelineThreads(0),
+          m_numDecodeThreads(0),
+          m_throttleDelayMicros(0),
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
 }
 
 void AnalyzerThread::doRun() {
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::Analysis);
     std::unique_ptr<AnalysisDao> pAnalysisDao;
+    std::unique_ptr<AnalysisResultWriter> pResultWriter;
     // The thread-local database connection  must not be closed
     // before returning from this function.
     mixxx::DbConnectionPooler dbConnectionPooler;
 
+    // The database connection is needed for storing waveforms and for
+    // recording the versions of the analyzer results
+    dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
+    if (dbConnectionPooler.isPooling()) {
+        pAnalysisDao = std::make_unique<AnalysisDao>(m_pConfig);
+        pAnalysisDao->initialize(mixxx::DbConnectionPooled(m_dbConnectionPool));
+        // The results are committed in groups, because committing them
+        // separately for each track slows down batch analysis
+        pResultWriter = std::make_unique<AnalysisResultWriter>(
+                m_dbConnectionPool, m_pConfig);
+        pResultWriter->start(priority());
+    }
+
     if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
-        dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
         if (!dbConnectionPooler.isPooling()) {
             kLogger.warning()
                     << "Failed to obtain database connection for analyzer thread";
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(
+                m_pConfig, dbConnection, pResultWriter.get())));
     }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
         m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
@@ -123,13 +214,37 @@ void AnalyzerThread::doRun() {
     mixxx::AudioSource::OpenParams openParams;
     openParams.setChannelCount(mixxx::kAnalysisChannels);
 
+    const std::shared_ptr<CachingReaderPcmCache> pPcmCache =
+            CachingReaderPcmCache::create(m_pConfig);
+
     while (awaitWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack.has_value());
         kLogger.debug() << "Analyzing" << m_currentTrack->getTrack()->getLocation();
 
-        // Get the audio
-        const mixxx::AudioSourcePointer audioSource =
-                SoundSourceProxy(m_currentTrack->getTrack()).openAudioSource(openParams);
+        // Get the audio, preferably from the samples that have already been
+        // decoded for playback
+        const TrackPointer pTrack = m_currentTrack->getTrack();
+        mixxx::AudioSourcePointer audioSource;
+        if (pPcmCache) {
+            audioSource = pPcmCache->openAudioSource(pTrack, mixxx::kAnalysisChannels);
+        }
+        std::unique_ptr<CachingReaderPcmCache::Writer> pPcmCacheWriter;
+        bool decoding = false;
+        if (!audioSource) {
+            audioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+            decoding = true;
+            // Loaded tracks are analyzed right after they have been opened
+            // for playback. Writing the samples that are decoded for the
+            // analysis into the cache saves the reader from decoding them
+            // again. Batch analysis should not evict the cached tracks.
+            if (audioSource && pPcmCache &&
+                    !(m_modeFlags & AnalyzerModeFlags::LowPriority) &&
+                    audioSource->getSignalInfo().getChannelCount() ==
+                            mixxx::kAnalysisChannels) {
+                pPcmCacheWriter = pPcmCache->newFedWriter(
+                        pTrack, mixxx::kAnalysisChannels, audioSource);
+            }
+        }
         if (!audioSource) {
             kLogger.warning()
                     << "Failed to open file for analyzing:"
@@ -138,6 +253,38 @@ void AnalyzerThread::doRun() {
             continue;
         }
 
+        // Loaded tracks get a provisional beat grid within a fraction of
+        // the time the regular analysis takes, which refines it afterwards.
+        if (!(m_modeFlags & AnalyzerModeFlags::LowPriority) &&
+                AnalyzerBeatsPreview::shouldAnalyze(
+                        BeatDetectionSettings(m_pConfig), pTrack)) {
+            const mixxx::BeatsPointer pPreviewBeats =
+                    AnalyzerBeatsPreview::analyze(audioSource);
+            if (pPreviewBeats) {
+                pTrack->trySetBeats(pPreviewBeats);
+            }
+        }
+
+        // Results that have been recorded for another version of an
+        // analyzer or for a different signal are outdated. Results that
+        // have never been recorded, e.g. from previous releases, are
+        // left alone to avoid reanalyzing the whole library.
+        const QString fingerprint = signalFingerprint(*audioSource);
+        if (pAnalysisDao) {
+            const auto analyzerResults = pAnalysisDao->getAnalyzerResults(pTrack->getId());
+            for (const auto& analyzer : m_analyzers) {
+                const QString resultName = analyzer.resultName();
+                const auto iResult = analyzerResults.constFind(resultName);
+                if (resultName.isEmpty() || iResult == analyzerResults.constEnd()) {
+                    continue;
+                }
+                if (iResult->version != analyzer.resultVersion() ||
+                        iResult->fingerprint != fingerprint) {
+                    m_currentTrack->setResultOutdated(resultName);
+                }
+            }
+        }
+
         bool processTrack = false;
         for (auto&& analyzer : m_analyzers) {
             // Make sure not to short-circuit initialize(...)
@@ -150,9 +297,20 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
-            const auto analysisResult = analyzeAudioSource(audioSource);
+            m_pipeline.start(&m_analyzers, m_numPipelineThreads.load());
+            // Only wraps the source for the sequential read, the proxy
+            // stops its threads when going out of scope
+            const auto decodingAudioSource = decoding
+                    ? openParallelDecoding(
+                              pTrack, audioSource, openParams, m_numDecodeThreads.load())
+                    : audioSource;
+            PerformanceTimer analysisTimer;
+            analysisTimer.start();
+            const auto analysisResult = analyzeAudioSource(
+                    decodingAudioSource, pPcmCacheWriter.get());
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
             if (analysisResult == AnalysisResult::Finished) {
+                trackAnalysisSpeed(*audioSource, analysisTimer.elapsed());
                 // The analysis has been finished, and is either complete without
                 // any errors or partial if it has been aborted due to a corrupt
                 // audio file. In both cases don't reanalyze tracks during this
@@ -160,12 +318,21 @@ void AnalyzerThread::doRun() {
                 // and again, because it is very unlikely that the error vanishes
                 // suddenly.
                 emitBusyProgress(kAnalyzerProgressFinalizing);
+                m_pipeline.finish();
                 // This takes around 3 sec on a Atom Netbook
                 for (auto&& analyzer : m_analyzers) {
+                    if (pResultWriter && analyzer.isActive() &&
+                            !analyzer.resultName().isEmpty()) {
+                        pResultWriter->saveAnalyzerResult(pTrack->getId(),
+                                analyzer.resultName(),
+                                AnalysisDao::AnalyzerResultInfo{
+                                        analyzer.resultVersion(), fingerprint});
+                    }
                     analyzer.finish(*m_currentTrack);
                 }
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
+                m_pipeline.cancel();
                 for (auto&& analyzer : m_analyzers) {
                     analyzer.cancel();
                 }
@@ -175,11 +342,18 @@ void AnalyzerThread::doRun() {
             kLogger.debug() << "Skipping track analysis because no analyzer initialized.";
             emitDoneProgress(kAnalyzerProgressDone);
         }
+        // Closing returns the decoder into the SoundSourcePool, e.g. for
+        // loading the track into a deck afterwards
+        pPcmCacheWriter.reset();
+        audioSource->close();
     }
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
     m_analyzers.clear();
+    // Commits the pending results
+    pResultWriter.reset();
+    pAnalysisDao.reset();
 
     kLogger.debug() << "Exiting worker thread";
     emitProgress(AnalyzerThreadState::Exit);
@@ -217,7 +391,8 @@ WorkerThread::TryFetchWorkItemsResult AnalyzerThread::tryFetchWorkItems() {
 }
 
 AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
-        const mixxx::AudioSourcePointer& audioSource) {
+        const mixxx::AudioSourcePointer& audioSource,
+        CachingReaderPcmCache::Writer* pPcmCacheWriter) {
     DEBUG_ASSERT(m_currentTrack.has_value());
 
     mixxx::AudioSourceStereoProxy audioSourceProxy(
@@ -288,6 +463,10 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                     audioSourceProxy.frameIndexRange().end() - remainingFrameRange.end());
         }
 
+        const auto throttleDelayMicros = m_throttleDelayMicros.load();
+        if (throttleDelayMicros > 0) {
+            QThread::usleep(static_cast<unsigned long>(throttleDelayMicros));
+        }
         sleepWhileSuspended();
         if (isStopping()) {
             return AnalysisResult::Cancelled;
@@ -295,10 +474,11 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
-                        readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
+            m_pipeline.process(
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableLength());
+            if (pPcmCacheWriter && !pPcmCacheWriter->append(readableSampleFrames)) {
+                pPcmCacheWriter = nullptr;
             }
         }
 
@@ -324,6 +504,9 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
     }
 
+    if (pPcmCacheWriter) {
+        pPcmCacheWriter->finish();
+    }
     return AnalysisResult::Finished;
 }
 
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
+#include "engine/cachingreader/cachingreaderpcmcache.h"
 #include "preferences/usersettings.h"
 #include "rigtorp/SPSCQueue.h"
 #include "sources/audiosource.h"
@@ -22,6 +25,8 @@ enum AnalyzerModeFlags {
     WithBeats = 0x01,
     WithWaveform = 0x02,
     LowPriority = 0x04,
+    // Only runs when the CPU is otherwise idle, i.e. SCHED_IDLE on Linux
+    IdlePriority = 0x08,
     All = WithBeats | WithWaveform,
 };
 
@@ -79,6 +84,26 @@ class AnalyzerThread : public WorkerThread {
     // worker thread, yet.
     bool submitNextTrack(const AnalyzerTrack& nextTrack);
 
+    // Sets the number of additional threads that are used for analyzing
+    // the next track, see AnalyzerPipeline. Takes effect when the worker
+    // thread starts with the next track.
+    void setNumPipelineThreads(int numPipelineThreads) {
+        m_numPipelineThreads.store(numPipelineThreads);
+    }
+
+    // Sets the number of additional threads that are used for decoding
+    // the next track, see AudioSourceParallelProxy. Takes effect when
+    // the worker thread starts with the next track.
+    void setNumDecodeThreads(int numDecodeThreads) {
+        m_numDecodeThreads.store(numDecodeThreads);
+    }
+
+    // Sets the time the worker thread waits after each analyzed chunk
+    // to leave some headroom for the audio engine, see AnalysisThrottle.
+    void setThrottleDelay(mixxx::Duration delayPerChunk) {
+        m_throttleDelayMicros.store(delayPerChunk.toIntegerMicros());
+    }
+
   signals:
     // Use a single signal for progress updates to ensure that all signals
     // are queued and received in the same order as emitted from the internal
@@ -112,12 +137,20 @@ class AnalyzerThread : public WorkerThread {
     // for this purpose, which will become available in C++20.
     rigtorp::SPSCQueue<AnalyzerTrack> m_nextTrack;
 
+    std::atomic<int> m_numPipelineThreads;
+
+    std::atomic<int> m_numDecodeThreads;
+
+    std::atomic<qint64> m_throttleDelayMicros;
+
     /////////////////////////////////////////////////////////////////////////
     // Thread local: Only used in the constructor/destructor and within
     // run() by the worker thread.
 
     std::vector<AnalyzerWithState> m_analyzers;
 
+    AnalyzerPipeline m_pipeline;
+
     mixxx::SampleBuffer m_sampleBuffer;
 
     std::optional<AnalyzerTrack> m_currentTrack;
@@ -131,8 +164,11 @@ class AnalyzerThread : public WorkerThread {
         Finished,
         Cancelled,
     };
+    // The decoded samples are also written into the cache file if
+    // pPcmCacheWriter is not null
     AnalysisResult analyzeAudioSource(
-            const mixxx::AudioSourcePointer& audioSource);
+            const mixxx::AudioSourcePointer& audioSource,
+            CachingReaderPcmCache::Writer* pPcmCacheWriter);
 
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
@@ -14,3 +14,12 @@ const TrackPointer& AnalyzerTrack::getTrack() const {
 const AnalyzerTrack::Options& AnalyzerTrack::getOptions() const {
     return m_options;
 }
+
+void AnalyzerTrack::setResultOutdated(const QString& resultName) {
+    DEBUG_ASSERT(!resultName.isEmpty());
+    m_outdatedResults.insert(resultName);
+}
+
+bool AnalyzerTrack::isResultOutdated(const QString& resultName) const {
+    return m_outdatedResults.contains(resultName);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QSet>
+#include <QString>
 #include <optional>
 
 #include "track/track_decl.h"
@@ -20,9 +22,19 @@ class AnalyzerTrack {
     /// Fetches the additional options.
     const Options& getOptions() const;
 
+    /// Marks the stored results of an analyzer as outdated, see
+    /// Analyzer::resultName().
+    void setResultOutdated(const QString& resultName);
+
+    /// Returns true if the stored results of an analyzer are known to
+    /// be outdated. Results that have never been recorded are not.
+    bool isResultOutdated(const QString& resultName) const;
+
   private:
     /// The (not-null) track to be analyzed.
     TrackPointer m_track;
     /// The additional options.
     Options m_options;
+    /// The names of the analyzers with outdated results.
+    QSet<QString> m_outdatedResults;
 };
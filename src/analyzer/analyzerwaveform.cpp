@@ -1,10 +1,17 @@
 #include "analyzer/analyzerwaveform.h"
 
+#include <cmath>
+
+#include "analyzer/analysisresultwriter.h"
 #include "analyzer/analyzertrack.h"
 #include "engine/filters/enginefilterbessel4.h"
 #include "track/track.h"
 #include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "waveform/waveformcache.h"
 #include "waveform/waveformfactory.h"
+#include "waveform/waveformthumbnailstore.h"
 
 namespace {
 
@@ -14,12 +21,22 @@ constexpr double kLowMidFreqHz = 600.0;
 
 constexpr double kMidHighFreqHz = 4000.0;
 
+// Returns the number of frames following position that do not complete
+// a stride of the given length. fmod() is exact, so this is conservative
+// with respect to the per frame check in processSamples().
+SINT framesWithinStride(int position, double length) {
+    const double remainder = std::fmod(position, length);
+    return math_max(static_cast<SINT>(length - remainder) - 1, static_cast<SINT>(0));
+}
+
 } // namespace
 
 AnalyzerWaveform::AnalyzerWaveform(
         UserSettingsPointer pConfig,
-        const QSqlDatabase& dbConnection)
+        const QSqlDatabase& dbConnection,
+        AnalysisResultWriter* pResultWriter)
         : m_analysisDao(pConfig),
+          m_pResultWriter(pResultWriter),
           m_waveformData(nullptr),
           m_waveformSummaryData(nullptr),
           m_stride(0, 0),
@@ -101,6 +118,24 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     bool missingWaveform = pTrackWaveform.isNull();
     bool missingWavesummary = pTrackWaveformSummary.isNull();
 
+    if (trackId.isValid() && (missingWaveform || missingWavesummary)) {
+        // The waveforms of a track that has been evicted from the track
+        // cache may still be in memory
+        WaveformCache& waveformCache = WaveformCache::instance();
+        if (missingWaveform) {
+            pLoadedTrackWaveform = waveformCache.lookup(trackId,
+                    WaveformCache::Type::Waveform,
+                    WaveformFactory::currentWaveformVersion());
+            missingWaveform = pLoadedTrackWaveform.isNull();
+        }
+        if (missingWavesummary) {
+            pLoadedTrackWaveformSummary = waveformCache.lookup(trackId,
+                    WaveformCache::Type::Summary,
+                    WaveformFactory::currentWaveformSummaryVersion());
+            missingWavesummary = pLoadedTrackWaveformSummary.isNull();
+        }
+    }
+
     if (trackId.isValid() && (missingWaveform || missingWavesummary)) {
         QList<AnalysisDao::AnalysisInfo> analyses =
                 m_analysisDao.getAnalysesForTrack(trackId);
@@ -115,6 +150,9 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
                 if (missingWaveform && vc == WaveformFactory::VC_USE) {
                     pLoadedTrackWaveform = ConstWaveformPointer(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
+                    WaveformCache::instance().insert(trackId,
+                            WaveformCache::Type::Waveform,
+                            pLoadedTrackWaveform);
                     missingWaveform = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -126,6 +164,9 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
                 if (missingWavesummary && vc == WaveformFactory::VC_USE) {
                     pLoadedTrackWaveformSummary = ConstWaveformPointer(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
+                    WaveformCache::instance().insert(trackId,
+                            WaveformCache::Type::Summary,
+                            pLoadedTrackWaveformSummary);
                     missingWavesummary = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -143,6 +184,14 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
         }
         if (pLoadedTrackWaveformSummary) {
             tio->setWaveformSummary(pLoadedTrackWaveformSummary);
+            // Tracks that have been analyzed before the thumbnails were
+            // introduced get theirs when they are loaded
+            const auto pThumbnailStore = WaveformThumbnailStore::instance();
+            if (pThumbnailStore && !pThumbnailStore->contains(trackId)) {
+                pThumbnailStore->insert(trackId,
+                        WaveformThumbnailStore::stripFromSummary(
+                                *pLoadedTrackWaveformSummary));
+            }
         }
         return false;
     }
@@ -194,6 +243,29 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* buffer, SINT count) {
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
 
     for (SINT i = 0; i < count; i += 2) {
+        // Frames that do not complete any stride are reduced block wise
+        const SINT blockFrames = math_min((count - i) / ChannelCount,
+                math_min(framesWithinStride(m_stride.m_position, m_stride.m_length),
+                        framesWithinStride(m_stride.m_position, m_stride.m_averageLength)));
+        if (blockFrames > 0) {
+            const SINT blockSamples = blockFrames * ChannelCount;
+            SampleUtil::maxAbsPerChannel(&m_stride.m_overallData[Left],
+                    &m_stride.m_overallData[Right],
+                    buffer + i,
+                    blockSamples);
+            for (int f = 0; f < FilterCount; ++f) {
+                SampleUtil::maxAbsPerChannel(&m_stride.m_filteredData[Left][f],
+                        &m_stride.m_filteredData[Right][f],
+                        &m_buffers[f][i],
+                        blockSamples);
+            }
+            m_stride.m_position += static_cast<int>(blockFrames);
+            i += blockSamples;
+            if (i >= count) {
+                break;
+            }
+        }
+
         // Take max value, not average of data
         CSAMPLE cover[2] = {fabs(buffer[i]), fabs(buffer[i + 1])};
         CSAMPLE clow[2] = {fabs(m_buffers[Low][i]), fabs(m_buffers[Low][i + 1])};
@@ -271,6 +343,7 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
     // Force completion to waveform size
     if (m_waveform) {
         m_waveform->setSaveState(Waveform::SaveState::SavePending);
+        m_waveform->buildMipLevels();
         m_waveform->setCompletion(m_waveform->getDataSize());
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
@@ -286,6 +359,26 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
     }
     tio->setWaveformSummary(m_waveformSummary);
 
+    // The waveforms are complete and not modified anymore
+    const TrackId trackId = tio->getId();
+    if (trackId.isValid()) {
+        if (m_waveform) {
+            WaveformCache::instance().insert(trackId,
+                    WaveformCache::Type::Waveform,
+                    m_waveform);
+        }
+        if (m_waveformSummary) {
+            WaveformCache::instance().insert(trackId,
+                    WaveformCache::Type::Summary,
+                    m_waveformSummary);
+            const auto pThumbnailStore = WaveformThumbnailStore::instance();
+            if (pThumbnailStore) {
+                pThumbnailStore->insert(trackId,
+                        WaveformThumbnailStore::stripFromSummary(*m_waveformSummary));
+            }
+        }
+    }
+
 #ifdef TEST_HEAT_MAP
     test_heatMap->save("heatMap.png");
 #endif
@@ -294,10 +387,17 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
     // waveforms (i.e. if the config setting was disabled in a previous scan)
     // and then it is not called. The other analyzers have signals which control
     // the update of their data.
-    m_analysisDao.saveTrackAnalyses(
-            tio->getId(),
-            m_waveform,
-            m_waveformSummary);
+    if (m_pResultWriter) {
+        m_pResultWriter->saveTrackAnalyses(
+                tio->getId(),
+                m_waveform,
+                m_waveformSummary);
+    } else {
+        m_analysisDao.saveTrackAnalyses(
+                tio->getId(),
+                m_waveform,
+                m_waveformSummary);
+    }
 
     kLogger.debug() << "Waveform generation for track" << tio->getId() << "done"
                     << m_timer.elapsed().debugSecondsWithUnit();
@@ -14,6 +14,7 @@
 class QImage;
 #endif
 
+class AnalysisResultWriter;
 class EngineFilterIIRBase;
 class QSqlDatabase;
 
@@ -147,9 +148,12 @@ struct WaveformStride {
 
 class AnalyzerWaveform : public Analyzer {
   public:
+    /// The results are saved in the background if a result
+    /// writer is provided, otherwise immediately.
     AnalyzerWaveform(
             UserSettingsPointer pConfig,
-            const QSqlDatabase& dbConnection);
+            const QSqlDatabase& dbConnection,
+            AnalysisResultWriter* pResultWriter = nullptr);
     ~AnalyzerWaveform() override;
 
     bool initialize(const AnalyzerTrack& track,
@@ -170,6 +174,7 @@ class AnalyzerWaveform : public Analyzer {
     void storeIfGreater(float* pDest, float source);
 
     mutable AnalysisDao m_analysisDao;
+    AnalysisResultWriter* const m_pResultWriter;
 
     WaveformPointer m_waveform;
     WaveformPointer m_waveformSummary;
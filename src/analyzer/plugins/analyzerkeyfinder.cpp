@@ -1,6 +1,7 @@
 #include "analyzer/plugins/analyzerkeyfinder.h"
 
 #include "analyzer/constants.h"
+#include "analyzer/plugins/buffering_utils.h"
 #include "util/assert.h"
 
 using mixxx::track::io::key::ChromaticKey;
@@ -81,24 +82,43 @@ AnalyzerPluginInfo AnalyzerKeyFinder::pluginInfo() {
 
 bool AnalyzerKeyFinder::initialize(mixxx::audio::SampleRate sampleRate) {
     m_audioData.setFrameRate(sampleRate);
-    m_audioData.setChannels(kAnalysisChannels);
+    // KeyFinder analyzes a mono signal. It is passed the shared downmix
+    // instead of reducing each chunk to mono itself.
+    m_audioData.setChannels(1);
     return true;
 }
 
 bool AnalyzerKeyFinder::processSamples(const CSAMPLE* pIn, SINT iLen) {
     DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
-    if (m_audioData.getSampleCount() == 0) {
-        m_audioData.addToSampleCount(iLen);
+    const SINT numInputFrames = iLen / kAnalysisChannels;
+    if (static_cast<SINT>(m_downmix.size()) < numInputFrames) {
+        m_downmix.resize(numInputFrames);
     }
+    DownmixAndOverlapHelper::downmixStereoSamples(m_downmix.data(), pIn, iLen);
+    return processDownmixedFrames(m_downmix.data(), numInputFrames);
+}
 
-    const SINT numInputFrames = iLen / kAnalysisChannels;
-    m_currentFrame += numInputFrames;
+bool AnalyzerKeyFinder::processDownmixedSamples(
+        const CSAMPLE* /*pIn*/, const double* pDownmix, SINT iLen) {
+    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
+    return processDownmixedFrames(pDownmix, iLen / kAnalysisChannels);
+}
+
+bool AnalyzerKeyFinder::processDownmixedFrames(const double* pDownmix, SINT numFrames) {
+    // The buffer must contain exactly the frames of this chunk, e.g. the
+    // last chunk is usually shorter
+    if (m_audioData.getFrameCount() != static_cast<unsigned int>(numFrames)) {
+        const unsigned int frameRate = m_audioData.getFrameRate();
+        m_audioData = KeyFinder::AudioData();
+        m_audioData.setFrameRate(frameRate);
+        m_audioData.setChannels(1);
+        m_audioData.addToFrameCount(static_cast<unsigned int>(numFrames));
+    }
+
+    m_currentFrame += numFrames;
 
-    for (SINT frame = 0; frame < numInputFrames; frame++) {
-        for (SINT channel = 0; channel < kAnalysisChannels; channel++) {
-            m_audioData.setSampleByFrame(
-                    frame, channel, pIn[frame * kAnalysisChannels + channel]);
-        }
+    for (SINT frame = 0; frame < numFrames; frame++) {
+        m_audioData.setSample(frame, pDownmix[frame]);
     }
     m_keyFinder.progressiveChromagram(m_audioData, m_workspace);
     return true;
@@ -1,6 +1,8 @@
 #pragma once
 #include <keyfinder/keyfinder.h>
 
+#include <vector>
+
 #include "analyzer/plugins/analyzerplugin.h"
 #include "util/types.h"
 
@@ -19,6 +21,8 @@ class AnalyzerKeyFinder : public AnalyzerKeyPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processDownmixedSamples(
+            const CSAMPLE* pIn, const double* pDownmix, SINT iLen) override;
     bool finalize() override;
 
     KeyChangeList getKeyChanges() const override {
@@ -26,9 +30,13 @@ class AnalyzerKeyFinder : public AnalyzerKeyPlugin {
     }
 
   private:
+    bool processDownmixedFrames(const double* pDownmix, SINT numFrames);
+
     KeyFinder::KeyFinder m_keyFinder;
     KeyFinder::Workspace m_workspace;
     KeyFinder::AudioData m_audioData;
+    // Only used if the downmix is not passed in
+    std::vector<double> m_downmix;
 
     SINT m_currentFrame;
     KeyChangeList m_resultKeys;
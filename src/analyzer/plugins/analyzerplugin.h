@@ -62,6 +62,12 @@ class AnalyzerPlugin {
 
     virtual bool initialize(mixxx::audio::SampleRate sampleRate) = 0;
     virtual bool processSamples(const CSAMPLE* pIn, SINT iLen) = 0;
+    // Like processSamples() with an additional mono downmix of the
+    // samples, i.e. one value per frame.
+    virtual bool processDownmixedSamples(
+            const CSAMPLE* pIn, const double* /*pDownmix*/, SINT iLen) {
+        return processSamples(pIn, iLen);
+    }
     virtual bool finalize() = 0;
 };
 
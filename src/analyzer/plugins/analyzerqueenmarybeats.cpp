@@ -74,6 +74,16 @@ bool AnalyzerQueenMaryBeats::processSamples(const CSAMPLE* pIn, SINT iLen) {
     return m_helper.processStereoSamples(pIn, iLen);
 }
 
+bool AnalyzerQueenMaryBeats::processDownmixedSamples(
+        const CSAMPLE* /*pIn*/, const double* pDownmix, SINT iLen) {
+    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
+    if (!m_pDetectionFunction) {
+        return false;
+    }
+
+    return m_helper.processDownmixedFrames(pDownmix, iLen / kAnalysisChannels);
+}
+
 bool AnalyzerQueenMaryBeats::finalize() {
     m_helper.finalize();
 
@@ -32,6 +32,8 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processDownmixedSamples(
+            const CSAMPLE* pIn, const double* pDownmix, SINT iLen) override;
     bool finalize() override;
 
     bool supportsBeatTracking() const override {
@@ -87,6 +87,18 @@ bool AnalyzerQueenMaryKey::processSamples(const CSAMPLE* pIn, SINT iLen) {
     return m_helper.processStereoSamples(pIn, iLen);
 }
 
+bool AnalyzerQueenMaryKey::processDownmixedSamples(
+        const CSAMPLE* /*pIn*/, const double* pDownmix, SINT iLen) {
+    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
+    if (!m_pKeyMode) {
+        return false;
+    }
+
+    const size_t numInputFrames = iLen / kAnalysisChannels;
+    m_currentFrame += numInputFrames;
+    return m_helper.processDownmixedFrames(pDownmix, numInputFrames);
+}
+
 bool AnalyzerQueenMaryKey::finalize() {
     m_helper.finalize();
     m_pKeyMode.reset();
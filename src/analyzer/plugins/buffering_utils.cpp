@@ -1,5 +1,7 @@
 #include "analyzer/plugins/buffering_utils.h"
 
+#include <algorithm>
+
 #include "util/math.h"
 
 namespace mixxx {
@@ -20,7 +22,24 @@ bool DownmixAndOverlapHelper::initialize(size_t windowSize,
 
 bool DownmixAndOverlapHelper::processStereoSamples(const CSAMPLE* pInput, size_t inputStereoSamples) {
     const size_t numInputFrames = inputStereoSamples / 2;
-    return processInner(pInput, numInputFrames);
+    return processInner(pInput, nullptr, numInputFrames);
+}
+
+bool DownmixAndOverlapHelper::processDownmixedFrames(
+        const double* pDownmix, size_t numInputFrames) {
+    DEBUG_ASSERT(pDownmix);
+    return processInner(nullptr, pDownmix, numInputFrames);
+}
+
+// static
+void DownmixAndOverlapHelper::downmixStereoSamples(
+        double* pDownmix, const CSAMPLE* pInput, size_t inputStereoSamples) {
+    // note: LOOP VECTORIZED.
+    for (size_t i = 0; i < inputStereoSamples / 2; ++i) {
+        // We analyze a mono downmix of the signal since we don't think
+        // stereo does us any good.
+        pDownmix[i] = (pInput[i * 2] + pInput[i * 2 + 1]) * 0.5;
+    }
 }
 
 bool DownmixAndOverlapHelper::finalize() {
@@ -31,11 +50,11 @@ bool DownmixAndOverlapHelper::finalize() {
     // instead of "m_windowSize / 2 - m_stepSize"
     size_t framesToFillWindow = m_windowSize - m_bufferWritePosition;
     size_t numInputFrames = math_max(framesToFillWindow, m_windowSize / 2 - 1);
-    return processInner(nullptr, numInputFrames);
+    return processInner(nullptr, nullptr, numInputFrames);
 }
 
 bool DownmixAndOverlapHelper::processInner(
-        const CSAMPLE* pInput, size_t numInputFrames) {
+        const CSAMPLE* pInput, const double* pDownmixInput, size_t numInputFrames) {
     size_t inRead = 0;
     double* pDownmix = m_buffer.data();
 
@@ -44,14 +63,14 @@ bool DownmixAndOverlapHelper::processInner(
         DEBUG_ASSERT(m_bufferWritePosition <= m_windowSize);
         size_t writeAvailable = m_windowSize - m_bufferWritePosition;
         size_t numFrames = math_min(readAvailable, writeAvailable);
-        if (pInput) {
-            for (size_t i = 0; i < numFrames; ++i) {
-                // We analyze a mono downmix of the signal since we don't think
-                // stereo does us any good.
-                pDownmix[m_bufferWritePosition + i] = (pInput[(inRead + i) * 2] +
-                                                              pInput[(inRead + i) * 2 + 1]) *
-                        0.5;
-            }
+        if (pDownmixInput) {
+            std::copy(pDownmixInput + inRead,
+                    pDownmixInput + inRead + numFrames,
+                    pDownmix + m_bufferWritePosition);
+        } else if (pInput) {
+            downmixStereoSamples(pDownmix + m_bufferWritePosition,
+                    pInput + inRead * 2,
+                    numFrames * 2);
         } else {
             // we are in the finalize call. Add silence to
             // complete samples left in th buffer.
@@ -25,10 +25,26 @@ class DownmixAndOverlapHelper {
             const CSAMPLE* pInput,
             size_t inputStereoSamples);
 
+    // Processes a mono signal that has already been downmixed by
+    // downmixStereoSamples(), which produces the same windows as
+    // processStereoSamples() for the corresponding stereo signal.
+    bool processDownmixedFrames(
+            const double* pDownmix,
+            size_t numInputFrames);
+
     bool finalize();
 
+    // Computes the mono downmix that is used for the analysis.
+    static void downmixStereoSamples(
+            double* pDownmix,
+            const CSAMPLE* pInput,
+            size_t inputStereoSamples);
+
   private:
-    bool processInner(const CSAMPLE* pInput, size_t numInputFrames);
+    bool processInner(
+            const CSAMPLE* pInput,
+            const double* pDownmix,
+            size_t numInputFrames);
 
     std::vector<double> m_buffer;
     // The window size in frames.
@@ -5,6 +5,7 @@
 #include "moc_trackanalysisscheduler.cpp"
 #include "track/trackid.h"
 #include "util/logger.h"
+#include "util/math.h"
 
 namespace {
 
@@ -53,9 +54,24 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         const UserSettingsPointer& pConfig,
         AnalyzerModeFlags modeFlags)
         : m_pEnvironment(std::move(pEnvironment)),
+          m_numPipelineCores(pConfig &&
+                                  pConfig->getValue(ConfigKey(QStringLiteral("[Library]"),
+                                                            QStringLiteral("EnablePipelinedAnalysis")),
+                                          false)
+                          ? QThread::idealThreadCount()
+                          : 0),
+          m_numDecodeCores(pConfig &&
+                                  pConfig->getValue(ConfigKey(QStringLiteral("[Library]"),
+                                                            QStringLiteral("EnableParallelDecoding")),
+                                          false)
+                          ? QThread::idealThreadCount()
+                          : 0),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
+          // The worker threads are started in a suspended state
+          m_suspended(true),
+          m_throttlePaused(false),
           // The first signal should always be emitted
           m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration) {
     DEBUG_ASSERT(m_pEnvironment);
@@ -263,16 +279,60 @@ int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>&
 
 void TrackAnalysisScheduler::suspend() {
     kLogger.debug() << "Suspending";
-    for (auto& worker: m_workers) {
-        worker.suspendThread();
-    }
+    m_suspended = true;
+    suspendOrResumeWorkers();
 }
 
 void TrackAnalysisScheduler::resume() {
     kLogger.debug() << "Resuming";
+    m_suspended = false;
+    suspendOrResumeWorkers();
+}
+
+void TrackAnalysisScheduler::setThrottle(mixxx::Duration delayPerChunk, bool paused) {
     for (auto& worker: m_workers) {
-        worker.resumeThread();
+        worker.setThrottleDelay(delayPerChunk);
+    }
+    if (paused != m_throttlePaused) {
+        m_throttlePaused = paused;
+        suspendOrResumeWorkers();
+    }
+}
+
+void TrackAnalysisScheduler::suspendOrResumeWorkers() {
+    if (m_suspended || m_throttlePaused) {
+        for (auto& worker: m_workers) {
+            worker.suspendThread();
+        }
+    } else {
+        for (auto& worker: m_workers) {
+            worker.resumeThread();
+        }
+    }
+}
+
+int TrackAnalysisScheduler::numConcurrentTracks() const {
+    return math_max(1,
+            math_min(static_cast<int>(m_workers.size()),
+                    static_cast<int>(m_pendingTrackIds.size() + m_queuedTracks.size())));
+}
+
+int TrackAnalysisScheduler::numPipelineThreads() const {
+    if (m_numPipelineCores <= 0) {
+        return 0;
+    }
+    // Each of the tracks that are analyzed concurrently gets an equal
+    // share of the cores. The worker thread itself occupies one of them.
+    return math_max(0, m_numPipelineCores / numConcurrentTracks() - 1);
+}
+
+int TrackAnalysisScheduler::numDecodeThreads() const {
+    if (m_numDecodeCores <= 0) {
+        return 0;
     }
+    // Same share as for the pipeline. Even a single decoding thread
+    // lets the worker thread analyze while the next segment is decoded.
+    return math_max(0, m_numDecodeCores / numConcurrentTracks() - 1);
 }
 
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
@@ -286,6 +346,8 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     m_pEnvironment->loadTrackById(nextTrackId);
             if (nextTrackPtr) {
                 AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
+                worker->setNumPipelineThreads(numPipelineThreads());
+                worker->setNumDecodeThreads(numDecodeThreads());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
                     if (worker->submitNextTrack(std::move(nextTrack))) {
                         m_queuedTracks.pop_front();
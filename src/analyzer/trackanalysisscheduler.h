@@ -63,6 +63,10 @@ class TrackAnalysisScheduler : public QObject {
     // Stops a running analysis and discards all enqueued tracks.
     void stop();
 
+    // Slows down or pauses the analysis independent of suspend() and
+    // resume(), see AnalysisThrottle.
+    void setThrottle(mixxx::Duration delayPerChunk, bool paused);
+
   signals:
     // Progress for individual tracks is passed-through from the workers
     void trackProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
@@ -105,6 +109,22 @@ class TrackAnalysisScheduler : public QObject {
             return m_thread->submitNextTrack(std::move(track));
         }
 
+        void setNumPipelineThreads(int numPipelineThreads) {
+            DEBUG_ASSERT(m_thread);
+            m_thread->setNumPipelineThreads(numPipelineThreads);
+        }
+
+        void setNumDecodeThreads(int numDecodeThreads) {
+            DEBUG_ASSERT(m_thread);
+            m_thread->setNumDecodeThreads(numDecodeThreads);
+        }
+
+        void setThrottleDelay(mixxx::Duration delayPerChunk) {
+            if (m_thread) {
+                m_thread->setThrottleDelay(delayPerChunk);
+            }
+        }
+
         void suspendThread() {
             if (m_thread) {
                 m_thread->suspend();
@@ -140,7 +160,13 @@ class TrackAnalysisScheduler : public QObject {
     };
 
     bool submitNextTrack(Worker* worker);
+    int numConcurrentTracks() const;
+    // The number of additional threads for analyzing the next track
+    int numPipelineThreads() const;
+    // The number of additional threads for decoding the next track
+    int numDecodeThreads() const;
     void emitProgressOrFinished();
+    void suspendOrResumeWorkers();
 
     bool allTracksFinished() const {
         return m_queuedTracks.empty() &&
@@ -149,6 +175,15 @@ class TrackAnalysisScheduler : public QObject {
 
     const std::unique_ptr<const TrackAnalysisSchedulerEnvironment> m_pEnvironment;
 
+    // The number of cores that are shared by the analysis of all pending
+    // tracks. Idle cores are used for analyzing a single track with multiple
+    // threads if there are fewer pending tracks than cores, e.g. at the end
+    // of a batch analysis. 0 if pipelined analysis is disabled.
+    const int m_numPipelineCores;
+    // The number of cores that are shared for decoding FLAC files in
+    // segments, see AudioSourceParallelProxy. 0 if disabled.
+    const int m_numDecodeCores;
+
     std::vector<Worker> m_workers;
 
     std::deque<AnalyzerScheduledTrack> m_queuedTracks;
@@ -163,6 +198,11 @@ class TrackAnalysisScheduler : public QObject {
 
     int m_dequeuedTracksCount;
 
+    // The workers are only running if neither suspended by the
+    // owner nor paused by the throttle
+    bool m_suspended;
+    bool m_throttlePaused;
+
     typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
 };
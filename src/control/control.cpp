@@ -1,7 +1,10 @@
 #include "control/control.h"
 
+#include <atomic>
+
 #include "control/controlobject.h"
 #include "moc_control.cpp"
+#include "util/controllerlatency.h"
 #include "util/stat.h"
 
 namespace {
@@ -27,6 +30,9 @@ QHash<ConfigKey, ConfigKey> s_qCOAliasHash
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
+
+/// Incremented after each insertion into s_qCOHash
+std::atomic<quint64> s_registrationCount{0};
 } // namespace
 
 ControlDoublePrivate::ControlDoublePrivate()
@@ -129,6 +135,12 @@ void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey&
 
     s_qCOAliasHash.insert(key, alias);
     s_qCOHash.insert(alias, pControl);
+    s_registrationCount.fetch_add(1, std::memory_order_release);
+}
+
+// static
+quint64 ControlDoublePrivate::registrationCount() {
+    return s_registrationCount.load(std::memory_order_acquire);
 }
 
 // static
@@ -194,6 +206,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         const MMutexLocker locker(&s_qCOHashMutex);
         //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
         s_qCOHash.insert(key, pControl);
+        s_registrationCount.fetch_add(1, std::memory_order_release);
         return pControl;
     }
 
@@ -295,6 +308,7 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
         return;
     }
     m_value.setValue(value);
+    mixxx::ControllerLatency::controlChanged();
     emit valueChanged(value, pSender);
 
     if (m_bTrack) {
@@ -57,6 +57,11 @@ class ControlDoublePrivate : public QObject {
             double defaultValue = 0.0);
     static QSharedPointer<ControlDoublePrivate> getDefaultControl();
 
+    // Increases whenever a control or an alias has been added. Callers that
+    // cache failed lookups only need to retry if this has changed.
+    // Lock-free.
+    static quint64 registrationCount();
+
     // Returns a list of all existing instances.
     static QList<QSharedPointer<ControlDoublePrivate>> getAllInstances();
     // Clears all existing instances and returns them as a list.
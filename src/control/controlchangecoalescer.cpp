@@ -0,0 +1,124 @@
+#include "control/controlchangecoalescer.h"
+
+#include <QCoreApplication>
+#include <QPointer>
+#include <QThread>
+#include <QVarLengthArray>
+#include <atomic>
+
+#include "control/control.h"
+#include "control/controlproxy.h"
+#include "moc_controlchangecoalescer.cpp"
+#include "util/assert.h"
+
+namespace {
+
+std::atomic<bool> s_enabled{false};
+
+bool isMainThread() {
+    return QCoreApplication::instance() &&
+            QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+
+} // anonymous namespace
+
+struct ControlChangeCoalescer::Entry {
+    // Written from any thread that changes the control
+    std::atomic<bool> dirty{false};
+    std::atomic<QObject*> pLastSetter{nullptr};
+
+    // Only accessed from the main thread
+    QSharedPointer<ControlDoublePrivate> pControl;
+    QMetaObject::Connection connection;
+    QVector<QPointer<ControlProxy>> proxies;
+};
+
+// static
+void ControlChangeCoalescer::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+// static
+bool ControlChangeCoalescer::isEnabled() {
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+// static
+ControlChangeCoalescer* ControlChangeCoalescer::instance() {
+    DEBUG_ASSERT(isMainThread());
+    // Intentionally leaked, because ControlProxys may outlive any owner.
+    static ControlChangeCoalescer* s_pInstance = new ControlChangeCoalescer();
+    return s_pInstance;
+}
+
+// static
+bool ControlChangeCoalescer::subscribe(ControlProxy* pProxy,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    if (!isEnabled() || !isMainThread() || pProxy->thread() != QThread::currentThread()) {
+        return false;
+    }
+    ControlChangeCoalescer* pCoalescer = instance();
+    QSharedPointer<Entry>& pEntry = pCoalescer->m_entries[pControl.data()];
+    if (!pEntry) {
+        pEntry = QSharedPointer<Entry>::create();
+        pEntry->pControl = pControl;
+        // The direct connection runs in the thread that changes the control
+        // and only touches the atomics. The lambda keeps the entry alive,
+        // even if the connection is removed while a change is emitted.
+        QSharedPointer<Entry> pEntryRef = pEntry;
+        pEntry->connection = connect(pControl.data(),
+                &ControlDoublePrivate::valueChanged,
+                pCoalescer,
+                [pEntryRef](double value, QObject* pSetter) {
+                    Q_UNUSED(value);
+                    pEntryRef->pLastSetter.store(pSetter, std::memory_order_relaxed);
+                    pEntryRef->dirty.store(true, std::memory_order_release);
+                },
+                Qt::DirectConnection);
+    }
+    if (!pEntry->proxies.contains(pProxy)) {
+        pEntry->proxies.append(pProxy);
+    }
+    return true;
+}
+
+// static
+void ControlChangeCoalescer::unsubscribe(ControlProxy* pProxy,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    ControlChangeCoalescer* pCoalescer = instance();
+    const auto it = pCoalescer->m_entries.find(pControl.data());
+    if (it == pCoalescer->m_entries.end()) {
+        return;
+    }
+    QSharedPointer<Entry> pEntry = it.value();
+    pEntry->proxies.removeAll(pProxy);
+    if (pEntry->proxies.isEmpty()) {
+        disconnect(pEntry->connection);
+        pCoalescer->m_entries.erase(it);
+    }
+}
+
+// static
+void ControlChangeCoalescer::dispatch() {
+    if (!isEnabled()) {
+        return;
+    }
+    ControlChangeCoalescer* pCoalescer = instance();
+    // Listeners may subscribe or unsubscribe proxies while being notified
+    QVarLengthArray<QSharedPointer<Entry>, 256> dirtyEntries;
+    for (const auto& pEntry : std::as_const(pCoalescer->m_entries)) {
+        if (pEntry->dirty.exchange(false, std::memory_order_acquire)) {
+            dirtyEntries.append(pEntry);
+        }
+    }
+    for (const auto& pEntry : std::as_const(dirtyEntries)) {
+        const double value = pEntry->pControl->get();
+        QObject* pSetter = pEntry->pLastSetter.load(std::memory_order_relaxed);
+        const QVector<QPointer<ControlProxy>> proxies = pEntry->proxies;
+        for (const auto& pProxy : proxies) {
+            if (pProxy) {
+                pProxy->slotValueChangedAuto(value, pSetter);
+            }
+        }
+    }
+}
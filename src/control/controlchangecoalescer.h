@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+
+class ControlDoublePrivate;
+class ControlProxy;
+
+/// Coalesces the value change notifications of controls for ControlProxys
+/// that live in the main thread.
+///
+/// Without coalescing, each change of a control from another thread posts
+/// one event per connected ControlProxy into the event loop of the main
+/// thread, e.g. for every processed audio buffer or every controller
+/// message. When coalescing is enabled, changes only mark the control as
+/// dirty, and dispatch() notifies all subscribed proxies once with the
+/// latest value. dispatch() is called once per GUI frame by GuiTick.
+///
+/// Listeners no longer see intermediate values, so this is an optional
+/// mode, see [App],coalesce_control_changes. ControlProxys that have been
+/// connected before it was enabled are not affected.
+class ControlChangeCoalescer : public QObject {
+    Q_OBJECT
+  public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /// Subscribes the proxy for coalesced notifications. Returns false if
+    /// coalescing is disabled or the proxy does not live in the main thread,
+    /// then the proxy must connect to the control directly.
+    static bool subscribe(ControlProxy* pProxy,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+    static void unsubscribe(ControlProxy* pProxy,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+
+    /// Notifies the subscribed proxies of all controls that have been changed
+    /// since the last call. Must be called from the main thread.
+    static void dispatch();
+
+  private:
+    struct Entry;
+
+    ControlChangeCoalescer() = default;
+    static ControlChangeCoalescer* instance();
+
+    QHash<ControlDoublePrivate*, QSharedPointer<Entry>> m_entries;
+};
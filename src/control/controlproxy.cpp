@@ -8,7 +8,9 @@ ControlProxy::ControlProxy(const QString& g, const QString& i, QObject* pParent,
 }
 
 ControlProxy::ControlProxy(const ConfigKey& key, QObject* pParent, ControlFlags flags)
-        : QObject(pParent) {
+        : QObject(pParent),
+          m_coalesced(false),
+          m_flightRecorderName(FlightRecorder::kInvalidName) {
     m_pControl = ControlDoublePrivate::getControl(key, flags);
     if (!m_pControl) {
         DEBUG_ASSERT(flags & ControlFlag::AllowMissingOrInvalid);
@@ -19,8 +21,26 @@ ControlProxy::ControlProxy(const ConfigKey& key, QObject* pParent, ControlFlags
 
 ControlProxy::~ControlProxy() {
     //qDebug() << "ControlProxy::~ControlProxy()";
+    if (m_coalesced) {
+        ControlChangeCoalescer::unsubscribe(this, m_pControl);
+    }
 }
 
 const ConfigKey& ControlProxy::getKey() const {
     return m_pControl->getKey();
 }
+
+void ControlProxy::recordChange() {
+    if (FlightRecorder::isInCallback()) {
+        return;
+    }
+    if (m_flightRecorderName == FlightRecorder::kInvalidName) {
+        const ConfigKey& key = m_pControl->getKey();
+        if (!key.isValid()) {
+            return;
+        }
+        m_flightRecorderName = FlightRecorder::instance().registerName(
+                key.group + QChar(',') + key.item);
+    }
+    FlightRecorder::instance().recordInstant(m_flightRecorderName, m_pControl->get());
+}
@@ -5,7 +5,9 @@
 #include <QString>
 
 #include "control/control.h"
+#include "control/controlchangecoalescer.h"
 #include "preferences/usersettings.h"
+#include "util/flightrecorder.h"
 
 //// This class is the successor of ControlObjectThread. It should be used for
 /// new code to avoid unnecessary locking during send if no slot is connected.
@@ -83,6 +85,14 @@ class ControlProxy : public QObject {
         // throws a [-Wclazy-lambda-unique-connection] warning.
         switch (requestedConnectionType) {
         case Qt::AutoConnection:
+            // Changes from other threads are delivered once per GUI frame
+            // if enabled.
+            if (!m_coalesced && ControlChangeCoalescer::subscribe(this, m_pControl)) {
+                m_coalesced = true;
+            }
+            if (m_coalesced) {
+                break;
+            }
             connect(m_pControl.data(), &ControlDoublePrivate::valueChanged, this, &ControlProxy::slotValueChangedAuto, copConnection);
             break;
         case Qt::DirectConnection:
@@ -137,10 +147,12 @@ class ControlProxy : public QObject {
     /// Sets the control value to v. Thread safe, non-blocking.
     void set(double v) {
         m_pControl->set(v, this);
+        recordChange();
     }
     /// Sets the control parameterized value to v. Thread safe, non-blocking.
     void setParameter(double v) {
         m_pControl->setParameter(v, this);
+        recordChange();
     }
     /// Resets the control to its default value. Thread safe, non-blocking.
     void reset() {
@@ -150,6 +162,7 @@ class ControlProxy : public QObject {
         // us. For this reason, we provide NULL here so that the change is
         // not filtered in valueChanged()
         m_pControl->reset();
+        recordChange();
     }
 
   signals:
@@ -185,4 +198,17 @@ class ControlProxy : public QObject {
   protected:
     /// Pointer to connected control.
     QSharedPointer<ControlDoublePrivate> m_pControl;
+
+  private:
+    /// Records the change in the FlightRecorder unless it has been made by
+    /// the engine
+    void recordChange();
+
+    /// Whether changes are received from the ControlChangeCoalescer
+    bool m_coalesced;
+
+    /// Registered on the first change
+    FlightRecorder::NameId m_flightRecorderName;
+
+    friend class ControlChangeCoalescer;
 };
@@ -0,0 +1,20 @@
+#include "control/controlsnapshot.h"
+
+ControlSnapshot::Proxy ControlSnapshot::subscribe(
+        const ConfigKey& key, ControlFlags flags) {
+    QSharedPointer<ControlDoublePrivate> pControl =
+            ControlDoublePrivate::getControl(key, flags);
+    if (!pControl) {
+        DEBUG_ASSERT(flags & ControlFlag::AllowMissingOrInvalid);
+        pControl = ControlDoublePrivate::getDefaultControl();
+    }
+    for (std::size_t i = 0; i < m_controls.size(); ++i) {
+        if (m_controls[i] == pControl.data()) {
+            return Proxy(this, static_cast<int>(i));
+        }
+    }
+    m_controls.push_back(pControl.data());
+    m_values.push_back(pControl->get());
+    m_pControlRefs.push_back(std::move(pControl));
+    return Proxy(this, static_cast<int>(m_controls.size() - 1));
+}
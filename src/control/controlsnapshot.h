@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <vector>
+
+#include "control/control.h"
+
+/// A snapshot of the values of a set of controls, which is taken once at the
+/// start of an audio callback.
+///
+/// Reading the controls through their ControlDoublePrivate objects means one
+/// atomic load from a separate heap object for each read. Instead, the
+/// controls that are read during a callback are subscribed once and their
+/// values are copied into one contiguous array by update(). Afterwards each
+/// read is a plain memory access, and all readers see the same values until
+/// the next update(), even if a control is changed in the meantime.
+///
+/// Note that the values are loaded one after another, so two controls that
+/// are changed together by another thread may still end up in different
+/// snapshots.
+///
+/// Only suitable for controls that are changed from outside of the
+/// callback, because changes within the callback are not visible before the
+/// next update().
+class ControlSnapshot {
+  public:
+    /// A handle to the snapshot value of one control.
+    class Proxy {
+      public:
+        Proxy()
+                : m_pSnapshot(nullptr),
+                  m_index(-1) {
+        }
+
+        bool isSubscribed() const {
+            return m_pSnapshot != nullptr;
+        }
+
+        /// Returns the value at the time of the last update(). Real-time safe.
+        double get() const {
+            DEBUG_ASSERT(isSubscribed());
+            return m_pSnapshot->m_values[m_index];
+        }
+
+        /// Returns the bool interpretation of the value
+        bool toBool() const {
+            return get() > 0.0;
+        }
+
+      private:
+        Proxy(const ControlSnapshot* pSnapshot, int index)
+                : m_pSnapshot(pSnapshot),
+                  m_index(index) {
+        }
+
+        const ControlSnapshot* m_pSnapshot;
+        int m_index;
+
+        friend class ControlSnapshot;
+    };
+
+    ControlSnapshot() = default;
+    ControlSnapshot(const ControlSnapshot&) = delete;
+    ControlSnapshot& operator=(const ControlSnapshot&) = delete;
+
+    /// Adds a control to the snapshot and loads its current value. If the
+    /// control is missing and ControlFlag::AllowMissingOrInvalid is passed,
+    /// the value is always 0. Subscribing the same control twice returns the
+    /// same value.
+    ///
+    /// Must not be called concurrently with update().
+    Proxy subscribe(const ConfigKey& key, ControlFlags flags = ControlFlag::None);
+
+    /// Loads the current values of all subscribed controls and returns true
+    /// if any of them has changed since the last update(). Real-time safe.
+    bool update() {
+        bool changed = false;
+        for (std::size_t i = 0; i < m_controls.size(); ++i) {
+            const double value = m_controls[i]->get();
+            changed |= value != m_values[i];
+            m_values[i] = value;
+        }
+        return changed;
+    }
+
+    int size() const {
+        return static_cast<int>(m_values.size());
+    }
+
+  private:
+    // Struct of arrays, so update() and the readers touch as few cache
+    // lines as possible. The shared pointers only keep the controls alive.
+    std::vector<const ControlDoublePrivate*> m_controls;
+    std::vector<double> m_values;
+    std::vector<QSharedPointer<ControlDoublePrivate>> m_pControlRefs;
+};
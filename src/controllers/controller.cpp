@@ -6,6 +6,7 @@
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 #include "moc_controller.cpp"
 #include "util/cmdlineargs.h"
+#include "util/inputtimestamp.h"
 #include "util/screensaver.h"
 
 namespace {
@@ -162,6 +163,7 @@ void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
         qCDebug(m_logInput).noquote() << message;
     }
 
+    const mixxx::ScopedInputTimestamp inputTimestamp(timestamp);
     m_pScriptEngineLegacy->handleIncomingData(data);
 }
 void Controller::slotBeforeEngineShutdown() {
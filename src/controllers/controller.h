@@ -178,6 +178,7 @@ class Controller : public QObject {
     friend class ControllerJSProxy;
     // accesses lots of our stuff, but in the same thread
     friend class ControllerManager;
+    friend class ControllerPoller;
     // For testing
     friend class LegacyControllerMappingValidationTest;
     friend class MidiControllerTest;
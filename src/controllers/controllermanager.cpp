@@ -10,8 +10,7 @@
 #include "moc_controllermanager.cpp"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qmutex.h"
-#include "util/duration.h"
-#include "util/time.h"
+#include "util/threadplacement.h"
 
 #ifdef __PORTMIDI__
 #include "controllers/midi/portmidienumerator.h"
@@ -31,16 +30,22 @@
 
 // http://developer.qt.nokia.com/wiki/Threads_Events_QObjects
 
-// Poll every 1ms (where possible) for good controller response
-#ifdef __LINUX__
-// Many Linux distros ship with the system tick set to 250Hz so 1ms timer
-// reportedly causes CPU hosage. See Bug #990992 rryan 6/2012
-const mixxx::Duration ControllerManager::kPollInterval = mixxx::Duration::fromMillis(5);
-#else
-const mixxx::Duration ControllerManager::kPollInterval = mixxx::Duration::fromMillis(1);
-#endif
-
 namespace {
+
+const ConfigKey kThreadPerControllerConfigKey =
+        ConfigKey(QStringLiteral("[Controller]"), QStringLiteral("ThreadPerController"));
+
+/// Runs the function on the thread of the object and waits until it
+/// has finished.
+template<typename Function>
+void invokeOnThreadOf(QObject* pObject, Function function) {
+    if (pObject->thread() == QThread::currentThread()) {
+        function();
+    } else {
+        QMetaObject::invokeMethod(pObject, function, Qt::BlockingQueuedConnection);
+    }
+}
+
 /// Strip slashes and spaces from device name, so that it can be used as config
 /// key or a filename.
 QString sanitizeDeviceName(QString name) {
@@ -67,6 +72,20 @@ QFileInfo findMappingFile(const QString& pathOrFilename, const QStringList& path
 // kept for backwards compatibility.
 const QString kSettingsGroup = QLatin1String("[ControllerPreset]");
 
+/// Applies the controller thread placement in the started thread itself,
+/// before its event loop is entered.
+void placeControllerThread(QThread* pThread) {
+    QObject::connect(
+            pThread,
+            &QThread::started,
+            pThread,
+            []() {
+                mixxx::ThreadPlacement::applyToCurrentThread(
+                        mixxx::ThreadPlacement::Role::Controller);
+            },
+            Qt::DirectConnection);
+}
+
 } // anonymous namespace
 
 QString firstAvailableFilename(QSet<QString>& filenames,
@@ -92,8 +111,8 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
           // ControllerManager because the CM is moved to its own thread and runs
           // its own event loop.
           m_pControllerLearningEventFilter(new ControllerLearningEventFilter()),
-          m_pollTimer(this),
-          m_skipPoll(false) {
+          m_poller(this),
+          m_threadPerController(m_pConfig->getValue(kThreadPerControllerConfigKey, false)) {
     qRegisterMetaType<std::shared_ptr<LegacyControllerMapping>>(
             "std::shared_ptr<LegacyControllerMapping>");
 
@@ -104,9 +123,6 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
         QDir().mkpath(userMappings);
     }
 
-    m_pollTimer.setInterval(kPollInterval.toIntegerMillis());
-    connect(&m_pollTimer, &QTimer::timeout, this, &ControllerManager::pollDevices);
-
     m_pThread = new QThread;
     m_pThread->setObjectName("Controller");
 
@@ -115,6 +131,7 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
 
     // Controller processing needs to be prioritized since it can affect the
     // audio directly, like when scratching
+    placeControllerThread(m_pThread);
     m_pThread->start(QThread::HighPriority);
 
     connect(this, &ControllerManager::requestInitialize, this, &ControllerManager::slotInitialize);
@@ -167,7 +184,8 @@ void ControllerManager::slotInitialize() {
 }
 
 void ControllerManager::slotShutdown() {
-    stopPolling();
+    m_poller.stopPolling();
+    shutDownControllerThreads();
 
     // Clear m_enumerators before deleting the enumerators to prevent other code
     // paths from accessing them.
@@ -250,7 +268,7 @@ void ControllerManager::slotSetUpDevices() {
         QString name = pController->getName();
 
         if (pController->isOpen()) {
-            pController->close();
+            closeInControllerThread(pController);
         }
 
         // The filename for this device name.
@@ -285,7 +303,10 @@ void ControllerManager::slotSetUpDevices() {
         pMapping->loadSettings(m_pConfig, pController->getName());
 
         // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-        pController->setMapping(pMapping->clone());
+        std::shared_ptr<LegacyControllerMapping> pClonedMapping = pMapping->clone();
+        invokeOnThreadOf(pController, [pController, &pClonedMapping] {
+            pController->setMapping(std::move(pClonedMapping));
+        });
 
         // If we are in safe mode, skip opening controllers.
         if (CmdlineArgs::Instance().getSafeMode()) {
@@ -295,12 +316,11 @@ void ControllerManager::slotSetUpDevices() {
 
         qDebug() << "Opening controller:" << name;
 
-        int value = pController->open();
+        int value = openInControllerThread(pController);
         if (value != 0) {
             qWarning() << "There was a problem opening" << name;
             continue;
         }
-        pController->applyMapping(m_pConfig->getResourcePath());
     }
 
     pollIfAnyControllersOpen();
@@ -311,89 +331,94 @@ void ControllerManager::pollIfAnyControllersOpen() {
     QList<Controller*> controllers = m_controllers;
     locker.unlock();
 
-    bool shouldPoll = false;
-    for (Controller* pController : controllers) {
-        if (pController->isOpen() && pController->isPolling()) {
-            shouldPoll = true;
+    // Controllers on their own thread are polled from there
+    QList<Controller*> sharedThreadControllers;
+    for (Controller* pController : std::as_const(controllers)) {
+        const auto it = m_controllerThreads.constFind(pController);
+        if (it == m_controllerThreads.constEnd()) {
+            sharedThreadControllers.append(pController);
+            continue;
         }
+        ControllerPoller* pPoller = it->pPoller;
+        QMetaObject::invokeMethod(pPoller, [pPoller] {
+            pPoller->pollIfAnyControllersOpen();
+        });
     }
-    if (shouldPoll) {
-        startPolling();
-    } else {
-        stopPolling();
-    }
+    m_poller.setControllers(sharedThreadControllers);
+    m_poller.pollIfAnyControllersOpen();
 }
 
-void ControllerManager::startPolling() {
-    // Start the polling timer.
-    if (!m_pollTimer.isActive()) {
-        m_pollTimer.start();
-        qDebug() << "Controller polling started.";
+void ControllerManager::setUpControllerThread(Controller* pController) {
+    if (!m_threadPerController || m_controllerThreads.contains(pController)) {
+        return;
     }
+    ControllerThread controllerThread;
+    controllerThread.pThread = new QThread;
+    controllerThread.pThread->setObjectName(
+            QStringLiteral("Controller %1").arg(pController->getName()));
+    controllerThread.pPoller = new ControllerPoller;
+    controllerThread.pPoller->setControllers({pController});
+    // Both objects are moved back by shutDownControllerThreads()
+    pController->moveToThread(controllerThread.pThread);
+    controllerThread.pPoller->moveToThread(controllerThread.pThread);
+    // Same priority as the shared controller thread, see constructor
+    placeControllerThread(controllerThread.pThread);
+    controllerThread.pThread->start(QThread::HighPriority);
+    m_controllerThreads.insert(pController, controllerThread);
 }
 
-void ControllerManager::stopPolling() {
-    m_pollTimer.stop();
-    qDebug() << "Controller polling stopped.";
-}
-
-void ControllerManager::pollDevices() {
-    // Note: this function is called from a high priority thread which
-    // may stall the GUI or may reduce the available CPU time for other
-    // High Priority threads like caching reader or broadcasting more
-    // then desired, if it is called endless loop like.
-    //
-    // This especially happens if a controller like the 3x Speed
-    // Stanton SCS.1D emits more massages than Mixxx is able to handle
-    // or a controller like Hercules RMX2 goes wild. In such a case the
-    // receive buffer is stacked up every call to insane values > 500 messages.
-    //
-    // To avoid this we pick here a strategies similar like the audio
-    // thread. In case pollDevice() takes longer than a call cycle
-    // we are cooperative a skip the next cycle to free at least some
-    // CPU time
-    //
-    // Some random test data form a i5-3317U CPU @ 1.70GHz Running
-    // Ubuntu Trusty:
-    // * Idle poll: ~5 µs.
-    // * 5 messages burst (full midi bandwidth): ~872 µs.
-
-    if (m_skipPoll) {
-        // skip poll in overload situation
-        m_skipPoll = false;
-        //qDebug() << "ControllerManager::pollDevices() skip";
-        return;
+void ControllerManager::shutDownControllerThreads() {
+    QThread* pManagerThread = thread();
+    for (auto it = m_controllerThreads.constBegin(); it != m_controllerThreads.constEnd(); ++it) {
+        Controller* pController = it.key();
+        ControllerPoller* pPoller = it->pPoller;
+        // The controllers are deleted by their enumerators on this thread
+        invokeOnThreadOf(pController, [pController, pPoller, pManagerThread] {
+            delete pPoller;
+            if (pController->isOpen()) {
+                pController->close();
+            }
+            pController->moveToThread(pManagerThread);
+        });
+        it->pThread->quit();
+        it->pThread->wait();
+        delete it->pThread;
     }
+    m_controllerThreads.clear();
+}
 
-    mixxx::Duration start = mixxx::Time::elapsed();
-    for (Controller* pDevice : std::as_const(m_controllers)) {
-        if (pDevice->isOpen() && pDevice->isPolling()) {
-            pDevice->poll();
+int ControllerManager::openInControllerThread(Controller* pController) {
+    setUpControllerThread(pController);
+    const QString resourcePath = m_pConfig->getResourcePath();
+    int result = -1;
+    invokeOnThreadOf(pController, [pController, &resourcePath, &result] {
+        if (pController->isOpen()) {
+            pController->close();
         }
-    }
+        result = pController->open();
+        if (result == 0) {
+            pController->applyMapping(resourcePath);
+        }
+    });
+    return result;
+}
 
-    mixxx::Duration duration = mixxx::Time::elapsed() - start;
-    if (duration > kPollInterval) {
-        m_skipPoll = true;
-    }
-    //qDebug() << "ControllerManager::pollDevices()" << duration << start;
+void ControllerManager::closeInControllerThread(Controller* pController) {
+    invokeOnThreadOf(pController, [pController] {
+        pController->close();
+    });
 }
 
 void ControllerManager::openController(Controller* pController) {
     if (!pController) {
         return;
     }
-    if (pController->isOpen()) {
-        pController->close();
-    }
-    int result = pController->open();
+    int result = openInControllerThread(pController);
     pollIfAnyControllersOpen();
 
-    // If successfully opened the device, apply the mapping and save the
-    // preference setting.
+    // If successfully opened the device, the mapping has been applied.
+    // Save the preference setting.
     if (result == 0) {
-        pController->applyMapping(m_pConfig->getResourcePath());
-
         // Update configuration to reflect controller is enabled.
         m_pConfig->setValue(
                 ConfigKey("[Controller]", sanitizeDeviceName(pController->getName())), 1);
@@ -404,7 +429,7 @@ void ControllerManager::closeController(Controller* pController) {
     if (!pController) {
         return;
     }
-    pController->close();
+    closeInControllerThread(pController);
     pollIfAnyControllersOpen();
     // Update configuration to reflect controller is disabled.
     m_pConfig->setValue(
@@ -438,7 +463,10 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     m_pConfig->set(key, pMapping->filePath());
 
     // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-    pController->setMapping(pMapping->clone());
+    std::shared_ptr<LegacyControllerMapping> pClonedMapping = pMapping->clone();
+    invokeOnThreadOf(pController, [pController, &pClonedMapping] {
+        pController->setMapping(std::move(pClonedMapping));
+    });
 
     if (bEnabled) {
         openController(pController);
@@ -1,13 +1,13 @@
 #pragma once
 
+#include <QHash>
 #include <QMutex>
 #include <QSharedPointer>
-#include <QTimer>
 #include <memory>
 
 #include "controllers/controllerenumerator.h"
+#include "controllers/controllerpoller.h"
 #include "preferences/usersettings.h"
-#include "util/duration.h"
 
 // Forward declaration(s)
 class Controller;
@@ -26,8 +26,6 @@ class ControllerManager : public QObject {
     ControllerManager(UserSettingsPointer pConfig);
     virtual ~ControllerManager();
 
-    static const mixxx::Duration kPollInterval;
-
     QList<Controller*> getControllers() const;
     QList<Controller*> getControllerList(bool outputDevices=true, bool inputDevices=true);
     ControllerLearningEventFilter* getControllerLearningEventFilter() const;
@@ -69,21 +67,35 @@ class ControllerManager : public QObject {
     /// preferences dialog on apply, and only open/close changed devices
     void slotSetUpDevices();
     void slotShutdown();
-    /// Calls poll() on all devices that have isPolling() true.
-    void pollDevices();
-    void startPolling();
-    void stopPolling();
     void pollIfAnyControllersOpen();
 
   private:
+    /// A thread that runs the script engine of a single controller, used
+    /// if each controller should run on its own thread.
+    struct ControllerThread {
+        QThread* pThread;
+        ControllerPoller* pPoller;
+    };
+
+    /// Moves the controller to its own thread before it is opened if
+    /// each controller should run on its own thread.
+    void setUpControllerThread(Controller* pController);
+    void shutDownControllerThreads();
+
+    int openInControllerThread(Controller* pController);
+    void closeInControllerThread(Controller* pController);
+
     UserSettingsPointer m_pConfig;
     ControllerLearningEventFilter* m_pControllerLearningEventFilter;
-    QTimer m_pollTimer;
+    ControllerPoller m_poller;
     mutable QMutex m_mutex;
     QList<ControllerEnumerator*> m_enumerators;
     QList<Controller*> m_controllers;
     QThread* m_pThread;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadUserMappingEnumerator;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadSystemMappingEnumerator;
-    bool m_skipPoll;
+    /// A busy mapping of one controller, e.g. one that renders LEDs or
+    /// screens, must not delay the input of the other controllers.
+    const bool m_threadPerController;
+    QHash<Controller*, ControllerThread> m_controllerThreads;
 };
@@ -0,0 +1,118 @@
+#include "controllers/controllerpoller.h"
+
+#include "controllers/controller.h"
+#include "moc_controllerpoller.cpp"
+#include "util/time.h"
+
+// Poll every 1ms while any controller is in use for good controller response,
+// e.g. when scratching with a jog wheel
+const mixxx::Duration ControllerPoller::kPollInterval = mixxx::Duration::fromMillis(1);
+// Poll less frequently while all controllers are idle to avoid waking up the
+// CPU 1000 times per second. This was the poll interval on Linux before,
+// because many Linux distros ship with the system tick set to 250Hz so 1ms
+// timer reportedly caused CPU hosage. See Bug #990992 rryan 6/2012
+const mixxx::Duration ControllerPoller::kIdlePollInterval = mixxx::Duration::fromMillis(5);
+
+namespace {
+
+/// Switch to the idle poll interval if no input has been received
+/// for this time.
+const mixxx::Duration kIdleTimeout = mixxx::Duration::fromMillis(1000);
+
+} // anonymous namespace
+
+ControllerPoller::ControllerPoller(QObject* pParent)
+        : QObject(pParent),
+          m_pollTimer(this),
+          m_skipPoll(false),
+          m_pollInterval(kIdlePollInterval) {
+    connect(&m_pollTimer, &QTimer::timeout, this, &ControllerPoller::pollDevices);
+}
+
+void ControllerPoller::setControllers(const QList<Controller*>& controllers) {
+    m_controllers = controllers;
+}
+
+void ControllerPoller::pollIfAnyControllersOpen() {
+    bool shouldPoll = false;
+    for (Controller* pController : std::as_const(m_controllers)) {
+        if (pController->isOpen() && pController->isPolling()) {
+            shouldPoll = true;
+        }
+    }
+    if (!shouldPoll) {
+        stopPolling();
+    } else if (!m_pollTimer.isActive()) {
+        setIdlePolling(true);
+        m_pollTimer.start();
+        qDebug() << "Controller polling started.";
+    }
+}
+
+void ControllerPoller::stopPolling() {
+    m_pollTimer.stop();
+    qDebug() << "Controller polling stopped.";
+}
+
+void ControllerPoller::setIdlePolling(bool idle) {
+    const auto pollInterval = idle ? kIdlePollInterval : kPollInterval;
+    if (pollInterval == m_pollInterval && m_pollTimer.isActive()) {
+        return;
+    }
+    m_pollInterval = pollInterval;
+    // The idle timer may be delayed slightly for coalescing wake-ups
+    m_pollTimer.setTimerType(idle ? Qt::CoarseTimer : Qt::PreciseTimer);
+    m_pollTimer.setInterval(m_pollInterval.toIntegerMillis());
+}
+
+void ControllerPoller::pollDevices() {
+    // Note: this function is called from a high priority thread which
+    // may stall the GUI or may reduce the available CPU time for other
+    // High Priority threads like caching reader or broadcasting more
+    // then desired, if it is called endless loop like.
+    //
+    // This especially happens if a controller like the 3x Speed
+    // Stanton SCS.1D emits more massages than Mixxx is able to handle
+    // or a controller like Hercules RMX2 goes wild. In such a case the
+    // receive buffer is stacked up every call to insane values > 500 messages.
+    //
+    // To avoid this we pick here a strategies similar like the audio
+    // thread. In case pollDevice() takes longer than a call cycle
+    // we are cooperative a skip the next cycle to free at least some
+    // CPU time
+    //
+    // Some random test data form a i5-3317U CPU @ 1.70GHz Running
+    // Ubuntu Trusty:
+    // * Idle poll: ~5 µs.
+    // * 5 messages burst (full midi bandwidth): ~872 µs.
+
+    if (m_skipPoll) {
+        // skip poll in overload situation
+        m_skipPoll = false;
+        //qDebug() << "ControllerPoller::pollDevices() skip";
+        return;
+    }
+
+    mixxx::Duration start = mixxx::Time::elapsed();
+    bool received = false;
+    for (Controller* pDevice : std::as_const(m_controllers)) {
+        if (pDevice->isOpen() && pDevice->isPolling()) {
+            received |= pDevice->poll();
+        }
+    }
+
+    mixxx::Duration duration = mixxx::Time::elapsed() - start;
+    if (duration > m_pollInterval) {
+        m_skipPoll = true;
+    }
+
+    // Subsequent input is likely while a controller is in use, e.g. when
+    // turning a knob or a jog wheel
+    if (received) {
+        m_lastInput = start;
+        setIdlePolling(false);
+    } else if (start - m_lastInput > kIdleTimeout) {
+        setIdlePolling(true);
+    }
+    //qDebug() << "ControllerPoller::pollDevices()" << duration << start;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QList>
+#include <QTimer>
+
+#include "util/duration.h"
+
+class Controller;
+
+/// Polls the controllers that need polling from the thread that this
+/// object lives in.
+class ControllerPoller : public QObject {
+    Q_OBJECT
+  public:
+    explicit ControllerPoller(QObject* pParent = nullptr);
+
+    static const mixxx::Duration kPollInterval;
+    static const mixxx::Duration kIdlePollInterval;
+
+    void setControllers(const QList<Controller*>& controllers);
+
+    /// Starts polling if any of the controllers is open and needs polling,
+    /// otherwise stops polling.
+    void pollIfAnyControllersOpen();
+    void stopPolling();
+
+  private slots:
+    /// Calls poll() on all devices that have isPolling() true.
+    void pollDevices();
+
+  private:
+    /// Polls less frequently if none of the controllers has received
+    /// any input recently.
+    void setIdlePolling(bool idle);
+
+    QTimer m_pollTimer;
+    QList<Controller*> m_controllers;
+    bool m_skipPoll;
+    mixxx::Duration m_pollInterval;
+    mixxx::Duration m_lastInput;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "controllers/controller.h"
 #include "controllers/hid/hiddevice.h"
 #include "controllers/hid/hidiothread.h"
@@ -115,6 +117,33 @@ class HidControllerJSProxy : public ControllerJSProxy {
                 reportID, dataArray, useNonSkippingFIFO);
     }
 
+    /// @brief Sets the priority of the cached OutputReports with this ReportID
+    /// @param reportID 1...255 for HID devices that uses ReportIDs - or 0 for devices, which don't use ReportIDs
+    /// @param priority 0 (low), 1 (normal, default) or 2 (high)
+    /// @details Changed reports of a higher priority are sent first, e.g. to
+    ///          prevent the displays of jog wheels from delaying button LEDs.
+    ///          Reports sent with useNonSkippingFIFO are always sent first.
+    Q_INVOKABLE void setOutputReportPriority(quint8 reportID, int priority) {
+        VERIFY_OR_DEBUG_ASSERT(m_pHidController->m_pHidIoThread) {
+            return;
+        }
+        m_pHidController->m_pHidIoThread->setOutputReportPriority(reportID,
+                static_cast<HidOutputReportPriority>(std::clamp(priority,
+                        static_cast<int>(HidOutputReportPriority::Low),
+                        static_cast<int>(HidOutputReportPriority::High))));
+    }
+
+    /// @brief Limits the bandwidth of the cached OutputReports
+    /// @param bytesPerSecond Bytes per second including the ReportIDs, 0 for no limit (default)
+    /// @details Devices that are flooded with OutputReports may delay their
+    ///          InputReports. Reports sent with useNonSkippingFIFO are not limited.
+    Q_INVOKABLE void setOutputBandwidth(int bytesPerSecond) {
+        VERIFY_OR_DEBUG_ASSERT(m_pHidController->m_pHidIoThread) {
+            return;
+        }
+        m_pHidController->m_pHidIoThread->setOutputBandwidth(bytesPerSecond);
+    }
+
     /// @brief getInputReport receives an InputReport from the HID device on request.
     /// @details This can be used on startup to initialize the knob positions in Mixxx
     ///          to the physical position of the hardware knobs on the controller.
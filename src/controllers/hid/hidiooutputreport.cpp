@@ -4,6 +4,7 @@
 
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qbytearray.h"
+#include "util/controllerlatency.h"
 #include "util/runtimeloggingcategory.h"
 #include "util/string.h"
 #include "util/time.h"
@@ -13,10 +14,15 @@ constexpr int kReportIdSize = 1;
 constexpr size_t kMaxHidErrorMessageSize = 512;
 } // namespace
 
-HidIoOutputReport::HidIoOutputReport(
-        const quint8& reportId, const unsigned int& reportDataSize)
+HidIoOutputReport::HidIoOutputReport(const quint8& reportId,
+        const unsigned int& reportDataSize,
+        HidOutputReportPriority priority)
         : m_reportId(reportId),
+          m_priority(static_cast<int>(priority)),
+          m_reportSize(kReportIdSize + static_cast<int>(reportDataSize)),
           m_possiblyUnsentDataCached(false),
+          m_changedBegin(kReportIdSize),
+          m_changedEnd(kReportIdSize),
           m_lastCachedDataSize(0) {
     // First byte must always contain the ReportID - also after swapping, therefore initialize both arrays
     m_cachedData.reserve(kReportIdSize + reportDataSize);
@@ -51,6 +57,7 @@ void HidIoOutputReport::updateCachedData(const QByteArray& data,
                     << data.size()
                     << "- This indicates a bug in the mapping code!";
             m_lastCachedDataSize = data.size();
+            m_reportSize.storeRelease(kReportIdSize + m_lastCachedDataSize);
         }
     }
 
@@ -70,45 +77,74 @@ void HidIoOutputReport::updateCachedData(const QByteArray& data,
             m_cachedData.size(),
             data.constData(),
             data.size());
-    m_possiblyUnsentDataCached = true;
-}
-
-bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
-        hid_device* pHidDevice,
-        const RuntimeLoggingCategory& logOutput) {
-    auto startOfHidWrite = mixxx::Time::elapsed();
 
-    auto cacheLock = lockMutex(&m_cachedDataMutex);
-
-    if (!m_possiblyUnsentDataCached) {
-        // Return with false, to signal the caller, that no time consuming IO operation was necessary
-        return false;
-    }
-
-    if (!m_lastSentData.compare(m_cachedData)) {
+    const bool wasUnsentDataCached = m_possiblyUnsentDataCached;
+    m_possiblyUnsentDataCached = updateChangedRange();
+    if (m_possiblyUnsentDataCached) {
+        if (!wasUnsentDataCached) {
+            m_unsentSince = mixxx::Time::elapsed();
+        }
+    } else if (CmdlineArgs::Instance().getControllerDebug()) {
         // An HID OutputReport can contain only HID OutputItems.
         // HID OutputItems are defined to represent the state of one or more similar controls or LEDs.
         // Only HID Feature items may be attributes of other items.
         // This means there is always a one to one relationship to the state of control(s)/LED(s),
         // and if the state is not changed, there's no need to execute the time consuming hid_write again.
+        qCDebug(logOutput) << "t:" << mixxx::Time::elapsed().formatMillisWithUnit()
+                           << "Skipped identical OutputReport data for ReportID"
+                           << m_reportId;
+    }
+}
 
-        // Setting m_possiblyUnsentDataCached to false prevents,
-        // that the byte array compare operation is executed for the same data again
-        m_possiblyUnsentDataCached = false;
+bool HidIoOutputReport::updateChangedRange() {
+    const int size = m_cachedData.size();
+    if (m_lastSentData.size() != size) {
+        // Nothing has been sent yet or sending failed
+        m_changedBegin = kReportIdSize;
+        m_changedEnd = size;
+        return true;
+    }
+    const char* pCachedData = m_cachedData.constData();
+    const char* pLastSentData = m_lastSentData.constData();
+    int begin = kReportIdSize;
+    while (begin < size && pCachedData[begin] == pLastSentData[begin]) {
+        ++begin;
+    }
+    if (begin == size) {
+        return false;
+    }
+    int end = size;
+    while (pCachedData[end - 1] == pLastSentData[end - 1]) {
+        --end;
+    }
+    m_changedBegin = begin;
+    m_changedEnd = end;
+    return true;
+}
 
-        cacheLock.unlock();
+bool HidIoOutputReport::hasUnsentData(mixxx::Duration* pUnsentSince) {
+    const auto cacheLock = lockMutex(&m_cachedDataMutex);
+    if (!m_possiblyUnsentDataCached) {
+        return false;
+    }
+    *pUnsentSince = m_unsentSince;
+    return true;
+}
 
-        if (CmdlineArgs::Instance()
-                        .getControllerDebug()) {
-            qCDebug(logOutput) << "t:" << startOfHidWrite.formatMillisWithUnit()
-                               << "Skipped sending identical OutputReport data "
-                                  "from cache for ReportID"
-                               << m_reportId;
-        }
+bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
+        hid_device* pHidDevice,
+        const RuntimeLoggingCategory& logOutput) {
+    auto startOfHidWrite = mixxx::Time::elapsed();
+
+    auto cacheLock = lockMutex(&m_cachedDataMutex);
 
+    // Identical data have already been skipped by updateCachedData()
+    if (!m_possiblyUnsentDataCached) {
         // Return with false, to signal the caller, that no time consuming IO operation was necessary
         return false;
     }
+    const int changedBytes = m_changedEnd - m_changedBegin;
+    const auto unsentSince = m_unsentSince;
 
     // Preemptively set m_lastSentData and m_possiblyUnsentDataCached,
     // to release the mutex during the time consuming hid_write operation.
@@ -151,12 +187,15 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
         return true;
     }
 
+    mixxx::ControllerLatency::outputSent(unsentSince);
+
     if (CmdlineArgs::Instance()
                     .getControllerDebug()) {
         qCDebug(logOutput) << "t:" << startOfHidWrite.formatMillisWithUnit() << " "
                            << result << "bytes ( including ReportID of"
                            << static_cast<quint8>(m_reportId)
-                           << ") sent from skipping cache - Needed:"
+                           << ") sent from skipping cache with"
+                           << changedBytes << "changed bytes - Needed:"
                            << (mixxx::Time::elapsed() - startOfHidWrite).formatMicrosWithUnit();
     }
 
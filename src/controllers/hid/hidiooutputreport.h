@@ -1,15 +1,43 @@
 #pragma once
 
+#include <QAtomicInt>
 #include <QByteArray>
 
 #include "util/compatibility/qmutex.h"
+#include "util/duration.h"
 
 struct RuntimeLoggingCategory;
 typedef struct hid_device_ hid_device;
 
+/// Changed OutputReports of a higher priority are sent first, e.g. button
+/// LEDs before the displays of jog wheels.
+enum class HidOutputReportPriority : int {
+    Low = 0,
+    Normal = 1,
+    High = 2,
+};
+
 class HidIoOutputReport {
   public:
-    HidIoOutputReport(const quint8& reportId, const unsigned int& reportDataSize);
+    HidIoOutputReport(const quint8& reportId,
+            const unsigned int& reportDataSize,
+            HidOutputReportPriority priority = HidOutputReportPriority::Normal);
+
+    HidOutputReportPriority priority() const {
+        return static_cast<HidOutputReportPriority>(m_priority.loadAcquire());
+    }
+    void setPriority(HidOutputReportPriority priority) {
+        m_priority.storeRelease(static_cast<int>(priority));
+    }
+
+    /// Size of the report on the wire including the ReportID
+    int sizeInBytes() const {
+        return m_reportSize.loadAcquire();
+    }
+
+    /// Returns true if the cached data differ from the data that have
+    /// been sent and stores since when they differ.
+    bool hasUnsentData(mixxx::Duration* pUnsentSince);
 
     /// Caches new report data, which will later send by the IO thread
     void updateCachedData(const QByteArray& data,
@@ -23,7 +51,14 @@ class HidIoOutputReport {
             const RuntimeLoggingCategory& logOutput);
 
   private:
+    /// Determines the range of bytes that differ from the last sent data.
+    /// HID can only transfer whole reports, but reports without changes
+    /// are skipped here before they are queued for the IO thread.
+    bool updateChangedRange();
+
     const quint8 m_reportId;
+    QAtomicInt m_priority;
+    QAtomicInt m_reportSize;
     QByteArray m_lastSentData;
 
     /// Mutex must be locked when reading/writing m_cachedData
@@ -32,6 +67,9 @@ class HidIoOutputReport {
 
     QByteArray m_cachedData;
     bool m_possiblyUnsentDataCached;
+    mixxx::Duration m_unsentSince;
+    int m_changedBegin;
+    int m_changedEnd;
 
     /// Due to swapping of the QbyteArrays, we need to store
     /// this information independent of the QBytearray size
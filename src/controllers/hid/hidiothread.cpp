@@ -2,6 +2,8 @@
 
 #include <hidapi.h>
 
+#include <algorithm>
+
 #include "moc_hidiothread.cpp"
 #include "util/runtimeloggingcategory.h"
 #include "util/string.h"
@@ -21,6 +23,10 @@ constexpr size_t kMaxHidErrorMessageSize = 512;
 // the fastest possible rate of HID devices with USB HighSpeed or USB SuperSpeed interface is 8kHz
 constexpr int kSleepTimeWhenIdleMicros = 250;
 
+// The bandwidth budget accumulates for at most this time, which allows
+// short bursts of output while the device has been idle
+constexpr double kMaxOutputBurstSeconds = 0.01;
+
 QString loggingCategoryPrefix(const QString& deviceName) {
     return QStringLiteral("controller.") +
             RuntimeLoggingCategory::removeInvalidCharsFromCategory(deviceName.toLower());
@@ -40,13 +46,14 @@ HidIoThread::HidIoThread(
           m_pHidDevice(pHidDevice),
           m_lastPollSize(0),
           m_pollingBufferIndex(0),
+          m_outputBytesPerSecond(0),
+          m_outputBudgetBytes(0),
           m_globalOutputReportFifo(),
           m_runLoopSemaphore(1) {
     // Initializing isn't strictly necessary but is good practice.
     for (int i = 0; i < kNumBuffers; i++) {
         memset(m_pPollData[i], 0, kBufferSize);
     }
-    m_outputReportIterator = m_outputReports.begin();
     m_state.storeRelease(static_cast<int>(HidIoThreadState::Initialized));
 }
 
@@ -189,9 +196,12 @@ void HidIoThread::updateCachedOutputReportData(quint8 reportID,
         bool useNonSkippingFIFO) {
     auto mapLock = lockMutex(&m_outputReportMapMutex);
     if (m_outputReports.find(reportID) == m_outputReports.end()) {
-        std::unique_ptr<HidIoOutputReport> pNewOutputReport;
-        m_outputReports[reportID] = std::make_unique<HidIoOutputReport>(
-                reportID, data.size());
+        const auto priorityIt = m_outputReportPriorities.find(reportID);
+        m_outputReports[reportID] = std::make_unique<HidIoOutputReport>(reportID,
+                data.size(),
+                priorityIt != m_outputReportPriorities.end()
+                        ? priorityIt->second
+                        : HidOutputReportPriority::Normal);
     }
 
     // The only mutable operation on m_outputReports is insert
@@ -213,6 +223,43 @@ void HidIoThread::updateCachedOutputReportData(quint8 reportID,
     }
 }
 
+void HidIoThread::setOutputReportPriority(
+        quint8 reportID, HidOutputReportPriority priority) {
+    const auto mapLock = lockMutex(&m_outputReportMapMutex);
+    m_outputReportPriorities[reportID] = priority;
+    const auto it = m_outputReports.find(reportID);
+    if (it != m_outputReports.end()) {
+        it->second->setPriority(priority);
+    }
+}
+
+void HidIoThread::setOutputBandwidth(int bytesPerSecond) {
+    m_outputBytesPerSecond.storeRelease(std::max(bytesPerSecond, 0));
+}
+
+bool HidIoThread::consumeOutputBandwidth(int bytes) {
+    const int bytesPerSecond = m_outputBytesPerSecond.loadAcquire();
+    if (bytesPerSecond == 0 ||
+            // Don't delay the last reports before the device is closed
+            m_state.loadAcquire() ==
+                    static_cast<int>(HidIoThreadState::StopWhenAllReportsSent)) {
+        return true;
+    }
+    const auto now = mixxx::Time::elapsed();
+    // The budget must allow sending the largest report at least
+    const double maxBudgetBytes = std::max(
+            bytesPerSecond * kMaxOutputBurstSeconds, static_cast<double>(bytes));
+    m_outputBudgetBytes = std::min(maxBudgetBytes,
+            m_outputBudgetBytes +
+                    (now - m_lastOutputBudgetUpdate).toDoubleSeconds() * bytesPerSecond);
+    m_lastOutputBudgetUpdate = now;
+    if (m_outputBudgetBytes < bytes) {
+        return false;
+    }
+    m_outputBudgetBytes -= bytes;
+    return true;
+}
+
 bool HidIoThread::sendNextCachedOutputReport() {
     // 1.) Send non-skipping reports from FIFO
     if (m_globalOutputReportFifo.sendNextReportDataset(&m_hidDeviceAndPollMutex,
@@ -224,36 +271,43 @@ bool HidIoThread::sendNextCachedOutputReport() {
     }
 
     // 2.) If non non-skipping reports were in the FIFO, send the skipable reports
-    // from the m_outputReports cache
-
-    // m_outputReports.size() doesn't need mutex protection, because the value of i is not used.
-    // i is just a counter to prevent infinite loop execution.
-    // If the map size increases, this loop will execute one iteration more,
-    // which only has the effect, that one additional lookup operation for unsent data will be executed.
-    for (std::size_t i = 0; i < m_outputReports.size(); i++) {
-        auto mapLock = lockMutex(&m_outputReportMapMutex);
-        if (m_outputReportIterator == m_outputReports.end()) {
-            m_outputReportIterator = m_outputReports.begin();
-        } else {
-            m_outputReportIterator++;
-            if (m_outputReportIterator == m_outputReports.end()) {
-                m_outputReportIterator = m_outputReports.begin();
-            }
+    // from the m_outputReports cache. The report with the highest priority is
+    // sent first, and among those the one that has waited longest, so that
+    // frequently changing reports can't starve the others.
+    HidIoOutputReport* pNextOutputReport = nullptr;
+    mixxx::Duration nextUnsentSince;
+    auto mapLock = lockMutex(&m_outputReportMapMutex);
+    for (const auto& [reportID, pOutputReport] : m_outputReports) {
+        Q_UNUSED(reportID);
+        mixxx::Duration unsentSince;
+        if (!pOutputReport->hasUnsentData(&unsentSince)) {
+            continue;
         }
-        mapLock.unlock();
-
-        // The only mutable operation on m_outputReports is insert
-        // by std::map<Key,T,Compare,Allocator>::operator[]
-        // The standard says that "No iterators or references are invalidated." using this operator.
-        // Therefore m_outputReportIterator doesn't require Mutex protection.
-        if (m_outputReportIterator->second->sendCachedData(
-                    &m_hidDeviceAndPollMutex, m_pHidDevice, m_logOutput)) {
-            // Return after each time consuming sendCachedData
-            return true;
+        if (!pNextOutputReport ||
+                pOutputReport->priority() > pNextOutputReport->priority() ||
+                (pOutputReport->priority() == pNextOutputReport->priority() &&
+                        unsentSince < nextUnsentSince)) {
+            pNextOutputReport = pOutputReport.get();
+            nextUnsentSince = unsentSince;
         }
     }
-    // Returns false if no report required a time consuming sendCachedData
-    return false;
+    mapLock.unlock();
+
+    if (!pNextOutputReport) {
+        // Returns false if no report required a time consuming sendCachedData
+        return false;
+    }
+    if (!consumeOutputBandwidth(pNextOutputReport->sizeInBytes())) {
+        // Wait until the bandwidth budget allows sending the report
+        return false;
+    }
+
+    // The only mutable operation on m_outputReports is insert
+    // by std::map<Key,T,Compare,Allocator>::operator[]
+    // The standard says that "No iterators or references are invalidated." using this operator.
+    // Therefore pNextOutputReport doesn't require Mutex protection.
+    return pNextOutputReport->sendCachedData(
+            &m_hidDeviceAndPollMutex, m_pHidDevice, m_logOutput);
 }
 
 void HidIoThread::sendFeatureReport(
@@ -45,6 +45,9 @@ class HidIoThread : public QThread {
     void updateCachedOutputReportData(quint8 reportID,
             const QByteArray& reportData,
             bool useNonSkippingFIFO);
+    void setOutputReportPriority(quint8 reportID, HidOutputReportPriority priority);
+    /// Limits the bandwidth of the cached OutputReports, 0 for no limit
+    void setOutputBandwidth(int bytesPerSecond);
     QByteArray getInputReport(quint8 reportID);
     void sendFeatureReport(quint8 reportID, const QByteArray& reportData);
     QByteArray getFeatureReport(quint8 reportID);
@@ -55,6 +58,9 @@ class HidIoThread : public QThread {
 
   private:
     bool sendNextCachedOutputReport();
+    /// Returns false if sending the number of bytes now would exceed
+    /// the bandwidth limit.
+    bool consumeOutputBandwidth(int bytes);
 
     void pollBufferedInputReports();
     void processInputReport(int bytesRead);
@@ -81,7 +87,7 @@ class HidIoThread : public QThread {
     int m_pollingBufferIndex;
 
     /// Must be locked when a operation changes the size of the m_outputReports map,
-    /// or when modify the m_outputReportIterator
+    /// or m_outputReportPriorities, or when iterating over m_outputReports
     QMutex m_outputReportMapMutex;
 
     typedef std::map<unsigned char, std::unique_ptr<HidIoOutputReport>> OutputReportMap;
@@ -90,7 +96,12 @@ class HidIoThread : public QThread {
     /// Until then, it's not known, which OutputReports a device/mapping has.
     /// No other modifications to the map are done, until destruction of this class.
     OutputReportMap m_outputReports;
-    OutputReportMap::iterator m_outputReportIterator;
+    /// Priorities that have been set before the first report was sent
+    std::map<unsigned char, HidOutputReportPriority> m_outputReportPriorities;
+
+    QAtomicInt m_outputBytesPerSecond;
+    double m_outputBudgetBytes;
+    mixxx::Duration m_lastOutputBudgetUpdate;
 
     HidIoGlobalOutputReportFifo m_globalOutputReportFifo;
 
@@ -4,6 +4,7 @@
 #include <QKeyEvent>
 #include <QtDebug>
 
+#include "control/control.h"
 #include "moc_keyboardeventfilter.cpp"
 #include "util/cmdlineargs.h"
 
@@ -48,17 +49,14 @@ bool KeyboardEventFilter::eventFilter(QObject*, QEvent* e) {
 #ifndef __APPLE__
             m_altPressedWithoutKey = false;
 #endif
-            ConfigValueKbd ksv(ks);
             // Check if a shortcut is defined
             bool result = false;
-            // using const_iterator here is faster than QMultiHash::values()
-            for (auto it = m_keySequenceToControlHash.constFind(ksv);
-                 it != m_keySequenceToControlHash.constEnd() && it.key() == ksv; ++it) {
-                const ConfigKey& configKey = it.value();
-                if (configKey.group != "[KeyboardShortcuts]") {
-                    ControlObject* control = ControlObject::getControl(configKey);
+            const auto it = m_keySequenceToControls.find(ks);
+            if (it != m_keySequenceToControls.end()) {
+                for (KeyControl& keyControl : it.value()) {
+                    ControlObject* control = resolveControl(&keyControl);
                     if (control) {
-                        //qDebug() << configKey << "MidiOpCode::NoteOn" << 1;
+                        //qDebug() << keyControl.key << "MidiOpCode::NoteOn" << 1;
                         // Add key to active key list
                         m_qActiveKeyList.append(KeyDownInformation(
                             keyId, ke->modifiers(), control));
@@ -67,9 +65,6 @@ bool KeyboardEventFilter::eventFilter(QObject*, QEvent* e) {
                         // key list, do that last.
                         control->setValueFromMidi(MidiOpCode::NoteOn, 1);
                         result = true;
-                    } else {
-                        qDebug() << "Warning: Keyboard key is configured for nonexistent control:"
-                                 << configKey.group << configKey.item;
                     }
                 }
             }
@@ -158,27 +153,11 @@ QKeySequence KeyboardEventFilter::getKeySeq(QKeyEvent* e) {
         return k;
     }
 
-    QString modseq;
-    // TODO(XXX) check if we may simply return QKeySequence(e->modifiers()+e->key())
-
-    if (e->modifiers() & Qt::ShiftModifier) {
-        modseq += "Shift+";
-    }
-
-    if (e->modifiers() & Qt::ControlModifier) {
-        modseq += "Ctrl+";
-    }
-
-    if (e->modifiers() & Qt::AltModifier) {
-        modseq += "Alt+";
-    }
-
-    if (e->modifiers() & Qt::MetaModifier) {
-        modseq += "Meta+";
-    }
-
-    QString keyseq = QKeySequence(e->key()).toString();
-    k = QKeySequence(modseq + keyseq);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    k = QKeySequence(e->modifiers() | e->key());
+#else
+    k = QKeySequence(e->modifiers() + e->key());
+#endif
 
     if (CmdlineArgs::Instance().getDeveloper()) {
         if (e->type() == QEvent::KeyPress) {
@@ -188,11 +167,35 @@ QKeySequence KeyboardEventFilter::getKeySeq(QKeyEvent* e) {
         }
     }
 
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    return QKeySequence(e->modifiers() | e->key());
-#else
-    return QKeySequence(e->modifiers() + e->key());
-#endif
+    return k;
+}
+
+// static
+ControlObject* KeyboardEventFilter::resolveControl(KeyControl* pKeyControl) {
+    const auto pControl = pKeyControl->pControl.lock();
+    if (pControl) {
+        ControlObject* pCreatorCO = pControl->getCreatorCO();
+        if (pCreatorCO) {
+            return pCreatorCO;
+        }
+    }
+    // Looking up a control locks the global control registry, so a missing
+    // control is only looked up again after new controls have been added.
+    const quint64 registrationCount = ControlDoublePrivate::registrationCount();
+    if (pKeyControl->missingRegistrationCount == registrationCount) {
+        return nullptr;
+    }
+    const auto pFoundControl = ControlDoublePrivate::getControl(
+            pKeyControl->key, ControlFlag::NoWarnIfMissing);
+    ControlObject* pCreatorCO = pFoundControl ? pFoundControl->getCreatorCO() : nullptr;
+    if (!pCreatorCO) {
+        qDebug() << "Warning: Keyboard key is configured for nonexistent control:"
+                 << pKeyControl->key.group << pKeyControl->key.item;
+        pKeyControl->missingRegistrationCount = registrationCount;
+        return nullptr;
+    }
+    pKeyControl->pControl = pFoundControl;
+    return pCreatorCO;
 }
 
 void KeyboardEventFilter::setKeyboardConfig(ConfigObject<ConfigValueKbd>* pKbdConfigObject) {
@@ -200,7 +203,16 @@ void KeyboardEventFilter::setKeyboardConfig(ConfigObject<ConfigValueKbd>* pKbdCo
     // invert the mapping to create an injection from key sequence to
     // ConfigKey. This allows a key sequence to trigger multiple controls in
     // Mixxx.
-    m_keySequenceToControlHash = pKbdConfigObject->transpose();
+    const QMultiHash<ConfigValueKbd, ConfigKey> transposedHash =
+            pKbdConfigObject->transpose();
+    m_keySequenceToControls.clear();
+    for (auto it = transposedHash.constBegin(); it != transposedHash.constEnd(); ++it) {
+        if (it.value().group == QLatin1String("[KeyboardShortcuts]")) {
+            // Menu shortcuts are handled by WMainMenuBar
+            continue;
+        }
+        m_keySequenceToControls[it.key().keys()].append(KeyControl(it.value()));
+    }
     m_pKbdConfigObject = pKbdConfigObject;
 }
 
@@ -1,11 +1,15 @@
 #pragma once
 
-#include <QMultiHash>
+#include <QHash>
+#include <QKeySequence>
+#include <QList>
 #include <QObject>
+#include <QWeakPointer>
 
 #include "control/controlobject.h"
 #include "preferences/configobject.h"
 
+class ControlDoublePrivate;
 class ControlObject;
 class QEvent;
 class QKeyEvent;
@@ -46,6 +50,26 @@ class KeyboardEventFilter : public QObject {
         ControlObject* pControl;
     };
 
+    // A control that is triggered by a key sequence
+    struct KeyControl {
+        explicit KeyControl(const ConfigKey& key)
+                : key(key),
+                  missingRegistrationCount(0) {
+        }
+
+        ConfigKey key;
+        // Resolved on the first key press, because most controls are created
+        // after the mapping has been loaded. Weak, because the controls of
+        // the skin are deleted and created again when the skin is reloaded.
+        QWeakPointer<ControlDoublePrivate> pControl;
+        // ControlDoublePrivate::registrationCount() when the control was
+        // found to be missing
+        quint64 missingRegistrationCount;
+    };
+
+    // Returns the control of the KeyControl or nullptr if it does not exist
+    static ControlObject* resolveControl(KeyControl* pKeyControl);
+
 #ifndef __APPLE__
     bool m_altPressedWithoutKey;
 #endif
@@ -64,6 +88,7 @@ class KeyboardEventFilter : public QObject {
     QList<KeyDownInformation> m_qActiveKeyList;
     // Pointer to keyboard config object
     ConfigObject<ConfigValueKbd> *m_pKbdConfigObject;
-    // Multi-hash of key sequence to
-    QMultiHash<ConfigValueKbd, ConfigKey> m_keySequenceToControlHash;
+    // The controls triggered by each key sequence, compiled from the
+    // keyboard config object
+    QHash<QKeySequence, QList<KeyControl>> m_keySequenceToControls;
 };
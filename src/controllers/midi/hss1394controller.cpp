@@ -185,6 +185,19 @@ void Hss1394Controller::sendShortMsg(unsigned char status, unsigned char byte1,
     }
 }
 
+void Hss1394Controller::sendShortMsgs(const QVector<MidiShortMessage>& messages) {
+    // The channel accepts a stream of MIDI bytes, so the whole batch is
+    // sent at once
+    QByteArray data;
+    data.reserve(messages.size() * 3);
+    for (const auto& message : messages) {
+        data.append(static_cast<char>(message.status));
+        data.append(static_cast<char>(message.byte1));
+        data.append(static_cast<char>(message.byte2));
+    }
+    sendBytes(data);
+}
+
 void Hss1394Controller::sendBytes(const QByteArray& data) {
     const int bytesSent = m_pChannel->SendChannelBytes(
             reinterpret_cast<const unsigned char*>(data.constData()), data.size());
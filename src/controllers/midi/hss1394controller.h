@@ -49,6 +49,7 @@ class Hss1394Controller : public MidiController {
   protected:
     void sendShortMsg(unsigned char status, unsigned char byte1,
                       unsigned char byte2) override;
+    void sendShortMsgs(const QVector<MidiShortMessage>& messages) override;
 
   private:
     // The sysex data must already contain the start byte 0xf0 and the end byte
@@ -13,17 +13,20 @@ bool LegacyMidiControllerMapping::isMappable() const {
 
 void LegacyMidiControllerMapping::addInputMapping(uint16_t key, const MidiInputMapping& mapping) {
     m_inputMappings.insert(key, mapping);
+    ++m_inputMappingsRevision;
     setDirty(true);
 }
 
 void LegacyMidiControllerMapping::removeInputMapping(uint16_t key) {
     m_inputMappings.remove(key);
+    ++m_inputMappingsRevision;
     setDirty(true);
 }
 
 bool LegacyMidiControllerMapping::removeInputMapping(
         uint16_t key, const MidiInputMapping& mapping) {
     auto result = m_inputMappings.remove(key, mapping);
+    ++m_inputMappingsRevision;
     setDirty(true);
     return result > 0;
 }
@@ -38,6 +41,7 @@ void LegacyMidiControllerMapping::setInputMappings(
     if (m_inputMappings != mappings) {
         m_inputMappings.clear();
         m_inputMappings.unite(mappings);
+        ++m_inputMappingsRevision;
         setDirty(true);
     }
 }
@@ -67,6 +71,7 @@ void LegacyMidiControllerMapping::setOutputMappings(
     }
 }
 void LegacyMidiControllerMapping::removeInputHandlerMappings() {
+    ++m_inputMappingsRevision;
 #if QT_VERSION >= QT_VERSION_CHECK(6, 1, 0)
     m_inputMappings.removeIf(
             [](std::pair<const uint16_t&, MidiInputMapping&> it) {
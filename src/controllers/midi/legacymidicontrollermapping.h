@@ -27,6 +27,11 @@ class LegacyMidiControllerMapping : public LegacyControllerMapping {
     void removeInputHandlerMappings();
     const QMultiHash<uint16_t, MidiInputMapping>& getInputMappings() const;
     void setInputMappings(const QMultiHash<uint16_t, MidiInputMapping>& mappings);
+    /// Incremented on every change of the input mappings, which allows
+    /// to detect when data derived from them needs to be updated.
+    uint inputMappingsRevision() const {
+        return m_inputMappingsRevision;
+    }
 
     // Output mappings
     void addOutputMapping(const ConfigKey& key, const MidiOutputMapping& mapping);
@@ -37,5 +42,6 @@ class LegacyMidiControllerMapping : public LegacyControllerMapping {
   private:
     // MIDI input and output mappings.
     QMultiHash<uint16_t, MidiInputMapping> m_inputMappings;
+    uint m_inputMappingsRevision = 0;
     QMultiHash<ConfigKey, MidiOutputMapping> m_outputMappings;
 };
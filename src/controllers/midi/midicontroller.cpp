@@ -2,6 +2,7 @@
 
 #include <QJSValue>
 #include <algorithm>
+#include <limits>
 
 #include "control/controlobject.h"
 #include "controllers/defs_controllers.h"
@@ -12,8 +13,19 @@
 #include "errordialoghandler.h"
 #include "mixer/playermanager.h"
 #include "moc_midicontroller.cpp"
+#include "util/controllerlatency.h"
+#include "util/inputtimestamp.h"
 #include "util/make_const_iterator.h"
 #include "util/math.h"
+#include "util/time.h"
+
+// Messages to the same target within this window are coalesced
+constexpr int kOutputIntervalMillis = 5;
+
+// Limits the output to 32 kB/s, which USB MIDI devices are able to
+// process without delaying their input. Without a limit VU meters and
+// beat-synced LEDs may saturate slower devices.
+constexpr int kMaxMessagesPerOutputInterval = 32 * kOutputIntervalMillis / 3;
 
 const QString kMakeInputHandlerError = QStringLiteral(
         "Invalid timer callback provided to midi.makeInputHandler. "
@@ -31,8 +43,13 @@ bool MidiInputHandleJSProxy::disconnect() {
 }
 
 MidiController::MidiController(const QString& deviceName)
-        : Controller(deviceName) {
+        : Controller(deviceName),
+          m_inputDispatchTableValid(false),
+          m_inputDispatchTableRevision(0),
+          m_outputTimer(this) {
     setDeviceCategory(tr("MIDI Controller"));
+    m_outputTimer.setInterval(kOutputIntervalMillis);
+    connect(&m_outputTimer, &QTimer::timeout, this, &MidiController::slotFlushOutput);
 }
 
 void MidiController::slotBeforeEngineShutdown() {
@@ -56,6 +73,8 @@ QString MidiController::mappingExtension() {
 
 void MidiController::setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) {
     m_pMapping = downcastAndTakeOwnership<LegacyMidiControllerMapping>(std::move(pMapping));
+    m_inputDispatchTableValid = false;
+    m_inputDispatchTable.clear();
 }
 
 std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
@@ -67,9 +86,62 @@ std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
 
 int MidiController::close() {
     destroyOutputHandlers();
+    // The device is closed by the sub-class after this, e.g. after the
+    // shutdown function of the script has turned off all LEDs
+    flushAllOutput();
+    m_outputScheduler.clear();
     return 0;
 }
 
+void MidiController::sendShortMsgs(const QVector<MidiShortMessage>& messages) {
+    for (const auto& message : messages) {
+        sendShortMsg(message.status, message.byte1, message.byte2);
+    }
+}
+
+void MidiController::scheduleShortMsg(unsigned char status,
+        unsigned char byte1,
+        unsigned char byte2) {
+    if (m_outputScheduler.schedule(MidiShortMessage{status, byte1, byte2},
+                mixxx::Time::elapsed()) &&
+            !m_outputTimer.isActive()) {
+        m_outputTimer.start();
+    }
+}
+
+void MidiController::send(const QList<int>& data, unsigned int length) {
+    flushAllOutput();
+    Controller::send(data, length);
+    // The SysEx message might have changed the state of the device
+    m_outputScheduler.clearSentValues();
+}
+
+void MidiController::slotFlushOutput() {
+    if (m_outputScheduler.isEmpty()) {
+        m_outputTimer.stop();
+        return;
+    }
+    const auto oldestPendingSince = m_outputScheduler.oldestPendingSince();
+    const auto messages = m_outputScheduler.take(
+            kMaxMessagesPerOutputInterval, mixxx::Time::elapsed());
+    sendShortMsgs(messages);
+    mixxx::ControllerLatency::outputSent(oldestPendingSince);
+    if (m_outputScheduler.isEmpty()) {
+        m_outputTimer.stop();
+    }
+}
+
+void MidiController::flushAllOutput() {
+    m_outputTimer.stop();
+    if (m_outputScheduler.isEmpty()) {
+        return;
+    }
+    const auto oldestPendingSince = m_outputScheduler.oldestPendingSince();
+    sendShortMsgs(m_outputScheduler.take(
+            std::numeric_limits<int>::max(), mixxx::Time::elapsed()));
+    mixxx::ControllerLatency::outputSent(oldestPendingSince);
+}
+
 bool MidiController::matchMapping(const MappingInfo& mapping) {
     // Product info mapping not implemented for MIDI devices yet
     Q_UNUSED(mapping);
@@ -273,25 +345,50 @@ void MidiController::receivedShortMessage(unsigned char status,
 
     MidiKey mappingKey(status, control);
     triggerActivity();
+    const mixxx::ScopedInputTimestamp inputTimestamp(timestamp);
     if (isLearning()) {
         emit messageReceived(status, control, value);
 
         auto it = m_temporaryInputMappings.constFind(mappingKey.key);
         if (it != m_temporaryInputMappings.constEnd()) {
             for (; it != m_temporaryInputMappings.constEnd() && it.key() == mappingKey.key; ++it) {
-                processInputMapping(it.value(), status, control, value, timestamp);
+                processInputMapping(it.value(),
+                        nullptr,
+                        nullptr,
+                        status,
+                        control,
+                        value,
+                        timestamp);
             }
             return;
         }
     }
 
-    auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
-    for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), status, control, value, timestamp);
+    updateInputDispatchTable();
+    for (auto& entry : m_inputDispatchTable.find(mappingKey.status, mappingKey.control)) {
+        processInputMapping(entry.mapping(),
+                entry.control(),
+                entry.softTakeover(&m_st),
+                status,
+                control,
+                value,
+                timestamp);
+    }
+}
+
+void MidiController::updateInputDispatchTable() {
+    if (m_inputDispatchTableValid &&
+            m_inputDispatchTableRevision == m_pMapping->inputMappingsRevision()) {
+        return;
     }
+    m_inputDispatchTable.compile(m_pMapping->getInputMappings());
+    m_inputDispatchTableRevision = m_pMapping->inputMappingsRevision();
+    m_inputDispatchTableValid = true;
 }
 
 void MidiController::processInputMapping(const MidiInputMapping& mapping,
+        ControlObject* pControl,
+        SoftTakeover* pSoftTakeover,
         unsigned char status,
         unsigned char control,
         unsigned char value,
@@ -350,8 +447,8 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
     }
 
     // Only pass values on to valid ControlObjects.
-    auto configKey = std::get<ConfigKey>(mapping.control);
-    ControlObject* pCO = ControlObject::getControl(configKey);
+    const auto& configKey = std::get<ConfigKey>(mapping.control);
+    ControlObject* pCO = pControl ? pControl : ControlObject::getControl(configKey);
     if (pCO == nullptr) {
         return;
     }
@@ -451,8 +548,11 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
 
     if (mapping.options.testFlag(MidiOption::SoftTakeover)) {
         // This is the only place to enable it if it isn't already.
-        m_st.enable(pCO);
-        if (m_st.ignore(pCO, pCO->getParameterForMidi(newValue))) {
+        if (!pSoftTakeover) {
+            pSoftTakeover = m_st.enable(pCO);
+        }
+        if (pSoftTakeover &&
+                pSoftTakeover->ignore(pCO, pCO->getParameterForMidi(newValue))) {
             return;
         }
     }
@@ -568,6 +668,7 @@ void MidiController::receive(const QByteArray& data, mixxx::Duration timestamp)
     MidiKey mappingKey(data.at(0), 0xFF);
 
     triggerActivity();
+    const mixxx::ScopedInputTimestamp inputTimestamp(timestamp);
     // TODO(rryan): Need to review how MIDI learn works with sysex messages. I
     // don't think this actually does anything useful.
     if (isLearning()) {
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <QJSValue>
+#include <QTimer>
 #include <utility>
 
 #include "controllers/controller.h"
 #include "controllers/midi/legacymidicontrollermappingfilehandler.h"
+#include "controllers/midi/midiinputdispatchtable.h"
 #include "controllers/midi/midimessage.h"
+#include "controllers/midi/midioutputscheduler.h"
 #include "controllers/softtakeover.h"
 
+class ControlObject;
 class MidiOutputHandler;
 
 class MidiInputHandleJSProxy final : public QObject {
@@ -59,6 +63,20 @@ class MidiController : public Controller {
             unsigned char byte1,
             unsigned char byte2) = 0;
 
+    /// Sends a batch of short messages, one by one unless the device
+    /// supports sending them at once.
+    virtual void sendShortMsgs(const QVector<MidiShortMessage>& messages);
+
+    /// Queues a short message for the next batch instead of sending it
+    /// immediately. See MidiOutputScheduler.
+    void scheduleShortMsg(unsigned char status,
+            unsigned char byte1,
+            unsigned char byte2);
+
+    /// Sends the queued short messages before the SysEx message to
+    /// keep their order.
+    void send(const QList<int>& data, unsigned int length = 0) override;
+
     /// Alias for send()
     /// The length parameter is here for backwards compatibility for when scripts
     /// were required to specify it.
@@ -83,13 +101,20 @@ class MidiController : public Controller {
   private slots:
     bool applyMapping(const QString& resourcePath) override;
 
+    /// Sends the next batch of queued short messages.
+    void slotFlushOutput();
+
     void learnTemporaryInputMappings(const MidiInputMappings& mappings);
     void clearTemporaryInputMappings();
     void commitTemporaryInputMappings();
 
   private:
+    /// pControl is the resolved target of the mapping and pSoftTakeover
+    /// its soft-takeover state, or nullptr if they need to be looked up.
     void processInputMapping(
             const MidiInputMapping& mapping,
+            ControlObject* pControl,
+            SoftTakeover* pSoftTakeover,
             unsigned char status,
             unsigned char control,
             unsigned char value,
@@ -103,14 +128,22 @@ class MidiController : public Controller {
     void createOutputHandlers();
     void updateAllOutputs();
     void destroyOutputHandlers();
+    void flushAllOutput();
+    void updateInputDispatchTable();
 
     QHash<uint16_t, MidiInputMapping> m_temporaryInputMappings;
     QList<MidiOutputHandler*> m_outputs;
     std::shared_ptr<LegacyMidiControllerMapping> m_pMapping;
+    // Compiled from the input mappings of m_pMapping whenever they change
+    MidiInputDispatchTable m_inputDispatchTable;
+    bool m_inputDispatchTableValid;
+    uint m_inputDispatchTableRevision;
     SoftTakeoverCtrl m_st;
     QList<QPair<MidiInputMapping, unsigned char>> m_fourteen_bit_queued_mappings;
+    MidiOutputScheduler m_outputScheduler;
+    QTimer m_outputTimer;
 
-    // So it can access sendShortMsg()
+    // So it can access scheduleShortMsg()
     friend class MidiOutputHandler;
     friend class MidiControllerTest;
     friend class MidiControllerJSProxy;
@@ -130,7 +163,7 @@ class MidiControllerJSProxy : public ControllerJSProxy {
     Q_INVOKABLE void sendShortMsg(unsigned char status,
             unsigned char byte1,
             unsigned char byte2) {
-        m_pMidiController->sendShortMsg(status, byte1, byte2);
+        m_pMidiController->scheduleShortMsg(status, byte1, byte2);
     }
 
     Q_INVOKABLE void sendSysexMsg(const QList<int>& data, unsigned int length = 0) {
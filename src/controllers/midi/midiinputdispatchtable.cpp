@@ -0,0 +1,66 @@
+#include "controllers/midi/midiinputdispatchtable.h"
+
+#include "control/controlobject.h"
+#include "controllers/softtakeover.h"
+
+ControlObject* MidiInputDispatchTable::Entry::control() {
+    if (m_pControl) {
+        return m_pControl.data();
+    }
+    if (m_mapping.options.testFlag(MidiOption::Script)) {
+        return nullptr;
+    }
+    const auto* pConfigKey = std::get_if<ConfigKey>(&m_mapping.control);
+    if (!pConfigKey) {
+        return nullptr;
+    }
+    m_pControl = ControlObject::getControl(*pConfigKey);
+    return m_pControl.data();
+}
+
+SoftTakeover* MidiInputDispatchTable::Entry::softTakeover(
+        SoftTakeoverCtrl* pSoftTakeoverCtrl) {
+    if (!m_mapping.options.testFlag(MidiOption::SoftTakeover)) {
+        return nullptr;
+    }
+    ControlObject* pControl = control();
+    if (!pControl) {
+        return nullptr;
+    }
+    if (pControl != m_pSoftTakeoverControl) {
+        // Resolved once per control, the state is owned by pSoftTakeoverCtrl
+        m_pSoftTakeover = pSoftTakeoverCtrl->enable(pControl);
+        m_pSoftTakeoverControl = pControl;
+    }
+    return m_pSoftTakeover;
+}
+
+void MidiInputDispatchTable::compile(
+        const QMultiHash<uint16_t, MidiInputMapping>& mappings) {
+    clear();
+    m_entries.reserve(mappings.size());
+    const auto keys = mappings.uniqueKeys();
+    for (const auto key : keys) {
+        MidiKey midiKey;
+        midiKey.key = key;
+        auto& pControlTable = m_controlTables[midiKey.status];
+        if (!pControlTable) {
+            pControlTable = std::make_unique<ControlTable>();
+        }
+        Range& range = (*pControlTable)[midiKey.control];
+        range.begin = static_cast<std::uint32_t>(m_entries.size());
+        for (auto it = mappings.constFind(key);
+                it != mappings.constEnd() && it.key() == key;
+                ++it) {
+            m_entries.emplace_back(it.value());
+        }
+        range.end = static_cast<std::uint32_t>(m_entries.size());
+    }
+}
+
+void MidiInputDispatchTable::clear() {
+    m_entries.clear();
+    for (auto& pControlTable : m_controlTables) {
+        pControlTable.reset();
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QMultiHash>
+#include <QPointer>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "controllers/midi/midimessage.h"
+
+class ControlObject;
+class SoftTakeover;
+class SoftTakeoverCtrl;
+
+/// Lookup table for the input mappings of a MIDI controller, compiled from
+/// the multi-hash of a LegacyMidiControllerMapping.
+///
+/// The mappings are indexed by the status byte and the first data byte, so
+/// finding the mappings of a short message takes two array accesses instead
+/// of hashing. The order of the mappings for the same key is the iteration
+/// order of the multi-hash.
+class MidiInputDispatchTable {
+  public:
+    class Entry {
+      public:
+        explicit Entry(const MidiInputMapping& mapping)
+                : m_mapping(mapping) {
+        }
+
+        const MidiInputMapping& mapping() const {
+            return m_mapping;
+        }
+
+        /// The target control of a non-script mapping, which is looked up
+        /// on first use and cached. Returns nullptr for script mappings and
+        /// controls that don't exist (yet). The control is tracked by
+        /// QPointer, because controls may be deleted while the mapping is
+        /// still loaded, e.g. during shutdown.
+        ControlObject* control();
+
+        /// The soft-takeover state of control() if the mapping has the
+        /// SoftTakeover option, which is enabled in pSoftTakeoverCtrl on
+        /// first use and cached. Returns nullptr otherwise. This saves
+        /// resolving the state of every message of high resolution faders
+        /// and knobs.
+        SoftTakeover* softTakeover(SoftTakeoverCtrl* pSoftTakeoverCtrl);
+
+      private:
+        MidiInputMapping m_mapping;
+        QPointer<ControlObject> m_pControl;
+        // The control that m_pSoftTakeover belongs to
+        const ControlObject* m_pSoftTakeoverControl = nullptr;
+        SoftTakeover* m_pSoftTakeover = nullptr;
+    };
+
+    void compile(const QMultiHash<uint16_t, MidiInputMapping>& mappings);
+
+    void clear();
+
+    /// The entries for a message. The span is invalidated by compile()
+    /// and clear().
+    std::span<Entry> find(unsigned char status, unsigned char control) {
+        const auto& pControlTable = m_controlTables[status];
+        if (!pControlTable) {
+            return {};
+        }
+        const Range range = (*pControlTable)[control];
+        return std::span<Entry>(m_entries.data() + range.begin, range.end - range.begin);
+    }
+
+  private:
+    struct Range {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+    };
+    using ControlTable = std::array<Range, 256>;
+
+    std::vector<Entry> m_entries;
+    // Only allocated for status bytes that have mappings
+    std::array<std::unique_ptr<ControlTable>, 256> m_controlTables;
+};
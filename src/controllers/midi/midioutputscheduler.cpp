@@ -0,0 +1,96 @@
+#include "controllers/midi/midioutputscheduler.h"
+
+#include <algorithm>
+
+#include "controllers/midi/midiutils.h"
+
+namespace {
+
+/// Values are resent after this time, in case the device has changed
+/// the state of an LED on its own.
+constexpr mixxx::Duration kRedundantMessageTimeout = mixxx::Duration::fromMillis(1000);
+
+/// Data bytes are 7 bit, so this never matches a control or note number.
+constexpr unsigned char kAnyByte1 = 0xFF;
+
+/// Returns the key of the target of the message or false for system
+/// messages that must not be replaced.
+bool targetKey(const MidiShortMessage& message, std::uint16_t* pKey) {
+    switch (MidiUtils::opCodeFromStatus(message.status)) {
+    case MidiOpCode::NoteOff:
+    case MidiOpCode::NoteOn:
+        // A note off replaces a note on for the same note and vice versa
+        *pKey = static_cast<std::uint16_t>(
+                (MidiUtils::statusFromOpCodeAndChannel(MidiOpCode::NoteOn,
+                         MidiUtils::channelFromStatus(message.status))
+                        << 8) |
+                message.byte1);
+        return true;
+    case MidiOpCode::PolyphonicKeyPressure:
+    case MidiOpCode::ControlChange:
+        *pKey = static_cast<std::uint16_t>((message.status << 8) | message.byte1);
+        return true;
+    case MidiOpCode::ProgramChange:
+    case MidiOpCode::ChannelPressure:
+    case MidiOpCode::PitchBendChange:
+        // The first data byte is part of the value
+        *pKey = static_cast<std::uint16_t>((message.status << 8) | kAnyByte1);
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // anonymous namespace
+
+bool MidiOutputScheduler::schedule(const MidiShortMessage& message, mixxx::Duration now) {
+    std::uint16_t key;
+    if (!targetKey(message, &key)) {
+        m_pending.append(message);
+        m_pendingSince.append(now);
+        return true;
+    }
+    const auto pendingIt = m_pendingIndices.constFind(key);
+    if (pendingIt != m_pendingIndices.constEnd()) {
+        m_pending[pendingIt.value()] = message;
+        return true;
+    }
+    const auto sentIt = m_sentMessages.constFind(key);
+    if (sentIt != m_sentMessages.constEnd() &&
+            sentIt->message == message &&
+            now - sentIt->timestamp < kRedundantMessageTimeout) {
+        return false;
+    }
+    m_pendingIndices.insert(key, m_pending.size());
+    m_pending.append(message);
+    m_pendingSince.append(now);
+    return true;
+}
+
+QVector<MidiShortMessage> MidiOutputScheduler::take(int maxCount, mixxx::Duration now) {
+    const int count = std::min(maxCount, static_cast<int>(m_pending.size()));
+    QVector<MidiShortMessage> messages(m_pending.cbegin(), m_pending.cbegin() + count);
+    m_pending.remove(0, count);
+    m_pendingSince.remove(0, count);
+    m_pendingIndices.clear();
+    for (int i = 0; i < m_pending.size(); ++i) {
+        std::uint16_t key;
+        if (targetKey(m_pending[i], &key)) {
+            m_pendingIndices.insert(key, i);
+        }
+    }
+    for (const auto& message : std::as_const(messages)) {
+        std::uint16_t key;
+        if (targetKey(message, &key)) {
+            m_sentMessages.insert(key, SentMessage{message, now});
+        }
+    }
+    return messages;
+}
+
+void MidiOutputScheduler::clear() {
+    m_pending.clear();
+    m_pendingSince.clear();
+    m_pendingIndices.clear();
+    m_sentMessages.clear();
+}
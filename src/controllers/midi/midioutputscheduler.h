@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QHash>
+#include <QVector>
+#include <cstdint>
+
+#include "util/duration.h"
+
+/// A MIDI channel or system message with up to two data bytes.
+struct MidiShortMessage {
+    unsigned char status;
+    unsigned char byte1;
+    unsigned char byte2;
+};
+
+inline bool operator==(const MidiShortMessage& lhs, const MidiShortMessage& rhs) {
+    return lhs.status == rhs.status &&
+            lhs.byte1 == rhs.byte1 &&
+            lhs.byte2 == rhs.byte2;
+}
+
+inline bool operator!=(const MidiShortMessage& lhs, const MidiShortMessage& rhs) {
+    return !(lhs == rhs);
+}
+
+/// Collects the short MIDI messages for a controller between two batches.
+///
+/// Messages for the same target, e.g. the same note or control number on
+/// the same channel, replace each other so that only the latest value of a
+/// target is sent. Messages that repeat the value that has been sent to the
+/// target shortly before are dropped. System messages are neither replaced
+/// nor dropped.
+class MidiOutputScheduler {
+  public:
+    /// Returns false if the message has been dropped as redundant.
+    bool schedule(const MidiShortMessage& message, mixxx::Duration now);
+
+    bool isEmpty() const {
+        return m_pending.isEmpty();
+    }
+
+    /// The time when the target of the first pending message has been
+    /// scheduled. Must not be called if isEmpty().
+    mixxx::Duration oldestPendingSince() const {
+        return m_pendingSince.first();
+    }
+
+    /// Removes up to maxCount messages in the order in which their targets
+    /// have been scheduled first.
+    QVector<MidiShortMessage> take(int maxCount, mixxx::Duration now);
+
+    /// Forgets the values that have been sent, e.g. after a SysEx message
+    /// that might have changed the state of the device.
+    void clearSentValues() {
+        m_sentMessages.clear();
+    }
+
+    void clear();
+
+  private:
+    struct SentMessage {
+        MidiShortMessage message;
+        mixxx::Duration timestamp;
+    };
+
+    QVector<MidiShortMessage> m_pending;
+    QVector<mixxx::Duration> m_pendingSince;
+    QHash<std::uint16_t, int> m_pendingIndices;
+    QHash<std::uint16_t, SentMessage> m_sentMessages;
+};
@@ -1,7 +1,12 @@
 #include "controllers/midi/portmidicontroller.h"
 
+#include <porttime.h>
+
+#include <algorithm>
+
 #include "controllers/midi/midiutils.h"
 #include "moc_portmidicontroller.cpp"
+#include "util/time.h"
 
 namespace {
 const QString kUnknownControllerName = QStringLiteral("Unknown PortMidiController");
@@ -130,9 +135,16 @@ bool PortMidiController::poll() {
         return false;
     }
 
+    // PortMidi timestamps the events in milliseconds of PortTime when they
+    // arrive. Translate them into the time base of mixxx::Time to allow
+    // comparing them with the timeline of the audio engine.
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    const mixxx::Duration portTimeOffset = now - mixxx::Duration::fromMillis(Pt_Time());
+
     for (int i = 0; i < numEvents; i++) {
         unsigned char status = Pm_MessageStatus(m_midiBuffer[i].message);
-        mixxx::Duration timestamp = mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp);
+        const mixxx::Duration timestamp = std::min(now,
+                portTimeOffset + mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp));
 
         if ((status & 0xF8) == 0xF8) {
             // Handle real-time MIDI messages at any time
@@ -222,6 +234,35 @@ void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
     }
 }
 
+void PortMidiController::sendShortMsgs(const QVector<MidiShortMessage>& messages) {
+    if (m_pOutputDevice.isNull() || !m_pOutputDevice->isOpen()) {
+        return;
+    }
+
+    // Write the whole batch with a single call into the driver
+    QVector<PmEvent> events;
+    events.reserve(messages.size());
+    for (const auto& message : messages) {
+        PmEvent event;
+        event.message = Pm_Message(message.status, message.byte1, message.byte2);
+        event.timestamp = 0;
+        events.append(event);
+        qCDebug(m_logOutput) << QStringLiteral("outgoing: ")
+                             << MidiUtils::formatMidiOpCode(getName(),
+                                        message.status,
+                                        message.byte1,
+                                        message.byte2,
+                                        MidiUtils::channelFromStatus(message.status),
+                                        MidiUtils::opCodeFromStatus(message.status));
+    }
+
+    PmError err = m_pOutputDevice->write(events.data(), events.size());
+    if (err != pmNoError) {
+        qCWarning(m_logOutput) << "Error sending" << events.size() << "short messages";
+        qCWarning(m_logOutput) << "PortMidi error:" << Pm_GetErrorText(err);
+    }
+}
+
 void PortMidiController::sendBytes(const QByteArray& data) {
     // PortMidi does not receive a length argument for the buffer we provide to
     // Pm_WriteSysEx. Instead, it scans for a MidiOpCode::EndOfExclusive byte
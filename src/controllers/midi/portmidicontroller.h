@@ -64,6 +64,7 @@ class PortMidiController : public MidiController {
     // MockPortMidiController needs this to not be private.
     void sendShortMsg(unsigned char status, unsigned char byte1,
                       unsigned char byte2) override;
+    void sendShortMsgs(const QVector<MidiShortMessage>& messages) override;
 
   private:
     // The sysex data must already contain the start byte 0xf0 and the end byte
@@ -10,6 +10,8 @@
 #include <QQuickRenderTarget>
 #include <QQuickWindow>
 #include <QThread>
+#include <algorithm>
+#include <cstring>
 
 #include "controllers/controller.h"
 #include "controllers/controllerenginethreadcontrol.h"
@@ -31,16 +33,61 @@
         return;                        \
     }
 
+using Clock = std::chrono::steady_clock;
+
 namespace {
 const mixxx::Logger kLogger("ControllerRenderingEngine");
-} // anonymous namespace
 
-using Clock = std::chrono::steady_clock;
+// Frames are re-sent at least this often, even if the scene is static,
+// e.g. for devices that turn the screen off without receiving frames.
+constexpr auto kMaxIdleFrameInterval = std::chrono::seconds(1);
+
+/// Returns the bounding rectangle of the pixels that differ between two
+/// frames of the same size and format.
+QRect changedRect(const QImage& frame, const QImage& previousFrame) {
+    if (previousFrame.size() != frame.size() ||
+            previousFrame.format() != frame.format()) {
+        return frame.rect();
+    }
+    const int bytesPerPixel = std::max(frame.depth() / 8, 1);
+    const qsizetype bytesPerLine = static_cast<qsizetype>(frame.width()) * bytesPerPixel;
+    int left = frame.width();
+    int right = -1;
+    int top = frame.height();
+    int bottom = -1;
+    for (int y = 0; y < frame.height(); ++y) {
+        const uchar* pLine = frame.constScanLine(y);
+        const uchar* pPreviousLine = previousFrame.constScanLine(y);
+        if (std::memcmp(pLine, pPreviousLine, bytesPerLine) == 0) {
+            continue;
+        }
+        top = std::min(top, y);
+        bottom = y;
+        qsizetype first = 0;
+        while (pLine[first] == pPreviousLine[first]) {
+            ++first;
+        }
+        qsizetype last = bytesPerLine - 1;
+        while (pLine[last] == pPreviousLine[last]) {
+            --last;
+        }
+        left = std::min(left, static_cast<int>(first / bytesPerPixel));
+        right = std::max(right, static_cast<int>(last / bytesPerPixel));
+    }
+    if (bottom < 0) {
+        return QRect();
+    }
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+} // anonymous namespace
 
 ControllerRenderingEngine::ControllerRenderingEngine(
         const LegacyControllerMapping::ScreenInfo& info,
         gsl::not_null<ControllerEngineThreadControl*> engineThreadControl)
         : QObject(),
+          m_frameTimer(this),
+          m_sceneDirty(true),
+          m_waitingForSceneChange(false),
           m_screenInfo(info),
           m_GLDataFormat(GL_RGBA),
           m_GLDataType(GL_UNSIGNED_BYTE),
@@ -110,6 +157,14 @@ void ControllerRenderingEngine::prepare() {
             this,
             &ControllerRenderingEngine::finish);
 
+    // The timer is a child and moves to the render thread with this object
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer,
+            &QTimer::timeout,
+            this,
+            &ControllerRenderingEngine::renderFrame);
+
     m_pThread->start(QThread::NormalPriority);
 }
 
@@ -206,6 +261,16 @@ void ControllerRenderingEngine::setup(std::shared_ptr<QQmlEngine> qmlEngine) {
     m_renderControl = std::make_unique<QQuickRenderControl>(this);
     m_quickWindow = std::make_unique<QQuickWindow>(m_renderControl.get());
 
+    // Both signals are also emitted while animations are running
+    connect(m_renderControl.get(),
+            &QQuickRenderControl::renderRequested,
+            this,
+            &ControllerRenderingEngine::slotSceneChanged);
+    connect(m_renderControl.get(),
+            &QQuickRenderControl::sceneChanged,
+            this,
+            &ControllerRenderingEngine::slotSceneChanged);
+
     if (!qmlEngine->incubationController()) {
         qmlEngine->setIncubationController(m_quickWindow->incubationController());
     }
@@ -218,6 +283,8 @@ void ControllerRenderingEngine::finish() {
     emit stopping();
 
     m_isValid = false;
+    m_frameTimer.stop();
+    m_previousFrame = QImage();
 
     if (m_context && m_context->isValid()) {
         disconnect(m_context.get(),
@@ -250,6 +317,20 @@ void ControllerRenderingEngine::renderFrame() {
         return;
     }
 
+    const auto frameStart = Clock::now();
+    if (m_fbo && !m_sceneDirty &&
+            frameStart - m_lastFrameEmitted < kMaxIdleFrameInterval) {
+        // Nothing has changed since the last frame. Suspend rendering until
+        // the scene changes or the last frame needs to be sent again.
+        m_waitingForSceneChange = true;
+        m_frameTimer.start(std::chrono::duration_cast<std::chrono::milliseconds>(
+                m_lastFrameEmitted + kMaxIdleFrameInterval - frameStart));
+        return;
+    }
+    m_waitingForSceneChange = false;
+    // Reset before syncing, changes made meanwhile need another frame
+    m_sceneDirty = false;
+
     VERIFY_OR_TERMINATE(m_offscreenSurface->isValid(), "OffscreenSurface isn't valid anymore.");
     VERIFY_OR_TERMINATE(m_context->isValid(), "GLContext isn't valid anymore.");
     VERIFY_OR_TERMINATE(m_context->makeCurrent(m_offscreenSurface.get()),
@@ -281,7 +362,7 @@ void ControllerRenderingEngine::renderFrame() {
         m_quickWindow->setGeometry(0, 0, m_screenInfo.size.width(), m_screenInfo.size.height());
     }
 
-    m_nextFrameStart = Clock::now();
+    m_nextFrameStart = frameStart;
 
     m_renderControl->beginFrame();
 
@@ -352,11 +433,40 @@ void ControllerRenderingEngine::renderFrame() {
 
     fboImage.mirror(false, true);
 
-    emit frameRendered(m_screenInfo, fboImage.copy(), timestamp);
+    QRect damage = changedRect(fboImage, m_previousFrame);
+    if (damage.isEmpty()) {
+        if (frameStart - m_lastFrameEmitted < kMaxIdleFrameInterval) {
+            // The scene was updated without changing any pixel, e.g. by
+            // an invisible item. There is nothing to send.
+            m_context->doneCurrent();
+            scheduleNextFrame();
+            return;
+        }
+        damage = fboImage.rect();
+    }
+    m_previousFrame = fboImage;
+    m_lastFrameEmitted = frameStart;
+
+    // The image is implicitly shared with m_previousFrame, which is never
+    // modified, so no deep copy is needed for passing it to another thread.
+    emit frameRendered(m_screenInfo, fboImage, timestamp, damage);
 
     m_context->doneCurrent();
 }
 
+void ControllerRenderingEngine::slotSceneChanged() {
+    m_sceneDirty = true;
+    if (!m_waitingForSceneChange) {
+        // The next frame is already scheduled or in flight
+        return;
+    }
+    m_waitingForSceneChange = false;
+    // Render in the time slot of the frame that has been skipped
+    m_frameTimer.start(std::max(std::chrono::milliseconds(0),
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                    m_nextFrameStart - Clock::now())));
+}
+
 bool ControllerRenderingEngine::stop() {
     m_pThread->quit();
     return m_pThread->wait();
@@ -380,6 +490,10 @@ void ControllerRenderingEngine::send(Controller* controller, const QByteArray& f
                 << "milliseconds and frame has" << frame.size() << "bytes";
     }
 
+    scheduleNextFrame();
+}
+
+void ControllerRenderingEngine::scheduleNextFrame() {
     m_nextFrameStart += std::chrono::microseconds(1000000 / m_screenInfo.target_fps);
 
     auto durationToWaitBeforeFrame =
@@ -393,12 +507,9 @@ void ControllerRenderingEngine::send(Controller* controller, const QByteArray& f
                             << durationToWaitBeforeFrame.count()
                             << "milliseconds before rendering next frame";
         }
-        QTimer::singleShot(durationToWaitBeforeFrame,
-                Qt::PreciseTimer,
-                this,
-                &ControllerRenderingEngine::renderFrame);
+        m_frameTimer.start(durationToWaitBeforeFrame);
     } else {
-        QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
+        m_frameTimer.start(0);
     }
 }
 
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
+#include <QTimer>
 #include <chrono>
 #include <gsl/pointers>
 
@@ -68,13 +69,19 @@ class ControllerRenderingEngine : public QObject {
   private slots:
     void finish();
     void renderFrame();
+    void slotSceneChanged();
     void setup(std::shared_ptr<QQmlEngine> qmlEngine);
     void send(Controller* controller, const QByteArray& frame);
 
   signals:
+    /// @brief Emitted when a frame has been rendered that differs from the
+    /// previous frame, or periodically if the scene doesn't change.
+    /// @param damage the bounding rectangle of the pixels that changed
+    /// since the previous frame, or the whole frame.
     void frameRendered(const LegacyControllerMapping::ScreenInfo& screeninfo,
             QImage frame,
-            const QDateTime& timestamp);
+            const QDateTime& timestamp,
+            const QRect& damage);
     void stopping();
     /// @brief Request the screen thread to send a frame to the device.
     /// @param controller the controller to send the frame to.
@@ -83,8 +90,20 @@ class ControllerRenderingEngine : public QObject {
 
   private:
     virtual void prepare();
+    void scheduleNextFrame();
 
     std::chrono::time_point<std::chrono::steady_clock> m_nextFrameStart;
+    std::chrono::time_point<std::chrono::steady_clock> m_lastFrameEmitted;
+
+    // Drives the frame loop. A single timer ensures that there is never
+    // more than one frame scheduled.
+    QTimer m_frameTimer;
+    // Set by the render control if the scene needs to be rendered again
+    bool m_sceneDirty;
+    // Whether rendering is suspended until the scene changes
+    bool m_waitingForSceneChange;
+    // The last emitted frame for detecting the changed pixels
+    QImage m_previousFrame;
 
     LegacyControllerMapping::ScreenInfo m_screenInfo;
 
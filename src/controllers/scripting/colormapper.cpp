@@ -1,15 +1,18 @@
 #include "controllers/scripting/colormapper.h"
 
-#include <QVariant>
-#include <cmath>
+#include <algorithm>
 
+#include "util/assert.h"
 #include "util/logger.h"
 
 namespace {
 
 const mixxx::Logger kLogger("ColorMapper");
 
-double colorDistance(QRgb a, QRgb b) {
+// Returns the square of the distance between two colors. Comparing squared
+// distances selects the same nearest color without taking the square root.
+inline int squaredColorDistance(
+        int redA, int greenA, int blueA, int redB, int greenB, int blueB) {
     // This algorithm calculates the distance between two colors. In
     // contrast to the L2 norm, this also tries take the human perception
     // of colors into account. More accurate algorithms like the CIELAB2000
@@ -17,63 +20,91 @@ double colorDistance(QRgb a, QRgb b) {
     // of costly computations. In contrast, this is a low-cost
     // approximation and should be sufficiently accurate.
     // More details: https://www.compuphase.com/cmetric.htm
-    long mean_red = (static_cast<long>(qRed(a)) + static_cast<long>(qRed(b))) / 2;
-    long delta_red = static_cast<long>(qRed(a)) - static_cast<long>(qRed(b));
-    long delta_green = static_cast<long>(qGreen(a)) - static_cast<long>(qGreen(b));
-    long delta_blue = static_cast<long>(qBlue(a)) - static_cast<long>(qBlue(b));
-    return sqrt(
-            (((512 + mean_red) * delta_red * delta_red) >> 8) +
+    // All terms are non-negative and fit into an int.
+    const int mean_red = (redA + redB) / 2;
+    const int delta_red = redA - redB;
+    const int delta_green = greenA - greenB;
+    const int delta_blue = blueA - blueB;
+    return (((512 + mean_red) * delta_red * delta_red) >> 8) +
             (4 * delta_green * delta_green) +
-            (((767 - mean_red) * delta_blue * delta_blue) >> 8));
+            (((767 - mean_red) * delta_blue * delta_blue) >> 8);
 }
 
 } // namespace
 
-QRgb ColorMapper::getNearestColor(QRgb desiredColor) {
+ColorMapper::ColorMapper(const QMap<QRgb, QVariant>& availableColors) {
+    DEBUG_ASSERT(!availableColors.isEmpty());
+    const auto colorCount = static_cast<std::size_t>(availableColors.size());
+    m_colors.reserve(colorCount);
+    m_values.reserve(colorCount);
+    m_reds.reserve(colorCount);
+    m_greens.reserve(colorCount);
+    m_blues.reserve(colorCount);
+    for (auto i = availableColors.constBegin(); i != availableColors.constEnd(); ++i) {
+        m_colors.push_back(i.key());
+        m_values.push_back(i.value());
+        m_reds.push_back(qRed(i.key()));
+        m_greens.push_back(qGreen(i.key()));
+        m_blues.push_back(qBlue(i.key()));
+    }
+    m_distances.resize(colorCount);
+}
+
+int ColorMapper::getNearestColorIndex(QRgb desiredColor) {
     // If desired color is already in cache, use cache entry
-    const auto iCachedColor = m_cache.constFind(desiredColor);
-    if (iCachedColor != m_cache.constEnd()) {
-        const QRgb cachedColor = iCachedColor.value();
-        DEBUG_ASSERT(m_availableColors.contains(cachedColor));
+    const auto iCachedIndex = m_nearestColorIndices.constFind(desiredColor);
+    if (iCachedIndex != m_nearestColorIndices.constEnd()) {
         if (kLogger.traceEnabled()) {
             kLogger.trace()
                     << "Found cached color"
-                    << cachedColor
+                    << m_colors[iCachedIndex.value()]
                     << "for"
                     << desiredColor;
         }
-        return cachedColor;
+        return iCachedIndex.value();
+    }
+
+    if (m_colors.empty()) {
+        DEBUG_ASSERT(!"Unreachable: No matching color found");
+        return -1;
     }
 
     // Color is not cached
-    auto iNearestColor = m_availableColors.constEnd();
-    double nearestColorDistance = qInf();
-    for (auto i = m_availableColors.constBegin(); i != m_availableColors.constEnd(); ++i) {
-        const QRgb availableColor = i.key();
-        double distance = colorDistance(desiredColor, availableColor);
-        if (distance < nearestColorDistance) {
-            nearestColorDistance = distance;
-            iNearestColor = i;
-        }
+    const int red = qRed(desiredColor);
+    const int green = qGreen(desiredColor);
+    const int blue = qBlue(desiredColor);
+    const std::size_t colorCount = m_colors.size();
+    for (std::size_t i = 0; i < colorCount; ++i) {
+        m_distances[i] = squaredColorDistance(
+                red, green, blue, m_reds[i], m_greens[i], m_blues[i]);
     }
-    if (iNearestColor != m_availableColors.constEnd()) {
-        const QRgb nearestColor = iNearestColor.key();
-        if (kLogger.traceEnabled()) {
-            kLogger.trace()
-                    << "Found matching color"
-                    << nearestColor
-                    << "for"
-                    << desiredColor;
-        }
-        m_cache.insert(desiredColor, nearestColor);
-        return nearestColor;
+    // The first of multiple nearest colors is the one with the lowest value
+    const auto nearestColorIndex = static_cast<int>(
+            std::min_element(m_distances.cbegin(), m_distances.cend()) -
+            m_distances.cbegin());
+    if (kLogger.traceEnabled()) {
+        kLogger.trace()
+                << "Found matching color"
+                << m_colors[nearestColorIndex]
+                << "for"
+                << desiredColor;
     }
+    m_nearestColorIndices.insert(desiredColor, nearestColorIndex);
+    return nearestColorIndex;
+}
 
-    DEBUG_ASSERT(m_availableColors.isEmpty());
-    DEBUG_ASSERT(!"Unreachable: No matching color found");
-    return desiredColor;
+QRgb ColorMapper::getNearestColor(QRgb desiredColor) {
+    const int nearestColorIndex = getNearestColorIndex(desiredColor);
+    if (nearestColorIndex < 0) {
+        return desiredColor;
+    }
+    return m_colors[nearestColorIndex];
 }
 
 QVariant ColorMapper::getValueForNearestColor(QRgb desiredColor) {
-    return m_availableColors.value(getNearestColor(desiredColor));
+    const int nearestColorIndex = getNearestColorIndex(desiredColor);
+    if (nearestColorIndex < 0) {
+        return QVariant();
+    }
+    return m_values[nearestColorIndex];
 }
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <QHash>
 #include <QMap>
 #include <QRgb>
-
-#include "util/assert.h"
+#include <QVariant>
+#include <vector>
 
 /// ColorMapper allows to find the nearest color representation of a given color
 /// in a set of fixed colors. Additional user data (e.g. MIDI byte values) can
@@ -11,15 +12,25 @@
 class ColorMapper final {
   public:
     ColorMapper() = delete;
-    explicit ColorMapper(const QMap<QRgb, QVariant>& availableColors)
-            : m_availableColors(availableColors) {
-        DEBUG_ASSERT(!m_availableColors.isEmpty());
-    }
+    explicit ColorMapper(const QMap<QRgb, QVariant>& availableColors);
 
     QRgb getNearestColor(QRgb desiredColor);
     QVariant getValueForNearestColor(QRgb desiredColor);
 
   private:
-    const QMap<QRgb, QVariant> m_availableColors;
-    QMap<QRgb, QRgb> m_cache;
+    /// Returns the index of the nearest available color or -1 if there
+    /// are no colors.
+    int getNearestColorIndex(QRgb desiredColor);
+
+    // The available colors in ascending order and their values
+    std::vector<QRgb> m_colors;
+    std::vector<QVariant> m_values;
+    // The components of the available colors in separate arrays, so the
+    // distances to all of them are computed in a single vectorized loop
+    std::vector<int> m_reds;
+    std::vector<int> m_greens;
+    std::vector<int> m_blues;
+    std::vector<int> m_distances;
+    // The nearest color indices of all colors that have been looked up
+    QHash<QRgb, int> m_nearestColorIndices;
 };
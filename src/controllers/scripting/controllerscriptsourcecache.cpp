@@ -0,0 +1,73 @@
+#include "controllers/scripting/controllerscriptsourcecache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <utility>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+struct CachedSourceCode {
+    qint64 size;
+    QDateTime lastModified;
+    QString sourceCode;
+};
+
+QMutex s_mutex;
+QHash<QString, CachedSourceCode> s_cachedSourceCodes;
+
+} // anonymous namespace
+
+// static
+bool ControllerScriptSourceCache::readSourceCode(
+        const QString& absoluteFilePath,
+        QString* pSourceCode,
+        QString* pErrorString) {
+    DEBUG_ASSERT(pSourceCode);
+    DEBUG_ASSERT(pErrorString);
+    const QFileInfo fileInfo(absoluteFilePath);
+    const qint64 size = fileInfo.size();
+    const QDateTime lastModified = fileInfo.lastModified();
+    {
+        const auto locker = lockMutex(&s_mutex);
+        const auto it = s_cachedSourceCodes.constFind(absoluteFilePath);
+        if (it != s_cachedSourceCodes.constEnd() &&
+                it->size == size &&
+                it->lastModified == lastModified) {
+            *pSourceCode = it->sourceCode;
+            return true;
+        }
+    }
+
+    // Read the file without holding the lock
+    QFile input(absoluteFilePath);
+    if (!input.open(QIODevice::ReadOnly)) {
+        *pErrorString = input.errorString();
+        return false;
+    }
+    QString sourceCode = QString::fromUtf8(input.readAll()) + QStringLiteral("\n");
+    input.close();
+
+    const auto locker = lockMutex(&s_mutex);
+    s_cachedSourceCodes.insert(absoluteFilePath,
+            CachedSourceCode{size, lastModified, sourceCode});
+    *pSourceCode = std::move(sourceCode);
+    return true;
+}
+
+// static
+void ControllerScriptSourceCache::invalidate(const QString& absoluteFilePath) {
+    const auto locker = lockMutex(&s_mutex);
+    s_cachedSourceCodes.remove(absoluteFilePath);
+}
+
+// static
+void ControllerScriptSourceCache::clear() {
+    const auto locker = lockMutex(&s_mutex);
+    s_cachedSourceCodes.clear();
+}
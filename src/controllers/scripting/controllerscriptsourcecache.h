@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QString>
+
+/// Process wide cache of the decoded source code of controller script files.
+///
+/// Libraries like common-controller-scripts.js or midi-components are loaded
+/// by the mappings of all connected controllers and again on every mapping
+/// reload. The cache ensures that each of them is only read and decoded once
+/// as long as the file doesn't change. Entries are validated against the
+/// size and modification time of the file. The file watchers of the script
+/// engines invalidate entries explicitly.
+///
+/// All functions are thread-safe, because controllers may run their script
+/// engines on different threads.
+class ControllerScriptSourceCache final {
+  public:
+    ControllerScriptSourceCache() = delete;
+
+    /// Reads the source code of the script file from the cache or from disk.
+    /// @return false and sets pErrorString if the file couldn't be read
+    static bool readSourceCode(
+            const QString& absoluteFilePath,
+            QString* pSourceCode,
+            QString* pErrorString);
+
+    static void invalidate(const QString& absoluteFilePath);
+
+    static void clear();
+};
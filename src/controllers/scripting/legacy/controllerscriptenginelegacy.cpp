@@ -15,6 +15,7 @@
 #include "controllers/rendering/controllerrenderingengine.h"
 #endif
 #include "controllers/scripting/colormapperjsproxy.h"
+#include "controllers/scripting/controllerscriptsourcecache.h"
 #include "controllers/scripting/legacy/controllerscriptinterfacelegacy.h"
 #include "errordialoghandler.h"
 #include "mixer/playermanager.h"
@@ -33,6 +34,11 @@ const QByteArray kScreenTransformFunctionUntypedSignature =
                 "transformFrame(QVariant,QVariant)");
 const QByteArray kScreenTransformFunctionTypedSignature =
         QMetaObject::normalizedSignature("transformFrame(QVariant,QDateTime)");
+const QByteArray kScreenTransformFunctionWithDamageUntypedSignature =
+        QMetaObject::normalizedSignature(
+                "transformFrame(QVariant,QVariant,QVariant)");
+const QByteArray kScreenTransformFunctionWithDamageTypedSignature =
+        QMetaObject::normalizedSignature("transformFrame(QVariant,QDateTime,QRectF)");
 const QByteArray kScreenInitFunctionUntypedSignature =
         QMetaObject::normalizedSignature(
                 "init(QVariant,QVariant)");
@@ -45,12 +51,14 @@ const QByteArray kScreenShutdownFunctionSignature =
 
 ControllerScriptEngineLegacy::ControllerScriptEngineLegacy(
         Controller* controller, const RuntimeLoggingCategory& logger)
-        : ControllerScriptEngineBase(controller, logger) {
+        : ControllerScriptEngineBase(controller, logger),
+          m_skipUnchangedIncomingData(false) {
     connect(&m_fileWatcher,
             &QFileSystemWatcher::fileChanged,
             this,
             [this](const QString& changedFile) {
                 qCDebug(m_logger) << "File" << changedFile << "has been changed.";
+                ControllerScriptSourceCache::invalidate(changedFile);
                 // This is to prevent double-reload when a file is updated twice
                 // in a row as part of the normal saving process. See note in
                 // QFileSystemWatcher::fileChanged documentation.
@@ -396,19 +404,14 @@ bool ControllerScriptEngineLegacy::initialize() {
 #endif
 
     // Binary data is passed from the Controller as a QByteArray, which
-    // QJSEngine::toScriptValue converts to an ArrayBuffer in JavaScript.
+    // QJSEngine::toScriptValue converts to an ArrayBuffer in JavaScript
+    // that shares the implicitly shared data of the QByteArray.
     // ArrayBuffer cannot be accessed with the [] operator in JS; it needs
     // to be converted to a typed array (Uint8Array in this case) first.
-    // This function generates a wrapper function from a JS callback to do
-    // that conversion automatically.
-    m_makeArrayBufferWrapperFunction = m_pJSEngine->evaluate(QStringLiteral(
-            // arg2 is the timestamp for ControllerScriptModuleEngine.
-            // In ControllerScriptEngineLegacy it is the length of the array.
-            "(function(callback) {"
-            "    return function(arrayBuffer, arg2) {"
-            "        callback(new Uint8Array(arrayBuffer), arg2);"
-            "    };"
-            "})"));
+    // The typed array is constructed once per incoming packet and passed
+    // to all incomingData functions, instead of wrapping each function.
+    m_uint8ArrayConstructor = m_pJSEngine->globalObject().property(
+            QStringLiteral("Uint8Array"));
 
     // Make this ControllerScriptHandler instance available to scripts as 'engine'.
     QJSValue engineGlobalObject = m_pJSEngine->globalObject();
@@ -515,8 +518,7 @@ bool ControllerScriptEngineLegacy::initialize() {
         }
         functionName.append(QStringLiteral(".incomingData"));
         m_incomingDataFunctions.append(
-                wrapArrayBufferCallback(
-                        wrapFunctionCode(functionName, 2)));
+                wrapFunctionCode(functionName, 2));
     }
 
 #ifdef MIXXX_USE_QML
@@ -551,7 +553,19 @@ void ControllerScriptEngineLegacy::extractTransformFunction(
 
     QMetaMethod transformFunction;
     bool typed = false;
-    int methodIdx = metaObject->indexOfMethod(kScreenTransformFunctionUntypedSignature);
+    // Functions that accept the changed rectangle can send partial updates
+    bool withDamage = true;
+    int methodIdx = metaObject->indexOfMethod(kScreenTransformFunctionWithDamageUntypedSignature);
+    if (methodIdx == -1 || !metaObject->method(methodIdx).isValid()) {
+        methodIdx = metaObject->indexOfMethod(kScreenTransformFunctionWithDamageTypedSignature);
+        typed = true;
+    }
+
+    if (methodIdx == -1 || !metaObject->method(methodIdx).isValid()) {
+        withDamage = false;
+        typed = false;
+        methodIdx = metaObject->indexOfMethod(kScreenTransformFunctionUntypedSignature);
+    }
 
     if (methodIdx == -1 || !metaObject->method(methodIdx).isValid()) {
         qCDebug(m_logger) << "QML Scene for screen" << screenIdentifier
@@ -575,7 +589,7 @@ void ControllerScriptEngineLegacy::extractTransformFunction(
     }
 
     m_transformScreenFrameFunctions.insert(screenIdentifier,
-            TransformScreenFrameFunction{transformFunction, typed});
+            TransformScreenFrameFunction{transformFunction, typed, withDamage});
 }
 
 bool ControllerScriptEngineLegacy::bindSceneToScreen(
@@ -618,7 +632,8 @@ bool ControllerScriptEngineLegacy::bindSceneToScreen(
 void ControllerScriptEngineLegacy::handleScreenFrame(
         const LegacyControllerMapping::ScreenInfo& screenInfo,
         const QImage& frame,
-        const QDateTime& timestamp) {
+        const QDateTime& timestamp,
+        const QRect& damage) {
     VERIFY_OR_DEBUG_ASSERT(
             m_transformScreenFrameFunctions.contains(screenInfo.identifier) ||
             m_renderingScreens.contains(screenInfo.identifier)) {
@@ -681,19 +696,38 @@ void ControllerScriptEngineLegacy::handleScreenFrame(
     }
     // During the frame transformation, any QML errors are considered fatal.
     setErrorsAreFatal(true);
-    bool isSuccessful = transformMethod.typed
-            ? transformMethod.method.invoke(
-                      m_rootItems.value(screenInfo.identifier).get(),
-                      Qt::DirectConnection,
-                      Q_RETURN_ARG(QVariant, returnedValue),
-                      Q_ARG(QVariant, input),
-                      Q_ARG(QDateTime, timestamp))
-            : transformMethod.method.invoke(
-                      m_rootItems.value(screenInfo.identifier).get(),
-                      Qt::DirectConnection,
-                      Q_RETURN_ARG(QVariant, returnedValue),
-                      Q_ARG(QVariant, input),
-                      Q_ARG(QVariant, timestamp));
+    bool isSuccessful;
+    if (transformMethod.withDamage) {
+        isSuccessful = transformMethod.typed
+                ? transformMethod.method.invoke(
+                          m_rootItems.value(screenInfo.identifier).get(),
+                          Qt::DirectConnection,
+                          Q_RETURN_ARG(QVariant, returnedValue),
+                          Q_ARG(QVariant, input),
+                          Q_ARG(QDateTime, timestamp),
+                          Q_ARG(QRectF, QRectF(damage)))
+                : transformMethod.method.invoke(
+                          m_rootItems.value(screenInfo.identifier).get(),
+                          Qt::DirectConnection,
+                          Q_RETURN_ARG(QVariant, returnedValue),
+                          Q_ARG(QVariant, input),
+                          Q_ARG(QVariant, timestamp),
+                          Q_ARG(QVariant, QRectF(damage)));
+    } else {
+        isSuccessful = transformMethod.typed
+                ? transformMethod.method.invoke(
+                          m_rootItems.value(screenInfo.identifier).get(),
+                          Qt::DirectConnection,
+                          Q_RETURN_ARG(QVariant, returnedValue),
+                          Q_ARG(QVariant, input),
+                          Q_ARG(QDateTime, timestamp))
+                : transformMethod.method.invoke(
+                          m_rootItems.value(screenInfo.identifier).get(),
+                          Qt::DirectConnection,
+                          Q_RETURN_ARG(QVariant, returnedValue),
+                          Q_ARG(QVariant, input),
+                          Q_ARG(QVariant, timestamp));
+    }
     setErrorsAreFatal(false);
 
     if (!isSuccessful) {
@@ -774,6 +808,7 @@ void ControllerScriptEngineLegacy::shutdown() {
 #endif
     m_scriptWrappedFunctionCache.clear();
     m_incomingDataFunctions.clear();
+    m_lastIncomingData.clear();
     m_scriptFunctionPrefixes.clear();
     if (m_pJSEngine) {
         ControllerScriptEngineBase::shutdown();
@@ -787,8 +822,21 @@ bool ControllerScriptEngineLegacy::handleIncomingData(const QByteArray& data) {
         return false;
     }
 
+    if (m_incomingDataFunctions.isEmpty()) {
+        return true;
+    }
+
+    if (m_skipUnchangedIncomingData) {
+        if (data == m_lastIncomingData) {
+            return true;
+        }
+        // Shallow copy of the implicitly shared data
+        m_lastIncomingData = data;
+    }
+
     const auto args = QJSValueList{
-            m_pJSEngine->toScriptValue(data),
+            m_uint8ArrayConstructor.callAsConstructor(
+                    QJSValueList{m_pJSEngine->toScriptValue(data)}),
             static_cast<uint>(data.size()),
     };
 
@@ -817,16 +865,16 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
     qCDebug(m_logger) << "Loading"
                       << scriptFile.absoluteFilePath();
 
-    // Read in the script file
+    // Read in the script file. Libraries that are shared between mappings
+    // are only read once.
     QString filename = scriptFile.absoluteFilePath();
-    QFile input(filename);
-    if (!input.open(QIODevice::ReadOnly)) {
+    QString scriptCode;
+    QString errorString;
+    if (!ControllerScriptSourceCache::readSourceCode(filename, &scriptCode, &errorString)) {
         qCWarning(m_logger) << QString(
                 "Problem opening the script file: %1, "
-                "error # %2, %3")
-                                       .arg(filename,
-                                               QString::number(input.error()),
-                                               input.errorString());
+                "error %2")
+                                       .arg(filename, errorString);
         // Set up error dialog
         ErrorDialogProperties* props = ErrorDialogHandler::instance()->newDialogProperties();
         props->setType(DLG_WARNING);
@@ -843,16 +891,13 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
         // when they don't speak english.
         props->setDetails(tr("File:") + QStringLiteral(" ") + filename +
                 QStringLiteral("\n") + tr("Error:") + QStringLiteral(" ") +
-                input.errorString());
+                errorString);
 
         // Ask above layer to display the dialog & handle user response
         ErrorDialogHandler::instance()->requestErrorDialog(props);
         return false;
     }
 
-    QString scriptCode = QString(input.readAll()) + QStringLiteral("\n");
-    input.close();
-
     QJSValue scriptFunction = m_pJSEngine->evaluate(scriptCode, filename);
     if (scriptFunction.isError()) {
         showScriptExceptionDialog(scriptFunction, true);
@@ -946,6 +991,7 @@ std::shared_ptr<QQuickItem> ControllerScriptEngineLegacy::loadQMLFile(
 }
 #endif
 
-QJSValue ControllerScriptEngineLegacy::wrapArrayBufferCallback(const QJSValue& callback) {
-    return m_makeArrayBufferWrapperFunction.call(QJSValueList{callback});
+void ControllerScriptEngineLegacy::setSkipUnchangedIncomingData(bool skip) {
+    m_skipUnchangedIncomingData = skip;
+    m_lastIncomingData.clear();
 }
@@ -29,6 +29,10 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
 
     bool handleIncomingData(const QByteArray& data);
 
+    /// Skip incoming packets that are identical to the previous packet
+    /// instead of passing them to the incomingData functions.
+    void setSkipUnchangedIncomingData(bool skip);
+
     /// Wrap a string of JS code in an anonymous function. This allows any JS
     /// string that evaluates to a function to be used in MIDI mapping XML files
     /// and ensures the function is executed with the correct 'this' object.
@@ -61,7 +65,8 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     void handleScreenFrame(
             const LegacyControllerMapping::ScreenInfo& screeninfo,
             const QImage& frame,
-            const QDateTime& timestamp);
+            const QDateTime& timestamp,
+            const QRect& damage);
 
   signals:
     /// Emitted when a screen has been rendered.
@@ -91,6 +96,8 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     struct TransformScreenFrameFunction {
         QMetaMethod method;
         bool typed;
+        // Whether the function accepts the changed rectangle of the frame
+        bool withDamage = false;
     };
 #endif
 
@@ -101,14 +108,13 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     /// @return true if the hook was run successfully, or if there was none.
     bool callInitFunction();
     void shutdown() override;
-    QJSValue wrapArrayBufferCallback(const QJSValue& callback);
     bool callFunctionOnObjects(const QList<QString>& scriptFunctionPrefixes,
             const QString&,
             const QJSValueList& args = {},
             bool bFatalError = false);
     void watchFilePath(const QString& path);
 
-    QJSValue m_makeArrayBufferWrapperFunction;
+    QJSValue m_uint8ArrayConstructor;
     QList<QString> m_scriptFunctionPrefixes;
 #ifdef MIXXX_USE_QML
     QHash<QString, std::shared_ptr<ControllerRenderingEngine>> m_renderingScreens;
@@ -122,6 +128,8 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     QString m_resourcePath{QStringLiteral(".")};
 #endif
     QList<QJSValue> m_incomingDataFunctions;
+    bool m_skipUnchangedIncomingData;
+    QByteArray m_lastIncomingData;
     QHash<QString, QJSValue> m_scriptWrappedFunctionCache;
     QList<LegacyControllerMapping::ScriptFileInfo> m_scriptFiles;
     QHash<QString, QJSValue> m_settings;
@@ -7,6 +7,7 @@
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptinterfacelegacy.cpp"
 #include "util/fpclassify.h"
+#include "util/inputtimestamp.h"
 #include "util/make_const_iterator.h"
 #include "util/time.h"
 
@@ -96,13 +97,23 @@ ControlObjectScript* ControllerScriptInterfaceLegacy::getControlObjectScript(
     ConfigKey key = ConfigKey(group, name);
     ControlObjectScript* coScript = m_controlCache.value(key, nullptr);
     if (coScript == nullptr) {
+        // Looking up a missing control locks the global control registry,
+        // so it is only repeated if new controls have been added since.
+        const quint64 registrationCount = ControlDoublePrivate::registrationCount();
+        const auto missingIt = m_missingControls.constFind(key);
+        if (missingIt != m_missingControls.constEnd() &&
+                missingIt.value() == registrationCount) {
+            return nullptr;
+        }
         // create COT
         coScript = new ControlObjectScript(key, m_logger, this);
         if (coScript->valid()) {
             m_controlCache.insert(key, coScript);
+            m_missingControls.remove(key);
         } else {
             delete coScript;
             coScript = nullptr;
+            m_missingControls.insert(key, registrationCount);
         }
     }
     return coScript;
@@ -733,7 +744,7 @@ void ControllerScriptInterfaceLegacy::scratchEnable(int deck,
 }
 
 void ControllerScriptInterfaceLegacy::scratchTick(int deck, int interval) {
-    m_lastMovement[deck] = mixxx::Time::elapsed();
+    m_lastMovement[deck] = mixxx::InputTimestamp::current();
     m_intervalAccumulator[deck] += interval;
 }
 
@@ -1034,3 +1045,7 @@ void ControllerScriptInterfaceLegacy::softStart(int deck, bool activate, double
     // activate the ramping in scratchProcess()
     m_ramp[deck] = true;
 }
+
+void ControllerScriptInterfaceLegacy::skipUnchangedIncomingData(bool skip) {
+    m_pScriptEngineLegacy->setSkipUnchangedIncomingData(skip);
+}
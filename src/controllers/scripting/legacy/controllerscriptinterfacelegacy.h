@@ -69,6 +69,7 @@ class ControllerScriptInterfaceLegacy : public QObject {
             double factor = 1.8,
             const double rate = -10.0);
     Q_INVOKABLE void softStart(const int deck, bool activate, double factor = 1.0);
+    Q_INVOKABLE void skipUnchangedIncomingData(bool skip);
 
     bool removeScriptConnection(const ScriptConnection& conn);
     /// Execute a ScriptConnection's JS callback
@@ -83,6 +84,9 @@ class ControllerScriptInterfaceLegacy : public QObject {
             const QJSValue& callback,
             bool skipSuperseded = false);
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
+    // Controls that did not exist when they have been looked up, with the
+    // ControlDoublePrivate::registrationCount() at that time.
+    QHash<ConfigKey, quint64> m_missingControls;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
 
     SoftTakeoverCtrl m_st;
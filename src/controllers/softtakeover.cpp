@@ -23,17 +23,19 @@ SoftTakeoverCtrl::~SoftTakeoverCtrl() {
     }
 }
 
-void SoftTakeoverCtrl::enable(ControlObject* control) {
+SoftTakeover* SoftTakeoverCtrl::enable(ControlObject* control) {
     ControlPotmeter* cpo = qobject_cast<ControlPotmeter*>(control);
     if (cpo == nullptr) {
         // softtakecover works only for continuous ControlPotmeter based COs
-        return;
+        return nullptr;
     }
 
     // Initialize times
-    if (!m_softTakeoverHash.contains(control)) {
-        m_softTakeoverHash.insert(control, new SoftTakeover());
+    SoftTakeover*& pSt = m_softTakeoverHash[control];
+    if (pSt == nullptr) {
+        pSt = new SoftTakeover();
     }
+    return pSt;
 }
 
 void SoftTakeoverCtrl::disable(ControlObject* control) {
@@ -43,7 +43,9 @@ class SoftTakeoverCtrl {
 
     // Enable soft-takeover for the given Control.
     // This does nothing on a control that already has soft-takeover enabled.
-    void enable(ControlObject* control);
+    // Returns the state of the control, which stays valid until it is
+    // disabled, or nullptr if the control doesn't support soft-takeover.
+    SoftTakeover* enable(ControlObject* control);
     // Disable soft-takeover for the given Control
     void disable(ControlObject* control);
     // Check to see if the new value for the Control should be ignored
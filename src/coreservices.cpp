@@ -2,6 +2,7 @@
 
 #include <QApplication>
 #include <QFileDialog>
+#include <QSqlQuery>
 #include <QStandardPaths>
 #include <QtGlobal>
 
@@ -25,6 +26,7 @@
 #include "mixer/playerinfo.h"
 #include "mixer/playermanager.h"
 #include "moc_coreservices.cpp"
+#include "network/networkscheduler.h"
 #include "preferences/dialog/dlgpreferences.h"
 #include "preferences/settingsmanager.h"
 #ifdef __MODPLUG__
@@ -46,17 +48,24 @@
 #include "qml/qmlplayerproxy.h"
 #endif
 #include "soundio/soundmanager.h"
+#include "sources/seektablecache.h"
 #include "sources/soundsourceproxy.h"
 #include "util/clipboard.h"
 #include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
 #include "util/font.h"
 #include "util/logger.h"
 #include "util/screensavermanager.h"
+#include "util/startuptasks.h"
 #include "util/statsmanager.h"
+#include "util/threadplacement.h"
 #include "util/time.h"
 #include "util/translations.h"
 #include "util/versionstore.h"
 #include "vinylcontrol/vinylcontrolmanager.h"
+#include "waveform/waveformcache.h"
+#include "waveform/waveformthumbnailstore.h"
+#include "widget/svgrastercache.h"
 
 #ifdef __APPLE__
 #include "util/sandbox.h"
@@ -81,8 +90,31 @@ constexpr int kMicrophoneCount = 4;
 constexpr int kAuxiliaryCount = 4;
 constexpr int kSamplerCount = 4;
 
+// 0 keeps the default memory limit of the WaveformCache
+const ConfigKey kWaveformCacheBudgetConfigKey = ConfigKey(
+        QStringLiteral("[App]"), QStringLiteral("waveform_cache_memory_mb"));
+
 #define CLEAR_AND_CHECK_DELETED(x) clearHelper(x, #x);
 
+/// Reads the track tables once, so that the track collection and the
+/// library views find them in the file system cache.
+void warmUpLibraryCache(const mixxx::DbConnectionPoolPtr& pDbConnectionPool) {
+    const mixxx::DbConnectionPooler dbConnectionPooler(pDbConnectionPool);
+    QSqlDatabase database = mixxx::DbConnectionPooled(pDbConnectionPool);
+    if (!database.isOpen()) {
+        return;
+    }
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    for (const auto& statement : {QStringLiteral("SELECT * FROM library"),
+                 QStringLiteral("SELECT * FROM track_locations")}) {
+        if (query.exec(statement)) {
+            while (query.next()) {
+            }
+        }
+    }
+}
+
 template<typename T>
 void clearHelper(std::shared_ptr<T>& ref_ptr, const char* name) {
     std::weak_ptr<T> weak(ref_ptr);
@@ -136,8 +168,8 @@ CoreServices::CoreServices(const CmdlineArgs& args, QApplication* pApp)
     // called after the GUI is initialized
     initializeSettings();
     initializeLogging();
-    // Only record stats in developer mode.
-    if (m_cmdlineArgs.getDeveloper()) {
+    // Only record stats in developer mode or if they are exported
+    if (m_cmdlineArgs.getDeveloper() || !m_cmdlineArgs.getStatsdTarget().isEmpty()) {
         StatsManager::createInstance();
     }
     mixxx::Translations::initializeTranslations(
@@ -155,7 +187,7 @@ CoreServices::~CoreServices() {
     CLEAR_AND_CHECK_DELETED(m_pKbdConfig);
     CLEAR_AND_CHECK_DELETED(m_pKbdConfigEmpty);
 
-    if (m_cmdlineArgs.getDeveloper()) {
+    if (m_cmdlineArgs.getDeveloper() || !m_cmdlineArgs.getStatsdTarget().isEmpty()) {
         StatsManager::destroy();
     }
 
@@ -253,14 +285,39 @@ void CoreServices::initialize(QApplication* pApp) {
     UserSettingsPointer pConfig = m_pSettingsManager->settings();
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
+    mixxx::SeekTableCache::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath("seektables"));
+    SvgRasterCache::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath("skincache"));
+    // Before any engine or worker thread is started
+    mixxx::ThreadPlacement::init(pConfig);
 
     QString resourcePath = pConfig->getResourcePath();
 
-    emit initializationProgressUpdate(0, tr("fonts"));
-
-    FontUtils::initializeFonts(resourcePath); // takes a long time
-
-    emit initializationProgressUpdate(10, tr("database"));
+    // The steps that do not create objects for the main thread run in
+    // parallel to the other steps.
+    mixxx::StartupTasks startupTasks;
+    startupTasks.run(QStringLiteral("fonts"), [resourcePath] {
+        FontUtils::initializeFonts(resourcePath); // takes a long time
+    });
+    QList<mixxx::StartupTasks::TaskId> audioDevicesTasks;
+#ifndef __WINDOWS__
+    // Windows host APIs like ASIO initialize COM for the calling thread,
+    // so PortAudio needs to be initialized on the main thread there.
+    audioDevicesTasks.append(startupTasks.run(QStringLiteral("audio devices"), [] {
+        SoundManager::preinitializePortAudio();
+    }));
+#endif
+    QList<EffectsBackendPointer> pluginBackends;
+    const auto effectPluginsTask =
+            startupTasks.run(QStringLiteral("effect plugins"),
+                    [&pluginBackends, settingsPath = pConfig->getSettingsPath()] {
+                        pluginBackends = EffectsBackendManager::createPluginBackends(
+                                settingsPath);
+                    });
+
+    emit initializationProgressUpdate(0, tr("database"));
+    startupTasks.beginStep(QStringLiteral("database"));
     m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
     if (!m_pDbConnectionPool) {
         exit(-1);
@@ -270,13 +327,27 @@ void CoreServices::initialize(QApplication* pApp) {
     if (!initializeDatabase()) {
         exit(-1);
     }
+    startupTasks.run(QStringLiteral("library cache"),
+            [pDbConnectionPool = m_pDbConnectionPool] {
+                warmUpLibraryCache(pDbConnectionPool);
+            });
+
+    emit initializationProgressUpdate(10, tr("controllers"));
+    startupTasks.beginStep(QStringLiteral("controllers"));
+    // Initialize controller sub-system,
+    // but do not set up controllers until the end of the application startup.
+    // The controller thread instantiates the enumerators meanwhile.
+    qDebug() << "Creating ControllerManager";
+    m_pControllerManager = std::make_shared<ControllerManager>(pConfig);
 
     m_pControlIndicatorTimer = std::make_shared<mixxx::ControlIndicatorTimer>(this);
 
     auto pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
 
     emit initializationProgressUpdate(20, tr("effects"));
-    m_pEffectsManager = std::make_shared<EffectsManager>(pConfig, pChannelHandleFactory);
+    startupTasks.beginStep(QStringLiteral("effects"), {effectPluginsTask});
+    m_pEffectsManager = std::make_shared<EffectsManager>(
+            pConfig, pChannelHandleFactory, std::move(pluginBackends));
 
     m_pEngine = std::make_shared<EngineMixer>(
             pConfig,
@@ -289,6 +360,7 @@ void CoreServices::initialize(QApplication* pApp) {
 #endif
 
     emit initializationProgressUpdate(30, tr("audio interface"));
+    startupTasks.beginStep(QStringLiteral("audio interface"), audioDevicesTasks);
     // Although m_pSoundManager is created here, m_pSoundManager->setupDevices()
     // needs to be called after m_pPlayerManager registers sound IO for each EngineChannel.
     m_pSoundManager = std::make_shared<SoundManager>(pConfig, m_pEngine.get());
@@ -309,6 +381,7 @@ void CoreServices::initialize(QApplication* pApp) {
 #endif
 
     emit initializationProgressUpdate(40, tr("decks"));
+    startupTasks.beginStep(QStringLiteral("decks"));
     // Create the player manager. (long)
     m_pPlayerManager = std::make_shared<PlayerManager>(
             pConfig,
@@ -355,8 +428,18 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
-    CoverArtCache::createInstance();
+    startupTasks.beginStep(QStringLiteral("library"));
+    CoverArtCache::createInstance(pConfig);
+    WaveformThumbnailStore::openInstance(
+            QDir(pConfig->getSettingsPath()).filePath("waveform_thumbnails.pack"));
+    const qint64 waveformCacheMegabytes =
+            pConfig->getValue(kWaveformCacheBudgetConfigKey, 0);
+    if (waveformCacheMegabytes > 0) {
+        WaveformCache::instance().setMaxBytes(
+                static_cast<std::size_t>(waveformCacheMegabytes) * 1024 * 1024);
+    }
     Clipboard::createInstance();
+    mixxx::network::NetworkScheduler::createInstance(pConfig);
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
             this,
@@ -397,13 +480,6 @@ void CoreServices::initialize(QApplication* pApp) {
         }
     }
 
-    emit initializationProgressUpdate(60, tr("controllers"));
-    // Initialize controller sub-system,
-    // but do not set up controllers until the end of the application startup
-    // (long)
-    qDebug() << "Creating ControllerManager";
-    m_pControllerManager = std::make_shared<ControllerManager>(pConfig);
-
     // Scan the library for new files and directories
     bool rescan = pConfig->getValue<bool>(
             library::prefs::kRescanOnStartupConfigKey);
@@ -446,6 +522,10 @@ void CoreServices::initialize(QApplication* pApp) {
     // loaded a skin, see issue #6625
     if (rescan || musicDirAdded || m_pSettingsManager->shouldRescanLibrary()) {
         m_pTrackCollectionManager->startLibraryScan();
+    } else if (pConfig->getValue(library::prefs::kWatchDirectoriesConfigKey, false)) {
+        // Pick up the changes since the last run, the watcher only
+        // notices changes while running
+        m_pTrackCollectionManager->startModifiedDirectoriesScan();
     }
 
     // This has to be done before m_pSoundManager->setupDevices()
@@ -467,6 +547,18 @@ void CoreServices::initialize(QApplication* pApp) {
         }
     }
 
+    // The fonts are needed by the skin
+    startupTasks.beginStep(QStringLiteral("background tasks"));
+    startupTasks.waitForAll();
+    startupTasks.endStep();
+    if (m_cmdlineArgs.getDeveloper()) {
+        kLogger.info() << "Startup timeline:";
+        const QStringList timeline = startupTasks.timeline();
+        for (const auto& line : timeline) {
+            kLogger.info() << qPrintable(line);
+        }
+    }
+
     m_isInitialized = true;
 
 #ifdef MIXXX_USE_QML
@@ -640,6 +732,9 @@ void CoreServices::finalize() {
 
     Clipboard::destroy();
 
+    // Web tasks only keep a weak reference to the network access manager
+    mixxx::network::NetworkScheduler::destroy();
+
     // PlayerManager depends on Engine, SoundManager, VinylControlManager, and Config
     // The player manager has to be deleted before the library to ensure
     // that all modified track metadata of loaded tracks is saved.
@@ -652,6 +747,9 @@ void CoreServices::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting Library";
     CLEAR_AND_CHECK_DELETED(m_pLibrary);
 
+    // Analyzers of the library and the players write into the store
+    WaveformThumbnailStore::closeInstance();
+
     // RecordingManager depends on config, engine
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting RecordingManager";
     CLEAR_AND_CHECK_DELETED(m_pRecordingManager);
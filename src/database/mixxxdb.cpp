@@ -1,18 +1,21 @@
 #include "database/mixxxdb.h"
 
 #include <QDir>
+#include <algorithm>
 
 #include "database/schemamanager.h"
 #include "moc_mixxxdb.cpp"
 #include "util/assert.h"
+#include "util/db/fwdsqlquery.h"
 #include "util/logger.h"
+#include "util/performancetimer.h"
 
 // The schema XML is baked into the binary via Qt resources.
 //static
 const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 
 //static
-const int MixxxDb::kRequiredSchemaVersion = 39;
+const int MixxxDb::kRequiredSchemaVersion = 44;
 
 namespace {
 
@@ -30,6 +33,64 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+// The performance profile of the database connections. The "tuned"
+// profile uses a write-ahead log (WAL) that allows concurrent reads from
+// other connections, e.g. the GUI, while writing analysis results or
+// play counts. The "default" profile uses the rollback journal with
+// the default settings of SQLite, e.g. for databases on network shares
+// that don't support the shared memory of WAL.
+const ConfigKey kPerformanceProfileConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("DatabasePerformanceProfile"));
+const QString kPerformanceProfileTuned = QStringLiteral("tuned");
+
+const ConfigKey kMmapSizeMiBConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("DatabaseMmapSizeMiB"));
+constexpr int kDefaultMmapSizeMiB = 256;
+
+const ConfigKey kCacheSizeMiBConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("DatabaseCacheSizeMiB"));
+constexpr int kDefaultCacheSizeMiB = 32;
+
+void addPerformanceProfileStatements(
+        mixxx::DbConnection::Params* pParams,
+        const UserSettingsPointer& pConfig) {
+    if (pConfig->getValue(kPerformanceProfileConfigKey, kPerformanceProfileTuned) !=
+            kPerformanceProfileTuned) {
+        // The journal mode is persisted in the database file, so WAL
+        // needs to be reverted explicitly after switching back from the
+        // tuned profile. The other PRAGMAs only affect the connection.
+        pParams->openStatements = QStringList{
+                QStringLiteral("PRAGMA journal_mode=DELETE"),
+                // The default of SQLite
+                QStringLiteral("PRAGMA synchronous=FULL"),
+        };
+        return;
+    }
+    const int mmapSizeMiB = std::max(0,
+            pConfig->getValue(kMmapSizeMiBConfigKey, kDefaultMmapSizeMiB));
+    const int cacheSizeMiB = std::max(0,
+            pConfig->getValue(kCacheSizeMiBConfigKey, kDefaultCacheSizeMiB));
+    pParams->openStatements = QStringList{
+            // Persistent, but must be executed before the other PRAGMAs
+            QStringLiteral("PRAGMA journal_mode=WAL"),
+            // Safe with WAL, a power loss might only roll back the
+            // most recent transactions but never corrupts the database
+            QStringLiteral("PRAGMA synchronous=NORMAL"),
+            QStringLiteral("PRAGMA mmap_size=%1")
+                    .arg(static_cast<qint64>(mmapSizeMiB) * 1024 * 1024),
+            // Negative values are interpreted as KiB instead of pages
+            QStringLiteral("PRAGMA cache_size=-%1")
+                    .arg(static_cast<qint64>(cacheSizeMiB) * 1024),
+            QStringLiteral("PRAGMA temp_store=MEMORY"),
+    };
+    // Transfer all changes from the WAL into the database and truncate
+    // the WAL. This does nothing while other connections are still
+    // reading and the last connection checkpoints the WAL anyway.
+    pParams->closeStatements = QStringList{
+            QStringLiteral("PRAGMA wal_checkpoint(TRUNCATE)"),
+    };
+}
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -55,6 +116,9 @@ mixxx::DbConnection::Params dbConnectionParams(
     // https://www.sqlite.org/inmemorydb.html
     if (inMemoryConnection) {
         params.filePath += QStringLiteral("?mode=memory&cache=shared");
+    } else {
+        // In-memory databases have no journal
+        addPerformanceProfileStatements(&params, pConfig);
     }
     params.userName = kUserName;
     params.password = kPassword;
@@ -117,3 +181,60 @@ bool MixxxDb::initDatabaseSchema(
     DEBUG_ASSERT(!"unhandled switch/case");
     return false;
 }
+
+// static
+bool MixxxDb::executeDeferredSchemaStatements(
+        const QSqlDatabase& database,
+        int schemaVersion,
+        const QString& schemaFile) {
+    const QStringList statements =
+            SchemaManager::readDeferredStatements(schemaVersion, schemaFile);
+    if (statements.isEmpty()) {
+        return true;
+    }
+    kLogger.info()
+            << "Executing" << statements.size()
+            << "deferred database schema statements";
+    PerformanceTimer timer;
+    timer.start();
+    bool result = true;
+    for (const auto& statement : statements) {
+        FwdSqlQuery query(database, statement);
+        if (!query.isPrepared() || !query.execPrepared()) {
+            kLogger.warning()
+                    << "Failed to execute deferred database schema statement"
+                    << statement;
+            result = false;
+        }
+    }
+    kLogger.info()
+            << "Finished executing deferred database schema statements:"
+            << timer.elapsed().debugMillisWithUnit();
+    return result;
+}
+
+// static
+bool MixxxDb::checkDatabaseIntegrity(const QSqlDatabase& database) {
+    kLogger.info() << "Checking database integrity...";
+    PerformanceTimer timer;
+    timer.start();
+    // Skips the expensive verification that the indexes match the tables
+    FwdSqlQuery query(database, QStringLiteral("PRAGMA quick_check"));
+    if (!query.isPrepared() || !query.execPrepared()) {
+        kLogger.warning() << "Failed to check database integrity";
+        return false;
+    }
+    bool result = true;
+    while (query.next()) {
+        const QString message = query.fieldValue(0).toString();
+        // A single row with "ok" if no problems have been found
+        if (message != QLatin1String("ok")) {
+            kLogger.critical() << "Database integrity problem:" << message;
+            result = false;
+        }
+    }
+    kLogger.info()
+            << "Finished checking database integrity:"
+            << timer.elapsed().debugMillisWithUnit();
+    return result;
+}
@@ -18,6 +18,18 @@ class MixxxDb : public QObject {
             int schemaVersion = kRequiredSchemaVersion,
             const QString& schemaFile = kDefaultSchemaFile);
 
+    /// Executes the deferred statements of the schema, i.e. creates the
+    /// indexes that are still missing after initDatabaseSchema(). Takes long
+    /// for big libraries, so it is executed in the background after startup.
+    static bool executeDeferredSchemaStatements(
+            const QSqlDatabase& database,
+            int schemaVersion = kRequiredSchemaVersion,
+            const QString& schemaFile = kDefaultSchemaFile);
+
+    /// Checks the integrity of the database and logs the problems that are
+    /// found. Reads the whole database and is executed in the background.
+    static bool checkDatabaseIntegrity(const QSqlDatabase& database);
+
     explicit MixxxDb(
             const UserSettingsPointer& pConfig,
             bool inMemoryConnection = false);
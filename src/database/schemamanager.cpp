@@ -41,6 +41,55 @@ std::optional<int> readSchemaVersion(
     return schemaVersion;
 }
 
+std::optional<QMap<int, QDomElement>> readRevisions(const QString& schemaFilename) {
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Loading database schema migrations from"
+                << schemaFilename;
+    }
+    QDomElement schemaRoot = XmlParse::openXMLFile(schemaFilename, "schema");
+    if (schemaRoot.isNull()) {
+        kLogger.critical()
+                << "Failed to load database schema migrations from"
+                << schemaFilename;
+        return std::nullopt;
+    }
+
+    QDomNodeList revisions = schemaRoot.childNodes();
+
+    QMap<int, QDomElement> revisionMap;
+
+    for (int i = 0; i < revisions.count(); i++) {
+        QDomElement revision = revisions.at(i).toElement();
+        QString version = revision.attribute("version");
+        VERIFY_OR_DEBUG_ASSERT(!version.isNull()) {
+            kLogger.critical()
+                    << "Failed to parse database schema migrations from"
+                    << schemaFilename;
+            return std::nullopt;
+        }
+        int iVersion = version.toInt();
+        revisionMap[iVersion] = revision;
+    }
+    return revisionMap;
+}
+
+QStringList splitStatements(const QString& sql) {
+    QStringList statements;
+    // TODO(XXX) We can't have semicolons in schema.xml for anything other
+    // than statement separators.
+    const QStringList sqlStatements = sql.split(";");
+    for (const auto& sqlStatement : sqlStatements) {
+        QString statement = sqlStatement.trimmed();
+        if (statement.isEmpty()) {
+            // skip blank lines
+            continue;
+        }
+        statements.append(statement);
+    }
+    return statements;
+}
+
 } // namespace
 
 SchemaManager::SchemaManager(const QSqlDatabase& database)
@@ -131,36 +180,11 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
         }
     }
 
-    if (kLogger.debugEnabled()) {
-        kLogger.debug()
-                << "Loading database schema migrations from"
-                << schemaFilename;
-    }
-    QDomElement schemaRoot = XmlParse::openXMLFile(schemaFilename, "schema");
-    if (schemaRoot.isNull()) {
-        kLogger.critical()
-                << "Failed to load database schema migrations from"
-                << schemaFilename;
+    const auto revisionMap = readRevisions(schemaFilename);
+    if (!revisionMap) {
         return Result::SchemaError;
     }
 
-    QDomNodeList revisions = schemaRoot.childNodes();
-
-    QMap<int, QDomElement> revisionMap;
-
-    for (int i = 0; i < revisions.count(); i++) {
-        QDomElement revision = revisions.at(i).toElement();
-        QString version = revision.attribute("version");
-        VERIFY_OR_DEBUG_ASSERT(!version.isNull()) {
-            kLogger.critical()
-                    << "Failed to parse database schema migrations from"
-                    << schemaFilename;
-            return Result::SchemaError;
-        }
-        int iVersion = version.toInt();
-        revisionMap[iVersion] = revision;
-    }
-
     if (currentVersion < targetVersion) {
         kLogger.info()
                 << "Upgrading database schema"
@@ -170,7 +194,7 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
     int nextVersion = lastUsedVersion;
     while (nextVersion < targetVersion) {
         nextVersion += 1;
-        VERIFY_OR_DEBUG_ASSERT(revisionMap.contains(nextVersion)) {
+        VERIFY_OR_DEBUG_ASSERT(revisionMap->contains(nextVersion)) {
             kLogger.critical()
                     << "Migration path for upgrading database schema"
                     << "from version" << currentVersion
@@ -194,7 +218,7 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
             }
         }
 
-        QDomElement revision = revisionMap[nextVersion];
+        QDomElement revision = revisionMap->value(nextVersion);
         QDomElement eDescription = revision.firstChildElement("description");
         QDomElement eSql = revision.firstChildElement("sql");
 
@@ -222,19 +246,13 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
 
         SqlTransaction transaction(m_settingsDao.database());
 
-        // TODO(XXX) We can't have semicolons in schema.xml for anything other
-        // than statement separators.
-        QStringList sqlStatements = sql.split(";");
+        const QStringList sqlStatements = splitStatements(sql);
 
         QStringListIterator it(sqlStatements);
 
         bool result = true;
         while (result && it.hasNext()) {
-            QString statement = it.next().trimmed();
-            if (statement.isEmpty()) {
-                // skip blank lines
-                continue;
-            }
+            const QString& statement = it.next();
             FwdSqlQuery query(m_settingsDao.database(), statement);
             result = query.isPrepared() && query.execPrepared();
             if (!result &&
@@ -302,3 +320,25 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
         return Result::UpgradeSucceeded;
     }
 }
+
+// static
+QStringList SchemaManager::readDeferredStatements(
+        int targetVersion,
+        const QString& schemaFilename) {
+    const auto revisionMap = readRevisions(schemaFilename);
+    if (!revisionMap) {
+        return {};
+    }
+    QStringList statements;
+    for (auto it = revisionMap->cbegin(); it != revisionMap->cend(); ++it) {
+        if (it.key() > targetVersion) {
+            break;
+        }
+        const QDomElement eDeferredSql = it.value().firstChildElement("deferred_sql");
+        if (eDeferredSql.isNull()) {
+            continue;
+        }
+        statements += splitStatements(eDeferredSql.text());
+    }
+    return statements;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QStringList>
+
 #include "library/dao/settingsdao.h"
 
 class QSqlDatabase;
@@ -32,6 +34,16 @@ class SchemaManager {
     /// No-op if the versions are incompatible or the targetVersion is older.
     Result upgradeToSchemaVersion(int targetVersion, const QString& schemaFilename);
 
+    /// Reads the <deferred_sql> statements of all schema versions up to
+    /// targetVersion. These only speed up queries, e.g. by creating indexes,
+    /// and are not executed by upgradeToSchemaVersion(). Instead they are
+    /// executed in the background after startup, so they must be safe to
+    /// execute repeatedly. Returns an empty list if the schemaFile is
+    /// invalid.
+    static QStringList readDeferredStatements(
+            int targetVersion,
+            const QString& schemaFilename);
+
   private:
     const SettingsDAO m_settingsDao;
 };
@@ -2,9 +2,12 @@
 
 #include <QDateTime>
 #include <QDir>
+#include <QFileDialog>
+#include <QHeaderView>
 
 #include "control/control.h"
 #include "moc_dlgdevelopertools.cpp"
+#include "util/callbackprofiler.h"
 #include "util/logging.h"
 #include "util/statsmanager.h"
 
@@ -60,6 +63,29 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
 
     m_logCursor = logTextView->textCursor();
 
+    // Set up the callback profiler
+    profilerTable->setColumnCount(6);
+    profilerTable->setHorizontalHeaderLabels({tr("Stage"),
+            tr("Count"),
+            tr("p50 [\u00b5s]"),
+            tr("p99 [\u00b5s]"),
+            tr("Max [\u00b5s]"),
+            tr("Max [% of deadline]")});
+    profilerTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    profilerEnabled->setChecked(CallbackProfiler::instance().isEnabled());
+    connect(profilerEnabled,
+            &QCheckBox::toggled,
+            this,
+            &DlgDeveloperTools::slotProfilerEnabled);
+    connect(profilerReset,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotProfilerReset);
+    connect(profilerExport,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotProfilerExport);
+
     // Update at 2FPS.
     startTimer(500);
 
@@ -99,6 +125,8 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
         if (pManager) {
             pManager->updateStats();
         }
+    } else if (toolTabWidget->currentWidget() == profilerTab) {
+        updateProfilerTable();
     }
 }
 
@@ -138,3 +166,70 @@ void DlgDeveloperTools::slotLogSearch() {
     m_logCursor = logTextView->document()->find(textToFind, m_logCursor);
     logTextView->setTextCursor(m_logCursor);
 }
+
+void DlgDeveloperTools::slotProfilerEnabled(bool enabled) {
+    CallbackProfiler::instance().setEnabled(enabled);
+}
+
+void DlgDeveloperTools::slotProfilerReset() {
+    CallbackProfiler::instance().reset();
+    profilerTable->setRowCount(0);
+}
+
+void DlgDeveloperTools::slotProfilerExport() {
+    CallbackProfiler& profiler = CallbackProfiler::instance();
+    profiler.drain();
+
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString traceFileName = QFileDialog::getSaveFileName(this,
+            tr("Export Trace"),
+            m_pConfig->getSettingsPath() + "/callback_trace_" + timestamp + ".json",
+            tr("Chrome Trace (*.json)"));
+    if (traceFileName.isEmpty()) {
+        return;
+    }
+    QFile traceFile(traceFileName);
+    if (!traceFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "open" << traceFileName << "failed";
+        return;
+    }
+    traceFile.write(profiler.chromeTraceJson());
+}
+
+void DlgDeveloperTools::updateProfilerTable() {
+    CallbackProfiler& profiler = CallbackProfiler::instance();
+    profiler.drain();
+
+    const qint64 deadlineNs = profiler.deadlineNs();
+    if (deadlineNs > 0) {
+        profilerDeadline->setText(
+                tr("Deadline: %1 \u00b5s, dropped events: %2")
+                        .arg(QString::number(deadlineNs / 1000.0, 'f', 1),
+                                QString::number(profiler.droppedEvents())));
+    }
+
+    const QList<CallbackProfiler::StageStatistics> statistics = profiler.statistics();
+    // Sorting would move rows while they are filled
+    profilerTable->setSortingEnabled(false);
+    profilerTable->setRowCount(statistics.size());
+    const auto setNumber = [this](int row, int column, double value, int precision) {
+        auto* pItem = new QTableWidgetItem;
+        // Sort numerically
+        pItem->setData(Qt::DisplayRole, QString::number(value, 'f', precision).toDouble());
+        pItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        profilerTable->setItem(row, column, pItem);
+    };
+    for (int row = 0; row < statistics.size(); ++row) {
+        const CallbackProfiler::StageStatistics& stage = statistics[row];
+        profilerTable->setItem(row, 0, new QTableWidgetItem(stage.name));
+        setNumber(row, 1, stage.count, 0);
+        setNumber(row, 2, stage.p50Ns / 1000.0, 1);
+        setNumber(row, 3, stage.p99Ns / 1000.0, 1);
+        setNumber(row, 4, stage.maxNs / 1000.0, 1);
+        if (deadlineNs > 0) {
+            setNumber(row, 5, 100.0 * stage.maxNs / deadlineNs, 1);
+        }
+    }
+    profilerTable->setSortingEnabled(true);
+}
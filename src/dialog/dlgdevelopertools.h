@@ -21,8 +21,13 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     void slotControlSearch(const QString& search);
     void slotLogSearch();
     void slotControlDump();
+    void slotProfilerEnabled(bool enabled);
+    void slotProfilerReset();
+    void slotProfilerExport();
 
   private:
+    void updateProfilerTable();
+
     UserSettingsPointer m_pConfig;
     ControlSortFilterModel m_controlProxyModel;
 
@@ -0,0 +1,214 @@
+#include <dsp/rateconversion/Resampler.h>
+
+// Class header comes after library includes here since our preprocessor
+// definitions interfere with qm-dsp's headers.
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+
+#include <cmath>
+#include <random>
+
+#include "effects/backends/effectmanifest.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "util/defs.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// The impulse responses are synthesized at this rate and resampled to the
+// rate of the engine
+constexpr int kImpulseResponseSampleRate = 48000;
+
+// The PartitionedConvolver is stereo
+constexpr int kChannels = 2;
+
+struct ImpulseResponseShape {
+    // The time until the impulse response has decayed by 60 dB
+    double decaySeconds;
+    double preDelaySeconds;
+    // Coefficients of the one pole low pass at the start and the end of the
+    // impulse response, higher values are darker
+    double initialDamping;
+    double finalDamping;
+};
+
+// Indexed by ConvolutionReverbEffect::ImpulseResponse
+constexpr ImpulseResponseShape kImpulseResponseShapes[] = {
+        // Room
+        {0.6, 0.004, 0.2, 0.7},
+        // Hall
+        {2.4, 0.02, 0.3, 0.85},
+        // Plate
+        {1.6, 0.0, 0.05, 0.5},
+};
+
+// Exponentially decaying noise that gets darker over time, with
+// decorrelated channels
+std::vector<double> synthesizeImpulseResponse(
+        const ImpulseResponseShape& shape, int channel) {
+    const auto preDelayFrames = static_cast<SINT>(
+            shape.preDelaySeconds * kImpulseResponseSampleRate);
+    const auto decayFrames = static_cast<SINT>(
+            shape.decaySeconds * kImpulseResponseSampleRate);
+    std::vector<double> impulseResponse(preDelayFrames + decayFrames, 0);
+
+    std::minstd_rand generator(channel + 1);
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    // -60 dB after decayFrames
+    const double decay = std::pow(10.0, -3.0 / decayFrames);
+    double envelope = 1;
+    double lowPass = 0;
+    for (SINT i = 0; i < decayFrames; ++i) {
+        const double damping = shape.initialDamping +
+                (shape.finalDamping - shape.initialDamping) * i / decayFrames;
+        lowPass = (1 - damping) * distribution(generator) + damping * lowPass;
+        impulseResponse[preDelayFrames + i] = envelope * lowPass;
+        envelope *= decay;
+    }
+    return impulseResponse;
+}
+
+// Called on the worker thread of the PartitionedConvolver
+std::vector<CSAMPLE> loadImpulseResponse(int impulseResponse, int sampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(impulseResponse >= 0 &&
+            impulseResponse < static_cast<int>(std::size(kImpulseResponseShapes))) {
+        return {};
+    }
+    std::vector<double> channels[kChannels];
+    for (int channel = 0; channel < kChannels; ++channel) {
+        channels[channel] = synthesizeImpulseResponse(
+                kImpulseResponseShapes[impulseResponse], channel);
+        if (sampleRate != kImpulseResponseSampleRate) {
+            channels[channel] = Resampler::resample(kImpulseResponseSampleRate,
+                    sampleRate,
+                    channels[channel].data(),
+                    static_cast<int>(channels[channel].size()));
+        }
+        // Keep the loudness of the input at any sample rate
+        double energy = 0;
+        for (double sample : channels[channel]) {
+            energy += sample * sample;
+        }
+        const double gain = 1 / std::sqrt(energy);
+        for (double& sample : channels[channel]) {
+            sample *= gain;
+        }
+    }
+
+    const SINT frames = channels[0].size();
+    std::vector<CSAMPLE> interleaved(frames * kChannels);
+    for (SINT i = 0; i < frames; ++i) {
+        for (int channel = 0; channel < kChannels; ++channel) {
+            interleaved[i * kChannels + channel] =
+                    static_cast<CSAMPLE>(channels[channel][i]);
+        }
+    }
+    return interleaved;
+}
+
+} // anonymous namespace
+
+// static
+QString ConvolutionReverbEffect::getId() {
+    return "org.mixxx.effects.convolutionreverb";
+}
+
+// static
+EffectManifestPointer ConvolutionReverbEffect::getManifest() {
+    EffectManifestPointer pManifest(new EffectManifest());
+    pManifest->setAddDryToWet(true);
+    pManifest->setEffectRampsFromDry(true);
+
+    pManifest->setId(getId());
+    pManifest->setName(QObject::tr("Convolution Reverb"));
+    pManifest->setShortName(QObject::tr("Conv Reverb"));
+    pManifest->setAuthor("The Mixxx Team");
+    pManifest->setVersion("1.0");
+    pManifest->setDescription(QObject::tr(
+            "Emulates the sound of the signal in a room by convolving it with "
+            "the impulse response of the room"));
+
+    EffectManifestParameterPointer impulseResponse = pManifest->addParameter();
+    impulseResponse->setId("impulse_response");
+    impulseResponse->setName(QObject::tr("Room"));
+    impulseResponse->setShortName(QObject::tr("Room"));
+    impulseResponse->setDescription(QObject::tr(
+            "The room whose impulse response is used"));
+    impulseResponse->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    impulseResponse->setRange(0, ImpulseResponse::Hall, 2);
+    impulseResponse->appendStep(qMakePair(QObject::tr("Room"), ImpulseResponse::Room));
+    impulseResponse->appendStep(qMakePair(QObject::tr("Hall"), ImpulseResponse::Hall));
+    impulseResponse->appendStep(qMakePair(QObject::tr("Plate"), ImpulseResponse::Plate));
+
+    EffectManifestParameterPointer send = pManifest->addParameter();
+    send->setId("send_amount");
+    send->setName(QObject::tr("Send"));
+    send->setShortName(QObject::tr("Send"));
+    send->setDescription(QObject::tr(
+            "How much of the signal to send in to the effect"));
+    send->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    send->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    send->setDefaultLinkType(EffectManifestParameter::LinkType::Linked);
+    send->setDefaultLinkInversion(EffectManifestParameter::LinkInversion::NotInverted);
+    send->setRange(0, 0, 1);
+
+    return pManifest;
+}
+
+ConvolutionReverbGroupState::ConvolutionReverbGroupState(
+        const mixxx::EngineParameters& engineParameters)
+        : EffectState(engineParameters),
+          convolver(loadImpulseResponse),
+          sendBuffer(kMaxEngineSamples),
+          sendPrevious(0) {
+}
+
+void ConvolutionReverbEffect::loadEngineEffectParameters(
+        const QMap<QString, EngineEffectParameterPointer>& parameters) {
+    m_pImpulseResponseParameter = parameters.value("impulse_response");
+    m_pSendParameter = parameters.value("send_amount");
+}
+
+void ConvolutionReverbEffect::processChannel(
+        ConvolutionReverbGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+
+    const auto sendCurrent = static_cast<CSAMPLE_GAIN>(m_pSendParameter->value());
+
+    // The impulse response is loaded in the background, the output is
+    // silent until it is available
+    pState->convolver.setImpulseResponse(m_pImpulseResponseParameter->toInt(),
+            static_cast<int>(engineParameters.sampleRate()));
+
+    // Prevent replaying the old tail from the last time the effect was
+    // enabled
+    if (enableState == EffectEnableState::Enabling) {
+        pState->convolver.reset();
+    }
+
+    // The send amount is applied before the convolution, so the tail keeps
+    // ringing when it is turned down
+    SampleUtil::copyWithRampingGain(pState->sendBuffer.data(),
+            pInput,
+            pState->sendPrevious,
+            sendCurrent,
+            engineParameters.samplesPerBuffer());
+    pState->convolver.process(pOutput,
+            pState->sendBuffer.data(),
+            engineParameters.framesPerBuffer());
+
+    // The ramping of the send parameter handles ramping when enabling, so
+    // this effect must handle ramping to dry when disabling itself (instead
+    // of being handled by EngineEffect::process).
+    if (enableState == EffectEnableState::Disabling) {
+        SampleUtil::applyRampingGain(pOutput, 1.0, 0.0, engineParameters.samplesPerBuffer());
+        pState->sendPrevious = 0;
+    } else {
+        pState->sendPrevious = sendCurrent;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QMap>
+
+#include "effects/backends/effectprocessor.h"
+#include "engine/filters/partitionedconvolver.h"
+#include "util/class.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+class ConvolutionReverbGroupState : public EffectState {
+  public:
+    ConvolutionReverbGroupState(const mixxx::EngineParameters& engineParameters);
+    ~ConvolutionReverbGroupState() override = default;
+
+    PartitionedConvolver convolver;
+    mixxx::SampleBuffer sendBuffer;
+    CSAMPLE_GAIN sendPrevious;
+};
+
+/// Convolves the signal with the impulse response of a room. Unlike the
+/// ReverbEffect, the CPU load does not depend on the settings: most of the
+/// impulse response is convolved on a worker thread.
+class ConvolutionReverbEffect : public EffectProcessorImpl<ConvolutionReverbGroupState> {
+  public:
+    ConvolutionReverbEffect() = default;
+    ~ConvolutionReverbEffect() override = default;
+
+    static QString getId();
+    static EffectManifestPointer getManifest();
+
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override;
+
+    void processChannel(
+            ConvolutionReverbGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+
+  private:
+    enum ImpulseResponse {
+        Room = 0,
+        Hall = 1,
+        Plate = 2,
+    };
+
+    QString debugString() const {
+        return getId();
+    }
+
+    EngineEffectParameterPointer m_pImpulseResponseParameter;
+    EngineEffectParameterPointer m_pSendParameter;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionReverbEffect);
+};
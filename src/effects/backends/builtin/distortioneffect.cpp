@@ -2,11 +2,14 @@
 
 #include "effects/backends/effectmanifest.h"
 #include "engine/effects/engineeffectparameter.h"
+#include "util/defs.h"
 
 namespace {
 inline CSAMPLE tanh_approx(CSAMPLE input) {
     return input / (1 + input * input / (3 + input * input / 5));
 }
+
+constexpr int kDefaultOversamplingFactor = 2;
 } // namespace
 
 // static
@@ -51,6 +54,20 @@ EffectManifestPointer DistortionEffect::getManifest() {
     drive->setNeutralPointOnScale(0);
     drive->setRange(0, 0, 1);
 
+    EffectManifestParameterPointer oversampling = pManifest->addParameter();
+    oversampling->setId("oversampling");
+    oversampling->setName(QObject::tr("Oversampling"));
+    oversampling->setShortName(QObject::tr("Oversampling"));
+    oversampling->setDescription(QObject::tr(
+            "Processes the audio at a higher sample rate, which reduces "
+            "the harsh aliasing of high frequencies at the cost of CPU load "
+            "and a latency of about half a millisecond."));
+    oversampling->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    oversampling->setRange(0, 1, 2);
+    oversampling->appendStep(qMakePair(QObject::tr("Off"), Oversampling::Off));
+    oversampling->appendStep(qMakePair(QObject::tr("2x"), Oversampling::TwoTimes));
+    oversampling->appendStep(qMakePair(QObject::tr("4x"), Oversampling::FourTimes));
+
     return pManifest;
 }
 
@@ -61,8 +78,11 @@ DistortionGroupState::DistortionGroupState(
           m_crossfadeParameter(0),
           m_samplerate(engineParameters.sampleRate()),
           m_previousMakeUpGain(1),
-          m_previousNormalizationGain(1) {
+          m_previousNormalizationGain(1),
+          m_oversampler(kMaxEngineFrames, kDefaultOversamplingFactor),
+          m_dry(kMaxEngineSamples) {
 }
+
 struct DistortionEffect::SoftClippingParameters {
     static constexpr const CSAMPLE normalizationLevel = 0.2f;
     static constexpr const CSAMPLE crossfadeEndParam = 0.2f;
@@ -87,6 +107,7 @@ void DistortionEffect::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
     m_pMode = parameters.value("mode");
     m_pDrive = parameters.value("drive");
+    m_pOversampling = parameters.value("oversampling");
 }
 
 void DistortionEffect::processChannel(
@@ -97,9 +118,11 @@ void DistortionEffect::processChannel(
         const EffectEnableState enableState,
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
-    Q_UNUSED(enableState);
 
-    // TODO: anti-aliasing
+    if (enableState == EffectEnableState::Enabling) {
+        pState->m_oversampler.reset();
+    }
+    pState->m_oversampler.setFactor(1 << m_pOversampling->toInt());
 
     SINT numSamples = engineParameters.samplesPerBuffer();
     CSAMPLE driveParam = static_cast<CSAMPLE>(m_pDrive->value());
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "effects/backends/effectprocessor.h"
+#include "engine/filters/polyphaseoversampler.h"
 #include "util/class.h"
 #include "util/sample.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class DistortionGroupState : public EffectState {
@@ -16,6 +18,11 @@ class DistortionGroupState : public EffectState {
 
     CSAMPLE m_previousMakeUpGain;
     CSAMPLE m_previousNormalizationGain;
+
+    // Reduces the aliasing of the waveshaper
+    PolyphaseOversampler m_oversampler;
+    // The input delayed by the latency of the oversampler
+    mixxx::SampleBuffer m_dry;
 };
 
 class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
@@ -43,6 +50,13 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
         HardClipping = 1,
     };
 
+    // The oversampling factor is 2 ^ Oversampling
+    enum Oversampling {
+        Off = 0,
+        TwoTimes = 1,
+        FourTimes = 2,
+    };
+
     struct SoftClippingParameters;
     struct HardClippingParameters;
 
@@ -52,7 +66,13 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
             CSAMPLE* pOutput,
             const CSAMPLE* pInput,
             const mixxx::EngineParameters& engineParameters) {
-        SINT numSamples = engineParameters.samplesPerBuffer();
+        const SINT numFrames = engineParameters.framesPerBuffer();
+        const SINT numSamples = engineParameters.samplesPerBuffer();
+
+        // The dry signal is mixed with the processed signal, which is
+        // delayed by the oversampler
+        CSAMPLE* pDry = pState->m_dry.data();
+        pState->m_oversampler.delayDry(pDry, pInput, numFrames);
 
         // Normalize input
         pState->m_previousNormalizationGain =
@@ -67,17 +87,18 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
         SampleUtil::copyWithRampingGain(
                 pOutput, pInput, pState->m_driveGain, driveGain, numSamples);
 
-        // Waveshape
-        for (SINT i = 0;
-                i < engineParameters.samplesPerBuffer();
-                i += engineParameters.channelCount()) {
-            for (int channel = 0; channel < engineParameters.channelCount(); ++channel) {
-                pOutput[i + channel] = ModeParams::process(pOutput[i + channel]);
-            }
+        // Waveshape at the oversampled rate, so the harmonics above the
+        // Nyquist frequency are removed instead of folding back
+        CSAMPLE* pOversampled = pState->m_oversampler.upsample(pOutput, numFrames);
+        const SINT numOversampledSamples = numSamples * pState->m_oversampler.factor();
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numOversampledSamples; ++i) {
+            pOversampled[i] = ModeParams::process(pOversampled[i]);
         }
+        pState->m_oversampler.downsample(pOutput, numFrames);
 
         // Volume compensation
-        CSAMPLE pInputRMS = SampleUtil::rms(pInput, numSamples);
+        CSAMPLE pInputRMS = SampleUtil::rms(pDry, numSamples);
         CSAMPLE pOutputRMS = SampleUtil::rms(pOutput, numSamples);
         CSAMPLE_GAIN gain = pOutputRMS == CSAMPLE_ZERO
                 ? 1
@@ -97,7 +118,7 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
                 crossfadeParam,
                 numSamples);
         SampleUtil::addWithRampingGain(pOutput,
-                pInput,
+                pDry,
                 1 - pState->m_crossfadeParameter,
                 1 - crossfadeParam,
                 numSamples);
@@ -112,6 +133,7 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
 
     EngineEffectParameterPointer m_pMode;
     EngineEffectParameterPointer m_pDrive;
+    EngineEffectParameterPointer m_pOversampling;
 
     DISALLOW_COPY_AND_ASSIGN(DistortionEffect);
 };
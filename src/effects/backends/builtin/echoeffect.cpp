@@ -5,21 +5,10 @@
 #include "util/math.h"
 #include "util/rampingvalue.h"
 #include "util/sample.h"
+#include "util/span.h"
 
 constexpr int EchoGroupState::kMaxDelaySeconds;
 
-namespace {
-
-void incrementRing(int* pIndex, int increment, int length) {
-    *pIndex = (*pIndex + increment) % length;
-}
-
-void decrementRing(int* pIndex, int decrement, int length) {
-    *pIndex = (*pIndex + length - decrement) % length;
-}
-
-} // anonymous namespace
-
 // static
 QString EchoEffect::getId() {
     return "org.mixxx.effects.echo";
@@ -158,12 +147,10 @@ void EchoEffect::processChannel(
         delay_samples = pGroupState->delay_buf.size();
     }
 
-    int prev_read_position = pGroupState->write_position;
-    decrementRing(&prev_read_position,
-            pGroupState->prev_delay_samples,
-            pGroupState->delay_buf.size());
-    int read_position = pGroupState->write_position;
-    decrementRing(&read_position, delay_samples, pGroupState->delay_buf.size());
+    // A delay change is cross-faded over the whole buffer
+    const int prev_delay_samples = pGroupState->prev_delay_samples > 0
+            ? pGroupState->prev_delay_samples
+            : delay_samples;
 
     RampingValue<CSAMPLE_GAIN> send(send_current,
             pGroupState->prev_send,
@@ -174,68 +161,78 @@ void EchoEffect::processChannel(
             pGroupState->prev_feedback,
             engineParameters.framesPerBuffer());
 
-    int rampIndex = 0;
+    // The delayed samples are read as a block before the input and feedback
+    // of the same samples are written, so the buffer is processed in chunks
+    // which are not longer than the delay.
+    const SINT samplesPerBuffer = engineParameters.samplesPerBuffer();
+    const SINT maxChunkSamples = math_min(
+            static_cast<SINT>(math_min(delay_samples, prev_delay_samples)),
+            pGroupState->feedback_buf.size());
+    CSAMPLE* pFeedback = pGroupState->feedback_buf.data();
+
     //TODO: rewrite to remove assumption of stereo buffer
-    for (SINT i = 0;
-            i < engineParameters.samplesPerBuffer();
-            i += engineParameters.channelCount()) {
-        CSAMPLE_GAIN send_ramped = send.getNth(rampIndex);
-        CSAMPLE_GAIN feedback_ramped = feedback.getNth(rampIndex);
-        ++rampIndex;
-
-        CSAMPLE bufferedSampleLeft = pGroupState->delay_buf[read_position];
-        CSAMPLE bufferedSampleRight = pGroupState->delay_buf[read_position + 1];
-        if (read_position != prev_read_position) {
-            const CSAMPLE_GAIN frac = static_cast<CSAMPLE_GAIN>(i) /
-                    engineParameters.samplesPerBuffer();
-            bufferedSampleLeft *= frac;
-            bufferedSampleRight *= frac;
-            bufferedSampleLeft += pGroupState->delay_buf[prev_read_position] * (1 - frac);
-            bufferedSampleRight += pGroupState->delay_buf[prev_read_position + 1] * (1 - frac);
-            incrementRing(&prev_read_position,
-                    engineParameters.channelCount(),
-                    pGroupState->delay_buf.size());
-        }
-        incrementRing(&read_position,
-                engineParameters.channelCount(),
-                pGroupState->delay_buf.size());
-
-        // Actual delays distort and saturate, so clamp the buffer here.
-        pGroupState->delay_buf[pGroupState->write_position] = SampleUtil::clampSample(
-                pInput[i] * send_ramped +
-                bufferedSampleLeft * feedback_ramped);
-        pGroupState->delay_buf[pGroupState->write_position + 1] = SampleUtil::clampSample(
-                pInput[i + 1] * send_ramped +
-                bufferedSampleRight * feedback_ramped);
-
-        // Pingpong the output.  If the pingpong value is zero, all of the
-        // math below should result in a simple copy of delay buf to pOutput.
-        if (pGroupState->ping_pong < delay_samples / 2) {
-            // Left sample plus a fraction of the right sample, normalized
-            // by 1 + fraction.
-            pOutput[i] =
-                    (bufferedSampleLeft + bufferedSampleRight * pingpong_frac) /
-                    (1 + pingpong_frac);
-            // Right sample reduced by (1 - fraction)
-            pOutput[i + 1] = bufferedSampleRight * (1 - pingpong_frac);
+    for (SINT chunkStart = 0; chunkStart < samplesPerBuffer;) {
+        const SINT chunkSamples = math_min(maxChunkSamples, samplesPerBuffer - chunkStart);
+        // The delayed samples are the wet output before ping-ponging
+        const auto delayed = mixxx::spanutil::spanFromPtrLen(
+                pOutput + chunkStart, chunkSamples);
+        if (prev_delay_samples != delay_samples) {
+            pGroupState->delay_buf.readCrossfaded(delayed,
+                    prev_delay_samples - chunkSamples,
+                    delay_samples - chunkSamples,
+                    static_cast<CSAMPLE_GAIN>(chunkStart) / samplesPerBuffer,
+                    static_cast<CSAMPLE_GAIN>(chunkStart + chunkSamples) /
+                            samplesPerBuffer);
         } else {
-            // Left sample reduced by (1 - fraction)
-            pOutput[i] = bufferedSampleLeft * (1 - pingpong_frac);
-            // Right sample plus fraction of left sample, normalized by
-            // 1 + fraction
-            pOutput[i + 1] =
-                    (bufferedSampleRight + bufferedSampleLeft * pingpong_frac) /
-                    (1 + pingpong_frac);
+            pGroupState->delay_buf.read(delayed, delay_samples - chunkSamples);
         }
 
-        incrementRing(&pGroupState->write_position,
-                engineParameters.channelCount(),
-                pGroupState->delay_buf.size());
+        for (SINT j = 0; j < chunkSamples; j += engineParameters.channelCount()) {
+            const SINT i = chunkStart + j;
+            const int rampIndex = static_cast<int>(i / engineParameters.channelCount());
+            CSAMPLE_GAIN send_ramped = send.getNth(rampIndex);
+            CSAMPLE_GAIN feedback_ramped = feedback.getNth(rampIndex);
+
+            const CSAMPLE bufferedSampleLeft = pOutput[i];
+            const CSAMPLE bufferedSampleRight = pOutput[i + 1];
+
+            // Actual delays distort and saturate, so clamp the buffer here.
+            pFeedback[j] = SampleUtil::clampSample(
+                    pInput[i] * send_ramped +
+                    bufferedSampleLeft * feedback_ramped);
+            pFeedback[j + 1] = SampleUtil::clampSample(
+                    pInput[i + 1] * send_ramped +
+                    bufferedSampleRight * feedback_ramped);
+
+            // Pingpong the output.  If the pingpong value is zero, all of the
+            // math below should result in a simple copy of delay buf to pOutput.
+            if (pGroupState->ping_pong < delay_samples / 2) {
+                // Left sample plus a fraction of the right sample, normalized
+                // by 1 + fraction.
+                pOutput[i] =
+                        (bufferedSampleLeft + bufferedSampleRight * pingpong_frac) /
+                        (1 + pingpong_frac);
+                // Right sample reduced by (1 - fraction)
+                pOutput[i + 1] = bufferedSampleRight * (1 - pingpong_frac);
+            } else {
+                // Left sample reduced by (1 - fraction)
+                pOutput[i] = bufferedSampleLeft * (1 - pingpong_frac);
+                // Right sample plus fraction of left sample, normalized by
+                // 1 + fraction
+                pOutput[i + 1] =
+                        (bufferedSampleRight + bufferedSampleLeft * pingpong_frac) /
+                        (1 + pingpong_frac);
+            }
 
-        ++(pGroupState->ping_pong);
-        if (pGroupState->ping_pong >= delay_samples) {
-            pGroupState->ping_pong = 0;
+            ++(pGroupState->ping_pong);
+            if (pGroupState->ping_pong >= delay_samples) {
+                pGroupState->ping_pong = 0;
+            }
         }
+
+        pGroupState->delay_buf.write(
+                mixxx::spanutil::spanFromPtrLen<const CSAMPLE>(pFeedback, chunkSamples));
+        chunkStart += chunkSamples;
     }
 
     // The ramping of the send parameter handles ramping when enabling, so
@@ -5,6 +5,8 @@
 #include "effects/backends/effectprocessor.h"
 #include "engine/engine.h"
 #include "util/class.h"
+#include "util/defs.h"
+#include "util/ringdelaybuffer.h"
 #include "util/samplebuffer.h"
 
 class EchoGroupState : public EffectState {
@@ -14,16 +16,15 @@ class EchoGroupState : public EffectState {
     static constexpr int kMaxDelaySeconds = 3;
 
     EchoGroupState(const mixxx::EngineParameters& engineParameters)
-            : EffectState(engineParameters) {
-        audioParametersChanged(engineParameters);
+            : EffectState(engineParameters),
+              delay_buf(delayBufferSize(engineParameters), false),
+              feedback_buf(kMaxEngineSamples) {
         clear();
     }
     ~EchoGroupState() override = default;
 
     void audioParametersChanged(const mixxx::EngineParameters& engineParameters) {
-        delay_buf = mixxx::SampleBuffer(kMaxDelaySeconds *
-                engineParameters.sampleRate() *
-                engineParameters.channelCount());
+        delay_buf = RingDelayBuffer(delayBufferSize(engineParameters), false);
     };
 
     void clear() {
@@ -31,15 +32,21 @@ class EchoGroupState : public EffectState {
         prev_send = 0.0f;
         prev_feedback = 0.0f;
         prev_delay_samples = 0;
-        write_position = 0;
         ping_pong = 0;
     };
 
-    mixxx::SampleBuffer delay_buf;
+    static SINT delayBufferSize(const mixxx::EngineParameters& engineParameters) {
+        return kMaxDelaySeconds *
+                engineParameters.sampleRate() *
+                engineParameters.channelCount();
+    }
+
+    RingDelayBuffer delay_buf;
+    // The samples written to delay_buf while processing a chunk
+    mixxx::SampleBuffer feedback_buf;
     CSAMPLE_GAIN prev_send;
     CSAMPLE_GAIN prev_feedback;
     int prev_delay_samples;
-    int write_position;
     int ping_pong;
 };
 
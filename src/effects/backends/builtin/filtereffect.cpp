@@ -8,6 +8,9 @@
 namespace {
 constexpr double kMinCorner = 13;    // Hz
 constexpr double kMaxCorner = 22050; // Hz
+// Changes of the corner frequencies and Q while a knob is moving
+// are only applied to the filter coefficients if they exceed 1 %
+constexpr double kRelativeTolerance = 0.01;
 } // anonymous namespace
 
 // static
@@ -68,12 +71,14 @@ EffectManifestPointer FilterEffect::getManifest() {
 
 FilterGroupState::FilterGroupState(const mixxx::EngineParameters& engineParameters)
         : EffectState(engineParameters),
-          m_loFreq(kMaxCorner),
-          m_q(0.707106781),
-          m_hiFreq(kMinCorner) {
+          m_lpf(kMaxCorner, kRelativeTolerance),
+          m_q(0.707106781, kRelativeTolerance),
+          m_hpf(kMinCorner, kRelativeTolerance) {
     m_buffer = mixxx::SampleBuffer(engineParameters.samplesPerBuffer());
-    m_pLowFilter = new EngineFilterBiquad1Low(engineParameters.sampleRate(), m_loFreq, m_q, true);
-    m_pHighFilter = new EngineFilterBiquad1High(engineParameters.sampleRate(), m_hiFreq, m_q, true);
+    m_pLowFilter = new EngineFilterBiquad1Low(
+            engineParameters.sampleRate(), m_lpf.applied(), m_q.applied(), true);
+    m_pHighFilter = new EngineFilterBiquad1High(
+            engineParameters.sampleRate(), m_hpf.applied(), m_q.applied(), true);
 }
 
 FilterGroupState::~FilterGroupState() {
@@ -110,13 +115,17 @@ void FilterEffect::processChannel(
         lpf = m_pLPF->value();
     }
 
-    if ((pState->m_loFreq != lpf) ||
-            (pState->m_q != q) ||
-            (pState->m_hiFreq != hpf)) {
+    // Do not short-circuit, all parameters need to be updated
+    const bool lpfChanged = pState->m_lpf.update(lpf);
+    const bool qChanged = pState->m_q.update(q);
+    const bool hpfChanged = pState->m_hpf.update(hpf);
+    if (lpfChanged || qChanged || hpfChanged) {
+        const double appliedLpf = pState->m_lpf.applied();
+        const double appliedHpf = pState->m_hpf.applied();
         // limit Q to ~4 in case of overlap
         // Determined empirically at 1000 Hz
-        double ratio = hpf / lpf;
-        double clampedQ = q;
+        double ratio = appliedHpf / appliedLpf;
+        double clampedQ = pState->m_q.applied();
         if (ratio < 1.414 && ratio >= 1) {
             ratio -= 1;
             double qmax = 2 + ratio * ratio * ratio * 29;
@@ -128,13 +137,15 @@ void FilterEffect::processChannel(
             double qmax = 4 - 2 / 0.6 * ratio;
             clampedQ = math_min(clampedQ, qmax);
         }
-        pState->m_pLowFilter->setFrequencyCorners(engineParameters.sampleRate(), lpf, clampedQ);
-        pState->m_pHighFilter->setFrequencyCorners(engineParameters.sampleRate(), hpf, clampedQ);
+        pState->m_pLowFilter->setFrequencyCorners(
+                engineParameters.sampleRate(), appliedLpf, clampedQ);
+        pState->m_pHighFilter->setFrequencyCorners(
+                engineParameters.sampleRate(), appliedHpf, clampedQ);
     }
 
     const CSAMPLE* pLpfInput = pState->m_buffer.data();
     CSAMPLE* pHpfOutput = pState->m_buffer.data();
-    if (lpf >= kMaxCorner && pState->m_loFreq >= kMaxCorner) {
+    if (lpf >= kMaxCorner && pState->m_lpf.previousValue() >= kMaxCorner) {
         // Lpf disabled Hpf can write directly to output
         pHpfOutput = pOutput;
         pLpfInput = pHpfOutput;
@@ -143,7 +154,7 @@ void FilterEffect::processChannel(
     if (hpf > kMinCorner) {
         // hpf enabled, fade-in is handled in the filter when starting from pause
         pState->m_pHighFilter->process(pInput, pHpfOutput, engineParameters.samplesPerBuffer());
-    } else if (pState->m_hiFreq > kMinCorner) {
+    } else if (pState->m_hpf.previousValue() > kMinCorner) {
         // hpf disabling
         pState->m_pHighFilter->processAndPauseFilter(pInput,
                 pHpfOutput,
@@ -156,7 +167,7 @@ void FilterEffect::processChannel(
     if (lpf < kMaxCorner) {
         // lpf enabled, fade-in is handled in the filter when starting from pause
         pState->m_pLowFilter->process(pLpfInput, pOutput, engineParameters.samplesPerBuffer());
-    } else if (pState->m_loFreq < kMaxCorner) {
+    } else if (pState->m_lpf.previousValue() < kMaxCorner) {
         // hpf disabling
         pState->m_pLowFilter->processAndPauseFilter(pLpfInput,
                 pOutput,
@@ -169,7 +180,7 @@ void FilterEffect::processChannel(
         }
     }
 
-    pState->m_loFreq = lpf;
-    pState->m_q = q;
-    pState->m_hiFreq = hpf;
+    pState->m_lpf.commit();
+    pState->m_q.commit();
+    pState->m_hpf.commit();
 }
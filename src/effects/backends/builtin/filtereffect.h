@@ -3,6 +3,7 @@
 #include "effects/backends/effectprocessor.h"
 #include "util/class.h"
 #include "util/samplebuffer.h"
+#include "util/smoothedparameter.h"
 #include "util/types.h"
 
 class EngineFilterBiquad1Low;
@@ -18,9 +19,9 @@ struct FilterGroupState : public EffectState {
     EngineFilterBiquad1Low* m_pLowFilter;
     EngineFilterBiquad1High* m_pHighFilter;
 
-    double m_loFreq;
-    double m_q;
-    double m_hiFreq;
+    SmoothedParameter<double> m_lpf;
+    SmoothedParameter<double> m_q;
+    SmoothedParameter<double> m_hpf;
 };
 
 class FilterEffect : public EffectProcessorImpl<FilterGroupState> {
@@ -193,12 +193,12 @@ void FlangerEffect::processChannel(
 
         SINT framePrev =
                 (pState->delayPos - static_cast<SINT>(floor(delayFrames)) +
-                        kBufferLenth) %
-                kBufferLenth;
+                        kBufferLenth) &
+                kBufferMask;
         SINT frameNext =
                 (pState->delayPos - static_cast<SINT>(ceil(delayFrames)) +
-                        kBufferLenth) %
-                kBufferLenth;
+                        kBufferLenth) &
+                kBufferMask;
         CSAMPLE prevLeft = delayLeft[framePrev];
         CSAMPLE nextLeft = delayLeft[frameNext];
 
@@ -214,7 +214,7 @@ void FlangerEffect::processChannel(
         delayRight[pState->delayPos] =
                 tanh_approx(pInput[i + 1] + regen_ramped * delayedSampleRight);
 
-        pState->delayPos = (pState->delayPos + 1) % kBufferLenth;
+        pState->delayPos = (pState->delayPos + 1) & kBufferMask;
 
         CSAMPLE_GAIN gain = (1 - mix_ramped + kGainCorrection * mix_ramped);
         pOutput[i] = (pInput[i] + mix_ramped * delayedSampleLeft) / gain;
@@ -4,6 +4,7 @@
 
 #include "effects/backends/effectprocessor.h"
 #include "util/class.h"
+#include "util/math.h"
 #include "util/rampingvalue.h"
 #include "util/sample.h"
 #include "util/types.h"
@@ -14,7 +15,10 @@ constexpr double kMinDelayMs = 0.22;
 constexpr double kCenterDelayMs = (kMaxDelayMs - kMinDelayMs) / 2 + kMinDelayMs;
 constexpr double kMaxLfoWidthMs = kMaxDelayMs - kMinDelayMs;
 // using + 1.0 instead of ceil() for Mac OS
-constexpr SINT kBufferLenth = static_cast<SINT>(kMaxDelayMs + 1.0) * 96; // for 96 kHz
+// The length is a power of 2, so positions wrap around with a cheap mask.
+constexpr SINT kBufferLenth = roundUpToPowerOf2(
+        static_cast<unsigned int>(kMaxDelayMs + 1.0) * 96); // for 96 kHz
+constexpr SINT kBufferMask = kBufferLenth - 1;
 constexpr double kMinLfoBeats = 1 / 4.0;
 constexpr double kMaxLfoBeats = 32.0;
 } // anonymous namespace
@@ -7,6 +7,9 @@
 
 namespace {
 constexpr double kQ = 1.2247449;
+// Gain changes while a knob is moving are only applied to the filter
+// coefficients if they exceed this tolerance
+constexpr double kGainToleranceDb = 0.1;
 } // namespace
 
 // static
@@ -77,12 +80,13 @@ EffectManifestPointer GraphicEQEffect::getManifest() {
 
 GraphicEQEffectGroupState::GraphicEQEffectGroupState(
         const mixxx::EngineParameters& engineParameters)
-        : EffectState(engineParameters) {
-    m_oldLow = 0;
+        : EffectState(engineParameters),
+          m_lowGain(0.0, 0.0, kGainToleranceDb),
+          m_highGain(0.0, 0.0, kGainToleranceDb) {
+    // The filters are initialized without gain
     for (int i = 0; i < 6; i++) {
-        m_oldMid.append(1.0);
+        m_midGain.emplace_back(0.0, 0.0, kGainToleranceDb);
     }
-    m_oldHigh = 0;
 
     m_pBufs.append(SampleUtil::alloc(engineParameters.samplesPerBuffer()));
     m_pBufs.append(SampleUtil::alloc(engineParameters.samplesPerBuffer()));
@@ -127,10 +131,13 @@ GraphicEQEffectGroupState::~GraphicEQEffectGroupState() {
 }
 
 void GraphicEQEffectGroupState::setFilters(mixxx::audio::SampleRate sampleRate) {
-    m_low->setFrequencyCorners(sampleRate, m_centerFrequencies[0], kQ, m_oldLow);
-    m_high->setFrequencyCorners(sampleRate, m_centerFrequencies[7], kQ, m_oldHigh);
+    m_low->setFrequencyCorners(sampleRate, m_centerFrequencies[0], kQ, m_lowGain.applied());
+    m_high->setFrequencyCorners(sampleRate, m_centerFrequencies[7], kQ, m_highGain.applied());
     for (int i = 0; i < 6; i++) {
-        m_bands[i]->setFrequencyCorners(sampleRate, m_centerFrequencies[i + 1], kQ, m_oldMid[i]);
+        m_bands[i]->setFrequencyCorners(sampleRate,
+                m_centerFrequencies[i + 1],
+                kQ,
+                m_midGain[i].applied());
     }
 }
 
@@ -179,24 +186,24 @@ void GraphicEQEffect::processChannel(
         }
     }
 
-    if (fLow != pState->m_oldLow) {
+    if (pState->m_lowGain.update(fLow)) {
         pState->m_low->setFrequencyCorners(engineParameters.sampleRate(),
                 pState->m_centerFrequencies[0],
                 kQ,
-                fLow);
+                pState->m_lowGain.applied());
     }
-    if (fHigh != pState->m_oldHigh) {
+    if (pState->m_highGain.update(fHigh)) {
         pState->m_high->setFrequencyCorners(engineParameters.sampleRate(),
                 pState->m_centerFrequencies[7],
                 kQ,
-                fHigh);
+                pState->m_highGain.applied());
     }
     for (int i = 0; i < 6; i++) {
-        if (fMid[i] != pState->m_oldMid[i]) {
+        if (pState->m_midGain[i].update(fMid[i])) {
             pState->m_bands[i]->setFrequencyCorners(engineParameters.sampleRate(),
                     pState->m_centerFrequencies[i + 1],
                     kQ,
-                    fMid[i]);
+                    pState->m_midGain[i].applied());
         }
     }
 
@@ -231,10 +238,10 @@ void GraphicEQEffect::processChannel(
         pState->m_high->pauseFilter();
     }
 
-    pState->m_oldLow = fLow;
-    pState->m_oldHigh = fHigh;
+    pState->m_lowGain.commit();
+    pState->m_highGain.commit();
     for (int i = 0; i < 6; i++) {
-        pState->m_oldMid[i] = fMid[i];
+        pState->m_midGain[i].commit();
     }
 
     if (enableState == EffectEnableState::Disabling) {
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <QMap>
+#include <vector>
 
 #include "effects/backends/effectprocessor.h"
 #include "util/class.h"
+#include "util/smoothedparameter.h"
 #include "util/types.h"
 
 class EngineFilterBiquad1LowShelving;
@@ -21,9 +23,10 @@ class GraphicEQEffectGroupState : public EffectState {
     QList<EngineFilterBiquad1Peaking*> m_bands;
     EngineFilterBiquad1HighShelving* m_high;
     QList<CSAMPLE*> m_pBufs;
-    QList<double> m_oldMid;
-    double m_oldLow;
-    double m_oldHigh;
+    // Only appended in the constructor which is called on the main thread
+    std::vector<SmoothedParameter<double>> m_midGain;
+    SmoothedParameter<double> m_lowGain;
+    SmoothedParameter<double> m_highGain;
     float m_centerFrequencies[8];
 };
 
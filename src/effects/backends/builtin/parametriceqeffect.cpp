@@ -7,6 +7,10 @@ namespace {
 constexpr int kBandCount = 2;
 constexpr double kDefaultCenter1 = 1000; // 1 kHz
 constexpr double kDefaultCenter2 = 3000; // 3 kHz
+// Changes while a knob is moving are only applied to the filter
+// coefficients if they exceed these tolerances
+constexpr double kGainToleranceDb = 0.1;
+constexpr double kRelativeTolerance = 0.01;
 } // namespace
 
 // static
@@ -104,24 +108,27 @@ ParametricEQEffectGroupState::ParametricEQEffectGroupState(
         : EffectState(engineParameters),
           m_oldSampleRate(44100) {
     for (int i = 0; i < kBandCount; i++) {
-        m_oldGain.append(1.0);
-        m_oldQ.append(1.75);
+        // The filters are initialized without gain
+        m_gain.emplace_back(0.0, 0.0, kGainToleranceDb);
+        m_q.emplace_back(1.75, kRelativeTolerance);
     }
 
-    m_oldCenter.append(kDefaultCenter1);
-    m_oldCenter.append(kDefaultCenter2);
+    m_center.emplace_back(kDefaultCenter1, kRelativeTolerance);
+    m_center.emplace_back(kDefaultCenter2, kRelativeTolerance);
 
     // Initialize the filters with default parameters
     for (int i = 0; i < kBandCount; i++) {
         m_bands.push_back(std::make_unique<EngineFilterBiquad1Peaking>(
-                engineParameters.sampleRate(), m_oldCenter[i], m_oldQ[i]));
+                engineParameters.sampleRate(), m_center[i].applied(), m_q[i].applied()));
     }
 }
 
 void ParametricEQEffectGroupState::setFilters(mixxx::audio::SampleRate sampleRate) {
     for (int i = 0; i < kBandCount; i++) {
-        m_bands[i]->setFrequencyCorners(
-                sampleRate, m_oldCenter[i], m_oldQ[i], m_oldGain[i]);
+        m_bands[i]->setFrequencyCorners(sampleRate,
+                m_center[i].applied(),
+                m_q[i].applied(),
+                m_gain[i].applied());
     }
 }
 
@@ -164,11 +171,15 @@ void ParametricEQEffect::processChannel(
         }
         fQ[i] = static_cast<CSAMPLE_GAIN>(m_pPotQ[i]->value());
         fCenter[i] = static_cast<CSAMPLE_GAIN>(m_pPotCenter[i]->value());
-        if (fGain[i] != pState->m_oldGain[i] ||
-                fQ[i] != pState->m_oldQ[i] ||
-                fCenter[i] != pState->m_oldCenter[i]) {
-            pState->m_bands[i]->setFrequencyCorners(
-                    engineParameters.sampleRate(), fCenter[i], fQ[i], fGain[i]);
+        // Do not short-circuit, all parameters need to be updated
+        const bool gainChanged = pState->m_gain[i].update(fGain[i]);
+        const bool qChanged = pState->m_q[i].update(fQ[i]);
+        const bool centerChanged = pState->m_center[i].update(fCenter[i]);
+        if (gainChanged || qChanged || centerChanged) {
+            pState->m_bands[i]->setFrequencyCorners(engineParameters.sampleRate(),
+                    pState->m_center[i].applied(),
+                    pState->m_q[i].applied(),
+                    pState->m_gain[i].applied());
         }
     }
 
@@ -190,9 +201,9 @@ void ParametricEQEffect::processChannel(
     }
 
     for (int i = 0; i < kBandCount; i++) {
-        pState->m_oldGain[i] = fGain[i];
-        pState->m_oldQ[i] = fQ[i];
-        pState->m_oldCenter[i] = fCenter[i];
+        pState->m_gain[i].commit();
+        pState->m_q[i].commit();
+        pState->m_center[i].commit();
     }
 
     if (enableState == EffectEnableState::Disabling) {
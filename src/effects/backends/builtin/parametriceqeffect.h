@@ -8,6 +8,7 @@
 #include "effects/backends/effectprocessor.h"
 #include "engine/filters/enginefilterbiquad1.h"
 #include "util/class.h"
+#include "util/smoothedparameter.h"
 #include "util/types.h"
 
 // The ParametricEQEffect models the mid bands from a SSL Black EQ (242)
@@ -26,9 +27,9 @@ class ParametricEQEffectGroupState final : public EffectState {
     // These containers are only appended in the constructor which is called on
     // the main thread, so there is no risk of allocation in the audio thread.
     std::vector<std::unique_ptr<EngineFilterBiquad1Peaking>> m_bands;
-    QList<double> m_oldGain;
-    QList<double> m_oldCenter;
-    QList<double> m_oldQ;
+    std::vector<SmoothedParameter<double>> m_gain;
+    std::vector<SmoothedParameter<double>> m_center;
+    std::vector<SmoothedParameter<double>> m_q;
 
     mixxx::audio::SampleRate m_oldSampleRate;
 
@@ -71,14 +71,27 @@ class EffectProcessor {
     /// These methods are called from the main thread
     virtual void initialize(
             const QSet<ChannelHandleAndGroup>& activeInputChannels,
+            const QSet<ChannelHandleAndGroup>& registeredInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredOutputChannels,
             const mixxx::EngineParameters& engineParameters) = 0;
-    virtual void initializeInputChannel(
-            ChannelHandle inputChannel,
+    /// Allocates the EffectStates of one input channel for all output
+    /// channels, to be passed to loadStatesForInputChannel
+    virtual EffectStatesMap createStatesForInputChannel(
             const mixxx::EngineParameters& engineParameters) = 0;
     virtual void loadEngineEffectParameters(
             const QMap<QString, EngineEffectParameterPointer>& parameters) = 0;
-    virtual bool hasStatesForInputChannel(ChannelHandle inputChannel) const = 0;
+
+    /// These methods are called from the audio thread. They only swap
+    /// pointers, the EffectStates that are returned in pStates must be
+    /// deleted in the main thread.
+    /// Takes over the EffectStates in pStates and returns the replaced ones.
+    virtual void loadStatesForInputChannel(
+            ChannelHandle inputChannel,
+            EffectStatesMap* pStates) = 0;
+    /// Returns all EffectStates of the input channel in pStates.
+    virtual void deleteStatesForInputChannel(
+            ChannelHandle inputChannel,
+            EffectStatesMap* pStates) = 0;
 
     /// Called from the audio thread
     /// This method takes a buffer of audio samples as pInput, processes the buffer
@@ -155,40 +168,32 @@ class EffectProcessorImpl : public EffectProcessor {
             const mixxx::EngineParameters& engineParameters,
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) final {
-        EffectSpecificState* pState =
-                m_channelStateMatrix[inputHandle][outputHandle].get();
+        EffectSpecificState* pState = nullptr;
+        const auto& outputChannelStates = m_channelStateMatrix[inputHandle];
+        if (outputHandle.handle() < static_cast<int>(outputChannelStates.size())) {
+            pState = outputChannelStates[outputHandle].get();
+        }
         VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
             if (kEffectDebugOutput) {
                 qWarning() << "EffectProcessorImpl::process could not retrieve"
                               "EffectState for input"
                            << inputHandle
                            << "and output" << outputHandle
-                           << "EffectState should have been preallocated in the"
+                           << "EffectState should have been loaded from the"
                               "main thread.";
             }
             SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+            return;
         }
         processChannel(pState, pInput, pOutput, engineParameters, enableState, groupFeatures);
     }
 
     void initialize(const QSet<ChannelHandleAndGroup>& activeInputChannels,
+            const QSet<ChannelHandleAndGroup>& registeredInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredOutputChannels,
             const mixxx::EngineParameters& engineParameters) final {
         m_registeredOutputChannels = registeredOutputChannels;
 
-        for (const ChannelHandleAndGroup& inputChannel : activeInputChannels) {
-            initializeInputChannel(inputChannel.handle(), engineParameters);
-        }
-    };
-
-    void initializeInputChannel(ChannelHandle inputChannel,
-            const mixxx::EngineParameters& engineParameters) final {
-        if (kEffectDebugOutput) {
-            qDebug() << this << "EffectProcessorImpl::initialize allocating "
-                                "EffectStates for input"
-                     << inputChannel;
-        }
-
         int requiredVectorSize = 0;
         // For fast lookups we use a vector with index = handle;
         // gaps are filled with nullptr
@@ -199,38 +204,77 @@ class EffectProcessorImpl : public EffectProcessor {
                 requiredVectorSize = vectorIndex + 1;
             }
         }
-
         DEBUG_ASSERT(requiredVectorSize > 0);
-        auto& outputChannelStates = m_channelStateMatrix[inputChannel];
-        DEBUG_ASSERT(outputChannelStates.size() == 0);
-        outputChannelStates.reserve(requiredVectorSize);
-        outputChannelStates.clear();
-        for (int i = 0; i < requiredVectorSize; ++i) {
-            outputChannelStates.push_back(std::unique_ptr<EffectSpecificState>());
+
+        // Reserve the slots for all routes up front, so loading the
+        // EffectStates in the audio thread does not allocate memory. The
+        // EffectStates themselves are only allocated for the routes that
+        // are enabled.
+        for (const ChannelHandleAndGroup& inputChannel : registeredInputChannels) {
+            auto& outputChannelStates = m_channelStateMatrix[inputChannel.handle()];
+            DEBUG_ASSERT(outputChannelStates.size() == 0);
+            outputChannelStates.resize(requiredVectorSize);
+        }
+
+        for (const ChannelHandleAndGroup& inputChannel : activeInputChannels) {
+            EffectStatesMap states = createStatesForInputChannel(engineParameters);
+            loadStatesForInputChannel(inputChannel.handle(), &states);
+            // Only left over if the input channel is not registered
+            for (EffectState* pState : states) {
+                delete pState;
+            }
         }
+    };
+
+    EffectStatesMap createStatesForInputChannel(
+            const mixxx::EngineParameters& engineParameters) final {
+        EffectStatesMap states;
         for (const ChannelHandleAndGroup& outputChannel :
                 std::as_const(m_registeredOutputChannels)) {
-            outputChannelStates[outputChannel.handle()].reset(
-                    createSpecificState(engineParameters));
+            EffectState* pState = createSpecificState(engineParameters);
             if (kEffectDebugOutput) {
                 qDebug() << this
-                         << "EffectProcessorImpl::initialize "
-                            "registering output"
-                         << outputChannel << outputChannel.handle()
-                         << outputChannelStates[outputChannel.handle()].get();
+                         << "EffectProcessorImpl::createStatesForInputChannel "
+                            "for output"
+                         << outputChannel << outputChannel.handle() << pState;
             }
+            states.insert(outputChannel.handle(), pState);
         }
-    };
+        return states;
+    }
+
+    void loadStatesForInputChannel(ChannelHandle inputChannel,
+            EffectStatesMap* pStates) final {
+        auto& outputChannelStates = m_channelStateMatrix[inputChannel];
+        for (const ChannelHandleAndGroup& outputChannel :
+                std::as_const(m_registeredOutputChannels)) {
+            EffectState*& pState = (*pStates)[outputChannel.handle()];
+            if (!pState) {
+                continue;
+            }
+            VERIFY_OR_DEBUG_ASSERT(outputChannel.handle() <
+                    static_cast<int>(outputChannelStates.size())) {
+                // The input channel was not registered, the EffectState is
+                // left in pStates to be deleted in the main thread
+                continue;
+            }
+            // All EffectStates in pStates were created by createSpecificState()
+            auto* pSpecificState = static_cast<EffectSpecificState*>(pState);
+            pState = outputChannelStates[outputChannel.handle()].release();
+            outputChannelStates[outputChannel.handle()].reset(pSpecificState);
+        }
+    }
 
-    bool hasStatesForInputChannel(ChannelHandle inputChannel) const final {
-        if (inputChannel.handle() < m_channelStateMatrix.size()) {
-            for (const auto& pState : m_channelStateMatrix.at(inputChannel)) {
-                if (pState) {
-                    return true;
-                }
+    void deleteStatesForInputChannel(ChannelHandle inputChannel,
+            EffectStatesMap* pStates) final {
+        auto& outputChannelStates = m_channelStateMatrix[inputChannel];
+        for (const ChannelHandleAndGroup& outputChannel :
+                std::as_const(m_registeredOutputChannels)) {
+            if (outputChannel.handle() < static_cast<int>(outputChannelStates.size())) {
+                pStates->insert(outputChannel.handle(),
+                        outputChannelStates[outputChannel.handle()].release());
             }
         }
-        return false;
     }
 
   protected:
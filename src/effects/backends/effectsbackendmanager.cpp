@@ -1,5 +1,7 @@
 #include "effects/backends/effectsbackendmanager.h"
 
+#include <QDir>
+
 #include "control/controlobject.h"
 #include "effects/backends/builtin/builtinbackend.h"
 #include "effects/backends/effectmanifest.h"
@@ -12,7 +14,8 @@
 #endif
 #include "effects/presets/effectpreset.h"
 
-EffectsBackendManager::EffectsBackendManager() {
+EffectsBackendManager::EffectsBackendManager(
+        std::optional<QList<EffectsBackendPointer>> pluginBackends) {
     m_pNumEffectsAvailable = std::make_unique<ControlObject>(
             ConfigKey("[Master]", "num_effectsavailable"));
     m_pNumEffectsAvailable->setReadOnly();
@@ -21,9 +24,27 @@ EffectsBackendManager::EffectsBackendManager() {
 #ifdef __AU_EFFECTS__
     addBackend(createAudioUnitBackend());
 #endif
+    if (!pluginBackends) {
+        pluginBackends = createPluginBackends();
+    }
+    for (const auto& pBackend : std::as_const(*pluginBackends)) {
+        addBackend(pBackend);
+    }
+}
+
+// static
+QList<EffectsBackendPointer> EffectsBackendManager::createPluginBackends(
+        const QString& cacheDirPath) {
+    QList<EffectsBackendPointer> backends;
 #ifdef __LILV__
-    addBackend(EffectsBackendPointer(new LV2Backend()));
+    const QString lv2CacheFilePath = cacheDirPath.isEmpty()
+            ? QString()
+            : QDir(cacheDirPath).filePath(QStringLiteral("lv2plugins.cache"));
+    backends.append(EffectsBackendPointer(new LV2Backend(lv2CacheFilePath)));
+#else
+    Q_UNUSED(cacheDirPath);
 #endif
+    return backends;
 }
 
 void EffectsBackendManager::addBackend(EffectsBackendPointer pBackend) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include "effects/defs.h"
 
 class ControlObject;
@@ -9,9 +11,18 @@ class EffectProcessor;
 /// available EffectManifests, and creates EffectProcessors from EffectManifests.
 class EffectsBackendManager {
   public:
-    EffectsBackendManager();
+    /// The plugin backends are created unless they are passed in, e.g.
+    /// after they have been created in parallel to other startup steps.
+    explicit EffectsBackendManager(
+            std::optional<QList<EffectsBackendPointer>> pluginBackends = std::nullopt);
     ~EffectsBackendManager() = default;
 
+    /// Creates the backends that scan the system for plugins, which takes
+    /// long. Can be called from any thread. The backends cache the results
+    /// of the scan in cacheDirPath unless it is empty.
+    static QList<EffectsBackendPointer> createPluginBackends(
+            const QString& cacheDirPath = QString());
+
     const QList<EffectManifestPointer>& getManifests() const {
         return m_manifests;
     };
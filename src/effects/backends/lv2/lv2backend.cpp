@@ -1,15 +1,79 @@
 #include "effects/backends/lv2/lv2backend.h"
 
+#include <lv2/buf-size/buf-size.h>
+#include <lv2/options/options.h>
+#include <lv2/parameters/parameters.h>
 #include <lv2/units/units.h>
+#include <lv2/urid/urid.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
 
 #include "effects/backends/lv2/lv2effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("LV2Backend");
+
+const QByteArray kCacheMagic = QByteArrayLiteral("MXLV2");
+// Increment when the cached data changes
+constexpr int kCacheVersion = 2;
+
+/// The directories that lilv searches for bundles, see lilv_world_load_all()
+QStringList lv2Paths() {
+    QString lv2Path = qEnvironmentVariable("LV2_PATH");
+    if (lv2Path.isEmpty()) {
+#if defined(__WINDOWS__)
+        lv2Path = qEnvironmentVariable("APPDATA") + QStringLiteral("\\LV2;") +
+                qEnvironmentVariable("COMMONPROGRAMFILES") + QStringLiteral("\\LV2");
+#elif defined(__APPLE__)
+        lv2Path = QStringLiteral(
+                "~/.lv2:~/Library/Audio/Plug-Ins/LV2:/usr/local/lib/lv2:"
+                "/usr/lib/lv2:/Library/Audio/Plug-Ins/LV2");
+#else
+        lv2Path = QStringLiteral("~/.lv2:/usr/local/lib/lv2:/usr/lib/lv2");
+#endif
+    }
+#if defined(__WINDOWS__)
+    const QChar separator = QLatin1Char(';');
+#else
+    const QChar separator = QLatin1Char(':');
+#endif
+    QStringList paths = lv2Path.split(separator, Qt::SkipEmptyParts);
+    for (auto& path : paths) {
+        if (path.startsWith(QStringLiteral("~/"))) {
+            path = QDir::homePath() + path.mid(1);
+        }
+    }
+    return paths;
+}
+
+} // anonymous namespace
 
-LV2Backend::LV2Backend() {
+LV2Backend::LV2Backend(const QString& cacheFilePath)
+        : m_cacheFilePath(cacheFilePath),
+          m_worldLoaded(false) {
     m_pWorld = lilv_world_new();
     initializeProperties();
+    BundleTimestamps bundleTimestamps;
+    if (!m_cacheFilePath.isEmpty()) {
+        bundleTimestamps = scanBundleTimestamps();
+        if (loadCache(bundleTimestamps)) {
+            return;
+        }
+    }
     lilv_world_load_all(m_pWorld);
+    m_worldLoaded = true;
     enumeratePlugins();
+    if (!m_cacheFilePath.isEmpty()) {
+        storeCache(bundleTimestamps);
+    }
 }
 
 LV2Backend::~LV2Backend() {
@@ -33,6 +97,116 @@ void LV2Backend::enumeratePlugins() {
     }
 }
 
+// static
+LV2Backend::BundleTimestamps LV2Backend::scanBundleTimestamps() {
+    // The descriptions of the plugins are in the Turtle files of a bundle.
+    // Checking them instead of only the directory also detects files that
+    // have been modified in place.
+    const QStringList turtleFilter = {QStringLiteral("*.ttl")};
+    BundleTimestamps bundleTimestamps;
+    const QStringList paths = lv2Paths();
+    for (const auto& path : paths) {
+        const QFileInfoList bundles = QDir(path).entryInfoList(
+                QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const auto& bundle : bundles) {
+            qint64 lastModified = bundle.lastModified().toMSecsSinceEpoch();
+            const QFileInfoList files = QDir(bundle.filePath())
+                                                .entryInfoList(turtleFilter, QDir::Files);
+            for (const auto& file : files) {
+                lastModified = std::max(lastModified,
+                        file.lastModified().toMSecsSinceEpoch());
+            }
+            bundleTimestamps.insert(bundle.absoluteFilePath(), lastModified);
+        }
+    }
+    return bundleTimestamps;
+}
+
+bool LV2Backend::loadCache(const BundleTimestamps& bundleTimestamps) {
+    QFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    QByteArray magic;
+    int version;
+    BundleTimestamps cachedBundleTimestamps;
+    int manifestCount;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok ||
+            magic != kCacheMagic ||
+            version != kCacheVersion) {
+        return false;
+    }
+    stream >> cachedBundleTimestamps;
+    if (stream.status() != QDataStream::Ok ||
+            cachedBundleTimestamps != bundleTimestamps) {
+        kLogger.info() << "Plugins have changed, rescanning";
+        return false;
+    }
+    stream >> manifestCount;
+    QHash<QString, LV2EffectManifestPointer> registeredEffects;
+    for (int i = 0; i < manifestCount && stream.status() == QDataStream::Ok; ++i) {
+        auto lv2Manifest = LV2EffectManifestPointer::create(stream);
+        lv2Manifest->setBackendType(getType());
+        registeredEffects.insert(lv2Manifest->id(), lv2Manifest);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        kLogger.warning() << "Ignoring invalid cache" << m_cacheFilePath;
+        return false;
+    }
+    m_registeredEffects = std::move(registeredEffects);
+    return true;
+}
+
+void LV2Backend::storeCache(const BundleTimestamps& bundleTimestamps) const {
+    QSaveFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open"
+                << file.fileName()
+                << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream << kCacheMagic << kCacheVersion << bundleTimestamps
+           << static_cast<int>(m_registeredEffects.size());
+    for (const auto& lv2Manifest : m_registeredEffects) {
+        lv2Manifest->write(stream);
+    }
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write"
+                << file.fileName()
+                << file.errorString();
+    }
+}
+
+const LilvPlugin* LV2Backend::loadPlugin(const LV2EffectManifestPointer& pManifest) const {
+    LilvNode* pPluginUri = lilv_new_uri(m_pWorld, pManifest->id().toUtf8().constData());
+    const LilvPlugin* pPlugin = nullptr;
+    if (!m_worldLoaded) {
+        // Loading only the bundle of the plugin is much faster than
+        // loading all bundles
+        LilvNode* pBundleUri = lilv_new_uri(
+                m_pWorld, pManifest->bundleUri().toUtf8().constData());
+        lilv_world_load_bundle(m_pWorld, pBundleUri);
+        lilv_node_free(pBundleUri);
+        pPlugin = lilv_plugins_get_by_uri(lilv_world_get_all_plugins(m_pWorld), pPluginUri);
+        if (!pPlugin) {
+            // The description of the plugin may be spread over multiple
+            // bundles. Bundles that have already been loaded are skipped.
+            lilv_world_load_all(m_pWorld);
+            m_worldLoaded = true;
+        }
+    }
+    if (!pPlugin) {
+        pPlugin = lilv_plugins_get_by_uri(lilv_world_get_all_plugins(m_pWorld), pPluginUri);
+    }
+    lilv_node_free(pPluginUri);
+    return pPlugin;
+}
+
 void LV2Backend::initializeProperties() {
     m_properties["audio_port"] = lilv_new_uri(m_pWorld, LV2_CORE__AudioPort);
     m_properties["input_port"] = lilv_new_uri(m_pWorld, LV2_CORE__InputPort);
@@ -44,6 +218,16 @@ void LV2Backend::initializeProperties() {
     m_properties["unit"] = lilv_new_uri(m_pWorld, LV2_UNITS__unit);
     m_properties["unit_prefix"] = lilv_new_uri(m_pWorld, LV2_UNITS_PREFIX);
     m_properties["unit_symbol"] = lilv_new_uri(m_pWorld, LV2_UNITS__symbol);
+    m_properties["urid_map"] = lilv_new_uri(m_pWorld, LV2_URID__map);
+    m_properties["options"] = lilv_new_uri(m_pWorld, LV2_OPTIONS__options);
+    m_properties["required_option"] = lilv_new_uri(m_pWorld, LV2_OPTIONS__requiredOption);
+    m_properties["bounded_block_length"] =
+            lilv_new_uri(m_pWorld, LV2_BUF_SIZE__boundedBlockLength);
+    m_properties["power_of_2_block_length"] =
+            lilv_new_uri(m_pWorld, LV2_BUF_SIZE__powerOf2BlockLength);
+    m_properties["min_block_length"] = lilv_new_uri(m_pWorld, LV2_BUF_SIZE__minBlockLength);
+    m_properties["max_block_length"] = lilv_new_uri(m_pWorld, LV2_BUF_SIZE__maxBlockLength);
+    m_properties["sample_rate"] = lilv_new_uri(m_pWorld, LV2_PARAMETERS__sampleRate);
 }
 
 const QList<QString> LV2Backend::getEffectIds() const {
@@ -92,6 +276,14 @@ std::unique_ptr<EffectProcessor> LV2Backend::createProcessor(
     VERIFY_OR_DEBUG_ASSERT(pLV2Manifest) {
         return nullptr;
     }
+    if (!pLV2Manifest->getPlugin()) {
+        const LilvPlugin* pPlugin = loadPlugin(pLV2Manifest);
+        VERIFY_OR_DEBUG_ASSERT(pPlugin) {
+            kLogger.warning() << "Failed to load plugin" << pManifest->id();
+            return nullptr;
+        }
+        pLV2Manifest->setPlugin(pPlugin);
+    }
     return std::make_unique<LV2EffectProcessor>(pLV2Manifest);
 }
 
@@ -2,14 +2,24 @@
 
 #include <lilv/lilv.h>
 
+#include <QMap>
+
 #include "effects/backends/effectsbackend.h"
 #include "effects/backends/lv2/lv2manifest.h"
 #include "effects/defs.h"
 
 /// Refer to EffectsBackend for documentation
+///
+/// Loading the descriptions of all installed plugins with lilv takes
+/// seconds if there are many of them. The manifests are therefore cached
+/// in a file together with the modification times of the bundles. As long
+/// as no bundle has been installed, removed or modified, the manifests are
+/// restored from the cache and a plugin is only loaded when an effect is
+/// created from it.
 class LV2Backend : public EffectsBackend {
   public:
-    LV2Backend();
+    /// The cache is disabled if cacheFilePath is empty
+    explicit LV2Backend(const QString& cacheFilePath = QString());
     virtual ~LV2Backend();
 
     EffectBackendType getType() const {
@@ -26,9 +36,23 @@ class LV2Backend : public EffectsBackend {
     bool canInstantiateEffect(const QString& effectId) const;
 
   private:
+    /// Maps the path of each bundle to its last modification
+    using BundleTimestamps = QMap<QString, qint64>;
+
+    static BundleTimestamps scanBundleTimestamps();
+
     void enumeratePlugins();
     void initializeProperties();
+    bool loadCache(const BundleTimestamps& bundleTimestamps);
+    void storeCache(const BundleTimestamps& bundleTimestamps) const;
+    /// Loads the plugin of a manifest that has been restored from the cache
+    const LilvPlugin* loadPlugin(const LV2EffectManifestPointer& pManifest) const;
+
+    const QString m_cacheFilePath;
     LilvWorld* m_pWorld;
+    /// Set when all bundles have been loaded, not only the bundles of the
+    /// plugins that are in use
+    mutable bool m_worldLoaded;
     QHash<QString, LilvNode*> m_properties;
     QHash<QString, LV2EffectManifestPointer> m_registeredEffects;
 
@@ -1,24 +1,145 @@
 #include "effects/backends/lv2/lv2effectprocessor.h"
 
+#include <lv2/atom/atom.h>
+#include <lv2/buf-size/buf-size.h>
+#include <lv2/parameters/parameters.h>
+#include <lv2/urid/urid.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
 #include "engine/effects/engineeffectparameter.h"
 #include "util/defs.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// The engine may process any number of frames up to kMaxEngineFrames
+const int32_t kMinBlockLength = 1;
+const int32_t kMaxBlockLength = kMaxEngineFrames;
+
+/// The urid:map feature, which is required for passing options. Plugins
+/// may map URIs from any thread except the audio thread.
+class UridMap {
+  public:
+    UridMap()
+            : m_feature{LV2_URID__map, &m_map},
+              m_map{this, &UridMap::mapUri} {
+    }
+
+    static UridMap& instance() {
+        static UridMap uridMap;
+        return uridMap;
+    }
+
+    const LV2_Feature* feature() const {
+        return &m_feature;
+    }
+
+    LV2_URID map(const char* pUri) {
+        const QMutexLocker lock(&m_mutex);
+        LV2_URID& urid = m_urids[QByteArray(pUri)];
+        if (urid == 0) {
+            // 0 is reserved for unmapped URIs
+            urid = static_cast<LV2_URID>(m_urids.size());
+        }
+        return urid;
+    }
+
+  private:
+    static LV2_URID mapUri(LV2_URID_Map_Handle handle, const char* pUri) {
+        return static_cast<UridMap*>(handle)->map(pUri);
+    }
+
+    const LV2_Feature m_feature;
+    LV2_URID_Map m_map;
+    QMutex m_mutex;
+    QHash<QByteArray, LV2_URID> m_urids;
+};
+
+const LV2_Feature kBoundedBlockLengthFeature = {LV2_BUF_SIZE__boundedBlockLength, nullptr};
+const LV2_Feature kPowerOf2BlockLengthFeature = {LV2_BUF_SIZE__powerOf2BlockLength, nullptr};
+
+} // anonymous namespace
+
+LV2EffectGroupState::LV2EffectGroupState(const mixxx::EngineParameters& engineParameters)
+        : EffectState(engineParameters),
+          m_pInstance(nullptr),
+          m_sampleRate(0),
+          m_options{},
+          m_optionsFeature{LV2_OPTIONS__options, m_options.data()},
+          m_features{} {
+}
+
+LV2EffectGroupState::~LV2EffectGroupState() {
+    if (m_pInstance) {
+        lilv_instance_deactivate(m_pInstance);
+        lilv_instance_free(m_pInstance);
+    }
+}
+
+LilvInstance* LV2EffectGroupState::instantiate(const LilvPlugin* pPlugin,
+        const mixxx::EngineParameters& engineParameters,
+        bool powerOf2BlockLength) {
+    if (m_pInstance) {
+        return m_pInstance;
+    }
+
+    UridMap& uridMap = UridMap::instance();
+    const LV2_URID intType = uridMap.map(LV2_ATOM__Int);
+    m_sampleRate = static_cast<float>(engineParameters.sampleRate());
+    m_options[0] = {LV2_OPTIONS_INSTANCE,
+            0,
+            uridMap.map(LV2_BUF_SIZE__minBlockLength),
+            sizeof(kMinBlockLength),
+            intType,
+            &kMinBlockLength};
+    m_options[1] = {LV2_OPTIONS_INSTANCE,
+            0,
+            uridMap.map(LV2_BUF_SIZE__maxBlockLength),
+            sizeof(kMaxBlockLength),
+            intType,
+            &kMaxBlockLength};
+    m_options[2] = {LV2_OPTIONS_INSTANCE,
+            0,
+            uridMap.map(LV2_PARAMETERS__sampleRate),
+            sizeof(m_sampleRate),
+            uridMap.map(LV2_ATOM__Float),
+            &m_sampleRate};
+    // Terminated by a zeroed option
+    m_options[3] = {LV2_OPTIONS_INSTANCE, 0, 0, 0, 0, nullptr};
+
+    std::size_t numFeatures = 0;
+    m_features[numFeatures++] = uridMap.feature();
+    m_features[numFeatures++] = &m_optionsFeature;
+    m_features[numFeatures++] = &kBoundedBlockLengthFeature;
+    if (powerOf2BlockLength) {
+        m_features[numFeatures++] = &kPowerOf2BlockLengthFeature;
+    }
+    DEBUG_ASSERT(numFeatures < m_features.size());
+    m_features[numFeatures] = nullptr;
+
+    m_pInstance = lilv_plugin_instantiate(
+            pPlugin, engineParameters.sampleRate(), m_features.data());
+    return m_pInstance;
+}
 
 LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest)
         : m_pManifest(pManifest),
-          m_LV2parameters(nullptr),
+          m_inputL(kMaxEngineFrames),
+          m_inputR(kMaxEngineFrames),
+          m_outputL(kMaxEngineFrames),
+          m_outputR(kMaxEngineFrames),
           m_pPlugin(pManifest->getPlugin()),
           m_audioPortIndices(pManifest->getAudioPortIndices()),
-          m_controlPortIndices(pManifest->getControlPortIndices()) {
-    m_inputL = new float[kMaxEngineSamples];
-    m_inputR = new float[kMaxEngineSamples];
-    m_outputL = new float[kMaxEngineSamples];
-    m_outputR = new float[kMaxEngineSamples];
+          m_controlPortIndices(pManifest->getControlPortIndices()),
+          m_powerOf2BlockLength(pManifest->requiresPowerOf2BlockLength()) {
 }
 
 void LV2EffectProcessor::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
-    m_LV2parameters = new float[parameters.size()];
-
     // EngineEffect passes the EngineEffectParameters indexed by ID string, which
     // is used directly by built-in EffectProcessorImpl subclasseses to access
     // specific named parameters. However, LV2EffectProcessor::process iterates
@@ -27,18 +148,13 @@ void LV2EffectProcessor::loadEngineEffectParameters(
     // LV2EffectProcessor::process, rearrange the QMap of EngineEffectParameters by
     // ID string to an ordered QList.
     for (const auto& pManifestParameter : m_pManifest->parameters()) {
-        m_engineEffectParameters.append(parameters.value(pManifestParameter->id()));
+        const EngineEffectParameterPointer pParameter =
+                parameters.value(pManifestParameter->id());
+        m_engineEffectParameters.append(pParameter);
+        m_LV2parameters.push_back(static_cast<float>(pParameter->value()));
     }
 }
 
-LV2EffectProcessor::~LV2EffectProcessor() {
-    delete[] m_inputL;
-    delete[] m_inputR;
-    delete[] m_outputL;
-    delete[] m_outputR;
-    delete[] m_LV2parameters;
-}
-
 void LV2EffectProcessor::processChannel(
         LV2EffectGroupState* channelState,
         const CSAMPLE* pInput,
@@ -48,40 +164,71 @@ void LV2EffectProcessor::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
-    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-        m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
+    LilvInstance* pInstance = channelState->lilvInstance();
+    VERIFY_OR_DEBUG_ASSERT(pInstance) {
+        SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+        return;
     }
 
-    SINT framesPerBuffer = engineParameters.framesPerBuffer();
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < framesPerBuffer; ++i) {
-        m_inputL[i] = pInput[i * 2];
-        m_inputR[i] = pInput[i * 2 + 1];
+    // The plugins read the control ports in every run, so only the values
+    // of parameters that have changed need to be written
+    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+        const auto value = static_cast<float>(m_engineEffectParameters[i]->value());
+        if (m_LV2parameters[i] != value) {
+            m_LV2parameters[i] = value;
+        }
     }
 
-    LilvInstance* instance = channelState->lilvInstance(m_pPlugin, engineParameters);
+    const SINT framesPerBuffer = engineParameters.framesPerBuffer();
+    DEBUG_ASSERT(framesPerBuffer <= kMaxBlockLength);
+    SampleUtil::deinterleaveBuffer(m_inputL.data(), m_inputR.data(), pInput, framesPerBuffer);
 
     if (enableState == EffectEnableState::Enabling) {
-        lilv_instance_activate(instance);
+        lilv_instance_activate(pInstance);
     }
 
-    lilv_instance_run(instance, framesPerBuffer);
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < framesPerBuffer; ++i) {
-        pOutput[i * 2] = m_outputL[i];
-        pOutput[i * 2 + 1] = m_outputR[i];
+    SINT frameOffset = 0;
+    while (frameOffset < framesPerBuffer) {
+        SINT blockFrames = framesPerBuffer - frameOffset;
+        if (m_powerOf2BlockLength) {
+            // The largest power of two that fits into the rest of the
+            // buffer, e.g. a buffer of 1000 frames is run in blocks of 512,
+            // 256, 128, 64, 32 and 8 frames
+            const auto roundedUp = static_cast<SINT>(
+                    roundUpToPowerOf2(static_cast<unsigned int>(blockFrames)));
+            if (roundedUp > blockFrames) {
+                blockFrames = roundedUp / 2;
+            }
+            connectAudioPorts(pInstance, frameOffset);
+        }
+        lilv_instance_run(pInstance, static_cast<uint32_t>(blockFrames));
+        frameOffset += blockFrames;
+    }
+    if (m_powerOf2BlockLength) {
+        connectAudioPorts(pInstance, 0);
     }
 
+    SampleUtil::interleaveBuffer(pOutput, m_outputL.data(), m_outputR.data(), framesPerBuffer);
+
     if (enableState == EffectEnableState::Disabling) {
-        lilv_instance_deactivate(instance);
+        lilv_instance_deactivate(pInstance);
     }
 }
 
+void LV2EffectProcessor::connectAudioPorts(LilvInstance* pInstance, SINT frameOffset) {
+    // We assume the audio ports are in the following order:
+    // input_left, input_right, output_left, output_right
+    lilv_instance_connect_port(pInstance, m_audioPortIndices[0], m_inputL.data() + frameOffset);
+    lilv_instance_connect_port(pInstance, m_audioPortIndices[1], m_inputR.data() + frameOffset);
+    lilv_instance_connect_port(pInstance, m_audioPortIndices[2], m_outputL.data() + frameOffset);
+    lilv_instance_connect_port(pInstance, m_audioPortIndices[3], m_outputR.data() + frameOffset);
+}
+
 LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         const mixxx::EngineParameters& engineParameters) {
     LV2EffectGroupState* pState = new LV2EffectGroupState(engineParameters);
-    LilvInstance* pInstance = pState->lilvInstance(m_pPlugin, engineParameters);
+    LilvInstance* pInstance = pState->instantiate(
+            m_pPlugin, engineParameters, m_powerOf2BlockLength);
     VERIFY_OR_DEBUG_ASSERT(pInstance) {
         return pState;
     }
@@ -90,20 +237,11 @@ LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         qDebug() << this << "LV2EffectProcessor creating LV2EffectGroupState" << pState;
     }
 
-    if (pInstance) {
-        for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-            m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
-            lilv_instance_connect_port(pInstance,
-                    m_controlPortIndices[i],
-                    &m_LV2parameters[i]);
-        }
-
-        // We assume the audio ports are in the following order:
-        // input_left, input_right, output_left, output_right
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[0], m_inputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[1], m_inputR);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[2], m_outputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[3], m_outputR);
+    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+        lilv_instance_connect_port(pInstance,
+                m_controlPortIndices[i],
+                &m_LV2parameters[i]);
     }
+    connectAudioPorts(pInstance, 0);
     return pState;
 };
@@ -1,44 +1,53 @@
 #pragma once
 
 #include <lilv/lilv.h>
+#include <lv2/options/options.h>
+
+#include <array>
+#include <vector>
 
 #include "effects/backends/effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
 #include "effects/defs.h"
 #include "engine/engine.h"
+#include "util/samplebuffer.h"
 
 // Refer to EffectProcessor for documentation
 class LV2EffectGroupState final : public EffectState {
   public:
-    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters)
-            : EffectState(engineParameters),
-              m_pInstance(nullptr) {
-    }
+    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters);
+    ~LV2EffectGroupState() override;
 
-    ~LV2EffectGroupState() override {
-        if (m_pInstance) {
-            lilv_instance_deactivate(m_pInstance);
-            lilv_instance_free(m_pInstance);
-        }
-    }
+    /// Called from the main thread. Returns nullptr if the plugin could not
+    /// be instantiated.
+    LilvInstance* instantiate(const LilvPlugin* pPlugin,
+            const mixxx::EngineParameters& engineParameters,
+            bool powerOf2BlockLength);
 
-    LilvInstance* lilvInstance(const LilvPlugin* pPlugin,
-            const mixxx::EngineParameters& engineParameters) {
-        if (!m_pInstance) {
-            m_pInstance = lilv_plugin_instantiate(
-                    pPlugin, engineParameters.sampleRate(), nullptr);
-        }
+    LilvInstance* lilvInstance() const {
         return m_pInstance;
     }
 
   private:
     LilvInstance* m_pInstance;
+
+    // The host features passed to the instance, they must stay valid as
+    // long as the instance exists
+    float m_sampleRate;
+    std::array<LV2_Options_Option, 4> m_options;
+    LV2_Feature m_optionsFeature;
+    std::array<const LV2_Feature*, 5> m_features;
 };
 
+/// Hosts an LV2 plugin. The port buffers are preallocated for the longest
+/// buffer of the engine, and the plugin is told so with the
+/// buf-size:boundedBlockLength feature. Plugins that require
+/// buf-size:powerOf2BlockLength are run for each power of two part of the
+/// buffer.
 class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState> {
   public:
     LV2EffectProcessor(LV2EffectManifestPointer pManifest);
-    ~LV2EffectProcessor() override;
+    ~LV2EffectProcessor() override = default;
 
     void loadEngineEffectParameters(
             const QMap<QString, EngineEffectParameterPointer>& parameters) override;
@@ -55,14 +64,19 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
     LV2EffectGroupState* createSpecificState(
             const mixxx::EngineParameters& engineParameters) override;
 
+    void connectAudioPorts(LilvInstance* pInstance, SINT frameOffset);
+
     LV2EffectManifestPointer m_pManifest;
     QList<EngineEffectParameterPointer> m_engineEffectParameters;
-    float* m_inputL;
-    float* m_inputR;
-    float* m_outputL;
-    float* m_outputR;
-    float* m_LV2parameters;
+    // The port buffers are shared by all instances, which are run one after
+    // the other
+    mixxx::SampleBuffer m_inputL;
+    mixxx::SampleBuffer m_inputR;
+    mixxx::SampleBuffer m_outputL;
+    mixxx::SampleBuffer m_outputR;
+    std::vector<float> m_LV2parameters;
     const LilvPlugin* m_pPlugin;
     const QList<int> m_audioPortIndices;
     const QList<int> m_controlPortIndices;
+    const bool m_powerOf2BlockLength;
 };
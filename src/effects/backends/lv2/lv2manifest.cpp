@@ -1,10 +1,22 @@
 #include "effects/backends/lv2/lv2manifest.h"
 
+#include <QDataStream>
+#include <algorithm>
+#include <iterator>
+
 #include "effects/backends/effectmanifestparameter.h"
 #include "util/fpclassify.h"
 
 namespace {
 constexpr bool lv2ParamDebug = true;
+
+template<std::size_t N>
+bool containsNode(const LilvNode* const (&nodes)[N], const LilvNode* pNode) {
+    return std::any_of(std::begin(nodes), std::end(nodes), [pNode](const LilvNode* pOther) {
+        return lilv_node_equals(pOther, pNode);
+    });
+}
+
 } // namespace
 
 LV2Manifest::LV2Manifest(LilvWorld* world,
@@ -14,8 +26,10 @@ LV2Manifest::LV2Manifest(LilvWorld* world,
           m_minimum(lilv_plugin_get_num_ports(plug)),
           m_maximum(lilv_plugin_get_num_ports(plug)),
           m_default(lilv_plugin_get_num_ports(plug)),
+          m_powerOf2BlockLength(false),
           m_status(AVAILABLE) {
     m_pLV2plugin = plug;
+    m_bundleUri = lilv_node_as_uri(lilv_plugin_get_bundle_uri(m_pLV2plugin));
 
     // Get and set the ID
     const LilvNode* id = lilv_plugin_get_uri(m_pLV2plugin);
@@ -180,12 +194,90 @@ LV2Manifest::LV2Manifest(LilvWorld* world,
         m_status = IO_NOT_STEREO;
     }
 
-    // We don't support any features
+    // Only the features and options which LV2EffectProcessor provides are
+    // supported
+    const LilvNode* supportedFeatures[] = {
+            properties["urid_map"],
+            properties["options"],
+            properties["bounded_block_length"],
+            properties["power_of_2_block_length"],
+    };
     LilvNodes* features = lilv_plugin_get_required_features(m_pLV2plugin);
-    if (lilv_nodes_size(features) > 0) {
-        m_status = HAS_REQUIRED_FEATURES;
+    LILV_FOREACH(nodes, iterator, features) {
+        const LilvNode* feature = lilv_nodes_get(features, iterator);
+        if (!containsNode(supportedFeatures, feature)) {
+            m_status = HAS_REQUIRED_FEATURES;
+        }
+        if (lilv_node_equals(feature, properties["power_of_2_block_length"])) {
+            m_powerOf2BlockLength = true;
+        }
     }
     lilv_nodes_free(features);
+
+    const LilvNode* supportedOptions[] = {
+            properties["min_block_length"],
+            properties["max_block_length"],
+            properties["sample_rate"],
+    };
+    LilvNodes* options = lilv_plugin_get_value(m_pLV2plugin, properties["required_option"]);
+    LILV_FOREACH(nodes, iterator, options) {
+        if (!containsNode(supportedOptions, lilv_nodes_get(options, iterator))) {
+            m_status = HAS_REQUIRED_FEATURES;
+        }
+    }
+    lilv_nodes_free(options);
+}
+
+LV2Manifest::LV2Manifest(QDataStream& stream)
+        : EffectManifest(),
+          m_pLV2plugin(nullptr),
+          m_powerOf2BlockLength(false),
+          m_status(AVAILABLE) {
+    QString id;
+    QString name;
+    QString author;
+    int status;
+    int parameterCount;
+    stream >> id >> name >> author >> m_bundleUri >> status >> m_powerOf2BlockLength >>
+            audioPortIndices >> controlPortIndices >> parameterCount;
+    setId(id);
+    setName(name);
+    setAuthor(author);
+    m_status = static_cast<Status>(status);
+    for (int i = 0; i < parameterCount && stream.status() == QDataStream::Ok; ++i) {
+        QString parameterId;
+        QString parameterName;
+        int unitsHint;
+        int valueScaler;
+        double minimum;
+        double defaultValue;
+        double maximum;
+        QList<QPair<QString, double>> steps;
+        stream >> parameterId >> parameterName >> unitsHint >> valueScaler >>
+                minimum >> defaultValue >> maximum >> steps;
+        EffectManifestParameterPointer param = addParameter();
+        param->setId(parameterId);
+        param->setName(parameterName);
+        param->setUnitsHint(static_cast<EffectManifestParameter::UnitsHint>(unitsHint));
+        param->setValueScaler(static_cast<EffectManifestParameter::ValueScaler>(valueScaler));
+        for (const auto& step : std::as_const(steps)) {
+            param->appendStep(step);
+        }
+        param->setRange(minimum, defaultValue, maximum);
+    }
+}
+
+void LV2Manifest::write(QDataStream& stream) const {
+    stream << id() << name() << author() << m_bundleUri << static_cast<int>(m_status)
+           << m_powerOf2BlockLength << audioPortIndices << controlPortIndices
+           << static_cast<int>(parameters().size());
+    for (const auto& param : parameters()) {
+        stream << param->id() << param->name()
+               << static_cast<int>(param->unitsHint())
+               << static_cast<int>(param->valueScaler())
+               << param->getMinimum() << param->getDefault() << param->getMaximum()
+               << param->getSteps();
+    }
 }
 
 QList<int> LV2Manifest::getAudioPortIndices() {
@@ -7,6 +7,8 @@
 
 #include "effects/backends/effectmanifest.h"
 
+class QDataStream;
+
 /// Refer to EffectManifest for documentation
 class LV2Manifest : public EffectManifest {
   public:
@@ -17,17 +19,34 @@ class LV2Manifest : public EffectManifest {
     };
 
     LV2Manifest(LilvWorld* world, const LilvPlugin* plug, QHash<QString, LilvNode*>& properties);
+    /// Restores a manifest that has been written to the plugin cache. The
+    /// plugin is not loaded until setPlugin() is called.
+    explicit LV2Manifest(QDataStream& stream);
+
+    void write(QDataStream& stream) const;
 
     QList<int> getAudioPortIndices();
     QList<int> getControlPortIndices();
     const LilvPlugin* getPlugin();
+    void setPlugin(const LilvPlugin* pPlugin) {
+        m_pLV2plugin = pPlugin;
+    }
+    /// The URI of the bundle that contains the plugin
+    const QString& bundleUri() const {
+        return m_bundleUri;
+    }
     bool isValid();
     Status getStatus();
+    /// The plugin must be run with a power of two frames at a time
+    bool requiresPowerOf2BlockLength() const {
+        return m_powerOf2BlockLength;
+    }
 
   private:
     void buildEnumerationOptions(const LilvPort* port,
             EffectManifestParameterPointer param);
     const LilvPlugin* m_pLV2plugin;
+    QString m_bundleUri;
 
     // This list contains:
     // position 0 -> input_left port index
@@ -42,6 +61,7 @@ class LV2Manifest : public EffectManifest {
     std::vector<float> m_minimum;
     std::vector<float> m_maximum;
     std::vector<float> m_default;
+    bool m_powerOf2BlockLength;
     Status m_status;
 };
 
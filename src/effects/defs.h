@@ -31,6 +31,8 @@ enum class SignalProcessingStage {
     Postfader
 };
 
+constexpr int kNumSignalProcessingStages = 2;
+
 inline qhash_seed_t qHash(
         SignalProcessingStage stage,
         qhash_seed_t seed = 0) {
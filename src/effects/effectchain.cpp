@@ -160,7 +160,7 @@ void EffectChain::addToEngine() {
             m_group,
             m_pEffectsManager->registeredInputChannels(),
             m_pEffectsManager->registeredOutputChannels());
-    EffectsRequest* pRequest = new EffectsRequest();
+    EffectsRequest* pRequest = m_pMessenger->newRequest();
     pRequest->type = EffectsRequest::ADD_EFFECT_CHAIN;
     pRequest->AddEffectChain.signalProcessingStage = m_signalProcessingStage;
     pRequest->AddEffectChain.pChain = m_pEngineEffectChain;
@@ -178,7 +178,7 @@ void EffectChain::removeFromEngine() {
         return;
     }
 
-    EffectsRequest* pRequest = new EffectsRequest();
+    EffectsRequest* pRequest = m_pMessenger->newRequest();
     pRequest->type = EffectsRequest::REMOVE_EFFECT_CHAIN;
     pRequest->RemoveEffectChain.signalProcessingStage = m_signalProcessingStage;
     pRequest->RemoveEffectChain.pChain = m_pEngineEffectChain;
@@ -192,6 +192,9 @@ const QString& EffectChain::presetName() const {
 }
 
 void EffectChain::loadChainPreset(EffectChainPresetPointer pChainPreset) {
+    // Replace all effects of the chain at once, without passing through
+    // intermediate states
+    const EffectsMessenger::ScopedBatch batch(m_pMessenger.data());
     slotControlClear(1);
     VERIFY_OR_DEBUG_ASSERT(pChainPreset) {
         return;
@@ -237,7 +240,7 @@ void EffectChain::loadEmptyNamelessPreset() {
 }
 
 void EffectChain::sendParameterUpdate() {
-    EffectsRequest* pRequest = new EffectsRequest();
+    EffectsRequest* pRequest = m_pMessenger->newRequest();
     pRequest->type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
     pRequest->pTargetChain = m_pEngineEffectChain;
     pRequest->SetEffectChainParameters.enabled = m_pControlChainEnabled->toBool();
@@ -403,17 +406,20 @@ void EffectChain::enableForInputChannel(const ChannelHandleAndGroup& handleGroup
         return;
     }
 
-    EffectsRequest* request = new EffectsRequest();
+    EffectsRequest* request = m_pMessenger->newRequest();
     request->type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
     request->pTargetChain = m_pEngineEffectChain;
     request->EnableInputChannelForChain.channelHandle = handleGroup.handle();
 
-    // Initialize EffectStates for the input channel here in the main thread to
-    // avoid allocating memory in the realtime audio callback thread.
-
-    for (int i = 0; i < m_effectSlots.size(); ++i) {
-        m_effectSlots[i]->initalizeInputChannel(handleGroup.handle());
+    // Allocate EffectStates for the input channel here in the main thread to
+    // avoid allocating memory in the realtime audio callback thread. They are
+    // deleted by the EffectsMessenger when the engine returns them.
+    auto* pEffectStatesMapArray = new EffectStatesMapArray;
+    DEBUG_ASSERT(m_effectSlots.size() <= kNumEffectsPerUnit);
+    for (int i = 0; i < m_effectSlots.size() && i < kNumEffectsPerUnit; ++i) {
+        (*pEffectStatesMapArray)[i] = m_effectSlots[i]->createStatesForInputChannel();
     }
+    request->EnableInputChannelForChain.pEffectStatesMapArray = pEffectStatesMapArray;
 
     m_pMessenger->writeRequest(request);
 
@@ -425,7 +431,7 @@ void EffectChain::disableForInputChannel(const ChannelHandleAndGroup& handleGrou
         return;
     }
 
-    EffectsRequest* request = new EffectsRequest();
+    EffectsRequest* request = m_pMessenger->newRequest();
     request->type = EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
     request->pTargetChain = m_pEngineEffectChain;
     request->DisableInputChannelForChain.channelHandle = handleGroup.handle();
@@ -12,6 +12,7 @@
 #include "effects/effectparameter.h"
 #include "effects/effectsmanager.h"
 #include "effects/effectsmessenger.h"
+#include "effects/engineeffectpool.h"
 #include "effects/presets/effectpreset.h"
 #include "effects/presets/effectpresetmanager.h"
 #include "effects/visibleeffectslist.h"
@@ -148,14 +149,20 @@ void EffectSlot::addToEngine() {
         return;
     }
 
-    m_pEngineEffect = new EngineEffect(
-            m_pManifest,
-            m_pBackendManager,
-            m_pChain->getActiveChannels(),
-            m_pEffectsManager->registeredInputChannels(),
-            m_pEffectsManager->registeredOutputChannels());
+    // Effects of the favorite QuickEffect chain presets have been created
+    // in advance
+    m_pEngineEffect = m_pEffectsManager->getEngineEffectPool()->take(
+            m_pManifest, m_pChain->getActiveChannels());
+    if (!m_pEngineEffect) {
+        m_pEngineEffect = new EngineEffect(
+                m_pManifest,
+                m_pBackendManager,
+                m_pChain->getActiveChannels(),
+                m_pEffectsManager->registeredInputChannels(),
+                m_pEffectsManager->registeredOutputChannels());
+    }
 
-    EffectsRequest* request = new EffectsRequest();
+    EffectsRequest* request = m_pMessenger->newRequest();
     request->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
     request->AddEffectToChain.pEffect = m_pEngineEffect;
@@ -168,7 +175,7 @@ void EffectSlot::removeFromEngine() {
         return;
     }
 
-    EffectsRequest* request = new EffectsRequest();
+    EffectsRequest* request = m_pMessenger->newRequest();
     request->type = EffectsRequest::REMOVE_EFFECT_FROM_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
     request->RemoveEffectFromChain.pEffect = m_pEngineEffect;
@@ -183,7 +190,7 @@ void EffectSlot::updateEngineState() {
         return;
     }
 
-    EffectsRequest* pRequest = new EffectsRequest();
+    EffectsRequest* pRequest = m_pMessenger->newRequest();
     pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
     pRequest->pTargetEffect = m_pEngineEffect;
     pRequest->SetEffectParameters.enabled = m_pControlEnabled->toBool();
@@ -196,12 +203,12 @@ void EffectSlot::updateEngineState() {
     }
 }
 
-void EffectSlot::initalizeInputChannel(ChannelHandle inputChannel) {
+EffectStatesMap EffectSlot::createStatesForInputChannel() {
     if (!m_pEngineEffect) {
-        return;
+        return EffectStatesMap();
     }
-    m_pEngineEffect->initalizeInputChannel(inputChannel);
-};
+    return m_pEngineEffect->createStatesForInputChannel();
+}
 
 EffectManifestPointer EffectSlot::getManifest() const {
     return m_pManifest;
@@ -273,6 +280,8 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
             qDebug() << this << m_group << "unloading effect";
         }
     }
+    // Swap the effects and apply the parameters in the same callback
+    const EffectsMessenger::ScopedBatch batch(m_pMessenger.data());
     unloadEffect();
     DEBUG_ASSERT(!m_pManifest);
 
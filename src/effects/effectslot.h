@@ -117,7 +117,9 @@ class EffectSlot : public QObject {
         return m_group;
     }
 
-    void initalizeInputChannel(ChannelHandle inputChannel);
+    /// Returns the states of the loaded effect for an input channel, to be
+    /// handed over to the engine when the chain is enabled for it.
+    EffectStatesMap createStatesForInputChannel();
 
     EffectManifestPointer getManifest() const;
 
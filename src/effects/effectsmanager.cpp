@@ -9,21 +9,27 @@
 #include "effects/chains/standardeffectchain.h"
 #include "effects/effectslot.h"
 #include "effects/effectsmessenger.h"
+#include "effects/engineeffectpool.h"
 #include "effects/presets/effectchainpreset.h"
 #include "effects/presets/effectpresetmanager.h"
 #include "effects/presets/effectxmlelements.h"
 #include "effects/visibleeffectslist.h"
 #include "engine/effects/engineeffectsmanager.h"
+#include "engine/effects/frozeneffectscache.h"
 #include "util/assert.h"
 
 namespace {
 const unsigned int kEffectMessagePipeFifoSize = 2048;
 const QString kEffectsXmlFile = QStringLiteral("effects.xml");
+// Longer loops are not frozen. Each cache holds kMaxSlots times the input
+// and the output of a loop of this length.
+constexpr double kMaxFrozenLoopSeconds = 10.0;
 } // anonymous namespace
 
 EffectsManager::EffectsManager(
         UserSettingsPointer pConfig,
-        std::shared_ptr<ChannelHandleFactory> pChannelHandleFactory)
+        std::shared_ptr<ChannelHandleFactory> pChannelHandleFactory,
+        std::optional<QList<EffectsBackendPointer>> pluginBackends)
         : m_pConfig(pConfig),
           m_pChannelHandleFactory(pChannelHandleFactory),
           m_loEqFreq(ConfigKey(kMixerProfile, kLowEqFrequency), 0., 22040),
@@ -31,7 +37,8 @@ EffectsManager::EffectsManager(
           m_initializedFromEffectsXml(false) {
     qRegisterMetaType<EffectChainMixMode>("EffectChainMixMode");
 
-    m_pBackendManager = EffectsBackendManagerPointer(new EffectsBackendManager());
+    m_pBackendManager = EffectsBackendManagerPointer(
+            new EffectsBackendManager(std::move(pluginBackends)));
 
     auto [pRequestPipe, pResponsePipe] = TwoWayMessagePipe<EffectsRequest*,
             EffectsResponse>::makeTwoWayMessagePipe(kEffectMessagePipeFifoSize,
@@ -47,6 +54,8 @@ EffectsManager::EffectsManager(
     m_pChainPresetManager = EffectChainPresetManagerPointer(
             new EffectChainPresetManager(pConfig, m_pBackendManager));
 
+    m_pEngineEffectPool = std::make_unique<EngineEffectPool>(this);
+
     m_pVisibleEffectsList = VisibleEffectsListPointer(new VisibleEffectsList());
 }
 
@@ -64,6 +73,7 @@ EffectsManager::~EffectsManager() {
     m_standardEffectChains.clear();
     m_outputEffectChain.clear();
     m_effectChainSlotsByGroup.clear();
+    m_pEngineEffectPool.reset();
 
     m_pMessenger->processEffectsResponses();
 }
@@ -94,6 +104,8 @@ void EffectsManager::registerInputChannel(const ChannelHandleAndGroup& handle_gr
     for (EffectChainPointer pChainSlot : std::as_const(m_standardEffectChains)) {
         pChainSlot->registerInputChannel(handle_group);
     }
+    // The EffectStates of pooled effects are allocated per registered channel
+    m_pEngineEffectPool->invalidate();
 }
 
 void EffectsManager::registerOutputChannel(const ChannelHandleAndGroup& handle_group) {
@@ -101,6 +113,30 @@ void EffectsManager::registerOutputChannel(const ChannelHandleAndGroup& handle_g
         return;
     }
     m_registeredOutputChannels.insert(handle_group);
+    m_pEngineEffectPool->invalidate();
+}
+
+void EffectsManager::setEffectsFrozen(const ChannelHandle& inputHandle,
+        bool frozen,
+        mixxx::audio::SampleRate sampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(inputHandle.valid()) {
+        return;
+    }
+    FrozenEffectsCache* pCache = nullptr;
+    if (frozen) {
+        VERIFY_OR_DEBUG_ASSERT(sampleRate.isValid()) {
+            return;
+        }
+        pCache = new FrozenEffectsCache(
+                static_cast<SINT>(kMaxFrozenLoopSeconds * sampleRate.value()));
+    }
+    // The replaced cache is returned with the response and deleted
+    // in EffectsMessenger::collectGarbage()
+    EffectsRequest* pRequest = m_pMessenger->newRequest();
+    pRequest->type = EffectsRequest::SET_FROZEN_EFFECTS_CACHE;
+    pRequest->SetFrozenEffectsCache.channelHandle = inputHandle;
+    pRequest->SetFrozenEffectsCache.pCache = pCache;
+    m_pMessenger->writeRequest(pRequest);
 }
 
 void EffectsManager::addStandardEffectChains() {
@@ -170,6 +206,7 @@ void EffectsManager::addQuickEffectChain(const ChannelHandleAndGroup& deckHandle
 
     m_quickEffectChains.insert(deckHandleGroup.name(), pChainSlot);
     m_effectChainSlotsByGroup.insert(pChainSlot->group(), pChainSlot);
+    m_pEngineEffectPool->addQuickEffectChannel(deckHandleGroup);
 }
 
 void EffectsManager::loadDefaultEqsAndQuickEffects() {
@@ -4,6 +4,7 @@
 #include <QList>
 #include <QSet>
 
+#include "audio/types.h"
 #include "control/controlpotmeter.h"
 #include "effects/backends/effectsbackendmanager.h"
 #include "effects/presets/effectchainpresetmanager.h"
@@ -11,6 +12,7 @@
 #include "preferences/usersettings.h"
 #include "util/class.h"
 
+class EngineEffectPool;
 class EngineEffectsManager;
 
 /// EffectsManager initializes and shuts down the effects system. It creates and
@@ -20,8 +22,11 @@ class EngineEffectsManager;
 /// responsible for specific parts of the effects system.
 class EffectsManager {
   public:
+    /// The plugin backends are created by the EffectsBackendManager if
+    /// they are not passed in.
     EffectsManager(UserSettingsPointer pConfig,
-            std::shared_ptr<ChannelHandleFactory> pChannelHandleFactory);
+            std::shared_ptr<ChannelHandleFactory> pChannelHandleFactory,
+            std::optional<QList<EffectsBackendPointer>> pluginBackends = std::nullopt);
 
     virtual ~EffectsManager();
 
@@ -63,6 +68,10 @@ class EffectsManager {
         return m_pBackendManager;
     }
 
+    EngineEffectPool* getEngineEffectPool() const {
+        return m_pEngineEffectPool.get();
+    }
+
     const VisibleEffectsListPointer getVisibleEffectsList() const {
         return m_pVisibleEffectsList;
     }
@@ -77,6 +86,13 @@ class EffectsManager {
         return m_registeredOutputChannels;
     }
 
+    /// Replays the effects output of the input channel from a cache while it
+    /// is looping and the effects parameters do not change, instead of
+    /// processing the effects. See FrozenEffectsCache.
+    void setEffectsFrozen(const ChannelHandle& inputHandle,
+            bool frozen,
+            mixxx::audio::SampleRate sampleRate);
+
     bool isAdoptMetaknobSettingEnabled() const;
 
   private:
@@ -109,6 +125,7 @@ class EffectsManager {
     VisibleEffectsListPointer m_pVisibleEffectsList;
     EffectPresetManagerPointer m_pEffectPresetManager;
     EffectChainPresetManagerPointer m_pChainPresetManager;
+    std::unique_ptr<EngineEffectPool> m_pEngineEffectPool;
 
     // ControlObjects for Equalizers' frequencies
     // TODO: replace these with effect parameters that are hidden by default
@@ -1,20 +1,81 @@
 #include "effects/effectsmessenger.h"
 
+#include <QVarLengthArray>
+#include <utility>
+
+#include "effects/backends/effectprocessor.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/effects/frozeneffectscache.h"
 #include "util/make_const_iterator.h"
 
+namespace {
+
+// Loading a chain preset sends a few dozen requests
+constexpr int kRequestSlabSize = 128;
+
+} // anonymous namespace
+
 EffectsMessenger::EffectsMessenger(
         std::unique_ptr<EffectsRequestPipe> pRequestPipe)
         : m_bShuttingDown(false),
           m_pRequestPipe(std::move(pRequestPipe)),
-          m_nextRequestId(0) {
+          m_nextRequestId(0),
+          m_batchDepth(0) {
 }
 
 EffectsMessenger::~EffectsMessenger() {
-    for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); it++) {
-        delete it.value();
+    // Pending requests are owned by m_requestSlabs
+    DEBUG_ASSERT(m_batchDepth == 0);
+}
+
+EffectsRequest* EffectsMessenger::newRequest() {
+    if (m_freeRequests.empty()) {
+        auto pSlab = std::make_unique<EffectsRequest[]>(kRequestSlabSize);
+        m_freeRequests.reserve(m_requestSlabs.size() * kRequestSlabSize + kRequestSlabSize);
+        for (int i = kRequestSlabSize - 1; i >= 0; --i) {
+            m_freeRequests.push_back(&pSlab[i]);
+        }
+        m_requestSlabs.push_back(std::move(pSlab));
+    }
+    EffectsRequest* pRequest = m_freeRequests.back();
+    m_freeRequests.pop_back();
+    *pRequest = EffectsRequest();
+    return pRequest;
+}
+
+void EffectsMessenger::releaseRequest(EffectsRequest* pRequest) {
+    m_freeRequests.push_back(pRequest);
+}
+
+void EffectsMessenger::beginBatch() {
+    ++m_batchDepth;
+}
+
+void EffectsMessenger::endBatch() {
+    VERIFY_OR_DEBUG_ASSERT(m_batchDepth > 0) {
+        return;
+    }
+    if (--m_batchDepth > 0 || m_batch.empty()) {
+        return;
+    }
+
+    const int batchSize = static_cast<int>(m_batch.size());
+    if (batchSize > 1) {
+        // The EngineEffectsManager waits for the whole batch, so it must be
+        // written completely.
+        if (batchSize <= m_pRequestPipe->writeCapacity()) {
+            m_batch.front()->batchSize = batchSize;
+        } else {
+            qWarning() << debugString()
+                       << "WARNING: Request pipe is too full for a batch of"
+                       << batchSize << "requests, sending them individually";
+        }
     }
+    for (auto* pRequest : m_batch) {
+        sendRequest(pRequest);
+    }
+    m_batch.clear();
 }
 
 void EffectsMessenger::initiateShutdown() {
@@ -29,7 +90,7 @@ bool EffectsMessenger::writeRequest(EffectsRequest* request) {
     }
 
     VERIFY_OR_DEBUG_ASSERT(m_pRequestPipe) {
-        delete request;
+        releaseRequest(request);
         return false;
     }
 
@@ -38,12 +99,19 @@ bool EffectsMessenger::writeRequest(EffectsRequest* request) {
     processEffectsResponses();
 
     request->request_id = m_nextRequestId++;
-    // TODO(XXX) use preallocated requests to avoid delete calls from engine
-    if (m_pRequestPipe->writeMessage(request)) {
-        m_activeRequests[request->request_id] = request;
+    if (m_batchDepth > 0 && !m_bShuttingDown) {
+        m_batch.push_back(request);
         return true;
     }
-    delete request;
+    return sendRequest(request);
+}
+
+bool EffectsMessenger::sendRequest(EffectsRequest* pRequest) {
+    if (m_pRequestPipe->writeMessage(pRequest)) {
+        m_activeRequests[pRequest->request_id] = pRequest;
+        return true;
+    }
+    releaseRequest(pRequest);
     return false;
 }
 
@@ -52,6 +120,10 @@ void EffectsMessenger::processEffectsResponses() {
         return;
     }
 
+    // The input channels whose EffectStates are no longer needed, the requests
+    // for deleting them are written after all responses have been processed.
+    QVarLengthArray<std::pair<EngineEffectChain*, ChannelHandle>> disabledInputChannels;
+
     EffectsResponse response;
     while (m_pRequestPipe->readMessage(&response)) {
         auto it = m_activeRequests.constFind(response.request_id);
@@ -71,11 +143,27 @@ void EffectsMessenger::processEffectsResponses() {
             // EngineEffectsMessenger and functions it calls to handle requests.
 
             collectGarbage(pRequest);
-
-            delete pRequest;
+            if (pRequest->type == EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL &&
+                    !m_bShuttingDown) {
+                // The effects have faded out when the next callback starts
+                disabledInputChannels.append(std::make_pair(pRequest->pTargetChain,
+                        pRequest->DisableInputChannelForChain.channelHandle));
+            }
+
+            releaseRequest(pRequest);
             it = constErase(&m_activeRequests, it);
         }
     }
+
+    for (const auto& [pChain, channelHandle] : disabledInputChannels) {
+        EffectsRequest* pRequest = newRequest();
+        pRequest->type = EffectsRequest::DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL;
+        pRequest->pTargetChain = pChain;
+        pRequest->DeleteEffectStatesForInputChannel.channelHandle = channelHandle;
+        pRequest->DeleteEffectStatesForInputChannel.pEffectStatesMapArray =
+                new EffectStatesMapArray;
+        writeRequest(pRequest);
+    }
 }
 
 void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
@@ -89,5 +177,26 @@ void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
             qDebug() << debugString() << "delete" << pRequest->RemoveEffectChain.pChain;
         }
         delete pRequest->RemoveEffectChain.pChain;
+    } else if (pRequest->type == EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL) {
+        deleteEffectStates(pRequest->EnableInputChannelForChain.pEffectStatesMapArray);
+    } else if (pRequest->type == EffectsRequest::DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL) {
+        deleteEffectStates(pRequest->DeleteEffectStatesForInputChannel.pEffectStatesMapArray);
+    } else if (pRequest->type == EffectsRequest::SET_FROZEN_EFFECTS_CACHE) {
+        delete pRequest->SetFrozenEffectsCache.pCache;
+    }
+}
+
+void EffectsMessenger::deleteEffectStates(EffectStatesMapArray* pEffectStatesMapArray) {
+    if (!pEffectStatesMapArray) {
+        return;
+    }
+    for (const auto& effectStatesMap : std::as_const(*pEffectStatesMapArray)) {
+        for (EffectState* pState : effectStatesMap) {
+            if (kEffectDebugOutput && pState) {
+                qDebug() << debugString() << "delete" << pState;
+            }
+            delete pState;
+        }
     }
+    delete pEffectStatesMapArray;
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "engine/effects/message.h"
 
 /// EffectsMessenger sends EffectsRequests from the main thread and receives
@@ -16,15 +19,47 @@ class EffectsMessenger {
   public:
     EffectsMessenger(std::unique_ptr<EffectsRequestPipe> pRequestPipe);
     ~EffectsMessenger();
-    /// Write an EffectsRequest to the EngineEffectsManager. EffectsMessenger takes
-    /// ownership of request and deletes it once a response is received.
+
+    /// Returns a default initialized EffectsRequest for writeRequest(). The
+    /// requests are taken from preallocated slabs and returned to them once
+    /// a response is received, so sending requests does not allocate memory.
+    EffectsRequest* newRequest();
+
+    /// Write an EffectsRequest to the EngineEffectsManager. The request must
+    /// have been obtained from newRequest(). EffectsMessenger keeps ownership
+    /// of request and recycles it once a response is received.
     bool writeRequest(EffectsRequest* request);
 
+    /// Requests written between beginBatch() and endBatch() are held back
+    /// and sent together, so the EngineEffectsManager applies all of them in
+    /// the same callback. Batches may be nested, in which case the requests
+    /// are sent when the outermost batch ends.
+    void beginBatch();
+    void endBatch();
+
+    /// Sends the requests written during its lifetime as one batch.
+    class ScopedBatch {
+      public:
+        explicit ScopedBatch(EffectsMessenger* pMessenger)
+                : m_pMessenger(pMessenger) {
+            m_pMessenger->beginBatch();
+        }
+        ~ScopedBatch() {
+            m_pMessenger->endBatch();
+        }
+
+      private:
+        EffectsMessenger* m_pMessenger;
+    };
+
     void initiateShutdown();
     void processEffectsResponses();
 
   private:
+    bool sendRequest(EffectsRequest* pRequest);
+    void releaseRequest(EffectsRequest* pRequest);
     void collectGarbage(const EffectsRequest* pRequest);
+    void deleteEffectStates(EffectStatesMapArray* pEffectStatesMapArray);
 
     QString debugString() const {
         return "EffectsMessenger";
@@ -35,4 +70,10 @@ class EffectsMessenger {
     std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
     qint64 m_nextRequestId;
     QHash<qint64, EffectsRequest*> m_activeRequests;
+
+    std::vector<std::unique_ptr<EffectsRequest[]>> m_requestSlabs;
+    std::vector<EffectsRequest*> m_freeRequests;
+
+    int m_batchDepth;
+    std::vector<EffectsRequest*> m_batch;
 };
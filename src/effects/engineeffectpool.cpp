@@ -0,0 +1,148 @@
+#include "effects/engineeffectpool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "effects/effectsmanager.h"
+#include "effects/presets/effectchainpreset.h"
+#include "effects/presets/effectchainpresetmanager.h"
+#include "effects/presets/effectpreset.h"
+#include "engine/effects/engineeffect.h"
+#include "moc_engineeffectpool.cpp"
+
+namespace {
+
+// The number of QuickEffect chain presets at the top of the user's list
+// whose effects are kept ready for every deck
+constexpr int kNumPooledQuickEffectPresets = 4;
+
+bool isSameEffect(const EffectManifestPointer& pManifest1,
+        const EffectManifestPointer& pManifest2) {
+    return pManifest1->id() == pManifest2->id() &&
+            pManifest1->backendType() == pManifest2->backendType();
+}
+
+} // anonymous namespace
+
+EngineEffectPool::EngineEffectPool(EffectsManager* pEffectsManager)
+        : m_pEffectsManager(pEffectsManager) {
+    // Create one effect per pass of the event loop, so the GUI stays
+    // responsive
+    m_createTimer.setInterval(0);
+    connect(&m_createTimer,
+            &QTimer::timeout,
+            this,
+            &EngineEffectPool::slotCreateNextEffect);
+    connect(m_pEffectsManager->getChainPresetManager().data(),
+            &EffectChainPresetManager::quickEffectChainPresetListUpdated,
+            this,
+            &EngineEffectPool::slotQuickEffectPresetListUpdated);
+}
+
+EngineEffectPool::~EngineEffectPool() {
+    deleteEffects();
+}
+
+void EngineEffectPool::addQuickEffectChannel(const ChannelHandleAndGroup& handleGroup) {
+    m_quickEffectChannels.insert(handleGroup);
+    slotQuickEffectPresetListUpdated();
+}
+
+void EngineEffectPool::invalidate() {
+    deleteEffects();
+    if (!m_entries.empty()) {
+        m_createTimer.start();
+    }
+}
+
+EngineEffect* EngineEffectPool::take(const EffectManifestPointer& pManifest,
+        const QSet<ChannelHandleAndGroup>& activeInputChannels) {
+    for (auto& entry : m_entries) {
+        if (entry.pEffect &&
+                entry.activeInputChannels == activeInputChannels &&
+                isSameEffect(entry.pManifest, pManifest)) {
+            EngineEffect* pEffect = entry.pEffect;
+            entry.pEffect = nullptr;
+            // Have a replacement ready for the next time
+            m_createTimer.start();
+            return pEffect;
+        }
+    }
+    return nullptr;
+}
+
+void EngineEffectPool::slotQuickEffectPresetListUpdated() {
+    // Each effect is needed as often as it occurs in a single preset
+    QList<EffectManifestPointer> manifests;
+    const QList<EffectChainPresetPointer> presets =
+            m_pEffectsManager->getChainPresetManager()->getQuickEffectPresetsSorted();
+    for (const auto& pChainPreset :
+            presets.mid(0, kNumPooledQuickEffectPresets)) {
+        QList<EffectManifestPointer> presetManifests;
+        for (const auto& pEffectPreset : pChainPreset->effectPresets()) {
+            if (!pEffectPreset || pEffectPreset->isEmpty()) {
+                continue;
+            }
+            const EffectManifestPointer pManifest =
+                    m_pEffectsManager->getBackendManager()->getManifest(pEffectPreset);
+            if (pManifest) {
+                presetManifests.append(pManifest);
+            }
+        }
+        for (const auto& pManifest : std::as_const(presetManifests)) {
+            const auto isSame = [&pManifest](const EffectManifestPointer& pOther) {
+                return isSameEffect(pManifest, pOther);
+            };
+            if (std::count_if(manifests.cbegin(), manifests.cend(), isSame) <
+                    std::count_if(presetManifests.cbegin(), presetManifests.cend(), isSame)) {
+                manifests.append(pManifest);
+            }
+        }
+    }
+
+    // Keep the effects which are still needed
+    std::vector<Entry> entries;
+    for (const auto& channel : std::as_const(m_quickEffectChannels)) {
+        const QSet<ChannelHandleAndGroup> activeInputChannels = {channel};
+        for (const auto& pManifest : std::as_const(manifests)) {
+            Entry newEntry{pManifest, activeInputChannels, nullptr};
+            for (auto& entry : m_entries) {
+                if (entry.pEffect &&
+                        entry.activeInputChannels == activeInputChannels &&
+                        isSameEffect(entry.pManifest, pManifest)) {
+                    newEntry.pEffect = std::exchange(entry.pEffect, nullptr);
+                    break;
+                }
+            }
+            entries.push_back(std::move(newEntry));
+        }
+    }
+    deleteEffects();
+    m_entries = std::move(entries);
+
+    if (std::any_of(m_entries.cbegin(), m_entries.cend(), [](const Entry& entry) {
+            return !entry.pEffect;
+        })) {
+        m_createTimer.start();
+    }
+}
+
+void EngineEffectPool::slotCreateNextEffect() {
+    for (auto& entry : m_entries) {
+        if (!entry.pEffect) {
+            entry.pEffect = new EngineEffect(entry.pManifest,
+                    m_pEffectsManager->getBackendManager(),
+                    entry.activeInputChannels,
+                    m_pEffectsManager->registeredInputChannels(),
+                    m_pEffectsManager->registeredOutputChannels());
+            return;
+        }
+    }
+    m_createTimer.stop();
+}
+
+void EngineEffectPool::deleteEffects() {
+    for (auto& entry : m_entries) {
+        delete std::exchange(entry.pEffect, nullptr);
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <vector>
+
+#include "effects/defs.h"
+#include "engine/channelhandle.h"
+
+class EffectsManager;
+class EngineEffect;
+
+/// EngineEffectPool keeps EngineEffects for the first QuickEffect chain
+/// presets in the user's order ready for every deck. Creating an
+/// EngineEffect allocates the EffectStates of the effect, which may take a
+/// while for effects with long delay lines. With the pool, selecting one of
+/// these presets only swaps the effects in the engine.
+///
+/// The effects are created one at a time while the event loop is idle,
+/// and a replacement is created after one has been taken. They are never
+/// sent to the engine while they are in the pool, so they are deleted in
+/// the main thread. All methods are called from the main thread.
+class EngineEffectPool : public QObject {
+    Q_OBJECT
+  public:
+    explicit EngineEffectPool(EffectsManager* pEffectsManager);
+    ~EngineEffectPool() override;
+
+    /// Keeps effects ready for the QuickEffect chain of the channel
+    void addQuickEffectChannel(const ChannelHandleAndGroup& handleGroup);
+
+    /// Recreates all effects, e.g. when an input or output channel has been
+    /// registered
+    void invalidate();
+
+    /// Returns an EngineEffect which has been created for the manifest and
+    /// the active input channels, or nullptr if there is none. The caller
+    /// takes ownership.
+    EngineEffect* take(const EffectManifestPointer& pManifest,
+            const QSet<ChannelHandleAndGroup>& activeInputChannels);
+
+  private slots:
+    void slotQuickEffectPresetListUpdated();
+    void slotCreateNextEffect();
+
+  private:
+    struct Entry {
+        EffectManifestPointer pManifest;
+        QSet<ChannelHandleAndGroup> activeInputChannels;
+        // nullptr until the effect has been created
+        EngineEffect* pEffect;
+    };
+
+    void deleteEffects();
+
+    EffectsManager* m_pEffectsManager;
+    QSet<ChannelHandleAndGroup> m_quickEffectChannels;
+    std::vector<Entry> m_entries;
+    QTimer m_createTimer;
+};
@@ -7,6 +7,13 @@
 #include "encoder/encoderwavesettings.h"
 #include "recording/defs_recording.h"
 
+namespace {
+
+// How often the header is rewritten while recording
+constexpr int kHeaderUpdateIntervalSeconds = 10;
+
+} // namespace
+
 // The virtual file context must return the length of the virtual file in bytes.
 static sf_count_t  sf_f_get_filelen (void *user_data)
 {
@@ -67,7 +74,8 @@ static sf_count_t  sf_f_tell (void *user_data)
 
 EncoderWave::EncoderWave(EncoderCallback* pCallback)
         : m_pCallback(pCallback),
-          m_pSndfile(nullptr) {
+          m_pSndfile(nullptr),
+          m_framesSinceHeaderUpdate(0) {
     m_sfInfo.frames = 0;
     m_sfInfo.samplerate = 0;
     m_sfInfo.channels = 0;
@@ -139,6 +147,14 @@ void EncoderWave::flush() {
 
 void EncoderWave::encodeBuffer(const CSAMPLE *pBuffer, const int iBufferSize) {
     sf_write_float(m_pSndfile, pBuffer, iBufferSize);
+
+    // Keep the length in the header up to date, so that the file is still
+    // readable if the recording is interrupted, e.g. by a crash
+    m_framesSinceHeaderUpdate += iBufferSize / m_sfInfo.channels;
+    if (m_framesSinceHeaderUpdate >= kHeaderUpdateIntervalSeconds * m_sfInfo.samplerate) {
+        sf_command(m_pSndfile, SFC_UPDATE_HEADER_NOW, nullptr, 0);
+        m_framesSinceHeaderUpdate = 0;
+    }
 }
 
 /* Originally called from enginebroadcast.cpp to update metadata information
@@ -203,6 +219,7 @@ int EncoderWave::initEncoder(mixxx::audio::SampleRate sampleRate, QString* pUser
     m_sfInfo.frames = 0;
     m_sfInfo.sections = 0;
     m_sfInfo.seekable = 0;
+    m_framesSinceHeaderUpdate = 0;
 
     // Opens a soundfile from a virtual file I/O context which is provided by the caller.
     // This is usually used to interface libsndfile to a stream or buffer based system.
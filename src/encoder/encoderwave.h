@@ -38,4 +38,7 @@ class EncoderWave : public Encoder {
     SF_INFO m_sfInfo;
 
     SF_VIRTUAL_IO m_virtualIo;
+
+    // Frames written since the header has been updated for the last time
+    sf_count_t m_framesSinceHeaderUpdate;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <cstdint>
 
 #include "audio/signalinfo.h"
 
@@ -51,6 +52,13 @@ class EngineBufferScale : public QObject {
         return m_signal;
     }
 
+    // Selects the stereo channel pairs of a multi-channel signal that are
+    // audible, one bit per pair. Scalers may skip the inactive pairs and
+    // produce silence for them instead. By default all pairs are scaled.
+    virtual void setActiveChannelPairs(std::uint32_t activeChannelPairs) {
+        Q_UNUSED(activeChannelPairs);
+    }
+
     // Called from EngineBuffer when seeking, to ensure the buffers are flushed */
     virtual void clear() = 0;
     // Scale buffer
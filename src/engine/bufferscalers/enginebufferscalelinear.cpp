@@ -45,7 +45,10 @@ void EngineBufferScaleLinear::clear() {
     // Clear out buffer and saved sample data
     m_bufferIntSize = 0;
     m_dNextFrame = 0;
-    onSignalChanged();
+    // The buffers are only reallocated when the channel count changes
+    m_floorSampleOld.clear();
+    m_floorSample.clear();
+    m_ceilSample.clear();
 }
 
 // laurent de soras - punked from musicdsp.org (mad props)
@@ -251,16 +254,21 @@ double EngineBufferScaleLinear::do_scale(CSAMPLE* buf, SINT buf_size) {
         SINT currentFrameFloor = static_cast<SINT>(floor(m_dCurrentFrame));
 
         int sampleCount = getOutputSignal().frames2samples(currentFrameFloor);
-        if (currentFrameFloor < 0) {
+        const CSAMPLE* pFloorSample = m_floorSample.data();
+        const CSAMPLE* pCeilSample = m_ceilSample.data();
+        const bool inBuffer = currentFrameFloor >= 0 &&
+                sampleCount + 2 * chCount - 1 < m_bufferIntSize;
+        if (inBuffer) {
+            // Common case: Both frames are in the buffer of the previous
+            // run, so interpolate between them without copying.
+            pFloorSample = &m_bufferInt[sampleCount];
+            pCeilSample = pFloorSample + chCount;
+        } else if (currentFrameFloor < 0) {
             // we have advanced to a new buffer in the previous run,
             // but the floor still points to the old buffer
             // so take the cached sample, this happens on slow rates
             SampleUtil::copy(m_floorSample.data(), m_floorSampleOld.data(), chCount);
             SampleUtil::copy(m_ceilSample.data(), m_bufferInt, chCount);
-        } else if (sampleCount + 2 * chCount - 1 < m_bufferIntSize) {
-            // take floorSample form the buffer of the previous run
-            SampleUtil::copy(m_floorSample.data(), &m_bufferInt[sampleCount], chCount);
-            SampleUtil::copy(m_ceilSample.data(), &m_bufferInt[sampleCount + chCount], chCount);
         } else {
             // if we don't have the ceilSample in buffer, load some more
 
@@ -315,11 +323,17 @@ double EngineBufferScaleLinear::do_scale(CSAMPLE* buf, SINT buf_size) {
 
         // Perform linear interpolation
         for (int chIdx = 0; chIdx < chCount; chIdx++) {
-            buf[i + chIdx] = m_floorSample[chIdx] +
-                    frac * (m_ceilSample[chIdx] - m_floorSample[chIdx]);
+            buf[i + chIdx] = pFloorSample[chIdx] +
+                    frac * (pCeilSample[chIdx] - pFloorSample[chIdx]);
         }
 
-        m_floorSampleOld.swap(m_floorSample);
+        // The floor sample is only needed if the position is still before
+        // the start of the buffer after it has been reloaded, which only
+        // happens if the buffer has been reloaded in this or the previous
+        // run.
+        if (!inBuffer) {
+            m_floorSampleOld.swap(m_floorSample);
+        }
 
         // increment the index for the next loop
         m_dNextFrame = m_dCurrentFrame + rate_add;
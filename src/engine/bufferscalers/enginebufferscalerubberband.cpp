@@ -98,6 +98,7 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
     // memory allocations that may block the real-time thread.
     // When is this function actually invoked??
     m_rubberBand.clear();
+    m_bCleared = false;
     if (!getOutputSignal().isValid()) {
         return;
     }
@@ -148,6 +149,11 @@ void EngineBufferScaleRubberBand::clear() {
     VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
         return;
     }
+    if (m_bCleared) {
+        // Nothing has been processed since the last reset, so the padding
+        // doesn't need to be run through the stretcher again.
+        return;
+    }
     reset();
 }
 
@@ -296,6 +302,7 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         // unscaled input buffer!
         return 0.0;
     }
+    m_bCleared = false;
 
     double readFramesProcessed = 0;
     SINT remaining_frames = getOutputSignal().samples2frames(iOutputBufferSize);
@@ -420,4 +427,5 @@ void EngineBufferScaleRubberBand::reset() {
     // silence should be dropped from the result when the `retrieve()` in
     // `retrieveAndDeinterleave()` first starts producing audio.
     m_remainingPaddingInOutput = static_cast<SINT>(getStartDelay());
+    m_bCleared = true;
 }
@@ -38,6 +38,10 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
             CSAMPLE* pOutputBuffer,
             SINT iOutputBufferSize) override;
 
+    void setActiveChannelPairs(std::uint32_t activeChannelPairs) override {
+        m_rubberBand.setActiveChannelPairs(activeChannelPairs);
+    }
+
     // Flush buffer.
     void clear() override;
 
@@ -83,6 +87,9 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     /// retrieve samples in `retrieveAndDeinterleave()`. See the `reset()`
     /// function for an explanation.
     SINT m_remainingPaddingInOutput = 0;
+    /// True if the instance has been reset and padded and no audio has been
+    /// processed since, so clear() can return immediately.
+    bool m_bCleared = false;
 
     bool m_useEngineFiner;
 };
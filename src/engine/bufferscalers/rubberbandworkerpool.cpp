@@ -2,13 +2,57 @@
 
 #include <rubberband/RubberBandStretcher.h>
 
+#include <QDir>
+#include <QFile>
+#include <QSet>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
 #include "engine/engine.h"
 #include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+} // anonymous namespace
+
+// static
+int RubberBandWorkerPool::physicalCoreCount() {
+    const int logicalCores = QThread::idealThreadCount();
+#if defined(__LINUX__)
+    // Hardware threads of the same core share the list of their siblings
+    QSet<QByteArray> cores;
+    const QDir cpuDir(QStringLiteral("/sys/devices/system/cpu"));
+    const QStringList cpus = cpuDir.entryList(
+            QStringList{QStringLiteral("cpu[0-9]*")}, QDir::Dirs);
+    for (const auto& cpu : cpus) {
+        QFile siblings(cpuDir.filePath(cpu + QStringLiteral("/topology/thread_siblings_list")));
+        if (siblings.open(QIODevice::ReadOnly)) {
+            cores.insert(siblings.readAll().trimmed());
+        }
+    }
+    if (!cores.isEmpty()) {
+        return math_min(static_cast<int>(cores.size()), logicalCores);
+    }
+#elif defined(__APPLE__)
+    int physicalCores = 0;
+    size_t size = sizeof(physicalCores);
+    if (sysctlbyname("hw.physicalcpu", &physicalCores, &size, nullptr, 0) == 0 &&
+            physicalCores > 0) {
+        return math_min(physicalCores, logicalCores);
+    }
+#endif
+    return logicalCores;
+}
 
 RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
         : QThreadPool() {
     bool multiThreadedOnStereo = pConfig &&
-            pConfig->getValue(ConfigKey(QStringLiteral("[App]"),
+            pConfig->getValue(ConfigKey(kAppGroup,
                                       QStringLiteral("keylock_multithreading")),
                     false);
     m_channelPerWorker = multiThreadedOnStereo
@@ -16,21 +60,54 @@ RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
             : mixxx::audio::ChannelCount::stereo();
     DEBUG_ASSERT(mixxx::kMaxEngineChannelInputCount % m_channelPerWorker == 0);
 
-    int numCore = QThread::idealThreadCount();
-    int numRBTasks = qMin(numCore, mixxx::kMaxEngineChannelInputCount / m_channelPerWorker);
+    // Every thread that processes channels, i.e. the engine thread and the
+    // threads used for processing channels in parallel, may stretch one deck
+    // at a time and takes care of one task of it, so it doesn't have to be
+    // idle while waiting for the workers.
+    int numChannelThreads = 1;
+    if (pConfig) {
+        numChannelThreads += math_max(0,
+                pConfig->getValue(ConfigKey(kAppGroup,
+                                          QStringLiteral("engine_channel_threads")),
+                        0));
+    }
+    const int maxUsefulThreads = numChannelThreads *
+            (mixxx::kMaxEngineChannelInputCount / m_channelPerWorker - 1);
 
-    qDebug() << "RubberBand will use" << numRBTasks << "tasks to scale the audio signal";
+    // A negative value selects the number of threads automatically
+    int numThreads = pConfig
+            ? pConfig->getValue(ConfigKey(kAppGroup,
+                                        QStringLiteral("keylock_worker_threads")),
+                      -1)
+            : -1;
+    if (numThreads < 0) {
+        numThreads = physicalCoreCount() - numChannelThreads;
+    }
+    numThreads = math_clamp(numThreads, 0, maxUsefulThreads);
 
-    setThreadPriority(QThread::HighPriority);
-    // The RB pool will only be used to scale n-1 buffer sample, so the engine
-    // thread takes care of the last buffer and doesn't have to be idle.
-    setMaxThreadCount(numRBTasks - 1);
+    qDebug() << "RubberBand will use" << numThreads
+             << "additional threads to scale the audio signal";
 
-    // We allocate one runner less than the total of maximum supported channel,
-    // so the engine thread will also perform a stretching operation, instead of
-    // waiting all workers to complete. During performance testing, this ahas
-    // show better results
-    for (int w = 0; w < maxThreadCount(); w++) {
-        reserveThread();
+    setThreadPriority(QThread::TimeCriticalPriority);
+    setMaxThreadCount(numThreads);
+    // Once spawned, the worker threads are kept alive for the lifetime of the
+    // pool to avoid thread creation in the audio callback. Reserving the
+    // threads instead would limit the pool to a single active thread.
+    setExpiryTimeout(-1);
+}
+
+mixxx::audio::ChannelCount RubberBandWorkerPool::channelPerTask(
+        mixxx::audio::ChannelCount chCount) const {
+    VERIFY_OR_DEBUG_ASSERT(chCount % m_channelPerWorker == 0) {
+        return chCount;
+    }
+    const int numUnits = chCount / m_channelPerWorker;
+    // The task count includes all the thread in the pool + the engine thread
+    const int maxTasks = maxThreadCount() + 1;
+    // Distribute the units evenly, so all tasks take the same time
+    int unitsPerTask = (numUnits + maxTasks - 1) / maxTasks;
+    while (numUnits % unitsPerTask != 0) {
+        ++unitsPerTask;
     }
+    return mixxx::audio::ChannelCount(unitsPerTask * m_channelPerWorker);
 }
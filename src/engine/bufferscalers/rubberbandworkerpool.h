@@ -9,17 +9,30 @@
 // RubberBandWorkerPool is a global pool manager for RubberBandWorkerPool. It
 // allows a the Engine thread to use a pool of agnostic RubberBandWorker which
 // can be distributed stretching job
+//
+// The pool is shared by all decks. When channels are processed in parallel
+// (see [App],engine_channel_threads), several decks submit their stretching
+// jobs at the same time, and jobs which find no idle worker are processed by
+// the submitting thread.
 class RubberBandWorkerPool : public QThreadPool, public Singleton<RubberBandWorkerPool> {
   public:
     const mixxx::audio::ChannelCount& channelPerWorker() const {
         return m_channelPerWorker;
     }
 
+    /// Computes how many channels each task of a stretcher with chCount
+    /// channels should process. Stereo pairs are only split if the user has
+    /// requested to process stereo channels as mono channels.
+    mixxx::audio::ChannelCount channelPerTask(mixxx::audio::ChannelCount chCount) const;
+
+    /// The number of CPU cores, not counting additional hardware threads of
+    /// the same core, which do not speed up the stretching noticeably.
+    static int physicalCoreCount();
+
   protected:
     RubberBandWorkerPool(UserSettingsPointer pConfig = nullptr);
 
   private:
-    ;
     mixxx::audio::ChannelCount m_channelPerWorker;
 
     friend class Singleton<RubberBandWorkerPool>;
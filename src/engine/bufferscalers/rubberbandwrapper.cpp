@@ -1,5 +1,8 @@
 #include "engine/bufferscalers/rubberbandwrapper.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "engine/bufferscalers/rubberbandworkerpool.h"
 #include "engine/engine.h"
 #include "util/assert.h"
@@ -11,10 +14,49 @@ using RubberBand::RubberBandStretcher;
 
 namespace {
 
+// The input history needs to cover the start pad and the output that has not
+// been retrieved yet when a channel pair is restarted.
+constexpr SINT kHistoryFrames = 16384;
+constexpr SINT kScratchFrames = 4096;
+constexpr SINT kFadeInFrames = 1024;
+// The additional input frames a restarted instance is fed per call of
+// process(), until it has caught up with the input of the others. This
+// bounds the extra work in the real-time thread.
+constexpr SINT kPrimingCatchUpFrames = 1024;
+
+// See
+// https://github.com/breakfastquay/rubberband/commit/72654b04ea4f0707e214377515119e933efbdd6c
+// for how these two functions were implemented within librubberband itself
+size_t preferredStartPadOf(const RubberBandStretcher& stretcher) {
+#if RUBBERBANDV3
+    return stretcher.getPreferredStartPad();
+#else
+    // `getPreferredStartPad()` returns `window_size / 2`, while with
+    // `getLatency()` both time stretching engines return `window_size / 2 /
+    // pitch_scale`
+    return static_cast<size_t>(std::ceil(
+            stretcher.getLatency() * stretcher.getPitchScale()));
+#endif
+}
+
+size_t startDelayOf(const RubberBandStretcher& stretcher) {
+#if RUBBERBANDV3
+    return stretcher.getStartDelay();
+#else
+    // In newer Rubber Band versions `getLatency()` is a deprecated alias for
+    // `getStartDelay()`, so they should behave the same. In the commit linked
+    // above the behavior was different for the R3 stretcher, but that was only
+    // during the initial betas of Rubberband 3.0 so we shouldn't have to worry
+    // about that.
+    return stretcher.getLatency();
+#endif
+}
+
 /// The function is used to compute the best number of channel per RB task,
 /// depending of the number of channels and available worker. This allows
 /// hardware if will less than 8 core to adjust the task distribution in the
-/// most optimum way.
+/// most optimum way. Stereo pairs are kept together in one task, unless the
+/// user has explicitly requested stereo channels to be processed as mono.
 ///
 /// The following table provide the expected number of channel per task with
 /// stereo processing for a given number of CPU core (the default behaviour)
@@ -23,7 +65,7 @@ namespace {
 ///  |----------|--------|------|
 ///  | 1        | 2      | 8    |
 ///  | 2        | 2      | 4    |
-///  | 3        | 2      | 2    |
+///  | 3        | 2      | 4    |
 ///  | 4        | 2      | 2    |
 ///
 /// The following table provide the expected number of channel per task when the
@@ -34,7 +76,7 @@ namespace {
 ///  |----------|--------|------|
 ///  | 1        | 2      | 8    |
 ///  | 2        | 1      | 4    |
-///  | 3        | 1      | 2    |
+///  | 3        | 1      | 4    |
 ///  | 4        | 1      | 2    |
 ///  | 5        | 1      | 2    |
 ///  | 6        | 1      | 2    |
@@ -50,20 +92,7 @@ mixxx::audio::ChannelCount getChannelPerWorker(mixxx::audio::ChannelCount chCoun
     VERIFY_OR_DEBUG_ASSERT(pPool) {
         return mixxx::kMaxEngineChannelInputCount;
     }
-    auto channelPerWorker = pPool->channelPerWorker();
-    // The task count includes all the thread in the pool + the engine thread
-    auto maxThreadCount = pPool->maxThreadCount() + 1;
-    VERIFY_OR_DEBUG_ASSERT(chCount % channelPerWorker == 0) {
-        return mixxx::kEngineChannelOutputCount;
-    }
-    auto numTasks = chCount / channelPerWorker;
-    if (numTasks > maxThreadCount) {
-        VERIFY_OR_DEBUG_ASSERT(numTasks % maxThreadCount == 0) {
-            return mixxx::kEngineChannelOutputCount;
-        }
-        return mixxx::audio::ChannelCount(chCount / maxThreadCount);
-    }
-    return channelPerWorker;
+    return pPool->channelPerTask(chCount);
 }
 } // namespace
 
@@ -78,26 +107,35 @@ int RubberBandWrapper::getEngineVersion() const {
 #endif
 }
 void RubberBandWrapper::setTimeRatio(double ratio) {
+    m_timeRatio = ratio;
     for (auto& stretcher : m_pInstances) {
         stretcher->setTimeRatio(ratio);
     }
 }
 size_t RubberBandWrapper::getSamplesRequired() const {
     size_t require = 0;
-    for (const auto& stretcher : m_pInstances) {
-        require = qMax(require, stretcher->getSamplesRequired());
+    for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+        if (isInstanceProducing(i)) {
+            require = qMax(require, m_pInstances[i]->getSamplesRequired());
+        }
     }
     return require;
 }
 int RubberBandWrapper::available() const {
     int available = std::numeric_limits<int>::max();
-    for (const auto& stretcher : m_pInstances) {
-        available = qMin(available, stretcher->available());
+    for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+        const InstanceState& state = m_instanceStates[i];
+        if (isInstanceProducing(i)) {
+            // The output of a restarted instance that is still going to be
+            // dropped is not available
+            available = qMin(available,
+                    std::max(0, m_pInstances[i]->available() - state.discardFrames));
+        }
     }
     return available == std::numeric_limits<int>::max() ? 0 : available;
 }
 size_t RubberBandWrapper::retrieve(
-        float* const* output, size_t samples, SINT channelBufferSize) const {
+        float* const* output, size_t samples, SINT channelBufferSize) {
     // ensure we don't fetch more samples than we really have available.
     samples = std::min(static_cast<size_t>(available()), samples);
     VERIFY_OR_DEBUG_ASSERT(samples <= static_cast<size_t>(channelBufferSize)) {
@@ -106,9 +144,24 @@ size_t RubberBandWrapper::retrieve(
     if (m_pInstances.size() == 1) {
         return m_pInstances[0]->retrieve(output, samples);
     } else {
-        for (const auto& stretcher : m_pInstances) {
+        for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+            InstanceState& state = m_instanceStates[i];
+            if (!isInstanceProducing(i)) {
+                for (int ch = 0; ch < m_channelPerWorker; ch++) {
+                    SampleUtil::clear(output[ch], samples);
+                }
+                if (state.priming) {
+                    // Drop the output that corresponds to the output of
+                    // the others meanwhile
+                    state.discardFrames += static_cast<SINT>(samples);
+                    discardOutput(i);
+                }
+                output += m_channelPerWorker;
+                continue;
+            }
+            discardOutput(i);
             size_t numSamplesRetrieved =
-                    stretcher->retrieve(output, samples);
+                    m_pInstances[i]->retrieve(output, samples);
             // there is something very wrong if we got a different of amount
             // of samples than we requested
             // We clear the buffer to limit the damage, but the signal
@@ -121,8 +174,26 @@ size_t RubberBandWrapper::retrieve(
                     }
                 }
             }
+            if (state.deactivating) {
+                for (int ch = 0; ch < m_channelPerWorker; ch++) {
+                    SampleUtil::clear(output[ch], samples);
+                }
+            } else if (state.fadeInFrames > 0) {
+                // Fade in a restarted instance, which may not be perfectly
+                // aligned with the others
+                const SINT fadeFrames = std::min(state.fadeInFrames, static_cast<SINT>(samples));
+                const SINT fadedFrames = kFadeInFrames - state.fadeInFrames;
+                for (int ch = 0; ch < m_channelPerWorker; ch++) {
+                    for (SINT frame = 0; frame < fadeFrames; ++frame) {
+                        output[ch][frame] *= static_cast<CSAMPLE_GAIN>(fadedFrames + frame + 1) /
+                                kFadeInFrames;
+                    }
+                }
+                state.fadeInFrames -= fadeFrames;
+            }
             output += m_channelPerWorker;
         }
+        m_retrievedOutputFrames += samples;
         return samples;
     }
 }
@@ -144,67 +215,100 @@ double RubberBandWrapper::getPitchScale() const {
     }
     return m_pInstances[0]->getPitchScale();
 }
-// See
-// https://github.com/breakfastquay/rubberband/commit/72654b04ea4f0707e214377515119e933efbdd6c
-// for how these two functions were implemented within librubberband itself
 size_t RubberBandWrapper::getPreferredStartPad() const {
     VERIFY_OR_DEBUG_ASSERT(isValid()) {
         return {};
     }
-#if RUBBERBANDV3
-    return m_pInstances[0]->getPreferredStartPad();
-#else
-    // `getPreferredStartPad()` returns `window_size / 2`, while with
-    // `getLatency()` both time stretching engines return `window_size / 2 /
-    // pitch_scale`
-    return static_cast<size_t>(std::ceil(
-            m_pInstances[0]->getLatency() * m_pInstances[0]->getPitchScale()));
-#endif
+    return preferredStartPadOf(*m_pInstances[0]);
 }
 size_t RubberBandWrapper::getStartDelay() const {
     VERIFY_OR_DEBUG_ASSERT(isValid()) {
         return {};
     }
-#if RUBBERBANDV3
-    return m_pInstances[0]->getStartDelay();
-#else
-    // In newer Rubber Band versions `getLatency()` is a deprecated alias for
-    // `getStartDelay()`, so they should behave the same. In the commit linked
-    // above the behavior was different for the R3 stretcher, but that was only
-    // during the initial betas of Rubberband 3.0 so we shouldn't have to worry
-    // about that.
-    return m_pInstances[0]->getLatency();
-#endif
+    return startDelayOf(*m_pInstances[0]);
 }
 void RubberBandWrapper::process(const float* const* input, size_t samples, bool isFinal) {
     if (m_pInstances.size() == 1) {
         return m_pInstances[0]->process(input, samples, isFinal);
     } else {
+        m_checkpointIndex = (m_checkpointIndex + 1) % m_checkpoints.size();
+        m_checkpointCount = std::min(m_checkpointCount + 1, m_checkpoints.size());
+        m_checkpoints[m_checkpointIndex] = RatioCheckpoint{
+                m_inputFrames, m_processedOutputFrames, m_timeRatio};
+        m_processedOutputFrames += samples * m_timeRatio;
+        appendHistory(input, samples);
         RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
-        for (auto& pInstance : m_pInstances) {
-            pInstance->set(input, samples, isFinal);
-            // We try to get the stretching job ran by the RBPool if there is a
-            // worker slot available
-            if (!pPool->tryStart(pInstance.get())) {
-                // Otherwise, it means the main thread should take care of the stretching
-                pInstance->run();
+        // The last active task is always processed by the calling thread, so
+        // it doesn't sit idle while the workers are busy.
+        RubberBandTask* pLocalTask = nullptr;
+        for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+            if (m_instanceStates[i].priming) {
+                setPrimingInput(i, samples);
+                pLocalTask = m_pInstances[i].get();
+            } else if (m_instanceStates[i].active) {
+                m_pInstances[i]->set(input, samples, isFinal);
+                pLocalTask = m_pInstances[i].get();
             }
             input += m_channelPerWorker;
         }
+        // Hand over all other tasks first, before processing anything on this
+        // thread. Tasks that found no idle worker slot, e.g. because other
+        // decks are stretched at the same time, are processed by this thread.
+        m_deferredTasks.clear();
+        for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+            RubberBandTask* pInstance = m_pInstances[i].get();
+            if (!m_instanceStates[i].active) {
+                continue;
+            }
+            if (pInstance == pLocalTask ||
+                    pPool->maxThreadCount() == 0 ||
+                    !pPool->tryStart(pInstance)) {
+                m_deferredTasks.push_back(pInstance);
+            }
+        }
+        for (auto* pTask : m_deferredTasks) {
+            pTask->run();
+        }
         // We always perform a wait, even for task that were ran in the main
         // thread, so it resets the semaphore
-        for (auto& pInstance : m_pInstances) {
-            pInstance->waitReady();
+        for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+            InstanceState& state = m_instanceStates[i];
+            if (!state.active) {
+                continue;
+            }
+            m_pInstances[i]->waitReady();
+            if (state.priming) {
+                // Keep the output buffer of the instance small
+                discardOutput(i);
+                if (state.primeInputFrame >= m_inputFrames) {
+                    state.priming = false;
+                    state.fadeInFrames = kFadeInFrames;
+                }
+            }
         }
+        finishDeactivation();
     }
 }
 void RubberBandWrapper::reset() {
     for (auto& stretcher : m_pInstances) {
         stretcher->reset();
     }
+    for (auto& state : m_instanceStates) {
+        // The input history is gone, priming instances start from silence
+        // like the others
+        state.priming = false;
+        state.discardFrames = 0;
+        state.fadeInFrames = 0;
+    }
+    finishDeactivation();
+    m_inputFrames = 0;
+    m_processedOutputFrames = 0;
+    m_retrievedOutputFrames = 0;
+    m_checkpointCount = 0;
 }
 void RubberBandWrapper::clear() {
     m_pInstances.clear();
+    m_instanceStates.clear();
 }
 void RubberBandWrapper::setup(mixxx::audio::SampleRate sampleRate,
         mixxx::audio::ChannelCount chCount,
@@ -224,15 +328,47 @@ void RubberBandWrapper::setup(mixxx::audio::SampleRate sampleRate,
         m_pInstances.emplace_back(
                 std::make_unique<RubberBandTask>(
                         sampleRate, chCount, opt));
+        m_instanceStates.assign(1, InstanceState{});
         return;
     }
 
     m_pInstances.reserve(chCount / m_channelPerWorker);
+    m_deferredTasks.reserve(chCount / m_channelPerWorker);
     for (int c = 0; c < chCount; c += m_channelPerWorker) {
         m_pInstances.emplace_back(
                 std::make_unique<RubberBandTask>(
                         sampleRate, m_channelPerWorker, opt));
     }
+    m_instanceStates.assign(m_pInstances.size(), InstanceState{});
+    m_inputFrames = 0;
+    m_processedOutputFrames = 0;
+    m_retrievedOutputFrames = 0;
+    m_checkpointCount = 0;
+
+    // Preallocate the buffers for restarting instances if there are
+    // multiple instances
+    if (m_pInstances.size() > 1) {
+        m_history.resize(chCount);
+        for (auto& buffer : m_history) {
+            if (buffer.size() != kHistoryFrames) {
+                buffer = mixxx::SampleBuffer(kHistoryFrames);
+            }
+        }
+        m_scratch.resize(m_channelPerWorker);
+        m_scratchPtrs.resize(m_channelPerWorker);
+        for (int ch = 0; ch < m_channelPerWorker; ch++) {
+            if (m_scratch[ch].size() != kScratchFrames) {
+                m_scratch[ch] = mixxx::SampleBuffer(kScratchFrames);
+            }
+            m_scratchPtrs[ch] = m_scratch[ch].data();
+        }
+        if (m_silence.size() != kScratchFrames) {
+            m_silence = mixxx::SampleBuffer(kScratchFrames);
+            m_silence.clear();
+        }
+        m_primingInputPtrs.assign(m_pInstances.size(),
+                std::vector<const float*>(m_channelPerWorker));
+    }
 }
 void RubberBandWrapper::setPitchScale(double scale) {
     for (auto& stretcher : m_pInstances) {
@@ -243,3 +379,168 @@ void RubberBandWrapper::setPitchScale(double scale) {
 bool RubberBandWrapper::isValid() const {
     return !m_pInstances.empty();
 }
+
+void RubberBandWrapper::setActiveChannelPairs(std::uint32_t activeChannelPairs) {
+    if (m_pInstances.size() <= 1) {
+        return;
+    }
+    bool anyActive = false;
+    for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+        anyActive |= isInstanceActive(i, activeChannelPairs);
+    }
+    if (!anyActive) {
+        // The output is silent anyway. Keep the active instances running,
+        // because they define the output timing.
+        return;
+    }
+    for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+        InstanceState& state = m_instanceStates[i];
+        const bool active = isInstanceActive(i, activeChannelPairs);
+        if (active && state.deactivating) {
+            // Still running
+            state.deactivating = false;
+            continue;
+        }
+        if (active == state.active) {
+            continue;
+        }
+        if (active) {
+            restartInstance(i);
+        } else {
+            // Deactivated by finishDeactivation(), unless all other active
+            // instances are priming
+            state.deactivating = true;
+        }
+    }
+    finishDeactivation();
+}
+
+void RubberBandWrapper::finishDeactivation() {
+    bool anyAudible = false;
+    for (std::size_t i = 0; i < m_pInstances.size(); ++i) {
+        anyAudible |= isInstanceProducing(i) && !m_instanceStates[i].deactivating;
+    }
+    if (!anyAudible) {
+        return;
+    }
+    for (auto& state : m_instanceStates) {
+        if (state.deactivating) {
+            state = InstanceState{};
+            state.active = false;
+        }
+    }
+}
+
+bool RubberBandWrapper::isInstanceActive(
+        std::size_t instanceIdx, std::uint32_t activeChannelPairs) const {
+    const int firstChannel = static_cast<int>(instanceIdx) * m_channelPerWorker;
+    for (int ch = firstChannel; ch < firstChannel + m_channelPerWorker; ch++) {
+        if (activeChannelPairs & (1u << (ch / mixxx::audio::ChannelCount::stereo()))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RubberBandWrapper::appendHistory(const float* const* input, size_t samples) {
+    // Only the most recent frames are kept
+    const SINT skippedFrames = std::max<SINT>(0, static_cast<SINT>(samples) - kHistoryFrames);
+    SINT position = static_cast<SINT>((m_inputFrames + skippedFrames) % kHistoryFrames);
+    SINT offset = skippedFrames;
+    SINT remainingFrames = static_cast<SINT>(samples) - skippedFrames;
+    while (remainingFrames > 0) {
+        const SINT frames = std::min(remainingFrames, kHistoryFrames - position);
+        for (std::size_t ch = 0; ch < m_history.size(); ch++) {
+            SampleUtil::copy(m_history[ch].data(position), input[ch] + offset, frames);
+        }
+        position = (position + frames) % kHistoryFrames;
+        offset += frames;
+        remainingFrames -= frames;
+    }
+    m_inputFrames += samples;
+}
+
+void RubberBandWrapper::discardOutput(std::size_t instanceIdx) {
+    RubberBandTask* pInstance = m_pInstances[instanceIdx].get();
+    InstanceState& state = m_instanceStates[instanceIdx];
+    while (state.discardFrames > 0) {
+        const SINT frames = std::min({state.discardFrames,
+                static_cast<SINT>(std::max(0, pInstance->available())),
+                kScratchFrames});
+        if (frames <= 0) {
+            break;
+        }
+        pInstance->retrieve(m_scratchPtrs.data(), frames);
+        state.discardFrames -= frames;
+    }
+}
+
+double RubberBandWrapper::inputFrameAtOutput(std::int64_t outputFrame) const {
+    // The newest checkpoint before the output frame
+    for (std::size_t n = 0; n < m_checkpointCount; ++n) {
+        const RatioCheckpoint& checkpoint = m_checkpoints[
+                (m_checkpointIndex + m_checkpoints.size() - n) % m_checkpoints.size()];
+        if (checkpoint.outputFrame <= outputFrame) {
+            return checkpoint.inputFrame +
+                    (outputFrame - checkpoint.outputFrame) / checkpoint.timeRatio;
+        }
+    }
+    // Older than all checkpoints, the history does not reach back that far
+    return static_cast<double>(m_inputFrames - kHistoryFrames);
+}
+
+void RubberBandWrapper::restartInstance(std::size_t instanceIdx) {
+    RubberBandTask* pInstance = m_pInstances[instanceIdx].get();
+    InstanceState& state = m_instanceStates[instanceIdx];
+    pInstance->reset();
+
+    // Instead of silence, the start pad is taken from the input history. It
+    // starts at the input frame that corresponds to the next output of the
+    // other instances, reduced by the start delay. After dropping the start
+    // delay and the output that the others produce while this instance
+    // catches up, the restarted instance is aligned with the others.
+    const size_t startDelay = startDelayOf(*pInstance);
+    std::int64_t inputFrame = static_cast<std::int64_t>(std::round(
+            inputFrameAtOutput(m_retrievedOutputFrames) -
+            static_cast<double>(startDelay) / m_timeRatio));
+    inputFrame = std::max(inputFrame, m_inputFrames - kHistoryFrames);
+    state = InstanceState{};
+    state.active = true;
+    state.priming = true;
+    state.primeInputFrame = inputFrame;
+    state.discardFrames = static_cast<SINT>(startDelay);
+}
+
+void RubberBandWrapper::setPrimingInput(std::size_t instanceIdx, size_t samples) {
+    InstanceState& state = m_instanceStates[instanceIdx];
+    std::vector<const float*>& inputPtrs = m_primingInputPtrs[instanceIdx];
+    // The oldest frames of the history have been overwritten if it was
+    // restarted far behind
+    state.primeInputFrame = std::max(state.primeInputFrame, m_inputFrames - kHistoryFrames);
+    // The instance is fed slightly more input than the others, until it
+    // has caught up
+    const std::int64_t maxFrames = static_cast<std::int64_t>(samples) + kPrimingCatchUpFrames;
+    SINT frames;
+    if (state.primeInputFrame < 0) {
+        // The input before the last reset is silence
+        frames = static_cast<SINT>(std::min<std::int64_t>(
+                {-state.primeInputFrame, maxFrames, kScratchFrames}));
+        for (int ch = 0; ch < m_channelPerWorker; ch++) {
+            inputPtrs[ch] = m_silence.data();
+        }
+    } else {
+        // The history has been appended before, so the instance never
+        // needs input beyond it
+        const SINT position = static_cast<SINT>(state.primeInputFrame % kHistoryFrames);
+        frames = static_cast<SINT>(std::min<std::int64_t>(
+                {m_inputFrames - state.primeInputFrame,
+                        kHistoryFrames - position,
+                        maxFrames}));
+        const int firstChannel = static_cast<int>(instanceIdx) * m_channelPerWorker;
+        for (int ch = 0; ch < m_channelPerWorker; ch++) {
+            inputPtrs[ch] = m_history[firstChannel + ch].data(position);
+        }
+    }
+    m_pInstances[instanceIdx]->set(inputPtrs.data(), frames, false);
+    state.primeInputFrame += frames;
+}
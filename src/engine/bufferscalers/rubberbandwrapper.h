@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include "audio/types.h"
 #include "engine/bufferscalers/rubberbandtask.h"
+#include "util/samplebuffer.h"
 
 /// RubberBandWrapper is a wrapper around RubberBand::RubberBandStretcher which
 /// allows to distribute signal stretching over multiple instance, but interface
@@ -12,7 +16,7 @@ class RubberBandWrapper {
     void setTimeRatio(double ratio);
     std::size_t getSamplesRequired() const;
     int available() const;
-    size_t retrieve(float* const* output, size_t samples, SINT channelBufferSize) const;
+    size_t retrieve(float* const* output, size_t samples, SINT channelBufferSize);
     size_t getInputIncrement() const;
     size_t getLatency() const;
     double getPitchScale() const;
@@ -29,10 +33,84 @@ class RubberBandWrapper {
             const RubberBand::RubberBandStretcher::Options& opt);
     bool isValid() const;
 
+    /// Selects the stereo channel pairs that are stretched, one bit per pair.
+    /// The instances of inactive pairs are not processed and retrieve silence.
+    /// When a pair becomes active again, its instance is restarted with the
+    /// recent input and faded in. Only has an effect if the channels are
+    /// distributed over multiple instances, and at least one instance always
+    /// stays active. Must be called from the thread that processes.
+    void setActiveChannelPairs(std::uint32_t activeChannelPairs);
+
   private:
+    struct InstanceState {
+        bool active = true;
+        // Set while a restarted instance catches up with the input from the
+        // history. Its output is silent and dropped until it has caught up.
+        bool priming = false;
+        // The next input frame that is fed to a priming instance, may be
+        // negative for the silence before the last reset
+        std::int64_t primeInputFrame = 0;
+        // Output which is dropped after a restart, to align the instance
+        // with the others
+        SINT discardFrames = 0;
+        SINT fadeInFrames = 0;
+        // Set if the instance has been deactivated while all other active
+        // instances are priming. It keeps running with silent output.
+        bool deactivating = false;
+    };
+
+    // The time ratio of the input passed to process(), to map the retrieved
+    // output back to the input
+    struct RatioCheckpoint {
+        std::int64_t inputFrame = 0;
+        double outputFrame = 0;
+        double timeRatio = 1.0;
+    };
+
+    bool isInstanceActive(std::size_t instanceIdx, std::uint32_t activeChannelPairs) const;
+    void restartInstance(std::size_t instanceIdx);
+    void discardOutput(std::size_t instanceIdx);
+    void appendHistory(const float* const* input, size_t samples);
+    /// Passes the next chunk of the input history to a priming instance
+    void setPrimingInput(std::size_t instanceIdx, size_t samples);
+    bool isInstanceProducing(std::size_t instanceIdx) const {
+        return m_instanceStates[instanceIdx].active &&
+                !m_instanceStates[instanceIdx].priming;
+    }
+    /// Deactivates the instances that have been kept running to define the
+    /// output timing, once another instance is audible.
+    void finishDeactivation();
+    /// Returns the input frame that corresponds to the output frame
+    double inputFrameAtOutput(std::int64_t outputFrame) const;
+
     // copy constructor of RubberBand::RubberBandStretcher is implicitly deleted.
     std::vector<std::unique_ptr<RubberBandTask>> m_pInstances;
+    // Tasks processed by the calling thread, preallocated in setup()
+    std::vector<RubberBandTask*> m_deferredTasks;
     // Number of channel used for each instance. This may vary whether the track
     // is a stereo track or a stem track
     mixxx::audio::ChannelCount m_channelPerWorker;
+
+    std::vector<InstanceState> m_instanceStates;
+    // The recent input of all channels, used to warm up restarted instances
+    std::vector<mixxx::SampleBuffer> m_history;
+    // Scratch buffers for the channels of one instance
+    std::vector<mixxx::SampleBuffer> m_scratch;
+    std::vector<float*> m_scratchPtrs;
+    // Silent input for priming instances
+    mixxx::SampleBuffer m_silence;
+    // The input channels of each priming instance, which must stay valid
+    // until the instance has been processed
+    std::vector<std::vector<const float*>> m_primingInputPtrs;
+    // The number of input frames since the last reset
+    std::int64_t m_inputFrames = 0;
+    // The output frames of the input since the last reset
+    double m_processedOutputFrames = 0;
+    // The number of retrieved output frames since the last reset
+    std::int64_t m_retrievedOutputFrames = 0;
+    // A ring of the recent checkpoints, the newest at m_checkpointIndex
+    std::array<RatioCheckpoint, 128> m_checkpoints;
+    std::size_t m_checkpointIndex = 0;
+    std::size_t m_checkpointCount = 0;
+    double m_timeRatio = 1.0;
 };
@@ -1,13 +1,17 @@
 #include "engine/cachingreader/cachingreader.h"
 
 #include <QtDebug>
+#include <atomic>
 
 #include "moc_cachingreader.cpp"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
 #include "util/counter.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/sample.h"
+#include "util/statsmanager.h"
+#include "util/time.h"
 
 namespace {
 
@@ -18,16 +22,17 @@ mixxx::Logger kLogger("CachingReader");
 // TODO() Do we suffer cache misses if we use an audio buffer of above 23 ms?
 constexpr SINT kDefaultHintFrames = 1024;
 
-// With CachingReaderChunk::kFrames = 8192 each chunk consumes
+// With CachingReaderChunk::kDefaultFrames = 8192 each chunk consumes
 // 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB for stereo frame.
 //
 //     80 chunks ->  5120 KB =  5 MB
 //
 // Each deck (including sample decks) will use their own CachingReader.
-// Consequently the total memory required for all allocated chunks depends
-// on the number of decks. The amount of memory reserved for a single
-// CachingReader must be multiplied by the number of decks to calculate
-// the total amount!
+// Each CachingReader contributes the memory for this number of default sized
+// chunks to the global budget, which is then shared by all CachingReaders
+// according to the activity of their deck. Unless configured otherwise the
+// total amount of memory equals the amount that was previously reserved by
+// each CachingReader individually.
 //
 // NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
 // (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
@@ -35,6 +40,69 @@ constexpr SINT kDefaultHintFrames = 1024;
 // massive drop outs are expected to occur Mixxx should run reliably!
 constexpr SINT kNumberOfCachedChunksInMemory = 80;
 
+// The upper bound for the number of chunks of an active deck, relative to
+// its default share.
+constexpr SINT kMaxNumberOfChunks = 4 * kNumberOfCachedChunksInMemory;
+
+// The lower bound for the number of chunks of an inactive deck. This
+// covers the read ahead and the chunks around all cue points.
+constexpr SINT kMinNumberOfChunks = 16;
+
+// Limits the number of release requests, so they do not occupy the request
+// FIFO for too long
+constexpr int kMaxReleasesPerCallback = 4;
+
+// Limits the number of preload requests, so they do not delay reading the
+// chunks around the playing position, e.g. after loading a track with many
+// hotcues.
+constexpr int kMaxPreloadRequestsPerCallback = 2;
+
+// The interval for polling the worker while waiting for a chunk in
+// synchronous mode
+constexpr unsigned long kSynchronousReadPollMicros = 100;
+
+// The chunk hits and misses of read() are reported together after this
+// number of lookups instead of once per callback
+constexpr int kChunkLookupsPerStatsReport = 256;
+
+// The stats are reported per deck. The StatsManager logs all stats starting
+// with "CachingReader " for each audio buffer underflow.
+const QString kStatsTagPattern = QStringLiteral("CachingReader %1 %2");
+
+QString statsTag(const QString& group, const char* name) {
+    return kStatsTagPattern.arg(group, QLatin1String(name));
+}
+
+mixxx::Duration chunkRequestTime() {
+    return StatsManager::s_bStatsManagerEnabled
+            ? mixxx::Time::elapsed()
+            : mixxx::Duration::empty();
+}
+
+const ConfigKey kBudgetConfigKey = ConfigKey(
+        QStringLiteral("[App]"), QStringLiteral("caching_reader_memory_mb"));
+
+int weightForActivity(CachingReader::Activity activity) {
+    switch (activity) {
+    case CachingReader::Activity::Paused:
+        return 1;
+    case CachingReader::Activity::Playing:
+        return 2;
+    case CachingReader::Activity::Scratching:
+        return 4;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return 1;
+}
+
+// The global chunk memory budget in samples, shared by all CachingReaders.
+// A configured value of 0 means that the budget is the sum of the default
+// shares of all readers.
+std::atomic<qint64> s_configuredBudgetSamples{0};
+std::atomic<qint64> s_defaultBudgetSamples{0};
+// The sum of the default shares of all readers multiplied by their weight
+std::atomic<qint64> s_weightedBudgetSamples{0};
+
 } // anonymous namespace
 
 CachingReader::CachingReader(const QString& group,
@@ -52,31 +120,55 @@ CachingReader::CachingReader(const QString& group,
           // that must take ownership and free them!!!
           m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
           // The capacity of the back channel must be equal to the number of
-          // allocated chunks, because the worker use writeBlocking(). Otherwise
+          // allocated chunks, because the worker blocks when it is full. Otherwise
           // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_readerStatusUpdateFIFO(kMaxNumberOfChunks),
           m_state(STATE_IDLE),
+          m_allocatedCachingReaderChunks(kMaxNumberOfChunks),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel *
+          m_pPreloadedSamples(nullptr),
+          m_pPrimedSamples(nullptr),
+          m_maxSupportedChannel(maxSupportedChannel),
+          m_chunkFrames(CachingReaderChunk::kDefaultFrames),
+          m_channelPairs(mixxx::AudioSource::kAllChannelPairs),
+          m_defaultBudgetSamples(CachingReaderChunk::frames2samples(
+                                         CachingReaderChunk::kDefaultFrames,
+                                         maxSupportedChannel) *
                   kNumberOfCachedChunksInMemory),
+          m_budgetWeight(weightForActivity(Activity::Paused)),
+          m_chunkHitsTag(statsTag(group, "chunk hits")),
+          m_chunkMissesTag(statsTag(group, "chunk misses")),
+          m_chunkHitRatioTag(statsTag(group, "chunk hit ratio")),
+          m_chunkLatencyTag(statsTag(group, "chunk request to ready")),
+          m_evictedHintedChunksTag(statsTag(group, "evicted hinted chunks")),
+          m_allocatedSamples(0),
+          m_memoryAccount(QStringLiteral("CachingReader ") + group),
+          m_numPendingReleases(0),
+          m_synchronousReads(false),
           m_worker(group,
                   &m_chunkReadRequestFIFO,
                   &m_readerStatusUpdateFIFO,
-                  maxSupportedChannel) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
-    // Divide up the allocated raw memory buffer into total_chunks
-    // chunks. Initialize each chunk to hold nothing and add it to the free
-    // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
-        CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
-                        mixxx::SampleBuffer::WritableSlice(
-                                m_sampleBuffer,
-                                CachingReaderChunk::kFrames * maxSupportedChannel * i,
-                                CachingReaderChunk::kFrames * maxSupportedChannel));
+                  maxSupportedChannel,
+                  CachingReaderPcmCache::create(config)) {
+    if (m_pConfig) {
+        const qint64 budgetMegabytes = m_pConfig->getValue(kBudgetConfigKey, 0);
+        s_configuredBudgetSamples.store(
+                budgetMegabytes * 1024 * 1024 / static_cast<qint64>(sizeof(CSAMPLE)));
+    }
+    s_defaultBudgetSamples.fetch_add(m_defaultBudgetSamples);
+    s_weightedBudgetSamples.fetch_add(
+            static_cast<qint64>(m_defaultBudgetSamples) * m_budgetWeight);
+
+    // Create all chunks without any sample memory and add them to the free
+    // list. The memory is allocated by the worker on demand.
+    m_chunks.reserve(kMaxNumberOfChunks);
+    m_freeChunksWithMemory.reserve(kMaxNumberOfChunks);
+    m_freeChunksWithoutMemory.reserve(kMaxNumberOfChunks);
+    for (SINT i = 0; i < kMaxNumberOfChunks; ++i) {
+        CachingReaderChunkForOwner* c = new CachingReaderChunkForOwner();
         m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
+        m_freeChunksWithoutMemory.push_back(c);
     }
 
     // Forward signals from worker
@@ -96,6 +188,82 @@ CachingReader::CachingReader(const QString& group,
 CachingReader::~CachingReader() {
     m_worker.quitWait();
     qDeleteAll(m_chunks);
+    s_weightedBudgetSamples.fetch_sub(
+            static_cast<qint64>(m_defaultBudgetSamples) * m_budgetWeight);
+    s_defaultBudgetSamples.fetch_sub(m_defaultBudgetSamples);
+}
+
+void CachingReader::setActivity(Activity activity) {
+    const int budgetWeight = weightForActivity(activity);
+    if (budgetWeight == m_budgetWeight) {
+        return;
+    }
+    s_weightedBudgetSamples.fetch_add(
+            static_cast<qint64>(m_defaultBudgetSamples) * (budgetWeight - m_budgetWeight));
+    m_budgetWeight = budgetWeight;
+}
+
+SINT CachingReader::budgetSamples() const {
+    // The shares of all readers are not updated atomically, so their sum may
+    // temporarily deviate from the total budget.
+    const qint64 weightedBudgetSamples = s_weightedBudgetSamples.load(std::memory_order_relaxed);
+    qint64 totalBudgetSamples = s_configuredBudgetSamples.load(std::memory_order_relaxed);
+    if (totalBudgetSamples <= 0) {
+        totalBudgetSamples = s_defaultBudgetSamples.load(std::memory_order_relaxed);
+    }
+    qint64 budgetSamples = m_defaultBudgetSamples;
+    if (weightedBudgetSamples > 0) {
+        budgetSamples = totalBudgetSamples *
+                (static_cast<qint64>(m_defaultBudgetSamples) * m_budgetWeight) /
+                weightedBudgetSamples;
+    }
+    const qint64 chunkSamples =
+            CachingReaderChunk::frames2samples(m_chunkFrames, m_maxSupportedChannel);
+    return static_cast<SINT>(math_clamp<qint64>(budgetSamples,
+            chunkSamples * kMinNumberOfChunks,
+            chunkSamples * kMaxNumberOfChunks));
+}
+
+void CachingReader::trimToBudget() {
+    if (m_numPendingReleases > 0) {
+        // Wait until the previous chunks have been released
+        return;
+    }
+    SINT excessSamples = m_allocatedSamples - budgetSamples();
+    int numReleases = 0;
+    while (excessSamples > 0 && numReleases < kMaxReleasesPerCallback) {
+        // Prefer free chunks that still hold memory over the LRU chunk
+        CachingReaderChunkForOwner* pChunk = nullptr;
+        if (hasFreeChunkWithMemory()) {
+            pChunk = popFreeChunk();
+        } else if (m_lruCachingReaderChunk) {
+            pChunk = m_lruCachingReaderChunk;
+            countEviction(pChunk);
+            m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
+            pChunk->removeFromList(
+                    &m_mruCachingReaderChunk,
+                    &m_lruCachingReaderChunk);
+            pChunk->free();
+        } else {
+            break;
+        }
+        pChunk->initForRelease();
+        const SINT releasedSamples = pChunk->sampleBufferSize();
+        CachingReaderChunkReadRequest request;
+        request.giveToWorkerForRelease(pChunk);
+        if (!m_chunkReadRequestFIFO.try_push(request)) {
+            // Keep the chunk and try again later
+            pChunk->takeFromWorker();
+            freeChunk(pChunk);
+            break;
+        }
+        excessSamples -= releasedSamples;
+        ++numReleases;
+    }
+    if (numReleases > 0) {
+        m_numPendingReleases = numReleases;
+        m_worker.workReady();
+    }
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
@@ -103,18 +271,37 @@ void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
     pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    // Free chunks that still hold memory are reused first
+    if (pChunk->sampleBufferSize() > 0) {
+        m_freeChunksWithMemory.push_back(pChunk);
+    } else {
+        m_freeChunksWithoutMemory.push_back(pChunk);
+    }
+}
+
+CachingReaderChunkForOwner* CachingReader::popFreeChunk() {
+    CachingReaderChunkForOwner* pChunk = nullptr;
+    if (!m_freeChunksWithMemory.empty()) {
+        pChunk = m_freeChunksWithMemory.back();
+        m_freeChunksWithMemory.pop_back();
+    } else if (!m_freeChunksWithoutMemory.empty()) {
+        pChunk = m_freeChunksWithoutMemory.back();
+        m_freeChunksWithoutMemory.pop_back();
+    }
+    return pChunk;
 }
 
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
     DEBUG_ASSERT(pChunk);
     DEBUG_ASSERT(pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING);
 
-    const int removed = m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
-    Q_UNUSED(removed); // only used in DEBUG_ASSERT
     // We'll tolerate not being in allocatedCachingReaderChunks,
     // because sometime you free a chunk right after you allocated it.
-    DEBUG_ASSERT(removed <= 1);
+    // A replacing chunk must not remove the chunk that it replaces.
+    if (pChunk->getIndex() >= 0 &&
+            m_allocatedCachingReaderChunks.find(pChunk->getIndex()) == pChunk) {
+        m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
+    }
 
     freeChunkFromList(pChunk);
 }
@@ -138,13 +325,12 @@ void CachingReader::freeAllChunks() {
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.empty()) {
+    CachingReaderChunkForOwner* pChunk = popFreeChunk();
+    if (!pChunk) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
 
-    pChunk->init(chunkIndex);
+    pChunk->init(chunkIndex, m_chunkFrames, m_channelPairs);
 
     m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
 
@@ -152,9 +338,21 @@ CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkIndex) {
+    // Reuse the memory of the LRU chunk instead of letting the worker allocate
+    // new memory if this would exceed the budget.
+    if (m_lruCachingReaderChunk &&
+            !hasFreeChunkWithMemory() &&
+            m_allocatedSamples +
+                            CachingReaderChunk::frames2samples(
+                                    m_chunkFrames, m_maxSupportedChannel) >
+                    budgetSamples()) {
+        countEviction(m_lruCachingReaderChunk);
+        freeChunk(m_lruCachingReaderChunk);
+    }
     auto* pChunk = allocateChunk(chunkIndex);
     if (!pChunk) {
         if (m_lruCachingReaderChunk) {
+            countEviction(m_lruCachingReaderChunk);
             freeChunk(m_lruCachingReaderChunk);
             pChunk = allocateChunk(chunkIndex);
         } else {
@@ -168,8 +366,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
 }
 
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
+    // Defaults to nullptr if it's not in the table.
+    auto* pChunk = m_allocatedCachingReaderChunks.find(chunkIndex);
     DEBUG_ASSERT(!pChunk || pChunk->getIndex() == chunkIndex);
     return pChunk;
 }
@@ -225,17 +423,28 @@ void CachingReader::newTrack(TrackPointer pTrack) {
 
 // Called from the engine thread
 void CachingReader::process() {
-    ReaderStatusUpdate update;
-    while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
+    while (const auto* pUpdate = m_readerStatusUpdateFIFO.front()) {
+        ReaderStatusUpdate update = *pUpdate;
+        m_readerStatusUpdateFIFO.pop();
         auto* pChunk = update.takeFromWorker();
         if (pChunk) {
             // Result of a read request (with a chunk)
-            DEBUG_ASSERT(atomicLoadRelaxed(m_state) != STATE_IDLE);
             DEBUG_ASSERT(
                     update.status == CHUNK_READ_SUCCESS ||
                     update.status == CHUNK_READ_EOF ||
                     update.status == CHUNK_READ_INVALID ||
                     update.status == CHUNK_READ_DISCARDED);
+            m_allocatedSamples += pChunk->sampleBufferSizeDelta();
+            m_memoryAccount.set(static_cast<qint64>(m_allocatedSamples) *
+                    static_cast<qint64>(sizeof(CSAMPLE)));
+            if (pChunk->isReleaseRequested()) {
+                DEBUG_ASSERT(update.status == CHUNK_READ_DISCARDED);
+                DEBUG_ASSERT(m_numPendingReleases > 0);
+                --m_numPendingReleases;
+                freeChunk(pChunk);
+                continue;
+            }
+            DEBUG_ASSERT(atomicLoadRelaxed(m_state) != STATE_IDLE);
             if (m_state.loadAcquire() == STATE_TRACK_LOADING) {
                 // Discard all results from pending read requests for the
                 // previous track before the next track has been loaded.
@@ -243,12 +452,19 @@ void CachingReader::process() {
                 continue;
             }
             DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADED);
-            if (update.status == CHUNK_READ_SUCCESS) {
+            if (update.status == CHUNK_READ_SUCCESS && replaceChunk(pChunk)) {
+                trackChunkLatency(pChunk);
                 // Insert or freshen the chunk in the MRU/LRU list after
                 // obtaining ownership from the worker.
                 freshenChunk(pChunk);
             } else {
                 // Discard chunks that don't carry any data
+                auto* pCachedChunk = lookupChunk(pChunk->getIndex());
+                if (pCachedChunk && pCachedChunk != pChunk &&
+                        pCachedChunk->getState() == CachingReaderChunkForOwner::READY) {
+                    // Keep the cached chunk and try to replace it again
+                    pCachedChunk->setReplacementPending(false);
+                }
                 freeChunk(pChunk);
             }
             // Adjust the readable frame index range (if available)
@@ -276,9 +492,18 @@ void CachingReader::process() {
                 }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_pPreloadedSamples = update.loadedPreloadedSamples();
+                m_pPrimedSamples = update.loadedPrimedSamples();
+                m_primedFrameIndexRange = update.loadedPrimedFrameIndexRange();
+                // All chunks are free now and will be initialized with the
+                // chunk size of the new track
+                m_chunkFrames = update.loadedChunkFrames();
                 m_state.storeRelease(STATE_TRACK_LOADED);
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
+                m_pPreloadedSamples = nullptr;
+                m_pPrimedSamples = nullptr;
+                m_primedFrameIndexRange = mixxx::IndexRange();
                 // This message could be processed later when a new
                 // track is already loading! In this case the TRACK_LOADED will
                 // be the very next status update.
@@ -292,6 +517,55 @@ void CachingReader::process() {
     }
 }
 
+void CachingReader::countChunkLookup(bool hit) {
+    if (hit) {
+        ++m_chunkHits;
+    } else {
+        ++m_chunkMisses;
+    }
+    if (m_chunkHits + m_chunkMisses < kChunkLookupsPerStatsReport) {
+        return;
+    }
+    Counter(m_chunkHitsTag).increment(m_chunkHits);
+    Counter(m_chunkMissesTag).increment(m_chunkMisses);
+    Stat::track(m_chunkHitRatioTag,
+            Stat::UNSPECIFIED,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN),
+            static_cast<double>(m_chunkHits) / (m_chunkHits + m_chunkMisses));
+    m_chunkHits = 0;
+    m_chunkMisses = 0;
+}
+
+void CachingReader::trackChunkLatency(const CachingReaderChunkForOwner* pChunk) {
+    const mixxx::Duration requestTime = pChunk->requestTime();
+    if (requestTime == mixxx::Duration::empty() || !StatsManager::s_bStatsManagerEnabled) {
+        return;
+    }
+    // The histogram stores distinct values, so they are rounded to 0.5 ms
+    const double latencyMillis = (mixxx::Time::elapsed() - requestTime).toDoubleMillis();
+    Stat::track(m_chunkLatencyTag,
+            Stat::DURATION_MSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN |
+                    Stat::MAX | Stat::HISTOGRAM),
+            std::round(latencyMillis * 2) / 2);
+}
+
+void CachingReader::countEviction(const CachingReaderChunkForOwner* pChunk) {
+    if (!m_pHintList || !StatsManager::s_bStatsManagerEnabled) {
+        return;
+    }
+    const SINT chunkIndex = pChunk->getIndex();
+    int firstChunkIndex;
+    int lastChunkIndex;
+    for (const auto& hint : *m_pHintList) {
+        if (chunkIndexRangeForHint(hint, &firstChunkIndex, &lastChunkIndex) &&
+                chunkIndex >= firstChunkIndex && chunkIndex <= lastChunkIndex) {
+            Counter(m_evictedHintedChunksTag).increment();
+            return;
+        }
+    }
+}
+
 CachingReader::ReadResult CachingReader::read(SINT startSample,
         SINT numSamples,
         bool reverse,
@@ -397,16 +671,49 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
         // buffer. The buffer will be filled with silence for every
         // unreadable sample or samples outside of the track region
         // later at the end of this function.
-        if (!remainingFrameIndexRange.empty()) {
+        // The samples that have been decoded when loading the track, either
+        // of the whole track or of the frames around the main cue
+        const CSAMPLE* pDecodedSamples = m_pPreloadedSamples;
+        mixxx::IndexRange decodedFrameIndexRange = m_readableFrameIndexRange;
+        if (!pDecodedSamples && m_pPrimedSamples &&
+                remainingFrameIndexRange.isSubrangeOf(intersect(
+                        m_primedFrameIndexRange, m_readableFrameIndexRange))) {
+            pDecodedSamples = m_pPrimedSamples;
+            decodedFrameIndexRange = m_primedFrameIndexRange;
+        }
+        if (!remainingFrameIndexRange.empty() && pDecodedSamples) {
+            const auto readFrameIndexRange =
+                    intersect(remainingFrameIndexRange, m_readableFrameIndexRange);
+            DEBUG_ASSERT(readFrameIndexRange.start() == remainingFrameIndexRange.start());
+            const CSAMPLE* pReadSamples = pDecodedSamples +
+                    CachingReaderChunk::frames2samples(
+                            readFrameIndexRange.start() -
+                                    decodedFrameIndexRange.start(),
+                            channelCount);
+            const SINT readSamples = CachingReaderChunk::frames2samples(
+                    readFrameIndexRange.length(), channelCount);
+            DEBUG_ASSERT(samplesRemaining >= readSamples);
+            if (reverse) {
+                SampleUtil::copyReverse(
+                        &buffer[samplesRemaining - readSamples],
+                        pReadSamples,
+                        readSamples,
+                        channelCount);
+            } else {
+                SampleUtil::copy(buffer, pReadSamples, readSamples);
+                buffer += readSamples;
+            }
+            samplesRemaining -= readSamples;
+        } else if (!remainingFrameIndexRange.empty()) {
             // The intersection between the readable samples from the track
             // and the requested samples is not empty, so start reading.
             DEBUG_ASSERT(!intersect(remainingFrameIndexRange, m_readableFrameIndexRange).empty());
             DEBUG_ASSERT(remainingFrameIndexRange.start() >= m_readableFrameIndexRange.start());
 
-            const SINT firstChunkIndex =
-                    CachingReaderChunk::indexForFrame(remainingFrameIndexRange.start());
-            SINT lastChunkIndex =
-                    CachingReaderChunk::indexForFrame(remainingFrameIndexRange.end() - 1);
+            const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(
+                    remainingFrameIndexRange.start(), m_chunkFrames);
+            SINT lastChunkIndex = CachingReaderChunk::indexForFrame(
+                    remainingFrameIndexRange.end() - 1, m_chunkFrames);
             for (SINT chunkIndex = firstChunkIndex;
                     chunkIndex <= lastChunkIndex;
                     ++chunkIndex) {
@@ -430,8 +737,8 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                     kLogger.warning() << "Failed to read more sample data";
                     break;
                 }
-                lastChunkIndex =
-                        CachingReaderChunk::indexForFrame(remainingFrameIndexRange.end() - 1);
+                lastChunkIndex = CachingReaderChunk::indexForFrame(
+                        remainingFrameIndexRange.end() - 1, m_chunkFrames);
                 if (lastChunkIndex < chunkIndex) {
                     // No more readable data available. Exit the loop and
                     // fill the remaining buffer with silence.
@@ -440,8 +747,13 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
+                const CachingReaderChunkForOwner* pChunk = lookupChunkAndFreshen(chunkIndex);
+                if (m_synchronousReads &&
+                        !(pChunk && pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    pChunk = readChunkSynchronously(chunkIndex);
+                }
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    countChunkLookup(true);
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -461,7 +773,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    countChunkLookup(false);
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -528,83 +840,272 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
     return result;
 }
 
+bool CachingReader::chunkIndexRangeForHint(const Hint& hint,
+        int* pFirstChunkIndex,
+        int* pLastChunkIndex) const {
+    SINT hintFrame = hint.frame;
+    SINT hintFrameCount = hint.frameCount;
+
+    // Handle some special length values
+    if (hintFrameCount == Hint::kFrameCountForward) {
+        hintFrameCount = kDefaultHintFrames;
+    } else if (hintFrameCount == Hint::kFrameCountBackward) {
+        hintFrame -= kDefaultHintFrames;
+        hintFrameCount = kDefaultHintFrames;
+        if (hintFrame < 0) {
+            hintFrameCount += hintFrame;
+            if (hintFrameCount <= 0) {
+                return false;
+            }
+            hintFrame = 0;
+        }
+    }
+
+    VERIFY_OR_DEBUG_ASSERT(hintFrameCount >= 0) {
+        kLogger.warning() << "CachingReader: Ignoring negative hint length.";
+        return false;
+    }
+
+    const auto readableFrameIndexRange = intersect(
+            m_readableFrameIndexRange,
+            mixxx::IndexRange::forward(hintFrame, hintFrameCount));
+    if (readableFrameIndexRange.empty()) {
+        return false;
+    }
+
+    *pFirstChunkIndex = CachingReaderChunk::indexForFrame(
+            readableFrameIndexRange.start(), m_chunkFrames);
+    *pLastChunkIndex = CachingReaderChunk::indexForFrame(
+            readableFrameIndexRange.end() - 1, m_chunkFrames);
+    return true;
+}
+
+bool CachingReader::requestChunk(SINT chunkIndex) {
+    CachingReaderChunkForOwner* pChunk = allocateChunkExpireLRU(chunkIndex);
+    if (!pChunk) {
+        kLogger.warning()
+                << "Failed to allocate chunk"
+                << chunkIndex
+                << "for read request";
+        return false;
+    }
+    // Do not insert the allocated chunk into the MRU/LRU list,
+    // because it will be handed over to the worker immediately
+    pChunk->setRequestTime(chunkRequestTime());
+    CachingReaderChunkReadRequest request;
+    request.giveToWorker(pChunk);
+    if (kLogger.traceEnabled()) {
+        kLogger.trace()
+                << "Requesting read of chunk"
+                << request.chunk;
+    }
+    if (!m_chunkReadRequestFIFO.try_push(request)) {
+        kLogger.warning()
+                << "Failed to submit read request for chunk"
+                << chunkIndex;
+        // Revoke the chunk from the worker and free it
+        pChunk->takeFromWorker();
+        freeChunk(pChunk);
+        return false;
+    }
+    return true;
+}
+
+CachingReaderChunkForOwner* CachingReader::readChunkSynchronously(SINT chunkIndex) {
+    if (!lookupChunk(chunkIndex) && !requestChunk(chunkIndex)) {
+        return nullptr;
+    }
+    // Wake the worker directly, the scheduler only wakes it after the
+    // callback
+    m_worker.workReady();
+    m_worker.wakeIfReady();
+    while (true) {
+        process();
+        auto* pChunk = lookupChunkAndFreshen(chunkIndex);
+        if (!pChunk || pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING) {
+            // The chunk has either been read or discarded
+            return pChunk;
+        }
+        QThread::usleep(kSynchronousReadPollMicros);
+    }
+}
+
+bool CachingReader::requestChunkReplacement(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::READY);
+    if (pChunk->isReplacementPending()) {
+        return true;
+    }
+    const SINT chunkIndex = pChunk->getIndex();
+    CachingReaderChunkForOwner* pReplacement = nullptr;
+    if (hasFreeChunkWithMemory() ||
+            m_allocatedSamples +
+                            CachingReaderChunk::frames2samples(
+                                    m_chunkFrames, m_maxSupportedChannel) <=
+                    budgetSamples()) {
+        pReplacement = popFreeChunk();
+    }
+    if (!pReplacement) {
+        // No memory left for keeping both chunks, read the chunk again
+        // at the cost of a cache miss
+        freeChunk(pChunk);
+        return requestChunk(chunkIndex);
+    }
+    // The replacing chunk is only inserted into the table after it
+    // has been read, see replaceChunk()
+    pReplacement->init(chunkIndex, m_chunkFrames, m_channelPairs);
+    pReplacement->setRequestTime(chunkRequestTime());
+    CachingReaderChunkReadRequest request;
+    request.giveToWorker(pReplacement);
+    if (!m_chunkReadRequestFIFO.try_push(request)) {
+        pReplacement->takeFromWorker();
+        freeChunk(pReplacement);
+        return false;
+    }
+    pChunk->setReplacementPending(true);
+    return true;
+}
+
+bool CachingReader::replaceChunk(CachingReaderChunkForOwner* pChunk) {
+    const SINT chunkIndex = pChunk->getIndex();
+    auto* pCachedChunk = lookupChunk(chunkIndex);
+    if (pCachedChunk == pChunk) {
+        return true;
+    }
+    if (pCachedChunk) {
+        if (pCachedChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+            // The cached chunk has been evicted and requested again
+            // in the meantime
+            return false;
+        }
+        freeChunk(pCachedChunk);
+    }
+    m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
+    return true;
+}
+
+bool CachingReader::canPreloadChunk(SINT numHintedChunks) const {
+    // Leave room for the requests of the next callbacks
+    if (m_chunkReadRequestFIFO.capacity() - m_chunkReadRequestFIFO.size() <=
+            kMaxPreloadRequestsPerCallback) {
+        return false;
+    }
+    if (hasFreeChunkWithMemory()) {
+        return true;
+    }
+    if (!m_freeChunksWithoutMemory.empty() &&
+            m_allocatedSamples +
+                            CachingReaderChunk::frames2samples(
+                                    m_chunkFrames, m_maxSupportedChannel) <=
+                    budgetSamples()) {
+        return true;
+    }
+    // Otherwise the LRU chunk is expired, which is only acceptable if it
+    // has not been hinted in this callback.
+    return m_allocatedCachingReaderChunks.size() > numHintedChunks;
+}
+
 void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // If no file is loaded, skip.
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
         return;
     }
 
-    // For every chunk that the hints indicated, check if it is in the cache. If
-    // any are not, then wake.
-    bool shouldWake = false;
+    if (m_pPreloadedSamples) {
+        // All samples are in memory already, only release the memory
+        // of the chunks that are left over from the previous track
+        trimToBudget();
+        return;
+    }
 
-    for (const auto& hint: hintList) {
-        SINT hintFrame = hint.frame;
-        SINT hintFrameCount = hint.frameCount;
-
-        // Handle some special length values
-        if (hintFrameCount == Hint::kFrameCountForward) {
-        	hintFrameCount = kDefaultHintFrames;
-        } else if (hintFrameCount == Hint::kFrameCountBackward) {
-        	hintFrame -= kDefaultHintFrames;
-        	hintFrameCount = kDefaultHintFrames;
-            if (hintFrame < 0) {
-            	hintFrameCount += hintFrame;
-                if (hintFrameCount <= 0) {
-                    continue;
-                }
-                hintFrame = 0;
-            }
-        }
+    // Evicting any of the hinted chunks is counted for the stats
+    m_pHintList = &hintList;
 
-        VERIFY_OR_DEBUG_ASSERT(hintFrameCount >= 0) {
-            kLogger.warning() << "CachingReader: Ignoring negative hint length.";
+    // The number of chunks that have been hinted in this callback. Chunks
+    // hinted multiple times are counted multiple times, which only makes
+    // preloading more conservative.
+    SINT numHintedChunks = 0;
+    int firstChunkIndex;
+    int lastChunkIndex;
+
+    // Freshen the cached chunks of the preload hints first. This keeps them
+    // behind the chunks of all other hints in the LRU list, i.e. they are
+    // evicted first when the memory budget is exhausted.
+    for (const auto& hint : hintList) {
+        if (!hint.isPreload() ||
+                !chunkIndexRangeForHint(hint, &firstChunkIndex, &lastChunkIndex)) {
             continue;
         }
+        for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+            if (lookupChunkAndFreshen(chunkIndex)) {
+                ++numHintedChunks;
+            }
+        }
+    }
 
-        const auto readableFrameIndexRange = intersect(
-                m_readableFrameIndexRange,
-                mixxx::IndexRange::forward(hintFrame, hintFrameCount));
-        if (readableFrameIndexRange.empty()) {
+    // For every chunk that the hints indicated, check if it is in the cache. If
+    // any are not, then wake.
+    bool shouldWake = false;
+
+    for (const auto& hint : hintList) {
+        if (hint.isPreload() ||
+                !chunkIndexRangeForHint(hint, &firstChunkIndex, &lastChunkIndex)) {
             continue;
         }
-
-        const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
-        const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
         for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
             CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
             if (!pChunk) {
                 shouldWake = true;
-                pChunk = allocateChunkExpireLRU(chunkIndex);
-                if (!pChunk) {
-                    kLogger.warning()
-                            << "Failed to allocate chunk"
-                            << chunkIndex
-                            << "for read request";
+                if (!requestChunk(chunkIndex)) {
                     continue;
                 }
-                // Do not insert the allocated chunk into the MRU/LRU list,
-                // because it will be handed over to the worker immediately
-                CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
-                if (kLogger.traceEnabled()) {
-                    kLogger.trace()
-                            << "Requesting read of chunk"
-                            << request.chunk;
-                }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
-                    kLogger.warning()
-                            << "Failed to submit read request for chunk"
-                            << chunkIndex;
-                    // Revoke the chunk from the worker and free it
-                    pChunk->takeFromWorker();
-                    freeChunk(pChunk);
-                }
             } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+                if (!pChunk->containsChannelPairs(m_channelPairs)) {
+                    // Stems have been selected since the chunk has been read
+                    shouldWake = true;
+                    if (!requestChunkReplacement(pChunk)) {
+                        continue;
+                    }
+                    pChunk = lookupChunk(chunkIndex);
+                    if (!pChunk ||
+                            pChunk->getState() != CachingReaderChunkForOwner::READY) {
+                        ++numHintedChunks;
+                        continue;
+                    }
+                }
                 // This will cause the chunk to be 'freshened' in the cache. The
                 // chunk will be moved to the end of the LRU list.
                 freshenChunk(pChunk);
             }
+            ++numHintedChunks;
+        }
+    }
+
+    // Request the missing chunks of the preload hints at a low rate and only
+    // if this does not evict any recently hinted chunks.
+    int numPreloadRequests = 0;
+    bool preload = true;
+    for (const auto& hint : hintList) {
+        if (!preload) {
+            break;
+        }
+        if (!hint.isPreload() ||
+                !chunkIndexRangeForHint(hint, &firstChunkIndex, &lastChunkIndex)) {
+            continue;
+        }
+        for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+            if (lookupChunk(chunkIndex)) {
+                continue;
+            }
+            if (numPreloadRequests >= kMaxPreloadRequestsPerCallback ||
+                    !canPreloadChunk(numHintedChunks)) {
+                preload = false;
+                break;
+            }
+            if (requestChunk(chunkIndex)) {
+                shouldWake = true;
+                ++numPreloadRequests;
+                ++numHintedChunks;
+            }
         }
     }
 
@@ -612,4 +1113,7 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     if (shouldWake) {
         m_worker.workReady();
     }
+
+    trimToBudget();
+    m_pHintList = nullptr;
 }
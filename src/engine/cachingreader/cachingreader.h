@@ -1,16 +1,16 @@
 #pragma once
 
 #include <QAtomicInt>
-#include <QHash>
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
-#include <list>
+#include <vector>
 
+#include "engine/cachingreader/cachingreaderchunktable.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
-#include "util/fifo.h"
+#include "util/memoryaccount.h"
 #include "util/types.h"
 
 // A Hint is an indication to the CachingReader that a certain section of a
@@ -28,7 +28,10 @@ typedef struct Hint {
         FirstSound,
         IntroStart,
         IntroEnd,
-        OutroStart
+        OutroStart,
+        OutroEnd,
+        SavedLoopEnd,
+        BeatJump
     };
 
     // The frame to ensure is present in memory.
@@ -43,6 +46,24 @@ typedef struct Hint {
     // for the default frame count in forward direction
     static constexpr SINT kFrameCountForward = 0;
     static constexpr SINT kFrameCountBackward = -1;
+
+    // Preload hints are positions the user might jump to, e.g. cues and
+    // beatjump targets. They are requested after all other hints and their
+    // chunks are evicted first.
+    static constexpr bool isPreload(Type type) {
+        switch (type) {
+        case Type::SlipPosition:
+        case Type::CurrentPosition:
+        case Type::LoopStartEnabled:
+        case Type::LoopEndEnabled:
+            return false;
+        default:
+            return true;
+        }
+    }
+    bool isPreload() const {
+        return isPreload(type);
+    }
 } Hint;
 
 // Note that we use a QVarLengthArray here instead of a QVector. Since this list
@@ -76,6 +97,12 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// The memory of all chunks is bounded by a budget that is shared by all
+// CachingReaders. Each reader gets a share of the budget that is weighted by
+// the activity of its deck, e.g. a scratched deck may cache more chunks than
+// a paused one. Chunks exceeding the share are handed back to the worker,
+// which releases their memory.
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -88,6 +115,16 @@ class CachingReader : public QObject {
 
     void process();
 
+    enum class Activity {
+        Paused,
+        Playing,
+        Scratching,
+    };
+
+    // Adjusts the share of the global chunk memory budget. Must only be
+    // called from the engine callback.
+    void setActivity(Activity activity);
+
     enum class ReadResult {
         // No samples read and buffer untouched(!), try again later in case of a cache miss
         UNAVAILABLE,
@@ -118,10 +155,43 @@ class CachingReader : public QObject {
     // for this to take effect.
     void newTrack(TrackPointer pTrack);
 
+    // Selects the stereo channel pairs of a stem track that need to be
+    // decoded, see mixxx::AudioSource::selectChannelPairs(). Cached chunks
+    // that lack any of these channel pairs are read again, but are still
+    // used until the replacing chunk is available. Must only be called
+    // from the engine callback.
+    void setChannelPairs(mixxx::AudioSource::ChannelPairs channelPairs) {
+        m_channelPairs = channelPairs;
+    }
+
+    // Decode all tracks completely when loading them, e.g. for samplers.
+    // Affects the next track that is loaded.
+    void setPreloadAllTracks(bool preloadAllTracks) {
+        m_worker.setPreloadAllTracks(preloadAllTracks);
+    }
+
+    // Prime the loaded tracks from the CachingReaderPrimeCache, e.g. for
+    // preview decks. Affects the next track that is loaded.
+    void setPreviewMode(bool previewMode) {
+        m_worker.setPreviewMode(previewMode);
+    }
+
+    // Blocks read() on a cache miss until the worker has read the chunk,
+    // instead of returning silence. Must only be enabled when the engine is
+    // not driven by a sound device, e.g. for rendering a mix offline.
+    void setSynchronousReads(bool synchronousReads) {
+        m_synchronousReads = synchronousReads;
+    }
+
     void setScheduler(EngineWorkerScheduler* pScheduler) {
         m_worker.setScheduler(pScheduler);
     }
 
+    // Wait-free, may be called from the engine callback
+    void setSchedulingPriority(EngineWorker::SchedulingPriority priority) {
+        m_worker.setSchedulingPriority(priority);
+    }
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -136,8 +206,8 @@ class CachingReader : public QObject {
 
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
-    FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
-    FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
+    CachingReaderChunkReadRequestQueue m_chunkReadRequestFIFO;
+    ReaderStatusUpdateQueue m_readerStatusUpdateFIFO;
 
     // Looks for the provided chunk number in the index of in-memory chunks and
     // returns it if it is present. If not, returns nullptr. If it is present then
@@ -151,6 +221,13 @@ class CachingReader : public QObject {
     // Moves the provided chunk to the MRU position.
     void freshenChunk(CachingReaderChunkForOwner* pChunk);
 
+    // Pops a chunk from the free lists, preferring chunks with memory.
+    // Returns nullptr if none available.
+    CachingReaderChunkForOwner* popFreeChunk();
+    bool hasFreeChunkWithMemory() const {
+        return !m_freeChunksWithMemory.empty();
+    }
+
     // Returns a CachingReaderChunk to the free list
     void freeChunk(CachingReaderChunkForOwner* pChunk);
     void freeChunkFromList(CachingReaderChunkForOwner* pChunk);
@@ -161,9 +238,52 @@ class CachingReader : public QObject {
     // Gets a chunk from the free list. Returns nullptr if none available.
     CachingReaderChunkForOwner* allocateChunk(SINT chunkIndex);
 
-    // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
+    // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none
+    // available or if the memory budget would be exceeded.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // The number of samples this reader may allocate for its chunks
+    SINT budgetSamples() const;
+
+    // Returns false if the hint does not cover any readable frames.
+    bool chunkIndexRangeForHint(const Hint& hint,
+            int* pFirstChunkIndex,
+            int* pLastChunkIndex) const;
+
+    // Allocates the chunk and hands it over to the worker for reading.
+    // Returns false on failure.
+    bool requestChunk(SINT chunkIndex);
+
+    // Requests the chunk if needed and waits until the worker has read it.
+    // Returns nullptr if the chunk could not be read.
+    CachingReaderChunkForOwner* readChunkSynchronously(SINT chunkIndex);
+
+    // Reads a cached chunk again with the currently selected channel
+    // pairs into a separate chunk. Returns false on failure.
+    bool requestChunkReplacement(CachingReaderChunkForOwner* pChunk);
+
+    // Inserts a chunk that has been read into the table if it replaces
+    // a cached chunk. Returns false if the chunk is obsolete.
+    bool replaceChunk(CachingReaderChunkForOwner* pChunk);
+
+    // Preloading must neither evict any of the numHintedChunks chunks
+    // hinted in the current callback nor occupy the request FIFO.
+    bool canPreloadChunk(SINT numHintedChunks) const;
+
+    // Hands chunks over to the worker for releasing their memory if the
+    // allocated memory exceeds the budget.
+    void trimToBudget();
+
+    // Counts the chunk lookups of read() for the stats
+    void countChunkLookup(bool hit);
+
+    // Tracks the time from requesting a chunk until it has been read
+    void trackChunkLatency(const CachingReaderChunkForOwner* pChunk);
+
+    // Counts the eviction of the chunk for the stats if it has been hinted
+    // in the current callback, i.e. it is still needed.
+    void countEviction(const CachingReaderChunkForOwner* pChunk);
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -175,23 +295,65 @@ class CachingReader : public QObject {
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
+    // Stacks of free chunks with and without sample memory. Free chunks with
+    // memory are reused first. The capacity is reserved on construction, so
+    // pushing and popping never allocates.
+    std::vector<CachingReaderChunkForOwner*> m_freeChunksWithMemory;
+    std::vector<CachingReaderChunkForOwner*> m_freeChunksWithoutMemory;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
-    QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
+    CachingReaderChunkTable m_allocatedCachingReaderChunks;
 
     // The linked list of recently-used chunks.
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
     CachingReaderChunkForOwner* m_lruCachingReaderChunk;
 
-    // The raw memory buffer which is divided up into chunks.
-    mixxx::SampleBuffer m_sampleBuffer;
-
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The samples of the whole readable frame index range if the loaded
+    // track has been preloaded, owned by the worker. Otherwise nullptr.
+    const CSAMPLE* m_pPreloadedSamples;
+
+    // The samples around the main cue that have been decoded when loading
+    // the track, owned by the worker. Otherwise nullptr. Reads within this
+    // range don't depend on the chunks.
+    const CSAMPLE* m_pPrimedSamples;
+    mixxx::IndexRange m_primedFrameIndexRange;
+
+    const mixxx::audio::ChannelCount m_maxSupportedChannel;
+
+    // The number of frames per chunk of the loaded track
+    SINT m_chunkFrames;
+
+    mixxx::AudioSource::ChannelPairs m_channelPairs;
+
+    // The contribution of this reader to the global budget
+    const SINT m_defaultBudgetSamples;
+    int m_budgetWeight;
+
+    // The tags of the per-deck stats
+    const QString m_chunkHitsTag;
+    const QString m_chunkMissesTag;
+    const QString m_chunkHitRatioTag;
+    const QString m_chunkLatencyTag;
+    const QString m_evictedHintedChunksTag;
+
+    // The chunk lookups of read() since the last stats report
+    int m_chunkHits = 0;
+    int m_chunkMisses = 0;
+
+    // The hints of the current hintAndMaybeWake() call, otherwise nullptr
+    const HintVector* m_pHintList = nullptr;
+
+    // The number of samples allocated by all chunks, including free chunks
+    // and excluding chunks which are currently owned by the worker.
+    SINT m_allocatedSamples;
+    MemoryAccount m_memoryAccount;
+    int m_numPendingReleases;
+
+    bool m_synchronousReads;
+
     CachingReaderWorker m_worker;
 };
@@ -16,18 +16,56 @@ constexpr SINT kInvalidChunkIndex = -1;
 
 } // anonymous namespace
 
-CachingReaderChunk::CachingReaderChunk(
-        mixxx::SampleBuffer::WritableSlice sampleBuffer)
+// static
+SINT CachingReaderChunk::framesForFileType(const QString& fileType) {
+    const QString type = fileType.toLower();
+    if (type == QLatin1String("wav") ||
+            type == QLatin1String("aif") ||
+            type == QLatin1String("aiff") ||
+            type == QLatin1String("flac") ||
+            type == QLatin1String("wv")) {
+        return kMaxFrames;
+    }
+    if (type == QLatin1String("mp3")) {
+        // 8 MPEG-1 Layer III frames with 1152 samples each
+        return 8 * 1152;
+    }
+    if (type == QLatin1String("opus")) {
+        // 9 Opus frames with 20 ms each at 48 kHz
+        return 9 * 960;
+    }
+    // AAC frames contain 1024 samples, so the default size is
+    // already aligned
+    return kDefaultFrames;
+}
+
+CachingReaderChunk::CachingReaderChunk()
         : m_index(kInvalidChunkIndex),
-          m_sampleBuffer(std::move(sampleBuffer)) {
+          m_frames(kDefaultFrames),
+          m_channelPairs(mixxx::AudioSource::kAllChannelPairs) {
 }
 
-void CachingReaderChunk::init(SINT index) {
+void CachingReaderChunk::init(SINT index, SINT frames) {
     DEBUG_ASSERT(m_index == kInvalidChunkIndex || index == kInvalidChunkIndex);
+    DEBUG_ASSERT(frames > 0 && frames <= kMaxFrames);
     m_index = index;
+    m_frames = frames;
     m_bufferedSampleFrames.frameIndexRange() = mixxx::IndexRange();
 }
 
+bool CachingReaderChunk::containsChannelPairs(
+        mixxx::AudioSource::ChannelPairs channelPairs) const {
+    if (m_channelPairs == mixxx::AudioSource::kAllChannelPairs ||
+            m_channelPairs == channelPairs) {
+        return true;
+    }
+    if (m_channelPairs == mixxx::AudioSource::kPremixedChannelPairs ||
+            channelPairs == mixxx::AudioSource::kPremixedChannelPairs) {
+        return false;
+    }
+    return (m_channelPairs & channelPairs) == channelPairs;
+}
+
 // Frame index range of this chunk for the given audio source.
 mixxx::IndexRange CachingReaderChunk::frameIndexRange(
         const mixxx::AudioSourcePointer& pAudioSource) const {
@@ -39,7 +77,7 @@ mixxx::IndexRange CachingReaderChunk::frameIndexRange(
             pAudioSource->frameIndexMin() +
             frameIndexOffset();
     return intersect(
-            mixxx::IndexRange::forward(minFrameIndex, kFrames),
+            mixxx::IndexRange::forward(minFrameIndex, m_frames),
             pAudioSource->frameIndexRange());
 }
 
@@ -48,10 +86,21 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
         mixxx::SampleBuffer::WritableSlice tempOutputBuffer) {
     DEBUG_ASSERT(m_index != kInvalidChunkIndex);
     const auto sourceFrameIndexRange = frameIndexRange(pAudioSource);
+    m_channelPairs = pAudioSource->selectChannelPairs(m_channelPairs);
 
-    if (pAudioSource->getSignalInfo().getChannelCount() %
+    const bool readAsStereo = pAudioSource->getSignalInfo().getChannelCount() %
                     mixxx::audio::ChannelCount::stereo() !=
-            0) {
+            0;
+    const SINT sampleBufferSize = frames2samples(m_frames,
+            readAsStereo ? mixxx::audio::ChannelCount::stereo()
+                         : pAudioSource->getSignalInfo().getChannelCount());
+    if (m_sampleBuffer.size() != sampleBufferSize) {
+        // Also shrink the buffer, the owner accounts the allocated memory
+        // against its budget.
+        mixxx::SampleBuffer(sampleBufferSize).swap(m_sampleBuffer);
+    }
+
+    if (readAsStereo) {
         // This happens if the audio source only contain a mono channel, or an
         // odd number of channel
         mixxx::AudioSourceStereoProxy audioSourceProxy(
@@ -77,6 +126,11 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
     return m_bufferedSampleFrames.frameIndexRange();
 }
 
+void CachingReaderChunk::releaseSampleBuffer() {
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames();
+    mixxx::SampleBuffer().swap(m_sampleBuffer);
+}
+
 mixxx::IndexRange CachingReaderChunk::readBufferedSampleFrames(
         CSAMPLE* sampleBuffer,
         mixxx::audio::ChannelCount channelCount,
@@ -127,23 +181,37 @@ mixxx::IndexRange CachingReaderChunk::readBufferedSampleFramesReverse(
     return copyableFrameIndexRange;
 }
 
-CachingReaderChunkForOwner::CachingReaderChunkForOwner(
-        mixxx::SampleBuffer::WritableSlice sampleBuffer)
-        : CachingReaderChunk(std::move(sampleBuffer)),
-          m_state(FREE),
+CachingReaderChunkForOwner::CachingReaderChunkForOwner()
+        : m_state(FREE),
+          m_sampleBufferSizeWhenGiven(0),
+          m_releaseRequested(false),
+          m_replacementPending(false),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
 
-void CachingReaderChunkForOwner::init(SINT index) {
+void CachingReaderChunkForOwner::init(SINT index,
+        SINT frames,
+        mixxx::AudioSource::ChannelPairs channelPairs) {
     // Must not be accessed by a worker!
     DEBUG_ASSERT(m_state != READ_PENDING);
     // Must not be referenced in MRU/LRU list!
     DEBUG_ASSERT(!m_pNext);
     DEBUG_ASSERT(!m_pPrev);
 
-    CachingReaderChunk::init(index);
+    CachingReaderChunk::init(index, frames);
+    setChannelPairs(channelPairs);
+    m_state = READY;
+    m_replacementPending = false;
+}
+
+void CachingReaderChunkForOwner::initForRelease() {
+    DEBUG_ASSERT(m_state == FREE);
+    DEBUG_ASSERT(!m_pNext);
+    DEBUG_ASSERT(!m_pPrev);
+
     m_state = READY;
+    m_releaseRequested = true;
 }
 
 void CachingReaderChunkForOwner::free() {
@@ -153,8 +221,10 @@ void CachingReaderChunkForOwner::free() {
     DEBUG_ASSERT(!m_pNext);
     DEBUG_ASSERT(!m_pPrev);
 
-    CachingReaderChunk::init(kInvalidChunkIndex);
+    CachingReaderChunk::init(kInvalidChunkIndex, getFrames());
     m_state = FREE;
+    m_releaseRequested = false;
+    m_replacementPending = false;
 }
 
 void CachingReaderChunkForOwner::insertIntoListBefore(
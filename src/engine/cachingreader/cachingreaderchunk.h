@@ -1,16 +1,22 @@
 #pragma once
 
+#include <QString>
+
 #include "sources/audiosource.h"
+#include "util/duration.h"
 
 // A Chunk is a memory-resident section of audio that has been cached.
-// Each chunk holds a fixed number kFrames of frames with samples for
-// kChannels.
+// Each chunk holds a number of frames with samples for all channels. The
+// number of frames is chosen per track when the track is loaded.
 //
 // The class is not thread-safe although it is shared between CachingReader
 // and CachingReaderWorker! A lock-free FIFO ensures that only a single
 // thread has exclusive access on each chunk. This abstract base class
 // is available for both the worker thread and the cache.
 //
+// The sample memory of a chunk is allocated and released by the worker
+// thread, never by the engine thread.
+//
 // This is the common (abstract) base class for both the cache (as the owner)
 // and the worker.
 class CachingReaderChunk {
@@ -19,11 +25,15 @@ public:
   // 8192 frames contain about 170 ms of audio at 48 kHz, which
   // is well above (hopefully) the latencies people are seeing.
   // At 10 ms latency one chunk is enough for 17 callbacks.
-  // Additionally the chunk size should be a power of 2 for
-  // easier memory alignment.
-  // TODO(XXX): The optimum value of the "constant" kFrames depends
-  // on the properties of the AudioSource as the remarks above suggest!
-  static constexpr SINT kFrames = 8192; // ~ 170 ms at 48 kHz
+  static constexpr SINT kDefaultFrames = 8192; // ~ 170 ms at 48 kHz
+  // Decoding of lossless formats is cheap compared to the seek overhead,
+  // so bigger chunks are used for them.
+  static constexpr SINT kMaxFrames = 16384; // ~ 340 ms at 48 kHz
+
+  // Returns the number of frames per chunk for tracks of the given file
+  // type. For lossy codecs the chunks are aligned to the codec frame size,
+  // so a chunk read does not need to decode a codec frame twice.
+  static SINT framesForFileType(const QString& fileType);
 
   // Converts frames to samples
   static constexpr SINT frames2samples(
@@ -39,10 +49,12 @@ public:
     // Returns the corresponding chunk index for a frame index
     static SINT indexForFrame(
             /*const mixxx::AudioSourcePointer& pAudioSource,*/
-            SINT frameIndex) {
+            SINT frameIndex,
+            SINT chunkFrames) {
         // DEBUG_ASSERT(pAudioSource->frameIndexRange().contains(frameIndex));
+        DEBUG_ASSERT(chunkFrames > 0);
         const SINT frameIndexOffset = frameIndex /*- pAudioSource->frameIndexMin()*/;
-        return frameIndexOffset / kFrames;
+        return frameIndexOffset / chunkFrames;
     }
 
     // Disable copy and move constructors
@@ -53,16 +65,41 @@ public:
         return m_index;
     }
 
+    SINT getFrames() const noexcept {
+        return m_frames;
+    }
+
+    // The number of samples that are allocated for this chunk
+    SINT sampleBufferSize() const noexcept {
+        return m_sampleBuffer.size();
+    }
+
+    // The channel pairs of a stem track that have been decoded into the
+    // buffered samples, see mixxx::AudioSource::selectChannelPairs().
+    // Before reading these are the channel pairs that should be decoded.
+    mixxx::AudioSource::ChannelPairs getChannelPairs() const noexcept {
+        return m_channelPairs;
+    }
+
+    // Checks if the buffered samples contain all the required channel
+    // pairs. The premixed signal is only contained in chunks with
+    // either the premixed signal or all channel pairs.
+    bool containsChannelPairs(mixxx::AudioSource::ChannelPairs channelPairs) const;
+
     // Frame index range of this chunk for the given audio source.
     mixxx::IndexRange frameIndexRange(
             const mixxx::AudioSourcePointer& pAudioSource) const;
 
     // Read sample frames from the audio source and return the
-    // range of frames that have been read.
+    // range of frames that have been read. Allocates the sample
+    // memory if needed. Only called by the worker.
     mixxx::IndexRange bufferSampleFrames(
             const mixxx::AudioSourcePointer& pAudioSource,
             mixxx::SampleBuffer::WritableSlice tempOutputBuffer);
 
+    // Frees the sample memory. Only called by the worker.
+    void releaseSampleBuffer();
+
     mixxx::IndexRange readBufferedSampleFrames(CSAMPLE* sampleBuffer,
             mixxx::audio::ChannelCount channelCount,
             const mixxx::IndexRange& frameIndexRange) const;
@@ -72,22 +109,27 @@ public:
             const mixxx::IndexRange& frameIndexRange) const;
 
   protected:
-    explicit CachingReaderChunk(
-            mixxx::SampleBuffer::WritableSlice sampleBuffer);
+    CachingReaderChunk();
     virtual ~CachingReaderChunk() = default;
 
-    void init(SINT index);
+    void init(SINT index, SINT frames);
+
+    void setChannelPairs(mixxx::AudioSource::ChannelPairs channelPairs) {
+        m_channelPairs = channelPairs;
+    }
 
   private:
     SINT frameIndexOffset() const noexcept {
-        return m_index * kFrames;
+        return m_index * m_frames;
     }
 
     SINT m_index;
+    SINT m_frames;
+    mixxx::AudioSource::ChannelPairs m_channelPairs;
 
-    // The worker thread will fill the sample buffer and
+    // The worker thread will allocate and fill the sample buffer and
     // set the corresponding frame index range.
-    mixxx::SampleBuffer::WritableSlice m_sampleBuffer;
+    mixxx::SampleBuffer m_sampleBuffer;
     mixxx::ReadableSampleFrames m_bufferedSampleFrames;
 };
 
@@ -96,11 +138,15 @@ public:
 // the worker thread is in control.
 class CachingReaderChunkForOwner: public CachingReaderChunk {
 public:
-  explicit CachingReaderChunkForOwner(
-          mixxx::SampleBuffer::WritableSlice sampleBuffer);
+  CachingReaderChunkForOwner();
   ~CachingReaderChunkForOwner() override = default;
 
-  void init(SINT index);
+  void init(SINT index, SINT frames,
+          mixxx::AudioSource::ChannelPairs channelPairs =
+                  mixxx::AudioSource::kAllChannelPairs);
+  // Prepares a free chunk for handing it over to the worker, which
+  // releases its sample memory.
+  void initForRelease();
   void free();
 
   enum State {
@@ -120,6 +166,7 @@ public:
         DEBUG_ASSERT(!m_pNext);
         DEBUG_ASSERT(m_state == READY);
         m_state = READ_PENDING;
+        m_sampleBufferSizeWhenGiven = sampleBufferSize();
     }
     void takeFromWorker() {
         // Must not be referenced in MRU/LRU list!
@@ -129,6 +176,37 @@ public:
         m_state = READY;
     }
 
+    bool isReleaseRequested() const noexcept {
+        return m_releaseRequested;
+    }
+
+    // A READY chunk with insufficient channel pairs is read again into
+    // a separate chunk, which replaces it when the read has finished.
+    // Until then the samples of this chunk are still used.
+    bool isReplacementPending() const noexcept {
+        return m_replacementPending;
+    }
+    void setReplacementPending(bool replacementPending) {
+        DEBUG_ASSERT(m_state == READY);
+        m_replacementPending = replacementPending;
+    }
+
+    // The change of the allocated sample memory while the chunk was
+    // owned by the worker.
+    SINT sampleBufferSizeDelta() const noexcept {
+        DEBUG_ASSERT(m_state != READ_PENDING);
+        return sampleBufferSize() - m_sampleBufferSizeWhenGiven;
+    }
+
+    // The time when the chunk has been requested from the worker for the
+    // stats, empty if the stats are disabled.
+    mixxx::Duration requestTime() const noexcept {
+        return m_requestTime;
+    }
+    void setRequestTime(mixxx::Duration requestTime) {
+        m_requestTime = requestTime;
+    }
+
     // Inserts a chunk into the double-linked list before the
     // given chunk and adjusts the head/tail pointers. The
     // chunk is inserted at the tail of the list if
@@ -145,6 +223,10 @@ public:
 
 private:
   State m_state;
+  SINT m_sampleBufferSizeWhenGiven;
+  bool m_releaseRequested;
+  bool m_replacementPending;
+  mixxx::Duration m_requestTime;
 
   CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
   CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
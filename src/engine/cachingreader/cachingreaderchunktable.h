@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vector>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/types.h"
+
+class CachingReaderChunkForOwner;
+
+// A hash table that maps chunk indices onto chunks.
+//
+// The table uses open addressing with linear probing and a fixed capacity
+// that is allocated on construction. None of the operations allocate memory,
+// so they are safe to be called from the engine callback. Removing an entry
+// shifts the following entries of its probe sequence backwards, so there are
+// no tombstones and the lookup performance does not degrade over time.
+class CachingReaderChunkTable final {
+  public:
+    // The table is able to hold maxSize entries with a load factor of
+    // at most 50%.
+    explicit CachingReaderChunkTable(SINT maxSize)
+            : m_slots(roundUpToPowerOf2(static_cast<unsigned int>(2 * maxSize))),
+              m_mask(static_cast<SINT>(m_slots.size()) - 1),
+              m_maxSize(maxSize),
+              m_size(0) {
+        DEBUG_ASSERT(maxSize > 0);
+    }
+
+    SINT size() const {
+        return m_size;
+    }
+
+    // Returns nullptr if the chunk index is not in the table.
+    CachingReaderChunkForOwner* find(SINT chunkIndex) const {
+        DEBUG_ASSERT(chunkIndex >= 0);
+        for (SINT slot = slotForIndex(chunkIndex);; slot = (slot + 1) & m_mask) {
+            const Slot& entry = m_slots[slot];
+            if (!entry.pChunk) {
+                return nullptr;
+            }
+            if (entry.chunkIndex == chunkIndex) {
+                return entry.pChunk;
+            }
+        }
+    }
+
+    // Inserts or replaces the chunk for its index. Returns false if the
+    // table is full.
+    bool insert(SINT chunkIndex, CachingReaderChunkForOwner* pChunk) {
+        DEBUG_ASSERT(chunkIndex >= 0);
+        DEBUG_ASSERT(pChunk);
+        for (SINT slot = slotForIndex(chunkIndex);; slot = (slot + 1) & m_mask) {
+            Slot& entry = m_slots[slot];
+            if (!entry.pChunk) {
+                VERIFY_OR_DEBUG_ASSERT(m_size < m_maxSize) {
+                    return false;
+                }
+                entry.chunkIndex = chunkIndex;
+                entry.pChunk = pChunk;
+                ++m_size;
+                return true;
+            }
+            if (entry.chunkIndex == chunkIndex) {
+                entry.pChunk = pChunk;
+                return true;
+            }
+        }
+    }
+
+    // Returns the number of removed entries, i.e. 0 or 1.
+    int remove(SINT chunkIndex) {
+        if (chunkIndex < 0) {
+            return 0;
+        }
+        SINT slot = slotForIndex(chunkIndex);
+        for (;; slot = (slot + 1) & m_mask) {
+            const Slot& entry = m_slots[slot];
+            if (!entry.pChunk) {
+                return 0;
+            }
+            if (entry.chunkIndex == chunkIndex) {
+                break;
+            }
+        }
+        // Backward shift deletion: Move all following entries of the
+        // probe sequence that cannot be found anymore into the gap.
+        SINT gap = slot;
+        for (SINT next = (gap + 1) & m_mask; m_slots[next].pChunk; next = (next + 1) & m_mask) {
+            const SINT home = slotForIndex(m_slots[next].chunkIndex);
+            // Distance of the entry from its home slot compared to the
+            // distance of the gap from that home slot
+            if (((next - home) & m_mask) >= ((next - gap) & m_mask)) {
+                m_slots[gap] = m_slots[next];
+                gap = next;
+            }
+        }
+        m_slots[gap] = Slot();
+        --m_size;
+        return 1;
+    }
+
+    void clear() {
+        if (m_size == 0) {
+            return;
+        }
+        for (auto& entry : m_slots) {
+            entry = Slot();
+        }
+        m_size = 0;
+    }
+
+  private:
+    struct Slot {
+        SINT chunkIndex = 0;
+        CachingReaderChunkForOwner* pChunk = nullptr;
+    };
+
+    SINT slotForIndex(SINT chunkIndex) const {
+        // Consecutive chunk indices are the common case and end up
+        // in consecutive slots, which keeps the probe sequences short.
+        return chunkIndex & m_mask;
+    }
+
+    std::vector<Slot> m_slots;
+    const SINT m_mask;
+    const SINT m_maxSize;
+    SINT m_size;
+};
@@ -0,0 +1,461 @@
+#include "engine/cachingreader/cachingreaderpcmcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMultiHash>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "sources/audiosourcetrackproxy.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CachingReaderPcmCache");
+
+// The size limit of the cache in MB. 0 disables the cache.
+const ConfigKey kSizeLimitConfigKey = ConfigKey(
+        QStringLiteral("[App]"), QStringLiteral("pcm_cache_size_mb"));
+
+const QString kCacheSubdirectory = QStringLiteral("/cache/pcm");
+const QString kCacheFileSuffix = QStringLiteral(".pcm");
+
+constexpr char kMagic[8] = {'M', 'I', 'X', 'X', 'X', 'P', 'C', 'M'};
+constexpr quint32 kVersion = 1;
+
+// The number of frames that are decoded and written per writeNext() call.
+// Small enough to react to new requests of the engine timely.
+constexpr SINT kFramesPerWrite = 65536;
+
+// The cache files are only used on the machine that has written them, so
+// all values are stored in native byte order.
+struct CacheFileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 frameIndexStart;
+    qint64 frameIndexEnd;
+    char reserved[24];
+};
+// Keeps the samples aligned in the mapped memory
+static_assert(sizeof(CacheFileHeader) == 64);
+
+bool isValidHeader(const CacheFileHeader& header) {
+    return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+            header.version == kVersion &&
+            header.channelCount > 0 &&
+            header.sampleRate > 0 &&
+            header.frameIndexStart >= 0 &&
+            header.frameIndexEnd > header.frameIndexStart;
+}
+
+// Reads the samples of a cache file from a read-only memory mapping.
+class PcmCacheAudioSource final : public mixxx::AudioSource {
+  public:
+    explicit PcmCacheAudioSource(const QString& fileName)
+            : AudioSource(QUrl::fromLocalFile(fileName)),
+              m_file(fileName),
+              m_pMapped(nullptr),
+              m_pSamples(nullptr) {
+    }
+    ~PcmCacheAudioSource() override {
+        close();
+    }
+
+    void close() override {
+        if (m_pMapped) {
+            m_file.unmap(m_pMapped);
+            m_pMapped = nullptr;
+            m_pSamples = nullptr;
+        }
+        m_file.close();
+    }
+
+  protected:
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& sampleFrames) override {
+        const mixxx::IndexRange frameIndexRange = sampleFrames.frameIndexRange();
+        const SINT sampleCount = getSignalInfo().frames2samples(frameIndexRange.length());
+        DEBUG_ASSERT(!sampleFrames.writableData() || sampleFrames.writableLength() >= sampleCount);
+        if (sampleFrames.writableData()) {
+            const SINT sampleOffset = getSignalInfo().frames2samples(
+                    frameIndexRange.start() - frameIndexMin());
+            SampleUtil::copy(sampleFrames.writableData(),
+                    m_pSamples + sampleOffset,
+                    sampleCount);
+        }
+        return mixxx::ReadableSampleFrames(
+                frameIndexRange,
+                mixxx::SampleBuffer::ReadableSlice(
+                        sampleFrames.writableData(),
+                        sampleFrames.writableData() ? sampleCount : 0));
+    }
+
+  private:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            return OpenResult::Failed;
+        }
+        CacheFileHeader header;
+        if (m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) !=
+                        static_cast<qint64>(sizeof(header)) ||
+                !isValidHeader(header)) {
+            kLogger.warning() << "Invalid cache file" << getUrlString();
+            return OpenResult::Failed;
+        }
+        const qint64 sampleCount = (header.frameIndexEnd - header.frameIndexStart) *
+                header.channelCount;
+        const qint64 expectedSize = static_cast<qint64>(sizeof(header)) +
+                sampleCount * static_cast<qint64>(sizeof(CSAMPLE));
+        if (m_file.size() != expectedSize) {
+            kLogger.warning() << "Truncated cache file" << getUrlString();
+            return OpenResult::Failed;
+        }
+        m_pMapped = m_file.map(0, expectedSize);
+        if (!m_pMapped) {
+            kLogger.warning() << "Failed to map cache file" << getUrlString()
+                              << m_file.errorString();
+            return OpenResult::Failed;
+        }
+        m_pSamples = reinterpret_cast<const CSAMPLE*>(m_pMapped + sizeof(header));
+
+        initChannelCountOnce(static_cast<int>(header.channelCount));
+        initSampleRateOnce(static_cast<SINT>(header.sampleRate));
+        if (header.bitrate > 0) {
+            initBitrateOnce(static_cast<SINT>(header.bitrate));
+        }
+        initFrameIndexRangeOnce(mixxx::IndexRange::between(
+                static_cast<SINT>(header.frameIndexStart),
+                static_cast<SINT>(header.frameIndexEnd)));
+        return OpenResult::Succeeded;
+    }
+
+    QFile m_file;
+    uchar* m_pMapped;
+    const CSAMPLE* m_pSamples;
+};
+
+// All unfinished Writers of all threads by file name
+std::mutex s_writersMutex;
+QMultiHash<QString, CachingReaderPcmCache::Writer*> s_writers;
+
+} // anonymous namespace
+
+// static
+std::shared_ptr<CachingReaderPcmCache> CachingReaderPcmCache::create(
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig) {
+        return nullptr;
+    }
+    const qint64 sizeLimitMegabytes = pConfig->getValue(kSizeLimitConfigKey, 0);
+    if (sizeLimitMegabytes <= 0) {
+        return nullptr;
+    }
+    return std::make_shared<CachingReaderPcmCache>(
+            pConfig->getSettingsPath() + kCacheSubdirectory,
+            sizeLimitMegabytes * 1024 * 1024);
+}
+
+CachingReaderPcmCache::CachingReaderPcmCache(
+        const QString& directory,
+        qint64 maxSizeBytes)
+        : m_directory(directory),
+          m_maxSizeBytes(maxSizeBytes) {
+    DEBUG_ASSERT(m_maxSizeBytes > 0);
+    QDir().mkpath(m_directory);
+}
+
+QString CachingReaderPcmCache::fileNameForTrack(
+        const TrackPointer& pTrack,
+        mixxx::audio::ChannelCount maxChannelCount) const {
+    // Any modification of the file invalidates the cached samples
+    const QFileInfo fileInfo(pTrack->getLocation());
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.canonicalFilePath().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    // Only stem files are decoded into more than two channels. Other files
+    // share the cache file between stem decks, stereo decks and the analysis.
+    if (pTrack->getStemInfo().isEmpty() &&
+            maxChannelCount > mixxx::audio::ChannelCount::stereo()) {
+        maxChannelCount = mixxx::audio::ChannelCount::stereo();
+    }
+    hash.addData(QByteArray::number(static_cast<int>(maxChannelCount)));
+    return m_directory + QChar('/') + QString::fromLatin1(hash.result().toHex()) +
+            kCacheFileSuffix;
+}
+
+mixxx::AudioSourcePointer CachingReaderPcmCache::openAudioSource(
+        const TrackPointer& pTrack,
+        mixxx::audio::ChannelCount maxChannelCount) {
+    const QString fileName = fileNameForTrack(pTrack, maxChannelCount);
+    if (!QFile::exists(fileName)) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<PcmCacheAudioSource>(fileName);
+    if (pAudioSource->open(mixxx::AudioSource::OpenMode::Strict) !=
+            mixxx::AudioSource::OpenResult::Succeeded) {
+        // Never use a corrupt file again
+        pAudioSource->close();
+        QFile::remove(fileName);
+        return nullptr;
+    }
+    // Mark as recently used for eviction
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    pTrack->updateStreamInfoFromSource(pAudioSource->getStreamInfo());
+    return mixxx::AudioSourceTrackProxy::create(pTrack, std::move(pAudioSource));
+}
+
+std::unique_ptr<CachingReaderPcmCache::Writer> CachingReaderPcmCache::newWriter(
+        const TrackPointer& pTrack,
+        mixxx::audio::ChannelCount maxChannelCount) {
+    const QString fileName = fileNameForTrack(pTrack, maxChannelCount);
+    {
+        const std::lock_guard lock(s_writersMutex);
+        for (auto it = s_writers.constFind(fileName);
+                it != s_writers.constEnd() && it.key() == fileName;
+                ++it) {
+            if (!it.value()->m_decoding) {
+                return nullptr;
+            }
+        }
+    }
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(maxChannelCount);
+    auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    if (!pAudioSource) {
+        return nullptr;
+    }
+    return std::unique_ptr<Writer>(new Writer(this,
+            std::move(pAudioSource),
+            fileName,
+            true));
+}
+
+std::unique_ptr<CachingReaderPcmCache::Writer> CachingReaderPcmCache::newFedWriter(
+        const TrackPointer& pTrack,
+        mixxx::audio::ChannelCount maxChannelCount,
+        mixxx::AudioSourcePointer pAudioSource) {
+    DEBUG_ASSERT(pAudioSource);
+    const QString fileName = fileNameForTrack(pTrack, maxChannelCount);
+    {
+        const std::lock_guard lock(s_writersMutex);
+        for (auto it = s_writers.constFind(fileName);
+                it != s_writers.constEnd() && it.key() == fileName;
+                ++it) {
+            if (!it.value()->m_decoding) {
+                return nullptr;
+            }
+        }
+        // Stop decoding the same track twice
+        for (auto it = s_writers.constFind(fileName);
+                it != s_writers.constEnd() && it.key() == fileName;
+                ++it) {
+            it.value()->m_superseded.store(true);
+        }
+    }
+    return std::unique_ptr<Writer>(new Writer(this,
+            std::move(pAudioSource),
+            fileName,
+            false));
+}
+
+void CachingReaderPcmCache::evict(const QString& keepFileName) {
+    QDir dir(m_directory);
+    // Most recently used first
+    const QFileInfoList fileInfos = dir.entryInfoList(
+            QStringList{QStringLiteral("*") + kCacheFileSuffix},
+            QDir::Files,
+            QDir::Time);
+    qint64 totalSize = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+    }
+    for (auto it = fileInfos.crbegin(); it != fileInfos.crend() && totalSize > m_maxSizeBytes;
+            ++it) {
+        if (it->absoluteFilePath() == keepFileName) {
+            continue;
+        }
+        // Fails on some platforms if the file is still mapped by another
+        // deck. It is retried on the next eviction.
+        if (QFile::remove(it->absoluteFilePath())) {
+            totalSize -= it->size();
+        }
+    }
+}
+
+CachingReaderPcmCache::Writer::Writer(CachingReaderPcmCache* pCache,
+        mixxx::AudioSourcePointer pAudioSource,
+        const QString& fileName,
+        bool decoding)
+        : m_pCache(pCache),
+          m_pAudioSource(std::move(pAudioSource)),
+          m_decoding(decoding),
+          m_file(fileName),
+          m_nextFrameIndex(m_pAudioSource->frameIndexMin()),
+          m_frameIndexEnd(m_pAudioSource->frameIndexMax()),
+          m_done(false),
+          m_superseded(false) {
+    if (m_decoding) {
+        mixxx::SampleBuffer(m_pAudioSource->getSignalInfo().frames2samples(
+                                    kFramesPerWrite))
+                .swap(m_buffer);
+    }
+    const std::lock_guard lock(s_writersMutex);
+    s_writers.insert(fileName, this);
+}
+
+CachingReaderPcmCache::Writer::~Writer() {
+    const std::lock_guard lock(s_writersMutex);
+    s_writers.remove(m_file.fileName(), this);
+}
+
+bool CachingReaderPcmCache::Writer::writeHeader() {
+    CacheFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.channelCount = m_pAudioSource->getSignalInfo().getChannelCount();
+    header.sampleRate = m_pAudioSource->getSignalInfo().getSampleRate();
+    header.bitrate = m_pAudioSource->getBitrate().isValid()
+            ? m_pAudioSource->getBitrate().value()
+            : 0;
+    header.frameIndexStart = m_pAudioSource->frameIndexMin();
+    // The header is rewritten with the actual end when finished
+    header.frameIndexEnd = m_nextFrameIndex;
+    return m_file.seek(0) &&
+            m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ==
+            static_cast<qint64>(sizeof(header));
+}
+
+bool CachingReaderPcmCache::Writer::open() {
+    if (m_file.isOpen()) {
+        return true;
+    }
+    if (!m_file.open(QIODevice::WriteOnly) || !writeHeader()) {
+        kLogger.warning() << "Failed to create cache file" << m_file.fileName()
+                          << m_file.errorString();
+        m_file.cancelWriting();
+        m_done = true;
+        return false;
+    }
+    return true;
+}
+
+bool CachingReaderPcmCache::Writer::writeSamples(
+        const mixxx::ReadableSampleFrames& sampleFrames) {
+    const SINT byteCount = sampleFrames.readableLength() *
+            static_cast<SINT>(sizeof(CSAMPLE));
+    if (byteCount > 0 &&
+            m_file.write(reinterpret_cast<const char*>(
+                                 sampleFrames.readableData()),
+                    byteCount) != byteCount) {
+        kLogger.warning() << "Failed to write cache file" << m_file.fileName()
+                          << m_file.errorString();
+        m_file.cancelWriting();
+        m_done = true;
+        return false;
+    }
+    m_nextFrameIndex = sampleFrames.frameIndexRange().end();
+    return true;
+}
+
+bool CachingReaderPcmCache::Writer::writeNext() {
+    DEBUG_ASSERT(m_decoding);
+    if (m_done) {
+        return false;
+    }
+    if (m_superseded.load()) {
+        kLogger.debug() << "Leaving cache file to the analysis" << m_file.fileName();
+        if (m_file.isOpen()) {
+            m_file.cancelWriting();
+        }
+        m_done = true;
+        return false;
+    }
+    if (!open()) {
+        return false;
+    }
+
+    const auto frameIndexRange = mixxx::IndexRange::forward(m_nextFrameIndex,
+            std::min(kFramesPerWrite, m_pAudioSource->frameIndexMax() - m_nextFrameIndex));
+    const auto readableSampleFrames = frameIndexRange.empty()
+            ? mixxx::ReadableSampleFrames(frameIndexRange)
+            : m_pAudioSource->readSampleFrames(mixxx::WritableSampleFrames(
+                      frameIndexRange,
+                      mixxx::SampleBuffer::WritableSlice(
+                              m_buffer.data(),
+                              m_pAudioSource->getSignalInfo().frames2samples(
+                                      frameIndexRange.length()))));
+    if (!writeSamples(readableSampleFrames)) {
+        return false;
+    }
+
+    // A short read indicates the end of the decodable audio data, which
+    // is only cached if it is the end of the track
+    if (readableSampleFrames.frameLength() < kFramesPerWrite) {
+        finish();
+        return false;
+    }
+    return true;
+}
+
+bool CachingReaderPcmCache::Writer::append(
+        const mixxx::ReadableSampleFrames& sampleFrames) {
+    DEBUG_ASSERT(!m_decoding);
+    if (m_done || !open()) {
+        return false;
+    }
+    if (sampleFrames.frameIndexRange().start() != m_nextFrameIndex) {
+        kLogger.debug() << "Discarding cache file with missing frames" << m_file.fileName();
+        m_file.cancelWriting();
+        m_done = true;
+        return false;
+    }
+    return writeSamples(sampleFrames);
+}
+
+void CachingReaderPcmCache::Writer::finish() {
+    if (m_done) {
+        return;
+    }
+    m_done = true;
+    if (!m_file.isOpen()) {
+        return; // nothing has been written
+    }
+    // The frame index range of the audio source shrinks if reading fails,
+    // e.g. for a damaged file or an I/O error. A truncated cache file would
+    // be used instead of the original file forever, so it is only committed
+    // if all frames have been written.
+    if (m_nextFrameIndex < m_frameIndexEnd) {
+        kLogger.debug() << "Discarding truncated cache file" << m_file.fileName()
+                        << m_nextFrameIndex << "<" << m_frameIndexEnd;
+        m_file.cancelWriting();
+        return;
+    }
+    if (m_nextFrameIndex <= m_pAudioSource->frameIndexMin() ||
+            !writeHeader() || !m_file.commit()) {
+        m_file.cancelWriting();
+        return;
+    }
+    if (m_decoding) {
+        m_pAudioSource->close();
+    }
+    kLogger.debug() << "Cached decoded samples in" << m_file.fileName();
+    m_pCache->evict(m_file.fileName());
+}
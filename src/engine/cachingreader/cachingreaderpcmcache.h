@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QSaveFile>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+#include "audio/types.h"
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+#include "util/samplebuffer.h"
+
+// An optional on-disk cache of decoded PCM data for repeated track loads.
+//
+// A cache file contains a small header followed by the interleaved float
+// samples of the whole track, exactly as they have been decoded. On a cache
+// hit the CachingReaderWorker reads the samples from a memory mapping of the
+// cache file instead of decoding the original file again. This makes loading
+// and seeking in tracks with expensive codecs like AAC or Opus almost free.
+//
+// Cache files are written incrementally by a Writer while the worker is idle.
+// The least recently used files are evicted when the configured size limit is
+// exceeded. The CachingReaderWorker and the AnalyzerThread share a cache, so
+// the samples that are decoded for analyzing a loaded track are written into
+// the cache file instead of decoding the track a second time.
+class CachingReaderPcmCache final {
+  public:
+    // Writes the decoded samples of a track into a new cache file. The file
+    // only becomes visible in the cache after all samples have been written.
+    //
+    // A Writer either decodes the track with its own decoder in batches or
+    // is fed with the samples that are decoded by its owner. At most one
+    // Writer is fed per file, and a fed Writer supersedes any Writer that
+    // decodes the same track.
+    class Writer final {
+      public:
+        ~Writer();
+
+        // Decodes and writes the next batch of samples. Returns false when
+        // there is nothing left to do, either because the file has been
+        // completed, because an error occurred or because the Writer has
+        // been superseded.
+        bool writeNext();
+
+        // Writes the next decoded samples of a fed Writer. The frames must
+        // follow the previously written frames without any gaps. Returns
+        // false if an error occurred.
+        bool append(const mixxx::ReadableSampleFrames& sampleFrames);
+
+        // Completes the cache file of a fed Writer. The file is discarded if
+        // not all frames of the track have been fed.
+        void finish();
+
+      private:
+        friend class CachingReaderPcmCache;
+        Writer(CachingReaderPcmCache* pCache,
+                mixxx::AudioSourcePointer pAudioSource,
+                const QString& fileName,
+                bool decoding);
+
+        bool open();
+        bool writeHeader();
+        bool writeSamples(const mixxx::ReadableSampleFrames& sampleFrames);
+
+        CachingReaderPcmCache* const m_pCache;
+        const mixxx::AudioSourcePointer m_pAudioSource;
+        const bool m_decoding;
+        QSaveFile m_file;
+        mixxx::SampleBuffer m_buffer;
+        SINT m_nextFrameIndex;
+        // The end of the frame index range when writing started
+        const SINT m_frameIndexEnd;
+        bool m_done;
+        std::atomic<bool> m_superseded;
+    };
+
+    // Returns nullptr if the cache is disabled in the settings.
+    static std::shared_ptr<CachingReaderPcmCache> create(
+            const UserSettingsPointer& pConfig);
+
+    CachingReaderPcmCache(
+            const QString& directory,
+            qint64 maxSizeBytes);
+
+    // Opens the cached samples of the track. Returns nullptr if the track
+    // has not been cached yet or if the cache file is outdated.
+    mixxx::AudioSourcePointer openAudioSource(
+            const TrackPointer& pTrack,
+            mixxx::audio::ChannelCount maxChannelCount);
+
+    // Creates a Writer that fills the cache for the track. Returns nullptr
+    // if the track could not be opened or if a fed Writer is already
+    // writing the same file.
+    std::unique_ptr<Writer> newWriter(
+            const TrackPointer& pTrack,
+            mixxx::audio::ChannelCount maxChannelCount);
+
+    // Creates a Writer that is fed with the samples of pAudioSource, which
+    // has been opened for the track with maxChannelCount by the caller.
+    // Returns nullptr if another fed Writer is already writing the same
+    // file.
+    std::unique_ptr<Writer> newFedWriter(
+            const TrackPointer& pTrack,
+            mixxx::audio::ChannelCount maxChannelCount,
+            mixxx::AudioSourcePointer pAudioSource);
+
+  private:
+    QString fileNameForTrack(
+            const TrackPointer& pTrack,
+            mixxx::audio::ChannelCount maxChannelCount) const;
+
+    // Deletes the least recently used files until the cache fits into
+    // the size limit again.
+    void evict(const QString& keepFileName);
+
+    const QString m_directory;
+    const qint64 m_maxSizeBytes;
+};
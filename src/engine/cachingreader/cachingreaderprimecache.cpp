@@ -0,0 +1,153 @@
+#include "engine/cachingreader/cachingreaderprimecache.h"
+
+#include <QtConcurrent>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderworker.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CachingReaderPrimeCache");
+
+} // anonymous namespace
+
+CachingReaderPrimeCache::CachedEntry::CachedEntry(
+        EntryPointer pEntry, MemoryAccount* pMemoryAccount)
+        : m_pEntry(std::move(pEntry)),
+          m_pMemoryAccount(pMemoryAccount),
+          m_bytes(static_cast<qint64>(m_pEntry->samples.size()) *
+                  static_cast<qint64>(sizeof(CSAMPLE))) {
+    m_pMemoryAccount->add(m_bytes);
+}
+
+CachingReaderPrimeCache::CachedEntry::~CachedEntry() {
+    m_pMemoryAccount->subtract(m_bytes);
+}
+
+CachingReaderPrimeCache::CachingReaderPrimeCache(int maxEntries)
+        : m_memoryAccount(QStringLiteral("CachingReaderPrimeCache")) {
+    // Each entry costs 1, the memory of an entry is bounded by
+    // kPrefetchSeconds
+    m_entries.setMaxCost(maxEntries);
+}
+
+// static
+CachingReaderPrimeCache& CachingReaderPrimeCache::instance() {
+    static CachingReaderPrimeCache s_instance;
+    return s_instance;
+}
+
+// static
+SINT CachingReaderPrimeCache::primeStartFrame(
+        const Track& track,
+        const mixxx::IndexRange& frameIndexRange) {
+    const auto mainCuePosition = track.getMainCuePosition();
+    if (mainCuePosition.isValid()) {
+        const auto mainCueFrame =
+                static_cast<SINT>(mainCuePosition.toLowerFrameBoundary().value());
+        if (frameIndexRange.containsIndex(mainCueFrame)) {
+            return mainCueFrame;
+        }
+    }
+    return frameIndexRange.start();
+}
+
+// static
+QString CachingReaderPrimeCache::cacheKey(
+        const QString& location,
+        mixxx::audio::ChannelCount maxChannelCount) {
+    return QString::number(maxChannelCount) + QChar('|') + location;
+}
+
+CachingReaderPrimeCache::EntryPointer CachingReaderPrimeCache::lookup(
+        const QString& location,
+        mixxx::audio::ChannelCount maxChannelCount) const {
+    const auto locker = lockMutex(&m_mutex);
+    const CachedEntry* pCachedEntry = m_entries.object(cacheKey(location, maxChannelCount));
+    return pCachedEntry ? pCachedEntry->entry() : nullptr;
+}
+
+void CachingReaderPrimeCache::insert(
+        const QString& location,
+        mixxx::audio::ChannelCount maxChannelCount,
+        EntryPointer pEntry) {
+    VERIFY_OR_DEBUG_ASSERT(pEntry) {
+        return;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    m_entries.insert(cacheKey(location, maxChannelCount),
+            new CachedEntry(std::move(pEntry), &m_memoryAccount));
+}
+
+int CachingReaderPrimeCache::size() const {
+    const auto locker = lockMutex(&m_mutex);
+    return static_cast<int>(m_entries.size());
+}
+
+void CachingReaderPrimeCache::prefetch(
+        const TrackPointer& pTrack,
+        mixxx::audio::ChannelCount maxChannelCount) {
+    VERIFY_OR_DEBUG_ASSERT(pTrack) {
+        return;
+    }
+    const QString key = cacheKey(pTrack->getLocation(), maxChannelCount);
+    {
+        const auto locker = lockMutex(&m_mutex);
+        if (m_entries.contains(key) || m_pendingKeys.contains(key)) {
+            return;
+        }
+        m_pendingKeys.insert(key);
+    }
+    QtConcurrent::run([this, pTrack, maxChannelCount, key] {
+        prefetchNow(pTrack, maxChannelCount, key);
+        const auto locker = lockMutex(&m_mutex);
+        m_pendingKeys.remove(key);
+    });
+}
+
+void CachingReaderPrimeCache::prefetchNow(
+        const TrackPointer& pTrack,
+        mixxx::audio::ChannelCount maxChannelCount,
+        const QString& key) {
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(maxChannelCount);
+    const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    if (!pAudioSource) {
+        return;
+    }
+    const auto signalInfo = pAudioSource->getSignalInfo();
+    const auto frameIndexRange = pAudioSource->frameIndexRange();
+    if (signalInfo.getChannelCount() > maxChannelCount || frameIndexRange.empty()) {
+        return;
+    }
+    const SINT startFrame = primeStartFrame(*pTrack, frameIndexRange);
+    const auto primedFrameIndexRange = intersect(frameIndexRange,
+            mixxx::IndexRange::forward(startFrame,
+                    static_cast<SINT>(signalInfo.getSampleRate().toDouble() *
+                            kPrefetchSeconds)));
+    if (primedFrameIndexRange.empty()) {
+        return;
+    }
+
+    const SINT chunkFrames = CachingReaderChunk::framesForFileType(pTrack->getType());
+    mixxx::SampleBuffer tempReadBuffer(signalInfo.frames2samples(chunkFrames));
+    auto pEntry = std::make_shared<Entry>();
+    if (!CachingReaderWorker::decodeFrames(pAudioSource,
+                primedFrameIndexRange,
+                chunkFrames,
+                &tempReadBuffer,
+                &pEntry->samples)) {
+        kLogger.debug() << "Failed to prefetch" << pTrack->getFileInfo();
+        return;
+    }
+    pEntry->signalInfo = signalInfo;
+    pEntry->frameIndexRange = primedFrameIndexRange;
+
+    const auto locker = lockMutex(&m_mutex);
+    m_entries.insert(key, new CachedEntry(std::move(pEntry), &m_memoryAccount));
+}
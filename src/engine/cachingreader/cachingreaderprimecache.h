@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QCache>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <memory>
+
+#include "audio/signalinfo.h"
+#include "track/track_decl.h"
+#include "util/indexrange.h"
+#include "util/memoryaccount.h"
+#include "util/samplebuffer.h"
+
+// A process-wide in-memory cache of the decoded frames at the main cue of
+// recently previewed tracks.
+//
+// Preview decks prime the tracks they load from this cache instead of
+// decoding them first, so playback starts right away when browsing the
+// library. The library prefetches the first seconds of the selected track
+// and its neighbors into the cache on a worker thread while the user is
+// still looking at them.
+//
+// All functions are thread-safe.
+class CachingReaderPrimeCache final {
+  public:
+    struct Entry {
+        // The signal of the audio source the samples have been decoded from
+        mixxx::audio::SignalInfo signalInfo;
+        mixxx::IndexRange frameIndexRange;
+        // Same layout as the samples of the chunks
+        mixxx::SampleBuffer samples;
+    };
+    using EntryPointer = std::shared_ptr<const Entry>;
+
+    static constexpr int kDefaultMaxEntries = 16;
+
+    // The duration that is prefetched from the main cue
+    static constexpr double kPrefetchSeconds = 4.0;
+
+    explicit CachingReaderPrimeCache(int maxEntries = kDefaultMaxEntries);
+
+    static CachingReaderPrimeCache& instance();
+
+    // The frame where priming starts, i.e. the main cue if it is within
+    // the given range and the start of the range otherwise.
+    static SINT primeStartFrame(
+            const Track& track,
+            const mixxx::IndexRange& frameIndexRange);
+
+    // Returns nullptr if nothing has been cached for the track.
+    EntryPointer lookup(
+            const QString& location,
+            mixxx::audio::ChannelCount maxChannelCount) const;
+    // Replaces any previous entry of the track.
+    void insert(
+            const QString& location,
+            mixxx::audio::ChannelCount maxChannelCount,
+            EntryPointer pEntry);
+
+    // Decodes the first seconds from the main cue of the track on a worker
+    // thread, unless they have been cached or are being prefetched already.
+    void prefetch(
+            const TrackPointer& pTrack,
+            mixxx::audio::ChannelCount maxChannelCount);
+
+    int size() const;
+
+  private:
+    // Accounts the memory of an entry while it is cached
+    class CachedEntry final {
+      public:
+        CachedEntry(EntryPointer pEntry, MemoryAccount* pMemoryAccount);
+        ~CachedEntry();
+
+        const EntryPointer& entry() const {
+            return m_pEntry;
+        }
+
+      private:
+        const EntryPointer m_pEntry;
+        MemoryAccount* const m_pMemoryAccount;
+        const qint64 m_bytes;
+    };
+
+    static QString cacheKey(
+            const QString& location,
+            mixxx::audio::ChannelCount maxChannelCount);
+
+    void prefetchNow(
+            const TrackPointer& pTrack,
+            mixxx::audio::ChannelCount maxChannelCount,
+            const QString& key);
+
+    MemoryAccount m_memoryAccount;
+
+    mutable QMutex m_mutex;
+    QCache<QString, CachedEntry> m_entries;
+    // The keys of the tracks that are being prefetched
+    QSet<QString> m_pendingKeys;
+};
@@ -2,16 +2,23 @@
 
 #include <QAtomicInt>
 #include <QtDebug>
+#include <algorithm>
+#include <cmath>
 
 #include "analyzer/analyzersilence.h"
+#include "engine/cachingreader/cachingreaderprimecache.h"
 #include "moc_cachingreaderworker.cpp"
+#include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/compatibility/qmutex.h"
+#include "util/counter.h"
 #include "util/event.h"
-#include "util/fifo.h"
 #include "util/logger.h"
+#include "util/performancetimer.h"
 #include "util/span.h"
+#include "util/statsmanager.h"
+#include "util/threadplacement.h"
 
 namespace {
 
@@ -20,17 +27,41 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// Tracks up to this duration are always decoded completely when loading
+// them, e.g. one-shot samples that must play instantly when triggered
+constexpr double kMaxShortTrackDurationSeconds = 1.0;
+
+// The number of chunks that are decoded around the main cue while loading
+// a track that is streamed
+constexpr SINT kNumPrimedChunks = 2;
+
+// Longer tracks are streamed in chunks even if all tracks should be
+// preloaded. Corresponds to 30 sec of stereo audio at 48 kHz or ~11 MB.
+constexpr SINT kMaxPreloadedSamples = 30 * 48000 * 2;
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
         const QString& group,
-        FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
-        mixxx::audio::ChannelCount maxSupportedChannel)
+        CachingReaderChunkReadRequestQueue* pChunkReadRequestFIFO,
+        ReaderStatusUpdateQueue* pReaderStatusFIFO,
+        mixxx::audio::ChannelCount maxSupportedChannel,
+        std::shared_ptr<CachingReaderPcmCache> pPcmCache)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
+          m_decodedBytesTag(QStringLiteral("CachingReader %1 decoded bytes").arg(m_group)),
+          m_decodeDurationTag(
+                  QStringLiteral("CachingReader %1 chunk decode duration").arg(m_group)),
+          m_readChunkName(FlightRecorder::instance().registerName(
+                  QStringLiteral("CachingReaderWorker %1 read chunk").arg(m_group))),
+          m_loadTrackName(FlightRecorder::instance().registerName(
+                  QStringLiteral("CachingReaderWorker %1 load track").arg(m_group))),
+          m_writePcmCacheName(FlightRecorder::instance().registerName(
+                  QStringLiteral("CachingReaderWorker %1 write PCM cache").arg(m_group))),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_pPcmCache(std::move(pPcmCache)),
+          m_chunkFrames(CachingReaderChunk::kDefaultFrames),
           m_maxSupportedChannel(maxSupportedChannel) {
 }
 
@@ -52,9 +83,29 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     }
 
     // Try to read the data required for the chunk from the audio source
+    const FlightRecorder::Scope flightRecorderScope(m_readChunkName);
+    const bool trackStats = StatsManager::s_bStatsManagerEnabled;
+    PerformanceTimer decodeTimer;
+    if (trackStats) {
+        decodeTimer.start();
+    }
     const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
             m_pAudioSource,
             mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    if (trackStats) {
+        // The histogram stores distinct values, so they are rounded to 0.1 ms
+        Stat::track(m_decodeDurationTag,
+                Stat::DURATION_MSEC,
+                Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN |
+                        Stat::MAX | Stat::HISTOGRAM),
+                std::round(decodeTimer.elapsed().toDoubleMillis() * 10) / 10);
+        Counter(m_decodedBytesTag)
+                .increment(static_cast<int>(
+                        CachingReaderChunk::frames2samples(
+                                bufferedFrameIndexRange.length(),
+                                m_pAudioSource->getSignalInfo().getChannelCount()) *
+                        sizeof(CSAMPLE)));
+    }
     DEBUG_ASSERT(!m_pAudioSource ||
             bufferedFrameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange()));
     // The readable frame range might have changed
@@ -107,10 +158,12 @@ void CachingReaderWorker::run() {
     const auto id = lastId.fetchAndAddRelaxed(1) + 1;
     QThread::currentThread()->setObjectName(
             QStringLiteral("CachingReaderWorker ") + QString::number(id));
+    FlightRecorder::instance().nameCurrentThread(QThread::currentThread()->objectName());
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::EngineWorker);
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
-        // Request is initialized by reading from FIFO
+        // Request is initialized by reading from the queue
         CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable.loadAcquire()) {
             TrackPointer pLoadTrack;
@@ -122,15 +175,30 @@ void CachingReaderWorker::run() {
             } // implicitly unlocks the mutex
             if (pLoadTrack) {
                 // in this case the engine is still running with the old track
+                const FlightRecorder::Scope flightRecorderScope(m_loadTrackName);
                 loadTrack(pLoadTrack);
             } else {
                 // here, the engine is already stopped
                 unloadTrack();
             }
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        } else if (readRequest(&request)) {
+            if (request.releaseSampleBuffer) {
+                // The cache is over its memory budget
+                request.chunk->releaseSampleBuffer();
+                const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
+                writeStatusUpdate(update);
+                continue;
+            }
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
-            m_pReaderStatusFIFO->writeBlocking(&update, 1);
+            writeStatusUpdate(update);
+        } else if (m_pPcmCacheWriter) {
+            // Use the idle time for filling the cache. Requests of the
+            // engine are checked again after each batch.
+            const FlightRecorder::Scope flightRecorderScope(m_writePcmCacheName);
+            if (!m_pPcmCacheWriter->writeNext()) {
+                m_pPcmCacheWriter.reset();
+            }
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -139,17 +207,42 @@ void CachingReaderWorker::run() {
     }
 }
 
+bool CachingReaderWorker::readRequest(CachingReaderChunkReadRequest* pRequest) {
+    const auto* pFront = m_pChunkReadRequestFIFO->front();
+    if (!pFront) {
+        return false;
+    }
+    *pRequest = *pFront;
+    m_pChunkReadRequestFIFO->pop();
+    return true;
+}
+
+void CachingReaderWorker::writeStatusUpdate(const ReaderStatusUpdate& update) {
+    // The capacity equals the number of chunks, so this only spins while
+    // the engine has not caught up with the updates yet.
+    while (!m_pReaderStatusFIFO->try_push(update)) {
+    }
+}
+
 void CachingReaderWorker::discardAllPendingRequests() {
     CachingReaderChunkReadRequest request;
-    while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+    while (readRequest(&request)) {
         const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
     }
 }
 
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
+    // Discards an incomplete cache file
+    m_pPcmCacheWriter.reset();
+
+    // The engine has been stopped and doesn't access the samples anymore
+    mixxx::SampleBuffer().swap(m_preloadedSamples);
+    mixxx::SampleBuffer().swap(m_primedSamples);
+    m_primedFrameIndexRange = mixxx::IndexRange();
+
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
         m_pAudioSource->close();
@@ -158,14 +251,33 @@ void CachingReaderWorker::closeAudioSource() {
 
     // This function has to be called with the engine stopped only
     // to avoid collecting new requests for the old track
-    DEBUG_ASSERT(!m_pChunkReadRequestFIFO->readAvailable());
+    DEBUG_ASSERT(m_pChunkReadRequestFIFO->empty());
 }
 
 void CachingReaderWorker::unloadTrack() {
     closeAudioSource();
 
     const auto update = ReaderStatusUpdate::trackUnloaded();
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    writeStatusUpdate(update);
+}
+
+mixxx::AudioSourcePointer CachingReaderWorker::openAudioSource(
+        const TrackPointer& pTrack, bool* pFromPcmCache) {
+    *pFromPcmCache = false;
+    if (m_pPcmCache) {
+        auto pAudioSource = m_pPcmCache->openAudioSource(pTrack, m_maxSupportedChannel);
+        if (pAudioSource) {
+            kLogger.debug()
+                    << m_group
+                    << "Reading decoded samples from cache"
+                    << pTrack->getFileInfo();
+            *pFromPcmCache = true;
+            return pAudioSource;
+        }
+    }
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(m_maxSupportedChannel);
+    return SoundSourceProxy(pTrack).openAudioSource(config);
 }
 
 void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
@@ -181,23 +293,22 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << "File not found"
                 << pTrack->getFileInfo();
         const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be found.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
         return;
     }
 
-    mixxx::AudioSource::OpenParams config;
-    config.setChannelCount(m_maxSupportedChannel);
-    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    bool fromPcmCache = false;
+    m_pAudioSource = openAudioSource(pTrack, &fromPcmCache);
     if (!m_pAudioSource) {
         kLogger.warning()
                 << m_group
                 << "Failed to open file"
                 << pTrack->getFileInfo();
         const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -212,7 +323,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                     m_maxSupportedChannel) {
         m_pAudioSource.reset(); // Close open file handles
         const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be loaded because it contains %2 "
                    "channels, and only 1 to %3 are supported.")
@@ -233,25 +344,44 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << "Failed to open empty file"
                 << pTrack->getFileInfo();
         const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' is empty and could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
         return;
     }
 
+    m_chunkFrames = CachingReaderChunk::framesForFileType(pTrack->getType());
+
     // Adjust the internal buffer
     const SINT tempReadBufferSize =
-            m_pAudioSource->getSignalInfo().frames2samples(
-                    CachingReaderChunk::kFrames);
+            m_pAudioSource->getSignalInfo().frames2samples(m_chunkFrames);
     if (m_tempReadBuffer.size() != tempReadBufferSize) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
+    const bool preloaded = preloadTrack();
+    if (!preloaded) {
+        // Decoding the first frames right away saves the round trip of
+        // requesting them as a chunk in the first callback
+        primeMainCue(pTrack);
+    }
+
+    if (m_pPcmCache && !fromPcmCache) {
+        // Decode the file a second time in the background while the
+        // worker is idle, so the next load of this track is served
+        // from the cache.
+        m_pPcmCacheWriter = m_pPcmCache->newWriter(pTrack, m_maxSupportedChannel);
+    }
+
     const auto update =
             ReaderStatusUpdate::trackLoaded(
-                    m_pAudioSource->frameIndexRange());
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+                    m_pAudioSource->frameIndexRange(),
+                    m_chunkFrames,
+                    preloaded ? m_preloadedSamples.data() : nullptr,
+                    m_primedFrameIndexRange,
+                    m_primedSamples.size() > 0 ? m_primedSamples.data() : nullptr);
+    writeStatusUpdate(update);
 
     // Emit that the track is loaded.
 
@@ -265,7 +395,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 
     // The engine must not request any chunks before receiving the
     // trackLoaded() signal
-    DEBUG_ASSERT(!m_pChunkReadRequestFIFO->readAvailable());
+    DEBUG_ASSERT(m_pChunkReadRequestFIFO->empty());
 
     emit trackLoaded(
             pTrack,
@@ -274,6 +404,152 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             mixxx::audio::FramePos(m_pAudioSource->frameLength()));
 }
 
+bool CachingReaderWorker::preloadTrack() {
+    DEBUG_ASSERT(m_pAudioSource);
+    DEBUG_ASSERT(m_preloadedSamples.size() == 0);
+    const auto signalInfo = m_pAudioSource->getSignalInfo();
+    const auto frameIndexRange = m_pAudioSource->frameIndexRange();
+    const bool shortTrack = frameIndexRange.length() <=
+            signalInfo.getSampleRate().toDouble() * kMaxShortTrackDurationSeconds;
+    if (!shortTrack && !m_preloadAllTracks.loadAcquire()) {
+        return false;
+    }
+    if (!decodeFrames(frameIndexRange, &m_preloadedSamples)) {
+        kLogger.warning()
+                << m_group
+                << "Failed to preload sample frames"
+                << frameIndexRange
+                << "- streaming the track instead";
+        return false;
+    }
+    kLogger.debug()
+            << m_group
+            << "Preloaded"
+            << frameIndexRange.length()
+            << "frames";
+    return true;
+}
+
+void CachingReaderWorker::primeMainCue(const TrackPointer& pTrack) {
+    DEBUG_ASSERT(m_pAudioSource);
+    DEBUG_ASSERT(m_primedSamples.size() == 0);
+    const auto frameIndexRange = m_pAudioSource->frameIndexRange();
+    const SINT startFrame =
+            CachingReaderPrimeCache::primeStartFrame(*pTrack, frameIndexRange);
+    const bool previewMode = m_previewMode.loadAcquire();
+    if (previewMode && primeMainCueFromCache(pTrack, startFrame)) {
+        return;
+    }
+    const auto primedFrameIndexRange = intersect(frameIndexRange,
+            mixxx::IndexRange::forward(startFrame, kNumPrimedChunks * m_chunkFrames));
+    if (primedFrameIndexRange.empty()) {
+        return;
+    }
+    if (!decodeFrames(primedFrameIndexRange, &m_primedSamples)) {
+        // The frames are read again as chunks
+        return;
+    }
+    m_primedFrameIndexRange = primedFrameIndexRange;
+    if (previewMode) {
+        auto pEntry = std::make_shared<CachingReaderPrimeCache::Entry>();
+        pEntry->signalInfo = m_pAudioSource->getSignalInfo();
+        pEntry->frameIndexRange = m_primedFrameIndexRange;
+        mixxx::SampleBuffer(m_primedSamples.size()).swap(pEntry->samples);
+        pEntry->samples.copy(m_primedSamples);
+        CachingReaderPrimeCache::instance().insert(
+                pTrack->getLocation(), m_maxSupportedChannel, std::move(pEntry));
+    }
+}
+
+bool CachingReaderWorker::primeMainCueFromCache(
+        const TrackPointer& pTrack, SINT startFrame) {
+    const auto pEntry = CachingReaderPrimeCache::instance().lookup(
+            pTrack->getLocation(), m_maxSupportedChannel);
+    if (!pEntry) {
+        return false;
+    }
+    // The file might have been replaced since it has been cached
+    if (pEntry->signalInfo != m_pAudioSource->getSignalInfo() ||
+            pEntry->frameIndexRange.start() != startFrame ||
+            !pEntry->frameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange())) {
+        return false;
+    }
+    mixxx::SampleBuffer(pEntry->samples.size()).swap(m_primedSamples);
+    m_primedSamples.copy(pEntry->samples);
+    m_primedFrameIndexRange = pEntry->frameIndexRange;
+    kLogger.debug()
+            << m_group
+            << "Primed"
+            << m_primedFrameIndexRange.length()
+            << "frames from cache";
+    return true;
+}
+
+bool CachingReaderWorker::decodeFrames(const mixxx::IndexRange& frameIndexRange,
+        mixxx::SampleBuffer* pSamples) {
+    return decodeFrames(m_pAudioSource,
+            frameIndexRange,
+            m_chunkFrames,
+            &m_tempReadBuffer,
+            pSamples);
+}
+
+// static
+bool CachingReaderWorker::decodeFrames(
+        const mixxx::AudioSourcePointer& pSourceAudioSource,
+        const mixxx::IndexRange& frameIndexRange,
+        SINT chunkFrames,
+        mixxx::SampleBuffer* pTempReadBuffer,
+        mixxx::SampleBuffer* pSamples) {
+    // Same layout as the samples of the chunks, see
+    // CachingReaderChunk::bufferSampleFrames()
+    const auto signalInfo = pSourceAudioSource->getSignalInfo();
+    const bool readAsStereo = signalInfo.getChannelCount() %
+                    mixxx::audio::ChannelCount::stereo() !=
+            0;
+    const auto channelCount = readAsStereo
+            ? mixxx::audio::ChannelCount::stereo()
+            : signalInfo.getChannelCount();
+    const SINT sampleCount = CachingReaderChunk::frames2samples(
+            frameIndexRange.length(), channelCount);
+    if (sampleCount > kMaxPreloadedSamples) {
+        return false;
+    }
+
+    mixxx::SampleBuffer(sampleCount).swap(*pSamples);
+    // The decoded samples are used regardless of the selected stems
+    pSourceAudioSource->selectChannelPairs(mixxx::AudioSource::kAllChannelPairs);
+    mixxx::AudioSourcePointer pAudioSource = pSourceAudioSource;
+    if (readAsStereo) {
+        pAudioSource = std::make_shared<mixxx::AudioSourceStereoProxy>(
+                pSourceAudioSource,
+                mixxx::SampleBuffer::WritableSlice(*pTempReadBuffer));
+    }
+    // Read in chunks that fit into the temporary buffer
+    SINT frameIndex = frameIndexRange.start();
+    while (frameIndex < frameIndexRange.end()) {
+        const auto readFrameIndexRange = mixxx::IndexRange::between(frameIndex,
+                std::min(frameIndex + chunkFrames, frameIndexRange.end()));
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readFrameIndexRange,
+                        mixxx::SampleBuffer::WritableSlice(
+                                pSamples->data(
+                                        CachingReaderChunk::frames2samples(
+                                                frameIndex - frameIndexRange.start(),
+                                                channelCount)),
+                                CachingReaderChunk::frames2samples(
+                                        readFrameIndexRange.length(),
+                                        channelCount))));
+        if (readableSampleFrames.frameIndexRange() != readFrameIndexRange) {
+            mixxx::SampleBuffer().swap(*pSamples);
+            return false;
+        }
+        frameIndex = readFrameIndexRange.end();
+    }
+    return true;
+}
+
 void CachingReaderWorker::quitWait() {
     m_stop = 1;
     m_semaRun.release();
@@ -286,10 +562,10 @@ void CachingReaderWorker::verifyFirstSound(const CachingReaderChunk* pChunk,
         return;
     }
 
+    const auto firstSoundFrame = static_cast<SINT>(
+            m_firstSoundFrameToVerify.toLowerFrameBoundary().value());
     const int firstSoundIndex =
-            CachingReaderChunk::indexForFrame(static_cast<SINT>(
-                    m_firstSoundFrameToVerify.toLowerFrameBoundary()
-                            .value()));
+            CachingReaderChunk::indexForFrame(firstSoundFrame, pChunk->getFrames());
     if (pChunk->getIndex() == firstSoundIndex) {
         mixxx::SampleBuffer sampleBuffer(kNumSoundFrameToVerify * channelCount);
         SINT end = static_cast<SINT>(m_firstSoundFrameToVerify.toLowerFrameBoundary().value());
@@ -2,26 +2,35 @@
 
 #include <QMutex>
 #include <QString>
+#include <memory>
 
 #include "audio/frame.h"
 #include "audio/types.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderpcmcache.h"
 #include "engine/engineworker.h"
+#include "rigtorp/SPSCQueue.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
+#include "util/flightrecorder.h"
 
-template<class DataType>
-class FIFO;
-
-// POD with trivial ctor/dtor/copy for passing through FIFO
+// POD with trivial ctor/dtor/copy for passing through the queue
 typedef struct CachingReaderChunkReadRequest {
     CachingReaderChunk* chunk;
+    // Release the sample memory of the chunk instead of reading it
+    bool releaseSampleBuffer;
 
     void giveToWorker(CachingReaderChunkForOwner* chunkForOwner) {
         DEBUG_ASSERT(chunkForOwner);
         chunk = chunkForOwner;
+        releaseSampleBuffer = false;
         chunkForOwner->giveToWorker();
     }
+
+    void giveToWorkerForRelease(CachingReaderChunkForOwner* chunkForOwner) {
+        giveToWorker(chunkForOwner);
+        releaseSampleBuffer = true;
+    }
 } CachingReaderChunkReadRequest;
 
 enum ReaderStatus {
@@ -33,12 +42,17 @@ enum ReaderStatus {
     CHUNK_READ_DISCARDED, // response without frame index range!
 };
 
-// POD with trivial ctor/dtor/copy for passing through FIFO
+// POD with trivial ctor/dtor/copy for passing through the queue
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
+    SINT chunkFrames;
+    const CSAMPLE* preloadedSamples;
+    const CSAMPLE* primedSamples;
+    SINT primedFrameIndexRangeStart;
+    SINT primedFrameIndexRangeEnd;
 
   public:
     ReaderStatus status;
@@ -51,6 +65,11 @@ typedef struct ReaderStatusUpdate {
         chunk = chunkArg;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
+        chunkFrames = 0;
+        preloadedSamples = nullptr;
+        primedSamples = nullptr;
+        primedFrameIndexRangeStart = 0;
+        primedFrameIndexRangeEnd = 0;
     }
 
     static ReaderStatusUpdate readDiscarded(
@@ -61,10 +80,20 @@ typedef struct ReaderStatusUpdate {
     }
 
     static ReaderStatusUpdate trackLoaded(
-            const mixxx::IndexRange& readableFrameIndexRange) {
+            const mixxx::IndexRange& readableFrameIndexRange,
+            SINT chunkFramesArg,
+            const CSAMPLE* preloadedSamplesArg,
+            const mixxx::IndexRange& primedFrameIndexRangeArg,
+            const CSAMPLE* primedSamplesArg) {
         DEBUG_ASSERT(!readableFrameIndexRange.empty());
+        DEBUG_ASSERT(chunkFramesArg > 0);
         ReaderStatusUpdate update;
         update.init(TRACK_LOADED, nullptr, readableFrameIndexRange);
+        update.chunkFrames = chunkFramesArg;
+        update.preloadedSamples = preloadedSamplesArg;
+        update.primedSamples = primedSamplesArg;
+        update.primedFrameIndexRangeStart = primedFrameIndexRangeArg.start();
+        update.primedFrameIndexRangeEnd = primedFrameIndexRangeArg.end();
         return update;
     }
 
@@ -90,28 +119,85 @@ typedef struct ReaderStatusUpdate {
                 readableFrameIndexRangeStart,
                 readableFrameIndexRangeEnd);
     }
+
+    // The number of frames per chunk of a loaded track
+    SINT loadedChunkFrames() const {
+        DEBUG_ASSERT(status == TRACK_LOADED);
+        return chunkFrames;
+    }
+
+    // The samples of the whole readable frame index range of a loaded
+    // track if it has been preloaded, otherwise nullptr. The memory is
+    // owned by the worker and remains valid until the next track is
+    // loaded or the track is unloaded.
+    const CSAMPLE* loadedPreloadedSamples() const {
+        DEBUG_ASSERT(status == TRACK_LOADED);
+        return preloadedSamples;
+    }
+
+    // The samples that have been decoded around the main cue of a loaded
+    // track while loading it, so the first callbacks don't need to wait
+    // for a chunk. Otherwise nullptr. The lifetime is the same as for
+    // the preloaded samples.
+    const CSAMPLE* loadedPrimedSamples() const {
+        DEBUG_ASSERT(status == TRACK_LOADED);
+        return primedSamples;
+    }
+    mixxx::IndexRange loadedPrimedFrameIndexRange() const {
+        DEBUG_ASSERT(status == TRACK_LOADED);
+        return mixxx::IndexRange::between(
+                primedFrameIndexRangeStart,
+                primedFrameIndexRangeEnd);
+    }
 } ReaderStatusUpdate;
 
+using CachingReaderChunkReadRequestQueue = rigtorp::SPSCQueue<CachingReaderChunkReadRequest>;
+using ReaderStatusUpdateQueue = rigtorp::SPSCQueue<ReaderStatusUpdate>;
+
 class CachingReaderWorker : public EngineWorker {
     Q_OBJECT
 
   public:
     // Construct a CachingReader with the given group.
     CachingReaderWorker(const QString& group,
-            FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
-            mixxx::audio::ChannelCount maxSupportedChannel);
+            CachingReaderChunkReadRequestQueue* pChunkReadRequestFIFO,
+            ReaderStatusUpdateQueue* pReaderStatusFIFO,
+            mixxx::audio::ChannelCount maxSupportedChannel,
+            std::shared_ptr<CachingReaderPcmCache> pPcmCache = nullptr);
     ~CachingReaderWorker() override = default;
 
     // Request to load a new track. wake() must be called afterwards.
     void newTrack(TrackPointer pTrack);
 
+    // Decode all tracks completely when loading them, not only short
+    // tracks. Thread-safe, affects the next track that is loaded.
+    void setPreloadAllTracks(bool preloadAllTracks) {
+        m_preloadAllTracks.storeRelease(preloadAllTracks ? 1 : 0);
+    }
+
+    // Prime the loaded tracks from the CachingReaderPrimeCache and keep the
+    // primed frames there for reloading them, e.g. for preview decks.
+    // Thread-safe, affects the next track that is loaded.
+    void setPreviewMode(bool previewMode) {
+        m_previewMode.storeRelease(previewMode ? 1 : 0);
+    }
+
     // Run upkeep operations like loading tracks and reading from file. Run by a
     // thread pool via the EngineWorkerScheduler.
     void run() override;
 
     void quitWait();
 
+    /// Decodes the frames of the audio source into the buffer with the
+    /// layout of the chunks. The temporary buffer must hold the samples
+    /// of chunkFrames frames with all channels of the source. Returns
+    /// false on failure.
+    static bool decodeFrames(const mixxx::AudioSourcePointer& pSourceAudioSource,
+            const mixxx::IndexRange& frameIndexRange,
+            SINT chunkFrames,
+            mixxx::SampleBuffer* pTempReadBuffer,
+            mixxx::SampleBuffer* pSamples);
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -125,10 +211,18 @@ class CachingReaderWorker : public EngineWorker {
     const QString m_group;
     QString m_tag;
 
+    // The tags of the per-deck stats, see CachingReader
+    const QString m_decodedBytesTag;
+    const QString m_decodeDurationTag;
+
+    const FlightRecorder::NameId m_readChunkName;
+    const FlightRecorder::NameId m_loadTrackName;
+    const FlightRecorder::NameId m_writePcmCacheName;
+
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
-    FIFO<CachingReaderChunkReadRequest>* m_pChunkReadRequestFIFO;
-    FIFO<ReaderStatusUpdate>* m_pReaderStatusFIFO;
+    CachingReaderChunkReadRequestQueue* m_pChunkReadRequestFIFO;
+    ReaderStatusUpdateQueue* m_pReaderStatusFIFO;
 
     // Queue of Tracks to load, and the corresponding lock. Must acquire the
     // lock to touch.
@@ -137,6 +231,8 @@ class CachingReaderWorker : public EngineWorker {
     TrackPointer m_pNewTrack;
 
     void discardAllPendingRequests();
+    bool readRequest(CachingReaderChunkReadRequest* pRequest);
+    void writeStatusUpdate(const ReaderStatusUpdate& update);
 
     /// call to be prepare for new tracks
     /// Make sure engine has been stopped before
@@ -152,14 +248,45 @@ class CachingReaderWorker : public EngineWorker {
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    /// Decodes the whole track into m_preloadedSamples if the preload
+    /// policy applies. Returns false if the track should be streamed
+    /// in chunks instead.
+    bool preloadTrack();
+
+    /// Decodes the frames around the main cue of the track into
+    /// m_primedSamples, where the deck most likely starts playing.
+    void primeMainCue(const TrackPointer& pTrack);
+
+    /// Copies the frames from the main cue of the track into
+    /// m_primedSamples if they have been cached. Returns false otherwise.
+    bool primeMainCueFromCache(const TrackPointer& pTrack, SINT startFrame);
+
+    /// Decodes the frames into the buffer with the layout of the chunks.
+    /// Returns false on failure.
+    bool decodeFrames(const mixxx::IndexRange& frameIndexRange,
+            mixxx::SampleBuffer* pSamples);
+
     void verifyFirstSound(const CachingReaderChunk* pChunk,
             mixxx::audio::ChannelCount channelCount);
 
+    /// Opens the audio source of the track, either from the PCM cache
+    /// or by decoding the file.
+    mixxx::AudioSourcePointer openAudioSource(
+            const TrackPointer& pTrack, bool* pFromPcmCache);
+
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
+    // The optional cache of decoded samples, nullptr if disabled
+    const std::shared_ptr<CachingReaderPcmCache> m_pPcmCache;
+    // Fills the cache for the loaded track while the worker is idle
+    std::unique_ptr<CachingReaderPcmCache::Writer> m_pPcmCacheWriter;
+
     mixxx::audio::FramePos m_firstSoundFrameToVerify;
 
+    // The number of frames per chunk of the loaded track
+    SINT m_chunkFrames;
+
     // Temporary buffer for reading samples from all channels
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
@@ -167,5 +294,16 @@ class CachingReaderWorker : public EngineWorker {
     // The maximum number of channel that this reader can support
     mixxx::audio::ChannelCount m_maxSupportedChannel;
 
+    // The samples of the loaded track if it has been decoded completely,
+    // empty otherwise. Not accounted for in the chunk memory budget.
+    mixxx::SampleBuffer m_preloadedSamples;
+    QAtomicInt m_preloadAllTracks;
+
+    // The samples around the main cue of the loaded track if it has not
+    // been preloaded, empty otherwise.
+    mixxx::SampleBuffer m_primedSamples;
+    mixxx::IndexRange m_primedFrameIndexRange;
+    QAtomicInt m_previewMode;
+
     QAtomicInt m_stop;
 };
@@ -16,14 +16,20 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
     // Signal flow overview:
     // 1. Clear pOutput buffer
     // 2. Calculate gains for each channel
-    // 3. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
+    // 3. Pass each channel with active post-fader effects, its calculated gain
+    //    and input buffer to pEngineEffectsManager, which then:
     //     A) Copies each channel input buffer to a temporary buffer
     //     B) Applies gain to the temporary buffer
     //     C) Processes effects on the temporary buffer
     //     D) Mixes the temporary buffer into pOutput
+    // 4. Mix all channels without post-fader effects with their ramping gains
+    //    into pOutput in a single pass.
     // The original channel input buffers are not modified.
     SampleUtil::clear(pOutput, iBufferSize);
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsAndMixChannels"));
+    QVarLengthArray<const CSAMPLE*, kPreallocatedChannels> bypassedBuffers;
+    QVarLengthArray<CSAMPLE_GAIN, kPreallocatedChannels> bypassedOldGains;
+    QVarLengthArray<CSAMPLE_GAIN, kPreallocatedChannels> bypassedNewGains;
     for (auto* pChannelInfo : activeChannels) {
         EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
         CSAMPLE_GAIN oldGain = gainCache.m_gain;
@@ -38,6 +44,14 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
             newGain = gainCalculator.getGain(pChannelInfo);
         }
         gainCache.m_gain = newGain;
+        if (pEngineEffectsManager->bypassPostFader(pChannelInfo->m_handle, outputHandle)) {
+            if (oldGain != CSAMPLE_GAIN_ZERO || newGain != CSAMPLE_GAIN_ZERO) {
+                bypassedBuffers.append(pChannelInfo->m_pBuffer.data());
+                bypassedOldGains.append(oldGain);
+                bypassedNewGains.append(newGain);
+            }
+            continue;
+        }
         pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
                 outputHandle,
                 pChannelInfo->m_pBuffer.data(),
@@ -49,6 +63,12 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
                 newGain,
                 fadeout);
     }
+    SampleUtil::addMultipleWithRampingGain(pOutput,
+            bypassedBuffers.constData(),
+            bypassedOldGains.constData(),
+            bypassedNewGains.constData(),
+            static_cast<int>(bypassedBuffers.size()),
+            iBufferSize);
 }
 
 void ChannelMixer::applyEffectsInPlaceAndMixChannels(
@@ -18,7 +18,9 @@ EngineChannel::EngineChannel(const ChannelHandleAndGroup& handleGroup,
           m_bIsPrimaryDeck(isPrimaryDeck),
           m_active(false),
           m_bIsTalkoverChannel(isTalkoverChannel),
-          m_channelIndex(-1) {
+          m_channelIndex(-1),
+          m_profilerStage(CallbackProfiler::instance().registerStage(
+                  QStringLiteral("EngineChannel ") + getGroup())) {
     m_pPFL = new ControlPushButton(ConfigKey(getGroup(), "pfl"));
     m_pPFL->setButtonMode(ControlPushButton::TOGGLE);
     m_pMainMix = new ControlPushButton(ConfigKey(getGroup(), "main_mix"));
@@ -4,6 +4,7 @@
 #include "engine/channelhandle.h"
 #include "engine/engineobject.h"
 #include "engine/enginevumeter.h"
+#include "util/callbackprofiler.h"
 
 class EffectsManager;
 class EngineBuffer;
@@ -56,6 +57,11 @@ class EngineChannel : public EngineObject {
     inline bool isPrimaryDeck() {
         return m_bIsPrimaryDeck;
     };
+    /// The stage of this channel in the CallbackProfiler
+    CallbackProfiler::StageId profilerStage() const {
+        return m_profilerStage;
+    }
+
     int getChannelIndex() {
         return m_channelIndex;
     }
@@ -103,4 +109,5 @@ class EngineChannel : public EngineObject {
     ControlPushButton* m_pTalkover;
     bool m_bIsTalkoverChannel;
     int m_channelIndex;
+    const CallbackProfiler::StageId m_profilerStage;
 };
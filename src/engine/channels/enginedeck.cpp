@@ -1,5 +1,8 @@
 #include "engine/channels/enginedeck.h"
 
+#include <algorithm>
+
+#include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
 #include "effects/effectsmanager.h"
 #include "engine/effects/engineeffectsmanager.h"
@@ -7,8 +10,19 @@
 #include "engine/enginepregain.h"
 #include "engine/enginevumeter.h"
 #include "moc_enginedeck.cpp"
+#include "sources/audiosource.h"
 #include "util/sample.h"
 
+namespace {
+
+QString groupForStem(const QString& deckGroup, int stemIdx) {
+    DEBUG_ASSERT(deckGroup.endsWith(QChar(']')));
+    return deckGroup.left(deckGroup.size() - 1) +
+            QStringLiteral("Stem%1]").arg(stemIdx + 1);
+}
+
+} // anonymous namespace
+
 EngineDeck::EngineDeck(
         const ChannelHandleAndGroup& handleGroup,
         UserSettingsPointer pConfig,
@@ -21,7 +35,9 @@ EngineDeck::EngineDeck(
                   primaryDeck),
           m_pConfig(pConfig),
           m_pInputConfigured(new ControlObject(ConfigKey(getGroup(), "input_configured"))),
-          m_pPassing(new ControlPushButton(ConfigKey(getGroup(), "passthrough"))) {
+          m_pPassing(new ControlPushButton(ConfigKey(getGroup(), "passthrough"))),
+          m_pEffectsFreeze(std::make_unique<ControlPushButton>(
+                  ConfigKey(getGroup(), QStringLiteral("effects_freeze")))) {
     m_pInputConfigured->setReadOnly();
     // Set up passthrough utilities and fields
     m_pPassing->setButtonMode(ControlPushButton::POWERWINDOW);
@@ -34,6 +50,13 @@ EngineDeck::EngineDeck(
             &EngineDeck::slotPassthroughChangeRequest,
             Qt::DirectConnection);
 
+    // The cache is allocated in the main thread
+    m_pEffectsFreeze->setButtonMode(ControlPushButton::TOGGLE);
+    connect(m_pEffectsFreeze.get(),
+            &ControlObject::valueChanged,
+            this,
+            &EngineDeck::slotEffectsFreezeToggle);
+
     m_pPregain = new EnginePregain(getGroup());
     m_pBuffer = new EngineBuffer(getGroup(),
             pConfig,
@@ -41,6 +64,22 @@ EngineDeck::EngineDeck(
             pMixingEngine,
             primaryDeck ? mixxx::audio::ChannelCount::stem()
                         : mixxx::audio::ChannelCount::stereo());
+
+    m_stemGainOld.fill(CSAMPLE_GAIN_ONE);
+    if (primaryDeck) {
+        for (std::size_t stemIdx = 0; stemIdx < m_stemGainOld.size(); ++stemIdx) {
+            const QString stemGroup = groupForStem(getGroup(), static_cast<int>(stemIdx));
+            auto pGain = std::make_unique<ControlPotmeter>(
+                    ConfigKey(stemGroup, QStringLiteral("volume")));
+            pGain->setDefaultValue(1.0);
+            pGain->set(1.0);
+            m_stemGain.push_back(std::move(pGain));
+            auto pMute = std::make_unique<ControlPushButton>(
+                    ConfigKey(stemGroup, QStringLiteral("mute")));
+            pMute->setButtonMode(ControlPushButton::TOGGLE);
+            m_stemMute.push_back(std::move(pMute));
+        }
+    }
 }
 
 EngineDeck::~EngineDeck() {
@@ -50,25 +89,61 @@ EngineDeck::~EngineDeck() {
 }
 
 void EngineDeck::processStem(CSAMPLE* pOut, const int iBufferSize) {
-    int stereoChannelCount = m_pBuffer->getChannelCount() / mixxx::kEngineChannelOutputCount;
+    const mixxx::audio::ChannelCount channelCount = m_pBuffer->getChannelCount();
+    const int stereoChannelCount = channelCount / mixxx::kEngineChannelOutputCount;
     auto allChannelBufferSize = iBufferSize * stereoChannelCount;
     if (m_stemBuffer.size() < allChannelBufferSize) {
         m_stemBuffer = mixxx::SampleBuffer(allChannelBufferSize);
     }
+    // Read the stem controls once per buffer
+    decltype(m_stemGainOld) stemGainNew;
+    DEBUG_ASSERT(stereoChannelCount <= static_cast<int>(stemGainNew.size()));
+    std::uint32_t activeStems = 0;
+    bool stemsUnchanged = true;
+    for (int stemIdx = 0; stemIdx < stereoChannelCount; ++stemIdx) {
+        if (stemIdx >= static_cast<int>(m_stemGain.size())) {
+            stemGainNew[stemIdx] = CSAMPLE_GAIN_ONE;
+        } else if (m_stemMute[stemIdx]->toBool()) {
+            stemGainNew[stemIdx] = CSAMPLE_GAIN_ZERO;
+        } else {
+            stemGainNew[stemIdx] = static_cast<CSAMPLE_GAIN>(m_stemGain[stemIdx]->get());
+        }
+        if (stemGainNew[stemIdx] != CSAMPLE_GAIN_ZERO ||
+                m_stemGainOld[stemIdx] != CSAMPLE_GAIN_ZERO) {
+            activeStems |= 1u << stemIdx;
+        }
+        if (stemGainNew[stemIdx] != CSAMPLE_GAIN_ONE ||
+                m_stemGainOld[stemIdx] != CSAMPLE_GAIN_ONE) {
+            stemsUnchanged = false;
+        }
+    }
+
+    // As long as no stem control has been touched the sum of all stems
+    // equals the main mix. Then only the main mix is decoded into the
+    // first stem and the other stems are silent. Otherwise only the
+    // audible stems are decoded.
+    m_pBuffer->setDecodedChannelPairs(stemsUnchanged
+                    ? mixxx::AudioSource::kPremixedChannelPairs
+                    : activeStems);
+    // All stems are decoded together, because they are interleaved in the
+    // same frames. Stems that are silent during the whole buffer are not
+    // time stretched.
+    m_pBuffer->setActiveChannelPairs(activeStems);
     m_pBuffer->process(m_stemBuffer.data(), allChannelBufferSize);
 
     // TODO(XXX): process effects per stems
 
-    SampleUtil::clear(pOut, iBufferSize);
-    const CSAMPLE* pIn = m_stemBuffer.data();
-    for (int i = 0; i < iBufferSize; i += mixxx::kEngineChannelOutputCount) {
-        for (int chIdx = 0; chIdx < m_pBuffer->getChannelCount();
-                chIdx += mixxx::kEngineChannelOutputCount) {
-            // TODO(XXX): apply stem gain or skip muted stem
-            pOut[i] += pIn[stereoChannelCount * i + chIdx];
-            pOut[i + 1] += pIn[stereoChannelCount * i + chIdx + 1];
-        }
-    }
+    // Apply the gains and sum up the stems in one pass. Muted stems are
+    // skipped.
+    SampleUtil::mixMultiToStereoWithRampingGain(pOut,
+            m_stemBuffer.data(),
+            m_stemGainOld.data(),
+            stemGainNew.data(),
+            iBufferSize / mixxx::kEngineChannelOutputCount,
+            channelCount);
+    std::copy(stemGainNew.begin(),
+            stemGainNew.begin() + stereoChannelCount,
+            m_stemGainOld.begin());
     // TODO(XXX): process stem DSP
 }
 
@@ -109,7 +184,8 @@ void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
                 m_pEffectsManager->getMainHandle(),
                 pOut,
                 iBufferSize,
-                mixxx::audio::SampleRate::fromDouble(m_sampleRate.get()));
+                mixxx::audio::SampleRate::fromDouble(m_sampleRate.get()),
+                m_pBuffer->getLoopPeriodFrames());
     }
 
     // Update VU meter
@@ -195,6 +271,12 @@ void EngineDeck::slotPassthroughToggle(double v) {
     m_bPassthroughIsActive = v > 0;
 }
 
+void EngineDeck::slotEffectsFreezeToggle(double v) {
+    m_pEffectsManager->setEffectsFrozen(m_group.handle(),
+            v > 0,
+            mixxx::audio::SampleRate::fromDouble(m_sampleRate.get()));
+}
+
 void EngineDeck::slotPassthroughChangeRequest(double v) {
     if (v <= 0 || m_pInputConfigured->get() > 0) {
         m_pPassing->setAndConfirm(v);
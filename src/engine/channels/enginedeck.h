@@ -1,8 +1,12 @@
 #pragma once
 
 #include <QScopedPointer>
+#include <array>
+#include <memory>
+#include <vector>
 
 #include "engine/channels/enginechannel.h"
+#include "engine/engine.h"
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
 #include "util/samplebuffer.h"
@@ -11,6 +15,7 @@ class EnginePregain;
 class EngineBuffer;
 class EngineMixer;
 class ControlPushButton;
+class ControlPotmeter;
 
 class EngineDeck : public EngineChannel, public AudioDestination {
     Q_OBJECT
@@ -69,6 +74,7 @@ class EngineDeck : public EngineChannel, public AudioDestination {
   public slots:
     void slotPassthroughToggle(double v);
     void slotPassthroughChangeRequest(double v);
+    void slotEffectsFreezeToggle(double v);
 
   private:
     // Process multiple channels and mix them together into the passed buffer
@@ -80,10 +86,20 @@ class EngineDeck : public EngineChannel, public AudioDestination {
 
     // Stem buffer used to retrieve all the channel to mix together
     mixxx::SampleBuffer m_stemBuffer;
+    // Per stem controls in [ChannelNStemM], only created for primary decks
+    std::vector<std::unique_ptr<ControlPotmeter>> m_stemGain;
+    std::vector<std::unique_ptr<ControlPushButton>> m_stemMute;
+    // The gains applied at the end of the previous buffer, for ramping
+    std::array<CSAMPLE_GAIN,
+            mixxx::kMaxEngineChannelInputCount / mixxx::kEngineChannelOutputCount>
+            m_stemGainOld;
 
     // Begin vinyl passthrough fields
     QScopedPointer<ControlObject> m_pInputConfigured;
     ControlPushButton* m_pPassing;
     bool m_bPassthroughIsActive;
     bool m_bPassthroughWasActive;
+
+    // Replay the effects output while looping, see FrozenEffectsCache
+    std::unique_ptr<ControlPushButton> m_pEffectsFreeze;
 };
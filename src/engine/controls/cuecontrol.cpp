@@ -70,19 +70,23 @@ inline int hotcueNumberToHotcueIndex(int hotcueNumber) {
 
 void appendCueHint(gsl::not_null<HintVector*> pHintList,
         const mixxx::audio::FramePos& frame,
-        Hint::Type type) {
+        Hint::Type type,
+        SINT frameCount = Hint::kFrameCountForward) {
     if (frame.isValid()) {
         const Hint cueHint = {
                 /*.frame =*/static_cast<SINT>(frame.toLowerFrameBoundary().value()),
-                /*.frameCount =*/Hint::kFrameCountForward,
+                /*.frameCount =*/frameCount,
                 /*.type =*/type};
         pHintList->append(cueHint);
     }
 }
 
-void appendCueHint(gsl::not_null<HintVector*> pHintList, const double playPos, Hint::Type type) {
+void appendCueHint(gsl::not_null<HintVector*> pHintList,
+        const double playPos,
+        Hint::Type type,
+        SINT frameCount = Hint::kFrameCountForward) {
     const auto frame = mixxx::audio::FramePos::fromEngineSamplePosMaybeInvalid(playPos);
-    appendCueHint(pHintList, frame, type);
+    appendCueHint(pHintList, frame, type, frameCount);
 }
 
 } // namespace
@@ -1282,12 +1286,22 @@ void CueControl::hintReader(gsl::not_null<HintVector*> pHintList) {
     // constructor and getPosition()->get() is a ControlObject
     for (const auto& pControl : std::as_const(m_hotcueControls)) {
         appendCueHint(pHintList, pControl->getPosition(), Hint::Type::HotCue);
+        // The end position is only valid for saved loops. Playing a saved
+        // loop jumps back from there, possibly also in reverse.
+        appendCueHint(pHintList,
+                pControl->getEndPosition(),
+                Hint::Type::SavedLoopEnd,
+                Hint::kFrameCountBackward);
     }
 
     appendCueHint(pHintList, m_n60dBSoundStartPosition.getValue(), Hint::Type::FirstSound);
     appendCueHint(pHintList, m_pIntroStartPosition->get(), Hint::Type::IntroStart);
     appendCueHint(pHintList, m_pIntroEndPosition->get(), Hint::Type::IntroEnd);
     appendCueHint(pHintList, m_pOutroStartPosition->get(), Hint::Type::OutroStart);
+    appendCueHint(pHintList,
+            m_pOutroEndPosition->get(),
+            Hint::Type::OutroEnd,
+            Hint::kFrameCountBackward);
 }
 
 // Moves the cue point to current position or to closest beat in case
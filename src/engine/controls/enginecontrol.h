@@ -12,6 +12,7 @@
 #include "track/beats.h"
 #include "track/track_decl.h"
 
+class ControlSnapshot;
 class EngineMixer;
 class EngineBuffer;
 struct GroupFeatureState;
@@ -56,11 +57,26 @@ class EngineControl : public QObject {
             mixxx::audio::FramePos currentPosition,
             const int iBufferSize);
 
+    /// Returns true if process() has nothing to do while the deck is paused
+    /// at an unchanged position. The EngineBuffer skips processing of a deck
+    /// at rest until one of its EngineControls returns false.
+    virtual bool isIdle() const {
+        return true;
+    }
+
     // hintReader allows the EngineControl to provide hints to the reader to
     // indicate that the given portion of a song is a potential imminent seek
     // target.
     virtual void hintReader(gsl::not_null<HintVector*> pHintList);
 
+    /// Called once when the EngineControl is added to an EngineBuffer.
+    /// Subscribe to all controls here, that are only read by process() and
+    /// not changed by the engine itself. The snapshot is updated at the
+    /// start of each EngineBuffer::process() call.
+    virtual void subscribeControls(ControlSnapshot* pSnapshot) {
+        Q_UNUSED(pSnapshot);
+    }
+
     virtual void setEngineMixer(EngineMixer* pEngineMixer);
     void setEngineBuffer(EngineBuffer* pEngineBuffer);
     virtual void setFrameInfo(mixxx::audio::FramePos currentPosition,
@@ -407,6 +407,19 @@ void LoopingControl::process(const double dRate,
     }
 }
 
+bool LoopingControl::isIdle() const {
+    if (m_bAdjustingLoopIn || m_bAdjustingLoopOut) {
+        return false;
+    }
+    // A changed loop may move the play position, see process()
+    const LoopInfo loopInfo = m_loopInfo.getValue();
+    return !m_bLoopingEnabled ||
+            !loopInfo.startPosition.isValid() ||
+            !loopInfo.endPosition.isValid() ||
+            (loopInfo.startPosition == m_oldLoopInfo.startPosition &&
+                    loopInfo.endPosition == m_oldLoopInfo.endPosition);
+}
+
 mixxx::audio::FramePos LoopingControl::nextTrigger(bool reverse,
         mixxx::audio::FramePos currentPosition,
         mixxx::audio::FramePos* pTargetPosition) {
@@ -589,12 +602,35 @@ void LoopingControl::hintReader(gsl::not_null<HintVector*> pHintList) {
                 ? m_currentPosition.getValue()
                 : findQuantizedBeatloopStart(
                           pBeats, m_currentPosition.getValue(), beats);
-        loop_hint.type = Hint::Type::LoopStart;
-        loop_hint.frame = static_cast<SINT>(
-                pBeats->findNBeatsFromPosition(currentPosition, -beats)
-                        .toLowerFrameBoundary()
-                        .value());
-        loop_hint.frameCount = Hint::kFrameCountForward;
+        const auto loopStartPosition = pBeats->findNBeatsFromPosition(currentPosition, -beats);
+        if (loopStartPosition.isValid()) {
+            loop_hint.type = Hint::Type::LoopStart;
+            loop_hint.frame = static_cast<SINT>(
+                    loopStartPosition.toLowerFrameBoundary().value());
+            loop_hint.frameCount = Hint::kFrameCountForward;
+            pHintList->append(loop_hint);
+        }
+    }
+
+    // Preload the targets of the next beatjump in both directions. Inside
+    // an active loop a beatjump moves the loop instead, which is covered
+    // by the loop hints above.
+    const mixxx::BeatsPointer pBeats = m_pBeats;
+    const auto currentPosition = m_currentPosition.getValue();
+    if (!pBeats || !currentPosition.isValid()) {
+        return;
+    }
+    const double beatJumpSize = m_pCOBeatJumpSize->get();
+    for (const double beats : {beatJumpSize, -beatJumpSize}) {
+        const auto targetPosition = pBeats->findNBeatsFromPosition(currentPosition, beats);
+        if (targetPosition.isValid()) {
+            const Hint beatJumpHint = {
+                    /*.frame =*/static_cast<SINT>(
+                            targetPosition.toLowerFrameBoundary().value()),
+                    /*.frameCount =*/Hint::kFrameCountForward,
+                    /*.type =*/Hint::Type::BeatJump};
+            pHintList->append(beatJumpHint);
+        }
     }
 }
 
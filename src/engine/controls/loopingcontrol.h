@@ -31,6 +31,7 @@ class LoopingControl : public EngineControl {
     void process(const double dRate,
             mixxx::audio::FramePos currentPosition,
             const int iBufferSize) override;
+    bool isIdle() const override;
 
     // nextTrigger returns the sample at which the engine will be triggered to
     // take a loop, given the value of currentPosition and the playback direction.
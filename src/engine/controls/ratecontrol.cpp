@@ -97,8 +97,6 @@ RateControl::RateControl(const QString& group,
 
     m_pSlipEnabled = new ControlProxy(group, "slip_enabled", this);
 
-    m_pVCEnabled = ControlObject::getControl(ConfigKey(getGroup(), "vinylcontrol_enabled"));
-    m_pVCScratching = ControlObject::getControl(ConfigKey(getGroup(), "vinylcontrol_scratching"));
     m_pVCMode = ControlObject::getControl(ConfigKey(getGroup(), "vinylcontrol_mode"));
 
     // Permanent rate-change buttons
@@ -366,6 +364,36 @@ void RateControl::slotControlRatePermUpSmall(double v) {
     }
 }
 
+void RateControl::subscribeControls(ControlSnapshot* pSnapshot) {
+    m_speedInputs.rateSearch = pSnapshot->subscribe(m_pRateSearch->getKey());
+    m_speedInputs.reverse = pSnapshot->subscribe(m_pReverseButton->getKey());
+    m_speedInputs.scratch2 = pSnapshot->subscribe(m_pScratch2->getKey());
+    m_speedInputs.scratch2Enable = pSnapshot->subscribe(m_pScratch2Enable->getKey());
+    m_speedInputs.scratch2Scratching = pSnapshot->subscribe(m_pScratch2Scratching->getKey());
+    // Vinyl control may not be available
+    m_speedInputs.vinylControlEnabled = pSnapshot->subscribe(
+            ConfigKey(getGroup(), QStringLiteral("vinylcontrol_enabled")),
+            ControlFlag::AllowMissingOrInvalid);
+    m_speedInputs.vinylControlScratching = pSnapshot->subscribe(
+            ConfigKey(getGroup(), QStringLiteral("vinylcontrol_scratching")),
+            ControlFlag::AllowMissingOrInvalid);
+}
+
+bool RateControl::isIdle() const {
+    // Wheel, jog and scratching move a paused deck. The inputs of the
+    // snapshot wake the deck when they change.
+    return m_pWheel->get() == 0 &&
+            m_pJog->get() == 0 &&
+            m_pJogFilter->isAtRest() &&
+            !m_bTempStarted &&
+            !m_pButtonRateTempUp->toBool() &&
+            !m_pButtonRateTempDown->toBool() &&
+            !m_pButtonRateTempUpSmall->toBool() &&
+            !m_pButtonRateTempDownSmall->toBool() &&
+            !m_speedInputs.vinylControlEnabled.toBool() &&
+            m_pScratchController->isAtRest();
+}
+
 double RateControl::getWheelFactor() const {
     return m_pWheel->get();
 }
@@ -404,31 +432,31 @@ double RateControl::calculateSpeed(double baserate, double speed, bool paused,
     processTempRate(iSamplesPerBuffer);
 
     double rate;
-    const double searching = m_pRateSearch->get();
+    const double searching = m_speedInputs.rateSearch.get();
     if (searching != 0) {
         // If searching is in progress, it overrides everything else
         rate = searching;
     } else {
         double wheelFactor = getWheelFactor();
         double jogFactor = getJogFactor();
-        bool bVinylControlEnabled = m_pVCEnabled && m_pVCEnabled->toBool();
-        bool useScratch2Value = m_pScratch2Enable->toBool();
+        bool bVinylControlEnabled = m_speedInputs.vinylControlEnabled.toBool();
+        bool useScratch2Value = m_speedInputs.scratch2Enable.toBool();
 
         // By default scratch2_enable is enough to determine if the user is
         // scratching or not. Moving platter controllers have to disable
         // "scratch2_indicates_scratching" if they are not scratching,
         // to allow things like key-lock.
-        if (useScratch2Value && m_pScratch2Scratching->toBool()) {
+        if (useScratch2Value && m_speedInputs.scratch2Scratching.toBool()) {
             *pReportScratching = true;
         }
 
         if (bVinylControlEnabled) {
-            if (m_pVCScratching->toBool()) {
+            if (m_speedInputs.vinylControlScratching.toBool()) {
                 *pReportScratching = true;
             }
             rate = speed;
         } else {
-            double scratchFactor = m_pScratch2->get();
+            double scratchFactor = m_speedInputs.scratch2.get();
             // Don't trust values from m_pScratch2
             if (util_isnan(scratchFactor)) {
                 scratchFactor = 0.0;
@@ -499,7 +527,7 @@ double RateControl::calculateSpeed(double baserate, double speed, bool paused,
             int vcmode = m_pVCMode ? static_cast<int>(m_pVCMode->get()) : MIXXX_VCMODE_ABSOLUTE;
             // TODO(owen): Instead of just ignoring reverse mode, should we
             // disable absolute mode instead?
-            if (m_pReverseButton->toBool() && !m_pScratch2Enable->toBool() &&
+            if (m_speedInputs.reverse.toBool() && !useScratch2Value &&
                     (!bVinylControlEnabled ||
                             vcmode != MIXXX_VCMODE_ABSOLUTE)) {
                 rate = -rate;
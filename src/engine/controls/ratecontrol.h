@@ -2,6 +2,7 @@
 
 #include <QObject>
 
+#include "control/controlsnapshot.h"
 #include "preferences/usersettings.h"
 #include "engine/controls/enginecontrol.h"
 #include "engine/sync/syncable.h"
@@ -41,6 +42,9 @@ public:
 
   void setBpmControl(BpmControl* bpmcontrol);
 
+  void subscribeControls(ControlSnapshot* pSnapshot) override;
+  bool isIdle() const override;
+
   // Returns the current engine rate.  "reportScratching" is used to tell
   // the caller that the user is currently scratching, and this is used to
   // disable keylock.
@@ -138,8 +142,6 @@ private:
 
   ControlPushButton* m_pScratch2Enable;
   ControlObject* m_pJog;
-  ControlObject* m_pVCEnabled;
-  ControlObject* m_pVCScratching;
   ControlObject* m_pVCMode;
   ControlObject* m_pScratch2Scratching;
   Rotary* m_pJogFilter;
@@ -152,6 +154,18 @@ private:
   ControlProxy* m_pSyncMode;
   ControlProxy* m_pSlipEnabled;
 
+  // The inputs of calculateSpeed(), which are read from the control
+  // snapshot of the EngineBuffer.
+  struct SpeedInputs {
+      ControlSnapshot::Proxy rateSearch;
+      ControlSnapshot::Proxy reverse;
+      ControlSnapshot::Proxy scratch2;
+      ControlSnapshot::Proxy scratch2Enable;
+      ControlSnapshot::Proxy scratch2Scratching;
+      ControlSnapshot::Proxy vinylControlEnabled;
+      ControlSnapshot::Proxy vinylControlScratching;
+  } m_speedInputs;
+
   int m_wrapAroundCount;
   mixxx::audio::FramePos m_jumpPos;
   mixxx::audio::FramePos m_targetPos;
@@ -20,7 +20,10 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_pManifest(pManifest),
           m_pProcessor(pBackendManager->createProcessor(pManifest)),
-          m_parameters(pManifest->parameters().size()) {
+          m_revision(0),
+          m_parameters(pManifest->parameters().size()),
+          m_profilerStage(CallbackProfiler::instance().registerStage(
+                  QStringLiteral("EngineEffect ") + pManifest->id())) {
     const QList<EffectManifestParameterPointer>& parameters = m_pManifest->parameters();
     for (int i = 0; i < parameters.size(); ++i) {
         EffectManifestParameterPointer param = parameters.at(i);
@@ -43,7 +46,10 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
     const mixxx::EngineParameters engineParameters(
             kInitalSampleRate,
             kMaxEngineFrames);
-    m_pProcessor->initialize(activeInputChannels, registeredOutputChannels, engineParameters);
+    m_pProcessor->initialize(activeInputChannels,
+            registeredInputChannels,
+            registeredOutputChannels,
+            engineParameters);
     m_effectRampsFromDry = pManifest->effectRampsFromDry();
 }
 
@@ -55,23 +61,35 @@ EngineEffect::~EngineEffect() {
     m_parameters.clear();
 }
 
-void EngineEffect::initalizeInputChannel(ChannelHandle inputChannel) {
-    if (m_pProcessor->hasStatesForInputChannel(inputChannel)) {
-        // already initialized for this input channel
-        return;
-    }
-
+EffectStatesMap EngineEffect::createStatesForInputChannel() {
     // At this point the SoundDevice is not set up so we use the kInitalSampleRate.
     const mixxx::EngineParameters engineParameters(
             kInitalSampleRate,
             kMaxEngineFrames);
-    m_pProcessor->initializeInputChannel(inputChannel, engineParameters);
+    return m_pProcessor->createStatesForInputChannel(engineParameters);
+}
+
+void EngineEffect::loadStatesForInputChannel(ChannelHandle inputChannel,
+        EffectStatesMap* pStates) {
+    if (kEffectDebugOutput) {
+        qDebug() << debugString() << "loadStatesForInputChannel" << inputChannel;
+    }
+    m_pProcessor->loadStatesForInputChannel(inputChannel, pStates);
+}
+
+void EngineEffect::deleteStatesForInputChannel(ChannelHandle inputChannel,
+        EffectStatesMap* pStates) {
+    if (kEffectDebugOutput) {
+        qDebug() << debugString() << "deleteStatesForInputChannel" << inputChannel;
+    }
+    m_pProcessor->deleteStatesForInputChannel(inputChannel, pStates);
 }
 
 bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                                          EffectsResponsePipe* pResponsePipe) {
     EngineEffectParameterPointer pParameter;
     EffectsResponse response(message);
+    ++m_revision;
 
     switch (message.type) {
     case EffectsRequest::SET_EFFECT_PARAMETERS:
@@ -133,6 +151,7 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
         const mixxx::audio::SampleRate sampleRate,
         const EffectEnableState chainEnableState,
         const GroupFeatureState& groupFeatures) {
+    const CallbackProfiler::Scope profilerScope(m_profilerStage);
     // Compute the effective enable state from the combination of the effect's state
     // for the channel and the state passed from the EngineEffectChain.
 
@@ -11,6 +11,7 @@
 #include "effects/backends/effectprocessor.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
+#include "util/callbackprofiler.h"
 #include "util/types.h"
 
 /// EngineEffect is a generic wrapper around an EffectProcessor which intermediates
@@ -28,8 +29,14 @@ class EngineEffect final : public EffectsRequestHandler {
     /// Called in main thread by EffectSlot
     ~EngineEffect();
 
-    /// Called from the main thread to make sure that the channel already has states
-    void initalizeInputChannel(ChannelHandle inputChannel);
+    /// Called from the main thread to allocate the states for an input
+    /// channel before it is enabled
+    EffectStatesMap createStatesForInputChannel();
+
+    /// Called in audio thread, see EffectProcessor
+    void loadStatesForInputChannel(ChannelHandle inputChannel, EffectStatesMap* pStates);
+    /// Called in audio thread, see EffectProcessor
+    void deleteStatesForInputChannel(ChannelHandle inputChannel, EffectStatesMap* pStates);
 
     /// Called in audio thread
     bool processEffectsRequest(
@@ -58,6 +65,12 @@ class EngineEffect final : public EffectsRequestHandler {
         return m_pProcessor->getGroupDelayFrames();
     }
 
+    /// Changes with every request that is processed by the effect.
+    /// Called in audio thread
+    quint64 revision() const {
+        return m_revision;
+    }
+
   private:
     QString debugString() const {
         return QString("EngineEffect(%1)").arg(m_pManifest->name());
@@ -67,9 +80,11 @@ class EngineEffect final : public EffectsRequestHandler {
     std::unique_ptr<EffectProcessor> m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
     bool m_effectRampsFromDry;
+    quint64 m_revision;
     // Must not be modified after construction.
     QVector<EngineEffectParameterPointer> m_parameters;
     QMap<QString, EngineEffectParameterPointer> m_parametersById;
+    const CallbackProfiler::StageId m_profilerStage;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffect);
 };
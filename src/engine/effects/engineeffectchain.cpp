@@ -2,6 +2,7 @@
 
 #include "engine/effects/engineeffect.h"
 #include "util/defs.h"
+#include "util/realtimeaudit.h"
 #include "util/sample.h"
 
 EngineEffectChain::EngineEffectChain(const QString& group,
@@ -11,6 +12,7 @@ EngineEffectChain::EngineEffectChain(const QString& group,
           m_enableState(EffectEnableState::Enabled),
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
+          m_revision(0),
           m_buffer1(kMaxEngineSamples),
           m_buffer2(kMaxEngineSamples) {
     // Try to prevent memory allocation.
@@ -90,6 +92,7 @@ bool EngineEffectChain::updateParameters(const EffectsRequest& message) {
 bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
         EffectsResponsePipe* pResponsePipe) {
     EffectsResponse response(message);
+    ++m_revision;
     switch (message.type) {
     case EffectsRequest::ADD_EFFECT_TO_CHAIN:
         if (kEffectDebugOutput) {
@@ -126,7 +129,8 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
                      << message.EnableInputChannelForChain.channelHandle;
         }
         response.success = enableForInputChannel(
-                message.EnableInputChannelForChain.channelHandle);
+                message.EnableInputChannelForChain.channelHandle,
+                message.EnableInputChannelForChain.pEffectStatesMapArray);
         break;
     case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL:
         if (kEffectDebugOutput) {
@@ -138,6 +142,17 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
         response.success = disableForInputChannel(
                 message.DisableInputChannelForChain.channelHandle);
         break;
+    case EffectsRequest::DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL:
+        if (kEffectDebugOutput) {
+            qDebug() << debugString() << this
+                     << "DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL"
+                     << message.pTargetChain
+                     << message.DeleteEffectStatesForInputChannel.channelHandle;
+        }
+        response.success = deleteStatesForInputChannel(
+                message.DeleteEffectStatesForInputChannel.channelHandle,
+                message.DeleteEffectStatesForInputChannel.pEffectStatesMapArray);
+        break;
     default:
         return false;
     }
@@ -145,10 +160,22 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
     return true;
 }
 
-bool EngineEffectChain::enableForInputChannel(ChannelHandle inputHandle) {
+bool EngineEffectChain::enableForInputChannel(ChannelHandle inputHandle,
+        EffectStatesMapArray* pEffectStatesMapArray) {
     if (kEffectDebugOutput) {
         qDebug() << "EngineEffectChain::enableForInputChannel" << this << inputHandle;
     }
+    VERIFY_OR_DEBUG_ASSERT(pEffectStatesMapArray) {
+        return false;
+    }
+    // The EffectStates were allocated for the effects in the chain at the time
+    // of the request, which are still the same because the requests are
+    // processed in order.
+    for (int i = 0; i < m_effects.size() && i < kNumEffectsPerUnit; ++i) {
+        if (m_effects[i]) {
+            m_effects[i]->loadStatesForInputChannel(inputHandle, &(*pEffectStatesMapArray)[i]);
+        }
+    }
     auto& outputMap = m_chainStatusForChannelMatrix[inputHandle];
     for (auto&& outputChannelStatus : outputMap) {
         DEBUG_ASSERT(outputChannelStatus.enableState != EffectEnableState::Enabled);
@@ -171,6 +198,92 @@ bool EngineEffectChain::disableForInputChannel(ChannelHandle inputHandle) {
     return true;
 }
 
+bool EngineEffectChain::deleteStatesForInputChannel(ChannelHandle inputHandle,
+        EffectStatesMapArray* pEffectStatesMapArray) {
+    VERIFY_OR_DEBUG_ASSERT(pEffectStatesMapArray) {
+        return false;
+    }
+    auto& outputMap = m_chainStatusForChannelMatrix[inputHandle];
+    for (const auto& outputChannelStatus : std::as_const(outputMap)) {
+        if (outputChannelStatus.enableState == EffectEnableState::Enabling ||
+                outputChannelStatus.enableState == EffectEnableState::Enabled) {
+            // Enabled again in the meantime, the EffectStates are still in use
+            return true;
+        }
+    }
+    for (auto&& outputChannelStatus : outputMap) {
+        // The fade out has been processed in the callback of the disable
+        // request unless the channel was not processed at all.
+        outputChannelStatus.enableState = EffectEnableState::Disabled;
+    }
+    for (int i = 0; i < m_effects.size() && i < kNumEffectsPerUnit; ++i) {
+        if (m_effects[i]) {
+            m_effects[i]->deleteStatesForInputChannel(inputHandle, &(*pEffectStatesMapArray)[i]);
+        }
+    }
+    return true;
+}
+
+bool EngineEffectChain::isBypassedForChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    if (m_enableState == EffectEnableState::Enabling ||
+            m_enableState == EffectEnableState::Disabling) {
+        // The state transition is done in process()
+        return false;
+    }
+    const ChannelStatus& channelStatus =
+            m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    return channelStatus.enableState == EffectEnableState::Disabled;
+}
+
+void EngineEffectChain::processBypassed(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    ChannelStatus& channelStatus = m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    DEBUG_ASSERT(channelStatus.enableState == EffectEnableState::Disabled);
+    channelStatus.oldMixKnob = m_dMix;
+}
+
+bool EngineEffectChain::isIdle() const {
+    if (m_enableState == EffectEnableState::Disabled) {
+        return true;
+    }
+    if (m_enableState == EffectEnableState::Enabling ||
+            m_enableState == EffectEnableState::Disabling) {
+        // The state transition is done in process()
+        return false;
+    }
+    for (const EngineEffect* pEffect : m_effects) {
+        if (pEffect) {
+            return false;
+        }
+    }
+    // Without effects only a pending fade of the dry signal delay is left
+    return m_effectsDelay.isIdle();
+}
+
+void EngineEffectChain::resumeFromIdle() {
+    for (auto& outputChannelStatus : m_chainStatusForChannelMatrix) {
+        for (auto& channelStatus : outputChannelStatus) {
+            channelStatus.oldMixKnob = m_dMix;
+            if (channelStatus.enableState == EffectEnableState::Disabling) {
+                channelStatus.enableState = EffectEnableState::Disabled;
+            } else if (channelStatus.enableState == EffectEnableState::Enabling) {
+                channelStatus.enableState = EffectEnableState::Enabled;
+            }
+        }
+    }
+}
+
+quint64 EngineEffectChain::revision() const {
+    quint64 revision = m_revision;
+    for (const EngineEffect* pEffect : m_effects) {
+        if (pEffect) {
+            revision += pEffect->revision();
+        }
+    }
+    return revision;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -231,6 +344,8 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                     pIntermediateOutput = m_buffer1.data();
                 }
 
+                const mixxx::realtimeaudit::ObjectScope realtimeAuditObject(
+                        "effect", pEffect->getManifest()->id());
                 if (pEffect->process(inputHandle,
                             outputHandle,
                             pIntermediateInput,
@@ -45,6 +45,33 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const GroupFeatureState& groupFeatures,
             bool fadeout);
 
+    /// Returns true if process() would pass the signal of the channel through
+    /// unmodified and without any pending enable state transition. In this
+    /// case process() can be replaced by processBypassed().
+    /// called from audio thread
+    bool isBypassedForChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+    /// Updates the channel status like process() does without touching
+    /// any samples. Only valid if isBypassedForChannel() returned true.
+    /// called from audio thread
+    void processBypassed(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+
+    /// Returns true if process() would neither touch any samples nor depend
+    /// on the state of any channel, because the chain is disabled or has no
+    /// effects. EngineEffectsManager skips idle chains entirely.
+    /// called from audio thread
+    bool isIdle() const;
+    /// Completes the channel state transitions which process() would have
+    /// done while the chain was skipped for being idle.
+    /// called from audio thread
+    void resumeFromIdle();
+
+    /// Changes with every request that is processed by the chain or by
+    /// one of its effects.
+    /// called from audio thread
+    quint64 revision() const;
+
   private:
     struct ChannelStatus {
         ChannelStatus()
@@ -62,13 +89,17 @@ class EngineEffectChain final : public EffectsRequestHandler {
     bool updateParameters(const EffectsRequest& message);
     bool addEffect(EngineEffect* pEffect, int iIndex);
     bool removeEffect(EngineEffect* pEffect, int iIndex);
-    bool enableForInputChannel(ChannelHandle inputHandle);
+    bool enableForInputChannel(ChannelHandle inputHandle,
+            EffectStatesMapArray* pEffectStatesMapArray);
     bool disableForInputChannel(ChannelHandle inputHandle);
+    bool deleteStatesForInputChannel(ChannelHandle inputHandle,
+            EffectStatesMapArray* pEffectStatesMapArray);
 
     QString m_group;
     EffectEnableState m_enableState;
     EffectChainMixMode::Type m_mixMode;
     CSAMPLE m_dMix;
+    quint64 m_revision;
     QList<EngineEffect*> m_effects;
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
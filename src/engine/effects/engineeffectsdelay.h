@@ -3,6 +3,7 @@
 #include "engine/engine.h"
 #include "engine/engineobject.h"
 #include "util/assert.h"
+#include "util/ringdelaybuffer.h"
 #include "util/types.h"
 
 namespace {
@@ -73,9 +74,14 @@ class EngineEffectsDelay final : public EngineObject {
     /// and of the output buffer created using the new delay value.
     void process(CSAMPLE* pInOut, const int iBufferSize) override;
 
+    /// Returns true if process() would neither delay the signal nor
+    /// cross-fade to a new delay value.
+    bool isIdle() const {
+        return m_currentDelaySamples == 0 && m_prevDelaySamples == 0;
+    }
+
   private:
     SINT m_currentDelaySamples;
     SINT m_prevDelaySamples;
-    SINT m_delayBufferWritePos;
-    CSAMPLE* m_pDelayBuffer;
+    RingDelayBuffer m_delayBuffer;
 };
@@ -1,5 +1,8 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "audio/types.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
@@ -8,20 +11,51 @@
 
 EngineEffectsManager::EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe)
         : m_pResponsePipe(std::move(pResponsePipe)),
+          m_pPendingBatch(nullptr),
+          m_executionPlanDirty(false),
           m_buffer1(kMaxEngineSamples),
           m_buffer2(kMaxEngineSamples) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
+    for (int i = 0; i < kNumSignalProcessingStages; ++i) {
+        m_executionPlan[i].reserve(64);
+        m_nextExecutionPlan[i].reserve(64);
+    }
+}
+
+EngineEffectsManager::~EngineEffectsManager() {
+    for (FrozenEffectsCache* pCache : std::as_const(m_frozenEffectsCaches)) {
+        delete pCache;
+    }
+}
+
+bool EngineEffectsManager::readRequest(EffectsRequest** ppRequest) {
+    EffectsRequest* pRequest = m_pPendingBatch;
+    if (!pRequest && !m_pResponsePipe->readMessage(&pRequest)) {
+        return false;
+    }
+    // The messenger checks that the whole batch fits into the pipe, but the
+    // remaining requests may still be in flight. Defer the batch to the next
+    // callback in that case, so it is applied atomically.
+    if (pRequest->batchSize > 1 &&
+            m_pResponsePipe->messageCount() < pRequest->batchSize - 1) {
+        m_pPendingBatch = pRequest;
+        return false;
+    }
+    m_pPendingBatch = nullptr;
+    *ppRequest = pRequest;
+    return true;
 }
 
 void EngineEffectsManager::onCallbackStart() {
     EffectsRequest* request = nullptr;
-    while (m_pResponsePipe->readMessage(&request)) {
+    while (readRequest(&request)) {
         EffectsResponse response(*request);
         bool processed = false;
         switch (request->type) {
         case EffectsRequest::ADD_EFFECT_CHAIN:
         case EffectsRequest::REMOVE_EFFECT_CHAIN:
+        case EffectsRequest::SET_FROZEN_EFFECTS_CACHE:
             if (processEffectsRequest(*request, m_pResponsePipe.get())) {
                 processed = true;
             }
@@ -30,7 +64,8 @@ void EngineEffectsManager::onCallbackStart() {
         case EffectsRequest::REMOVE_EFFECT_FROM_CHAIN:
         case EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS:
         case EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL:
-        case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL: {
+        case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL:
+        case EffectsRequest::DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL: {
             bool chainExists = false;
             for (const auto& chains : std::as_const(m_chainsByStage)) {
                 if (chains.contains(request->pTargetChain)) {
@@ -89,17 +124,63 @@ void EngineEffectsManager::onCallbackStart() {
         if (!processed) {
             m_pResponsePipe->writeMessage(response);
         }
+        m_executionPlanDirty = true;
+    }
+    updateExecutionPlan();
+}
+
+void EngineEffectsManager::updateExecutionPlan() {
+    if (!m_executionPlanDirty) {
+        // Chains only become active by requests, but finish fading out or
+        // delaying the dry signal while being processed.
+        for (const auto& chains : m_executionPlan) {
+            for (const EngineEffectChain* pChain : chains) {
+                if (pChain->isIdle()) {
+                    m_executionPlanDirty = true;
+                }
+            }
+        }
+        if (!m_executionPlanDirty) {
+            return;
+        }
+    }
+    m_executionPlanDirty = false;
+
+    for (int i = 0; i < kNumSignalProcessingStages; ++i) {
+        std::vector<EngineEffectChain*>& nextChains = m_nextExecutionPlan[i];
+        nextChains.clear();
+        const auto it = m_chainsByStage.constFind(static_cast<SignalProcessingStage>(i));
+        if (it == m_chainsByStage.constEnd()) {
+            continue;
+        }
+        for (EngineEffectChain* pChain : it.value()) {
+            if (!pChain || pChain->isIdle()) {
+                continue;
+            }
+            if (std::find(m_executionPlan[i].begin(), m_executionPlan[i].end(), pChain) ==
+                    m_executionPlan[i].end()) {
+                pChain->resumeFromIdle();
+            }
+            // Does not allocate unless there are more chains than reserved
+            nextChains.push_back(pChain);
+        }
     }
+    m_executionPlan.swap(m_nextExecutionPlan);
 }
 
 void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pInOut,
         unsigned int numSamples,
-        mixxx::audio::SampleRate sampleRate) {
+        mixxx::audio::SampleRate sampleRate,
+        SINT loopPeriodFrames) {
     // Feature state is gathered after prefader effects processing.
     // This is okay because the equalizer effects do not make use of it.
     GroupFeatureState featureState;
+    if (loopPeriodFrames > 0) {
+        featureState.has_loop_period_frames = true;
+        featureState.loop_period_frames = loopPeriodFrames;
+    }
     processInner(SignalProcessingStage::Prefader,
             inputHandle,
             outputHandle,
@@ -157,6 +238,21 @@ void EngineEffectsManager::processPostFaderAndMix(
             fadeout);
 }
 
+bool EngineEffectsManager::bypassPostFader(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    const auto& chains = plannedChains(SignalProcessingStage::Postfader);
+    for (EngineEffectChain* pChain : chains) {
+        if (!pChain->isBypassedForChannel(inputHandle, outputHandle)) {
+            return false;
+        }
+    }
+    for (EngineEffectChain* pChain : chains) {
+        pChain->processBypassed(inputHandle, outputHandle);
+    }
+    return true;
+}
+
 void EngineEffectsManager::processInner(
         const SignalProcessingStage stage,
         const ChannelHandle& inputHandle,
@@ -169,25 +265,46 @@ void EngineEffectsManager::processInner(
         CSAMPLE_GAIN oldGain,
         CSAMPLE_GAIN newGain,
         bool fadeout) {
-    const QList<EngineEffectChain*>& chains = m_chainsByStage.value(stage);
+    const auto& chains = plannedChains(stage);
+
+    FrozenEffectsCache::Slot* pFrozenSlot = nullptr;
+    if (!chains.empty()) {
+        pFrozenSlot = frozenEffectsSlot(stage, inputHandle, outputHandle);
+    }
+    if (pFrozenSlot &&
+            pFrozenSlot->beginBuffer(pIn,
+                    numSamples,
+                    groupFeatures.has_loop_period_frames
+                            ? groupFeatures.loop_period_frames
+                            : 0,
+                    chainsRevision(chains, inputHandle, outputHandle),
+                    oldGain,
+                    newGain)) {
+        // The chains are not processed while their output is replayed
+        pFrozenSlot->replay(pOut, pIn != pOut);
+        return;
+    }
 
     if (pIn == pOut) {
         // Gain and effects are applied to the buffer in place,
         // modifying the original input buffer
         SampleUtil::applyRampingGain(pIn, oldGain, newGain, numSamples);
         for (EngineEffectChain* pChain : chains) {
-            if (pChain) {
-                if (pChain->process(inputHandle,
-                            outputHandle,
-                            pIn,
-                            pOut,
-                            numSamples,
-                            sampleRate,
-                            groupFeatures,
-                            fadeout)) {
-                }
-            }
+            pChain->process(inputHandle,
+                    outputHandle,
+                    pIn,
+                    pOut,
+                    numSamples,
+                    sampleRate,
+                    groupFeatures,
+                    fadeout);
+        }
+        if (pFrozenSlot) {
+            pFrozenSlot->endBuffer(pOut);
         }
+    } else if (chains.empty()) {
+        // Nothing to process, so apply the gain while mixing
+        SampleUtil::addWithRampingGain(pOut, pIn, oldGain, newGain, numSamples);
     } else {
         // Do not modify the input buffer.
         // 1. Copy input buffer to a temporary buffer
@@ -207,33 +324,72 @@ void EngineEffectsManager::processInner(
 
         CSAMPLE* pIntermediateOutput;
         for (EngineEffectChain* pChain : chains) {
-            if (pChain) {
-                // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
-                } else {
-                    pIntermediateOutput = m_buffer1.data();
-                }
+            // Select an unused intermediate buffer for the next output
+            if (pIntermediateInput == m_buffer1.data()) {
+                pIntermediateOutput = m_buffer2.data();
+            } else {
+                pIntermediateOutput = m_buffer1.data();
+            }
 
-                if (pChain->process(inputHandle,
-                            outputHandle,
-                            pIntermediateInput,
-                            pIntermediateOutput,
-                            numSamples,
-                            sampleRate,
-                            groupFeatures,
-                            fadeout)) {
-                    // Output of this chain becomes the input of the next chain.
-                    pIntermediateInput = pIntermediateOutput;
-                }
+            if (pChain->process(inputHandle,
+                        outputHandle,
+                        pIntermediateInput,
+                        pIntermediateOutput,
+                        numSamples,
+                        sampleRate,
+                        groupFeatures,
+                        fadeout)) {
+                // Output of this chain becomes the input of the next chain.
+                pIntermediateInput = pIntermediateOutput;
             }
         }
+        if (pFrozenSlot) {
+            if (pIntermediateInput == pIn) {
+                // The recording may fade the output, which must not touch
+                // the input buffer
+                SampleUtil::copy(m_buffer1.data(), pIn, numSamples);
+                pIntermediateInput = m_buffer1.data();
+            }
+            pFrozenSlot->endBuffer(pIntermediateInput);
+        }
         // pIntermediateInput is the output of the last processed chain. It would
         // be the intermediate input of the next chain if there was one.
         SampleUtil::add(pOut, pIntermediateInput, numSamples);
     }
 }
 
+FrozenEffectsCache::Slot* EngineEffectsManager::frozenEffectsSlot(
+        SignalProcessingStage stage,
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    if (!inputHandle.valid() || inputHandle.handle() >= m_frozenEffectsCaches.size()) {
+        return nullptr;
+    }
+    FrozenEffectsCache* pCache = m_frozenEffectsCaches.at(inputHandle);
+    if (!pCache) {
+        return nullptr;
+    }
+    return pCache->slot(stage, outputHandle);
+}
+
+quint64 EngineEffectsManager::chainsRevision(
+        const std::vector<EngineEffectChain*>& chains,
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    quint64 revision = 0;
+    for (EngineEffectChain* pChain : chains) {
+        if (pChain->isBypassedForChannel(inputHandle, outputHandle)) {
+            continue;
+        }
+        // Includes the chain itself, which may be added to or removed from
+        // the signal path of the channel
+        revision = revision * 31 +
+                reinterpret_cast<quintptr>(pChain) +
+                pChain->revision();
+    }
+    return revision;
+}
+
 bool EngineEffectsManager::addEffectChain(EngineEffectChain* pChain,
         SignalProcessingStage stage) {
     QList<EngineEffectChain*>& chains = m_chainsByStage[stage];
@@ -255,6 +411,14 @@ bool EngineEffectsManager::removeEffectChain(EngineEffectChain* pChain,
     return chains.removeAll(pChain) > 0;
 }
 
+void EngineEffectsManager::setFrozenEffectsCache(const ChannelHandle& inputHandle,
+        FrozenEffectsCache** ppCache) {
+    // Does not allocate for less than ChannelHandleMap's preallocated
+    // number of channels
+    FrozenEffectsCache*& pCache = m_frozenEffectsCaches[inputHandle];
+    std::swap(pCache, *ppCache);
+}
+
 bool EngineEffectsManager::processEffectsRequest(EffectsRequest& message,
         EffectsResponsePipe* pResponsePipe) {
     EffectsResponse response(message);
@@ -275,6 +439,19 @@ bool EngineEffectsManager::processEffectsRequest(EffectsRequest& message,
         response.success = removeEffectChain(message.RemoveEffectChain.pChain,
                 message.RemoveEffectChain.signalProcessingStage);
         break;
+    case EffectsRequest::SET_FROZEN_EFFECTS_CACHE:
+        if (kEffectDebugOutput) {
+            qDebug() << debugString() << "SET_FROZEN_EFFECTS_CACHE"
+                     << message.SetFrozenEffectsCache.pCache;
+        }
+        VERIFY_OR_DEBUG_ASSERT(message.SetFrozenEffectsCache.channelHandle.valid()) {
+            response.success = false;
+            break;
+        }
+        setFrozenEffectsCache(message.SetFrozenEffectsCache.channelHandle,
+                &message.SetFrozenEffectsCache.pCache);
+        response.success = true;
+        break;
     default:
         return false;
     }
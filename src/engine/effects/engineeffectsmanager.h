@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "audio/types.h"
 #include "engine/channelhandle.h"
+#include "engine/effects/frozeneffectscache.h"
 #include "engine/effects/message.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
@@ -21,18 +25,20 @@ struct GroupFeatureState;
 class EngineEffectsManager final : public EffectsRequestHandler {
   public:
     EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe);
-    ~EngineEffectsManager() override = default;
+    ~EngineEffectsManager() override;
 
     void onCallbackStart();
 
     /// Process the prefader EngineEffectChains on the pInOut buffer, modifying
-    /// the contents of the input buffer.
+    /// the contents of the input buffer. The loop period is needed for
+    /// replaying frozen effects, see EngineBuffer::getLoopPeriodFrames().
     void processPreFaderInPlace(
             const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
             CSAMPLE* pInOut,
             unsigned int numSamples,
-            mixxx::audio::SampleRate sampleRate);
+            mixxx::audio::SampleRate sampleRate,
+            SINT loopPeriodFrames = 0);
 
     /// Process the postfader EngineEffectChains on the pInOut buffer, modifying
     /// the contents of the input buffer.
@@ -64,6 +70,14 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Returns true if no post-fader effect chain processes the signal of
+    /// the channel. In this case the chain states are updated, so the caller
+    /// can mix the channel itself instead of calling processPostFaderAndMix().
+    /// Otherwise nothing is changed and false is returned.
+    bool bypassPostFader(
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+
     bool processEffectsRequest(
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
@@ -73,8 +87,39 @@ class EngineEffectsManager final : public EffectsRequestHandler {
         return QString("EngineEffectsManager");
     }
 
+    /// The chains to process in each stage, in order. The plan is compiled
+    /// from m_chainsByStage when a request has been processed or a chain
+    /// has become idle, and is only swapped between two callbacks.
+    typedef std::array<std::vector<EngineEffectChain*>, kNumSignalProcessingStages>
+            ExecutionPlan;
+
+    const std::vector<EngineEffectChain*>& plannedChains(
+            SignalProcessingStage stage) const {
+        return m_executionPlan[static_cast<int>(stage)];
+    }
+    void updateExecutionPlan();
+
+    /// Reads the next request from the pipe, unless it starts a batch that
+    /// has not been received completely.
+    bool readRequest(EffectsRequest** ppRequest);
+
     bool addEffectChain(EngineEffectChain* pChain, SignalProcessingStage stage);
     bool removeEffectChain(EngineEffectChain* pChain, SignalProcessingStage stage);
+    void setFrozenEffectsCache(const ChannelHandle& inputHandle,
+            FrozenEffectsCache** ppCache);
+
+    /// Returns the slot for replaying the chains of the stage if the effects
+    /// of the input channel are frozen, or nullptr otherwise.
+    FrozenEffectsCache::Slot* frozenEffectsSlot(
+            SignalProcessingStage stage,
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+    /// Changes whenever any of the chains that process the input channel
+    /// for the output channel changes.
+    quint64 chainsRevision(
+            const std::vector<EngineEffectChain*>& chains,
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
 
     // Take a buffer of numSamples samples of audio from a channel, provided as
     // pInput, and apply each EngineEffectChain enabled for this channel to it,
@@ -98,6 +143,12 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     std::unique_ptr<EffectsResponsePipe> m_pResponsePipe;
     QHash<SignalProcessingStage, QList<EngineEffectChain*>> m_chainsByStage;
     QList<EngineEffect*> m_effects;
+    EffectsRequest* m_pPendingBatch;
+    ExecutionPlan m_executionPlan;
+    ExecutionPlan m_nextExecutionPlan;
+    bool m_executionPlanDirty;
+    // Only set for the input channels whose effects are frozen
+    ChannelHandleMap<FrozenEffectsCache*> m_frozenEffectsCaches;
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
@@ -0,0 +1,206 @@
+#include "engine/effects/frozeneffectscache.h"
+
+#include <cmath>
+
+#include "engine/engine.h"
+#include "util/assert.h"
+#include "util/defs.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// About -100 dBFS. The output of effects with a long tail, like reverb,
+// only repeats within this tolerance after some loop periods.
+constexpr CSAMPLE kOutputTolerance = 0.00001f;
+
+// Copies pSrc to pDest and returns true if no sample differs by more
+// than the tolerance from the sample it replaces.
+bool compareAndCopy(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        SINT numSamples,
+        CSAMPLE tolerance) {
+    bool matches = true;
+    for (SINT i = 0; i < numSamples; ++i) {
+        if (std::abs(pDest[i] - pSrc[i]) > tolerance) {
+            matches = false;
+        }
+        pDest[i] = pSrc[i];
+    }
+    return matches;
+}
+
+} // anonymous namespace
+
+FrozenEffectsCache::FrozenEffectsCache(SINT capacityFrames) {
+    for (auto& slot : m_slots) {
+        slot.m_input = mixxx::SampleBuffer(
+                capacityFrames * mixxx::kEngineChannelOutputCount);
+        slot.m_output = mixxx::SampleBuffer(
+                capacityFrames * mixxx::kEngineChannelOutputCount);
+        slot.m_fadeOut = mixxx::SampleBuffer(kMaxEngineSamples);
+    }
+}
+
+FrozenEffectsCache::Slot* FrozenEffectsCache::slot(
+        SignalProcessingStage stage, const ChannelHandle& outputHandle) {
+    for (auto& slot : m_slots) {
+        if (slot.m_assigned &&
+                slot.m_stage == stage &&
+                slot.m_outputHandle == outputHandle) {
+            return &slot;
+        }
+    }
+    for (auto& slot : m_slots) {
+        if (!slot.m_assigned) {
+            slot.m_stage = stage;
+            slot.m_outputHandle = outputHandle;
+            slot.m_assigned = true;
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void FrozenEffectsCache::Slot::reset(SINT loopPeriodFrames) {
+    m_loopPeriodFrames = loopPeriodFrames;
+    m_offsetFrames = 0;
+    m_recordedFrames = 0;
+    m_matchingFrames = 0;
+    m_frozen = false;
+}
+
+bool FrozenEffectsCache::Slot::beginBuffer(const CSAMPLE* pIn,
+        SINT numSamples,
+        SINT loopPeriodFrames,
+        quint64 chainsRevision,
+        CSAMPLE_GAIN oldGain,
+        CSAMPLE_GAIN newGain) {
+    VERIFY_OR_DEBUG_ASSERT(numSamples <= m_fadeOut.size()) {
+        reset(0);
+        m_numSamples = 0;
+        m_recording = false;
+        m_fadeToLive = false;
+        return false;
+    }
+    const SINT numFrames = numSamples / mixxx::kEngineChannelOutputCount;
+    if (loopPeriodFrames * mixxx::kEngineChannelOutputCount > m_input.size() ||
+            loopPeriodFrames < numFrames) {
+        // Not a loop that fits into the cache
+        loopPeriodFrames = 0;
+    }
+    const bool unchanged = loopPeriodFrames == m_loopPeriodFrames &&
+            chainsRevision == m_chainsRevision &&
+            oldGain == m_gain && newGain == m_gain;
+    m_numSamples = numSamples;
+    m_fadeToLive = false;
+    if (m_frozen && !unchanged) {
+        // The chains have not been processed while being frozen and resume
+        // from their state at that time, so the live output is faded in.
+        readOutput(m_fadeOut.data());
+        m_fadeToLive = true;
+        m_frozen = false;
+    }
+    if (!unchanged) {
+        // The output is only known to repeat after a whole period
+        m_matchingFrames = 0;
+    }
+    m_chainsRevision = chainsRevision;
+    m_gain = newGain;
+    if (loopPeriodFrames != m_loopPeriodFrames) {
+        reset(loopPeriodFrames);
+    }
+    m_recording = m_loopPeriodFrames > 0;
+    if (!m_recording) {
+        return false;
+    }
+
+    // Overwrite the input of one loop period earlier. The recording is
+    // split where it wraps around.
+    const SINT firstFrames = math_min(numFrames, m_loopPeriodFrames - m_offsetFrames);
+    const bool compare = m_recordedFrames >= m_loopPeriodFrames;
+    const bool firstMatches = compareAndCopy(
+            m_input.data(m_offsetFrames * mixxx::kEngineChannelOutputCount),
+            pIn,
+            firstFrames * mixxx::kEngineChannelOutputCount,
+            0);
+    const bool secondMatches = compareAndCopy(m_input.data(),
+            pIn + firstFrames * mixxx::kEngineChannelOutputCount,
+            (numFrames - firstFrames) * mixxx::kEngineChannelOutputCount,
+            0);
+    m_inputMatches = compare && firstMatches && secondMatches;
+
+    if (m_frozen) {
+        if (m_inputMatches) {
+            return true;
+        }
+        readOutput(m_fadeOut.data());
+        m_fadeToLive = true;
+        m_frozen = false;
+    }
+    return false;
+}
+
+void FrozenEffectsCache::Slot::readOutput(CSAMPLE* pDest) const {
+    const SINT numFrames = m_numSamples / mixxx::kEngineChannelOutputCount;
+    const SINT firstFrames = math_min(numFrames, m_loopPeriodFrames - m_offsetFrames);
+    SampleUtil::copy(pDest,
+            m_output.data(m_offsetFrames * mixxx::kEngineChannelOutputCount),
+            firstFrames * mixxx::kEngineChannelOutputCount);
+    SampleUtil::copy(pDest + firstFrames * mixxx::kEngineChannelOutputCount,
+            m_output.data(),
+            (numFrames - firstFrames) * mixxx::kEngineChannelOutputCount);
+}
+
+void FrozenEffectsCache::Slot::replay(CSAMPLE* pOut, bool addToOutput) {
+    DEBUG_ASSERT(m_frozen);
+    if (addToOutput) {
+        readOutput(m_fadeOut.data());
+        SampleUtil::add(pOut, m_fadeOut.data(), m_numSamples);
+    } else {
+        readOutput(pOut);
+    }
+    advance();
+}
+
+void FrozenEffectsCache::Slot::endBuffer(CSAMPLE* pProcessed) {
+    DEBUG_ASSERT(!m_frozen);
+    if (m_fadeToLive) {
+        SampleUtil::linearCrossfadeBuffersIn(pProcessed,
+                m_fadeOut.data(),
+                m_numSamples,
+                mixxx::kEngineChannelOutputCount);
+        m_fadeToLive = false;
+    }
+    if (!m_recording) {
+        return;
+    }
+
+    const SINT numFrames = m_numSamples / mixxx::kEngineChannelOutputCount;
+    const SINT firstFrames = math_min(numFrames, m_loopPeriodFrames - m_offsetFrames);
+    const bool firstMatches = compareAndCopy(
+            m_output.data(m_offsetFrames * mixxx::kEngineChannelOutputCount),
+            pProcessed,
+            firstFrames * mixxx::kEngineChannelOutputCount,
+            kOutputTolerance);
+    const bool secondMatches = compareAndCopy(m_output.data(),
+            pProcessed + firstFrames * mixxx::kEngineChannelOutputCount,
+            (numFrames - firstFrames) * mixxx::kEngineChannelOutputCount,
+            kOutputTolerance);
+    if (m_inputMatches && firstMatches && secondMatches) {
+        m_matchingFrames += numFrames;
+    } else {
+        m_matchingFrames = 0;
+    }
+    advance();
+    if (m_matchingFrames >= m_loopPeriodFrames) {
+        m_frozen = true;
+    }
+}
+
+void FrozenEffectsCache::Slot::advance() {
+    const SINT numFrames = m_numSamples / mixxx::kEngineChannelOutputCount;
+    m_offsetFrames = (m_offsetFrames + numFrames) % m_loopPeriodFrames;
+    // Saturates, only a whole recorded period matters
+    m_recordedFrames = math_min(m_recordedFrames + numFrames, m_loopPeriodFrames);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+
+#include "effects/defs.h"
+#include "engine/channelhandle.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// FrozenEffectsCache replays the effects output of an input channel that
+/// plays back a loop while the effects are "frozen", i.e. none of their
+/// parameters changes. It is created in the main thread when the freeze is
+/// enabled for the channel and handed over to the EngineEffectsManager.
+///
+/// The effects are processed live while the cache records the input and the
+/// output of the effect chains for the last loop period. Once a whole period
+/// has repeated the recorded input exactly and the recorded output within a
+/// tiny tolerance, the effect tails have settled and the chains are no longer
+/// processed for the channel. The output is replayed from the cache as long
+/// as the input keeps repeating and neither the parameters of the chains nor
+/// the gain change. Otherwise the channel falls back to live processing with
+/// a crossfade from the replayed output within the first buffer.
+///
+/// Each signal processing stage and output channel of the input channel is
+/// recorded separately, up to kMaxSlots of them.
+class FrozenEffectsCache final {
+  public:
+    static constexpr int kMaxSlots = 3;
+
+    class Slot {
+      public:
+        Slot() = default;
+
+        /// Stores the input of the chains for the current buffer and returns
+        /// true if the output can be replayed instead of processing the
+        /// chains. Otherwise the processed output must be passed to
+        /// endBuffer() afterwards.
+        bool beginBuffer(const CSAMPLE* pIn,
+                SINT numSamples,
+                SINT loopPeriodFrames,
+                quint64 chainsRevision,
+                CSAMPLE_GAIN oldGain,
+                CSAMPLE_GAIN newGain);
+        /// Copies or adds the replayed output for the current buffer to
+        /// pOut and finishes the buffer.
+        void replay(CSAMPLE* pOut, bool addToOutput);
+        /// Records the live output of the chains for the current buffer.
+        /// pProcessed is crossfaded from the replayed output if the cache
+        /// has stopped replaying within this buffer.
+        void endBuffer(CSAMPLE* pProcessed);
+
+        bool isFrozen() const {
+            return m_frozen;
+        }
+
+      private:
+        friend class FrozenEffectsCache;
+
+        void reset(SINT loopPeriodFrames);
+        void advance();
+        /// Copies the recorded output of the current buffer into pDest
+        void readOutput(CSAMPLE* pDest) const;
+
+        SignalProcessingStage m_stage = SignalProcessingStage::Prefader;
+        ChannelHandle m_outputHandle;
+        bool m_assigned = false;
+
+        mixxx::SampleBuffer m_input;
+        mixxx::SampleBuffer m_output;
+        // A scratch buffer for the crossfade to the live output
+        mixxx::SampleBuffer m_fadeOut;
+
+        SINT m_loopPeriodFrames = 0;
+        // The position within the loop period
+        SINT m_offsetFrames = 0;
+        SINT m_recordedFrames = 0;
+        // The number of consecutive frames that matched the recording of
+        // the previous loop period
+        SINT m_matchingFrames = 0;
+        quint64 m_chainsRevision = 0;
+        CSAMPLE_GAIN m_gain = CSAMPLE_GAIN_ONE;
+        bool m_frozen = false;
+
+        // The state of the current buffer
+        SINT m_numSamples = 0;
+        bool m_recording = false;
+        bool m_inputMatches = false;
+        bool m_fadeToLive = false;
+    };
+
+    /// called from main thread
+    explicit FrozenEffectsCache(SINT capacityFrames);
+
+    /// Returns the slot for the stage and the output channel, which is
+    /// assigned when it is requested for the first time. Returns nullptr
+    /// if all slots have been assigned already.
+    /// called from audio thread
+    Slot* slot(SignalProcessingStage stage, const ChannelHandle& outputHandle);
+
+  private:
+    std::array<Slot, kMaxSlots> m_slots;
+};
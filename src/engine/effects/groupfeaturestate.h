@@ -1,6 +1,7 @@
 #pragma once
 
 #include "proto/keys.pb.h"
+#include "util/types.h"
 
 /// GroupFeatureState communicates metadata about EngineChannels to EffectProcessors.
 struct GroupFeatureState {
@@ -10,7 +11,9 @@ struct GroupFeatureState {
               has_beat_fraction(false),
               beat_fraction(0.0),
               has_gain(false),
-              gain(1.0) {
+              gain(1.0),
+              has_loop_period_frames(false),
+              loop_period_frames(0) {
     }
 
     // The beat length in seconds.
@@ -24,4 +27,9 @@ struct GroupFeatureState {
 
     bool has_gain;
     double gain;
+
+    // The number of frames after which the audio of the channel repeats
+    // while it plays a loop, see EngineBuffer::getLoopPeriodFrames().
+    bool has_loop_period_frames;
+    SINT loop_period_frames;
 };
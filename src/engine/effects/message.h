@@ -12,6 +12,7 @@
 
 class EngineEffectChain;
 class EngineEffect;
+class FrozenEffectsCache;
 
 struct EffectsRequest {
     enum MessageType {
@@ -25,11 +26,18 @@ struct EffectsRequest {
         // the outputs that effects are applied to are hardwired in EngineMixer
         ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
         DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
+        // Sent by the EffectsMessenger after a DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
+        // request has been processed, to return the EffectStates of the input
+        // channel for deletion once the effects have faded out.
+        DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL,
 
         // Messages for EngineEffect
         SET_EFFECT_PARAMETERS,
         SET_PARAMETER_PARAMETERS,
 
+        // Messages for EngineEffectsManager
+        SET_FROZEN_EFFECTS_CACHE,
+
         // Must come last.
         NUM_REQUEST_TYPES
     };
@@ -39,6 +47,7 @@ struct EffectsRequest {
     EffectsRequest()
             : type(NUM_REQUEST_TYPES),
               request_id(-1),
+              batchSize(1),
               value(0.0) {
         pTargetChain = nullptr;
         pTargetEffect = nullptr;
@@ -46,6 +55,10 @@ struct EffectsRequest {
 
     MessageType type;
     qint64 request_id;
+    // The number of requests, including this one, which have to be processed
+    // together within the same callback. Only set on the first request of a
+    // batch, see EffectsMessenger::beginBatch().
+    int batchSize;
 
     // Target of the message.
     union {
@@ -55,6 +68,7 @@ struct EffectsRequest {
         // - SET_EFFECT_CHAIN_PARAMETERS
         // - ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
         // - DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
+        // - DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL
         EngineEffectChain* pTargetChain;
         // Used by:
         // - SET_EFFECT_PARAMETER
@@ -73,10 +87,20 @@ struct EffectsRequest {
         } RemoveEffectChain;
         struct {
             ChannelHandle channelHandle;
+            // Allocated in the main thread, indexed by the position of the
+            // effect in the chain. The engine swaps in the EffectStates and
+            // returns the replaced ones in the same array.
+            EffectStatesMapArray* pEffectStatesMapArray;
         } EnableInputChannelForChain;
         struct {
             ChannelHandle channelHandle;
         } DisableInputChannelForChain;
+        struct {
+            ChannelHandle channelHandle;
+            // Allocated empty in the main thread, the engine moves the
+            // EffectStates of the input channel into it.
+            EffectStatesMapArray* pEffectStatesMapArray;
+        } DeleteEffectStatesForInputChannel;
         struct {
             EngineEffect* pEffect;
             int iIndex;
@@ -96,6 +120,13 @@ struct EffectsRequest {
         struct {
             int iParameter;
         } SetParameterParameters;
+        struct {
+            ChannelHandle channelHandle;
+            // Allocated in the main thread, or null for unfreezing the
+            // effects of the input channel. The engine swaps in the cache
+            // and returns the replaced one for deletion.
+            FrozenEffectsCache* pCache;
+        } SetFrozenEffectsCache;
     };
 
     // Used by SET_EFFECT_PARAMETER.
@@ -1,6 +1,7 @@
 #include "engine/enginebuffer.h"
 
 #include <QtDebug>
+#include <cmath>
 
 #include "control/controllinpotmeter.h"
 #include "control/controlpotmeter.h"
@@ -50,6 +51,10 @@ constexpr double kLinearScalerElipsis =
 // Rate at which the playpos slider is updated
 constexpr int kPlaypositionUpdateRate = 15; // updates per second
 
+// The number of passes of a loop with a fractional length that are
+// tried for finding an integer number of frames after which it repeats
+constexpr int kMaxLoopPeriodPasses = 4;
+
 const QString kAppGroup = QStringLiteral("[App]");
 
 } // anonymous namespace
@@ -73,6 +78,7 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_speed_old(0),
           m_tempo_ratio_old(1.),
           m_scratching_old(false),
+          m_bAtRest(false),
           m_reverse_old(false),
           m_pitch_old(0),
           m_baserate_old(0),
@@ -85,6 +91,7 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_pRepeat(nullptr),
           m_startButton(nullptr),
           m_endButton(nullptr),
+          m_pStandbyScale(nullptr),
           m_bScalerOverride(false),
           m_iSeekPhaseQueued(0),
           m_iEnableSyncQueued(SYNC_REQUEST_NONE),
@@ -94,7 +101,10 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_pCrossfadeBuffer(SampleUtil::alloc(
                   kMaxEngineFrames * mixxx::kMaxEngineChannelInputCount)),
           m_bCrossfadeReady(false),
-          m_iLastBufferSize(0) {
+          m_iLastBufferSize(0),
+          m_activeChannelPairs(~std::uint32_t{0}),
+          m_scaleProfilerStage(CallbackProfiler::instance().registerStage(
+                  QStringLiteral("EngineBufferScale ") + group)) {
     // This should be a static assertion, but isValid() is not constexpr.
     DEBUG_ASSERT(kInitialPlayPosition.isValid());
 
@@ -267,6 +277,8 @@ EngineBuffer::EngineBuffer(const QString& group,
     m_pScaleVinyl = m_pScaleLinear;
     m_pScale = m_pScaleVinyl;
     m_pScale->clear();
+    // Prime the keylock scaler, so enabling keylock doesn't reset it
+    m_pStandbyScale = m_pScaleKeylock;
     m_bScalerChanged = true;
 
     m_pPassthroughEnabled = new ControlProxy(group, "passthrough", this);
@@ -349,6 +361,7 @@ void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
             // applied later
             readToCrossfadeBuffer(iBufferSize);
         }
+        m_pStandbyScale = m_pScale;
         m_pScale = keylock_scale;
         m_pScale->clear();
         m_bScalerChanged = true;
@@ -358,6 +371,7 @@ void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
             // (for slow speeds below 0.1 the vinyl_scale is used)
             readToCrossfadeBuffer(iBufferSize);
         }
+        m_pStandbyScale = m_pScale;
         m_pScale = vinyl_scale;
         m_pScale->clear();
         m_bScalerChanged = true;
@@ -446,6 +460,32 @@ void EngineBuffer::requestSyncMode(SyncMode mode) {
     }
 }
 
+bool EngineBuffer::isSynchronized() const {
+    return m_pSyncControl->isSynchronized();
+}
+
+void EngineBuffer::setAudible(bool audible) {
+    m_pReader->setSchedulingPriority(audible
+                    ? EngineWorker::SchedulingPriority::Audible
+                    : EngineWorker::SchedulingPriority::Normal);
+}
+
+void EngineBuffer::setPreloadAllTracks(bool preloadAllTracks) {
+    m_pReader->setPreloadAllTracks(preloadAllTracks);
+}
+
+void EngineBuffer::setPreviewMode(bool previewMode) {
+    m_pReader->setPreviewMode(previewMode);
+}
+
+void EngineBuffer::setSynchronousReads(bool synchronousReads) {
+    m_pReader->setSynchronousReads(synchronousReads);
+}
+
+void EngineBuffer::setDecodedChannelPairs(std::uint32_t channelPairs) {
+    m_pReader->setChannelPairs(channelPairs);
+}
+
 void EngineBuffer::readToCrossfadeBuffer(const int iBufferSize) {
     if (!m_bCrossfadeReady) {
         // Read buffer, as if there where no parameter change
@@ -502,6 +542,28 @@ bool EngineBuffer::isReverse() const {
     return m_reverse_old;
 }
 
+SINT EngineBuffer::getLoopPeriodFrames() const {
+    if (m_speed_old != 1.0 || m_scratching_old ||
+            !m_pLoopingControl->isLoopingEnabled()) {
+        return 0;
+    }
+    const LoopingControl::LoopInfo loopInfo = m_pLoopingControl->getLoopInfo();
+    if (!loopInfo.startPosition.isValid() || !loopInfo.endPosition.isValid()) {
+        return 0;
+    }
+    const mixxx::audio::FrameDiff_t loopFrames =
+            loopInfo.endPosition - loopInfo.startPosition;
+    for (int passes = 1; passes <= kMaxLoopPeriodPasses; ++passes) {
+        const double periodFrames = passes * loopFrames;
+        const double roundedPeriodFrames = std::round(periodFrames);
+        if (roundedPeriodFrames > 0 &&
+                std::abs(periodFrames - roundedPeriodFrames) < 0.000001) {
+            return static_cast<SINT>(roundedPeriodFrames);
+        }
+    }
+    return 0;
+}
+
 // WARNING: Always called from the EngineWorker thread pool
 void EngineBuffer::slotTrackLoading() {
     // Pause EngineBuffer from processing frames
@@ -540,7 +602,9 @@ void EngineBuffer::slotTrackLoaded(TrackPointer pTrack,
 
     m_visualPlayPos->setInvalid();
     m_playPos = kInitialPlayPosition; // for execute seeks to 0.0
+    m_bAtRest = false;
     m_pCurrentTrack = pTrack;
+    m_pReadAheadManager->notifyTrackChanged();
 
     m_channelCount = trackChannelCount;
     if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
@@ -623,10 +687,13 @@ void EngineBuffer::ejectTrack() {
             0.0,
             0.0,
             0.0,
+            0.0,
+            0.0,
             0.0);
     doSeekPlayPos(mixxx::audio::kStartFramePos, SEEK_EXACT);
 
     m_pCurrentTrack.reset();
+    m_pReadAheadManager->notifyTrackChanged();
     setTrackEndPosition(mixxx::audio::kInvalidFramePos);
     m_pTrackSampleRate->set(0);
     m_pTrackLoaded->forceSet(0);
@@ -874,6 +941,16 @@ void EngineBuffer::processTrackLocked(
         baseSampleRate = m_trackSampleRateOld / sampleRate;
     }
 
+    if (m_pStandbyScale) {
+        // Reset the scaler we have switched away from in the callback after
+        // the switch. The reset of RubberBand runs its start padding through
+        // the stretcher, which is done here instead of when switching back.
+        if (m_pStandbyScale != m_pScale) {
+            m_pStandbyScale->clear();
+        }
+        m_pStandbyScale = nullptr;
+    }
+
     // Sync requests can affect rate, so process those first.
     processSyncRequests();
 
@@ -1094,7 +1171,12 @@ void EngineBuffer::processTrackLocked(
     // If the buffer is not paused, then scale the audio.
     if (!bCurBufferPaused) {
         // Perform scaling of Reader buffer into buffer.
-        const double framesRead = m_pScale->scaleBuffer(pOutput, iBufferSize);
+        double framesRead;
+        {
+            const CallbackProfiler::Scope profilerScope(m_scaleProfilerStage);
+            m_pScale->setActiveChannelPairs(m_activeChannelPairs);
+            framesRead = m_pScale->scaleBuffer(pOutput, iBufferSize);
+        }
 
         // TODO(XXX): The result framesRead might not be an integer value.
         // Converting to samples here does not make sense. All positional
@@ -1146,6 +1228,10 @@ void EngineBuffer::processTrackLocked(
 
     m_scratching_old = is_scratching;
 
+    m_bAtRest = paused && bCurBufferPaused && rate == 0 && !is_scratching &&
+            !m_previousBufferSeek && !m_bCrossfadeReady &&
+            !m_bSlipEnabledProcessing;
+
     // If we're repeating and crossed the track boundary, ReadAheadManager already
     // wrapped around the playposition.
     // To ensure quantize is respected we request a phase sync.
@@ -1178,6 +1264,7 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     VERIFY_OR_DEBUG_ASSERT((iBufferSize % m_channelCount) == 0) {
         return;
     }
+    const bool controlsChanged = m_controlSnapshot.update();
     m_pReader->process();
     // Steps:
     // - Lookup new reader information
@@ -1202,7 +1289,11 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
 
     bool hasStableTrack = m_pTrackLoaded->toBool() && m_iTrackLoading.loadAcquire() == 0;
     if (hasStableTrack && m_pause.tryLock()) {
-        processTrackLocked(pOutput, iBufferSize, m_sampleRate);
+        if (m_bAtRest && canStayIdle(controlsChanged)) {
+            processIdle(pOutput, iBufferSize);
+        } else {
+            processTrackLocked(pOutput, iBufferSize, m_sampleRate);
+        }
         // release the pauselock
         m_pause.unlock();
     } else {
@@ -1227,6 +1318,7 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
         m_rate_old = 0;
         m_speed_old = 0;
         m_scratching_old = false;
+        m_bAtRest = false;
     }
 
 #ifdef __SCALER_DEBUG__
@@ -1241,6 +1333,33 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     m_bCrossfadeReady = false;
 }
 
+bool EngineBuffer::canStayIdle(bool controlsChanged) const {
+    if (controlsChanged ||
+            m_playButton->toBool() ||
+            m_queuedSeek.getValue().seekType != SEEK_NONE ||
+            atomicLoadRelaxed(m_iSeekPhaseQueued) != 0 ||
+            atomicLoadRelaxed(m_iEnableSyncQueued) != SYNC_REQUEST_NONE ||
+            atomicLoadRelaxed(m_iSyncModeQueued) != static_cast<int>(SyncMode::Invalid) ||
+            m_pSlipButton->toBool() != m_bSlipEnabledProcessing ||
+            m_bScalerChanged) {
+        return false;
+    }
+    for (const auto& pControl : m_engineControls) {
+        if (!pControl->isIdle()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EngineBuffer::processIdle(CSAMPLE* pOutput, const int iBufferSize) {
+    // Nothing has moved since the last processed callback, so the scaler,
+    // the EngineControls and the hints are still up to date. The hints are
+    // passed again to keep the chunks around the play position cached.
+    SampleUtil::clear(pOutput, iBufferSize);
+    m_pReader->hintAndMaybeWake(m_hintList);
+}
+
 void EngineBuffer::processSlip(int iBufferSize) {
     // Do a single read from m_bSlipEnabled so we don't run in to race conditions.
     bool enabled = m_pSlipButton->toBool();
@@ -1507,7 +1626,9 @@ void EngineBuffer::updateIndicators(double speed, int iBufferSize) {
             fFractionalLoopStartPos,
             fFractionalLoopEndPos,
             tempoTrackSeconds,
-            iBufferSize / mixxx::kEngineChannelOutputCount / m_sampleRate.toDouble() * 1000000.0);
+            iBufferSize / mixxx::kEngineChannelOutputCount / m_sampleRate.toDouble() * 1000000.0,
+            getRateRatio(),
+            m_trackEndPositionOld.toEngineSamplePos());
 
     // TODO: Especially with long audio buffers, jitter is visible. This can be fixed by moving the
     // ClockControl::updateIndicators into the waveform update loop which is synced with the display refresh rate.
@@ -1536,6 +1657,13 @@ void EngineBuffer::hintReader(const double dRate) {
     for (const auto& pControl : std::as_const(m_engineControls)) {
         pControl->hintReader(&m_hintList);
     }
+    if (m_scratching_old) {
+        m_pReader->setActivity(CachingReader::Activity::Scratching);
+    } else if (dRate != 0) {
+        m_pReader->setActivity(CachingReader::Activity::Playing);
+    } else {
+        m_pReader->setActivity(CachingReader::Activity::Paused);
+    }
     m_pReader->hintAndMaybeWake(m_hintList);
 }
 
@@ -1557,6 +1685,7 @@ void EngineBuffer::addControl(EngineControl* pControl) {
     // Connect to signals from EngineControl here...
     m_engineControls.push_back(pControl);
     pControl->setEngineBuffer(this);
+    pControl->subscribeControls(&m_controlSnapshot);
 }
 
 bool EngineBuffer::isTrackLoaded() const {
@@ -1606,6 +1735,11 @@ void EngineBuffer::collectFeatures(GroupFeatureState* pGroupFeatures) const {
     if (m_pBpmControl != nullptr) {
         m_pBpmControl->collectFeatures(pGroupFeatures);
     }
+    const SINT loopPeriodFrames = getLoopPeriodFrames();
+    if (loopPeriodFrames > 0) {
+        pGroupFeatures->has_loop_period_frames = true;
+        pGroupFeatures->loop_period_frames = loopPeriodFrames;
+    }
 }
 
 void EngineBuffer::slotUpdatedTrackBeats() {
@@ -1624,6 +1758,7 @@ void EngineBuffer::setScalerForTest(
     m_pScaleKeylock = pScaleKeylock;
     m_pScale = m_pScaleVinyl;
     m_pScale->clear();
+    m_pStandbyScale = nullptr;
     m_bScalerChanged = true;
     // This bool is permanently set and can't be undone.
     m_bScalerOverride = true;
@@ -4,10 +4,12 @@
 
 #include <QAtomicInt>
 #include <QMutex>
+#include <cstdint>
 #include <initializer_list>
 
 #include "audio/frame.h"
 #include "audio/types.h"
+#include "control/controlsnapshot.h"
 #include "control/controlvalue.h"
 #include "engine/cachingreader/cachingreader.h"
 #include "engine/engineobject.h"
@@ -16,6 +18,7 @@
 #include "preferences/usersettings.h"
 #include "track/bpm.h"
 #include "track/track_decl.h"
+#include "util/callbackprofiler.h"
 #include "util/types.h"
 
 #ifdef __RUBBERBAND__
@@ -114,8 +117,23 @@ class EngineBuffer : public EngineObject {
     mixxx::audio::ChannelCount getChannelCount() const {
         return m_channelCount;
     }
+    /// Selects the stereo channel pairs of a stem track that need to be
+    /// scaled, see EngineBufferScale::setActiveChannelPairs(). Called from
+    /// the engine thread before process().
+    void setActiveChannelPairs(std::uint32_t activeChannelPairs) {
+        m_activeChannelPairs = activeChannelPairs;
+    }
+    /// Selects the stereo channel pairs of a stem track that need to be
+    /// decoded, see CachingReader::setChannelPairs(). Called from the
+    /// engine thread before process().
+    void setDecodedChannelPairs(std::uint32_t channelPairs);
     bool getScratching() const;
     bool isReverse() const;
+    /// Returns the number of frames after which the output repeats while a
+    /// loop is played forward at the original speed, or 0 otherwise.
+    /// A loop with a fractional length only repeats after several passes.
+    /// (not thread-safe)
+    SINT getLoopPeriodFrames() const;
     /// Returns current bpm value (not thread-safe)
     mixxx::Bpm getBpm() const;
     /// Returns the BPM of the loaded track around the current position (not thread-safe)
@@ -134,6 +152,21 @@ class EngineBuffer : public EngineObject {
     void requestSyncPhase();
     void requestEnableSync(bool enabled);
     void requestSyncMode(SyncMode mode);
+    /// Returns true if the deck is a sync leader or follower (not thread-safe)
+    bool isSynchronized() const;
+    /// Lets the reader of an audible deck get its chunks read first.
+    /// called from audio thread
+    void setAudible(bool audible);
+    /// Decodes every track completely when loading it instead of streaming
+    /// it, so the first read never misses. Used for samplers.
+    void setPreloadAllTracks(bool preloadAllTracks);
+    /// Starts playing the tracks that have been prefetched for previewing
+    /// without decoding them first. Used for preview decks.
+    void setPreviewMode(bool previewMode);
+    /// Waits for the reader on a cache miss instead of playing silence, see
+    /// CachingReader::setSynchronousReads(). Must only be enabled while the
+    /// engine is not driven by a sound device.
+    void setSynchronousReads(bool synchronousReads);
 
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const int iBufferSize) override;
@@ -294,6 +327,10 @@ class EngineBuffer : public EngineObject {
     void processTrackLocked(CSAMPLE* pOutput,
             const int iBufferSize,
             mixxx::audio::SampleRate sampleRate);
+    /// Returns true if nothing has been requested that would move the deck
+    /// since it came to rest
+    bool canStayIdle(bool controlsChanged) const;
+    void processIdle(CSAMPLE* pOutput, const int iBufferSize);
 
     // Holds the name of the control group
     const QString m_group;
@@ -315,6 +352,7 @@ class EngineBuffer : public EngineObject {
     FRIEND_TEST(EngineSyncTest, FollowerUserTweakPreservedInLeaderChange);
     FRIEND_TEST(EngineSyncTest, BeatMapQuantizePlay);
     FRIEND_TEST(EngineBufferTest, ScalerNoTransport);
+    FRIEND_TEST(EngineBufferTest, IdleDeckWakesUp);
     EngineSync* m_pEngineSync;
     SyncControl* m_pSyncControl;
     VinylControlControl* m_pVinylControlControl;
@@ -327,6 +365,8 @@ class EngineBuffer : public EngineObject {
     CueControl* m_pCueControl;
 
     QList<EngineControl*> m_engineControls;
+    // The values of the controls that the EngineControls read in process()
+    ControlSnapshot m_controlSnapshot;
 
     // The read ahead manager for EngineBufferScale's that need to read ahead
     ReadAheadManager* m_pReadAheadManager;
@@ -350,6 +390,10 @@ class EngineBuffer : public EngineObject {
     // True if the previous callback was scratching.
     bool m_scratching_old;
 
+    // True if the previous callback was paused, not scratching and did not
+    // seek, i.e. the next callback has nothing to do unless requested.
+    bool m_bAtRest;
+
     // True if the previous callback was reverse.
     bool m_reverse_old;
 
@@ -439,6 +483,10 @@ class EngineBuffer : public EngineObject {
     EngineBufferScaleRubberBand* m_pScaleRB;
 #endif
 
+    // The scaler that has been switched away from and is reset in the next
+    // callback, so switching back to it doesn't need to reset it.
+    EngineBufferScale* m_pStandbyScale;
+
     // Indicates whether the scaler has changed since the last process()
     bool m_bScalerChanged;
     // Indicates that dependency injection has taken place.
@@ -479,6 +527,10 @@ class EngineBuffer : public EngineObject {
     int m_iLastBufferSize;
 
     QSharedPointer<VisualPlayPosition> m_visualPlayPos;
+
+    std::uint32_t m_activeChannelPairs;
+
+    const CallbackProfiler::StageId m_scaleProfilerStage;
 };
 
 Q_DECLARE_METATYPE(EngineBuffer::KeylockEngine)
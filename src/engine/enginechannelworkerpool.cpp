@@ -0,0 +1,106 @@
+#include "engine/enginechannelworkerpool.h"
+
+#include "engine/channels/enginechannel.h"
+#include "util/assert.h"
+#include "util/denormalsarezero.h"
+#include "util/flightrecorder.h"
+#include "util/realtimeaudit.h"
+#include "util/threadplacement.h"
+
+EngineChannelWorkerPool::ChannelTask::ChannelTask()
+        : QRunnable(),
+          m_completedSema(0),
+          m_pChannel(nullptr),
+          m_pOut(nullptr),
+          m_iBufferSize(0) {
+    setAutoDelete(false);
+}
+
+void EngineChannelWorkerPool::ChannelTask::set(
+        EngineChannel* pChannel, CSAMPLE* pOut, int iBufferSize) {
+    DEBUG_ASSERT(m_completedSema.available() == 0);
+    m_pChannel = pChannel;
+    m_pOut = pOut;
+    m_iBufferSize = iBufferSize;
+}
+
+void EngineChannelWorkerPool::ChannelTask::waitReady() {
+    VERIFY_OR_DEBUG_ASSERT(m_pChannel) {
+        return;
+    }
+    m_completedSema.acquire();
+    m_pChannel = nullptr;
+}
+
+void EngineChannelWorkerPool::ChannelTask::run() {
+    VERIFY_OR_DEBUG_ASSERT(m_completedSema.available() == 0 && m_pChannel && m_pOut) {
+        return;
+    }
+    mixxx::ThreadPlacement::applyToCurrentThreadOnce(mixxx::ThreadPlacement::Role::ChannelWorker);
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    // Worker threads do not inherit the floating point environment of the
+    // audio callback thread. Both calls are very fast.
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+    {
+        // The channel is processed on behalf of the audio callback
+        const mixxx::realtimeaudit::CallbackScope realtimeAuditScope;
+        const FlightRecorder::CallbackScope flightRecorderCallbackScope;
+        const mixxx::realtimeaudit::ObjectScope realtimeAuditObject(
+                "channel", m_pChannel->getGroup());
+        const CallbackProfiler::Scope profilerScope(m_pChannel->profilerStage());
+        m_pChannel->process(m_pOut, m_iBufferSize);
+    }
+    m_completedSema.release();
+}
+
+EngineChannelWorkerPool::EngineChannelWorkerPool(int numThreads, int maxChannels)
+        : QThreadPool(),
+          m_numScheduled(0) {
+    DEBUG_ASSERT(numThreads > 0);
+    setThreadPriority(QThread::TimeCriticalPriority);
+    setMaxThreadCount(numThreads);
+    // Once spawned, the worker threads are kept alive for the lifetime of the
+    // pool to avoid thread creation in the audio callback.
+    setExpiryTimeout(-1);
+
+    m_tasks.reserve(maxChannels);
+    for (int i = 0; i < maxChannels; ++i) {
+        m_tasks.push_back(std::make_unique<ChannelTask>());
+    }
+    m_deferredTasks.reserve(maxChannels);
+}
+
+EngineChannelWorkerPool::~EngineChannelWorkerPool() {
+    waitForDone();
+}
+
+void EngineChannelWorkerPool::schedule(
+        EngineChannel* pChannel, CSAMPLE* pOut, int iBufferSize) {
+    VERIFY_OR_DEBUG_ASSERT(m_numScheduled < static_cast<int>(m_tasks.size())) {
+        // Out of preallocated tasks, process directly
+        pChannel->process(pOut, iBufferSize);
+        return;
+    }
+    ChannelTask* pTask = m_tasks[m_numScheduled++].get();
+    pTask->set(pChannel, pOut, iBufferSize);
+    if (!tryStart(pTask)) {
+        // All workers are busy. The engine thread will process this
+        // channel in join() after all other channels have been scheduled.
+        m_deferredTasks.append(pTask);
+    }
+}
+
+void EngineChannelWorkerPool::join() {
+    for (ChannelTask* pTask : std::as_const(m_deferredTasks)) {
+        pTask->run();
+    }
+    m_deferredTasks.clear();
+    // We always perform a wait, even for tasks that were run in the engine
+    // thread, so it resets the semaphore.
+    for (int i = 0; i < m_numScheduled; ++i) {
+        m_tasks[i]->waitReady();
+    }
+    m_numScheduled = 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QVarLengthArray>
+#include <memory>
+#include <vector>
+
+#include "util/types.h"
+
+class EngineChannel;
+
+/// A fork/join pool that processes independent EngineChannels on pre-spawned
+/// worker threads during the audio callback.
+///
+/// The engine thread schedules all channels with schedule(), which hands the
+/// job over to an idle worker if one is available. Jobs that could not be
+/// handed over are kept and processed by the engine thread itself in join(),
+/// so the engine thread never sits idle while the workers are busy.
+class EngineChannelWorkerPool : public QThreadPool {
+  public:
+    /// @param numThreads the number of worker threads in addition to the
+    /// engine thread. Must be > 0.
+    /// @param maxChannels the maximum number of channels that can be
+    /// scheduled between two join() calls
+    EngineChannelWorkerPool(int numThreads, int maxChannels);
+    ~EngineChannelWorkerPool() override;
+
+    /// Schedule the processing of a channel into pOut. The buffer must remain
+    /// valid until join() returns.
+    void schedule(EngineChannel* pChannel, CSAMPLE* pOut, int iBufferSize);
+
+    /// Process all channels that have not been picked up by a worker on the
+    /// calling thread and wait until all scheduled channels are processed.
+    void join();
+
+  private:
+    class ChannelTask : public QRunnable {
+      public:
+        ChannelTask();
+
+        void set(EngineChannel* pChannel, CSAMPLE* pOut, int iBufferSize);
+        void waitReady();
+        void run() override;
+
+      private:
+        QSemaphore m_completedSema;
+        EngineChannel* m_pChannel;
+        CSAMPLE* m_pOut;
+        int m_iBufferSize;
+    };
+
+    std::vector<std::unique_ptr<ChannelTask>> m_tasks;
+    int m_numScheduled;
+    // Tasks which have been scheduled but not picked up by a worker thread.
+    QVarLengthArray<ChannelTask*, 64> m_deferredTasks;
+};
@@ -1,5 +1,8 @@
 #include "engine/enginemixer.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "audio/types.h"
 #include "control/controlaudiotaperpot.h"
 #include "control/controlpotmeter.h"
@@ -9,23 +12,40 @@
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
+#include "engine/enginechannelworkerpool.h"
 #include "engine/enginedelay.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
 #include "engine/enginexfader.h"
+#include "engine/sidechain/enginemultitrackrecorder.h"
 #include "engine/sidechain/enginesidechain.h"
 #include "engine/sync/enginesync.h"
 #include "mixer/playermanager.h"
 #include "moc_enginemixer.cpp"
 #include "preferences/usersettings.h"
+#include "util/controllerlatency.h"
 #include "util/defs.h"
+#include "util/realtimeaudit.h"
 #include "util/sample.h"
+#include "util/stat.h"
+#include "util/statsmanager.h"
+#include "util/time.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
 const QString kLegacyGroup = QStringLiteral("[Master]");
 const QString kMainGroup = QStringLiteral("[Main]");
+const QString kCallbackDurationTag = QStringLiteral("EngineMixer::process");
+
+void trackCallbackDuration(mixxx::Duration duration) {
+    // The histogram stores distinct values, so they are rounded to 0.1 ms
+    Stat::track(kCallbackDurationTag,
+            Stat::DURATION_MSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN |
+                    Stat::MAX | Stat::HISTOGRAM),
+            std::round(duration.toDoubleMillis() * 10) / 10);
+}
 } // namespace
 
 EngineMixer::EngineMixer(
@@ -49,7 +69,11 @@ EngineMixer::EngineMixer(
           m_busTalkoverHandle(registerChannelGroup("[BusTalkover]")),
           m_busCrossfaderLeftHandle(registerChannelGroup("[BusLeft]")),
           m_busCrossfaderCenterHandle(registerChannelGroup("[BusCenter]")),
-          m_busCrossfaderRightHandle(registerChannelGroup("[BusRight]")) {
+          m_busCrossfaderRightHandle(registerChannelGroup("[BusRight]")),
+          m_profilerStage(CallbackProfiler::instance().registerStage(
+                  QStringLiteral("EngineMixer::process"))),
+          m_flightRecorderName(FlightRecorder::instance().registerName(
+                  QStringLiteral("EngineMixer::process"))) {
     pEffectsManager->registerInputChannel(m_mainHandle);
     pEffectsManager->registerInputChannel(m_headphoneHandle);
     pEffectsManager->registerOutputChannel(m_mainHandle);
@@ -67,6 +91,20 @@ EngineMixer::EngineMixer(
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    // Optional fork/join processing of independent channels. The value is the
+    // number of worker threads used in addition to the engine thread.
+    const int channelWorkerThreads = math_min(
+            pConfig->getValue(ConfigKey(kAppGroup,
+                                      QStringLiteral("engine_channel_threads")),
+                    0),
+            QThread::idealThreadCount() - 1);
+    if (channelWorkerThreads > 0) {
+        qDebug() << "EngineMixer will use" << channelWorkerThreads
+                 << "additional threads to process channels";
+        m_pChannelWorkerPool = std::make_unique<EngineChannelWorkerPool>(
+                channelWorkerThreads, kPreallocatedChannels);
+    }
+
     // Main sample rate
     m_pSampleRate = new ControlObject(
             ConfigKey(kAppGroup, QStringLiteral("samplerate")), true, true);
@@ -150,6 +188,7 @@ EngineMixer::EngineMixer(
     m_talkover = mixxx::SampleBuffer(kMaxEngineSamples);
     m_talkoverHeadphones = mixxx::SampleBuffer(kMaxEngineSamples);
     m_sidechainMix = mixxx::SampleBuffer(kMaxEngineSamples);
+    m_talkoverDuckingGains = mixxx::SampleBuffer(kMaxEngineFrames);
     m_head.clear();
     m_main.clear();
     m_booth.clear();
@@ -166,6 +205,7 @@ EngineMixer::EngineMixer(
     // Starts a thread for recording and broadcast
     m_pEngineSideChain =
             bEnableSidechain ? new EngineSideChain(pConfig, m_sidechainMix.data()) : nullptr;
+    m_pMultitrackRecorder = std::make_unique<EngineMultitrackRecorder>();
 
     // X-Fader Setup
     m_pXFaderMode = new ControlPushButton(
@@ -243,6 +283,7 @@ EngineMixer::~EngineMixer() {
     delete m_pMicMonitorMode;
     delete m_pHeadphoneEnabled;
 
+    m_pChannelWorkerPool.reset();
     delete m_pWorkerScheduler;
 
     for (int i = 0; i < m_channels.size(); ++i) {
@@ -297,6 +338,15 @@ void EngineMixer::processChannels(int iBufferSize) {
         }
 
         EngineChannel::ActiveState activeState = pChannel->updateActiveState();
+        EngineBuffer* pBuffer = pChannel->getEngineBuffer();
+        if (pBuffer) {
+            // The reader of a deck that can be heard gets its chunks first
+            pBuffer->setAudible(activeState != EngineChannel::ActiveState::Inactive &&
+                    (pChannel->isPflEnabled() ||
+                            ((pChannel->isMainMixEnabled() ||
+                                     pChannel->isTalkoverEnabled()) &&
+                                    !pChannelInfo->m_pMuteControl->toBool())));
+        }
         if (activeState == EngineChannel::ActiveState::Inactive) {
             continue;
         }
@@ -359,17 +409,30 @@ void EngineMixer::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
-        pChannel->process(pChannelInfo->m_pBuffer.data(), iBufferSize);
+    if (m_pChannelWorkerPool) {
+        processChannelsParallel(activeChannelsStartIndex, iBufferSize);
+    } else {
+        for (int i = activeChannelsStartIndex;
+                i < m_activeChannels.size();
+                ++i) {
+            ChannelInfo* pChannelInfo = m_activeChannels[i];
+            DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
+            const mixxx::realtimeaudit::ObjectScope realtimeAuditObject(
+                    "channel", pChannelInfo->m_pChannel->getGroup());
+            const CallbackProfiler::Scope profilerScope(
+                    pChannelInfo->m_pChannel->profilerStage());
+            pChannelInfo->m_pChannel->process(pChannelInfo->m_pBuffer.data(), iBufferSize);
+        }
+    }
 
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        for (int i = activeChannelsStartIndex;
+                i < m_activeChannels.size();
+                ++i) {
+            ChannelInfo* pChannelInfo = m_activeChannels[i];
             GroupFeatureState features;
-            pChannel->collectFeatures(&features);
+            pChannelInfo->m_pChannel->collectFeatures(&features);
             pChannelInfo->m_features = features;
         }
     }
@@ -399,14 +462,62 @@ void EngineMixer::processChannels(int iBufferSize) {
     }
 }
 
+void EngineMixer::processChannelsParallel(int startIndex, int iBufferSize) {
+    // Hand over all channels that are independent of each other to the
+    // worker pool first, so they are processed while the engine thread takes
+    // care of the channels that interact via EngineSync. The decision is
+    // recorded, because processing the sync leader may change the sync mode
+    // of other channels.
+    QVarLengthArray<bool, kPreallocatedChannels> scheduled(m_activeChannels.size());
+    for (int i = startIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        EngineChannel* pChannel = pChannelInfo->m_pChannel;
+        const EngineBuffer* pBuffer = pChannel->getEngineBuffer();
+        // The sync leader, if any, is at index 0
+        scheduled[i] = i > 0 && !(pBuffer && pBuffer->isSynchronized());
+        if (scheduled[i]) {
+            DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
+            m_pChannelWorkerPool->schedule(pChannel,
+                    pChannelInfo->m_pBuffer.data(),
+                    iBufferSize);
+        }
+    }
+
+    // The sync leader must be processed before all followers, so the
+    // synchronized channels are processed here in order.
+    for (int i = startIndex; i < m_activeChannels.size(); ++i) {
+        if (scheduled[i]) {
+            continue;
+        }
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
+        const mixxx::realtimeaudit::ObjectScope realtimeAuditObject(
+                "channel", pChannelInfo->m_pChannel->getGroup());
+        const CallbackProfiler::Scope profilerScope(
+                pChannelInfo->m_pChannel->profilerStage());
+        pChannelInfo->m_pChannel->process(pChannelInfo->m_pBuffer.data(), iBufferSize);
+    }
+
+    m_pChannelWorkerPool->join();
+}
+
 void EngineMixer::process(const int iBufferSize) {
     DEBUG_ASSERT(iBufferSize <= static_cast<int>(kMaxEngineSamples));
 
     static bool haveSetName = false;
     if (!haveSetName) {
         QThread::currentThread()->setObjectName("Engine");
+        FlightRecorder::instance().nameCurrentThread(QStringLiteral("Engine"));
         haveSetName = true;
     }
+    const mixxx::realtimeaudit::CallbackScope realtimeAuditScope;
+    const CallbackProfiler::Scope profilerScope(m_profilerStage);
+    const FlightRecorder::CallbackScope flightRecorderCallbackScope;
+    const FlightRecorder::Scope flightRecorderScope(m_flightRecorderName);
+    const mixxx::Duration callbackStart = StatsManager::s_bStatsManagerEnabled
+            ? mixxx::Time::elapsed()
+            : mixxx::Duration::empty();
+    mixxx::ControllerLatency::audioCallbackStarted();
     // Trace t("EngineMixer::process");
 
     bool mainEnabled = m_pMainEnabled->toBool();
@@ -417,6 +528,10 @@ void EngineMixer::process(const int iBufferSize) {
     // TODO: remove assumption of stereo buffer
     constexpr unsigned int kChannels = 2;
     const unsigned int iFrames = iBufferSize / kChannels;
+    if (m_sampleRate.isValid()) {
+        CallbackProfiler::instance().setDeadlineNs(
+                static_cast<qint64>(iFrames) * 1000000000 / m_sampleRate.value());
+    }
 
     if (m_pEngineEffectsManager) {
         m_pEngineEffectsManager->onCallbackStart();
@@ -504,12 +619,14 @@ void EngineMixer::process(const int iBufferSize) {
                 false);
     }
 
+    // In AUTO mode the ducking follows the talkover signal within the buffer
+    const CSAMPLE* pTalkoverDuckingKey = nullptr;
     switch (m_pTalkoverDucking->getMode()) {
     case EngineTalkoverDucking::OFF:
         m_pTalkoverDucking->setAboveThreshold(false);
         break;
     case EngineTalkoverDucking::AUTO:
-        m_pTalkoverDucking->processKey(m_talkover.data(), iBufferSize);
+        pTalkoverDuckingKey = m_talkover.data();
         break;
     case EngineTalkoverDucking::MANUAL:
         m_pTalkoverDucking->setAboveThreshold(!m_activeTalkoverChannels.isEmpty());
@@ -528,14 +645,27 @@ void EngineMixer::process(const int iBufferSize) {
                                 m_pXFaderReverse->toBool(),
                                 &crossfaderLeftGain, &crossfaderRightGain);
 
+    // The talkover ducking gain curve is calculated once and applied to
+    // all channels of the main mix before their post-fader effects, like
+    // the channel gains below. The headphone mix has already been made.
+    if (m_pTalkoverDucking->getGains(
+                m_talkoverDuckingGains.data(), pTalkoverDuckingKey, iFrames)) {
+        for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+            for (auto* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+                SampleUtil::applyStereoGainCurve(pChannelInfo->m_pBuffer.data(),
+                        m_talkoverDuckingGains.data(),
+                        iFrames);
+            }
+        }
+    }
+
     // Make the mix for each crossfader orientation output bus.
     // m_mainGain takes care of applying the attenuation from
-    // channel volume faders, crossfader, and talkover ducking.
+    // channel volume faders and crossfader.
     // Talkover is mixed in later according to the configured MicMonitorMode
     m_mainGain.setGains(crossfaderLeftGain,
             1.0f,
-            crossfaderRightGain,
-            m_pTalkoverDucking->getGain(iFrames));
+            crossfaderRightGain);
 
     for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
         ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
@@ -549,6 +679,12 @@ void EngineMixer::process(const int iBufferSize) {
                 m_pEngineEffectsManager);
     }
 
+    // The channel buffers now contain the post-fader signal with post-fader
+    // effects, as mixed into the main output
+    if (m_pMultitrackRecorder->isRecording()) {
+        processMultitrackRecording(iFrames);
+    }
+
     // Process crossfader orientation bus channel effects
     if (m_pEngineEffectsManager) {
         m_pEngineEffectsManager->processPostFaderInPlace(
@@ -819,6 +955,10 @@ void EngineMixer::process(const int iBufferSize) {
     // We're close to the end of the callback. Wake up the engine worker
     // scheduler so that it runs the workers.
     m_pWorkerScheduler->runWorkers();
+
+    if (StatsManager::s_bStatsManagerEnabled) {
+        trackCallbackDuration(mixxx::Time::elapsed() - callbackStart);
+    }
 }
 
 void EngineMixer::applyMainEffects(int bufferSize) {
@@ -939,6 +1079,41 @@ const CSAMPLE* EngineMixer::getOutputBusBuffer(unsigned int i) const {
     return nullptr;
 }
 
+QStringList EngineMixer::getChannelGroups() const {
+    QStringList groups;
+    groups.reserve(m_channels.size());
+    for (const ChannelInfo* pChannelInfo : m_channels) {
+        groups.append(pChannelInfo->m_pChannel->getGroup());
+    }
+    return groups;
+}
+
+void EngineMixer::setSynchronousReads(bool synchronousReads) {
+    for (ChannelInfo* pChannelInfo : std::as_const(m_channels)) {
+        EngineBuffer* pEngineBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+        if (pEngineBuffer) {
+            pEngineBuffer->setSynchronousReads(synchronousReads);
+        }
+    }
+}
+
+void EngineMixer::processMultitrackRecording(int iFrames) {
+    // Resizing within the preallocated capacity does not allocate
+    m_stemBuffers.resize(m_channels.size());
+    std::fill(m_stemBuffers.begin(), m_stemBuffers.end(), nullptr);
+    for (const auto& activeChannels : m_activeBusChannels) {
+        for (const ChannelInfo* pChannelInfo : activeChannels) {
+            m_stemBuffers[pChannelInfo->m_index] = pChannelInfo->m_pBuffer.data();
+        }
+    }
+    for (const ChannelInfo* pChannelInfo : std::as_const(m_activeTalkoverChannels)) {
+        m_stemBuffers[pChannelInfo->m_index] = pChannelInfo->m_pBuffer.data();
+    }
+    m_pMultitrackRecorder->process(m_stemBuffers.constData(),
+            static_cast<int>(m_stemBuffers.size()),
+            iFrames);
+}
+
 const CSAMPLE* EngineMixer::getChannelBuffer(const QString& group) const {
     for (const ChannelInfo* pChannelInfo : m_channels) {
         if (pChannelInfo->m_pChannel->getGroup() == group) {
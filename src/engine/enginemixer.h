@@ -1,8 +1,10 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
 #include <QVarLengthArray>
 #include <atomic>
+#include <memory>
 
 #include "audio/types.h"
 #include "control/controlobject.h"
@@ -15,13 +17,17 @@
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/callbackprofiler.h"
+#include "util/flightrecorder.h"
 #include "util/samplebuffer.h"
 
+class EngineChannelWorkerPool;
 class EngineWorkerScheduler;
 class EngineVuMeter;
 class ControlPotmeter;
 class ControlPushButton;
 class EngineSideChain;
+class EngineMultitrackRecorder;
 class EffectsManager;
 class EngineEffectsManager;
 class EngineSync;
@@ -103,6 +109,19 @@ class EngineMixer : public QObject, public AudioSource {
         return m_pEngineSideChain;
     }
 
+    EngineMultitrackRecorder* getMultitrackRecorder() const {
+        return m_pMultitrackRecorder.get();
+    }
+    // The groups of all channels in the order in which they are passed to
+    // the multitrack recorder. Like addChannel() this is not thread safe.
+    QStringList getChannelGroups() const;
+
+    // Makes the readers of all channels wait for the decoded samples instead
+    // of playing silence, see EngineBuffer::setSynchronousReads(). Only for
+    // driving the engine without a sound device, e.g. by OfflineRenderer.
+    // Like addChannel() this is not thread safe.
+    void setSynchronousReads(bool synchronousReads);
+
     CSAMPLE_GAIN getMainGain(int channelIndex) const;
 
     struct ChannelInfo {
@@ -155,8 +174,7 @@ class EngineMixer : public QObject, public AudioSource {
         OrientationVolumeGainCalculator()
                 : m_dLeftGain(1.0),
                   m_dCenterGain(1.0),
-                  m_dRightGain(1.0),
-                  m_dTalkoverDuckingGain(1.0) {
+                  m_dRightGain(1.0) {
         }
 
         inline CSAMPLE_GAIN getGain(ChannelInfo* pChannelInfo) const override {
@@ -167,24 +185,21 @@ class EngineMixer : public QObject, public AudioSource {
                     m_dLeftGain,
                     m_dCenterGain,
                     m_dRightGain);
-            return channelVolume * orientationGain * m_dTalkoverDuckingGain;
+            return channelVolume * orientationGain;
         }
 
         inline void setGains(CSAMPLE_GAIN leftGain,
                 CSAMPLE_GAIN centerGain,
-                CSAMPLE_GAIN rightGain,
-                CSAMPLE_GAIN talkoverDuckingGain) {
+                CSAMPLE_GAIN rightGain) {
             m_dLeftGain = leftGain;
             m_dCenterGain = centerGain;
             m_dRightGain = rightGain;
-            m_dTalkoverDuckingGain = talkoverDuckingGain;
         }
 
       private:
         CSAMPLE_GAIN m_dLeftGain;
         CSAMPLE_GAIN m_dCenterGain;
         CSAMPLE_GAIN m_dRightGain;
-        CSAMPLE_GAIN m_dTalkoverDuckingGain;
     };
 
     enum class MicMonitorMode {
@@ -257,6 +272,10 @@ class EngineMixer : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(int iBufferSize);
+    // Processes the channels in m_activeChannels starting at startIndex.
+    // Channels which do not take part in sync are processed concurrently by
+    // m_pChannelWorkerPool.
+    void processChannelsParallel(int startIndex, int iBufferSize);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(int bufferSize);
@@ -264,6 +283,8 @@ class EngineMixer : public QObject, public AudioSource {
             const CSAMPLE_GAIN mainMixGainInHeadphones,
             int iBufferSize);
     bool sidechainMixRequired() const;
+    // Passes the post-fader buffers of all channels to m_pMultitrackRecorder
+    void processMultitrackRecording(int iFrames);
 
     EngineEffectsManager* m_pEngineEffectsManager;
 
@@ -291,8 +312,12 @@ class EngineMixer : public QObject, public AudioSource {
     mixxx::SampleBuffer m_talkover;
     mixxx::SampleBuffer m_talkoverHeadphones;
     mixxx::SampleBuffer m_sidechainMix;
+    // The talkover ducking gain of each frame, shared by all channels
+    mixxx::SampleBuffer m_talkoverDuckingGains;
 
     EngineWorkerScheduler* m_pWorkerScheduler;
+    // nullptr if parallel channel processing is disabled
+    std::unique_ptr<EngineChannelWorkerPool> m_pChannelWorkerPool;
     EngineSync* m_pEngineSync;
 
     ControlObject* m_pMainGain;
@@ -311,6 +336,10 @@ class EngineMixer : public QObject, public AudioSource {
 
     EngineVuMeter* m_pVumeter;
     EngineSideChain* m_pEngineSideChain;
+    std::unique_ptr<EngineMultitrackRecorder> m_pMultitrackRecorder;
+    // Pre-allocated buffer pointers for m_pMultitrackRecorder, indexed like
+    // m_channels
+    QVarLengthArray<const CSAMPLE*, kPreallocatedChannels> m_stemBuffers;
 
     ControlPotmeter* m_pCrossfader;
     ControlPotmeter* m_pHeadMix;
@@ -340,6 +369,9 @@ class EngineMixer : public QObject, public AudioSource {
     const ChannelHandleAndGroup m_busCrossfaderCenterHandle;
     const ChannelHandleAndGroup m_busCrossfaderRightHandle;
 
+    const CallbackProfiler::StageId m_profilerStage;
+    const FlightRecorder::NameId m_flightRecorderName;
+
     // Mix two Mono channels. This is useful for outdoor gigs
     ControlObject* m_pMainMonoMixdown;
     ControlObject* m_pMicMonitorMode;
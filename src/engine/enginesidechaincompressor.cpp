@@ -1,12 +1,48 @@
 #include <QtDebug>
+#include <algorithm>
+#include <array>
 
 #include "engine/enginesidechaincompressor.h"
+#include "util/defs.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr int kMaxEnvelopeBlocks =
+        kMaxEngineFrames / EngineSideChainCompressor::kEnvelopeBlockFrames;
+static_assert(kMaxEngineFrames % EngineSideChainCompressor::kEnvelopeBlockFrames == 0);
+
+// Fills pGains with a linear ramp from ratio by step per frame that stops at
+// target. Returns the gain of the last frame.
+CSAMPLE rampGains(CSAMPLE_GAIN* pGains,
+        CSAMPLE ratio,
+        CSAMPLE step,
+        CSAMPLE target,
+        int frames) {
+    if (step < 0) {
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < frames; ++i) {
+            const CSAMPLE_GAIN gain = ratio + step * (i + 1);
+            pGains[i] = gain < target ? target : gain;
+        }
+    } else {
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < frames; ++i) {
+            const CSAMPLE_GAIN gain = ratio + step * (i + 1);
+            pGains[i] = gain > target ? target : gain;
+        }
+    }
+    return pGains[frames - 1];
+}
+
+} // anonymous namespace
 
 EngineSideChainCompressor::EngineSideChainCompressor(const QString& group)
         : m_compressRatio(1.0),
           m_bAboveThreshold(false),
           m_threshold(1.0),
           m_strength(1.0),
+          m_lookaheadBlocks(0),
           m_attackTime(0),
           m_decayTime(0),
           m_attackPerFrame(0.0),
@@ -43,14 +79,7 @@ void EngineSideChainCompressor::setAboveThreshold(bool value) {
 }
 
 void EngineSideChainCompressor::processKey(const CSAMPLE* pIn, const int iBufferSize) {
-    m_bAboveThreshold = false;
-    for (int i = 0; i + 1 < iBufferSize; i += 2) {
-        CSAMPLE val = (pIn[i] + pIn[i + 1]) / 2;
-        if (val > m_threshold) {
-            m_bAboveThreshold = true;
-            return;
-        }
-    }
+    m_bAboveThreshold = SampleUtil::maxMid(pIn, iBufferSize) > m_threshold;
 }
 
 double EngineSideChainCompressor::calculateCompressedGain(int frames) {
@@ -79,3 +108,73 @@ double EngineSideChainCompressor::calculateCompressedGain(int frames) {
     }
     return m_compressRatio;
 }
+
+bool EngineSideChainCompressor::calculateCompressedGains(
+        CSAMPLE_GAIN* pGains, const CSAMPLE* pIn, int frames) {
+    if (frames <= 0) {
+        return false;
+    }
+    const int blocks = (frames + kEnvelopeBlockFrames - 1) / kEnvelopeBlockFrames;
+    VERIFY_OR_DEBUG_ASSERT(blocks <= kMaxEnvelopeBlocks) {
+        const CSAMPLE gain = static_cast<CSAMPLE>(calculateCompressedGain(frames));
+        std::fill(pGains, pGains + frames, gain);
+        return gain < 1;
+    }
+
+    std::array<bool, kMaxEnvelopeBlocks> aboveThreshold;
+    if (pIn) {
+        for (int block = 0; block < blocks; ++block) {
+            const int offset = block * kEnvelopeBlockFrames;
+            const int blockFrames = std::min(kEnvelopeBlockFrames, frames - offset);
+            aboveThreshold[block] =
+                    SampleUtil::maxMid(pIn + offset * 2, blockFrames * 2) > m_threshold;
+        }
+        m_bAboveThreshold = aboveThreshold[blocks - 1];
+        // Start the attack in the blocks before the key exceeds the threshold
+        int nextAboveBlock = -1;
+        for (int block = blocks - 1; block >= 0; --block) {
+            if (aboveThreshold[block]) {
+                nextAboveBlock = block;
+            } else if (nextAboveBlock >= 0 &&
+                    static_cast<unsigned int>(nextAboveBlock - block) <=
+                            m_lookaheadBlocks) {
+                aboveThreshold[block] = true;
+            }
+        }
+    } else {
+        std::fill(aboveThreshold.begin(), aboveThreshold.begin() + blocks, m_bAboveThreshold);
+    }
+
+    // The gain is linear within each block, so the minimum is one of the
+    // gains at the block boundaries
+    CSAMPLE minGain = m_compressRatio;
+    for (int block = 0; block < blocks; ++block) {
+        const int offset = block * kEnvelopeBlockFrames;
+        const int blockFrames = std::min(kEnvelopeBlockFrames, frames - offset);
+        CSAMPLE_GAIN* pBlockGains = pGains + offset;
+        if (aboveThreshold[block] && m_compressRatio > m_strength) {
+            m_compressRatio = rampGains(pBlockGains,
+                    m_compressRatio,
+                    -m_attackPerFrame,
+                    m_strength,
+                    blockFrames);
+        } else if (aboveThreshold[block] && m_compressRatio < m_strength) {
+            // If the strength param was changed, we might be compressing too much.
+            m_compressRatio = rampGains(pBlockGains,
+                    m_compressRatio,
+                    m_decayPerFrame,
+                    m_strength,
+                    blockFrames);
+        } else if (!aboveThreshold[block] && m_compressRatio < 1) {
+            m_compressRatio = rampGains(pBlockGains,
+                    m_compressRatio,
+                    m_decayPerFrame,
+                    1,
+                    blockFrames);
+        } else {
+            std::fill(pBlockGains, pBlockGains + blockFrames, m_compressRatio);
+        }
+        minGain = std::min(minGain, m_compressRatio);
+    }
+    return minGain < 1;
+}
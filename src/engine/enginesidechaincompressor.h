@@ -40,6 +40,15 @@ class EngineSideChainCompressor {
         calculateRates();
     }
 
+    /// Starts the attack up to the given number of frames before the key
+    /// signal exceeds the threshold. The lookahead is limited to the key
+    /// buffer that is passed to calculateCompressedGains(), so it does not
+    /// add any latency.
+    void setLookahead(unsigned int lookahead_frames) {
+        m_lookaheadBlocks = (lookahead_frames + kEnvelopeBlockFrames - 1) /
+                kEnvelopeBlockFrames;
+    }
+
     /// Forces the above threshold flag to the given value without calculations
     void setAboveThreshold(bool value);
 
@@ -54,6 +63,18 @@ class EngineSideChainCompressor {
     // over the given number of frames and whether the current input is above threshold.
     double calculateCompressedGain(int frames);
 
+    /// The number of frames of each block of the key signal that is compared
+    /// with the threshold by calculateCompressedGains()
+    static constexpr int kEnvelopeBlockFrames = 32;
+
+    /// Calculates the gain of each of the given number of frames into pGains,
+    /// so the gain follows the key signal within the buffer. The key signal
+    /// pIn must contain the same number of stereo frames. If pIn is nullptr,
+    /// the state of the last processKey() or setAboveThreshold() call is
+    /// used for the whole buffer.
+    /// Returns false if all gains are 1, so they do not need to be applied.
+    bool calculateCompressedGains(CSAMPLE_GAIN* pGains, const CSAMPLE* pIn, int frames);
+
   private:
     // Update the attack and decay rates.
     void calculateRates();
@@ -71,6 +92,9 @@ class EngineSideChainCompressor {
     // The largest ratio the signal can be compressed.
     CSAMPLE m_strength;
 
+    // The number of blocks of kEnvelopeBlockFrames the key signal is looked ahead.
+    unsigned int m_lookaheadBlocks;
+
     // The length of time, in frames (samples/2), until maximum compression is reached.
     unsigned int m_attackTime;
 
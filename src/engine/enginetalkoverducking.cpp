@@ -8,6 +8,10 @@ namespace {
 
 constexpr CSAMPLE kDuckThreshold = 0.1f;
 
+// Lets the attack start before the talkover exceeds the threshold,
+// if it does so within the current buffer
+constexpr double kLookaheadSeconds = 0.01;
+
 } // namespace
 
 EngineTalkoverDucking::EngineTalkoverDucking(
@@ -35,6 +39,7 @@ EngineTalkoverDucking::EngineTalkoverDucking(
             static_cast<CSAMPLE>(m_pDuckStrength->get()),
             static_cast<unsigned int>(m_pSampleRate->get() / 2 * .1),
             static_cast<unsigned int>(m_pSampleRate->get() / 2));
+    setLookahead(static_cast<unsigned int>(m_pSampleRate->get() * kLookaheadSeconds));
 
     m_pTalkoverDucking = new ControlPushButton(ConfigKey(m_group, "talkoverDucking"));
     m_pTalkoverDucking->setButtonMode(ControlPushButton::TOGGLE);
@@ -61,6 +66,7 @@ void EngineTalkoverDucking::slotSampleRateChanged(double samplerate) {
             static_cast<CSAMPLE>(m_pDuckStrength->get()),
             static_cast<unsigned int>(samplerate / 2 * .1),
             static_cast<unsigned int>(samplerate / 2));
+    setLookahead(static_cast<unsigned int>(samplerate * kLookaheadSeconds));
 }
 
 void EngineTalkoverDucking::slotDuckStrengthChanged(double strength) {
@@ -75,16 +81,17 @@ void EngineTalkoverDucking::slotDuckModeChanged(double mode) {
    m_pConfig->set(ConfigKey(m_group, "duckMode"), ConfigValue(mode));
 }
 
-CSAMPLE EngineTalkoverDucking::getGain(int numFrames) {
+bool EngineTalkoverDucking::getGains(
+        CSAMPLE_GAIN* pGains, const CSAMPLE* pKey, int numFrames) {
     // Apply microphone ducking.
     switch (getMode()) {
     case EngineTalkoverDucking::OFF:
-        return 1.0f;
+        return false;
     case EngineTalkoverDucking::AUTO:
     case EngineTalkoverDucking::MANUAL:
-        return static_cast<CSAMPLE>(calculateCompressedGain(numFrames));
+        return calculateCompressedGains(pGains, pKey, numFrames);
     default:
         DEBUG_ASSERT("!Unknown Ducking mode");
-        return 1.0f;
+        return false;
     }
 }
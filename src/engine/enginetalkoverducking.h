@@ -23,7 +23,10 @@ class EngineTalkoverDucking : public QObject, public EngineSideChainCompressor {
         return static_cast<TalkoverDuckSetting>(int(m_pTalkoverDucking->get()));
     }
 
-    CSAMPLE getGain(int numFrames);
+    /// Calculates the ducking gain of each frame into pGains, following the
+    /// key signal pKey within the buffer if it is not nullptr.
+    /// Returns false if no ducking is needed, leaving pGains undefined.
+    bool getGains(CSAMPLE_GAIN* pGains, const CSAMPLE* pKey, int numFrames);
 
   public slots:
     void slotSampleRateChanged(double);
@@ -5,7 +5,10 @@
 #include "util/assert.h"
 
 EngineWorker::EngineWorker()
-    : m_pScheduler(nullptr) {
+        : m_pScheduler(nullptr),
+          m_schedulerIndex(-1),
+          m_schedulingPriority(SchedulingPriority::Normal),
+          m_appliedPriority(SchedulingPriority::Normal) {
     m_notReady.test_and_set();
 }
 
@@ -18,15 +21,15 @@ void EngineWorker::run() {
 void EngineWorker::setScheduler(EngineWorkerScheduler* pScheduler) {
     DEBUG_ASSERT(m_pScheduler == nullptr);
     m_pScheduler = pScheduler;
-    pScheduler->addWorker(this);
+    m_schedulerIndex = pScheduler->addWorker(this);
 }
 
 void EngineWorker::workReady() {
     m_notReady.clear();
-    VERIFY_OR_DEBUG_ASSERT(m_pScheduler) {
-        return;     
+    VERIFY_OR_DEBUG_ASSERT(m_pScheduler && m_schedulerIndex >= 0) {
+        return;
     }
-    m_pScheduler->workerReady();
+    m_pScheduler->workerReady(m_schedulerIndex);
 }
 
 void EngineWorker::wakeIfReady() {
@@ -15,6 +15,14 @@ class EngineWorkerScheduler;
 class EngineWorker : public QThread {
     Q_OBJECT
   public:
+    // Workers with a higher priority are woken first and run with a higher
+    // thread priority.
+    enum class SchedulingPriority : int {
+        Normal = 0,
+        // The worker serves a channel that is currently audible
+        Audible = 1,
+    };
+
     EngineWorker();
     virtual ~EngineWorker();
 
@@ -24,10 +32,25 @@ class EngineWorker : public QThread {
     void workReady();
     void wakeIfReady();
 
+    /// Wait-free, may be called from the audio thread
+    void setSchedulingPriority(SchedulingPriority priority) {
+        m_schedulingPriority.store(priority, std::memory_order_relaxed);
+    }
+    SchedulingPriority schedulingPriority() const {
+        return m_schedulingPriority.load(std::memory_order_relaxed);
+    }
+
   protected:
     QSemaphore m_semaRun;
 
   private:
+    friend class EngineWorkerScheduler;
+
     EngineWorkerScheduler* m_pScheduler;
+    int m_schedulerIndex;
     std::atomic_flag m_notReady;
+    std::atomic<SchedulingPriority> m_schedulingPriority;
+    // The priority that has been applied to the thread. Only accessed by
+    // the scheduler thread.
+    SchedulingPriority m_appliedPriority;
 };
@@ -1,59 +1,138 @@
 #include "engine/engineworkerscheduler.h"
 
+#include <QVarLengthArray>
+#include <algorithm>
+#include <bit>
+#include <utility>
+
 #include "engine/engineworker.h"
 #include "moc_engineworkerscheduler.cpp"
-#include "util/compatibility/qmutex.h"
+#include "util/assert.h"
 #include "util/event.h"
+#include "util/threadplacement.h"
+
+namespace {
+
+QThread::Priority threadPriority(EngineWorker::SchedulingPriority priority) {
+    switch (priority) {
+    case EngineWorker::SchedulingPriority::Audible:
+        return QThread::HighestPriority;
+    case EngineWorker::SchedulingPriority::Normal:
+        break;
+    }
+    // The priority all EngineWorkers are started with
+    return QThread::HighPriority;
+}
+
+} // anonymous namespace
 
 EngineWorkerScheduler::EngineWorkerScheduler(QObject* pParent)
-        : m_bWakeScheduler(false),
+        : m_bWakePending(false),
+          m_numWorkers(0),
           m_bQuit(false) {
     Q_UNUSED(pParent);
+    for (auto& readyWord : m_readyWorkers) {
+        readyWord.store(0, std::memory_order_relaxed);
+    }
+    for (auto& pWorker : m_workers) {
+        pWorker.store(nullptr, std::memory_order_relaxed);
+    }
 }
 
 EngineWorkerScheduler::~EngineWorkerScheduler() {
-    m_bQuit = true;
-    m_waitCondition.wakeAll();
+    m_bQuit.store(true);
+    m_semaWake.release();
     wait();
 }
 
-void EngineWorkerScheduler::workerReady() {
-    m_bWakeScheduler = true;
+int EngineWorkerScheduler::addWorker(EngineWorker* pWorker) {
+    DEBUG_ASSERT(pWorker);
+    const int workerIndex = m_numWorkers.load(std::memory_order_relaxed);
+    VERIFY_OR_DEBUG_ASSERT(workerIndex < MAX_ENGINE_WORKERS) {
+        return -1;
+    }
+    // Publish the worker before it becomes visible to the scheduler thread
+    m_workers[workerIndex].store(pWorker, std::memory_order_release);
+    m_numWorkers.store(workerIndex + 1, std::memory_order_release);
+    return workerIndex;
 }
 
-void EngineWorkerScheduler::addWorker(EngineWorker* pWorker) {
-    DEBUG_ASSERT(pWorker);
-    const auto locker = lockMutex(&m_mutex);
-    m_workers.push_back(pWorker);
+void EngineWorkerScheduler::workerReady(int workerIndex) {
+    DEBUG_ASSERT(workerIndex >= 0 && workerIndex < MAX_ENGINE_WORKERS);
+    m_readyWorkers[workerIndex / kReadyWordBits].fetch_or(
+            std::uint64_t{1} << (workerIndex % kReadyWordBits));
 }
 
 void EngineWorkerScheduler::runWorkers() {
-    // Wake the scheduler if we have written a worker-ready message to the
-    // scheduler. There is no race condition in accessing this boolean because
-    // both workerReady and runWorkers are called from the callback thread.
-    if (m_bWakeScheduler) {
-        m_bWakeScheduler = false;
-        m_waitCondition.wakeAll();
+    // Wake the scheduler if a worker has been marked as ready. runWorkers is
+    // called from the callback thread after all channels which may call
+    // workerReady have been processed.
+    for (const auto& readyWord : m_readyWorkers) {
+        if (readyWord.load(std::memory_order_relaxed) != 0) {
+            if (!m_bWakePending.exchange(true)) {
+                m_semaWake.release();
+            }
+            return;
+        }
+    }
+}
+
+void EngineWorkerScheduler::wakeReadyWorkers() {
+    // The priority is captured once, because the engine may change it
+    // concurrently.
+    QVarLengthArray<std::pair<EngineWorker::SchedulingPriority, EngineWorker*>,
+            MAX_ENGINE_WORKERS>
+            readyWorkers;
+    const int numWorkers = m_numWorkers.load(std::memory_order_acquire);
+    for (int word = 0; word < kNumReadyWords; ++word) {
+        std::uint64_t readyBits = m_readyWorkers[word].exchange(0);
+        while (readyBits != 0) {
+            const int bit = std::countr_zero(readyBits);
+            readyBits &= readyBits - 1;
+            const int workerIndex = word * kReadyWordBits + bit;
+            if (workerIndex >= numWorkers) {
+                continue;
+            }
+            EngineWorker* pWorker = m_workers[workerIndex].load(std::memory_order_acquire);
+            if (pWorker) {
+                readyWorkers.append({pWorker->schedulingPriority(), pWorker});
+            }
+        }
+    }
+
+    // Wake the workers with the highest priority first, so they get a head
+    // start when competing for the disk.
+    std::stable_sort(readyWorkers.begin(),
+            readyWorkers.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.first > rhs.first;
+            });
+    // A configured priority of the workers takes precedence
+    const bool hasConfiguredPriority = mixxx::ThreadPlacement::hasConfiguredPriority(
+            mixxx::ThreadPlacement::Role::EngineWorker);
+    for (const auto& [priority, pWorker] : std::as_const(readyWorkers)) {
+        if (priority != pWorker->m_appliedPriority && pWorker->isRunning() &&
+                !hasConfiguredPriority) {
+            pWorker->setPriority(threadPriority(priority));
+            pWorker->m_appliedPriority = priority;
+        }
+        pWorker->wakeIfReady();
     }
 }
 
 void EngineWorkerScheduler::run() {
     static const QString tag("EngineWorkerScheduler");
-    while (!m_bQuit) {
-        Event::start(tag);
-        {
-            const auto locker = lockMutex(&m_mutex);
-            for(const auto& pWorker: m_workers) {
-                pWorker->wakeIfReady();
-            }
+    while (!m_bQuit.load()) {
+        // Wait for next runWorkers() call
+        m_semaWake.acquire();
+        // Sequentially consistent with the ready bits, so a worker marked
+        // ready after this point wakes the scheduler again.
+        m_bWakePending.store(false);
+        if (m_bQuit.load()) {
+            break;
         }
+        Event::start(tag);
+        wakeReadyWorkers();
         Event::end(tag);
-        {
-            const auto lock = lockMutex(&m_mutex);
-            if (!m_bQuit) {
-                // Wait for next runWorkers() call
-                m_waitCondition.wait(&m_mutex); // unlock mutex and wait
-            }
-        }
     }
 }
@@ -1,36 +1,64 @@
 #pragma once
 
-#include <QMutex>
+#include <QSemaphore>
 #include <QThread>
-#include <QWaitCondition>
+#include <array>
+#include <atomic>
+#include <cstdint>
 
-// The max engine workers that can be expected to run within a callback
-// (e.g. the max that we will schedule). Must be a power of 2.
-#define MAX_ENGINE_WORKERS 32
+// The max engine workers that can be registered with a scheduler. This covers
+// all decks, samplers and preview decks. Must be a multiple of 64.
+#define MAX_ENGINE_WORKERS 256
 
 class EngineWorker;
 
+// The EngineWorkerScheduler wakes up the EngineWorkers that have signaled
+// work during the audio callback once the callback is done.
+//
+// Every EngineWorker runs its work on its own thread, so several workers can
+// read in parallel. The scheduler only decides when and in which order the
+// workers are woken: workers with a higher scheduling priority (e.g. the
+// reader of the deck that is currently audible) are woken and boosted first.
+//
+// workerReady() and runWorkers() are lock-free and safe to call from the
+// audio callback and the EngineChannelWorkerPool threads.
 class EngineWorkerScheduler : public QThread {
     Q_OBJECT
   public:
     EngineWorkerScheduler(QObject* pParent=NULL);
     virtual ~EngineWorkerScheduler();
 
-    void addWorker(EngineWorker* pWorker);
+    /// Registers the worker and returns its index used for workerReady(),
+    /// or -1 when out of worker slots.
+    /// Must not be called concurrently.
+    int addWorker(EngineWorker* pWorker);
+    /// Wakes the scheduler thread if any worker is ready.
+    /// called from audio thread
     void runWorkers();
-    void workerReady();
+    /// Marks the worker as ready. Wait-free.
+    void workerReady(int workerIndex);
 
   protected:
     void run();
 
   private:
-    // Indicates whether workerReady has been called since the last time
-    // runWorkers was run. This should only be touched from the engine callback.
-    bool m_bWakeScheduler;
+    static constexpr int kReadyWordBits = 64;
+    static constexpr int kNumReadyWords = MAX_ENGINE_WORKERS / kReadyWordBits;
+    static_assert(MAX_ENGINE_WORKERS % kReadyWordBits == 0);
 
-    std::vector<EngineWorker*> m_workers;
+    void wakeReadyWorkers();
 
-    QWaitCondition m_waitCondition;
-    QMutex m_mutex;
-    volatile bool m_bQuit;
+    // Bit set of the workers that have called workerReady() since the last
+    // time they were woken.
+    std::array<std::atomic<std::uint64_t>, kNumReadyWords> m_readyWorkers;
+    // Indicates whether m_semaWake has been released and the scheduler
+    // thread has not yet picked it up. This avoids releasing the semaphore
+    // in every callback.
+    std::atomic<bool> m_bWakePending;
+
+    std::array<std::atomic<EngineWorker*>, MAX_ENGINE_WORKERS> m_workers;
+    std::atomic<int> m_numWorkers;
+
+    QSemaphore m_semaWake;
+    std::atomic<bool> m_bQuit;
 };
@@ -10,6 +10,11 @@
 #include "engine/engineobject.h"
 #include "util/sample.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIXXX_IIR_SSE2
+#endif
+
 // set to 1 to print some analysis data using qDebug()
 // It prints the resulting delay after 50 % of impulse have passed
 // and the gain and phase shift at some sample frequencies
@@ -27,6 +32,126 @@ enum IIRPass {
 };
 
 
+// A pair of doubles for the left and the right channel, which are processed
+// in the two lanes of an SSE2 register if available. The filter state is
+// kept in double precision by both variants.
+class IIRStereoLanes {
+  public:
+    IIRStereoLanes() = default;
+#ifdef MIXXX_IIR_SSE2
+    IIRStereoLanes(double left, double right)
+            : m_lanes(_mm_set_pd(right, left)) {
+    }
+#else
+    IIRStereoLanes(double left, double right)
+            : m_left(left),
+              m_right(right) {
+    }
+#endif
+
+    // Loads an interleaved stereo frame
+    static IIRStereoLanes load(const CSAMPLE* pFrame) {
+#ifdef MIXXX_IIR_SSE2
+        // Load both floats at once and convert them to doubles. The
+        // intrinsic accesses memory through __m128i, which may alias any
+        // type, and needs no alignment.
+        return IIRStereoLanes(_mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)))));
+#else
+        return IIRStereoLanes(pFrame[0], pFrame[1]);
+#endif
+    }
+
+    // Stores an interleaved stereo frame
+    void store(CSAMPLE* pFrame) const {
+#ifdef MIXXX_IIR_SSE2
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pFrame),
+                _mm_castps_si128(_mm_cvtpd_ps(m_lanes)));
+#else
+        pFrame[0] = static_cast<CSAMPLE>(m_left);
+        pFrame[1] = static_cast<CSAMPLE>(m_right);
+#endif
+    }
+
+#ifdef MIXXX_IIR_SSE2
+    double left() const {
+        return _mm_cvtsd_f64(m_lanes);
+    }
+    double right() const {
+        return _mm_cvtsd_f64(_mm_unpackhi_pd(m_lanes, m_lanes));
+    }
+
+    IIRStereoLanes& operator+=(IIRStereoLanes other) {
+        m_lanes = _mm_add_pd(m_lanes, other.m_lanes);
+        return *this;
+    }
+    IIRStereoLanes& operator-=(IIRStereoLanes other) {
+        m_lanes = _mm_sub_pd(m_lanes, other.m_lanes);
+        return *this;
+    }
+    friend IIRStereoLanes operator+(IIRStereoLanes a, IIRStereoLanes b) {
+        return IIRStereoLanes(_mm_add_pd(a.m_lanes, b.m_lanes));
+    }
+    friend IIRStereoLanes operator-(IIRStereoLanes a, IIRStereoLanes b) {
+        return IIRStereoLanes(_mm_sub_pd(a.m_lanes, b.m_lanes));
+    }
+    friend IIRStereoLanes operator-(IIRStereoLanes a) {
+        // Flip the sign bits
+        return IIRStereoLanes(_mm_xor_pd(a.m_lanes, _mm_set1_pd(-0.0)));
+    }
+    friend IIRStereoLanes operator*(IIRStereoLanes a, double b) {
+        return IIRStereoLanes(_mm_mul_pd(a.m_lanes, _mm_set1_pd(b)));
+    }
+    friend IIRStereoLanes operator*(double a, IIRStereoLanes b) {
+        return IIRStereoLanes(_mm_mul_pd(_mm_set1_pd(a), b.m_lanes));
+    }
+
+  private:
+    explicit IIRStereoLanes(__m128d lanes)
+            : m_lanes(lanes) {
+    }
+
+    __m128d m_lanes;
+#else
+    double left() const {
+        return m_left;
+    }
+    double right() const {
+        return m_right;
+    }
+
+    IIRStereoLanes& operator+=(IIRStereoLanes other) {
+        m_left += other.m_left;
+        m_right += other.m_right;
+        return *this;
+    }
+    IIRStereoLanes& operator-=(IIRStereoLanes other) {
+        m_left -= other.m_left;
+        m_right -= other.m_right;
+        return *this;
+    }
+    friend IIRStereoLanes operator+(IIRStereoLanes a, IIRStereoLanes b) {
+        return a += b;
+    }
+    friend IIRStereoLanes operator-(IIRStereoLanes a, IIRStereoLanes b) {
+        return a -= b;
+    }
+    friend IIRStereoLanes operator-(IIRStereoLanes a) {
+        return IIRStereoLanes(-a.m_left, -a.m_right);
+    }
+    friend IIRStereoLanes operator*(IIRStereoLanes a, double b) {
+        return IIRStereoLanes(a.m_left * b, a.m_right * b);
+    }
+    friend IIRStereoLanes operator*(double a, IIRStereoLanes b) {
+        return IIRStereoLanes(a * b.m_left, a * b.m_right);
+    }
+
+  private:
+    double m_left;
+    double m_right;
+#endif
+};
+
 class EngineFilterIIRBase : public EngineObjectConstIn {
   public:
     virtual void assumeSettled() = 0;
@@ -85,11 +210,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        memcpy(m_oldBuf, m_buf, sizeof(m_buf));
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
     }
 
@@ -236,8 +359,8 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                          const int iBufferSize) {
         if (!m_doRamping) {
             for (int i = 0; i < iBufferSize; i += 2) {
-                pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                processSample(m_coef, m_buf, IIRStereoLanes::load(pIn + i))
+                        .store(pOutput + i);
             }
         } else {
             double cross_mix = 0.0;
@@ -254,12 +377,14 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
+                const IIRStereoLanes in = IIRStereoLanes::load(pIn + i);
                 double old1;
                 double old2;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf1, pIn[i]));
-                    old2 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                    const IIRStereoLanes old = processSample(m_oldCoef, m_oldBuf, in);
+                    old1 = static_cast<CSAMPLE>(old.left());
+                    old2 = static_cast<CSAMPLE>(old.right());
                 } else {
                     if (m_startFromDry) {
                         old1 = pIn[i];
@@ -269,8 +394,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                         old2 = 0;
                     }
                 }
-                double new1 = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                double new2 = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const IIRStereoLanes newLanes = processSample(m_coef, m_buf, in);
+                double new1 = static_cast<CSAMPLE>(newLanes.left());
+                double new2 = static_cast<CSAMPLE>(newLanes.right());
 
                 if (i < iBufferSize / 2) {
                     pOutput[i] = static_cast<CSAMPLE>(old1);
@@ -288,11 +414,12 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    // Processes one frame of the left and the right channel in parallel
+    inline IIRStereoLanes processSample(
+            const double* coef, IIRStereoLanes* buf, IIRStereoLanes val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
         m_doStart = true;
     }
@@ -301,15 +428,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
-
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    // State of both channels
+    IIRStereoLanes m_buf[SIZE];
+    // Old buffer needed for ramping
+    IIRStereoLanes m_oldBuf[SIZE];
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -320,10 +442,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<2, IIR_LP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -334,10 +455,9 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<2, IIR_BP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -348,10 +468,9 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<2, IIR_HP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -362,10 +481,9 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<4, IIR_LP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -381,10 +499,9 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<8, IIR_BP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -411,10 +528,9 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<4, IIR_HP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -430,10 +546,9 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<8, IIR_LP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -460,10 +575,9 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<16, IIR_BP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -512,10 +626,9 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<8, IIR_HP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -543,10 +656,9 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<5, IIR_BP>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -557,10 +669,9 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<4, IIR_LPMO>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+   IIRStereoLanes tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -583,10 +694,9 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<4, IIR_HPMO>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+   IIRStereoLanes tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -608,10 +718,9 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<2, IIR_LP2>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -629,10 +738,9 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline IIRStereoLanes EngineFilterIIR<2, IIR_HP2>::processSample(
+        const double* coef, IIRStereoLanes* buf, IIRStereoLanes val) {
+    IIRStereoLanes tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
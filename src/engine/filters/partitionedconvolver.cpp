@@ -0,0 +1,430 @@
+#include <dsp/transforms/FFT.h>
+
+// Class header comes after library includes here since our preprocessor
+// definitions interfere with qm-dsp's headers.
+#include "engine/filters/partitionedconvolver.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr int kChannels = 2;
+
+constexpr SINT kHeadBlocksPerTailBlock =
+        PartitionedConvolver::kTailBlockFrames / PartitionedConvolver::kHeadBlockFrames;
+static_assert(PartitionedConvolver::kTailBlockFrames % PartitionedConvolver::kHeadBlockFrames == 0);
+
+// The head covers the frames of the impulse response until the first
+// tail partition, which starts two tail blocks after the input
+constexpr SINT kHeadFrames = 2 * PartitionedConvolver::kTailBlockFrames;
+constexpr int kMaxHeadPartitions = kHeadFrames / PartitionedConvolver::kHeadBlockFrames;
+
+constexpr int kNoImpulseResponse = -1;
+
+int partitionCount(SINT frames, SINT partitionFrames) {
+    return static_cast<int>((frames + partitionFrames - 1) / partitionFrames);
+}
+
+// Calculates the spectra of the partitions of one channel of the impulse
+// response, each partition is zero-padded to twice its size
+void transformPartitions(std::vector<double>* pRe,
+        std::vector<double>* pIm,
+        const std::vector<CSAMPLE>& impulseResponse,
+        int channel,
+        SINT firstFrame,
+        SINT partitionFrames,
+        int numPartitions) {
+    const SINT bins = partitionFrames + 1;
+    const SINT impulseResponseFrames = impulseResponse.size() / kChannels;
+    pRe->assign(numPartitions * bins, 0);
+    pIm->assign(numPartitions * bins, 0);
+    FFTReal fft(2 * partitionFrames);
+    std::vector<double> time(2 * partitionFrames);
+    std::vector<double> spectrumRe(2 * partitionFrames);
+    std::vector<double> spectrumIm(2 * partitionFrames);
+    for (int partition = 0; partition < numPartitions; ++partition) {
+        std::fill(time.begin(), time.end(), 0);
+        const SINT partitionStart = firstFrame + partition * partitionFrames;
+        const SINT frames = math_min(partitionFrames, impulseResponseFrames - partitionStart);
+        for (SINT i = 0; i < frames; ++i) {
+            time[i] = impulseResponse[(partitionStart + i) * kChannels + channel];
+        }
+        fft.forward(time.data(), spectrumRe.data(), spectrumIm.data());
+        std::copy(spectrumRe.begin(),
+                spectrumRe.begin() + bins,
+                pRe->begin() + partition * bins);
+        std::copy(spectrumIm.begin(),
+                spectrumIm.begin() + bins,
+                pIm->begin() + partition * bins);
+    }
+}
+
+} // anonymous namespace
+
+struct PartitionedConvolver::Kernel {
+    int numHeadPartitions;
+    int numTailPartitions;
+    // Indexed by channel, the partitions are stored one after another
+    std::vector<double> headRe[kChannels];
+    std::vector<double> headIm[kChannels];
+    std::vector<double> tailRe[kChannels];
+    std::vector<double> tailIm[kChannels];
+};
+
+PartitionedConvolver::UniformConvolver::UniformConvolver(
+        SINT blockFrames, SINT maxPartitions)
+        : m_blockFrames(blockFrames),
+          m_pFft(std::make_unique<FFTReal>(2 * blockFrames)),
+          m_time(2 * blockFrames),
+          m_spectrumRe(2 * blockFrames),
+          m_spectrumIm(2 * blockFrames),
+          m_historyRe(maxPartitions * bins()),
+          m_historyIm(maxPartitions * bins()),
+          m_historyPosition(0),
+          m_sumRe(bins()),
+          m_sumIm(bins()) {
+}
+
+PartitionedConvolver::UniformConvolver::~UniformConvolver() = default;
+
+void PartitionedConvolver::UniformConvolver::process(CSAMPLE* pBlock,
+        const std::vector<double>& partitionsRe,
+        const std::vector<double>& partitionsIm,
+        int numPartitions) {
+    const SINT bins = this->bins();
+    const int maxPartitions = static_cast<int>(m_historyRe.size() / bins);
+    DEBUG_ASSERT(numPartitions <= maxPartitions);
+
+    std::copy(m_time.begin() + m_blockFrames, m_time.end(), m_time.begin());
+    std::copy(pBlock, pBlock + m_blockFrames, m_time.begin() + m_blockFrames);
+    m_pFft->forward(m_time.data(), m_spectrumRe.data(), m_spectrumIm.data());
+
+    m_historyPosition = (m_historyPosition + 1) % maxPartitions;
+    std::copy(m_spectrumRe.begin(),
+            m_spectrumRe.begin() + bins,
+            m_historyRe.begin() + m_historyPosition * bins);
+    std::copy(m_spectrumIm.begin(),
+            m_spectrumIm.begin() + bins,
+            m_historyIm.begin() + m_historyPosition * bins);
+
+    // The spectrum of the n-th previous input block is multiplied with the
+    // spectrum of the n-th partition
+    std::fill(m_sumRe.begin(), m_sumRe.end(), 0);
+    std::fill(m_sumIm.begin(), m_sumIm.end(), 0);
+    double* pSumRe = m_sumRe.data();
+    double* pSumIm = m_sumIm.data();
+    for (int partition = 0; partition < numPartitions; ++partition) {
+        const int history = (m_historyPosition - partition + maxPartitions) % maxPartitions;
+        const double* pInputRe = &m_historyRe[history * bins];
+        const double* pInputIm = &m_historyIm[history * bins];
+        const double* pPartitionRe = &partitionsRe[partition * bins];
+        const double* pPartitionIm = &partitionsIm[partition * bins];
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < bins; ++i) {
+            pSumRe[i] += pInputRe[i] * pPartitionRe[i] - pInputIm[i] * pPartitionIm[i];
+            pSumIm[i] += pInputRe[i] * pPartitionIm[i] + pInputIm[i] * pPartitionRe[i];
+        }
+    }
+
+    // Only the second half is free of the circular wrap around
+    m_pFft->inverse(pSumRe, pSumIm, m_spectrumRe.data());
+    for (SINT i = 0; i < m_blockFrames; ++i) {
+        pBlock[i] = static_cast<CSAMPLE>(m_spectrumRe[m_blockFrames + i]);
+    }
+}
+
+void PartitionedConvolver::UniformConvolver::reset() {
+    std::fill(m_time.begin(), m_time.end(), 0);
+    std::fill(m_historyRe.begin(), m_historyRe.end(), 0);
+    std::fill(m_historyIm.begin(), m_historyIm.end(), 0);
+}
+
+PartitionedConvolver::PartitionedConvolver(ImpulseResponseLoader loader)
+        : m_requestedImpulseResponse(kNoImpulseResponse),
+          m_requestedSampleRate(0),
+          m_inputBlock(kChannels * kHeadBlockFrames),
+          m_outputBlock(kChannels * kHeadBlockFrames),
+          m_blockFill(0),
+          m_blockIndex(0),
+          m_firstTailJob(0),
+          m_lastPostedTailJob(-1),
+          m_lastPostedTailJobs{-1, -1},
+          m_feedingTail(false),
+          m_tailAvailable(false),
+          m_missedTailBlocks(0),
+          m_impulseResponse(kNoImpulseResponse),
+          m_sampleRate(0),
+          m_pPendingKernel(nullptr),
+          m_pRetiredKernel(nullptr),
+          m_tailRestartJob(0),
+          m_postedTailJob(-1),
+          m_completedTailJob(-1),
+          m_loading(false),
+          m_loader(std::move(loader)),
+          m_pWorkerKernel(nullptr),
+          m_loadedImpulseResponse(kNoImpulseResponse),
+          m_loadedSampleRate(0),
+          m_processedTailJob(-1),
+          m_quit(false) {
+    for (int channel = 0; channel < kChannels; ++channel) {
+        m_headBlock[channel].resize(kHeadBlockFrames);
+        m_headConvolvers.push_back(
+                std::make_unique<UniformConvolver>(kHeadBlockFrames, kMaxHeadPartitions));
+        for (int slot = 0; slot < 2; ++slot) {
+            m_tailInput[slot][channel].resize(kTailBlockFrames);
+            m_tailOutput[slot][channel].resize(kTailBlockFrames);
+        }
+    }
+    m_pWorkerThread.reset(QThread::create([this] {
+        runWorker();
+    }));
+    m_pWorkerThread->setObjectName(QStringLiteral("PartitionedConvolver"));
+    m_pWorkerThread->start(QThread::HighPriority);
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    m_quit.store(true);
+    m_semaWorker.release();
+    m_pWorkerThread->wait();
+    // The kernel of the worker is either pending or used by the engine
+    delete m_pPendingKernel.exchange(nullptr);
+    delete m_pRetiredKernel.exchange(nullptr);
+}
+
+// static
+std::unique_ptr<PartitionedConvolver::Kernel> PartitionedConvolver::createKernel(
+        const std::vector<CSAMPLE>& impulseResponse) {
+    const SINT frames = impulseResponse.size() / kChannels;
+    auto pKernel = std::make_unique<Kernel>();
+    pKernel->numHeadPartitions = partitionCount(math_min(frames, kHeadFrames), kHeadBlockFrames);
+    pKernel->numTailPartitions = frames > kHeadFrames
+            ? partitionCount(frames - kHeadFrames, kTailBlockFrames)
+            : 0;
+    for (int channel = 0; channel < kChannels; ++channel) {
+        transformPartitions(&pKernel->headRe[channel],
+                &pKernel->headIm[channel],
+                impulseResponse,
+                channel,
+                0,
+                kHeadBlockFrames,
+                pKernel->numHeadPartitions);
+        transformPartitions(&pKernel->tailRe[channel],
+                &pKernel->tailIm[channel],
+                impulseResponse,
+                channel,
+                kHeadFrames,
+                kTailBlockFrames,
+                pKernel->numTailPartitions);
+    }
+    return pKernel;
+}
+
+void PartitionedConvolver::setImpulseResponse(int impulseResponse, int sampleRate) {
+    if (impulseResponse == m_requestedImpulseResponse &&
+            sampleRate == m_requestedSampleRate) {
+        return;
+    }
+    m_requestedImpulseResponse = impulseResponse;
+    m_requestedSampleRate = sampleRate;
+    m_loading.store(true);
+    m_impulseResponse.store(impulseResponse);
+    m_sampleRate.store(sampleRate);
+    m_semaWorker.release();
+}
+
+void PartitionedConvolver::process(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames) {
+    // A new kernel is only taken over after the worker has deleted the
+    // previous one
+    if (m_pRetiredKernel.load(std::memory_order_acquire) == nullptr) {
+        Kernel* pKernel = m_pPendingKernel.exchange(nullptr, std::memory_order_acq_rel);
+        if (pKernel) {
+            m_pRetiredKernel.store(m_pKernel.release(), std::memory_order_release);
+            m_pKernel.reset(pKernel);
+            for (const auto& pConvolver : m_headConvolvers) {
+                pConvolver->reset();
+            }
+            m_semaWorker.release();
+        }
+    }
+
+    SINT framesDone = 0;
+    while (framesDone < numFrames) {
+        const SINT frames = math_min(kHeadBlockFrames - m_blockFill, numFrames - framesDone);
+        // The input is read before the output is written, in case both
+        // are the same buffer
+        SampleUtil::copy(&m_inputBlock[m_blockFill * kChannels],
+                &pInput[framesDone * kChannels],
+                frames * kChannels);
+        SampleUtil::copy(&pOutput[framesDone * kChannels],
+                &m_outputBlock[m_blockFill * kChannels],
+                frames * kChannels);
+        m_blockFill += frames;
+        framesDone += frames;
+        if (m_blockFill == kHeadBlockFrames) {
+            processBlock();
+            m_blockFill = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::processBlock() {
+    const qint64 tailBlock = m_blockIndex / kHeadBlocksPerTailBlock;
+    const SINT tailOffset = (m_blockIndex % kHeadBlocksPerTailBlock) * kHeadBlockFrames;
+    if (tailOffset == 0) {
+        startTailBlock(tailBlock);
+    }
+
+    SampleUtil::deinterleaveBuffer(m_headBlock[0].data(),
+            m_headBlock[1].data(),
+            m_inputBlock.data(),
+            kHeadBlockFrames);
+    for (int channel = 0; channel < kChannels; ++channel) {
+        CSAMPLE* pBlock = m_headBlock[channel].data();
+        if (m_feedingTail) {
+            SampleUtil::copy(&m_tailInput[tailBlock % 2][channel][tailOffset],
+                    pBlock,
+                    kHeadBlockFrames);
+        }
+        if (m_pKernel) {
+            m_headConvolvers[channel]->process(pBlock,
+                    m_pKernel->headRe[channel],
+                    m_pKernel->headIm[channel],
+                    m_pKernel->numHeadPartitions);
+        } else {
+            SampleUtil::clear(pBlock, kHeadBlockFrames);
+        }
+        if (m_tailAvailable) {
+            // The input of two tail blocks ago, convolved with the tail
+            SampleUtil::add(pBlock,
+                    &m_tailOutput[(tailBlock - 2) % 2][channel][tailOffset],
+                    kHeadBlockFrames);
+        }
+    }
+    SampleUtil::interleaveBuffer(m_outputBlock.data(),
+            m_headBlock[0].data(),
+            m_headBlock[1].data(),
+            kHeadBlockFrames);
+
+    if (m_feedingTail && tailOffset + kHeadBlockFrames == kTailBlockFrames) {
+        m_lastPostedTailJob = tailBlock;
+        m_lastPostedTailJobs[tailBlock % 2] = tailBlock;
+        m_postedTailJob.store(tailBlock, std::memory_order_release);
+        m_semaWorker.release();
+    }
+    ++m_blockIndex;
+}
+
+void PartitionedConvolver::startTailBlock(qint64 tailBlock) {
+    const qint64 completedJob = m_completedTailJob.load(std::memory_order_acquire);
+
+    // The output of a tail job is added two tail blocks after its input
+    const qint64 job = tailBlock - 2;
+    const bool posted = job >= m_firstTailJob && job <= m_lastPostedTailJob;
+    m_tailAvailable = posted && completedJob >= job;
+    if (posted && !m_tailAvailable) {
+        ++m_missedTailBlocks;
+    }
+
+    // The input of this tail block replaces the input of the last job that
+    // has been posted with the same slot, which the worker may still read.
+    // Then this tail block is skipped.
+    if (completedJob < m_lastPostedTailJobs[tailBlock % 2]) {
+        restartTail(tailBlock + 1);
+    }
+    m_feedingTail = tailBlock >= m_firstTailJob;
+}
+
+void PartitionedConvolver::restartTail(qint64 firstJob) {
+    m_firstTailJob = firstJob;
+    m_tailRestartJob.store(firstJob, std::memory_order_release);
+}
+
+void PartitionedConvolver::reset() {
+    std::fill(m_inputBlock.begin(), m_inputBlock.end(), CSAMPLE_ZERO);
+    std::fill(m_outputBlock.begin(), m_outputBlock.end(), CSAMPLE_ZERO);
+    m_blockFill = 0;
+    for (const auto& pConvolver : m_headConvolvers) {
+        pConvolver->reset();
+    }
+    // The current tail block may already contain old input
+    const qint64 tailBlock = m_blockIndex / kHeadBlocksPerTailBlock;
+    m_feedingTail = false;
+    m_tailAvailable = false;
+    restartTail(tailBlock + 1);
+}
+
+void PartitionedConvolver::waitForWorker() const {
+    while (m_loading.load() ||
+            m_completedTailJob.load() < m_postedTailJob.load() ||
+            m_pRetiredKernel.load() != nullptr) {
+        QThread::msleep(1);
+    }
+}
+
+void PartitionedConvolver::runWorker() {
+    while (true) {
+        m_semaWorker.acquire();
+        if (m_quit.load()) {
+            return;
+        }
+
+        delete m_pRetiredKernel.exchange(nullptr, std::memory_order_acq_rel);
+
+        const int impulseResponse = m_impulseResponse.load();
+        const int sampleRate = m_sampleRate.load();
+        if (impulseResponse != m_loadedImpulseResponse || sampleRate != m_loadedSampleRate) {
+            std::unique_ptr<Kernel> pKernel = createKernel(m_loader(impulseResponse, sampleRate));
+            m_loadedImpulseResponse = impulseResponse;
+            m_loadedSampleRate = sampleRate;
+            m_tailConvolvers.clear();
+            for (int channel = 0; channel < kChannels; ++channel) {
+                m_tailConvolvers.push_back(std::make_unique<UniformConvolver>(
+                        kTailBlockFrames, math_max(pKernel->numTailPartitions, 1)));
+            }
+            m_pWorkerKernel = pKernel.get();
+            // A kernel that has not been taken over by the engine yet is
+            // replaced
+            delete m_pPendingKernel.exchange(pKernel.release(), std::memory_order_acq_rel);
+            if (impulseResponse == m_impulseResponse.load() &&
+                    sampleRate == m_sampleRate.load()) {
+                m_loading.store(false);
+            }
+        }
+
+        const qint64 postedJob = m_postedTailJob.load(std::memory_order_acquire);
+        const qint64 restartJob = m_tailRestartJob.load(std::memory_order_acquire);
+        if (m_processedTailJob + 1 < restartJob) {
+            // The jobs before have been skipped or are not needed anymore
+            for (const auto& pConvolver : m_tailConvolvers) {
+                pConvolver->reset();
+            }
+            m_processedTailJob = restartJob - 1;
+            m_completedTailJob.store(m_processedTailJob, std::memory_order_release);
+        }
+        for (qint64 job = m_processedTailJob + 1; job <= postedJob; ++job) {
+            processTailJob(job);
+            m_processedTailJob = job;
+            m_completedTailJob.store(job, std::memory_order_release);
+        }
+    }
+}
+
+void PartitionedConvolver::processTailJob(qint64 job) {
+    const int slot = job % 2;
+    for (int channel = 0; channel < kChannels; ++channel) {
+        CSAMPLE* pOutput = m_tailOutput[slot][channel].data();
+        if (m_pWorkerKernel && m_pWorkerKernel->numTailPartitions > 0) {
+            SampleUtil::copy(pOutput, m_tailInput[slot][channel].data(), kTailBlockFrames);
+            m_tailConvolvers[channel]->process(pOutput,
+                    m_pWorkerKernel->tailRe[channel],
+                    m_pWorkerKernel->tailIm[channel],
+                    m_pWorkerKernel->numTailPartitions);
+        } else {
+            SampleUtil::clear(pOutput, kTailBlockFrames);
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "util/types.h"
+
+class FFTReal;
+
+/// Convolves interleaved stereo audio with a long impulse response, e.g. of
+/// a room, at a CPU load that does not depend on the buffer size.
+///
+/// The impulse response is split into partitions of two sizes, which are
+/// convolved in the frequency domain (overlap-save):
+///   * The head covers the first 2 * kTailBlockFrames frames with short
+///     partitions. It is calculated in the engine thread for every block of
+///     kHeadBlockFrames frames.
+///   * The tail covers the rest with long partitions. It is calculated on a
+///     worker thread once per kTailBlockFrames frames. The result of a tail
+///     block is needed one tail block after it has been posted, so the worker
+///     has a whole tail block of time. If it is late, the tail is muted
+///     until the worker has caught up, instead of blocking the engine.
+///
+/// The CPU load of the engine thread only depends on the length of the
+/// head, not on the length of the impulse response.
+///
+/// The impulse responses are loaded on the worker thread as well and handed
+/// over to the engine thread without locking.
+///
+/// The output is delayed by kHeadBlockFrames frames.
+class PartitionedConvolver {
+  public:
+    static constexpr SINT kHeadBlockFrames = 128;
+    static constexpr SINT kTailBlockFrames = 16 * kHeadBlockFrames;
+
+    /// Returns the interleaved stereo impulse response with the given id at
+    /// the sample rate. Called on the worker thread.
+    using ImpulseResponseLoader =
+            std::function<std::vector<CSAMPLE>(int impulseResponse, int sampleRate)>;
+
+    explicit PartitionedConvolver(ImpulseResponseLoader loader);
+    ~PartitionedConvolver();
+
+    /// Requests to load another impulse response. The output stays silent
+    /// until it is loaded. Wait-free, called from the engine thread.
+    void setImpulseResponse(int impulseResponse, int sampleRate);
+
+    /// Wait-free, called from the engine thread. pOutput and pInput may be
+    /// the same buffer.
+    void process(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames);
+
+    /// Clears the history, e.g. when the effect is enabled. Called from the
+    /// engine thread.
+    void reset();
+
+    /// The number of tail blocks that have been muted because the worker
+    /// was late
+    int missedTailBlocks() const {
+        return m_missedTailBlocks;
+    }
+
+    /// Blocks until the worker has finished all posted work. Must not be
+    /// called from the engine thread, this is only useful for tests and
+    /// benchmarks.
+    void waitForWorker() const;
+
+  private:
+    // The spectra of the partitions of an impulse response
+    struct Kernel;
+
+    // Overlap-save convolution with equally sized partitions
+    class UniformConvolver {
+      public:
+        UniformConvolver(SINT blockFrames, SINT maxPartitions);
+        ~UniformConvolver();
+
+        /// Convolves blockFrames samples of one channel and replaces them
+        /// with the result
+        void process(CSAMPLE* pBlock,
+                const std::vector<double>& partitionsRe,
+                const std::vector<double>& partitionsIm,
+                int numPartitions);
+
+        void reset();
+
+        SINT bins() const {
+            return m_blockFrames + 1;
+        }
+
+      private:
+        const SINT m_blockFrames;
+        std::unique_ptr<FFTReal> m_pFft;
+        // The previous and the current block
+        std::vector<double> m_time;
+        std::vector<double> m_spectrumRe;
+        std::vector<double> m_spectrumIm;
+        // The spectra of the previous input blocks, a ring buffer
+        std::vector<double> m_historyRe;
+        std::vector<double> m_historyIm;
+        int m_historyPosition;
+        std::vector<double> m_sumRe;
+        std::vector<double> m_sumIm;
+    };
+
+    static std::unique_ptr<Kernel> createKernel(const std::vector<CSAMPLE>& impulseResponse);
+
+    void processBlock();
+    void startTailBlock(qint64 tailBlock);
+    void restartTail(qint64 firstJob);
+
+    void runWorker();
+    void processTailJob(qint64 job);
+
+    // Engine thread
+    std::unique_ptr<Kernel> m_pKernel;
+    int m_requestedImpulseResponse;
+    int m_requestedSampleRate;
+    std::vector<CSAMPLE> m_inputBlock;
+    std::vector<CSAMPLE> m_outputBlock;
+    SINT m_blockFill;
+    qint64 m_blockIndex;
+    std::vector<CSAMPLE> m_headBlock[2];
+    std::vector<std::unique_ptr<UniformConvolver>> m_headConvolvers;
+    // The first tail job that may be posted, the tail is not fed before
+    qint64 m_firstTailJob;
+    qint64 m_lastPostedTailJob;
+    // Indexed by job % 2
+    qint64 m_lastPostedTailJobs[2];
+    bool m_feedingTail;
+    bool m_tailAvailable;
+    int m_missedTailBlocks;
+
+    // Shared between the engine and the worker thread
+    std::atomic<int> m_impulseResponse;
+    std::atomic<int> m_sampleRate;
+    std::atomic<Kernel*> m_pPendingKernel;
+    std::atomic<Kernel*> m_pRetiredKernel;
+    // The worker resets the tail before this job, because the jobs before
+    // have not been posted
+    std::atomic<qint64> m_tailRestartJob;
+    std::atomic<qint64> m_postedTailJob;
+    std::atomic<qint64> m_completedTailJob;
+    std::atomic<bool> m_loading;
+    // The input of the tail jobs, indexed by job % 2 and channel
+    std::vector<CSAMPLE> m_tailInput[2][2];
+    // The output of the tail jobs, indexed by job % 2 and channel
+    std::vector<CSAMPLE> m_tailOutput[2][2];
+
+    // Worker thread
+    const ImpulseResponseLoader m_loader;
+    const Kernel* m_pWorkerKernel;
+    int m_loadedImpulseResponse;
+    int m_loadedSampleRate;
+    qint64 m_processedTailJob;
+    std::vector<std::unique_ptr<UniformConvolver>> m_tailConvolvers;
+
+    mutable QSemaphore m_semaWorker;
+    std::atomic<bool> m_quit;
+    std::unique_ptr<QThread> m_pWorkerThread;
+};
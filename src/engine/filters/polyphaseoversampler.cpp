@@ -0,0 +1,246 @@
+#include "engine/filters/polyphaseoversampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// The number of non-zero coefficient pairs of the half-band filters.
+// The first stage needs a steep transition below the Nyquist frequency
+// of the original sample rate.
+constexpr int kFirstStageHalfLength = 12;
+constexpr int kSecondStageHalfLength = 4;
+
+constexpr int kMaxFactor = 4;
+
+constexpr int kChannels = 2;
+
+int latencyForFactor(int factor) {
+    switch (factor) {
+    case 2:
+        return 2 * kFirstStageHalfLength - 1;
+    case 4:
+        // The second stage is delayed by one sample of the intermediate
+        // rate, so its latency is a whole number of frames
+        return 2 * kFirstStageHalfLength - 1 + kSecondStageHalfLength;
+    default:
+        return 0;
+    }
+}
+
+} // anonymous namespace
+
+PolyphaseOversampler::Stage::Stage(int halfLength, int extraDelay, SINT maxInputFrames)
+        : m_halfLength(halfLength),
+          m_extraDelay(extraDelay),
+          m_coefficients(halfLength),
+          m_upHistory(2 * halfLength - 1 + extraDelay + maxInputFrames),
+          m_downEvenHistory(2 * halfLength - 1 + maxInputFrames),
+          m_downOddHistory(halfLength + maxInputFrames),
+          m_even(maxInputFrames) {
+    // Blackman windowed sinc with the cutoff at half the Nyquist frequency.
+    // The coefficients at even distances from the center are zero, except
+    // for the center tap of 0.5. Only the odd distances are stored.
+    double sum = 0;
+    for (int j = 0; j < halfLength; ++j) {
+        const double distance = 2 * j + 1;
+        const double sinc = std::sin(M_PI * distance / 2) / (M_PI * distance);
+        const double window = 0.42 +
+                0.5 * std::cos(M_PI * distance / (2 * halfLength)) +
+                0.08 * std::cos(2 * M_PI * distance / (2 * halfLength));
+        m_coefficients[j] = static_cast<CSAMPLE>(sinc * window);
+        sum += m_coefficients[j];
+    }
+    // Normalize to unity gain at DC, the center tap contributes 0.5
+    for (int j = 0; j < halfLength; ++j) {
+        m_coefficients[j] = static_cast<CSAMPLE>(m_coefficients[j] * 0.25 / sum);
+    }
+}
+
+void PolyphaseOversampler::Stage::upsample(
+        CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames) {
+    // The extra delay keeps additional input samples in the history
+    const int historyLength = 2 * m_halfLength - 1 + m_extraDelay;
+    CSAMPLE* pHistory = m_upHistory.data();
+    std::copy(pInput, pInput + numFrames, pHistory + historyLength);
+
+    // The zero-stuffed samples are multiplied with the odd taps, which
+    // gives the even output samples. The factor 2 compensates the energy
+    // of the zero-stuffed samples.
+    CSAMPLE* pEven = m_even.data();
+    std::fill(pEven, pEven + numFrames, CSAMPLE_ZERO);
+    for (int j = 0; j < m_halfLength; ++j) {
+        const CSAMPLE coefficient = 2 * m_coefficients[j];
+        const CSAMPLE* pLater = pHistory + m_halfLength + j;
+        const CSAMPLE* pEarlier = pHistory + m_halfLength - 1 - j;
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pEven[i] += coefficient * (pLater[i] + pEarlier[i]);
+        }
+    }
+    // The odd output samples only see the center tap
+    const CSAMPLE* pCenter = pHistory + m_halfLength;
+    SampleUtil::interleaveBuffer(pOutput, pEven, pCenter, numFrames);
+
+    std::copy(pHistory + numFrames,
+            pHistory + numFrames + historyLength,
+            pHistory);
+}
+
+void PolyphaseOversampler::Stage::downsample(
+        CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames) {
+    const int evenHistoryLength = 2 * m_halfLength - 1;
+    const int oddHistoryLength = m_halfLength;
+    CSAMPLE* pEvenHistory = m_downEvenHistory.data();
+    CSAMPLE* pOddHistory = m_downOddHistory.data();
+    SampleUtil::deinterleaveBuffer(pEvenHistory + evenHistoryLength,
+            pOddHistory + oddHistoryLength,
+            pInput,
+            numFrames);
+
+    // Only the output samples that are kept are calculated. The odd input
+    // samples only see the center tap, the even ones the odd taps.
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pOutput[i] = 0.5f * pOddHistory[i];
+    }
+    for (int j = 0; j < m_halfLength; ++j) {
+        const CSAMPLE coefficient = m_coefficients[j];
+        const CSAMPLE* pLater = pEvenHistory + m_halfLength + j;
+        const CSAMPLE* pEarlier = pEvenHistory + m_halfLength - 1 - j;
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pOutput[i] += coefficient * (pLater[i] + pEarlier[i]);
+        }
+    }
+
+    std::copy(pEvenHistory + numFrames,
+            pEvenHistory + numFrames + evenHistoryLength,
+            pEvenHistory);
+    std::copy(pOddHistory + numFrames,
+            pOddHistory + numFrames + oddHistoryLength,
+            pOddHistory);
+}
+
+void PolyphaseOversampler::Stage::reset() {
+    std::fill(m_upHistory.begin(), m_upHistory.end(), CSAMPLE_ZERO);
+    std::fill(m_downEvenHistory.begin(), m_downEvenHistory.end(), CSAMPLE_ZERO);
+    std::fill(m_downOddHistory.begin(), m_downOddHistory.end(), CSAMPLE_ZERO);
+}
+
+PolyphaseOversampler::PolyphaseOversampler(SINT maxFramesPerBuffer, int factor)
+        : m_maxFramesPerBuffer(maxFramesPerBuffer),
+          m_factor(1),
+          m_oversampled(kChannels * kMaxFactor * maxFramesPerBuffer),
+          m_dryHistory(kChannels * (latencyForFactor(kMaxFactor) + maxFramesPerBuffer)) {
+    m_stages.reserve(2 * kChannels);
+    for (int channel = 0; channel < kChannels; ++channel) {
+        m_stages.emplace_back(kFirstStageHalfLength, 0, maxFramesPerBuffer);
+        m_stages.emplace_back(kSecondStageHalfLength, 1, 2 * maxFramesPerBuffer);
+        m_planar[channel].resize(maxFramesPerBuffer);
+        m_planarIntermediate[channel].resize(2 * maxFramesPerBuffer);
+        m_planarOversampled[channel].resize(kMaxFactor * maxFramesPerBuffer);
+    }
+    setFactor(factor);
+}
+
+void PolyphaseOversampler::setFactor(int factor) {
+    VERIFY_OR_DEBUG_ASSERT(factor == 1 || factor == 2 || factor == kMaxFactor) {
+        factor = 1;
+    }
+    if (factor == m_factor) {
+        return;
+    }
+    m_factor = factor;
+    reset();
+}
+
+SINT PolyphaseOversampler::latencyFrames() const {
+    return latencyForFactor(m_factor);
+}
+
+CSAMPLE* PolyphaseOversampler::upsample(const CSAMPLE* pInput, SINT numFrames) {
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_maxFramesPerBuffer) {
+        numFrames = m_maxFramesPerBuffer;
+    }
+    CSAMPLE* pOversampled = m_oversampled.data();
+    if (m_factor == 1) {
+        SampleUtil::copy(pOversampled, pInput, kChannels * numFrames);
+        return pOversampled;
+    }
+
+    SampleUtil::deinterleaveBuffer(m_planar[0].data(), m_planar[1].data(), pInput, numFrames);
+    for (int channel = 0; channel < kChannels; ++channel) {
+        if (m_factor == 2) {
+            m_stages[channel * 2].upsample(m_planarOversampled[channel].data(),
+                    m_planar[channel].data(),
+                    numFrames);
+        } else {
+            m_stages[channel * 2].upsample(m_planarIntermediate[channel].data(),
+                    m_planar[channel].data(),
+                    numFrames);
+            m_stages[channel * 2 + 1].upsample(m_planarOversampled[channel].data(),
+                    m_planarIntermediate[channel].data(),
+                    2 * numFrames);
+        }
+    }
+    SampleUtil::interleaveBuffer(pOversampled,
+            m_planarOversampled[0].data(),
+            m_planarOversampled[1].data(),
+            m_factor * numFrames);
+    return pOversampled;
+}
+
+void PolyphaseOversampler::downsample(CSAMPLE* pOutput, SINT numFrames) {
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_maxFramesPerBuffer) {
+        numFrames = m_maxFramesPerBuffer;
+    }
+    const CSAMPLE* pOversampled = m_oversampled.data();
+    if (m_factor == 1) {
+        SampleUtil::copy(pOutput, pOversampled, kChannels * numFrames);
+        return;
+    }
+
+    SampleUtil::deinterleaveBuffer(m_planarOversampled[0].data(),
+            m_planarOversampled[1].data(),
+            pOversampled,
+            m_factor * numFrames);
+    for (int channel = 0; channel < kChannels; ++channel) {
+        if (m_factor == 2) {
+            m_stages[channel * 2].downsample(m_planar[channel].data(),
+                    m_planarOversampled[channel].data(),
+                    numFrames);
+        } else {
+            m_stages[channel * 2 + 1].downsample(m_planarIntermediate[channel].data(),
+                    m_planarOversampled[channel].data(),
+                    2 * numFrames);
+            m_stages[channel * 2].downsample(m_planar[channel].data(),
+                    m_planarIntermediate[channel].data(),
+                    numFrames);
+        }
+    }
+    SampleUtil::interleaveBuffer(pOutput, m_planar[0].data(), m_planar[1].data(), numFrames);
+}
+
+void PolyphaseOversampler::delayDry(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames) {
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_maxFramesPerBuffer) {
+        numFrames = m_maxFramesPerBuffer;
+    }
+    const SINT latencySamples = kChannels * latencyFrames();
+    const SINT numSamples = kChannels * numFrames;
+    CSAMPLE* pHistory = m_dryHistory.data();
+    SampleUtil::copy(pHistory + latencySamples, pInput, numSamples);
+    SampleUtil::copy(pOutput, pHistory, numSamples);
+    std::copy(pHistory + numSamples, pHistory + numSamples + latencySamples, pHistory);
+}
+
+void PolyphaseOversampler::reset() {
+    for (auto& stage : m_stages) {
+        stage.reset();
+    }
+    std::fill(m_dryHistory.begin(), m_dryHistory.end(), CSAMPLE_ZERO);
+}
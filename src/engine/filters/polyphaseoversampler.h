@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include "util/types.h"
+
+/// Oversamples interleaved stereo audio by 2 or 4, so that nonlinear effects
+/// like waveshapers produce less aliasing.
+///
+/// Each factor of 2 is a linear phase half-band FIR filter that is split into
+/// its polyphase components. Only every other tap of a half-band filter is
+/// non-zero, and the polyphase form does not calculate the samples that are
+/// zero-stuffed or dropped. The filters loop over the frames of the buffer
+/// for each tap, so the compiler can vectorize them.
+///
+/// The 4x oversampling uses a shorter filter for the second stage,
+/// because the images at the higher rate are far from the audio band.
+///
+/// All buffers are allocated in the constructor, so the factor can be
+/// changed in the engine thread.
+class PolyphaseOversampler {
+  public:
+    PolyphaseOversampler(SINT maxFramesPerBuffer, int factor);
+
+    /// Sets the oversampling factor 1 (disabled), 2 or 4 and resets the
+    /// filters if it has changed
+    void setFactor(int factor);
+    int factor() const {
+        return m_factor;
+    }
+
+    /// The delay of the oversampled signal after downsample(), in frames
+    /// at the original sample rate
+    SINT latencyFrames() const;
+
+    /// Upsamples numFrames frames of interleaved stereo audio. Returns the
+    /// interleaved stereo buffer with numFrames * factor() frames, which
+    /// is processed in place before calling downsample().
+    CSAMPLE* upsample(const CSAMPLE* pInput, SINT numFrames);
+
+    /// Downsamples the buffer returned by upsample() into numFrames frames
+    /// of pOutput
+    void downsample(CSAMPLE* pOutput, SINT numFrames);
+
+    /// Delays the unprocessed input by latencyFrames(), so it can be mixed
+    /// with the oversampled signal without comb filtering. pOutput and
+    /// pInput may be the same buffer.
+    void delayDry(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames);
+
+    /// Clears the filter history, e.g. after the effect has been disabled
+    void reset();
+
+  private:
+    /// One 2x half-band stage for one channel
+    class Stage {
+      public:
+        Stage(int halfLength, int extraDelay, SINT maxInputFrames);
+
+        /// Writes 2 * numFrames samples to pOutput
+        void upsample(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames);
+        /// Reads 2 * numFrames samples from pInput
+        void downsample(CSAMPLE* pOutput, const CSAMPLE* pInput, SINT numFrames);
+
+        /// The delay of upsample() and downsample() in frames of the
+        /// lower sample rate
+        int latencyFrames() const {
+            return 2 * m_halfLength - 1 + m_extraDelay;
+        }
+
+        void reset();
+
+      private:
+        // The number of non-zero coefficient pairs besides the center tap
+        const int m_halfLength;
+        // Delays the upsampled signal by whole samples of the lower rate,
+        // so the latency of all stages is a whole number of frames
+        const int m_extraDelay;
+        std::vector<CSAMPLE> m_coefficients;
+
+        std::vector<CSAMPLE> m_upHistory;
+        std::vector<CSAMPLE> m_downEvenHistory;
+        std::vector<CSAMPLE> m_downOddHistory;
+        std::vector<CSAMPLE> m_even;
+    };
+
+    const SINT m_maxFramesPerBuffer;
+    int m_factor;
+
+    // Two stages for each channel
+    std::vector<Stage> m_stages;
+
+    std::vector<CSAMPLE> m_planar[2];
+    std::vector<CSAMPLE> m_planarOversampled[2];
+    std::vector<CSAMPLE> m_planarIntermediate[2];
+    std::vector<CSAMPLE> m_oversampled;
+    std::vector<CSAMPLE> m_dryHistory;
+};
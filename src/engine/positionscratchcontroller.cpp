@@ -1,10 +1,32 @@
 #include "engine/positionscratchcontroller.h"
 
+#include <iterator>
+
 #include "control/controlobject.h"
 #include "engine/bufferscalers/enginebufferscale.h" // for MIN_SEEK_SPEED
 #include "moc_positionscratchcontroller.cpp"
 #include "preferences/configobject.h" // for ConfigKey
+#include "util/compatibility/qmutex.h"
+#include "util/inputtimestamp.h"
 #include "util/math.h"
+#include "util/time.h"
+
+namespace {
+
+// Enough for inputs at 1 kHz during the longest audio buffers
+constexpr int kScratchInputQueueSize = 256;
+
+// Mouse events typically arrive every 8 ms
+constexpr double kDefaultScratchInputInterval = 0.008;
+
+// The scratch position follows the inputs delayed by two input intervals,
+// so that there is an input on both sides of the interpolated position
+// despite of the jitter of the inputs. The upper limit keeps scratching
+// responsive with slowly polled controllers.
+constexpr double kMinScratchInputDelay = 0.002;
+constexpr double kMaxScratchInputDelay = 0.032;
+
+} // anonymous namespace
 
 class VelocityController {
   public:
@@ -74,9 +96,17 @@ PositionScratchController::PositionScratchController(const QString& group)
           m_scratchStartPos(0),
           m_rate(0),
           m_moveDelay(0),
-          m_mouseSampleTime(0) {
+          m_scratchInputQueue(kScratchInputQueueSize),
+          m_scratchInputInterval(kDefaultScratchInputInterval) {
     m_pScratchEnable = new ControlObject(ConfigKey(group, "scratch_position_enable"));
     m_pScratchPos = new ControlObject(ConfigKey(group, "scratch_position"));
+    // Timestamp the positions in the thread that sets them
+    connect(m_pScratchPos,
+            &ControlObject::valueChanged,
+            this,
+            &PositionScratchController::slotScratchPositionChanged,
+            Qt::DirectConnection);
+    m_scratchInputs.reserve(kScratchInputQueueSize);
     m_pMainSampleRate = ControlObject::getControl(
             ConfigKey(QStringLiteral("[App]"), QStringLiteral("samplerate")));
     m_pVelocityController = new VelocityController();
@@ -99,6 +129,8 @@ void PositionScratchController::process(double currentSamplePos,
         mixxx::audio::FramePos target) {
     bool scratchEnable = m_pScratchEnable->get() != 0;
 
+    readScratchInputs();
+
     if (!m_isScratching && !scratchEnable) {
         // We were not previously in scratch mode are still not in scratch
         // mode. Do nothing
@@ -108,25 +140,31 @@ void PositionScratchController::process(double currentSamplePos,
     // The latency or time difference between process calls.
     const double dt = static_cast<double>(iBufferSize) / m_pMainSampleRate->get() / 2;
 
-    // Sample Mouse with fixed timing intervals to iron out significant jitters
-    // that are added on the way from mouse to engine thread
-    // Normally the Mouse is sampled every 8 ms so with this 16 ms window we
-    // have 0 ... 3 samples. The remaining jitter is ironed by the following IIR
-    // lowpass filter
-    const double m_mouseSampleInterval = 0.016;
-    const auto callsPerDt = static_cast<int>(ceil(m_mouseSampleInterval / dt));
-    double scratchPosition = 0;
-    m_mouseSampleTime += dt;
-    if (m_mouseSampleTime >= m_mouseSampleInterval || !m_isScratching) {
+    // Interpolate the timestamped inputs at the time of this callback to
+    // iron out the jitter that is added on the way from the mouse or
+    // controller to the engine thread and that depends on the poll rate.
+    // The remaining jitter is ironed by the following IIR lowpass filter
+    const double scratchInputDelay = math_clamp(2 * m_scratchInputInterval,
+            kMinScratchInputDelay,
+            kMaxScratchInputDelay);
+    double scratchPosition;
+    if (m_isScratching) {
+        scratchPosition = interpolateScratchPosition(mixxx::Time::elapsed() -
+                mixxx::Duration::fromSeconds(scratchInputDelay));
+    } else {
+        // Start from the most recent position, older inputs belong to
+        // the previous scratch gesture
         scratchPosition = m_pScratchPos->get();
-        m_mouseSampleTime = 0;
+        if (m_scratchInputs.size() > 1) {
+            m_scratchInputs.erase(m_scratchInputs.begin(), m_scratchInputs.end() - 1);
+        }
     }
 
     // Tweak PD controller for different latencies
     double p = 0.3;
     double d = p/-2;
     double f = 0.4;
-    if (dt > m_mouseSampleInterval * 2) {
+    if (dt > scratchInputDelay * 2) {
         f = 1;
     }
     m_pVelocityController->setPD(p, d);
@@ -202,59 +240,54 @@ void PositionScratchController::process(double currentSamplePos,
             // boundaries. And normalize to one buffer
             m_samplePosDeltaSum += (sampleDelta) / (iBufferSize * baseSampleRate);
 
-            // Continue with the last rate if we do not have a new
-            // Mouse position
-            if (m_mouseSampleTime == 0) {
-                // Set the scratch target to the current set position
-                // and normalize to one buffer
-                double scratchTargetDelta = (scratchPosition - m_scratchStartPos) /
-                        (iBufferSize * baseSampleRate);
-
-                bool calcRate = true;
-
-                if (m_scratchTargetDelta == scratchTargetDelta) {
-                    // we get here, if the next mouse position is delayed
-                    // the mouse is stopped or moves slow. Since we don't know the case
-                    // we assume delayed mouse updates for 40 ms
-                    m_moveDelay += dt * callsPerDt;
-                    if (m_moveDelay < 0.04) {
-                        // Assume a missing Mouse Update and continue with the
-                        // previously calculated rate.
-                        calcRate = false;
-                    } else {
-                        // Mouse has stopped
-                        m_pVelocityController->setPD(p, 0);
-                        if (scratchTargetDelta == 0) {
-                            // Mouse was not moved at all
-                            // Stop immediately by restarting the controller
-                            // in stopped mode
-                            m_pVelocityController->reset(0);
-                            m_pRateIIFilter->reset(0);
-                            m_samplePosDeltaSum = 0;
-                        }
-                    }
+            // Set the scratch target to the current set position
+            // and normalize to one buffer
+            double scratchTargetDelta = (scratchPosition - m_scratchStartPos) /
+                    (iBufferSize * baseSampleRate);
+
+            bool calcRate = true;
+
+            if (m_scratchTargetDelta == scratchTargetDelta) {
+                // we get here, if the next mouse position is delayed
+                // the mouse is stopped or moves slow. Since we don't know the case
+                // we assume delayed mouse updates for 40 ms
+                m_moveDelay += dt;
+                if (m_moveDelay < 0.04) {
+                    // Assume a missing Mouse Update and continue with the
+                    // previously calculated rate.
+                    calcRate = false;
                 } else {
-                    m_moveDelay = 0;
-                    m_scratchTargetDelta = scratchTargetDelta;
-                }
-
-                if (calcRate) {
-                    double ctrlError = m_pRateIIFilter->filter(
-                            scratchTargetDelta - m_samplePosDeltaSum);
-                    m_rate = m_pVelocityController->observation(ctrlError);
-                    m_rate /= ceil(m_mouseSampleInterval / dt);
-                    // Note: The following SoundTouch changes the also rate by a ramp
-                    // This looks like average of the new and the old rate independent
-                    // from dt. Ramping is disabled when direction changes or rate = 0;
-                    // (determined experimentally)
-                    if (fabs(m_rate) < MIN_SEEK_SPEED) {
-                        // we cannot get closer
-                        m_rate = 0;
+                    // Mouse has stopped
+                    m_pVelocityController->setPD(p, 0);
+                    if (scratchTargetDelta == 0) {
+                        // Mouse was not moved at all
+                        // Stop immediately by restarting the controller
+                        // in stopped mode
+                        m_pVelocityController->reset(0);
+                        m_pRateIIFilter->reset(0);
+                        m_samplePosDeltaSum = 0;
                     }
                 }
+            } else {
+                m_moveDelay = 0;
+                m_scratchTargetDelta = scratchTargetDelta;
+            }
 
-                // qDebug() << m_rate << scratchTargetDelta << m_samplePosDeltaSum << dt;
+            if (calcRate) {
+                double ctrlError = m_pRateIIFilter->filter(
+                        scratchTargetDelta - m_samplePosDeltaSum);
+                m_rate = m_pVelocityController->observation(ctrlError);
+                // Note: The following SoundTouch changes the also rate by a ramp
+                // This looks like average of the new and the old rate independent
+                // from dt. Ramping is disabled when direction changes or rate = 0;
+                // (determined experimentally)
+                if (fabs(m_rate) < MIN_SEEK_SPEED) {
+                    // we cannot get closer
+                    m_rate = 0;
+                }
             }
+
+            // qDebug() << m_rate << scratchTargetDelta << m_samplePosDeltaSum << dt;
         } else {
             // We were previously in scratch mode and are no longer in scratch
             // mode. Disable everything, or optionally enable inertia mode if
@@ -279,8 +312,8 @@ void PositionScratchController::process(double currentSamplePos,
         m_moveDelay = 0;
         // Set up initial values, in a way that the system is settled
         m_rate = releaseRate;
-        m_samplePosDeltaSum = -(releaseRate / p) *
-                callsPerDt; // Set to the remaining error of a p controller
+        // Set to the remaining error of a p controller
+        m_samplePosDeltaSum = -(releaseRate / p);
         m_pVelocityController->reset(-m_samplePosDeltaSum);
         m_pRateIIFilter->reset(-m_samplePosDeltaSum);
         m_scratchStartPos = scratchPosition;
@@ -289,11 +322,67 @@ void PositionScratchController::process(double currentSamplePos,
     m_prevSamplePos = currentSamplePos;
 }
 
+void PositionScratchController::slotScratchPositionChanged(double position) {
+    const ScratchInput input{mixxx::InputTimestamp::current(), position};
+    // The mouse and the controllers set the position from different threads.
+    // Inputs are dropped if the engine does not keep up.
+    const auto locker = lockMutex(&m_scratchInputWriteMutex);
+    m_scratchInputQueue.write(&input, 1);
+}
+
+void PositionScratchController::readScratchInputs() {
+    ScratchInput input;
+    while (m_scratchInputQueue.read(&input, 1) == 1) {
+        if (!m_scratchInputs.empty()) {
+            const double interval =
+                    (input.timestamp - m_scratchInputs.back().timestamp).toDoubleSeconds();
+            if (interval > 0) {
+                // Long pauses between gestures must not count as interval
+                m_scratchInputInterval += 0.1 *
+                        (math_min(interval, kMaxScratchInputDelay) -
+                                m_scratchInputInterval);
+            }
+            if (m_scratchInputs.size() == m_scratchInputs.capacity()) {
+                m_scratchInputs.erase(m_scratchInputs.begin());
+            }
+        }
+        m_scratchInputs.push_back(input);
+    }
+}
+
+double PositionScratchController::interpolateScratchPosition(mixxx::Duration time) {
+    // Drop the inputs that are no longer needed for interpolating at
+    // this or any later time
+    auto prev = m_scratchInputs.begin();
+    while (prev != m_scratchInputs.end() &&
+            std::next(prev) != m_scratchInputs.end() &&
+            std::next(prev)->timestamp <= time) {
+        ++prev;
+    }
+    m_scratchInputs.erase(m_scratchInputs.begin(), prev);
+
+    if (m_scratchInputs.empty()) {
+        return m_pScratchPos->get();
+    }
+    const ScratchInput& prevInput = m_scratchInputs[0];
+    if (m_scratchInputs.size() == 1 || time <= prevInput.timestamp) {
+        return prevInput.position;
+    }
+    const ScratchInput& nextInput = m_scratchInputs[1];
+    const double fraction = (time - prevInput.timestamp).toDoubleSeconds() /
+            (nextInput.timestamp - prevInput.timestamp).toDoubleSeconds();
+    return prevInput.position + (nextInput.position - prevInput.position) * fraction;
+}
+
 bool PositionScratchController::isEnabled() {
     // return true only if m_rate is valid.
     return m_isScratching;
 }
 
+bool PositionScratchController::isAtRest() const {
+    return !m_isScratching && m_pScratchEnable->get() == 0;
+}
+
 double PositionScratchController::getRate() {
     return m_rate;
 }
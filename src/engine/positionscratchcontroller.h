@@ -1,9 +1,13 @@
 #pragma once
 
+#include <QMutex>
 #include <QObject>
 #include <QString>
+#include <vector>
 
 #include "audio/frame.h"
+#include "util/duration.h"
+#include "util/fifo.h"
 
 class ControlObject;
 class RateIIFilter;
@@ -23,10 +27,25 @@ class PositionScratchController : public QObject {
             mixxx::audio::FramePos trigger,
             mixxx::audio::FramePos target);
     bool isEnabled();
+    /// True if neither scratching nor about to start scratching
+    bool isAtRest() const;
     double getRate();
     void notifySeek(mixxx::audio::FramePos position);
 
+  private slots:
+    void slotScratchPositionChanged(double position);
+
   private:
+    /// A scratch position together with the arrival time of the input
+    /// event that caused it.
+    struct ScratchInput {
+        mixxx::Duration timestamp;
+        double position;
+    };
+
+    void readScratchInputs();
+    double interpolateScratchPosition(mixxx::Duration time);
+
     const QString m_group;
     ControlObject* m_pScratchEnable;
     ControlObject* m_pScratchPos;
@@ -41,5 +60,12 @@ class PositionScratchController : public QObject {
     double m_scratchStartPos;
     double m_rate;
     double m_moveDelay;
-    double m_mouseSampleTime;
+
+    // Written by the GUI and controller threads, read by the engine
+    FIFO<ScratchInput> m_scratchInputQueue;
+    QMutex m_scratchInputWriteMutex;
+    // The inputs around the interpolated position, owned by the engine
+    std::vector<ScratchInput> m_scratchInputs;
+    // Smoothed interval between inputs in seconds
+    double m_scratchInputInterval;
 };
@@ -6,13 +6,27 @@
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// Loops that fit into this buffer together with their crossfade tails are
+// read from a copy, e.g. beat loops of up to a few seconds for stereo
+// tracks, or of about a second for stem tracks.
+constexpr SINT kLoopBufferSamples = 1 << 19;
+// The crossfade at the wrap-around reads up to one request before the loop
+// start, or after the loop end in reverse.
+constexpr SINT kLoopBufferTailFrames = kMaxEngineFrames;
+
+} // anonymous namespace
+
 ReadAheadManager::ReadAheadManager()
         : m_pLoopingControl(nullptr),
           m_pRateControl(nullptr),
           m_currentPosition(0),
           m_pReader(nullptr),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
-          m_cacheMissHappened(false) {
+          m_cacheMissHappened(false),
+          m_loopBufferStartSample(0),
+          m_loopBufferEndSample(0) {
     // For testing only: ReadAheadManagerMock
 }
 
@@ -23,7 +37,10 @@ ReadAheadManager::ReadAheadManager(CachingReader* pReader,
           m_currentPosition(0),
           m_pReader(pReader),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
-          m_cacheMissHappened(false) {
+          m_cacheMissHappened(false),
+          m_loopBuffer(kLoopBufferSamples),
+          m_loopBufferStartSample(0),
+          m_loopBufferEndSample(0) {
     DEBUG_ASSERT(m_pLoopingControl != nullptr);
     DEBUG_ASSERT(m_pReader != nullptr);
 }
@@ -88,7 +105,7 @@ SINT ReadAheadManager::getNextSamples(double dRate,
     SINT start_sample = SampleUtil::roundPlayPosToFrameStart(
             m_currentPosition, channelCount);
 
-    const auto readResult = m_pReader->read(
+    const auto readResult = readSamples(
             start_sample, samples_from_reader, in_reverse, pOutput, channelCount);
     if (readResult == CachingReader::ReadResult::UNAVAILABLE) {
         // Cache miss - no samples written
@@ -127,6 +144,10 @@ SINT ReadAheadManager::getNextSamples(double dRate,
         }
         // TODO probably also useful for hotcue_X_indicator in CueControl::updateIndicators()
 
+        // The whole loop has just been played, so its chunks are most likely
+        // cached and it is read from a copy from now on.
+        updateLoopBuffer(channelCount);
+
         // Jump to other end of loop or track.
         m_currentPosition = target;
         if (preloop_samples > 0) {
@@ -172,7 +193,7 @@ SINT ReadAheadManager::getNextSamples(double dRate,
         }
 
         if (crossFadeSamples > 0) {
-            const auto readResult = m_pReader->read(loop_read_position +
+            const auto readResult = readSamples(loop_read_position +
                             (in_reverse ? crossFadeStart : -crossFadeStart),
                     crossFadeSamples,
                     in_reverse,
@@ -227,6 +248,80 @@ void ReadAheadManager::notifySeek(double seekPosition) {
     // }
 }
 
+void ReadAheadManager::notifyTrackChanged() {
+    m_loopBufferStartSample = 0;
+    m_loopBufferEndSample = 0;
+}
+
+CachingReader::ReadResult ReadAheadManager::readSamples(SINT startSample,
+        SINT numSamples,
+        bool reverse,
+        CSAMPLE* pOutput,
+        mixxx::audio::ChannelCount channelCount) {
+    // The reader reads backwards from startSample in reverse
+    const SINT firstSample = reverse ? startSample - numSamples : startSample;
+    if (numSamples > 0 &&
+            channelCount == m_loopBufferChannelCount &&
+            firstSample >= m_loopBufferStartSample &&
+            firstSample + numSamples <= m_loopBufferEndSample) {
+        const CSAMPLE* pSource = m_loopBuffer.data(firstSample - m_loopBufferStartSample);
+        if (reverse) {
+            SampleUtil::copyReverse(pOutput, pSource, numSamples, channelCount);
+        } else {
+            SampleUtil::copy(pOutput, pSource, numSamples);
+        }
+        return CachingReader::ReadResult::AVAILABLE;
+    }
+    return m_pReader->read(startSample, numSamples, reverse, pOutput, channelCount);
+}
+
+void ReadAheadManager::updateLoopBuffer(mixxx::audio::ChannelCount channelCount) {
+    if (!m_pLoopingControl->isLoopingEnabled()) {
+        // Wrap-around at the track end with repeat enabled
+        return;
+    }
+    const LoopingControl::LoopInfo loopInfo = m_pLoopingControl->getLoopInfo();
+    const mixxx::audio::FramePos trackEndPosition = m_pLoopingControl->getTrackFrame();
+    if (!loopInfo.startPosition.isValid() ||
+            !loopInfo.endPosition.isValid() ||
+            !trackEndPosition.isValid()) {
+        return;
+    }
+    const SINT startFrame = math_max<SINT>(0,
+            static_cast<SINT>(std::floor(loopInfo.startPosition.value())) -
+                    kLoopBufferTailFrames);
+    const SINT endFrame = math_min(
+            static_cast<SINT>(std::floor(trackEndPosition.value())),
+            static_cast<SINT>(std::ceil(loopInfo.endPosition.value())) +
+                    kLoopBufferTailFrames);
+    const SINT startSample = startFrame * channelCount;
+    const SINT endSample = endFrame * channelCount;
+    if (channelCount == m_loopBufferChannelCount &&
+            startSample >= m_loopBufferStartSample &&
+            endSample <= m_loopBufferEndSample) {
+        return;
+    }
+    if (endSample <= startSample || endSample - startSample > m_loopBuffer.size()) {
+        return;
+    }
+
+    // The buffer is overwritten, even if the read fails
+    m_loopBufferStartSample = 0;
+    m_loopBufferEndSample = 0;
+    const auto readResult = m_pReader->read(startSample,
+            endSample - startSample,
+            false,
+            m_loopBuffer.data(),
+            channelCount);
+    if (readResult != CachingReader::ReadResult::AVAILABLE) {
+        // Try again at the next wrap-around
+        return;
+    }
+    m_loopBufferStartSample = startSample;
+    m_loopBufferEndSample = endSample;
+    m_loopBufferChannelCount = channelCount;
+}
+
 void ReadAheadManager::hintReader(double dRate,
         gsl::not_null<HintVector*> pHintList,
         mixxx::audio::ChannelCount channelCount) {
@@ -235,7 +330,7 @@ void ReadAheadManager::hintReader(double dRate,
 
     // SoundTouch can read up to 2 chunks ahead. Always keep 2 chunks ahead in
     // cache.
-    SINT frameCountToCache = 2 * CachingReaderChunk::kFrames;
+    SINT frameCountToCache = 2 * CachingReaderChunk::kDefaultFrames;
     current_position.frameCount = frameCountToCache;
 
     // this called after the precious chunk was consumed
@@ -6,6 +6,7 @@
 #include "audio/frame.h"
 #include "engine/cachingreader/cachingreader.h"
 #include "util/math.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class LoopingControl;
@@ -50,6 +51,10 @@ class ReadAheadManager {
 
     virtual void notifySeek(double seekPosition);
 
+    /// Discards the copy of the active loop, which belongs to the previous
+    /// track. Must be called whenever the track changes.
+    void notifyTrackChanged();
+
     /// hintReader allows the ReadAheadManager to provide hints to the reader to
     /// indicate that the given portion of a song is about to be read.
     virtual void hintReader(double dRate,
@@ -123,6 +128,18 @@ class ReadAheadManager {
     void addReadLogEntry(double virtualPlaypositionStart,
                          double virtualPlaypositionEndNonInclusive);
 
+    /// Reads from the loop buffer if it contains all requested samples, and
+    /// from the CachingReader otherwise. Same arguments as CachingReader::read().
+    CachingReader::ReadResult readSamples(SINT startSample,
+            SINT numSamples,
+            bool reverse,
+            CSAMPLE* pOutput,
+            mixxx::audio::ChannelCount channelCount);
+    /// Copies the active loop and the samples around it that are needed for
+    /// the crossfade at the wrap-around into the loop buffer, unless they
+    /// are already contained or do not fit.
+    void updateLoopBuffer(mixxx::audio::ChannelCount channelCount);
+
     LoopingControl* m_pLoopingControl;
     RateControl* m_pRateControl;
     std::list<ReadLogEntry> m_readAheadLog;
@@ -130,4 +147,13 @@ class ReadAheadManager {
     CachingReader* m_pReader;
     CSAMPLE* m_pCrossFadeBuffer;
     bool m_cacheMissHappened;
+
+    // A contiguous copy of the track samples of a short loop, which is read
+    // instead of seeking through the CachingReader on every wrap-around.
+    // The samples of a track never change, so it is valid until the track
+    // changes. It is empty if the start equals the end.
+    mixxx::SampleBuffer m_loopBuffer;
+    SINT m_loopBufferStartSample;
+    SINT m_loopBufferEndSample;
+    mixxx::audio::ChannelCount m_loopBufferChannelCount;
 };
@@ -0,0 +1,246 @@
+#include "engine/sidechain/enginemultitrackrecorder.h"
+
+#ifdef _WIN32
+// Enable unicode in libsndfile on Windows
+// (sf_open uses UTF-8 otherwise)
+#include <windows.h>
+#define ENABLE_SNDFILE_WINDOWS_PROTOTYPES 1
+#endif
+#include <sndfile.h>
+
+#include <QFile>
+#include <QRegularExpression>
+#include <algorithm>
+
+#include "engine/engine.h"
+#include "util/assert.h"
+#include "util/counter.h"
+#include "util/defs.h"
+#include "util/logger.h"
+#include "util/sample.h"
+#include "util/threadplacement.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineMultitrackRecorder");
+
+// The writer thread may fall behind by this duration before samples are
+// lost, e.g. while a slow disk flushes its cache
+constexpr int kFifoSeconds = 4;
+
+// How often the writer thread drains the FIFO. The engine thread does not
+// signal the writer thread, because waking a thread is not real-time safe.
+constexpr int kDrainIntervalMillis = 20;
+
+// libsndfile can't write more channels to a FLAC file
+constexpr int kMaxFlacChannels = 8;
+
+constexpr int kStemChannels = mixxx::kEngineChannelOutputCount;
+
+const QRegularExpression kInvalidFileNameCharsRegex(QStringLiteral("[^A-Za-z0-9_-]"));
+
+SNDFILE* openFile(const QString& fileName, int format, int channels, int sampleRate) {
+    SF_INFO info{};
+    info.samplerate = sampleRate;
+    info.channels = channels;
+    info.format = format;
+#ifdef _WIN32
+    SNDFILE* pFile = sf_wchar_open(
+            reinterpret_cast<LPCWSTR>(fileName.utf16()), SFM_WRITE, &info);
+#else
+    SNDFILE* pFile = sf_open(QFile::encodeName(fileName).constData(), SFM_WRITE, &info);
+#endif
+    if (!pFile) {
+        kLogger.warning() << "Failed to open" << fileName << sf_strerror(nullptr);
+        return nullptr;
+    }
+    sf_command(pFile, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+    if ((format & SF_FORMAT_TYPEMASK) == SF_FORMAT_RF64) {
+        // Plain WAV as long as the file stays below 4 GiB
+        sf_command(pFile, SFC_RF64_AUTO_DOWNGRADE, nullptr, SF_TRUE);
+    }
+    return pFile;
+}
+
+} // namespace
+
+EngineMultitrackRecorder::EngineMultitrackRecorder()
+        : m_state(State::Idle),
+          m_engineProcessing(false),
+          m_stopThread(false),
+          m_mode(Mode::Off),
+          m_numStems(0) {
+}
+
+EngineMultitrackRecorder::~EngineMultitrackRecorder() {
+    stopRecording();
+}
+
+bool EngineMultitrackRecorder::startRecording(const QString& baseFileName,
+        Mode mode,
+        bool flac,
+        const QStringList& stemNames,
+        mixxx::audio::SampleRate sampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(m_state.load() == State::Idle) {
+        return false;
+    }
+    VERIFY_OR_DEBUG_ASSERT(mode != Mode::Off && sampleRate.isValid()) {
+        return false;
+    }
+    const int numStems = std::min(static_cast<int>(stemNames.size()), kMaxStems);
+    if (numStems == 0) {
+        return false;
+    }
+    // The engine thread only touches the buffers while recording
+    waitUntilEngineLeftProcess();
+
+    m_mode = mode;
+    m_numStems = numStems;
+    const int numChannels = numStems * kStemChannels;
+    m_pFifo = std::make_unique<FIFO<CSAMPLE>>(
+            kFifoSeconds * static_cast<int>(sampleRate.value()) * numChannels);
+    mixxx::SampleBuffer(kMaxEngineFrames * numChannels).swap(m_interleavedBuffer);
+    mixxx::SampleBuffer(kMaxEngineFrames * numChannels).swap(m_readBuffer);
+    mixxx::SampleBuffer(kMaxEngineFrames * kStemChannels).swap(m_stemBuffer);
+
+    const int subtype = flac ? SF_FORMAT_PCM_24 : SF_FORMAT_FLOAT;
+    const QString extension = flac ? QStringLiteral("flac") : QStringLiteral("wav");
+    if (mode == Mode::MultichannelFile) {
+        int format = SF_FORMAT_RF64 | SF_FORMAT_FLOAT;
+        QString fileExtension = QStringLiteral("wav");
+        if (flac) {
+            if (numChannels <= kMaxFlacChannels) {
+                format = SF_FORMAT_FLAC | subtype;
+                fileExtension = extension;
+            } else {
+                kLogger.info() << "Recording" << numChannels
+                               << "channels as WAV, FLAC supports only"
+                               << kMaxFlacChannels;
+            }
+        }
+        const QString fileName = QStringLiteral("%1_stems.%2").arg(baseFileName, fileExtension);
+        SNDFILE* pFile = openFile(fileName, format, numChannels, sampleRate.value());
+        if (pFile) {
+            m_files.push_back(pFile);
+            kLogger.info() << "Recording stems" << stemNames.mid(0, numStems)
+                           << "to" << fileName;
+        }
+    } else {
+        const int format = (flac ? SF_FORMAT_FLAC : SF_FORMAT_RF64) | subtype;
+        for (int i = 0; i < numStems; ++i) {
+            // "[Channel1]" -> "Channel1"
+            QString stemName = stemNames.at(i);
+            stemName.remove(kInvalidFileNameCharsRegex);
+            const QString fileName = QStringLiteral("%1_%2.%3")
+                                             .arg(baseFileName, stemName, extension);
+            SNDFILE* pFile = openFile(fileName, format, kStemChannels, sampleRate.value());
+            if (!pFile) {
+                break;
+            }
+            m_files.push_back(pFile);
+        }
+    }
+    const int expectedFiles = mode == Mode::MultichannelFile ? 1 : numStems;
+    if (static_cast<int>(m_files.size()) != expectedFiles) {
+        closeFiles();
+        return false;
+    }
+
+    m_stopThread.store(false);
+    start(QThread::HighPriority);
+    m_state.store(State::Recording, std::memory_order_release);
+    return true;
+}
+
+void EngineMultitrackRecorder::stopRecording() {
+    if (m_state.load() != State::Recording) {
+        return;
+    }
+    m_state.store(State::Stopping);
+    waitUntilEngineLeftProcess();
+    m_stopThread.store(true);
+    // The thread writes the remaining samples before it exits
+    wait();
+    closeFiles();
+    m_state.store(State::Idle);
+}
+
+void EngineMultitrackRecorder::waitUntilEngineLeftProcess() const {
+    // Only spins for the duration of a single process() call
+    while (m_engineProcessing.load()) {
+        QThread::yieldCurrentThread();
+    }
+}
+
+void EngineMultitrackRecorder::process(
+        const CSAMPLE* const* ppStemBuffers, int numBuffers, int iFrames) {
+    m_engineProcessing.store(true);
+    if (m_state.load() != State::Recording) {
+        m_engineProcessing.store(false);
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(iFrames <= static_cast<int>(kMaxEngineFrames)) {
+        iFrames = kMaxEngineFrames;
+    }
+    const int numChannels = m_numStems * kStemChannels;
+    CSAMPLE* pInterleaved = m_interleavedBuffer.data();
+    for (int stem = 0; stem < m_numStems; ++stem) {
+        const CSAMPLE* pStem = stem < numBuffers ? ppStemBuffers[stem] : nullptr;
+        CSAMPLE* pOut = pInterleaved + stem * kStemChannels;
+        if (pStem) {
+            for (int frame = 0; frame < iFrames; ++frame) {
+                pOut[frame * numChannels] = pStem[frame * kStemChannels];
+                pOut[frame * numChannels + 1] = pStem[frame * kStemChannels + 1];
+            }
+        } else {
+            for (int frame = 0; frame < iFrames; ++frame) {
+                pOut[frame * numChannels] = CSAMPLE_ZERO;
+                pOut[frame * numChannels + 1] = CSAMPLE_ZERO;
+            }
+        }
+    }
+    const int samples = iFrames * numChannels;
+    if (m_pFifo->write(pInterleaved, samples) != samples) {
+        Counter("EngineMultitrackRecorder buffer overrun").increment();
+    }
+    m_engineProcessing.store(false);
+}
+
+void EngineMultitrackRecorder::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("EngineMultitrackRecorder"));
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::SideChain);
+    while (!m_stopThread.load()) {
+        drainFifo();
+        QThread::msleep(kDrainIntervalMillis);
+    }
+    drainFifo();
+}
+
+void EngineMultitrackRecorder::drainFifo() {
+    const int numChannels = m_numStems * kStemChannels;
+    const int maxSamples = kMaxEngineFrames * numChannels;
+    int samples;
+    while ((samples = m_pFifo->read(m_readBuffer.data(), maxSamples)) > 0) {
+        const sf_count_t frames = samples / numChannels;
+        if (m_mode == Mode::MultichannelFile) {
+            sf_writef_float(m_files.front(), m_readBuffer.data(), frames);
+            continue;
+        }
+        for (int stem = 0; stem < m_numStems; ++stem) {
+            const CSAMPLE* pIn = m_readBuffer.data() + stem * kStemChannels;
+            CSAMPLE* pOut = m_stemBuffer.data();
+            for (sf_count_t frame = 0; frame < frames; ++frame) {
+                pOut[frame * kStemChannels] = pIn[frame * numChannels];
+                pOut[frame * kStemChannels + 1] = pIn[frame * numChannels + 1];
+            }
+            sf_writef_float(m_files[stem], pOut, frames);
+        }
+    }
+}
+
+void EngineMultitrackRecorder::closeFiles() {
+    for (SNDFILE* pFile : m_files) {
+        sf_close(pFile);
+    }
+    m_files.clear();
+}
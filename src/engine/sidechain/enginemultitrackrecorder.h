@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QStringList>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/fifo.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+// Forward declare libsndfile structures to prevent leaking sndfile.h
+// definitions beyond where they are needed.
+typedef struct sf_private_tag SNDFILE;
+
+/// Records the post-fader signal of every channel of the mixer as a separate
+/// stereo track, for editing a mix afterwards.
+///
+/// EngineMixer hands the channel buffers to process() in the engine thread,
+/// which interleaves them into a single multi-channel FIFO without
+/// allocating or locking. A background thread drains the FIFO and writes
+/// either one multi-channel file or one stereo file per channel.
+class EngineMultitrackRecorder : public QThread {
+  public:
+    enum class Mode {
+        Off = 0,
+        MultichannelFile = 1,
+        FilePerChannel = 2,
+    };
+
+    // Decks, samplers, microphones and auxiliary inputs beyond this limit
+    // are not recorded
+    static constexpr int kMaxStems = 32;
+
+    EngineMultitrackRecorder();
+    ~EngineMultitrackRecorder() override;
+
+    /// Opens the files and starts recording. The stems are recorded in the
+    /// order of the channel buffers passed to process(), stemNames are used
+    /// for the file names. Called from the GUI thread.
+    bool startRecording(const QString& baseFileName,
+            Mode mode,
+            bool flac,
+            const QStringList& stemNames,
+            mixxx::audio::SampleRate sampleRate);
+    /// Writes the remaining samples and closes the files. Called from the
+    /// GUI thread.
+    void stopRecording();
+
+    bool isRecording() const {
+        return m_state.load(std::memory_order_acquire) == State::Recording;
+    }
+
+    /// Called from the engine thread, real-time safe. A nullptr buffer is
+    /// recorded as silence, e.g. for a channel that is not playing.
+    void process(const CSAMPLE* const* ppStemBuffers, int numBuffers, int iFrames);
+
+  private:
+    enum class State {
+        Idle,
+        Recording,
+        Stopping,
+    };
+
+    void run() override;
+    void drainFifo();
+    void closeFiles();
+    void waitUntilEngineLeftProcess() const;
+
+    std::atomic<State> m_state;
+    // Set while the engine thread is inside process()
+    std::atomic<bool> m_engineProcessing;
+    std::atomic<bool> m_stopThread;
+
+    // Written by the GUI thread while not recording
+    Mode m_mode;
+    int m_numStems;
+    std::unique_ptr<FIFO<CSAMPLE>> m_pFifo;
+    mixxx::SampleBuffer m_interleavedBuffer;
+    mixxx::SampleBuffer m_readBuffer;
+    mixxx::SampleBuffer m_stemBuffer;
+    std::vector<SNDFILE*> m_files;
+};
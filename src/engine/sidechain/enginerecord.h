@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QDataStream>
 #include <QFile>
 
 #include "audio/types.h"
@@ -10,6 +9,7 @@
 #include "engine/sidechain/sidechainworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
+#include "util/asyncfilewriter.h"
 
 class ControlProxy;
 
@@ -68,9 +68,9 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     QString m_baAuthor;
     QString m_baAlbum;
 
-    QFile m_file;
+    // Keeps disk stalls off the side chain thread
+    mixxx::AsyncFileWriter m_fileWriter;
     QFile m_cueFile;
-    QDataStream m_dataStream;
 
     PollingControlProxy m_sampleRateControl;
     ControlProxy* m_pRecReady;
@@ -4,7 +4,8 @@
 // to increase the amount of time the CPU has to do whatever work needs to
 // be done, and that work is executed in a separate thread. (Threading
 // allows the next buffer to be filled while processing a buffer that's is
-// already full.)
+// already full.) The thread of this class only distributes the samples to
+// the workers, each worker runs in its own SideChainWorkerThread.
 
 #include "engine/sidechain/enginesidechain.h"
 
@@ -12,14 +13,24 @@
 
 #include "engine/engine.h"
 #include "engine/sidechain/sidechainworker.h"
+#include "engine/sidechain/sidechainworkerthread.h"
 #include "moc_enginesidechain.cpp"
 #include "util/counter.h"
 #include "util/event.h"
 #include "util/sample.h"
+#include "util/threadplacement.h"
 #include "util/trace.h"
 
 #define SIDECHAIN_BUFFER_SIZE 65536
 
+namespace {
+
+// Each worker may fall behind by a few buffers before losing samples,
+// e.g. while the encoder of a recording flushes to a slow disk
+constexpr int kWorkerBufferSize = 4 * SIDECHAIN_BUFFER_SIZE;
+
+} // namespace
+
 EngineSideChain::EngineSideChain(
         UserSettingsPointer pConfig,
         CSAMPLE* sidechainMix)
@@ -47,8 +58,11 @@ EngineSideChain::~EngineSideChain() {
     wait();
 
     MMutexLocker locker(&m_workerLock);
-    while (!m_workers.empty()) {
-        SideChainWorker* pWorker = m_workers.takeLast();
+    while (!m_workerThreads.empty()) {
+        SideChainWorkerThread* pWorkerThread = m_workerThreads.takeLast();
+        SideChainWorker* pWorker = pWorkerThread->worker();
+        // Stops the thread after processing the remaining samples
+        delete pWorkerThread;
         pWorker->shutdown();
         delete pWorker;
     }
@@ -59,7 +73,7 @@ EngineSideChain::~EngineSideChain() {
 
 void EngineSideChain::addSideChainWorker(SideChainWorker* pWorker) {
     MMutexLocker locker(&m_workerLock);
-    m_workers.append(pWorker);
+    m_workerThreads.append(new SideChainWorkerThread(pWorker, kWorkerBufferSize));
 }
 
 void EngineSideChain::receiveBuffer(const AudioInput& input,
@@ -96,6 +110,7 @@ void EngineSideChain::run() {
     // factor this out somehow), -kousu 2/2009
     unsigned static id = 0;
     QThread::currentThread()->setObjectName(QString("EngineSideChain %1").arg(++id));
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::SideChain);
     static const QString tag("EngineSideChain");
     Event::start(tag);
     while (!m_bStopThread) {
@@ -112,8 +127,10 @@ void EngineSideChain::run() {
                                                  SIDECHAIN_BUFFER_SIZE))) {
             Trace process("EngineSideChain::process");
             MMutexLocker locker(&m_workerLock);
-            foreach (SideChainWorker* pWorker, m_workers) {
-                pWorker->process(m_pWorkBuffer, samples_read);
+            for (SideChainWorkerThread* pWorkerThread : std::as_const(m_workerThreads)) {
+                if (!pWorkerThread->writeSamples(m_pWorkBuffer, samples_read)) {
+                    Counter("EngineSideChain worker buffer overrun").increment();
+                }
             }
         }
 
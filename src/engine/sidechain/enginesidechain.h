@@ -12,6 +12,7 @@
 #include "util/types.h"
 
 class SideChainWorker;
+class SideChainWorkerThread;
 
 class EngineSideChain : public QThread, public AudioDestination {
     Q_OBJECT
@@ -30,7 +31,7 @@ class EngineSideChain : public QThread, public AudioDestination {
             const CSAMPLE* pBuffer,
             unsigned int iFrames) override;
 
-    // Thread-safe, blocking.
+    // Thread-safe, blocking. Each worker is processed in its own thread.
     void addSideChainWorker(SideChainWorker* pWorker);
 
     static constexpr int SIDECHAIN_BUFFER_SIZE = 65536;
@@ -51,7 +52,7 @@ class EngineSideChain : public QThread, public AudioDestination {
     // Allows sleeping until we have samples to process.
     QWaitCondition m_waitForSamples;
 
-    // Sidechain workers registered with EngineSideChain.
+    // Threads of the sidechain workers registered with EngineSideChain.
     MMutex m_workerLock;
-    QList<SideChainWorker*> m_workers GUARDED_BY(m_workerLock);
+    QList<SideChainWorkerThread*> m_workerThreads GUARDED_BY(m_workerLock);
 };
@@ -0,0 +1,147 @@
+#include "engine/sidechain/sharedbroadcastencoder.h"
+
+#include <QHash>
+#include <algorithm>
+#include <utility>
+
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+// Same limit as for the libshout queue, see ShoutConnection::write().
+// A subscriber that falls further behind loses data instead of growing
+// the queue without bounds.
+constexpr int kMaxEncodedDataSize = 491520; // 10 s mp3 @ 192 kbit/s
+
+const mixxx::Logger kLogger("SharedBroadcastEncoder");
+
+QMutex s_registryMutex;
+QHash<QString, std::weak_ptr<SharedBroadcastEncoder>> s_registry;
+
+QString registryKey(
+        const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate) {
+    return QStringLiteral("%1/%2/%3/%4")
+            .arg(pSettings->getFormat(),
+                    QString::number(pSettings->getQuality()),
+                    QString::number(static_cast<int>(pSettings->getChannelMode())),
+                    QString::number(sampleRate.value()));
+}
+
+} // namespace
+
+// static
+bool SharedBroadcastEncoder::isShareable(const QString& format) {
+    return format == QStringLiteral(ENCODING_MP3) ||
+            format == QStringLiteral(ENCODING_AAC) ||
+            format == QStringLiteral(ENCODING_HEAAC) ||
+            format == QStringLiteral(ENCODING_HEAACV2);
+}
+
+// static
+std::shared_ptr<SharedBroadcastEncoder> SharedBroadcastEncoder::acquire(
+        const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate,
+        QString* pUserErrorMsg) {
+    VERIFY_OR_DEBUG_ASSERT(isShareable(pSettings->getFormat())) {
+        return nullptr;
+    }
+    const QString key = registryKey(pSettings, sampleRate);
+    const auto locker = lockMutex(&s_registryMutex);
+    auto pShared = s_registry.value(key).lock();
+    if (pShared) {
+        kLogger.debug() << "Sharing encoder" << key;
+        return pShared;
+    }
+    // The constructor is private, so std::make_shared can't be used
+    pShared = std::shared_ptr<SharedBroadcastEncoder>(new SharedBroadcastEncoder());
+    pShared->m_pEncoder = EncoderFactory::getFactory().createEncoder(
+            pSettings, pShared.get());
+    if (!pShared->m_pEncoder ||
+            pShared->m_pEncoder->initEncoder(sampleRate, pUserErrorMsg) < 0) {
+        return nullptr;
+    }
+    // Drop the entries of encoders that are no longer used
+    for (auto it = s_registry.begin(); it != s_registry.end();) {
+        if (it.value().expired()) {
+            it = s_registry.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    s_registry.insert(key, pShared);
+    kLogger.debug() << "Created encoder" << key;
+    return pShared;
+}
+
+SharedBroadcastEncoder::~SharedBroadcastEncoder() {
+    // Deleting the encoder flushes it by calling write(), which needs the
+    // other members
+    m_pEncoder.reset();
+}
+
+void SharedBroadcastEncoder::subscribe(const EncoderCallback* pSubscriber) {
+    const auto locker = lockMutex(&m_subscribersMutex);
+    DEBUG_ASSERT(std::none_of(m_subscribers.cbegin(),
+            m_subscribers.cend(),
+            [pSubscriber](const Subscriber& subscriber) {
+                return subscriber.pCallback == pSubscriber;
+            }));
+    m_subscribers.push_back(Subscriber{pSubscriber, QByteArray()});
+}
+
+void SharedBroadcastEncoder::unsubscribe(const EncoderCallback* pSubscriber) {
+    const auto locker = lockMutex(&m_subscribersMutex);
+    m_subscribers.erase(std::remove_if(m_subscribers.begin(),
+                                m_subscribers.end(),
+                                [pSubscriber](const Subscriber& subscriber) {
+                                    return subscriber.pCallback == pSubscriber;
+                                }),
+            m_subscribers.end());
+}
+
+void SharedBroadcastEncoder::encodeBuffer(const EncoderCallback* pSubscriber,
+        const CSAMPLE* pBuffer,
+        int iBufferSize) {
+    {
+        const auto locker = lockMutex(&m_subscribersMutex);
+        if (m_subscribers.empty() || m_subscribers.front().pCallback != pSubscriber) {
+            return;
+        }
+    }
+    const auto locker = lockMutex(&m_encoderMutex);
+    // the encoded frames are received by the write() callback.
+    m_pEncoder->encodeBuffer(pBuffer, iBufferSize);
+}
+
+QByteArray SharedBroadcastEncoder::takeEncodedData(const EncoderCallback* pSubscriber) {
+    const auto locker = lockMutex(&m_subscribersMutex);
+    for (auto& subscriber : m_subscribers) {
+        if (subscriber.pCallback == pSubscriber) {
+            return std::exchange(subscriber.encodedData, QByteArray());
+        }
+    }
+    return QByteArray();
+}
+
+void SharedBroadcastEncoder::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    const auto locker = lockMutex(&m_subscribersMutex);
+    for (auto& subscriber : m_subscribers) {
+        if (subscriber.encodedData.size() + headerLen + bodyLen > kMaxEncodedDataSize) {
+            kLogger.warning() << "Dropping encoded data for a subscriber that"
+                              << "does not keep up with the stream";
+            subscriber.encodedData.clear();
+        }
+        if (headerLen > 0) {
+            subscriber.encodedData.append(
+                    reinterpret_cast<const char*>(header), headerLen);
+        }
+        subscriber.encodedData.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "encoder/encodersettings.h"
+#include "util/types.h"
+
+/// An encoder that is shared by all broadcast connections with identical
+/// encoder settings, so the main mix is only encoded once per format and
+/// bitrate, no matter how many servers it is streamed to.
+///
+/// Only one subscriber, the first one in the list, feeds the encoder. The
+/// encoded data is appended to the queue of every subscriber and each
+/// subscriber sends its queue from its own thread, so a slow server does not
+/// stall the others.
+///
+/// Sharing is limited to formats without stream headers (MP3 and AAC). An Ogg
+/// stream can't be joined in the middle and is restarted on metadata updates.
+class SharedBroadcastEncoder : public EncoderCallback {
+  public:
+    /// Returns the encoder for the given settings. A new encoder is created
+    /// if no connection uses these settings yet. Returns nullptr and sets
+    /// pUserErrorMsg if the encoder can't be initialized.
+    static std::shared_ptr<SharedBroadcastEncoder> acquire(
+            const EncoderSettingsPointer& pSettings,
+            mixxx::audio::SampleRate sampleRate,
+            QString* pUserErrorMsg);
+
+    /// Whether the format can be shared between connections.
+    static bool isShareable(const QString& format);
+
+    ~SharedBroadcastEncoder() override;
+
+    /// Registers a subscriber that receives the encoded data from now on.
+    void subscribe(const EncoderCallback* pSubscriber);
+    void unsubscribe(const EncoderCallback* pSubscriber);
+
+    /// Encodes the buffer if pSubscriber is the one that feeds the encoder.
+    /// The other subscribers receive the same samples from their FIFO and
+    /// only need to send the data that has been encoded for them.
+    void encodeBuffer(const EncoderCallback* pSubscriber,
+            const CSAMPLE* pBuffer,
+            int iBufferSize);
+
+    /// Returns and clears the data that has been encoded for pSubscriber.
+    QByteArray takeEncodedData(const EncoderCallback* pSubscriber);
+
+    // EncoderCallback
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override {
+        return -1;
+    }
+    void seek(int pos) override {
+        Q_UNUSED(pos);
+    }
+    int filelen() override {
+        return 0;
+    }
+
+  private:
+    SharedBroadcastEncoder() = default;
+
+    struct Subscriber {
+        const EncoderCallback* pCallback;
+        QByteArray encodedData;
+    };
+
+    // Serializes the encoder, which is fed from the thread of the first
+    // subscriber. A new first subscriber may take over at any time.
+    QMutex m_encoderMutex;
+    EncoderPointer m_pEncoder;
+
+    // Guards m_subscribers and is taken from within write()
+    QMutex m_subscribersMutex;
+    std::vector<Subscriber> m_subscribers;
+};
@@ -3,6 +3,7 @@
 #include <QRegularExpression>
 #include <QTextCodec>
 #include <QUrl>
+#include <algorithm>
 
 // These includes are only required by ignoreSigpipe, which is unix-only
 #ifndef __WINDOWS__
@@ -26,11 +27,20 @@
 #include "track/track.h"
 #include "util/compatibility/qatomic.h"
 #include "util/logger.h"
+#include "util/stat.h"
+#include "util/threadplacement.h"
 
 namespace {
 
 constexpr int kConnectRetries = 30;
-constexpr int kMaxNetworkCache = 491520; // 10 s mp3 @ 192 kbit/s
+// The data queued by libshout while the server does not keep up. The limit
+// depends on the bitrate, so all streams survive the same network hiccup.
+constexpr int kMaxNetworkCacheSeconds = 10;
+// Used if the bitrate is unknown, e.g. for VBR
+constexpr int kMinNetworkCacheBitrate = 192;
+// How long the thread waits for new samples before retrying to send the
+// queued data
+constexpr int kQueueFlushIntervalMillis = 10;
 // Shoutcast default receive buffer 1048576 and autodumpsourcetime 30 s
 // http://wiki.shoutcast.com/wiki/SHOUTcast_DNAS_Server_2
 constexpr int kMaxShoutFailures = 3;
@@ -54,6 +64,8 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_pConfig(pConfig),
           m_pProfile(profile),
           m_encoder(nullptr),
+          m_maxNetworkCacheBytes(0),
+          m_iBitrate(0),
           m_mainSamplerate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_broadcastEnabled(BROADCAST_PREF_KEY, "enabled"),
           m_custom_metadata(false),
@@ -187,6 +199,7 @@ void ShoutConnection::updateFromPreferences() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    m_pSharedEncoder.reset();
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -391,6 +404,10 @@ void ShoutConnection::updateFromPreferences() {
     if (iBitrate < 0) {
         qWarning() << "Error: unknown bit rate:" << iBitrate;
     }
+    m_iBitrate = std::max(iBitrate, kMinNetworkCacheBitrate);
+    m_maxNetworkCacheBytes = m_iBitrate * 1000 / 8 * kMaxNetworkCacheSeconds;
+    m_sendQueueStatTag = QStringLiteral("ShoutConnection '%1' send queue")
+                                 .arg(m_pProfile->getProfileName());
 
     auto mainSamplerate = mixxx::audio::SampleRate::fromDouble(m_mainSamplerate.get());
     VERIFY_OR_DEBUG_ASSERT(mainSamplerate.isValid()) {
@@ -453,13 +470,21 @@ void ShoutConnection::updateFromPreferences() {
     // Initialize m_encoder
     EncoderSettingsPointer pBroadcastSettings =
             std::make_shared<EncoderBroadcastSettings>(m_pProfile);
-    m_encoder = EncoderFactory::getFactory().createEncoder(
-                    pBroadcastSettings, this);
-
     QString userErrorMsg;
     int ret = -1;
-    if (m_encoder) {
-        ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+    if (SharedBroadcastEncoder::isShareable(pBroadcastSettings->getFormat())) {
+        // Connections with the same settings share the encoder
+        m_pSharedEncoder = SharedBroadcastEncoder::acquire(
+                pBroadcastSettings, mainSamplerate, &userErrorMsg);
+        if (m_pSharedEncoder) {
+            ret = 0;
+        }
+    } else {
+        m_encoder = EncoderFactory::getFactory().createEncoder(
+                pBroadcastSettings, this);
+        if (m_encoder) {
+            ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+        }
     }
 
     // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
@@ -597,6 +622,10 @@ bool ShoutConnection::processConnect() {
             }
             m_threadWaiting = true;
 
+            if (m_pSharedEncoder) {
+                m_pSharedEncoder->subscribe(this);
+            }
+
             setStatus(BroadcastProfile::STATUS_CONNECTED);
             emit broadcastConnected();
 
@@ -626,6 +655,7 @@ bool ShoutConnection::processConnect() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    m_pSharedEncoder.reset();
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -651,6 +681,10 @@ bool ShoutConnection::processDisconnect() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    if (m_pSharedEncoder) {
+        m_pSharedEncoder->unsubscribe(this);
+        m_pSharedEncoder.reset();
+    }
     return disconnected;
 }
 
@@ -675,14 +709,29 @@ void ShoutConnection::write(const unsigned char* header, const unsigned char* bo
     }
 
     ssize_t queuelen = shout_queuelen(m_pShout);
+    // The backpressure of the server, as the duration of the audio that
+    // waits to be sent
+    Stat::track(m_sendQueueStatTag,
+            Stat::DURATION_MSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MAX),
+            std::max<ssize_t>(queuelen, 0) * 8.0 / m_iBitrate);
     if (queuelen > 0) {
         kLogger.debug() << "shout_queuelen" << queuelen;
-        if (queuelen > kMaxNetworkCache) {
+        if (queuelen > m_maxNetworkCacheBytes) {
             m_lastErrorStr = tr("Network cache overflow");
             tryReconnect();
         }
     }
 }
+
+void ShoutConnection::flushQueuedData() {
+    if (!m_pShout || m_iShoutStatus != SHOUTERR_CONNECTED ||
+            shout_queuelen(m_pShout) <= 0) {
+        return;
+    }
+    // Sends as much as the socket accepts without blocking
+    (void)shout_send_raw(m_pShout, nullptr, 0);
+}
 // These are not used for streaming, but the interface requires them
 int ShoutConnection::tell() {
     if (!m_pShout) {
@@ -704,12 +753,11 @@ bool ShoutConnection::writeSingle(const unsigned char* data, size_t len) {
     setFunctionCode(8);
     int ret = shout_send_raw(m_pShout, data, len);
     if (ret == SHOUTERR_BUSY) {
-        // in case of busy, frames are queued
-        // try to flush queue after a short sleep
-        kLogger.warning() << "writeSingle() SHOUTERR_BUSY, trying again";
-        usleep(10000); // wait 10 ms until "busy" is over. TODO() tweak for an optimum.
-        // if this fails, the queue is transmitted after the next regular shout_send_raw()
-        (void)shout_send_raw(m_pShout, nullptr, 0);
+        // In non-blocking mode the frames are queued by libshout. The queue
+        // is sent with the next write or by flushQueuedData() when the
+        // thread is idle, instead of stalling this thread until the server
+        // catches up.
+        kLogger.debug() << "writeSingle() SHOUTERR_BUSY, data queued";
     } else if (ret < SHOUTERR_SUCCESS) {
         m_lastErrorStr = shout_get_error(m_pShout);
         kLogger.warning()
@@ -742,12 +790,27 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const int iBufferSize) {
     // to prevent race conditions when resetting the member
     // pointer while disconnecting in the worker thread!
     const EncoderPointer pEncoder = m_encoder;
+    const auto pSharedEncoder = m_pSharedEncoder;
 
     // If we are connected, encode the samples.
     if (iBufferSize > 0 && pEncoder) {
         setFunctionCode(6);
         pEncoder->encodeBuffer(pBuffer, iBufferSize);
         // the encoded frames are received by the write() callback.
+    } else if (pSharedEncoder) {
+        setFunctionCode(6);
+        if (iBufferSize > 0) {
+            pSharedEncoder->encodeBuffer(this, pBuffer, iBufferSize);
+        }
+        // Send what has been encoded for this connection, either just now
+        // or by the connection that feeds the shared encoder.
+        const QByteArray encodedData = pSharedEncoder->takeEncodedData(this);
+        if (!encodedData.isEmpty()) {
+            write(nullptr,
+                    reinterpret_cast<const unsigned char*>(encodedData.constData()),
+                    0,
+                    encodedData.size());
+        }
     }
 
     // Check if track metadata has changed and if so, update.
@@ -995,6 +1058,7 @@ bool ShoutConnection::threadWaiting() {
 void ShoutConnection::run() {
     QThread::currentThread()->setObjectName(
             QString("ShoutOutput '%1'").arg(m_pProfile->getProfileName()));
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::SideChain);
     kLogger.debug() << "run: Starting thread";
 
 #ifndef __WINDOWS__
@@ -1033,7 +1097,11 @@ void ShoutConnection::run() {
 
         setFunctionCode(1);
         incRunCount();
-        if(!m_readSema.tryAcquire(1, 1000)) {
+        // Wake up early to send the queued data while the server is slow
+        const bool hasQueuedData = m_pShout && m_iShoutStatus == SHOUTERR_CONNECTED &&
+                shout_queuelen(m_pShout) > 0;
+        if (!m_readSema.tryAcquire(1, hasQueuedData ? kQueueFlushIntervalMillis : 1000)) {
+            flushQueuedData();
             continue;
         }
 
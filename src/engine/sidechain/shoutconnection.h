@@ -12,6 +12,7 @@
 #include "control/pollingcontrolproxy.h"
 #include "encoder/encoder.h"
 #include "encoder/encodercallback.h"
+#include "engine/sidechain/sharedbroadcastencoder.h"
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -102,6 +103,8 @@ class ShoutConnection
 #endif
 
     bool writeSingle(const unsigned char *data, size_t len);
+    // Tries to send the data that libshout has queued, without blocking
+    void flushQueuedData();
 
     QByteArray encodeString(const QString& string);
 
@@ -120,6 +123,14 @@ class ShoutConnection
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
     EncoderPointer m_encoder;
+    // Used instead of m_encoder if the format can be shared with other
+    // connections
+    std::shared_ptr<SharedBroadcastEncoder> m_pSharedEncoder;
+    // Limit of the libshout send queue, derived from the bitrate
+    int m_maxNetworkCacheBytes;
+    // kbit/s
+    int m_iBitrate;
+    QString m_sendQueueStatTag;
     PollingControlProxy m_mainSamplerate;
     PollingControlProxy m_broadcastEnabled;
     // static metadata according to prefereneces
@@ -0,0 +1,60 @@
+#include "engine/sidechain/sidechainworkerthread.h"
+
+#include "engine/sidechain/sidechainworker.h"
+#include "util/sample.h"
+#include "util/threadplacement.h"
+#include "util/trace.h"
+
+SideChainWorkerThread::SideChainWorkerThread(
+        SideChainWorker* pWorker, int fifoSize)
+        : m_pWorker(pWorker),
+          m_sampleFifo(fifoSize),
+          m_pWorkBuffer(SampleUtil::alloc(fifoSize)),
+          m_workBufferSize(fifoSize),
+          m_bStopThread(false) {
+    // Same priority as EngineSideChain, see there
+    start(QThread::HighPriority);
+}
+
+SideChainWorkerThread::~SideChainWorkerThread() {
+    stop();
+    SampleUtil::free(m_pWorkBuffer);
+}
+
+bool SideChainWorkerThread::writeSamples(const CSAMPLE* pBuffer, int iSamples) {
+    const int samplesWritten = m_sampleFifo.write(pBuffer, iSamples);
+    m_samplesAvailable.release();
+    return samplesWritten == iSamples;
+}
+
+void SideChainWorkerThread::stop() {
+    m_bStopThread.store(true);
+    m_samplesAvailable.release();
+    wait();
+}
+
+void SideChainWorkerThread::run() {
+    unsigned static id = 0;
+    QThread::currentThread()->setObjectName(
+            QString("SideChainWorker %1").arg(++id));
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::SideChain);
+    while (true) {
+        m_samplesAvailable.acquire();
+        // Consume the releases of all writes that arrived meanwhile, the
+        // loop below drains the FIFO anyway
+        const int pendingReleases = m_samplesAvailable.available();
+        if (pendingReleases > 0) {
+            m_samplesAvailable.tryAcquire(pendingReleases);
+        }
+
+        int samplesRead;
+        while ((samplesRead = m_sampleFifo.read(m_pWorkBuffer, m_workBufferSize))) {
+            Trace process("SideChainWorkerThread::process");
+            m_pWorker->process(m_pWorkBuffer, samplesRead);
+        }
+
+        if (m_bStopThread.load()) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+
+#include "util/fifo.h"
+#include "util/types.h"
+
+class SideChainWorker;
+
+/// Runs a single SideChainWorker in its own thread, fed by its own FIFO.
+///
+/// EngineSideChain copies every buffer of the side chain mix into the FIFO
+/// of each worker, so a worker that falls behind, e.g. a slow encoder on a
+/// weak CPU, only overflows its own FIFO and never delays the others.
+class SideChainWorkerThread : public QThread {
+  public:
+    SideChainWorkerThread(SideChainWorker* pWorker, int fifoSize);
+    ~SideChainWorkerThread() override;
+
+    SideChainWorker* worker() const {
+        return m_pWorker;
+    }
+
+    /// Not thread-safe, wait-free. Must only be called from the thread that
+    /// distributes the side chain mix. Returns false if the FIFO overflowed.
+    bool writeSamples(const CSAMPLE* pBuffer, int iSamples);
+
+    /// Thread-safe, blocking. Processes the samples in the FIFO and stops
+    /// the thread.
+    void stop();
+
+  private:
+    void run() override;
+
+    SideChainWorker* const m_pWorker;
+    FIFO<CSAMPLE> m_sampleFifo;
+    CSAMPLE* m_pWorkBuffer;
+    const int m_workBufferSize;
+
+    QSemaphore m_samplesAvailable;
+    std::atomic<bool> m_bStopThread;
+};
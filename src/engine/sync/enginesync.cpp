@@ -669,7 +669,12 @@ void EngineSync::updateLeaderBeatDistance(Syncable* pSource, double beatDistance
                         << beatDistance;
     }
     if (pSource != m_pInternalClock) {
+        // The internal clock notifies us about its new beat distance,
+        // which then reaches all other syncables exactly once. Forwarding
+        // it to them here as well would update each follower (and the
+        // internal clock) repeatedly with the same value in every callback.
         m_pInternalClock->updateLeaderBeatDistance(beatDistance);
+        return;
     }
     foreach (Syncable* pSyncable, m_syncables) {
         if (pSyncable == pSource ||
@@ -1,12 +1,14 @@
 #include "library/analysis/analysisfeature.h"
 
 #include <QList>
+#include <QTimer>
 #include <QtDebug>
 
 #include "analyzer/analyzerscheduledtrack.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "library/analysis/dlganalysis.h"
 #include "library/library.h"
+#include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "moc_analysisfeature.cpp"
 #include "sources/soundsourceproxy.h"
@@ -39,6 +41,9 @@ AnalyzerModeFlags getAnalyzerModeFlags(
     if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
         modeFlags |= AnalyzerModeFlags::WithWaveform;
     }
+    if (pConfig->getValue<bool>(ConfigKey("[Library]", "AnalyzeWithIdlePriority"), false)) {
+        modeFlags |= AnalyzerModeFlags::IdlePriority;
+    }
     return static_cast<AnalyzerModeFlags>(modeFlags);
 }
 
@@ -50,11 +55,17 @@ AnalysisFeature::AnalysisFeature(
         : LibraryFeature(pLibrary, pConfig, QStringLiteral("prepare")),
           m_baseTitle(tr("Analyze")),
           m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_pThrottle(make_parented<AnalysisThrottle>(this)),
           m_pSidebarModel(make_parented<TreeItemModel>(this)),
           m_pAnalysisView(nullptr),
+          m_persistedQueueRestored(false),
           m_title(m_baseTitle) {
 }
 
+AnalysisDao& AnalysisFeature::analysisDao() const {
+    return m_pLibrary->trackCollectionManager()->internalCollection()->getAnalysisDAO();
+}
+
 void AnalysisFeature::resetTitle() {
     m_title = m_baseTitle;
     emit featureIsLoading(this, false);
@@ -90,7 +101,7 @@ void AnalysisFeature::bindLibraryWidget(WLibrary* libraryWidget,
     connect(m_pAnalysisView,
             &DlgAnalysis::stopAnalysis,
             this,
-            &AnalysisFeature::stopAnalysis);
+            &AnalysisFeature::cancelAnalysis);
 
     connect(m_pAnalysisView,
             &DlgAnalysis::trackSelected,
@@ -107,6 +118,12 @@ void AnalysisFeature::bindLibraryWidget(WLibrary* libraryWidget,
     // Let the DlgAnalysis know whether or not analysis is active.
     emit analysisActive(static_cast<bool>(m_pTrackAnalysisScheduler));
 
+    // The view must exist before the analysis is started
+    if (!m_persistedQueueRestored) {
+        m_persistedQueueRestored = true;
+        QTimer::singleShot(0, this, &AnalysisFeature::restorePersistedQueue);
+    }
+
     libraryWidget->registerView(kViewName, m_pAnalysisView);
 }
 
@@ -156,15 +173,45 @@ void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks)
                 &TrackAnalysisScheduler::finished,
                 this,
                 &AnalysisFeature::onTrackAnalysisSchedulerFinished);
+        connect(m_pTrackAnalysisScheduler.get(),
+                &TrackAnalysisScheduler::trackProgress,
+                this,
+                &AnalysisFeature::onTrackAnalysisSchedulerTrackProgress);
+
+        // Yield to the audio engine while performing live
+        if (m_pConfig->getValue<bool>(ConfigKey("[Library]", "ThrottleAnalysis"), true)) {
+            connect(m_pThrottle.get(),
+                    &AnalysisThrottle::throttleChanged,
+                    m_pTrackAnalysisScheduler.get(),
+                    &TrackAnalysisScheduler::setThrottle);
+            m_pThrottle->start();
+        }
 
         emit analysisActive(true);
     }
 
+    analysisDao().enqueueTracksForAnalysis(tracks);
     if (m_pTrackAnalysisScheduler->scheduleTracks(tracks) > 0) {
         resumeAnalysis();
     }
 }
 
+void AnalysisFeature::restorePersistedQueue() {
+    if (!m_pConfig->getValue(ConfigKey("[Library]", "ResumeAnalysisOnStartup"), true)) {
+        analysisDao().clearAnalysisQueue();
+        return;
+    }
+    const QList<AnalyzerScheduledTrack> tracks = analysisDao().getQueuedTracksForAnalysis();
+    if (tracks.isEmpty()) {
+        return;
+    }
+    kLogger.info()
+            << "Resuming interrupted analysis of"
+            << tracks.size()
+            << "tracks";
+    analyzeTracks(tracks);
+}
+
 void AnalysisFeature::suspendAnalysis() {
     if (!m_pTrackAnalysisScheduler) {
         return; // inactive
@@ -189,6 +236,23 @@ void AnalysisFeature::stopAnalysis() {
     m_pTrackAnalysisScheduler->stop();
 }
 
+void AnalysisFeature::cancelAnalysis() {
+    // Unlike stopping the analysis on shutdown, the remaining
+    // tracks are not analyzed after the next restart.
+    analysisDao().clearAnalysisQueue();
+    stopAnalysis();
+}
+
+void AnalysisFeature::onTrackAnalysisSchedulerTrackProgress(
+        TrackId trackId,
+        AnalyzerProgress analyzerProgress) {
+    // Failed tracks are not retried after a restart either
+    if (analyzerProgress == kAnalyzerProgressDone ||
+            analyzerProgress == kAnalyzerProgressUnknown) {
+        analysisDao().dequeueTrackFromAnalysis(trackId);
+    }
+}
+
 void AnalysisFeature::onTrackAnalysisSchedulerProgress(
         AnalyzerProgress /*currentTrackProgress*/,
         int currentTrackNumber,
@@ -218,6 +282,7 @@ void AnalysisFeature::onTrackAnalysisSchedulerFinished() {
         // for creating the queue with its worker threads are acceptable.
         m_pTrackAnalysisScheduler.reset();
     }
+    m_pThrottle->stop();
     resetTitle();
     emit analysisActive(false);
 }
@@ -5,12 +5,14 @@
 #include <QUrl>
 #include <QVariant>
 
+#include "analyzer/analysisthrottle.h"
 #include "analyzer/trackanalysisscheduler.h"
 #include "library/libraryfeature.h"
 #include "library/treeitemmodel.h"
 #include "preferences/usersettings.h"
 #include "util/parented_ptr.h"
 
+class AnalysisDao;
 class DlgAnalysis;
 
 class AnalysisFeature : public LibraryFeature {
@@ -41,9 +43,14 @@ class AnalysisFeature : public LibraryFeature {
 
     void suspendAnalysis();
     void resumeAnalysis();
+    // Stops the analysis, which is resumed after a restart
     void stopAnalysis();
+    // Stops the analysis and discards all remaining tracks
+    void cancelAnalysis();
 
   private slots:
+    void restorePersistedQueue();
+    void onTrackAnalysisSchedulerTrackProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
     void onTrackAnalysisSchedulerProgress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
     void onTrackAnalysisSchedulerFinished();
 
@@ -57,13 +64,18 @@ class AnalysisFeature : public LibraryFeature {
     // tracks in the job
     void setTitleProgress(int currentTrackNumber, int totalTracksCount);
 
+    AnalysisDao& analysisDao() const;
+
     const QString m_baseTitle;
 
     TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+    parented_ptr<AnalysisThrottle> m_pThrottle;
 
     parented_ptr<TreeItemModel> m_pSidebarModel;
     DlgAnalysis* m_pAnalysisView;
 
+    bool m_persistedQueueRestored;
+
     // The title is dynamic and reflects the current progress
     QString m_title;
 };
@@ -0,0 +1,175 @@
+#include "library/autodj/autodjcratesindex.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "util/assert.h"
+
+namespace {
+
+// Like SQLite, sorts tracks that have never been played first
+int compareLastPlayed(const QString& lhs, const QString& rhs) {
+    if (lhs.isNull() || rhs.isNull()) {
+        return static_cast<int>(!lhs.isNull()) - static_cast<int>(!rhs.isNull());
+    }
+    return lhs.compare(rhs);
+}
+
+} // anonymous namespace
+
+AutoDJCratesIndex::AutoDJCratesIndex(bool orderByLastPlayed)
+        : m_orderByLastPlayed(orderByLastPlayed),
+          m_unplayedActiveCount(0) {
+}
+
+bool AutoDJCratesIndex::lessThan(const Entry& lhs, const Entry& rhs) const {
+    if (!m_orderByLastPlayed && lhs.timesPlayed != rhs.timesPlayed) {
+        return lhs.timesPlayed < rhs.timesPlayed;
+    }
+    const int lastPlayedOrder = compareLastPlayed(lhs.lastPlayed, rhs.lastPlayed);
+    if (lastPlayedOrder != 0) {
+        return lastPlayedOrder < 0;
+    }
+    // Makes the order of the tracks deterministic
+    return lhs.trackId < rhs.trackId;
+}
+
+void AutoDJCratesIndex::reset(const std::vector<Entry>& entries) {
+    clear();
+    m_entries.reserve(static_cast<int>(entries.size()));
+    for (const auto& entry : entries) {
+        VERIFY_OR_DEBUG_ASSERT(entry.trackId.isValid()) {
+            continue;
+        }
+        m_entries.insert(entry.trackId, entry);
+    }
+    for (const auto& entry : std::as_const(m_entries)) {
+        if (entry.autoDjRefs <= 0) {
+            m_activeTracks.push_back(entry);
+            if (entry.timesPlayed == 0) {
+                ++m_unplayedActiveCount;
+            }
+        }
+    }
+    std::sort(m_activeTracks.begin(),
+            m_activeTracks.end(),
+            [this](const Entry& lhs, const Entry& rhs) {
+                return lessThan(lhs, rhs);
+            });
+}
+
+void AutoDJCratesIndex::clear() {
+    m_entries.clear();
+    m_activeTracks.clear();
+    m_unplayedActiveCount = 0;
+}
+
+void AutoDJCratesIndex::setOrderByLastPlayed(bool orderByLastPlayed) {
+    if (m_orderByLastPlayed == orderByLastPlayed) {
+        return;
+    }
+    m_orderByLastPlayed = orderByLastPlayed;
+    std::sort(m_activeTracks.begin(),
+            m_activeTracks.end(),
+            [this](const Entry& lhs, const Entry& rhs) {
+                return lessThan(lhs, rhs);
+            });
+}
+
+void AutoDJCratesIndex::insert(const Entry& entry) {
+    VERIFY_OR_DEBUG_ASSERT(entry.trackId.isValid()) {
+        return;
+    }
+    remove(entry.trackId);
+    m_entries.insert(entry.trackId, entry);
+    if (entry.autoDjRefs <= 0) {
+        insertActive(entry);
+    }
+}
+
+void AutoDJCratesIndex::remove(TrackId trackId) {
+    const auto it = m_entries.find(trackId);
+    if (it == m_entries.end()) {
+        return;
+    }
+    if (it->autoDjRefs <= 0) {
+        removeActive(it.value());
+    }
+    m_entries.erase(it);
+}
+
+void AutoDJCratesIndex::addAutoDjRefs(TrackId trackId, int delta) {
+    const auto it = m_entries.constFind(trackId);
+    if (it == m_entries.constEnd()) {
+        return;
+    }
+    Entry entry = it.value();
+    entry.autoDjRefs += delta;
+    insert(entry);
+}
+
+void AutoDJCratesIndex::setTimesPlayed(TrackId trackId, int timesPlayed) {
+    const auto it = m_entries.constFind(trackId);
+    if (it == m_entries.constEnd()) {
+        return;
+    }
+    Entry entry = it.value();
+    entry.timesPlayed = timesPlayed;
+    insert(entry);
+}
+
+std::vector<AutoDJCratesIndex::Entry>::iterator AutoDJCratesIndex::findActive(
+        const Entry& entry) {
+    return std::lower_bound(m_activeTracks.begin(),
+            m_activeTracks.end(),
+            entry,
+            [this](const Entry& lhs, const Entry& rhs) {
+                return lessThan(lhs, rhs);
+            });
+}
+
+void AutoDJCratesIndex::insertActive(const Entry& entry) {
+    m_activeTracks.insert(findActive(entry), entry);
+    if (entry.timesPlayed == 0) {
+        ++m_unplayedActiveCount;
+    }
+}
+
+void AutoDJCratesIndex::removeActive(const Entry& entry) {
+    const auto it = findActive(entry);
+    VERIFY_OR_DEBUG_ASSERT(it != m_activeTracks.end() && it->trackId == entry.trackId) {
+        return;
+    }
+    m_activeTracks.erase(it);
+    if (entry.timesPlayed == 0) {
+        --m_unplayedActiveCount;
+    }
+}
+
+int AutoDJCratesIndex::activeCountPlayedBefore(const QString& timestamp) const {
+    const auto isPlayedBefore = [&timestamp](const Entry& entry) {
+        return !entry.lastPlayed.isNull() && entry.lastPlayed < timestamp;
+    };
+    if (!m_orderByLastPlayed) {
+        return static_cast<int>(std::count_if(
+                m_activeTracks.begin(), m_activeTracks.end(), isPlayedBefore));
+    }
+    // The tracks that have never been played are followed by the tracks
+    // that have been played before the timestamp
+    const auto firstPlayed = std::partition_point(
+            m_activeTracks.begin(),
+            m_activeTracks.end(),
+            [](const Entry& entry) {
+                return entry.lastPlayed.isNull();
+            });
+    const auto endPlayedBefore = std::partition_point(
+            firstPlayed, m_activeTracks.end(), isPlayedBefore);
+    return static_cast<int>(std::distance(firstPlayed, endPlayedBefore));
+}
+
+TrackId AutoDJCratesIndex::activeTrackAt(int index) const {
+    VERIFY_OR_DEBUG_ASSERT(index >= 0 && index < activeCount()) {
+        return TrackId();
+    }
+    return m_activeTracks[index].trackId;
+}
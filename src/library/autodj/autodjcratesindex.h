@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <vector>
+
+#include "track/trackid.h"
+
+/// An in-memory index of the tracks in the Auto DJ crates, from which
+/// AutoDJCratesDAO selects random tracks.
+///
+/// The active tracks are the tracks that are neither queued in the Auto DJ
+/// playlist nor loaded into a deck. They are kept sorted by the number of
+/// times they have been played and by the date/time they have been played
+/// last, or only by the latter. Tracks that have never been played come
+/// first. Counting and selecting active tracks does not need to query the
+/// database. The index is updated track by track as the tracks are played,
+/// queued or added to and removed from the crates.
+class AutoDJCratesIndex {
+  public:
+    struct Entry {
+        TrackId trackId;
+        int timesPlayed = 0;
+        /// The timestamp as generated by SQLite, which sorts like the
+        /// date/time. A null string if the track has never been played.
+        QString lastPlayed;
+        /// The references of the Auto DJ playlist and of the decks
+        int autoDjRefs = 0;
+    };
+
+    explicit AutoDJCratesIndex(bool orderByLastPlayed = false);
+
+    void reset(const std::vector<Entry>& entries);
+    void clear();
+
+    bool orderByLastPlayed() const {
+        return m_orderByLastPlayed;
+    }
+    void setOrderByLastPlayed(bool orderByLastPlayed);
+
+    /// Inserts the track or replaces its previous entry.
+    void insert(const Entry& entry);
+    void remove(TrackId trackId);
+    /// Ignored for tracks that are not contained.
+    void addAutoDjRefs(TrackId trackId, int delta);
+    void setTimesPlayed(TrackId trackId, int timesPlayed);
+
+    /// The number of all tracks in the Auto DJ crates
+    int size() const {
+        return static_cast<int>(m_entries.size());
+    }
+    bool contains(TrackId trackId) const {
+        return m_entries.contains(trackId);
+    }
+
+    int activeCount() const {
+        return static_cast<int>(m_activeTracks.size());
+    }
+    int unplayedActiveCount() const {
+        return m_unplayedActiveCount;
+    }
+    /// The number of active tracks that have been played, but not since
+    /// the given timestamp.
+    int activeCountPlayedBefore(const QString& timestamp) const;
+
+    /// Returns the active track at the given position of the sort order.
+    TrackId activeTrackAt(int index) const;
+
+  private:
+    bool lessThan(const Entry& lhs, const Entry& rhs) const;
+    std::vector<Entry>::iterator findActive(const Entry& entry);
+    void insertActive(const Entry& entry);
+    void removeActive(const Entry& entry);
+
+    bool m_orderByLastPlayed;
+    QHash<TrackId, Entry> m_entries;
+    // Sorted by lessThan(). The insertion and removal of a track moves the
+    // entries behind it, which is still much cheaper than sorting them.
+    std::vector<Entry> m_activeTracks;
+    int m_unplayedActiveCount;
+};
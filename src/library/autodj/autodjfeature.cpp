@@ -16,6 +16,7 @@
 #include "track/track.h"
 #include "util/clipboard.h"
 #include "util/dnd.h"
+#include "util/fileinfo.h"
 #include "widget/wlibrary.h"
 #include "widget/wlibrarysidebar.h"
 
@@ -68,6 +69,12 @@ AutoDJFeature::AutoDJFeature(Library* pLibrary,
             &LibraryFeature::loadTrackToPlayer,
             Qt::QueuedConnection);
 
+    // Missing analyses of upcoming tracks are added to the batch analysis
+    connect(m_pAutoDJProcessor,
+            &AutoDJProcessor::analyzeTracks,
+            pLibrary,
+            &Library::analyzeTracks);
+
     m_playlistDao.setAutoDJProcessor(m_pAutoDJProcessor);
 
     // Create the "Crates" tree-item under the root item.
@@ -242,9 +249,10 @@ void AutoDJFeature::slotCrateChanged(CrateId crateId) {
 
 void AutoDJFeature::slotAddRandomTrack() {
     if (m_iAutoDJPlaylistId >= 0) {
-        TrackPointer pRandomTrack;
+        TrackId foundTrackId;
         for (int failedRetrieveAttempts = 0;
-                !pRandomTrack && (failedRetrieveAttempts < 2 * kMaxRetrieveAttempts); // 2 rounds
+                !foundTrackId.isValid() &&
+                (failedRetrieveAttempts < 2 * kMaxRetrieveAttempts); // 2 rounds
                 ++failedRetrieveAttempts) {
             TrackId randomTrackId;
             if (m_crateList.isEmpty()) {
@@ -259,23 +267,27 @@ void AutoDJFeature::slotAddRandomTrack() {
             }
 
             if (randomTrackId.isValid()) {
-                pRandomTrack = m_pLibrary->trackCollectionManager()->getTrackById(randomTrackId);
-                VERIFY_OR_DEBUG_ASSERT(pRandomTrack) {
+                // Only the location is needed for checking if the file
+                // exists. Loading the whole track is not necessary.
+                const QString trackLocation =
+                        m_pTrackCollection->getTrackDAO().getTrackLocation(randomTrackId);
+                VERIFY_OR_DEBUG_ASSERT(!trackLocation.isEmpty()) {
                     qWarning() << "Track does not exist:"
                             << randomTrackId;
                     continue;
                 }
-                if (!pRandomTrack->getFileInfo().checkFileExists()) {
+                if (!mixxx::FileInfo(trackLocation).checkFileExists()) {
                     qWarning() << "Track does not exist:"
-                               << pRandomTrack->getInfo()
-                               << pRandomTrack->getLocation();
-                    pRandomTrack.reset();
+                               << randomTrackId
+                               << trackLocation;
+                    continue;
                 }
+                foundTrackId = randomTrackId;
             }
         }
-        if (pRandomTrack) {
+        if (foundTrackId.isValid()) {
             m_pTrackCollection->getPlaylistDAO().appendTrackToPlaylist(
-                    pRandomTrack->getId(), m_iAutoDJPlaylistId);
+                    foundTrackId, m_iAutoDJPlaylistId);
             m_pAutoDJView->onShow();
             return; // success
         }
@@ -1,9 +1,15 @@
 #include "library/autodj/autodjprocessor.h"
 
+#include <QFile>
+#include <QtConcurrent>
+
 #include "control/controlproxy.h"
 #include "control/controlpushbutton.h"
 #include "engine/channels/enginedeck.h"
+#include "library/dao/analysisdao.h"
 #include "library/playlisttablemodel.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
 #include "mixer/basetrackplayer.h"
 #include "mixer/playermanager.h"
 #include "moc_autodjprocessor.cpp"
@@ -20,7 +26,43 @@ constexpr double kKeepPosition = -1.0;
 // A track needs to be longer than two callbacks to not stop AutoDJ
 constexpr double kMinimumTrackDurationSec = 0.2;
 
+// The number of tracks after the next one that are prepared in advance,
+// 0 = disabled. The next track is always prepared when enabled.
+const char* kLookaheadTracksPreferenceName = "LookaheadTracks";
+constexpr int kLookaheadTracksDefault = 0;
+
+// The beginning of a track up to the end of its intro is read in advance.
+// If no intro is set we assume that Auto DJ will start it within the first
+// minute.
+constexpr double kLookaheadDefaultIntroSec = 60.0;
+constexpr qint64 kLookaheadMinimumBytes = 1024 * 1024;
+constexpr qint64 kLookaheadChunkBytes = 1024 * 1024;
+
 constexpr bool sDebug = false;
+
+/// Reads the beginning of an audio file and the waveform of a track, so
+/// they will be served from the cache of the OS when loading the track.
+void warmUpTrackFiles(
+        const QString& location,
+        qint64 bytesToRead,
+        const AnalysisDao* pAnalysisDao,
+        AnalysisDao::AnalysisInfo waveformAnalysis) {
+    QFile file(location);
+    if (file.open(QIODevice::ReadOnly)) {
+        QByteArray buffer(kLookaheadChunkBytes, '\0');
+        qint64 bytesRead = 0;
+        while (bytesRead < bytesToRead) {
+            const qint64 chunkBytes = file.read(buffer.data(), buffer.size());
+            if (chunkBytes <= 0) {
+                break;
+            }
+            bytesRead += chunkBytes;
+        }
+    }
+    if (waveformAnalysis.analysisId != -1) {
+        pAnalysisDao->loadAnalysisData(&waveformAnalysis);
+    }
+}
 } // anonymous namespace
 
 DeckAttributes::DeckAttributes(int index,
@@ -116,6 +158,7 @@ AutoDJProcessor::AutoDJProcessor(
         int iAutoDJPlaylistId)
         : QObject(pParent),
           m_pConfig(pConfig),
+          m_pTrackCollectionManager(pTrackCollectionManager),
           m_pAutoDJTableModel(nullptr),
           m_eState(ADJ_DISABLED),
           m_transitionProgress(0.0),
@@ -567,10 +610,12 @@ AutoDJProcessor::AutoDJError AutoDJProcessor::toggleAutoDJ(bool enable) {
             }
         }
         emitAutoDJStateChanged(m_eState);
+        prepareUpcomingTracks();
     } else { // Disable Auto DJ
         m_pEnabledAutoDJ->setAndConfirm(0.0);
         qDebug() << "Auto DJ disabled";
         m_eState = ADJ_DISABLED;
+        prepareUpcomingTracks();
         disconnect(m_pCOCrossfader,
                 &ControlProxy::valueChanged,
                 this,
@@ -966,9 +1011,89 @@ bool AutoDJProcessor::removeTrackFromTopOfQueue(TrackPointer pTrack) {
     }
 
     maybeFillRandomTracks();
+    prepareUpcomingTracks();
     return true;
 }
 
+void AutoDJProcessor::prepareUpcomingTracks() {
+    if (m_eState == ADJ_DISABLED) {
+        m_upcomingTracks.clear();
+        m_preparedTrackIds.clear();
+        return;
+    }
+    const int lookaheadTracks = m_pConfig->getValue(
+            ConfigKey(kConfigKey, kLookaheadTracksPreferenceName),
+            kLookaheadTracksDefault);
+    if (lookaheadTracks <= 0) {
+        m_upcomingTracks.clear();
+        m_preparedTrackIds.clear();
+        return;
+    }
+
+    AnalysisDao& analysisDao =
+            m_pTrackCollectionManager->internalCollection()->getAnalysisDAO();
+    TrackPointerList upcomingTracks;
+    QSet<TrackId> preparedTrackIds;
+    QList<AnalyzerScheduledTrack> tracksToAnalyze;
+    // The top of the queue is the next track, which might already be
+    // loaded into the idle deck.
+    const int rowCount = math_min(m_pAutoDJTableModel->rowCount(), lookaheadTracks + 1);
+    for (int row = 0; row < rowCount; ++row) {
+        TrackPointer pTrack = m_pAutoDJTableModel->getTrack(
+                m_pAutoDJTableModel->index(row, 0));
+        if (!pTrack) {
+            continue;
+        }
+        // Keeping a reference avoids that the track needs to be loaded
+        // again from the database when loading it into a deck.
+        upcomingTracks.append(pTrack);
+        const TrackId trackId = pTrack->getId();
+        preparedTrackIds.insert(trackId);
+        if (m_preparedTrackIds.contains(trackId)) {
+            continue;
+        }
+
+        const auto waveformAnalyses = analysisDao.getAnalysisInfosForTrackByType(
+                trackId, AnalysisDao::TYPE_WAVEFORM);
+        if (waveformAnalyses.isEmpty() || !pTrack->getBeats()) {
+            tracksToAnalyze.append(AnalyzerScheduledTrack(trackId));
+        }
+
+        const mixxx::FileInfo fileInfo = pTrack->getFileInfo();
+        const double durationSec = pTrack->getDuration();
+        double introEndSec = kLookaheadDefaultIntroSec;
+        const CuePointer pIntroCue = pTrack->findCueByType(mixxx::CueType::Intro);
+        const auto sampleRate = pTrack->getSampleRate();
+        if (pIntroCue && pIntroCue->getEndPosition().isValid() && sampleRate.isValid()) {
+            introEndSec = pIntroCue->getEndPosition().value() /
+                    static_cast<double>(sampleRate);
+        }
+        qint64 bytesToRead = fileInfo.sizeInBytes();
+        if (durationSec > introEndSec) {
+            bytesToRead = math_max(kLookaheadMinimumBytes,
+                    static_cast<qint64>(bytesToRead * introEndSec / durationSec));
+        }
+        if constexpr (sDebug) {
+            qDebug() << this << "prepareUpcomingTracks" << fileInfo << bytesToRead;
+        }
+        QtConcurrent::run(warmUpTrackFiles,
+                fileInfo.location(),
+                bytesToRead,
+                &std::as_const(analysisDao),
+                waveformAnalyses.isEmpty()
+                        ? AnalysisDao::AnalysisInfo()
+                        : waveformAnalyses.first());
+    }
+    m_upcomingTracks = upcomingTracks;
+    m_preparedTrackIds = preparedTrackIds;
+
+    if (!tracksToAnalyze.isEmpty()) {
+        qDebug() << "Auto DJ requests the analysis of"
+                 << tracksToAnalyze.size() << "upcoming tracks";
+        emit analyzeTracks(tracksToAnalyze);
+    }
+}
+
 void AutoDJProcessor::maybeFillRandomTracks() {
     int minAutoDJCrateTracks = m_pConfig->getValueString(
             ConfigKey(kConfigKey, "RandomQueueMinimumAllowed")).toInt();
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <QObject>
+#include <QSet>
 #include <QString>
 
+#include "analyzer/analyzerscheduledtrack.h"
 #include "audio/frame.h"
 #include "control/controlproxy.h"
 #include "engine/channels/enginechannel.h"
@@ -206,6 +208,7 @@ class AutoDJProcessor : public QObject {
     void autoDJError(AutoDJProcessor::AutoDJError error);
     void transitionTimeChanged(int time);
     void randomTrackRequested(int tracksToAdd);
+    void analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
   private slots:
     void crossfaderChanged(double value);
@@ -278,9 +281,21 @@ class AutoDJProcessor : public QObject {
     // present.
     bool removeTrackFromTopOfQueue(TrackPointer pTrack);
     void maybeFillRandomTracks();
+
+    // Prepares the tracks at the top of the queue while Auto DJ is enabled,
+    // so loading them into a deck doesn't need to wait for the database,
+    // the file system or an analysis. The tracks are kept in memory, their
+    // files and waveforms are read in the background to get them into the
+    // cache of the OS and missing analyses are requested.
+    void prepareUpcomingTracks();
+
     UserSettingsPointer m_pConfig;
+    TrackCollectionManager* m_pTrackCollectionManager;
     PlaylistTableModel* m_pAutoDJTableModel;
 
+    TrackPointerList m_upcomingTracks;
+    QSet<TrackId> m_preparedTrackIds;
+
     AutoDJState m_eState;
     double m_transitionProgress;
     double m_transitionTime; // the desired value set by the user
@@ -22,7 +22,8 @@ BaseExternalLibraryFeature::BaseExternalLibraryFeature(
         UserSettingsPointer pConfig,
         const QString& iconName)
         : LibraryFeature(pLibrary, pConfig, iconName),
-          m_pTrackCollection(pLibrary->trackCollectionManager()->internalCollection()) {
+          m_pTrackCollection(pLibrary->trackCollectionManager()->internalCollection()),
+          m_initialized(false) {
     m_pAddToAutoDJAction = make_parented<QAction>(tr("Add to Auto DJ Queue (bottom)"), this);
     connect(m_pAddToAutoDJAction,
             &QAction::triggered,
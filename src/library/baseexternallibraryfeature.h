@@ -27,6 +27,23 @@ class BaseExternalLibraryFeature : public LibraryFeature {
     void onRightClickChild(const QPoint& globalPos, const QModelIndex& index) override;
 
   protected:
+    /// Prepares the feature on first use instead of at startup, because
+    /// most users never open most of the external libraries. Must be
+    /// invoked before anything that depends on the work done in
+    /// initialize(), e.g. at the start of activate().
+    void initializeOnce() {
+        if (!m_initialized) {
+            m_initialized = true;
+            initialize();
+        }
+    }
+    bool isInitialized() const {
+        return m_initialized;
+    }
+    /// Creates the temporary tables, opens database connections etc.
+    virtual void initialize() {
+    }
+
     // Must be re-implemented by external Libraries copied to Mixxx DB
     virtual std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
             const QString& playlist);
@@ -64,4 +81,6 @@ class BaseExternalLibraryFeature : public LibraryFeature {
     parented_ptr<QAction> m_pImportAsMixxxCrateAction;
 
     QPointer<WLibrarySidebar> m_pSidebarWidget;
+
+    bool m_initialized;
 };
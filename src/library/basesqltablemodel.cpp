@@ -45,7 +45,10 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_bInitialized(false),
+          m_bAsyncSelect(false),
+          m_pSelectGeneration(std::make_shared<std::atomic<int>>(0)),
+          m_bStreamingRows(false) {
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
@@ -211,6 +214,17 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select()";
     }
 
+    // Reordering needs the updated rows right after select()
+    if (m_bAsyncSelect &&
+            !hasCapabilities(Capability::Reorder) &&
+            m_pTrackCollectionManager->trackQueryThread()) {
+        selectAsync();
+        return;
+    }
+    // Discard the results of a pending asynchronous select
+    ++*m_pSelectGeneration;
+    m_pendingRows.clear();
+
     PerformanceTimer time;
     time.start();
 
@@ -341,6 +355,221 @@ void BaseSqlTableModel::select() {
              << "results in" << time.elapsed().debugMillisWithUnit();
 }
 
+void BaseSqlTableModel::selectAsync() {
+    TrackQueryThread::Request request;
+    request.viewDefinitions = TrackQueryThread::temporaryViewDefinitions(m_database);
+    request.tableQuery = QString("SELECT %1 FROM %2 %3")
+                                 .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    request.idColumn = m_idColumn;
+    request.columnCount = m_tableColumns.size();
+    if (m_trackSource) {
+        if (!m_trackSource->isIndexBuilt()) {
+            m_trackSource->buildIndex();
+        }
+        // Filter by a subquery instead of the list of all track ids,
+        // which are not known before the table query has been executed
+        request.trackSourceQuery = m_trackSource->filterAndSortQueryString(
+                QString("SELECT %1 FROM %2").arg(m_idColumn, m_tableName),
+                m_currentSearch,
+                m_currentSearchFilter,
+                m_trackSourceOrderBy);
+        request.trackSourceIdColumn = m_trackSource->idColumn();
+        request.trackSourceIsSorted = !m_trackSourceOrderBy.isEmpty();
+        request.dirtyTrackIds = m_trackSource->dirtyTrackIds();
+    }
+    request.generation = ++*m_pSelectGeneration;
+    request.pLatestGeneration = m_pSelectGeneration;
+
+    if (sDebug) {
+        qDebug() << this << "selectAsync() executing:" << request.tableQuery
+                 << request.trackSourceQuery;
+    }
+
+    m_bStreamingRows = m_rowInfo.isEmpty();
+    m_pendingRows.clear();
+    m_selectTimer.start();
+    m_pTrackCollectionManager->trackQueryThread()->select(
+            std::move(request),
+            this,
+            [this](TrackQueryThread::Page page) {
+                onSelectPage(std::move(page));
+            });
+}
+
+void BaseSqlTableModel::onSelectPage(TrackQueryThread::Page page) {
+    if (page.generation != m_pSelectGeneration->load()) {
+        // Superseded by a newer select
+        return;
+    }
+    if (page.failed) {
+        // Keep the current rows, like select() does if the query fails
+        qWarning() << this << "selectAsync() failed";
+        m_pendingRows.clear();
+        return;
+    }
+
+    if (m_bStreamingRows) {
+        appendRows(toRowInfos(std::move(page.rows), m_rowInfo.size()));
+    } else {
+        m_pendingRows.append(toRowInfos(std::move(page.rows), m_pendingRows.size()));
+    }
+    if (!page.isLast) {
+        return;
+    }
+    if (!m_bStreamingRows) {
+        replaceRowsKeepingPersistentIndexes(std::move(m_pendingRows));
+        m_pendingRows = QVector<RowInfo>();
+    }
+
+    // Like BaseTrackCache::filterAndSort() correct the rows of modified
+    // tracks that have not been saved yet
+    if (m_trackSource) {
+        updateChangedTrackRows(m_trackSource->dirtyTrackIds());
+        insertDirtyTrackRows(toRowInfos(std::move(page.filteredDirtyRows), 0));
+    }
+
+    qDebug() << this << "selectAsync() returned" << m_rowInfo.size()
+             << "results in" << m_selectTimer.elapsed().debugMillisWithUnit();
+}
+
+void BaseSqlTableModel::appendRows(QVector<RowInfo>&& rows) {
+    if (rows.isEmpty()) {
+        return;
+    }
+    const int firstRow = m_rowInfo.size();
+    beginInsertRows(QModelIndex(), firstRow, firstRow + rows.size() - 1);
+    for (int i = 0; i < rows.size(); ++i) {
+        m_trackIdToRows[rows[i].trackId].push_back(firstRow + i);
+    }
+    m_rowInfo.append(std::move(rows));
+    endInsertRows();
+}
+
+void BaseSqlTableModel::replaceRowsKeepingPersistentIndexes(QVector<RowInfo>&& rows) {
+    const int oldRowCount = m_rowInfo.size();
+    const int newRowCount = rows.size();
+    if (oldRowCount == 0) {
+        appendRows(std::move(rows));
+        return;
+    }
+    if (newRowCount == 0) {
+        clearRows();
+        return;
+    }
+
+    // The number of rows must not change while the layout is changed.
+    // Additional rows are inserted before and surplus rows are removed
+    // afterwards.
+    if (newRowCount > oldRowCount) {
+        appendRows(rows.mid(oldRowCount));
+    } else if (newRowCount < oldRowCount) {
+        rows.append(m_rowInfo.mid(newRowCount));
+    }
+    DEBUG_ASSERT(rows.size() == m_rowInfo.size());
+
+    emit layoutAboutToBeChanged();
+    TrackId2Rows trackIdToRows = indexRows(rows);
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (const auto& oldIndex : oldIndexes) {
+        // Tracks that are contained multiple times are mapped by the
+        // order of their occurrences
+        const TrackId trackId = m_rowInfo[oldIndex.row()].trackId;
+        const int occurrence = m_trackIdToRows.value(trackId).indexOf(oldIndex.row());
+        const QVector<int> newRows = trackIdToRows.value(trackId);
+        if (occurrence >= 0 && occurrence < newRows.size()) {
+            newIndexes.append(index(newRows[occurrence], oldIndex.column()));
+        } else {
+            newIndexes.append(QModelIndex());
+        }
+    }
+    m_rowInfo = std::move(rows);
+    m_trackIdToRows = std::move(trackIdToRows);
+    changePersistentIndexList(oldIndexes, newIndexes);
+    emit layoutChanged();
+
+    if (newRowCount < oldRowCount) {
+        beginRemoveRows(QModelIndex(), newRowCount, oldRowCount - 1);
+        m_rowInfo.resize(newRowCount);
+        m_trackIdToRows = indexRows(m_rowInfo);
+        endRemoveRows();
+    }
+}
+
+void BaseSqlTableModel::insertDirtyTrackRows(QVector<RowInfo>&& rows) {
+    if (rows.isEmpty()) {
+        return;
+    }
+    QSet<TrackId> trackIds;
+    for (const auto& row : std::as_const(rows)) {
+        trackIds.insert(row.trackId);
+    }
+    const QSet<TrackId> matchingTrackIds =
+            m_trackSource->findTracksMatchingSearch(trackIds, m_currentSearch);
+    if (matchingTrackIds.isEmpty()) {
+        return;
+    }
+
+    const bool isSorted = isSortedByTrackSource();
+    // exclude the 1st column with the id
+    const int columnOffset = m_tableColumns.size() - 1;
+    for (auto& row : rows) {
+        if (!matchingTrackIds.contains(row.trackId)) {
+            continue;
+        }
+        int insertRow = m_rowInfo.size();
+        if (isSorted) {
+            // Binary search for the first row that sorts after the track
+            int min = 0;
+            int max = m_rowInfo.size();
+            while (min < max) {
+                const int mid = min + (max - min) / 2;
+                if (m_trackSource->compareTracks(row.trackId,
+                            m_rowInfo[mid].trackId,
+                            m_sortColumns,
+                            columnOffset) < 0) {
+                    max = mid;
+                } else {
+                    min = mid + 1;
+                }
+            }
+            insertRow = min;
+        }
+        beginInsertRows(QModelIndex(), insertRow, insertRow);
+        m_rowInfo.insert(insertRow, std::move(row));
+        reindexTrackRows(insertRow, m_rowInfo.size() - 1);
+        endInsertRows();
+    }
+}
+
+// static
+QVector<BaseSqlTableModel::RowInfo> BaseSqlTableModel::toRowInfos(
+        QVector<TrackQueryThread::Row>&& rows,
+        int firstOrder) {
+    QVector<RowInfo> rowInfos;
+    rowInfos.reserve(rows.size());
+    for (auto& row : rows) {
+        RowInfo rowInfo;
+        rowInfo.trackId = row.trackId;
+        rowInfo.order = firstOrder + rowInfos.size();
+        rowInfo.metadata = std::move(row.metadata);
+        rowInfos.push_back(std::move(rowInfo));
+    }
+    return rowInfos;
+}
+
+// static
+BaseSqlTableModel::TrackId2Rows BaseSqlTableModel::indexRows(
+        const QVector<RowInfo>& rows) {
+    TrackId2Rows trackIdToRows;
+    trackIdToRows.reserve(rows.size());
+    for (int i = 0; i < rows.size(); ++i) {
+        trackIdToRows[rows[i].trackId].push_back(i);
+    }
+    return trackIdToRows;
+}
+
 void BaseSqlTableModel::setTable(QString tableName,
         QString idColumn,
         QStringList tableColumns,
@@ -348,6 +577,14 @@ void BaseSqlTableModel::setTable(QString tableName,
     if (sDebug) {
         qDebug() << this << "setTable" << tableName << tableColumns << idColumn;
     }
+    if (m_bAsyncSelect && m_tableName != tableName) {
+        // The rows of a different table must neither be displayed until
+        // the new rows have been selected nor be used for mapping the
+        // selection to the new rows
+        ++*m_pSelectGeneration;
+        m_pendingRows.clear();
+        clearRows();
+    }
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
     m_tableColumns = std::move(tableColumns);
@@ -833,6 +1070,8 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
         qDebug() << this << "trackChanged" << trackIds.size();
     }
 
+    updateChangedTrackRows(trackIds);
+
     const int numColumns = columnCount();
     for (const auto& trackId : trackIds) {
         const auto rows = getTrackRows(trackId);
@@ -845,6 +1084,139 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
     }
 }
 
+void BaseSqlTableModel::updateChangedTrackRows(const QSet<TrackId>& trackIds) {
+    if (!m_trackSource || m_rowInfo.isEmpty()) {
+        return;
+    }
+    QSet<TrackId> changedTrackIds;
+    for (const auto& trackId : trackIds) {
+        if (m_trackIdToRows.contains(trackId)) {
+            changedTrackIds.insert(trackId);
+        }
+    }
+    if (changedTrackIds.isEmpty()) {
+        return;
+    }
+
+    // Like the dirty tracks in BaseTrackCache::filterAndSort() only the
+    // search query is re-evaluated, not the extra filter.
+    const QSet<TrackId> notMatchingTrackIds =
+            m_trackSource->findTracksNotMatchingSearch(changedTrackIds, m_currentSearch);
+    for (const auto& trackId : notMatchingTrackIds) {
+        removeTrackRows(trackId);
+        changedTrackIds.remove(trackId);
+    }
+
+    if (!isSortedByTrackSource()) {
+        return;
+    }
+    // exclude the 1st column with the id
+    const int columnOffset = m_tableColumns.size() - 1;
+    for (const auto& trackId : std::as_const(changedTrackIds)) {
+        moveTrackRow(trackId, columnOffset);
+    }
+}
+
+bool BaseSqlTableModel::isSortedByTrackSource() const {
+    if (m_trackSourceOrderBy.isEmpty() || !m_tableOrderBy.isEmpty()) {
+        return false;
+    }
+    // The order of table columns and of the random sort is only known
+    // to the database
+    for (const auto& sortColumn : m_sortColumns) {
+        if (sortColumn.m_column < m_tableColumns.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BaseSqlTableModel::moveTrackRow(TrackId trackId, int columnOffset) {
+    const QVector<int> rows = m_trackIdToRows.value(trackId);
+    if (rows.size() != 1) {
+        // Tracks that are contained multiple times keep their rows
+        return;
+    }
+    const int row = rows.first();
+    const int lastRow = m_rowInfo.size() - 1;
+    const auto compareWithRow = [&](int otherRow) {
+        return m_trackSource->compareTracks(
+                trackId, m_rowInfo[otherRow].trackId, m_sortColumns, columnOffset);
+    };
+    if ((row == 0 || compareWithRow(row - 1) >= 0) &&
+            (row == lastRow || compareWithRow(row + 1) <= 0)) {
+        // Still sorted, also if the track is equal to its neighbors
+        return;
+    }
+
+    // Binary search for the position among all other rows, which are
+    // still sorted
+    int min = 0;
+    int max = lastRow;
+    while (min < max) {
+        const int mid = min + (max - min) / 2;
+        const int otherRow = mid < row ? mid : mid + 1;
+        if (compareWithRow(otherRow) < 0) {
+            max = mid;
+        } else {
+            min = mid + 1;
+        }
+    }
+    const int newRow = min;
+    if (newRow == row) {
+        return;
+    }
+    // The destination of beginMoveRows() refers to the rows before the move
+    const int destinationRow = newRow < row ? newRow : newRow + 1;
+    if (!beginMoveRows(QModelIndex(), row, row, QModelIndex(), destinationRow)) {
+        return;
+    }
+    m_rowInfo.move(row, newRow);
+    endMoveRows();
+    reindexTrackRows(std::min(row, newRow), std::max(row, newRow));
+}
+
+void BaseSqlTableModel::removeTrackRows(TrackId trackId) {
+    const QVector<int> rows = m_trackIdToRows.value(trackId);
+    if (rows.isEmpty()) {
+        return;
+    }
+    const int lastRow = m_rowInfo.size() - 1;
+    // Remove from the end, so the remaining rows keep their index
+    for (auto it = rows.crbegin(); it != rows.crend(); ++it) {
+        beginRemoveRows(QModelIndex(), *it, *it);
+        m_rowInfo.remove(*it);
+        endRemoveRows();
+    }
+    m_trackIdToRows.remove(trackId);
+    reindexTrackRows(*std::min_element(rows.cbegin(), rows.cend()), lastRow);
+}
+
+void BaseSqlTableModel::reindexTrackRows(int firstRow, int lastRow) {
+    const int lastExistingRow = std::min(lastRow, static_cast<int>(m_rowInfo.size()) - 1);
+    QSet<TrackId> trackIds;
+    for (int row = firstRow; row <= lastExistingRow; ++row) {
+        trackIds.insert(m_rowInfo[row].trackId);
+    }
+    for (const auto& trackId : std::as_const(trackIds)) {
+        auto& rows = m_trackIdToRows[trackId];
+        rows.erase(std::remove_if(rows.begin(),
+                           rows.end(),
+                           [firstRow, lastRow](int row) {
+                               return row >= firstRow && row <= lastRow;
+                           }),
+                rows.end());
+    }
+    for (int row = firstRow; row <= lastExistingRow; ++row) {
+        m_trackIdToRows[m_rowInfo[row].trackId].append(row);
+    }
+    for (const auto& trackId : std::as_const(trackIds)) {
+        auto& rows = m_trackIdToRows[trackId];
+        std::sort(rows.begin(), rows.end());
+    }
+    DEBUG_ASSERT(m_rowInfo.empty() == m_trackIdToRows.empty());
+}
+
 void BaseSqlTableModel::hideTracks(const QModelIndexList& indices) {
     QList<TrackId> trackIds;
     foreach (QModelIndex index, indices) {
@@ -2,12 +2,16 @@
 
 #include <QHash>
 #include <QtSql>
+#include <atomic>
+#include <memory>
 
 #include "library/basetrackcache.h"
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
 #include "library/columncache.h"
+#include "library/trackquerythread.h"
 #include "util/class.h"
+#include "util/performancetimer.h"
 
 class TrackCollectionManager;
 
@@ -32,6 +36,18 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     void setSearch(const QString& searchText, const QString& extraFilter = QString());
     void setSort(int column, Qt::SortOrder order);
 
+    /// Selects the rows on the TrackQueryThread instead of blocking the
+    /// GUI thread. The rows of an empty model are inserted page by page,
+    /// otherwise the current rows are kept until all new rows have been
+    /// received and then replaced at once, which preserves the selection
+    /// and the scroll position. Only enable this for models whose rows are
+    /// not accessed immediately after calling select(). This excludes all
+    /// models that support reordering, because moving and dropping tracks
+    /// in WTrackTableView relies on the rows being updated synchronously.
+    void setAsyncSelect(bool asyncSelect) {
+        m_bAsyncSelect = asyncSelect;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from QAbstractItemModel
     ///////////////////////////////////////////////////////////////////////////
@@ -142,6 +158,30 @@ class BaseSqlTableModel : public BaseTrackTableModel {
             QVector<RowInfo>&& rows,
             TrackId2Rows&& trackIdToRows);
 
+    void selectAsync();
+    void onSelectPage(TrackQueryThread::Page page);
+    void appendRows(QVector<RowInfo>&& rows);
+    /// Replaces all rows and moves the persistent indexes, e.g. the
+    /// selection, to the new rows of their tracks.
+    void replaceRowsKeepingPersistentIndexes(QVector<RowInfo>&& rows);
+    /// Inserts the rows of modified tracks that have been filtered out by
+    /// the database, but match the search in their current state.
+    void insertDirtyTrackRows(QVector<RowInfo>&& rows);
+    static QVector<RowInfo> toRowInfos(
+            QVector<TrackQueryThread::Row>&& rows,
+            int firstOrder);
+    static TrackId2Rows indexRows(const QVector<RowInfo>& rows);
+
+    /// Keeps the rows of modified tracks filtered and sorted without
+    /// selecting all rows again.
+    void updateChangedTrackRows(const QSet<TrackId>& trackIds);
+    bool isSortedByTrackSource() const;
+    void moveTrackRow(TrackId trackId, int columnOffset);
+    void removeTrackRows(TrackId trackId);
+    /// Updates m_trackIdToRows after the rows between firstRow and
+    /// lastRow have been moved or removed.
+    void reindexTrackRows(int firstRow, int lastRow);
+
     QVector<RowInfo> m_rowInfo;
 
     QString m_idColumn;
@@ -156,5 +196,14 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    bool m_bAsyncSelect;
+    // Results of superseded asynchronous selects are discarded
+    std::shared_ptr<std::atomic<int>> m_pSelectGeneration;
+    // Set if the rows of the pending asynchronous select are appended
+    // while received, otherwise they are collected in m_pendingRows
+    bool m_bStreamingRows;
+    QVector<RowInfo> m_pendingRows;
+    PerformanceTimer m_selectTimer;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
@@ -1,5 +1,7 @@
 #include "library/basetrackcache.h"
 
+#include <algorithm>
+
 #include "library/queryutil.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
@@ -29,9 +31,12 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_columnCache(std::move(columns)),
           m_pQueryParser(std::make_unique<SearchQueryParser>(
                   pTrackCollection, std::move(searchColumns))),
+          m_bLastFilterValid(false),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
+          m_trackInfo(m_columnCount),
           m_database(pTrackCollection->database()) {
+    m_pQueryParser->setSearchIndex(&pTrackCollection->getSearchIndexDAO());
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -81,6 +86,7 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
         m_trackInfo.remove(trackId);
         m_dirtyTracks.remove(trackId);
     }
+    invalidateFilterResult();
 }
 
 void BaseTrackCache::slotTrackDirty(TrackId trackId) {
@@ -88,6 +94,7 @@ void BaseTrackCache::slotTrackDirty(TrackId trackId) {
         qDebug() << this << "slotTrackDirty" << trackId;
     }
     m_dirtyTracks.insert(trackId);
+    invalidateFilterResult();
 }
 
 void BaseTrackCache::slotTrackClean(TrackId trackId) {
@@ -99,6 +106,16 @@ void BaseTrackCache::slotTrackClean(TrackId trackId) {
     updateTrackInIndex(trackId);
 }
 
+void BaseTrackCache::slotTracksClean(const QSet<TrackId>& trackIds) {
+    if (sDebug) {
+        qDebug() << this << "slotTracksClean" << trackIds.size();
+    }
+    for (const auto& trackId : trackIds) {
+        m_dirtyTracks.remove(trackId);
+    }
+    updateTracksInIndex(trackIds);
+}
+
 bool BaseTrackCache::isCached(TrackId trackId) const {
     return m_trackInfo.contains(trackId);
 }
@@ -115,12 +132,11 @@ const TrackPointer& BaseTrackCache::getRecentTrack(TrackId trackId) const {
     DEBUG_ASSERT(m_bIsCaching);
     // Only refresh the recently used track if the identifiers
     // don't match. Otherwise simply return the corresponding
-    // pointer to avoid accessing and locking the global track
-    // cache excessively.
+    // pointer to avoid accessing the global track cache excessively.
     if (m_recentTrackId != trackId) {
         if (trackId.isValid()) {
             TrackPointer trackPtr =
-                    GlobalTrackCacheLocker().lookupTrackById(trackId);
+                    GlobalTrackCache::lookupTrackById(trackId);
             replaceRecentTrack(
                     std::move(trackId),
                     std::move(trackPtr));
@@ -167,7 +183,10 @@ void BaseTrackCache::replaceRecentTrack(TrackId trackId, TrackPointer pTrack) co
             DEBUG_ASSERT(m_recentTrackPtr);
 
             if (m_recentTrackPtr->isDirty()) {
-                m_dirtyTracks.insert(m_recentTrackId);
+                if (!m_dirtyTracks.contains(m_recentTrackId)) {
+                    m_dirtyTracks.insert(m_recentTrackId);
+                    invalidateFilterResult();
+                }
             } else {
                 m_dirtyTracks.remove(m_recentTrackId);
             }
@@ -193,6 +212,7 @@ bool BaseTrackCache::updateTrackInIndex(
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return false;
     }
+    invalidateFilterResult();
     if (sDebug) {
         qDebug() << "updateTrackInIndex:" << pTrack->getLocation();
     }
@@ -201,13 +221,12 @@ bool BaseTrackCache::updateTrackInIndex(
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        // preallocate memory for all columns at once
-        record.resize(numColumns);
+        const int row = m_trackInfo.insert(trackId);
         for (int i = 0; i < numColumns; ++i) {
-            getTrackValueForColumn(pTrack, i, record[i]);
+            // Columns that are not provided by the track keep their value
+            QVariant trackValue = m_trackInfo.value(trackId, i);
+            getTrackValueForColumn(pTrack, i, trackValue);
+            m_trackInfo.setValue(row, i, trackValue);
         }
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), pTrack);
@@ -223,6 +242,7 @@ bool BaseTrackCache::updateTrackInIndex(
 bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
     PerformanceTimer timer;
     timer.start();
+    invalidateFilterResult();
 
     if (sDebug) {
         qDebug() << "updateIndexWithQuery issuing query:" << queryString;
@@ -245,23 +265,20 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
 
     int numColumns = columnCount();
     int idColumn = query.record().indexOf(m_idColumn);
+    const int locationColumn = fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
 
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
-
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
+        const int row = m_trackInfo.insert(trackId);
 
         for (int i = 0; i < numColumns; ++i) {
-            if (fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION) == i) {
+            if (locationColumn == i) {
                 // Database stores all locations with Qt separators: "/"
                 // Here we want to cache the display string with native separators.
                 QString location = query.value(i).toString();
-                record[i] = QDir::toNativeSeparators(location);
+                m_trackInfo.setValue(row, i, QDir::toNativeSeparators(location));
             } else {
-                record[i] = query.value(i);
+                m_trackInfo.setValue(row, i, query.value(i));
             }
         }
     }
@@ -414,7 +431,10 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
         return result;
     }
 
-    if (m_bIsCaching) {
+    // Only tracks with unsaved modifications differ from the track info
+    // cache, which is updated when a track is saved. Looking up all other
+    // tracks in the global track cache would only slow down painting.
+    if (m_bIsCaching && m_dirtyTracks.contains(trackId)) {
         TrackPointer pTrack = getRecentTrack(trackId);
         if (pTrack) {
             getTrackValueForColumn(pTrack, column, result);
@@ -429,11 +449,7 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
     if (!result.isValid()) {
-        auto it = m_trackInfo.constFind(trackId);
-        if (it != m_trackInfo.constEnd()) {
-            const QVector<QVariant>& fields = it.value();
-            result = fields.value(column, result);
-        }
+        result = m_trackInfo.value(trackId, column);
     }
     return result;
 }
@@ -454,38 +470,44 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
+    // While the user is typing ahead only the tracks of the previous
+    // result can match. The same query is evaluated again, because it
+    // is repeated when something else has changed, e.g. a crate.
+    const bool narrowLastFilter = m_bLastFilterValid &&
+            searchQuery != m_lastFilterSearchQuery &&
+            extraFilter == m_lastFilterExtraFilter &&
+            SearchQueryParser::queryIsMoreSpecific(
+                    m_lastFilterSearchQuery, searchQuery) &&
+            trackIds == m_lastFilterTrackIds;
+    QSet<TrackId> lastResultTrackIds;
+    if (narrowLastFilter) {
+        // m_trackOrder still contains the last result
+        lastResultTrackIds.reserve(m_trackOrder.size());
+        for (const auto& trackId : std::as_const(m_trackOrder)) {
+            lastResultTrackIds.insert(trackId);
+        }
+        if (sDebug) {
+            qDebug() << this << "Narrowing the last result of"
+                     << lastResultTrackIds.size() << "tracks";
+        }
+    }
+    const QSet<TrackId>& candidateTrackIds =
+            narrowLastFilter ? lastResultTrackIds : trackIds;
+
     QStringList idStrings;
     // TODO(rryan) consider making this the data passed in and a separate
     // QVector for output
     QSet<TrackId> dirtyTracks;
-    for (const auto& trackId: trackIds) {
+    for (const auto& trackId : candidateTrackIds) {
         idStrings << trackId.toString();
         if (m_dirtyTracks.contains(trackId)) {
             dirtyTracks.insert(trackId);
         }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
-
     const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+            parseFilterQuery(idStrings.join(","), searchQuery, extraFilter);
+    const QString queryString = queryStringForFilter(*pQuery, orderByClause);
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -497,8 +519,14 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     query.setForwardOnly(true);
     query.prepare(queryString);
 
-    if (!query.exec()) {
+    if (query.exec()) {
+        m_lastFilterTrackIds = trackIds;
+        m_lastFilterSearchQuery = searchQuery;
+        m_lastFilterExtraFilter = extraFilter;
+        m_bLastFilterValid = true;
+    } else {
         LOG_FAILED_QUERY(query);
+        invalidateFilterResult();
     }
 
     int idColumn = query.record().indexOf(m_idColumn);
@@ -534,6 +562,11 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         return;
     }
 
+    // All dirty tracks are removed from the result set at once, which keeps
+    // the remaining tracks sorted. Those that match are then inserted again
+    // at their sort position. The index is only rebuilt once at the end.
+    QSet<TrackId> tracksToRemove;
+    QList<TrackPointer> tracksToInsert;
     for (TrackId trackId : std::as_const(dirtyTracks)) {
         // Only get the track if it is in the cache. Tracks that
         // are not cached in memory cannot be dirty.
@@ -548,52 +581,141 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         bool shouldBeInResultSet = searchQuery.isEmpty() ||
                 pQuery->match(pTrack);
 
-        // If the track is in this result set.
-        bool isInResultSet = trackToIndex->contains(trackId);
-
+        // Tracks must be removed before reinserting them, otherwise they
+        // would sort wrong.
+        if (trackToIndex->contains(trackId)) {
+            tracksToRemove.insert(trackId);
+        }
         if (shouldBeInResultSet) {
-            // Track should be in result set...
-
-            // Remove the track from the results first (we have to do this or it
-            // will sort wrong).
-            if (isInResultSet) {
-                int index = (*trackToIndex)[trackId];
-                m_trackOrder.remove(index);
-                // Don't update trackToIndex, since we do it below.
-            }
+            tracksToInsert.append(std::move(pTrack));
+        }
+    }
+    if (tracksToRemove.isEmpty() && tracksToInsert.isEmpty()) {
+        return;
+    }
+
+    m_trackOrder.erase(std::remove_if(m_trackOrder.begin(),
+                               m_trackOrder.end(),
+                               [&tracksToRemove](TrackId trackId) {
+                                   return tracksToRemove.contains(trackId);
+                               }),
+            m_trackOrder.end());
+    for (const auto& pTrack : std::as_const(tracksToInsert)) {
+        // Figure out where it is supposed to sort. The table is sorted by
+        // the sort column, so we can binary search.
+        int insertRow = findSortInsertionPoint(
+                pTrack, sortColumns, columnOffset, m_trackOrder);
+
+        if (sDebug) {
+            qDebug() << this
+                     << "Insertion sort says it should be inserted at:"
+                     << insertRow;
+        }
 
-            // Figure out where it is supposed to sort. The table is sorted by
-            // the sort column, so we can binary search.
-            int insertRow = findSortInsertionPoint(
-                    pTrack, sortColumns, columnOffset, m_trackOrder);
+        // The track should sort at insertRow
+        m_trackOrder.insert(insertRow, pTrack->getId());
+    }
 
-            if (sDebug) {
-                qDebug() << this
-                         << "Insertion sort says it should be inserted at:"
-                         << insertRow;
-            }
+    trackToIndex->clear();
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
+    }
+}
+
+std::unique_ptr<QueryNode> BaseTrackCache::parseFilterQuery(
+        const QString& trackIdList,
+        const QString& searchQuery,
+        const QString& extraFilter) const {
+    QStringList queryFragments;
+    if (!extraFilter.isNull() && extraFilter != "") {
+        queryFragments << QString("(%1)").arg(extraFilter);
+    }
+    if (!trackIdList.isEmpty()) {
+        queryFragments << QString("%1 in (%2)")
+                .arg(m_idColumn, trackIdList);
+    }
 
-            // The track should sort at insertRow
-            m_trackOrder.insert(insertRow, trackId);
+    return m_pQueryParser->parseQuery(
+            searchQuery,
+            queryFragments.join(" AND "));
+}
 
-            trackToIndex->clear();
-            // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
-            }
-        } else if (isInResultSet) {
-            // Track should not be in this result set, but it is. We need to
-            // remove it.
-            int index = (*trackToIndex)[trackId];
-            m_trackOrder.remove(index);
-
-            trackToIndex->clear();
-            // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
-            }
+QString BaseTrackCache::queryStringForFilter(
+        const QueryNode& query,
+        const QString& orderByClause) const {
+    QString filter = query.toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+
+    return QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+}
+
+QString BaseTrackCache::filterAndSortQueryString(
+        const QString& trackIdList,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause) const {
+    const std::unique_ptr<QueryNode> pQuery =
+            parseFilterQuery(trackIdList, searchQuery, extraFilter);
+    return queryStringForFilter(*pQuery, orderByClause);
+}
+
+int BaseTrackCache::compareTracks(TrackId trackId1,
+        TrackId trackId2,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset) const {
+    for (const auto& sortColumn : sortColumns) {
+        const int column = sortColumn.m_column - columnOffset;
+        const int compare = compareColumnValues(column,
+                sortColumn.m_order,
+                data(trackId1, column),
+                data(trackId2, column));
+        if (compare != 0) {
+            return compare;
+        }
+    }
+    return 0;
+}
+
+QSet<TrackId> BaseTrackCache::findTracksNotMatchingSearch(
+        const QSet<TrackId>& trackIds,
+        const QString& searchQuery) const {
+    QSet<TrackId> notMatchingTrackIds;
+    if (!m_bIsCaching || searchQuery.isEmpty()) {
+        return notMatchingTrackIds;
+    }
+    const std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(searchQuery, QString());
+    for (const auto& trackId : trackIds) {
+        // Copy the pointer, the recent track is replaced while matching
+        const TrackPointer pTrack = getRecentTrack(trackId);
+        if (pTrack && !pQuery->match(pTrack)) {
+            notMatchingTrackIds.insert(trackId);
+        }
+    }
+    return notMatchingTrackIds;
+}
+
+QSet<TrackId> BaseTrackCache::findTracksMatchingSearch(
+        const QSet<TrackId>& trackIds,
+        const QString& searchQuery) const {
+    QSet<TrackId> matchingTrackIds;
+    if (!m_bIsCaching) {
+        return matchingTrackIds;
+    }
+    const std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(searchQuery, QString());
+    for (const auto& trackId : trackIds) {
+        // Copy the pointer, the recent track is replaced while matching
+        const TrackPointer pTrack = getRecentTrack(trackId);
+        if (pTrack && (searchQuery.isEmpty() || pQuery->match(pTrack))) {
+            matchingTrackIds.insert(trackId);
         }
     }
+    return matchingTrackIds;
 }
 
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
@@ -11,11 +11,13 @@
 #include <memory>
 
 #include "library/columncache.h"
+#include "library/trackinfocolumns.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -71,6 +73,49 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+    /// Returns the query that filterAndSort() executes for selecting the
+    /// ids of the filtered tracks in their sort order. The trackIdList is
+    /// either a comma-separated list of track ids or a subquery that selects
+    /// them. The query only depends on the table of this cache and may be
+    /// executed on a different connection, see TrackQueryThread.
+    QString filterAndSortQueryString(
+            const QString& trackIdList,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QString& orderByClause) const;
+    const QString& idColumn() const {
+        return m_idColumn;
+    }
+    const QSqlDatabase& database() const {
+        return m_database;
+    }
+    bool isIndexBuilt() const {
+        return m_bIndexBuilt;
+    }
+    /// Returns the tracks that might have been modified without saving
+    /// them to the database yet.
+    const QSet<TrackId>& dirtyTrackIds() const {
+        return m_dirtyTracks;
+    }
+
+    /// Compares the values of two tracks in the sort columns like the
+    /// insertion sort of dirty tracks in filterAndSort() does.
+    int compareTracks(TrackId trackId1,
+            TrackId trackId2,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset) const;
+    /// Re-evaluates the search query for the given tracks, e.g. after they
+    /// have been modified. Only tracks that are currently loaded can be
+    /// evaluated, all others are assumed to still match.
+    QSet<TrackId> findTracksNotMatchingSearch(
+            const QSet<TrackId>& trackIds,
+            const QString& searchQuery) const;
+    /// Returns the tracks that are currently loaded and match the search
+    /// query, i.e. those that filterAndSort() would add to the result set
+    /// after they have been modified.
+    QSet<TrackId> findTracksMatchingSearch(
+            const QSet<TrackId>& trackIds,
+            const QString& searchQuery) const;
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(const QSet<TrackId>& trackIds);
@@ -85,6 +130,7 @@ class BaseTrackCache : public QObject {
     void slotTracksRemoved(const QSet<TrackId>& trackId);
     void slotTrackDirty(TrackId trackId);
     void slotTrackClean(TrackId trackId);
+    void slotTracksClean(const QSet<TrackId>& trackIds);
 
   private:
     const TrackPointer& getRecentTrack(TrackId trackId) const;
@@ -92,6 +138,17 @@ class BaseTrackCache : public QObject {
     void replaceRecentTrack(TrackId trackId, TrackPointer pTrack) const;
     void resetRecentTrack() const;
 
+    std::unique_ptr<QueryNode> parseFilterQuery(
+            const QString& trackIdList,
+            const QString& searchQuery,
+            const QString& extraFilter) const;
+    QString queryStringForFilter(
+            const QueryNode& query,
+            const QString& orderByClause) const;
+    void invalidateFilterResult() const {
+        m_bLastFilterValid = false;
+    }
+
     bool updateIndexWithQuery(const QString& query);
     void updateTrackInIndex(TrackId trackId);
     bool updateTrackInIndex(const TrackPointer& pTrack);
@@ -130,6 +187,15 @@ class BaseTrackCache : public QObject {
 
     QVector<TrackId> m_trackOrder;
 
+    // The arguments of the last filterAndSort() call, whose result is still
+    // in m_trackOrder. While the user is typing ahead, a more specific
+    // search only needs to filter this result instead of all tracks. Any
+    // change of the tracks invalidates it.
+    QSet<TrackId> m_lastFilterTrackIds;
+    QString m_lastFilterSearchQuery;
+    QString m_lastFilterExtraFilter;
+    mutable bool m_bLastFilterValid;
+
     // Remember key and value of the most recent cache lookup to avoid querying
     // the global track cache again and again while populating the columns
     // of a single row. These members serve as a single-valued private cache.
@@ -144,7 +210,7 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant>> m_trackInfo;
+    TrackInfoColumns m_trackInfo;
     QSqlDatabase m_database;
 
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
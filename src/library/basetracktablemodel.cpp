@@ -14,6 +14,7 @@
 #include "library/tabledelegates/playcountdelegate.h"
 #include "library/tabledelegates/previewbuttondelegate.h"
 #include "library/tabledelegates/stardelegate.h"
+#include "library/tabledelegates/waveformthumbnaildelegate.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "mixer/playerinfo.h"
@@ -35,6 +36,15 @@ const mixxx::Logger kLogger("BaseTrackTableModel");
 constexpr double kRelativeHeightOfCoverartToolTip =
         0.165; // Height of the image for the cover art tooltip (Relative to the available screen size)
 
+// Rows are painted page by page, a few pages of rows are sufficient
+constexpr int kMaxCachedRowStyles = 1024;
+
+bool isCheckedValue(const QVariant& value) {
+    return !value.isNull() &&
+            value.canConvert<bool>() &&
+            value.toBool();
+}
+
 const QStringList kDefaultTableColumns = {
         LIBRARYTABLE_ALBUM,
         LIBRARYTABLE_ALBUMARTIST,
@@ -63,6 +73,7 @@ const QStringList kDefaultTableColumns = {
         LIBRARYTABLE_LAST_PLAYED_AT,
         LIBRARYTABLE_TITLE,
         LIBRARYTABLE_TRACKNUMBER,
+        LIBRARYTABLE_WAVEFORM,
         LIBRARYTABLE_YEAR,
 };
 
@@ -152,6 +163,31 @@ BaseTrackTableModel::BaseTrackTableModel(
                 this,
                 &BaseTrackTableModel::slotCoverFound);
     }
+    // The row styles are cached until the rows change
+    connect(this,
+            &QAbstractItemModel::dataChanged,
+            this,
+            &BaseTrackTableModel::slotInvalidateRowStyles);
+    connect(this,
+            &QAbstractItemModel::modelReset,
+            this,
+            &BaseTrackTableModel::slotClearRowStyles);
+    connect(this,
+            &QAbstractItemModel::layoutChanged,
+            this,
+            &BaseTrackTableModel::slotClearRowStyles);
+    connect(this,
+            &QAbstractItemModel::rowsInserted,
+            this,
+            &BaseTrackTableModel::slotClearRowStyles);
+    connect(this,
+            &QAbstractItemModel::rowsRemoved,
+            this,
+            &BaseTrackTableModel::slotClearRowStyles);
+    connect(this,
+            &QAbstractItemModel::rowsMoved,
+            this,
+            &BaseTrackTableModel::slotClearRowStyles);
 }
 
 void BaseTrackTableModel::initTableColumnsAndHeaderProperties(
@@ -264,6 +300,10 @@ void BaseTrackTableModel::initHeaderProperties() {
             ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER,
             tr("Track #"),
             defaultColumnWidth());
+    setHeaderProperties(
+            ColumnCache::COLUMN_LIBRARYTABLE_WAVEFORM,
+            tr("Waveform"),
+            defaultColumnWidth() * 3);
     setHeaderProperties(
             ColumnCache::COLUMN_LIBRARYTABLE_YEAR,
             tr("Year"),
@@ -450,6 +490,7 @@ bool BaseTrackTableModel::isColumnHiddenByDefault(
             column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
             column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED) ||
             column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_WAVEFORM) ||
             column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR);
 }
 
@@ -506,6 +547,8 @@ QAbstractItemDelegate* BaseTrackTableModel::delegateForColumn(
                 this,
                 &BaseTrackTableModel::slotRefreshCoverRows);
         return pCoverArtDelegate;
+    } else if (index == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_WAVEFORM)) {
+        return new WaveformThumbnailDelegate(pTableView);
     }
     return nullptr;
 }
@@ -518,10 +561,7 @@ QVariant BaseTrackTableModel::data(
     }
 
     if (role == Qt::BackgroundRole) {
-        const auto rgbColorValue = rawSiblingValue(
-                index,
-                ColumnCache::COLUMN_LIBRARYTABLE_COLOR);
-        const auto rgbColor = mixxx::RgbColor::fromQVariant(rgbColorValue);
+        const auto rgbColor = rowStyle(index).color;
         if (!rgbColor) {
             return QVariant();
         }
@@ -532,6 +572,7 @@ QVariant BaseTrackTableModel::data(
         bgColor.setAlphaF(static_cast<float>(m_backgroundColorOpacity));
         return QBrush(bgColor);
     } else if (role == Qt::ForegroundRole) {
+        const RowStyle& style = rowStyle(index);
         // Custom text color for missing tracks
         // Visible in playlists, crates and Missing feature.
         // Check this first so played, missing tracks (unlikely case, but possible)
@@ -539,24 +580,12 @@ QVariant BaseTrackTableModel::data(
         // Note: this is not helpful in Tracks -> Missing, so override it with
         // the regular track color (WTrackTableView { color: #xxx; }) like this:
         // #DlgMissing WTrackTableView { qproperty-trackMissingColor: #xxx; }
-        auto missingRaw = rawSiblingValue(
-                index,
-                ColumnCache::COLUMN_TRACKLOCATIONSTABLE_FSDELETED);
-        if (!missingRaw.isNull() &&
-                missingRaw.canConvert<bool>() &&
-                missingRaw.toBool()) {
+        if (style.missing) {
             return QVariant::fromValue(m_trackMissingColor);
         }
-        if (s_bApplyPlayedTrackColor) {
-            // Custom text color for played tracks
-            auto playedRaw = rawSiblingValue(
-                    index,
-                    ColumnCache::COLUMN_LIBRARYTABLE_PLAYED);
-            if (!playedRaw.isNull() &&
-                    playedRaw.canConvert<bool>() &&
-                    playedRaw.toBool()) {
-                return QVariant::fromValue(m_trackPlayedColor);
-            }
+        // Custom text color for played tracks
+        if (s_bApplyPlayedTrackColor && style.played) {
+            return QVariant::fromValue(m_trackPlayedColor);
         }
     }
 
@@ -718,6 +747,7 @@ QVariant BaseTrackTableModel::roleValue(
         case ColumnCache::COLUMN_LIBRARYTABLE_COVERART:
             return composeCoverArtToolTipHtml(index);
         case ColumnCache::COLUMN_LIBRARYTABLE_PREVIEW:
+        case ColumnCache::COLUMN_LIBRARYTABLE_WAVEFORM:
             return QVariant();
         case ColumnCache::COLUMN_LIBRARYTABLE_RATING:
         case ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED:
@@ -1070,7 +1100,8 @@ Qt::ItemFlags BaseTrackTableModel::readWriteFlags(
             column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_FILETYPE) ||
             column == fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION) ||
             column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN) ||
-            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE)) {
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_WAVEFORM)) {
         return readOnlyFlags(index);
     }
 
@@ -1170,6 +1201,49 @@ void BaseTrackTableModel::slotRefreshAllRows() {
     select();
 }
 
+void BaseTrackTableModel::slotInvalidateRowStyles(
+        const QModelIndex& topLeft,
+        const QModelIndex& bottomRight) {
+    if (!topLeft.isValid()) {
+        m_rowStyles.clear();
+        return;
+    }
+    const int lastRow = bottomRight.isValid() ? bottomRight.row() : topLeft.row();
+    if (lastRow - topLeft.row() >= m_rowStyles.size()) {
+        m_rowStyles.clear();
+        return;
+    }
+    for (int row = topLeft.row(); row <= lastRow; ++row) {
+        m_rowStyles.remove(row);
+    }
+}
+
+void BaseTrackTableModel::slotClearRowStyles() {
+    m_rowStyles.clear();
+}
+
+const BaseTrackTableModel::RowStyle& BaseTrackTableModel::rowStyle(
+        const QModelIndex& index) const {
+    const auto it = m_rowStyles.constFind(index.row());
+    if (it != m_rowStyles.constEnd()) {
+        return it.value();
+    }
+    if (m_rowStyles.size() >= kMaxCachedRowStyles) {
+        m_rowStyles.clear();
+    }
+    RowStyle style;
+    style.color = mixxx::RgbColor::fromQVariant(rawSiblingValue(
+            index,
+            ColumnCache::COLUMN_LIBRARYTABLE_COLOR));
+    style.missing = isCheckedValue(rawSiblingValue(
+            index,
+            ColumnCache::COLUMN_TRACKLOCATIONSTABLE_FSDELETED));
+    style.played = isCheckedValue(rawSiblingValue(
+            index,
+            ColumnCache::COLUMN_LIBRARYTABLE_PLAYED));
+    return m_rowStyles.insert(index.row(), style).value();
+}
+
 void BaseTrackTableModel::emitDataChangedForMultipleRowsInColumn(
         const QList<int>& rows,
         int column,
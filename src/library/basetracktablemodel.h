@@ -1,12 +1,14 @@
 #pragma once
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QList>
 #include <QPointer>
 
 #include "library/columncache.h"
 #include "library/trackmodel.h"
 #include "track/track_decl.h"
+#include "util/color/rgbcolor.h"
 
 class TrackCollectionManager;
 
@@ -216,6 +218,7 @@ class BaseTrackTableModel : public QAbstractTableModel, public TrackModel {
     /// COLUMN_LIBRARYTABLE_COVERART_DIGEST: QByteArray (pass-through)
     /// COLUMN_LIBRARYTABLE_COVERART_HASH: quint16 (pass-through)
     /// COLUMN_LIBRARYTABLE_LAST_PLAYED_AT: QDateTime
+    /// COLUMN_LIBRARYTABLE_WAVEFORM: virtual column for WaveformThumbnailDelegate
     /// COLUMN_PLAYLISTTABLE_DATETIMEADDED: QDateTime
     virtual QVariant rawValue(
             const QModelIndex& index) const;
@@ -251,6 +254,11 @@ class BaseTrackTableModel : public QAbstractTableModel, public TrackModel {
 
     void slotRefreshAllRows();
 
+    void slotInvalidateRowStyles(
+            const QModelIndex& topLeft,
+            const QModelIndex& bottomRight);
+    void slotClearRowStyles();
+
     void slotCoverFound(
             const QObject* pRequester,
             const CoverInfo& coverInfo,
@@ -292,6 +300,18 @@ class BaseTrackTableModel : public QAbstractTableModel, public TrackModel {
 
     mutable QModelIndex m_toolTipIndex;
 
+    // The sibling values that determine the background and text color
+    // of all cells in a row. They are cached to avoid looking them up
+    // again for each painted cell of the row.
+    struct RowStyle {
+        mixxx::RgbColor::optional_t color;
+        bool missing;
+        bool played;
+    };
+    const RowStyle& rowStyle(
+            const QModelIndex& index) const;
+    mutable QHash<int, RowStyle> m_rowStyles;
+
     static int s_bpmColumnPrecision;
 
     static bool s_bApplyPlayedTrackColor;
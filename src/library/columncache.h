@@ -54,6 +54,7 @@ class ColumnCache : public QObject {
         COLUMN_LIBRARYTABLE_COVERART_DIGEST,
         COLUMN_LIBRARYTABLE_COVERART_HASH,
         COLUMN_LIBRARYTABLE_LAST_PLAYED_AT,
+        COLUMN_LIBRARYTABLE_WAVEFORM,
 
         COLUMN_TRACKLOCATIONSTABLE_LOCATION,
         COLUMN_TRACKLOCATIONSTABLE_FSDELETED,
@@ -1,22 +1,29 @@
 #include "library/coverartcache.h"
 
+#include <QDir>
 #include <QFutureWatcher>
-#include <QPixmapCache>
 #include <QtConcurrent>
 #include <QtDebug>
 
+#include "library/coverthumbnailpack.h"
+#include "library/library_prefs.h"
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/thread_affinity.h"
 
 namespace {
 
 mixxx::Logger kLogger("CoverArtCache");
 
-QString pixmapCacheKey(mixxx::cache_key_t hash, int width) {
-    return QString("CoverArtCache_%1_%2")
-            .arg(QString::number(hash), QString::number(width));
+const QString kThumbnailPackFileName = QStringLiteral("coverthumbnails.pack");
+
+// The cost of a pixmap in the memory cache
+int pixmapSizeKiB(const QPixmap& pixmap) {
+    const qint64 sizeInBytes =
+            static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    return static_cast<int>(math_max<qint64>(1, sizeInBytes / 1024));
 }
 
 // The transformation mode when scaling images
@@ -29,7 +36,29 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
 
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
+CoverArtCache::CoverArtCache(UserSettingsPointer pConfig)
+        : m_pixmapCache(mixxx::library::prefs::kCoverArtMemoryCacheSizeMiBDefault * 1024),
+          m_pixmapMemoryAccount(QStringLiteral("CoverArtCache")) {
+    if (!pConfig) {
+        return;
+    }
+    const int memoryCacheSizeMiB = pConfig->getValue(
+            mixxx::library::prefs::kCoverArtMemoryCacheSizeMiBConfigKey,
+            mixxx::library::prefs::kCoverArtMemoryCacheSizeMiBDefault);
+    m_pixmapCache.setMaxCost(math_max(1, memoryCacheSizeMiB) * 1024);
+
+    // A size of 0 disables the thumbnail pack
+    const int thumbnailCacheSizeMiB = pConfig->getValue(
+            mixxx::library::prefs::kCoverArtThumbnailCacheSizeMiBConfigKey,
+            mixxx::library::prefs::kCoverArtThumbnailCacheSizeMiBDefault);
+    if (thumbnailCacheSizeMiB > 0) {
+        auto pThumbnailPack = std::make_shared<CoverThumbnailPack>(
+                QDir(pConfig->getSettingsPath()).filePath(kThumbnailPackFileName),
+                static_cast<qint64>(thumbnailCacheSizeMiB) * 1024 * 1024);
+        if (pThumbnailPack->isOpen()) {
+            m_pThumbnailPack = std::move(pThumbnailPack);
+        }
+    }
 }
 
 //static
@@ -74,11 +103,14 @@ QPixmap CoverArtCache::getCachedCover(
     if (!coverInfo.hasImage()) {
         return QPixmap();
     }
-    const mixxx::cache_key_t requestedCacheKey = coverInfo.cacheKey();
-    QString cacheKey = pixmapCacheKey(requestedCacheKey, desiredWidth);
-
-    QPixmap pixmap;
-    if (!QPixmapCache::find(cacheKey, &pixmap)) {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    VERIFY_OR_DEBUG_ASSERT(pCache) {
+        return QPixmap();
+    }
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(pCache);
+    const QPixmap* pPixmap = pCache->m_pixmapCache.object(
+            PixmapKey(coverInfo.cacheKey(), desiredWidth));
+    if (!pPixmap) {
         if (kLogger.traceEnabled()) {
             kLogger.trace()
                     << "requestCover cache miss"
@@ -92,7 +124,7 @@ QPixmap CoverArtCache::getCachedCover(
                 << "requestCover cache hit"
                 << coverInfo;
     }
-    return pixmap;
+    return *pPixmap;
 }
 
 // static
@@ -131,6 +163,39 @@ void CoverArtCache::requestUncachedCover(
             desiredWidth);
 }
 
+// static
+void CoverArtCache::prefetchCover(
+        const CoverInfo& coverInfo,
+        int desiredWidth) {
+    // Covers without a digest need to be loaded with their track
+    // for updating the digest
+    if (!coverInfo.hasImage() || coverInfo.imageDigest().isEmpty() || desiredWidth <= 0) {
+        return;
+    }
+    CoverArtCache* pCache = CoverArtCache::instance();
+    VERIFY_OR_DEBUG_ASSERT(pCache) {
+        return;
+    }
+    if (!getCachedCover(coverInfo, desiredWidth).isNull()) {
+        return;
+    }
+    pCache->tryLoadCover(
+            nullptr,
+            TrackPointer(),
+            coverInfo,
+            desiredWidth);
+}
+
+// static
+std::shared_ptr<CoverThumbnailPack> CoverArtCache::thumbnailPack() {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    VERIFY_OR_DEBUG_ASSERT(pCache) {
+        return nullptr;
+    }
+    // Only set in the constructor, i.e. safe to access from any thread
+    return pCache->m_pThumbnailPack;
+}
+
 void CoverArtCache::tryLoadCover(
         const QObject* pRequester,
         const TrackPointer& pTrack,
@@ -171,10 +236,9 @@ void CoverArtCache::tryLoadCover(
     // The watcher will be deleted in coverLoaded()
     QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
     QFuture<FutureResult> future = QtConcurrent::run(
-            &CoverArtCache::loadCover,
-            pTrack,
-            coverInfo,
-            desiredWidth);
+            [pTrack, coverInfo, desiredWidth, pThumbnailPack = m_pThumbnailPack]() {
+                return loadCover(pTrack, coverInfo, desiredWidth, pThumbnailPack);
+            });
     connect(watcher,
             &QFutureWatcher<FutureResult>::finished,
             this,
@@ -187,7 +251,8 @@ void CoverArtCache::tryLoadCover(
 CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
-        int desiredWidth) {
+        int desiredWidth,
+        const std::shared_ptr<CoverThumbnailPack>& pThumbnailPack) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -200,6 +265,28 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     auto res = FutureResult(
             coverInfo.cacheKey());
 
+    // Covers without a digest are identified by their legacy hash that
+    // needs to be replaced by loading the original image.
+    const bool useThumbnailPack = pThumbnailPack &&
+            desiredWidth > 0 &&
+            !coverInfo.imageDigest().isEmpty();
+    if (useThumbnailPack) {
+        QImage thumbnail = pThumbnailPack->load(coverInfo.cacheKey(), desiredWidth);
+        if (!thumbnail.isNull()) {
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.image = std::move(thumbnail);
+            loadedImage.location =
+                    (coverInfo.type == CoverInfo::FILE && !coverInfo.coverLocation.isEmpty())
+                    ? coverInfo.coverLocation
+                    : coverInfo.trackLocation;
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack);
     if (!loadedImage.image.isNull()) {
         if (coverInfo.imageDigest().isEmpty()) {
@@ -221,6 +308,9 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             // Adjust the cover size according to the request
             // or downsize the image for efficiency.
             loadedImage.image = resizeImageWidth(loadedImage.image, desiredWidth);
+            if (useThumbnailPack) {
+                pThumbnailPack->store(coverInfo.cacheKey(), desiredWidth, loadedImage.image);
+            }
         }
     }
 
@@ -248,8 +338,6 @@ void CoverArtCache::coverLoaded() {
         kLogger.trace() << "coverLoaded" << res.coverArt;
     }
 
-    QString cacheKey = pixmapCacheKey(
-            res.coverArt.cacheKey(), res.coverArt.resizedToWidth);
     QPixmap pixmap;
     if (res.coverArt.loadedImage.result != CoverInfo::LoadedImage::Result::NoImage) {
         if (res.coverArt.loadedImage.result == CoverInfo::LoadedImage::Result::Ok) {
@@ -285,7 +373,12 @@ void CoverArtCache::coverLoaded() {
             // It is very unlikely that res.coverArt.hash generates the
             // same hash for different images. Otherwise the wrong image would
             // be displayed when loaded from the cache.
-            QPixmapCache::insert(cacheKey, pixmap);
+            m_pixmapCache.insert(
+                    PixmapKey(res.coverArt.cacheKey(), res.coverArt.resizedToWidth),
+                    new QPixmap(pixmap),
+                    pixmapSizeKiB(pixmap));
+            m_pixmapMemoryAccount.set(
+                    static_cast<qint64>(m_pixmapCache.totalCost()) * 1024);
         }
     }
 
@@ -297,6 +390,11 @@ void CoverArtCache::coverLoaded() {
     auto i = runningRequests.find(res.coverArt.cacheKey());
     while (i != runningRequests.end() && i.key() == res.coverArt.cacheKey()) {
         if (i.value().desiredWidth == res.coverArt.resizedToWidth) {
+            if (!i.value().pRequester) {
+                // Prefetched
+                ++i;
+                continue;
+            }
             emit coverFound(
                     i.value().pRequester,
                     res.coverArt,
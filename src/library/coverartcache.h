@@ -1,15 +1,21 @@
 #pragma once
 
+#include <QCache>
 #include <QObject>
 #include <QPair>
 #include <QPixmap>
 #include <QSet>
 #include <QtDebug>
+#include <memory>
 
 #include "library/coverart.h"
+#include "preferences/usersettings.h"
 #include "track/track_decl.h"
+#include "util/memoryaccount.h"
 #include "util/singleton.h"
 
+class CoverThumbnailPack;
+
 class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     Q_OBJECT
   public:
@@ -37,6 +43,17 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const TrackPointer& pTrack,
             int desiredWidth);
 
+    /// Loads the cover into the cache in the background if it is not
+    /// cached yet, e.g. for rows that are about to scroll into view.
+    /// No coverFound() signal is emitted for prefetched covers.
+    static void prefetchCover(
+            const CoverInfo& coverInfo,
+            int desiredWidth);
+
+    /// The thumbnail pack for loading resized covers outside of this
+    /// cache, e.g. by the QML image provider, or nullptr if disabled.
+    static std::shared_ptr<CoverThumbnailPack> thumbnailPack();
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -51,10 +68,14 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     };
     // Load cover from path indicated in coverInfo. WARNING: This is run in a
     // worker thread.
+    //
+    // Resized covers are read from and written to the thumbnail pack if
+    // available.
     static FutureResult loadCover(
             TrackPointer pTrack,
             CoverInfo coverInfo,
-            int desiredWidth);
+            int desiredWidth,
+            const std::shared_ptr<CoverThumbnailPack>& pThumbnailPack = nullptr);
 
   private slots:
     // Called when loadCover is complete in the main thread.
@@ -67,7 +88,9 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const QPixmap& pixmap);
 
   protected:
-    CoverArtCache();
+    /// The thumbnail pack and the configurable memory budget are only
+    /// available if a config is provided.
+    explicit CoverArtCache(UserSettingsPointer pConfig = UserSettingsPointer());
     ~CoverArtCache() override = default;
     friend class Singleton<CoverArtCache>;
 
@@ -89,4 +112,12 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
         int desiredWidth;
     };
     QMultiHash<mixxx::cache_key_t, RequestData> m_runningRequests;
+
+    // The cost of each pixmap is its size in KiB
+    typedef QPair<mixxx::cache_key_t, int> PixmapKey;
+    QCache<PixmapKey, QPixmap> m_pixmapCache;
+    MemoryAccount m_pixmapMemoryAccount;
+
+    // Shared with the worker threads that might outlive this object
+    std::shared_ptr<CoverThumbnailPack> m_pThumbnailPack;
 };
@@ -18,6 +18,9 @@ mixxx::Logger kLogger("CoverArtUtils");
 // is enabled, unless it is explicitly disabled during tests!
 volatile bool s_enableConcurrentGuessingOfTrackCoverInfo = true;
 
+// Different embedded covers within a folder are rare
+constexpr int kMaxCachedEmbeddedCovers = 4;
+
 } // anonymous namespace
 
 //static
@@ -106,17 +109,23 @@ CoverInfoRelative CoverArtUtils::selectCoverArtForTrack(
         const mixxx::FileInfo& trackFile,
         const QString& albumName,
         const QList<QFileInfo>& covers) {
-    CoverInfoRelative coverInfoRelative;
-    DEBUG_ASSERT(coverInfoRelative.type == CoverInfo::NONE);
-    DEBUG_ASSERT(coverInfoRelative.imageDigest().isNull());
-    DEBUG_ASSERT(coverInfoRelative.coverLocation.isNull());
-    coverInfoRelative.source = CoverInfo::GUESSED;
-    if (covers.isEmpty()) {
+    const int coverIndex = selectCoverFileForTrack(trackFile, albumName, covers);
+    if (coverIndex < 0) {
+        CoverInfoRelative coverInfoRelative;
+        coverInfoRelative.source = CoverInfo::GUESSED;
         return coverInfoRelative;
     }
+    return coverInfoFromFile(covers.at(coverIndex));
+}
 
-    PreferredCoverType bestType = NONE;
-    const QFileInfo* bestInfo = nullptr;
+//static
+int CoverArtUtils::selectCoverFileForTrack(
+        const mixxx::FileInfo& trackFile,
+        const QString& albumName,
+        const QList<QFileInfo>& covers) {
+    if (covers.isEmpty()) {
+        return -1;
+    }
 
     // If there is a single image then we use it unconditionally. Otherwise
     // we use the priority order described in PreferredCoverType. Notably,
@@ -125,88 +134,146 @@ CoverInfoRelative CoverArtUtils::selectCoverArtForTrack(
     // arbitrary image that happens to be in the same folder as some of the
     // user's music files.
     if (covers.size() == 1) {
-        bestInfo = &covers.first();
-    } else {
-        // TODO(XXX) Sort instead so that we can fall-back if one fails to
-        // open?
-        foreach (const QFileInfo& file, covers) {
-            const QString coverBaseName = file.completeBaseName();
-            if (bestType > TRACK_BASENAME &&
-                    coverBaseName.compare(trackFile.completeBaseName(),
-                            Qt::CaseInsensitive) == 0) {
-                bestInfo = &file;
-                // This is the best type (TRACK_BASENAME) so we know we're done.
-                break;
-            } else if (bestType > TRACK_BASENAME &&
-                    coverBaseName.compare(trackFile.fileName(),
-                            Qt::CaseInsensitive) == 0) {
-                bestType = TRACK_BASENAME;
-                bestInfo = &file;
-            } else if (bestType > ALBUM_NAME &&
-                    coverBaseName.compare(albumName,
-                            Qt::CaseInsensitive) == 0) {
-                bestType = ALBUM_NAME;
-                bestInfo = &file;
-            } else if (bestType > COVER &&
-                    coverBaseName.compare(QLatin1String("cover"),
-                            Qt::CaseInsensitive) == 0) {
-                bestType = COVER;
-                bestInfo = &file;
-            } else if (bestType > FRONT &&
-                    coverBaseName.compare(QLatin1String("front"),
-                            Qt::CaseInsensitive) == 0) {
-                bestType = FRONT;
-                bestInfo = &file;
-            } else if (bestType > ALBUM &&
-                    coverBaseName.compare(QLatin1String("album"),
-                            Qt::CaseInsensitive) == 0) {
-                bestType = ALBUM;
-                bestInfo = &file;
-            } else if (bestType > FOLDER &&
-                    coverBaseName.compare(QLatin1String("folder"),
-                            Qt::CaseInsensitive) == 0) {
-                bestType = FOLDER;
-                bestInfo = &file;
-            }
-        }
+        return 0;
     }
 
-    if (bestInfo) {
-        const QImage image(bestInfo->filePath());
-        if (!image.isNull()) {
-            coverInfoRelative.type = CoverInfo::FILE;
-            coverInfoRelative.coverLocation = bestInfo->fileName();
-            coverInfoRelative.setImageDigest(image);
+    PreferredCoverType bestType = NONE;
+    int bestIndex = -1;
+    // TODO(XXX) Sort instead so that we can fall-back if one fails to
+    // open?
+    for (int i = 0; i < covers.size(); ++i) {
+        const QString coverBaseName = covers.at(i).completeBaseName();
+        if (bestType > TRACK_BASENAME &&
+                coverBaseName.compare(trackFile.completeBaseName(),
+                        Qt::CaseInsensitive) == 0) {
+            // This is the best type (TRACK_BASENAME) so we know we're done.
+            return i;
+        } else if (bestType > TRACK_BASENAME &&
+                coverBaseName.compare(trackFile.fileName(),
+                        Qt::CaseInsensitive) == 0) {
+            bestType = TRACK_BASENAME;
+            bestIndex = i;
+        } else if (bestType > ALBUM_NAME &&
+                coverBaseName.compare(albumName,
+                        Qt::CaseInsensitive) == 0) {
+            bestType = ALBUM_NAME;
+            bestIndex = i;
+        } else if (bestType > COVER &&
+                coverBaseName.compare(QLatin1String("cover"),
+                        Qt::CaseInsensitive) == 0) {
+            bestType = COVER;
+            bestIndex = i;
+        } else if (bestType > FRONT &&
+                coverBaseName.compare(QLatin1String("front"),
+                        Qt::CaseInsensitive) == 0) {
+            bestType = FRONT;
+            bestIndex = i;
+        } else if (bestType > ALBUM &&
+                coverBaseName.compare(QLatin1String("album"),
+                        Qt::CaseInsensitive) == 0) {
+            bestType = ALBUM;
+            bestIndex = i;
+        } else if (bestType > FOLDER &&
+                coverBaseName.compare(QLatin1String("folder"),
+                        Qt::CaseInsensitive) == 0) {
+            bestType = FOLDER;
+            bestIndex = i;
         }
     }
+    return bestIndex;
+}
 
+//static
+CoverInfoRelative CoverArtUtils::coverInfoFromFile(
+        const QFileInfo& coverFile) {
+    CoverInfoRelative coverInfoRelative;
+    DEBUG_ASSERT(coverInfoRelative.type == CoverInfo::NONE);
+    DEBUG_ASSERT(coverInfoRelative.imageDigest().isNull());
+    DEBUG_ASSERT(coverInfoRelative.coverLocation.isNull());
+    coverInfoRelative.source = CoverInfo::GUESSED;
+    const QImage image(coverFile.filePath());
+    if (!image.isNull()) {
+        coverInfoRelative.type = CoverInfo::FILE;
+        coverInfoRelative.coverLocation = coverFile.fileName();
+        coverInfoRelative.setImageDigest(image);
+    }
     return coverInfoRelative;
 }
 
+void CoverInfoGuesser::visitFolder(const QString& folder) {
+    if (folder == m_cachedFolder) {
+        return;
+    }
+    m_cachedFolder = folder;
+    // The image files are listed lazily when they are needed
+    m_cachedPossibleCoversValid = false;
+    m_cachedPossibleCoversInFolder.clear();
+    m_cachedCoverFiles.clear();
+    m_cachedEmbeddedCovers.clear();
+}
+
+CoverInfoRelative CoverInfoGuesser::guessEmbeddedCoverInfo(
+        const QImage& embeddedCover) {
+    DEBUG_ASSERT(!embeddedCover.isNull());
+    // Much cheaper than the digest and the background color, which
+    // need to be calculated only once for identical images.
+    const size_t pixelHash = qHashBits(
+            embeddedCover.constBits(),
+            static_cast<size_t>(embeddedCover.sizeInBytes()));
+    const auto it = m_cachedEmbeddedCovers.constFind(pixelHash);
+    if (it != m_cachedEmbeddedCovers.constEnd() && it->image == embeddedCover) {
+        return it->coverInfo;
+    }
+
+    CoverInfoRelative coverInfo;
+    coverInfo.source = CoverInfo::GUESSED;
+    coverInfo.type = CoverInfo::METADATA;
+    coverInfo.setImageDigest(embeddedCover);
+    DEBUG_ASSERT(coverInfo.coverLocation.isNull());
+
+    // Each cached image occupies its decoded size in memory. Tracks with
+    // the same cover usually follow each other within a folder.
+    if (m_cachedEmbeddedCovers.size() >= kMaxCachedEmbeddedCovers) {
+        m_cachedEmbeddedCovers.clear();
+    }
+    m_cachedEmbeddedCovers.insert(pixelHash, EmbeddedCover{embeddedCover, coverInfo});
+    return coverInfo;
+}
+
 CoverInfoRelative CoverInfoGuesser::guessCoverInfo(
         const mixxx::FileInfo& trackFile,
         const QString& albumName,
         const QImage& embeddedCover) {
+    visitFolder(trackFile.locationPath());
+
     if (!embeddedCover.isNull()) {
-        CoverInfoRelative coverInfo;
-        coverInfo.source = CoverInfo::GUESSED;
-        coverInfo.type = CoverInfo::METADATA;
-        coverInfo.setImageDigest(embeddedCover);
-        DEBUG_ASSERT(coverInfo.coverLocation.isNull());
-        return coverInfo;
+        return guessEmbeddedCoverInfo(embeddedCover);
     }
 
-    const auto trackFolder = trackFile.locationPath();
-    if (trackFolder != m_cachedFolder) {
-        m_cachedFolder = trackFile.locationPath();
+    if (!m_cachedPossibleCoversValid) {
         m_cachedPossibleCoversInFolder =
                 CoverArtUtils::findPossibleCoversInFolder(
                         m_cachedFolder);
+        m_cachedPossibleCoversValid = true;
     }
-    return CoverArtUtils::selectCoverArtForTrack(
+    const int coverIndex = CoverArtUtils::selectCoverFileForTrack(
             trackFile,
             albumName,
             m_cachedPossibleCoversInFolder);
+    if (coverIndex < 0) {
+        CoverInfoRelative coverInfo;
+        coverInfo.source = CoverInfo::GUESSED;
+        return coverInfo;
+    }
+    const QFileInfo& coverFile = m_cachedPossibleCoversInFolder.at(coverIndex);
+    const QString coverFilePath = coverFile.filePath();
+    auto it = m_cachedCoverFiles.constFind(coverFilePath);
+    if (it == m_cachedCoverFiles.constEnd()) {
+        it = m_cachedCoverFiles.insert(
+                coverFilePath,
+                CoverArtUtils::coverInfoFromFile(coverFile));
+    }
+    return it.value();
 }
 
 CoverInfoRelative CoverInfoGuesser::guessCoverInfoForTrack(
@@ -2,16 +2,16 @@
 
 #include <QFileInfo>
 #include <QFuture>
+#include <QHash>
 #include <QImage>
 #include <QList>
 #include <QSize>
 #include <QString>
 #include <QStringList>
 
+#include "library/coverart.h"
 #include "track/track_decl.h"
 
-class CoverInfoRelative;
-
 namespace mixxx {
 
 class FileInfo;
@@ -63,10 +63,28 @@ class CoverArtUtils {
             const mixxx::FileInfo& trackFile,
             const QString& albumName,
             const QList<QFileInfo>& covers);
+
+    // Returns the index of the preferred cover file within 'covers'
+    // or -1 if none of them is appropriate.
+    static int selectCoverFileForTrack(
+            const mixxx::FileInfo& trackFile,
+            const QString& albumName,
+            const QList<QFileInfo>& covers);
+
+    // Loads the image of the cover file. The type is NONE if the image
+    // could not be loaded.
+    static CoverInfoRelative coverInfoFromFile(
+            const QFileInfo& coverFile);
 };
 
 // Stateful guessing of cover art by caching the possible
 // covers from the last visited folder.
+//
+// The image files of the folder are only listed if a track without
+// an embedded cover needs them, and each of them is loaded at most
+// once for all tracks. Identical embedded covers, e.g. of the tracks
+// of an album, are recognized by a hash of their pixels and share
+// the digest and color of the first one.
 class CoverInfoGuesser {
   public:
     // Guesses the cover art for the provided track.
@@ -86,8 +104,22 @@ class CoverInfoGuesser {
             const TrackPointerList& tracks);
 
   private:
+    struct EmbeddedCover {
+        QImage image;
+        CoverInfoRelative coverInfo;
+    };
+
+    void visitFolder(const QString& folder);
+    CoverInfoRelative guessEmbeddedCoverInfo(
+            const QImage& embeddedCover);
+
     QString m_cachedFolder;
+    bool m_cachedPossibleCoversValid = false;
     QList<QFileInfo> m_cachedPossibleCoversInFolder;
+    // By the file path of the cover
+    QHash<QString, CoverInfoRelative> m_cachedCoverFiles;
+    // By the hash of the pixels
+    QHash<size_t, EmbeddedCover> m_cachedEmbeddedCovers;
 };
 
 // Guesses the cover art for the provided tracks by searching the tracks'
@@ -0,0 +1,209 @@
+#include "library/coverthumbnailpack.h"
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QtEndian>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverThumbnailPack");
+
+const QByteArray kMagic = QByteArrayLiteral("MXCT");
+
+constexpr quint32 kVersion = 1;
+
+constexpr qint64 kHeaderSize = 8;
+
+// cache key (8 bytes) + width (4 bytes) + size (4 bytes)
+constexpr qint64 kRecordHeaderSize = 16;
+
+// JPEG is much more compact than PNG, but doesn't support transparency
+constexpr int kJpegQuality = 90;
+
+QByteArray encodeImage(const QImage& image) {
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    if (image.hasAlphaChannel()) {
+        image.save(&buffer, "PNG");
+    } else {
+        image.save(&buffer, "JPG", kJpegQuality);
+    }
+    return data;
+}
+
+} // anonymous namespace
+
+CoverThumbnailPack::CoverThumbnailPack(
+        const QString& filePath,
+        qint64 maxFileSize)
+        : m_maxFileSize(maxFileSize),
+          m_file(filePath) {
+    const auto locked = lockMutex(&m_mutex);
+    if (!openWhileLocked()) {
+        kLogger.warning()
+                << "Failed to open"
+                << filePath
+                << m_file.errorString();
+        m_file.close();
+        m_index.clear();
+    }
+}
+
+CoverThumbnailPack::~CoverThumbnailPack() {
+    const auto locked = lockMutex(&m_mutex);
+    m_file.close();
+}
+
+bool CoverThumbnailPack::isOpen() const {
+    const auto locked = lockMutex(&m_mutex);
+    return m_file.isOpen();
+}
+
+bool CoverThumbnailPack::openWhileLocked() {
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    const qint64 fileSize = m_file.size();
+    if (fileSize < kHeaderSize || fileSize > m_maxFileSize) {
+        return resetWhileLocked();
+    }
+    const QByteArray header = m_file.read(kHeaderSize);
+    if (header.size() != kHeaderSize ||
+            !header.startsWith(kMagic) ||
+            qFromLittleEndian<quint32>(header.constData() + kMagic.size()) != kVersion) {
+        kLogger.info()
+                << "Discarding pack file with an unsupported format"
+                << m_file.fileName();
+        return resetWhileLocked();
+    }
+    qint64 offset = kHeaderSize;
+    while (offset + kRecordHeaderSize <= fileSize) {
+        const QByteArray recordHeader = m_file.read(kRecordHeaderSize);
+        if (recordHeader.size() != kRecordHeaderSize) {
+            break;
+        }
+        const auto cacheKey = qFromLittleEndian<quint64>(recordHeader.constData());
+        const auto width = qFromLittleEndian<qint32>(recordHeader.constData() + 8);
+        const auto size = qFromLittleEndian<quint32>(recordHeader.constData() + 12);
+        const qint64 dataOffset = offset + kRecordHeaderSize;
+        if (dataOffset + size > fileSize) {
+            break;
+        }
+        m_index.insert(Key(cacheKey, width), Entry{dataOffset, size});
+        offset = dataOffset + size;
+        if (!m_file.seek(offset)) {
+            return false;
+        }
+    }
+    if (offset < fileSize) {
+        // Drop an incomplete record at the end, e.g. after a crash
+        kLogger.info()
+                << "Discarding"
+                << fileSize - offset
+                << "bytes at the end of"
+                << m_file.fileName();
+        if (!m_file.resize(offset)) {
+            return false;
+        }
+    }
+    kLogger.debug()
+            << "Opened"
+            << m_file.fileName()
+            << "with"
+            << m_index.size()
+            << "thumbnails";
+    return true;
+}
+
+bool CoverThumbnailPack::resetWhileLocked() {
+    DEBUG_ASSERT(m_file.isOpen());
+    m_index.clear();
+    if (!m_file.resize(0) || !m_file.seek(0)) {
+        return false;
+    }
+    QByteArray header = kMagic;
+    header.resize(kHeaderSize);
+    qToLittleEndian<quint32>(kVersion, header.data() + kMagic.size());
+    return m_file.write(header) == kHeaderSize && m_file.flush();
+}
+
+QImage CoverThumbnailPack::load(
+        mixxx::cache_key_t cacheKey,
+        int width) const {
+    QByteArray data;
+    {
+        const auto locked = lockMutex(&m_mutex);
+        const auto it = m_index.constFind(Key(cacheKey, width));
+        if (it == m_index.constEnd()) {
+            return QImage();
+        }
+        if (!m_file.seek(it->offset)) {
+            return QImage();
+        }
+        data = m_file.read(it->size);
+        if (data.size() != static_cast<qint64>(it->size)) {
+            return QImage();
+        }
+    }
+    return QImage::fromData(data);
+}
+
+void CoverThumbnailPack::store(
+        mixxx::cache_key_t cacheKey,
+        int width,
+        const QImage& image) {
+    VERIFY_OR_DEBUG_ASSERT(!image.isNull()) {
+        return;
+    }
+    const QByteArray data = encodeImage(image);
+    if (data.isEmpty()) {
+        return;
+    }
+    QByteArray recordHeader(kRecordHeaderSize, '\0');
+    qToLittleEndian<quint64>(cacheKey, recordHeader.data());
+    qToLittleEndian<qint32>(width, recordHeader.data() + 8);
+    qToLittleEndian<quint32>(static_cast<quint32>(data.size()), recordHeader.data() + 12);
+
+    const auto locked = lockMutex(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    const Key key(cacheKey, width);
+    if (m_index.contains(key)) {
+        // Has been stored concurrently
+        return;
+    }
+    qint64 offset = m_file.size();
+    if (offset + kRecordHeaderSize + data.size() > m_maxFileSize) {
+        kLogger.info()
+                << "Discarding all thumbnails after reaching the maximum size of"
+                << m_file.fileName();
+        if (!resetWhileLocked()) {
+            m_file.close();
+            return;
+        }
+        offset = m_file.size();
+    }
+    if (!m_file.seek(offset) ||
+            m_file.write(recordHeader) != kRecordHeaderSize ||
+            m_file.write(data) != data.size() ||
+            !m_file.flush()) {
+        kLogger.warning()
+                << "Failed to write to"
+                << m_file.fileName()
+                << m_file.errorString();
+        // Drop the incomplete record
+        if (!m_file.resize(offset)) {
+            m_file.close();
+            m_index.clear();
+        }
+        return;
+    }
+    m_index.insert(key,
+            Entry{offset + kRecordHeaderSize, static_cast<quint32>(data.size())});
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+
+#include "util/cache.h"
+
+/// CoverThumbnailPack persists resized cover images across restarts, so
+/// the covers in the library table don't need to be decoded from the
+/// audio files or image files and resized again after each start.
+///
+/// All thumbnails are stored in a single pack file instead of one file per
+/// image. The file starts with a header followed by a sequence of records
+/// that are only appended. Each record consists of the cache key of the
+/// cover, the width of the thumbnail, the size of the encoded image and
+/// the encoded image. The index of all records is built when opening the
+/// file. The file is discarded and started from scratch when exceeding
+/// its maximum size.
+///
+/// All functions are thread-safe. Images are encoded and decoded without
+/// holding the lock.
+class CoverThumbnailPack final {
+  public:
+    CoverThumbnailPack(
+            const QString& filePath,
+            qint64 maxFileSize);
+    ~CoverThumbnailPack();
+
+    bool isOpen() const;
+
+    /// Returns a null image if no thumbnail with this width is stored.
+    QImage load(
+            mixxx::cache_key_t cacheKey,
+            int width) const;
+
+    void store(
+            mixxx::cache_key_t cacheKey,
+            int width,
+            const QImage& image);
+
+  private:
+    typedef QPair<mixxx::cache_key_t, int> Key;
+
+    struct Entry {
+        qint64 offset;
+        quint32 size;
+    };
+
+    bool openWhileLocked();
+    bool resetWhileLocked();
+
+    const qint64 m_maxFileSize;
+
+    mutable QMutex m_mutex;
+    mutable QFile m_file;
+    QHash<Key, Entry> m_index;
+};
@@ -5,10 +5,16 @@
 
 #include "library/queryutil.h"
 #include "preferences/waveformsettings.h"
+#include "util/assert.h"
 #include "util/performancetimer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformcache.h"
+#include "waveform/waveformthumbnailstore.h"
 
 const QString AnalysisDao::s_analysisTableName = "track_analysis";
+const QString AnalysisDao::s_analysisQueueTableName = "analysis_queue";
+const QString AnalysisDao::s_analyzerResultsTableName = "analyzer_results";
+const QString AnalysisDao::s_chromaprintsTableName = "track_chromaprints";
 
 // For a track that takes 1.2MB to store the big waveform, the default
 // compression level (-1) takes the size down to about 600KB. The difference
@@ -35,7 +41,7 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::getAnalysesForTrack(TrackId trackI
         "WHERE track_id=:trackId").arg(s_analysisTableName));
     query.bindValue(":trackId", trackId.toVariant());
 
-    return loadAnalysesFromQuery(trackId, &query);
+    return loadAnalysesFromQuery(trackId, &query, true);
 }
 
 QList<AnalysisDao::AnalysisInfo> AnalysisDao::getAnalysesForTrackByType(
@@ -51,10 +57,51 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::getAnalysesForTrackByType(
     query.bindValue(":trackId", trackId.toVariant());
     query.bindValue(":type", type);
 
-    return loadAnalysesFromQuery(trackId, &query);
+    return loadAnalysesFromQuery(trackId, &query, true);
 }
 
-QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query) {
+QList<AnalysisDao::AnalysisInfo> AnalysisDao::getAnalysisInfosForTrackByType(
+        TrackId trackId, AnalysisType type) {
+    if (!m_database.isOpen() || !trackId.isValid()) {
+        return QList<AnalysisInfo>();
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+        "SELECT id, type, description, version, data_checksum FROM %1 "
+        "WHERE track_id=:trackId AND type=:type").arg(s_analysisTableName));
+    query.bindValue(":trackId", trackId.toVariant());
+    query.bindValue(":type", type);
+
+    return loadAnalysesFromQuery(trackId, &query, false);
+}
+
+bool AnalysisDao::loadAnalysisData(AnalysisDao::AnalysisInfo* info) const {
+    VERIFY_OR_DEBUG_ASSERT(info != nullptr && info->analysisId != -1) {
+        return false;
+    }
+    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
+        QString::number(info->analysisId));
+    const QByteArray compressedData = loadDataFromFile(dataPath);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    const int file_checksum = qChecksum(
+            compressedData);
+#else
+    const int file_checksum = qChecksum(
+            compressedData.constData(),
+            compressedData.length());
+#endif
+    if (info->dataChecksum != file_checksum) {
+        qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
+                 << "length" << compressedData.length();
+        return false;
+    }
+    info->data = qUncompress(compressedData);
+    return true;
+}
+
+QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(
+        TrackId trackId, QSqlQuery* query, bool loadData) {
     QList<AnalysisDao::AnalysisInfo> analyses;
     PerformanceTimer time;
     time.start();
@@ -72,7 +119,6 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
     const int versionColumn = queryRecord.indexOf("version");
     const int dataChecksumColumn = queryRecord.indexOf("data_checksum");
 
-    QDir analysisPath(getAnalysisStoragePath());
     while (query->next()) {
         AnalysisDao::AnalysisInfo info;
         info.analysisId = query->value(idColumn).toInt();
@@ -80,24 +126,10 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         info.type = static_cast<AnalysisType>(query->value(typeColumn).toInt());
         info.description = query->value(descriptionColumn).toString();
         info.version = query->value(versionColumn).toString();
-        int checksum = query->value(dataChecksumColumn).toInt();
-        QString dataPath = analysisPath.absoluteFilePath(
-            QString::number(info.analysisId));
-        const QByteArray compressedData = loadDataFromFile(dataPath);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const int file_checksum = qChecksum(
-                compressedData);
-#else
-        const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
-#endif
-        if (checksum != file_checksum) {
-            qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
-                     << "length" << compressedData.length();
+        info.dataChecksum = query->value(dataChecksumColumn).toInt();
+        if (loadData && !loadAnalysisData(&info)) {
             continue;
         }
-        info.data = qUncompress(compressedData);
         bytes += info.data.length();
         analyses.append(info);
     }
@@ -128,6 +160,7 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
             compressedData.constData(),
             compressedData.length());
 #endif
+    info->dataChecksum = checksum;
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -208,6 +241,13 @@ void AnalysisDao::deleteAnalyses(const QList<TrackId>& trackIds) {
     QStringList idList;
     for (const auto& trackId: trackIds) {
         idList << trackId.toString();
+        WaveformCache::instance().remove(trackId);
+    }
+    const auto pThumbnailStore = WaveformThumbnailStore::instance();
+    if (pThumbnailStore) {
+        for (const auto& trackId : trackIds) {
+            pThumbnailStore->remove(trackId);
+        }
     }
     QSqlQuery query(m_database);
     query.prepare(QString("SELECT track_analysis.id FROM track_analysis WHERE "
@@ -227,12 +267,27 @@ void AnalysisDao::deleteAnalyses(const QList<TrackId>& trackIds) {
     if (!query.exec()) {
         LOG_FAILED_QUERY(query) << "couldn't delete analysis";
     }
+    query.prepare(QString("DELETE FROM %1 WHERE track_id in (%2)")
+                          .arg(s_analyzerResultsTableName, idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't delete analyzer results";
+    }
+    query.prepare(QString("DELETE FROM %1 WHERE track_id in (%2)")
+                          .arg(s_chromaprintsTableName, idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't delete chromaprints";
+    }
 }
 
 bool AnalysisDao::deleteAnalysesForTrack(TrackId trackId) {
     if (!trackId.isValid()) {
         return false;
     }
+    WaveformCache::instance().remove(trackId);
+    const auto pThumbnailStore = WaveformThumbnailStore::instance();
+    if (pThumbnailStore) {
+        pThumbnailStore->remove(trackId);
+    }
     QSqlQuery query(m_database);
     query.prepare(QString(
         "SELECT id FROM %1 where track_id = :track_id").arg(s_analysisTableName));
@@ -318,16 +373,40 @@ void AnalysisDao::saveTrackAnalyses(
         TrackId trackId,
         ConstWaveformPointer pWaveform,
         ConstWaveformPointer pWaveSummary) {
-    // The only analyses we have at the moment are waveform analyses so we have
-    // nothing to do if it is disabled.
-    WaveformSettings waveformSettings(m_pConfig);
-    if (!waveformSettings.waveformCachingEnabled()) {
+    if (!tryBeginSaveTrackAnalyses(pWaveform, pWaveSummary)) {
         return;
     }
+    saveClaimedTrackAnalyses(trackId, pWaveform, pWaveSummary);
+}
 
+// static
+bool AnalysisDao::tryBeginSaveTrackAnalyses(
+        const ConstWaveformPointer& pWaveform,
+        const ConstWaveformPointer& pWaveSummary) {
     // Don't try to save invalid or non-dirty waveforms.
-    if (!pWaveform || pWaveform->saveState() != Waveform::SaveState::SavePending ||
-        !pWaveSummary || pWaveSummary->saveState() != Waveform::SaveState::SavePending) {
+    if (!pWaveform || !pWaveSummary) {
+        return false;
+    }
+    if (!pWaveform->tryBeginSave()) {
+        return false;
+    }
+    if (!pWaveSummary->tryBeginSave()) {
+        pWaveform->finishSave(false);
+        return false;
+    }
+    return true;
+}
+
+void AnalysisDao::saveClaimedTrackAnalyses(
+        TrackId trackId,
+        const ConstWaveformPointer& pWaveform,
+        const ConstWaveformPointer& pWaveSummary) {
+    // The only analyses we have at the moment are waveform analyses so we have
+    // nothing to do if it is disabled.
+    WaveformSettings waveformSettings(m_pConfig);
+    if (!waveformSettings.waveformCachingEnabled()) {
+        pWaveform->finishSave(false);
+        pWaveSummary->finishSave(false);
         return;
     }
 
@@ -341,9 +420,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.version = pWaveform->getVersion();
     analysis.data = pWaveform->toByteArray();
     bool success = saveAnalysis(&analysis);
-    if (success) {
-        pWaveform->setSaveState(Waveform::SaveState::Saved);
-    }
+    pWaveform->finishSave(success);
 
     qDebug() << (success ? "Saved" : "Failed to save")
                  << "waveform analysis for trackId" << trackId
@@ -357,9 +434,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.data = pWaveSummary->toByteArray();
 
     success = saveAnalysis(&analysis);
-    if (success) {
-        pWaveSummary->setSaveState(Waveform::SaveState::Saved);
-    }
+    pWaveSummary->finishSave(success);
     qDebug() << (success ? "Saved" : "Failed to save")
              << "waveform summary analysis for trackId" << trackId
              << "analysisId" << analysis.analysisId;
@@ -368,6 +443,15 @@ void AnalysisDao::saveTrackAnalyses(
 size_t AnalysisDao::getDiskUsageInBytes(
         const QSqlDatabase& database,
         AnalysisType type) const {
+    if (type == TYPE_WAVEFORM) {
+        WaveformCache::instance().removeAll(WaveformCache::Type::Waveform);
+    } else if (type == TYPE_WAVESUMMARY) {
+        WaveformCache::instance().removeAll(WaveformCache::Type::Summary);
+        const auto pThumbnailStore = WaveformThumbnailStore::instance();
+        if (pThumbnailStore) {
+            pThumbnailStore->clear();
+        }
+    }
     QDir analysisPath(getAnalysisStoragePath());
 
     QSqlQuery query(database);
@@ -415,3 +499,183 @@ bool AnalysisDao::deleteAnalysesByType(
 
     return true;
 }
+
+bool AnalysisDao::enqueueTracksForAnalysis(const QList<AnalyzerScheduledTrack>& tracks) {
+    if (tracks.isEmpty()) {
+        return true;
+    }
+    ScopedTransaction transaction(m_database);
+    QSqlQuery query(m_database);
+    // Tracks that are already queued keep their position
+    query.prepare(QString(
+            "INSERT OR IGNORE INTO %1 (track_id, use_fixed_tempo) "
+            "VALUES (:track_id, :use_fixed_tempo)").arg(s_analysisQueueTableName));
+    for (const auto& track : tracks) {
+        const auto& useFixedTempo = track.getOptions().useFixedTempo;
+        query.bindValue(":track_id", track.getTrackId().toVariant());
+        query.bindValue(":use_fixed_tempo",
+                useFixedTempo ? QVariant(*useFixedTempo) : QVariant());
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query) << "couldn't enqueue track for analysis"
+                                    << track.getTrackId();
+            return false;
+        }
+    }
+    return transaction.commit();
+}
+
+bool AnalysisDao::dequeueTrackFromAnalysis(TrackId trackId) {
+    if (!trackId.isValid()) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "DELETE FROM %1 WHERE track_id=:track_id").arg(s_analysisQueueTableName));
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't dequeue track from analysis" << trackId;
+        return false;
+    }
+    return true;
+}
+
+QList<AnalyzerScheduledTrack> AnalysisDao::getQueuedTracksForAnalysis() {
+    QList<AnalyzerScheduledTrack> tracks;
+    if (!m_database.isOpen()) {
+        return tracks;
+    }
+
+    // Tracks that have been purged from the library in the meantime
+    // would otherwise stay in the queue forever.
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "DELETE FROM %1 WHERE track_id NOT IN "
+            "(SELECT id FROM library)").arg(s_analysisQueueTableName));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't remove deleted tracks from analysis queue";
+    }
+
+    query.prepare(QString(
+            "SELECT track_id, use_fixed_tempo FROM %1 ORDER BY id").arg(s_analysisQueueTableName));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get analysis queue";
+        return tracks;
+    }
+    const int trackIdColumn = query.record().indexOf("track_id");
+    const int useFixedTempoColumn = query.record().indexOf("use_fixed_tempo");
+    while (query.next()) {
+        AnalyzerTrack::Options options;
+        const QVariant useFixedTempo = query.value(useFixedTempoColumn);
+        if (!useFixedTempo.isNull()) {
+            options.useFixedTempo = useFixedTempo.toBool();
+        }
+        tracks.append(AnalyzerScheduledTrack(
+                TrackId(query.value(trackIdColumn)), options));
+    }
+    return tracks;
+}
+
+bool AnalysisDao::clearAnalysisQueue() {
+    QSqlQuery query(m_database);
+    query.prepare(QString("DELETE FROM %1").arg(s_analysisQueueTableName));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't clear analysis queue";
+        return false;
+    }
+    return true;
+}
+
+QHash<QString, AnalysisDao::AnalyzerResultInfo> AnalysisDao::getAnalyzerResults(
+        TrackId trackId) {
+    QHash<QString, AnalyzerResultInfo> results;
+    if (!trackId.isValid() || !m_database.isOpen()) {
+        return results;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "SELECT analyzer, version, fingerprint FROM %1 "
+            "WHERE track_id=:track_id").arg(s_analyzerResultsTableName));
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get analyzer results" << trackId;
+        return results;
+    }
+    const int analyzerColumn = query.record().indexOf("analyzer");
+    const int versionColumn = query.record().indexOf("version");
+    const int fingerprintColumn = query.record().indexOf("fingerprint");
+    while (query.next()) {
+        AnalyzerResultInfo result;
+        result.version = query.value(versionColumn).toString();
+        result.fingerprint = query.value(fingerprintColumn).toString();
+        results.insert(query.value(analyzerColumn).toString(), result);
+    }
+    return results;
+}
+
+bool AnalysisDao::saveAnalyzerResult(
+        TrackId trackId,
+        const QString& analyzer,
+        const AnalyzerResultInfo& result) {
+    if (!trackId.isValid()) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "INSERT OR REPLACE INTO %1 (track_id, analyzer, version, fingerprint) "
+            "VALUES (:track_id, :analyzer, :version, :fingerprint)")
+                    .arg(s_analyzerResultsTableName));
+    query.bindValue(":track_id", trackId.toVariant());
+    query.bindValue(":analyzer", analyzer);
+    query.bindValue(":version", result.version);
+    query.bindValue(":fingerprint", result.fingerprint);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't save analyzer result" << trackId << analyzer;
+        return false;
+    }
+    return true;
+}
+
+AnalysisDao::ChromaprintInfo AnalysisDao::getChromaprint(TrackId trackId) {
+    ChromaprintInfo chromaprint;
+    if (!trackId.isValid() || !m_database.isOpen()) {
+        return chromaprint;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "SELECT fingerprint, duration, file_signature FROM %1 "
+            "WHERE track_id=:track_id").arg(s_chromaprintsTableName));
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get chromaprint" << trackId;
+        return chromaprint;
+    }
+    if (query.next()) {
+        const QSqlRecord record = query.record();
+        chromaprint.fingerprint = query.value(record.indexOf("fingerprint")).toString();
+        chromaprint.duration = query.value(record.indexOf("duration")).toInt();
+        chromaprint.fileSignature = query.value(record.indexOf("file_signature")).toString();
+    }
+    return chromaprint;
+}
+
+bool AnalysisDao::saveChromaprint(
+        TrackId trackId,
+        const ChromaprintInfo& chromaprint) {
+    if (!trackId.isValid() || chromaprint.fingerprint.isEmpty()) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "INSERT OR REPLACE INTO %1 (track_id, fingerprint, duration, file_signature) "
+            "VALUES (:track_id, :fingerprint, :duration, :file_signature)")
+                    .arg(s_chromaprintsTableName));
+    query.bindValue(":track_id", trackId.toVariant());
+    query.bindValue(":fingerprint", chromaprint.fingerprint);
+    query.bindValue(":duration", chromaprint.duration);
+    query.bindValue(":file_signature", chromaprint.fileSignature);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't save chromaprint" << trackId;
+        return false;
+    }
+    return true;
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <QDir>
+#include <QHash>
 
+#include "analyzer/analyzerscheduledtrack.h"
 #include "preferences/usersettings.h"
 #include "library/dao/dao.h"
 #include "track/trackid.h"
@@ -12,6 +14,9 @@ class QSqlDatabase;
 class AnalysisDao : public DAO {
   public:
     static const QString s_analysisTableName;
+    static const QString s_analysisQueueTableName;
+    static const QString s_analyzerResultsTableName;
+    static const QString s_chromaprintsTableName;
 
     enum AnalysisType {
         TYPE_UNKNOWN = 0,
@@ -22,16 +27,36 @@ class AnalysisDao : public DAO {
     struct AnalysisInfo {
         AnalysisInfo()
                 : analysisId(-1),
-                  type(TYPE_UNKNOWN) {
+                  type(TYPE_UNKNOWN),
+                  dataChecksum(0) {
         }
         int analysisId;
         TrackId trackId;
         AnalysisType type;
         QString description;
         QString version;
+        // The checksum of the compressed data file
+        int dataChecksum;
         QByteArray data;
     };
 
+    // The version of the results of an analyzer together with a
+    // fingerprint of the decoded signal they have been computed from,
+    // see Analyzer::resultName().
+    struct AnalyzerResultInfo {
+        QString version;
+        QString fingerprint;
+    };
+
+    // The Chromaprint fingerprint of the beginning of a track for AcoustID
+    // lookups. It stays valid as long as the file has not been modified,
+    // see BatchTagFetcher::fileSignature().
+    struct ChromaprintInfo {
+        QString fingerprint;
+        int duration = 0;
+        QString fileSignature;
+    };
+
     explicit AnalysisDao(UserSettingsPointer pConfig);
     ~AnalysisDao() override = default;
 
@@ -47,6 +72,11 @@ class AnalysisDao : public DAO {
 
     QList<AnalysisInfo> getAnalysesForTrackByType(TrackId trackId, AnalysisType type);
     QList<AnalysisInfo> getAnalysesForTrack(TrackId trackId);
+    // Only loads the metadata of the analyses without reading their data
+    // files. The data could be loaded later by loadAnalysisData(), which
+    // doesn't access the database and may be invoked from any thread.
+    QList<AnalysisInfo> getAnalysisInfosForTrackByType(TrackId trackId, AnalysisType type);
+    bool loadAnalysisData(AnalysisInfo* analysis) const;
     bool saveAnalysis(AnalysisInfo* analysis);
     bool deleteAnalysis(const int analysisId);
     void deleteAnalyses(const QList<TrackId>& trackIds);
@@ -56,13 +86,44 @@ class AnalysisDao : public DAO {
             TrackId trackId,
             ConstWaveformPointer pWaveform,
             ConstWaveformPointer pWaveSummary);
+    /// Claims both pending waveforms for saving, see Waveform::tryBeginSave().
+    /// Returns false if they are not pending or claimed by another thread.
+    static bool tryBeginSaveTrackAnalyses(
+            const ConstWaveformPointer& pWaveform,
+            const ConstWaveformPointer& pWaveSummary);
+    /// Saves the waveforms claimed by tryBeginSaveTrackAnalyses()
+    void saveClaimedTrackAnalyses(
+            TrackId trackId,
+            const ConstWaveformPointer& pWaveform,
+            const ConstWaveformPointer& pWaveSummary);
+
+    // The queue of a batch analysis is persisted, so an interrupted
+    // analysis can be resumed after a restart. Tracks are removed one by
+    // one when they have been analyzed.
+    bool enqueueTracksForAnalysis(const QList<AnalyzerScheduledTrack>& tracks);
+    bool dequeueTrackFromAnalysis(TrackId trackId);
+    // Returns the queued tracks in the order they have been enqueued
+    QList<AnalyzerScheduledTrack> getQueuedTracksForAnalysis();
+    bool clearAnalysisQueue();
+
+    // Returns the recorded analyzer results of a track by analyzer name
+    QHash<QString, AnalyzerResultInfo> getAnalyzerResults(TrackId trackId);
+    bool saveAnalyzerResult(
+            TrackId trackId,
+            const QString& analyzer,
+            const AnalyzerResultInfo& result);
+
+    // Returns an empty fingerprint if none has been stored for the track
+    ChromaprintInfo getChromaprint(TrackId trackId);
+    bool saveChromaprint(TrackId trackId, const ChromaprintInfo& chromaprint);
 
   private:
     QDir getAnalysisStoragePath() const;
     QByteArray loadDataFromFile(const QString& fileName) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
-    QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
+    QList<AnalysisInfo> loadAnalysesFromQuery(
+            TrackId trackId, QSqlQuery* query, bool loadData);
 
     const UserSettingsPointer m_pConfig;
 };
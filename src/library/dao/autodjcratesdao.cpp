@@ -2,6 +2,8 @@
 
 #include <QRandomGenerator>
 #include <QtDebug>
+#include <utility>
+#include <vector>
 
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
@@ -34,10 +36,6 @@
 // INTEGER AUTODJCRATESTABLE_AUTODJREFS -> counts the occurrences of the track in the AutoDj queue
 // DATETIME AUTODJCRATESTABLE_LASTPLAYED -> from the history feature
 
-#define AUTODJACTIVETRACKS_TABLE "temp_autodj_activetracks"
-// The same table like above, but of all tracks that not already queued into Auto DJ
-// ordered by TimesPlayed.
-
 namespace {
 // Percentage of most and least played tracks to ignore [0,50)
 constexpr int kLeastPreferredPercent = 15;
@@ -77,36 +75,10 @@ AutoDJCratesDAO::~AutoDJCratesDAO() {
 // use of this feature.
 void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
     // If the use of tracks that haven't been played in a while has changed,
-    // then the active-tracks view must be recreated.
-    bool bUseIgnoreTime = m_pConfig->getValue(
+    // then the active tracks must be sorted differently.
+    m_bUseIgnoreTime = m_pConfig->getValue(
             ConfigKey("[Auto DJ]", "UseIgnoreTime"), false);
-    if (m_bAutoDjCratesDbCreated) {
-        if (m_bUseIgnoreTime != bUseIgnoreTime) {
-            // Do all this in a single transaction.
-            ScopedTransaction oTransaction(m_database);
-
-            // Get rid of the old active-tracks view.
-            QSqlQuery oQuery(m_database);
-            oQuery.exec ("DROP VIEW IF EXISTS " AUTODJACTIVETRACKS_TABLE);
-            if (!oQuery.exec()) {
-                LOG_FAILED_QUERY(oQuery);
-                return;
-            }
-
-            // Create the new active-tracks view.
-            if (!createActiveTracksView(bUseIgnoreTime)) {
-                return;
-            }
-
-            // Remember the new setting.
-            m_bUseIgnoreTime = bUseIgnoreTime;
-
-            // Commit these changes.
-            oTransaction.commit();
-        }
-    } else {
-        m_bUseIgnoreTime = bUseIgnoreTime;
-    }
+    m_index.setOrderByLastPlayed(m_bUseIgnoreTime);
 
     // If this database has already been created, skip this.
     if (m_bAutoDjCratesDbCreated) {
@@ -186,12 +158,6 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
         return;
     }
 
-    // Create the active-tracks view.
-    //oQuery.exec ("DROP VIEW IF EXISTS " AUTODJACTIVETRACKS_TABLE);
-    if (!createActiveTracksView (m_bUseIgnoreTime)) {
-        return;
-    }
-
     // Make a list of the IDs of every set-log playlist.
     // SELECT id FROM Playlists WHERE hidden = 2;
     oQuery.prepare(QString("SELECT %1 FROM " PLAYLIST_TABLE " WHERE %2 = %3")
@@ -212,6 +178,8 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
     // signals.
     oTransaction.commit();
 
+    reloadIndex();
+
     // Be notified when a track is modified.
     // We only care when the number of times it's been played changes.
     connect(m_pTrackCollectionManager->internalCollection(),
@@ -271,58 +239,54 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
     m_bAutoDjCratesDbCreated = true;
 }
 
-// Create the active-tracks view.
-bool AutoDJCratesDAO::createActiveTracksView (bool a_bUseIgnoreTime) {
-    // Create the active-tracks view.  This is a list of all tracks loaded into
-    // the auto-DJ-crates database, excluding all tracks already in the auto-DJ
-    // playlist, sorted by the number of times the track has been played, and
-    // limited by either the active percentage or by the number of tracks that
-    // have never been played, whichever is larger.
-    //
-    // At one point, I hoped that I could create this table in a single SQL
-    // statement, with a "limit" clause that dynamically updated the size of the
-    // view as the state of the system changed.  Unfortunately, that limit
-    // clause is only evaluated once.  For posterity, though, here's the monster
-    // SQL query that attempted to create that version:
-    //
-    // CREATE TEMP VIEW temp_autodj_activetracks AS
-    //     SELECT * FROM temp_autodj_crates
-    //     WHERE autodjrefs = 0
-    //     ORDER BY timesplayed, lastplayed LIMIT (
-    //         SELECT MAX(count)
-    //         FROM (
-    //             SELECT COUNT(*) AS count
-    //             FROM temp_autodj_crates WHERE timesplayed = 0
-    //             UNION ALL SELECT (
-    //                 count * (
-    //                     SELECT value
-    //                     FROM settings WHERE
-    //                     name="mixxx.db.model.autodjcrates.active_percentage")
-    //                 / 100) AS count
-    //                 FROM (
-    //                     SELECT COUNT(*) AS count
-    //                     FROM temp_autodj_crates)));
-
-    // CREATE TEMP VIEW temp_autodj_activetracks AS
-    // SELECT *
-    // FROM temp_autodj_crates
-    // WHERE autodjrefs = 0
-    // ORDER BY timesplayed, lastplayed;
+void AutoDJCratesDAO::reloadIndex() {
+    // SELECT track_id, timesplayed, lastplayed, autodjrefs
+    // FROM temp_autodj_crates;
     QSqlQuery oQuery(m_database);
-    QString strTimesPlayed;
-    if (!a_bUseIgnoreTime) {
-        strTimesPlayed = AUTODJCRATESTABLE_TIMESPLAYED ", ";
+    oQuery.setForwardOnly(true);
+    oQuery.prepare("SELECT " AUTODJCRATESTABLE_TRACKID ", "
+            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_LASTPLAYED ", "
+            AUTODJCRATESTABLE_AUTODJREFS " FROM " AUTODJCRATES_TABLE);
+    if (!oQuery.exec()) {
+        LOG_FAILED_QUERY(oQuery);
+        m_index.clear();
+        return;
     }
-    oQuery.prepare(QString("CREATE TEMP VIEW " AUTODJACTIVETRACKS_TABLE
-            " AS SELECT * FROM " AUTODJCRATES_TABLE " WHERE "
-            AUTODJCRATESTABLE_AUTODJREFS " = 0 ORDER BY %1"
-            AUTODJCRATESTABLE_LASTPLAYED)
-            .arg(strTimesPlayed)); // %1
+    std::vector<AutoDJCratesIndex::Entry> entries;
+    while (oQuery.next()) {
+        entries.push_back(AutoDJCratesIndex::Entry{
+                TrackId(oQuery.value(0)),
+                oQuery.value(1).toInt(),
+                oQuery.value(2).toString(),
+                oQuery.value(3).toInt()});
+    }
+    m_index.reset(entries);
+}
+
+void AutoDJCratesDAO::reloadIndexForTrack(TrackId trackId) {
+    // SELECT timesplayed, lastplayed, autodjrefs
+    // FROM temp_autodj_crates WHERE track_id = :track_id;
+    QSqlQuery oQuery(m_database);
+    oQuery.prepare("SELECT " AUTODJCRATESTABLE_TIMESPLAYED ", "
+            AUTODJCRATESTABLE_LASTPLAYED ", " AUTODJCRATESTABLE_AUTODJREFS
+            " FROM " AUTODJCRATES_TABLE " WHERE " AUTODJCRATESTABLE_TRACKID
+            " = :track_id");
+    oQuery.bindValue(":track_id", trackId.toVariant());
     if (!oQuery.exec()) {
         LOG_FAILED_QUERY(oQuery);
-        return false;
+        m_index.remove(trackId);
+        return;
     }
-    return true;
+    if (!oQuery.next()) {
+        // No longer in any auto-DJ crate
+        m_index.remove(trackId);
+        return;
+    }
+    m_index.insert(AutoDJCratesIndex::Entry{
+            trackId,
+            oQuery.value(0).toInt(),
+            oQuery.value(1).toString(),
+            oQuery.value(2).toInt()});
 }
 
 // Update the number of auto-DJ-playlist references to each track in the
@@ -551,31 +515,10 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
     // If necessary, create the temporary auto-DJ-crates database.
     createAndConnectAutoDjCratesDatabase();
 
-    // Calculate the number of active-tracks that have never been played, and
-    // the total number of active-tracks.
-    QSqlQuery oQuery(m_database);
-    // SELECT COUNT(*) AS count
-    // FROM temp_autodj_activetracks
-    // WHERE timesplayed = 0
-    // UNION ALL SELECT COUNT(*) AS count
-    // FROM temp_autodj_activetracks;
-    oQuery.prepare("SELECT COUNT(*) AS count FROM " AUTODJACTIVETRACKS_TABLE
-        " WHERE " AUTODJCRATESTABLE_TIMESPLAYED
-        " = 0 UNION ALL SELECT COUNT(*) AS count FROM "
-        AUTODJACTIVETRACKS_TABLE);
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        DEBUG_ASSERT(!"failed query");
-        return TrackId();
-    }
-    int iUnplayedTracks = 0;
-    int iTotalTracks = 0;
-    if (oQuery.next()) {
-        iUnplayedTracks = oQuery.value(0).toInt();
-        if (oQuery.next()) {
-            iTotalTracks = oQuery.value(0).toInt();
-        }
-    }
+    // The number of active-tracks that have never been played, and the
+    // total number of active-tracks.
+    const int iUnplayedTracks = m_index.unplayedActiveCount();
+    const int iTotalTracks = m_index.activeCount();
 
     // Get the active percentage (default 20%).
     int minimumAvailablePercentage = m_pConfig->getValue(
@@ -615,19 +558,7 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
         QString strDateTime = timeCurrent.toString("yyyy-MM-dd hh:mm:ss");
 
         // Count the number of tracks that haven't been played since this time.
-        // SELECT COUNT(*) FROM temp_autodj_activetracks WHERE lastplayed < :lastplayed;
-        int iIgnoreTimeTracks = 0;
-        oQuery.prepare("SELECT COUNT(*) FROM " AUTODJACTIVETRACKS_TABLE
-            " WHERE " AUTODJCRATESTABLE_LASTPLAYED " < :lastplayed");
-        oQuery.bindValue (":lastplayed", strDateTime);
-        if (oQuery.exec()) {
-            if (oQuery.next()) {
-                iIgnoreTimeTracks = oQuery.value(0).toInt();
-            }
-        } else {
-            LOG_FAILED_QUERY(oQuery);
-            return TrackId();
-        }
+        const int iIgnoreTimeTracks = m_index.activeCountPlayedBefore(strDateTime);
 
         // Allow that to be a new maximum.
         iActiveTracks = qMax(iActiveTracks, iIgnoreTimeTracks);
@@ -641,25 +572,8 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
         return TrackId();
     }
 
-    // Pick a random track.
-    // SELECT track_id
-    // FROM temp_autodj_activetracks LIMIT 1 OFFSET ABS (RANDOM() % :active);
-    oQuery.prepare("SELECT " AUTODJCRATESTABLE_TRACKID " FROM "
-        AUTODJACTIVETRACKS_TABLE " LIMIT 1 OFFSET ABS (RANDOM() % :active)");
-    oQuery.bindValue (":active", iActiveTracks);
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        DEBUG_ASSERT(!"failed query");
-        return TrackId();
-    }
-    if (oQuery.next()) {
-        // Give our caller the randomly-selected track.
-        return TrackId(oQuery.value(0));
-    } else {
-        DEBUG_ASSERT(false); // We should have exit earlier
-        qDebug() << "No random track available for Auto DJ";
-        return TrackId();
-    }
+    // Pick a random track among the first active-tracks.
+    return m_index.activeTrackAt(bounded_rand(iActiveTracks));
 }
 
 TrackId AutoDJCratesDAO::getRandomTrackIdFromAutoDj(int percentActive) {
@@ -764,6 +678,9 @@ void AutoDJCratesDAO::slotTrackDirty(TrackId trackId) {
         LOG_FAILED_QUERY(oQuery);
         return;
     }
+    if (oQuery.numRowsAffected() > 0) {
+        m_index.setTimesPlayed(trackId, playCounter.getTimesPlayed());
+    }
 }
 
 void AutoDJCratesDAO::slotCrateInserted(CrateId crateId) {
@@ -880,6 +797,8 @@ void AutoDJCratesDAO::updateAutoDjCrate(CrateId crateId) {
 
     // The transaction was successful.
     oTransaction.commit();
+
+    reloadIndex();
 }
 
 void AutoDJCratesDAO::deleteAutoDjCrate(CrateId crateId) {
@@ -917,6 +836,10 @@ void AutoDJCratesDAO::deleteAutoDjCrate(CrateId crateId) {
 
     // The transaction was successful.
     oTransaction.commit();
+
+    if (oQuery.numRowsAffected() > 0) {
+        reloadIndex();
+    }
 }
 
 void AutoDJCratesDAO::slotCrateTracksChanged(
@@ -933,6 +856,9 @@ void AutoDJCratesDAO::slotCrateTracksChanged(
 
     ScopedTransaction oTransaction(m_database);
     QSqlQuery oQuery(m_database);
+    // The tracks that have entered or left the auto-DJ-crates table
+    QList<TrackId> insertedTrackIds;
+    QList<TrackId> deletedTrackIds;
     for (const auto& trackId: addedTrackIds) {
         // Add a crate-reference to this track, if it's already in the
         // auto-DJ-crates table (in which case, we're done).
@@ -987,6 +913,7 @@ void AutoDJCratesDAO::slotCrateTracksChanged(
         if (!updateLastPlayedDateTimeForTrack(trackId)) {
             return; // failure
         }
+        insertedTrackIds.append(trackId);
     }
     for (const auto& trackId: removedTrackIds) {
         // UPDATE temp_autodj_crates SET craterefs = craterefs - 1 WHERE track_id = :track_id;
@@ -1009,9 +936,19 @@ void AutoDJCratesDAO::slotCrateTracksChanged(
             LOG_FAILED_QUERY(oQuery);
             return;
         }
+        if (oQuery.numRowsAffected() > 0) {
+            deletedTrackIds.append(trackId);
+        }
     }
     // The transaction was successful.
     oTransaction.commit();
+
+    for (const auto& trackId : std::as_const(insertedTrackIds)) {
+        reloadIndexForTrack(trackId);
+    }
+    for (const auto& trackId : std::as_const(deletedTrackIds)) {
+        m_index.remove(trackId);
+    }
 }
 
 // Signaled by the playlistDAO when a playlist is added.
@@ -1021,7 +958,9 @@ void AutoDJCratesDAO::slotPlaylistAdded(int playlistId) {
                     ->getPlaylistDAO()
                     .getHiddenType(playlistId) == PlaylistDAO::PLHT_SET_LOG) {
         m_lstSetLogPlaylistIds.append(playlistId);
-        updateLastPlayedDateTime();
+        if (updateLastPlayedDateTime()) {
+            reloadIndex();
+        }
     }
 }
 
@@ -1031,7 +970,9 @@ void AutoDJCratesDAO::slotPlaylistDeleted(int playlistId) {
     int iIndex = m_lstSetLogPlaylistIds.indexOf(playlistId);
     if (iIndex >= 0) {
         m_lstSetLogPlaylistIds.removeAt(iIndex);
-        updateLastPlayedDateTime();
+        if (updateLastPlayedDateTime()) {
+            reloadIndex();
+        }
     }
 }
 
@@ -1051,12 +992,15 @@ void AutoDJCratesDAO::slotPlaylistTrackAdded(int playlistId, TrackId trackId,
             LOG_FAILED_QUERY(oQuery);
             return;
         }
+        m_index.addAutoDjRefs(trackId, 1);
     } else if (m_lstSetLogPlaylistIds.contains(playlistId)) {
         // Deal with changes to set-log playlists.
         // If this query doesn't succeed, it'll log a message.
         // Do nothing special otherwise -- any change it makes can be part of
         // any current transaction.
-        updateLastPlayedDateTimeForTrack(trackId);
+        if (m_index.contains(trackId) && updateLastPlayedDateTimeForTrack(trackId)) {
+            reloadIndexForTrack(trackId);
+        }
     }
 }
 
@@ -1076,12 +1020,15 @@ void AutoDJCratesDAO::slotPlaylistTrackRemoved(int playlistId,
             LOG_FAILED_QUERY(oQuery);
             return;
         }
+        m_index.addAutoDjRefs(trackId, -1);
     } else if (m_lstSetLogPlaylistIds.contains(playlistId)) {
         // Deal with changes to set-log playlists.
         // If this query doesn't succeed, it'll log a message.
         // Do nothing special otherwise -- any change it makes can be part of
         // any current transaction.
-        updateLastPlayedDateTimeForTrack(trackId);
+        if (m_index.contains(trackId) && updateLastPlayedDateTimeForTrack(trackId)) {
+            reloadIndexForTrack(trackId);
+        }
     }
 }
 
@@ -1118,6 +1065,7 @@ void AutoDJCratesDAO::playerInfoTrackLoaded(const QString& group,
                 LOG_FAILED_QUERY(oQuery);
                 return;
             }
+            m_index.addAutoDjRefs(trackId, 1);
             return;
         }
     }
@@ -1146,6 +1094,7 @@ void AutoDJCratesDAO::playerInfoTrackUnloaded(const QString& group,
                 LOG_FAILED_QUERY(oQuery);
                 return;
             }
+            m_index.addAutoDjRefs(trackId, -1);
             return;
         }
     }
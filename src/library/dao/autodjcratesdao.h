@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QSqlDatabase>
 
+#include "library/autodj/autodjcratesindex.h"
 #include "library/trackset/crate/crateid.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -36,8 +37,13 @@ class AutoDJCratesDAO : public QObject {
     // use of this feature.
     void createAndConnectAutoDjCratesDatabase();
 
-    // Create the active-tracks view.
-    bool createActiveTracksView(bool a_bUseIgnoreTime);
+    // Reload the index of the active tracks from the auto-DJ-crates
+    // database, e.g. after updating many tracks.
+    void reloadIndex();
+
+    // Reload the given track into the index of the active tracks after
+    // updating it in the auto-DJ-crates database.
+    void reloadIndexForTrack(TrackId trackId);
 
     // Update the number of auto-DJ-playlist references to each track in the
     // auto-DJ-crates database.  Returns true if successful.
@@ -119,4 +125,8 @@ class AutoDJCratesDAO : public QObject {
 
     // The ID of every set-log playlist.
     QList<int> m_lstSetLogPlaylistIds;
+
+    // The tracks of the auto-DJ-crates database from which random tracks
+    // are selected.
+    AutoDJCratesIndex m_index;
 };
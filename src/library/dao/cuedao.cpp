@@ -2,6 +2,7 @@
 
 #include <QVariant>
 #include <QtDebug>
+#include <algorithm>
 
 #include "engine/engine.h"
 #include "library/queryutil.h"
@@ -10,10 +11,20 @@
 #include "util/db/fwdsqlquery.h"
 #include "util/logger.h"
 
+// The columns of a cue row, except for the id
+#define CUE_COLUMNS "track_id,type,position,length,hotcue,label,color"
+
 namespace {
 
 const mixxx::Logger kLogger = mixxx::Logger("CueDAO");
 
+constexpr int kNumCueColumns = 7;
+
+// SQLite allows up to 999 bound values per statement in older versions
+constexpr int kMaxRowsPerQuery = 999 / (kNumCueColumns + 1);
+// Ids are inlined into the statement
+constexpr int kMaxIdsPerQuery = 500;
+
 /// Wrap a `QString` label in a `QVariant`. The label column is not nullable,
 /// so this function also makes sure that the label an empty string, not null.
 inline const QVariant labelToQVariant(const QString& label) {
@@ -71,13 +82,56 @@ CuePointer cueFromRow(const QSqlRecord& row) {
     return pCue;
 }
 
+/// The values of a cue row in the order of CUE_COLUMNS
+QVariantList cueToRow(TrackId trackId, const Cue& cue) {
+    return QVariantList{
+            trackId.toVariant(),
+            static_cast<int>(cue.getType()),
+            cue.getPosition().toEngineSamplePosMaybeInvalid(),
+            cue.getLengthFrames() * mixxx::kEngineChannelOutputCount,
+            cue.getHotCue(),
+            labelToQVariant(cue.getLabel()),
+            mixxx::RgbColor::toQVariant(cue.getColor()),
+    };
+}
+
+/// Inserts all rows with a single statement
+bool execMultiRowInsert(QSqlQuery* pQuery,
+        const QString& statement,
+        const QList<QVariantList>& rows) {
+    DEBUG_ASSERT(!rows.isEmpty());
+    QStringList placeholders;
+    placeholders.reserve(rows.size());
+    for (const auto& row : rows) {
+        QStringList rowPlaceholders;
+        for (int i = 0; i < row.size(); ++i) {
+            rowPlaceholders << QStringLiteral("?");
+        }
+        placeholders << QChar('(') + rowPlaceholders.join(QChar(',')) + QChar(')');
+    }
+    if (!pQuery->prepare(statement + placeholders.join(QChar(',')))) {
+        LOG_FAILED_QUERY(*pQuery);
+        return false;
+    }
+    for (const auto& row : rows) {
+        for (const auto& value : row) {
+            pQuery->addBindValue(value);
+        }
+    }
+    if (!pQuery->exec()) {
+        LOG_FAILED_QUERY(*pQuery);
+        return false;
+    }
+    return true;
+}
+
 } // namespace
 
 QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
     //qDebug() << "CueDAO::getCuesForTrack" << QThread::currentThread() << m_database.connectionName();
     QList<CuePointer> cues;
 
-    FwdSqlQuery query(
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(
             m_database,
             QStringLiteral("SELECT * FROM " CUE_TABLE " WHERE track_id=:id"));
     DEBUG_ASSERT(
@@ -117,15 +171,14 @@ QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
 
 bool CueDAO::deleteCuesForTrack(TrackId trackId) const {
     qDebug() << "CueDAO::deleteCuesForTrack" << QThread::currentThread() << m_database.connectionName();
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral("DELETE FROM " CUE_TABLE " WHERE track_id=:track_id"));
-    query.bindValue(":track_id", trackId.toVariant());
-    if (query.exec()) {
-        return true;
-    } else {
-        LOG_FAILED_QUERY(query);
-    }
-    return false;
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(
+            m_database,
+            QStringLiteral("DELETE FROM " CUE_TABLE " WHERE track_id=:track_id"));
+    DEBUG_ASSERT(
+            query.isPrepared() &&
+            !query.hasError());
+    query.bindValue(":track_id", trackId);
+    return query.execPrepared();
 }
 
 bool CueDAO::deleteCuesForTracks(const QList<TrackId>& trackIds) const {
@@ -147,100 +200,141 @@ bool CueDAO::deleteCuesForTracks(const QList<TrackId>& trackIds) const {
     return false;
 }
 
-bool CueDAO::saveCue(TrackId trackId, Cue* cue) const {
-    //qDebug() << "CueDAO::saveCue" << QThread::currentThread() << m_database.connectionName();
-    VERIFY_OR_DEBUG_ASSERT(cue) {
-        return false;
+void CueDAO::saveTrackCues(
+        TrackId trackId,
+        const QList<CuePointer>& cueList) const {
+    DEBUG_ASSERT(trackId.isValid());
+    QHash<TrackId, QList<CuePointer>> cuesByTrack;
+    cuesByTrack.insert(trackId, cueList);
+    if (!saveTracksCues(cuesByTrack)) {
+        kLogger.warning()
+                << "Failed to save cues of track"
+                << trackId;
     }
+}
 
-    // Prepare query
-    QSqlQuery query(m_database);
-    if (cue->getId().isValid()) {
-        // Update cue
-        query.prepare(QStringLiteral("UPDATE " CUE_TABLE " SET "
-                        "track_id=:track_id,"
-                        "type=:type,"
-                        "position=:position,"
-                        "length=:length,"
-                        "hotcue=:hotcue,"
-                        "label=:label,"
-                        "color=:color"
-                        " WHERE id=:id"));
-        query.bindValue(":id", cue->getId().toVariant());
-    } else {
-        // New cue
-        query.prepare(
-                QStringLiteral("INSERT INTO " CUE_TABLE
-                               " (track_id, type, position, length, hotcue, "
-                               "label, color) VALUES (:track_id, :type, "
-                               ":position, :length, :hotcue, :label, :color)"));
-    }
-
-    // Bind values and execute query
-    query.bindValue(":track_id", trackId.toVariant());
-    query.bindValue(":type", static_cast<int>(cue->getType()));
-    query.bindValue(":position", cue->getPosition().toEngineSamplePosMaybeInvalid());
-    query.bindValue(":length", cue->getLengthFrames() * mixxx::kEngineChannelOutputCount);
-    query.bindValue(":hotcue", cue->getHotCue());
-    query.bindValue(":label", labelToQVariant(cue->getLabel()));
-    query.bindValue(":color", mixxx::RgbColor::toQVariant(cue->getColor()));
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return false;
+bool CueDAO::saveTracksCues(
+        const QHash<TrackId, QList<CuePointer>>& cuesByTrack) const {
+    if (cuesByTrack.isEmpty()) {
+        return true;
     }
 
-    if (!cue->getId().isValid()) {
-        // New cue
-        const auto newId = DbId(query.lastInsertId());
-        DEBUG_ASSERT(newId.isValid());
-        cue->setId(newId);
+    // Load the stored rows of all tracks
+    QHash<DbId, QVariantList> storedRows;
+    const QList<TrackId> trackIds = cuesByTrack.keys();
+    for (int i = 0; i < trackIds.size(); i += kMaxIdsPerQuery) {
+        QStringList idList;
+        for (const auto& trackId : trackIds.mid(i, kMaxIdsPerQuery)) {
+            DEBUG_ASSERT(trackId.isValid());
+            idList << trackId.toString();
+        }
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral("SELECT id," CUE_COLUMNS " FROM " CUE_TABLE
+                                     " WHERE track_id IN (%1)")
+                              .arg(idList.join(QChar(','))));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        while (query.next()) {
+            QVariantList values;
+            values.reserve(kNumCueColumns);
+            for (int column = 1; column <= kNumCueColumns; ++column) {
+                values.append(query.value(column));
+            }
+            storedRows.insert(DbId(query.value(0)), std::move(values));
+        }
     }
-    DEBUG_ASSERT(cue->getId().isValid());
-    cue->setDirty(false);
-    return true;
-}
 
-void CueDAO::saveTrackCues(
-        TrackId trackId,
-        const QList<CuePointer>& cueList) const {
-    DEBUG_ASSERT(trackId.isValid());
-    QStringList cueIds;
-    cueIds.reserve(cueList.size());
-    for (const auto& pCue : cueList) {
-        // New cues (without an id) must always be marked as dirty
-        DEBUG_ASSERT(pCue->getId().isValid() || pCue->isDirty());
-        // Update or save cue
-        if (pCue->isDirty()) {
-            saveCue(trackId, pCue.get());
-        }
-        // After saving each cue must have a valid id
-        VERIFY_OR_DEBUG_ASSERT(pCue->getId().isValid()) {
-            continue;
+    // Only the cues that differ from their stored row are written. All
+    // stored rows that are left over afterwards belong to deleted cues.
+    QList<CuePointer> newCues;
+    QList<QVariantList> newRows;
+    QList<CuePointer> changedCues;
+    QList<QVariantList> changedRows;
+    for (auto it = cuesByTrack.cbegin(); it != cuesByTrack.cend(); ++it) {
+        for (const auto& pCue : it.value()) {
+            VERIFY_OR_DEBUG_ASSERT(pCue) {
+                continue;
+            }
+            // New cues (without an id) must always be marked as dirty
+            DEBUG_ASSERT(pCue->getId().isValid() || pCue->isDirty());
+            QVariantList values = cueToRow(it.key(), *pCue);
+            if (!pCue->getId().isValid()) {
+                newCues.append(pCue);
+                newRows.append(std::move(values));
+                continue;
+            }
+            if (storedRows.take(pCue->getId()) == values) {
+                pCue->setDirty(false);
+                continue;
+            }
+            values.prepend(pCue->getId().toVariant());
+            changedCues.append(pCue);
+            changedRows.append(std::move(values));
         }
-        cueIds.append(pCue->getId().toString());
     }
 
     // Delete orphaned cues
-    FwdSqlQuery query(
-            m_database,
-            QStringLiteral("DELETE FROM " CUE_TABLE " WHERE track_id=:track_id AND id NOT IN (%1)")
-                    .arg(cueIds.join(QChar(','))));
-    DEBUG_ASSERT(
-            query.isPrepared() &&
-            !query.hasError());
-    query.bindValue(":track_id", trackId);
-    if (!query.execPrepared()) {
-        kLogger.warning()
-                << "Failed to delete orphaned cues of track"
-                << trackId;
-        DEBUG_ASSERT(!"failed query");
-        return;
+    const QList<DbId> orphanedIds = storedRows.keys();
+    for (int i = 0; i < orphanedIds.size(); i += kMaxIdsPerQuery) {
+        QStringList idList;
+        for (const auto& id : orphanedIds.mid(i, kMaxIdsPerQuery)) {
+            idList << id.toString();
+        }
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral("DELETE FROM " CUE_TABLE " WHERE id IN (%1)")
+                              .arg(idList.join(QChar(','))));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
     }
-    if (query.numRowsAffected() > 0) {
+
+    // Replace the rows of changed cues, keeping their ids
+    for (int i = 0; i < changedRows.size(); i += kMaxRowsPerQuery) {
+        const int numRows = std::min(kMaxRowsPerQuery, static_cast<int>(changedRows.size()) - i);
+        QSqlQuery query(m_database);
+        if (!execMultiRowInsert(&query,
+                    QStringLiteral("INSERT OR REPLACE INTO " CUE_TABLE
+                                   " (id," CUE_COLUMNS ") VALUES "),
+                    changedRows.mid(i, numRows))) {
+            return false;
+        }
+        for (const auto& pCue : changedCues.mid(i, numRows)) {
+            pCue->setDirty(false);
+        }
+    }
+
+    // Insert the new cues
+    for (int i = 0; i < newRows.size(); i += kMaxRowsPerQuery) {
+        const int numRows = std::min(kMaxRowsPerQuery, static_cast<int>(newRows.size()) - i);
+        QSqlQuery query(m_database);
+        if (!execMultiRowInsert(&query,
+                    QStringLiteral("INSERT INTO " CUE_TABLE
+                                   " (" CUE_COLUMNS ") VALUES "),
+                    newRows.mid(i, numRows))) {
+            return false;
+        }
+        // The ids are AUTOINCREMENT and no other connection can write
+        // within the transaction, so the rows of a single statement get
+        // consecutive ids ending with the last inserted one.
+        const auto lastId = query.lastInsertId().toLongLong();
+        for (int row = 0; row < numRows; ++row) {
+            const auto& pCue = newCues[i + row];
+            const auto newId = DbId(QVariant(lastId - numRows + 1 + row));
+            DEBUG_ASSERT(newId.isValid());
+            pCue->setId(newId);
+            pCue->setDirty(false);
+        }
+    }
+
+    if (kLogger.debugEnabled()) {
         kLogger.debug()
-                << "Deleted"
-                << query.numRowsAffected()
-                << "orphaned cue(s) of track"
-                << trackId;
+                << "Saved cues of" << cuesByTrack.size() << "track(s):"
+                << newCues.size() << "inserted,"
+                << changedCues.size() << "updated,"
+                << orphanedIds.size() << "deleted";
     }
+    return true;
 }
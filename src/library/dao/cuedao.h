@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QHash>
+
 #include "library/dao/dao.h"
 #include "track/cue.h"
 #include "track/trackid.h"
@@ -15,9 +17,11 @@ class CueDAO : public DAO {
     QList<CuePointer> getCuesForTrack(TrackId trackId) const;
 
     void saveTrackCues(TrackId trackId, const QList<CuePointer>& cueList) const;
+    /// Saves the cues of many tracks at once, e.g. after cues have been
+    /// imported from Serato or rekordbox. The cues are compared with the
+    /// stored rows and only the differences are written, using multi-row
+    /// statements. Must be invoked within a transaction.
+    bool saveTracksCues(const QHash<TrackId, QList<CuePointer>>& cuesByTrack) const;
     bool deleteCuesForTrack(TrackId trackId) const;
     bool deleteCuesForTracks(const QList<TrackId>& trackIds) const;
-
-  private:
-    bool saveCue(TrackId trackId, Cue* pCue) const;
 };
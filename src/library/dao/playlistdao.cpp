@@ -641,45 +641,49 @@ void PlaylistDAO::removeTracksFromPlaylist(int playlistId, const QList<int>& pos
 }
 
 void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, int position) {
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "SELECT track_id FROM PlaylistTracks "
-            "WHERE playlist_id=:id AND position=:position"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return;
-    }
-
-    if (!query.next()) {
-        qDebug() << "removeTrackFromPlaylist no track exists at position:"
-                 << position << "in playlist:" << playlistId;
-        return;
+    // These statements are executed once per removed track
+    TrackId trackId;
+    {
+        FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
+                QStringLiteral(
+                        "SELECT track_id FROM PlaylistTracks "
+                        "WHERE playlist_id=:id AND position=:position"));
+        query.bindValue(":id", playlistId);
+        query.bindValue(":position", position);
+        if (!query.isPrepared() || !query.execPrepared()) {
+            return;
+        }
+        if (!query.next()) {
+            qDebug() << "removeTrackFromPlaylist no track exists at position:"
+                     << position << "in playlist:" << playlistId;
+            return;
+        }
+        trackId = TrackId(query.fieldValue(0));
     }
-    TrackId trackId(query.value(query.record().indexOf("track_id")));
 
     // Delete the track from the playlist.
-    query.prepare(QStringLiteral(
-            "DELETE FROM PlaylistTracks "
-            "WHERE playlist_id=:id AND position=:position"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return;
+    {
+        FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
+                QStringLiteral(
+                        "DELETE FROM PlaylistTracks "
+                        "WHERE playlist_id=:id AND position=:position"));
+        query.bindValue(":id", playlistId);
+        query.bindValue(":position", position);
+        if (!query.isPrepared() || !query.execPrepared()) {
+            return;
+        }
     }
 
-    query.prepare(QStringLiteral(
-            "UPDATE PlaylistTracks SET position=position-1 "
-            "WHERE position>=:position AND playlist_id=:id"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    {
+        FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
+                QStringLiteral(
+                        "UPDATE PlaylistTracks SET position=position-1 "
+                        "WHERE position>=:position AND playlist_id=:id"));
+        query.bindValue(":id", playlistId);
+        query.bindValue(":position", position);
+        if (query.isPrepared()) {
+            query.execPrepared();
+        }
     }
 
     m_playlistsTrackIsIn.remove(trackId, playlistId);
@@ -941,19 +945,19 @@ bool PlaylistDAO::copyPlaylistTracks(const int sourcePlaylistID, const int targe
 int PlaylistDAO::getMaxPosition(const int playlistId) const {
     // Find out the highest position existing in the playlist so we know what
     // position this track should have.
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "SELECT max(position) as position FROM PlaylistTracks "
-            "WHERE playlist_id = :id"));
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
+            QStringLiteral(
+                    "SELECT max(position) as position FROM PlaylistTracks "
+                    "WHERE playlist_id = :id"));
     query.bindValue(":id", playlistId);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    if (!query.isPrepared() || !query.execPrepared()) {
+        return 0;
     }
 
     // Get the position of the highest track in the playlist.
     int position = 0;
     if (query.next()) {
-        position = query.value(query.record().indexOf("position")).toInt();
+        position = query.fieldValue(0).toInt();
     }
     return position;
 }
@@ -0,0 +1,195 @@
+#include "library/dao/searchindexdao.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "library/dao/trackschema.h"
+#include "library/queryutil.h"
+#include "util/db/dbconnection.h"
+#include "util/db/fwdsqlquery.h"
+#include "util/db/sqllikewildcards.h"
+#include "util/db/sqltransaction.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SearchIndexDAO");
+
+const QString kTableName = QStringLiteral("library_search_index");
+
+const QStringList kIndexedColumns = {
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_ALBUMARTIST,
+        LIBRARYTABLE_ALBUM,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_GENRE,
+        LIBRARYTABLE_COMPOSER,
+        LIBRARYTABLE_GROUPING,
+        LIBRARYTABLE_COMMENT,
+        TRACKLOCATIONSTABLE_LOCATION,
+};
+
+QString joinTrackIds(const QList<TrackId>& trackIds) {
+    QStringList trackIdList;
+    trackIdList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        trackIdList.append(trackId.toString());
+    }
+    return trackIdList.join(QChar(','));
+}
+
+/// Selects the folded text of all indexed columns, starting with the
+/// track id that is used as the rowid of the index.
+QString selectIndexedValues(const QString& whereClause) {
+    QStringList values;
+    values.reserve(kIndexedColumns.size() + 1);
+    values.append(QStringLiteral(LIBRARY_TABLE ".") + LIBRARYTABLE_ID);
+    for (const auto& column : kIndexedColumns) {
+        values.append(QStringLiteral("%1(%2.%3)")
+                        .arg(QLatin1String(mixxx::DbConnection::kLatinLowFunction),
+                                mixxx::trackschema::tableForColumn(column),
+                                column));
+    }
+    // The left join keeps tracks with a missing location in the index,
+    // otherwise their count would never match the count of the library.
+    return QStringLiteral(
+            "INSERT INTO %1(rowid,%2) SELECT %3 FROM " LIBRARY_TABLE
+            " LEFT JOIN " TRACKLOCATIONS_TABLE " ON " LIBRARY_TABLE
+            ".location=" TRACKLOCATIONS_TABLE ".id %4")
+            .arg(kTableName,
+                    kIndexedColumns.join(QChar(',')),
+                    values.join(QChar(',')),
+                    whereClause);
+}
+
+} // anonymous namespace
+
+void SearchIndexDAO::initialize(const QSqlDatabase& database) {
+    DAO::initialize(database);
+    m_available = false;
+    m_created = false;
+
+    // Failing queries are expected if SQLite does not support FTS5, so
+    // they are not reported as errors.
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT name FROM sqlite_master WHERE type='table' AND name=:name"));
+    query.bindValue(QStringLiteral(":name"), kTableName);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+    if (!query.next()) {
+        if (!query.exec(QStringLiteral(
+                    "CREATE VIRTUAL TABLE %1 USING fts5(%2, tokenize='trigram')")
+                                .arg(kTableName, kIndexedColumns.join(QChar(','))))) {
+            kLogger.info()
+                    << "Full-text search is not supported by SQLite:"
+                    << query.lastError().databaseText();
+            return;
+        }
+        m_created = true;
+    }
+    if (!query.exec(QStringLiteral("SELECT rowid FROM %1 WHERE %1 MATCH 'mixxx' LIMIT 1")
+                                .arg(kTableName))) {
+        kLogger.info()
+                << "Full-text search index is not usable:"
+                << query.lastError().databaseText();
+        return;
+    }
+    m_available = true;
+}
+
+bool SearchIndexDAO::rebuildIfIncomplete() {
+    if (!m_available) {
+        return false;
+    }
+    if (!m_created) {
+        FwdSqlQuery query(m_database,
+                QStringLiteral("SELECT (SELECT COUNT(*) FROM " LIBRARY_TABLE
+                               ")=(SELECT COUNT(*) FROM %1)")
+                        .arg(kTableName));
+        if (query.hasError() || !query.execPrepared() || !query.next()) {
+            return false;
+        }
+        if (query.fieldValueBoolean(0)) {
+            return true;
+        }
+    }
+    if (!rebuild()) {
+        return false;
+    }
+    m_created = false;
+    return true;
+}
+
+bool SearchIndexDAO::rebuild() const {
+    kLogger.info() << "Building full-text search index";
+    SqlTransaction transaction(m_database);
+    {
+        FwdSqlQuery query(m_database, QStringLiteral("DELETE FROM %1").arg(kTableName));
+        if (query.hasError() || !query.execPrepared()) {
+            return false;
+        }
+    }
+    {
+        FwdSqlQuery query(m_database, selectIndexedValues(QString()));
+        if (query.hasError() || !query.execPrepared()) {
+            return false;
+        }
+    }
+    return transaction.commit();
+}
+
+bool SearchIndexDAO::updateTracks(const QList<TrackId>& trackIds) const {
+    if (!m_available || trackIds.isEmpty()) {
+        return true;
+    }
+    if (!removeTracks(trackIds)) {
+        return false;
+    }
+    FwdSqlQuery query(m_database,
+            selectIndexedValues(QStringLiteral("WHERE " LIBRARY_TABLE ".id IN (%1)")
+                                        .arg(joinTrackIds(trackIds))));
+    return !query.hasError() && query.execPrepared();
+}
+
+bool SearchIndexDAO::removeTracks(const QList<TrackId>& trackIds) const {
+    if (!m_available || trackIds.isEmpty()) {
+        return true;
+    }
+    FwdSqlQuery query(m_database,
+            QStringLiteral("DELETE FROM %1 WHERE rowid IN (%2)")
+                    .arg(kTableName, joinTrackIds(trackIds)));
+    return !query.hasError() && query.execPrepared();
+}
+
+bool SearchIndexDAO::canMatch(const QStringList& sqlColumns, const QString& argument) const {
+    if (!m_available || sqlColumns.isEmpty()) {
+        return false;
+    }
+    for (const auto& column : sqlColumns) {
+        if (!kIndexedColumns.contains(column)) {
+            return false;
+        }
+    }
+    // The wildcards of LIKE have no meaning for the index and the trigram
+    // tokenizer cannot find shorter substrings.
+    if (argument.contains(kSqlLikeMatchAll) || argument.contains(kSqlLikeMatchOne)) {
+        return false;
+    }
+    return argument.toUcs4().size() >= kMinMatchLength;
+}
+
+QString SearchIndexDAO::formatMatchFilter(
+        const QStringList& sqlColumns, const QString& argument) const {
+    DEBUG_ASSERT(canMatch(sqlColumns, argument));
+    QString phrase = argument;
+    phrase.replace(QChar('"'), QStringLiteral("\"\""));
+    // A column filter followed by a single phrase, i.e. {artist title} : "term"
+    const QString matchExpression = QStringLiteral("{%1} : \"%2\"")
+                                            .arg(sqlColumns.join(QChar(' ')), phrase);
+    FieldEscaper escaper(m_database);
+    return QStringLiteral("%1 IN (SELECT rowid FROM %2 WHERE %2 MATCH %3)")
+            .arg(LIBRARYTABLE_ID, kTableName, escaper.escapeString(matchExpression));
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "library/dao/dao.h"
+#include "track/trackid.h"
+
+/// SearchIndexDAO maintains a full-text index of the text columns of the
+/// library in an SQLite FTS5 table, so a search does not need to scan the
+/// whole library table with LIKE.
+///
+/// The table uses the trigram tokenizer, which finds arbitrary substrings
+/// like LIKE '%term%' does, as long as the term has at least
+/// kMinMatchLength characters. The indexed text is folded with
+/// DbConnection::makeStringLatinLow() like the strings compared by the
+/// custom LIKE function, so both find the same tracks.
+///
+/// If SQLite has been built without FTS5 or without the trigram tokenizer
+/// the index is not available and all searches fall back to LIKE.
+class SearchIndexDAO : public DAO {
+  public:
+    static constexpr int kMinMatchLength = 3;
+
+    ~SearchIndexDAO() override = default;
+
+    /// Creates the index table if it does not exist yet and detects
+    /// if the index can be used.
+    void initialize(const QSqlDatabase& database) override;
+
+    bool isAvailable() const {
+        return m_available;
+    }
+
+    /// Rebuilds the index if it has just been created or if it does not
+    /// contain all tracks, e.g. after a version of Mixxx without the index
+    /// has modified the library.
+    bool rebuildIfIncomplete();
+
+    /// Reindexes the given tracks after they have been inserted or updated.
+    bool updateTracks(const QList<TrackId>& trackIds) const;
+    /// Removes the given tracks from the index after they have been deleted.
+    bool removeTracks(const QList<TrackId>& trackIds) const;
+
+    /// Returns true if a substring search for the folded argument in
+    /// the given columns can be done with the index.
+    bool canMatch(const QStringList& sqlColumns, const QString& argument) const;
+
+    /// Returns an SQL filter that selects the ids of all tracks containing
+    /// the folded argument in one of the given columns. Only valid if
+    /// canMatch() returns true.
+    QString formatMatchFilter(const QStringList& sqlColumns, const QString& argument) const;
+
+  private:
+    bool rebuild() const;
+
+    bool m_available = false;
+    bool m_created = false;
+};
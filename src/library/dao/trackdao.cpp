@@ -3,7 +3,11 @@
 #include <QChar>
 #include <QDir>
 #include <QFileInfo>
+#include <QMultiHash>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 #include <QtDebug>
+#include <cmath>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -15,6 +19,7 @@
 #include "library/dao/cuedao.h"
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
+#include "library/dao/searchindexdao.h"
 #include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "moc_trackdao.cpp"
@@ -26,6 +31,7 @@
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/datetime.h"
+#include "util/db/dbwritequeue.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/db/sqlite.h"
 #include "util/db/sqlstringformatter.h"
@@ -34,6 +40,7 @@
 #include "util/logger.h"
 #include "util/math.h"
 #include "util/qt.h"
+#include "util/stringinterner.h"
 #include "util/timer.h"
 
 namespace {
@@ -73,18 +80,26 @@ QString locationPathPrefixFromRootDir(const QDir& rootDir) {
     return mixxx::FileInfo(rootDir).location() + '/';
 }
 
+// Defined below
+bool updatePlayCounters(
+        const QSqlDatabase& database,
+        const QSet<TrackId>& trackIds);
+
 } // anonymous namespace
 
 TrackDAO::TrackDAO(CueDAO& cueDao,
                    PlaylistDAO& playlistDao,
                    AnalysisDao& analysisDao,
                    LibraryHashDAO& libraryHashDao,
+                   SearchIndexDAO& searchIndexDao,
                    UserSettingsPointer pConfig)
         : m_cueDao(cueDao),
           m_playlistDao(playlistDao),
           m_analysisDao(analysisDao),
           m_libraryHashDao(libraryHashDao),
+          m_searchIndexDao(searchIndexDao),
           m_pConfig(pConfig),
+          m_pWriteQueue(nullptr),
           m_trackLocationIdColumn(UndefinedRecordIndex),
           m_queryLibraryIdColumn(UndefinedRecordIndex),
           m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex) {
@@ -96,6 +111,23 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
                     // Nothing to do
                     return;
                 }
+                if (m_pWriteQueue) {
+                    // Don't block while updating the play counters of
+                    // many tracks, e.g. after deleting a history playlist
+                    m_pWriteQueue->enqueue(
+                            [playedTrackIds](const QSqlDatabase& database) {
+                                return updatePlayCounters(
+                                        database, playedTrackIds);
+                            },
+                            this,
+                            [this, playedTrackIds](bool success) {
+                                VERIFY_OR_DEBUG_ASSERT(success) {
+                                    return;
+                                }
+                                emit tracksChanged(playedTrackIds);
+                            });
+                    return;
+                }
                 VERIFY_OR_DEBUG_ASSERT(updatePlayCounterFromPlayedHistory(playedTrackIds)) {
                     return;
                 }
@@ -143,14 +175,13 @@ TrackId TrackDAO::getTrackIdByLocation(const QString& location) const {
         return {};
     }
 
-    QSqlQuery query(m_database);
-    query.prepare(
-            "SELECT library.id FROM library "
-            "INNER JOIN track_locations ON library.location = track_locations.id "
-            "WHERE track_locations.location=:location");
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
+            QStringLiteral(
+                    "SELECT library.id FROM library "
+                    "INNER JOIN track_locations ON library.location = track_locations.id "
+                    "WHERE track_locations.location=:location"));
     query.bindValue(":location", location);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    if (!query.isPrepared() || !query.execPrepared()) {
         DEBUG_ASSERT(!"Failed query");
         return {};
     }
@@ -158,7 +189,7 @@ TrackId TrackDAO::getTrackIdByLocation(const QString& location) const {
         qDebug() << "TrackDAO::getTrackId(): Track location not found in library:" << location;
         return {};
     }
-    const auto trackId = TrackId(query.value(query.record().indexOf("id")));
+    const auto trackId = TrackId(query.fieldValue(0));
     DEBUG_ASSERT(trackId.isValid());
     return trackId;
 }
@@ -282,25 +313,58 @@ QSet<QString> TrackDAO::getAllTrackLocations() const {
 QString TrackDAO::getTrackLocation(TrackId trackId) const {
     qDebug() << "TrackDAO::getTrackLocation"
              << QThread::currentThread() << m_database.connectionName();
-    QSqlQuery query(m_database);
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
+            QStringLiteral(
+                    "SELECT track_locations.location FROM track_locations "
+                    "INNER JOIN library ON library.location = track_locations.id "
+                    "WHERE library.id=:id"));
     QString trackLocation = "";
-    query.prepare("SELECT track_locations.location FROM track_locations "
-                  "INNER JOIN library ON library.location = track_locations.id "
-                  "WHERE library.id=:id");
-    query.bindValue(":id", trackId.toVariant());
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    query.bindValue(":id", trackId);
+    if (!query.isPrepared() || !query.execPrepared()) {
         DEBUG_ASSERT(!"Failed query");
         return "";
     }
-    const int locationColumn = query.record().indexOf("location");
     while (query.next()) {
-        trackLocation = query.value(locationColumn).toString();
+        trackLocation = query.fieldValue(0).toString();
     }
 
     return trackLocation;
 }
 
+QHash<TrackId, QVariantList> TrackDAO::getTrackFields(
+        const QSet<TrackId>& trackIds,
+        const QStringList& columns) const {
+    QHash<TrackId, QVariantList> fields;
+    if (trackIds.isEmpty()) {
+        return fields;
+    }
+    VERIFY_OR_DEBUG_ASSERT(!columns.isEmpty()) {
+        return fields;
+    }
+    fields.reserve(trackIds.size());
+    // The id is selected as an additional, last column
+    FwdSqlQuery query(m_database,
+            QStringLiteral(
+                    "SELECT %1,library.id FROM library "
+                    "INNER JOIN track_locations ON library.location = track_locations.id "
+                    "WHERE library.id IN (%2)")
+                    .arg(columns.join(QChar(',')), joinTrackIdList(trackIds)));
+    if (!query.isPrepared() || !query.execPrepared()) {
+        DEBUG_ASSERT(!"Failed query");
+        return fields;
+    }
+    const int columnCount = static_cast<int>(columns.size());
+    while (query.next()) {
+        QVariantList values;
+        values.reserve(columnCount);
+        for (int i = 0; i < columnCount; ++i) {
+            values.append(query.fieldValue(i));
+        }
+        fields.insert(TrackId(query.fieldValue(columnCount)), std::move(values));
+    }
+    return fields;
+}
+
 bool TrackDAO::saveTrack(Track* pTrack) const {
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return false;
@@ -316,6 +380,12 @@ bool TrackDAO::saveTrack(Track* pTrack) const {
         return false;
     }
 
+    if (m_pSaveTracksTransaction) {
+        // Marked clean when the transaction has been committed
+        m_savedTracks.insert(trackId, pTrack);
+        return true;
+    }
+
     // BaseTrackCache must be informed separately, because the
     // track has already been disconnected and TrackDAO does
     // not receive any signals that are usually forwarded to
@@ -326,6 +396,53 @@ bool TrackDAO::saveTrack(Track* pTrack) const {
     return true;
 }
 
+void TrackDAO::beginSaveTracks() {
+    VERIFY_OR_DEBUG_ASSERT(!m_pSaveTracksTransaction) {
+        return;
+    }
+    auto pTransaction = std::make_unique<SqlTransaction>(m_database);
+    if (!*pTransaction) {
+        // Each track is saved within its own transaction
+        return;
+    }
+    m_pSaveTracksTransaction = std::move(pTransaction);
+}
+
+void TrackDAO::finishSaveTracks() {
+    if (!m_pSaveTracksTransaction) {
+        return;
+    }
+    if (!m_pendingTrackCues.isEmpty()) {
+        if (!m_cueDao.saveTracksCues(m_pendingTrackCues)) {
+            qWarning() << "TrackDAO: Failed to save the cues of"
+                       << m_pendingTrackCues.size()
+                       << "saved tracks";
+        }
+        m_pendingTrackCues.clear();
+    }
+    const QHash<TrackId, Track*> savedTracks = std::move(m_savedTracks);
+    m_savedTracks.clear();
+    const bool committed = m_pSaveTracksTransaction->commit();
+    if (!committed) {
+        // The tracks stay dirty and are saved again later
+        qWarning() << "TrackDAO: Failed to commit"
+                   << savedTracks.size()
+                   << "saved tracks";
+        m_pSaveTracksTransaction->rollback();
+    }
+    m_pSaveTracksTransaction.reset();
+    if (!committed || savedTracks.isEmpty()) {
+        return;
+    }
+    QSet<TrackId> cleanTrackIds;
+    cleanTrackIds.reserve(savedTracks.size());
+    for (auto it = savedTracks.constBegin(); it != savedTracks.constEnd(); ++it) {
+        it.value()->markClean();
+        cleanTrackIds.insert(it.key());
+    }
+    emit tracksClean(cleanTrackIds);
+}
+
 void TrackDAO::slotDatabaseTracksChanged(const QSet<TrackId>& changedTrackIds) {
     if (!changedTrackIds.isEmpty()) {
         emit tracksChanged(changedTrackIds);
@@ -797,6 +914,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
         pTrack->initId(trackId);
         pTrack->setDateAdded(trackDateAdded);
 
+        m_searchIndexDao.updateTracks({trackId});
+
         m_analysisDao.saveTrackAnalyses(
                 trackId,
                 pTrack->getWaveform(),
@@ -814,7 +933,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const mixxx::FileAccess& fileAccess,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::PreparedTrackSource* pPreparedSource) {
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
     // the track is already in the library. A refactoring is
@@ -864,7 +984,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pPreparedSource);
     if (!pTrack->checkSourceSynchronized()) {
         qWarning() << "TrackDAO::addTracksAddFile:"
                 << "Failed to parse track metadata from file"
@@ -1040,6 +1161,9 @@ bool TrackDAO::onPurgingTracks(
             return false;
         }
     }
+    if (!m_searchIndexDao.removeTracks(trackIds)) {
+        return false;
+    }
     {
         // invalidate the hash in LibraryHash,
         // in case the file was not deleted to detect it on a rescan
@@ -1082,8 +1206,14 @@ typedef void (*TrackPopulatorFn)(
         const int column,
         Track* pTrack);
 
+// For fields that are repeated for many tracks. The loaded tracks share
+// their values instead of holding a copy each.
+QString internedString(const QSqlRecord& record, const int column) {
+    return StringInterner::instance().intern(record.value(column).toString());
+}
+
 void setTrackArtist(const QSqlRecord& record, const int column, Track* pTrack) {
-    pTrack->setArtist(record.value(column).toString());
+    pTrack->setArtist(internedString(record, column));
 }
 
 void setTrackTitle(const QSqlRecord& record, const int column, Track* pTrack) {
@@ -1091,27 +1221,27 @@ void setTrackTitle(const QSqlRecord& record, const int column, Track* pTrack) {
 }
 
 void setTrackAlbum(const QSqlRecord& record, const int column, Track* pTrack) {
-    pTrack->setAlbum(record.value(column).toString());
+    pTrack->setAlbum(internedString(record, column));
 }
 
 void setTrackAlbumArtist(const QSqlRecord& record, const int column, Track* pTrack) {
-    pTrack->setAlbumArtist(record.value(column).toString());
+    pTrack->setAlbumArtist(internedString(record, column));
 }
 
 void setTrackYear(const QSqlRecord& record, const int column, Track* pTrack) {
-    pTrack->setYear(record.value(column).toString());
+    pTrack->setYear(internedString(record, column));
 }
 
 void setTrackGenre(const QSqlRecord& record, const int column, Track* pTrack) {
-    TrackDAO::setTrackGenreInternal(pTrack, record.value(column).toString());
+    TrackDAO::setTrackGenreInternal(pTrack, internedString(record, column));
 }
 
 void setTrackComposer(const QSqlRecord& record, const int column, Track* pTrack) {
-    pTrack->setComposer(record.value(column).toString());
+    pTrack->setComposer(internedString(record, column));
 }
 
 void setTrackGrouping(const QSqlRecord& record, const int column, Track* pTrack) {
-    pTrack->setGrouping(record.value(column).toString());
+    pTrack->setGrouping(internedString(record, column));
 }
 
 void setTrackNumber(const QSqlRecord& record, const int column, Track* pTrack) {
@@ -1180,7 +1310,7 @@ void setTrackDateAdded(const QSqlRecord& record, const int column, Track* pTrack
 }
 
 void setTrackFiletype(const QSqlRecord& record, const int column, Track* pTrack) {
-    pTrack->setType(record.value(column).toString());
+    pTrack->setType(internedString(record, column));
 }
 
 void setTrackHeaderParsed(const QSqlRecord& record, const int column, Track* pTrack) {
@@ -1297,8 +1427,9 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         return nullptr;
     }
 
-    // The GlobalTrackCache is only locked while executing the following line.
-    TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+    // The GlobalTrackCache is only locked while executing the following
+    // line if the cached track needs to be revived.
+    TrackPointer pTrack = GlobalTrackCache::lookupTrackById(trackId);
     if (pTrack) {
         return pTrack;
     }
@@ -1385,15 +1516,16 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
             columnsStr.append(columns[i].name);
         }
 
-        QSqlQuery query(m_database);
-        query.prepare(QString(
-                "SELECT %1 FROM Library "
-                "INNER JOIN track_locations ON library.location = track_locations.id "
-                "WHERE library.id = %2")
-                              .arg(columnsStr, trackId.toString()));
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query)
-                    << QString("getTrack(%1)").arg(trackId.toString());
+        // The columns are the same for all tracks
+        FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
+                QString(
+                        "SELECT %1 FROM Library "
+                        "INNER JOIN track_locations ON library.location = track_locations.id "
+                        "WHERE library.id=:id")
+                        .arg(columnsStr));
+        query.bindValue(":id", trackId);
+        if (!query.isPrepared() || !query.execPrepared()) {
+            qWarning() << "Failed to load track" << trackId;
             DEBUG_ASSERT(!"Failed query");
             return nullptr;
         }
@@ -1606,7 +1738,31 @@ bool TrackDAO::updateTrack(const Track& track) const {
              << trackId
              << track.getLocation();
 
+    if (m_pSaveTracksTransaction) {
+        // Only roll back the changes of this track if writing fails
+        QSqlQuery savepoint(m_database);
+        if (!savepoint.exec(QStringLiteral("SAVEPOINT updateTrack"))) {
+            LOG_FAILED_QUERY(savepoint);
+            return false;
+        }
+        const bool success = writeTrack(track);
+        if (!success) {
+            savepoint.exec(QStringLiteral("ROLLBACK TO updateTrack"));
+        }
+        savepoint.exec(QStringLiteral("RELEASE updateTrack"));
+        return success;
+    }
+
     SqlTransaction transaction(m_database);
+    if (!writeTrack(track)) {
+        return false;
+    }
+    transaction.commit();
+    return true;
+}
+
+bool TrackDAO::writeTrack(const Track& track) const {
+    const TrackId trackId = track.getId();
     // PerformanceTimer time;
     // time.start();
 
@@ -1680,15 +1836,23 @@ bool TrackDAO::updateTrack(const Track& track) const {
         return false;
     }
 
+    VERIFY_OR_DEBUG_ASSERT(m_searchIndexDao.updateTracks({trackId})) {
+        return false;
+    }
+
     //qDebug() << "Update track took : " << time.elapsed().formatMillisWithUnit() << "Now updating cues";
     //time.start();
     m_analysisDao.saveTrackAnalyses(
             trackId,
             track.getWaveform(),
             track.getWaveformSummary());
-    m_cueDao.saveTrackCues(
-            trackId, track.getCuePoints());
-    transaction.commit();
+    if (m_pSaveTracksTransaction) {
+        // Saved together with the cues of all other tracks
+        m_pendingTrackCues.insert(trackId, track.getCuePoints());
+    } else {
+        m_cueDao.saveTrackCues(
+                trackId, track.getCuePoints());
+    }
 
     //qDebug() << "Update track in database took: " << time.elapsed().formatMillisWithUnit();
     //time.start();
@@ -1805,20 +1969,51 @@ bool TrackDAO::detectMovedTracks(
         return true;
     }
 
-    // Query possible successors
+    // Query possible successors once and index them by their file name
+    // for matching them with all missing tracks in memory.
     // NOTE: Successors are identified by filename and duration (in seconds).
     // Since duration is stored as double-precision floating-point and since it
     // is sometimes truncated to nearest integer, tolerance of 1 second is used.
-    QSqlQuery newTrackQuery(m_database);
-    newTrackQuery.prepare(QString(
-            "SELECT library.id as track_id, track_locations.id as location_id, "
-            "track_locations.location "
-            "FROM library INNER JOIN track_locations ON library.location=track_locations.id "
-            "WHERE track_locations.location IN (%1) AND "
-            "filename=:filename AND "
-            "ABS(duration - :duration) < 1 AND "
-            "fs_deleted=0").arg(
-                    SqlStringFormatter::formatList(m_database, addedTracks)));
+    struct AddedTrack {
+        TrackId trackId;
+        DbId locationId;
+        QString location;
+        double duration;
+    };
+    QMultiHash<QString, AddedTrack> addedTracksByFilename;
+    {
+        QSqlQuery newTrackQuery(m_database);
+        newTrackQuery.prepare(QString(
+                "SELECT library.id as track_id, track_locations.id as location_id, "
+                "track_locations.location, filename, duration "
+                "FROM library INNER JOIN track_locations ON library.location=track_locations.id "
+                "WHERE track_locations.location IN (%1) AND "
+                "fs_deleted=0").arg(
+                        SqlStringFormatter::formatList(m_database, addedTracks)));
+        if (!newTrackQuery.exec()) {
+            LOG_FAILED_QUERY(newTrackQuery);
+            DEBUG_ASSERT(!"Failed query");
+            return false;
+        }
+        const QSqlRecord newTrackQueryRecord = newTrackQuery.record();
+        const int newTrackIdColumn = newTrackQueryRecord.indexOf("track_id");
+        const int newLocationIdColumn = newTrackQueryRecord.indexOf("location_id");
+        const int newLocationColumn = newTrackQueryRecord.indexOf("location");
+        const int newFilenameColumn = newTrackQueryRecord.indexOf("filename");
+        const int newDurationColumn = newTrackQueryRecord.indexOf("duration");
+        while (newTrackQuery.next()) {
+            addedTracksByFilename.insert(
+                    newTrackQuery.value(newFilenameColumn).toString(),
+                    AddedTrack{
+                            TrackId(newTrackQuery.value(newTrackIdColumn)),
+                            DbId(newTrackQuery.value(newLocationIdColumn)),
+                            newTrackQuery.value(newLocationColumn).toString(),
+                            newTrackQuery.value(newDurationColumn).toDouble()});
+        }
+    }
+    if (addedTracksByFilename.isEmpty()) {
+        return true;
+    }
 
     // Query tracks, where we need a successor for
     QSqlQuery oldTrackQuery(m_database);
@@ -1854,23 +2049,15 @@ bool TrackDAO::detectMovedTracks(
                 << "Looking for substitute of missing track location"
                 << oldTrackLocation;
 
-        newTrackQuery.bindValue(":filename", filename);
-        newTrackQuery.bindValue(":duration", duration);
-        if (!newTrackQuery.exec()) {
-            LOG_FAILED_QUERY(newTrackQuery);
-            DEBUG_ASSERT(!"Failed query");
-            continue;
-        }
-        const auto newTrackIdColumn = newTrackQuery.record().indexOf("track_id");
-        const auto newTrackLocationIdColumn = newTrackQuery.record().indexOf("location_id");
-        const auto newTrackLocationColumn = newTrackQuery.record().indexOf("location");
         int newTrackLocationSuffixMatch = 0;
-        TrackId newTrackId;
-        DbId newTrackLocationId;
-        QString newTrackLocation;
-        while (newTrackQuery.next()) {
-            const auto nextTrackLocation =
-                    newTrackQuery.value(newTrackLocationColumn).toString();
+        auto newTrackIt = addedTracksByFilename.end();
+        for (auto it = addedTracksByFilename.find(filename);
+                it != addedTracksByFilename.end() && it.key() == filename;
+                ++it) {
+            if (std::abs(it.value().duration - duration) >= 1) {
+                continue;
+            }
+            const auto& nextTrackLocation = it.value().location;
             VERIFY_OR_DEBUG_ASSERT(nextTrackLocation != oldTrackLocation) {
                 continue;
             }
@@ -1882,17 +2069,18 @@ bool TrackDAO::detectMovedTracks(
             DEBUG_ASSERT(nextSuffixMatch >= filename.length());
             if (newTrackLocationSuffixMatch < nextSuffixMatch) {
                 newTrackLocationSuffixMatch = nextSuffixMatch;
-                newTrackId = TrackId(newTrackQuery.value(newTrackIdColumn));
-                newTrackLocationId = DbId(newTrackQuery.value(newTrackLocationIdColumn));
-                newTrackLocation = nextTrackLocation;
+                newTrackIt = it;
             }
         }
-        if (newTrackLocation.isEmpty()) {
+        if (newTrackIt == addedTracksByFilename.end()) {
             kLogger.info()
                     << "Found no substitute for missing track location"
                     << oldTrackLocation;
             continue;
         }
+        TrackId newTrackId = newTrackIt.value().trackId;
+        const DbId newTrackLocationId = newTrackIt.value().locationId;
+        const QString newTrackLocation = newTrackIt.value().location;
         DEBUG_ASSERT(newTrackId.isValid());
         DEBUG_ASSERT(newTrackLocationId.isValid());
         kLogger.info()
@@ -1935,6 +2123,9 @@ bool TrackDAO::detectMovedTracks(
                 DEBUG_ASSERT(!"Failed query");
                 continue;
             }
+            m_searchIndexDao.removeTracks({relocatedTrack.deletedTrackId()});
+            // The added track is not a successor of any other missing track
+            addedTracksByFilename.erase(newTrackIt);
         }
 
         // Update the location foreign key for the existing row in the
@@ -1949,6 +2140,7 @@ bool TrackDAO::detectMovedTracks(
                 LOG_FAILED_QUERY(query);
                 DEBUG_ASSERT(!"Failed query");
             }
+            m_searchIndexDao.updateTracks({relocatedTrack.updatedTrackRef().getId()});
         }
 
         // Remove old, orphaned row from track_locations table
@@ -2058,6 +2250,8 @@ bool TrackDAO::verifyRemainingTracks(
     return true;
 }
 
+namespace {
+
 struct TrackWithoutCover {
     TrackId trackId;
     QString trackLocation;
@@ -2065,6 +2259,48 @@ struct TrackWithoutCover {
     QString trackAlbum;
 };
 
+// Guessing covers is I/O bound. More threads would only compete for
+// the disk, which is a spinning one for many large libraries.
+constexpr int kMaxCoverArtThreads = 4;
+
+// Guesses the covers of consecutive tracks in the same directory with a
+// shared CoverInfoGuesser. Tracks whose file does not exist get a cover
+// info with the source UNKNOWN.
+QVector<CoverInfoRelative> guessCoverInfoForDirectory(
+        const QVector<TrackWithoutCover>& tracks,
+        int begin,
+        int end,
+        volatile const bool* pCancel) {
+    QVector<CoverInfoRelative> coverInfos;
+    coverInfos.reserve(end - begin);
+    CoverInfoGuesser coverInfoGuesser;
+    for (int i = begin; i < end; ++i) {
+        if (*pCancel) {
+            break;
+        }
+        const auto& track = tracks.at(i);
+        const auto fileInfo = mixxx::FileInfo(track.trackLocation);
+        if (!fileInfo.checkFileExists()) {
+            //qDebug() << fileInfo << "does not exist";
+            coverInfos.append(CoverInfoRelative());
+            continue;
+        }
+        const auto embeddedCover =
+                CoverArtUtils::extractEmbeddedCover(
+                        mixxx::FileAccess(fileInfo));
+        const auto coverInfo =
+                coverInfoGuesser.guessCoverInfo(
+                        fileInfo,
+                        track.trackAlbum,
+                        embeddedCover);
+        DEBUG_ASSERT(coverInfo.source != CoverInfo::UNKNOWN);
+        coverInfos.append(coverInfo);
+    }
+    return coverInfos;
+}
+
+} // anonymous namespace
+
 void TrackDAO::detectCoverArtForTracksWithoutCover(volatile const bool* pCancel,
                                               QSet<TrackId>* pTracksChanged) {
     // WARNING TO ANYONE TOUCHING THIS IN THE FUTURE
@@ -2134,45 +2370,72 @@ void TrackDAO::detectCoverArtForTracksWithoutCover(volatile const bool* pCancel,
             "coverart_hash=:coverart_hash "
             "WHERE id=:track_id");
 
-    CoverInfoGuesser coverInfoGuesser;
-    for (const auto& track: tracksWithoutCover) {
+    // The covers are guessed in the background, one task per directory,
+    // while the results are written into the database by this thread.
+    // The tracks are ordered by directory.
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(
+            math_min(QThread::idealThreadCount(), kMaxCoverArtThreads));
+    QVector<int> directoryBegins;
+    QList<QFuture<QVector<CoverInfoRelative>>> directoryTasks;
+    for (int begin = 0; begin < tracksWithoutCover.size();) {
+        const QString& directoryPath = tracksWithoutCover.at(begin).directoryPath;
+        int end = begin + 1;
+        while (end < tracksWithoutCover.size() &&
+                tracksWithoutCover.at(end).directoryPath == directoryPath) {
+            ++end;
+        }
+        directoryBegins.append(begin);
+        directoryTasks.append(QtConcurrent::run(&threadPool,
+                [&tracksWithoutCover, begin, end, pCancel] {
+                    return guessCoverInfoForDirectory(
+                            tracksWithoutCover, begin, end, pCancel);
+                }));
+        begin = end;
+    }
+
+    for (int taskIndex = 0; taskIndex < directoryTasks.size(); ++taskIndex) {
         if (*pCancel) {
+            // Discard the pending tasks. The running ones abort
+            // themselves and are awaited by the thread pool.
+            threadPool.clear();
             return;
         }
+        // Blocks until the task has finished
+        const auto coverInfos = directoryTasks.at(taskIndex).result();
+        for (int i = 0; i < coverInfos.size(); ++i) {
+            if (*pCancel) {
+                threadPool.clear();
+                return;
+            }
 
-        //qDebug() << "Searching for cover art for" << trackLocation;
-        emit progressCoverArt(track.trackLocation);
+            const auto& track = tracksWithoutCover.at(directoryBegins.at(taskIndex) + i);
+            const auto& coverInfo = coverInfos.at(i);
 
-        const auto fileInfo = mixxx::FileInfo(track.trackLocation);
-        if (!fileInfo.checkFileExists()) {
-            //qDebug() << fileInfo << "does not exist";
-            continue;
-        }
+            //qDebug() << "Searching for cover art for" << trackLocation;
+            emit progressCoverArt(track.trackLocation);
 
-        const auto embeddedCover =
-                CoverArtUtils::extractEmbeddedCover(
-                        mixxx::FileAccess(fileInfo));
-        const auto coverInfo =
-                coverInfoGuesser.guessCoverInfo(
-                        fileInfo,
-                        track.trackAlbum,
-                        embeddedCover);
-        DEBUG_ASSERT(coverInfo.source != CoverInfo::UNKNOWN);
+            if (coverInfo.source == CoverInfo::UNKNOWN) {
+                // The file does not exist
+                continue;
+            }
 
-        updateQuery.bindValue(":track_id", track.trackId.toVariant());
-        updateQuery.bindValue(":coverart_type",
-                              static_cast<int>(coverInfo.type));
-        updateQuery.bindValue(":coverart_source",
-                              static_cast<int>(coverInfo.source));
-        updateQuery.bindValue(":coverart_location", coverInfo.coverLocation);
-        updateQuery.bindValue(":coverart_color", mixxx::RgbColor::toQVariant(coverInfo.color));
-        updateQuery.bindValue(":coverart_digest", coverInfo.imageDigest());
-        updateQuery.bindValue(":coverart_hash", coverInfo.legacyHash());
-
-        if (!updateQuery.exec()) {
-            LOG_FAILED_QUERY(updateQuery) << "failed to write file or none cover";
-        } else {
-            pTracksChanged->insert(track.trackId);
+            updateQuery.bindValue(":track_id", track.trackId.toVariant());
+            updateQuery.bindValue(":coverart_type",
+                    static_cast<int>(coverInfo.type));
+            updateQuery.bindValue(":coverart_source",
+                    static_cast<int>(coverInfo.source));
+            updateQuery.bindValue(":coverart_location", coverInfo.coverLocation);
+            updateQuery.bindValue(":coverart_color",
+                    mixxx::RgbColor::toQVariant(coverInfo.color));
+            updateQuery.bindValue(":coverart_digest", coverInfo.imageDigest());
+            updateQuery.bindValue(":coverart_hash", coverInfo.legacyHash());
+
+            if (!updateQuery.exec()) {
+                LOG_FAILED_QUERY(updateQuery) << "failed to write file or none cover";
+            } else {
+                pTracksChanged->insert(track.trackId);
+            }
         }
     }
 }
@@ -2236,8 +2499,11 @@ mixxx::FileAccess TrackDAO::relocateCachedTrack(TrackId trackId) {
     }
 }
 
-bool TrackDAO::updatePlayCounterFromPlayedHistory(
-        const QSet<TrackId>& trackIds) const {
+namespace {
+
+bool updatePlayCounters(
+        const QSqlDatabase& database,
+        const QSet<TrackId>& trackIds) {
     // Invoking this function with an empty list is pointless.
     // All following database queries assume that the list is
     // not empty. Otherwise the played history of all tracks
@@ -2262,7 +2528,7 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
 #endif // __SQLITE3__
         const QString trackIdList = joinTrackIdList(trackIds);
         auto updatePlayed = FwdSqlQuery(
-                m_database,
+                database,
                 QStringLiteral(
                         "UPDATE library SET "
                         "timesplayed=q.timesplayed,"
@@ -2291,7 +2557,7 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
             return false;
         }
         auto updateNotPlayed = FwdSqlQuery(
-                m_database,
+                database,
                 QStringLiteral(
                         "UPDATE library SET "
                         "timesplayed=0,"
@@ -2317,7 +2583,7 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
     } else {
         // TODO: Remove this workaround after dropping support for Ubuntu 20.04
         auto playCounterQuery = FwdSqlQuery(
-                m_database,
+                database,
                 QStringLiteral(
                         "SELECT "
                         "COUNT(PlaylistTracks.track_id),"
@@ -2331,7 +2597,7 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
                 QStringLiteral(":playlistHidden"),
                 QVariant(PlaylistDAO::PLHT_SET_LOG));
         auto trackUpdateQuery = FwdSqlQuery(
-                m_database,
+                database,
                 QStringLiteral(
                         "UPDATE library SET "
                         "timesplayed=:timesplayed,"
@@ -2381,6 +2647,16 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
         }
     }
 #endif // __SQLITE3__
+    return true;
+}
+
+} // anonymous namespace
+
+bool TrackDAO::updatePlayCounterFromPlayedHistory(
+        const QSet<TrackId>& trackIds) const {
+    if (!updatePlayCounters(m_database, trackIds)) {
+        return false;
+    }
     // TODO: DAOs should be passive and simply execute queries. They
     // should neither make assumptions about transaction boundaries
     // nor receive or emit any signals.
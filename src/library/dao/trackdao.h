@@ -1,14 +1,19 @@
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QVariantList>
 #include <memory>
 
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
+#include "track/cue.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 
@@ -17,8 +22,10 @@ class PlaylistDAO;
 class AnalysisDao;
 class CueDAO;
 class LibraryHashDAO;
+class SearchIndexDAO;
 
 namespace mixxx {
+class DbWriteQueue;
 class FileInfo;
 class TrackRecord;
 
@@ -42,6 +49,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             PlaylistDAO& playlistDao,
             AnalysisDao& analysisDao,
             LibraryHashDAO& libraryHashDao,
+            SearchIndexDAO& searchIndexDao,
             UserSettingsPointer pConfig);
     ~TrackDAO() override;
 
@@ -63,6 +71,15 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     QSet<QString> getAllTrackLocations() const;
     QString getTrackLocation(TrackId trackId) const;
 
+    /// Loads only the given columns of the tracks without creating Track
+    /// objects, e.g. "bpm" or "track_locations.location". The values are
+    /// returned in the order of the columns. Only the values that have been
+    /// saved in the database are returned, pending modifications of cached
+    /// tracks are not considered. Tracks that do not exist are omitted.
+    QHash<TrackId, QVariantList> getTrackFields(
+            const QSet<TrackId>& trackIds,
+            const QStringList& columns) const;
+
     // Only used by friend class LibraryScanner, but public for testing!
     bool detectMovedTracks(
             QList<RelocatedTrack>* pRelocatedTracks,
@@ -72,11 +89,28 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
 
+    /// All tracks that are saved until finishSaveTracks() is invoked
+    /// share a single transaction. Each track is saved within a
+    /// savepoint, i.e. a track that fails to save doesn't affect the
+    /// others. The saved tracks are marked clean and a single tracksClean()
+    /// signal is emitted after the transaction has been committed, so
+    /// they must not be deleted before. If committing fails they remain
+    /// dirty.
+    void beginSaveTracks();
+    void finishSaveTracks();
+
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
     bool updatePlayCounterFromPlayedHistory(
             const QSet<TrackId>& trackIds) const;
 
+    /// Updates the play counters on the write queue instead of blocking
+    /// when the played history changes. Not used in tests, where all
+    /// writes are executed synchronously.
+    void setWriteQueue(mixxx::DbWriteQueue* pWriteQueue) {
+        m_pWriteQueue = pWriteQueue;
+    }
+
     /// Don't use even if public!!! Ugly workaround for C++ visibility restrictions.
     /// This method is invoked by a free function that needs to access
     /// a private Track member that only TrackDAO is allowed to access
@@ -108,6 +142,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void trackClean(TrackId trackId);
 
     // Multiple tracks
+    void tracksClean(const QSet<TrackId>& trackIds);
     void tracksAdded(const QSet<TrackId>& trackIds);
     void tracksChanged(const QSet<TrackId>& trackIds);
     void tracksRemoved(const QSet<TrackId>& trackIds);
@@ -147,9 +182,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// The metadata of the track is read from the prepared source
+    /// instead of from the file if possible.
     TrackPointer addTracksAddFile(
             const mixxx::FileAccess& fileAccess,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::PreparedTrackSource* pPreparedSource = nullptr);
     TrackPointer addTracksAddFile(
             const QString& filePath,
             bool unremove) {
@@ -160,6 +198,8 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
+    /// Writes all properties of the track without a transaction
+    bool writeTrack(const Track& track) const;
 
     void hideAllTracks(const QDir& rootDir) const;
 
@@ -198,15 +238,23 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     PlaylistDAO& m_playlistDao;
     AnalysisDao& m_analysisDao;
     LibraryHashDAO& m_libraryHashDao;
+    SearchIndexDAO& m_searchIndexDao;
 
     const UserSettingsPointer m_pConfig;
 
+    mixxx::DbWriteQueue* m_pWriteQueue;
+
     std::unique_ptr<QSqlQuery> m_pQueryTrackLocationInsert;
     std::unique_ptr<QSqlQuery> m_pQueryTrackLocationSelect;
     std::unique_ptr<QSqlQuery> m_pQueryLibraryInsert;
     std::unique_ptr<QSqlQuery> m_pQueryLibraryUpdate;
     std::unique_ptr<QSqlQuery> m_pQueryLibrarySelect;
     std::unique_ptr<SqlTransaction> m_pTransaction;
+    /// The transaction of the tracks that are saved in a batch
+    std::unique_ptr<SqlTransaction> m_pSaveTracksTransaction;
+    mutable QHash<TrackId, Track*> m_savedTracks;
+    /// The cues of the tracks that are saved in a batch
+    mutable QHash<TrackId, QList<CuePointer>> m_pendingTrackCues;
     int m_trackLocationIdColumn;
     int m_queryLibraryIdColumn;
     int m_queryLibraryMixxxDeletedColumn;
@@ -46,6 +46,8 @@ const QString LIBRARYTABLE_COVERART_LOCATION = QStringLiteral("coverart_location
 const QString LIBRARYTABLE_COVERART_COLOR = QStringLiteral("coverart_color");
 const QString LIBRARYTABLE_COVERART_DIGEST = QStringLiteral("coverart_digest");
 const QString LIBRARYTABLE_COVERART_HASH = QStringLiteral("coverart_hash");
+// A virtual column for the waveform thumbnails
+const QString LIBRARYTABLE_WAVEFORM = QStringLiteral("waveform");
 const QString LIBRARYTABLE_CRATE = QStringLiteral("crate");
 
 const QString TRACKLOCATIONSTABLE_ID = QStringLiteral("id");
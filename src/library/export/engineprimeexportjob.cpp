@@ -1,7 +1,15 @@
 #include "library/export/engineprimeexportjob.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFuture>
 #include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
 #include <QStringList>
+#include <QtConcurrent>
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <memory>
@@ -29,6 +37,16 @@ constexpr int kMaxHotCues = 8;
 
 constexpr uint8_t kDefaultWaveformOpacity = 127;
 
+// The number of tracks that are loaded from the Mixxx database at once and
+// then prepared concurrently while the previous chunk is written.
+constexpr int kTrackChunkSize = 32;
+
+const QString kExportDigestsFileName = QStringLiteral("mixxx-export-digests.json");
+
+// Must be incremented when modifying what is exported for a track, so that
+// all tracks are written again.
+constexpr int kExportDigestVersion = 1;
+
 const QStringList kSupportedFileTypes = {
         "aac",
         "m4a",
@@ -73,7 +91,16 @@ std::optional<djinterop::musical_key> toDjinteropKey(
     return keyMap[key];
 }
 
-QString exportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
+QString exportedFilePath(const QSharedPointer<EnginePrimeExportRequest> pRequest,
+        TrackPointer pTrack) {
+    // To ensure no chance of filename clashes, and to keep things simple,
+    // we will prefix the destination files with the DB track identifier.
+    QString dstFilename = pTrack->getId().toString() + " - " +
+            pTrack->getFileInfo().fileName();
+    return pRequest->musicFilesDir.filePath(dstFilename);
+}
+
+void exportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
         TrackPointer pTrack) {
     if (!pRequest->engineLibraryDbDir.exists()) {
         const auto msg = QStringLiteral(
@@ -88,19 +115,14 @@ QString exportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
     }
 
     // Copy music files into the Mixxx export dir, if the source file has
-    // been modified (or the destination doesn't exist).  To ensure no
-    // chance of filename clashes, and to keep things simple, we will prefix
-    // the destination files with the DB track identifier.
+    // been modified (or the destination doesn't exist).
     mixxx::FileInfo srcFileInfo = pTrack->getFileInfo();
-    QString dstFilename = pTrack->getId().toString() + " - " + srcFileInfo.fileName();
-    QString dstPath = pRequest->musicFilesDir.filePath(dstFilename);
+    QString dstPath = exportedFilePath(pRequest, pTrack);
     if (!QFile::exists(dstPath) ||
             srcFileInfo.lastModified() > QFileInfo{dstPath}.lastModified()) {
         const auto srcPath = srcFileInfo.location();
         QFile::copy(srcPath, dstPath);
     }
-
-    return pRequest->engineLibraryDbDir.relativeFilePath(dstPath);
 }
 
 std::optional<djinterop::track> getTrackByRelativePath(
@@ -166,21 +188,105 @@ bool tryGetBeatgrid(BeatsPointer pBeats,
     return true;
 }
 
-void exportMetadata(
-        djinterop::database* pDatabase,
+/// Reads the digests of all previously exported tracks by relative path.
+QHash<QString, QString> loadExportDigests(const QString& filePath) {
+    QHash<QString, QString> digests;
+    QFile file(filePath);
+    if (!file.exists()) {
+        return digests;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << filePath << file.errorString();
+        return digests;
+    }
+    const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+    if (object.value(QStringLiteral("version")).toInt() != kExportDigestVersion) {
+        // All tracks will be written again
+        return digests;
+    }
+    const QJsonObject tracks = object.value(QStringLiteral("tracks")).toObject();
+    for (auto it = tracks.constBegin(); it != tracks.constEnd(); ++it) {
+        digests.insert(it.key(), it.value().toString());
+    }
+    return digests;
+}
+
+void saveExportDigests(const QString& filePath, const QHash<QString, QString>& digests) {
+    QJsonObject tracks;
+    for (auto it = digests.constBegin(); it != digests.constEnd(); ++it) {
+        tracks.insert(it.key(), it.value());
+    }
+    QJsonObject object;
+    object.insert(QStringLiteral("version"), kExportDigestVersion);
+    object.insert(QStringLiteral("tracks"), tracks);
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            file.write(QJsonDocument(object).toJson(QJsonDocument::Compact)) < 0) {
+        qWarning() << "Failed to write" << filePath << file.errorString();
+    }
+}
+
+/// Calculates a digest of everything that is exported for a track, which
+/// is compared to the digest of the last export for skipping tracks that
+/// have not been modified since.
+QString calculateExportDigest(TrackPointer pTrack,
+        const AnalysisDao::AnalysisInfo& waveformAnalysis,
+        const QString& relativePath) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    const mixxx::FileInfo fileInfo = pTrack->getFileInfo();
+    stream << relativePath
+           << fileInfo.sizeInBytes()
+           << fileInfo.lastModified()
+           << pTrack->getTrackNumber()
+           << pTrack->getDuration()
+           << pTrack->getBpm()
+           << pTrack->getYear()
+           << pTrack->getTitle()
+           << pTrack->getArtist()
+           << pTrack->getAlbum()
+           << pTrack->getGenre()
+           << pTrack->getComment()
+           << pTrack->getComposer()
+           << static_cast<qint32>(pTrack->getKey())
+           << static_cast<qint32>(pTrack->getBitrate())
+           << static_cast<qint32>(pTrack->getRating())
+           << static_cast<quint32>(pTrack->getSampleRate());
+    const mixxx::audio::FramePos cuePlayPos = pTrack->getMainCuePosition();
+    stream << (cuePlayPos.isValid() ? cuePlayPos.value() : 0);
+    const BeatsPointer pBeats = pTrack->getBeats();
+    if (pBeats) {
+        stream << pBeats->getVersion() << pBeats->toByteArray();
+    }
+    const auto cues = pTrack->getCuePoints();
+    for (const CuePointer& pCue : cues) {
+        if (pCue->getType() != CueType::HotCue) {
+            continue;
+        }
+        const auto position = pCue->getPosition();
+        stream << static_cast<qint32>(pCue->getHotCue())
+               << (position.isValid() ? position.value() : -1)
+               << pCue->getLabel()
+               << static_cast<quint32>(
+                          mixxx::RgbColor::toQColor(pCue->getColor()).rgb());
+    }
+    stream << static_cast<qint32>(waveformAnalysis.analysisId)
+           << waveformAnalysis.version
+           << static_cast<qint32>(waveformAnalysis.dataChecksum);
+    return QString::fromLatin1(
+            QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+}
+
+/// Fills a snapshot with the data of a Mixxx track. The beat grid and the
+/// waveform are left empty and the hot cues are left unset if the Mixxx
+/// track doesn't have them, so that they won't replace existing data when
+/// merging the snapshot into an already exported track.
+void convertTrack(
+        djinterop::track_snapshot* pSnapshot,
         const e::engine_version& dbVersion,
-        QHash<TrackId, int64_t>* pMixxxToEnginePrimeTrackIdMap,
         TrackPointer pTrack,
-        const Waveform* pWaveform,
-        const QString& relativePath) {
-    // Attempt to load the track in the database, using the relative path to
-    // the music file.  If it exists already, take a snapshot of the track and
-    // update it.  If it does not exist, we'll create a new snapshot.
-    auto externalTrack = getTrackByRelativePath(pDatabase, relativePath);
-    auto snapshot = externalTrack
-            ? externalTrack->snapshot()
-            : djinterop::track_snapshot{};
-    snapshot.relative_path = relativePath.toStdString();
+        const Waveform* pWaveform) {
+    auto& snapshot = *pSnapshot;
 
     snapshot.track_number = pTrack->getTrackNumber().toInt();
     if (snapshot.track_number == 0) {
@@ -234,8 +340,6 @@ void exportMetadata(
                 << "(" << pTrack->getFileInfo().fileName() << ")";
     }
 
-    // Note that any existing hot cues on the track are kept in place, if Mixxx
-    // does not have a hot cue at that location.
     const auto cues = pTrack->getCuePoints();
     snapshot.hot_cues.resize(kMaxHotCues);
     for (const CuePointer& pCue : cues) {
@@ -279,7 +383,7 @@ void exportMetadata(
 
     // TODO (mr-smidge): Export saved loops.
 
-    // Write waveform.
+    // Convert waveform.
     if (pWaveform) {
         djinterop::waveform_extents extents = dbVersion.is_v2_schema()
                 ? e::calculate_overview_waveform_extents(
@@ -299,45 +403,159 @@ void exportMetadata(
         qInfo() << "No waveform data found for track" << pTrack->getId()
                 << "(" << pTrack->getFileInfo().fileName() << ")";
     }
+}
 
-    int externalTrackId;
-    if (externalTrack) {
-        externalTrack->update(snapshot);
-        externalTrackId = externalTrack->id();
-    } else {
-        auto newTrack = pDatabase->create_track(snapshot);
-        externalTrackId = newTrack.id();
+/// A track of the current chunk that is handed to the export workers.
+struct PendingTrack {
+    TrackPointer pTrack;
+    AnalysisDao::AnalysisInfo waveformAnalysis;
+    QString relativePath;
+    // Only set if the track has already been exported before
+    std::optional<int64_t> externalTrackId;
+    QString previousDigest;
+};
+
+/// The result of an export worker that is written into the external
+/// database by the job thread.
+struct PreparedTrack {
+    TrackPointer pTrack;
+    QString relativePath;
+    std::optional<int64_t> externalTrackId;
+    QString digest;
+    // Unsupported file types are not exported at all
+    bool skipped = false;
+    // Tracks that have not been modified since the last export only need
+    // to be added to the crates
+    bool unchanged = false;
+    djinterop::track_snapshot snapshot;
+    QString errorMessage;
+};
+
+/// Copies the music file and converts the data of a track. Invoked
+/// concurrently for all tracks of a chunk and must not access the external
+/// database.
+class TrackPreparer {
+  public:
+    // Required by QtConcurrent::mapped() in Qt 5
+    typedef PreparedTrack result_type;
+
+    TrackPreparer(
+            const QSharedPointer<EnginePrimeExportRequest>& pRequest,
+            const e::engine_version& dbVersion,
+            const AnalysisDao* pAnalysisDao)
+            : m_pRequest(pRequest),
+              m_dbVersion(dbVersion),
+              m_pAnalysisDao(pAnalysisDao) {
     }
 
-    // Record the mapping from Mixxx track id to exported track id.
-    pMixxxToEnginePrimeTrackIdMap->insert(pTrack->getId(), externalTrackId);
-}
+    PreparedTrack operator()(const PendingTrack& pendingTrack) const {
+        PreparedTrack preparedTrack;
+        preparedTrack.pTrack = pendingTrack.pTrack;
+        preparedTrack.relativePath = pendingTrack.relativePath;
+        preparedTrack.externalTrackId = pendingTrack.externalTrackId;
+        const TrackPointer& pTrack = pendingTrack.pTrack;
+
+        // Only export supported file types.
+        if (!kSupportedFileTypes.contains(pTrack->getType())) {
+            qInfo() << "Skipping file" << pTrack->getFileInfo().fileName()
+                    << "(id" << pTrack->getId() << ") as its file type"
+                    << pTrack->getType() << "is not supported";
+            preparedTrack.skipped = true;
+            return preparedTrack;
+        }
+
+        qInfo() << "Exporting track" << pTrack->getId().toString()
+                << "at" << pTrack->getFileInfo().location() << "...";
+        try {
+            // Copy the file, if required.
+            exportFile(m_pRequest, pTrack);
+
+            preparedTrack.digest = calculateExportDigest(pTrack,
+                    pendingTrack.waveformAnalysis,
+                    pendingTrack.relativePath);
+            if (pendingTrack.externalTrackId &&
+                    preparedTrack.digest == pendingTrack.previousDigest) {
+                preparedTrack.unchanged = true;
+                return preparedTrack;
+            }
+
+            // Load high-resolution waveform from analysis data.
+            std::unique_ptr<Waveform> pWaveform;
+            AnalysisDao::AnalysisInfo waveformAnalysis = pendingTrack.waveformAnalysis;
+            if (waveformAnalysis.analysisId != -1 &&
+                    m_pAnalysisDao->loadAnalysisData(&waveformAnalysis)) {
+                pWaveform.reset(WaveformFactory::loadWaveformFromAnalysis(
+                        waveformAnalysis));
+            }
+
+            convertTrack(&preparedTrack.snapshot, m_dbVersion, pTrack, pWaveform.get());
+        } catch (std::exception& e) {
+            preparedTrack.errorMessage = QString::fromStdString(e.what());
+        }
+        return preparedTrack;
+    }
+
+  private:
+    QSharedPointer<EnginePrimeExportRequest> m_pRequest;
+    e::engine_version m_dbVersion;
+    const AnalysisDao* m_pAnalysisDao;
+};
 
-void exportTrack(
-        const QSharedPointer<EnginePrimeExportRequest> pRequest,
+/// Writes a converted track into the external database.
+int64_t writeTrack(
         djinterop::database* pDatabase,
-        const e::engine_version& dbVersion,
-        QHash<TrackId, int64_t>* pMixxxToEnginePrimeTrackIdMap,
-        const TrackPointer pTrack,
-        const Waveform* pWaveform) {
-    // Only export supported file types.
-    if (!kSupportedFileTypes.contains(pTrack->getType())) {
-        qInfo() << "Skipping file" << pTrack->getFileInfo().fileName()
-                << "(id" << pTrack->getId() << ") as its file type"
-                << pTrack->getType() << "is not supported";
-        return;
+        const PreparedTrack& preparedTrack) {
+    const auto& converted = preparedTrack.snapshot;
+
+    // Attempt to load the track in the database, using the relative path to
+    // the music file.  If it exists already, take a snapshot of the track and
+    // update it.  If it does not exist, we'll create a new snapshot.
+    auto externalTrack = getTrackByRelativePath(pDatabase, preparedTrack.relativePath);
+    if (!externalTrack) {
+        auto snapshot = converted;
+        snapshot.relative_path = preparedTrack.relativePath.toStdString();
+        return pDatabase->create_track(snapshot).id();
     }
 
-    // Copy the file, if required.
-    const auto musicFileRelativePath = exportFile(pRequest, pTrack);
+    auto snapshot = externalTrack->snapshot();
+    snapshot.relative_path = preparedTrack.relativePath.toStdString();
+    snapshot.track_number = converted.track_number;
+    snapshot.duration = converted.duration;
+    snapshot.bpm = converted.bpm;
+    snapshot.year = converted.year;
+    snapshot.title = converted.title;
+    snapshot.artist = converted.artist;
+    snapshot.album = converted.album;
+    snapshot.genre = converted.genre;
+    snapshot.comment = converted.comment;
+    snapshot.composer = converted.composer;
+    snapshot.key = converted.key;
+    snapshot.bitrate = converted.bitrate;
+    snapshot.rating = converted.rating;
+    snapshot.file_bytes = converted.file_bytes;
+    snapshot.sample_count = converted.sample_count;
+    snapshot.sample_rate = converted.sample_rate;
+    snapshot.average_loudness = converted.average_loudness;
+    snapshot.main_cue = converted.main_cue;
+    if (!converted.beatgrid.empty()) {
+        snapshot.beatgrid = converted.beatgrid;
+    }
 
-    // Export meta-data.
-    exportMetadata(pDatabase,
-            dbVersion,
-            pMixxxToEnginePrimeTrackIdMap,
-            pTrack,
-            pWaveform,
-            musicFileRelativePath);
+    // Note that any existing hot cues on the track are kept in place, if Mixxx
+    // does not have a hot cue at that location.
+    snapshot.hot_cues.resize(kMaxHotCues);
+    for (int i = 0; i < kMaxHotCues; ++i) {
+        if (converted.hot_cues[i]) {
+            snapshot.hot_cues[i] = converted.hot_cues[i];
+        }
+    }
+
+    if (!converted.waveform.empty()) {
+        snapshot.waveform = converted.waveform;
+    }
+
+    externalTrack->update(snapshot);
+    return externalTrack->id();
 }
 
 void exportCrate(
@@ -367,6 +585,7 @@ EnginePrimeExportJob::EnginePrimeExportJob(
         TrackCollectionManager* pTrackCollectionManager,
         QSharedPointer<EnginePrimeExportRequest> pRequest)
         : QThread{parent},
+          m_pAnalysisDao(nullptr),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_pRequest{pRequest} {
     // Must be collocated with the TrackCollectionManager.
@@ -381,6 +600,8 @@ EnginePrimeExportJob::EnginePrimeExportJob(
 void EnginePrimeExportJob::loadIds(const QSet<CrateId>& crateIds) {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(m_pTrackCollectionManager);
 
+    m_pAnalysisDao = &m_pTrackCollectionManager->internalCollection()->getAnalysisDAO();
+
     if (crateIds.isEmpty()) {
         // No explicit crate ids specified, meaning we want to export the
         // whole library, plus all non-empty crates.  Start by building a list
@@ -435,33 +656,46 @@ void EnginePrimeExportJob::loadIds(const QSet<CrateId>& crateIds) {
             auto result = m_pTrackCollectionManager->internalCollection()
                                   ->crates()
                                   .selectCrateTracksSorted(crateId);
+            QList<TrackId> trackIds;
             while (result.next()) {
-                const auto trackId = result.trackId();
-                const auto location = m_pTrackCollectionManager->internalCollection()
-                                              ->getTrackDAO()
-                                              .getTrackLocation(trackId);
+                trackIds.append(result.trackId());
+            }
+            // Load the locations of all tracks at once
+            const auto locations = m_pTrackCollectionManager->internalCollection()
+                                           ->getTrackDAO()
+                                           .getTrackFields(
+                                                   QSet<TrackId>(trackIds.begin(), trackIds.end()),
+                                                   {QStringLiteral("track_locations.location")});
+            for (const auto& trackId : std::as_const(trackIds)) {
+                const auto location = locations.value(trackId).value(0).toString();
                 m_trackRefs.append(TrackRef::fromFilePath(location, trackId));
             }
         }
     }
 }
 
-void EnginePrimeExportJob::loadTrack(const TrackRef& trackRef) {
+void EnginePrimeExportJob::loadTracks(int firstIndex, int count) {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(m_pTrackCollectionManager);
 
-    // Load the track.
-    m_pLastLoadedTrack = m_pTrackCollectionManager->getOrAddTrack(trackRef);
-
-    // Load high-resolution waveform from analysis info.
+    m_lastLoadedTracks.clear();
+    m_lastLoadedWaveformAnalyses.clear();
     auto& analysisDao = m_pTrackCollectionManager->internalCollection()->getAnalysisDAO();
-    const auto waveformAnalyses = analysisDao.getAnalysesForTrackByType(
-            m_pLastLoadedTrack->getId(), AnalysisDao::TYPE_WAVEFORM);
-    if (!waveformAnalyses.isEmpty()) {
-        const auto& waveformAnalysis = waveformAnalyses.first();
-        m_pLastLoadedWaveform.reset(
-                WaveformFactory::loadWaveformFromAnalysis(waveformAnalysis));
-    } else {
-        m_pLastLoadedWaveform.reset();
+    for (int i = firstIndex; i < firstIndex + count; ++i) {
+        // Load the track.
+        const auto pTrack = m_pTrackCollectionManager->getOrAddTrack(m_trackRefs.at(i));
+        if (!pTrack) {
+            qWarning() << "Failed to load track" << m_trackRefs.at(i);
+            continue;
+        }
+        m_lastLoadedTracks.append(pTrack);
+
+        // Reading and decoding the high-resolution waveform is left to the
+        // export workers.
+        const auto waveformAnalyses = analysisDao.getAnalysisInfosForTrackByType(
+                pTrack->getId(), AnalysisDao::TYPE_WAVEFORM);
+        m_lastLoadedWaveformAnalyses.append(waveformAnalyses.isEmpty()
+                        ? AnalysisDao::AnalysisInfo()
+                        : waveformAnalyses.first());
     }
 }
 
@@ -526,50 +760,149 @@ void EnginePrimeExportJob::run() {
     ++currProgress;
     emit jobProgress(currProgress);
 
+    // The digests of the tracks that have been exported into this database
+    // before, which allow to skip writing unmodified tracks again.
+    const QString digestsFilePath =
+            m_pRequest->engineLibraryDbDir.filePath(kExportDigestsFileName);
+    QHash<QString, QString> exportDigests = loadExportDigests(digestsFilePath);
+
     // We will build up a map from Mixxx track id to EL track id during export.
     QHash<TrackId, int64_t> mixxxToEnginePrimeTrackIdMap;
 
-    for (const auto& trackRef : std::as_const(m_trackRefs)) {
-        // Load each track.
+    // Loads the next chunk of tracks and starts preparing it concurrently.
+    // Returns a future without results after the last chunk.
+    int nextTrackIndex = 0;
+    const TrackPreparer trackPreparer{m_pRequest, dbVersion, m_pAnalysisDao};
+    const auto prepareNextChunk = [&]() {
+        QList<PendingTrack> pendingTracks;
+        if (nextTrackIndex >= m_trackRefs.size() ||
+                m_cancellationRequested.loadAcquire() != 0) {
+            return QtConcurrent::mapped(pendingTracks, trackPreparer);
+        }
+        const int count = std::min(kTrackChunkSize,
+                static_cast<int>(m_trackRefs.size()) - nextTrackIndex);
+
         // Note that loading must happen on the same thread as the track collection
         // manager, which is not the same as this method's worker thread.
         QMetaObject::invokeMethod(
                 this,
-                "loadTrack",
+                "loadTracks",
                 Qt::BlockingQueuedConnection,
-                Q_ARG(TrackRef, trackRef));
-
-        if (m_cancellationRequested.loadAcquire() != 0) {
-            qInfo() << "Cancelling export";
-            return;
+                Q_ARG(int, nextTrackIndex),
+                Q_ARG(int, count));
+        nextTrackIndex += count;
+        // Tracks that failed to load are skipped
+        currProgress += count - static_cast<int>(m_lastLoadedTracks.size());
+
+        DEBUG_ASSERT(m_lastLoadedTracks.size() == m_lastLoadedWaveformAnalyses.size());
+        for (int i = 0; i < m_lastLoadedTracks.size(); ++i) {
+            PendingTrack pendingTrack;
+            pendingTrack.pTrack = m_lastLoadedTracks.at(i);
+            pendingTrack.waveformAnalysis = m_lastLoadedWaveformAnalyses.at(i);
+            pendingTrack.relativePath = m_pRequest->engineLibraryDbDir.relativeFilePath(
+                    exportedFilePath(m_pRequest, pendingTrack.pTrack));
+            pendingTrack.previousDigest = exportDigests.value(pendingTrack.relativePath);
+            if (!pendingTrack.previousDigest.isEmpty()) {
+                // The track might have been removed from the database in
+                // the meantime, e.g. by Engine Prime.
+                const auto externalTrack = getTrackByRelativePath(
+                        pDb.get(), pendingTrack.relativePath);
+                if (externalTrack) {
+                    pendingTrack.externalTrackId = externalTrack->id();
+                }
+            }
+            pendingTracks.append(pendingTrack);
         }
+        m_lastLoadedTracks.clear();
+        m_lastLoadedWaveformAnalyses.clear();
+        return QtConcurrent::mapped(pendingTracks, trackPreparer);
+    };
 
-        DEBUG_ASSERT(m_pLastLoadedTrack != nullptr);
+    QFuture<PreparedTrack> preparedTracksFuture;
+    try {
+        preparedTracksFuture = prepareNextChunk();
+    } catch (std::exception& e) {
+        qWarning() << "Failed to look up exported tracks:" << e.what();
+        m_lastErrorMessage = e.what();
+        emit failed(m_lastErrorMessage);
+        return;
+    }
+    while (true) {
+        const QList<PreparedTrack> preparedTracks = preparedTracksFuture.results();
+        if (preparedTracks.isEmpty()) {
+            break;
+        }
 
-        qInfo() << "Exporting track" << m_pLastLoadedTrack->getId().toString()
-                << "at" << m_pLastLoadedTrack->getFileInfo().location() << "...";
+        // Prepare the next chunk while this one is written, so that copying
+        // and converting overlaps with the database updates.
         try {
-            exportTrack(m_pRequest,
-                    pDb.get(),
-                    dbVersion,
-                    &mixxxToEnginePrimeTrackIdMap,
-                    m_pLastLoadedTrack,
-                    m_pLastLoadedWaveform.get());
+            preparedTracksFuture = prepareNextChunk();
         } catch (std::exception& e) {
-            qWarning() << "Failed to export track"
-                       << m_pLastLoadedTrack->getId().toString() << ":"
-                       << e.what();
+            qWarning() << "Failed to look up exported tracks:" << e.what();
             m_lastErrorMessage = e.what();
             emit failed(m_lastErrorMessage);
             return;
         }
 
-        m_pLastLoadedTrack.reset();
+        for (const auto& preparedTrack : preparedTracks) {
+            if (m_cancellationRequested.loadAcquire() != 0) {
+                qInfo() << "Cancelling export";
+                preparedTracksFuture.cancel();
+                preparedTracksFuture.waitForFinished();
+                return;
+            }
 
-        ++currProgress;
-        emit jobProgress(currProgress);
+            const TrackPointer& pTrack = preparedTrack.pTrack;
+            if (!preparedTrack.errorMessage.isEmpty()) {
+                qWarning() << "Failed to export track"
+                           << pTrack->getId().toString() << ":"
+                           << preparedTrack.errorMessage;
+                m_lastErrorMessage = preparedTrack.errorMessage;
+                emit failed(m_lastErrorMessage);
+                preparedTracksFuture.cancel();
+                preparedTracksFuture.waitForFinished();
+                return;
+            }
+
+            if (!preparedTrack.skipped) {
+                int64_t externalTrackId;
+                if (preparedTrack.unchanged) {
+                    DEBUG_ASSERT(preparedTrack.externalTrackId);
+                    qDebug() << "Track" << pTrack->getId()
+                             << "has not been modified since the last export";
+                    externalTrackId = *preparedTrack.externalTrackId;
+                } else {
+                    try {
+                        externalTrackId = writeTrack(pDb.get(), preparedTrack);
+                    } catch (std::exception& e) {
+                        qWarning() << "Failed to export track"
+                                   << pTrack->getId().toString() << ":"
+                                   << e.what();
+                        m_lastErrorMessage = e.what();
+                        emit failed(m_lastErrorMessage);
+                        preparedTracksFuture.cancel();
+                        preparedTracksFuture.waitForFinished();
+                        return;
+                    }
+                    exportDigests.insert(preparedTrack.relativePath, preparedTrack.digest);
+                }
+
+                // Record the mapping from Mixxx track id to exported track id.
+                mixxxToEnginePrimeTrackIdMap.insert(pTrack->getId(), externalTrackId);
+            }
+
+            ++currProgress;
+            emit jobProgress(currProgress);
+        }
+    }
+
+    if (m_cancellationRequested.loadAcquire() != 0) {
+        qInfo() << "Cancelling export";
+        return;
     }
 
+    saveExportDigests(digestsFilePath, exportDigests);
+
     // We will ensure that there is a special top-level crate representing the
     // root of all Mixxx-exported items.  Mixxx tracks and crates will exist
     // underneath this crate.
@@ -5,8 +5,8 @@
 #include <QSet>
 #include <QSharedPointer>
 #include <QThread>
-#include <memory>
 
+#include "library/dao/analysisdao.h"
 #include "library/trackset/crate/crate.h"
 #include "library/trackset/crate/crateid.h"
 #include "track/track_decl.h"
@@ -14,7 +14,6 @@
 #include "track/trackref.h"
 
 class TrackCollectionManager;
-class Waveform;
 
 namespace mixxx {
 
@@ -24,6 +23,13 @@ struct EnginePrimeExportRequest;
 /// library to an external Engine Prime (also known as "Engine Library")
 /// database, using the libdjinterop library, in accordance with the export
 /// request with which it is constructed.
+///
+/// Tracks are exported in a pipeline. They are loaded from the Mixxx
+/// database in chunks on the main thread. The music files of a chunk are
+/// copied and its waveforms and beat grids are converted concurrently by
+/// worker threads, while the previous chunk is written to the external
+/// database by the job thread. Tracks that have not been modified since
+/// the last export into the same database are not written again.
 class EnginePrimeExportJob : public QThread {
     Q_OBJECT
   public:
@@ -57,14 +63,17 @@ class EnginePrimeExportJob : public QThread {
     // thread of the application, which will be different to the worker thread
     // used by an instance of this class.
     void loadIds(const QSet<CrateId>& crateIdsToExport);
-    void loadTrack(const TrackRef& trackRef);
+    void loadTracks(int firstIndex, int count);
     void loadCrate(const CrateId& crateId);
 
   private:
     QList<TrackRef> m_trackRefs;
     QList<CrateId> m_crateIds;
-    TrackPointer m_pLastLoadedTrack;
-    std::unique_ptr<Waveform> m_pLastLoadedWaveform;
+    const AnalysisDao* m_pAnalysisDao;
+    QList<TrackPointer> m_lastLoadedTracks;
+    // Only the metadata of the waveform analyses without their data and
+    // an invalid analysis for each track without a waveform
+    QList<AnalysisDao::AnalysisInfo> m_lastLoadedWaveformAnalyses;
     Crate m_lastLoadedCrate;
     QList<TrackId> m_lastLoadedCrateTrackIds;
 
@@ -26,7 +26,10 @@ bool TrackExportWizard::selectDestinationDirectory() {
     m_pConfig->set(ConfigKey("[Library]", "LastTrackCopyDirectory"),
                    ConfigValue(destDir));
 
-    m_worker.reset(new TrackExportWorker(destDir, m_tracks));
+    const int maxParallelCopies = m_pConfig->getValue(
+            ConfigKey("[Library]", "TrackCopyMaxParallelCopies"),
+            TrackExportWorker::kDefaultMaxParallelCopies);
+    m_worker.reset(new TrackExportWorker(destDir, m_tracks, maxParallelCopies));
     m_dialog.reset(new TrackExportDlg(m_parent, m_pConfig, m_worker.data()));
     return true;
 }
@@ -2,9 +2,14 @@
 
 #include <QDebug>
 #include <QFileInfo>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
 
 #include "moc_trackexportworker.cpp"
 #include "track/track.h"
+#include "util/filecopy.h"
 
 namespace {
 
@@ -68,80 +73,123 @@ QMap<QString, mixxx::FileInfo> createCopylist(const TrackPointerList& tracks) {
 }  // namespace
 
 void TrackExportWorker::run() {
-    int i = 0;
     QMap<QString, mixxx::FileInfo> copy_list = createCopylist(m_tracks);
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(std::max(m_maxParallelCopies, 1));
+
+    // Start copying each file as soon as we know where it goes.  A
+    // future without a result is stored for each file that is skipped.
+    emit progress(copy_list.isEmpty() ? QString() : copy_list.first().fileName(),
+            0,
+            copy_list.size());
+    QList<QFuture<QString>> copies;
     for (auto it = copy_list.constBegin(); it != copy_list.constEnd(); ++it) {
-        // We emit progress twice per loop, which may seem excessive, but it
-        // guarantees that we emit a sane progress before we start and after
-        // we end.  In between, each filename will get its own visible tick
-        // on the bar, which looks really nice.
-        emit progress(it->fileName(), i, copy_list.size());
-        copyFile(*it, it.key());
         if (m_bStop.loadAcquire()) {
-            emit canceled();
-            return;
+            break;
+        }
+        if (!prepareDestination(*it, it.key())) {
+            copies.append(QFuture<QString>());
+            continue;
+        }
+        const mixxx::FileInfo source_fileinfo = *it;
+        const QString dest_filename = it.key();
+        copies.append(QtConcurrent::run(&threadPool, [this, source_fileinfo, dest_filename] {
+            if (m_bStop.loadAcquire()) {
+                return QString();
+            }
+            return copyFile(source_fileinfo, dest_filename);
+        }));
+    }
+
+    // Progress is reported in order, once per file.  Signals are emitted
+    // from this thread only.
+    int i = 0;
+    for (auto it = copy_list.constBegin(); it != copy_list.constEnd(); ++it) {
+        if (i >= copies.size()) {
+            break;
+        }
+        QFuture<QString>& copy = copies[i];
+        copy.waitForFinished();
+        if (copy.resultCount() > 0) {
+            const QString error_message = copy.result();
+            if (!error_message.isEmpty() && m_errorMessage.isEmpty()) {
+                qWarning() << error_message;
+                m_errorMessage = error_message;
+                stop();
+            }
         }
         ++i;
         emit progress(it->fileName(), i, copy_list.size());
     }
+    threadPool.waitForDone();
+
+    if (m_bStop.loadAcquire()) {
+        emit canceled();
+    }
 }
 
-void TrackExportWorker::copyFile(
+bool TrackExportWorker::prepareDestination(
         const mixxx::FileInfo& source_fileinfo,
         const QString& dest_filename) {
     QString sourceFilename = source_fileinfo.canonicalLocation();
     const QString dest_path = QDir(m_destDir).filePath(dest_filename);
     QFileInfo dest_fileinfo(dest_path);
 
-    if (dest_fileinfo.exists()) {
-        switch (m_overwriteMode) {
-        // Give the user the option to overwrite existing files in the destination.
-        case OverwriteMode::ASK:
-            switch (makeOverwriteRequest(dest_path)) {
-            case OverwriteAnswer::SKIP:
-            case OverwriteAnswer::SKIP_ALL:
-                qDebug() << "skipping" << sourceFilename;
-                return;
-            case OverwriteAnswer::OVERWRITE:
-            case OverwriteAnswer::OVERWRITE_ALL:
-                break;
-            case OverwriteAnswer::CANCEL:
-                m_errorMessage = tr("Export process was canceled");
-                stop();
-                return;
-            }
-            break;
-        case OverwriteMode::SKIP_ALL:
-            qDebug() << "skipping" << sourceFilename;
-            return;
-        case OverwriteMode::OVERWRITE_ALL:;
-        }
+    if (!dest_fileinfo.exists()) {
+        return true;
+    }
 
-        // Remove the existing file in preparation for overwriting.
-        QFile dest_file(dest_path);
-        qDebug() << "Removing existing file" << dest_path;
-        if (!dest_file.remove()) {
-            const QString error_message = tr(
-                    "Error removing file %1: %2. Stopping.").arg(
-                    dest_path, dest_file.errorString());
-            qWarning() << error_message;
-            m_errorMessage = error_message;
+    switch (m_overwriteMode) {
+    // Give the user the option to overwrite existing files in the destination.
+    case OverwriteMode::ASK:
+        switch (makeOverwriteRequest(dest_path)) {
+        case OverwriteAnswer::SKIP:
+        case OverwriteAnswer::SKIP_ALL:
+            qDebug() << "skipping" << sourceFilename;
+            return false;
+        case OverwriteAnswer::OVERWRITE:
+        case OverwriteAnswer::OVERWRITE_ALL:
+            break;
+        case OverwriteAnswer::CANCEL:
+            m_errorMessage = tr("Export process was canceled");
             stop();
-            return;
+            return false;
         }
+        break;
+    case OverwriteMode::SKIP_ALL:
+        qDebug() << "skipping" << sourceFilename;
+        return false;
+    case OverwriteMode::OVERWRITE_ALL:;
     }
 
-    qDebug() << "Copying" << sourceFilename << "to" << dest_path;
-    QFile source_file(sourceFilename);
-    if (!source_file.copy(dest_path)) {
+    // Remove the existing file in preparation for overwriting.
+    QFile dest_file(dest_path);
+    qDebug() << "Removing existing file" << dest_path;
+    if (!dest_file.remove()) {
         const QString error_message = tr(
-                "Error exporting track %1 to %2: %3. Stopping.").arg(
-                sourceFilename, dest_path, source_file.errorString());
+                "Error removing file %1: %2. Stopping.").arg(
+                dest_path, dest_file.errorString());
         qWarning() << error_message;
         m_errorMessage = error_message;
         stop();
-        return;
+        return false;
+    }
+    return true;
+}
+
+QString TrackExportWorker::copyFile(
+        const mixxx::FileInfo& source_fileinfo,
+        const QString& dest_filename) const {
+    QString sourceFilename = source_fileinfo.canonicalLocation();
+    const QString dest_path = QDir(m_destDir).filePath(dest_filename);
+
+    qDebug() << "Copying" << sourceFilename << "to" << dest_path;
+    QString copy_error;
+    if (!mixxx::copyFile(sourceFilename, dest_path, &copy_error)) {
+        return tr("Error exporting track %1 to %2: %3. Stopping.").arg(
+                sourceFilename, dest_path, copy_error);
     }
+    return QString();
 }
 
 TrackExportWorker::OverwriteAnswer TrackExportWorker::makeOverwriteRequest(
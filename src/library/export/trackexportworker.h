@@ -11,9 +11,10 @@ class FileInfo;
 } // namespace mixxx
 
 // A QThread class for copying a list of files to a single destination directory.
-// Currently does not preserve subdirectory relationships.  This class performs
-// all copies in a blocking style within its own thread.  May be canceled from
-// another thread.
+// Currently does not preserve subdirectory relationships.  Questions about
+// existing files are asked one after another from its own thread, while the
+// files are copied in parallel by a thread pool as soon as their destination
+// is known.  May be canceled from another thread.
 class TrackExportWorker : public QThread {
     Q_OBJECT
   public:
@@ -33,10 +34,18 @@ class TrackExportWorker : public QThread {
         CANCEL = -1,
     };
 
+    // Copying a few files in parallel keeps fast devices busy, while
+    // slow devices are not slowed down noticeably.
+    static constexpr int kDefaultMaxParallelCopies = 4;
+
     // Constructor does not validate the destination directory.  Calling classes
     // should do that.
-    TrackExportWorker(const QString& destDir, const TrackPointerList& tracks)
-            : m_destDir(destDir), m_tracks(tracks) {
+    TrackExportWorker(const QString& destDir,
+            const TrackPointerList& tracks,
+            int maxParallelCopies = kDefaultMaxParallelCopies)
+            : m_destDir(destDir),
+              m_tracks(tracks),
+              m_maxParallelCopies(maxParallelCopies) {
     }
     virtual ~TrackExportWorker() { };
 
@@ -49,7 +58,7 @@ class TrackExportWorker : public QThread {
         return m_errorMessage;
     }
 
-    // Cancels the export after the current copy operation.
+    // Cancels the export after the current copy operations.
     // May be called from another thread.
     void stop();
 
@@ -66,14 +75,19 @@ class TrackExportWorker : public QThread {
     void canceled();
 
   private:
-    // Copies the file at source_fileinfo to the destination directory with the
-    // name given by dest_filename (not a full path).  If the destination file
-    // exists, will emit an overwrite request signal to ask how to proceed.
-    // On unrecoverable error, sets the error message and stops the export
-    // process entirely.
-    void copyFile(const mixxx::FileInfo& source_fileinfo,
+    // Prepares copying to the destination directory with the name given by
+    // dest_filename (not a full path).  If the destination file exists, will
+    // emit an overwrite request signal to ask how to proceed.  Returns false
+    // if the file should not be copied.  On unrecoverable error, sets the
+    // error message and stops the export process entirely.
+    bool prepareDestination(const mixxx::FileInfo& source_fileinfo,
             const QString& dest_filename);
 
+    // Copies the file at source_fileinfo to the destination directory.  Invoked
+    // concurrently and returns an error message on failure.
+    QString copyFile(const mixxx::FileInfo& source_fileinfo,
+            const QString& dest_filename) const;
+
     // Emit a signal requesting overwrite mode, and block until we get an
     // answer.  Updates m_overwriteMode appropriately.
     OverwriteAnswer makeOverwriteRequest(const QString& filename);
@@ -84,4 +98,5 @@ class TrackExportWorker : public QThread {
     OverwriteMode m_overwriteMode = OverwriteMode::ASK;
     const QString m_destDir;
     const TrackPointerList m_tracks;
+    const int m_maxParallelCopies;
 };
@@ -0,0 +1,91 @@
+#include "library/externallibraryfingerprint.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+
+namespace {
+
+// Separates the fields of the serialized fingerprint. File paths may
+// contain any other printable character.
+const QChar kSeparator = QChar('\n');
+
+QByteArray hashFileContent(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) {
+        return QByteArray();
+    }
+    return hash.result().toHex();
+}
+
+} // anonymous namespace
+
+// static
+ExternalLibraryFingerprint ExternalLibraryFingerprint::ofFile(
+        const QString& filePath) {
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile()) {
+        return ExternalLibraryFingerprint();
+    }
+    ExternalLibraryFingerprint fingerprint;
+    fingerprint.m_filePath = fileInfo.absoluteFilePath();
+    fingerprint.m_fileSize = fileInfo.size();
+    fingerprint.m_lastModifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+    fingerprint.m_contentHash = hashFileContent(filePath);
+    if (!fingerprint.isValid()) {
+        return ExternalLibraryFingerprint();
+    }
+    return fingerprint;
+}
+
+// static
+ExternalLibraryFingerprint ExternalLibraryFingerprint::fromString(
+        const QString& str) {
+    const QStringList fields = str.split(kSeparator);
+    if (fields.size() != 4) {
+        return ExternalLibraryFingerprint();
+    }
+    ExternalLibraryFingerprint fingerprint;
+    bool fileSizeValid = false;
+    bool lastModifiedValid = false;
+    fingerprint.m_filePath = fields[0];
+    fingerprint.m_fileSize = fields[1].toLongLong(&fileSizeValid);
+    fingerprint.m_lastModifiedMs = fields[2].toLongLong(&lastModifiedValid);
+    fingerprint.m_contentHash = fields[3].toLatin1();
+    if (!fileSizeValid || !lastModifiedValid || !fingerprint.isValid()) {
+        return ExternalLibraryFingerprint();
+    }
+    return fingerprint;
+}
+
+QString ExternalLibraryFingerprint::toString() const {
+    if (!isValid()) {
+        return QString();
+    }
+    return m_filePath + kSeparator +
+            QString::number(m_fileSize) + kSeparator +
+            QString::number(m_lastModifiedMs) + kSeparator +
+            QString::fromLatin1(m_contentHash);
+}
+
+bool ExternalLibraryFingerprint::matchesFile(const QString& filePath) const {
+    if (!isValid()) {
+        return false;
+    }
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile() ||
+            fileInfo.absoluteFilePath() != m_filePath ||
+            fileInfo.size() != m_fileSize) {
+        return false;
+    }
+    if (fileInfo.lastModified().toMSecsSinceEpoch() == m_lastModifiedMs) {
+        return true;
+    }
+    return hashFileContent(filePath) == m_contentHash;
+}
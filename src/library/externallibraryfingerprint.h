@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+/// Identifies the contents of the database file of an external library,
+/// e.g. the iTunes XML or the Traktor collection.nml, for detecting if it
+/// has changed since the last import.
+///
+/// A fingerprint consists of the file path, the file size, the time of the
+/// last modification and a hash of the contents. The contents only need to
+/// be hashed again if the size matches but the modification time doesn't,
+/// e.g. after the file has been rewritten with the same contents.
+class ExternalLibraryFingerprint final {
+  public:
+    ExternalLibraryFingerprint() = default;
+
+    /// Reads the file and computes its fingerprint. Returns an invalid
+    /// fingerprint if the file cannot be read.
+    static ExternalLibraryFingerprint ofFile(const QString& filePath);
+
+    /// Parses a fingerprint that has been stored with toString(). Returns an
+    /// invalid fingerprint if the string is empty or malformed.
+    static ExternalLibraryFingerprint fromString(const QString& str);
+    QString toString() const;
+
+    bool isValid() const {
+        return m_fileSize >= 0 && !m_contentHash.isEmpty();
+    }
+
+    /// Returns true if the file still has the contents from when this
+    /// fingerprint was computed.
+    bool matchesFile(const QString& filePath) const;
+
+    friend bool operator==(
+            const ExternalLibraryFingerprint& lhs,
+            const ExternalLibraryFingerprint& rhs) {
+        return lhs.m_filePath == rhs.m_filePath &&
+                lhs.m_fileSize == rhs.m_fileSize &&
+                lhs.m_lastModifiedMs == rhs.m_lastModifiedMs &&
+                lhs.m_contentHash == rhs.m_contentHash;
+    }
+    friend bool operator!=(
+            const ExternalLibraryFingerprint& lhs,
+            const ExternalLibraryFingerprint& rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    QString m_filePath;
+    qint64 m_fileSize = -1;
+    qint64 m_lastModifiedMs = -1;
+    QByteArray m_contentHash;
+};
@@ -8,6 +8,7 @@
 #include "library/itunes/itunespathmapping.h"
 #include "library/queryutil.h"
 #include "library/treeitem.h"
+#include "util/assert.h"
 
 std::ostream& operator<<(std::ostream& os, const ITunesTrack& track) {
     os << "ITunesTrack { "
@@ -41,9 +42,11 @@ std::ostream& operator<<(std::ostream& os, const ITunesPlaylist& playlist) {
 }
 
 void ITunesDAO::initialize(const QSqlDatabase& database) {
+    m_database = database;
     m_insertTrackQuery = QSqlQuery(database);
     m_insertPlaylistQuery = QSqlQuery(database);
     m_insertPlaylistTrackQuery = QSqlQuery(database);
+    m_insertPlaylistRelationQuery = QSqlQuery(database);
     m_applyPathMappingQuery = QSqlQuery(database);
 
     m_insertTrackQuery.prepare(
@@ -60,6 +63,10 @@ void ITunesDAO::initialize(const QSqlDatabase& database) {
             "INSERT INTO itunes_playlist_tracks (playlist_id, track_id, "
             "position) VALUES (:playlist_id, :track_id, :position)");
 
+    m_insertPlaylistRelationQuery.prepare(
+            "INSERT INTO itunes_playlist_tree (parent_id, playlist_id) "
+            "VALUES (:parent_id, :playlist_id)");
+
     m_applyPathMappingQuery.prepare(
             "UPDATE itunes_library SET location = replace( location, "
             ":itunes_path, :mixxx_path )");
@@ -118,6 +125,18 @@ bool ITunesDAO::importPlaylist(const ITunesPlaylist& playlist) {
 }
 
 bool ITunesDAO::importPlaylistRelation(int parentId, int childId) {
+    if (m_isDatabaseInitialized) {
+        QSqlQuery& query = m_insertPlaylistRelationQuery;
+
+        query.bindValue(":parent_id", parentId);
+        query.bindValue(":playlist_id", childId);
+
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+
     m_playlistIdsByParentId.insert({parentId, childId});
     return true;
 }
@@ -156,6 +175,40 @@ bool ITunesDAO::applyPathMapping(const ITunesPathMapping& pathMapping) {
     return true;
 }
 
+bool ITunesDAO::loadPlaylistTree() {
+    VERIFY_OR_DEBUG_ASSERT(m_isDatabaseInitialized) {
+        return false;
+    }
+    m_playlistNameById.clear();
+    m_playlistIdsByParentId.clear();
+
+    QSqlQuery playlistQuery(m_database);
+    playlistQuery.prepare("SELECT id, name FROM itunes_playlists");
+    if (!playlistQuery.exec()) {
+        LOG_FAILED_QUERY(playlistQuery);
+        return false;
+    }
+    while (playlistQuery.next()) {
+        m_playlistNameById[playlistQuery.value(0).toInt()] =
+                playlistQuery.value(1).toString();
+    }
+
+    // The tree is restored in the order of the original import
+    QSqlQuery treeQuery(m_database);
+    treeQuery.prepare(
+            "SELECT parent_id, playlist_id FROM itunes_playlist_tree "
+            "ORDER BY id");
+    if (!treeQuery.exec()) {
+        LOG_FAILED_QUERY(treeQuery);
+        return false;
+    }
+    while (treeQuery.next()) {
+        m_playlistIdsByParentId.insert(
+                {treeQuery.value(0).toInt(), treeQuery.value(1).toInt()});
+    }
+    return true;
+}
+
 void ITunesDAO::appendPlaylistTree(gsl::not_null<TreeItem*> item, int playlistId) {
     auto childsRange = m_playlistIdsByParentId.equal_range(playlistId);
     std::for_each(childsRange.first,
@@ -2,6 +2,7 @@
 
 #include <QDateTime>
 #include <QHash>
+#include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QString>
 #include <gsl/pointers>
@@ -10,7 +11,6 @@
 
 #include "library/dao/dao.h"
 
-class QSqlDatabase;
 struct ITunesPathMapping;
 class TreeItem;
 
@@ -101,6 +101,10 @@ class ITunesDAO : public DAO {
     virtual void appendPlaylistTree(gsl::not_null<TreeItem*> item,
             int playlistId = kRootITunesPlaylistId);
 
+    /// Loads the playlist tree of a previous import from the database
+    /// instead of importing it again.
+    bool loadPlaylistTree();
+
   private:
     QHash<QString, int> m_playlistDuplicatesByName;
     QHash<int, QString> m_playlistNameById;
@@ -116,7 +120,10 @@ class ITunesDAO : public DAO {
     QSqlQuery m_insertTrackQuery;
     QSqlQuery m_insertPlaylistQuery;
     QSqlQuery m_insertPlaylistTrackQuery;
+    QSqlQuery m_insertPlaylistRelationQuery;
     QSqlQuery m_applyPathMappingQuery;
 
+    QSqlDatabase m_database;
+
     QString uniquifyPlaylistName(QString name);
 };
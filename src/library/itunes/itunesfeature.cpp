@@ -13,6 +13,7 @@
 #include "library/baseexternaltrackmodel.h"
 #include "library/basetrackcache.h"
 #include "library/dao/settingsdao.h"
+#include "library/externallibraryfingerprint.h"
 #include "library/itunes/itunesdao.h"
 #include "library/itunes/itunesimporter.h"
 #include "library/itunes/itunesplaylistmodel.h"
@@ -34,6 +35,7 @@
 namespace {
 
 const QString kItdbPathKey = "mixxx.itunesfeature.itdbpath";
+const QString kItdbFingerprintKey = "mixxx.itunesfeature.itdbfingerprint";
 
 bool isMacOSImporterAvailable() {
 #ifdef __MACOS_ITUNES_LIBRARY__
@@ -101,22 +103,10 @@ ITunesFeature::ITunesFeature(Library* pLibrary, UserSettingsPointer pConfig)
     m_isActivated = false;
     m_title = tr("iTunes");
 
-    m_database =
-            QSqlDatabase::cloneDatabase(m_pLibrary->trackCollectionManager()
-                                                ->internalCollection()
-                                                ->database(),
-                    "ITUNES_SCANNER");
-
-    // Open the database connection in this thread.
-    if (!m_database.open()) {
-        qDebug() << "Failed to open database for iTunes scanner." << m_database.lastError();
-    }
     connect(&m_future_watcher,
             &QFutureWatcher<TreeItem*>::finished,
             this,
             &ITunesFeature::onTrackCollectionLoaded);
-
-    m_pITunesTrackModel->setSearch(""); // enable search.
 }
 
 ITunesFeature::~ITunesFeature() {
@@ -158,6 +148,21 @@ void ITunesFeature::bindSidebarWidget(WLibrarySidebar* pSidebarWidget) {
     BaseExternalLibraryFeature::bindSidebarWidget(pSidebarWidget);
 }
 
+void ITunesFeature::initialize() {
+    m_database =
+            QSqlDatabase::cloneDatabase(m_pLibrary->trackCollectionManager()
+                                                ->internalCollection()
+                                                ->database(),
+                    "ITUNES_SCANNER");
+
+    // Open the database connection in this thread.
+    if (!m_database.open()) {
+        qDebug() << "Failed to open database for iTunes scanner." << m_database.lastError();
+    }
+
+    m_pITunesTrackModel->setSearch(""); // enable search.
+}
+
 void ITunesFeature::activate() {
     activate(false);
     emit enableCoverArtDisplay(false);
@@ -165,15 +170,8 @@ void ITunesFeature::activate() {
 
 void ITunesFeature::activate(bool forceReload) {
     //qDebug("ITunesFeature::activate()");
+    initializeOnce();
     if (!m_isActivated || forceReload) {
-
-        //Delete all table entries of iTunes feature
-        ScopedTransaction transaction(m_database);
-        clearTable("itunes_playlist_tracks");
-        clearTable("itunes_library");
-        clearTable("itunes_playlists");
-        transaction.commit();
-
         emit showTrackModel(m_pITunesTrackModel);
 
         SettingsDAO settings(m_pTrackCollection->database());
@@ -214,9 +212,9 @@ void ITunesFeature::activate(bool forceReload) {
         m_isActivated =  true;
         // Let a worker thread do the XML parsing
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        m_future = QtConcurrent::run(&ITunesFeature::importLibrary, this);
+        m_future = QtConcurrent::run(&ITunesFeature::importLibrary, this, forceReload);
 #else
-        m_future = QtConcurrent::run(this, &ITunesFeature::importLibrary);
+        m_future = QtConcurrent::run(this, &ITunesFeature::importLibrary, forceReload);
 #endif
         m_future_watcher.setFuture(m_future);
         m_title = tr("(loading) iTunes");
@@ -256,6 +254,7 @@ bool ITunesFeature::isMacOSImporterUsed() {
 
 void ITunesFeature::onRightClick(const QPoint& globalPos) {
     BaseExternalLibraryFeature::onRightClick(globalPos);
+    initializeOnce();
     QMenu menu(m_pSidebarWidget);
     QAction useDefault(tr("Use Default Library"), &menu);
     QAction chooseNew(tr("Choose Library..."), &menu);
@@ -321,18 +320,49 @@ std::unique_ptr<ITunesImporter> ITunesFeature::makeImporter() {
 
 // This method is executed in a separate thread
 // via QtConcurrent::run
-TreeItem* ITunesFeature::importLibrary() {
+TreeItem* ITunesFeature::importLibrary(bool forceReload) {
     //Give thread a low priority
     QThread* thisThread = QThread::currentThread();
     thisThread->setPriority(QThread::LowPriority);
 
     qDebug() << "ITunesFeature::importLibrary() ";
 
+    SettingsDAO settings(m_database);
+    ExternalLibraryFingerprint fingerprint;
+    if (!isMacOSImporterUsed()) {
+        // The tables still contain the previous import if the XML
+        // file has not changed since then
+        if (!forceReload &&
+                ExternalLibraryFingerprint::fromString(
+                        settings.getValue(kItdbFingerprintKey))
+                        .matchesFile(m_dbfile)) {
+            std::unique_ptr<TreeItem> pRootItem = restorePlaylistTree();
+            if (pRootItem) {
+                qDebug() << "iTunes library is unchanged since the last import";
+                return pRootItem.release();
+            }
+        }
+        // Computed before parsing to detect modifications while importing
+        fingerprint = ExternalLibraryFingerprint::ofFile(m_dbfile);
+    }
+
     ScopedTransaction transaction(m_database);
 
+    //Delete all table entries of iTunes feature
+    clearTable("itunes_playlist_tree");
+    clearTable("itunes_playlist_tracks");
+    clearTable("itunes_library");
+    clearTable("itunes_playlists");
+    settings.setValue(kItdbFingerprintKey, QString());
+
     std::unique_ptr<ITunesImporter> importer = makeImporter();
     ITunesImport iTunesImport = importer->importLibrary();
 
+    // Only a complete import may be reused later
+    if (iTunesImport.playlistRoot && !isImportCanceled()) {
+        settings.setValue(kItdbFingerprintKey, fingerprint.toString());
+    }
+
     // Even if an error occurred, commit the transaction. The file may have been
     // half-parsed.
     transaction.commit();
@@ -340,6 +370,17 @@ TreeItem* ITunesFeature::importLibrary() {
     return iTunesImport.playlistRoot.release();
 }
 
+std::unique_ptr<TreeItem> ITunesFeature::restorePlaylistTree() {
+    ITunesDAO dao;
+    dao.initialize(m_database);
+    if (!dao.loadPlaylistTree()) {
+        return nullptr;
+    }
+    std::unique_ptr<TreeItem> pRootItem = TreeItem::newRoot(this);
+    dao.appendPlaylistTree(pRootItem.get());
+    return pRootItem;
+}
+
 void ITunesFeature::clearTable(const QString& table_name) {
     QSqlQuery query(m_database);
     query.prepare("delete from "+table_name);
@@ -39,12 +39,15 @@ class ITunesFeature : public BaseExternalLibraryFeature {
     void onTrackCollectionLoaded();
 
   private:
+    void initialize() override;
     std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
             const QString& playlist) override;
     static QString getiTunesMusicPath();
     std::unique_ptr<ITunesImporter> makeImporter();
     // returns the invisible rootItem for the sidebar model
-    TreeItem* importLibrary();
+    TreeItem* importLibrary(bool forceReload);
+    // Restores the sidebar from the tables of the previous import
+    std::unique_ptr<TreeItem> restorePlaylistTree();
     void clearTable(const QString& table_name);
 
     /// Presents an 'open file' dialog for selecting an iTunes library XML and
@@ -83,6 +83,10 @@ Library::Library(
             &TrackCollectionManager::libraryScanFinished,
             this,
             &Library::slotRefreshLibraryModels);
+    connect(m_pTrackCollectionManager,
+            &TrackCollectionManager::libraryDirectoriesScanFinished,
+            this,
+            &Library::slotRefreshLibraryModels);
 
     // TODO(rryan) -- turn this construction / adding of features into a static
     // method or something -- CreateDefaultLibrary
@@ -151,6 +155,10 @@ Library::Library(
             &Library::analyzeTracks,
             m_pAnalysisFeature,
             &AnalysisFeature::analyzeTracks);
+    connect(m_pAnalysisFeature,
+            &AnalysisFeature::analysisActive,
+            this,
+            &Library::analysisActive);
     addFeature(m_pAnalysisFeature);
     // Suspend a batch analysis while an ad-hoc analysis of
     // loaded tracks is in progress and resume it afterwards.
@@ -292,6 +300,28 @@ TrackAnalysisScheduler::Pointer Library::createTrackAnalysisScheduler(
             modeFlags);
 }
 
+bool Library::analyzeCrateByName(const QString& crateName) {
+    const CrateStorage& crates =
+            m_pTrackCollectionManager->internalCollection()->crates();
+    Crate crate;
+    if (!crates.readCrateByName(crateName, &crate)) {
+        kLogger.warning() << "Crate not found:" << crateName;
+        return false;
+    }
+    QList<AnalyzerScheduledTrack> tracks;
+    CrateTrackSelectResult crateTracks(crates.selectCrateTracksSorted(crate.getId()));
+    while (crateTracks.next()) {
+        tracks.append(crateTracks.trackId());
+    }
+    if (tracks.isEmpty()) {
+        kLogger.warning() << "Crate is empty:" << crateName;
+        return false;
+    }
+    kLogger.info() << "Analyzing" << tracks.size() << "tracks of crate" << crateName;
+    emit analyzeTracks(tracks);
+    return true;
+}
+
 void Library::stopPendingTasks() {
     if (m_pAnalysisFeature) {
         m_pAnalysisFeature->stopAnalysis();
@@ -66,6 +66,10 @@ class Library: public QObject {
             int numWorkerThreads,
             AnalyzerModeFlags modeFlags) const;
 
+    /// Starts a batch analysis of all tracks in the crate. Returns false
+    /// if the crate does not exist or is empty.
+    bool analyzeCrateByName(const QString& crateName);
+
     void bindSearchboxWidget(WSearchLineEdit* pSearchboxWidget);
     void bindSidebarWidget(WLibrarySidebar* sidebarWidget);
     void bindLibraryWidget(WLibrary* libraryWidget,
@@ -137,6 +141,7 @@ class Library: public QObject {
     void selectTrack(const TrackId&);
     void trackSelected(TrackPointer pTrack);
     void analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks);
+    void analysisActive(bool active);
 #ifdef __ENGINEPRIME__
     void exportLibrary();
     void exportCrate(CrateId crateId);
@@ -18,6 +18,21 @@ const ConfigKey mixxx::library::prefs::kRescanOnStartupConfigKey =
                 mixxx::library::prefs::kConfigGroup,
                 QStringLiteral("RescanOnStartup")};
 
+const ConfigKey mixxx::library::prefs::kScannerThreadCountConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("ScannerThreadCount")};
+
+const ConfigKey mixxx::library::prefs::kWatchDirectoriesConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("WatchDirectories")};
+
+const ConfigKey mixxx::library::prefs::kLastCompleteScanConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("LastCompleteScan")};
+
 const ConfigKey mixxx::library::prefs::kKeyNotationConfigKey =
         ConfigKey{
                 mixxx::library::prefs::kConfigGroup,
@@ -100,6 +115,21 @@ const ConfigKey mixxx::library::prefs::kCoverArtFetcherQualityConfigKey =
                 mixxx::library::prefs::kConfigGroup,
                 QStringLiteral("CoverArtFetcherQuality")};
 
+const ConfigKey mixxx::library::prefs::kCoverArtMemoryCacheSizeMiBConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("CoverArtMemoryCacheSizeMiB")};
+
+const ConfigKey mixxx::library::prefs::kCoverArtThumbnailCacheSizeMiBConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("CoverArtThumbnailCacheSizeMiB")};
+
+const ConfigKey mixxx::library::prefs::kPreviewPrefetchConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("PreviewPrefetch")};
+
 const ConfigKey mixxx::library::prefs::kTagFetcherApplyTagsConfigKey =
         ConfigKey{
                 mixxx::library::prefs::kConfigGroup,
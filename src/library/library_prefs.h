@@ -14,6 +14,12 @@ extern const QString kConfigGroup;
 
 extern const ConfigKey kRescanOnStartupConfigKey;
 
+extern const ConfigKey kScannerThreadCountConfigKey;
+
+extern const ConfigKey kWatchDirectoriesConfigKey;
+
+extern const ConfigKey kLastCompleteScanConfigKey;
+
 extern const ConfigKey kKeyNotationConfigKey;
 
 extern const ConfigKey kTrackDoubleClickActionConfigKey;
@@ -52,6 +58,18 @@ extern const ConfigKey kUseRelativePathOnExportConfigKey;
 
 extern const ConfigKey kCoverArtFetcherQualityConfigKey;
 
+extern const ConfigKey kCoverArtMemoryCacheSizeMiBConfigKey;
+
+const int kCoverArtMemoryCacheSizeMiBDefault = 64;
+
+extern const ConfigKey kCoverArtThumbnailCacheSizeMiBConfigKey;
+
+const int kCoverArtThumbnailCacheSizeMiBDefault = 256;
+
+extern const ConfigKey kPreviewPrefetchConfigKey;
+
+const bool kPreviewPrefetchDefault = true;
+
 extern const ConfigKey kTagFetcherApplyTagsConfigKey;
 
 extern const ConfigKey kTagFetcherApplyCoverConfigKey;
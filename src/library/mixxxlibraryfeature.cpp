@@ -70,7 +70,8 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
             LIBRARYTABLE_COVERART_LOCATION,
             LIBRARYTABLE_COVERART_COLOR,
             LIBRARYTABLE_COVERART_DIGEST,
-            LIBRARYTABLE_COVERART_HASH};
+            LIBRARYTABLE_COVERART_HASH,
+            LIBRARYTABLE_WAVEFORM};
     QStringList searchColumns = {
             LIBRARYTABLE_ARTIST,
             LIBRARYTABLE_ALBUM,
@@ -84,6 +85,11 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
 
     QStringList qualifiedTableColumns;
     for (const auto& col : columns) {
+        if (col == LIBRARYTABLE_WAVEFORM) {
+            // Painted from the WaveformThumbnailStore
+            qualifiedTableColumns.append(QStringLiteral("NULL AS ") + col);
+            continue;
+        }
         qualifiedTableColumns.append(mixxx::trackschema::tableForColumn(col) +
                 QLatin1Char('.') + col);
     }
@@ -113,6 +119,8 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
     m_pLibraryTableModel = new LibraryTableModel(this,
             pLibrary->trackCollectionManager(),
             "mixxx.db.model.library");
+    // The library view might contain a lot of tracks
+    m_pLibraryTableModel->setAsyncSelect(true);
 
     std::unique_ptr<TreeItem> pRootItem = TreeItem::newRoot(this);
     pRootItem->appendChild(kMissingTitle);
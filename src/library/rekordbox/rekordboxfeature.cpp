@@ -4,6 +4,7 @@
 #include <rekordbox_anlz.h>
 #include <rekordbox_pdb.h>
 
+#include <QHash>
 #include <QMap>
 #include <QMessageBox>
 #include <QSettings>
@@ -343,7 +344,6 @@ mixxx::RgbColor colorFromID(int colorID) {
 }
 
 void insertTrack(
-        QSqlDatabase& database,
         rekordbox_pdb_t::track_row_t* track,
         QSqlQuery& query,
         QSqlQuery& queryInsertIntoDevicePlaylistTracks,
@@ -351,6 +351,7 @@ void insertTrack(
         QMap<uint32_t, QString>& albumsMap,
         QMap<uint32_t, QString>& genresMap,
         QMap<uint32_t, QString>& keysMap,
+        QHash<uint32_t, int>& trackIdMap,
         const QString& devicePath,
         const QString& device,
         int audioFilesCount) {
@@ -390,26 +391,17 @@ void insertTrack(
             mixxx::RgbColor::toQVariant(
                     colorFromID(static_cast<int>(track->color_id()))));
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
-
     int trackID = -1;
-    QSqlQuery finderQuery(database);
-    finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-            " where rb_id=:rb_id and device=:device");
-    finderQuery.bindValue(":rb_id", rbID);
-    finderQuery.bindValue(":device", device);
-
-    if (!finderQuery.exec()) {
-        LOG_FAILED_QUERY(finderQuery)
+    if (query.exec()) {
+        // Remember the id for resolving the playlist entries instead of
+        // looking it up again, because rb_id is not indexed.
+        trackID = query.lastInsertId().toInt();
+        trackIdMap.insert(track->id(), trackID);
+    } else {
+        LOG_FAILED_QUERY(query)
                 << "rbID:" << rbID;
     }
 
-    if (finderQuery.next()) {
-        trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
-    }
-
     // Insert into device all tracks playlist
     queryInsertIntoDevicePlaylistTracks.bindValue(":track_id", trackID);
     queryInsertIntoDevicePlaylistTracks.bindValue(":position", audioFilesCount);
@@ -429,8 +421,10 @@ void buildPlaylistTree(
         QMap<uint32_t, bool>& playlistIsFolderMap,
         QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
         QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
-        const QString& playlistPath,
-        const QString& device);
+        const QHash<uint32_t, int>& trackIdMap,
+        QSqlQuery& queryInsertIntoPlaylist,
+        QSqlQuery& queryInsertIntoPlaylistTracks,
+        const QString& playlistPath);
 
 QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* deviceItem) {
     QString device = deviceItem->getLabel();
@@ -520,6 +514,7 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     QMap<uint32_t, bool> playlistIsFolderMap;
     QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTreeMap;
     QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTrackMap;
+    QHash<uint32_t, int> trackIdMap;
 
     bool folderOrPlaylistFound = false;
 
@@ -572,7 +567,7 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
                                                                 ->track_id();
                                     } break;
                                     case rekordbox_pdb_t::PAGE_TYPE_TRACKS: {
-                                        insertTrack(database,
+                                        insertTrack(
                                                 static_cast<rekordbox_pdb_t::track_row_t*>(
                                                         rowRef->body()),
                                                 query,
@@ -581,6 +576,7 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
                                                 albumsMap,
                                                 genresMap,
                                                 keysMap,
+                                                trackIdMap,
                                                 devicePath,
                                                 device,
                                                 audioFilesCount);
@@ -627,15 +623,26 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     if (audioFilesCount > 0 || folderOrPlaylistFound) {
         // If we have found anything, recursively build playlist/folder TreeItem children
         // for the original device TreeItem
-        buildPlaylistTree(database,
-                deviceItem,
+        QSqlQuery queryInsertIntoPlaylist(database);
+        queryInsertIntoPlaylist.prepare(
+                "INSERT INTO " + kRekordboxPlaylistsTable +
+                " (name) "
+                "VALUES (:name)");
+        QSqlQuery queryInsertIntoPlaylistTracks(database);
+        queryInsertIntoPlaylistTracks.prepare(
+                "INSERT INTO " + kRekordboxPlaylistTracksTable +
+                " (playlist_id, track_id, position) "
+                "VALUES (:playlist_id, :track_id, :position)");
+        buildPlaylistTree(deviceItem,
                 0,
                 playlistNameMap,
                 playlistIsFolderMap,
                 playlistTreeMap,
                 playlistTrackMap,
-                devicePath,
-                device);
+                trackIdMap,
+                queryInsertIntoPlaylist,
+                queryInsertIntoPlaylistTracks,
+                devicePath);
     }
 
     qDebug() << "Found: " << audioFilesCount << " audio files in Rekordbox device " << device;
@@ -646,15 +653,16 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
 }
 
 void buildPlaylistTree(
-        QSqlDatabase& database,
         TreeItem* parent,
         uint32_t parentID,
         QMap<uint32_t, QString>& playlistNameMap,
         QMap<uint32_t, bool>& playlistIsFolderMap,
         QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
         QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
-        const QString& playlistPath,
-        const QString& device) {
+        const QHash<uint32_t, int>& trackIdMap,
+        QSqlQuery& queryInsertIntoPlaylist,
+        QSqlQuery& queryInsertIntoPlaylistTracks,
+        const QString& playlistPath) {
     for (uint32_t childIndex = 0;
             childIndex < (uint32_t)playlistTreeMap[parentID].size();
             childIndex++) {
@@ -670,12 +678,6 @@ void buildPlaylistTree(
                 QVariant(QList<QString>{currentPath, IS_NOT_RECORDBOX_DEVICE}));
 
         // Create a playlist for this child
-        QSqlQuery queryInsertIntoPlaylist(database);
-        queryInsertIntoPlaylist.prepare(
-                "INSERT INTO " + kRekordboxPlaylistsTable +
-                " (name) "
-                "VALUES (:name)");
-
         queryInsertIntoPlaylist.bindValue(":name", currentPath);
 
         if (!queryInsertIntoPlaylist.exec()) {
@@ -684,26 +686,7 @@ void buildPlaylistTree(
             return;
         }
 
-        QSqlQuery idQuery(database);
-        idQuery.prepare("select id from " + kRekordboxPlaylistsTable + " where name=:path");
-        idQuery.bindValue(":path", currentPath);
-
-        if (!idQuery.exec()) {
-            LOG_FAILED_QUERY(idQuery)
-                    << "currentPath" << currentPath;
-            return;
-        }
-
-        int playlistID = kInvalidPlaylistId;
-        while (idQuery.next()) {
-            playlistID = idQuery.value(idQuery.record().indexOf("id")).toInt();
-        }
-
-        QSqlQuery queryInsertIntoPlaylistTracks(database);
-        queryInsertIntoPlaylistTracks.prepare(
-                "INSERT INTO " + kRekordboxPlaylistTracksTable +
-                " (playlist_id, track_id, position) "
-                "VALUES (:playlist_id, :track_id, :position)");
+        const int playlistID = queryInsertIntoPlaylist.lastInsertId().toInt();
 
         if (playlistTrackMap.contains(childID)) {
             // Add playlist tracks for children
@@ -711,24 +694,7 @@ void buildPlaylistTree(
                     static_cast<uint32_t>(playlistTrackMap[childID].size());
                     trackIndex++) {
                 uint32_t rbTrackID = playlistTrackMap[childID][trackIndex];
-
-                int trackID = -1;
-                QSqlQuery finderQuery(database);
-                finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-                        " where rb_id=:rb_id and device=:device");
-                finderQuery.bindValue(":rb_id", rbTrackID);
-                finderQuery.bindValue(":device", device);
-
-                if (!finderQuery.exec()) {
-                    LOG_FAILED_QUERY(finderQuery)
-                            << "rbTrackID:" << rbTrackID
-                            << "device:" << device;
-                    return;
-                }
-
-                if (finderQuery.next()) {
-                    trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
-                }
+                int trackID = trackIdMap.value(rbTrackID, -1);
 
                 queryInsertIntoPlaylistTracks.bindValue(":playlist_id", playlistID);
                 queryInsertIntoPlaylistTracks.bindValue(":track_id", trackID);
@@ -747,15 +713,16 @@ void buildPlaylistTree(
 
         if (playlistIsFolderMap[childID]) {
             // If this child is a folder (playlists are only leaf nodes), build playlist tree for it
-            buildPlaylistTree(database,
-                    child,
+            buildPlaylistTree(child,
                     childID,
                     playlistNameMap,
                     playlistIsFolderMap,
                     playlistTreeMap,
                     playlistTrackMap,
-                    currentPath,
-                    device);
+                    trackIdMap,
+                    queryInsertIntoPlaylist,
+                    queryInsertIntoPlaylistTracks,
+                    currentPath);
         }
     }
 }
@@ -1343,19 +1310,6 @@ RekordboxFeature::RekordboxFeature(
 
     m_title = tr("Rekordbox");
 
-    QSqlDatabase database = m_pTrackCollection->database();
-    ScopedTransaction transaction(database);
-    // Drop any leftover temporary Rekordbox database tables if they exist
-    dropTable(database, kRekordboxPlaylistTracksTable);
-    dropTable(database, kRekordboxPlaylistsTable);
-    dropTable(database, kRekordboxLibraryTable);
-
-    // Create new temporary Rekordbox database tables
-    createLibraryTable(database, kRekordboxLibraryTable);
-    createPlaylistsTable(database, kRekordboxPlaylistsTable);
-    createPlaylistTracksTable(database, kRekordboxPlaylistTracksTable);
-    transaction.commit();
-
     connect(&m_devicesFutureWatcher,
             &QFutureWatcher<QList<TreeItem*>>::finished,
             this,
@@ -1372,6 +1326,9 @@ RekordboxFeature::~RekordboxFeature() {
     m_devicesFuture.waitForFinished();
     m_tracksFuture.waitForFinished();
 
+    if (!isInitialized()) {
+        return;
+    }
     // Drop temporary Rekordbox database tables on shutdown
     QSqlDatabase database = m_pTrackCollection->database();
     ScopedTransaction transaction(database);
@@ -1465,9 +1422,26 @@ QString RekordboxFeature::formatRootViewHtml() const {
 void RekordboxFeature::refreshLibraryModels() {
 }
 
+void RekordboxFeature::initialize() {
+    QSqlDatabase database = m_pTrackCollection->database();
+    ScopedTransaction transaction(database);
+    // Drop any leftover temporary Rekordbox database tables if they exist
+    dropTable(database, kRekordboxPlaylistTracksTable);
+    dropTable(database, kRekordboxPlaylistsTable);
+    dropTable(database, kRekordboxLibraryTable);
+
+    // Create new temporary Rekordbox database tables
+    createLibraryTable(database, kRekordboxLibraryTable);
+    createPlaylistsTable(database, kRekordboxPlaylistsTable);
+    createPlaylistTracksTable(database, kRekordboxPlaylistTracksTable);
+    transaction.commit();
+}
+
 void RekordboxFeature::activate() {
     qDebug() << "RekordboxFeature::activate()";
 
+    initializeOnce();
+
     // Let a worker thread do the XML parsing
     m_devicesFuture = QtConcurrent::run(findRekordboxDevices);
     m_devicesFutureWatcher.setFuture(m_devicesFuture);
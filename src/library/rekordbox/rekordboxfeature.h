@@ -77,6 +77,7 @@ class RekordboxFeature : public BaseExternalLibraryFeature {
     void htmlLinkClicked(const QUrl& link);
 
   private:
+    void initialize() override;
     QString formatRootViewHtml() const;
     std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
             const QString& playlist) override;
@@ -65,24 +65,11 @@ RhythmboxFeature::RhythmboxFeature(Library* pLibrary, UserSettingsPointer pConfi
     m_isActivated =  false;
     m_title = tr("Rhythmbox");
 
-    m_database =
-            QSqlDatabase::cloneDatabase(pLibrary->trackCollectionManager()
-                                                ->internalCollection()
-                                                ->database(),
-                    "RHYTHMBOX_SCANNER");
-
-    //Open the database connection in this thread.
-    if (!m_database.open()) {
-        qDebug() << "Failed to open database for Rhythmbox scanner."
-                 << m_database.lastError();
-    }
     connect(&m_track_watcher,
             &QFutureWatcher<TreeItem*>::finished,
             this,
             &RhythmboxFeature::onTrackCollectionLoaded,
             Qt::QueuedConnection);
-
-    m_pRhythmboxTrackModel->setSearch(""); // enable search.
 }
 
 RhythmboxFeature::~RhythmboxFeature() {
@@ -119,9 +106,27 @@ TreeItemModel* RhythmboxFeature::sidebarModel() const {
     return m_pSidebarModel;
 }
 
+void RhythmboxFeature::initialize() {
+    m_database =
+            QSqlDatabase::cloneDatabase(m_pLibrary->trackCollectionManager()
+                                                ->internalCollection()
+                                                ->database(),
+                    "RHYTHMBOX_SCANNER");
+
+    //Open the database connection in this thread.
+    if (!m_database.open()) {
+        qDebug() << "Failed to open database for Rhythmbox scanner."
+                 << m_database.lastError();
+    }
+
+    m_pRhythmboxTrackModel->setSearch(""); // enable search.
+}
+
 void RhythmboxFeature::activate() {
     qDebug() << "RhythmboxFeature::activate()";
 
+    initializeOnce();
+
     if (!m_isActivated) {
         m_isActivated =  true;
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -36,6 +36,7 @@ class RhythmboxFeature : public BaseExternalLibraryFeature {
             const QString& playlist) override;
 
   private:
+    void initialize() override;
     // Removes all rows from a given table
     void clearTable(const QString& table_name);
     // reads the properties of a track and executes a SQL statement
@@ -22,6 +22,7 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(QStringLiteral("ImportFilesTask::run"));
+    QStringList existingTrackLocations;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -40,7 +41,7 @@ void ImportFilesTask::run() {
             // If the track is in the database, mark it as existing. This code gets
             // executed when other files in the same directory have changed (the
             // directory hash has changed).
-            emit trackExists(trackLocation);
+            existingTrackLocations.append(trackLocation);
         } else {
             if (!fileInfo.exists()) {
                 qWarning() << "ImportFilesTask: Skipping inaccessible file"
@@ -49,9 +50,18 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            // Reading the file tags is the most expensive part of adding
+            // a track. It is done here concurrently, while the tracks are
+            // added to the database one after another by the scanner.
+            emit addNewTrack(trackLocation,
+                    SoundSourceProxy::prepareTrackSourceFromFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            m_scannerGlobal->resetMissingTagMetadataOnImport()));
         }
     }
+    if (!existingTrackLocations.isEmpty()) {
+        emit tracksExist(existingTrackLocations);
+    }
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
     setSuccess(true);
@@ -1,6 +1,7 @@
 #include "library/scanner/libraryscanner.h"
 
 #include "library/coverartutils.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "library/scanner/libraryscannerdlg.h"
 #include "library/scanner/recursivescandirectorytask.h"
@@ -19,8 +20,12 @@
 
 namespace {
 
-// TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
+// Scanning directories is dominated by the latency of the file system,
+// especially on network shares, and not by the CPU. Walking multiple
+// directories concurrently hides that latency. The number of threads is
+// bounded to avoid overloading the file server.
+constexpr int kDefaultScannerThreadPoolSize = 4;
+constexpr int kMaxScannerThreadPoolSize = 16;
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -98,10 +103,11 @@ LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
-                  pConfig),
+                  m_searchIndexDao, pConfig),
           m_stateSema(1), // only one transaction is possible at a time
           m_state(IDLE) {
     // Move LibraryScanner to its own thread so that our signals/slots will
@@ -112,11 +118,30 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    int threadPoolSize = pConfig->getValue(
+            mixxx::library::prefs::kScannerThreadCountConfigKey,
+            kDefaultScannerThreadPoolSize);
+    if (threadPoolSize < 1 || threadPoolSize > kMaxScannerThreadPoolSize) {
+        kLogger.warning()
+                << "Invalid number of scanner threads"
+                << threadPoolSize;
+        threadPoolSize = kDefaultScannerThreadPoolSize;
+    }
+    kLogger.info()
+            << "Scanning with"
+            << threadPoolSize
+            << "threads";
+    m_pool.setMaxThreadCount(threadPoolSize);
+
+    qRegisterMetaType<SoundSourceProxy::PreparedTrackSourcePointer>();
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
     connect(this, &LibraryScanner::startScan, this, &LibraryScanner::slotStartScan);
+    connect(this,
+            &LibraryScanner::startDirectoriesScan,
+            this,
+            &LibraryScanner::slotStartDirectoriesScan);
 
     m_pProgressDlg.reset(new LibraryScannerDlg());
     connect(this,
@@ -173,6 +198,7 @@ void LibraryScanner::run() {
         m_playlistDao.initialize(dbConnection);
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
+        m_searchIndexDao.initialize(dbConnection);
 
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
@@ -186,6 +212,7 @@ void LibraryScanner::slotStartScan() {
     kLogger.debug() << "slotStartScan()";
     DEBUG_ASSERT(m_state == STARTING);
 
+    m_scanStartTime = QDateTime::currentDateTimeUtc();
     cleanUpDatabase(m_libraryHashDao.database());
 
     // Recursively scan each directory in the directories table.
@@ -209,6 +236,9 @@ void LibraryScanner::slotStartScan() {
     m_scannerGlobal = ScannerGlobalPointer(
             new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
                               coverExtensionFilter, directoryBlacklist));
+    m_scannerGlobal->setResetMissingTagMetadataOnImport(
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)
+                    .resetMissingTagMetadataOnImport);
 
     m_scannerGlobal->startTimer();
 
@@ -414,6 +444,8 @@ void LibraryScanner::slotFinishUnhashedScan() {
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         const auto dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
         updateQueryPlannerStatisticsForDatabase(dbConnection);
+        emit allDirectoriesScanned(m_scanStartTime);
+        emit directoriesHashed(m_libraryHashDao.getDirectoryHashes().keys());
     }
 
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
@@ -447,6 +479,136 @@ void LibraryScanner::scan() {
     }
 }
 
+bool LibraryScanner::scanDirectories(
+        const QStringList& dirPaths, const QDateTime& modifiedSince) {
+    if (!changeScannerState(STARTING)) {
+        return false;
+    }
+    emit startDirectoriesScan(dirPaths, modifiedSince);
+    return true;
+}
+
+void LibraryScanner::slotStartDirectoriesScan(
+        const QStringList& dirPaths, const QDateTime& modifiedSince) {
+    kLogger.debug() << "slotStartDirectoriesScan()" << dirPaths << modifiedSince;
+    DEBUG_ASSERT(m_state == STARTING);
+
+    m_scanStartTime = modifiedSince.isValid()
+            ? QDateTime::currentDateTimeUtc()
+            : QDateTime();
+    QHash<QString, mixxx::cache_key_t> directoryHashes = m_libraryHashDao.getDirectoryHashes();
+    QStringList changedDirPaths = dirPaths;
+    if (modifiedSince.isValid()) {
+        // Only the modification time of the directories is checked, which
+        // is much cheaper than listing their contents
+        for (auto it = directoryHashes.constBegin(); it != directoryHashes.constEnd(); ++it) {
+            const mixxx::FileInfo dirInfo(it.key());
+            if (dirInfo.isDir() && dirInfo.lastModified() > modifiedSince) {
+                changedDirPaths.append(it.key());
+            }
+        }
+    }
+    if (changedDirPaths.isEmpty()) {
+        changeScannerState(IDLE);
+        if (m_scanStartTime.isValid()) {
+            emit allDirectoriesScanned(m_scanStartTime);
+        }
+        emit directoriesHashed(directoryHashes.keys());
+        emit directoriesScanFinished();
+        return;
+    }
+    changeScannerState(SCANNING);
+
+    QSet<QString> trackLocations = m_trackDao.getAllTrackLocations();
+    QRegularExpression extensionFilter(SoundSourceProxy::getSupportedFileNamesRegex());
+    QRegularExpression coverExtensionFilter =
+            QRegularExpression(CoverArtUtils::supportedCoverArtExtensionsRegex(),
+                    QRegularExpression::CaseInsensitiveOption);
+    QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
+
+    m_scannerGlobal = ScannerGlobalPointer(
+            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
+                              coverExtensionFilter, directoryBlacklist));
+    m_scannerGlobal->setScanSubdirectoriesWithHash(false);
+    m_scannerGlobal->setResetMissingTagMetadataOnImport(
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)
+                    .resetMissingTagMetadataOnImport);
+    m_scannerGlobal->startTimer();
+
+    kLogger.debug() << "Scanning" << changedDirPaths.size() << "directories";
+
+    m_trackDao.addTracksPrepare();
+
+    TaskWatcher* pWatcher = &m_scannerGlobal->getTaskWatcher();
+    pWatcher->watchTask();
+    connect(pWatcher,
+            &TaskWatcher::allTasksDone,
+            this,
+            &LibraryScanner::slotFinishDirectoriesScan);
+
+    for (const QString& dirPath : std::as_const(changedDirPaths)) {
+        const mixxx::FileInfo dirInfo(dirPath);
+        if (!dirInfo.exists() || !dirInfo.isDir()) {
+            // Deleted directories are only detected by a full scan
+            continue;
+        }
+        if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
+            // The files of new directories are imported immediately,
+            // there is no second stage like for a full scan
+            queueTask(new RecursiveScanDirectoryTask(
+                    this, m_scannerGlobal, mixxx::FileAccess(dirInfo), true));
+        }
+    }
+    pWatcher->taskDone();
+}
+
+void LibraryScanner::slotFinishDirectoriesScan() {
+    kLogger.debug() << "slotFinishDirectoriesScan";
+    VERIFY_OR_DEBUG_ASSERT(!m_scannerGlobal.isNull()) {
+        kLogger.critical() << "No scanner global state exists in slotFinishDirectoriesScan";
+        return;
+    }
+
+    TaskWatcher* pWatcher = &m_scannerGlobal->getTaskWatcher();
+    disconnect(pWatcher,
+            &TaskWatcher::allTasksDone,
+            this,
+            &LibraryScanner::slotFinishDirectoriesScan);
+
+    const bool bScanFinishedCleanly = m_scannerGlobal->scanFinishedCleanly();
+    m_trackDao.addTracksFinish(!m_scannerGlobal->shouldCancel() &&
+            !bScanFinishedCleanly);
+
+    if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly &&
+            !m_scannerGlobal->verifiedTracks().isEmpty()) {
+        // Tracks that have been missing might have reappeared
+        QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+        ScopedTransaction transaction(dbConnection);
+        m_trackDao.markTrackLocationsAsVerified(m_scannerGlobal->verifiedTracks());
+        transaction.commit();
+    }
+    if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
+        if (m_scanStartTime.isValid()) {
+            emit allDirectoriesScanned(m_scanStartTime);
+        }
+        emit directoriesHashed(m_libraryHashDao.getDirectoryHashes().keys());
+    }
+
+    kLogger.info()
+            << "Scanning"
+            << m_scannerGlobal->numScannedDirectories()
+            << "changed directories took"
+            << m_scannerGlobal->timerElapsed().formatNanosWithUnit()
+            << "and added"
+            << m_scannerGlobal->addedTracks().size()
+            << "new tracks";
+
+    m_scannerGlobal.clear();
+    changeScannerState(FINISHED);
+
+    emit directoriesScanFinished();
+}
+
 // this is called after pressing the cancel button in the scanner
 // progress dialog
 void LibraryScanner::slotCancel() {
@@ -507,9 +669,9 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::slotDirectoryUnchanged);
     connect(pTask,
-            &ScannerTask::trackExists,
+            &ScannerTask::tracksExist,
             this,
-            &LibraryScanner::slotTrackExists);
+            &LibraryScanner::slotTracksExist);
     connect(pTask,
             &ScannerTask::addNewTrack,
             this,
@@ -558,21 +720,23 @@ void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
     emit progressHashing(directoryPath);
 }
 
-void LibraryScanner::slotTrackExists(const QString& trackPath) {
-    //kLogger.debug() << "slotTrackExists" << trackPath;
-    ScopedTimer timer(QStringLiteral("LibraryScanner::slotTrackExists"));
+void LibraryScanner::slotTracksExist(const QStringList& trackPaths) {
+    //kLogger.debug() << "slotTracksExist" << trackPaths;
+    ScopedTimer timer(QStringLiteral("LibraryScanner::slotTracksExist"));
     if (m_scannerGlobal) {
-        m_scannerGlobal->addVerifiedTrack(trackPath);
+        m_scannerGlobal->addVerifiedTracks(trackPaths);
     }
 }
 
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
+void LibraryScanner::slotAddNewTrack(const QString& trackPath,
+        const SoundSourceProxy::PreparedTrackSourcePointer& pPreparedSource) {
     //kLogger.debug() << "slotAddNewTrack" << trackPath;
     ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTrack"));
     // For statistics tracking and to detect moved tracks
     TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
+            mixxx::FileAccess(mixxx::FileInfo(trackPath)),
+            false,
+            pPreparedSource.get());
     if (pTrack) {
         DEBUG_ASSERT(!pTrack->isDirty());
         // The track's actual location might differ from the
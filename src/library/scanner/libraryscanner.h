@@ -2,9 +2,11 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <QDateTime>
 #include <QList>
 #include <QScopedPointer>
 #include <QSemaphore>
+#include <QStringList>
 #include <QThread>
 #include <QThreadPool>
 
@@ -13,6 +15,7 @@
 #include "library/dao/directorydao.h"
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
+#include "library/dao/searchindexdao.h"
 #include "library/dao/trackdao.h"
 #include "library/scanner/scannerglobal.h"
 #include "track/track_decl.h"
@@ -36,6 +39,13 @@ class LibraryScanner : public QThread {
     // in progress.
     void scan();
 
+    // Call from any thread to scan only the given directories and the
+    // directories that have been modified after modifiedSince, if valid.
+    // New tracks are added, but missing tracks are only detected by a full
+    // scan. Returns false and does nothing if a scan is already in progress.
+    bool scanDirectories(const QStringList& dirPaths,
+            const QDateTime& modifiedSince = QDateTime());
+
     // Call from any thread to cancel the scan.
     void slotCancel();
 
@@ -48,10 +58,20 @@ class LibraryScanner : public QThread {
     void trackAdded(TrackPointer pTrack);
     void tracksChanged(const QSet<TrackId>& changedTrackIds);
     void tracksRelocated(const QList<RelocatedTrack>& relocatedTracks);
+    // Emitted instead of scanStarted() and scanFinished() when scanning
+    // only some directories, which is done silently in the background.
+    void directoriesScanFinished();
+    // Emitted after a scan with all directories that are known to the
+    // database, e.g. for watching them.
+    void directoriesHashed(const QStringList& dirPaths);
+    // Emitted after all directories that have been modified after
+    // startTime have been scanned successfully.
+    void allDirectoriesScanned(const QDateTime& startTime);
 
     // Emitted by scan() to invoke slotStartScan in the scanner thread's event
     // loop.
     void startScan();
+    void startDirectoriesScan(const QStringList& dirPaths, const QDateTime& modifiedSince);
 
   protected:
     void run() override;
@@ -63,13 +83,16 @@ class LibraryScanner : public QThread {
     void slotStartScan();
     void slotFinishHashedScan();
     void slotFinishUnhashedScan();
+    void slotStartDirectoriesScan(const QStringList& dirPaths, const QDateTime& modifiedSince);
+    void slotFinishDirectoriesScan();
 
     // ScannerTask signal handlers.
     void slotDirectoryHashedAndScanned(const QString& directoryPath,
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
-    void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotTracksExist(const QStringList& trackPaths);
+    void slotAddNewTrack(const QString& trackPath,
+            const SoundSourceProxy::PreparedTrackSourcePointer& pPreparedSource);
 
   private:
     enum ScannerState {
@@ -96,6 +119,7 @@ class LibraryScanner : public QThread {
     void cleanUpScan();
 
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
@@ -106,6 +130,7 @@ class LibraryScanner : public QThread {
     PlaylistDAO m_playlistDao;
     DirectoryDAO m_directoryDao;
     AnalysisDao m_analysisDao;
+    SearchIndexDAO m_searchIndexDao;
     TrackDAO m_trackDao;
 
     // Global scanner state for scan currently in progress.
@@ -119,5 +144,8 @@ class LibraryScanner : public QThread {
     volatile ScannerState m_state;
 
     QList<mixxx::FileInfo> m_libraryRootDirs;
+    // Only valid while scanning all directories, i.e. not only those
+    // that have been reported as modified
+    QDateTime m_scanStartTime;
     QScopedPointer<LibraryScannerDlg> m_pProgressDlg;
 };
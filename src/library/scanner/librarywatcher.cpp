@@ -0,0 +1,95 @@
+#include "library/scanner/librarywatcher.h"
+
+#include "library/scanner/libraryscanner.h"
+#include "moc_librarywatcher.cpp"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryWatcher");
+
+// Collect the changes from copying multiple files into a
+// directory before scanning it
+constexpr int kScanDelayMillis = 3000;
+
+} // anonymous namespace
+
+LibraryWatcher::LibraryWatcher(
+        LibraryScanner* pScanner,
+        QObject* parent)
+        : QObject(parent),
+          m_pScanner(pScanner) {
+    DEBUG_ASSERT(m_pScanner);
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(kScanDelayMillis);
+    connect(&m_timer,
+            &QTimer::timeout,
+            this,
+            &LibraryWatcher::slotScanChangedDirectories);
+    connect(&m_watcher,
+            &QFileSystemWatcher::directoryChanged,
+            this,
+            &LibraryWatcher::slotDirectoryChanged);
+}
+
+void LibraryWatcher::slotWatchDirectories(const QStringList& dirPaths) {
+    const QStringList watchedDirPaths = m_watcher.directories();
+    const QSet<QString> newDirPaths(dirPaths.cbegin(), dirPaths.cend());
+    const QSet<QString> oldDirPaths(watchedDirPaths.cbegin(), watchedDirPaths.cend());
+
+    QStringList removedDirPaths;
+    for (const auto& dirPath : oldDirPaths) {
+        if (!newDirPaths.contains(dirPath)) {
+            removedDirPaths.append(dirPath);
+        }
+    }
+    if (!removedDirPaths.isEmpty()) {
+        m_watcher.removePaths(removedDirPaths);
+    }
+
+    QStringList addedDirPaths;
+    for (const auto& dirPath : newDirPaths) {
+        if (!oldDirPaths.contains(dirPath)) {
+            addedDirPaths.append(dirPath);
+        }
+    }
+    if (!addedDirPaths.isEmpty()) {
+        const QStringList failedDirPaths = m_watcher.addPaths(addedDirPaths);
+        if (!failedDirPaths.isEmpty()) {
+            // e.g. if the limit of inotify watches has been reached
+            kLogger.warning()
+                    << "Failed to watch"
+                    << failedDirPaths.size()
+                    << "of"
+                    << addedDirPaths.size()
+                    << "directories";
+        }
+    }
+    kLogger.info()
+            << "Watching"
+            << m_watcher.directories().size()
+            << "directories";
+}
+
+void LibraryWatcher::slotDirectoryChanged(const QString& dirPath) {
+    m_changedDirPaths.insert(dirPath);
+    m_timer.start();
+}
+
+void LibraryWatcher::slotScanChangedDirectories() {
+    if (m_changedDirPaths.isEmpty()) {
+        return;
+    }
+    const QStringList dirPaths(m_changedDirPaths.cbegin(), m_changedDirPaths.cend());
+    if (!m_pScanner->scanDirectories(dirPaths)) {
+        // Try again after the current scan has finished
+        m_timer.start();
+        return;
+    }
+    kLogger.debug()
+            << "Scanning"
+            << dirPaths.size()
+            << "changed directories";
+    m_changedDirPaths.clear();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+class LibraryScanner;
+
+/// LibraryWatcher watches the directories of the library for changes and
+/// lets the LibraryScanner scan only the changed directories for new tracks,
+/// without a full rescan. The QFileSystemWatcher uses the native
+/// notifications of the platform, e.g. inotify, FSEvents or
+/// ReadDirectoryChangesW.
+///
+/// Changes are collected for a short time before scanning them, because
+/// copying files into a directory causes many notifications.
+class LibraryWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit LibraryWatcher(
+            LibraryScanner* pScanner,
+            QObject* parent = nullptr);
+    ~LibraryWatcher() override = default;
+
+  public slots:
+    /// Replaces the watched directories.
+    void slotWatchDirectories(const QStringList& dirPaths);
+
+  private slots:
+    void slotDirectoryChanged(const QString& dirPath);
+    void slotScanChangedDirectories();
+
+  private:
+    LibraryScanner* const m_pScanner;
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_timer;
+    QSet<QString> m_changedDirPaths;
+};
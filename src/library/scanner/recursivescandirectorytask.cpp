@@ -117,6 +117,11 @@ void RecursiveScanDirectoryTask::run() {
 
     // Process all of the sub-directories.
     for (const mixxx::FileInfo& dirInfo : dirsToScan) {
+        if (!m_scannerGlobal->scanSubdirectoriesWithHash() &&
+                mixxx::isValidCacheKey(
+                        m_scannerGlobal->directoryHashInDatabase(dirInfo.location()))) {
+            continue;
+        }
         // Atomically test and mark the directory as scanned to avoid
         // that the same directory is scanned multiple times by different
         // tasks.
@@ -29,6 +29,8 @@ class ScannerGlobal {
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
+              m_scanSubdirectoriesWithHash(true),
+              m_resetMissingTagMetadataOnImport(false),
               m_numScannedDirectories(0) {
     }
 
@@ -106,6 +108,27 @@ class ScannerGlobal {
         m_shouldCancel = true;
     }
 
+    // Subdirectories that have been hashed before are skipped when only
+    // scanning changed directories, because their changes are detected
+    // separately.
+    bool scanSubdirectoriesWithHash() const {
+        return m_scanSubdirectoriesWithHash;
+    }
+
+    void setScanSubdirectoriesWithHash(bool scanSubdirectoriesWithHash) {
+        m_scanSubdirectoriesWithHash = scanSubdirectoriesWithHash;
+    }
+
+    // The metadata of new tracks is imported concurrently by the tasks
+    // with the same settings that are used when adding them.
+    bool resetMissingTagMetadataOnImport() const {
+        return m_resetMissingTagMetadataOnImport;
+    }
+
+    void setResetMissingTagMetadataOnImport(bool resetMissingTagMetadataOnImport) {
+        m_resetMissingTagMetadataOnImport = resetMissingTagMetadataOnImport;
+    }
+
     bool scanFinishedCleanly() const {
         return m_scanFinishedCleanly;
     }
@@ -122,8 +145,8 @@ class ScannerGlobal {
         return m_verifiedDirectories;
     }
 
-    void addVerifiedTrack(const QString& trackLocation) {
-        m_verifiedTracks << trackLocation;
+    void addVerifiedTracks(const QStringList& trackLocations) {
+        m_verifiedTracks << trackLocations;
     }
 
     const QStringList& verifiedTracks() const {
@@ -193,6 +216,8 @@ class ScannerGlobal {
 
     volatile bool m_scanFinishedCleanly;
     volatile bool m_shouldCancel;
+    bool m_scanSubdirectoriesWithHash;
+    bool m_resetMissingTagMetadataOnImport;
 
     // Stats tracking.
     PerformanceTimer m_timer;
@@ -4,9 +4,12 @@
 #include <QRunnable>
 
 #include "library/scanner/scannerglobal.h"
+#include "sources/soundsourceproxy.h"
 
 class LibraryScanner;
 
+Q_DECLARE_METATYPE(SoundSourceProxy::PreparedTrackSourcePointer);
+
 class ScannerTask : public QObject, public QRunnable {
     Q_OBJECT
   public:
@@ -22,8 +25,10 @@ class ScannerTask : public QObject, public QRunnable {
     void directoryHashedAndScanned(const QString& directoryPath,
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
-    void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    // Emitted once per directory instead of once per file
+    void tracksExist(const QStringList& filePaths);
+    void addNewTrack(const QString& filePath,
+            const SoundSourceProxy::PreparedTrackSourcePointer& pPreparedSource);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
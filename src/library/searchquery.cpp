@@ -2,10 +2,11 @@
 
 #include <QRegularExpression>
 
+#include "library/dao/searchindexdao.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
 #include "library/trackset/crate/crateschema.h"
-#include "library/trackset/crate/cratestorage.h" // for CrateTrackSelectResult
+#include "library/trackset/crate/cratestorage.h"
 #include "track/keyutils.h"
 #include "track/track.h"
 #include "util/db/dbconnection.h"
@@ -168,11 +169,13 @@ QString NotNode::toSql() const {
 TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QStringList& sqlColumns,
         const QString& argument,
-        const StringMatch matchMode)
+        const StringMatch matchMode,
+        const SearchIndexDAO* pSearchIndex)
         : m_database(database),
           m_sqlColumns(sqlColumns),
           m_argument(argument),
-          m_matchMode(matchMode) {
+          m_matchMode(matchMode),
+          m_pSearchIndex(pSearchIndex) {
     mixxx::DbConnection::makeStringLatinLow(&m_argument);
 }
 
@@ -199,6 +202,10 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
 }
 
 QString TextFilterNode::toSql() const {
+    if (m_matchMode == StringMatch::Contains && m_pSearchIndex &&
+            m_pSearchIndex->canMatch(m_sqlColumns, m_argument)) {
+        return m_pSearchIndex->formatMatchFilter(m_sqlColumns, m_argument);
+    }
     FieldEscaper escaper(m_database);
     QString argument = m_argument;
     if (argument.size() > 0) {
@@ -255,17 +262,20 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
 
 bool CrateFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_matchInitialized) {
-        CrateTrackSelectResult crateTracks(
-                m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
-
-        while (crateTracks.next()) {
-            m_matchingTrackIds.push_back(crateTracks.trackId());
-        }
-
+        // Only the names are matched in the database, the tracks
+        // are looked up in the in-memory index of the crates.
+        m_matchingCrateIds =
+                m_pCrateStorage->collectCrateIdsByNameLike(m_crateNameLike);
         m_matchInitialized = true;
     }
 
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    const TrackId trackId = pTrack->getId();
+    for (const auto& crateId : std::as_const(m_matchingCrateIds)) {
+        if (m_pCrateStorage->isTrackInCrate(crateId, trackId)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 QString CrateFilterNode::toSql() const {
@@ -275,23 +285,11 @@ QString CrateFilterNode::toSql() const {
 }
 
 NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
-        : m_pCrateStorage(pCrateStorage),
-          m_matchInitialized(false) {
+        : m_pCrateStorage(pCrateStorage) {
 }
 
 bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        TrackSelectResult tracks(
-                m_pCrateStorage->selectAllTracksSorted());
-
-        while (tracks.next()) {
-            m_matchingTrackIds.push_back(tracks.trackId());
-        }
-
-        m_matchInitialized = true;
-    }
-
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    return !m_pCrateStorage->isTrackInAnyCrate(pTrack->getId());
 }
 
 QString NoCrateFilterNode::toSql() const {
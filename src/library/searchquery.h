@@ -9,11 +9,13 @@
 #include <utility>
 #include <vector>
 
+#include "library/trackset/crate/crateid.h"
 #include "proto/keys.pb.h"
 #include "track/track_decl.h"
 #include "util/assert.h"
 
 class CrateStorage;
+class SearchIndexDAO;
 class TrackId;
 
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
@@ -77,10 +79,13 @@ class NotNode : public QueryNode {
 
 class TextFilterNode : public QueryNode {
   public:
+    /// If a search index is given, substring searches are done with the
+    /// index instead of LIKE whenever possible.
     TextFilterNode(const QSqlDatabase& database,
             const QStringList& sqlColumns,
             const QString& argument,
-            const StringMatch matchMode = StringMatch::Contains);
+            const StringMatch matchMode = StringMatch::Contains,
+            const SearchIndexDAO* pSearchIndex = nullptr);
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
@@ -90,6 +95,7 @@ class TextFilterNode : public QueryNode {
     QStringList m_sqlColumns;
     QString m_argument;
     StringMatch m_matchMode;
+    const SearchIndexDAO* m_pSearchIndex;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
@@ -120,7 +126,7 @@ class CrateFilterNode : public QueryNode {
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
-    mutable std::vector<TrackId> m_matchingTrackIds;
+    mutable QList<CrateId> m_matchingCrateIds;
 };
 
 class NoCrateFilterNode : public QueryNode {
@@ -132,9 +138,6 @@ class NoCrateFilterNode : public QueryNode {
 
   private:
     const CrateStorage* m_pCrateStorage;
-    QString m_crateNameLike;
-    mutable bool m_matchInitialized;
-    mutable std::vector<TrackId> m_matchingTrackIds;
 };
 
 class NumericFilterNode : public QueryNode {
@@ -69,6 +69,7 @@ const QRegularExpression kSplitOnOrOperatorRegexp = QRegularExpression(
 
 SearchQueryParser::SearchQueryParser(TrackCollection* pTrackCollection, QStringList searchColumns)
         : m_pTrackCollection(pTrackCollection),
+          m_pSearchIndex(nullptr),
           m_searchCrates(false) {
     setSearchColumns(std::move(searchColumns));
 
@@ -204,7 +205,8 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                             m_pTrackCollection->database(),
                             m_fieldToSqlColumns[field],
                             argument,
-                            matchMode);
+                            matchMode,
+                            m_pSearchIndex);
                 }
             }
         } else if (numericFilterMatch.hasMatch()) {
@@ -279,11 +281,19 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     gNode->addNode(std::make_unique<CrateFilterNode>(
                                     &m_pTrackCollection->crates(), argument));
                     gNode->addNode(std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument));
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_pSearchIndex));
                     pNode = std::move(gNode);
                 } else {
                     pNode = std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument);
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_pSearchIndex);
                 }
             }
         }
@@ -383,3 +393,48 @@ bool SearchQueryParser::queryIsLessSpecific(const QString& original, const QStri
     }
     return false;
 }
+
+bool SearchQueryParser::queryIsMoreSpecific(const QString& original, const QString& changed) {
+    // Quotes and the OR operator change how the following words are
+    // combined, which is not worth handling here
+    if (original.contains(QChar('"')) || changed.contains(QChar('"')) ||
+            original.contains(kSplitOnOrOperatorRegexp) ||
+            changed.contains(kSplitOnOrOperatorRegexp)) {
+        return false;
+    }
+    const QStringList oldWordList = SearchQueryParser::splitQueryIntoWords(original);
+    const QStringList newWordList = SearchQueryParser::splitQueryIntoWords(changed);
+    if (newWordList.size() < oldWordList.size()) {
+        return false;
+    }
+    // Only a plain search term that is extended is a substring search
+    // that matches fewer tracks. Negated, fuzzy or exact terms and
+    // filters may match more.
+    const auto isPlainWord = [](const QString& word) {
+        return !word.startsWith(kNegatePrefix) &&
+                !word.startsWith(kFuzzyPrefix) &&
+                !word.startsWith(QChar('=')) &&
+                !word.contains(QChar(':'));
+    };
+    for (int i = 0; i < oldWordList.size(); i++) {
+        const QString& oldWord = oldWordList.at(i);
+        const QString& newWord = newWordList.at(i);
+        if (oldWord.endsWith(QChar(':'))) {
+            // The argument of the filter is the next word
+            return false;
+        }
+        if (newWord == oldWord) {
+            continue;
+        }
+        // Only the last word may have been changed while typing
+        if (i != oldWordList.size() - 1 ||
+                !newWord.startsWith(oldWord) ||
+                !isPlainWord(oldWord) ||
+                !isPlainWord(newWord)) {
+            return false;
+        }
+    }
+    // All words are combined with AND, so any additional word can only
+    // reduce the result
+    return true;
+}
@@ -7,6 +7,7 @@
 #include "library/searchquery.h"
 #include "util/class.h"
 
+class SearchIndexDAO;
 class TrackCollection;
 class QueryNode;
 class AndNode;
@@ -17,6 +18,12 @@ class SearchQueryParser {
 
     void setSearchColumns(QStringList searchColumns);
 
+    /// Substring searches in text fields use the full-text search index
+    /// if it is available. Without an index they are done with LIKE.
+    void setSearchIndex(const SearchIndexDAO* pSearchIndex) {
+        m_pSearchIndex = pSearchIndex;
+    }
+
     std::unique_ptr<QueryNode> parseQuery(
             const QString& query,
             const QString& extraFilter) const;
@@ -25,6 +32,10 @@ class SearchQueryParser {
     static QStringList splitQueryIntoWords(const QString& query);
     /// checks if the changed search query is less specific then the original term
     static bool queryIsLessSpecific(const QString& original, const QString& changed);
+    /// Checks if the changed search query matches a subset of the tracks
+    /// that the original query matches, e.g. after the user has typed more
+    /// characters or terms. Returns false if that is not certain.
+    static bool queryIsMoreSpecific(const QString& original, const QString& changed);
 
   private:
     void parseTokens(QStringList tokens,
@@ -43,6 +54,7 @@ class SearchQueryParser {
             bool removeLeadingEqualsSign = true) const;
 
     TrackCollection* m_pTrackCollection;
+    const SearchIndexDAO* m_pSearchIndex;
     QStringList m_queryColumns;
     bool m_searchCrates;
     QStringList m_textFilters;
@@ -107,11 +107,15 @@ int createPlaylist(const QSqlDatabase& database, const QString& name, const QStr
     return query.lastInsertId().toInt();
 }
 
-int insertTrackIntoPlaylist(const QSqlDatabase& database, int playlistId, int trackId, int position) {
+QSqlQuery prepareInsertTrackIntoPlaylist(const QSqlDatabase& database) {
     QSqlQuery query(database);
     query.prepare(
             "INSERT INTO serato_playlist_tracks (playlist_id, track_id, position) "
             "VALUES (:playlist_id, :track_id, :position)");
+    return query;
+}
+
+int insertTrackIntoPlaylist(QSqlQuery& query, int playlistId, int trackId, int position) {
     query.bindValue(":playlist_id", playlistId);
     query.bindValue(":track_id", trackId);
     query.bindValue(":position", position);
@@ -326,23 +330,23 @@ inline QString parseCrateTrackPath(QIODevice* buffer) {
     return location;
 }
 
-QString parseCrate(
-        const QSqlDatabase& database,
-        const QString& databasePath,
-        const QString& crateFilePath,
-        const QMap<QString, int>& trackIdMap) {
-    QString crateName = QFileInfo(crateFilePath).baseName();
+struct SeratoCrate {
+    QString filePath;
+    QString name;
+    QStringList trackLocations;
+    bool valid = false;
+};
+
+// This function is executed concurrently for all crate files and
+// must not access the database.
+SeratoCrate readCrate(const QString& crateFilePath) {
+    SeratoCrate crate;
+    crate.filePath = crateFilePath;
+    crate.name = QFileInfo(crateFilePath).baseName();
     qDebug() << "Parsing crate"
-             << crateName
+             << crate.name
              << "at" << crateFilePath;
 
-    //Open the database connection in this thread.
-    VERIFY_OR_DEBUG_ASSERT(database.isOpen()) {
-        qWarning() << "Failed to open database for Serato parser."
-                   << database.lastError();
-        return QString();
-    }
-
     mixxx::FileInfo fileInfo(crateFilePath);
     QFile crateFile(crateFilePath);
     if (!Sandbox::askForAccess(&fileInfo) || !crateFile.open(QIODevice::ReadOnly)) {
@@ -350,17 +354,9 @@ QString parseCrate(
                    << crateFilePath
                    << " for reading:"
                    << crateFile.errorString();
-        return QString();
-    }
-
-    int playlistId = createPlaylist(database, crateFilePath, databasePath);
-    if (playlistId < 0) {
-        qWarning() << "Failed to create library playlist for "
-                   << crateFilePath;
-        return QString();
+        return crate;
     }
 
-    int trackCount = 0;
     QByteArray headerData = crateFile.read(kHeaderSize);
     while (headerData.length() == kHeaderSize) {
         quint32 fieldId = bytesToUInt32(headerData.mid(0, sizeof(quint32)));
@@ -377,7 +373,7 @@ QString parseCrate(
                        << " field from "
                        << crateFilePath
                        << ".";
-            return QString();
+            return crate;
         }
 
         // Parse field data
@@ -393,10 +389,7 @@ QString parseCrate(
             buffer.open(QIODevice::ReadOnly);
             QString location = parseCrateTrackPath(&buffer);
             if (!location.isEmpty()) {
-                int trackId = trackIdMap.value(location, -1);
-                insertTrackIntoPlaylist(database, playlistId, trackId, trackCount);
-                trackCount++;
-                break;
+                crate.trackLocations.append(location);
             }
             break;
         }
@@ -423,7 +416,30 @@ QString parseCrate(
                    << ".";
     }
 
-    return crateName;
+    crate.valid = true;
+    return crate;
+}
+
+bool insertCrate(
+        const QSqlDatabase& database,
+        const QString& databasePath,
+        const SeratoCrate& crate,
+        const QMap<QString, int>& trackIdMap,
+        QSqlQuery& queryInsertTrackIntoPlaylist) {
+    int playlistId = createPlaylist(database, crate.filePath, databasePath);
+    if (playlistId < 0) {
+        qWarning() << "Failed to create library playlist for "
+                   << crate.filePath;
+        return false;
+    }
+
+    int trackCount = 0;
+    for (const auto& location : crate.trackLocations) {
+        int trackId = trackIdMap.value(location, -1);
+        insertTrackIntoPlaylist(queryInsertTrackIntoPlaylist, playlistId, trackId, trackCount);
+        trackCount++;
+    }
+    return true;
 }
 
 QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* databaseItem) {
@@ -542,6 +558,8 @@ QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dat
         return QString();
     }
 
+    QSqlQuery queryInsertTrackIntoPlaylist = prepareInsertTrackIntoPlaylist(database);
+
     int trackCount = 0;
     QMap<QString, int> trackIdMap;
     QByteArray headerData = databaseFile.read(kHeaderSize);
@@ -599,7 +617,8 @@ QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dat
                     LOG_FAILED_QUERY(query);
                 } else {
                     int trackId = query.lastInsertId().toInt();
-                    insertTrackIntoPlaylist(database, playlistId, trackId, trackCount);
+                    insertTrackIntoPlaylist(
+                            queryInsertTrackIntoPlaylist, playlistId, trackId, trackCount);
                     trackIdMap.insert(track.location, trackId);
                     trackCount++;
                 }
@@ -636,19 +655,29 @@ QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dat
         QStringList filters;
         filters << kCrateFilter;
         const auto entryList = crateDir.entryList(filters);
+        QStringList crateFilePaths;
+        crateFilePaths.reserve(entryList.size());
         for (const QString& entry : entryList) {
-            QString crateFilePath = crateDir.filePath(entry);
-            QString crateName = parseCrate(
-                    database,
-                    databaseDir.path(),
-                    crateFilePath,
-                    trackIdMap);
-            if (!crateName.isEmpty()) {
-                TreeItem* crateItem = databaseItem->appendChild(crateName,
-                        QList<QVariant>{
-                                QVariant(crateFilePath), QVariant(true)});
-                crateItem->setIcon(QIcon(":/images/library/ic_library_crates.svg"));
+            crateFilePaths.append(crateDir.filePath(entry));
+        }
+        // Reading the crate files is independent of each other and done
+        // concurrently, while the database is only accessed from this thread.
+        const QList<SeratoCrate> crates =
+                QtConcurrent::blockingMapped<QList<SeratoCrate>>(
+                        crateFilePaths, readCrate);
+        for (const auto& crate : crates) {
+            if (!crate.valid ||
+                    !insertCrate(database,
+                            databaseDir.path(),
+                            crate,
+                            trackIdMap,
+                            queryInsertTrackIntoPlaylist)) {
+                continue;
             }
+            TreeItem* crateItem = databaseItem->appendChild(crate.name,
+                    QList<QVariant>{
+                            QVariant(crate.filePath), QVariant(true)});
+            crateItem->setIcon(QIcon(":/images/library/ic_library_crates.svg"));
         }
     } else {
         qWarning() << "Failed to open crate directory: "
@@ -883,19 +912,6 @@ SeratoFeature::SeratoFeature(
 
     m_title = tr("Serato");
 
-    QSqlDatabase database = m_pTrackCollection->database();
-    ScopedTransaction transaction(database);
-    // Drop any leftover temporary Serato database tables if they exist
-    dropTable(database, kSeratoPlaylistTracksTable);
-    dropTable(database, kSeratoPlaylistsTable);
-    dropTable(database, kSeratoLibraryTable);
-
-    // Create new temporary Serato database tables
-    createLibraryTable(database, kSeratoLibraryTable);
-    createPlaylistsTable(database, kSeratoPlaylistsTable);
-    createPlaylistTracksTable(database, kSeratoPlaylistTracksTable);
-    transaction.commit();
-
     connect(&m_databasesFutureWatcher,
             &QFutureWatcher<QList<TreeItem*>>::finished,
             this,
@@ -913,13 +929,15 @@ SeratoFeature::~SeratoFeature() {
     m_databasesFuture.waitForFinished();
     m_tracksFuture.waitForFinished();
 
-    // Drop temporary Serato database tables on shutdown
-    QSqlDatabase database = m_pTrackCollection->database();
-    ScopedTransaction transaction(database);
-    dropTable(database, kSeratoPlaylistTracksTable);
-    dropTable(database, kSeratoPlaylistsTable);
-    dropTable(database, kSeratoLibraryTable);
-    transaction.commit();
+    if (isInitialized()) {
+        // Drop temporary Serato database tables on shutdown
+        QSqlDatabase database = m_pTrackCollection->database();
+        ScopedTransaction transaction(database);
+        dropTable(database, kSeratoPlaylistTracksTable);
+        dropTable(database, kSeratoPlaylistsTable);
+        dropTable(database, kSeratoLibraryTable);
+        transaction.commit();
+    }
 
     delete m_pSeratoPlaylistModel;
 }
@@ -991,9 +1009,26 @@ QString SeratoFeature::formatRootViewHtml() const {
 void SeratoFeature::refreshLibraryModels() {
 }
 
+void SeratoFeature::initialize() {
+    QSqlDatabase database = m_pTrackCollection->database();
+    ScopedTransaction transaction(database);
+    // Drop any leftover temporary Serato database tables if they exist
+    dropTable(database, kSeratoPlaylistTracksTable);
+    dropTable(database, kSeratoPlaylistsTable);
+    dropTable(database, kSeratoLibraryTable);
+
+    // Create new temporary Serato database tables
+    createLibraryTable(database, kSeratoLibraryTable);
+    createPlaylistsTable(database, kSeratoPlaylistsTable);
+    createPlaylistTracksTable(database, kSeratoPlaylistTracksTable);
+    transaction.commit();
+}
+
 void SeratoFeature::activate() {
     qDebug() << "SeratoFeature::activate()";
 
+    initializeOnce();
+
     // Let a worker thread do the parsing
     m_databasesFuture = QtConcurrent::run(findSeratoDatabases);
     m_databasesFutureWatcher.setFuture(m_databasesFuture);
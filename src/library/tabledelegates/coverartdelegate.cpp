@@ -10,6 +10,7 @@
 #include "track/track.h"
 #include "util/logger.h"
 #include "util/make_const_iterator.h"
+#include "util/math.h"
 
 namespace {
 
@@ -29,7 +30,8 @@ CoverArtDelegate::CoverArtDelegate(QTableView* parent)
         : TableItemDelegate(parent),
           m_pTrackModel(asTrackModel(parent)),
           m_pCache(CoverArtCache::instance()),
-          m_inhibitLazyLoading(false) {
+          m_inhibitLazyLoading(false),
+          m_coverWidth(0) {
     if (m_pCache) {
         connect(m_pCache,
                 &CoverArtCache::coverFound,
@@ -62,7 +64,12 @@ void CoverArtDelegate::emitRowsChanged(
 void CoverArtDelegate::slotInhibitLazyLoading(
         bool inhibitLazyLoading) {
     m_inhibitLazyLoading = inhibitLazyLoading;
-    if (m_inhibitLazyLoading || m_cacheMissRows.isEmpty()) {
+    if (m_inhibitLazyLoading) {
+        return;
+    }
+    // The user has stopped scrolling
+    prefetchAdjacentRows();
+    if (m_cacheMissRows.isEmpty()) {
         return;
     }
     // If we can request non-cache covers now, request updates
@@ -104,6 +111,41 @@ TrackPointer CoverArtDelegate::loadTrackByLocation(
             TrackRef::fromFilePath(trackLocation));
 }
 
+void CoverArtDelegate::prefetchAdjacentRows() const {
+    if (!m_pCache || m_coverWidth <= 0) {
+        return;
+    }
+    const auto* pTableView = qobject_cast<QTableView*>(parent());
+    VERIFY_OR_DEBUG_ASSERT(pTableView && pTableView->model()) {
+        return;
+    }
+    const QAbstractItemModel* pModel = pTableView->model();
+    const int rowCount = pModel->rowCount();
+    const int firstVisibleRow = pTableView->rowAt(0);
+    if (firstVisibleRow < 0 || rowCount <= 0) {
+        return;
+    }
+    int lastVisibleRow = pTableView->rowAt(pTableView->viewport()->height() - 1);
+    if (lastVisibleRow < 0) {
+        // The visible rows don't fill the viewport
+        lastVisibleRow = rowCount - 1;
+    }
+    const int pageSize = lastVisibleRow - firstVisibleRow + 1;
+    // Rows below the visible rows are more likely to be displayed next
+    const int endRow = math_min(rowCount, lastVisibleRow + 1 + pageSize);
+    for (int row = lastVisibleRow + 1; row < endRow; ++row) {
+        CoverArtCache::prefetchCover(
+                m_pTrackModel->getCoverInfo(pModel->index(row, 0)),
+                m_coverWidth);
+    }
+    const int beginRow = math_max(0, firstVisibleRow - pageSize);
+    for (int row = firstVisibleRow - 1; row >= beginRow; --row) {
+        CoverArtCache::prefetchCover(
+                m_pTrackModel->getCoverInfo(pModel->index(row, 0)),
+                m_coverWidth);
+    }
+}
+
 void CoverArtDelegate::paintItem(
         QPainter* painter,
         const QStyleOptionViewItem& option,
@@ -120,6 +162,7 @@ void CoverArtDelegate::paintItem(
             return;
         }
         const double scaleFactor = qobject_cast<QWidget*>(parent())->devicePixelRatioF();
+        m_coverWidth = static_cast<int>(option.rect.width() * scaleFactor);
         QPixmap pixmap = CoverArtCache::getCachedCover(
                 coverInfo,
                 static_cast<int>(option.rect.width() * scaleFactor));
@@ -59,9 +59,16 @@ class CoverArtDelegate : public TableItemDelegate {
     TrackPointer loadTrackByLocation(
             const QString& trackLocation) const;
 
+    // Loads the covers of the rows of one page above and one
+    // page below the visible rows into the cache.
+    void prefetchAdjacentRows() const;
+
     CoverArtCache* const m_pCache;
     bool m_inhibitLazyLoading;
 
+    // The width of the painted covers in device pixels
+    mutable int m_coverWidth;
+
     // We need to record rows in paint() (which is const) so
     // these are marked mutable.
     mutable QList<int> m_cacheMissRows;
@@ -1,5 +1,7 @@
 #include "library/tabledelegates/stardelegate.h"
 
+#include <QPainter>
+#include <QPixmapCache>
 #include <QTableView>
 
 #include "library/starrating.h"
@@ -25,8 +27,31 @@ void StarDelegate::paintItem(
 
     paintItemBackground(painter, option, index);
 
-    StarRating starRating = index.data().value<StarRating>();
-    starRating.paint(painter, option.rect);
+    // Painting the antialiased polygons is expensive compared to other
+    // cells. The few distinct ratings are rendered once and cached, the
+    // key covers everything that affects the result.
+    const StarRating starRating = index.data().value<StarRating>();
+    const QColor color = painter->brush().color();
+    const double scaleFactor = painter->device()->devicePixelRatioF();
+    const QString cacheKey = QStringLiteral("StarDelegate_%1_%2_%3x%4_%5_%6")
+                                     .arg(starRating.starCount())
+                                     .arg(starRating.maxStarCount())
+                                     .arg(option.rect.width())
+                                     .arg(option.rect.height())
+                                     .arg(color.rgba())
+                                     .arg(scaleFactor);
+    QPixmap pixmap;
+    if (!QPixmapCache::find(cacheKey, &pixmap)) {
+        pixmap = QPixmap(option.rect.size() * scaleFactor);
+        pixmap.setDevicePixelRatio(scaleFactor);
+        pixmap.fill(Qt::transparent);
+        QPainter pixmapPainter(&pixmap);
+        pixmapPainter.setBrush(painter->brush());
+        starRating.paint(&pixmapPainter, QRect(QPoint(), option.rect.size()));
+        pixmapPainter.end();
+        QPixmapCache::insert(cacheKey, pixmap);
+    }
+    painter->drawPixmap(option.rect.topLeft(), pixmap);
 }
 
 QSize StarDelegate::sizeHint(const QStyleOptionViewItem& option,
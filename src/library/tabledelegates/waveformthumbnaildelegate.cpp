@@ -0,0 +1,64 @@
+#include "library/tabledelegates/waveformthumbnaildelegate.h"
+
+#include <QPainter>
+#include <QStyle>
+#include <QTableView>
+
+#include "library/trackmodel.h"
+#include "moc_waveformthumbnaildelegate.cpp"
+#include "util/assert.h"
+#include "waveform/waveformthumbnailstore.h"
+
+namespace {
+
+// Keeps the peaks apart from the row borders
+constexpr double kVerticalMargin = 2.0;
+
+} // anonymous namespace
+
+WaveformThumbnailDelegate::WaveformThumbnailDelegate(QTableView* pTableView)
+        : TableItemDelegate(pTableView),
+          m_pTrackModel(dynamic_cast<TrackModel*>(pTableView->model())) {
+    DEBUG_ASSERT(m_pTrackModel);
+}
+
+void WaveformThumbnailDelegate::paintItem(
+        QPainter* painter,
+        const QStyleOptionViewItem& option,
+        const QModelIndex& index) const {
+    paintItemBackground(painter, option, index);
+
+    const auto pStore = WaveformThumbnailStore::instance();
+    if (!pStore || !m_pTrackModel) {
+        return;
+    }
+    WaveformThumbnailStore::Strip strip;
+    if (!pStore->lookup(m_pTrackModel->getTrackId(index), &strip)) {
+        return;
+    }
+
+    const QRectF rect = QRectF(option.rect).adjusted(
+            0, kVerticalMargin, 0, -kVerticalMargin);
+    if (rect.height() <= 0) {
+        return;
+    }
+    const QColor color = option.palette.color(
+            option.state & QStyle::State_Selected
+                    ? QPalette::HighlightedText
+                    : QPalette::Text);
+    const double columnWidth = rect.width() / WaveformThumbnailStore::kStripWidth;
+    const double halfHeight = rect.height() / 2;
+    const double centerY = rect.center().y();
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    for (int column = 0; column < WaveformThumbnailStore::kStripWidth; ++column) {
+        // Mirrored around the center like the overview
+        const double peak = halfHeight * strip[column] / 255.0;
+        painter->fillRect(QRectF(rect.left() + column * columnWidth,
+                                  centerY - peak,
+                                  columnWidth,
+                                  2 * peak),
+                color);
+    }
+    painter->restore();
+}
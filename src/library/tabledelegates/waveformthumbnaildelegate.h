@@ -0,0 +1,20 @@
+#pragma once
+
+#include "library/tabledelegates/tableitemdelegate.h"
+
+class TrackModel;
+
+/// Paints the waveform thumbnail of a track from the WaveformThumbnailStore.
+/// Nothing is painted for tracks that have not been analyzed yet.
+class WaveformThumbnailDelegate : public TableItemDelegate {
+    Q_OBJECT
+  public:
+    explicit WaveformThumbnailDelegate(QTableView* pTableView);
+
+    void paintItem(QPainter* painter,
+            const QStyleOptionViewItem& option,
+            const QModelIndex& index) const override;
+
+  private:
+    TrackModel* const m_pTrackModel;
+};
@@ -21,7 +21,8 @@ TrackCollection::TrackCollection(
         : QObject(parent),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
-                     m_analysisDao, m_libraryHashDao, pConfig) {
+                     m_analysisDao, m_libraryHashDao,
+                     m_searchIndexDao, pConfig) {
     // Forward signals from TrackDAO
     connect(&m_trackDao,
             &TrackDAO::trackClean,
@@ -82,6 +83,10 @@ void TrackCollection::connectDatabase(const QSqlDatabase& database) {
     m_directoryDao.initialize(database);
     m_analysisDao.initialize(database);
     m_libraryHashDao.initialize(database);
+    m_searchIndexDao.initialize(database);
+    if (m_searchIndexDao.isAvailable() && !m_searchIndexDao.rebuildIfIncomplete()) {
+        kLogger.warning() << "Failed to build the full-text search index";
+    }
     m_crates.connectDatabase(database);
 }
 
@@ -115,6 +120,10 @@ void TrackCollection::connectTrackSource(QSharedPointer<BaseTrackCache> pTrackSo
             &TrackDAO::trackClean,
             m_pTrackSource.data(),
             &BaseTrackCache::slotTrackClean);
+    connect(&m_trackDao,
+            &TrackDAO::tracksClean,
+            m_pTrackSource.data(),
+            &BaseTrackCache::slotTracksClean);
     connect(&m_trackDao,
             &TrackDAO::tracksAdded,
             m_pTrackSource.data(),
@@ -205,6 +214,14 @@ DirectoryDAO::RelocateResult TrackCollection::relocateDirectory(
     DirectoryDAO::RelocateResult result;
     QList<RelocatedTrack> relocatedTracks;
     std::tie(result, relocatedTracks) = m_directoryDao.relocateDirectory(oldDir, newDir);
+    if (result == DirectoryDAO::RelocateResult::Ok) {
+        QList<TrackId> relocatedTrackIds;
+        relocatedTrackIds.reserve(relocatedTracks.size());
+        for (const auto& relocatedTrack : std::as_const(relocatedTracks)) {
+            relocatedTrackIds.append(relocatedTrack.updatedTrackRef().getId());
+        }
+        m_searchIndexDao.updateTracks(relocatedTrackIds);
+    }
     transaction.commit();
 
     if (result != DirectoryDAO::RelocateResult::Ok || relocatedTracks.isEmpty()) {
@@ -386,6 +403,7 @@ bool TrackCollection::purgeTracks(
     // Post-processing
     // TODO(XXX): Move signals from TrackDAO to TrackCollection
     m_trackDao.afterPurgingTracks(trackIds);
+    m_crates.afterPurgingTracks(trackIds);
 
     // Emit signal(s)
     // TODO(XXX): Emit signals here instead of from DAOs
@@ -474,6 +492,9 @@ bool TrackCollection::deleteCrate(
         return false;
     }
 
+    // Post-processing
+    m_crates.afterDeletingCrate(crateId);
+
     // Emit signals
     emit crateDeleted(crateId);
 
@@ -497,6 +518,9 @@ bool TrackCollection::addCrateTracks(
         return false;
     }
 
+    // Post-processing
+    m_crates.afterAddingCrateTracks(crateId, trackIds);
+
     // Emit signals
     emit crateTracksChanged(crateId, trackIds, QList<TrackId>());
 
@@ -520,6 +544,9 @@ bool TrackCollection::removeCrateTracks(
         return false;
     }
 
+    // Post-processing
+    m_crates.afterRemovingCrateTracks(crateId, trackIds);
+
     // Emit signals
     emit crateTracksChanged(crateId, QList<TrackId>(), trackIds);
 
@@ -548,6 +575,18 @@ bool TrackCollection::saveTrack(Track* pTrack) const {
     return m_trackDao.saveTrack(pTrack);
 }
 
+void TrackCollection::beginSaveTracks() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    m_trackDao.beginSaveTracks();
+}
+
+void TrackCollection::finishSaveTracks() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    m_trackDao.finishSaveTracks();
+}
+
 TrackPointer TrackCollection::getTrackById(
         TrackId trackId) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
@@ -2,15 +2,20 @@
 
 #include <utility>
 
+#include "database/mixxxdb.h"
 #include "library/externaltrackcollection.h"
 #include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
+#include "library/scanner/librarywatcher.h"
 #include "library/trackcollection.h"
+#include "library/trackquerythread.h"
 #include "moc_trackcollectionmanager.cpp"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/db/dbconnectionpooled.h"
+#include "util/db/dbwritequeue.h"
 #include "util/logger.h"
 
 namespace {
@@ -84,6 +89,18 @@ TrackCollectionManager::TrackCollectionManager(
                 this,
                 &TrackCollectionManager::libraryScanFinished,
                 /*signal-to-signal*/ Qt::DirectConnection);
+        connect(m_pScanner.get(),
+                &LibraryScanner::directoriesScanFinished,
+                this,
+                &TrackCollectionManager::libraryDirectoriesScanFinished,
+                /*signal-to-signal*/ Qt::DirectConnection);
+        connect(m_pScanner.get(),
+                &LibraryScanner::allDirectoriesScanned,
+                /*receiver thread context*/ this,
+                [this](const QDateTime& startTime) {
+                    m_pConfig->set(mixxx::library::prefs::kLastCompleteScanConfigKey,
+                            ConfigValue(startTime.toString(Qt::ISODate)));
+                });
 
         // Handle signals
         // NOTE: The receiver's thread context `this` is required to enforce
@@ -123,12 +140,49 @@ TrackCollectionManager::TrackCollectionManager(
                 pTrackDAO,
                 &TrackDAO::slotDatabaseTracksRelocated);
 
+        if (m_pConfig->getValue(mixxx::library::prefs::kWatchDirectoriesConfigKey, false)) {
+            m_pWatcher = std::make_unique<LibraryWatcher>(m_pScanner.get());
+            connect(m_pScanner.get(),
+                    &LibraryScanner::directoriesHashed,
+                    m_pWatcher.get(),
+                    &LibraryWatcher::slotWatchDirectories);
+        }
+
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
+
+        m_pTrackQueryThread = std::make_unique<TrackQueryThread>(pDbConnectionPool);
+        m_pTrackQueryThread->start(QThread::HighPriority);
+
+        m_pDbWriteQueue = std::make_unique<mixxx::DbWriteQueue>(pDbConnectionPool);
+        m_pDbWriteQueue->start();
+        m_pInternalCollection->getTrackDAO().setWriteQueue(m_pDbWriteQueue.get());
+
+        // Building missing indexes after a schema upgrade and checking the
+        // database may take long for big libraries. The library is usable
+        // meanwhile, only the other queued writes are delayed.
+        m_pDbWriteQueue->enqueue([](const QSqlDatabase& database) {
+            return MixxxDb::executeDeferredSchemaStatements(database);
+        });
+        m_pDbWriteQueue->enqueue([](const QSqlDatabase& database) {
+            return MixxxDb::checkDatabaseIntegrity(database);
+        });
     }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    // Pending selects are discarded
+    m_pTrackQueryThread.reset();
+
+    // Pending writes are executed
+    if (m_pDbWriteQueue) {
+        m_pInternalCollection->getTrackDAO().setWriteQueue(nullptr);
+        m_pDbWriteQueue.reset();
+    }
+
+    // Stop watching before stopping the scanner
+    m_pWatcher.reset();
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
@@ -173,6 +227,20 @@ void TrackCollectionManager::startLibraryScan() {
     m_pScanner->scan();
 }
 
+void TrackCollectionManager::startModifiedDirectoriesScan() {
+    VERIFY_OR_DEBUG_ASSERT(m_pScanner) {
+        return;
+    }
+    const QDateTime lastCompleteScan = QDateTime::fromString(
+            m_pConfig->getValueString(mixxx::library::prefs::kLastCompleteScanConfigKey),
+            Qt::ISODate);
+    if (!lastCompleteScan.isValid()) {
+        m_pScanner->scan();
+        return;
+    }
+    m_pScanner->scanDirectories(QStringList(), lastCompleteScan);
+}
+
 void TrackCollectionManager::stopLibraryScan() {
     VERIFY_OR_DEBUG_ASSERT(m_pScanner) {
         return;
@@ -189,6 +257,23 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
     return res;
 }
 
+int TrackCollectionManager::saveTracks(const TrackPointerList& tracks) const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    int savedCount = 0;
+    m_pInternalCollection->beginSaveTracks();
+    for (const auto& pTrack : tracks) {
+        VERIFY_OR_DEBUG_ASSERT(pTrack) {
+            continue;
+        }
+        if (saveTrack(pTrack.get(), TrackMetadataExportMode::Deferred) ==
+                SaveTrackResult::Saved) {
+            ++savedCount;
+        }
+    }
+    m_pInternalCollection->finishSaveTracks();
+    return savedCount;
+}
+
 // Export metadata and save the track in both the internal database
 // and external libraries.
 void TrackCollectionManager::saveEvictedTrack(Track* pTrack) noexcept {
@@ -260,8 +345,8 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         DEBUG_ASSERT(pTrack->isDirty());
         return SaveTrackResult::Failed;
     }
-    // The dirty flag is reset after the track has been saved successfully
-    DEBUG_ASSERT(!pTrack->isDirty());
+    // The dirty flag is reset after the track has been saved successfully,
+    // within saveTracks() when all tracks have been committed
 
     if (!m_externalCollections.isEmpty()) {
         // Track still exists in the internal collection/database
@@ -361,6 +446,9 @@ DirectoryDAO::RelocateResult TrackCollectionManager::relocateDirectory(
             << oldDir
             << "->"
             << newDir;
+    // The files have been moved, decoders of the old locations must not
+    // be reused
+    mixxx::SoundSourcePool::evictDirectory(oldDir);
     DirectoryDAO::RelocateResult result =
             m_pInternalCollection->relocateDirectory(oldDir, newDir);
 
@@ -553,6 +641,10 @@ void TrackCollectionManager::afterTracksRelocated(
         const QList<RelocatedTrack>& relocatedTracks) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
 
+    for (const auto& relocatedTrack : relocatedTracks) {
+        mixxx::SoundSourcePool::evict(relocatedTrack.deletedTrackLocation());
+    }
+
     // Already replaced in m_pInternalCollection
     if (m_externalCollections.isEmpty()) {
         return;
@@ -13,6 +13,11 @@
 #include "util/thread_affinity.h"
 
 class LibraryScanner;
+class LibraryWatcher;
+namespace mixxx {
+class DbWriteQueue;
+} // namespace mixxx
+class TrackQueryThread;
 class TrackCollection;
 class ExternalTrackCollection;
 class RelocatedTrack;
@@ -47,6 +52,13 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    /// Executes the selects of track table models asynchronously. Not
+    /// available in tests, where all selects are synchronous.
+    TrackQueryThread* trackQueryThread() const {
+        DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+        return m_pTrackQueryThread.get();
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
     TrackPointer getTrackByRef(
@@ -92,13 +104,24 @@ class TrackCollectionManager: public QObject,
     };
     SaveTrackResult saveTrack(const TrackPointer& pTrack) const;
 
+    /// Saves multiple tracks like saveTrack() within a single transaction
+    /// of the internal database. Returns the number of saved tracks.
+    int saveTracks(const TrackPointerList& tracks) const;
+
   signals:
     void libraryScanStarted();
     void libraryScanFinished();
+    // Emitted after new tracks have been added from changed directories
+    // in the background
+    void libraryDirectoriesScanFinished();
 
   public slots:
     void startLibraryScan();
     void stopLibraryScan();
+    // Only scans the directories that have been modified since the last
+    // complete scan for new tracks. Starts a full scan if none has been
+    // completed yet.
+    void startModifiedDirectoriesScan();
 
   private:
     void afterTrackAdded(const TrackPointer& pTrack) const;
@@ -128,4 +151,8 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+    std::unique_ptr<LibraryWatcher> m_pWatcher;
+
+    std::unique_ptr<TrackQueryThread> m_pTrackQueryThread;
+    std::unique_ptr<mixxx::DbWriteQueue> m_pDbWriteQueue;
 };
@@ -0,0 +1,298 @@
+#include "library/trackinfocolumns.h"
+
+#include <limits>
+
+#include "util/assert.h"
+
+TrackInfoColumns::TrackInfoColumns(int columnCount)
+        : m_columns(columnCount),
+          m_rowCount(0) {
+}
+
+void TrackInfoColumns::clear() {
+    for (auto& column : m_columns) {
+        column = Column();
+    }
+    m_rowsByTrackId.clear();
+    m_freeRows.clear();
+    m_rowCount = 0;
+}
+
+int TrackInfoColumns::insert(TrackId trackId) {
+    const auto it = m_rowsByTrackId.constFind(trackId);
+    if (it != m_rowsByTrackId.constEnd()) {
+        return it.value();
+    }
+    int row;
+    if (m_freeRows.empty()) {
+        row = m_rowCount++;
+        for (auto& column : m_columns) {
+            column.resize(m_rowCount);
+        }
+    } else {
+        row = m_freeRows.back();
+        m_freeRows.pop_back();
+    }
+    m_rowsByTrackId.insert(trackId, row);
+    return row;
+}
+
+void TrackInfoColumns::remove(TrackId trackId) {
+    const auto it = m_rowsByTrackId.find(trackId);
+    if (it == m_rowsByTrackId.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_rowsByTrackId.erase(it);
+    for (auto& column : m_columns) {
+        column.clearValue(row);
+    }
+    m_freeRows.push_back(row);
+}
+
+void TrackInfoColumns::setValue(int row, int column, const QVariant& value) {
+    VERIFY_OR_DEBUG_ASSERT(row >= 0 && row < m_rowCount) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(column >= 0 && column < columnCount()) {
+        return;
+    }
+    m_columns[column].setValue(row, value);
+}
+
+QVariant TrackInfoColumns::value(TrackId trackId, int column) const {
+    if (column < 0 || column >= columnCount()) {
+        return QVariant();
+    }
+    const auto it = m_rowsByTrackId.constFind(trackId);
+    if (it == m_rowsByTrackId.constEnd()) {
+        return QVariant();
+    }
+    return m_columns[column].value(it.value());
+}
+
+// static
+TrackInfoColumns::Column::Type TrackInfoColumns::Column::typeOf(const QMetaType& metaType) {
+    switch (metaType.id()) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+        return Type::Integer;
+    case QMetaType::Double:
+        return Type::Double;
+    case QMetaType::QString:
+        return Type::String;
+    default:
+        return Type::Variant;
+    }
+}
+
+void TrackInfoColumns::Column::resize(int rowCount) {
+    m_rowCount = rowCount;
+    switch (m_type) {
+    case Type::Empty:
+        break;
+    case Type::Integer:
+        m_isNull.resize(rowCount, true);
+        m_integers.resize(rowCount);
+        break;
+    case Type::Double:
+        m_isNull.resize(rowCount, true);
+        m_doubles.resize(rowCount);
+        break;
+    case Type::String:
+        m_stringIndices.resize(rowCount, -1);
+        break;
+    case Type::Variant:
+        m_variants.resize(rowCount);
+        break;
+    }
+}
+
+void TrackInfoColumns::Column::clearValue(int row) {
+    switch (m_type) {
+    case Type::Empty:
+        break;
+    case Type::Integer:
+    case Type::Double:
+        m_isNull[row] = true;
+        break;
+    case Type::String:
+        m_stringIndices[row] = -1;
+        break;
+    case Type::Variant:
+        m_variants[row] = QVariant();
+        break;
+    }
+}
+
+void TrackInfoColumns::Column::setValue(int row, const QVariant& value) {
+    if (value.isNull()) {
+        if (m_type == Type::Empty) {
+            // Remember the type of null values for returning them
+            if (value.isValid()) {
+                m_metaType = value.metaType();
+            }
+        } else if (m_type == Type::Variant) {
+            m_variants[row] = value;
+        } else {
+            clearValue(row);
+        }
+        return;
+    }
+    if (m_type == Type::Empty) {
+        initialize(value);
+    } else if (!fits(value)) {
+        convertToVariants();
+    }
+    switch (m_type) {
+    case Type::Empty:
+        DEBUG_ASSERT(!"unreachable");
+        break;
+    case Type::Integer:
+        m_integers[row] = value.toLongLong();
+        m_isNull[row] = false;
+        break;
+    case Type::Double:
+        m_doubles[row] = value.toDouble();
+        m_isNull[row] = false;
+        break;
+    case Type::String:
+        m_stringIndices[row] = internString(value.toString());
+        break;
+    case Type::Variant:
+        m_variants[row] = value;
+        break;
+    }
+}
+
+QVariant TrackInfoColumns::Column::value(int row) const {
+    DEBUG_ASSERT(row >= 0 && row < m_rowCount);
+    switch (m_type) {
+    case Type::Empty:
+        break;
+    case Type::Integer:
+        if (m_isNull[row]) {
+            break;
+        }
+        switch (m_metaType.id()) {
+        case QMetaType::Bool:
+            return QVariant(m_integers[row] != 0);
+        case QMetaType::Int:
+            return QVariant(static_cast<int>(m_integers[row]));
+        case QMetaType::UInt:
+            return QVariant(static_cast<uint>(m_integers[row]));
+        default:
+            return QVariant(static_cast<qlonglong>(m_integers[row]));
+        }
+    case Type::Double:
+        if (m_isNull[row]) {
+            break;
+        }
+        return QVariant(m_doubles[row]);
+    case Type::String: {
+        const int index = m_stringIndices[row];
+        if (index < 0) {
+            break;
+        }
+        return QVariant(m_strings[index]);
+    }
+    case Type::Variant:
+        return m_variants[row];
+    }
+    // A null value of the column type
+    if (m_metaType.isValid()) {
+        return QVariant(m_metaType);
+    }
+    return QVariant();
+}
+
+bool TrackInfoColumns::Column::fits(const QVariant& value) const {
+    switch (m_type) {
+    case Type::Empty:
+        return false;
+    case Type::Integer: {
+        if (typeOf(value.metaType()) != Type::Integer) {
+            return false;
+        }
+        // Integers of a different type are returned with the type of
+        // the column, as long as they fit into it
+        const qint64 integer = value.toLongLong();
+        switch (m_metaType.id()) {
+        case QMetaType::Bool:
+            return integer == 0 || integer == 1;
+        case QMetaType::Int:
+            return integer >= std::numeric_limits<int>::min() &&
+                    integer <= std::numeric_limits<int>::max();
+        case QMetaType::UInt:
+            return integer >= 0 && integer <= std::numeric_limits<uint>::max();
+        default:
+            return true;
+        }
+    }
+    case Type::Double:
+    case Type::String:
+        return value.metaType() == m_metaType;
+    case Type::Variant:
+        return true;
+    }
+    return false;
+}
+
+void TrackInfoColumns::Column::initialize(const QVariant& value) {
+    DEBUG_ASSERT(m_type == Type::Empty);
+    // Null values that have been set before keep their type
+    const QVariant nullValue =
+            m_metaType.isValid() ? QVariant(m_metaType) : QVariant();
+    m_type = typeOf(value.metaType());
+    m_metaType = value.metaType();
+    switch (m_type) {
+    case Type::Empty:
+        DEBUG_ASSERT(!"unreachable");
+        break;
+    case Type::Integer:
+        m_isNull.assign(m_rowCount, true);
+        m_integers.assign(m_rowCount, 0);
+        break;
+    case Type::Double:
+        m_isNull.assign(m_rowCount, true);
+        m_doubles.assign(m_rowCount, 0.0);
+        break;
+    case Type::String:
+        m_stringIndices.assign(m_rowCount, -1);
+        break;
+    case Type::Variant:
+        m_variants.assign(m_rowCount, nullValue);
+        break;
+    }
+}
+
+void TrackInfoColumns::Column::convertToVariants() {
+    DEBUG_ASSERT(m_type != Type::Empty);
+    DEBUG_ASSERT(m_type != Type::Variant);
+    std::vector<QVariant> variants;
+    variants.reserve(m_rowCount);
+    for (int row = 0; row < m_rowCount; ++row) {
+        variants.push_back(value(row));
+    }
+    m_type = Type::Variant;
+    m_variants = std::move(variants);
+    m_isNull = std::vector<bool>();
+    m_integers = std::vector<qint64>();
+    m_doubles = std::vector<double>();
+    m_stringIndices = std::vector<int>();
+    m_strings.clear();
+    m_stringIndicesByValue.clear();
+}
+
+int TrackInfoColumns::Column::internString(const QString& string) {
+    const auto it = m_stringIndicesByValue.constFind(string);
+    if (it != m_stringIndicesByValue.constEnd()) {
+        return it.value();
+    }
+    const int index = static_cast<int>(m_strings.size());
+    m_strings.append(string);
+    m_stringIndicesByValue.insert(string, index);
+    return index;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <QVariant>
+#include <vector>
+
+#include "track/trackid.h"
+
+/// TrackInfoColumns stores the values of a fixed number of columns for
+/// a set of tracks, like a table with one row per track.
+///
+/// Instead of one QVariant per cell the values are stored column by column
+/// in typed arrays, which avoids a heap allocation per cell and keeps the
+/// values of a column close together. Each column chooses its type from the
+/// first non-null value: booleans, integers and doubles are stored unboxed
+/// and integers of a different type are converted to the column type, strings
+/// are interned per column, so repeated values like the artist, the album
+/// or the genre share a single QString. A column that receives values of
+/// different or unsupported types falls back to storing QVariants.
+///
+/// Rows of removed tracks are reused for tracks that are inserted later.
+class TrackInfoColumns {
+  public:
+    explicit TrackInfoColumns(int columnCount);
+
+    int columnCount() const {
+        return static_cast<int>(m_columns.size());
+    }
+
+    /// The number of tracks.
+    int size() const {
+        return static_cast<int>(m_rowsByTrackId.size());
+    }
+
+    bool contains(TrackId trackId) const {
+        return m_rowsByTrackId.contains(trackId);
+    }
+
+    void clear();
+
+    /// Returns the row of the track, adding an empty row if the track
+    /// is not contained yet.
+    int insert(TrackId trackId);
+    void remove(TrackId trackId);
+
+    void setValue(int row, int column, const QVariant& value);
+
+    /// Returns an invalid QVariant if the track is not contained or
+    /// if the column is out of range.
+    QVariant value(TrackId trackId, int column) const;
+
+  private:
+    class Column {
+      public:
+        void resize(int rowCount);
+        void clearValue(int row);
+        void setValue(int row, const QVariant& value);
+        QVariant value(int row) const;
+
+      private:
+        enum class Type {
+            Empty,
+            Integer,
+            Double,
+            String,
+            Variant,
+        };
+
+        static Type typeOf(const QMetaType& metaType);
+
+        bool fits(const QVariant& value) const;
+        void initialize(const QVariant& value);
+        void convertToVariants();
+        int internString(const QString& string);
+
+        int m_rowCount = 0;
+        Type m_type = Type::Empty;
+        // The type of the returned values, even for null values
+        QMetaType m_metaType;
+        // Only used for integers and doubles
+        std::vector<bool> m_isNull;
+        std::vector<qint64> m_integers;
+        std::vector<double> m_doubles;
+        // Indices into m_strings, -1 for null values
+        std::vector<int> m_stringIndices;
+        QList<QString> m_strings;
+        QHash<QString, int> m_stringIndicesByValue;
+        std::vector<QVariant> m_variants;
+    };
+
+    std::vector<Column> m_columns;
+    QHash<TrackId, int> m_rowsByTrackId;
+    std::vector<int> m_freeRows;
+    int m_rowCount;
+};
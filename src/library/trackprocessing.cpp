@@ -1,6 +1,11 @@
 #include "library/trackprocessing.h"
 
 #include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <deque>
+#include <utility>
 
 #include "library/trackcollectionmanager.h"
 #include "moc_trackprocessing.cpp"
@@ -12,6 +17,10 @@ namespace {
 
 const Logger kLogger("ModalTrackBatchProcessor");
 
+// The number of modified tracks that are saved within a single
+// database transaction
+constexpr int kSaveTracksChunkSize = 100;
+
 } // anonymous namespace
 
 int ModalTrackBatchProcessor::processTracks(
@@ -35,26 +44,20 @@ int ModalTrackBatchProcessor::processTracks(
             m_minimumProgressDuration,
             this);
     taskMonitor.registerTask(this);
-    while (auto nextTrackPointer = pTrackPointerIterator->nextItem()) {
-        const auto pTrack = *nextTrackPointer;
-        VERIFY_OR_DEBUG_ASSERT(pTrack) {
-            kLogger.warning()
-                    << progressLabelText
-                    << "failed to load next track for processing";
-            continue;
-        }
-        if (m_bAborted) {
-            kLogger.info()
-                    << "Aborting"
-                    << progressLabelText
-                    << "after processing"
-                    << finishedTrackCount
-                    << "of"
-                    << estimatedTotalCount
-                    << "track(s)";
-            return finishedTrackCount;
+
+    TrackPointerList tracksToSave;
+    const auto saveTracks = [&] {
+        if (tracksToSave.isEmpty()) {
+            return;
         }
-        switch (doProcessNextTrack(pTrack)) {
+        pTrackCollectionManager->saveTracks(tracksToSave);
+        tracksToSave.clear();
+    };
+
+    // Returns false if processing should be aborted
+    const auto finishTrack = [&](const TrackPointer& pTrack,
+                                     ProcessNextTrackResult result) {
+        switch (result) {
         case ProcessNextTrackResult::AbortProcessing:
             kLogger.info()
                     << progressLabelText
@@ -63,11 +66,14 @@ int ModalTrackBatchProcessor::processTracks(
                     << "of"
                     << estimatedTotalCount
                     << "track(s)";
-            return finishedTrackCount;
+            return false;
         case ProcessNextTrackResult::ContinueProcessing:
             break;
         case ProcessNextTrackResult::SaveTrackAndContinueProcessing:
-            pTrackCollectionManager->saveTrack(pTrack);
+            tracksToSave.append(pTrack);
+            if (tracksToSave.size() >= kSaveTracksChunkSize) {
+                saveTracks();
+            }
             break;
         }
         ++finishedTrackCount;
@@ -88,7 +94,62 @@ int ModalTrackBatchProcessor::processTracks(
                                 finishedTrackCount /
                                 static_cast<PercentageOfCompletion>(
                                         estimatedTotalCount));
+        return true;
+    };
+
+    // Tracks are always loaded and saved on this thread. If supported
+    // they are processed concurrently on the global thread pool, e.g.
+    // for parsing the file tags of many tracks. The results are finished
+    // in the order of the tracks.
+    const int maxPendingTrackCount = processTracksConcurrently()
+            ? 2 * std::max(QThreadPool::globalInstance()->maxThreadCount(), 1)
+            : 0;
+    std::deque<std::pair<TrackPointer, QFuture<ProcessNextTrackResult>>> pendingTracks;
+    while (auto nextTrackPointer = pTrackPointerIterator->nextItem()) {
+        const auto pTrack = *nextTrackPointer;
+        VERIFY_OR_DEBUG_ASSERT(pTrack) {
+            kLogger.warning()
+                    << progressLabelText
+                    << "failed to load next track for processing";
+            continue;
+        }
+        if (m_bAborted) {
+            kLogger.info()
+                    << "Aborting"
+                    << progressLabelText
+                    << "after processing"
+                    << finishedTrackCount
+                    << "of"
+                    << estimatedTotalCount
+                    << "track(s)";
+            break;
+        }
+        if (maxPendingTrackCount <= 0) {
+            if (!finishTrack(pTrack, doProcessNextTrack(pTrack))) {
+                break;
+            }
+            continue;
+        }
+        pendingTracks.emplace_back(pTrack, QtConcurrent::run([this, pTrack] {
+            return doProcessNextTrack(pTrack);
+        }));
+        if (static_cast<int>(pendingTracks.size()) < maxPendingTrackCount) {
+            continue;
+        }
+        const auto [pPendingTrack, future] = std::move(pendingTracks.front());
+        pendingTracks.pop_front();
+        if (!finishTrack(pPendingTrack, future.result())) {
+            break;
+        }
     }
+    // The pending tracks have already been processed and need to be
+    // finished, even after aborting
+    while (!pendingTracks.empty()) {
+        const auto [pPendingTrack, future] = std::move(pendingTracks.front());
+        pendingTracks.pop_front();
+        finishTrack(pPendingTrack, future.result());
+    }
+    saveTracks();
     return finishedTrackCount;
 }
 
@@ -103,6 +164,10 @@ ModalTrackBatchOperationProcessor::ModalTrackBatchOperationProcessor(
     DEBUG_ASSERT(m_pTrackPointerOperation);
 }
 
+bool ModalTrackBatchOperationProcessor::processTracksConcurrently() const {
+    return m_pTrackPointerOperation->isThreadSafe();
+}
+
 ModalTrackBatchProcessor::ProcessNextTrackResult
 ModalTrackBatchOperationProcessor::doProcessNextTrack(
         const TrackPointer& pTrack) {
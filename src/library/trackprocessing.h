@@ -28,6 +28,9 @@ class ModalTrackBatchProcessor
 
     /// Subsequently load and process a list of tracks.
     ///
+    /// Modified tracks are saved in chunks, each within a single
+    /// database transaction.
+    ///
     /// Returns the number of processed tracks.
     int processTracks(
             const QString& progressLabelText,
@@ -59,9 +62,16 @@ class ModalTrackBatchProcessor
     ModalTrackBatchProcessor(ModalTrackBatchProcessor&&) = delete;
 
     /// Template method to process the next available track.
+    ///
+    /// Invoked on the global thread pool for multiple tracks at once if
+    /// processTracksConcurrently() returns true.
     virtual ProcessNextTrackResult doProcessNextTrack(
             const TrackPointer& pTrack) = 0;
 
+    virtual bool processTracksConcurrently() const {
+        return false;
+    }
+
     const Duration m_minimumProgressDuration;
 
     bool m_bAborted;
@@ -89,6 +99,13 @@ class TrackPointerOperation {
         doApply(pTrack);
     }
 
+    /// Operations that only access the thread-safe track object and
+    /// the corresponding file may be applied to multiple tracks
+    /// concurrently.
+    virtual bool isThreadSafe() const {
+        return false;
+    }
+
   private:
     /// Overridable template method that is supposed to handle or
     /// modify the given track object.
@@ -127,6 +144,7 @@ class ModalTrackBatchOperationProcessor
   private:
     ProcessNextTrackResult doProcessNextTrack(
             const TrackPointer& pTrack) override;
+    bool processTracksConcurrently() const override;
 
     const TrackPointerOperation* const m_pTrackPointerOperation;
     const Mode m_mode;
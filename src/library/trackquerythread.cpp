@@ -0,0 +1,244 @@
+#include "library/trackquerythread.h"
+
+#include <QHash>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "library/queryutil.h"
+#include "moc_trackquerythread.cpp"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackQueryThread");
+
+const QString kCreateViewPrefix = QStringLiteral("CREATE VIEW ");
+
+} // anonymous namespace
+
+TrackQueryThread::TrackQueryThread(mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pContext(std::make_unique<QObject>()) {
+    setObjectName(QStringLiteral("TrackQueryThread"));
+    // Requests that are posted before the thread has been started
+    // are executed as soon as its event loop is running
+    m_pContext->moveToThread(this);
+}
+
+TrackQueryThread::~TrackQueryThread() {
+    quit();
+    wait();
+}
+
+void TrackQueryThread::run() {
+    kLogger.debug() << "Entering thread";
+    {
+        const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+        exec();
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+// static
+QList<TrackQueryThread::ViewDefinition> TrackQueryThread::temporaryViewDefinitions(
+        const QSqlDatabase& database) {
+    QList<ViewDefinition> viewDefinitions;
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral(
+                "SELECT name,sql FROM sqlite_temp_master WHERE type='view'"))) {
+        LOG_FAILED_QUERY(query);
+        return viewDefinitions;
+    }
+    while (query.next()) {
+        QString sql = query.value(1).toString();
+        // SQLite stores the statement without the TEMP keyword
+        if (!sql.startsWith(kCreateViewPrefix)) {
+            continue;
+        }
+        sql.insert(QStringLiteral("CREATE ").size(), QStringLiteral("TEMP "));
+        viewDefinitions.append(ViewDefinition{query.value(0).toString(), sql});
+    }
+    return viewDefinitions;
+}
+
+void TrackQueryThread::select(Request request,
+        QObject* pReceiver,
+        std::function<void(Page page)> onPage) {
+    QMetaObject::invokeMethod(
+            m_pContext.get(),
+            [this,
+                    request = std::move(request),
+                    pReceiver = QPointer<QObject>(pReceiver),
+                    onPage = std::move(onPage)]() {
+                execute(request, pReceiver, onPage);
+            },
+            Qt::QueuedConnection);
+}
+
+void TrackQueryThread::execute(const Request& request,
+        const QPointer<QObject>& pReceiver,
+        const std::function<void(Page page)>& onPage) const {
+    const auto isSuperseded = [&request]() {
+        return request.pLatestGeneration &&
+                request.pLatestGeneration->load() != request.generation;
+    };
+    const auto deliver = [this, &request, &pReceiver, &onPage](Page page) {
+        page.generation = request.generation;
+        // The receiver lives in the same thread as this object and
+        // must only be checked there
+        QMetaObject::invokeMethod(
+                const_cast<TrackQueryThread*>(this),
+                [pReceiver, onPage, page = std::move(page)]() mutable {
+                    if (pReceiver) {
+                        onPage(std::move(page));
+                    }
+                },
+                Qt::QueuedConnection);
+    };
+    const auto fail = [&deliver]() {
+        Page page;
+        page.isLast = true;
+        page.failed = true;
+        deliver(std::move(page));
+    };
+
+    if (isSuperseded()) {
+        return;
+    }
+
+    const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    if (!database.isOpen()) {
+        kLogger.warning() << "No database connection";
+        fail();
+        return;
+    }
+
+    for (const auto& viewDefinition : request.viewDefinitions) {
+        QSqlQuery query(database);
+        if (!query.exec(QStringLiteral("DROP VIEW IF EXISTS temp.%1")
+                                .arg(viewDefinition.name)) ||
+                !query.exec(viewDefinition.sql)) {
+            LOG_FAILED_QUERY(query);
+            fail();
+            return;
+        }
+    }
+
+    QVector<Row> rows;
+    {
+        QSqlQuery query(database);
+        query.setForwardOnly(true);
+        if (!query.prepare(request.tableQuery) || !query.exec()) {
+            LOG_FAILED_QUERY(query);
+            fail();
+            return;
+        }
+        const int idColumn = query.record().indexOf(request.idColumn);
+        VERIFY_OR_DEBUG_ASSERT(idColumn >= 0) {
+            fail();
+            return;
+        }
+        while (query.next()) {
+            Row row;
+            row.trackId = TrackId(query.value(idColumn));
+            row.metadata.reserve(request.columnCount);
+            for (int i = 0; i < request.columnCount; ++i) {
+                row.metadata.push_back(query.value(i));
+            }
+            rows.push_back(std::move(row));
+        }
+    }
+
+    if (isSuperseded()) {
+        return;
+    }
+
+    QVector<Row> filteredDirtyRows;
+    if (!request.trackSourceQuery.isEmpty()) {
+        QHash<TrackId, int> trackSourceOrder;
+        {
+            QSqlQuery query(database);
+            query.setForwardOnly(true);
+            if (!query.prepare(request.trackSourceQuery) || !query.exec()) {
+                LOG_FAILED_QUERY(query);
+                fail();
+                return;
+            }
+            const int idColumn = query.record().indexOf(request.trackSourceIdColumn);
+            VERIFY_OR_DEBUG_ASSERT(idColumn >= 0) {
+                fail();
+                return;
+            }
+            while (query.next()) {
+                trackSourceOrder.insert(
+                        TrackId(query.value(idColumn)),
+                        static_cast<int>(trackSourceOrder.size()));
+            }
+        }
+
+        if (isSuperseded()) {
+            return;
+        }
+
+        // Sort like BaseSqlTableModel::select(): Filtered rows with the
+        // order -1 are placed at the end and the sort is stable, because
+        // the rows are already sorted by the table query.
+        std::vector<int> orders;
+        orders.reserve(rows.size());
+        for (const auto& row : std::as_const(rows)) {
+            if (request.trackSourceIsSorted) {
+                orders.push_back(trackSourceOrder.value(row.trackId, -1));
+            } else {
+                orders.push_back(trackSourceOrder.contains(row.trackId) ? 0 : -1);
+            }
+        }
+        std::vector<int> permutation(rows.size());
+        std::iota(permutation.begin(), permutation.end(), 0);
+        std::stable_sort(permutation.begin(),
+                permutation.end(),
+                [&orders](int lhs, int rhs) {
+                    if (orders[lhs] == -1) {
+                        return false;
+                    } else if (orders[rhs] == -1) {
+                        return true;
+                    }
+                    return orders[lhs] < orders[rhs];
+                });
+        QVector<Row> sortedRows;
+        sortedRows.reserve(rows.size());
+        for (const int index : permutation) {
+            if (orders[index] != -1) {
+                sortedRows.push_back(std::move(rows[index]));
+            } else if (request.dirtyTrackIds.contains(rows[index].trackId)) {
+                filteredDirtyRows.push_back(std::move(rows[index]));
+            }
+        }
+        rows = std::move(sortedRows);
+    }
+
+    // The first page is small to display it as early as possible
+    int begin = 0;
+    int pageSize = kFirstPageSize;
+    do {
+        if (isSuperseded()) {
+            return;
+        }
+        const int end = std::min(begin + pageSize, static_cast<int>(rows.size()));
+        Page page;
+        page.rows.reserve(end - begin);
+        std::move(rows.begin() + begin, rows.begin() + end, std::back_inserter(page.rows));
+        page.isLast = end == rows.size();
+        if (page.isLast) {
+            page.filteredDirtyRows = std::move(filteredDirtyRows);
+        }
+        deliver(std::move(page));
+        begin = end;
+        pageSize = kPageSize;
+    } while (begin < rows.size());
+}
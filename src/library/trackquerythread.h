@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QString>
+#include <QThread>
+#include <QVariant>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+/// TrackQueryThread executes the queries that select the rows of track
+/// table models on its own database connection from the pool, so the
+/// GUI thread is not blocked while selecting large playlists or the
+/// whole library.
+///
+/// The temporary views of the models only exist on the connection that
+/// created them. Their definitions are copied from that connection with
+/// temporaryViewDefinitions() and created again on the connection of this
+/// thread before executing the queries.
+class TrackQueryThread : public QThread {
+    Q_OBJECT
+  public:
+    struct ViewDefinition {
+        QString name;
+        QString sql;
+    };
+
+    struct Row {
+        TrackId trackId;
+        QVector<QVariant> metadata;
+    };
+
+    struct Request {
+        QList<ViewDefinition> viewDefinitions;
+
+        /// Selects the id and all columns of the table model.
+        QString tableQuery;
+        QString idColumn;
+        int columnCount = 0;
+
+        /// Optionally selects the ids of the tracks of the table query that
+        /// match the search query of the track source, sorted by the
+        /// track source if trackSourceIsSorted.
+        QString trackSourceQuery;
+        QString trackSourceIdColumn;
+        bool trackSourceIsSorted = false;
+
+        /// Rows of these tracks that are filtered out by the track source
+        /// query are returned separately, because they might match after
+        /// their pending modifications have been saved.
+        QSet<TrackId> dirtyTrackIds;
+
+        /// The request is skipped or aborted if the latest generation
+        /// differs from its generation, i.e. if it has been superseded.
+        int generation = 0;
+        std::shared_ptr<const std::atomic<int>> pLatestGeneration;
+    };
+
+    struct Page {
+        int generation = 0;
+        QVector<Row> rows;
+        /// Only set for the last page.
+        QVector<Row> filteredDirtyRows;
+        bool isLast = false;
+        bool failed = false;
+    };
+
+    static constexpr int kFirstPageSize = 200;
+    static constexpr int kPageSize = 5000;
+
+    explicit TrackQueryThread(mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~TrackQueryThread() override;
+
+    /// Returns the definitions of all temporary views of the connection.
+    static QList<ViewDefinition> temporaryViewDefinitions(const QSqlDatabase& database);
+
+    /// Executes the request asynchronously. The rows are delivered in pages
+    /// in their final order by invoking onPage in the thread of the
+    /// receiver. Nothing is delivered after the receiver has been deleted.
+    void select(Request request,
+            QObject* pReceiver,
+            std::function<void(Page page)> onPage);
+
+  protected:
+    void run() override;
+
+  private:
+    void execute(const Request& request,
+            const QPointer<QObject>& pReceiver,
+            const std::function<void(Page page)>& onPage) const;
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    // Lives in this thread for executing requests in its event loop
+    std::unique_ptr<QObject> m_pContext;
+};
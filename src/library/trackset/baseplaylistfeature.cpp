@@ -758,35 +758,32 @@ void BasePlaylistFeature::updateChildModel(const QSet<int>& playlistIds) {
         return;
     }
 
-    int id = kInvalidPlaylistId;
-    QString label;
-    bool ok = false;
-
     for (int row = 0; row < m_pSidebarModel->rowCount(); ++row) {
         QModelIndex index = m_pSidebarModel->index(row, 0);
         TreeItem* pTreeItem = m_pSidebarModel->getItem(index);
         DEBUG_ASSERT(pTreeItem != nullptr);
-        if (pTreeItem->hasChildren()) {
-            for (TreeItem* pChild : pTreeItem->children()) {
-                id = pChild->getData().toInt(&ok);
-                if (ok && id != kInvalidPlaylistId && playlistIds.contains(id)) {
-                    label = fetchPlaylistLabel(id);
-                    pChild->setLabel(label);
-                    decorateChild(pChild, id);
-                }
-            }
-        } else {
-            id = pTreeItem->getData().toInt(&ok);
-            if (ok && id != kInvalidPlaylistId && playlistIds.contains(id)) {
-                label = fetchPlaylistLabel(id);
-                pTreeItem->setLabel(label);
-                decorateChild(pTreeItem, id);
-            }
-        }
+        updateTreeItem(pTreeItem, playlistIds);
     }
     m_pSidebarModel->triggerRepaint();
 }
 
+void BasePlaylistFeature::updateTreeItem(
+        TreeItem* pTreeItem, const QSet<int>& playlistIds) {
+    if (pTreeItem->hasChildren()) {
+        // Playlists may be grouped in multiple levels, e.g. by year and month
+        for (TreeItem* pChild : pTreeItem->children()) {
+            updateTreeItem(pChild, playlistIds);
+        }
+        return;
+    }
+    bool ok = false;
+    int id = pTreeItem->getData().toInt(&ok);
+    if (ok && id != kInvalidPlaylistId && playlistIds.contains(id)) {
+        pTreeItem->setLabel(fetchPlaylistLabel(id));
+        decorateChild(pTreeItem, id);
+    }
+}
+
 /// Clears the child model dynamically, but the invisible root item remains
 void BasePlaylistFeature::clearChildModel() {
     m_lastClickedIndex = QModelIndex();
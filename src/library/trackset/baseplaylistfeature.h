@@ -90,11 +90,14 @@ class BasePlaylistFeature : public BaseTrackSetFeature {
     int playlistIdFromIndex(const QModelIndex& index) const;
     // Get the QModelIndex of a playlist based on its id.  Returns QModelIndex()
     // on failure.
-    QModelIndex indexFromPlaylistId(int playlistId);
+    virtual QModelIndex indexFromPlaylistId(int playlistId);
     bool isChildIndexSelectedInSidebar(const QModelIndex& index);
 
     QString createPlaylistLabel(const QString& name, int count, int duration) const;
 
+    // Marks the item and its parents bold if it contains the selected track
+    virtual void markTreeItem(TreeItem* pTreeItem);
+
     PlaylistDAO& m_playlistDao;
     QModelIndex m_lastClickedIndex;
     QModelIndex m_lastRightClickedIndex;
@@ -127,7 +130,7 @@ class BasePlaylistFeature : public BaseTrackSetFeature {
     void initActions();
     void connectPlaylistDAO();
     virtual QString getRootViewHtml() const = 0;
-    void markTreeItem(TreeItem* pTreeItem);
+    void updateTreeItem(TreeItem* pTreeItem, const QSet<int>& playlistIds);
     QString fetchPlaylistLabel(int playlistId);
 
     TrackId m_selectedTrackId;
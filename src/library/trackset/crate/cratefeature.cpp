@@ -910,25 +910,17 @@ void CrateFeature::slotTrackSelected(TrackId trackId) {
         return;
     }
 
-    std::vector<CrateId> sortedTrackCrates;
-    if (m_selectedTrackId.isValid()) {
-        CrateTrackSelectResult trackCratesIter(
-                m_pTrackCollection->crates().selectTrackCratesSorted(m_selectedTrackId));
-        while (trackCratesIter.next()) {
-            sortedTrackCrates.push_back(trackCratesIter.crateId());
-        }
-    }
-
     // Set all crates the track is in bold (or if there is no track selected,
-    // clear all the bolding).
+    // clear all the bolding). The memberships are looked up in the in-memory
+    // index of the crate storage.
+    const CrateStorage& crateStorage = m_pTrackCollection->crates();
     for (TreeItem* pTreeItem : pRootItem->children()) {
         DEBUG_ASSERT(pTreeItem != nullptr);
         bool crateContainsSelectedTrack =
                 m_selectedTrackId.isValid() &&
-                std::binary_search(
-                        sortedTrackCrates.begin(),
-                        sortedTrackCrates.end(),
-                        CrateId(pTreeItem->getData()));
+                crateStorage.isTrackInCrate(
+                        CrateId(pTreeItem->getData()),
+                        m_selectedTrackId);
         pTreeItem->setBold(crateContainsSelectedTrack);
     }
 
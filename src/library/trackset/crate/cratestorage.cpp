@@ -223,12 +223,15 @@ void CrateStorage::repairDatabase(const QSqlDatabase& database) {
 void CrateStorage::connectDatabase(const QSqlDatabase& database) {
     m_database = database;
     createViews();
+    loadCrateTracks();
 }
 
 void CrateStorage::disconnectDatabase() {
     // Ensure that we don't use the current database connection
     // any longer.
     m_database = QSqlDatabase();
+    m_crateTracks.clear();
+    m_tracksInAnyCrate.clear();
 }
 
 void CrateStorage::createViews() {
@@ -239,6 +242,35 @@ void CrateStorage::createViews() {
     }
 }
 
+void CrateStorage::loadCrateTracks() {
+    m_crateTracks.clear();
+    m_tracksInAnyCrate.clear();
+    FwdSqlQuery query(m_database,
+            QStringLiteral("SELECT %1,%2 FROM %3")
+                    .arg(CRATETRACKSTABLE_CRATEID,
+                            CRATETRACKSTABLE_TRACKID,
+                            CRATE_TRACKS_TABLE));
+    VERIFY_OR_DEBUG_ASSERT(query.execPrepared()) {
+        kLogger.critical()
+                << "Failed to load crate tracks!";
+        return;
+    }
+    CrateTrackQueryFields queryFields(query);
+    while (query.next()) {
+        const TrackId trackId = queryFields.trackId(query);
+        m_crateTracks[queryFields.crateId(query)].insert(trackId);
+        m_tracksInAnyCrate.insert(trackId);
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Loaded"
+                << m_tracksInAnyCrate.size()
+                << "tracks of"
+                << m_crateTracks.size()
+                << "crates";
+    }
+}
+
 uint CrateStorage::countCrates() const {
     FwdSqlQuery query(m_database,
             QStringLiteral("SELECT COUNT(*) FROM %1").arg(CRATE_TABLE));
@@ -252,7 +284,7 @@ uint CrateStorage::countCrates() const {
 }
 
 bool CrateStorage::readCrateById(CrateId id, Crate* pCrate) const {
-    FwdSqlQuery query(m_database,
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
             QStringLiteral("SELECT * FROM %1 WHERE %2=:id")
                     .arg(CRATE_TABLE, CRATETABLE_ID));
     query.bindValue(":id", id);
@@ -375,7 +407,7 @@ CrateSummarySelectResult CrateStorage::selectCrateSummaries() const {
 
 bool CrateStorage::readCrateSummaryById(
         CrateId id, CrateSummary* pCrateSummary) const {
-    FwdSqlQuery query(m_database,
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
             QStringLiteral("SELECT * FROM %1 WHERE %2=:id")
                     .arg(CRATE_SUMMARY_VIEW, CRATETABLE_ID));
     query.bindValue(":id", id);
@@ -396,17 +428,49 @@ bool CrateStorage::readCrateSummaryById(
 }
 
 uint CrateStorage::countCrateTracks(CrateId crateId) const {
-    FwdSqlQuery query(m_database,
-            QStringLiteral("SELECT COUNT(*) FROM %1 WHERE %2=:crateId")
-                    .arg(CRATE_TRACKS_TABLE, CRATETRACKSTABLE_CRATEID));
-    query.bindValue(":crateId", crateId);
-    if (query.execPrepared() && query.next()) {
-        uint result = query.fieldValue(0).toUInt();
-        DEBUG_ASSERT(!query.next());
-        return result;
-    } else {
+    const auto it = m_crateTracks.constFind(crateId);
+    if (it == m_crateTracks.constEnd()) {
+        return 0;
+    }
+    return it->size();
+}
+
+uint CrateStorage::countCrateTracks(
+        CrateId crateId,
+        const QList<TrackId>& trackIds) const {
+    const auto it = m_crateTracks.constFind(crateId);
+    if (it == m_crateTracks.constEnd()) {
         return 0;
     }
+    return it->countContained(trackIds);
+}
+
+bool CrateStorage::isTrackInCrate(
+        CrateId crateId,
+        TrackId trackId) const {
+    const auto it = m_crateTracks.constFind(crateId);
+    return it != m_crateTracks.constEnd() && it->contains(trackId);
+}
+
+bool CrateStorage::isTrackInAnyCrate(
+        TrackId trackId) const {
+    return m_tracksInAnyCrate.contains(trackId);
+}
+
+QList<CrateId> CrateStorage::collectCrateIdsByNameLike(
+        const QString& crateNameLike) const {
+    FwdSqlQuery query(m_database,
+            QStringLiteral("SELECT %1 FROM %2 WHERE %3 LIKE :crateNameLike")
+                    .arg(CRATETABLE_ID, CRATE_TABLE, CRATETABLE_NAME));
+    query.bindValue(":crateNameLike",
+            QVariant(kSqlLikeMatchAll + crateNameLike + kSqlLikeMatchAll));
+    QList<CrateId> crateIds;
+    if (query.execPrepared()) {
+        while (query.next()) {
+            crateIds.append(CrateId(query.fieldValue(0)));
+        }
+    }
+    return crateIds;
 }
 
 //static
@@ -449,7 +513,7 @@ QString CrateStorage::formatQueryForTrackIdsWithCrate() {
 
 CrateTrackSelectResult CrateStorage::selectCrateTracksSorted(
         CrateId crateId) const {
-    FwdSqlQuery query(m_database,
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
             QStringLiteral("SELECT * FROM %1 WHERE %2=:crateId ORDER BY %3")
                     .arg(CRATE_TRACKS_TABLE,
                             CRATETRACKSTABLE_CRATEID,
@@ -464,7 +528,7 @@ CrateTrackSelectResult CrateStorage::selectCrateTracksSorted(
 
 CrateTrackSelectResult CrateStorage::selectTrackCratesSorted(
         TrackId trackId) const {
-    FwdSqlQuery query(m_database,
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
             QStringLiteral("SELECT * FROM %1 WHERE %2=:trackId ORDER BY %3")
                     .arg(CRATE_TRACKS_TABLE,
                             CRATETRACKSTABLE_TRACKID,
@@ -543,18 +607,22 @@ TrackSelectResult CrateStorage::selectAllTracksSorted() const {
 }
 
 QSet<CrateId> CrateStorage::collectCrateIdsOfTracks(const QList<TrackId>& trackIds) const {
-    // NOTE(uklotzde): One query per track id. This could be optimized
-    // by querying for chunks of track ids and collecting the results.
-    QSet<CrateId> trackCrates;
+    QList<TrackId> trackIdsInAnyCrate;
     for (const auto& trackId : trackIds) {
-        // NOTE(uklotzde): The query result does not need to be sorted by crate id
-        // here. But since the corresponding FK column is indexed the impact on the
-        // performance should be negligible. By reusing an existing query we reduce
-        // the amount of code and the number of prepared SQL queries.
-        CrateTrackSelectResult crateTracks(selectTrackCratesSorted(trackId));
-        while (crateTracks.next()) {
-            DEBUG_ASSERT(crateTracks.trackId() == trackId);
-            trackCrates.insert(crateTracks.crateId());
+        if (m_tracksInAnyCrate.contains(trackId)) {
+            trackIdsInAnyCrate.append(trackId);
+        }
+    }
+    QSet<CrateId> trackCrates;
+    if (trackIdsInAnyCrate.isEmpty()) {
+        return trackCrates;
+    }
+    for (auto it = m_crateTracks.constBegin(); it != m_crateTracks.constEnd(); ++it) {
+        for (const auto& trackId : std::as_const(trackIdsInAnyCrate)) {
+            if (it->contains(trackId)) {
+                trackCrates.insert(it.key());
+                break;
+            }
         }
     }
     return trackCrates;
@@ -695,7 +763,7 @@ bool CrateStorage::onDeletingCrate(
 bool CrateStorage::onAddingCrateTracks(
         CrateId crateId,
         const QList<TrackId>& trackIds) {
-    FwdSqlQuery query(m_database,
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
             QStringLiteral(
                     "INSERT OR IGNORE INTO %1 (%2, %3) "
                     "VALUES (:crateId,:trackId)")
@@ -731,7 +799,7 @@ bool CrateStorage::onRemovingCrateTracks(
         const QList<TrackId>& trackIds) {
     // NOTE(uklotzde): We remove tracks in a loop
     // analogously to adding tracks (see above).
-    FwdSqlQuery query(m_database,
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(m_database,
             QStringLiteral(
                     "DELETE FROM %1 "
                     "WHERE %2=:crateId AND %3=:trackId")
@@ -781,3 +849,74 @@ bool CrateStorage::onPurgingTracks(
     }
     return true;
 }
+
+void CrateStorage::afterDeletingCrate(
+        CrateId crateId) {
+    const auto it = m_crateTracks.find(crateId);
+    if (it == m_crateTracks.end()) {
+        return;
+    }
+    const QList<TrackId> trackIds = it->toList();
+    m_crateTracks.erase(it);
+    for (const auto& trackId : trackIds) {
+        if (!scanCratesForTrack(trackId)) {
+            m_tracksInAnyCrate.remove(trackId);
+        }
+    }
+}
+
+void CrateStorage::afterAddingCrateTracks(
+        CrateId crateId,
+        const QList<TrackId>& trackIds) {
+    auto& crateTracks = m_crateTracks[crateId];
+    for (const auto& trackId : trackIds) {
+        crateTracks.insert(trackId);
+        m_tracksInAnyCrate.insert(trackId);
+    }
+}
+
+void CrateStorage::afterRemovingCrateTracks(
+        CrateId crateId,
+        const QList<TrackId>& trackIds) {
+    const auto it = m_crateTracks.find(crateId);
+    if (it == m_crateTracks.end()) {
+        return;
+    }
+    for (const auto& trackId : trackIds) {
+        it->remove(trackId);
+    }
+    if (it->isEmpty()) {
+        m_crateTracks.erase(it);
+    }
+    for (const auto& trackId : trackIds) {
+        if (!scanCratesForTrack(trackId)) {
+            m_tracksInAnyCrate.remove(trackId);
+        }
+    }
+}
+
+void CrateStorage::afterPurgingTracks(
+        const QList<TrackId>& trackIds) {
+    for (auto it = m_crateTracks.begin(); it != m_crateTracks.end();) {
+        for (const auto& trackId : trackIds) {
+            it->remove(trackId);
+        }
+        if (it->isEmpty()) {
+            it = m_crateTracks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& trackId : trackIds) {
+        m_tracksInAnyCrate.remove(trackId);
+    }
+}
+
+bool CrateStorage::scanCratesForTrack(TrackId trackId) const {
+    for (const auto& crateTracks : m_crateTracks) {
+        if (crateTracks.contains(trackId)) {
+            return true;
+        }
+    }
+    return false;
+}
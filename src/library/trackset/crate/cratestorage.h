@@ -1,9 +1,11 @@
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QSet>
 
 #include "library/trackset/crate/crateid.h"
+#include "library/trackset/trackidbitmap.h"
 #include "track/trackid.h"
 #include "util/db/fwdsqlqueryselectresult.h"
 #include "util/db/sqlstorage.h"
@@ -262,6 +264,20 @@ class CrateStorage : public virtual /*implements*/ SqlStorage {
     bool onPurgingTracks(
             const QList<TrackId>& trackIds);
 
+    void afterDeletingCrate(
+            CrateId crateId);
+
+    void afterAddingCrateTracks(
+            CrateId crateId,
+            const QList<TrackId>& trackIds);
+
+    void afterRemovingCrateTracks(
+            CrateId crateId,
+            const QList<TrackId>& trackIds);
+
+    void afterPurgingTracks(
+            const QList<TrackId>& trackIds);
+
     /////////////////////////////////////////////////////////////////////////
     // Crate read operations (read-only, const)
     /////////////////////////////////////////////////////////////////////////
@@ -294,8 +310,23 @@ class CrateStorage : public virtual /*implements*/ SqlStorage {
     // before starting to code.
     CrateSelectResult selectAutoDjCrates(bool autoDjSource = true) const;
 
-    // Crate content, i.e. the crate's tracks referenced by id
+    // Crate content, i.e. the crate's tracks referenced by id.
+    // The following functions are answered from an in-memory index
+    // of all crate tracks without accessing the database.
     uint countCrateTracks(CrateId crateId) const;
+    // Count how many of the provided tracks are contained in the crate
+    uint countCrateTracks(
+            CrateId crateId,
+            const QList<TrackId>& trackIds) const;
+    bool isTrackInCrate(
+            CrateId crateId,
+            TrackId trackId) const;
+    bool isTrackInAnyCrate(
+            TrackId trackId) const;
+
+    // Select the ids of all crates with a matching name (unordered)
+    QList<CrateId> collectCrateIdsByNameLike(
+            const QString& crateNameLike) const;
 
     // Format a subselect query for the tracks contained in crate.
     static QString formatSubselectQueryForCrateTrackIds(
@@ -339,6 +370,15 @@ class CrateStorage : public virtual /*implements*/ SqlStorage {
 
   private:
     void createViews();
+    void loadCrateTracks();
+    // Slow path for updating the union of all crates
+    bool scanCratesForTrack(TrackId trackId) const;
 
     QSqlDatabase m_database;
+
+    // In-memory index of the crate tracks table that is updated after
+    // each committed modification.
+    QHash<CrateId, TrackIdBitmap> m_crateTracks;
+    // The union of all crates
+    TrackIdBitmap m_tracksInAnyCrate;
 };
@@ -1,6 +1,7 @@
 #include "library/trackset/setlogfeature.h"
 
 #include <QDateTime>
+#include <QLocale>
 #include <QMenu>
 
 #include "library/library.h"
@@ -225,14 +226,14 @@ void SetlogFeature::onRightClickChild(const QPoint& globalPos, const QModelIndex
 /// Purpose: When inserting or removing playlists,
 /// we require the sidebar model not to reset.
 /// This method queries the database and does dynamic insertion
-/// Use a custom model in the history for grouping by year
+/// Use a custom model in the history for grouping by year and month
 /// @param selectedId row which should be selected
 QModelIndex SetlogFeature::constructChildModel(int selectedId) {
     // qDebug() << "SetlogFeature::constructChildModel() selected:" << selectedId;
-    // Setup the sidebar playlist model
     QSqlDatabase database =
             m_pLibrary->trackCollectionManager()->internalCollection()->database();
 
+    // The view is used for updating the labels of single playlists
     QString queryString = QStringLiteral(
             "CREATE TEMPORARY VIEW IF NOT EXISTS %1 "
             "AS SELECT "
@@ -251,7 +252,6 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
             "  GROUP BY Playlists.id")
                                   .arg(m_countsDurationTableName,
                                           QString::number(PlaylistDAO::PLHT_SET_LOG));
-    ;
     queryString.append(
             mixxx::DbConnection::collateLexicographically(
                     " ORDER BY sort_name"));
@@ -260,91 +260,297 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
         LOG_FAILED_QUERY(query);
     }
 
-    // Setup the sidebar playlist model
-    QSqlTableModel playlistTableModel(this, database);
-    playlistTableModel.setTable(m_countsDurationTableName);
-    playlistTableModel.setSort(playlistTableModel.fieldIndex("id"), Qt::DescendingOrder);
-    playlistTableModel.select();
-    while (playlistTableModel.canFetchMore()) {
-        playlistTableModel.fetchMore();
-    }
-    QSqlRecord record = playlistTableModel.record();
-    int nameColumn = record.indexOf("name");
-    int idColumn = record.indexOf("id");
-    int createdColumn = record.indexOf("date_created");
-    int countColumn = record.indexOf("count");
-    int durationColumn = record.indexOf("durationSeconds");
-
     // Nice to have: restore previous expanded/collapsed state of YEAR items
     clearChildModel();
-    QMap<int, TreeItem*> groups;
-    std::vector<std::unique_ptr<TreeItem>> itemList;
-    // Generous estimate (number of years the db is used ;))
-    itemList.reserve(kNumToplevelHistoryEntries + 15);
-
-    for (int row = 0; row < playlistTableModel.rowCount(); ++row) {
-        int id =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, idColumn))
-                        .toInt();
-        QString name =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, nameColumn))
-                        .toString();
-        QDateTime dateCreated =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, createdColumn))
-                        .toDateTime();
-        int count = playlistTableModel
-                            .data(playlistTableModel.index(row, countColumn))
-                            .toInt();
-        int duration =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, durationColumn))
-                        .toInt();
-        QString label = createPlaylistLabel(name, count, duration);
-
-        // Create the TreeItem whose parent is the invisible root item.
-        // Show only [kNumToplevelHistoryEntries] recent playlists at the top level
-        // before grouping them by year.
-        if (row >= kNumToplevelHistoryEntries) {
-            // group by year
-            int yearCreated = dateCreated.date().year();
-
-            auto i = groups.find(yearCreated);
-            TreeItem* pGroupItem;
-            if (i != groups.end() && i.key() == yearCreated) {
-                // get YEAR item the playlist will sorted into
-                pGroupItem = i.value();
-            } else {
-                // create YEAR item the playlist will sorted into
-                // store id of empty placeholder playlist
-                auto pNewGroupItem = std::make_unique<TreeItem>(
-                        QString::number(yearCreated), m_yearNodeId);
-                pGroupItem = pNewGroupItem.get();
-                groups.insert(yearCreated, pGroupItem);
-                itemList.push_back(std::move(pNewGroupItem));
-            }
 
-            TreeItem* pItem = pGroupItem->appendChild(label, id);
-            pItem->setBold(m_playlistIdsOfSelectedTrack.contains(id));
-            decorateChild(pItem, id);
-        } else {
-            // add most recent top-level playlist
-            auto pItem = std::make_unique<TreeItem>(label, id);
-            pItem->setBold(m_playlistIdsOfSelectedTrack.contains(id));
-            decorateChild(pItem.get(), id);
+    // Show only [kNumToplevelHistoryEntries] recent playlists at the top level
+    // before grouping them by year and month.
+    std::vector<std::unique_ptr<TreeItem>> itemList =
+            createPlaylistItems(QString(), kNumToplevelHistoryEntries);
+    for (const auto& pItem : itemList) {
+        m_recentPlaylistIds.insert(pItem->getData().toInt());
+    }
+
+    // Only the aggregated numbers of each month are queried, the playlists
+    // of a month are loaded when it is expanded. With years of history
+    // this avoids creating thousands of sidebar items up front.
+    query.prepare(QStringLiteral(
+            "SELECT "
+            "  CAST(strftime('%Y', Playlists.date_created) AS INTEGER) AS year, "
+            "  CAST(strftime('%m', Playlists.date_created) AS INTEGER) AS month, "
+            "  COUNT(PlaylistTracks.id) AS count, "
+            "  SUM(library.duration) AS durationSeconds "
+            "FROM Playlists "
+            "LEFT JOIN PlaylistTracks "
+            "  ON PlaylistTracks.playlist_id = Playlists.id "
+            "LEFT JOIN library "
+            "  ON PlaylistTracks.track_id = library.id "
+            "WHERE Playlists.hidden = :hidden %1 "
+            "GROUP BY year, month "
+            "ORDER BY year DESC, month DESC")
+                          .arg(excludeRecentPlaylistsFilter()));
+    query.bindValue(":hidden", PlaylistDAO::PLHT_SET_LOG);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
 
-            itemList.push_back(std::move(pItem));
+    TreeItem* pYearItem = nullptr;
+    int yearCount = 0;
+    int yearDuration = 0;
+    while (query.next()) {
+        const int year = query.value(0).toInt();
+        const int month = query.value(1).toInt();
+        const int count = query.value(2).toInt();
+        const int duration = query.value(3).toInt();
+        if (!pYearItem || m_periodItems.value(pYearItem).year != year) {
+            // create YEAR item the months will be sorted into
+            // store id of empty placeholder playlist
+            auto pNewYearItem = std::make_unique<TreeItem>(
+                    QString::number(year), m_yearNodeId);
+            pYearItem = pNewYearItem.get();
+            m_periodItems.insert(pYearItem, HistoryPeriod{year, 0, true});
+            itemList.push_back(std::move(pNewYearItem));
+            yearCount = 0;
+            yearDuration = 0;
         }
+        yearCount += count;
+        yearDuration += duration;
+        pYearItem->setLabel(createPlaylistLabel(QString::number(year), yearCount, yearDuration));
+
+        TreeItem* pMonthItem = pYearItem->appendChild(
+                createPlaylistLabel(QLocale().standaloneMonthName(month), count, duration),
+                m_yearNodeId);
+        m_periodItems.insert(pMonthItem, HistoryPeriod{year, month, false});
+        // Placeholder that makes the month expandable until its
+        // playlists are loaded
+        pMonthItem->appendChild(QString());
     }
 
     // Append all the newly created TreeItems in a dynamic way to the childmodel
     m_pSidebarModel->insertTreeItemRows(std::move(itemList), 0);
+    for (TreeItem* pItem : m_pSidebarModel->getRootItem()->children()) {
+        markTreeItem(pItem);
+    }
 
     return indexFromPlaylistId(selectedId);
 }
 
+std::vector<std::unique_ptr<TreeItem>> SetlogFeature::createPlaylistItems(
+        const QString& filter, int limit) {
+    QSqlQuery query(m_pLibrary->trackCollectionManager()->internalCollection()->database());
+    query.prepare(QStringLiteral(
+            "SELECT "
+            "  Playlists.id AS id, "
+            "  Playlists.name AS name, "
+            "  max(PlaylistTracks.position) AS count, "
+            "  SUM(library.duration) AS durationSeconds "
+            "FROM Playlists "
+            "LEFT JOIN PlaylistTracks "
+            "  ON PlaylistTracks.playlist_id = Playlists.id "
+            "LEFT JOIN library "
+            "  ON PlaylistTracks.track_id = library.id "
+            "WHERE Playlists.hidden = :hidden %1 "
+            "GROUP BY Playlists.id "
+            "ORDER BY Playlists.id DESC "
+            "LIMIT :limit")
+                          .arg(filter));
+    query.bindValue(":hidden", PlaylistDAO::PLHT_SET_LOG);
+    // A negative limit is no limit in SQLite
+    query.bindValue(":limit", limit);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+
+    std::vector<std::unique_ptr<TreeItem>> items;
+    while (query.next()) {
+        const int id = query.value(0).toInt();
+        const QString label = createPlaylistLabel(
+                query.value(1).toString(),
+                query.value(2).toInt(),
+                query.value(3).toInt());
+        auto pItem = std::make_unique<TreeItem>(label, id);
+        pItem->setBold(m_playlistIdsOfSelectedTrack.contains(id));
+        decorateChild(pItem.get(), id);
+        items.push_back(std::move(pItem));
+    }
+    return items;
+}
+
+QString SetlogFeature::excludeRecentPlaylistsFilter() const {
+    if (m_recentPlaylistIds.isEmpty()) {
+        return QString();
+    }
+    QStringList ids;
+    ids.reserve(m_recentPlaylistIds.size());
+    for (const int id : m_recentPlaylistIds) {
+        ids.append(QString::number(id));
+    }
+    return QStringLiteral("AND Playlists.id NOT IN (%1)").arg(ids.join(','));
+}
+
+QString SetlogFeature::periodFilter(const HistoryPeriod& period) const {
+    // Playlists.date_created is stored as 'YYYY-MM-DD HH:MM:SS', which
+    // can be compared lexicographically with the first day of a period.
+    const QDate begin(period.year, period.month > 0 ? period.month : 1, 1);
+    const QDate end = period.month > 0 ? begin.addMonths(1) : begin.addYears(1);
+    return QStringLiteral(
+            "AND Playlists.date_created >= '%1' "
+            "AND Playlists.date_created < '%2' %3")
+            .arg(begin.toString(Qt::ISODate),
+                    end.toString(Qt::ISODate),
+                    excludeRecentPlaylistsFilter());
+}
+
+QString SetlogFeature::periodName(const HistoryPeriod& period) const {
+    if (period.month > 0) {
+        return QStringLiteral("%1 %2").arg(
+                QLocale().standaloneMonthName(period.month),
+                QString::number(period.year));
+    }
+    return QString::number(period.year);
+}
+
+QList<int> SetlogFeature::playlistIdsOfPeriod(const HistoryPeriod& period) const {
+    QSqlQuery query(m_pLibrary->trackCollectionManager()->internalCollection()->database());
+    query.prepare(QStringLiteral(
+            "SELECT Playlists.id FROM Playlists "
+            "WHERE Playlists.hidden = :hidden %1")
+                          .arg(periodFilter(period)));
+    query.bindValue(":hidden", PlaylistDAO::PLHT_SET_LOG);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    QList<int> ids;
+    while (query.next()) {
+        ids.append(query.value(0).toInt());
+    }
+    return ids;
+}
+
+const QSet<int>& SetlogFeature::monthsOfSelectedTrack() {
+    if (m_monthsOfSelectedTrackPlaylistIds == m_playlistIdsOfSelectedTrack) {
+        return m_monthsOfSelectedTrack;
+    }
+    m_monthsOfSelectedTrackPlaylistIds = m_playlistIdsOfSelectedTrack;
+    m_monthsOfSelectedTrack.clear();
+    if (m_playlistIdsOfSelectedTrack.isEmpty()) {
+        return m_monthsOfSelectedTrack;
+    }
+    QStringList ids;
+    ids.reserve(m_playlistIdsOfSelectedTrack.size());
+    for (const int id : std::as_const(m_playlistIdsOfSelectedTrack)) {
+        ids.append(QString::number(id));
+    }
+    QSqlQuery query(m_pLibrary->trackCollectionManager()->internalCollection()->database());
+    query.prepare(QStringLiteral(
+            "SELECT DISTINCT "
+            "  CAST(strftime('%Y', date_created) AS INTEGER) * 100 + "
+            "  CAST(strftime('%m', date_created) AS INTEGER) "
+            "FROM Playlists "
+            "WHERE hidden = :hidden AND id IN (%1)")
+                          .arg(ids.join(',')));
+    query.bindValue(":hidden", PlaylistDAO::PLHT_SET_LOG);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    while (query.next()) {
+        m_monthsOfSelectedTrack.insert(query.value(0).toInt());
+    }
+    return m_monthsOfSelectedTrack;
+}
+
+QModelIndex SetlogFeature::indexFromTreeItem(TreeItem* pItem) const {
+    if (!pItem || !pItem->hasParent()) {
+        return QModelIndex();
+    }
+    return m_pSidebarModel->index(pItem->parentRow(), 0, indexFromTreeItem(pItem->parent()));
+}
+
+QModelIndex SetlogFeature::indexFromPeriod(int year, int month) const {
+    for (auto it = m_periodItems.constBegin(); it != m_periodItems.constEnd(); ++it) {
+        if (it->year == year && it->month == month) {
+            return indexFromTreeItem(const_cast<TreeItem*>(it.key()));
+        }
+    }
+    return QModelIndex();
+}
+
+void SetlogFeature::loadMonth(const QModelIndex& index) {
+    TreeItem* pItem = m_pSidebarModel->getItem(index);
+    const auto it = m_periodItems.find(pItem);
+    if (it == m_periodItems.end() || it->month == 0 || it->loaded) {
+        return;
+    }
+    it->loaded = true;
+    std::vector<std::unique_ptr<TreeItem>> items = createPlaylistItems(periodFilter(*it));
+    // Replace the placeholder
+    m_pSidebarModel->removeRows(0, pItem->childRows(), index);
+    m_pSidebarModel->insertTreeItemRows(std::move(items), 0, index);
+}
+
+void SetlogFeature::onLazyChildExpandation(const QModelIndex& index) {
+    if (!index.isValid()) {
+        return;
+    }
+    loadMonth(index);
+}
+
+QModelIndex SetlogFeature::indexFromPlaylistId(int playlistId) {
+    QModelIndex index = BasePlaylistFeature::indexFromPlaylistId(playlistId);
+    if (index.isValid() ||
+            playlistId == kInvalidPlaylistId ||
+            playlistId == m_yearNodeId) {
+        return index;
+    }
+    // The playlist may belong to a month that has not been expanded yet
+    QSqlQuery query(m_pLibrary->trackCollectionManager()->internalCollection()->database());
+    query.prepare(QStringLiteral(
+            "SELECT "
+            "  CAST(strftime('%Y', date_created) AS INTEGER), "
+            "  CAST(strftime('%m', date_created) AS INTEGER) "
+            "FROM Playlists "
+            "WHERE id = :id AND hidden = :hidden"));
+    query.bindValue(":id", playlistId);
+    query.bindValue(":hidden", PlaylistDAO::PLHT_SET_LOG);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return index;
+    }
+    if (!query.next()) {
+        return index;
+    }
+    const QModelIndex monthIndex = indexFromPeriod(
+            query.value(0).toInt(), query.value(1).toInt());
+    if (!monthIndex.isValid()) {
+        return index;
+    }
+    loadMonth(monthIndex);
+    return BasePlaylistFeature::indexFromPlaylistId(playlistId);
+}
+
+void SetlogFeature::clearChildModel() {
+    BasePlaylistFeature::clearChildModel();
+    m_periodItems.clear();
+    m_recentPlaylistIds.clear();
+}
+
+void SetlogFeature::markTreeItem(TreeItem* pTreeItem) {
+    const auto it = m_periodItems.constFind(pTreeItem);
+    if (it == m_periodItems.constEnd() || it->loaded) {
+        BasePlaylistFeature::markTreeItem(pTreeItem);
+        return;
+    }
+    // The playlists of this month are not loaded yet
+    const bool shouldBold = monthsOfSelectedTrack().contains(it->year * 100 + it->month);
+    pTreeItem->setBold(shouldBold);
+    if (shouldBold) {
+        TreeItem* pItem = pTreeItem;
+        while ((pItem = pItem->parent())) {
+            pItem->setBold(true);
+        }
+    }
+}
+
 void SetlogFeature::decorateChild(TreeItem* item, int playlistId) {
     if (playlistId == m_currentPlaylistId) {
         item->setIcon(QIcon(":/images/library/ic_library_history_current.svg"));
@@ -498,52 +704,45 @@ void SetlogFeature::lockOrUnlockAllChildPlaylists(bool lock) {
     if (!m_lastRightClickedIndex.isValid()) {
         return;
     }
+    const auto it = m_periodItems.constFind(m_pSidebarModel->getItem(m_lastRightClickedIndex));
+    if (it == m_periodItems.constEnd()) {
+        return;
+    }
     if (lock) {
-        qWarning() << "lock all child playlists of" << m_lastRightClickedIndex.data().toString();
+        qWarning() << "lock all child playlists of" << periodName(*it);
     } else {
-        qWarning() << "unlock all child playlists of" << m_lastRightClickedIndex.data().toString();
-    }
-    TreeItem* item = static_cast<TreeItem*>(m_lastRightClickedIndex.internalPointer());
-    if (!item) {
-        return;
+        qWarning() << "unlock all child playlists of" << periodName(*it);
     }
-    const QList<TreeItem*> yearChildren = item->children();
-    if (yearChildren.isEmpty()) {
+    // Query the playlists of the period, because the playlists of
+    // collapsed months are not loaded.
+    const QList<int> ids = playlistIdsOfPeriod(*it);
+    if (ids.isEmpty()) {
         return;
     }
-
-    QSet<int> ids;
-    for (const auto& pChild : yearChildren) {
-        bool ok = false;
-        int childId = pChild->getData().toInt(&ok);
-        if (ok && childId != kInvalidPlaylistId) {
-            ids.insert(childId);
-        }
-    }
-    m_playlistDao.setPlaylistsLocked(ids, lock);
+    m_playlistDao.setPlaylistsLocked(QSet<int>(ids.begin(), ids.end()), lock);
 }
 
 void SetlogFeature::slotDeleteAllUnlockedChildPlaylists() {
     if (!m_lastRightClickedIndex.isValid()) {
         return;
     }
-    TreeItem* item = static_cast<TreeItem*>(m_lastRightClickedIndex.internalPointer());
-    if (!item) {
+    const auto it = m_periodItems.constFind(m_pSidebarModel->getItem(m_lastRightClickedIndex));
+    if (it == m_periodItems.constEnd()) {
         return;
     }
-    const QList<TreeItem*> yearChildren = item->children();
-    if (yearChildren.isEmpty()) {
+    const QList<int> childIds = playlistIdsOfPeriod(*it);
+    if (childIds.isEmpty()) {
         return;
     }
-    QString year = m_lastRightClickedIndex.data().toString();
+    const QString period = periodName(*it);
 
     QMessageBox::StandardButton btn = QMessageBox::question(nullptr,
             tr("Confirm Deletion"),
-            //: %1 is the year
+            //: %1 is the year or the month
             //: <b> + </b> are used to make the text in between bold in the popup
             //: <br> is a linebreak
             tr("Do you really want to delete all unlocked playlist from <b>%1</b>?<br><br>")
-                    .arg(year),
+                    .arg(period),
             QMessageBox::Yes | QMessageBox::No,
             QMessageBox::No);
     if (btn != QMessageBox::Yes) {
@@ -551,30 +750,25 @@ void SetlogFeature::slotDeleteAllUnlockedChildPlaylists() {
     }
 
     QStringList ids;
-    int count = 0;
-    for (const auto& pChild : yearChildren) {
-        bool ok = false;
-        int childId = pChild->getData().toInt(&ok);
-        if (ok && childId != kInvalidPlaylistId) {
-            ids.append(pChild->getData().toString());
-            count++;
-        }
+    ids.reserve(childIds.size());
+    for (const int childId : childIds) {
+        ids.append(QString::number(childId));
     }
     // Double-check, this is a weighty decision
     btn = QMessageBox::warning(nullptr,
             tr("Confirm Deletion"),
             //: %1 is the number of playlists to be deleted
-            //: %2 is the year
+            //: %2 is the year or the month
             //: <b> + </b> are used to make the text in between bold in the popup
             //: <br> is a linebreak
             tr("Deleting %1 playlists from <b>%2</b>.<br><br>")
-                    .arg(QString::number(count), year),
+                    .arg(QString::number(ids.size()), period),
             QMessageBox::Ok | QMessageBox::Cancel,
             QMessageBox::Cancel);
     if (btn != QMessageBox::Ok) {
         return;
     }
-    qDebug() << "History: deleting all unlocked playlists of" << year;
+    qDebug() << "History: deleting all unlocked playlists of" << period;
     m_playlistDao.deleteUnlockedPlaylists(std::move(ids));
 }
 
@@ -664,14 +858,18 @@ void SetlogFeature::slotPlaylistTableChanged(int playlistId) {
 
     // save currently selected History sidebar item (if any)
     int selectedYearIndexRow = -1;
+    HistoryPeriod selectedPeriod{0, 0, false};
     int selectedPlaylistId = kInvalidPlaylistId;
     bool rootWasSelected = false;
     if (isChildIndexSelectedInSidebar(m_lastClickedIndex)) {
-        // a child index was selected (actual playlist or YEAR item)
+        // a child index was selected (actual playlist or YEAR/MONTH item)
         int lastClickedPlaylistId = playlistIdFromIndex(m_lastClickedIndex);
         if (lastClickedPlaylistId == m_yearNodeId) {
-            // a YEAR item was selected
-            selectedYearIndexRow = m_lastClickedIndex.row();
+            // a YEAR or MONTH item was selected
+            selectedPeriod = m_periodItems.value(m_pSidebarModel->getItem(m_lastClickedIndex));
+            if (selectedPeriod.month == 0) {
+                selectedYearIndexRow = m_lastClickedIndex.row();
+            }
         } else if (playlistId == lastClickedPlaylistId &&
                 type == PlaylistDAO::PLHT_UNKNOWN) {
             // selected playlist was deleted, find a sibling.
@@ -697,8 +895,15 @@ void SetlogFeature::slotPlaylistTableChanged(int playlistId) {
     QModelIndex newIndex = constructChildModel(selectedPlaylistId);
 
     // restore selection
-    if (selectedYearIndexRow != -1) {
-        // if row is valid this means newIndex is invalid anyway
+    if (selectedPeriod.year != 0) {
+        newIndex = indexFromPeriod(selectedPeriod.year, selectedPeriod.month);
+        if (!newIndex.isValid() && selectedPeriod.month != 0) {
+            // the MONTH item is gone, select its YEAR item instead
+            newIndex = indexFromPeriod(selectedPeriod.year, 0);
+        }
+    }
+    if (!newIndex.isValid() && selectedYearIndexRow != -1) {
+        // the YEAR item is gone, select the item at its row
         newIndex = m_pSidebarModel->index(selectedYearIndexRow, 0);
         if (!newIndex.isValid()) {
             // seems like we deleted the oldest (bottom) YEAR node while it was
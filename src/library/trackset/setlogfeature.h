@@ -1,6 +1,8 @@
 #pragma once
 
+#include <QHash>
 #include <QPointer>
+#include <QSet>
 
 #include "library/trackset/baseplaylistfeature.h"
 #include "preferences/usersettings.h"
@@ -33,10 +35,14 @@ class SetlogFeature : public BasePlaylistFeature {
     void slotGetNewPlaylist();
     void activate() override;
     void activateChild(const QModelIndex& index) override;
+    void onLazyChildExpandation(const QModelIndex& index) override;
 
   protected:
     QModelIndex constructChildModel(int selectedId);
     void decorateChild(TreeItem* pChild, int playlistId) override;
+    void clearChildModel() override;
+    QModelIndex indexFromPlaylistId(int playlistId) override;
+    void markTreeItem(TreeItem* pTreeItem) override;
 
   private slots:
     void slotPlayingTrackChanged(TrackPointer currentPlayingTrack);
@@ -46,6 +52,31 @@ class SetlogFeature : public BasePlaylistFeature {
     void slotDeleteAllUnlockedChildPlaylists();
 
   private:
+    /// A YEAR item or a MONTH item of the sidebar
+    struct HistoryPeriod {
+        int year;
+        /// 1 to 12, or 0 for the whole year
+        int month;
+        /// Whether the playlists of a MONTH item have been loaded
+        bool loaded;
+    };
+
+    /// Creates the items of the history playlists matching the filter,
+    /// most recent first
+    std::vector<std::unique_ptr<TreeItem>> createPlaylistItems(
+            const QString& filter, int limit = -1);
+    QString excludeRecentPlaylistsFilter() const;
+    QString periodFilter(const HistoryPeriod& period) const;
+    QString periodName(const HistoryPeriod& period) const;
+    QList<int> playlistIdsOfPeriod(const HistoryPeriod& period) const;
+    /// The months (year * 100 + month) with history playlists that
+    /// contain the selected track
+    const QSet<int>& monthsOfSelectedTrack();
+    QModelIndex indexFromTreeItem(TreeItem* pItem) const;
+    QModelIndex indexFromPeriod(int year, int month) const;
+    /// Replaces the placeholder of a MONTH item with its playlists
+    void loadMonth(const QModelIndex& index);
+
     void deleteAllUnlockedPlaylistsWithFewerTracks();
     void lockOrUnlockAllChildPlaylists(bool lock);
     QString getRootViewHtml() const override;
@@ -60,6 +91,11 @@ class SetlogFeature : public BasePlaylistFeature {
 
     int m_currentPlaylistId;
     int m_yearNodeId;
+    QHash<const TreeItem*, HistoryPeriod> m_periodItems;
+    /// The playlists shown at the top level instead of in their month
+    QSet<int> m_recentPlaylistIds;
+    QSet<int> m_monthsOfSelectedTrackPlaylistIds;
+    QSet<int> m_monthsOfSelectedTrack;
     Library* m_pLibrary;
     UserSettingsPointer m_pConfig;
 };
@@ -0,0 +1,217 @@
+#include "library/trackset/trackidbitmap.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "util/assert.h"
+
+namespace {
+
+constexpr int kBitsPerWord = 64;
+
+// 65536 bits
+constexpr std::size_t kBitmapWords = 1024;
+
+// An array with more elements would need more memory than a bitmap
+constexpr int kMaxArraySize = 4096;
+
+// Don't convert bitmaps back to arrays right after exceeding
+// the maximum size of an array
+constexpr int kMinBitmapSize = kMaxArraySize / 2;
+
+bool splitTrackId(TrackId trackId, std::uint16_t* pHigh, std::uint16_t* pLow) {
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return false;
+    }
+    const auto value = static_cast<std::uint32_t>(trackId.toVariant().toInt());
+    *pHigh = static_cast<std::uint16_t>(value >> 16);
+    *pLow = static_cast<std::uint16_t>(value & 0xFFFF);
+    return true;
+}
+
+} // anonymous namespace
+
+bool TrackIdBitmap::insert(TrackId trackId) {
+    std::uint16_t high;
+    std::uint16_t low;
+    if (!splitTrackId(trackId, &high, &low)) {
+        return false;
+    }
+    auto it = std::lower_bound(m_chunks.begin(),
+            m_chunks.end(),
+            high,
+            [](const Chunk& chunk, std::uint16_t high) {
+                return chunk.high() < high;
+            });
+    if (it == m_chunks.end() || it->high() != high) {
+        it = m_chunks.insert(it, Chunk(high));
+    }
+    if (!it->insert(low)) {
+        return false;
+    }
+    ++m_size;
+    return true;
+}
+
+bool TrackIdBitmap::remove(TrackId trackId) {
+    std::uint16_t high;
+    std::uint16_t low;
+    if (!splitTrackId(trackId, &high, &low)) {
+        return false;
+    }
+    const auto it = std::lower_bound(m_chunks.begin(),
+            m_chunks.end(),
+            high,
+            [](const Chunk& chunk, std::uint16_t high) {
+                return chunk.high() < high;
+            });
+    if (it == m_chunks.end() || it->high() != high) {
+        return false;
+    }
+    if (!it->remove(low)) {
+        return false;
+    }
+    if (it->size() == 0) {
+        m_chunks.erase(it);
+    }
+    --m_size;
+    return true;
+}
+
+void TrackIdBitmap::clear() {
+    m_chunks.clear();
+    m_size = 0;
+}
+
+bool TrackIdBitmap::contains(TrackId trackId) const {
+    if (!trackId.isValid()) {
+        return false;
+    }
+    std::uint16_t high;
+    std::uint16_t low;
+    splitTrackId(trackId, &high, &low);
+    const auto it = std::lower_bound(m_chunks.begin(),
+            m_chunks.end(),
+            high,
+            [](const Chunk& chunk, std::uint16_t high) {
+                return chunk.high() < high;
+            });
+    return it != m_chunks.end() && it->high() == high && it->contains(low);
+}
+
+int TrackIdBitmap::countContained(const QList<TrackId>& trackIds) const {
+    if (isEmpty()) {
+        return 0;
+    }
+    return static_cast<int>(std::count_if(trackIds.begin(),
+            trackIds.end(),
+            [this](TrackId trackId) {
+                return contains(trackId);
+            }));
+}
+
+QList<TrackId> TrackIdBitmap::toList() const {
+    QList<TrackId> trackIds;
+    trackIds.reserve(m_size);
+    for (const auto& chunk : m_chunks) {
+        chunk.appendTo(&trackIds);
+    }
+    DEBUG_ASSERT(trackIds.size() == m_size);
+    return trackIds;
+}
+
+bool TrackIdBitmap::Chunk::insert(std::uint16_t low) {
+    if (isBitmap()) {
+        auto& word = m_bitmap[low / kBitsPerWord];
+        const auto mask = std::uint64_t{1} << (low % kBitsPerWord);
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+    } else {
+        const auto it = std::lower_bound(m_array.begin(), m_array.end(), low);
+        if (it != m_array.end() && *it == low) {
+            return false;
+        }
+        m_array.insert(it, low);
+    }
+    ++m_size;
+    if (!isBitmap() && m_size > kMaxArraySize) {
+        convertToBitmap();
+    }
+    return true;
+}
+
+bool TrackIdBitmap::Chunk::remove(std::uint16_t low) {
+    if (isBitmap()) {
+        auto& word = m_bitmap[low / kBitsPerWord];
+        const auto mask = std::uint64_t{1} << (low % kBitsPerWord);
+        if (!(word & mask)) {
+            return false;
+        }
+        word &= ~mask;
+    } else {
+        const auto it = std::lower_bound(m_array.begin(), m_array.end(), low);
+        if (it == m_array.end() || *it != low) {
+            return false;
+        }
+        m_array.erase(it);
+    }
+    --m_size;
+    if (isBitmap() && m_size < kMinBitmapSize) {
+        convertToArray();
+    }
+    return true;
+}
+
+bool TrackIdBitmap::Chunk::contains(std::uint16_t low) const {
+    if (isBitmap()) {
+        return m_bitmap[low / kBitsPerWord] & (std::uint64_t{1} << (low % kBitsPerWord));
+    }
+    return std::binary_search(m_array.begin(), m_array.end(), low);
+}
+
+void TrackIdBitmap::Chunk::appendTo(QList<TrackId>* pTrackIds) const {
+    const int base = static_cast<int>(m_high) << 16;
+    if (isBitmap()) {
+        for (std::size_t i = 0; i < m_bitmap.size(); ++i) {
+            std::uint64_t word = m_bitmap[i];
+            while (word) {
+                const int bit = std::countr_zero(word);
+                pTrackIds->append(TrackId(QVariant(
+                        base + static_cast<int>(i) * kBitsPerWord + bit)));
+                word &= word - 1;
+            }
+        }
+    } else {
+        for (const auto low : m_array) {
+            pTrackIds->append(TrackId(QVariant(base + low)));
+        }
+    }
+}
+
+void TrackIdBitmap::Chunk::convertToBitmap() {
+    DEBUG_ASSERT(!isBitmap());
+    m_bitmap.assign(kBitmapWords, 0);
+    for (const auto low : m_array) {
+        m_bitmap[low / kBitsPerWord] |= std::uint64_t{1} << (low % kBitsPerWord);
+    }
+    m_array = std::vector<std::uint16_t>();
+}
+
+void TrackIdBitmap::Chunk::convertToArray() {
+    DEBUG_ASSERT(isBitmap());
+    std::vector<std::uint16_t> array;
+    array.reserve(m_size);
+    for (std::size_t i = 0; i < m_bitmap.size(); ++i) {
+        std::uint64_t word = m_bitmap[i];
+        while (word) {
+            const int bit = std::countr_zero(word);
+            array.push_back(static_cast<std::uint16_t>(i * kBitsPerWord + bit));
+            word &= word - 1;
+        }
+    }
+    DEBUG_ASSERT(static_cast<int>(array.size()) == m_size);
+    m_array = std::move(array);
+    m_bitmap = std::vector<std::uint64_t>();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QList>
+#include <cstdint>
+#include <vector>
+
+#include "track/trackid.h"
+
+/// TrackIdBitmap is a compressed set of track ids in the style of
+/// roaring bitmaps.
+///
+/// The ids are partitioned into chunks of 65536 consecutive values by
+/// their upper 16 bits. Each chunk stores the lower 16 bits of its ids
+/// either in a sorted array while it contains only a few ids or in a
+/// bitmap of 8 KiB otherwise. Small sets like most crates only need a
+/// few bytes per track, while large sets need at most a single bit per
+/// track. Membership tests take constant time for bitmaps and logarithmic
+/// time for arrays.
+class TrackIdBitmap final {
+  public:
+    TrackIdBitmap() = default;
+
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+    int size() const {
+        return m_size;
+    }
+
+    /// Returns true if the track has been added and false if it was
+    /// already contained.
+    bool insert(TrackId trackId);
+    /// Returns true if the track has been removed and false if it was
+    /// not contained.
+    bool remove(TrackId trackId);
+    void clear();
+
+    bool contains(TrackId trackId) const;
+
+    /// Returns the number of the given tracks that are contained.
+    int countContained(const QList<TrackId>& trackIds) const;
+
+    /// Returns all tracks in ascending order.
+    QList<TrackId> toList() const;
+
+  private:
+    class Chunk {
+      public:
+        explicit Chunk(std::uint16_t high)
+                : m_high(high),
+                  m_size(0) {
+        }
+
+        std::uint16_t high() const {
+            return m_high;
+        }
+        int size() const {
+            return m_size;
+        }
+
+        bool insert(std::uint16_t low);
+        bool remove(std::uint16_t low);
+        bool contains(std::uint16_t low) const;
+
+        void appendTo(QList<TrackId>* pTrackIds) const;
+
+      private:
+        bool isBitmap() const {
+            return !m_bitmap.empty();
+        }
+        void convertToBitmap();
+        void convertToArray();
+
+        std::uint16_t m_high;
+        int m_size;
+        // Only one of both is used at a time
+        std::vector<std::uint16_t> m_array;
+        std::vector<std::uint64_t> m_bitmap;
+    };
+
+    // Sorted by high
+    std::vector<Chunk> m_chunks;
+    int m_size = 0;
+};
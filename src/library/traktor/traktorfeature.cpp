@@ -1,5 +1,6 @@
 #include "library/traktor/traktorfeature.h"
 
+#include <QHash>
 #include <QMap>
 #include <QMessageBox>
 #include <QRegularExpression>
@@ -8,6 +9,8 @@
 #include <QXmlStreamReader>
 #include <QtDebug>
 
+#include "library/dao/settingsdao.h"
+#include "library/externallibraryfingerprint.h"
 #include "library/library.h"
 #include "library/librarytablemodel.h"
 #include "library/missing_hidden/missingtablemodel.h"
@@ -22,6 +25,11 @@
 
 namespace {
 
+const QString kCollectionFingerprintKey = QStringLiteral("mixxx.traktorfeature.collectionfingerprint");
+
+// Separates the folders in the unique path of a playlist
+const QString kPlaylistPathDelimiter = QStringLiteral("-->");
+
 QString fromTraktorSeparators(QString path) {
     // Traktor uses /: instead of just / as delimiting character for some reasons
     return path.replace("/:", "/");
@@ -108,23 +116,10 @@ TraktorFeature::TraktorFeature(Library* pLibrary, UserSettingsPointer pConfig)
 
     m_title = tr("Traktor");
 
-    m_database =
-            QSqlDatabase::cloneDatabase(pLibrary->trackCollectionManager()
-                                                ->internalCollection()
-                                                ->database(),
-                    "TRAKTOR_SCANNER");
-
-    //Open the database connection in this thread.
-    if (!m_database.open()) {
-        qDebug() << "Failed to open database for iTunes scanner."
-                 << m_database.lastError();
-    }
     connect(&m_future_watcher,
             &QFutureWatcher<TreeItem*>::finished,
             this,
             &TraktorFeature::onTrackCollectionLoaded);
-
-    m_pTraktorTableModel->setSearch(""); // enable search
 }
 
 TraktorFeature::~TraktorFeature() {
@@ -158,9 +153,26 @@ TreeItemModel* TraktorFeature::sidebarModel() const {
 void TraktorFeature::refreshLibraryModels() {
 }
 
+void TraktorFeature::initialize() {
+    m_database =
+            QSqlDatabase::cloneDatabase(m_pLibrary->trackCollectionManager()
+                                                ->internalCollection()
+                                                ->database(),
+                    "TRAKTOR_SCANNER");
+
+    //Open the database connection in this thread.
+    if (!m_database.open()) {
+        qDebug() << "Failed to open database for iTunes scanner."
+                 << m_database.lastError();
+    }
+
+    m_pTraktorTableModel->setSearch(""); // enable search
+}
+
 void TraktorFeature::activate() {
     qDebug() << "TraktorFeature::activate()";
 
+    initializeOnce();
     if (!m_isActivated) {
         m_isActivated =  true;
         // Let a worker thread do the XML parsing
@@ -205,11 +217,35 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     thisThread->setPriority(QThread::LowPriority);
     //Invisible root item of Traktor's child model
     TreeItem* root = nullptr;
+
+    mixxx::FileInfo fileInfo(file);
+    QFile traktor_file(file);
+    if (!Sandbox::askForAccess(&fileInfo) || !traktor_file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Cannot open Traktor music collection: " << traktor_file.errorString();
+        return nullptr;
+    }
+
+    // The tables still contain the previous import if the collection
+    // has not changed since then
+    SettingsDAO settings(m_database);
+    if (ExternalLibraryFingerprint::fromString(
+                settings.getValue(kCollectionFingerprintKey))
+                    .matchesFile(file)) {
+        std::unique_ptr<TreeItem> pRootItem = restorePlaylistTree();
+        if (pRootItem) {
+            qDebug() << "Traktor collection is unchanged since the last import";
+            return pRootItem.release();
+        }
+    }
+    // Computed before parsing to detect modifications while importing
+    const auto fingerprint = ExternalLibraryFingerprint::ofFile(file);
+
     //Delete all table entries of Traktor feature
     ScopedTransaction transaction(m_database);
     clearTable("traktor_playlist_tracks");
     clearTable("traktor_library");
     clearTable("traktor_playlists");
+    settings.setValue(kCollectionFingerprintKey, QString());
     transaction.commit();
 
     transaction.transaction();
@@ -221,12 +257,6 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
                   ":rating,:key)");
 
     //Parse Trakor XML file using SAX (for performance)
-    mixxx::FileInfo fileInfo(file);
-    QFile traktor_file(file);
-    if (!Sandbox::askForAccess(&fileInfo) || !traktor_file.open(QIODevice::ReadOnly)) {
-        qDebug() << "Cannot open Traktor music collection: " << traktor_file.errorString();
-        return nullptr;
-    }
     QXmlStreamReader xml(&traktor_file);
     bool inCollectionTag = false;
     bool inPlaylistsTag = false;
@@ -279,12 +309,52 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     }
 
     qDebug() << "Found: " << nAudioFiles << " audio files in Traktor";
+    // Only a complete import may be reused later
+    if (root && !m_cancelImport) {
+        settings.setValue(kCollectionFingerprintKey, fingerprint.toString());
+    }
     //initialize TraktorTableModel
     transaction.commit();
 
     return root;
 }
 
+std::unique_ptr<TreeItem> TraktorFeature::restorePlaylistTree() {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT name FROM traktor_playlists ORDER BY id");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return nullptr;
+    }
+
+    // The playlists have been inserted in the order of the tree and their
+    // names are the unique paths of folders, e.g. "-->folderA-->playlistA".
+    // Empty folders are not restored.
+    std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
+    QHash<QString, TreeItem*> foldersByPath;
+    while (query.next()) {
+        const QString playlistPath = query.value(0).toString();
+        const QStringList names = playlistPath.split(kPlaylistPathDelimiter);
+        if (names.size() < 2) {
+            continue;
+        }
+        TreeItem* parent = rootItem.get();
+        QString folderPath;
+        for (int i = 1; i < names.size() - 1; ++i) {
+            folderPath += kPlaylistPathDelimiter;
+            folderPath += names[i];
+            auto folder = foldersByPath.find(folderPath);
+            if (folder == foldersByPath.end()) {
+                folder = foldersByPath.insert(folderPath,
+                        parent->appendChild(names[i], folderPath));
+            }
+            parent = folder.value();
+        }
+        parent->appendChild(names.last(), playlistPath);
+    }
+    return rootItem;
+}
+
 void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
     QString title;
     QString artist;
@@ -417,7 +487,7 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
     QString current_path = "";
     QMap<QString,QString> map;
 
-    QString delimiter = "-->";
+    const QString& delimiter = kPlaylistPathDelimiter;
 
     std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
     TreeItem* parent = rootItem.get();
@@ -48,9 +48,12 @@ class TraktorFeature : public BaseExternalLibraryFeature {
     void onTrackCollectionLoaded();
 
   private:
+    void initialize() override;
     std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
             const QString& playlist) override;
     TreeItem* importLibrary(const QString& file);
+    // Restores the sidebar from the tables of the previous import
+    std::unique_ptr<TreeItem> restorePlaylistTree();
     // parses a track in the music collection
     void parseTrack(QXmlStreamReader &xml, QSqlQuery &query);
     // Iterates over all playliost and folders and constructs the childmodel
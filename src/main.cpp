@@ -40,10 +40,9 @@ const QString kConfigGroup = QStringLiteral("[Config]");
 const QString kScaleFactorKey = QStringLiteral("ScaleFactor");
 
 // The default initial QPixmapCache limit is 10MB.
-// But this is used for all CoverArts in all used sizes and
-// as rendering cache for all SVG icons by Qt behind the scenes.
-// Consequently coverArt cache will always have less than those
-// 10MB available to store the pixmaps.
+// This is used as rendering cache for all SVG icons by Qt behind
+// the scenes. Cover arts are cached separately by CoverArtCache
+// with its own, configurable memory budget.
 // Profiling at 100% HiDPI zoom on Windows, that with 20MByte,
 // the SVG rendering happens sometimes during normal operation.
 // An indicator that the QPixmapCache was too small.
@@ -1,5 +1,7 @@
 #include "mixer/previewdeck.h"
 
+#include "engine/channels/enginedeck.h"
+#include "engine/enginebuffer.h"
 #include "moc_previewdeck.cpp"
 
 PreviewDeck::PreviewDeck(PlayerManager* pParent,
@@ -17,4 +19,7 @@ PreviewDeck::PreviewDeck(PlayerManager* pParent,
                   /*defaultMainMix*/ false,
                   /*defaultHeadphones*/ true,
                   /*primaryDeck*/ false) {
+    // Previews are started while browsing the library, often for tracks
+    // that have been prefetched when they were selected
+    getEngineDeck()->getEngineBuffer()->setPreviewMode(true);
 }
@@ -1,5 +1,7 @@
 #include "mixer/sampler.h"
 
+#include "engine/channels/enginedeck.h"
+#include "engine/enginebuffer.h"
 #include "moc_sampler.cpp"
 
 Sampler::Sampler(PlayerManager* pParent,
@@ -17,4 +19,7 @@ Sampler::Sampler(PlayerManager* pParent,
                   /*defaultMainMix*/ true,
                   /*defaultHeadphones*/ false,
                   /*primaryDeck*/ false) {
+    // Samples are often triggered right after loading them, e.g. from a
+    // sampler bank, and must not miss the cache when played first
+    getEngineDeck()->getEngineBuffer()->setPreloadAllTracks(true);
 }
@@ -5,6 +5,7 @@
 #include <QDebug>
 #include <QFileDialog>
 #include <QOpenGLContext>
+#include <QTimer>
 #include <QUrl>
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -31,6 +32,7 @@
 #ifdef __BROADCAST__
 #include "broadcast/broadcastmanager.h"
 #endif
+#include "control/controlchangecoalescer.h"
 #include "control/controlindicatortimer.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
@@ -117,6 +119,10 @@ MixxxMainWindow::MixxxMainWindow(std::shared_ptr<mixxx::CoreServices> pCoreServi
                 CmdlineArgs::Instance().getStartInFullscreen() || fullscreenPref);
     }
 #endif // __LINUX__
+    // Must be selected before the widgets connect to their controls
+    ControlChangeCoalescer::setEnabled(
+            m_pCoreServices->getSettings()->getValue<bool>(
+                    ConfigKey("[App]", "coalesce_control_changes"), false));
     createMenuBar();
     m_pMenuBar->hide();
 
@@ -430,6 +436,23 @@ void MixxxMainWindow::initialize() {
         qDebug("Enabling Auto DJ from CLI flag.");
         ControlObject::set(ConfigKey("[AutoDJ]", "enabled"), 1.0);
     }
+
+    // Analyze a crate and quit afterwards if the cmdline arg is passed.
+    const QString& analyzeCrate = CmdlineArgs::Instance().getAnalyzeCrate();
+    if (!analyzeCrate.isEmpty()) {
+        qDebug() << "Analyzing crate" << analyzeCrate << "from CLI flag.";
+        connect(m_pCoreServices->getLibrary().get(),
+                &Library::analysisActive,
+                this,
+                [this](bool active) {
+                    if (!active) {
+                        close();
+                    }
+                });
+        if (!m_pCoreServices->getLibrary()->analyzeCrateByName(analyzeCrate)) {
+            QTimer::singleShot(0, this, &MixxxMainWindow::close);
+        }
+    }
 }
 
 MixxxMainWindow::~MixxxMainWindow() {
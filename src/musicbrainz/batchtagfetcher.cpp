@@ -0,0 +1,418 @@
+#include "musicbrainz/batchtagfetcher.h"
+
+#include <QDateTime>
+#include <algorithm>
+
+#include "engine/cachingreader/cachingreaderpcmcache.h"
+#include "moc_batchtagfetcher.cpp"
+#include "musicbrainz/chromaprinter.h"
+#include "network/networkscheduler.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/thread_affinity.h"
+
+namespace {
+
+const mixxx::Logger kLogger("BatchTagFetcher");
+
+// Long timeout to cope with occasional server-side unresponsiveness
+constexpr int kAcoustIdTimeoutMillis = 60000; // msec
+
+// Long timeout to cope with occasional server-side unresponsiveness
+constexpr int kMusicBrainzTimeoutMillis = 60000; // msec
+
+// AcoustID allows 3 requests per second
+constexpr int kMinLookupIntervalMillis = 334;
+constexpr int kMaxLookupIntervalMillis = 10000;
+constexpr int kMaxLookupRetries = 5;
+
+// Enough to keep the connection busy while the responses of the
+// previous batches are on their way
+constexpr int kMaxPendingLookups = 3;
+
+constexpr mixxx::network::HttpStatusCode kHttpStatusCodeTooManyRequests = 429;
+constexpr mixxx::network::HttpStatusCode kHttpStatusCodeServiceUnavailable = 503;
+
+bool isRateLimited(mixxx::network::HttpStatusCode statusCode) {
+    return statusCode == kHttpStatusCodeTooManyRequests ||
+            statusCode == kHttpStatusCodeServiceUnavailable;
+}
+
+} // anonymous namespace
+
+BatchTagFetcher::BatchTagFetcher(
+        UserSettingsPointer pConfig,
+        AnalysisDao* pAnalysisDao,
+        QObject* parent)
+        : QObject(parent),
+          m_pAnalysisDao(pAnalysisDao),
+          m_pPcmCache(CachingReaderPcmCache::create(pConfig)),
+          m_pNetworkAccessManager(mixxx::network::NetworkScheduler::instance()),
+          m_fetchId(0),
+          m_totalTracks(0),
+          m_finishedTracks(0),
+          m_pendingFingerprints(0),
+          m_nextLookupAtMillis(0),
+          m_lookupIntervalMillis(kMinLookupIntervalMillis),
+          m_lookupRetries(0) {
+}
+
+BatchTagFetcher::~BatchTagFetcher() {
+    cancel();
+    // The fingerprints that are still calculated are discarded
+    m_fingerprintThreadPool.waitForDone();
+}
+
+// static
+QString BatchTagFetcher::fileSignature(
+        const TrackPointer& pTrack) {
+    const auto fileInfo = pTrack->getFileInfo();
+    return QStringLiteral("%1:%2").arg(
+            QString::number(fileInfo.sizeInBytes()),
+            QString::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+}
+
+void BatchTagFetcher::startFetch(
+        const QList<TrackPointer>& tracks) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    cancel();
+
+    m_totalTracks = tracks.size();
+    m_fetchTimer.start();
+    const int fetchId = m_fetchId;
+    for (const auto& pTrack : tracks) {
+        const QString signature = fileSignature(pTrack);
+        if (m_pAnalysisDao) {
+            const auto chromaprint = m_pAnalysisDao->getChromaprint(pTrack->getId());
+            if (!chromaprint.fingerprint.isEmpty() &&
+                    chromaprint.fileSignature == signature) {
+                m_lookupQueue.append(LookupEntry{pTrack, chromaprint});
+                continue;
+            }
+        }
+        ++m_pendingFingerprints;
+        const int duration = pTrack->getDurationSecondsInt();
+        const auto pPcmCache = m_pPcmCache;
+        m_fingerprintThreadPool.start(
+                [this, fetchId, pTrack, duration, signature, pPcmCache] {
+                    const auto chromaprint = AnalysisDao::ChromaprintInfo{
+                            ChromaPrinter().getFingerprint(pTrack, pPcmCache.get()),
+                            duration,
+                            signature};
+                    QMetaObject::invokeMethod(
+                            this,
+                            [this, fetchId, pTrack, chromaprint] {
+                                fingerprintReady(fetchId, pTrack, chromaprint);
+                            },
+                            Qt::QueuedConnection);
+                });
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Reusing"
+                << m_lookupQueue.size()
+                << "stored fingerprints and calculating"
+                << m_pendingFingerprints
+                << "fingerprints";
+    }
+    if (m_totalTracks == 0) {
+        emit finished();
+        return;
+    }
+    startLookups();
+}
+
+void BatchTagFetcher::cancel() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    ++m_fetchId;
+    // Fingerprints that are not calculated yet are skipped
+    m_fingerprintThreadPool.clear();
+
+    for (auto* pTask : m_pendingLookups.keys()) {
+        pTask->disconnect(this);
+        pTask->deleteLater();
+    }
+    m_pendingLookups.clear();
+    if (m_pMusicBrainzTask) {
+        m_pMusicBrainzTask->disconnect(this);
+        m_pMusicBrainzTask->deleteLater();
+        m_pMusicBrainzTask = nullptr;
+    }
+    m_pMusicBrainzTrack.reset();
+
+    m_totalTracks = 0;
+    m_finishedTracks = 0;
+    m_pendingFingerprints = 0;
+    m_lookupQueue.clear();
+    m_nextLookupAtMillis = 0;
+    m_lookupIntervalMillis = kMinLookupIntervalMillis;
+    m_lookupRetries = 0;
+    m_musicBrainzQueue.clear();
+}
+
+void BatchTagFetcher::fingerprintReady(
+        int fetchId,
+        const TrackPointer& pTrack,
+        const AnalysisDao::ChromaprintInfo& chromaprint) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    if (fetchId != m_fetchId) {
+        // stray result from a canceled fetch
+        return;
+    }
+    DEBUG_ASSERT(m_pendingFingerprints > 0);
+    --m_pendingFingerprints;
+    if (chromaprint.fingerprint.isEmpty()) {
+        trackFinished(pTrack, QList<mixxx::musicbrainz::TrackRelease>());
+    } else {
+        if (m_pAnalysisDao) {
+            m_pAnalysisDao->saveChromaprint(pTrack->getId(), chromaprint);
+        }
+        m_lookupQueue.append(LookupEntry{pTrack, chromaprint});
+    }
+    startLookups();
+}
+
+void BatchTagFetcher::startLookups() {
+    while (m_pendingLookups.size() < kMaxPendingLookups &&
+            !m_lookupQueue.isEmpty()) {
+        if (m_lookupQueue.size() < mixxx::AcoustIdBatchLookupTask::kMaxFingerprints &&
+                m_pendingFingerprints > 0) {
+            // Wait for more fingerprints to fill the batch
+            return;
+        }
+        const int batchSize = std::min(
+                static_cast<int>(m_lookupQueue.size()),
+                mixxx::AcoustIdBatchLookupTask::kMaxFingerprints);
+        const QList<LookupEntry> entries = m_lookupQueue.mid(0, batchSize);
+        m_lookupQueue.erase(m_lookupQueue.begin(), m_lookupQueue.begin() + batchSize);
+
+        QList<mixxx::AcoustIdBatchLookupTask::Fingerprint> fingerprints;
+        fingerprints.reserve(entries.size());
+        for (const auto& entry : entries) {
+            fingerprints.append(mixxx::AcoustIdBatchLookupTask::Fingerprint{
+                    entry.chromaprint.fingerprint,
+                    entry.chromaprint.duration});
+        }
+        auto* const pTask = new mixxx::AcoustIdBatchLookupTask(
+                m_pNetworkAccessManager,
+                fingerprints,
+                this);
+        pTask->setPriority(mixxx::network::RequestPriority::Bulk);
+        connect(pTask,
+                &mixxx::AcoustIdBatchLookupTask::succeeded,
+                this,
+                &BatchTagFetcher::slotAcoustIdTaskSucceeded);
+        connect(pTask,
+                &mixxx::AcoustIdBatchLookupTask::failed,
+                this,
+                &BatchTagFetcher::slotAcoustIdTaskFailed);
+        connect(pTask,
+                &mixxx::AcoustIdBatchLookupTask::networkError,
+                this,
+                &BatchTagFetcher::slotAcoustIdTaskNetworkError);
+        m_pendingLookups.insert(pTask, entries);
+
+        // Pace the requests instead of sending them all at once
+        const qint64 nowMillis = m_fetchTimer.elapsed().toIntegerMillis();
+        const qint64 startAtMillis = std::max(nowMillis, m_nextLookupAtMillis);
+        m_nextLookupAtMillis = startAtMillis + m_lookupIntervalMillis;
+        pTask->invokeStart(
+                kAcoustIdTimeoutMillis,
+                static_cast<int>(startAtMillis - nowMillis));
+    }
+}
+
+QList<BatchTagFetcher::LookupEntry> BatchTagFetcher::takeLookup(
+        mixxx::AcoustIdBatchLookupTask* pTask) {
+    pTask->disconnect(this);
+    pTask->deleteLater();
+    return m_pendingLookups.take(pTask);
+}
+
+bool BatchTagFetcher::retryLookup(
+        mixxx::AcoustIdBatchLookupTask* pTask,
+        mixxx::network::HttpStatusCode statusCode) {
+    if (!isRateLimited(statusCode) || m_lookupRetries >= kMaxLookupRetries) {
+        return false;
+    }
+    ++m_lookupRetries;
+    m_lookupIntervalMillis = std::min(
+            2 * m_lookupIntervalMillis, kMaxLookupIntervalMillis);
+    kLogger.info()
+            << "AcoustID rate limit exceeded, retrying with an interval of"
+            << m_lookupIntervalMillis
+            << "ms";
+    const QList<LookupEntry> entries = takeLookup(pTask);
+    // Retry the batch before all others
+    m_lookupQueue = entries + m_lookupQueue;
+    m_nextLookupAtMillis = std::max(m_nextLookupAtMillis,
+            m_fetchTimer.elapsed().toIntegerMillis() + m_lookupIntervalMillis);
+    startLookups();
+    return true;
+}
+
+void BatchTagFetcher::slotAcoustIdTaskSucceeded(
+        const QList<QList<QUuid>>& recordingIds) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    auto* const pTask = qobject_cast<mixxx::AcoustIdBatchLookupTask*>(sender());
+    if (!m_pendingLookups.contains(pTask)) {
+        // stray call from an already aborted try
+        return;
+    }
+    m_lookupRetries = 0;
+    const QList<LookupEntry> entries = takeLookup(pTask);
+    DEBUG_ASSERT(entries.size() == recordingIds.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        if (i >= recordingIds.size() || recordingIds[i].isEmpty()) {
+            trackFinished(entries[i].pTrack, QList<mixxx::musicbrainz::TrackRelease>());
+        } else {
+            m_musicBrainzQueue.append(RecordingsEntry{entries[i].pTrack, recordingIds[i]});
+        }
+    }
+    startLookups();
+    startNextMusicBrainzTask();
+}
+
+void BatchTagFetcher::slotAcoustIdTaskFailed(
+        const mixxx::network::JsonWebResponse& response) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    auto* const pTask = qobject_cast<mixxx::AcoustIdBatchLookupTask*>(sender());
+    if (!m_pendingLookups.contains(pTask)) {
+        // stray call from an already aborted try
+        return;
+    }
+    if (retryLookup(pTask, response.statusCode())) {
+        return;
+    }
+    const QList<LookupEntry> entries = takeLookup(pTask);
+    emit networkError(
+            response.statusCode(),
+            QStringLiteral("AcoustID"),
+            response.content().toJson(),
+            -1);
+    for (const auto& entry : entries) {
+        trackFinished(entry.pTrack, QList<mixxx::musicbrainz::TrackRelease>());
+    }
+    startLookups();
+}
+
+void BatchTagFetcher::slotAcoustIdTaskNetworkError(
+        QNetworkReply::NetworkError errorCode,
+        const QString& errorString,
+        const mixxx::network::WebResponseWithContent& responseWithContent) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    auto* const pTask = qobject_cast<mixxx::AcoustIdBatchLookupTask*>(sender());
+    if (!m_pendingLookups.contains(pTask)) {
+        // stray call from an already aborted try
+        return;
+    }
+    if (retryLookup(pTask, responseWithContent.statusCode())) {
+        return;
+    }
+    const QList<LookupEntry> entries = takeLookup(pTask);
+    emit networkError(
+            responseWithContent.statusCode(),
+            QStringLiteral("AcoustID"),
+            errorString,
+            errorCode);
+    for (const auto& entry : entries) {
+        trackFinished(entry.pTrack, QList<mixxx::musicbrainz::TrackRelease>());
+    }
+    startLookups();
+}
+
+void BatchTagFetcher::startNextMusicBrainzTask() {
+    if (m_pMusicBrainzTask || m_musicBrainzQueue.isEmpty()) {
+        return;
+    }
+    RecordingsEntry entry = m_musicBrainzQueue.takeFirst();
+    m_pMusicBrainzTrack = std::move(entry.pTrack);
+    m_pMusicBrainzTask = make_parented<mixxx::MusicBrainzRecordingsTask>(
+            m_pNetworkAccessManager,
+            std::move(entry.recordingIds),
+            this);
+    m_pMusicBrainzTask->setPriority(mixxx::network::RequestPriority::Bulk);
+    connect(m_pMusicBrainzTask,
+            &mixxx::MusicBrainzRecordingsTask::succeeded,
+            this,
+            &BatchTagFetcher::slotMusicBrainzTaskSucceeded);
+    connect(m_pMusicBrainzTask,
+            &mixxx::MusicBrainzRecordingsTask::failed,
+            this,
+            &BatchTagFetcher::slotMusicBrainzTaskFailed);
+    connect(m_pMusicBrainzTask,
+            &mixxx::MusicBrainzRecordingsTask::networkError,
+            this,
+            &BatchTagFetcher::slotMusicBrainzTaskNetworkError);
+    m_pMusicBrainzTask->invokeStart(
+            kMusicBrainzTimeoutMillis);
+}
+
+void BatchTagFetcher::musicBrainzTaskFinished(
+        const QList<mixxx::musicbrainz::TrackRelease>& guessedTrackReleases) {
+    m_pMusicBrainzTask->disconnect(this);
+    m_pMusicBrainzTask->deleteLater();
+    m_pMusicBrainzTask = nullptr;
+    trackFinished(std::move(m_pMusicBrainzTrack), guessedTrackReleases);
+    startNextMusicBrainzTask();
+}
+
+void BatchTagFetcher::slotMusicBrainzTaskSucceeded(
+        const QList<mixxx::musicbrainz::TrackRelease>& guessedTrackReleases) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    if (m_pMusicBrainzTask.get() != sender()) {
+        // stray call from an already aborted try
+        return;
+    }
+    musicBrainzTaskFinished(guessedTrackReleases);
+}
+
+void BatchTagFetcher::slotMusicBrainzTaskFailed(
+        const mixxx::network::WebResponse& response,
+        int errorCode,
+        const QString& errorMessage) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    if (m_pMusicBrainzTask.get() != sender()) {
+        // stray call from an already aborted try
+        return;
+    }
+    emit networkError(
+            response.statusCode(),
+            QStringLiteral("MusicBrainz"),
+            errorMessage,
+            errorCode);
+    musicBrainzTaskFinished(QList<mixxx::musicbrainz::TrackRelease>());
+}
+
+void BatchTagFetcher::slotMusicBrainzTaskNetworkError(
+        QNetworkReply::NetworkError errorCode,
+        const QString& errorString,
+        const mixxx::network::WebResponseWithContent& responseWithContent) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    if (m_pMusicBrainzTask.get() != sender()) {
+        // stray call from an already aborted try
+        return;
+    }
+    emit networkError(
+            responseWithContent.statusCode(),
+            QStringLiteral("MusicBrainz"),
+            errorString,
+            errorCode);
+    musicBrainzTaskFinished(QList<mixxx::musicbrainz::TrackRelease>());
+}
+
+void BatchTagFetcher::trackFinished(
+        TrackPointer pTrack,
+        const QList<mixxx::musicbrainz::TrackRelease>& guessedTrackReleases) {
+    ++m_finishedTracks;
+    emit resultAvailable(std::move(pTrack), guessedTrackReleases);
+    emit fetchProgress(m_finishedTracks, m_totalTracks);
+    if (m_finishedTracks == m_totalTracks) {
+        kLogger.info()
+                << "Finished fetching the tags of"
+                << m_totalTracks
+                << "tracks in"
+                << m_fetchTimer.elapsed().debugMillisWithUnit();
+        emit finished();
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+#include <QUuid>
+#include <memory>
+
+#include "library/dao/analysisdao.h"
+#include "musicbrainz/web/acoustidbatchlookuptask.h"
+#include "musicbrainz/web/musicbrainzrecordingstask.h"
+#include "preferences/usersettings.h"
+#include "track/track_decl.h"
+#include "util/parented_ptr.h"
+#include "util/performancetimer.h"
+
+class CachingReaderPcmCache;
+
+class BatchTagFetcher : public QObject {
+    Q_OBJECT
+
+    // Implements the same stages as the TagFetcher for many tracks at once:
+    //   1. Chromaprint -> AcoustID fingerprints
+    //      The fingerprints are calculated in parallel, reading the decoded
+    //      samples from the PCM cache if available. They are stored in the
+    //      database and reused until the file is modified.
+    //   2. AcoustID -> MusicBrainz recording UUIDs
+    //      The fingerprints are looked up in batches. A few batches may be
+    //      pending at the same time, but they are started no more often than
+    //      the rate limit of AcoustID allows. Batches that are rejected by
+    //      the rate limit are retried later with a slower rate.
+    //   3. MusicBrainz -> MusicBrainz track releases
+    //      The recordings are fetched one track after another. Interactive
+    //      requests of the TagFetcher are preferred by the NetworkScheduler.
+
+  public:
+    BatchTagFetcher(
+            UserSettingsPointer pConfig,
+            AnalysisDao* pAnalysisDao,
+            QObject* parent = nullptr);
+    ~BatchTagFetcher() override;
+
+    void startFetch(
+            const QList<TrackPointer>& tracks);
+
+    // Changes whenever the file of a track is modified
+    static QString fileSignature(
+            const TrackPointer& pTrack);
+
+  public slots:
+    void cancel();
+
+  signals:
+    // Emitted once for each track, with no releases if the track
+    // could not be identified
+    void resultAvailable(
+            TrackPointer pTrack,
+            const QList<mixxx::musicbrainz::TrackRelease>& guessedTrackReleases);
+    void fetchProgress(
+            int finishedTracks,
+            int totalTracks);
+    void finished();
+    void networkError(
+            int httpStatus,
+            const QString& app,
+            const QString& message,
+            int code);
+
+  private slots:
+    void slotAcoustIdTaskSucceeded(
+            const QList<QList<QUuid>>& recordingIds);
+    void slotAcoustIdTaskFailed(
+            const mixxx::network::JsonWebResponse& response);
+    void slotAcoustIdTaskNetworkError(
+            QNetworkReply::NetworkError errorCode,
+            const QString& errorString,
+            const mixxx::network::WebResponseWithContent& responseWithContent);
+
+    void slotMusicBrainzTaskSucceeded(
+            const QList<mixxx::musicbrainz::TrackRelease>& guessedTrackReleases);
+    void slotMusicBrainzTaskFailed(
+            const mixxx::network::WebResponse& response,
+            int errorCode,
+            const QString& errorMessage);
+    void slotMusicBrainzTaskNetworkError(
+            QNetworkReply::NetworkError errorCode,
+            const QString& errorString,
+            const mixxx::network::WebResponseWithContent& responseWithContent);
+
+  private:
+    struct LookupEntry {
+        TrackPointer pTrack;
+        AnalysisDao::ChromaprintInfo chromaprint;
+    };
+    struct RecordingsEntry {
+        TrackPointer pTrack;
+        QList<QUuid> recordingIds;
+    };
+
+    void fingerprintReady(
+            int fetchId,
+            const TrackPointer& pTrack,
+            const AnalysisDao::ChromaprintInfo& chromaprint);
+
+    void startLookups();
+    // Returns false if the batch is not retried
+    bool retryLookup(
+            mixxx::AcoustIdBatchLookupTask* pTask,
+            mixxx::network::HttpStatusCode statusCode);
+    QList<LookupEntry> takeLookup(
+            mixxx::AcoustIdBatchLookupTask* pTask);
+
+    void startNextMusicBrainzTask();
+    void musicBrainzTaskFinished(
+            const QList<mixxx::musicbrainz::TrackRelease>& guessedTrackReleases);
+
+    void trackFinished(
+            TrackPointer pTrack,
+            const QList<mixxx::musicbrainz::TrackRelease>& guessedTrackReleases);
+
+    AnalysisDao* const m_pAnalysisDao;
+    const std::shared_ptr<CachingReaderPcmCache> m_pPcmCache;
+
+    // Shared with all other web tasks, see NetworkScheduler
+    QNetworkAccessManager* const m_pNetworkAccessManager;
+
+    QThreadPool m_fingerprintThreadPool;
+
+    // Results of fingerprints that have been calculated for a
+    // previous fetch are discarded
+    int m_fetchId;
+
+    int m_totalTracks;
+    int m_finishedTracks;
+    int m_pendingFingerprints;
+
+    QList<LookupEntry> m_lookupQueue;
+    QHash<mixxx::AcoustIdBatchLookupTask*, QList<LookupEntry>> m_pendingLookups;
+    PerformanceTimer m_fetchTimer;
+    qint64 m_nextLookupAtMillis;
+    int m_lookupIntervalMillis;
+    int m_lookupRetries;
+
+    QList<RecordingsEntry> m_musicBrainzQueue;
+    parented_ptr<mixxx::MusicBrainzRecordingsTask> m_pMusicBrainzTask;
+    TrackPointer m_pMusicBrainzTrack;
+};
@@ -5,6 +5,7 @@
 #include <QtDebug>
 #include <vector>
 
+#include "engine/cachingreader/cachingreaderpcmcache.h"
 #include "moc_chromaprinter.cpp"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
@@ -111,11 +112,19 @@ ChromaPrinter::ChromaPrinter(QObject* parent)
              : QObject(parent) {
 }
 
-QString ChromaPrinter::getFingerprint(TrackPointer pTrack) {
-    mixxx::AudioSource::OpenParams config;
+QString ChromaPrinter::getFingerprint(TrackPointer pTrack,
+        CachingReaderPcmCache* pPcmCache) {
     // always stereo / 2 channels (see below)
-    config.setChannelCount(mixxx::audio::ChannelCount(2));
-    auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    const auto channelCount = mixxx::audio::ChannelCount(2);
+    mixxx::AudioSourcePointer pAudioSource;
+    if (pPcmCache) {
+        pAudioSource = pPcmCache->openAudioSource(pTrack, channelCount);
+    }
+    if (!pAudioSource) {
+        mixxx::AudioSource::OpenParams config;
+        config.setChannelCount(channelCount);
+        pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    }
     if (!pAudioSource) {
         qDebug()
                 << "Failed to open file for fingerprinting"
@@ -4,10 +4,14 @@
 
 #include "track/track_decl.h"
 
+class CachingReaderPcmCache;
+
 class ChromaPrinter: public QObject {
   Q_OBJECT
 
 public:
       explicit ChromaPrinter(QObject* parent = NULL);
-      QString getFingerprint(TrackPointer pTrack);
+      // Reads the decoded samples from the PCM cache if available
+      QString getFingerprint(TrackPointer pTrack,
+              CachingReaderPcmCache* pPcmCache = nullptr);
 };
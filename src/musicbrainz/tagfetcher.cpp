@@ -5,6 +5,7 @@
 
 #include "moc_tagfetcher.cpp"
 #include "musicbrainz/chromaprinter.h"
+#include "network/networkscheduler.h"
 #include "track/track.h"
 #include "util/thread_affinity.h"
 
@@ -26,6 +27,7 @@ constexpr int kCoverArtArchiveImageTimeoutMilis = 60000; // msec
 
 TagFetcher::TagFetcher(QObject* parent)
         : QObject(parent),
+          m_pNetworkAccessManager(mixxx::network::NetworkScheduler::instance()),
           m_fingerprintWatcher(this) {
 }
 
@@ -123,7 +125,7 @@ void TagFetcher::slotFingerprintReady() {
     emit fetchProgress(tr("Identifying track through Acoustid"));
     DEBUG_ASSERT(!m_pAcoustIdTask);
     m_pAcoustIdTask = make_parented<mixxx::AcoustIdLookupTask>(
-            &m_network,
+            m_pNetworkAccessManager,
             fingerprint,
             m_pTrack->getDurationSecondsInt(),
             this);
@@ -174,7 +176,7 @@ void TagFetcher::slotAcoustIdTaskSucceeded(
 
     DEBUG_ASSERT(!m_pMusicBrainzTask);
     m_pMusicBrainzTask = make_parented<mixxx::MusicBrainzRecordingsTask>(
-            &m_network,
+            m_pNetworkAccessManager,
             std::move(recordingIds),
             this);
     connect(m_pMusicBrainzTask,
@@ -312,7 +314,7 @@ void TagFetcher::startFetchCoverArtLinks(
     terminate();
 
     m_pCoverArtArchiveLinksTask = make_parented<mixxx::CoverArtArchiveLinksTask>(
-            &m_network,
+            m_pNetworkAccessManager,
             std::move(albumReleaseId),
             this);
 
@@ -400,7 +402,7 @@ void TagFetcher::slotCoverArtArchiveLinksTaskSucceeded(const QUuid& albumRelease
 void TagFetcher::startFetchCoverArtImage(const QUuid& albumReleaseId,
         const QString& coverArtUrl) {
     m_pCoverArtArchiveImageTask = make_parented<mixxx::CoverArtArchiveImageTask>(
-            &m_network,
+            m_pNetworkAccessManager,
             coverArtUrl,
             albumReleaseId,
             this);
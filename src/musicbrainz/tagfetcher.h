@@ -114,7 +114,7 @@ class TagFetcher : public QObject {
   private:
     void terminate();
 
-    QNetworkAccessManager m_network;
+    QNetworkAccessManager* const m_pNetworkAccessManager;
 
     QFutureWatcher<QString> m_fingerprintWatcher;
 
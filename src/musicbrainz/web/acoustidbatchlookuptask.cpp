@@ -0,0 +1,197 @@
+#include "musicbrainz/web/acoustidbatchlookuptask.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "moc_acoustidbatchlookuptask.cpp"
+#include "musicbrainz/gzip.h"
+#include "musicbrainz/web/acoustidlookuptask.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("AcoustIdBatchLookupTask");
+
+// The same API key as for AcoustIdLookupTask
+const QString kClientApiKey = QStringLiteral("czKxnkyO");
+
+const QUrl kBaseUrl = QStringLiteral("https://api.acoustid.org/");
+
+const QString kRequestPath = QStringLiteral("/v2/lookup");
+
+const QLatin1String kContentTypeHeaderValue("application/x-www-form-urlencoded");
+
+const QByteArray kContentEncodingRawHeaderKey = "Content-Encoding";
+const QByteArray kContentEncodingRawHeaderValue = "gzip";
+
+QUrlQuery lookupUrlQuery(
+        const QList<AcoustIdBatchLookupTask::Fingerprint>& fingerprints) {
+    DEBUG_ASSERT(!fingerprints.isEmpty());
+    DEBUG_ASSERT(fingerprints.size() <= AcoustIdBatchLookupTask::kMaxFingerprints);
+
+    QUrlQuery urlQuery;
+    urlQuery.addQueryItem(
+            QStringLiteral("format"),
+            QStringLiteral("json"));
+    urlQuery.addQueryItem(
+            QStringLiteral("client"),
+            kClientApiKey);
+    urlQuery.addQueryItem(
+            QStringLiteral("meta"),
+            QStringLiteral("recordingids"));
+    // Multiple fingerprints are distinguished by their index
+    for (int i = 0; i < fingerprints.size(); ++i) {
+        DEBUG_ASSERT(!fingerprints[i].fingerprint.isEmpty());
+        DEBUG_ASSERT(fingerprints[i].duration >= 0);
+        urlQuery.addQueryItem(
+                QStringLiteral("fingerprint.%1").arg(i),
+                fingerprints[i].fingerprint);
+        urlQuery.addQueryItem(
+                QStringLiteral("duration.%1").arg(i),
+                QString::number(fingerprints[i].duration));
+    }
+    return urlQuery;
+}
+
+network::JsonWebRequest lookupRequest() {
+    return network::JsonWebRequest{
+            network::HttpRequestMethod::Post,
+            kRequestPath,
+            QUrlQuery(),     // custom query
+            QJsonDocument(), // custom body
+    };
+}
+
+} // anonymous namespace
+
+AcoustIdBatchLookupTask::AcoustIdBatchLookupTask(
+        QNetworkAccessManager* networkAccessManager,
+        const QList<Fingerprint>& fingerprints,
+        QObject* parent)
+        : network::JsonWebTask(
+                  networkAccessManager,
+                  kBaseUrl,
+                  lookupRequest(),
+                  parent),
+          m_fingerprintCount(fingerprints.size()),
+          m_urlQuery(lookupUrlQuery(fingerprints)) {
+}
+
+QNetworkReply* AcoustIdBatchLookupTask::sendNetworkRequest(
+        QNetworkAccessManager* networkAccessManager,
+        network::HttpRequestMethod method,
+        const QUrl& url,
+        const QJsonDocument& content) {
+    Q_UNUSED(method);
+    DEBUG_ASSERT(method == network::HttpRequestMethod::Post);
+    Q_UNUSED(content);
+    DEBUG_ASSERT(content.isEmpty());
+
+    DEBUG_ASSERT(url.isValid());
+    QNetworkRequest req(url);
+    req.setHeader(
+            QNetworkRequest::ContentTypeHeader,
+            kContentTypeHeaderValue);
+    req.setRawHeader(
+            kContentEncodingRawHeaderKey,
+            kContentEncodingRawHeaderValue);
+    // Multiple batches might be pending at the same time. They are sent
+    // on the same kept-alive connection instead of opening a new one
+    // for each batch.
+    req.setAttribute(
+            QNetworkRequest::HttpPipeliningAllowedAttribute,
+            true);
+
+    // application/x-www-form-urlencoded request bodies must be percent encoded.
+    DEBUG_ASSERT(!m_urlQuery.isEmpty());
+    QByteArray body = gzipCompress(
+            m_urlQuery.query(QUrl::FullyEncoded).toLatin1());
+
+    if (kLogger.traceEnabled()) {
+        kLogger.trace()
+                << "POST"
+                << url
+                << body;
+    }
+    DEBUG_ASSERT(networkAccessManager);
+    return networkAccessManager->post(req, body);
+}
+
+void AcoustIdBatchLookupTask::onFinished(
+        const network::JsonWebResponse& response) {
+    if (!response.isStatusCodeSuccess()) {
+        kLogger.warning()
+                << "Request failed with HTTP status code"
+                << response.statusCode();
+        emitFailed(response);
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(response.statusCode() == network::kHttpStatusCodeOk) {
+        kLogger.warning()
+                << "Unexpected HTTP status code"
+                << response.statusCode();
+        emitFailed(response);
+        return;
+    }
+
+    VERIFY_OR_DEBUG_ASSERT(response.content().isObject()) {
+        kLogger.warning()
+                << "Invalid JSON content"
+                << response.content();
+        emitFailed(response);
+        return;
+    }
+    const auto jsonObject = response.content().object();
+
+    const auto statusText = jsonObject.value(QStringLiteral("status")).toString();
+    if (statusText != QStringLiteral("ok")) {
+        kLogger.warning()
+                << "Unexpected response status"
+                << statusText;
+        emitFailed(response);
+        return;
+    }
+
+    // The results of each fingerprint are returned together with its
+    // index, which is not necessarily in the order of the request.
+    QList<QList<QUuid>> recordingIds;
+    recordingIds.reserve(m_fingerprintCount);
+    for (int i = 0; i < m_fingerprintCount; ++i) {
+        recordingIds.append(QList<QUuid>());
+    }
+    DEBUG_ASSERT(jsonObject.value(QLatin1String("fingerprints")).isArray());
+    const QJsonArray fingerprints =
+            jsonObject.value(QLatin1String("fingerprints")).toArray();
+    for (const auto& fingerprint : fingerprints) {
+        DEBUG_ASSERT(fingerprint.isObject());
+        const auto fingerprintObject = fingerprint.toObject();
+        // The index is sent as a string
+        bool ok = false;
+        const int index = fingerprintObject.value(QLatin1String("index"))
+                                  .toVariant()
+                                  .toInt(&ok);
+        VERIFY_OR_DEBUG_ASSERT(ok && index >= 0 && index < m_fingerprintCount) {
+            continue;
+        }
+        recordingIds[index] = AcoustIdLookupTask::recordingIdsOfResults(
+                fingerprintObject.value(QLatin1String("results")).toArray());
+    }
+    emitSucceeded(recordingIds);
+}
+
+void AcoustIdBatchLookupTask::emitSucceeded(
+        const QList<QList<QUuid>>& recordingIds) {
+    VERIFY_OR_DEBUG_ASSERT(
+            isSignalFuncConnected(&AcoustIdBatchLookupTask::succeeded)) {
+        kLogger.warning()
+                << "Unhandled succeeded signal";
+        deleteLater();
+        return;
+    }
+    emit succeeded(recordingIds);
+}
+
+} // namespace mixxx
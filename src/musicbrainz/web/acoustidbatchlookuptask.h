@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QUrlQuery>
+#include <QUuid>
+
+#include "network/jsonwebtask.h"
+
+namespace mixxx {
+
+/// Looks up the fingerprints of multiple tracks with a single AcoustID
+/// request, which is much faster than one request per track with respect
+/// to the rate limit of the AcoustID web service.
+class AcoustIdBatchLookupTask : public network::JsonWebTask {
+    Q_OBJECT
+
+  public:
+    struct Fingerprint {
+        QString fingerprint;
+        int duration;
+    };
+
+    /// The maximum number of fingerprints per request
+    static constexpr int kMaxFingerprints = 20;
+
+    AcoustIdBatchLookupTask(
+            QNetworkAccessManager* networkAccessManager,
+            const QList<Fingerprint>& fingerprints,
+            QObject* parent = nullptr);
+    ~AcoustIdBatchLookupTask() override = default;
+
+  signals:
+    /// The recording ids in the same order as the fingerprints
+    void succeeded(
+            const QList<QList<QUuid>>& recordingIds);
+
+  protected:
+    QNetworkReply* sendNetworkRequest(
+            QNetworkAccessManager* networkAccessManager,
+            network::HttpRequestMethod method,
+            const QUrl& url,
+            const QJsonDocument& content) override;
+
+  private:
+    void onFinished(
+            const network::JsonWebResponse& response) override;
+
+    void emitSucceeded(
+            const QList<QList<QUuid>>& recordingIds);
+
+    const int m_fingerprintCount;
+    const QUrlQuery m_urlQuery;
+};
+
+} // namespace mixxx
@@ -147,9 +147,15 @@ void AcoustIdLookupTask::onFinished(
         return;
     }
 
-    QList<QUuid> recordingIds;
     DEBUG_ASSERT(jsonObject.value(QLatin1String("results")).isArray());
-    const QJsonArray results = jsonObject.value(QLatin1String("results")).toArray();
+    emitSucceeded(recordingIdsOfResults(
+            jsonObject.value(QLatin1String("results")).toArray()));
+}
+
+// static
+QList<QUuid> AcoustIdLookupTask::recordingIdsOfResults(
+        const QJsonArray& results) {
+    QList<QUuid> recordingIds;
     double maxScore = -1.0; // uninitialized (< 0)
     // Results are expected to be ordered by score (descending)
     for (const auto& result : results) {
@@ -207,7 +213,7 @@ void AcoustIdLookupTask::onFinished(
             }
         }
     }
-    emitSucceeded(recordingIds);
+    return recordingIds;
 }
 
 void AcoustIdLookupTask::emitSucceeded(
@@ -5,6 +5,7 @@
 
 #include "network/jsonwebtask.h"
 
+class QJsonArray;
 class QUuid;
 
 namespace mixxx {
@@ -20,6 +21,10 @@ class AcoustIdLookupTask : public network::JsonWebTask {
             QObject* parent = nullptr);
     ~AcoustIdLookupTask() override = default;
 
+    // Returns the recording ids of the results with the highest score
+    static QList<QUuid> recordingIdsOfResults(
+            const QJsonArray& results);
+
   signals:
     void succeeded(
             const QList<QUuid>& recordingIds);
@@ -79,6 +79,10 @@ MusicBrainzRecordingsTask::MusicBrainzRecordingsTask(
     musicbrainz::registerMetaTypesOnce();
 }
 
+QString MusicBrainzRecordingsTask::requestHost() const {
+    return kBaseUrl.host();
+}
+
 QNetworkReply* MusicBrainzRecordingsTask::doStartNetworkRequest(
         QNetworkAccessManager* networkAccessManager,
         int parentTimeoutMillis) {
@@ -35,6 +35,7 @@ class MusicBrainzRecordingsTask : public network::WebTask {
     void onNetworkError(
             QNetworkReply* finishedNetworkReply,
             network::HttpStatusCode statusCode) override;
+    QString requestHost() const override;
 
   private:
     QNetworkReply* doStartNetworkRequest(
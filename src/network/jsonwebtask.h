@@ -91,6 +91,10 @@ class JsonWebTask : public WebTask {
     void emitFailed(
             const network::JsonWebResponse& response);
 
+    QString requestHost() const override {
+        return m_baseUrl.host();
+    }
+
   private:
     /// Handle the response and ensure that the task eventually
     /// gets deleted.
@@ -0,0 +1,148 @@
+#include "network/networkscheduler.h"
+
+#include <QNetworkDiskCache>
+#include <QTimer>
+#include <algorithm>
+
+#include "moc_networkscheduler.cpp"
+#include "network/webtask.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/thread_affinity.h"
+
+namespace mixxx {
+
+namespace network {
+
+namespace {
+
+const Logger kLogger("mixxx::network::NetworkScheduler");
+
+const QString kCacheSubdirectory = QStringLiteral("/cache/network");
+
+constexpr qint64 kMaxCacheSizeBytes = 50 * 1024 * 1024;
+
+// https://musicbrainz.org/doc/MusicBrainz_API/Rate_Limiting
+constexpr int kMusicBrainzMinIntervalMillis = 1000;
+
+// https://acoustid.org/webservice
+constexpr int kAcoustIdMinIntervalMillis = 334;
+
+} // anonymous namespace
+
+NetworkScheduler::NetworkScheduler(UserSettingsPointer pConfig) {
+    auto* const pCache = new QNetworkDiskCache(this);
+    pCache->setCacheDirectory(pConfig->getSettingsPath() + kCacheSubdirectory);
+    pCache->setMaximumCacheSize(kMaxCacheSizeBytes);
+    setCache(pCache);
+
+    setMinRequestInterval(
+            QStringLiteral("musicbrainz.org"),
+            kMusicBrainzMinIntervalMillis);
+    setMinRequestInterval(
+            QStringLiteral("api.acoustid.org"),
+            kAcoustIdMinIntervalMillis);
+
+    m_clock.start();
+}
+
+void NetworkScheduler::setMinRequestInterval(
+        const QString& host,
+        int intervalMillis) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    DEBUG_ASSERT(intervalMillis >= 0);
+    m_hosts[host].minIntervalMillis = intervalMillis;
+}
+
+int NetworkScheduler::minRequestInterval(
+        const QString& host) const {
+    return m_hosts.value(host).minIntervalMillis;
+}
+
+QNetworkReply* NetworkScheduler::createRequest(
+        Operation op,
+        const QNetworkRequest& originalReq,
+        QIODevice* outgoingData) {
+    QNetworkRequest req = originalReq;
+    // Multiplex all requests to the same host over a single connection
+    // if the server supports it. Enabled by default since Qt 6.
+    req.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    return QNetworkAccessManager::createRequest(op, req, outgoingData);
+}
+
+bool NetworkScheduler::enqueue(
+        WebTask* pTask,
+        const QString& host,
+        RequestPriority priority) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    DEBUG_ASSERT(pTask);
+    const auto it = m_hosts.find(host);
+    if (it == m_hosts.end() || it->minIntervalMillis <= 0) {
+        return false;
+    }
+    Host& hostState = it.value();
+
+    // Interactive tasks are queued before all bulk tasks, otherwise
+    // the order is preserved
+    int index = hostState.queue.size();
+    if (priority == RequestPriority::Interactive) {
+        index = 0;
+        while (index < hostState.queue.size() &&
+                hostState.queue[index] &&
+                hostState.queue[index]->m_priority == RequestPriority::Interactive) {
+            ++index;
+        }
+    }
+    hostState.queue.insert(index, pTask);
+
+    if (!hostState.pTimer) {
+        hostState.pTimer = new QTimer(this);
+        hostState.pTimer->setSingleShot(true);
+        connect(hostState.pTimer,
+                &QTimer::timeout,
+                this,
+                [this, host] {
+                    startNext(host);
+                });
+    }
+    if (!hostState.pTimer->isActive()) {
+        const qint64 nextStartMillis = hostState.lastStartedMillis < 0
+                ? 0
+                : hostState.lastStartedMillis + hostState.minIntervalMillis;
+        hostState.pTimer->start(static_cast<int>(
+                std::max<qint64>(0, nextStartMillis - m_clock.elapsed())));
+    }
+    return true;
+}
+
+void NetworkScheduler::startNext(const QString& host) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    Host& hostState = m_hosts[host];
+    while (!hostState.queue.isEmpty()) {
+        const QPointer<WebTask> pTask = hostState.queue.takeFirst();
+        // Skip tasks that have been deleted or aborted while waiting
+        if (!pTask || !pTask->m_waitingForScheduler) {
+            continue;
+        }
+        hostState.lastStartedMillis = m_clock.elapsed();
+        if (kLogger.debugEnabled()) {
+            kLogger.debug()
+                    << "Starting request to"
+                    << host
+                    << "with"
+                    << hostState.queue.size()
+                    << "requests waiting";
+        }
+        pTask->startScheduled();
+        // The task might have started other tasks synchronously
+        const Host& nextHostState = m_hosts[host];
+        if (!nextHostState.queue.isEmpty() && !nextHostState.pTimer->isActive()) {
+            nextHostState.pTimer->start(nextHostState.minIntervalMillis);
+        }
+        return;
+    }
+}
+
+} // namespace network
+
+} // namespace mixxx
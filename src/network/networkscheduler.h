@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QPointer>
+#include <QString>
+
+#include "preferences/usersettings.h"
+#include "util/singleton.h"
+
+class QTimer;
+
+namespace mixxx {
+
+namespace network {
+
+class WebTask;
+
+enum class RequestPriority {
+    /// Requests that a user is waiting for, e.g. in the tag fetcher dialog
+    Interactive,
+    /// Requests of long running batch jobs
+    Bulk,
+};
+
+/// The network access manager that is shared by all web tasks of the
+/// application.
+///
+/// Sharing a single manager allows to reuse the connections to each host,
+/// which are kept alive and pooled by Qt. Requests may use HTTP/2, which
+/// multiplexes all requests to a host over a single connection.
+///
+/// Responses are cached on disk and reused according to their HTTP cache
+/// headers, e.g. when fetching the same MusicBrainz recordings or cover
+/// art again.
+///
+/// Web services like MusicBrainz and AcoustID only accept a limited number
+/// of requests per second. Web tasks for these hosts are queued and started
+/// one after another in the order of their priority, so that bulk requests
+/// do not exceed the rate limit and do not delay interactive requests.
+class NetworkScheduler : public QNetworkAccessManager, public Singleton<NetworkScheduler> {
+    Q_OBJECT
+
+  public:
+    /// The minimum interval between two requests to the host.
+    /// 0 disables the rate limit.
+    void setMinRequestInterval(
+            const QString& host,
+            int intervalMillis);
+    int minRequestInterval(
+            const QString& host) const;
+
+  protected:
+    QNetworkReply* createRequest(
+            Operation op,
+            const QNetworkRequest& originalReq,
+            QIODevice* outgoingData) override;
+
+  private:
+    friend class Singleton<NetworkScheduler>;
+    friend class WebTask;
+
+    explicit NetworkScheduler(UserSettingsPointer pConfig);
+    ~NetworkScheduler() override = default;
+
+    struct Host {
+        int minIntervalMillis = 0;
+        // Not valid until the first request has been started
+        qint64 lastStartedMillis = -1;
+        QList<QPointer<WebTask>> queue;
+        QTimer* pTimer = nullptr;
+    };
+
+    /// Returns false if requests to the host are not rate limited
+    /// and the task could be started immediately.
+    bool enqueue(
+            WebTask* pTask,
+            const QString& host,
+            RequestPriority priority);
+
+    void startNext(const QString& host);
+
+    QElapsedTimer m_clock;
+    QHash<QString, Host> m_hosts;
+};
+
+} // namespace network
+
+} // namespace mixxx
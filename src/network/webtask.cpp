@@ -115,7 +115,10 @@ WebTask::WebTask(
         : NetworkTask(networkAccessManager, parent),
           m_state(State::Initial),
           m_timeoutTimerId(kInvalidTimerId),
-          m_timeoutMillis(kNoTimeout) {
+          m_timeoutMillis(kNoTimeout),
+          m_priority(RequestPriority::Interactive),
+          m_waitingForScheduler(false),
+          m_scheduled(false) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
 }
 
@@ -205,6 +208,22 @@ void WebTask::slotStart(int timeoutMillis, int delayMillis) {
     }
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(pNetworkAccessManager);
 
+    if (m_scheduled) {
+        m_scheduled = false;
+    } else {
+        auto* const pScheduler = qobject_cast<NetworkScheduler*>(pNetworkAccessManager);
+        if (pScheduler && pScheduler->enqueue(this, requestHost(), m_priority)) {
+            m_state = State::Starting;
+            kLogger.debug()
+                    << this
+                    << "Waiting for the network scheduler";
+            // Store timeout for later
+            m_timeoutMillis = timeoutMillis;
+            m_waitingForScheduler = true;
+            return;
+        }
+    }
+
     kLogger.debug()
             << this
             << "Starting...";
@@ -261,6 +280,7 @@ void WebTask::slotAbort() {
     kLogger.debug()
             << this
             << "Aborting...";
+    m_waitingForScheduler = false;
 
     if (m_timeoutTimerId != kInvalidTimerId) {
         killTimer(m_timeoutTimerId);
@@ -304,6 +324,16 @@ void WebTask::slotAbort() {
     emitAborted(requestUrl);
 }
 
+void WebTask::startScheduled() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    DEBUG_ASSERT(m_state == State::Starting);
+    DEBUG_ASSERT(m_waitingForScheduler);
+    m_waitingForScheduler = false;
+    m_scheduled = true;
+    m_state = State::Initial;
+    slotStart(m_timeoutMillis);
+}
+
 void WebTask::timerEvent(QTimerEvent* event) {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
     const auto timerId = event->timerId();
@@ -5,6 +5,7 @@
 #include <QUrl>
 
 #include "network/httpstatuscode.h"
+#include "network/networkscheduler.h"
 #include "network/networktask.h"
 #include "util/optional.h"
 #include "util/performancetimer.h"
@@ -132,6 +133,13 @@ class WebTask : public NetworkTask {
                 state() == State::Pending;
     }
 
+    /// Requests to rate limited hosts are started in the order of their
+    /// priority when using the NetworkScheduler. The default priority is
+    /// RequestPriority::Interactive.
+    void setPriority(RequestPriority priority) {
+        m_priority = priority;
+    }
+
   signals:
     /// Network or server-side abort/timeout/failure
     void networkError(
@@ -187,7 +195,17 @@ class WebTask : public NetworkTask {
             QNetworkReply* pFinishedNetworkReply,
             HttpStatusCode statusCode);
 
+    /// The host of the requests for rate limiting them in the
+    /// NetworkScheduler. Requests are not rate limited by default.
+    virtual QString requestHost() const {
+        return QString();
+    }
+
   private:
+    friend class NetworkScheduler;
+
+    /// Invoked by the NetworkScheduler when it is the turn of the task.
+    void startScheduled();
     QUrl abortPendingNetworkReply();
 
     /// Try to compose and send the actual network request.
@@ -225,6 +243,12 @@ class WebTask : public NetworkTask {
     int m_timeoutTimerId;
     int m_timeoutMillis;
 
+    RequestPriority m_priority;
+    // Queued by the NetworkScheduler
+    bool m_waitingForScheduler;
+    // Started by the NetworkScheduler
+    bool m_scheduled;
+
     SafeQPointer<QNetworkReply> m_pendingNetworkReplyWeakPtr;
 };
 
@@ -17,6 +17,7 @@
 #define BPM_REANALYZE_WHEN_SETTINGS_CHANGE "ReanalyzeWhenSettingsChange"
 #define BPM_REANALYZE_IMPORTED "ReanalyzeImported"
 #define BPM_FAST_ANALYSIS_ENABLED "FastAnalysisEnabled"
+#define BPM_PREVIEW_ANALYSIS_ENABLED "PreviewAnalysisEnabled"
 
 class BeatDetectionSettings {
   public:
@@ -40,6 +41,12 @@ class BeatDetectionSettings {
     DEFINE_PREFERENCE_HELPERS(FastAnalysis, bool,
                               BPM_CONFIG_KEY, BPM_FAST_ANALYSIS_ENABLED, false);
 
+    DEFINE_PREFERENCE_HELPERS(PreviewAnalysis,
+            bool,
+            BPM_CONFIG_KEY,
+            BPM_PREVIEW_ANALYSIS_ENABLED,
+            false);
+
     QString getBeatPluginId() const {
         return m_pConfig->getValue<QString>(ConfigKey(
                 VAMP_CONFIG_KEY, VAMP_ANALYZER_BEAT_PLUGIN_ID));
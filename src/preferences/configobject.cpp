@@ -8,12 +8,17 @@
 
 #include "util/cmdlineargs.h"
 #include "util/color/rgbcolor.h"
+#include "util/compatibility/qmutex.h"
+#include "util/debouncedwriter.h"
 #include "util/xml.h"
 #include "widget/wwidget.h"
 
 // TODO(rryan): Move to a utility file.
 namespace {
 const QString kTempFilenameExtension = QStringLiteral(".tmp");
+// Saves requested by saveDeferred() are delayed by this time after the last
+// request
+constexpr std::chrono::milliseconds kDeferredSaveDelay(1000);
 const QString kCMakeCacheFile = QStringLiteral("CMakeCache.txt");
 const QLatin1String kSourceDirLine = QLatin1String("mixxx_SOURCE_DIR:STATIC=");
 
@@ -155,11 +160,20 @@ ConfigObject<ValueType>::ConfigObject(
 }
 
 template <class ValueType> ConfigObject<ValueType>::~ConfigObject() {
+    if (m_pDeferredWriter) {
+        // Write a pending deferred save
+        m_pDeferredWriter->stop();
+    }
 }
 
 template <class ValueType>
 void ConfigObject<ValueType>::set(const ConfigKey& k, const ValueType& v) {
     QWriteLocker lock(&m_valuesLock);
+    // Compare the serialized values, operator== of ConfigValue ignores the case
+    const auto it = m_values.constFind(k);
+    if (it == m_values.constEnd() || it.value().value != v.value) {
+        m_dirty = true;
+    }
     m_values.insert(k, v);
 }
 
@@ -178,7 +192,11 @@ bool ConfigObject<ValueType>::exists(const ConfigKey& k) const {
 template <class ValueType>
 bool ConfigObject<ValueType>::remove(const ConfigKey& k) {
     QWriteLocker lock(&m_valuesLock);
-    return m_values.remove(k) > 0;
+    if (m_values.remove(k) == 0) {
+        return false;
+    }
+    m_dirty = true;
+    return true;
 }
 
 template <class ValueType>
@@ -234,51 +252,74 @@ template <class ValueType> void ConfigObject<ValueType>::reopen(const QString& f
     if (!m_filename.isEmpty()) {
         parse();
     }
+    // The parsed values are already in the file
+    QWriteLocker lock(&m_valuesLock);
+    m_dirty = false;
 }
 
 /// Save the ConfigObject to disk.
 /// Returns true on success
 template<class ValueType>
 bool ConfigObject<ValueType>::save() {
-    QReadLocker lock(&m_valuesLock); // we only read the m_values here.
+    return write(false);
+}
+
+template<class ValueType>
+void ConfigObject<ValueType>::saveDeferred() {
+    if (!m_pDeferredWriter) {
+        m_pDeferredWriter = std::make_unique<mixxx::DebouncedWriter>(
+                [this] {
+                    write(true);
+                },
+                kDeferredSaveDelay);
+    }
+    m_pDeferredWriter->schedule();
+}
+
+template<class ValueType>
+bool ConfigObject<ValueType>::write(bool onlyIfDirty) {
+    const auto saveLocker = lockMutex(&m_saveMutex);
+
+    // Only the serialization needs the values, the file is written
+    // without blocking set() on other threads.
+    QString content;
+    {
+        QWriteLocker lock(&m_valuesLock);
+        if (onlyIfDirty && !m_dirty) {
+            return true;
+        }
+        QTextStream stream(&content);
+        QString group = "";
+        for (auto i = m_values.constBegin(); i != m_values.constEnd(); ++i) {
+            //qDebug() << "group:" << it.key().group << "item" << it.key().item << "val" << it.value()->value;
+            if (i.key().group != group) {
+                group = i.key().group;
+                stream << "\n"
+                       << group << "\n";
+            }
+            stream << i.key().item << " " << i.value().value << "\n";
+        }
+        m_dirty = false;
+    }
+    const auto markDirty = [this] {
+        QWriteLocker lock(&m_valuesLock);
+        m_dirty = true;
+    };
+
     QFile tmpFile(m_filename + kTempFilenameExtension);
     if (!QDir(QFileInfo(tmpFile).absolutePath()).exists()) {
         QDir().mkpath(QFileInfo(tmpFile).absolutePath());
     }
     if (!tmpFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
         qWarning() << "Could not write config file: " << tmpFile.fileName();
+        markDirty();
         return false;
     }
-    QTextStream stream(&tmpFile);
-    // UTF-8 is the default in Qt6.
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    DEBUG_ASSERT(stream.encoding() == QStringConverter::Utf8);
-#else
-    stream.setCodec("UTF-8");
-#endif
-
-    QString group = "";
-
-    // Since it is legit to have a ConfigObject with 0 values, checking
-    // the stream.pos alone will yield wrong warnings. We therefore estimate
-    // a minimum length as an additional safety check.
-    qint64 minLength = 0;
-    for (auto i = m_values.constBegin(); i != m_values.constEnd(); ++i) {
-        //qDebug() << "group:" << it.key().group << "item" << it.key().item << "val" << it.value()->value;
-        if (i.key().group != group) {
-            group = i.key().group;
-            stream << "\n"
-                   << group << "\n";
-            minLength += i.key().group.length() + 2;
-        }
-        stream << i.key().item << " " << i.value().value << "\n";
-        minLength += i.key().item.length() + i.value().value.length() + 1;
-    }
 
-    stream.flush();
-    // the stream is usually longer, depending on the amount of encoded data.
-    if (stream.pos() < minLength || QFileInfo(tmpFile).size() != stream.pos()) {
+    const QByteArray data = content.toUtf8();
+    if (tmpFile.write(data) != data.size()) {
         qWarning().nospace() << "Error while writing configuration file: " << tmpFile.fileName();
+        markDirty();
         return false;
     }
 
@@ -287,6 +328,7 @@ bool ConfigObject<ValueType>::save() {
             QFile::NoError) { //could be better... should actually say what the error was..
         qWarning().nospace() << "Error while writing configuration file: "
                              << tmpFile.fileName() << ": " << tmpFile.errorString();
+        markDirty();
         return false;
     }
 
@@ -296,12 +338,14 @@ bool ConfigObject<ValueType>::save() {
         if (!oldConfig.remove()) {
             qWarning().nospace() << "Could not remove old config file: "
                                  << oldConfig.fileName() << ": " << oldConfig.errorString();
+            markDirty();
             return false;
         }
     }
     if (!tmpFile.rename(m_filename)) {
         qWarning().nospace() << "Could not rename tmp file to config file: "
                              << tmpFile.fileName() << ": " << tmpFile.errorString();
+        markDirty();
         return false;
     }
 
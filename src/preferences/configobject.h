@@ -5,14 +5,20 @@
 #include <QKeySequence>
 #include <QMap>
 #include <QMetaType>
+#include <QMutex>
 #include <QReadWriteLock>
 #include <QString>
+#include <memory>
 #include <type_traits>
 
 #include "util/assert.h"
 #include "util/compatibility/qhash.h"
 #include "util/debug.h"
 
+namespace mixxx {
+class DebouncedWriter;
+} // namespace mixxx
+
 // Class for the key for a specific configuration element. A key consists of a
 // group and an item.
 class ConfigKey final {
@@ -112,6 +118,10 @@ class ConfigValueKbd : public ConfigValue {
         reportFatalErrorAndQuit("ConfigValueKbd from QDomNode not implemented here");
     }
 
+    const QKeySequence& keys() const {
+        return m_keys;
+    }
+
     friend bool operator==(const ConfigValueKbd& lhs, const ConfigValueKbd& rhs) {
         // Both the key sequence and the value of the base class must be consistent!
         // TODO(XXX): Fix this error prone design!!
@@ -189,6 +199,13 @@ template <class ValueType> class ConfigObject {
 
     void reopen(const QString& file);
     bool save();
+    /// Saves the ConfigObject on a background thread, once there have been
+    /// no further calls for a short while. Nothing is written if no value
+    /// has changed since the last save. A pending save is written when the
+    /// ConfigObject is destroyed.
+    ///
+    /// Must always be called from the same thread.
+    void saveDeferred();
 
     static QString computeResourcePath();
 
@@ -214,10 +231,18 @@ template <class ValueType> class ConfigObject {
     QString m_filename;
     const QString m_resourcePath;
     const QString m_settingsPath;
+    // Whether a value has changed since the last save, guarded by
+    // m_valuesLock
+    bool m_dirty = false;
+
+    // Serializes saving, so an older snapshot never overwrites a newer one
+    QMutex m_saveMutex;
+    std::unique_ptr<mixxx::DebouncedWriter> m_pDeferredWriter;
 
     // Loads and parses the configuration file. Returns false if the file could
     // not be opened; otherwise true.
     bool parse();
+    bool write(bool onlyIfDirty);
 };
 
 // Specialization must be declared before the first use that would cause
@@ -58,6 +58,11 @@ void DlgPrefAutoDJ::slotUpdate() {
                     ? Qt::Checked
                     : Qt::Unchecked);
 
+    // Prepare upcoming tracks in advance
+    LookaheadTracksSpinBox->setValue(
+            m_pConfig->getValue(
+                    ConfigKey("[Auto DJ]", "LookaheadTracks"), 0));
+
     // Re-center the crossfader instantly when AutoDJ is disabled
     CenterXfaderCheckBox->setChecked(m_pConfig->getValue(
             ConfigKey("[Auto DJ]", "center_xfader_when_disabling"), false));
@@ -79,6 +84,9 @@ void DlgPrefAutoDJ::slotApply() {
             ConfigKey("[Auto DJ]", "RandomQueueMinimumAllowed"),
             RandomQueueMinimumSpinBox->value());
 
+    m_pConfig->setValue(ConfigKey("[Auto DJ]", "LookaheadTracks"),
+            LookaheadTracksSpinBox->value());
+
     m_pConfig->setValue(ConfigKey("[Auto DJ]", "center_xfader_when_disabling"),
             CenterXfaderCheckBox->isChecked());
 }
@@ -95,6 +103,8 @@ void DlgPrefAutoDJ::slotResetToDefaults() {
     RandomQueueMinimumSpinBox->setEnabled(false);
     RandomQueueMinimumSpinBox->setValue(5);
 
+    LookaheadTracksSpinBox->setValue(0);
+
     CenterXfaderCheckBox->setChecked(false);
 }
 
@@ -10,6 +10,7 @@ DlgPrefBeats::DlgPrefBeats(QWidget* parent, UserSettingsPointer pConfig)
           m_bAnalyzerEnabled(m_bpmSettings.getBpmDetectionEnabledDefault()),
           m_bFixedTempoEnabled(m_bpmSettings.getFixedTempoAssumptionDefault()),
           m_bFastAnalysisEnabled(m_bpmSettings.getFastAnalysisDefault()),
+          m_bPreviewAnalysisEnabled(m_bpmSettings.getPreviewAnalysisDefault()),
           m_bReanalyze(m_bpmSettings.getReanalyzeWhenSettingsChangeDefault()),
           m_bReanalyzeImported(m_bpmSettings.getReanalyzeImportedDefault()) {
     setupUi(this);
@@ -38,6 +39,10 @@ DlgPrefBeats::DlgPrefBeats(QWidget* parent, UserSettingsPointer pConfig)
             &QCheckBox::stateChanged,
             this,
             &DlgPrefBeats::fastAnalysisEnabled);
+    connect(checkBoxPreviewAnalysis,
+            &QCheckBox::stateChanged,
+            this,
+            &DlgPrefBeats::previewAnalysisEnabled);
     connect(checkBoxReanalyze,
             &QCheckBox::stateChanged,
             this,
@@ -64,6 +69,7 @@ void DlgPrefBeats::loadSettings() {
     m_bReanalyze =  m_bpmSettings.getReanalyzeWhenSettingsChange();
     m_bReanalyzeImported = m_bpmSettings.getReanalyzeImported();
     m_bFastAnalysisEnabled = m_bpmSettings.getFastAnalysis();
+    m_bPreviewAnalysisEnabled = m_bpmSettings.getPreviewAnalysis();
 
     slotUpdate();
 }
@@ -75,6 +81,7 @@ void DlgPrefBeats::slotResetToDefaults() {
     m_bAnalyzerEnabled = m_bpmSettings.getBpmDetectionEnabledDefault();
     m_bFixedTempoEnabled = m_bpmSettings.getFixedTempoAssumptionDefault();
     m_bFastAnalysisEnabled = m_bpmSettings.getFastAnalysisDefault();
+    m_bPreviewAnalysisEnabled = m_bpmSettings.getPreviewAnalysisDefault();
     m_bReanalyze = m_bpmSettings.getReanalyzeWhenSettingsChangeDefault();
     m_bReanalyzeImported = m_bpmSettings.getReanalyzeImportedDefault();
 
@@ -105,6 +112,7 @@ void DlgPrefBeats::slotUpdate() {
     checkBoxAnalyzerEnabled->setChecked(m_bAnalyzerEnabled);
     // Fast analysis cannot be combined with non-constant tempo beatgrids.
     checkBoxFastAnalysis->setEnabled(m_bAnalyzerEnabled && m_bFixedTempoEnabled);
+    checkBoxPreviewAnalysis->setEnabled(m_bAnalyzerEnabled);
     checkBoxReanalyze->setEnabled(m_bAnalyzerEnabled);
     checkBoxReanalyzeImported->setEnabled(m_bAnalyzerEnabled);
 
@@ -134,6 +142,7 @@ void DlgPrefBeats::slotUpdate() {
     checkBoxFixedTempo->setChecked(m_bFixedTempoEnabled);
     // Fast analysis cannot be combined with non-constant tempo beatgrids.
     checkBoxFastAnalysis->setChecked(m_bFastAnalysisEnabled && m_bFixedTempoEnabled);
+    checkBoxPreviewAnalysis->setChecked(m_bPreviewAnalysisEnabled);
 
     checkBoxReanalyze->setChecked(m_bReanalyze);
     checkBoxReanalyzeImported->setChecked(m_bReanalyzeImported);
@@ -154,6 +163,11 @@ void DlgPrefBeats::fastAnalysisEnabled(int i) {
     slotUpdate();
 }
 
+void DlgPrefBeats::previewAnalysisEnabled(int i) {
+    m_bPreviewAnalysisEnabled = static_cast<bool>(i);
+    slotUpdate();
+}
+
 void DlgPrefBeats::slotApply() {
     m_bpmSettings.setBeatPluginId(m_selectedAnalyzerId);
     m_bpmSettings.setBpmDetectionEnabled(m_bAnalyzerEnabled);
@@ -161,4 +175,5 @@ void DlgPrefBeats::slotApply() {
     m_bpmSettings.setReanalyzeWhenSettingsChange(m_bReanalyze);
     m_bpmSettings.setReanalyzeImported(m_bReanalyzeImported);
     m_bpmSettings.setFastAnalysis(m_bFastAnalysisEnabled);
+    m_bpmSettings.setPreviewAnalysis(m_bPreviewAnalysisEnabled);
 }
@@ -30,6 +30,7 @@ class DlgPrefBeats : public DlgPreferencePage, public Ui::DlgBeatsDlg {
     void analyzerEnabled(int i);
     void fixedtempoEnabled(int i);
     void fastAnalysisEnabled(int i);
+    void previewAnalysisEnabled(int i);
     void slotReanalyzeChanged(int value);
     void slotReanalyzeImportedChanged(int value);
 
@@ -42,6 +43,7 @@ class DlgPrefBeats : public DlgPreferencePage, public Ui::DlgBeatsDlg {
     bool m_bAnalyzerEnabled;
     bool m_bFixedTempoEnabled;
     bool m_bFastAnalysisEnabled;
+    bool m_bPreviewAnalysisEnabled;
     bool m_bReanalyze;
     bool m_bReanalyzeImported;
 };
@@ -586,8 +586,7 @@ void DlgPrefLibrary::slotApply() {
             mixxx::library::prefs::kApplyPlayedTrackColorConfigKey,
             ConfigValue(checkbox_played_track_color->isChecked()));
 
-    // TODO(rryan): Don't save here.
-    m_pConfig->save();
+    m_pConfig->saveDeferred();
 }
 
 void DlgPrefLibrary::slotRowHeightValueChanged(int height) {
@@ -6,12 +6,14 @@
 
 #include "encoder/encoder.h"
 #include "encoder/encodermp3settings.h"
+#include "engine/sidechain/enginemultitrackrecorder.h"
 #include "moc_dlgprefrecord.cpp"
 #include "recording/defs_recording.h"
 #include "util/sandbox.h"
 
 namespace {
 constexpr bool kDefaultCueEnabled = true;
+constexpr int kDefaultMultitrack = static_cast<int>(EngineMultitrackRecorder::Mode::Off);
 } // anonymous namespace
 
 DlgPrefRecord::DlgPrefRecord(QWidget* parent, UserSettingsPointer pConfig)
@@ -76,6 +78,17 @@ DlgPrefRecord::DlgPrefRecord(QWidget* parent, UserSettingsPointer pConfig)
     CheckBoxRecordCueFile->setChecked(m_pConfig->getValue<bool>(
             ConfigKey(RECORDING_PREF_KEY, "CueEnabled"), kDefaultCueEnabled));
 
+    // Setting multitrack
+    comboBoxMultitrack->addItem(tr("Off"),
+            static_cast<int>(EngineMultitrackRecorder::Mode::Off));
+    comboBoxMultitrack->addItem(tr("One multichannel file"),
+            static_cast<int>(EngineMultitrackRecorder::Mode::MultichannelFile));
+    comboBoxMultitrack->addItem(tr("One file per channel"),
+            static_cast<int>(EngineMultitrackRecorder::Mode::FilePerChannel));
+    comboBoxMultitrack->setCurrentIndex(comboBoxMultitrack->findData(
+            m_pConfig->getValue(ConfigKey(RECORDING_PREF_KEY, "Multitrack"),
+                    kDefaultMultitrack)));
+
     // Setting split
     comboBoxSplitting->addItem(SPLIT_650MB);
     comboBoxSplitting->addItem(SPLIT_700MB);
@@ -144,6 +157,7 @@ void DlgPrefRecord::slotApply() {
     saveMetaData();
     saveEncoding();
     saveUseCueFile();
+    saveMultitrack();
     saveSplitSize();
 }
 
@@ -178,6 +192,9 @@ void DlgPrefRecord::slotUpdate() {
      // Setting miscellaneous
     CheckBoxRecordCueFile->setChecked(m_pConfig->getValue<bool>(
             ConfigKey(RECORDING_PREF_KEY, "CueEnabled"), kDefaultCueEnabled));
+    comboBoxMultitrack->setCurrentIndex(comboBoxMultitrack->findData(
+            m_pConfig->getValue(ConfigKey(RECORDING_PREF_KEY, "Multitrack"),
+                    kDefaultMultitrack)));
 
     QString fileSizeStr = m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "FileSize"));
     int index = comboBoxSplitting->findText(fileSizeStr);
@@ -202,6 +219,7 @@ void DlgPrefRecord::slotResetToDefaults() {
     // 4GB splitting is the default
     comboBoxSplitting->setCurrentIndex(4);
     CheckBoxRecordCueFile->setChecked(kDefaultCueEnabled);
+    comboBoxMultitrack->setCurrentIndex(comboBoxMultitrack->findData(kDefaultMultitrack));
 }
 
 void DlgPrefRecord::slotBrowseRecordingsDir() {
@@ -434,6 +452,11 @@ void DlgPrefRecord::saveUseCueFile() {
                    ConfigValue(CheckBoxRecordCueFile->isChecked()));
 }
 
+void DlgPrefRecord::saveMultitrack() {
+    m_pConfig->setValue(ConfigKey(RECORDING_PREF_KEY, "Multitrack"),
+            comboBoxMultitrack->currentData().toInt());
+}
+
 void DlgPrefRecord::saveSplitSize() {
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "FileSize"),
                    ConfigValue(comboBoxSplitting->currentText()));
@@ -128,6 +128,10 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this,
             &DlgPrefSound::engineClockChanged);
+    connect(adaptiveBufferSizeCheckBox,
+            &QCheckBox::toggled,
+            this,
+            &DlgPrefSound::adaptiveBufferSizeChanged);
 
     keylockComboBox->clear();
     for (const auto engine : EngineBuffer::kKeylockEngines) {
@@ -207,6 +211,10 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this,
             &DlgPrefSound::settingChanged);
+    connect(adaptiveBufferSizeCheckBox,
+            &QCheckBox::toggled,
+            this,
+            &DlgPrefSound::settingChanged);
     connect(keylockComboBox,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this,
@@ -525,6 +533,8 @@ void DlgPrefSound::loadSettings(const SoundManagerConfig& config) {
         engineClockComboBox->setCurrentIndex(0);
     }
 
+    adaptiveBufferSizeCheckBox->setChecked(m_config.getAdaptiveBufferSize());
+
     // Default keylock engine is Rubberband Faster (v2)
     const auto keylockEngine = static_cast<EngineBuffer::KeylockEngine>(
             m_pSettings->getValue(ConfigKey("[Master]", "keylock_engine"),
@@ -597,6 +607,7 @@ void DlgPrefSound::apiChanged(int index) {
     sampleRateComboBox->setEnabled(enable);
     deviceSyncComboBox->setEnabled(enable);
     engineClockComboBox->setEnabled(enable);
+    adaptiveBufferSizeCheckBox->setEnabled(enable);
     updateAudioBufferSizes(sampleRateComboBox->currentIndex());
 }
 
@@ -649,6 +660,10 @@ void DlgPrefSound::syncBuffersChanged(int index) {
     }
 }
 
+void DlgPrefSound::adaptiveBufferSizeChanged(bool adaptive) {
+    m_config.setAdaptiveBufferSize(adaptive);
+}
+
 void DlgPrefSound::engineClockChanged(int index) {
     if (index == 0) {
         // "Soundcard Clock"
@@ -66,6 +66,7 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     void updateAudioBufferSizes(int sampleRateIndex);
     void syncBuffersChanged(int index);
     void engineClockChanged(int index);
+    void adaptiveBufferSizeChanged(bool adaptive);
     void refreshDevices();
     void settingChanged();
     void deviceChanged();
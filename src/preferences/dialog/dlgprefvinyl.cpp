@@ -1,6 +1,7 @@
 #include "preferences/dialog/dlgprefvinyl.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "control/controlobject.h"
 #include "control/controlproxy.h"
@@ -8,7 +9,6 @@
 #include "defs_urls.h"
 #include "mixer/playermanager.h"
 #include "moc_dlgprefvinyl.cpp"
-#include "util/defs.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "vinylcontrol/vinylcontrolmanager.h"
 #include "vinylcontrol/vinylcontrolsignalwidget.h"
@@ -92,7 +92,7 @@ DlgPrefVinyl::DlgPrefVinyl(
             this,
             &DlgPrefVinyl::slotUpdateVinylGain);
 
-    for (int i = 0; i < kMaxNumberOfDecks; ++i) {
+    for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
         setDeckWidgetsVisible(i, false);
     }
 
@@ -109,9 +109,11 @@ DlgPrefVinyl::~DlgPrefVinyl() {
 void DlgPrefVinyl::slotNumDecksChanged(double dNumDecks) {
     int num_decks = static_cast<int>(dNumDecks);
 
-    if (num_decks < 0 || num_decks > kMaxNumberOfDecks) {
+    if (num_decks < 0) {
         return;
     }
+    // Only the first decks can be controlled by vinyl
+    num_decks = std::min(num_decks, kMaximumVinylControlInputs);
 
     for (int i = m_COSpeeds.length(); i < num_decks; ++i) {
         QString group = PlayerManager::groupForDeck(i);
@@ -165,6 +167,7 @@ void DlgPrefVinyl::slotResetToDefaults() {
     }
 
     SignalQualityEnable->setChecked(true);
+    DecodeInAudioCallbackEnable->setChecked(false);
     SliderVinylGain->setValue(0);
     slotUpdateVinylGain();
 }
@@ -178,6 +181,8 @@ void DlgPrefVinyl::slotUpdate() {
 
     SignalQualityEnable->setChecked(
             (bool)config->getValue<bool>(ConfigKey(VINYL_PREF_KEY, "show_signal_quality")));
+    DecodeInAudioCallbackEnable->setChecked(config->getValue<bool>(
+            ConfigKey(VINYL_PREF_KEY, "decode_in_audio_callback"), false));
 
     for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
         QString group = PlayerManager::groupForDeck(i);
@@ -271,6 +276,8 @@ void DlgPrefVinyl::slotApply() {
 
     config->set(ConfigKey(VINYL_PREF_KEY,"show_signal_quality"),
                 ConfigValue((int)(SignalQualityEnable->isChecked())));
+    config->setValue(ConfigKey(VINYL_PREF_KEY, "decode_in_audio_callback"),
+            DecodeInAudioCallbackEnable->isChecked());
 
     m_pVCManager->requestReloadConfig();
     slotUpdate();
@@ -131,6 +131,10 @@ DlgPrefWaveform::DlgPrefWaveform(
             &QCheckBox::clicked,
             this,
             &DlgPrefWaveform::slotSetZoomSynchronization);
+    connect(adaptiveFrameRateCheckBox,
+            &QCheckBox::toggled,
+            this,
+            &DlgPrefWaveform::slotSetAdaptiveFrameRate);
     connect(allVisualGain,
             QOverload<double>::of(&QDoubleSpinBox::valueChanged),
             this,
@@ -251,6 +255,7 @@ void DlgPrefWaveform::slotUpdate() {
 
     frameRateSpinBox->setValue(factory->getFrameRate());
     frameRateSlider->setValue(factory->getFrameRate());
+    adaptiveFrameRateCheckBox->setChecked(factory->isAdaptiveFrameRate());
     endOfTrackWarningTimeSpinBox->setValue(factory->getEndOfTrackWarningTime());
     endOfTrackWarningTimeSlider->setValue(factory->getEndOfTrackWarningTime());
     synchronizeZoomCheckBox->setChecked(factory->isZoomSync());
@@ -348,6 +353,7 @@ void DlgPrefWaveform::slotResetToDefaults() {
 
     // 60FPS is the default
     frameRateSlider->setValue(60);
+    adaptiveFrameRateCheckBox->setChecked(false);
     endOfTrackWarningTimeSlider->setValue(30);
 
     // Waveform caching enabled.
@@ -366,6 +372,10 @@ void DlgPrefWaveform::slotSetFrameRate(int frameRate) {
     WaveformWidgetFactory::instance()->setFrameRate(frameRate);
 }
 
+void DlgPrefWaveform::slotSetAdaptiveFrameRate(bool adaptive) {
+    WaveformWidgetFactory::instance()->setAdaptiveFrameRate(adaptive);
+}
+
 void DlgPrefWaveform::slotSetWaveformEndRender(int endTime) {
     WaveformWidgetFactory::instance()->setEndOfTrackWarningTime(endTime);
 }
@@ -30,6 +30,7 @@ class DlgPrefWaveform : public DlgPreferencePage, public Ui::DlgPrefWaveformDlg
 
   private slots:
     void slotSetFrameRate(int frameRate);
+    void slotSetAdaptiveFrameRate(bool adaptive);
     void slotSetWaveformType(int index);
     void slotSetWaveformEnabled(bool checked);
     void slotSetWaveformAcceleration(bool checked);
@@ -3,25 +3,77 @@
 #include "library/coverartcache.h"
 #include "moc_asyncimageprovider.cpp"
 #include "track/track.h"
+#include "util/compatibility/qmutex.h"
+#include "util/math.h"
 
 namespace {
 const QString kCoverArtPrefix = QStringLiteral("coverart/");
+
+constexpr int kImageCacheSizeKiB = 32 * 1024;
+
+// The range of the width buckets of decoded images
+constexpr int kMinBucketWidth = 32;
+constexpr int kMaxBucketWidth = 1024;
+
+int imageSizeKiB(const QImage& image) {
+    return static_cast<int>(math_max<qint64>(1, image.sizeInBytes() / 1024));
 }
+} // namespace
 
 namespace mixxx {
 
 namespace qml {
 
+DecodedImageCache::DecodedImageCache(int maxCostKiB)
+        : m_cache(maxCostKiB) {
+}
+
+QImage DecodedImageCache::object(const QString& trackLocation, int bucketWidth) {
+    const auto locker = lockMutex(&m_mutex);
+    const QImage* pImage = m_cache.object(qMakePair(trackLocation, bucketWidth));
+    return pImage ? *pImage : QImage();
+}
+
+void DecodedImageCache::insert(
+        const QString& trackLocation, int bucketWidth, const QImage& image) {
+    DEBUG_ASSERT(!image.isNull());
+    const auto locker = lockMutex(&m_mutex);
+    m_cache.insert(qMakePair(trackLocation, bucketWidth),
+            new QImage(image),
+            imageSizeKiB(image));
+}
+
 AsyncImageResponse::AsyncImageResponse(
         QString id,
         QSize requestedSize,
-        std::shared_ptr<TrackCollectionManager> pTrackCollectionManager)
+        std::shared_ptr<TrackCollectionManager> pTrackCollectionManager,
+        std::shared_ptr<DecodedImageCache> pImageCache,
+        std::shared_ptr<CoverThumbnailPack> pThumbnailPack)
         : m_id(std::move(id)),
           m_requestedSize(requestedSize),
-          m_pTrackCollectionManager(std::move(pTrackCollectionManager)) {
+          m_pTrackCollectionManager(std::move(pTrackCollectionManager)),
+          m_pImageCache(std::move(pImageCache)),
+          m_pThumbnailPack(std::move(pThumbnailPack)) {
     setAutoDelete(false);
 }
 
+// static
+int AsyncImageResponse::bucketWidth(QSize requestedSize) {
+    const int width = requestedSize.width() > 0
+            ? requestedSize.width()
+            : requestedSize.height();
+    if (width <= 0) {
+        return 0;
+    }
+    if (width > kMaxBucketWidth) {
+        // Larger images are rarely requested, don't round them up
+        return width;
+    }
+    return math_clamp(static_cast<int>(roundUpToPowerOf2(static_cast<unsigned int>(width))),
+            kMinBucketWidth,
+            kMaxBucketWidth);
+}
+
 QQuickTextureFactory* AsyncImageResponse::textureFactory() const {
     return QQuickTextureFactory::textureFactoryForImage(m_image);
 }
@@ -33,6 +85,14 @@ void AsyncImageResponse::run() {
         return;
     }
     const QString trackLocation = AsyncImageProvider::coverArtUrlIdToTrackLocation(m_id);
+    const int width = bucketWidth(m_requestedSize);
+    m_image = m_pImageCache->object(trackLocation, width);
+    if (!m_image.isNull()) {
+        // Neither the track nor the image need to be loaded
+        emit finished();
+        return;
+    }
+
     const auto trackRef = TrackRef::fromFilePath(trackLocation);
 
     // TODO: Only load CoverInfo from TrackCollectionManager
@@ -59,17 +119,19 @@ void AsyncImageResponse::run() {
     // Release the track reference asap, i.e. before loading the image
     pTrack.reset();
 
-    const CoverInfo::LoadedImage loadedImage = coverInfo.loadImage();
+    // The image is delivered in the size of its bucket and scaled to the
+    // requested size when rendering the texture. Resized images are read
+    // from and stored in the thumbnail pack of the widget UI.
+    const CoverArtCache::FutureResult result =
+            CoverArtCache::loadCover(TrackPointer(), coverInfo, width, m_pThumbnailPack);
+    const CoverInfo::LoadedImage& loadedImage = result.coverArt.loadedImage;
     switch (loadedImage.result) {
     case CoverInfo::LoadedImage::Result::NoImage:
         break;
     case CoverInfo::LoadedImage::Result::Ok:
         DEBUG_ASSERT(!loadedImage.image.isNull());
-        if (m_requestedSize.isValid()) {
-            m_image = loadedImage.image.scaled(m_requestedSize);
-        } else {
-            m_image = loadedImage.image;
-        }
+        m_image = loadedImage.image;
+        m_pImageCache->insert(trackLocation, width, m_image);
         break;
     default:
         qWarning() << "ImageProvider: Failed to load cover art" << trackRef;
@@ -82,13 +144,15 @@ void AsyncImageResponse::run() {
 AsyncImageProvider::AsyncImageProvider(
         std::shared_ptr<TrackCollectionManager> pTrackCollectionManager)
         : QQuickAsyncImageProvider(),
-          m_pTrackCollectionManager(pTrackCollectionManager) {
+          m_pTrackCollectionManager(pTrackCollectionManager),
+          m_pImageCache(std::make_shared<DecodedImageCache>(kImageCacheSizeKiB)),
+          m_pThumbnailPack(CoverArtCache::thumbnailPack()) {
 }
 
 QQuickImageResponse* AsyncImageProvider::requestImageResponse(
         const QString& id, const QSize& requestedSize) {
     AsyncImageResponse* response = new AsyncImageResponse(
-            id, requestedSize, m_pTrackCollectionManager);
+            id, requestedSize, m_pTrackCollectionManager, m_pImageCache, m_pThumbnailPack);
     pool.start(response);
     return response;
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <QCache>
 #include <QImage>
+#include <QMutex>
+#include <QPair>
 #include <QQuickAsyncImageProvider>
 #include <QRunnable>
 #include <QSize>
@@ -11,16 +14,40 @@
 #include "library/coverart.h"
 #include "library/trackcollectionmanager.h"
 
+class CoverThumbnailPack;
+
 namespace mixxx {
 namespace qml {
 
+/// Decoded cover images by track location and width bucket, shared
+/// by all responses of an AsyncImageProvider. Thread-safe.
+class DecodedImageCache {
+  public:
+    explicit DecodedImageCache(int maxCostKiB);
+
+    QImage object(const QString& trackLocation, int bucketWidth);
+    void insert(const QString& trackLocation, int bucketWidth, const QImage& image);
+
+  private:
+    QMutex m_mutex;
+    // The cost of each image is its size in KiB
+    QCache<QPair<QString, int>, QImage> m_cache;
+};
+
 class AsyncImageResponse : public QQuickImageResponse, public QRunnable {
     Q_OBJECT
   public:
     AsyncImageResponse(
             QString id,
             QSize requestedSize,
-            std::shared_ptr<TrackCollectionManager> pTrackCollectionManager);
+            std::shared_ptr<TrackCollectionManager> pTrackCollectionManager,
+            std::shared_ptr<DecodedImageCache> pImageCache,
+            std::shared_ptr<CoverThumbnailPack> pThumbnailPack);
+
+    /// The width of the decoded image for the requested size. The widths
+    /// are rounded up to powers of two, so a few decoded images serve all
+    /// sizes a view requests. 0 for the original size.
+    static int bucketWidth(QSize requestedSize);
 
     QQuickTextureFactory* textureFactory() const override;
 
@@ -30,6 +57,8 @@ class AsyncImageResponse : public QQuickImageResponse, public QRunnable {
     QString m_id;
     QSize m_requestedSize;
     std::shared_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+    std::shared_ptr<DecodedImageCache> m_pImageCache;
+    std::shared_ptr<CoverThumbnailPack> m_pThumbnailPack;
 
     QImage m_image;
 };
@@ -48,6 +77,9 @@ class AsyncImageProvider : public QQuickAsyncImageProvider {
   private:
     QThreadPool pool;
     std::shared_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+    std::shared_ptr<DecodedImageCache> m_pImageCache;
+    /// Shared with the cover art cache of the widget UI
+    std::shared_ptr<CoverThumbnailPack> m_pThumbnailPack;
 };
 
 } // namespace qml
@@ -1,7 +1,16 @@
 #include "qml/qmllibrarytracklistmodel.h"
 
-#include "library/librarytablemodel.h"
+#include <QDir>
+#include <QSqlQuery>
+#include <algorithm>
+
+#include "library/basetrackcache.h"
+#include "library/dao/trackschema.h"
+#include "library/queryutil.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
 #include "moc_qmllibrarytracklistmodel.cpp"
+#include "util/db/dbconnection.h"
 
 namespace mixxx {
 namespace qml {
@@ -13,75 +22,225 @@ const QHash<int, QByteArray> kRoleNames = {
         {QmlLibraryTrackListModel::AlbumArtistRole, "albumArtist"},
         {QmlLibraryTrackListModel::FileUrlRole, "fileUrl"},
 };
+
+// The number of rows exposed to the view at once
+constexpr int kFetchMoreRowCount = 500;
+
+QString selectTrackIdsQuery() {
+    const QString collate = DbConnection::collateLexicographically(QString());
+    return QStringLiteral(
+            "SELECT library.%1 FROM library "
+            "INNER JOIN track_locations "
+            "ON library.location=track_locations.id "
+            "WHERE (mixxx_deleted=0 AND fs_deleted=0) "
+            "ORDER BY library.%2%5, library.%3%5, library.%4%5")
+            .arg(LIBRARYTABLE_ID,
+                    LIBRARYTABLE_ARTIST,
+                    LIBRARYTABLE_ALBUM,
+                    LIBRARYTABLE_TITLE,
+                    collate);
 }
 
-QmlLibraryTrackListModel::QmlLibraryTrackListModel(LibraryTableModel* pModel, QObject* pParent)
-        : QIdentityProxyModel(pParent) {
-    pModel->select();
-    setSourceModel(pModel);
+} // namespace
+
+QmlLibraryTrackListModel::QmlLibraryTrackListModel(
+        TrackCollectionManager* pTrackCollectionManager, QObject* pParent)
+        : QAbstractListModel(pParent),
+          m_pTrackCollectionManager(pTrackCollectionManager),
+          m_pTrackSource(pTrackCollectionManager->internalCollection()
+                                 ->getTrackSource()
+                                 .data()),
+          m_rowCount(0),
+          m_requestedRowCount(0),
+          m_selecting(false),
+          m_pSelectGeneration(std::make_shared<std::atomic<int>>(0)) {
+    DEBUG_ASSERT(m_pTrackSource);
+    const TrackCollection* pTrackCollection = pTrackCollectionManager->internalCollection();
+    connect(pTrackCollection,
+            &TrackCollection::tracksAdded,
+            this,
+            &QmlLibraryTrackListModel::select);
+    connect(pTrackCollection,
+            &TrackCollection::tracksRemoved,
+            this,
+            &QmlLibraryTrackListModel::select);
+    connect(m_pTrackSource,
+            &BaseTrackCache::tracksChanged,
+            this,
+            &QmlLibraryTrackListModel::slotTracksChanged);
+    select();
 }
 
-QVariant QmlLibraryTrackListModel::data(const QModelIndex& proxyIndex, int role) const {
-    if (!proxyIndex.isValid()) {
-        return {};
+void QmlLibraryTrackListModel::select() {
+    if (!m_pTrackSource->isIndexBuilt()) {
+        m_pTrackSource->buildIndex();
     }
 
-    VERIFY_OR_DEBUG_ASSERT(checkIndex(proxyIndex)) {
-        return {};
+    beginResetModel();
+    m_rows.clear();
+    m_rowCount = 0;
+    m_requestedRowCount = kFetchMoreRowCount;
+    m_selecting = true;
+    endResetModel();
+
+    const int generation = ++*m_pSelectGeneration;
+    TrackQueryThread* pTrackQueryThread = m_pTrackCollectionManager->trackQueryThread();
+    if (!pTrackQueryThread) {
+        // Select synchronously if there is no database connection pool
+        TrackQueryThread::Page page;
+        page.generation = generation;
+        page.isLast = true;
+        QSqlQuery query(m_pTrackSource->database());
+        query.setForwardOnly(true);
+        if (query.exec(selectTrackIdsQuery())) {
+            while (query.next()) {
+                page.rows.append(TrackQueryThread::Row{TrackId(query.value(0)), {}});
+            }
+        } else {
+            LOG_FAILED_QUERY(query);
+            page.failed = true;
+        }
+        onSelectPage(std::move(page));
+        return;
+    }
+
+    TrackQueryThread::Request request;
+    request.tableQuery = selectTrackIdsQuery();
+    request.idColumn = LIBRARYTABLE_ID;
+    // Only the id is needed, the role data is read from the track cache
+    request.columnCount = 0;
+    request.generation = generation;
+    request.pLatestGeneration = m_pSelectGeneration;
+    pTrackQueryThread->select(
+            std::move(request),
+            this,
+            [this](TrackQueryThread::Page page) {
+                onSelectPage(std::move(page));
+            });
+}
+
+void QmlLibraryTrackListModel::onSelectPage(TrackQueryThread::Page page) {
+    if (page.generation != m_pSelectGeneration->load()) {
+        // Superseded by a newer select
+        return;
+    }
+    if (page.failed) {
+        qWarning() << "QmlLibraryTrackListModel: Failed to select tracks";
+        m_selecting = false;
+        return;
+    }
+    appendRows(page.rows);
+    if (page.isLast) {
+        m_selecting = false;
+    }
+    insertFetchedRows();
+}
+
+void QmlLibraryTrackListModel::appendRows(const QVector<TrackQueryThread::Row>& rows) {
+    m_rows.reserve(m_rows.size() + rows.size());
+    for (const auto& row : rows) {
+        TrackRow trackRow;
+        trackRow.trackId = row.trackId;
+        readTrackRow(&trackRow);
+        m_rows.append(std::move(trackRow));
     }
+}
 
-    const auto pSourceModel = static_cast<LibraryTableModel*>(sourceModel());
-    VERIFY_OR_DEBUG_ASSERT(pSourceModel) {
+void QmlLibraryTrackListModel::readTrackRow(TrackRow* pRow) const {
+    const auto value = [this, pRow](ColumnCache::Column column) {
+        return m_pTrackSource->data(pRow->trackId, m_pTrackSource->fieldIndex(column));
+    };
+    if (!m_pTrackSource->isCached(pRow->trackId)) {
+        m_pTrackSource->ensureCached(pRow->trackId);
+    }
+    // The strings are shared with the track cache
+    pRow->title = value(ColumnCache::COLUMN_LIBRARYTABLE_TITLE).toString();
+    pRow->artist = value(ColumnCache::COLUMN_LIBRARYTABLE_ARTIST).toString();
+    pRow->album = value(ColumnCache::COLUMN_LIBRARYTABLE_ALBUM).toString();
+    pRow->albumArtist = value(ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST).toString();
+    const QString location = QDir::fromNativeSeparators(
+            value(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION).toString());
+    pRow->fileUrl = location.isEmpty() ? QUrl() : QUrl::fromLocalFile(location);
+}
+
+void QmlLibraryTrackListModel::insertFetchedRows() {
+    const int rowCount = std::min(m_requestedRowCount, static_cast<int>(m_rows.size()));
+    if (rowCount <= m_rowCount) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), m_rowCount, rowCount - 1);
+    m_rowCount = rowCount;
+    endInsertRows();
+}
+
+void QmlLibraryTrackListModel::slotTracksChanged(const QSet<TrackId>& trackIds) {
+    if (trackIds.isEmpty()) {
+        return;
+    }
+    for (int row = 0; row < m_rows.size(); ++row) {
+        TrackRow& trackRow = m_rows[row];
+        if (!trackIds.contains(trackRow.trackId)) {
+            continue;
+        }
+        readTrackRow(&trackRow);
+        if (row < m_rowCount) {
+            const QModelIndex changedIndex = index(row);
+            emit dataChanged(changedIndex, changedIndex);
+        }
+    }
+}
+
+QVariant QmlLibraryTrackListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
         return {};
     }
 
-    if (proxyIndex.column() > 0) {
+    VERIFY_OR_DEBUG_ASSERT(checkIndex(index)) {
         return {};
     }
 
-    int column = -1;
+    const TrackRow& trackRow = m_rows[index.row()];
     switch (role) {
     case TitleRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TITLE);
-        break;
+        return trackRow.title;
     case ArtistRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ARTIST);
-        break;
+        return trackRow.artist;
     case AlbumRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ALBUM);
-        break;
+        return trackRow.album;
     case AlbumArtistRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST);
-        break;
-    case FileUrlRole: {
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
-        const QString location = QIdentityProxyModel::data(
-                proxyIndex.siblingAtColumn(column), Qt::DisplayRole)
-                                         .toString();
-        if (location.isEmpty()) {
+        return trackRow.albumArtist;
+    case FileUrlRole:
+        if (trackRow.fileUrl.isEmpty()) {
             return {};
         }
-        return QUrl::fromLocalFile(location);
-    }
+        return trackRow.fileUrl;
     default:
-        break;
-    }
-
-    if (column < 0) {
         return {};
     }
-
-    return QIdentityProxyModel::data(proxyIndex.siblingAtColumn(column), Qt::DisplayRole);
 }
 
-int QmlLibraryTrackListModel::columnCount(const QModelIndex& parent) const {
+int QmlLibraryTrackListModel::rowCount(const QModelIndex& parent) const {
     // This is a list model, i.e. no entries have a parent.
-    VERIFY_OR_DEBUG_ASSERT(!parent.isValid()) {
+    if (parent.isValid()) {
         return 0;
     }
+    return m_rowCount;
+}
 
-    // There is exactly one column. All data is exposed as roles.
-    return 1;
+bool QmlLibraryTrackListModel::canFetchMore(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return false;
+    }
+    return m_rowCount < m_rows.size() || m_selecting;
+}
+
+void QmlLibraryTrackListModel::fetchMore(const QModelIndex& parent) {
+    if (parent.isValid()) {
+        return;
+    }
+    // Rows that have not been selected yet are inserted when they arrive
+    m_requestedRowCount = m_rowCount + kFetchMoreRowCount;
+    insertFetchedRows();
 }
 
 QHash<int, QByteArray> QmlLibraryTrackListModel::roleNames() const {
@@ -1,13 +1,30 @@
 #pragma once
-#include <QIdentityProxyModel>
+#include <QAbstractListModel>
+#include <QSet>
+#include <QUrl>
+#include <QVector>
 #include <QtQml>
+#include <atomic>
+#include <memory>
 
-class LibraryTableModel;
+#include "library/trackquerythread.h"
+#include "track/trackid.h"
+
+class BaseTrackCache;
+class TrackCollectionManager;
 
 namespace mixxx {
 namespace qml {
 
-class QmlLibraryTrackListModel : public QIdentityProxyModel {
+/// A list model of all tracks of the library for QML.
+///
+/// The ids of the tracks are selected in their sort order on the
+/// TrackQueryThread. The role data is then read from the track cache of
+/// the library, which already holds the values of all tracks, and stored
+/// in a compact struct per row, so data() doesn't need to look up columns.
+/// The rows are exposed to the view in chunks by fetchMore(), so a view
+/// only creates delegates for the rows that have been scrolled to.
+class QmlLibraryTrackListModel : public QAbstractListModel {
     Q_OBJECT
     QML_NAMED_ELEMENT(LibraryTrackListModel)
     QML_UNCREATABLE("Only accessible via Mixxx.Library.model")
@@ -22,13 +39,50 @@ class QmlLibraryTrackListModel : public QIdentityProxyModel {
     };
     Q_ENUM(Roles);
 
-    QmlLibraryTrackListModel(LibraryTableModel* pModel, QObject* pParent = nullptr);
-    ~QmlLibraryTrackListModel() = default;
+    QmlLibraryTrackListModel(TrackCollectionManager* pTrackCollectionManager,
+            QObject* pParent = nullptr);
+    ~QmlLibraryTrackListModel() override = default;
 
     QVariant data(const QModelIndex& index, int role) const override;
-    int columnCount(const QModelIndex& index = QModelIndex()) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
     QHash<int, QByteArray> roleNames() const override;
     Q_INVOKABLE QVariant get(int row) const;
+
+  public slots:
+    /// Selects all tracks again, e.g. after tracks have been added
+    void select();
+
+  private slots:
+    void slotTracksChanged(const QSet<TrackId>& trackIds);
+
+  private:
+    struct TrackRow {
+        TrackId trackId;
+        QString title;
+        QString artist;
+        QString album;
+        QString albumArtist;
+        QUrl fileUrl;
+    };
+
+    void readTrackRow(TrackRow* pRow) const;
+    void onSelectPage(TrackQueryThread::Page page);
+    /// Appends the selected track ids as rows
+    void appendRows(const QVector<TrackQueryThread::Row>& rows);
+    /// Exposes the selected rows that have been requested by fetchMore()
+    void insertFetchedRows();
+
+    TrackCollectionManager* const m_pTrackCollectionManager;
+    BaseTrackCache* m_pTrackSource;
+
+    /// All selected rows. Only the first m_rowCount rows are exposed.
+    QVector<TrackRow> m_rows;
+    int m_rowCount;
+    int m_requestedRowCount;
+    bool m_selecting;
+    const std::shared_ptr<std::atomic<int>> m_pSelectGeneration;
 };
 
 } // namespace qml
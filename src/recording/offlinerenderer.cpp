@@ -0,0 +1,163 @@
+#include "recording/offlinerenderer.h"
+
+#include <QCoreApplication>
+#include <algorithm>
+
+#include "control/controlobject.h"
+#include "engine/engine.h"
+#include "engine/enginemixer.h"
+#include "moc_offlinerenderer.cpp"
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("OfflineRenderer");
+
+// The frames per EngineMixer::process() call. There is no latency to care
+// about, this only limits how often pending events are processed.
+constexpr SINT kBufferFrames = 1024;
+
+} // anonymous namespace
+
+OfflineRenderer::OfflineRenderer(UserSettingsPointer pConfig, EngineMixer* pEngineMixer)
+        : m_pConfig(pConfig),
+          m_pEngineMixer(pEngineMixer),
+          m_frames(0),
+          m_renderNanos(0),
+          m_stopRequested(false) {
+}
+
+OfflineRenderer::~OfflineRenderer() {
+    close();
+}
+
+bool OfflineRenderer::open(const QString& fileName, QString* pErrorMessage) {
+    VERIFY_OR_DEBUG_ASSERT(!isOpen()) {
+        close();
+    }
+
+    m_sampleRate = mixxx::audio::SampleRate::fromDouble(
+            ControlObject::get(ConfigKey(QStringLiteral("[App]"), QStringLiteral("samplerate"))));
+    const Encoder::Format format = EncoderFactory::getFactory().getSelectedFormat(m_pConfig);
+    m_pEncoder = EncoderFactory::getFactory().createRecordingEncoder(
+            format, m_pConfig, this);
+    if (!m_pEncoder) {
+        *pErrorMessage = tr("The %1 encoder is not available.").arg(format.label);
+        return false;
+    }
+    m_pEncoder->updateMetaData(
+            m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "Author")),
+            m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "Title")),
+            m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "Album")));
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *pErrorMessage = m_file.errorString();
+        m_pEncoder.reset();
+        return false;
+    }
+    // The encoder may write a header when it is initialized
+    if (m_pEncoder->initEncoder(m_sampleRate, pErrorMessage) < 0) {
+        m_pEncoder.reset();
+        m_file.close();
+        return false;
+    }
+
+    m_frames = 0;
+    m_renderNanos = 0;
+    m_stopRequested = false;
+    return true;
+}
+
+void OfflineRenderer::close() {
+    if (!isOpen()) {
+        return;
+    }
+    if (m_pEncoder) {
+        m_pEncoder->flush();
+        m_pEncoder.reset();
+    }
+    m_file.close();
+    kLogger.info()
+            << "Rendered" << m_frames << "frames to" << m_file.fileName()
+            << "at" << speedFactor() << "times real time";
+}
+
+SINT OfflineRenderer::render(SINT frames) {
+    VERIFY_OR_DEBUG_ASSERT(isOpen() && m_pEncoder) {
+        return 0;
+    }
+
+    m_stopRequested = false;
+    m_pEngineMixer->setSynchronousReads(true);
+    PerformanceTimer timer;
+    timer.start();
+    SINT renderedFrames = 0;
+    while (renderedFrames < frames && !m_stopRequested) {
+        const SINT bufferFrames = std::min(frames - renderedFrames, kBufferFrames);
+        const SINT bufferSamples = bufferFrames * mixxx::kEngineChannelOutputCount;
+        m_pEngineMixer->process(static_cast<int>(bufferSamples));
+        m_pEncoder->encodeBuffer(m_pEngineMixer->getMainBuffer(),
+                static_cast<int>(bufferSamples));
+        renderedFrames += bufferFrames;
+        m_frames += bufferFrames;
+        emit framesRendered(m_frames);
+
+        // Apply the changes of the GUI thread, e.g. Auto DJ fading to the
+        // next track, before rendering the next buffer
+        QCoreApplication::processEvents();
+    }
+    m_pEngineMixer->setSynchronousReads(false);
+    m_renderNanos += timer.elapsed().toIntegerNanos();
+    return renderedFrames;
+}
+
+double OfflineRenderer::speedFactor() const {
+    if (m_renderNanos <= 0 || !m_sampleRate.isValid()) {
+        return 0.0;
+    }
+    const double renderedNanos = static_cast<double>(m_frames) * 1e9 / m_sampleRate.value();
+    return renderedNanos / static_cast<double>(m_renderNanos);
+}
+
+void OfflineRenderer::stop() {
+    m_stopRequested = true;
+}
+
+void OfflineRenderer::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (!isOpen()) {
+        return;
+    }
+    // Relevant for OGG
+    if (headerLen > 0) {
+        m_file.write(reinterpret_cast<const char*>(header), headerLen);
+    }
+    m_file.write(reinterpret_cast<const char*>(body), bodyLen);
+}
+
+int OfflineRenderer::tell() {
+    if (!isOpen()) {
+        return -1;
+    }
+    return static_cast<int>(m_file.pos());
+}
+
+void OfflineRenderer::seek(int pos) {
+    if (!isOpen()) {
+        return;
+    }
+    m_file.seek(static_cast<qint64>(pos));
+}
+
+int OfflineRenderer::filelen() {
+    if (!isOpen()) {
+        return 0;
+    }
+    return static_cast<int>(m_file.size());
+}
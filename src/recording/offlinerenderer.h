@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/usersettings.h"
+#include "util/types.h"
+
+class EngineMixer;
+
+/// The OfflineRenderer renders the main mix into a file as fast as the CPU
+/// allows, e.g. for pre-rendering an Auto DJ show. It drives
+/// EngineMixer::process() itself instead of a sound device and encodes the
+/// mix with the recording encoder selected in the preferences, like
+/// EngineRecord.
+///
+/// The readers of all channels wait for the decoded samples, so no chunk is
+/// ever missed and the rendered mix only depends on the tracks and the
+/// controls. This also makes it usable for load testing the engine.
+///
+/// The OfflineRenderer lives in the GUI thread. The engine must not be driven
+/// by SoundManager while rendering.
+class OfflineRenderer : public QObject, public EncoderCallback {
+    Q_OBJECT
+  public:
+    OfflineRenderer(UserSettingsPointer pConfig, EngineMixer* pEngineMixer);
+    ~OfflineRenderer() override;
+
+    /// Creates the encoder and opens the file. Returns false and sets
+    /// pErrorMessage on failure.
+    bool open(const QString& fileName, QString* pErrorMessage);
+    /// Flushes the encoder and closes the file.
+    void close();
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+
+    /// Renders up to the given number of frames and returns the number of
+    /// frames that have been rendered, which is less if stop() has been
+    /// called. Pending events are processed after each buffer, so Auto DJ
+    /// and the controls keep working while rendering.
+    SINT render(SINT frames);
+
+    /// The ratio of the rendered duration to the time it took to render
+    /// it, e.g. 20 if the mix has been rendered at 20 times real time.
+    double speedFactor() const;
+
+    // EncoderCallback
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  public slots:
+    /// Stops rendering after the current buffer, e.g. when Auto DJ has
+    /// been disabled at the end of the queue.
+    void stop();
+
+  signals:
+    void framesRendered(quint64 frames);
+
+  private:
+    UserSettingsPointer m_pConfig;
+    EngineMixer* m_pEngineMixer;
+    EncoderPointer m_pEncoder;
+    QFile m_file;
+
+    mixxx::audio::SampleRate m_sampleRate;
+    quint64 m_frames;
+    // The wall clock time spent in render() in ns
+    qint64 m_renderNanos;
+    bool m_stopRequested;
+};
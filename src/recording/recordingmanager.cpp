@@ -8,6 +8,7 @@
 
 #include "control/controlpushbutton.h"
 #include "engine/enginemixer.h"
+#include "engine/sidechain/enginemultitrackrecorder.h"
 #include "engine/sidechain/enginerecord.h"
 #include "engine/sidechain/enginesidechain.h"
 #include "errordialoghandler.h"
@@ -18,6 +19,7 @@
 
 RecordingManager::RecordingManager(UserSettingsPointer pConfig, EngineMixer* pEngine)
         : m_pConfig(pConfig),
+          m_pEngine(pEngine),
           m_recordingDir(""),
           m_recording_base_file(""),
           m_recordingFile(""),
@@ -135,6 +137,35 @@ void RecordingManager::startRecording() {
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "CuePath"), ConfigValue(m_recording_base_file + QStringLiteral(".cue")));
 
     m_pCoRecStatus->set(RECORD_READY);
+
+    startMultitrackRecording();
+}
+
+void RecordingManager::startMultitrackRecording() {
+    const auto mode = static_cast<EngineMultitrackRecorder::Mode>(
+            m_pConfig->getValue(ConfigKey(RECORDING_PREF_KEY, "Multitrack"),
+                    static_cast<int>(EngineMultitrackRecorder::Mode::Off)));
+    if (mode == EngineMultitrackRecorder::Mode::Off) {
+        return;
+    }
+    const bool flac = m_pConfig->getValueString(
+                              ConfigKey(RECORDING_PREF_KEY, "Encoding")) ==
+            QStringLiteral(ENCODING_FLAC);
+    const auto sampleRate = mixxx::audio::SampleRate::fromDouble(
+            ControlObject::get(ConfigKey(QStringLiteral("[App]"), QStringLiteral("samplerate"))));
+    // Decks and samplers are added after the RecordingManager has been
+    // created, so the channels are looked up when starting
+    if (!m_pEngine->getMultitrackRecorder()->startRecording(m_recording_base_file,
+                mode,
+                flac,
+                m_pEngine->getChannelGroups(),
+                sampleRate)) {
+        ErrorDialogProperties* props = ErrorDialogHandler::instance()->newDialogProperties();
+        props->setType(DLG_WARNING);
+        props->setTitle(tr("Recording"));
+        props->setText(tr("Could not create the files for the multitrack recording."));
+        ErrorDialogHandler::instance()->requestErrorDialog(props);
+    }
 }
 
 void RecordingManager::splitContinueRecording()
@@ -163,6 +194,7 @@ void RecordingManager::splitContinueRecording()
 void RecordingManager::stopRecording() {
     qDebug() << "Recording stopped";
     m_pCoRecStatus->set(RECORD_OFF);
+    m_pEngine->getMultitrackRecorder()->stopRecording();
     m_recordingFile = "";
     m_recordingLocation = "";
     m_iNumberOfBytesRecorded = 0;
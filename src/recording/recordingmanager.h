@@ -58,6 +58,7 @@ class RecordingManager : public QObject {
     // name of the first split but with a suffix.
     void splitContinueRecording();
     void warnFreespace();
+    void startMultitrackRecording();
     std::unique_ptr<ControlObject> m_pCoRecStatus;
     std::unique_ptr<ControlPushButton> m_pToggleRecording;
 
@@ -66,6 +67,7 @@ class RecordingManager : public QObject {
     qint64 getFreeSpace();
 
     UserSettingsPointer m_pConfig;
+    EngineMixer* m_pEngine;
     QString m_recordingDir;
     // the base file
     QString m_recording_base_file;
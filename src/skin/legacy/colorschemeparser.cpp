@@ -1,5 +1,7 @@
 #include "skin/legacy/colorschemeparser.h"
 
+#include <QTextStream>
+
 #include "widget/wpixmapstore.h"
 #include "widget/wimagestore.h"
 #include "widget/wskincolor.h"
@@ -44,9 +46,17 @@ void ColorSchemeParser::setupLegacyColorSchemes(const QDomElement& docElem,
         }
 
         if (bSelectedColorSchemeFound) {
+            const QDomNode filtersNode = schemeNode.namedItem("Filters");
             std::shared_ptr<ImgSource> imsrc =
-                    std::shared_ptr<ImgSource>(parseFilters(schemeNode.namedItem("Filters")));
-            WPixmapStore::setLoader(imsrc);
+                    std::shared_ptr<ImgSource>(parseFilters(filtersNode));
+            // The filters are identified by their definition, because
+            // schemes of different skins may share a name.
+            QString colorSchemeKey;
+            if (filtersNode.hasChildNodes()) {
+                QTextStream stream(&colorSchemeKey);
+                filtersNode.save(stream, 0);
+            }
+            WPixmapStore::setLoader(imsrc, colorSchemeKey);
             WImageStore::setLoader(imsrc);
             WSkinColor::setLoader(imsrc);
 
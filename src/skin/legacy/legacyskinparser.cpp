@@ -91,6 +91,9 @@ using mixxx::skin::SkinManifest;
 /// of QString instead of every widget keeping its own copy.
 QSet<QString> LegacySkinParser::s_sharedGroupStrings;
 
+// static
+QHash<QString, LegacySkinParser::CachedTemplate> LegacySkinParser::s_templateCache;
+
 static bool sDebug = false;
 
 ControlObject* LegacySkinParser::controlFromConfigKey(
@@ -1716,10 +1719,16 @@ QDomElement LegacySkinParser::loadTemplate(const QString& path) {
     QFileInfo templateFileInfo(path);
 
     QString absolutePath = templateFileInfo.absoluteFilePath();
-
-    auto it = m_templateCache.constFind(absolutePath);
-    if (it != m_templateCache.constEnd()) {
-        return it.value();
+    const QDateTime lastModified = templateFileInfo.lastModified();
+
+    auto it = s_templateCache.constFind(absolutePath);
+    if (it != s_templateCache.constEnd() && it->lastModified == lastModified) {
+        // Same as if the template had been parsed by this parser
+        if (!m_loadedTemplates.contains(absolutePath)) {
+            m_loadedTemplates.insert(absolutePath);
+            m_pContext->setSkinTemplatePath(templateFileInfo.absoluteDir().absolutePath());
+        }
+        return it->element;
     }
 
     QFile templateFile(absolutePath);
@@ -1741,7 +1750,8 @@ QDomElement LegacySkinParser::loadTemplate(const QString& path) {
         return QDomElement();
     }
 
-    m_templateCache[absolutePath] = tmpl.documentElement();
+    s_templateCache.insert(absolutePath, CachedTemplate{lastModified, tmpl.documentElement()});
+    m_loadedTemplates.insert(absolutePath);
     m_pContext->setSkinTemplatePath(templateFileInfo.absoluteDir().absolutePath());
     return tmpl.documentElement();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QDateTime>
 #include <QDomElement>
 #include <QList>
 #include <QObject>
@@ -163,6 +164,15 @@ class LegacySkinParser : public QObject, public SkinParser {
     std::unique_ptr<SkinContext> m_pContext;
     QString m_style;
     Tooltips m_tooltips;
-    QHash<QString, QDomElement> m_templateCache;
+    struct CachedTemplate {
+        QDateTime lastModified;
+        QDomElement element;
+    };
+    /// The parsed template files are kept for the lifetime of the
+    /// application, so they are not parsed again when the skin is
+    /// reloaded or switched. The DOM is never modified while parsing.
+    static QHash<QString, CachedTemplate> s_templateCache;
+    /// The templates that have been loaded by this parser
+    QSet<QString> m_loadedTemplates;
     static QSet<QString> s_sharedGroupStrings;
 };
@@ -0,0 +1,111 @@
+#include "soundio/adaptivebuffersizecontroller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// An xrun within this number of windows after stepping down is blamed on
+/// the smaller buffer.
+constexpr int kStepDownBlameWindows = 60;
+
+} // anonymous namespace
+
+AdaptiveBufferSizeController::AdaptiveBufferSizeController()
+        : m_lastLoadPercentile(-1.0),
+          m_headroomWindows(0),
+          m_overloadWindows(0),
+          m_remainingHoldWindows(0),
+          m_holdWindows(kMinHoldWindows),
+          m_windowsSinceStepDown(kStepDownBlameWindows) {
+    for (auto& bin : m_loadHistogram) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AdaptiveBufferSizeController::recordCallbackLoad(double load) {
+    const int bin = std::clamp(static_cast<int>(std::lround(load * 100)),
+            0,
+            kNumLoadBins - 1);
+    m_loadHistogram[bin].fetch_add(1, std::memory_order_relaxed);
+}
+
+double AdaptiveBufferSizeController::takeLoadPercentile() {
+    std::array<int, kNumLoadBins> histogram;
+    int numCallbacks = 0;
+    for (int i = 0; i < kNumLoadBins; ++i) {
+        histogram[i] = m_loadHistogram[i].exchange(0, std::memory_order_relaxed);
+        numCallbacks += histogram[i];
+    }
+    if (numCallbacks == 0) {
+        return -1.0;
+    }
+    const int rank = static_cast<int>(std::ceil(numCallbacks * kLoadPercentile));
+    int count = 0;
+    for (int i = 0; i < kNumLoadBins; ++i) {
+        count += histogram[i];
+        if (count >= rank) {
+            return i / 100.0;
+        }
+    }
+    return (kNumLoadBins - 1) / 100.0;
+}
+
+AdaptiveBufferSizeController::Decision AdaptiveBufferSizeController::evaluate(
+        bool xrunHappened, bool canStepDown) {
+    m_lastLoadPercentile = takeLoadPercentile();
+    if (m_windowsSinceStepDown < kStepDownBlameWindows) {
+        ++m_windowsSinceStepDown;
+    }
+    if (m_remainingHoldWindows > 0) {
+        --m_remainingHoldWindows;
+    }
+
+    if (xrunHappened) {
+        if (m_windowsSinceStepDown < kStepDownBlameWindows) {
+            // The previous step down was not sustainable, back off longer
+            // before trying again.
+            m_holdWindows = std::min(m_holdWindows * 2, kMaxHoldWindows);
+        }
+        m_remainingHoldWindows = m_holdWindows;
+        m_windowsSinceStepDown = kStepDownBlameWindows;
+        m_headroomWindows = 0;
+        m_overloadWindows = 0;
+        return Decision::StepUp;
+    }
+
+    if (m_lastLoadPercentile < 0) {
+        // No callbacks, e.g. while the devices are reopened
+        return Decision::Keep;
+    }
+
+    if (m_lastLoadPercentile > kOverloadLoad) {
+        m_headroomWindows = 0;
+        if (++m_overloadWindows >= kOverloadWindows) {
+            m_overloadWindows = 0;
+            m_remainingHoldWindows = m_holdWindows;
+            return Decision::StepUp;
+        }
+        return Decision::Keep;
+    }
+    m_overloadWindows = 0;
+
+    if (m_lastLoadPercentile < kHeadroomLoad) {
+        ++m_headroomWindows;
+    } else {
+        m_headroomWindows = 0;
+    }
+    if (canStepDown && m_remainingHoldWindows == 0 &&
+            m_headroomWindows >= kHeadroomWindows) {
+        m_headroomWindows = 0;
+        m_windowsSinceStepDown = 0;
+        return Decision::StepDown;
+    }
+    return Decision::Keep;
+}
+
+void AdaptiveBufferSizeController::restart() {
+    takeLoadPercentile();
+    m_headroomWindows = 0;
+    m_overloadWindows = 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+/// Decides about stepping the audio buffer size up or down in the adaptive
+/// buffer size mode.
+///
+/// The audio callback reports the load of each callback, i.e. the time
+/// spent in the callback relative to the duration of the buffer. Once per
+/// evaluation window the controller looks at a high percentile of these
+/// loads and at the xruns of the window:
+///  - An xrun or a persistent overload steps the buffer size up at once.
+///  - Consistent headroom over several windows steps it down.
+/// Stepping down again after an xrun is delayed by a hold time that doubles
+/// with each step down that resulted in an xrun.
+class AdaptiveBufferSizeController {
+  public:
+    enum class Decision {
+        Keep,
+        StepDown,
+        StepUp,
+    };
+
+    /// The percentile of the callback load that is compared to the limits
+    static constexpr double kLoadPercentile = 0.99;
+    /// Stepping down halves the buffer, which about doubles the relative
+    /// jitter, so the headroom needs to be large.
+    static constexpr double kHeadroomLoad = 0.4;
+    static constexpr double kOverloadLoad = 0.8;
+    static constexpr int kHeadroomWindows = 10;
+    static constexpr int kOverloadWindows = 3;
+    static constexpr int kMinHoldWindows = 30;
+    static constexpr int kMaxHoldWindows = 1800;
+
+    AdaptiveBufferSizeController();
+
+    /// Called from the audio callback. Real-time safe.
+    void recordCallbackLoad(double load);
+
+    /// Evaluates the callback loads since the previous call. Called once
+    /// per evaluation window from the main thread. Stepping down is only
+    /// considered if canStepDown is true, e.g. when the smallest buffer
+    /// size has been reached.
+    Decision evaluate(bool xrunHappened, bool canStepDown);
+
+    /// Restarts the observation, e.g. after the devices have been reopened
+    /// with a different buffer size. The hold time is kept.
+    void restart();
+
+    /// The load percentile of the last evaluated window or a negative value
+    /// if the window did not contain any callbacks.
+    double lastLoadPercentile() const {
+        return m_lastLoadPercentile;
+    }
+
+    int holdWindows() const {
+        return m_holdWindows;
+    }
+
+  private:
+    /// The loads are collected in bins of 1%, the last bin collects all
+    /// overloads.
+    static constexpr int kNumLoadBins = 101;
+
+    double takeLoadPercentile();
+
+    std::array<std::atomic<int>, kNumLoadBins> m_loadHistogram;
+    double m_lastLoadPercentile;
+    int m_headroomWindows;
+    int m_overloadWindows;
+    /// Remaining windows before stepping down is considered again
+    int m_remainingHoldWindows;
+    int m_holdWindows;
+    /// Windows since the last step down, for detecting xruns caused by it
+    int m_windowsSinceStepDown;
+};
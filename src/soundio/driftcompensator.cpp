@@ -0,0 +1,157 @@
+#include "soundio/driftcompensator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "util/assert.h"
+
+namespace {
+
+// The fill level is measured once per callback, the jitter of the callbacks
+// is smoothed over about 100 callbacks.
+constexpr double kErrorSmoothing = 0.01;
+
+// The FIFO integrates the difference of the clocks, so the proportional term
+// alone would leave a constant error. The gains are critically damped
+// (kIntegralGain = kProportionalGain^2 / 4) with a time constant of about
+// 1000 callbacks, slow enough to be inaudible.
+constexpr double kProportionalGain = 1e-3;
+constexpr double kIntegralGain = kProportionalGain * kProportionalGain / 4;
+
+// Frames around the interpolation position needed by the cubic interpolation
+constexpr SINT kFramesBefore = 1;
+constexpr SINT kFramesAfter = 2;
+
+} // anonymous namespace
+
+DriftCompensator::DriftCompensator(Direction direction,
+        int channelCount,
+        SINT maxFramesPerBuffer,
+        SINT targetFillFrames)
+        : m_direction(direction),
+          m_channelCount(channelCount),
+          m_targetFillFrames(targetFillFrames),
+          // The input direction resamples all frames of a buffer at once,
+          // which may result in slightly more output than input frames.
+          m_input((maxFramesPerBuffer * 2 + kFramesBefore + kFramesAfter) * channelCount),
+          m_inputFrames(0),
+          m_position(0),
+          m_indices(maxFramesPerBuffer * 2),
+          m_fractions(maxFramesPerBuffer * 2),
+          m_ratio(1.0),
+          m_smoothedError(0),
+          m_integral(0) {
+    DEBUG_ASSERT(channelCount > 0);
+    reset();
+}
+
+void DriftCompensator::reset() {
+    clearInput();
+    m_ratio = 1.0;
+    m_smoothedError = 0;
+    m_integral = 0;
+}
+
+void DriftCompensator::clearInput() {
+    // Start with a silent frame before the first interpolation position
+    std::fill(m_input.begin(), m_input.begin() + m_channelCount, CSAMPLE_ZERO);
+    m_inputFrames = kFramesBefore;
+    m_position = kFramesBefore;
+}
+
+void DriftCompensator::updateRatio(
+        SINT fillFrames, SINT framesPerBuffer, double periodFraction) {
+    VERIFY_OR_DEBUG_ASSERT(framesPerBuffer > 0) {
+        return;
+    }
+    // Spread the buffer that the clock reference device has written or read
+    // over its callback period, as if the FIFO was accessed continuously.
+    const double pendingFrames = framesPerBuffer * (1.0 - std::clamp(periodFraction, 0.0, 1.0));
+    const double continuousFillFrames = m_direction == Direction::Output
+            ? fillFrames - pendingFrames
+            : fillFrames + pendingFrames;
+    const double error = (continuousFillFrames - m_targetFillFrames) / framesPerBuffer;
+    m_smoothedError += kErrorSmoothing * (error - m_smoothedError);
+    m_integral = std::clamp(m_integral + kIntegralGain * m_smoothedError,
+            -kMaxDeviation,
+            kMaxDeviation);
+    m_ratio = 1.0 +
+            std::clamp(kProportionalGain * m_smoothedError + m_integral,
+                    -kMaxDeviation,
+                    kMaxDeviation);
+}
+
+SINT DriftCompensator::inputFramesRequired(SINT outputFrames) const {
+    if (outputFrames <= 0) {
+        return 0;
+    }
+    const double lastPosition = m_position + (outputFrames - 1) * m_ratio;
+    const SINT framesRequired = static_cast<SINT>(lastPosition) + kFramesAfter + 1;
+    return std::max<SINT>(0, framesRequired - m_inputFrames);
+}
+
+SINT DriftCompensator::outputFramesAvailable() const {
+    const double positionLimit = static_cast<double>(m_inputFrames - kFramesAfter);
+    if (positionLimit <= m_position) {
+        return 0;
+    }
+    return static_cast<SINT>(std::ceil((positionLimit - m_position) / m_ratio));
+}
+
+void DriftCompensator::addInput(const CSAMPLE* pInput, SINT frames) {
+    const SINT capacity = static_cast<SINT>(m_input.size()) / m_channelCount;
+    VERIFY_OR_DEBUG_ASSERT(m_inputFrames + frames <= capacity) {
+        frames = capacity - m_inputFrames;
+    }
+    std::copy(pInput,
+            pInput + frames * m_channelCount,
+            m_input.begin() + m_inputFrames * m_channelCount);
+    m_inputFrames += frames;
+}
+
+SINT DriftCompensator::process(CSAMPLE* pOutput, SINT outputFrames) {
+    const SINT frames = std::min({outputFrames,
+            outputFramesAvailable(),
+            static_cast<SINT>(m_indices.size())});
+
+    // The positions are calculated in double precision, because the
+    // fractions would lose the sub-ppm resolution of the ratio otherwise.
+    for (SINT i = 0; i < frames; ++i) {
+        const double position = m_position + i * m_ratio;
+        const SINT index = static_cast<SINT>(position);
+        m_indices[i] = index;
+        m_fractions[i] = static_cast<CSAMPLE>(position - index);
+    }
+
+    // Cubic Catmull-Rom interpolation. The channels of a frame are
+    // independent, so the inner loop can be vectorized.
+    const SINT channelCount = m_channelCount;
+    for (SINT i = 0; i < frames; ++i) {
+        const CSAMPLE t = m_fractions[i];
+        const CSAMPLE* p0 = &m_input[(m_indices[i] - 1) * channelCount];
+        const CSAMPLE* p1 = p0 + channelCount;
+        const CSAMPLE* p2 = p1 + channelCount;
+        const CSAMPLE* p3 = p2 + channelCount;
+        CSAMPLE* pFrame = &pOutput[i * channelCount];
+        for (SINT ch = 0; ch < channelCount; ++ch) {
+            const CSAMPLE a = 3 * (p1[ch] - p2[ch]) + p3[ch] - p0[ch];
+            const CSAMPLE b = 2 * p0[ch] - 5 * p1[ch] + 4 * p2[ch] - p3[ch];
+            const CSAMPLE c = p2[ch] - p0[ch];
+            pFrame[ch] = p1[ch] + CSAMPLE(0.5) * t * (c + t * (b + t * a));
+        }
+    }
+
+    // Discard the consumed input but the frame before the next position
+    m_position += frames * m_ratio;
+    const SINT consumedFrames = std::clamp<SINT>(
+            static_cast<SINT>(m_position) - kFramesBefore, 0, m_inputFrames);
+    if (consumedFrames > 0) {
+        std::memmove(m_input.data(),
+                m_input.data() + consumedFrames * channelCount,
+                (m_inputFrames - consumedFrames) * channelCount * sizeof(CSAMPLE));
+        m_inputFrames -= consumedFrames;
+        m_position -= consumedFrames;
+    }
+    return frames;
+}
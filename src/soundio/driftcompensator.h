@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+
+#include "util/types.h"
+
+/// Compensates the clock drift between the clock reference device and a
+/// secondary sound device.
+///
+/// The audio of the secondary device is resampled with a ratio close to 1,
+/// which is the number of input frames consumed per output frame. A PI
+/// controller adjusts the ratio to keep the fill level of the FIFO between
+/// both devices at a target. The drift is corrected continuously, instead
+/// of by skipping or duplicating whole frames.
+///
+/// The FIFO is filled and drained in whole buffers, so its fill level seen
+/// by one device jumps by a buffer whenever the callbacks of both devices
+/// pass each other. The fill level is therefore corrected by the time
+/// since the other device has accessed the FIFO.
+class DriftCompensator {
+  public:
+    enum class Direction {
+        /// The secondary device reads the output of the engine from the FIFO
+        Output,
+        /// The secondary device writes its input for the engine to the FIFO
+        Input,
+    };
+
+    /// The maximum deviation of the ratio from 1. Crystals deviate by up to a
+    /// few hundred ppm, the rest is left for catching up after jitter.
+    static constexpr double kMaxDeviation = 0.002;
+
+    DriftCompensator(Direction direction,
+            int channelCount,
+            SINT maxFramesPerBuffer,
+            SINT targetFillFrames);
+
+    void reset();
+
+    /// Discards the buffered input but keeps the ratio, e.g. after the
+    /// output could not be stored.
+    void clearInput();
+
+    /// Adjusts the ratio from the fill level of the FIFO, measured at the
+    /// start of each callback. periodFraction is the time since the clock
+    /// reference device has accessed the FIFO in units of its callback
+    /// period.
+    void updateRatio(SINT fillFrames, SINT framesPerBuffer, double periodFraction);
+
+    double ratio() const {
+        return m_ratio;
+    }
+
+    /// The number of input frames that need to be added with addInput()
+    /// before outputFrames can be resampled.
+    SINT inputFramesRequired(SINT outputFrames) const;
+
+    /// The number of output frames that can be resampled from the input
+    /// added so far.
+    SINT outputFramesAvailable() const;
+
+    void addInput(const CSAMPLE* pInput, SINT frames);
+
+    /// Resamples up to outputFrames frames and returns the number of
+    /// frames written to pOutput.
+    SINT process(CSAMPLE* pOutput, SINT outputFrames);
+
+  private:
+    const Direction m_direction;
+    const int m_channelCount;
+    const SINT m_targetFillFrames;
+    /// Interleaved input frames, starting with the frame before the current
+    /// interpolation position
+    std::vector<CSAMPLE> m_input;
+    SINT m_inputFrames;
+    /// Position of the next output frame relative to the start of m_input
+    double m_position;
+    /// The interpolation positions of one buffer
+    std::vector<SINT> m_indices;
+    std::vector<CSAMPLE> m_fractions;
+
+    double m_ratio;
+    double m_smoothedError;
+    double m_integral;
+};
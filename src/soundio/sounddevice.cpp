@@ -1,5 +1,8 @@
 #include "soundio/sounddevice.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "soundio/soundmanagerconfig.h"
 #include "soundio/soundmanagerutil.h"
 #include "soundmanagerconfig.h"
@@ -15,7 +18,9 @@ SoundDevice::SoundDevice(UserSettingsPointer config, SoundManager* sm)
           m_numInputChannels(mixxx::audio::ChannelCount::stereo()),
           m_sampleRate(SoundManagerConfig::kMixxxDefaultSampleRate),
           m_hostAPI("Unknown API"),
-          m_configFramesPerBuffer(0) {
+          m_configFramesPerBuffer(0),
+          m_outputRoutesFrameSize(-1),
+          m_outputRoutesCoverAllChannels(false) {
 }
 
 mixxx::audio::ChannelCount SoundDevice::getNumInputChannels() const {
@@ -53,11 +58,16 @@ SoundDeviceStatus SoundDevice::addOutput(const AudioOutputBuffer& out) {
         return SoundDeviceStatus::ErrorExcessiveOutputChannel;
     }
     m_audioOutputs.append(out);
+    // Recompiled by the audio callback, which must not allocate
+    m_outputRoutes.reserve(m_audioOutputs.size());
+    m_outputPairBuffers.reserve(m_audioOutputs.size());
+    m_outputRoutesFrameSize = -1;
     return SoundDeviceStatus::Ok;
 }
 
 void SoundDevice::clearOutputs() {
     m_audioOutputs.clear();
+    m_outputRoutesFrameSize = -1;
 }
 
 SoundDeviceStatus SoundDevice::addInput(const AudioInputBuffer& in) {
@@ -80,6 +90,38 @@ bool SoundDevice::operator==(const SoundDevice &other) const {
     return m_deviceId == other.getDeviceId();
 }
 
+void SoundDevice::compileOutputRoutes(int iFrameSize) {
+    m_outputRoutes.clear();
+    int coveredChannels = 0;
+    for (const auto& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup channelGroup = out.getChannelGroup();
+        const OutputRoute route = {
+                out.getBuffer(),
+                channelGroup.getChannelBase(),
+                channelGroup.getChannelCount()};
+        VERIFY_OR_DEBUG_ASSERT(route.channelBase + route.channelCount <= iFrameSize) {
+            continue;
+        }
+        m_outputRoutes.push_back(route);
+        // The channels of the outputs do not clash, see addOutput()
+        coveredChannels += route.channelCount;
+    }
+    std::sort(m_outputRoutes.begin(),
+            m_outputRoutes.end(),
+            [](const OutputRoute& lhs, const OutputRoute& rhs) {
+                return lhs.channelBase < rhs.channelBase;
+            });
+    m_outputRoutesCoverAllChannels = coveredChannels == iFrameSize;
+
+    bool stereoPairs = m_outputRoutesCoverAllChannels && !m_outputRoutes.empty();
+    for (std::size_t i = 0; i < m_outputRoutes.size() && stereoPairs; ++i) {
+        stereoPairs = m_outputRoutes[i].channelCount == 2 &&
+                m_outputRoutes[i].channelBase == static_cast<int>(i) * 2;
+    }
+    m_outputPairBuffers.resize(stereoPairs ? m_outputRoutes.size() : 0);
+    m_outputRoutesFrameSize = iFrameSize;
+}
+
 void SoundDevice::composeOutputBuffer(CSAMPLE* outputBuffer,
                                       const SINT framesToCompose,
                                       const SINT framesReadOffset,
@@ -88,64 +130,49 @@ void SoundDevice::composeOutputBuffer(CSAMPLE* outputBuffer,
     //         << device->getInternalName()
     //         << framesToCompose << iFrameSize;
 
-    // Interlace Audio data onto portaudio buffer.  We iterate through the
-    // source list to find out what goes in the buffer data is interlaced in
-    // the order of the list
-
-    if (iFrameSize == 2 && m_audioOutputs.size() == 1 &&
-            m_audioOutputs.at(0).getChannelGroup().getChannelCount() == 2) {
-        // Special case for one stereo device only
-        const AudioOutputBuffer& out = m_audioOutputs.at(0);
-        const CSAMPLE* pAudioOutputBuffer = out.getBuffer(); // Always Stereo
-        pAudioOutputBuffer = &pAudioOutputBuffer[framesReadOffset*2];
-        SampleUtil::copyClampBuffer(outputBuffer, pAudioOutputBuffer,
-               framesToCompose * 2);
-    } else {
+    // Interlace Audio data onto the device buffer, following the copy plan
+    // that has been compiled from the list of outputs.
+    if (m_outputRoutesFrameSize != iFrameSize) {
+        compileOutputRoutes(iFrameSize);
+    }
+    // The output buffers are always stereo
+    const SINT readOffset = framesReadOffset * 2;
+
+    if (!m_outputPairBuffers.empty()) {
+        // e.g. a single stereo output or the decks routed to the channels
+        // of an external mixer
+        for (std::size_t i = 0; i < m_outputPairBuffers.size(); ++i) {
+            m_outputPairBuffers[i] = &m_outputRoutes[i].pBuffer[readOffset];
+        }
+        SampleUtil::interleaveStereoPairsClamp(outputBuffer,
+                m_outputPairBuffers.data(),
+                static_cast<int>(m_outputPairBuffers.size()),
+                framesToCompose);
+        return;
+    }
+
+    if (!m_outputRoutesCoverAllChannels) {
         // Reset sample for each open channel
         SampleUtil::clear(outputBuffer, framesToCompose * iFrameSize);
-
-        for (QList<AudioOutputBuffer>::iterator i = m_audioOutputs.begin(),
-                     e = m_audioOutputs.end(); i != e; ++i) {
-            AudioOutputBuffer& out = *i;
-
-            const ChannelGroup outChans = out.getChannelGroup();
-            const int iChannelCount = outChans.getChannelCount();
-            const int iChannelBase = outChans.getChannelBase();
-
-            const CSAMPLE* pAudioOutputBuffer = out.getBuffer();
-            // advanced to offset; pAudioOutputBuffer is always stereo
-            pAudioOutputBuffer = &pAudioOutputBuffer[framesReadOffset*2];
-            if (iChannelCount == 1) {
-                // All AudioOutputs are stereo as of Mixxx 1.12.0. If we have a mono
-                // output then we need to downsample.
-                for (SINT iFrameNo = 0; iFrameNo < framesToCompose; ++iFrameNo) {
-                    // iFrameBase is the "base sample" in a frame (ie. the first
-                    // sample in a frame)
-                    const SINT iFrameBase = iFrameNo * iFrameSize;
-                    outputBuffer[iFrameBase + iChannelBase] = SampleUtil::clampSample(
-                            (pAudioOutputBuffer[iFrameNo * 2] +
-                                    pAudioOutputBuffer[iFrameNo * 2 + 1]) / 2.0f);
-                }
-            } else {
-                for (SINT iFrameNo = 0; iFrameNo < framesToCompose; ++iFrameNo) {
-                    // iFrameBase is the "base sample" in a frame (ie. the first
-                    // sample in a frame)
-                    const SINT iFrameBase = iFrameNo * iFrameSize;
-                    const SINT iLocalFrameBase = iFrameNo * iChannelCount;
-
-                    // this will make sure a sample from each channel is copied
-                    for (int iChannel = 0; iChannel < iChannelCount; ++iChannel) {
-                        outputBuffer[iFrameBase + iChannelBase + iChannel] =
-                                SampleUtil::clampSample(
-                                        pAudioOutputBuffer[iLocalFrameBase + iChannel]);
-
-                        // Input audio pass-through (useful for debugging)
-                        //if (in)
-                        //    output[iFrameBase + src.channelBase + iChannel] =
-                        //    in[iFrameBase + src.channelBase + iChannel];
-                    }
-                }
+    }
+    for (const auto& route : m_outputRoutes) {
+        const CSAMPLE* pAudioOutputBuffer = &route.pBuffer[readOffset];
+        if (route.channelCount == 1) {
+            // All AudioOutputs are stereo as of Mixxx 1.12.0. If we have a mono
+            // output then we need to downsample.
+            for (SINT iFrameNo = 0; iFrameNo < framesToCompose; ++iFrameNo) {
+                outputBuffer[iFrameNo * iFrameSize + route.channelBase] =
+                        SampleUtil::clampSample(
+                                (pAudioOutputBuffer[iFrameNo * 2] +
+                                        pAudioOutputBuffer[iFrameNo * 2 + 1]) /
+                                2.0f);
             }
+        } else {
+            SampleUtil::copyStereoToMultiClamp(outputBuffer,
+                    pAudioOutputBuffer,
+                    iFrameSize,
+                    route.channelBase,
+                    framesToCompose);
         }
     }
 }
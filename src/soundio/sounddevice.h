@@ -2,6 +2,7 @@
 
 #include <QList>
 #include <QString>
+#include <vector>
 
 #include "audio/types.h"
 #include "preferences/usersettings.h"
@@ -90,6 +91,26 @@ class SoundDevice {
     SINT m_configFramesPerBuffer;
     QList<AudioOutputBuffer> m_audioOutputs;
     QList<AudioInputBuffer> m_audioInputs;
+
+  private:
+    struct OutputRoute {
+        const CSAMPLE* pBuffer; // Always stereo
+        int channelBase;
+        int channelCount;
+    };
+
+    // Compiles m_audioOutputs into the copy plan of composeOutputBuffer()
+    // for the given frame size of the device.
+    void compileOutputRoutes(int iFrameSize);
+
+    // Sorted by channelBase. Compiled on the first callback after the
+    // outputs have changed.
+    std::vector<OutputRoute> m_outputRoutes;
+    int m_outputRoutesFrameSize;
+    bool m_outputRoutesCoverAllChannels;
+    // Set if the outputs are stereo pairs that cover all channels in order,
+    // which are interleaved in a single pass over the device buffer.
+    std::vector<const CSAMPLE*> m_outputPairBuffers;
 };
 
 typedef QSharedPointer<SoundDevice> SoundDevicePointer;
@@ -0,0 +1,794 @@
+#include "soundio/sounddevicealsa.h"
+
+#include <float.h>
+#include <pthread.h>
+
+#include <QtDebug>
+#include <algorithm>
+#include <utility>
+
+#include "control/controlobject.h"
+#include "moc_sounddevicealsa.cpp"
+#include "soundio/soundmanager.h"
+#include "util/denormalsarezero.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/threadplacement.h"
+#include "util/timer.h"
+#include "util/trace.h"
+#include "waveform/visualplayposition.h"
+
+namespace {
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+constexpr int kCpuUsageUpdateRate = 30; // in 1/s, fits to display frame rate
+
+// The ring buffer of each device holds this number of periods. Two periods
+// are the minimum, one is played while the other one is filled.
+constexpr unsigned int kPeriods = 2;
+
+// snd_pcm_wait() returns after this time, which allows to stop the thread
+// when the device does not run.
+constexpr int kWaitTimeoutMillis = 500;
+
+// Hardware devices may report up to a few hundred channels
+constexpr int kMaxChannels = 64;
+
+// Within the usual range of SCHED_FIFO audio threads (see
+// SoundDevicePortAudio::callbackProcessClkRef)
+constexpr int kRealtimePriority = 70;
+
+// In order of preference. Float samples are interleaved into the mmap area
+// of the device without a copy.
+constexpr snd_pcm_format_t kFormats[] = {
+        SND_PCM_FORMAT_FLOAT,
+        SND_PCM_FORMAT_S32,
+        SND_PCM_FORMAT_S16,
+};
+
+constexpr double kS32Scale = 2147483647.0;
+
+void convertToDevice(void* pDest,
+        const CSAMPLE* pSrc,
+        snd_pcm_format_t format,
+        SINT numSamples) {
+    if (format == SND_PCM_FORMAT_S16) {
+        SampleUtil::convertFloat32ToS16(static_cast<SAMPLE*>(pDest), pSrc, numSamples);
+        return;
+    }
+    DEBUG_ASSERT(format == SND_PCM_FORMAT_S32);
+    int32_t* pDestS32 = static_cast<int32_t*>(pDest);
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDestS32[i] = static_cast<int32_t>(
+                SampleUtil::clampSample(pSrc[i]) * kS32Scale);
+    }
+}
+
+void convertFromDevice(CSAMPLE* pDest,
+        const void* pSrc,
+        snd_pcm_format_t format,
+        SINT numSamples) {
+    if (format == SND_PCM_FORMAT_S16) {
+        SampleUtil::convertS16ToFloat32(pDest, static_cast<const SAMPLE*>(pSrc), numSamples);
+        return;
+    }
+    DEBUG_ASSERT(format == SND_PCM_FORMAT_S32);
+    SampleUtil::convertS32ToFloat32(pDest,
+            static_cast<const int32_t*>(pSrc),
+            static_cast<CSAMPLE>(1.0 / (kS32Scale + 1.0)),
+            numSamples);
+}
+
+// All channels of an interleaved device share the area of the first one
+void* interleavedBuffer(const snd_pcm_channel_area_t* pAreas, snd_pcm_uframes_t offset) {
+    return static_cast<char*>(pAreas[0].addr) +
+            (pAreas[0].first + offset * pAreas[0].step) / 8;
+}
+
+QString errorText(int err) {
+    return QString::fromUtf8(snd_strerror(err));
+}
+
+// Returns the maximum number of channels or 0 if the device can not be
+// opened, e.g. because it is used by a sound server.
+int queryChannelCount(const QByteArray& hwDevice,
+        snd_pcm_stream_t direction,
+        mixxx::audio::SampleRate* pDefaultSampleRate) {
+    snd_pcm_t* pPcm = nullptr;
+    if (snd_pcm_open(&pPcm, hwDevice.constData(), direction, SND_PCM_NONBLOCK) < 0) {
+        return 0;
+    }
+    snd_pcm_hw_params_t* pHwParams;
+    snd_pcm_hw_params_alloca(&pHwParams);
+    unsigned int maxChannels = 0;
+    if (snd_pcm_hw_params_any(pPcm, pHwParams) >= 0 &&
+            snd_pcm_hw_params_get_channels_max(pHwParams, &maxChannels) >= 0) {
+        if (!pDefaultSampleRate->isValid()) {
+            for (const auto sampleRate : {48000u, 44100u}) {
+                if (snd_pcm_hw_params_test_rate(pPcm, pHwParams, sampleRate, 0) == 0) {
+                    *pDefaultSampleRate = mixxx::audio::SampleRate(sampleRate);
+                    break;
+                }
+            }
+        }
+    }
+    snd_pcm_close(pPcm);
+    return std::min(static_cast<int>(maxChannels), kMaxChannels);
+}
+
+} // anonymous namespace
+
+// static
+QList<SoundDeviceAlsa::Info> SoundDeviceAlsa::queryDevices() {
+    QList<Info> devices;
+    int card = -1;
+    while (snd_card_next(&card) >= 0 && card >= 0) {
+        snd_ctl_t* pCtl = nullptr;
+        const QByteArray ctlName = QStringLiteral("hw:%1").arg(card).toLatin1();
+        if (snd_ctl_open(&pCtl, ctlName.constData(), 0) < 0) {
+            continue;
+        }
+        snd_ctl_card_info_t* pCardInfo;
+        snd_ctl_card_info_alloca(&pCardInfo);
+        if (snd_ctl_card_info(pCtl, pCardInfo) < 0) {
+            snd_ctl_close(pCtl);
+            continue;
+        }
+        const QString cardName = QString::fromUtf8(snd_ctl_card_info_get_name(pCardInfo));
+
+        int device = -1;
+        while (snd_ctl_pcm_next_device(pCtl, &device) >= 0 && device >= 0) {
+            Info info;
+            info.hwDevice = QStringLiteral("hw:%1,%2").arg(card).arg(device);
+            info.name = cardName;
+            snd_pcm_info_t* pPcmInfo;
+            snd_pcm_info_alloca(&pPcmInfo);
+            snd_pcm_info_set_device(pPcmInfo, device);
+            snd_pcm_info_set_subdevice(pPcmInfo, 0);
+            for (const auto direction : {SND_PCM_STREAM_PLAYBACK, SND_PCM_STREAM_CAPTURE}) {
+                snd_pcm_info_set_stream(pPcmInfo, direction);
+                if (snd_ctl_pcm_info(pCtl, pPcmInfo) >= 0) {
+                    info.name = cardName + QStringLiteral(": ") +
+                            QString::fromUtf8(snd_pcm_info_get_name(pPcmInfo));
+                    break;
+                }
+            }
+
+            const QByteArray hwDevice = info.hwDevice.toLatin1();
+            const int outputChannels = queryChannelCount(
+                    hwDevice, SND_PCM_STREAM_PLAYBACK, &info.defaultSampleRate);
+            const int inputChannels = queryChannelCount(
+                    hwDevice, SND_PCM_STREAM_CAPTURE, &info.defaultSampleRate);
+            if (outputChannels == 0 && inputChannels == 0) {
+                qDebug() << "SoundDeviceAlsa: Skipping unavailable device" << info.hwDevice;
+                continue;
+            }
+            if (outputChannels > 0) {
+                info.numOutputChannels = mixxx::audio::ChannelCount::fromInt(outputChannels);
+            }
+            if (inputChannels > 0) {
+                info.numInputChannels = mixxx::audio::ChannelCount::fromInt(inputChannels);
+            }
+            devices.append(info);
+        }
+        snd_ctl_close(pCtl);
+    }
+    return devices;
+}
+
+SoundDeviceAlsa::SoundDeviceAlsa(UserSettingsPointer config,
+        SoundManager* sm,
+        const Info& info,
+        int devIndex)
+        : SoundDevice(config, sm),
+          m_defaultSampleRate(info.defaultSampleRate),
+          m_periodFrames(0),
+          m_isClkRefDevice(false),
+          m_isOpen(false),
+          m_denormals(false),
+          m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
+          m_framesSinceAudioLatencyUsageUpdate(0) {
+    // Setting parent class members:
+    m_hostAPI = MIXXX_ALSA_DIRECT_STRING;
+    m_sampleRate = getDefaultSampleRate();
+    // Like for the PortAudio ALSA devices, the name and the hw device are
+    // stored separately, see SoundManagerConfig::readFromDisk
+    m_deviceId.name = info.name;
+    m_deviceId.alsaHwDevice = info.hwDevice;
+    m_deviceId.portAudioIndex = devIndex;
+    m_strDisplayName = QStringLiteral("%1 (%2)").arg(info.name, info.hwDevice);
+    m_numOutputChannels = info.numOutputChannels;
+    m_numInputChannels = info.numInputChannels;
+}
+
+SoundDeviceAlsa::~SoundDeviceAlsa() {
+    close();
+}
+
+bool SoundDeviceAlsa::openStream(Stream* pStream,
+        snd_pcm_stream_t direction,
+        int channelCount,
+        snd_pcm_uframes_t* pPeriodFrames) {
+    const QByteArray hwDevice = m_deviceId.alsaHwDevice.toLatin1();
+    int err = snd_pcm_open(&pStream->pPcm, hwDevice.constData(), direction, 0);
+    if (err < 0) {
+        pStream->pPcm = nullptr;
+        m_lastError = QStringLiteral("Opening %1 failed: %2")
+                              .arg(m_deviceId.alsaHwDevice, errorText(err));
+        return false;
+    }
+    snd_pcm_t* pPcm = pStream->pPcm;
+
+    snd_pcm_hw_params_t* pHwParams;
+    snd_pcm_hw_params_alloca(&pHwParams);
+    snd_pcm_hw_params_any(pPcm, pHwParams);
+    err = snd_pcm_hw_params_set_access(pPcm, pHwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED);
+    if (err < 0) {
+        m_lastError = QStringLiteral("mmap access is not supported: %1").arg(errorText(err));
+        closeStream(pStream);
+        return false;
+    }
+
+    pStream->format = SND_PCM_FORMAT_UNKNOWN;
+    for (const auto format : kFormats) {
+        if (snd_pcm_hw_params_set_format(pPcm, pHwParams, format) == 0) {
+            pStream->format = format;
+            break;
+        }
+    }
+    if (pStream->format == SND_PCM_FORMAT_UNKNOWN) {
+        m_lastError = QStringLiteral("None of the supported sample formats is available");
+        closeStream(pStream);
+        return false;
+    }
+
+    // The hardware must run at the requested sample rate, resampling is
+    // left to the plugins that we want to bypass.
+    snd_pcm_hw_params_set_rate_resample(pPcm, pHwParams, 0);
+    err = snd_pcm_hw_params_set_rate(pPcm, pHwParams, m_sampleRate.value(), 0);
+    if (err < 0) {
+        m_lastError = QStringLiteral("The sample rate %1 Hz is not supported: %2")
+                              .arg(QString::number(m_sampleRate.value()), errorText(err));
+        closeStream(pStream);
+        return false;
+    }
+
+    // Devices may have a minimum number of channels, e.g. a mono output is
+    // opened in stereo.
+    unsigned int minChannels = 0;
+    snd_pcm_hw_params_get_channels_min(pHwParams, &minChannels);
+    pStream->channelCount = std::max(channelCount, static_cast<int>(minChannels));
+    err = snd_pcm_hw_params_set_channels(pPcm, pHwParams, pStream->channelCount);
+    if (err < 0) {
+        m_lastError = QStringLiteral("%1 channels are not supported: %2")
+                              .arg(QString::number(pStream->channelCount), errorText(err));
+        closeStream(pStream);
+        return false;
+    }
+
+    snd_pcm_uframes_t periodFrames = *pPeriodFrames;
+    snd_pcm_hw_params_set_period_size_near(pPcm, pHwParams, &periodFrames, nullptr);
+    unsigned int periods = kPeriods;
+    snd_pcm_hw_params_set_periods_near(pPcm, pHwParams, &periods, nullptr);
+    snd_pcm_hw_params_set_periods_integer(pPcm, pHwParams);
+    err = snd_pcm_hw_params(pPcm, pHwParams);
+    if (err < 0) {
+        m_lastError = QStringLiteral("Setting the hardware parameters failed: %1")
+                              .arg(errorText(err));
+        closeStream(pStream);
+        return false;
+    }
+    snd_pcm_hw_params_get_period_size(pHwParams, &periodFrames, nullptr);
+    *pPeriodFrames = periodFrames;
+
+    // Wake up once per period. The streams are started explicitly after
+    // the output has been filled.
+    snd_pcm_sw_params_t* pSwParams;
+    snd_pcm_sw_params_alloca(&pSwParams);
+    snd_pcm_sw_params_current(pPcm, pSwParams);
+    snd_pcm_uframes_t boundary = 0;
+    snd_pcm_sw_params_get_boundary(pSwParams, &boundary);
+    snd_pcm_sw_params_set_avail_min(pPcm, pSwParams, periodFrames);
+    snd_pcm_sw_params_set_start_threshold(pPcm, pSwParams, boundary);
+    err = snd_pcm_sw_params(pPcm, pSwParams);
+    if (err < 0) {
+        m_lastError = QStringLiteral("Setting the software parameters failed: %1")
+                              .arg(errorText(err));
+        closeStream(pStream);
+        return false;
+    }
+
+    if (pStream->format != SND_PCM_FORMAT_FLOAT) {
+        pStream->convertBuffer.assign(periodFrames * pStream->channelCount, 0);
+    }
+    qDebug() << "SoundDeviceAlsa: Opened" << m_deviceId.alsaHwDevice
+             << (direction == SND_PCM_STREAM_PLAYBACK ? "playback" : "capture")
+             << "with" << pStream->channelCount << "channels,"
+             << snd_pcm_format_name(pStream->format) << "samples,"
+             << periods << "periods of" << periodFrames << "frames";
+    return true;
+}
+
+void SoundDeviceAlsa::closeStream(Stream* pStream) {
+    if (pStream->pPcm) {
+        snd_pcm_drop(pStream->pPcm);
+        snd_pcm_close(pStream->pPcm);
+        pStream->pPcm = nullptr;
+    }
+    pStream->format = SND_PCM_FORMAT_UNKNOWN;
+    pStream->channelCount = 0;
+    pStream->convertBuffer.clear();
+}
+
+SoundDeviceStatus SoundDeviceAlsa::open(bool isClkRefDevice, int syncBuffers) {
+    Q_UNUSED(syncBuffers);
+    qDebug() << "SoundDeviceAlsa::open()" << m_deviceId;
+
+    if (m_audioOutputs.empty() && m_audioInputs.empty()) {
+        m_lastError = QStringLiteral(
+                "No inputs or outputs in SDA::open() "
+                "(THIS IS A BUG, this should be filtered by SM::setupDevices)");
+        return SoundDeviceStatus::Error;
+    }
+
+    int outputChannels = 0;
+    for (const auto& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup channelGroup = out.getChannelGroup();
+        outputChannels = std::max(outputChannels,
+                channelGroup.getChannelBase() + channelGroup.getChannelCount());
+    }
+    int inputChannels = 0;
+    for (const auto& in : std::as_const(m_audioInputs)) {
+        const ChannelGroup channelGroup = in.getChannelGroup();
+        inputChannels = std::max(inputChannels,
+                channelGroup.getChannelBase() + channelGroup.getChannelCount());
+    }
+
+    if (!m_sampleRate.isValid()) {
+        m_sampleRate = getDefaultSampleRate();
+    }
+
+    // Both streams run with the same period, so they can be processed
+    // together.
+    m_periodFrames = m_configFramesPerBuffer;
+    if (outputChannels > 0 &&
+            !openStream(&m_output, SND_PCM_STREAM_PLAYBACK, outputChannels, &m_periodFrames)) {
+        qWarning() << "SoundDeviceAlsa:" << m_lastError;
+        return SoundDeviceStatus::Error;
+    }
+    if (inputChannels > 0) {
+        const snd_pcm_uframes_t outputPeriodFrames = m_periodFrames;
+        if (!openStream(&m_input, SND_PCM_STREAM_CAPTURE, inputChannels, &m_periodFrames)) {
+            qWarning() << "SoundDeviceAlsa:" << m_lastError;
+            closeStream(&m_output);
+            return SoundDeviceStatus::Error;
+        }
+        if (m_output.pPcm && m_periodFrames != outputPeriodFrames) {
+            m_lastError = QStringLiteral(
+                    "The playback and capture periods differ: %1 and %2 frames")
+                                  .arg(outputPeriodFrames)
+                                  .arg(m_periodFrames);
+            qWarning() << "SoundDeviceAlsa:" << m_lastError;
+            closeStream(&m_input);
+            closeStream(&m_output);
+            return SoundDeviceStatus::Error;
+        }
+        if (m_output.pPcm && snd_pcm_link(m_output.pPcm, m_input.pPcm) < 0) {
+            // Both streams are still started together below
+            qDebug() << "SoundDeviceAlsa: Linking the streams failed";
+        }
+    }
+
+    m_isClkRefDevice = isClkRefDevice;
+    if (!isClkRefDevice) {
+        // Fed by the clock reference device
+        const int framesPerBuffer = static_cast<int>(m_configFramesPerBuffer);
+        if (m_output.pPcm) {
+            m_outputFifo = std::make_unique<FIFO<CSAMPLE>>(
+                    m_output.channelCount * framesPerBuffer * 2);
+        }
+        if (m_input.pPcm) {
+            m_inputFifo = std::make_unique<FIFO<CSAMPLE>>(
+                    m_input.channelCount * framesPerBuffer * 2);
+        }
+    }
+
+    const int err = startStreams();
+    if (err < 0) {
+        m_lastError = QStringLiteral("Starting the device failed: %1").arg(errorText(err));
+        qWarning() << "SoundDeviceAlsa:" << m_lastError;
+        close();
+        return SoundDeviceStatus::Error;
+    }
+
+    if (isClkRefDevice) {
+        // Update the samplerate and latency ControlObjects, which allow the
+        // waveform view to properly correct for the latency.
+        const double latencyMillis = 1000.0 * m_periodFrames * kPeriods / m_sampleRate.toDouble();
+        qDebug() << "SoundDeviceAlsa: Sample rate:" << m_sampleRate
+                 << "Hz, latency:" << latencyMillis << "ms";
+        ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("output_latency_ms")),
+                latencyMillis);
+        ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("samplerate")), m_sampleRate);
+        m_clkRefTimer.start();
+    }
+
+    m_isOpen.store(true, std::memory_order_release);
+    m_pThread = std::make_unique<SoundDeviceAlsaThread>(this);
+    m_pThread->start(QThread::TimeCriticalPriority);
+    return SoundDeviceStatus::Ok;
+}
+
+bool SoundDeviceAlsa::isOpen() const {
+    return m_isOpen.load(std::memory_order_acquire);
+}
+
+SoundDeviceStatus SoundDeviceAlsa::close() {
+    m_isOpen.store(false, std::memory_order_release);
+    if (m_pThread) {
+        m_pThread->stop();
+        m_pThread->wait();
+        m_pThread.reset();
+    }
+    if (m_output.pPcm && m_input.pPcm) {
+        snd_pcm_unlink(m_input.pPcm);
+    }
+    closeStream(&m_input);
+    closeStream(&m_output);
+    m_outputFifo.reset();
+    m_inputFifo.reset();
+    return SoundDeviceStatus::Ok;
+}
+
+QString SoundDeviceAlsa::getError() const {
+    return m_lastError;
+}
+
+void SoundDeviceAlsa::readProcess(SINT framesPerBuffer) {
+    if (!isOpen() || !m_inputFifo) {
+        return;
+    }
+    const int channelCount = m_input.channelCount;
+    const int inChunkSize = static_cast<int>(framesPerBuffer) * channelCount;
+    int readCount = inChunkSize;
+    const int readAvailable = m_inputFifo->readAvailable();
+    if (readCount > readAvailable) {
+        readCount = readAvailable;
+        m_pSoundManager->underflowHappened(23);
+    }
+    if (readCount > 0) {
+        CSAMPLE* dataPtr1;
+        ring_buffer_size_t size1;
+        CSAMPLE* dataPtr2;
+        ring_buffer_size_t size2;
+        // We use size1 and size2, so we can ignore the return value
+        (void)m_inputFifo->aquireReadRegions(readCount, &dataPtr1, &size1, &dataPtr2, &size2);
+        composeInputBuffer(dataPtr1, size1 / channelCount, 0, channelCount);
+        if (size2 > 0) {
+            composeInputBuffer(dataPtr2,
+                    size2 / channelCount,
+                    size1 / channelCount,
+                    channelCount);
+        }
+        m_inputFifo->releaseReadRegions(readCount);
+    }
+    if (readCount < inChunkSize) {
+        // Fill remaining buffers with zeros
+        clearInputBuffer(inChunkSize - readCount, readCount);
+    }
+    m_pSoundManager->pushInputBuffers(m_audioInputs, framesPerBuffer);
+}
+
+void SoundDeviceAlsa::writeProcess(SINT framesPerBuffer) {
+    if (!isOpen() || !m_outputFifo) {
+        return;
+    }
+    const int channelCount = m_output.channelCount;
+    const int outChunkSize = static_cast<int>(framesPerBuffer) * channelCount;
+    int writeCount = outChunkSize;
+    const int writeAvailable = m_outputFifo->writeAvailable();
+    if (writeCount > writeAvailable) {
+        writeCount = writeAvailable;
+        m_pSoundManager->underflowHappened(24);
+    }
+    if (writeCount > 0) {
+        CSAMPLE* dataPtr1;
+        ring_buffer_size_t size1;
+        CSAMPLE* dataPtr2;
+        ring_buffer_size_t size2;
+        // We use size1 and size2, so we can ignore the return value
+        (void)m_outputFifo->aquireWriteRegions(writeCount, &dataPtr1, &size1, &dataPtr2, &size2);
+        composeOutputBuffer(dataPtr1, size1 / channelCount, 0, channelCount);
+        if (size2 > 0) {
+            composeOutputBuffer(dataPtr2,
+                    size2 / channelCount,
+                    size1 / channelCount,
+                    channelCount);
+        }
+        m_outputFifo->releaseWriteRegions(writeCount);
+    }
+}
+
+snd_pcm_sframes_t SoundDeviceAlsa::processInput(snd_pcm_uframes_t frames) {
+    const snd_pcm_channel_area_t* pAreas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t mmapFrames = frames;
+    int err = snd_pcm_mmap_begin(m_input.pPcm, &pAreas, &offset, &mmapFrames);
+    if (err < 0) {
+        return err;
+    }
+    // The ring buffer consists of whole periods, which never wrap around
+    VERIFY_OR_DEBUG_ASSERT(mmapFrames == frames) {
+        snd_pcm_mmap_commit(m_input.pPcm, offset, 0);
+        return -EPIPE;
+    }
+
+    const int channelCount = m_input.channelCount;
+    const SINT numSamples = static_cast<SINT>(frames) * channelCount;
+    const void* pDeviceBuffer = interleavedBuffer(pAreas, offset);
+    const CSAMPLE* pBuffer;
+    if (m_input.format == SND_PCM_FORMAT_FLOAT) {
+        pBuffer = static_cast<const CSAMPLE*>(pDeviceBuffer);
+    } else {
+        convertFromDevice(m_input.convertBuffer.data(), pDeviceBuffer, m_input.format, numSamples);
+        pBuffer = m_input.convertBuffer.data();
+    }
+
+    if (m_isClkRefDevice) {
+        ScopedTimer t(QStringLiteral("SoundDeviceAlsa::callbackProcess input %1"),
+                m_deviceId.debugName());
+        composeInputBuffer(pBuffer, frames, 0, channelCount);
+        m_pSoundManager->pushInputBuffers(m_audioInputs, frames);
+    } else {
+        const int writeAvailable = m_inputFifo->writeAvailable();
+        if (writeAvailable < numSamples) {
+            // FIFO overflow
+            m_pSoundManager->underflowHappened(25);
+        }
+        m_inputFifo->write(pBuffer, std::min(writeAvailable, static_cast<int>(numSamples)));
+    }
+    return snd_pcm_mmap_commit(m_input.pPcm, offset, frames);
+}
+
+snd_pcm_sframes_t SoundDeviceAlsa::processOutput(snd_pcm_uframes_t frames) {
+    const snd_pcm_channel_area_t* pAreas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t mmapFrames = frames;
+    int err = snd_pcm_mmap_begin(m_output.pPcm, &pAreas, &offset, &mmapFrames);
+    if (err < 0) {
+        return err;
+    }
+    // The ring buffer consists of whole periods, which never wrap around
+    VERIFY_OR_DEBUG_ASSERT(mmapFrames == frames) {
+        snd_pcm_mmap_commit(m_output.pPcm, offset, 0);
+        return -EPIPE;
+    }
+
+    const int channelCount = m_output.channelCount;
+    const SINT numSamples = static_cast<SINT>(frames) * channelCount;
+    void* pDeviceBuffer = interleavedBuffer(pAreas, offset);
+    const bool zeroCopy = m_output.format == SND_PCM_FORMAT_FLOAT;
+    CSAMPLE* pBuffer = zeroCopy
+            ? static_cast<CSAMPLE*>(pDeviceBuffer)
+            : m_output.convertBuffer.data();
+
+    if (m_isClkRefDevice) {
+        ScopedTimer t(QStringLiteral("SoundDeviceAlsa::callbackProcess output %1"),
+                m_deviceId.debugName());
+        composeOutputBuffer(pBuffer, frames, 0, channelCount);
+    } else {
+        const int readCount = m_outputFifo->read(pBuffer, static_cast<int>(numSamples));
+        if (readCount < numSamples) {
+            // FIFO underflow
+            SampleUtil::clear(&pBuffer[readCount], numSamples - readCount);
+            m_pSoundManager->underflowHappened(26);
+        }
+    }
+
+    if (!zeroCopy) {
+        convertToDevice(pDeviceBuffer, pBuffer, m_output.format, numSamples);
+    }
+    return snd_pcm_mmap_commit(m_output.pPcm, offset, frames);
+}
+
+int SoundDeviceAlsa::startStreams() {
+    int err = 0;
+    if (m_output.pPcm && snd_pcm_state(m_output.pPcm) == SND_PCM_STATE_PREPARED) {
+        // Start with a buffer full of silence
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(m_output.pPcm);
+        while (avail > 0) {
+            const snd_pcm_channel_area_t* pAreas;
+            snd_pcm_uframes_t offset;
+            snd_pcm_uframes_t frames = avail;
+            err = snd_pcm_mmap_begin(m_output.pPcm, &pAreas, &offset, &frames);
+            if (err < 0) {
+                return err;
+            }
+            snd_pcm_areas_silence(pAreas, offset, m_output.channelCount, frames, m_output.format);
+            const snd_pcm_sframes_t committed = snd_pcm_mmap_commit(m_output.pPcm, offset, frames);
+            if (committed < 0) {
+                return static_cast<int>(committed);
+            }
+            avail -= committed;
+        }
+        // Also starts the linked input
+        err = snd_pcm_start(m_output.pPcm);
+        if (err < 0) {
+            return err;
+        }
+    }
+    if (m_input.pPcm && snd_pcm_state(m_input.pPcm) == SND_PCM_STATE_PREPARED) {
+        err = snd_pcm_start(m_input.pPcm);
+    }
+    return err;
+}
+
+bool SoundDeviceAlsa::recover(Stream* pStream, int err) {
+    m_pSoundManager->underflowHappened(27);
+    err = snd_pcm_recover(pStream->pPcm, err, 1);
+    if (err < 0) {
+        qWarning() << "SoundDeviceAlsa: Recovering" << m_deviceId.alsaHwDevice
+                   << "failed:" << errorText(err);
+        return false;
+    }
+    // Recovering prepares the stream (and a linked stream) again
+    err = startStreams();
+    if (err < 0) {
+        qWarning() << "SoundDeviceAlsa: Restarting" << m_deviceId.alsaHwDevice
+                   << "failed:" << errorText(err);
+        return false;
+    }
+    return true;
+}
+
+void SoundDeviceAlsa::threadProcess() {
+    Stream* pStream = m_output.pPcm ? &m_output : &m_input;
+    int err = snd_pcm_wait(pStream->pPcm, kWaitTimeoutMillis);
+    if (err == 0) {
+        // Timeout
+        return;
+    }
+    if (err < 0) {
+        if (!recover(pStream, err)) {
+            QThread::msleep(kWaitTimeoutMillis);
+        }
+        return;
+    }
+
+    // Process all complete periods, usually one
+    while (true) {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(pStream->pPcm);
+        if (avail >= 0 && m_output.pPcm && m_input.pPcm) {
+            const snd_pcm_sframes_t inputAvail = snd_pcm_avail_update(m_input.pPcm);
+            if (inputAvail < 0) {
+                recover(&m_input, static_cast<int>(inputAvail));
+                return;
+            }
+            avail = std::min(avail, inputAvail);
+        }
+        if (avail < 0) {
+            recover(pStream, static_cast<int>(avail));
+            return;
+        }
+        if (static_cast<snd_pcm_uframes_t>(avail) < m_periodFrames) {
+            return;
+        }
+
+        const SINT framesPerBuffer = static_cast<SINT>(m_periodFrames);
+        if (m_isClkRefDevice) {
+            // This must be the very first call, to measure an exact value
+            updateCallbackEntryToDacTime(framesPerBuffer);
+            Trace trace("SoundDeviceAlsa::callbackProcessClkRef %1", m_deviceId.debugName());
+            if (!m_denormals) {
+                m_denormals = true;
+                setupDenormals();
+            }
+            m_pSoundManager->processUnderflowHappened(framesPerBuffer);
+        }
+
+        // Input is processed first so that any ControlObject changes made in
+        // response to input are processed as soon as possible.
+        if (m_input.pPcm) {
+            const snd_pcm_sframes_t processed = processInput(m_periodFrames);
+            if (processed < 0) {
+                recover(&m_input, static_cast<int>(processed));
+                return;
+            }
+        }
+
+        if (m_isClkRefDevice) {
+            m_pSoundManager->readProcess(framesPerBuffer);
+            {
+                ScopedTimer t(QStringLiteral("SoundDeviceAlsa::callbackProcess prepare %1"),
+                        m_deviceId.debugName());
+                m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
+            }
+        }
+
+        if (m_output.pPcm) {
+            const snd_pcm_sframes_t processed = processOutput(m_periodFrames);
+            if (processed < 0) {
+                recover(&m_output, static_cast<int>(processed));
+                return;
+            }
+        }
+
+        if (m_isClkRefDevice) {
+            m_pSoundManager->writeProcess(framesPerBuffer);
+            updateAudioLatencyUsage(framesPerBuffer);
+        }
+    }
+}
+
+void SoundDeviceAlsa::setupDenormals() {
+    // This disables the denormals calculations, to avoid a
+    // performance penalty of ~20
+    // https://github.com/mixxxdj/mixxx/issues/7747
+#if defined(__SSE__)
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+
+#if defined(__aarch64__)
+    // Bit 24 of the Floating-point Control Register is the flush-to-zero
+    // mode control bit
+    int64_t savedFPCR;
+    asm volatile("mrs %[savedFPCR], FPCR"
+                 : [ savedFPCR ] "=r"(savedFPCR));
+    asm volatile("msr FPCR, %[src]"
+                 :
+                 : [ src ] "r"(savedFPCR | (1 << 24)));
+#endif
+
+    // verify if flush to zero or denormals to zero works
+    volatile double doubleMin = DBL_MIN; // the smallest normalized double
+    VERIFY_OR_DEBUG_ASSERT(doubleMin / 2 == 0.0) {
+        qWarning() << "SoundDeviceAlsa: Denormals to zero mode is not working. "
+                      "EQs and effects may suffer high CPU load";
+    }
+}
+
+void SoundDeviceAlsa::updateCallbackEntryToDacTime(SINT framesPerBuffer) {
+    m_clkRefTimer.start();
+    // The frames that are queued in front of the period that is filled now.
+    // Unlike the time stamps of some PortAudio host APIs, this is exact.
+    snd_pcm_sframes_t delayFrames = framesPerBuffer;
+    if (m_output.pPcm && snd_pcm_delay(m_output.pPcm, &delayFrames) < 0) {
+        delayFrames = framesPerBuffer;
+    }
+    const double callbackEntrytoDacSecs =
+            math_max(delayFrames / m_sampleRate.toDouble(), 0.0);
+    VisualPlayPosition::setCallbackEntryToDacSecs(callbackEntrytoDacSecs, m_clkRefTimer);
+}
+
+void SoundDeviceAlsa::updateAudioLatencyUsage(SINT framesPerBuffer) {
+    m_framesSinceAudioLatencyUsageUpdate += framesPerBuffer;
+    if (m_framesSinceAudioLatencyUsageUpdate > (m_sampleRate.toDouble() / kCpuUsageUpdateRate)) {
+        double secInAudioCb = m_timeInAudioCallback.toDoubleSeconds();
+        m_audioLatencyUsage.set(secInAudioCb /
+                (m_framesSinceAudioLatencyUsageUpdate / m_sampleRate.toDouble()));
+        m_timeInAudioCallback = mixxx::Duration::empty();
+        m_framesSinceAudioLatencyUsageUpdate = 0;
+    }
+    // measure time in Audio callback at the very last
+    const mixxx::Duration timeInCallback = m_clkRefTimer.elapsed();
+    m_timeInAudioCallback += timeInCallback;
+    m_pSoundManager->recordCallbackLoad(timeInCallback.toDoubleSeconds() *
+            m_sampleRate.toDouble() / framesPerBuffer);
+}
+
+void SoundDeviceAlsaThread::run() {
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::Audio);
+    if (!mixxx::ThreadPlacement::hasConfiguredPriority(mixxx::ThreadPlacement::Role::Audio)) {
+        struct sched_param spm = {0};
+        spm.sched_priority = kRealtimePriority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &spm)) {
+            qWarning() << "SoundDeviceAlsaThread: Failed bumping priority";
+        }
+    }
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        m_pParent->threadProcess();
+    }
+}
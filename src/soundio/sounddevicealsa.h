@@ -0,0 +1,131 @@
+#pragma once
+
+#include <alsa/asoundlib.h>
+
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "control/pollingcontrolproxy.h"
+#include "soundio/sounddevice.h"
+#include "soundio/soundmanagerconfig.h"
+#include "util/duration.h"
+#include "util/fifo.h"
+#include "util/performancetimer.h"
+
+class SoundManager;
+class SoundDeviceAlsaThread;
+
+/// A sound device that accesses an ALSA hardware device ("hw:X,Y") directly
+/// in mmap mode, bypassing the buffering and the polling threads of
+/// PortAudio.
+///
+/// The device runs its own real-time thread, which wakes up once per period.
+/// The audio is interleaved straight into the mmap area of the device if it
+/// accepts 32-bit float samples, or converted from a scratch buffer
+/// otherwise. As a secondary device it exchanges the audio with the clock
+/// reference device through FIFOs like the "Disabled (short delay)" mode of
+/// SoundDevicePortAudio.
+class SoundDeviceAlsa : public SoundDevice {
+  public:
+    struct Info {
+        /// The "hw:X,Y" device name
+        QString hwDevice;
+        /// The name of the card and of the PCM device
+        QString name;
+        mixxx::audio::ChannelCount numOutputChannels;
+        mixxx::audio::ChannelCount numInputChannels;
+        mixxx::audio::SampleRate defaultSampleRate;
+    };
+
+    /// Lists the hardware PCM devices of all sound cards.
+    static QList<Info> queryDevices();
+
+    SoundDeviceAlsa(UserSettingsPointer config,
+            SoundManager* sm,
+            const Info& info,
+            int devIndex);
+    ~SoundDeviceAlsa() override;
+
+    SoundDeviceStatus open(bool isClkRefDevice, int syncBuffers) override;
+    bool isOpen() const override;
+    SoundDeviceStatus close() override;
+    void readProcess(SINT framesPerBuffer) override;
+    void writeProcess(SINT framesPerBuffer) override;
+    QString getError() const override;
+
+    mixxx::audio::SampleRate getDefaultSampleRate() const override {
+        return m_defaultSampleRate.isValid()
+                ? m_defaultSampleRate
+                : SoundManagerConfig::kMixxxDefaultSampleRate;
+    }
+
+    /// Waits for the next period and processes it. Called in a loop by the
+    /// thread of the device.
+    void threadProcess();
+
+  private:
+    struct Stream {
+        snd_pcm_t* pPcm = nullptr;
+        snd_pcm_format_t format = SND_PCM_FORMAT_UNKNOWN;
+        int channelCount = 0;
+        // Used for devices that do not accept float samples
+        std::vector<CSAMPLE> convertBuffer;
+    };
+
+    bool openStream(Stream* pStream,
+            snd_pcm_stream_t direction,
+            int channelCount,
+            snd_pcm_uframes_t* pPeriodFrames);
+    void closeStream(Stream* pStream);
+    /// Fills the output with silence and starts the prepared streams.
+    /// Returns a negative ALSA error code on failure.
+    int startStreams();
+    bool recover(Stream* pStream, int err);
+    void setupDenormals();
+
+    // Return the number of frames or a negative ALSA error code
+    snd_pcm_sframes_t processInput(snd_pcm_uframes_t frames);
+    snd_pcm_sframes_t processOutput(snd_pcm_uframes_t frames);
+
+    void updateCallbackEntryToDacTime(SINT framesPerBuffer);
+    void updateAudioLatencyUsage(SINT framesPerBuffer);
+
+    const mixxx::audio::SampleRate m_defaultSampleRate;
+    Stream m_output;
+    Stream m_input;
+    snd_pcm_uframes_t m_periodFrames;
+    bool m_isClkRefDevice;
+    std::atomic<bool> m_isOpen;
+    std::unique_ptr<SoundDeviceAlsaThread> m_pThread;
+    std::unique_ptr<FIFO<CSAMPLE>> m_outputFifo;
+    std::unique_ptr<FIFO<CSAMPLE>> m_inputFifo;
+
+    QString m_lastError;
+    bool m_denormals;
+    PollingControlProxy m_audioLatencyUsage;
+    mixxx::Duration m_timeInAudioCallback;
+    int m_framesSinceAudioLatencyUsageUpdate;
+    PerformanceTimer m_clkRefTimer;
+};
+
+class SoundDeviceAlsaThread : public QThread {
+    Q_OBJECT
+  public:
+    SoundDeviceAlsaThread(SoundDeviceAlsa* pParent)
+            : m_pParent(pParent),
+              m_stop(false) {
+    }
+
+    void stop() {
+        m_stop.store(true, std::memory_order_relaxed);
+    }
+
+  private:
+    void run() override;
+
+    SoundDeviceAlsa* m_pParent;
+    std::atomic<bool> m_stop;
+};
@@ -15,6 +15,7 @@
 #include "soundio/sounddevice.h"
 #include "util/fifo.h"
 #include "util/performancetimer.h"
+#include "util/threadplacement.h"
 
 #define CPU_USAGE_UPDATE_RATE 30 // in 1/s, fits to display frame rate
 #define CPU_OVERLOAD_DURATION 500 // in ms
@@ -88,11 +89,16 @@ class SoundDeviceNetworkThread : public QThread {
 
   private:
     void run() override {
+        mixxx::ThreadPlacement::applyToCurrentThread(
+                mixxx::ThreadPlacement::Role::Audio);
 #ifdef __LINUX__
-        struct sched_param spm = { 0 };
-        spm.sched_priority = 1;
-        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &spm)) {
-            qWarning() << "SoundDeviceNetworkThread: Failed bumping priority";
+        if (!mixxx::ThreadPlacement::hasConfiguredPriority(
+                    mixxx::ThreadPlacement::Role::Audio)) {
+            struct sched_param spm = {0};
+            spm.sched_priority = 1;
+            if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &spm)) {
+                qWarning() << "SoundDeviceNetworkThread: Failed bumping priority";
+            }
         }
 #endif
 
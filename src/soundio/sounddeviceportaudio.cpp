@@ -8,6 +8,7 @@
 
 #include "control/controlobject.h"
 #include "sounddevicenetwork.h"
+#include "soundio/driftcompensator.h"
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
@@ -16,6 +17,8 @@
 #include "util/fifo.h"
 #include "util/math.h"
 #include "util/sample.h"
+#include "util/threadplacement.h"
+#include "util/time.h"
 #include "util/timer.h"
 #include "util/trace.h"
 #include "waveform/visualplayposition.h"
@@ -89,6 +92,8 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
           m_inputFifo(nullptr),
           m_outputDrift(false),
           m_inputDrift(false),
+          m_lastOutputFifoWriteNanos(0),
+          m_lastInputFifoReadNanos(0),
           m_bSetThreadPriority(false),
           m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
           m_framesSinceAudioLatencyUsageUpdate(0),
@@ -293,6 +298,12 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
             SampleUtil::clear(dataPtr1, size1);
             SampleUtil::clear(dataPtr2, size2);
             m_outputFifo->releaseWriteRegions(writeCount);
+            // The resampler keeps the FIFO at the prefilled 1.5 chunks
+            m_pOutputDriftCompensator = std::make_unique<DriftCompensator>(
+                    DriftCompensator::Direction::Output,
+                    m_outputParams.channelCount,
+                    framesPerBuffer,
+                    framesPerBuffer * kFifoSize / 2);
         }
         if (m_inputParams.channelCount > 0) {
             m_inputFifo = std::make_unique<FIFO<CSAMPLE>>(
@@ -309,6 +320,11 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
             SampleUtil::clear(dataPtr1, size1);
             SampleUtil::clear(dataPtr2, size2);
             m_inputFifo->releaseWriteRegions(writeCount);
+            m_pInputDriftCompensator = std::make_unique<DriftCompensator>(
+                    DriftCompensator::Direction::Input,
+                    m_inputParams.channelCount,
+                    framesPerBuffer,
+                    framesPerBuffer * kFifoSize / 2);
         }
     } else if (m_syncBuffers == 1) { // "Disabled (short delay)"
         // this can be used on a second device when it is driven by the Clock
@@ -445,6 +461,8 @@ SoundDeviceStatus SoundDevicePortAudio::close() {
 
     m_outputFifo.reset();
     m_inputFifo.reset();
+    m_pOutputDriftCompensator.reset();
+    m_pInputDriftCompensator.reset();
     m_bSetThreadPriority = false;
 
     return SoundDeviceStatus::Ok;
@@ -576,6 +594,11 @@ void SoundDevicePortAudio::readProcess(SINT framesPerBuffer) {
             }
             m_inputFifo->releaseReadRegions(readCount);
         }
+        if (m_pInputDriftCompensator) {
+            m_lastInputFifoReadNanos.store(
+                    mixxx::Time::elapsed().toIntegerNanos(),
+                    std::memory_order_relaxed);
+        }
         if (readCount < inChunkSize) {
             // Fill remaining buffers with zeros
             clearInputBuffer(inChunkSize - readCount, readCount);
@@ -616,6 +639,11 @@ void SoundDevicePortAudio::writeProcess(SINT framesPerBuffer) {
             }
             m_outputFifo->releaseWriteRegions(writeCount);
         }
+        if (m_pOutputDriftCompensator) {
+            m_lastOutputFifoWriteNanos.store(
+                    mixxx::Time::elapsed().toIntegerNanos(),
+                    std::memory_order_relaxed);
+        }
 
         if (m_syncBuffers == 0) { // "Experimental (no delay)"
             // Polling
@@ -710,119 +738,100 @@ int SoundDevicePortAudio::callbackProcessDrift(
     // Unfortunately this delay is somehow random, an WILL produce a delay slow
     // shift without we can avoid it. (That's the price for using a cheap USB soundcard).
     //
-    // Additional we need an filled chunk and an empty chunk. These are used when on
-    // sound card overtakes the other. This always happens, if they are driven form
-    // two crystals. In a test case every 30 s @ 23 ms. After they are consumed,
-    // the drift correction takes place and fills or clears the reserve buffers.
-    // If this is finished before another overtake happens, we do not face any
-    // dropouts or clicks.
-    // So that's why we need a Fifo of 3 chunks.
+    // The FIFO of 3 chunks is kept filled with 1.5 chunks, which leaves half
+    // a chunk for the jitter in both directions. It happens that one callback
+    // is delayed, in this case the second one fires two times and then the
+    // first one fires two time as well to catch up.
     //
-    // In addition there is a jitter effect. It happens that one callback is delayed,
-    // in this case the second one fires two times and then the first one fires two
-    // time as well to catch up. This is also fixed by the additional buffers. If this
-    // happens just after an regular overtake, we will have clicks again.
-    //
-    // I the tests it turns out that it only happens in the opposite direction, so
-    // 3 chunks are just fine.
+    // The drift is compensated by resampling the audio with a ratio slightly
+    // different from 1 that follows the fill level of the FIFO. Unlike
+    // skipping or duplicating single frames this does not produce clicks.
 
     if (m_inputParams.channelCount) {
-        int inChunkSize = framesPerBuffer * m_inputParams.channelCount;
-        int readAvailable = m_inputFifo->readAvailable();
-        int writeAvailable = m_inputFifo->writeAvailable();
-        if (readAvailable < inChunkSize * kDriftReserve) {
-            // risk of an underflow, duplicate one frame
-            m_inputFifo->write(in, inChunkSize);
-            if (m_inputDrift) {
-                // Do not compensate the first delay, because it is likely a jitter
-                // corrected in the next cycle
-                // Duplicate one frame
-                m_inputFifo->write(
-                        &in[inChunkSize - m_inputParams.channelCount],
-                        m_inputParams.channelCount);
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Skip";
-            } else {
-                m_inputDrift = true;
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Jitter Skip";
-            }
-        } else if (readAvailable == inChunkSize * kDriftReserve) {
-            // Everything Ok
-            m_inputFifo->write(in, inChunkSize);
-            m_inputDrift = false;
-            //qDebug() << "callbackProcess write:" << (float) readAvailable / inChunkSize << "Normal";
-        } else if (writeAvailable >= inChunkSize) {
-            // Risk of overflow, skip one frame
-            if (m_inputDrift) {
-                m_inputFifo->write(in, inChunkSize - m_inputParams.channelCount);
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Skip";
-            } else {
-                m_inputFifo->write(in, inChunkSize);
-                m_inputDrift = true;
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Jitter Skip";
-            }
-        } else if (writeAvailable) {
+        const int channelCount = m_inputParams.channelCount;
+        m_pInputDriftCompensator->updateRatio(
+                m_inputFifo->readAvailable() / channelCount,
+                framesPerBuffer,
+                clkRefPeriodFraction(m_lastInputFifoReadNanos, framesPerBuffer));
+        m_pInputDriftCompensator->addInput(in, framesPerBuffer);
+        SINT frames = m_pInputDriftCompensator->outputFramesAvailable();
+        const SINT writeAvailable = m_inputFifo->writeAvailable() / channelCount;
+        if (frames > writeAvailable) {
             // Fifo Overflow
-            m_inputFifo->write(in, writeAvailable);
+            frames = writeAvailable;
             m_pSoundManager->underflowHappened(8);
-            //qDebug() << "callbackProcessDrift write:" << (float) readAvailable / inChunkSize << "Overflow";
-        } else {
-            // Buffer full
-            m_pSoundManager->underflowHappened(9);
-            //qDebug() << "callbackProcessDrift write:" << (float) readAvailable / inChunkSize << "Buffer full";
+        }
+        if (frames > 0) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+            // We use size1 and size2, so we can ignore the return value
+            (void)m_inputFifo->aquireWriteRegions(frames * channelCount,
+                    &dataPtr1,
+                    &size1,
+                    &dataPtr2,
+                    &size2);
+            SINT written = m_pInputDriftCompensator->process(
+                    dataPtr1, size1 / channelCount);
+            if (size2 > 0) {
+                written += m_pInputDriftCompensator->process(
+                        dataPtr2, size2 / channelCount);
+            }
+            m_inputFifo->releaseWriteRegions(written * channelCount);
+        }
+        if (m_pInputDriftCompensator->outputFramesAvailable() > 0) {
+            // Drop what did not fit into the FIFO
+            m_pInputDriftCompensator->clearInput();
         }
     }
 
     if (m_outputParams.channelCount > 0) {
-        int outChunkSize = framesPerBuffer * m_outputParams.channelCount;
-        int readAvailable = m_outputFifo->readAvailable();
-
-        if (readAvailable > outChunkSize * (kDriftReserve + 1)) {
-            m_outputFifo->read(out, outChunkSize);
-            if (m_outputDrift) {
-                // Risk of overflow, skip one frame
-                m_outputFifo->releaseReadRegions(m_outputParams.channelCount);
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Skip";
-            } else {
-                m_outputDrift = true;
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Jitter Skip";
-            }
-        } else if (readAvailable == outChunkSize * (kDriftReserve + 1)) {
-            m_outputFifo->read(out, outChunkSize);
-            m_outputDrift = false;
-            //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Normal";
-        } else if (readAvailable >= outChunkSize) {
-            if (m_outputDrift) {
-                // Risk of underflow, duplicate one frame
-                m_outputFifo->read(out,
-                        outChunkSize - m_outputParams.channelCount);
-                SampleUtil::copy(
-                        &out[outChunkSize - m_outputParams.channelCount],
-                        &out[outChunkSize - (2 * m_outputParams.channelCount)],
-                        m_outputParams.channelCount);
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Save";
-            } else {
-                m_outputFifo->read(out, outChunkSize);
-                m_outputDrift = true;
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Jitter Save";
-            }
-        } else if (readAvailable) {
-            m_outputFifo->read(out,
-                    readAvailable);
+        const int channelCount = m_outputParams.channelCount;
+        const SINT readAvailable = m_outputFifo->readAvailable() / channelCount;
+        m_pOutputDriftCompensator->updateRatio(readAvailable,
+                framesPerBuffer,
+                clkRefPeriodFraction(m_lastOutputFifoWriteNanos, framesPerBuffer));
+        SINT readCount = m_pOutputDriftCompensator->inputFramesRequired(framesPerBuffer);
+        if (readCount > readAvailable) {
             // underflow
-            SampleUtil::clear(&out[readAvailable],
-                    outChunkSize - readAvailable);
+            readCount = readAvailable;
             m_pSoundManager->underflowHappened(10);
-            //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Underflow";
-        } else {
-            // underflow
-            SampleUtil::clear(out, outChunkSize);
-            m_pSoundManager->underflowHappened(11);
-            //qDebug() << "callbackProcess read:" << (float)readAvailable / outChunkSize << "Buffer empty";
+        }
+        if (readCount > 0) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+            // We use size1 and size2, so we can ignore the return value
+            (void)m_outputFifo->aquireReadRegions(readCount * channelCount,
+                    &dataPtr1,
+                    &size1,
+                    &dataPtr2,
+                    &size2);
+            m_pOutputDriftCompensator->addInput(dataPtr1, size1 / channelCount);
+            if (size2 > 0) {
+                m_pOutputDriftCompensator->addInput(dataPtr2, size2 / channelCount);
+            }
+            m_outputFifo->releaseReadRegions(readCount * channelCount);
+        }
+        const SINT frames = m_pOutputDriftCompensator->process(out, framesPerBuffer);
+        if (frames < framesPerBuffer) {
+            SampleUtil::clear(&out[frames * channelCount],
+                    (framesPerBuffer - frames) * channelCount);
         }
     }
     return paContinue;
 }
 
+double SoundDevicePortAudio::clkRefPeriodFraction(
+        const std::atomic<qint64>& accessNanos, SINT framesPerBuffer) const {
+    const qint64 sinceAccessNanos = mixxx::Time::elapsed().toIntegerNanos() -
+            accessNanos.load(std::memory_order_relaxed);
+    const double periodNanos = 1e9 * framesPerBuffer / m_sampleRate.toDouble();
+    return sinceAccessNanos / periodNanos;
+}
+
 int SoundDevicePortAudio::callbackProcess(const SINT framesPerBuffer,
         CSAMPLE *out, const CSAMPLE *in,
         const PaStreamCallbackTimeInfo *timeInfo,
@@ -888,6 +897,10 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     //qDebug() << "SoundDevicePortAudio::callbackProcess:" << m_deviceId;
 
     if (!m_bSetThreadPriority) {
+        // Only once per thread and without blocking calls to the system
+        // scheduler service, because we are already processing audio.
+        mixxx::ThreadPlacement::applyToCurrentThreadOnce(
+                mixxx::ThreadPlacement::Role::Audio);
 #ifdef __LINUX__
         // Verify if we are a thread with "real-time" policy.
         // The audio thread on Linux should be set to SCHED_FIFO with a priority
@@ -902,7 +915,10 @@ int SoundDevicePortAudio::callbackProcessClkRef(
         // If we are running in Linux this will have no effect. Either the thread is
         // already set up correctly because of the audio server, or it's still set to
         // the SCHED_OTHER policy in which case the call also wouldn't do anything.
-        QThread::currentThread()->setPriority(QThread::TimeCriticalPriority);
+        if (!mixxx::ThreadPlacement::hasConfiguredPriority(
+                    mixxx::ThreadPlacement::Role::Audio)) {
+            QThread::currentThread()->setPriority(QThread::TimeCriticalPriority);
+        }
 #endif
         m_bSetThreadPriority = true;
 
@@ -1104,5 +1120,8 @@ void SoundDevicePortAudio::updateAudioLatencyUsage(
         //          << m_audioLatencyUsage->get();
     }
     // measure time in Audio callback at the very last
-    m_timeInAudioCallback += m_clkRefTimer.elapsed();
+    const mixxx::Duration timeInCallback = m_clkRefTimer.elapsed();
+    m_timeInAudioCallback += timeInCallback;
+    m_pSoundManager->recordCallbackLoad(timeInCallback.toDoubleSeconds() *
+            m_sampleRate.toDouble() / framesPerBuffer);
 }
@@ -3,6 +3,7 @@
 #include <portaudio.h>
 
 #include <QString>
+#include <atomic>
 #include <memory>
 
 #include "control/pollingcontrolproxy.h"
@@ -12,6 +13,7 @@
 #include "util/fifo.h"
 #include "util/performancetimer.h"
 
+class DriftCompensator;
 class SoundManager;
 
 class SoundDevicePortAudio : public SoundDevice {
@@ -57,6 +59,8 @@ class SoundDevicePortAudio : public SoundDevice {
     void updateCallbackEntryToDacTime(
             SINT framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo);
     void updateAudioLatencyUsage(const SINT framesPerBuffer);
+    double clkRefPeriodFraction(
+            const std::atomic<qint64>& accessNanos, SINT framesPerBuffer) const;
 
     // PortAudio stream for this device.
     PaStream* volatile m_pStream;
@@ -72,6 +76,13 @@ class SoundDevicePortAudio : public SoundDevice {
     std::unique_ptr<FIFO<CSAMPLE>> m_inputFifo;
     bool m_outputDrift;
     bool m_inputDrift;
+    // Resamplers for the "Default (long delay)" mode
+    std::unique_ptr<DriftCompensator> m_pOutputDriftCompensator;
+    std::unique_ptr<DriftCompensator> m_pInputDriftCompensator;
+    // Time when the clock reference device has last written to
+    // m_outputFifo or read from m_inputFifo
+    std::atomic<qint64> m_lastOutputFifoWriteNanos;
+    std::atomic<qint64> m_lastInputFifoReadNanos;
 
     // A string describing the last PortAudio error to occur.
     QString m_lastError;
@@ -2,24 +2,36 @@
 
 #include <portaudio.h>
 
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
 #include <QLibrary>
 #include <QThread>
+#include <QtConcurrentRun>
 #include <QtGlobal>
+#include <atomic>
 #include <cstring> // for memcpy and strcmp
 
 #include "control/controlobject.h"
 #include "engine/enginemixer.h"
 #include "engine/sidechain/enginenetworkstream.h"
+#include "mixer/playerinfo.h"
 #include "moc_soundmanager.cpp"
 #include "soundio/sounddevice.h"
+#ifdef __ALSA__
+#include "soundio/sounddevicealsa.h"
+#endif
 #include "soundio/sounddevicenetwork.h"
 #include "soundio/sounddevicenotfound.h"
 #include "soundio/sounddeviceportaudio.h"
 #include "soundio/soundmanagerutil.h"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qatomic.h"
+#include "util/counter.h"
 #include "util/defs.h"
+#include "util/realtimeaudit.h"
 #include "util/sample.h"
+#include "util/statsmanager.h"
 #include "util/versionstore.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 
@@ -35,6 +47,47 @@ const QString kAppGroup = QStringLiteral("[App]");
 
 #define CPU_OVERLOAD_DURATION 500 // in ms
 
+// The evaluation window of the adaptive buffer size
+constexpr int kAdaptiveBufferSizeWindowMillis = 1000;
+constexpr unsigned int kMinAdaptiveBufferSizeIndex =
+        static_cast<unsigned int>(SoundManagerConfig::AudioBufferSizeIndex::Size1xms);
+
+// Underflows are checked at this interval, so each trace also contains up
+// to this time after the underflow.
+constexpr int kXrunTraceIntervalMillis = 1000;
+// The duration of the trace before it has been written
+constexpr qint64 kXrunTraceWindowNs = 5'000'000'000;
+// Limits the traces of consecutive underflows
+constexpr qint64 kMinXrunTraceDistanceNs = 30'000'000'000;
+// Older traces are deleted
+constexpr int kMaxXrunTraces = 20;
+
+const QString kXrunTraceDir = QStringLiteral("xrun-traces");
+
+void writeXrunTrace(const QString& dirPath,
+        const QString& fileName,
+        const std::vector<FlightRecorder::Event>& events) {
+    QDir dir(dirPath);
+    if (!dir.mkpath(QStringLiteral("."))) {
+        qWarning() << "Failed to create the directory for xrun traces" << dirPath;
+        return;
+    }
+    QFile file(dir.filePath(fileName));
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(FlightRecorder::instance().chromeTraceJson(events)) < 0) {
+        qWarning() << "Failed to write the xrun trace" << file.fileName()
+                   << file.errorString();
+        return;
+    }
+    qInfo() << "Wrote the trace of an audio buffer underflow to" << file.fileName();
+    // The file names are ordered by time
+    const QStringList traces = dir.entryList(
+            {QStringLiteral("xrun-*.json")}, QDir::Files, QDir::Name);
+    for (int i = 0; i < traces.size() - kMaxXrunTraces; ++i) {
+        dir.remove(traces[i]);
+    }
+}
+
 struct DeviceMode {
     SoundDevicePointer pDevice;
     bool isInput;
@@ -44,6 +97,46 @@ struct DeviceMode {
 #ifdef __LINUX__
 constexpr unsigned int kSleepSecondsAfterClosingDevice = 5;
 #endif
+
+// Set by SoundManager::preinitializePortAudio()
+std::atomic<bool> s_paPreinitialized = false;
+PaError s_paPreinitializeError = paNoError;
+
+#ifdef Q_OS_LINUX
+void setJACKName() {
+    typedef PaError (*SetJackClientName)(const char *name);
+    QLibrary portaudio("libportaudio.so.2");
+    if (portaudio.load()) {
+        SetJackClientName func(
+            reinterpret_cast<SetJackClientName>(
+                portaudio.resolve("PaJack_SetClientName")));
+        if (func) {
+            // PortAudio does not make a copy of the string we provide it so we
+            // need to make sure it will last forever so we intentionally leak
+            // this string.
+            char* jackNameCopy = strdup(VersionStore::applicationName().toLocal8Bit().constData());
+            if (!func(jackNameCopy)) {
+                qDebug() << "JACK client name set";
+            }
+        } else {
+            qWarning() << "failed to resolve JACK name method";
+        }
+    } else {
+        qWarning() << "failed to load portaudio for JACK rename";
+    }
+}
+#endif
+
+PaError initializePortAudio() {
+#ifdef Q_OS_LINUX
+    setJACKName();
+#endif
+#ifdef Q_OS_IOS
+    mixxx::initializeAVAudioSession();
+#endif
+    return Pa_Initialize();
+}
+
 } // anonymous namespace
 
 SoundManager::SoundManager(UserSettingsPointer pConfig,
@@ -55,6 +148,12 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
           m_pErrorDevice(nullptr),
           m_underflowHappened(0),
           m_underflowUpdateCount(0),
+          m_underflowCount(0),
+          m_lastUnderflowCount(0),
+          m_underflowName(FlightRecorder::instance().registerName(
+                  QStringLiteral("Audio buffer underflow"))),
+          m_lastTracedUnderflowCount(0),
+          m_lastXrunTraceNs(0),
           m_audioLatencyOverloadCount(kAppGroup, QStringLiteral("audio_latency_overload_count")),
           m_audioLatencyOverload(kAppGroup, QStringLiteral("audio_latency_overload")) {
     // TODO(xxx) some of these ControlObject are not needed by soundmanager, or are unused here.
@@ -71,6 +170,17 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
     m_samplerates.push_back(mixxx::audio::SampleRate(48000));
     m_samplerates.push_back(mixxx::audio::SampleRate(96000));
 
+    m_adaptiveBufferSizeTimer.setInterval(kAdaptiveBufferSizeWindowMillis);
+    connect(&m_adaptiveBufferSizeTimer,
+            &QTimer::timeout,
+            this,
+            &SoundManager::slotEvaluateAdaptiveBufferSize);
+    m_xrunTraceTimer.setInterval(kXrunTraceIntervalMillis);
+    connect(&m_xrunTraceTimer,
+            &QTimer::timeout,
+            this,
+            &SoundManager::slotWriteXrunTrace);
+
     m_pNetworkStream = QSharedPointer<EngineNetworkStream>(
             new EngineNetworkStream(2, 0));
 
@@ -141,6 +251,14 @@ QList<QString> SoundManager::getHostAPIList() const {
             apiList.push_back(api->name);
         }
     }
+#ifdef __ALSA__
+    for (const auto& pDevice : m_devices) {
+        if (pDevice->getHostAPI() == MIXXX_ALSA_DIRECT_STRING) {
+            apiList.push_back(MIXXX_ALSA_DIRECT_STRING);
+            break;
+        }
+    }
+#endif
 
     return apiList;
 }
@@ -237,6 +355,7 @@ QList<mixxx::audio::SampleRate> SoundManager::getSampleRates() const {
 void SoundManager::queryDevices() {
     //qDebug() << "SoundManager::queryDevices()";
     queryDevicesPortaudio();
+    queryDevicesAlsa();
     queryDevicesMixxx();
 
     // now tell the prefs that we updated the device list -- bkgood
@@ -252,13 +371,11 @@ void SoundManager::clearAndQueryDevices() {
 void SoundManager::queryDevicesPortaudio() {
     PaError err = paNoError;
     if (!m_paInitialized) {
-#ifdef Q_OS_LINUX
-        setJACKName();
-#endif
-#ifdef Q_OS_IOS
-        mixxx::initializeAVAudioSession();
-#endif
-        err = Pa_Initialize();
+        if (s_paPreinitialized.exchange(false, std::memory_order_acquire)) {
+            err = s_paPreinitializeError;
+        } else {
+            err = initializePortAudio();
+        }
         m_paInitialized = true;
     }
     if (err != paNoError) {
@@ -315,6 +432,17 @@ void SoundManager::queryDevicesPortaudio() {
     }
 }
 
+void SoundManager::queryDevicesAlsa() {
+#ifdef __ALSA__
+    const QList<SoundDeviceAlsa::Info> devices = SoundDeviceAlsa::queryDevices();
+    for (int i = 0; i < devices.size(); i++) {
+        auto currentDevice = SoundDevicePointer(new SoundDeviceAlsa(
+                m_pConfig, this, devices.at(i), i));
+        m_devices.push_back(currentDevice);
+    }
+#endif
+}
+
 void SoundManager::queryDevicesMixxx() {
     auto currentDevice = SoundDevicePointer(new SoundDeviceNetwork(
             m_pConfig, this, m_pNetworkStream));
@@ -326,6 +454,8 @@ SoundDeviceStatus SoundManager::setupDevices() {
     // pushBuffer and onDeviceOutputCallback until closeDevices() below.
 
     qDebug() << "SoundManager::setupDevices()";
+    m_adaptiveBufferSizeTimer.stop();
+    m_xrunTraceTimer.stop();
     m_pControlObjectSoundStatusCO->set(SOUNDMANAGER_CONNECTING);
     SoundDeviceStatus status = SoundDeviceStatus::Ok;
     // NOTE(rryan): Do not clear m_pClkRefDevice here. If we didn't touch the
@@ -504,6 +634,16 @@ SoundDeviceStatus SoundManager::setupDevices() {
 
     // returns OK if we were able to open all the devices the user wanted
     if (devicesNotFound.isEmpty()) {
+        // JACK decides about the buffer size and the network clock does not
+        // depend on it.
+        if (m_config.getAdaptiveBufferSize() && !jackApiUsed() && pNewMainClockRef &&
+                pNewMainClockRef->getDeviceId().name != kNetworkDeviceInternalName) {
+            m_adaptiveBufferSize.restart();
+            m_lastUnderflowCount = atomicLoadRelaxed(m_underflowCount);
+            m_adaptiveBufferSizeTimer.start();
+        }
+        m_lastTracedUnderflowCount = atomicLoadRelaxed(m_underflowCount);
+        m_xrunTraceTimer.start();
         emit devicesSetup();
         return SoundDeviceStatus::Ok;
     }
@@ -577,6 +717,86 @@ SoundDeviceStatus SoundManager::setConfig(const SoundManagerConfig& config) {
     return status;
 }
 
+SoundDeviceStatus SoundManager::changeAudioBufferSize(unsigned int sizeIndex) {
+    const unsigned int previousSizeIndex = m_config.getAudioBufferSizeIndex();
+    m_config.setAudioBufferSizeIndex(sizeIndex);
+    // Only the buffer size changes, so the devices are reopened at once to
+    // keep the gap in the output short.
+    const bool sleepAfterClosing = false;
+    closeDevices(sleepAfterClosing);
+    SoundDeviceStatus status = setupDevices();
+    if (status != SoundDeviceStatus::Ok) {
+        qWarning() << "Failed to change the audio buffer size, reverting to"
+                   << "the previous size";
+        m_config.setAudioBufferSizeIndex(previousSizeIndex);
+        closeDevices(sleepAfterClosing);
+        status = setupDevices();
+    }
+    return status;
+}
+
+void SoundManager::slotEvaluateAdaptiveBufferSize() {
+    const int underflowCount = atomicLoadRelaxed(m_underflowCount);
+    const bool xrunHappened = underflowCount != m_lastUnderflowCount;
+    m_lastUnderflowCount = underflowCount;
+
+    const unsigned int sizeIndex = m_config.getAudioBufferSizeIndex();
+    // Reopening the devices interrupts the output, so the buffer is only made
+    // smaller while no deck is playing. Making it larger can not wait,
+    // because the output is already glitching.
+    const bool canStepDown = sizeIndex > kMinAdaptiveBufferSizeIndex &&
+            PlayerInfo::instance().getCurrentPlayingDeck() < 0;
+    const auto decision = m_adaptiveBufferSize.evaluate(xrunHappened, canStepDown);
+    unsigned int newSizeIndex = sizeIndex;
+    switch (decision) {
+    case AdaptiveBufferSizeController::Decision::StepDown:
+        newSizeIndex = sizeIndex - 1;
+        break;
+    case AdaptiveBufferSizeController::Decision::StepUp:
+        if (sizeIndex < SoundManagerConfig::kMaxAudioBufferSizeIndex) {
+            newSizeIndex = sizeIndex + 1;
+        }
+        break;
+    case AdaptiveBufferSizeController::Decision::Keep:
+        break;
+    }
+    if (newSizeIndex == sizeIndex) {
+        return;
+    }
+    qInfo() << "Adaptive buffer size: changing the buffer size index from"
+            << sizeIndex << "to" << newSizeIndex << "at a callback load of"
+            << m_adaptiveBufferSize.lastLoadPercentile()
+            << (xrunHappened ? "after an xrun" : "");
+    changeAudioBufferSize(newSizeIndex);
+}
+
+void SoundManager::slotWriteXrunTrace() {
+    const int underflowCount = atomicLoadRelaxed(m_underflowCount);
+    if (underflowCount == m_lastTracedUnderflowCount || !m_pConfig) {
+        return;
+    }
+    const qint64 nowNs = FlightRecorder::nowNs();
+    if (m_lastXrunTraceNs != 0 && nowNs - m_lastXrunTraceNs < kMinXrunTraceDistanceNs) {
+        // Try again later, the next trace contains the recent underflows
+        return;
+    }
+    m_lastTracedUnderflowCount = underflowCount;
+    m_lastXrunTraceNs = nowNs;
+    // Copying the events is fast, formatting and writing them is done
+    // in the background
+    std::vector<FlightRecorder::Event> events =
+            FlightRecorder::instance().snapshot(nowNs - kXrunTraceWindowNs);
+    const QString dirPath = QDir(m_pConfig->getSettingsPath()).filePath(kXrunTraceDir);
+    const QString fileName = QStringLiteral("xrun-") +
+            QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss")) +
+            QStringLiteral(".json");
+    // Nobody waits for the result
+    const auto future = QtConcurrent::run([dirPath, fileName, events = std::move(events)] {
+        writeXrunTrace(dirPath, fileName, events);
+    });
+    Q_UNUSED(future);
+}
+
 void SoundManager::checkConfig() {
     if (!m_config.checkAPI()) {
         m_config.setAPI(SoundManagerConfig::kDefaultAPI);
@@ -594,6 +814,7 @@ void SoundManager::checkConfig() {
 }
 
 void SoundManager::onDeviceOutputCallback(const SINT iFramesPerBuffer) {
+    const mixxx::realtimeaudit::CallbackScope realtimeAuditScope;
     // Produce a block of samples for output. EngineMixer expects stereo
     // samples so multiply iFramesPerBuffer by 2.
     m_pEngineMixer->process(iFramesPerBuffer * 2);
@@ -653,29 +874,11 @@ QList<AudioInput> SoundManager::registeredInputs() const {
     return m_registeredDestinations.keys();
 }
 
-void SoundManager::setJACKName() const {
-#ifdef Q_OS_LINUX
-    typedef PaError (*SetJackClientName)(const char *name);
-    QLibrary portaudio("libportaudio.so.2");
-    if (portaudio.load()) {
-        SetJackClientName func(
-            reinterpret_cast<SetJackClientName>(
-                portaudio.resolve("PaJack_SetClientName")));
-        if (func) {
-            // PortAudio does not make a copy of the string we provide it so we
-            // need to make sure it will last forever so we intentionally leak
-            // this string.
-            char* jackNameCopy = strdup(VersionStore::applicationName().toLocal8Bit().constData());
-            if (!func(jackNameCopy)) {
-                qDebug() << "JACK client name set";
-            }
-        } else {
-            qWarning() << "failed to resolve JACK name method";
-        }
-    } else {
-        qWarning() << "failed to load portaudio for JACK rename";
-    }
-#endif
+// static
+void SoundManager::preinitializePortAudio() {
+    DEBUG_ASSERT(!s_paPreinitialized.load(std::memory_order_relaxed));
+    s_paPreinitializeError = initializePortAudio();
+    s_paPreinitialized.store(true, std::memory_order_release);
 }
 
 void SoundManager::setConfiguredDeckCount(int count) {
@@ -698,6 +901,7 @@ void SoundManager::processUnderflowHappened(SINT framesPerBuffer) {
             m_audioLatencyOverload.set(1.0);
             m_audioLatencyOverloadCount.set(
                     m_audioLatencyOverloadCount.get() + 1);
+            Counter(StatsManager::kAudioOverloadTag).increment();
             m_underflowUpdateCount = CPU_OVERLOAD_DURATION *
                     m_config.getSampleRate() / framesPerBuffer / 1000;
 
@@ -5,14 +5,17 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <QTimer>
 
 #include "audio/types.h"
 #include "control/pollingcontrolproxy.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "preferences/usersettings.h"
+#include "soundio/adaptivebuffersizecontroller.h"
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanagerconfig.h"
 #include "util/cmdlineargs.h"
+#include "util/flightrecorder.h"
 #include "util/types.h"
 
 class EngineMixer;
@@ -28,6 +31,8 @@ class ControlObject;
 // (https://github.com/PortAudio/portaudio/pull/881), we may have to update this
 #define MIXXX_PORTAUDIO_IOSAUDIO_STRING "iOS Audio"
 #define MIXXX_PORTAUDIO_COREAUDIO_STRING "Core Audio"
+// The ALSA hardware devices accessed by SoundDeviceAlsa, bypassing PortAudio
+#define MIXXX_ALSA_DIRECT_STRING "ALSA (direct)"
 
 #define SOUNDMANAGER_DISCONNECTED 0
 #define SOUNDMANAGER_CONNECTING 1
@@ -40,6 +45,11 @@ class SoundManager : public QObject {
     SoundManager(UserSettingsPointer pConfig, EngineMixer* pEngineMixer);
     ~SoundManager() override;
 
+    // Initializes PortAudio in advance, which makes the host APIs query their
+    // devices and takes long. May be called from any thread, but must have
+    // returned before the SoundManager is created, which takes over.
+    static void preinitializePortAudio();
+
     // Returns a list of all devices we've enumerated that match the provided
     // filterApi, and have at least one output or input channel if the
     // bOutputDevices or bInputDevices are set, respectively.
@@ -50,6 +60,7 @@ class SoundManager : public QObject {
     void clearAndQueryDevices();
     void queryDevices();
     void queryDevicesPortaudio();
+    void queryDevicesAlsa();
     void queryDevicesMixxx();
 
     // Opens all the devices chosen by the user in the preferences dialog, and
@@ -97,6 +108,8 @@ class SoundManager : public QObject {
 
     void underflowHappened(int code) {
         m_underflowHappened = 1;
+        m_underflowCount.fetchAndAddRelaxed(1);
+        FlightRecorder::instance().recordInstant(m_underflowName, code);
         // Disable the engine warnings by default, because printing a warning is a
         // locking function that will make the problem worse
         if (CmdlineArgs::Instance().getDeveloper()) {
@@ -106,13 +119,29 @@ class SoundManager : public QObject {
 
     void processUnderflowHappened(SINT framesPerBuffer);
 
+    /// Reports the time spent in an audio callback relative to the duration
+    /// of its buffer for the adaptive buffer size. Real-time safe.
+    void recordCallbackLoad(double load) {
+        m_adaptiveBufferSize.recordCallbackLoad(load);
+    }
+
   signals:
     void devicesUpdated(); // emitted when pointers to SoundDevices go stale
     void devicesSetup(); // emitted when the sound devices have been set up
     void outputRegistered(const AudioOutput& output, AudioSource* src);
     void inputRegistered(const AudioInput& input, AudioDestination* dest);
 
+  private slots:
+    void slotEvaluateAdaptiveBufferSize();
+    // Writes the events of the FlightRecorder before the last underflow
+    // into a trace file
+    void slotWriteXrunTrace();
+
   private:
+    // Reopens the devices with a different buffer size, without the pause
+    // of setConfig(). Reverts to the previous size if this fails.
+    SoundDeviceStatus changeAudioBufferSize(unsigned int sizeIndex);
+
     // Closes all the devices and empties the list of devices we have.
     void clearDeviceList(bool sleepAfterClosing);
 
@@ -122,7 +151,6 @@ class SoundManager : public QObject {
     // isn't open is safe.
     void closeDevices(bool sleepAfterClosing);
 
-    void setJACKName() const;
     bool jackApiUsed() const {
         return m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING;
     }
@@ -146,6 +174,14 @@ class SoundManager : public QObject {
 
     QAtomicInt m_underflowHappened;
     int m_underflowUpdateCount;
+    QAtomicInt m_underflowCount;
+    int m_lastUnderflowCount;
+    AdaptiveBufferSizeController m_adaptiveBufferSize;
+    QTimer m_adaptiveBufferSizeTimer;
+    const FlightRecorder::NameId m_underflowName;
+    QTimer m_xrunTraceTimer;
+    int m_lastTracedUnderflowCount;
+    qint64 m_lastXrunTraceNs;
     PollingControlProxy m_audioLatencyOverloadCount;
     PollingControlProxy m_audioLatencyOverload;
 };
@@ -23,6 +23,7 @@ const QString xmlAttributeSampleRate = "samplerate";
 const QString xmlAttributeBufferSize = "latency";
 const QString xmlAttributeSyncBuffers = "sync_buffers";
 const QString xmlAttributeForceNetworkClock = "force_network_clock";
+const QString xmlAttributeAdaptiveBufferSize = "adaptive_buffer_size";
 const QString xmlAttributeDeckCount = "deck_count";
 
 const QString xmlElementSoundDevice = "SoundDevice";
@@ -43,6 +44,7 @@ SoundManagerConfig::SoundManagerConfig(SoundManager* pSoundManager)
       m_audioBufferSizeIndex(kDefaultAudioBufferSizeIndex),
       m_syncBuffers(2),
       m_forceNetworkClock(false),
+      m_adaptiveBufferSize(false),
       m_iNumMicInputs(0),
       m_bExternalRecordBroadcastConnected(false),
       m_pSoundManager(pSoundManager) {
@@ -75,6 +77,8 @@ bool SoundManagerConfig::readFromDisk() {
     setSyncBuffers(rootElement.attribute(xmlAttributeSyncBuffers, "2").toUInt());
     setForceNetworkClock(rootElement.attribute(xmlAttributeForceNetworkClock,
             "0").toUInt() != 0);
+    setAdaptiveBufferSize(rootElement.attribute(xmlAttributeAdaptiveBufferSize,
+            "0").toUInt() != 0);
     setDeckCount(rootElement.attribute(xmlAttributeDeckCount,
                                     QString::number(kDefaultDeckCount))
                          .toUInt());
@@ -228,6 +232,7 @@ bool SoundManagerConfig::writeToDisk() const {
     docElement.setAttribute(xmlAttributeBufferSize, m_audioBufferSizeIndex);
     docElement.setAttribute(xmlAttributeSyncBuffers, m_syncBuffers);
     docElement.setAttribute(xmlAttributeForceNetworkClock, m_forceNetworkClock);
+    docElement.setAttribute(xmlAttributeAdaptiveBufferSize, m_adaptiveBufferSize);
     docElement.setAttribute(xmlAttributeDeckCount, m_deckCount);
     doc.appendChild(docElement);
 
@@ -236,7 +241,7 @@ bool SoundManagerConfig::writeToDisk() const {
         QDomElement devElement(doc.createElement(xmlElementSoundDevice));
         devElement.setAttribute(xmlAttributeDeviceName, deviceId.name);
         devElement.setAttribute(xmlAttributePortAudioIndex, deviceId.portAudioIndex);
-        if (m_api == MIXXX_PORTAUDIO_ALSA_STRING) {
+        if (m_api == MIXXX_PORTAUDIO_ALSA_STRING || m_api == MIXXX_ALSA_DIRECT_STRING) {
             devElement.setAttribute(xmlAttributeAlsaHwDevice, deviceId.alsaHwDevice);
         }
 
@@ -319,6 +324,14 @@ void SoundManagerConfig::setForceNetworkClock(bool force) {
     m_forceNetworkClock = force;
 }
 
+bool SoundManagerConfig::getAdaptiveBufferSize() const {
+    return m_adaptiveBufferSize;
+}
+
+void SoundManagerConfig::setAdaptiveBufferSize(bool adaptive) {
+    m_adaptiveBufferSize = adaptive;
+}
+
 /**
  * Checks that the sample rate in the object is valid according to the list of
  * sample rates given by SoundManager.
@@ -541,6 +554,7 @@ void SoundManagerConfig::loadDefaults(SoundManager* soundManager, unsigned int f
 
     m_syncBuffers = kDefaultSyncBuffers;
     m_forceNetworkClock = false;
+    m_adaptiveBufferSize = false;
 }
 
 QSet<SoundDeviceId> SoundManagerConfig::getDevices() const {
@@ -86,6 +86,10 @@ class SoundManagerConfig {
     void setSyncBuffers(unsigned int syncBuffers);
     bool getForceNetworkClock() const;
     void setForceNetworkClock(bool force);
+    /// In the adaptive mode the buffer size is stepped up and down at
+    /// runtime, starting with the configured size.
+    bool getAdaptiveBufferSize() const;
+    void setAdaptiveBufferSize(bool adaptive);
     void addOutput(const SoundDeviceId& device, const AudioOutput& out);
     void addInput(const SoundDeviceId& device, const AudioInput& in);
     QMultiHash<SoundDeviceId, AudioOutput> getOutputs() const;
@@ -110,6 +114,7 @@ class SoundManagerConfig {
     unsigned int m_audioBufferSizeIndex;
     unsigned int m_syncBuffers;
     bool m_forceNetworkClock;
+    bool m_adaptiveBufferSize;
     QMultiHash<SoundDeviceId, AudioOutput> m_outputs;
     QMultiHash<SoundDeviceId, AudioInput> m_inputs;
     int m_iNumMicInputs;
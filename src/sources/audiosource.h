@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "audio/streaminfo.h"
@@ -302,6 +303,26 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     ReadableSampleFrames readSampleFrames(
             const WritableSampleFrames& sampleFrames);
 
+    /// A bit mask of stereo channel pairs, e.g. the stems of a stem file.
+    typedef std::uint32_t ChannelPairs;
+    static constexpr ChannelPairs kAllChannelPairs = ~ChannelPairs{0} >> 1;
+    /// Only the premixed stereo signal, decoded into the first channel
+    /// pair while all other channel pairs are silent.
+    static constexpr ChannelPairs kPremixedChannelPairs = ChannelPairs{1} << 31;
+
+    /// Selects the stereo channel pairs that are decoded by subsequent
+    /// reads. The samples of all other channel pairs are silent. Returns
+    /// the channel pairs that will actually be decoded, which might be
+    /// more than requested.
+    ///
+    /// Only sources with multiple independently encoded channel pairs
+    /// are able to skip decoding, all other sources always decode all
+    /// channels.
+    virtual ChannelPairs selectChannelPairs(ChannelPairs channelPairs) {
+        Q_UNUSED(channelPairs);
+        return kAllChannelPairs;
+    }
+
   protected:
     explicit AudioSource(const QUrl& url);
 
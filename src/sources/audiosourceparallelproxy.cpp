@@ -0,0 +1,230 @@
+#include "sources/audiosourceparallelproxy.h"
+
+#include <algorithm>
+
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("AudioSourceParallelProxy");
+
+} // anonymous namespace
+
+AudioSourceParallelProxy::AudioSourceParallelProxy(
+        AudioSourcePointer pAudioSource,
+        OpenDecoderFn openDecoder,
+        int numHelperThreads)
+        : AudioSourceProxy(std::move(pAudioSource)),
+          m_openDecoder(std::move(openDecoder)),
+          m_segmentCount((frameLength() + kSegmentFrameCount - 1) / kSegmentFrameCount),
+          m_firstSegmentIndex(0),
+          m_nextSegmentIndex(0),
+          m_numActiveHelpers(0),
+          m_stopping(false) {
+    DEBUG_ASSERT(m_openDecoder);
+    DEBUG_ASSERT(numHelperThreads > 0);
+    // More helpers than segments would never get any work
+    const int numHelpers = static_cast<int>(std::min(
+            static_cast<SINT>(numHelperThreads), m_segmentCount));
+    if (numHelpers <= 0) {
+        return;
+    }
+    m_slots.resize(numHelpers * kSegmentsPerHelperThread);
+    for (auto& slot : m_slots) {
+        slot.sampleBuffer = SampleBuffer(
+                getSignalInfo().frames2samples(kSegmentFrameCount));
+    }
+    m_numActiveHelpers = numHelpers;
+    const auto priority = QThread::currentThread()->priority();
+    for (int i = 0; i < numHelpers; ++i) {
+        m_helperThreads.emplace_back(QThread::create([this] {
+            runHelper();
+        }));
+        m_helperThreads.back()->setObjectName(
+                QStringLiteral("AudioSourceParallelProxy %1").arg(i + 1));
+        m_helperThreads.back()->start(priority);
+    }
+}
+
+AudioSourceParallelProxy::~AudioSourceParallelProxy() {
+    stopHelpers();
+}
+
+void AudioSourceParallelProxy::close() {
+    stopHelpers();
+    AudioSourceProxy::close();
+}
+
+void AudioSourceParallelProxy::stopHelpers() {
+    {
+        const std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cond.notify_all();
+    for (const auto& pThread : m_helperThreads) {
+        pThread->wait();
+    }
+    m_helperThreads.clear();
+}
+
+IndexRange AudioSourceParallelProxy::segmentFrameIndexRange(
+        SINT segmentIndex) const {
+    const SINT start = frameIndexMin() + segmentIndex * kSegmentFrameCount;
+    return IndexRange::between(
+            start,
+            std::min(start + kSegmentFrameCount, frameIndexMax()));
+}
+
+void AudioSourceParallelProxy::runHelper() {
+    // The decoders are opened concurrently
+    AudioSourcePointer pDecoder = m_openDecoder();
+    if (pDecoder &&
+            (pDecoder->getSignalInfo() != getSignalInfo() ||
+                    pDecoder->frameIndexRange() != frameIndexRange())) {
+        kLogger.warning()
+                << "Decoder doesn't match the original audio source:"
+                << pDecoder->getSignalInfo()
+                << pDecoder->frameIndexRange();
+        pDecoder->close();
+        pDecoder.reset();
+    }
+    std::unique_lock lock(m_mutex);
+    while (pDecoder && !m_stopping) {
+        // Segments that the reader has skipped are not decoded
+        m_nextSegmentIndex = std::max(m_nextSegmentIndex, m_firstSegmentIndex);
+        if (m_nextSegmentIndex >= m_segmentCount) {
+            break; // finished
+        }
+        const SINT segmentIndex = m_nextSegmentIndex;
+        Slot& slot = slotOf(segmentIndex);
+        if (segmentIndex >= m_firstSegmentIndex + static_cast<SINT>(m_slots.size()) ||
+                slot.state == SlotState::Decoding) {
+            // Wait until the reader has consumed a segment
+            m_cond.wait(lock);
+            continue;
+        }
+        ++m_nextSegmentIndex;
+        slot.segmentIndex = segmentIndex;
+        slot.state = SlotState::Decoding;
+        lock.unlock();
+        const auto segmentRange = segmentFrameIndexRange(segmentIndex);
+        const auto decodedFrames = pDecoder->readSampleFrames(
+                WritableSampleFrames(
+                        segmentRange,
+                        SampleBuffer::WritableSlice(
+                                slot.sampleBuffer.data(),
+                                getSignalInfo().frames2samples(segmentRange.length()))));
+        const bool decoded = decodedFrames.frameIndexRange() == segmentRange;
+        if (!decoded) {
+            kLogger.warning()
+                    << "Failed to decode segment"
+                    << segmentRange
+                    << "- decoded"
+                    << decodedFrames.frameIndexRange();
+        }
+        lock.lock();
+        slot.state = decoded ? SlotState::Decoded : SlotState::Failed;
+        m_cond.notify_all();
+    }
+    --m_numActiveHelpers;
+    lock.unlock();
+    m_cond.notify_all();
+    if (pDecoder) {
+        pDecoder->close();
+    }
+}
+
+const AudioSourceParallelProxy::Slot* AudioSourceParallelProxy::awaitSegment(
+        SINT segmentIndex) {
+    if (m_slots.empty()) {
+        return nullptr;
+    }
+    std::unique_lock lock(m_mutex);
+    if (segmentIndex < m_firstSegmentIndex) {
+        // The segment has already been consumed before a backward jump
+        return nullptr;
+    }
+    if (segmentIndex > m_firstSegmentIndex) {
+        // The preceding segments have been consumed or skipped
+        m_firstSegmentIndex = segmentIndex;
+        m_cond.notify_all();
+    }
+    const Slot& slot = slotOf(segmentIndex);
+    m_cond.wait(lock, [this, &slot, segmentIndex] {
+        if (slot.segmentIndex == segmentIndex &&
+                (slot.state == SlotState::Decoded ||
+                        slot.state == SlotState::Failed)) {
+            return true;
+        }
+        // Nobody is left for decoding the segment
+        return m_numActiveHelpers <= 0 || m_stopping;
+    });
+    if (slot.segmentIndex != segmentIndex || slot.state != SlotState::Decoded) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+ReadableSampleFrames AudioSourceParallelProxy::readSampleFramesClamped(
+        const WritableSampleFrames& writableSampleFrames) {
+    const auto frameIndexRange = writableSampleFrames.frameIndexRange();
+    CSAMPLE* pOutput = writableSampleFrames.writableData();
+    SINT frameIndex = frameIndexRange.start();
+    while (frameIndex < frameIndexRange.end()) {
+        const SINT segmentIndex = (frameIndex - frameIndexMin()) / kSegmentFrameCount;
+        const Slot* pSlot = awaitSegment(segmentIndex);
+        if (!pSlot) {
+            break;
+        }
+        const auto segmentRange = segmentFrameIndexRange(segmentIndex);
+        const SINT frameCount =
+                std::min(frameIndexRange.end(), segmentRange.end()) - frameIndex;
+        if (pOutput) {
+            const SINT sampleCount = getSignalInfo().frames2samples(frameCount);
+            SampleUtil::copy(
+                    pOutput,
+                    pSlot->sampleBuffer.data(getSignalInfo().frames2samples(
+                            frameIndex - segmentRange.start())),
+                    sampleCount);
+            pOutput += sampleCount;
+        }
+        frameIndex += frameCount;
+    }
+    if (frameIndex < frameIndexRange.end()) {
+        // Decode the remaining frames with the wrapped source
+        const auto remainingRange = IndexRange::between(
+                frameIndex, frameIndexRange.end());
+        const auto readableSampleFrames = readSampleFramesClampedOn(
+                *m_pAudioSource,
+                WritableSampleFrames(
+                        remainingRange,
+                        SampleBuffer::WritableSlice(
+                                pOutput,
+                                pOutput
+                                        ? getSignalInfo().frames2samples(
+                                                  remainingRange.length())
+                                        : 0)));
+        const auto readableRange = readableSampleFrames.frameIndexRange();
+        if (!readableRange.empty() && readableRange.start() == frameIndex) {
+            if (pOutput && readableSampleFrames.readableData() != pOutput) {
+                SampleUtil::copy(
+                        pOutput,
+                        readableSampleFrames.readableData(),
+                        readableSampleFrames.readableLength());
+            }
+            frameIndex = readableRange.end();
+        }
+    }
+    const auto resultRange = IndexRange::between(frameIndexRange.start(), frameIndex);
+    return ReadableSampleFrames(
+            resultRange,
+            SampleBuffer::ReadableSlice(
+                    writableSampleFrames.writableData(),
+                    std::min(writableSampleFrames.writableLength(),
+                            getSignalInfo().frames2samples(resultRange.length()))));
+}
+
+} // namespace mixxx
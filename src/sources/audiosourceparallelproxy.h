@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QThread>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "sources/audiosourceproxy.h"
+#include "util/samplebuffer.h"
+
+namespace mixxx {
+
+/// Decodes an AudioSource in segments on multiple threads for consumers
+/// that read the whole file from the beginning to the end, e.g. the
+/// analysis. This is only suitable for formats that can be decoded
+/// sample accurately after seeking, like FLAC.
+///
+/// Each helper thread opens its own decoder and decodes the segments
+/// ahead of the current read position. The segments are passed to the
+/// reader in order. At most a few segments per helper thread are kept
+/// in memory, so a slow reader throttles the helper threads.
+///
+/// Reads that cannot be served from the decoded segments, i.e. after
+/// a backward jump or a decoding error, are delegated to the wrapped
+/// AudioSource. The helper threads continue after forward jumps.
+/// Closing the proxy also closes the wrapped AudioSource, whereas
+/// destroying it only stops the helper threads.
+class AudioSourceParallelProxy : public AudioSourceProxy {
+  public:
+    /// Opens an additional, independent decoder for the same file.
+    /// Returns nullptr on failure. Invoked on the helper threads.
+    typedef std::function<AudioSourcePointer()> OpenDecoderFn;
+
+    // 2^18 frames = ~6 sec @ 44.1 kHz
+    static constexpr SINT kSegmentFrameCount = 1 << 18;
+
+    static constexpr int kSegmentsPerHelperThread = 2;
+
+    static AudioSourcePointer create(
+            AudioSourcePointer pAudioSource,
+            OpenDecoderFn openDecoder,
+            int numHelperThreads) {
+        return std::make_shared<AudioSourceParallelProxy>(
+                std::move(pAudioSource),
+                std::move(openDecoder),
+                numHelperThreads);
+    }
+
+    AudioSourceParallelProxy(
+            AudioSourcePointer pAudioSource,
+            OpenDecoderFn openDecoder,
+            int numHelperThreads);
+    ~AudioSourceParallelProxy() override;
+
+    void close() override;
+
+  protected:
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& writableSampleFrames) override;
+
+  private:
+    enum class SlotState {
+        Empty,
+        Decoding,
+        Decoded,
+        Failed,
+    };
+
+    struct Slot {
+        SINT segmentIndex = -1;
+        SlotState state = SlotState::Empty;
+        SampleBuffer sampleBuffer;
+    };
+
+    IndexRange segmentFrameIndexRange(SINT segmentIndex) const;
+    Slot& slotOf(SINT segmentIndex) {
+        return m_slots[segmentIndex % m_slots.size()];
+    }
+
+    void runHelper();
+    void stopHelpers();
+
+    // Waits until the segment has been decoded. Returns nullptr if the
+    // segment is not available and needs to be decoded by the reader.
+    const Slot* awaitSegment(SINT segmentIndex);
+
+    const OpenDecoderFn m_openDecoder;
+    const SINT m_segmentCount;
+
+    std::vector<Slot> m_slots;
+    std::vector<std::unique_ptr<QThread>> m_helperThreads;
+
+    // Guarded by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    // Segments before this one have been consumed by the reader
+    SINT m_firstSegmentIndex;
+    SINT m_nextSegmentIndex;
+    int m_numActiveHelpers;
+    bool m_stopping;
+};
+
+} // namespace mixxx
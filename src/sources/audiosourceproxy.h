@@ -23,6 +23,10 @@ class AudioSourceProxy : public AudioSource {
         m_pAudioSource->close();
     }
 
+    ChannelPairs selectChannelPairs(ChannelPairs channelPairs) override {
+        return m_pAudioSource->selectChannelPairs(channelPairs);
+    }
+
   protected:
     OpenResult tryOpen(
             OpenMode mode,
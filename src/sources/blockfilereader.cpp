@@ -0,0 +1,176 @@
+#include "sources/blockfilereader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+#if defined(__LINUX__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("BlockFileReader");
+
+} // anonymous namespace
+
+BlockFileReader::BlockFileReader(const QString& fileName)
+        : m_file(fileName),
+          m_size(0),
+          m_pos(0),
+          m_useCounter(0) {
+}
+
+bool BlockFileReader::open() {
+    DEBUG_ASSERT(!m_file.isOpen());
+    // All reads are buffered in blocks, QFile doesn't need to
+    // buffer them once more
+    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        kLogger.warning()
+                << "Failed to open file:"
+                << m_file.fileName()
+                << m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    m_pos = 0;
+    adviseReadAhead(0, kReadAheadBlocks * kBlockSize);
+    return true;
+}
+
+void BlockFileReader::close() {
+    m_file.close();
+    m_size = 0;
+    m_pos = 0;
+    // Free the memory of the cached blocks
+    std::vector<Block>().swap(m_blocks);
+}
+
+bool BlockFileReader::seek(qint64 pos) {
+    if (pos < 0 || pos > m_size) {
+        return false;
+    }
+    m_pos = pos;
+    return true;
+}
+
+qint64 BlockFileReader::read(char* pData, qint64 maxSize) {
+    DEBUG_ASSERT(maxSize >= 0);
+    qint64 readSize = 0;
+    while (readSize < maxSize && m_pos < m_size) {
+        const qint64 blockIndex = m_pos / kBlockSize;
+        const Block* pBlock = fetchBlock(blockIndex);
+        if (!pBlock) {
+            // Report the error only if nothing has been read
+            return readSize > 0 ? readSize : -1;
+        }
+        const qint64 blockOffset = m_pos - blockIndex * kBlockSize;
+        if (blockOffset >= pBlock->length) {
+            // The file has been truncated while reading
+            break;
+        }
+        const qint64 copySize = std::min(
+                maxSize - readSize,
+                pBlock->length - blockOffset);
+        std::memcpy(pData + readSize, pBlock->data.data() + blockOffset, copySize);
+        readSize += copySize;
+        m_pos += copySize;
+    }
+    return readSize;
+}
+
+const BlockFileReader::Block* BlockFileReader::fetchBlock(qint64 blockIndex) {
+    for (auto& block : m_blocks) {
+        if (block.index == blockIndex) {
+            block.lastUsed = ++m_useCounter;
+            return &block;
+        }
+    }
+    Block* pBlock;
+    if (static_cast<int>(m_blocks.size()) < kMaxCachedBlocks) {
+        m_blocks.emplace_back();
+        pBlock = &m_blocks.back();
+        pBlock->data.resize(kBlockSize);
+    } else {
+        // Replace the least recently used block
+        pBlock = &*std::min_element(
+                m_blocks.begin(),
+                m_blocks.end(),
+                [](const Block& lhs, const Block& rhs) {
+                    return lhs.lastUsed < rhs.lastUsed;
+                });
+    }
+    pBlock->index = -1;
+    const qint64 blockOffset = blockIndex * kBlockSize;
+    if (!m_file.seek(blockOffset)) {
+        kLogger.warning()
+                << "Failed to seek to offset"
+                << blockOffset
+                << "in file"
+                << m_file.fileName();
+        return nullptr;
+    }
+    const qint64 length = m_file.read(pBlock->data.data(), kBlockSize);
+    if (length < 0) {
+        kLogger.warning()
+                << "Failed to read from offset"
+                << blockOffset
+                << "in file"
+                << m_file.fileName()
+                << m_file.errorString();
+        return nullptr;
+    }
+    pBlock->index = blockIndex;
+    pBlock->length = length;
+    pBlock->lastUsed = ++m_useCounter;
+    // Decoders read sequentially after seeking
+    adviseReadAhead(blockOffset + kBlockSize, kReadAheadBlocks * kBlockSize);
+    return pBlock;
+}
+
+void BlockFileReader::adviseReadAhead(qint64 offset, qint64 length) {
+    if (offset >= m_size) {
+        return;
+    }
+    length = std::min(length, m_size - offset);
+#if defined(__LINUX__)
+    // Starts reading into the page cache asynchronously
+    posix_fadvise(m_file.handle(), offset, length, POSIX_FADV_WILLNEED);
+#elif defined(__APPLE__)
+    radvisory advisory;
+    advisory.ra_offset = offset;
+    advisory.ra_count = static_cast<int>(length);
+    fcntl(m_file.handle(), F_RDADVISE, &advisory);
+#else
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+#endif
+}
+
+// static
+void BlockFileReader::adviseWillNeed(const uchar* pMappedData, qint64 length) {
+#if defined(__LINUX__) || defined(__APPLE__)
+    // The address must be aligned to the page size
+    static const quintptr kPageSize = static_cast<quintptr>(sysconf(_SC_PAGESIZE));
+    const quintptr address = reinterpret_cast<quintptr>(pMappedData);
+    const quintptr alignedAddress = address & ~(kPageSize - 1);
+    posix_madvise(reinterpret_cast<void*>(alignedAddress),
+            static_cast<size_t>(length + (address - alignedAddress)),
+            POSIX_MADV_WILLNEED);
+#else
+    Q_UNUSED(pMappedData);
+    Q_UNUSED(length);
+#endif
+}
+
+} // namespace mixxx
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <vector>
+
+namespace mixxx {
+
+/// Reads the file of a SoundSource in large, aligned blocks and keeps the
+/// most recently read blocks in memory. Intended for files on network
+/// storage like SMB shares, where each small read that misses the page
+/// cache costs a round trip to the server.
+///
+/// After reading a block the operating system is advised to prefetch the
+/// subsequent blocks asynchronously, so decoding continues without waiting
+/// after a seek. Seeking back and forth between nearby positions, e.g.
+/// for resyncing the decoder after a seek, is served from the cached
+/// blocks.
+///
+/// The interface resembles QFile to simplify the I/O callbacks of the
+/// decoder libraries. Instances are not thread-safe.
+class BlockFileReader final {
+  public:
+    // 256 KiB, a multiple of the page size on all platforms
+    static constexpr qint64 kBlockSize = 256 * 1024;
+    // 4 MiB
+    static constexpr int kMaxCachedBlocks = 16;
+    // 2 MiB
+    static constexpr int kReadAheadBlocks = 8;
+
+    explicit BlockFileReader(const QString& fileName);
+    BlockFileReader(const BlockFileReader&) = delete;
+    BlockFileReader& operator=(const BlockFileReader&) = delete;
+
+    bool open();
+    void close();
+
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+
+    QString fileName() const {
+        return m_file.fileName();
+    }
+
+    qint64 size() const {
+        return m_size;
+    }
+
+    qint64 pos() const {
+        return m_pos;
+    }
+
+    bool atEnd() const {
+        return m_pos >= m_size;
+    }
+
+    /// Positions beyond the end of the file are rejected.
+    bool seek(qint64 pos);
+
+    /// Returns the number of bytes that have been read, 0 at the end
+    /// of the file, or -1 on errors.
+    qint64 read(char* pData, qint64 maxSize);
+
+    /// Advises the operating system that the given range of a memory
+    /// mapped file will be accessed soon.
+    static void adviseWillNeed(const uchar* pMappedData, qint64 length);
+
+  private:
+    struct Block {
+        qint64 index = -1;
+        qint64 length = 0;
+        quint64 lastUsed = 0;
+        std::vector<char> data;
+    };
+
+    const Block* fetchBlock(qint64 blockIndex);
+    void adviseReadAhead(qint64 offset, qint64 length);
+
+    QFile m_file;
+    qint64 m_size;
+    qint64 m_pos;
+
+    std::vector<Block> m_blocks;
+    quint64 m_useCounter;
+};
+
+} // namespace mixxx
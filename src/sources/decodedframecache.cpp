@@ -0,0 +1,272 @@
+#include "sources/decodedframecache.h"
+
+#include <algorithm>
+
+#include "util/sample.h"
+
+namespace mixxx {
+
+namespace {
+
+FrameIndex ringPosition(FrameIndex frameIndex, FrameCount capacity) {
+    DEBUG_ASSERT(capacity > 0);
+    const FrameIndex position = frameIndex % capacity;
+    return position < 0 ? position + capacity : position;
+}
+
+} // anonymous namespace
+
+DecodedFrameCache::DecodedFrameCache(
+        const audio::SignalInfo& signalInfo,
+        FrameCount historyCapacity,
+        FrameCount seekTargetCapacity,
+        int maxSeekTargets)
+        : m_signalInfo(signalInfo),
+          m_historyCapacity(historyCapacity),
+          m_seekTargetCapacity(seekTargetCapacity),
+          m_maxSeekTargets(maxSeekTargets) {
+    DEBUG_ASSERT(m_historyCapacity >= 0);
+    DEBUG_ASSERT(m_seekTargetCapacity >= 0);
+    DEBUG_ASSERT(m_maxSeekTargets >= 0);
+}
+
+void DecodedFrameCache::clear() {
+    SampleBuffer().swap(m_history);
+    m_historyRange = IndexRange();
+    m_seekTargets.clear();
+    m_recordingSeekTarget = -1;
+}
+
+WritableSampleFrames DecodedFrameCache::read(
+        const WritableSampleFrames& outputBuffer) {
+    auto remainingBuffer = outputBuffer;
+    while (!remainingBuffer.frameIndexRange().empty()) {
+        const auto startIndex = remainingBuffer.frameIndexRange().start();
+        remainingBuffer = readSeekTarget(remainingBuffer);
+        remainingBuffer = readHistory(remainingBuffer);
+        if (remainingBuffer.frameIndexRange().start() == startIndex) {
+            break; // not cached
+        }
+    }
+    return remainingBuffer;
+}
+
+WritableSampleFrames DecodedFrameCache::readHistory(
+        const WritableSampleFrames& outputBuffer) const {
+    const auto outputRange = outputBuffer.frameIndexRange();
+    if (m_historyRange.empty() ||
+            outputRange.empty() ||
+            !m_historyRange.containsIndex(outputRange.start())) {
+        return outputBuffer;
+    }
+    const FrameCount frameCount = std::min(
+            outputRange.length(),
+            m_historyRange.end() - outputRange.start());
+    CSAMPLE* pOutput = outputBuffer.writableData();
+    if (pOutput) {
+        // Copy in up to two parts when wrapping around the ring buffer
+        FrameIndex frameIndex = outputRange.start();
+        FrameCount remainingCount = frameCount;
+        while (remainingCount > 0) {
+            const FrameIndex position = ringPosition(frameIndex, m_historyCapacity);
+            const FrameCount copyCount = std::min(
+                    remainingCount, m_historyCapacity - position);
+            const SINT sampleCount = m_signalInfo.frames2samples(copyCount);
+            SampleUtil::copy(
+                    pOutput,
+                    m_history.data(m_signalInfo.frames2samples(position)),
+                    sampleCount);
+            pOutput += sampleCount;
+            frameIndex += copyCount;
+            remainingCount -= copyCount;
+        }
+    }
+    const auto remainingRange = IndexRange::between(
+            outputRange.start() + frameCount,
+            outputRange.end());
+    return WritableSampleFrames(
+            remainingRange,
+            SampleBuffer::WritableSlice(
+                    pOutput,
+                    pOutput ? m_signalInfo.frames2samples(remainingRange.length()) : 0));
+}
+
+WritableSampleFrames DecodedFrameCache::readSeekTarget(
+        const WritableSampleFrames& outputBuffer) {
+    const auto outputRange = outputBuffer.frameIndexRange();
+    if (outputRange.empty()) {
+        return outputBuffer;
+    }
+    for (auto& seekTarget : m_seekTargets) {
+        if (seekTarget.range.empty() ||
+                !seekTarget.range.containsIndex(outputRange.start())) {
+            continue;
+        }
+        seekTarget.lastUsed = ++m_useCounter;
+        const FrameCount frameOffset =
+                outputRange.start() - seekTarget.range.start();
+        const FrameCount frameCount = std::min(
+                outputRange.length(),
+                seekTarget.range.length() - frameOffset);
+        CSAMPLE* pOutput = outputBuffer.writableData();
+        if (pOutput) {
+            const SINT sampleCount = m_signalInfo.frames2samples(frameCount);
+            SampleUtil::copy(
+                    pOutput,
+                    seekTarget.sampleBuffer.data(
+                            m_signalInfo.frames2samples(frameOffset)),
+                    sampleCount);
+            pOutput += sampleCount;
+        }
+        const auto remainingRange = IndexRange::between(
+                outputRange.start() + frameCount,
+                outputRange.end());
+        return WritableSampleFrames(
+                remainingRange,
+                SampleBuffer::WritableSlice(
+                        pOutput,
+                        pOutput ? m_signalInfo.frames2samples(remainingRange.length()) : 0));
+    }
+    return outputBuffer;
+}
+
+void DecodedFrameCache::beginSeekTarget(
+        FrameIndex frameIndex) {
+    m_recordingSeekTarget = -1;
+    if (m_maxSeekTargets <= 0 || m_seekTargetCapacity <= 0) {
+        return;
+    }
+    // Continuing after the cached frames is not a jump
+    if (!m_historyRange.empty() && m_historyRange.end() == frameIndex) {
+        return;
+    }
+    for (const auto& seekTarget : m_seekTargets) {
+        if (!seekTarget.range.empty() && seekTarget.range.end() == frameIndex) {
+            return;
+        }
+    }
+    int index = -1;
+    for (int i = 0; i < static_cast<int>(m_seekTargets.size()); ++i) {
+        if (m_seekTargets[i].range.start() == frameIndex) {
+            // Incomplete, otherwise the read would have been served
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        if (static_cast<int>(m_seekTargets.size()) < m_maxSeekTargets) {
+            m_seekTargets.push_back(SeekTarget{
+                    IndexRange(),
+                    SampleBuffer(m_signalInfo.frames2samples(m_seekTargetCapacity)),
+                    0});
+            index = static_cast<int>(m_seekTargets.size()) - 1;
+        } else {
+            // Replace the least recently used seek target
+            const auto i = std::min_element(
+                    m_seekTargets.begin(),
+                    m_seekTargets.end(),
+                    [](const SeekTarget& lhs, const SeekTarget& rhs) {
+                        return lhs.lastUsed < rhs.lastUsed;
+                    });
+            index = static_cast<int>(i - m_seekTargets.begin());
+        }
+    }
+    auto& seekTarget = m_seekTargets[index];
+    seekTarget.range = IndexRange::forward(frameIndex, 0);
+    seekTarget.lastUsed = ++m_useCounter;
+    m_recordingSeekTarget = index;
+}
+
+void DecodedFrameCache::record(
+        const ReadableSampleFrames& sampleFrames) {
+    if (sampleFrames.frameIndexRange().empty()) {
+        return;
+    }
+    recordSeekTarget(sampleFrames);
+    recordHistory(sampleFrames);
+}
+
+void DecodedFrameCache::recordHistory(
+        const ReadableSampleFrames& sampleFrames) {
+    if (m_historyCapacity <= 0) {
+        return;
+    }
+    const auto inputRange = sampleFrames.frameIndexRange();
+    if (!sampleFrames.readableData()) {
+        // The samples have been skipped and are not available
+        m_historyRange = IndexRange();
+        return;
+    }
+    if (m_history.size() == 0) {
+        SampleBuffer(m_signalInfo.frames2samples(m_historyCapacity)).swap(m_history);
+    }
+    FrameIndex historyStart;
+    FrameIndex frameIndex;
+    if (!m_historyRange.empty() &&
+            m_historyRange.start() <= inputRange.start() &&
+            inputRange.start() <= m_historyRange.end()) {
+        // The history continues, frames that have already been
+        // recorded are identical
+        if (inputRange.end() <= m_historyRange.end()) {
+            return;
+        }
+        historyStart = m_historyRange.start();
+        frameIndex = m_historyRange.end();
+    } else {
+        historyStart = inputRange.start();
+        frameIndex = inputRange.start();
+    }
+    // Only the last frames fit into the ring buffer
+    frameIndex = std::max(frameIndex, inputRange.end() - m_historyCapacity);
+    const CSAMPLE* pInput = sampleFrames.readableData(
+            m_signalInfo.frames2samples(frameIndex - inputRange.start()));
+    while (frameIndex < inputRange.end()) {
+        const FrameIndex position = ringPosition(frameIndex, m_historyCapacity);
+        const FrameCount copyCount = std::min(
+                inputRange.end() - frameIndex, m_historyCapacity - position);
+        const SINT sampleCount = m_signalInfo.frames2samples(copyCount);
+        SampleUtil::copy(
+                m_history.data(m_signalInfo.frames2samples(position)),
+                pInput,
+                sampleCount);
+        pInput += sampleCount;
+        frameIndex += copyCount;
+    }
+    m_historyRange = IndexRange::between(
+            std::max(historyStart, inputRange.end() - m_historyCapacity),
+            inputRange.end());
+}
+
+void DecodedFrameCache::recordSeekTarget(
+        const ReadableSampleFrames& sampleFrames) {
+    if (m_recordingSeekTarget < 0) {
+        return;
+    }
+    auto& seekTarget = m_seekTargets[m_recordingSeekTarget];
+    const auto inputRange = sampleFrames.frameIndexRange();
+    // The recorded frames might start before the seek target if the
+    // beginning of a read has been served from a buffer
+    if (!sampleFrames.readableData() ||
+            inputRange.start() > seekTarget.range.end() ||
+            inputRange.end() <= seekTarget.range.end()) {
+        // Discontinuity
+        m_recordingSeekTarget = -1;
+        return;
+    }
+    const FrameCount inputOffset = seekTarget.range.end() - inputRange.start();
+    const FrameCount frameCount = std::min(
+            inputRange.length() - inputOffset,
+            m_seekTargetCapacity - seekTarget.range.length());
+    SampleUtil::copy(
+            seekTarget.sampleBuffer.data(
+                    m_signalInfo.frames2samples(seekTarget.range.length())),
+            sampleFrames.readableData(m_signalInfo.frames2samples(inputOffset)),
+            m_signalInfo.frames2samples(frameCount));
+    seekTarget.range.growBack(frameCount);
+    if (seekTarget.range.length() >= m_seekTargetCapacity) {
+        // Complete
+        m_recordingSeekTarget = -1;
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+
+#include "sources/readaheadframebuffer.h"
+#include "util/samplebuffer.h"
+
+namespace mixxx {
+
+/// Keeps sample frames that have been decoded recently for serving
+/// subsequent reads without seeking and decoding them again.
+///
+/// Two kinds of ranges are kept:
+///  - The history, i.e. the most recently decoded frames of a contiguous
+///    read. Backward seeks within the history, e.g. while scratching, are
+///    served from the history.
+///  - The frames that have been decoded after seeking to a new position,
+///    e.g. a hotcue. Only the beginning of each seek target is kept, which
+///    covers the time needed for decoding the subsequent frames.
+///
+/// Frames are stored as they are returned to the caller, i.e. after cutting
+/// off any preroll, and serving them is sample accurate.
+class DecodedFrameCache final {
+  public:
+    DecodedFrameCache() = default;
+    DecodedFrameCache(
+            const audio::SignalInfo& signalInfo,
+            FrameCount historyCapacity,
+            FrameCount seekTargetCapacity,
+            int maxSeekTargets);
+    DecodedFrameCache(DecodedFrameCache&&) = default;
+    DecodedFrameCache(const DecodedFrameCache&) = delete;
+    DecodedFrameCache& operator=(DecodedFrameCache&&) = default;
+    DecodedFrameCache& operator=(const DecodedFrameCache&) = delete;
+
+    /// Frees all buffers.
+    void clear();
+
+    /// Copies the cached frames at the start of the output buffer.
+    ///
+    /// Returns the remaining portion that could not be filled from
+    /// the cache.
+    WritableSampleFrames read(
+            const WritableSampleFrames& outputBuffer);
+
+    /// Starts recording a new seek target at the given position. The
+    /// following frames that are passed to record() will be kept for
+    /// this seek target.
+    void beginSeekTarget(
+            FrameIndex frameIndex);
+
+    /// Records decoded frames. Frames that don't continue the previously
+    /// recorded frames start a new history.
+    void record(
+            const ReadableSampleFrames& sampleFrames);
+
+  private:
+    struct SeekTarget {
+        IndexRange range;
+        SampleBuffer sampleBuffer;
+        quint64 lastUsed;
+    };
+
+    void recordHistory(
+            const ReadableSampleFrames& sampleFrames);
+    void recordSeekTarget(
+            const ReadableSampleFrames& sampleFrames);
+
+    WritableSampleFrames readHistory(
+            const WritableSampleFrames& outputBuffer) const;
+    WritableSampleFrames readSeekTarget(
+            const WritableSampleFrames& outputBuffer);
+
+    audio::SignalInfo m_signalInfo;
+    FrameCount m_historyCapacity = 0;
+    FrameCount m_seekTargetCapacity = 0;
+    int m_maxSeekTargets = 0;
+
+    // Ring buffer, the frame at index i is stored at
+    // position (i mod capacity).
+    SampleBuffer m_history;
+    IndexRange m_historyRange;
+
+    std::vector<SeekTarget> m_seekTargets;
+    // Index into m_seekTargets or -1 if not recording
+    int m_recordingSeekTarget = -1;
+    quint64 m_useCounter = 0;
+};
+
+} // namespace mixxx
@@ -0,0 +1,92 @@
+#include "sources/metadatacache.h"
+
+#include <QCache>
+#include <QFile>
+#include <QMutex>
+
+#include "sources/metadatasource.h"
+#include "util/compatibility/qmutex.h"
+
+namespace mixxx {
+
+namespace {
+
+struct Entry {
+    MetadataCache::FileKey fileKey;
+    bool resetMissingTagMetadata;
+    TrackMetadata existingMetadata;
+    TrackMetadata importedMetadata;
+};
+
+QMutex s_mutex;
+// Evicts the least recently used entries
+QCache<QString, Entry> s_entries(MetadataCache::kMaxEntries);
+
+} // anonymous namespace
+
+// static
+MetadataCache::FileKey MetadataCache::fileKey(const QString& filePath) {
+    const QFile file(filePath);
+    FileKey fileKey;
+    fileKey.lastModified = MetadataSource::getFileSynchronizedAt(file);
+    fileKey.size = file.exists() ? file.size() : -1;
+    return fileKey;
+}
+
+// static
+bool MetadataCache::import(
+        const QString& filePath,
+        const FileKey& fileKey,
+        bool resetMissingTagMetadata,
+        TrackMetadata* pTrackMetadata) {
+    DEBUG_ASSERT(pTrackMetadata);
+    if (!fileKey.isValid()) {
+        return false;
+    }
+    const auto locker = lockMutex(&s_mutex);
+    const Entry* pEntry = s_entries.object(filePath);
+    if (!pEntry) {
+        return false;
+    }
+    if (pEntry->fileKey.lastModified != fileKey.lastModified ||
+            pEntry->fileKey.size != fileKey.size) {
+        // The file has been modified
+        s_entries.remove(filePath);
+        return false;
+    }
+    if (pEntry->resetMissingTagMetadata != resetMissingTagMetadata ||
+            (*pTrackMetadata != pEntry->existingMetadata &&
+                    *pTrackMetadata != pEntry->importedMetadata)) {
+        return false;
+    }
+    *pTrackMetadata = pEntry->importedMetadata;
+    return true;
+}
+
+// static
+void MetadataCache::store(
+        const QString& filePath,
+        const FileKey& fileKey,
+        bool resetMissingTagMetadata,
+        const TrackMetadata& existingMetadata,
+        const TrackMetadata& importedMetadata) {
+    if (!fileKey.isValid()) {
+        return;
+    }
+    auto* pEntry = new Entry{
+            fileKey,
+            resetMissingTagMetadata,
+            existingMetadata,
+            importedMetadata};
+    const auto locker = lockMutex(&s_mutex);
+    // Takes ownership
+    s_entries.insert(filePath, pEntry);
+}
+
+// static
+void MetadataCache::remove(const QString& filePath) {
+    const auto locker = lockMutex(&s_mutex);
+    s_entries.remove(filePath);
+}
+
+} // namespace mixxx
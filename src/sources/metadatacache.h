@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QDateTime>
+#include <QString>
+
+#include "track/trackmetadata.h"
+
+namespace mixxx {
+
+/// MetadataCache keeps the results of recent imports of track metadata
+/// from file tags in memory, so files that have not been modified are not
+/// parsed again when synchronizing the same tracks repeatedly.
+///
+/// The entries are keyed by the file path and validated by the size and
+/// the modification time of the file. Importing metadata depends on the
+/// existing metadata if missing tags should not reset it. Both the existing
+/// and the imported metadata are stored, and importing the same tags again
+/// into the imported metadata doesn't change it. So the entry is used if
+/// the existing metadata equals either of them.
+///
+/// Cover images are not cached, they would consume too much memory.
+/// All functions are thread-safe.
+class MetadataCache final {
+  public:
+    /// Identifies the content of a file without reading it
+    struct FileKey {
+        QDateTime lastModified;
+        qint64 size = -1;
+
+        bool isValid() const {
+            return lastModified.isValid() && size >= 0;
+        }
+    };
+
+    static constexpr int kMaxEntries = 4096;
+
+    static FileKey fileKey(const QString& filePath);
+
+    /// Replaces *pTrackMetadata with the cached metadata that has been
+    /// imported from the same file before. Returns false if not cached.
+    static bool import(
+            const QString& filePath,
+            const FileKey& fileKey,
+            bool resetMissingTagMetadata,
+            TrackMetadata* pTrackMetadata);
+
+    /// Stores the imported metadata. The file key must have been obtained
+    /// before importing the metadata, so concurrent modifications of the
+    /// file are detected.
+    static void store(
+            const QString& filePath,
+            const FileKey& fileKey,
+            bool resetMissingTagMetadata,
+            const TrackMetadata& existingMetadata,
+            const TrackMetadata& importedMetadata);
+
+    /// Discards all entries, e.g. after exporting metadata into a file.
+    static void remove(const QString& filePath);
+};
+
+} // namespace mixxx
@@ -6,6 +6,7 @@
 #include <QFile>
 #include <memory>
 
+#include "sources/metadatacache.h"
 #include "track/taglib/trackmetadata.h"
 #include "track/taglib/trackmetadata_common.h"
 #include "util/logger.h"
@@ -75,6 +76,7 @@ MetadataSourceTagLib::afterImport(ImportResult importResult) const {
 
 std::pair<MetadataSourceTagLib::ExportResult, QDateTime>
 MetadataSourceTagLib::afterExport(ExportResult exportResult) const {
+    MetadataCache::remove(m_fileName);
     const auto sourceSynchronizedAt =
             MetadataSource::getFileSynchronizedAt(QFile(m_fileName));
     DEBUG_ASSERT(sourceSynchronizedAt.isValid() ||
@@ -87,6 +89,34 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         TrackMetadata* pTrackMetadata,
         QImage* pCoverImage,
         bool resetMissingTagMetadata) const {
+    if (!pTrackMetadata || pCoverImage) {
+        // Cover images are not cached
+        return importTrackMetadataAndCoverImageFromFile(
+                pTrackMetadata, pCoverImage, resetMissingTagMetadata);
+    }
+    const auto fileKey = MetadataCache::fileKey(m_fileName);
+    if (MetadataCache::import(
+                m_fileName, fileKey, resetMissingTagMetadata, pTrackMetadata)) {
+        return std::make_pair(ImportResult::Succeeded, fileKey.lastModified);
+    }
+    const TrackMetadata existingMetadata = *pTrackMetadata;
+    const auto importResult = importTrackMetadataAndCoverImageFromFile(
+            pTrackMetadata, nullptr, resetMissingTagMetadata);
+    if (importResult.first == ImportResult::Succeeded) {
+        MetadataCache::store(m_fileName,
+                fileKey,
+                resetMissingTagMetadata,
+                existingMetadata,
+                *pTrackMetadata);
+    }
+    return importResult;
+}
+
+std::pair<MetadataSource::ImportResult, QDateTime>
+MetadataSourceTagLib::importTrackMetadataAndCoverImageFromFile(
+        TrackMetadata* pTrackMetadata,
+        QImage* pCoverImage,
+        bool resetMissingTagMetadata) const {
     VERIFY_OR_DEBUG_ASSERT(pTrackMetadata || pCoverImage) {
         kLogger.warning()
                 << "Nothing to import"
@@ -5,6 +5,9 @@
 namespace mixxx {
 
 // Universal default implementation of IMetadataSource using TagLib.
+//
+// Imported track metadata is cached by MetadataCache, so unmodified
+// files are only parsed again for importing cover images.
 class MetadataSourceTagLib : public MetadataSource {
   public:
     explicit MetadataSourceTagLib(
@@ -28,6 +31,12 @@ class MetadataSourceTagLib : public MetadataSource {
             const TrackMetadata& trackMetadata) const override;
 
   private:
+    /// Parses the file tags, bypassing the MetadataCache.
+    std::pair<ImportResult, QDateTime> importTrackMetadataAndCoverImageFromFile(
+            TrackMetadata* pTrackMetadata,
+            QImage* pCoverImage,
+            bool resetMissingTagMetadata) const;
+
     std::pair<ImportResult, QDateTime> afterImport(ImportResult importResult) const;
     std::pair<ExportResult, QDateTime> afterExport(ExportResult exportResult) const;
 
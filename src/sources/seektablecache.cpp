@@ -0,0 +1,147 @@
+#include "sources/seektablecache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QReadWriteLock>
+#include <QSaveFile>
+#include <algorithm>
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SeekTableCache");
+
+// The number of bytes at the beginning and at the end of a file that are
+// included in its fingerprint
+constexpr qint64 kFingerprintBytes = 64 * 1024;
+
+const QByteArray kMagic = QByteArrayLiteral("MXST");
+
+QReadWriteLock s_directoryLock;
+QString s_directoryPath;
+
+QString directoryPath() {
+    QReadLocker locker(&s_directoryLock);
+    return s_directoryPath;
+}
+
+/// Returns an empty fingerprint if the file could not be read.
+QByteArray calculateFingerprint(
+        const QString& audioFilePath,
+        const QString& decoder,
+        int version) {
+    QFile file(audioFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    const qint64 fileSize = file.size();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(decoder.toUtf8());
+    hash.addData(QByteArray::number(version));
+    hash.addData(QByteArray::number(fileSize));
+    hash.addData(QByteArray::number(
+            QFileInfo(file).lastModified().toMSecsSinceEpoch()));
+    hash.addData(file.read(kFingerprintBytes));
+    if (fileSize > kFingerprintBytes) {
+        if (!file.seek(std::max(kFingerprintBytes, fileSize - kFingerprintBytes))) {
+            return QByteArray();
+        }
+        hash.addData(file.read(kFingerprintBytes));
+    }
+    return hash.result();
+}
+
+QString cacheFilePath(const QString& dirPath, const QByteArray& fingerprint) {
+    return QDir(dirPath).filePath(QString::fromLatin1(fingerprint.toHex()));
+}
+
+} // anonymous namespace
+
+// static
+void SeekTableCache::setDirectory(const QString& dirPath) {
+    if (!dirPath.isEmpty() && !QDir().mkpath(dirPath)) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << dirPath;
+        return;
+    }
+    QWriteLocker locker(&s_directoryLock);
+    s_directoryPath = dirPath;
+}
+
+// static
+QByteArray SeekTableCache::load(
+        const QString& audioFilePath,
+        const QString& decoder,
+        int version) {
+    const QString dirPath = directoryPath();
+    if (dirPath.isEmpty()) {
+        return QByteArray();
+    }
+    const QByteArray fingerprint = calculateFingerprint(audioFilePath, decoder, version);
+    if (fingerprint.isEmpty()) {
+        return QByteArray();
+    }
+    QFile file(cacheFilePath(dirPath, fingerprint));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QDataStream stream(&file);
+    QByteArray magic;
+    QByteArray storedFingerprint;
+    QByteArray compressedData;
+    stream >> magic >> storedFingerprint >> compressedData;
+    if (stream.status() != QDataStream::Ok ||
+            magic != kMagic ||
+            storedFingerprint != fingerprint) {
+        kLogger.info()
+                << "Ignoring invalid seek table for"
+                << audioFilePath;
+        return QByteArray();
+    }
+    return qUncompress(compressedData);
+}
+
+// static
+void SeekTableCache::store(
+        const QString& audioFilePath,
+        const QString& decoder,
+        int version,
+        const QByteArray& data) {
+    const QString dirPath = directoryPath();
+    if (dirPath.isEmpty()) {
+        return;
+    }
+    const QByteArray fingerprint = calculateFingerprint(audioFilePath, decoder, version);
+    if (fingerprint.isEmpty()) {
+        return;
+    }
+    // Written atomically, because another thread might open the same
+    // audio file concurrently, e.g. the analyzer while the track is
+    // loaded into a deck.
+    QSaveFile file(cacheFilePath(dirPath, fingerprint));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open"
+                << file.fileName()
+                << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream << kMagic << fingerprint << qCompress(data);
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write"
+                << file.fileName()
+                << file.errorString();
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+namespace mixxx {
+
+/// SeekTableCache persists the seek tables of decoders that need to scan
+/// a whole file before the first sample can be decoded, e.g. the list of
+/// MP3 frames. It stores opaque, decoder-specific data in a directory with
+/// a single file per audio file.
+///
+/// The cache entries are keyed by a fingerprint of the audio file that is
+/// calculated from its size, its modification time and hashes of its first
+/// and last bytes. Reading the whole file, which the cache is supposed to
+/// avoid, is not needed for detecting modifications.
+///
+/// The cache is disabled until a directory has been set. All functions are
+/// thread-safe.
+class SeekTableCache final {
+  public:
+    /// Scanning small files is fast, and caching them would only fill
+    /// the cache directory.
+    static constexpr qint64 kMinFileSize = 16 * 1024 * 1024;
+
+    /// Enables the cache. An empty path disables it.
+    static void setDirectory(const QString& dirPath);
+
+    /// Returns an empty byte array if no data has been stored for
+    /// this version of the decoder and this content of the file.
+    static QByteArray load(
+            const QString& audioFilePath,
+            const QString& decoder,
+            int version);
+
+    static void store(
+            const QString& audioFilePath,
+            const QString& decoder,
+            int version,
+            const QByteArray& data);
+};
+
+} // namespace mixxx
@@ -9,6 +9,9 @@ extern "C" {
 
 } // extern "C"
 
+#include <memory>
+
+#include "sources/blockfilereader.h"
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -53,8 +56,84 @@ constexpr int64_t kavStreamDecoderFrameDelayAAC = 2112;
 
 constexpr SINT kMaxSamplesPerMP3Frame = 1152;
 
+// Backward seeks within the last 3 seconds, e.g. while scratching,
+// are served from the decoded frames
+constexpr double kDecodedHistorySeconds = 3.0;
+
+// The beginning of the most recent seek targets, e.g. hotcues, is kept
+// for serving repeated jumps while decoding the subsequent frames
+constexpr double kDecodedSeekTargetSeconds = 0.5;
+constexpr int kMaxDecodedSeekTargets = 8;
+
 const Logger kLogger("SoundSourceFFmpeg");
 
+// FFmpeg reads through this buffer in chunks of this size, while
+// BlockFileReader reads the file in larger blocks
+constexpr int kAVIOBufferSize = 64 * 1024;
+
+int readAVIOPacket(void* opaque, uint8_t* pBuffer, int bufferSize) {
+    auto* pFileReader = static_cast<BlockFileReader*>(opaque);
+    const qint64 readSize = pFileReader->read(
+            reinterpret_cast<char*>(pBuffer), bufferSize);
+    if (readSize < 0) {
+        return AVERROR(EIO);
+    }
+    if (readSize == 0) {
+        return AVERROR_EOF;
+    }
+    return static_cast<int>(readSize);
+}
+
+int64_t seekAVIO(void* opaque, int64_t offset, int whence) {
+    auto* pFileReader = static_cast<BlockFileReader*>(opaque);
+    if (whence & AVSEEK_SIZE) {
+        return pFileReader->size();
+    }
+    switch (whence & ~AVSEEK_FORCE) {
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        offset += pFileReader->pos();
+        break;
+    case SEEK_END:
+        offset += pFileReader->size();
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (!pFileReader->seek(offset)) {
+        return AVERROR(EINVAL);
+    }
+    return offset;
+}
+
+void freeAVIOContext(AVIOContext** ppavIOContext) {
+    if (!*ppavIOContext) {
+        return;
+    }
+    delete static_cast<BlockFileReader*>((*ppavIOContext)->opaque);
+    av_freep(&(*ppavIOContext)->buffer);
+    avio_context_free(ppavIOContext);
+}
+
+// Full scale of signed 32-bit integer samples
+constexpr CSAMPLE kS32ScaleFactor = 1.0f / 2147483648.0f; // 2^31
+
+// Sample formats that are converted by SampleUtil without
+// allocating a resampling context. Other sample formats are
+// still converted by libswresample.
+bool canConvertSampleFormat(AVSampleFormat avSampleFormat) {
+    switch (avSampleFormat) {
+    case AV_SAMPLE_FMT_FLT:
+    case AV_SAMPLE_FMT_FLTP:
+    case AV_SAMPLE_FMT_S16:
+    case AV_SAMPLE_FMT_S32:
+        return true;
+    default:
+        return false;
+    }
+}
+
 int64_t getStreamStartTime(const AVStream& avStream) {
     auto start_time = avStream.start_time;
     if (start_time == AV_NOPTS_VALUE) {
@@ -198,6 +277,18 @@ FrameCount SoundSourceFFmpeg::frameBufferCapacityForStream(
     return kDefaultFrameBufferCapacity;
 }
 
+// Static
+DecodedFrameCache SoundSourceFFmpeg::decodedFrameCacheForSignal(
+        const audio::SignalInfo& signalInfo) {
+    return DecodedFrameCache(
+            signalInfo,
+            static_cast<FrameCount>(
+                    signalInfo.getSampleRate() * kDecodedHistorySeconds),
+            static_cast<FrameCount>(
+                    signalInfo.getSampleRate() * kDecodedSeekTargetSeconds),
+            kMaxDecodedSeekTargets);
+}
+
 // Static
 SINT SoundSourceFFmpeg::getStreamSeekPrerollFrameCount(const AVStream& avStream) {
     // Stream might not provide an appropriate value that is
@@ -284,10 +375,41 @@ QString SoundSourceFFmpeg::formatErrorString(int errnum) {
 // Static
 AVFormatContext* SoundSourceFFmpeg::openInputFile(
         const QString& fileName) {
-    // Will be allocated implicitly when opening the input file
-    AVFormatContext* pavInputFormatContext = nullptr;
+    // The file is read through a BlockFileReader instead of the
+    // default AVIO implementation
+    auto pFileReader = std::make_unique<BlockFileReader>(fileName);
+    if (!pFileReader->open()) {
+        return nullptr;
+    }
+    auto* pAVIOBuffer = static_cast<unsigned char*>(av_malloc(kAVIOBufferSize));
+    if (!pAVIOBuffer) {
+        return nullptr;
+    }
+    AVIOContext* pavIOContext = avio_alloc_context(
+            pAVIOBuffer,
+            kAVIOBufferSize,
+            0, // read-only
+            pFileReader.get(),
+            readAVIOPacket,
+            nullptr,
+            seekAVIO);
+    if (!pavIOContext) {
+        av_free(pAVIOBuffer);
+        return nullptr;
+    }
+    // Owned by the AVIOContext from now on
+    pFileReader.release();
 
-    // Open input file and allocate/initialize AVFormatContext
+    AVFormatContext* pavInputFormatContext = avformat_alloc_context();
+    if (!pavInputFormatContext) {
+        freeAVIOContext(&pavIOContext);
+        return nullptr;
+    }
+    pavInputFormatContext->pb = pavIOContext;
+    pavInputFormatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    // Open input file and initialize AVFormatContext. The file name
+    // is only used for guessing the format.
     const int avformat_open_input_result =
             avformat_open_input(
                     &pavInputFormatContext, fileName.toLocal8Bit().constData(), nullptr, nullptr);
@@ -296,11 +418,30 @@ AVFormatContext* SoundSourceFFmpeg::openInputFile(
         kLogger.warning().noquote()
                 << "avformat_open_input() failed:"
                 << formatErrorString(avformat_open_input_result);
+        // The AVFormatContext has been freed, but not the custom I/O
         DEBUG_ASSERT(pavInputFormatContext == nullptr);
+        freeAVIOContext(&pavIOContext);
     }
     return pavInputFormatContext;
 }
 
+// Static
+void SoundSourceFFmpeg::closeInputFile(
+        AVFormatContext** ppavInputFormatContext) {
+    DEBUG_ASSERT(ppavInputFormatContext);
+    if (!*ppavInputFormatContext) {
+        return;
+    }
+    AVIOContext* pavIOContext =
+            ((*ppavInputFormatContext)->flags & AVFMT_FLAG_CUSTOM_IO)
+            ? (*ppavInputFormatContext)->pb
+            : nullptr;
+    // Doesn't close the custom I/O
+    avformat_close_input(ppavInputFormatContext);
+    DEBUG_ASSERT(*ppavInputFormatContext == nullptr);
+    freeAVIOContext(&pavIOContext);
+}
+
 void SoundSourceFFmpeg::InputAVFormatContextPtr::take(
         AVFormatContext** ppavInputFormatContext) {
     DEBUG_ASSERT(ppavInputFormatContext != nullptr);
@@ -312,10 +453,7 @@ void SoundSourceFFmpeg::InputAVFormatContextPtr::take(
 }
 
 void SoundSourceFFmpeg::InputAVFormatContextPtr::close() {
-    if (m_pavInputFormatContext != nullptr) {
-        avformat_close_input(&m_pavInputFormatContext);
-        DEBUG_ASSERT(m_pavInputFormatContext == nullptr);
-    }
+    closeInputFile(&m_pavInputFormatContext);
 }
 
 //static
@@ -486,6 +624,7 @@ SoundSourceFFmpeg::SoundSourceFFmpeg(const QUrl& url)
           m_pavStream(nullptr),
           m_pavDecodedFrame(nullptr),
           m_seekPrerollFrameCount(0),
+          m_addPacketIndexEntries(false),
           m_pavPacket(av_packet_alloc()),
           m_pavResampledFrame(nullptr),
           m_avutilVersion(avutil_version()) {
@@ -737,6 +876,13 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
 #if VERBOSE_DEBUG_LOG
     kLogger.debug() << "Frame buffer capacity:" << m_frameBuffer.capacity();
 #endif
+    m_decodedFrameCache = decodedFrameCacheForSignal(getSignalInfo());
+
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 76, 100) // FFmpeg 4.4
+    m_addPacketIndexEntries = avformat_index_get_entries_count(m_pavStream) == 0;
+#else
+    m_addPacketIndexEntries = m_pavStream->nb_index_entries == 0;
+#endif
 
     return OpenResult::Succeeded;
 }
@@ -783,6 +929,8 @@ bool SoundSourceFFmpeg::initResampling(
     const auto streamSampleRate =
             audio::SampleRate(m_pavStream->codecpar->sample_rate);
     const auto resampledSampleRate = streamSampleRate;
+    // Decoders typically output planar floats or integers. Converting
+    // them into interleaved floats doesn't need a resampling context.
     if (
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
             av_channel_layout_compare(&avResampledChannelLayout, &avStreamChannelLayout) != 0 ||
@@ -790,7 +938,7 @@ bool SoundSourceFFmpeg::initResampling(
             (resampledChannelCount != streamChannelCount) ||
             (avResampledChannelLayout != avStreamChannelLayout) ||
 #endif
-            (avResampledSampleFormat != avStreamSampleFormat)) {
+            !canConvertSampleFormat(avStreamSampleFormat)) {
 #if VERBOSE_DEBUG_LOG
         kLogger.debug()
                 << "Decoded stream needs to be resampled"
@@ -881,6 +1029,8 @@ void SoundSourceFFmpeg::close() {
     m_pavCodecContext.close();
     m_pavInputFormatContext.close();
     m_pavStream = nullptr;
+    m_decodedFrameCache.clear();
+    SampleBuffer().swap(m_convertedSampleBuffer);
 }
 
 namespace {
@@ -934,7 +1084,9 @@ SINT readNextPacket(
 }
 } // namespace
 
-bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
+bool SoundSourceFFmpeg::adjustCurrentPosition(
+        SINT startIndex,
+        bool recordSeekTarget) {
     DEBUG_ASSERT(frameIndexRange().containsIndex(startIndex));
 
     if (m_frameBuffer.tryContinueReadingFrom(startIndex)) {
@@ -982,6 +1134,9 @@ bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
     // The current position remains unknown until actually reading data
     // from the stream
     m_frameBuffer.reset();
+    if (recordSeekTarget) {
+        m_decodedFrameCache.beginSeekTarget(startIndex);
+    }
 
     return true;
 }
@@ -1002,6 +1157,19 @@ bool SoundSourceFFmpeg::consumeNextAVPacket(
             m_frameBuffer.invalidate();
             return false;
         }
+        if (m_addPacketIndexEntries &&
+                m_pavPacket->data &&
+                (m_pavPacket->flags & AV_PKT_FLAG_KEY) &&
+                m_pavPacket->pos >= 0 &&
+                m_pavPacket->pts != AV_NOPTS_VALUE) {
+            av_add_index_entry(
+                    m_pavStream,
+                    m_pavPacket->pos,
+                    m_pavPacket->pts,
+                    m_pavPacket->size,
+                    0,
+                    AVINDEX_KEYFRAME);
+        }
         *ppavNextPacket = m_pavPacket;
     }
     auto* pavNextPacket = *ppavNextPacket;
@@ -1081,10 +1249,53 @@ const CSAMPLE* SoundSourceFFmpeg::resampleDecodedAVFrame() {
         DEBUG_ASSERT(m_pavResampledFrame->nb_samples == m_pavDecodedFrame->nb_samples);
         return reinterpret_cast<const CSAMPLE*>(
                 m_pavResampledFrame->extended_data[0]);
-    } else {
+    }
+    const SINT sampleCount = getSignalInfo().frames2samples(
+            m_pavDecodedFrame->nb_samples);
+    const auto avSampleFormat =
+            static_cast<AVSampleFormat>(m_pavDecodedFrame->format);
+    if (avSampleFormat == s_avSampleFormat) {
+        // Already interleaved floats, nothing to do
         return reinterpret_cast<const CSAMPLE*>(
                 m_pavDecodedFrame->extended_data[0]);
     }
+    if (m_convertedSampleBuffer.size() < sampleCount) {
+        SampleBuffer(sampleCount).swap(m_convertedSampleBuffer);
+    }
+    CSAMPLE* pConverted = m_convertedSampleBuffer.data();
+    switch (avSampleFormat) {
+    case AV_SAMPLE_FMT_FLTP:
+        SampleUtil::interleavePlanarBuffer(
+                pConverted,
+                reinterpret_cast<const CSAMPLE* const*>(
+                        m_pavDecodedFrame->extended_data),
+                getSignalInfo().getChannelCount(),
+                m_pavDecodedFrame->nb_samples);
+        break;
+    case AV_SAMPLE_FMT_S16:
+        SampleUtil::convertS16ToFloat32(
+                pConverted,
+                reinterpret_cast<const SAMPLE*>(
+                        m_pavDecodedFrame->extended_data[0]),
+                sampleCount);
+        break;
+    case AV_SAMPLE_FMT_S32:
+        SampleUtil::convertS32ToFloat32(
+                pConverted,
+                reinterpret_cast<const int32_t*>(
+                        m_pavDecodedFrame->extended_data[0]),
+                kS32ScaleFactor,
+                sampleCount);
+        break;
+    default:
+        // The sample format has changed while decoding
+        kLogger.warning()
+                << "Unexpected sample format of decoded frame"
+                << av_get_sample_fmt_name(avSampleFormat);
+        av_frame_unref(m_pavDecodedFrame);
+        return nullptr;
+    }
+    return pConverted;
 }
 
 ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
@@ -1111,6 +1322,21 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
 #endif
     }
 
+    // Serve recently decoded frames instead of seeking. Decoding is
+    // continued if the current position matches.
+    if (!writableSampleFrames.frameIndexRange().empty() &&
+            !(m_frameBuffer.isReady() &&
+                    m_frameBuffer.writeIndex() ==
+                            writableSampleFrames.frameIndexRange().start())) {
+        const auto cacheStartIndex = writableSampleFrames.frameIndexRange().start();
+        writableSampleFrames = m_decodedFrameCache.read(writableSampleFrames);
+        if (writableSampleFrames.frameIndexRange().start() != cacheStartIndex &&
+                m_frameBuffer.isReady()) {
+            // The cached frames might end within the buffered frames
+            writableSampleFrames = m_frameBuffer.drainBuffer(writableSampleFrames);
+        }
+    }
+
     // Skip decoding if all data has been read
     auto writableFrameRange = writableSampleFrames.frameIndexRange();
     DEBUG_ASSERT(writableFrameRange.isSubrangeOf(frameIndexRange()));
@@ -1120,12 +1346,18 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
         DEBUG_ASSERT(readableRange.orientation() != IndexRange::Orientation::Backward);
         const auto readableSampleCount =
                 getSignalInfo().frames2samples(readableRange.length());
-        return ReadableSampleFrames(readableRange,
+        const auto readableSampleFrames = ReadableSampleFrames(readableRange,
                 SampleBuffer::ReadableSlice(readableData, readableSampleCount));
+        m_decodedFrameCache.record(readableSampleFrames);
+        return readableSampleFrames;
     }
 
-    // Adjust the current position
-    if (!adjustCurrentPosition(writableFrameRange.start())) {
+    // Adjust the current position. Only reads that could not be served
+    // from any buffer at all are jumps to a new position that are worth
+    // to be remembered.
+    if (!adjustCurrentPosition(
+                writableFrameRange.start(),
+                writableFrameRange.start() == readableStartIndex)) {
         // Abort reading on seek errors
         return ReadableSampleFrames();
     }
@@ -1348,11 +1580,13 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
             IndexRange::between(
                     readableStartIndex,
                     writableFrameRange.start());
-    return ReadableSampleFrames(
+    const auto readableSampleFrames = ReadableSampleFrames(
             readableRange,
             SampleBuffer::ReadableSlice(
                     readableData,
                     getSignalInfo().frames2samples(readableRange.length())));
+    m_decodedFrameCache.record(readableSampleFrames);
+    return readableSampleFrames;
 }
 
 } // namespace mixxx
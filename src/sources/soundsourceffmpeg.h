@@ -8,6 +8,7 @@ extern "C" {
 
 } // extern "C"
 
+#include "sources/decodedframecache.h"
 #include "sources/readaheadframebuffer.h"
 #include "sources/soundsourceprovider.h"
 
@@ -34,9 +35,11 @@ class SoundSourceFFmpeg : public SoundSource {
     const CSAMPLE* resampleDecodedAVFrame();
 
     // Seek to the requested start index (if needed) or return false
-    // upon seek errors.
+    // upon seek errors. The frames that are decoded after seeking are
+    // kept in m_decodedFrameCache if requested.
     bool adjustCurrentPosition(
-            SINT startIndex);
+            SINT startIndex,
+            bool recordSeekTarget);
 
     bool consumeNextAVPacket(
             AVPacket** ppavNextPacket);
@@ -137,6 +140,8 @@ class SoundSourceFFmpeg : public SoundSource {
     // The following static functions are used by children and closely related
     // classes, this is why these static methods aren't defined as protected.
     static AVFormatContext* openInputFile(const QString& fileName);
+    /// Closes an AVFormatContext that has been opened by openInputFile().
+    static void closeInputFile(AVFormatContext** ppavInputFormatContext);
     static bool openDecodingContext(AVCodecContext* pavCodecContext);
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
     static void initChannelLayoutFromStream(
@@ -148,6 +153,7 @@ class SoundSourceFFmpeg : public SoundSource {
     static IndexRange getStreamFrameIndexRange(const AVStream& avStream);
     static SINT getStreamSeekPrerollFrameCount(const AVStream& avStream);
     static FrameCount frameBufferCapacityForStream(const AVStream& avStream);
+    static DecodedFrameCache decodedFrameCacheForSignal(const audio::SignalInfo& signalInfo);
 
   protected:
     InputAVFormatContextPtr m_pavInputFormatContext;
@@ -156,6 +162,12 @@ class SoundSourceFFmpeg : public SoundSource {
     AVFrame* m_pavDecodedFrame;
     FrameCount m_seekPrerollFrameCount;
     ReadAheadFrameBuffer m_frameBuffer;
+    DecodedFrameCache m_decodedFrameCache;
+
+    // Demuxers without an index of their own, e.g. for raw AAC, need to
+    // scan the stream when seeking. The positions of the key frames that
+    // have been read are added to the index of the stream instead.
+    bool m_addPacketIndexEntries;
 
     // FFmpeg static constants
     static constexpr AVSampleFormat s_avSampleFormat = AV_SAMPLE_FMT_FLT;
@@ -213,6 +225,10 @@ class SoundSourceFFmpeg : public SoundSource {
 
     AVFrame* m_pavResampledFrame;
 
+    // Interleaved floats of the decoded frame if the sample format has
+    // been converted without a resampling context
+    SampleBuffer m_convertedSampleBuffer;
+
     const unsigned int m_avutilVersion;
 };
 
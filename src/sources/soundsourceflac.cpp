@@ -104,7 +104,7 @@ SoundSource::OpenResult SoundSourceFLAC::tryOpen(
         OpenMode /*mode*/,
         const OpenParams& /*config*/) {
     DEBUG_ASSERT(!m_file.isOpen());
-    if (!m_file.open(QIODevice::ReadOnly)) {
+    if (!m_file.open()) {
         kLogger.warning()
                 << "Failed to open FLAC file:"
                 << m_file.fileName();
@@ -368,26 +368,17 @@ FLAC__StreamDecoderSeekStatus SoundSourceFLAC::flacSeek(FLAC__uint64 absolute_by
 }
 
 FLAC__StreamDecoderTellStatus SoundSourceFLAC::flacTell(FLAC__uint64* offset) {
-    if (m_file.isSequential()) {
-        return FLAC__STREAM_DECODER_TELL_STATUS_UNSUPPORTED;
-    }
     *offset = m_file.pos();
     return FLAC__STREAM_DECODER_TELL_STATUS_OK;
 }
 
 FLAC__StreamDecoderLengthStatus SoundSourceFLAC::flacLength(
         FLAC__uint64* length) {
-    if (m_file.isSequential()) {
-        return FLAC__STREAM_DECODER_LENGTH_STATUS_UNSUPPORTED;
-    }
     *length = m_file.size();
     return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
 }
 
 FLAC__bool SoundSourceFLAC::flacEOF() {
-    if (m_file.isSequential()) {
-        return false;
-    }
     return m_file.atEnd();
 }
 
@@ -1,5 +1,10 @@
 #include "sources/soundsourcemp3.h"
+
+#include <QDataStream>
+
+#include "sources/blockfilereader.h"
 #include "sources/mp3decoding.h"
+#include "sources/seektablecache.h"
 
 #include "util/logger.h"
 #include "util/math.h"
@@ -90,6 +95,12 @@ constexpr SINT kMaxMp3FramesPerSecond = 39; // fixed: 1 MP3 frame = 26 ms -> ~ 1
 constexpr SINT kSeekFrameListCapacity =
         kMinutesPerFile * kSecondsPerMinute * kMaxMp3FramesPerSecond;
 
+// Must be incremented when changing the serialization of the seek frame
+// list or how the frames are scanned, e.g. when no longer skipping the
+// MP3 info frame.
+constexpr int kSeekTableVersion = 1;
+const QString kSeekTableDecoder = QStringLiteral("mp3");
+
 inline QString formatHeaderFlags(int headerFlags) {
     return QString("0x%1").arg(headerFlags, 4, 16, QLatin1Char('0'));
 }
@@ -247,6 +258,30 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
     m_curFrameIndex = 0;
+
+    {
+        audio::ChannelCount channelCount;
+        audio::SampleRate sampleRate;
+        audio::Bitrate bitrate;
+        if (restoreSeekFrameList(&channelCount, &sampleRate, &bitrate)) {
+            initChannelCountOnce(channelCount);
+            initSampleRateOnce(sampleRate);
+            initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+            // The restored list is already terminated
+            m_avgSeekFrameCount = frameLength() /
+                    static_cast<SINT>(m_seekFrameList.size() - 1);
+            if (bitrate.isValid()) {
+                initBitrateOnce(bitrate);
+            }
+            restartDecoding(m_seekFrameList.front());
+            if (m_curFrameIndex == frameIndexMin()) {
+                return OpenResult::Succeeded;
+            }
+            kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+            return OpenResult::Failed;
+        }
+    }
+
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -484,9 +519,112 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         return OpenResult::Failed;
     }
 
+    storeSeekFrameList();
+
     return OpenResult::Succeeded;
 }
 
+bool SoundSourceMp3::restoreSeekFrameList(
+        audio::ChannelCount* pChannelCount,
+        audio::SampleRate* pSampleRate,
+        audio::Bitrate* pBitrate) {
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    if (static_cast<qint64>(m_fileSize) < SeekTableCache::kMinFileSize) {
+        return false;
+    }
+    const QByteArray data = SeekTableCache::load(
+            m_file.fileName(), kSeekTableDecoder, kSeekTableVersion);
+    if (data.isEmpty()) {
+        return false;
+    }
+    QDataStream stream(data);
+    qint32 channelCount;
+    qint32 sampleRate;
+    qint32 bitrate;
+    quint32 seekFrameCount;
+    stream >> channelCount >> sampleRate >> bitrate >> seekFrameCount;
+    *pChannelCount = audio::ChannelCount(channelCount);
+    *pSampleRate = audio::SampleRate(sampleRate);
+    *pBitrate = audio::Bitrate(bitrate);
+    if (stream.status() != QDataStream::Ok ||
+            !pChannelCount->isValid() ||
+            *pChannelCount > kChannelCountMax ||
+            !pSampleRate->isValid() ||
+            seekFrameCount == 0) {
+        return false;
+    }
+    // Frame indices and file offsets are stored as differences to those
+    // of the previous frame that compress very well
+    SINT frameIndex = 0;
+    quint64 fileOffset = 0;
+    m_seekFrameList.reserve(seekFrameCount + 1);
+    for (quint32 i = 0; i < seekFrameCount; ++i) {
+        quint32 frameIndexDelta;
+        quint32 fileOffsetDelta;
+        stream >> frameIndexDelta >> fileOffsetDelta;
+        if (stream.status() != QDataStream::Ok ||
+                (i > 0 && (frameIndexDelta == 0 || fileOffsetDelta == 0))) {
+            m_seekFrameList.clear();
+            return false;
+        }
+        frameIndex += frameIndexDelta;
+        fileOffset += fileOffsetDelta;
+        if (fileOffset >= m_fileSize || (i == 0 && frameIndex != 0)) {
+            m_seekFrameList.clear();
+            return false;
+        }
+        addSeekFrame(frameIndex, m_pFileData + fileOffset);
+    }
+    quint32 frameIndexDelta;
+    stream >> frameIndexDelta;
+    if (stream.status() != QDataStream::Ok || frameIndexDelta == 0) {
+        m_seekFrameList.clear();
+        return false;
+    }
+    m_curFrameIndex = frameIndex + frameIndexDelta;
+    // Terminate m_seekFrameList
+    addSeekFrame(m_curFrameIndex, nullptr);
+    kLogger.debug()
+            << "Restored"
+            << seekFrameCount
+            << "seek frames of"
+            << m_file.fileName();
+    return true;
+}
+
+void SoundSourceMp3::storeSeekFrameList() const {
+    if (static_cast<qint64>(m_fileSize) < SeekTableCache::kMinFileSize) {
+        return;
+    }
+    DEBUG_ASSERT(m_seekFrameList.size() > 1);
+    DEBUG_ASSERT(m_seekFrameList.back().pInputData == nullptr);
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    const auto seekFrameCount = static_cast<quint32>(m_seekFrameList.size() - 1);
+    stream << static_cast<qint32>(getSignalInfo().getChannelCount())
+           << static_cast<qint32>(getSignalInfo().getSampleRate())
+           << static_cast<qint32>(getBitrate())
+           << seekFrameCount;
+    SINT frameIndex = 0;
+    const unsigned char* pInputData = m_pFileData;
+    for (quint32 i = 0; i < seekFrameCount; ++i) {
+        const SeekFrameType& seekFrame = m_seekFrameList[i];
+        if (seekFrame.pInputData < m_pFileData ||
+                seekFrame.pInputData >= m_pFileData + m_fileSize) {
+            // The last frame might have been copied into the leftover
+            // buffer and can't be restored
+            return;
+        }
+        stream << static_cast<quint32>(seekFrame.frameIndex - frameIndex)
+               << static_cast<quint32>(seekFrame.pInputData - pInputData);
+        frameIndex = seekFrame.frameIndex;
+        pInputData = seekFrame.pInputData;
+    }
+    stream << static_cast<quint32>(m_seekFrameList.back().frameIndex - frameIndex);
+    SeekTableCache::store(
+            m_file.fileName(), kSeekTableDecoder, kSeekTableVersion, data);
+}
+
 void SoundSourceMp3::close() {
     finishDecoding();
 
@@ -528,7 +666,15 @@ void SoundSourceMp3::restartDecoding(
     }
 
     // Fill input buffer
-    mad_stream_buffer(&m_madStream, seekFrame.pInputData, m_fileSize - (seekFrame.pInputData - m_pFileData));
+    const auto remainingInputSize =
+            m_fileSize - (seekFrame.pInputData - m_pFileData);
+    mad_stream_buffer(&m_madStream, seekFrame.pInputData, remainingInputSize);
+    // Prefetch the mapped input data after the seek position instead of
+    // faulting in one page after another, e.g. from network storage
+    BlockFileReader::adviseWillNeed(
+            seekFrame.pInputData,
+            std::min(static_cast<qint64>(remainingInputSize),
+                    BlockFileReader::kReadAheadBlocks * BlockFileReader::kBlockSize));
 
     if (frameIndexMin() < seekFrame.frameIndex) {
         // Muting is done here to eliminate potential pops/clicks
@@ -53,6 +53,14 @@ class SoundSourceMp3 final : public SoundSource {
 
     void addSeekFrame(SINT frameIndex, const unsigned char* pInputData);
 
+    /// Restores the terminated seek frame list of a previous scan from
+    /// the SeekTableCache instead of scanning the whole file again.
+    bool restoreSeekFrameList(
+            audio::ChannelCount* pChannelCount,
+            audio::SampleRate* pSampleRate,
+            audio::Bitrate* pBitrate);
+    void storeSeekFrameList() const;
+
     /** Returns the position in m_seekFrameList of the requested frame index. */
     SINT findSeekFrameIndex(SINT frameIndex) const;
 
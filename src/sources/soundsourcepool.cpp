@@ -0,0 +1,276 @@
+#include "sources/soundsourcepool.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <vector>
+
+#include "sources/audiosourceproxy.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourcePool");
+
+// Each idle source keeps a file handle and the decoder state. On Windows
+// open files can neither be deleted nor renamed, also not by other
+// applications, so no idle sources are kept there.
+#if defined(__WINDOWS__)
+constexpr std::size_t kMaxIdleSources = 0;
+#else
+constexpr std::size_t kMaxIdleSources = 8;
+#endif
+
+constexpr qint64 kMaxIdleMillis = 60 * 1000;
+
+constexpr int kMaxProbes = 256;
+
+// Modifications of a file are detected by comparing its size and
+// its modification time. Unlike SeekTableCache the content is not
+// hashed, because the pool only lives as long as the process.
+struct FileStamp {
+    qint64 size = -1;
+    qint64 lastModified = -1;
+
+    static FileStamp of(const QString& filePath) {
+        const QFileInfo fileInfo(filePath);
+        if (!fileInfo.exists()) {
+            return FileStamp();
+        }
+        return FileStamp{
+                fileInfo.size(),
+                fileInfo.lastModified().toMSecsSinceEpoch()};
+    }
+
+    bool isValid() const {
+        return size >= 0;
+    }
+
+    bool operator==(const FileStamp& other) const {
+        return size == other.size && lastModified == other.lastModified;
+    }
+};
+
+struct IdleSource {
+    QString filePath;
+    FileStamp fileStamp;
+    audio::SignalInfo openSignalInfo;
+    SoundSourceProviderPointer pProvider;
+    SoundSourcePointer pSoundSource;
+    QElapsedTimer idleTimer;
+};
+
+struct ProbeEntry {
+    FileStamp fileStamp;
+    SoundSourcePool::Probe probe;
+};
+
+QMutex s_mutex;
+// Ordered from least to most recently used
+std::vector<IdleSource> s_idleSources;
+QHash<QString, ProbeEntry> s_probes;
+
+// Must be invoked while holding s_mutex. The removed sources are
+// appended to pClosing and must be closed after unlocking.
+void removeExpiredIdleSources(std::vector<SoundSourcePointer>* pClosing) {
+    auto i = s_idleSources.begin();
+    while (i != s_idleSources.end()) {
+        if (i->idleTimer.hasExpired(kMaxIdleMillis)) {
+            pClosing->push_back(std::move(i->pSoundSource));
+            i = s_idleSources.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void closeAll(const std::vector<SoundSourcePointer>& soundSources) {
+    for (const auto& pSoundSource : soundSources) {
+        pSoundSource->close();
+    }
+}
+
+void release(IdleSource&& idleSource) {
+    std::vector<SoundSourcePointer> closing;
+    {
+        QMutexLocker locker(&s_mutex);
+        removeExpiredIdleSources(&closing);
+        idleSource.idleTimer.start();
+        s_idleSources.push_back(std::move(idleSource));
+        while (s_idleSources.size() > kMaxIdleSources) {
+            closing.push_back(std::move(s_idleSources.front().pSoundSource));
+            s_idleSources.erase(s_idleSources.begin());
+        }
+    }
+    closeAll(closing);
+}
+
+// Closing returns the wrapped SoundSource into the pool. The source
+// is only released once, subsequent invocations of close() are ignored.
+class PooledAudioSource : public AudioSourceProxy {
+  public:
+    explicit PooledAudioSource(
+            IdleSource&& idleSource)
+            : AudioSourceProxy(AudioSourcePointer(idleSource.pSoundSource)),
+              m_idleSource(std::move(idleSource)) {
+    }
+
+    void close() override {
+        if (!m_idleSource.pSoundSource) {
+            return;
+        }
+        release(std::move(m_idleSource));
+        m_idleSource.pSoundSource.reset();
+    }
+
+  private:
+    IdleSource m_idleSource;
+};
+
+} // anonymous namespace
+
+// static
+SoundSourcePointer SoundSourcePool::take(
+        const QString& filePath,
+        const AudioSource::OpenParams& params,
+        SoundSourceProviderPointer* pProvider) {
+    DEBUG_ASSERT(pProvider);
+    const auto fileStamp = FileStamp::of(filePath);
+    if (!fileStamp.isValid()) {
+        return nullptr;
+    }
+    SoundSourcePointer pSoundSource;
+    std::vector<SoundSourcePointer> closing;
+    {
+        QMutexLocker locker(&s_mutex);
+        removeExpiredIdleSources(&closing);
+        for (auto i = s_idleSources.rbegin(); i != s_idleSources.rend(); ++i) {
+            if (i->filePath != filePath ||
+                    i->openSignalInfo != params.getSignalInfo() ||
+                    (*pProvider && i->pProvider != *pProvider)) {
+                continue;
+            }
+            if (i->fileStamp == fileStamp) {
+                *pProvider = std::move(i->pProvider);
+                pSoundSource = std::move(i->pSoundSource);
+            } else {
+                // The file has been modified since
+                closing.push_back(std::move(i->pSoundSource));
+            }
+            s_idleSources.erase(std::next(i).base());
+            break;
+        }
+    }
+    closeAll(closing);
+    if (pSoundSource && kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Reusing open SoundSource for file"
+                << filePath;
+    }
+    return pSoundSource;
+}
+
+// static
+AudioSourcePointer SoundSourcePool::lease(
+        const QString& filePath,
+        const AudioSource::OpenParams& params,
+        SoundSourceProviderPointer pProvider,
+        SoundSourcePointer pSoundSource) {
+    DEBUG_ASSERT(pProvider);
+    DEBUG_ASSERT(pSoundSource);
+    return std::make_shared<PooledAudioSource>(IdleSource{
+            filePath,
+            FileStamp::of(filePath),
+            params.getSignalInfo(),
+            std::move(pProvider),
+            std::move(pSoundSource),
+            QElapsedTimer()});
+}
+
+// static
+void SoundSourcePool::evict(const QString& filePath) {
+    std::vector<SoundSourcePointer> closing;
+    {
+        QMutexLocker locker(&s_mutex);
+        auto i = s_idleSources.begin();
+        while (i != s_idleSources.end()) {
+            if (i->filePath == filePath) {
+                closing.push_back(std::move(i->pSoundSource));
+                i = s_idleSources.erase(i);
+            } else {
+                ++i;
+            }
+        }
+        s_probes.remove(filePath);
+    }
+    closeAll(closing);
+}
+
+// static
+void SoundSourcePool::evictDirectory(const QString& dirPath) {
+    const QString prefix = dirPath.endsWith(QChar('/')) ? dirPath : dirPath + QChar('/');
+    std::vector<SoundSourcePointer> closing;
+    {
+        QMutexLocker locker(&s_mutex);
+        auto i = s_idleSources.begin();
+        while (i != s_idleSources.end()) {
+            if (i->filePath.startsWith(prefix)) {
+                closing.push_back(std::move(i->pSoundSource));
+                i = s_idleSources.erase(i);
+            } else {
+                ++i;
+            }
+        }
+        auto j = s_probes.begin();
+        while (j != s_probes.end()) {
+            if (j.key().startsWith(prefix)) {
+                j = s_probes.erase(j);
+            } else {
+                ++j;
+            }
+        }
+    }
+    closeAll(closing);
+}
+
+// static
+std::optional<SoundSourcePool::Probe> SoundSourcePool::probe(
+        const QString& filePath) {
+    const auto fileStamp = FileStamp::of(filePath);
+    QMutexLocker locker(&s_mutex);
+    const auto i = s_probes.constFind(filePath);
+    if (i == s_probes.constEnd()) {
+        return std::nullopt;
+    }
+    if (!fileStamp.isValid() || !(i->fileStamp == fileStamp)) {
+        s_probes.erase(i);
+        return std::nullopt;
+    }
+    return i->probe;
+}
+
+// static
+void SoundSourcePool::storeProbe(
+        const QString& filePath,
+        SoundSourceProviderPointer pProvider,
+        const audio::StreamInfo& streamInfo) {
+    const auto fileStamp = FileStamp::of(filePath);
+    if (!fileStamp.isValid()) {
+        return;
+    }
+    QMutexLocker locker(&s_mutex);
+    if (s_probes.size() >= kMaxProbes && !s_probes.contains(filePath)) {
+        // Probes are cheap to recreate, an arbitrary entry is dropped
+        s_probes.erase(s_probes.begin());
+    }
+    s_probes.insert(filePath,
+            ProbeEntry{
+                    fileStamp,
+                    Probe{std::move(pProvider), streamInfo}});
+}
+
+} // namespace mixxx
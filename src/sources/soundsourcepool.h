@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QString>
+#include <optional>
+
+#include "sources/soundsourceprovider.h"
+
+namespace mixxx {
+
+/// SoundSourcePool keeps recently used SoundSources open for reuse, because
+/// opening a file is expensive for some decoders, e.g. FFmpeg needs to probe
+/// the container and the codec. Loading the same samples and jingles again
+/// and again into sampler and preview decks then doesn't need to reopen the
+/// file every time.
+///
+/// Closing an AudioSource that has been wrapped by lease() returns the open
+/// SoundSource into the pool instead of closing it. Only a few idle sources
+/// are kept open, and sources that have been idle for a while are closed.
+/// A source is only reused if the file has not been modified since it has
+/// been opened, i.e. if both its size and its modification time are
+/// unchanged.
+///
+/// Additionally the pool remembers the probe results of the files that have
+/// been opened, i.e. the provider that could open the file and the stream
+/// info, for skipping providers that failed before and for avoiding to open
+/// a file just for obtaining its stream info.
+///
+/// All functions are thread-safe.
+class SoundSourcePool final {
+  public:
+    struct Probe {
+        SoundSourceProviderPointer pProvider;
+        audio::StreamInfo streamInfo;
+    };
+
+    /// Takes an idle SoundSource for the file out of the pool. Only sources
+    /// that have been opened with the same parameters are returned. If
+    /// pProvider is set only sources of this provider are returned.
+    /// Otherwise pProvider receives the provider of the returned source.
+    ///
+    /// Returns nullptr if no matching source is available.
+    static SoundSourcePointer take(
+            const QString& filePath,
+            const AudioSource::OpenParams& params,
+            SoundSourceProviderPointer* pProvider);
+
+    /// Wraps an open SoundSource. Closing the returned AudioSource
+    /// returns the SoundSource into the pool.
+    static AudioSourcePointer lease(
+            const QString& filePath,
+            const AudioSource::OpenParams& params,
+            SoundSourceProviderPointer pProvider,
+            SoundSourcePointer pSoundSource);
+
+    /// Closes all idle sources of the file and forgets its probe
+    /// results. Must be invoked before writing into, deleting, moving or
+    /// renaming the file.
+    static void evict(const QString& filePath);
+
+    /// Like evict() for all files within the directory, including its
+    /// subdirectories.
+    static void evictDirectory(const QString& dirPath);
+
+    static std::optional<Probe> probe(
+            const QString& filePath);
+
+    static void storeProbe(
+            const QString& filePath,
+            SoundSourceProviderPointer pProvider,
+            const audio::StreamInfo& streamInfo);
+};
+
+} // namespace mixxx
@@ -6,6 +6,7 @@
 #include <QStandardPaths>
 
 #include "sources/audiosourcetrackproxy.h"
+#include "sources/soundsourcepool.h"
 
 #ifdef __MAD__
 #include "sources/soundsourcemp3.h"
@@ -391,6 +392,8 @@ SoundSourceProxy::exportTrackMetadataBeforeSaving(
         const SyncTrackMetadataParams& syncParams) {
     DEBUG_ASSERT(pTrack);
     const auto fileInfo = pTrack->getFileInfo();
+    // Idle decoders must not keep the file open while writing
+    mixxx::SoundSourcePool::evict(fileInfo.location());
     mixxx::SoundSourcePointer pSoundSource;
     {
         auto proxy = SoundSourceProxy(fileInfo.toQUrl());
@@ -549,6 +552,28 @@ bool SoundSourceProxy::initSoundSourceWithProvider(
     return true;
 }
 
+void SoundSourceProxy::initSoundSourceWithProbedProvider(
+        const mixxx::SoundSourceProviderPointer& pProbedProvider) {
+    if (!pProbedProvider || pProbedProvider == m_pProvider) {
+        return;
+    }
+    for (int i = 0; i < m_providerRegistrations.size(); ++i) {
+        if (m_providerRegistrations[i].getProvider() != pProbedProvider) {
+            continue;
+        }
+        // Skip the providers that failed to open the file before. The
+        // remaining providers are still tried if opening fails this time.
+        auto pProvider = pProbedProvider;
+        m_pProvider.reset();
+        m_pSoundSource.reset();
+        m_providerRegistrationIndex = i;
+        if (!initSoundSourceWithProvider(std::move(pProvider))) {
+            findProviderAndInitSoundSource();
+        }
+        return;
+    }
+}
+
 namespace {
 
 inline std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
@@ -590,6 +615,41 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
             resetMissingTagMetadata);
 }
 
+// static
+SoundSourceProxy::PreparedTrackSourcePointer SoundSourceProxy::prepareTrackSourceFromFile(
+        mixxx::FileAccess trackFileAccess,
+        bool resetMissingTagMetadata) {
+    if (!trackFileAccess.info().checkFileExists()) {
+        return nullptr;
+    }
+    {
+        GlobalTrackCacheLocker locker;
+        if (locker.lookupTrackByRef(TrackRef::fromFileInfo(trackFileAccess.info()))) {
+            // The metadata of a cached track object might be written
+            // into the file concurrently
+            return nullptr;
+        }
+    }
+    const QDateTime modifiedBefore = mixxx::MetadataSource::getFileSynchronizedAt(
+            trackFileAccess.info().toQFile());
+    // The temporary track object is not managed by GlobalTrackCache
+    const auto pTrack = Track::newTemporary(std::move(trackFileAccess));
+    auto pPreparedSource = std::make_shared<PreparedTrackSource>();
+    pPreparedSource->resetMissingTagMetadata = resetMissingTagMetadata;
+    const auto [importResult, sourceSynchronizedAt] =
+            SoundSourceProxy(pTrack).importTrackMetadataAndCoverImage(
+                    &pPreparedSource->trackMetadata,
+                    &pPreparedSource->coverImage,
+                    resetMissingTagMetadata);
+    if (importResult != mixxx::MetadataSource::ImportResult::Succeeded ||
+            !sourceSynchronizedAt.isValid() ||
+            sourceSynchronizedAt != modifiedBefore) {
+        return nullptr;
+    }
+    pPreparedSource->sourceSynchronizedAt = sourceSynchronizedAt;
+    return pPreparedSource;
+}
+
 std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
 SoundSourceProxy::importTrackMetadataAndCoverImage(
         mixxx::TrackMetadata* pTrackMetadata,
@@ -635,7 +695,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const PreparedTrackSource* pPreparedSource) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -705,13 +766,31 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
+    // The prepared source has been imported from the file of a new track
+    // with default values, like a full import would do here
+    const bool usePreparedSource = pPreparedSource &&
+            sourceSyncStatus == mixxx::TrackRecord::SourceSyncStatus::Void &&
+            pCoverImg &&
+            pPreparedSource->resetMissingTagMetadata ==
+                    syncParams.resetMissingTagMetadataOnImport &&
+            trackMetadata == mixxx::TrackMetadata() &&
+            pPreparedSource->sourceSynchronizedAt ==
+                    mixxx::MetadataSource::getFileSynchronizedAt(
+                            m_pTrack->getFileInfo().toQFile());
+
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    auto [metadataImportResult, sourceSynchronizedAt] = usePreparedSource
+            ? std::make_pair(mixxx::MetadataSource::ImportResult::Succeeded,
+                      pPreparedSource->sourceSynchronizedAt)
+            : importTrackMetadataAndCoverImage(
+                      &trackMetadata,
+                      pCoverImg,
+                      syncParams.resetMissingTagMetadataOnImport);
+    if (usePreparedSource) {
+        trackMetadata = pPreparedSource->trackMetadata;
+        coverImg = pPreparedSource->coverImage;
+    }
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -842,20 +921,28 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
     const bool pendingCueImport =
             m_pTrack->getCueImportStatus() == Track::ImportStatus::Pending;
     if (pendingBeatsImport || pendingCueImport) {
-        // Try to open the audio source once to determine the actual
-        // stream properties for finishing the pending import.
-        kLogger.debug()
-                << "Opening audio source to finish import of beats/cues";
-        const auto pAudioSource = openAudioSource();
-        DEBUG_ASSERT(!pAudioSource ||
-                m_pTrack->getBeatsImportStatus() ==
-                        Track::ImportStatus::Complete);
-        DEBUG_ASSERT(!pAudioSource ||
-                m_pTrack->getCueImportStatus() ==
-                        Track::ImportStatus::Complete);
-        if (pAudioSource) {
-            // Close open file handles
-            pAudioSource->close();
+        const auto probe = mixxx::SoundSourcePool::probe(
+                m_pTrack->getFileInfo().location());
+        if (probe) {
+            // The actual stream properties are still known from
+            // opening the unmodified file before
+            m_pTrack->updateStreamInfoFromSource(probe->streamInfo);
+        } else {
+            // Try to open the audio source once to determine the actual
+            // stream properties for finishing the pending import.
+            kLogger.debug()
+                    << "Opening audio source to finish import of beats/cues";
+            const auto pAudioSource = openAudioSource();
+            DEBUG_ASSERT(!pAudioSource ||
+                    m_pTrack->getBeatsImportStatus() ==
+                            Track::ImportStatus::Complete);
+            DEBUG_ASSERT(!pAudioSource ||
+                    m_pTrack->getCueImportStatus() ==
+                            Track::ImportStatus::Complete);
+            if (pAudioSource) {
+                // Close open file handles
+                pAudioSource->close();
+            }
         }
     }
 
@@ -944,11 +1031,32 @@ mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return nullptr;
     }
-    if (!openSoundSource(params)) {
-        return nullptr;
+    const QString filePath = m_pTrack->getFileInfo().location();
+    // A provider that has been selected explicitly must be respected
+    mixxx::SoundSourceProviderPointer pPooledProvider =
+            m_providerRegistrationIndex < 0 ? m_pProvider : nullptr;
+    auto pPooledSoundSource = mixxx::SoundSourcePool::take(
+            filePath, params, &pPooledProvider);
+    if (pPooledSoundSource) {
+        m_pProvider = std::move(pPooledProvider);
+        m_pSoundSource = std::move(pPooledSoundSource);
+    } else {
+        if (m_providerRegistrationIndex >= 0) {
+            const auto probe = mixxx::SoundSourcePool::probe(filePath);
+            if (probe) {
+                initSoundSourceWithProbedProvider(probe->pProvider);
+            }
+        }
+        if (!openSoundSource(params)) {
+            return nullptr;
+        }
+        mixxx::SoundSourcePool::storeProbe(
+                filePath, m_pProvider, m_pSoundSource->getStreamInfo());
     }
     // Overwrite metadata with actual audio properties
     m_pTrack->updateStreamInfoFromSource(
             m_pSoundSource->getStreamInfo());
-    return mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
+    return mixxx::AudioSourceTrackProxy::create(m_pTrack,
+            mixxx::SoundSourcePool::lease(
+                    filePath, params, m_pProvider, m_pSoundSource));
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <QMimeType>
+#include <memory>
 
+#include "sources/metadatasource.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
 
@@ -105,6 +107,32 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata);
 
+    /// Track metadata and cover image of a new track that have been
+    /// imported from its file in advance, see prepareTrackSourceFromFile().
+    struct PreparedTrackSource {
+        mixxx::TrackMetadata trackMetadata;
+        QImage coverImage;
+        QDateTime sourceSynchronizedAt;
+        bool resetMissingTagMetadata = false;
+    };
+    typedef std::shared_ptr<const PreparedTrackSource> PreparedTrackSourcePointer;
+
+    /// Import the track metadata and the cover image of a file that has
+    /// not been added to the library yet, before actually adding it.
+    ///
+    /// This function is thread-safe and can be invoked from multiple
+    /// threads concurrently. Unlike importTrackMetadataAndCoverImageFromFile()
+    /// it doesn't keep GlobalTrackCache locked while reading. Instead it
+    /// ensures that the file has not been modified while reading it, and
+    /// updateTrackFromSource() checks that it has not been modified since.
+    ///
+    /// Returns nullptr if the file is currently in use or if the import
+    /// failed. The metadata then needs to be imported when adding the
+    /// track as usual.
+    static PreparedTrackSourcePointer prepareTrackSourceFromFile(
+            mixxx::FileAccess trackFileAccess,
+            bool resetMissingTagMetadata);
+
     /// Import both track metadata and/or the cover image of the
     /// captured track object from the corresponding file.
     ///
@@ -173,9 +201,13 @@ class SoundSourceProxy {
     /// analysis in case unexpected behavior has been reported.
     ///
     /// Returns true if the track has been modified and false otherwise.
+    ///
+    /// The prepared source of a new track is used instead of reading
+    /// the file again if it is still up-to-date.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const PreparedTrackSource* pPreparedSource = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
@@ -186,6 +218,9 @@ class SoundSourceProxy {
     /// last reference is dropped. One of these references is hold
     /// by SoundSourceProxy as a member.
     ///
+    /// Closing returns the decoder into SoundSourcePool, which keeps
+    /// it open for a while in case the file is opened again.
+    ///
     /// Note: If opening the audio stream fails the selection
     /// process may continue among the available providers and
     /// sound sources might be resumed and continue until a
@@ -228,6 +263,11 @@ class SoundSourceProxy {
     bool initSoundSourceWithProvider(
             mixxx::SoundSourceProviderPointer&& pProvider);
 
+    /// Continues with the provider that has opened the file before
+    /// instead of the primary provider.
+    void initSoundSourceWithProbedProvider(
+            const mixxx::SoundSourceProviderPointer& pProbedProvider);
+
     mixxx::SoundSourceProviderPointer primaryProvider();
     mixxx::SoundSourceProviderPointer nextProvider();
     std::pair<mixxx::SoundSourceProviderPointer, mixxx::SoundSource::OpenMode>
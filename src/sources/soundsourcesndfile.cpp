@@ -1,6 +1,6 @@
 #include "sources/soundsourcesndfile.h"
 
-#include <QDir>
+#include <cstdio>
 
 #include "util/logger.h"
 #include "util/semanticversion.h"
@@ -40,6 +40,54 @@ QStringList getSupportedFileTypesFiltered() {
     return supportedFileTypes;
 };
 
+// Virtual I/O through BlockFileReader instead of stdio
+sf_count_t sfGetFileLength(void* pUserData) {
+    return static_cast<BlockFileReader*>(pUserData)->size();
+}
+
+sf_count_t sfSeek(sf_count_t offset, int whence, void* pUserData) {
+    auto* pFileReader = static_cast<BlockFileReader*>(pUserData);
+    switch (whence) {
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        offset += pFileReader->pos();
+        break;
+    case SEEK_END:
+        offset += pFileReader->size();
+        break;
+    default:
+        return -1;
+    }
+    if (!pFileReader->seek(offset)) {
+        return -1;
+    }
+    return offset;
+}
+
+sf_count_t sfRead(void* pData, sf_count_t count, void* pUserData) {
+    const qint64 readSize = static_cast<BlockFileReader*>(pUserData)->read(
+            static_cast<char*>(pData), count);
+    return readSize < 0 ? 0 : readSize;
+}
+
+sf_count_t sfWrite(const void* /*pData*/, sf_count_t /*count*/, void* /*pUserData*/) {
+    // Read-only
+    return 0;
+}
+
+sf_count_t sfTell(void* pUserData) {
+    return static_cast<BlockFileReader*>(pUserData)->pos();
+}
+
+SF_VIRTUAL_IO s_virtualIO = {
+        sfGetFileLength,
+        sfSeek,
+        sfRead,
+        sfWrite,
+        sfTell,
+};
+
 } // anonymous namespace
 
 //static
@@ -67,6 +115,7 @@ SoundSourceProviderPriority SoundSourceProviderSndFile::getPriorityHint(
 
 SoundSourceSndFile::SoundSourceSndFile(const QUrl& url)
         : SoundSource(url),
+          m_file(getLocalFileName()),
           m_pSndFile(nullptr),
           m_curFrameIndex(0) {
 }
@@ -79,21 +128,14 @@ SoundSource::OpenResult SoundSourceSndFile::tryOpen(
         OpenMode /*mode*/,
         const OpenParams& /*config*/) {
     DEBUG_ASSERT(!m_pSndFile);
+    // The file is opened by Qt, which also takes care of
+    // Unicode file names on Windows
+    if (!m_file.open()) {
+        return OpenResult::Failed;
+    }
     SF_INFO sfInfo;
     memset(&sfInfo, 0, sizeof(sfInfo));
-#ifdef __WINDOWS__
-    // Note: we cannot use QString::toStdWString since QT 4 is compiled with
-    // '/Zc:wchar_t-' flag and QT 5 not
-    const QString localFileName(QDir::toNativeSeparators(getLocalFileName()));
-    const ushort* const fileNameUtf16 = localFileName.utf16();
-    static_assert(sizeof(wchar_t) == sizeof(ushort), "QString::utf16(): wchar_t and ushort have different sizes");
-    m_pSndFile = sf_wchar_open(
-            reinterpret_cast<wchar_t*>(const_cast<ushort*>(fileNameUtf16)),
-            SFM_READ,
-            &sfInfo);
-#else
-    m_pSndFile = sf_open(QFile::encodeName(getLocalFileName()), SFM_READ, &sfInfo);
-#endif
+    m_pSndFile = sf_open_virtual(&s_virtualIO, SFM_READ, &sfInfo, &m_file);
 
     switch (sf_error(m_pSndFile)) {
     case SF_ERR_NO_ERROR:
@@ -137,6 +179,7 @@ void SoundSourceSndFile::close() {
                               << getUrlString();
         }
     }
+    m_file.close();
 }
 
 ReadableSampleFrames SoundSourceSndFile::readSampleFramesClamped(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sources/blockfilereader.h"
 #include "sources/soundsourceprovider.h"
 
 #ifdef Q_OS_WIN
@@ -28,6 +29,8 @@ class SoundSourceSndFile final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    BlockFileReader m_file;
+
     SNDFILE* m_pSndFile;
 
     SINT m_curFrameIndex;
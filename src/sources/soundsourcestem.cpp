@@ -11,6 +11,8 @@ extern "C" {
 
 } // extern "C"
 
+#include <memory>
+
 #include "util/assert.h"
 #include "util/logger.h"
 #include "util/sample.h"
@@ -29,6 +31,12 @@ constexpr int kRequiredStreamCount = kNumStreams - 1; // Stem count doesn't incl
 
 const Logger kLogger("SoundSourceSTEM");
 
+struct InputFileCloser {
+    void operator()(AVFormatContext* pavInputFormatContext) const {
+        SoundSourceFFmpeg::closeInputFile(&pavInputFormatContext);
+    }
+};
+
 } // anonymous namespace
 
 const QString SoundSourceProviderSTEM::kDisplayName = QStringLiteral("STEM with FFmpeg");
@@ -273,12 +281,16 @@ SoundSource::OpenResult SoundSourceSingleSTEM::tryOpen(
 #if VERBOSE_DEBUG_LOG
     kLogger.debug() << "Frame buffer capacity:" << m_frameBuffer.capacity();
 #endif
+    m_decodedFrameCache = decodedFrameCacheForSignal(getSignalInfo());
 
     return OpenResult::Succeeded;
 }
 
 SoundSourceSTEM::SoundSourceSTEM(const QUrl& url)
-        : SoundSource(url) {
+        : SoundSource(url),
+          m_openedStems(0),
+          m_failedStems(0),
+          m_selectedChannelPairs(kAllChannelPairs) {
 }
 
 SoundSource::OpenResult SoundSourceSTEM::tryOpen(
@@ -293,6 +305,10 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
                 << getLocalFileName();
         return OpenResult::Failed;
     }
+    // The streams are opened separately, this context is only needed
+    // for inspecting them and must be closed when returning
+    const std::unique_ptr<AVFormatContext, InputFileCloser> inputFileCloser(
+            pavInputFormatContext);
 #if VERBOSE_DEBUG_LOG
     kLogger.debug()
             << "AVFormatContext"
@@ -321,8 +337,8 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
     bool openInStereo = params.getSignalInfo().getChannelCount() ==
             mixxx::audio::ChannelCount::stereo();
     int stemCount = 0;
-    OpenParams stemParam = params;
-    stemParam.setChannelCount(mixxx::audio::ChannelCount::stereo());
+    m_stemOpenParams = params;
+    m_stemOpenParams.setChannelCount(mixxx::audio::ChannelCount::stereo());
     for (unsigned int streamIdx = 0; streamIdx < pavInputFormatContext->nb_streams; streamIdx++) {
         if (pavInputFormatContext->streams[streamIdx]->codecpar->codec_type !=
                 AVMEDIA_TYPE_AUDIO) {
@@ -344,10 +360,12 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
         if (!firstAudioStream) {
             firstAudioStream = pavInputFormatContext->streams[streamIdx];
 
-            // If the stem file is requested into a stereo format, then we keep
-            // the main mix, otherwise we continue to iterate to find the stems
-            if (!openInStereo) {
-                continue;
+            // The main mix is needed in both modes, either as the only
+            // stream or until any stem is selected
+            m_pMainMix = std::make_unique<SoundSourceSingleSTEM>(getUrl(), streamIdx);
+            if (m_pMainMix->open(OpenMode::Strict /*Unused*/,
+                        m_stemOpenParams) != OpenResult::Succeeded) {
+                return OpenResult::Failed;
             }
         } else {
             if (pavInputFormatContext->streams[streamIdx]->codecpar->codec_id !=
@@ -367,17 +385,13 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
             stemCount++;
 
             // If the stem file is requested into a stereo format, then just
-            // count the stems to ensure the right format
-            if (openInStereo) {
-                continue;
+            // count the stems to ensure the right format. Otherwise the
+            // stems are opened when they are selected for the first time.
+            if (!openInStereo) {
+                m_pStems.emplace_back(std::make_unique<SoundSourceSingleSTEM>(
+                        getUrl(), streamIdx));
             }
         }
-
-        m_pStereoStreams.emplace_back(std::make_unique<SoundSourceSingleSTEM>(getUrl(), streamIdx));
-        if (m_pStereoStreams.back()->open(OpenMode::Strict /*Unused*/,
-                    stemParam) != OpenResult::Succeeded) {
-            return OpenResult::Failed;
-        }
     }
 
     if (stemCount != kRequiredStreamCount) {
@@ -389,37 +403,91 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
     }
 
     if (openInStereo) {
-        DEBUG_ASSERT(m_pStereoStreams.size() == 1);
+        DEBUG_ASSERT(m_pStems.empty());
         // Requesting a stereo stream (used for analysis)
-        initChannelCountOnce(m_pStereoStreams.front()->getSignalInfo().getChannelCount());
+        initChannelCountOnce(m_pMainMix->getSignalInfo().getChannelCount());
     } else {
         // No special channel format request
         initChannelCountOnce(
                 mixxx::audio::ChannelCount::stereo() *
-                m_pStereoStreams.size());
+                m_pStems.size());
     }
 
-    initSampleRateOnce(m_pStereoStreams.front()->getSignalInfo().getSampleRate());
-    initBitrateOnce(m_pStereoStreams.front()->getBitrate());
-    initFrameIndexRangeOnce(m_pStereoStreams.front()->frameIndexRange());
+    // All streams share the same properties, the stems are supposed
+    // to be aligned with the main mix
+    initSampleRateOnce(m_pMainMix->getSignalInfo().getSampleRate());
+    initBitrateOnce(m_pMainMix->getBitrate());
+    initFrameIndexRangeOnce(m_pMainMix->frameIndexRange());
 
     return OpenResult::Succeeded;
 }
 
 void SoundSourceSTEM::close() {
-    for (auto& stream : m_pStereoStreams) {
+    if (m_pMainMix) {
+        m_pMainMix->close();
+    }
+    for (auto& stream : m_pStems) {
         stream->close();
     }
+    m_openedStems = 0;
+    m_failedStems = 0;
+}
+
+SoundSourceSingleSTEM* SoundSourceSTEM::openedStem(int stemIdx) {
+    const ChannelPairs stemBit = ChannelPairs{1} << stemIdx;
+    if (m_openedStems & stemBit) {
+        return m_pStems[stemIdx].get();
+    }
+    if (m_failedStems & stemBit) {
+        return nullptr;
+    }
+    if (m_pStems[stemIdx]->open(OpenMode::Strict /*Unused*/,
+                m_stemOpenParams) != OpenResult::Succeeded) {
+        kLogger.warning()
+                << "Failed to open stem"
+                << stemIdx
+                << "of"
+                << getLocalFileName();
+        m_failedStems |= stemBit;
+        return nullptr;
+    }
+    if (m_pStems[stemIdx]->frameIndexRange() != frameIndexRange()) {
+        kLogger.debug()
+                << "Frame index range of stem"
+                << stemIdx
+                << "differs from the main mix:"
+                << m_pStems[stemIdx]->frameIndexRange()
+                << "!="
+                << frameIndexRange();
+    }
+    m_openedStems |= stemBit;
+    return m_pStems[stemIdx].get();
+}
+
+AudioSource::ChannelPairs SoundSourceSTEM::selectChannelPairs(ChannelPairs channelPairs) {
+    if (m_pStems.empty()) {
+        // Opened in stereo mode, the main mix is the only channel pair
+        return kAllChannelPairs;
+    }
+    const ChannelPairs allStems = (ChannelPairs{1} << m_pStems.size()) - 1;
+    if (channelPairs == kPremixedChannelPairs) {
+        m_selectedChannelPairs = kPremixedChannelPairs;
+    } else if ((channelPairs & allStems) == allStems) {
+        m_selectedChannelPairs = kAllChannelPairs;
+    } else {
+        m_selectedChannelPairs = channelPairs & allStems;
+    }
+    return m_selectedChannelPairs;
 }
 
 ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         const WritableSampleFrames& globalSampleFrames) {
-    if (m_pStereoStreams.size() == 1) {
+    if (m_pStems.empty()) {
         // Opened in stereo mode, proxy the read request to the main mix channel
-        return m_pStereoStreams.front()->readSampleFrames(globalSampleFrames);
+        return m_pMainMix->readSampleFrames(globalSampleFrames);
     }
 
-    int stemCount = m_pStereoStreams.size();
+    int stemCount = m_pStems.size();
 
     VERIFY_OR_DEBUG_ASSERT(globalSampleFrames.writableLength() %
                     (stemCount * mixxx::audio::ChannelCount::stereo()) ==
@@ -427,7 +495,7 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         return ReadableSampleFrames();
     };
 
-    SINT stemSampleLength = m_pStereoStreams.front()->getSignalInfo().frames2samples(
+    SINT stemSampleLength = m_pMainMix->getSignalInfo().frames2samples(
             globalSampleFrames.frameLength());
 
     // The same buffer is reused between requests tp prevent reallocation, but
@@ -444,12 +512,29 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
     DEBUG_ASSERT(stemSampleLength * stemCount == globalSampleFrames.writableLength());
     CSAMPLE* pBuffer = globalSampleFrames.writableData();
     for (int streamIdx = 0; streamIdx < stemCount; streamIdx++) {
+        SoundSourceSingleSTEM* pStream = nullptr;
+        if (m_selectedChannelPairs == kPremixedChannelPairs) {
+            // The main mix takes the place of the first stem
+            if (streamIdx == 0) {
+                pStream = m_pMainMix.get();
+            }
+        } else if (m_selectedChannelPairs & (ChannelPairs{1} << streamIdx)) {
+            pStream = openedStem(streamIdx);
+        }
+        if (!pStream) {
+            // Not decoded, silence
+            for (SINT i = 0; i < stemSampleLength / 2; i++) {
+                pBuffer[2 * stemCount * i + 2 * streamIdx] = CSAMPLE_ZERO;
+                pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = CSAMPLE_ZERO;
+            }
+            continue;
+        }
         WritableSampleFrames currentStemFrame = WritableSampleFrames(
                 globalSampleFrames.frameIndexRange(),
                 SampleBuffer::WritableSlice(
                         m_buffer.data(),
                         stemSampleLength));
-        m_pStereoStreams[streamIdx]->readSampleFrames(currentStemFrame);
+        pStream->readSampleFrames(currentStemFrame);
         // TODO(XXX): currently, stem samples are interleaved and packed next to each other as such:
         //    1L1R1L1R1L1R...2L2R2L2R2L2R2L2R......3L3R3L3R3L3R3L3R......4L4R4L4R4L4R4L4R....
         //    Can FFmpeg decode as without having to use a decoder per channel?
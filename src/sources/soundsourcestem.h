@@ -26,15 +26,31 @@ class SoundSourceSingleSTEM : public SoundSourceFFmpeg {
 /// stereo or in stem (4 x stereo). Use OpenParams to request a maximum number of channels.
 /// This allows decks which must not use STEM for performance or usability reason to use the
 /// same soundsource.
+///
+/// In stem mode the stems are only decoded on demand, see selectChannelPairs().
+/// Until any stem is selected only the main mix is decoded, which is as
+/// expensive as decoding a regular track.
 class SoundSourceSTEM : public SoundSource {
   public:
     explicit SoundSourceSTEM(const QUrl& url);
 
     void close() override;
 
+    ChannelPairs selectChannelPairs(ChannelPairs channelPairs) override;
+
   private:
-    // Contains each stem source, or the main mix if opened in stereo mode
-    std::vector<std::unique_ptr<SoundSourceSingleSTEM>> m_pStereoStreams;
+    // Opens the stem on first use. Returns nullptr on failure.
+    SoundSourceSingleSTEM* openedStem(int stemIdx);
+
+    // The main mix, always opened
+    std::unique_ptr<SoundSourceSingleSTEM> m_pMainMix;
+    // Each stem source if opened in stem mode, they are opened lazily
+    std::vector<std::unique_ptr<SoundSourceSingleSTEM>> m_pStems;
+    ChannelPairs m_openedStems;
+    ChannelPairs m_failedStems;
+    OpenParams m_stemOpenParams;
+
+    ChannelPairs m_selectedChannelPairs;
     SampleBuffer m_buffer;
 
   protected:
@@ -3,6 +3,7 @@
 #include <wavpack.h>
 
 #include "util/logger.h"
+#include "util/sample.h"
 
 namespace mixxx {
 
@@ -158,13 +159,12 @@ ReadableSampleFrames SoundSourceWV::readSampleFramesClamped(
     DEBUG_ASSERT(unpackCount >= 0);
     DEBUG_ASSERT(unpackCount <= numberOfFramesTotal);
     if (!(WavpackGetMode(static_cast<WavpackContext*>(m_wpc)) & MODE_FLOAT)) {
-        // signed integer -> float
-        const SINT sampleCount = getSignalInfo().frames2samples(unpackCount);
-        for (SINT i = 0; i < sampleCount; ++i) {
-            const int32_t sampleValue =
-                    *reinterpret_cast<int32_t*>(pOutputBuffer);
-            *pOutputBuffer++ = CSAMPLE(sampleValue) * m_sampleScaleFactor;
-        }
+        // signed integer -> float (in-place)
+        SampleUtil::convertS32ToFloat32(
+                pOutputBuffer,
+                reinterpret_cast<const int32_t*>(pOutputBuffer),
+                m_sampleScaleFactor,
+                getSignalInfo().frames2samples(unpackCount));
     }
     const auto resultRange = IndexRange::forward(m_curFrameIndex, unpackCount);
     m_curFrameIndex += unpackCount;
@@ -0,0 +1,84 @@
+#include "soundio/adaptivebuffersizecontroller.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using Decision = AdaptiveBufferSizeController::Decision;
+
+class AdaptiveBufferSizeControllerTest : public testing::Test {
+  protected:
+    // Evaluates a window of callbacks with the given load
+    Decision window(double load, bool xrun = false, bool canStepDown = true) {
+        for (int i = 0; i < 100; ++i) {
+            m_controller.recordCallbackLoad(load);
+        }
+        return m_controller.evaluate(xrun, canStepDown);
+    }
+
+    AdaptiveBufferSizeController m_controller;
+};
+
+TEST_F(AdaptiveBufferSizeControllerTest, StepsDownAfterConsistentHeadroom) {
+    for (int i = 1; i < AdaptiveBufferSizeController::kHeadroomWindows; ++i) {
+        EXPECT_EQ(Decision::Keep, window(0.2));
+    }
+    EXPECT_EQ(Decision::StepDown, window(0.2));
+    EXPECT_DOUBLE_EQ(0.2, m_controller.lastLoadPercentile());
+    // The observation starts over after a step
+    EXPECT_EQ(Decision::Keep, window(0.2));
+}
+
+TEST_F(AdaptiveBufferSizeControllerTest, PercentileIgnoresRareSpikes) {
+    for (int i = 0; i < 1000; ++i) {
+        m_controller.recordCallbackLoad(i < 5 ? 1.5 : 0.3);
+    }
+    EXPECT_EQ(Decision::Keep, m_controller.evaluate(false, true));
+    EXPECT_DOUBLE_EQ(0.3, m_controller.lastLoadPercentile());
+    // More than 1% of overloads dominate the percentile
+    for (int i = 0; i < 1000; ++i) {
+        m_controller.recordCallbackLoad(i < 20 ? 1.5 : 0.3);
+    }
+    m_controller.evaluate(false, true);
+    EXPECT_DOUBLE_EQ(1.0, m_controller.lastLoadPercentile());
+}
+
+TEST_F(AdaptiveBufferSizeControllerTest, NoStepDownIfNotAllowed) {
+    for (int i = 0; i < 2 * AdaptiveBufferSizeController::kHeadroomWindows; ++i) {
+        EXPECT_EQ(Decision::Keep, window(0.2, false, false));
+    }
+    EXPECT_EQ(Decision::StepDown, window(0.2));
+}
+
+TEST_F(AdaptiveBufferSizeControllerTest, StepsUpOnXrun) {
+    EXPECT_EQ(Decision::StepUp, window(0.2, true));
+}
+
+TEST_F(AdaptiveBufferSizeControllerTest, StepsUpOnPersistentOverload) {
+    for (int i = 1; i < AdaptiveBufferSizeController::kOverloadWindows; ++i) {
+        EXPECT_EQ(Decision::Keep, window(0.9));
+    }
+    EXPECT_EQ(Decision::StepUp, window(0.9));
+}
+
+TEST_F(AdaptiveBufferSizeControllerTest, EmptyWindowKeepsSize) {
+    EXPECT_EQ(Decision::Keep, m_controller.evaluate(false, true));
+    EXPECT_LT(m_controller.lastLoadPercentile(), 0);
+}
+
+TEST_F(AdaptiveBufferSizeControllerTest, HoldTimeDoublesAfterFailedStepDown) {
+    for (int i = 0; i < AdaptiveBufferSizeController::kHeadroomWindows; ++i) {
+        window(0.2);
+    }
+    EXPECT_EQ(Decision::StepUp, window(0.2, true));
+    EXPECT_EQ(2 * AdaptiveBufferSizeController::kMinHoldWindows,
+            m_controller.holdWindows());
+
+    // No step down while holding, despite the headroom
+    for (int i = 1; i < m_controller.holdWindows(); ++i) {
+        EXPECT_EQ(Decision::Keep, window(0.2));
+    }
+    EXPECT_EQ(Decision::StepDown, window(0.2));
+}
+
+} // namespace
@@ -1,6 +1,8 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include <QDir>
+#include <QTemporaryDir>
 #include <QtDebug>
 #include <vector>
 
@@ -9,6 +11,7 @@
 #include "library/dao/analysisdao.h"
 #include "test/mixxxtest.h"
 #include "track/track.h"
+#include "util/math.h"
 
 namespace {
 
@@ -60,18 +63,25 @@ class AnalyzerWaveformTest : public MixxxTest {
         const QByteArray actual = pWaveform->toByteArray();
 
         ASSERT_TRUE(f.open(QFile::ReadOnly));
-        const QByteArray reference = f.readAll();
-
-        if (actual.size() == reference.size()) {
-            for (int i = 0; i < actual.size(); ++i) {
-                if (actual.at(i) != reference.at(i)) {
-                    qDebug() << "#" << i << QString::number(actual[i], 16)
-                             << QString::number(reference[i], 16);
+        // The reference has been stored in the previous protobuf format
+        // and is compared with the restored compact format, which checks
+        // both reading the previous and writing the current format
+        const Waveform reference(f.readAll());
+        const Waveform restored(actual);
+
+        if (restored.getDataSize() == reference.getDataSize() &&
+                restored.getDataSize() == pWaveform->getDataSize() &&
+                restored.getAudioVisualRatio() == reference.getAudioVisualRatio()) {
+            for (int i = 0; i < restored.getDataSize(); ++i) {
+                if (restored.get(i).m_i != reference.get(i).m_i ||
+                        restored.get(i).m_i != pWaveform->get(i).m_i) {
+                    qDebug() << "#" << i << QString::number(restored.get(i).m_i, 16)
+                             << QString::number(reference.get(i).m_i, 16);
                     pass = false;
                 }
             }
         } else {
-            qDebug() << "##" << actual.size() << reference.size();
+            qDebug() << "##" << restored.getDataSize() << reference.getDataSize();
             pass = false;
         }
 
@@ -129,4 +139,50 @@ TEST_F(AnalyzerWaveformTest, canary) {
     EXPECT_DOUBLE_EQ(pWaveformSummary->getAudioVisualRatio(), 1.0);
 }
 
+constexpr int kBenchmarkSampleRate = 44100;
+constexpr int kBenchmarkSeconds = 10;
+
+static void BM_AnalyzeWaveform(benchmark::State& state) {
+    const QTemporaryDir settingsDir;
+    AnalyzerWaveform analyzer(
+            UserSettingsPointer(new UserSettings(
+                    settingsDir.filePath(QStringLiteral("mixxx.cfg")))),
+            QSqlDatabase());
+    const SINT bufferSizeInSamples = static_cast<SINT>(state.range(0));
+    const SINT frameLength = kBenchmarkSeconds * kBenchmarkSampleRate;
+    TrackPointer pTrack = Track::newTemporary();
+    pTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(kChannelCount),
+            mixxx::audio::SampleRate(kBenchmarkSampleRate),
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromSeconds(kBenchmarkSeconds));
+
+    // A stereo 440 Hz sine with slowly changing amplitude
+    std::vector<CSAMPLE> samples(bufferSizeInSamples);
+    for (SINT i = 0; i < bufferSizeInSamples / kChannelCount; ++i) {
+        const float phase = 2 * static_cast<float>(M_PI) * 440 * i / kBenchmarkSampleRate;
+        samples[i * kChannelCount] = 0.5f * std::sin(phase);
+        samples[i * kChannelCount + 1] = 0.25f * std::sin(phase) * (1 + std::sin(phase / 64));
+    }
+
+    for (auto _ : state) {
+        if (!analyzer.initialize(AnalyzerTrack(pTrack),
+                    pTrack->getSampleRate(),
+                    frameLength)) {
+            state.SkipWithError("Failed to initialize the analyzer");
+            return;
+        }
+        for (SINT frame = 0; frame < frameLength;
+                frame += bufferSizeInSamples / kChannelCount) {
+            analyzer.processSamples(samples.data(), bufferSizeInSamples);
+        }
+        analyzer.cleanup();
+        // Force a new analysis of the same track
+        pTrack->setWaveform(ConstWaveformPointer());
+        pTrack->setWaveformSummary(ConstWaveformPointer());
+    }
+    state.SetItemsProcessed(state.iterations() * frameLength);
+}
+BENCHMARK(BM_AnalyzeWaveform)->Range(64, 4 << 10);
+
 } // namespace
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QSqlQuery>
+
+#include "library/dao/analysisdao.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+class AnalysisDaoTest : public LibraryTest {
+  protected:
+    TrackId addTrack(const QString& fileName) {
+        const mixxx::FileInfo fileInfo(QDir(QDir::tempPath()), fileName);
+        TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(fileInfo));
+        return internalCollection()->addTrack(pTrack, false);
+    }
+};
+
+TEST_F(AnalysisDaoTest, QueueIsPersisted) {
+    AnalysisDao& analysisDao = internalCollection()->getAnalysisDAO();
+    const TrackId trackId1 = addTrack(QStringLiteral("analysisqueue1.mp3"));
+    const TrackId trackId2 = addTrack(QStringLiteral("analysisqueue2.mp3"));
+    const TrackId trackId3 = addTrack(QStringLiteral("analysisqueue3.mp3"));
+    ASSERT_TRUE(trackId1.isValid());
+    ASSERT_TRUE(trackId2.isValid());
+    ASSERT_TRUE(trackId3.isValid());
+
+    AnalyzerTrack::Options fixedTempo;
+    fixedTempo.useFixedTempo = true;
+    ASSERT_TRUE(analysisDao.enqueueTracksForAnalysis({
+            AnalyzerScheduledTrack(trackId2),
+            AnalyzerScheduledTrack(trackId1, fixedTempo),
+    }));
+    // Tracks that are already queued keep their position
+    ASSERT_TRUE(analysisDao.enqueueTracksForAnalysis({
+            AnalyzerScheduledTrack(trackId3),
+            AnalyzerScheduledTrack(trackId2),
+    }));
+
+    QList<AnalyzerScheduledTrack> tracks = analysisDao.getQueuedTracksForAnalysis();
+    ASSERT_EQ(3, tracks.size());
+    EXPECT_EQ(trackId2, tracks[0].getTrackId());
+    EXPECT_FALSE(tracks[0].getOptions().useFixedTempo.has_value());
+    EXPECT_EQ(trackId1, tracks[1].getTrackId());
+    EXPECT_EQ(std::optional<bool>(true), tracks[1].getOptions().useFixedTempo);
+    EXPECT_EQ(trackId3, tracks[2].getTrackId());
+
+    EXPECT_TRUE(analysisDao.dequeueTrackFromAnalysis(trackId1));
+    tracks = analysisDao.getQueuedTracksForAnalysis();
+    ASSERT_EQ(2, tracks.size());
+    EXPECT_EQ(trackId2, tracks[0].getTrackId());
+    EXPECT_EQ(trackId3, tracks[1].getTrackId());
+
+    EXPECT_TRUE(analysisDao.clearAnalysisQueue());
+    EXPECT_TRUE(analysisDao.getQueuedTracksForAnalysis().isEmpty());
+}
+
+TEST_F(AnalysisDaoTest, PurgedTracksAreRemovedFromQueue) {
+    AnalysisDao& analysisDao = internalCollection()->getAnalysisDAO();
+    const TrackId trackId1 = addTrack(QStringLiteral("analysisqueue1.mp3"));
+    const TrackId trackId2 = addTrack(QStringLiteral("analysisqueue2.mp3"));
+    ASSERT_TRUE(analysisDao.enqueueTracksForAnalysis({
+            AnalyzerScheduledTrack(trackId1),
+            AnalyzerScheduledTrack(trackId2),
+    }));
+
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.prepare("DELETE FROM library WHERE id=:id"));
+    query.bindValue(":id", trackId1.toVariant());
+    ASSERT_TRUE(query.exec());
+
+    const QList<AnalyzerScheduledTrack> tracks = analysisDao.getQueuedTracksForAnalysis();
+    ASSERT_EQ(1, tracks.size());
+    EXPECT_EQ(trackId2, tracks[0].getTrackId());
+}
+
+TEST_F(AnalysisDaoTest, AnalyzerResultsAreRecorded) {
+    AnalysisDao& analysisDao = internalCollection()->getAnalysisDAO();
+    const TrackId trackId = addTrack(QStringLiteral("analyzerresults.mp3"));
+    ASSERT_TRUE(trackId.isValid());
+    EXPECT_TRUE(analysisDao.getAnalyzerResults(trackId).isEmpty());
+
+    ASSERT_TRUE(analysisDao.saveAnalyzerResult(trackId,
+            QStringLiteral("replaygain"),
+            AnalysisDao::AnalyzerResultInfo{
+                    QStringLiteral("1"), QStringLiteral("44100:2:1000")}));
+    // Recording the result again replaces the previous version
+    ASSERT_TRUE(analysisDao.saveAnalyzerResult(trackId,
+            QStringLiteral("replaygain"),
+            AnalysisDao::AnalyzerResultInfo{
+                    QStringLiteral("2"), QStringLiteral("44100:2:1000")}));
+
+    auto results = analysisDao.getAnalyzerResults(trackId);
+    ASSERT_EQ(1, results.size());
+    EXPECT_EQ(QStringLiteral("2"), results.value(QStringLiteral("replaygain")).version);
+    EXPECT_EQ(QStringLiteral("44100:2:1000"),
+            results.value(QStringLiteral("replaygain")).fingerprint);
+
+    analysisDao.deleteAnalyses({trackId});
+    EXPECT_TRUE(analysisDao.getAnalyzerResults(trackId).isEmpty());
+}
+
+TEST_F(AnalysisDaoTest, ChromaprintsAreStored) {
+    AnalysisDao& analysisDao = internalCollection()->getAnalysisDAO();
+    const TrackId trackId = addTrack(QStringLiteral("chromaprint.mp3"));
+    ASSERT_TRUE(trackId.isValid());
+    EXPECT_TRUE(analysisDao.getChromaprint(trackId).fingerprint.isEmpty());
+
+    ASSERT_TRUE(analysisDao.saveChromaprint(trackId,
+            AnalysisDao::ChromaprintInfo{
+                    QStringLiteral("AQAAEEmS"), 180, QStringLiteral("1000:1")}));
+    // Storing the fingerprint again replaces the previous one
+    ASSERT_TRUE(analysisDao.saveChromaprint(trackId,
+            AnalysisDao::ChromaprintInfo{
+                    QStringLiteral("AQAAEEmT"), 181, QStringLiteral("1000:2")}));
+
+    const auto chromaprint = analysisDao.getChromaprint(trackId);
+    EXPECT_EQ(QStringLiteral("AQAAEEmT"), chromaprint.fingerprint);
+    EXPECT_EQ(181, chromaprint.duration);
+    EXPECT_EQ(QStringLiteral("1000:2"), chromaprint.fileSignature);
+
+    analysisDao.deleteAnalyses({trackId});
+    EXPECT_TRUE(analysisDao.getChromaprint(trackId).fingerprint.isEmpty());
+}
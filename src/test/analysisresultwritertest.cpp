@@ -0,0 +1,69 @@
+#include "analyzer/analysisresultwriter.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+
+#include "test/librarytest.h"
+#include "track/track.h"
+
+class AnalysisResultWriterTest : public LibraryTest {
+  protected:
+    TrackId addTrack(const QString& fileName) {
+        const mixxx::FileInfo fileInfo(QDir(QDir::tempPath()), fileName);
+        TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(fileInfo));
+        return internalCollection()->addTrack(pTrack, false);
+    }
+};
+
+TEST_F(AnalysisResultWriterTest, PendingResultsAreCommittedWhenDestroyed) {
+    const TrackId trackId1 = addTrack(QStringLiteral("analysisresults1.mp3"));
+    const TrackId trackId2 = addTrack(QStringLiteral("analysisresults2.mp3"));
+    ASSERT_TRUE(trackId1.isValid());
+    ASSERT_TRUE(trackId2.isValid());
+
+    {
+        AnalysisResultWriter writer(dbConnectionPooler(), config());
+        writer.start();
+        writer.saveAnalyzerResult(trackId1,
+                QStringLiteral("replaygain"),
+                AnalysisDao::AnalyzerResultInfo{
+                        QStringLiteral("1"), QStringLiteral("44100:2:1000")});
+        writer.saveAnalyzerResult(trackId2,
+                QStringLiteral("replaygain"),
+                AnalysisDao::AnalyzerResultInfo{
+                        QStringLiteral("2"), QStringLiteral("48000:2:2000")});
+    }
+
+    AnalysisDao& analysisDao = internalCollection()->getAnalysisDAO();
+    EXPECT_EQ(QStringLiteral("1"),
+            analysisDao.getAnalyzerResults(trackId1)
+                    .value(QStringLiteral("replaygain"))
+                    .version);
+    EXPECT_EQ(QStringLiteral("48000:2:2000"),
+            analysisDao.getAnalyzerResults(trackId2)
+                    .value(QStringLiteral("replaygain"))
+                    .fingerprint);
+}
+
+TEST_F(AnalysisResultWriterTest, PendingWaveformsAreNotSavedTwice) {
+    const TrackId trackId = addTrack(QStringLiteral("analysisresults3.mp3"));
+    ASSERT_TRUE(trackId.isValid());
+    const auto pWaveform = ConstWaveformPointer(new Waveform(44100, 44100, 441, -1));
+    const auto pWaveSummary = ConstWaveformPointer(new Waveform(44100, 44100, 441, 1000));
+    ASSERT_EQ(Waveform::SaveState::SavePending, pWaveform->saveState());
+    ASSERT_EQ(Waveform::SaveState::SavePending, pWaveSummary->saveState());
+
+    AnalysisDao& analysisDao = internalCollection()->getAnalysisDAO();
+    {
+        AnalysisResultWriter writer(dbConnectionPooler(), config());
+        writer.start();
+        writer.saveTrackAnalyses(trackId, pWaveform, pWaveSummary);
+        // Like TrackDAO when the track is saved meanwhile
+        analysisDao.saveTrackAnalyses(trackId, pWaveform, pWaveSummary);
+    }
+
+    EXPECT_EQ(Waveform::SaveState::Saved, pWaveform->saveState());
+    EXPECT_EQ(Waveform::SaveState::Saved, pWaveSummary->saveState());
+    EXPECT_EQ(2, analysisDao.getAnalysesForTrack(trackId).size());
+}
@@ -0,0 +1,70 @@
+#include "analyzer/analysisthrottle.h"
+
+#include <gtest/gtest.h>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+mixxx::Duration seconds(int seconds) {
+    return mixxx::Duration::fromSeconds(seconds);
+}
+
+class AnalysisThrottleTest : public MixxxTest {
+  protected:
+    AnalysisThrottle m_throttle;
+};
+
+TEST_F(AnalysisThrottleTest, DelayFollowsLatencyUsage) {
+    m_throttle.update(0.2, 0, seconds(0));
+    EXPECT_EQ(mixxx::Duration::empty(), m_throttle.delayPerChunk());
+    EXPECT_FALSE(m_throttle.isPaused());
+
+    // High usage doubles the delay up to the maximum
+    m_throttle.update(0.9, 0, seconds(1));
+    EXPECT_EQ(AnalysisThrottle::kMinDelayPerChunk, m_throttle.delayPerChunk());
+    m_throttle.update(0.9, 0, seconds(2));
+    EXPECT_EQ(AnalysisThrottle::kMinDelayPerChunk * 2, m_throttle.delayPerChunk());
+    for (int i = 0; i < 10; ++i) {
+        m_throttle.update(0.9, 0, seconds(3 + i));
+    }
+    EXPECT_EQ(AnalysisThrottle::kMaxDelayPerChunk, m_throttle.delayPerChunk());
+
+    // Moderate usage keeps the delay
+    m_throttle.update(0.6, 0, seconds(13));
+    EXPECT_EQ(AnalysisThrottle::kMaxDelayPerChunk, m_throttle.delayPerChunk());
+
+    // Low usage halves the delay until it vanishes
+    for (int i = 0; i < 10; ++i) {
+        m_throttle.update(0.2, 0, seconds(14 + i));
+    }
+    EXPECT_EQ(mixxx::Duration::empty(), m_throttle.delayPerChunk());
+    EXPECT_FALSE(m_throttle.isPaused());
+}
+
+TEST_F(AnalysisThrottleTest, UnderflowPausesAnalysis) {
+    int numChanges = 0;
+    QObject::connect(&m_throttle,
+            &AnalysisThrottle::throttleChanged,
+            [&numChanges](mixxx::Duration, bool) {
+                ++numChanges;
+            });
+
+    // Underflows before watching are ignored
+    m_throttle.update(0.2, 3, seconds(0));
+    EXPECT_FALSE(m_throttle.isPaused());
+
+    m_throttle.update(0.2, 4, seconds(1));
+    EXPECT_TRUE(m_throttle.isPaused());
+    EXPECT_EQ(1, numChanges);
+
+    m_throttle.update(0.2, 4, seconds(6));
+    EXPECT_TRUE(m_throttle.isPaused());
+    EXPECT_EQ(1, numChanges);
+
+    m_throttle.update(0.2, 4, seconds(1) + AnalysisThrottle::kPauseAfterOverload);
+    EXPECT_FALSE(m_throttle.isPaused());
+    EXPECT_EQ(2, numChanges);
+}
+
+} // namespace
@@ -0,0 +1,82 @@
+#include "analyzer/analyzerbeatspreview.h"
+
+#include <gtest/gtest.h>
+
+#include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzertrack.h"
+#include "test/mixxxtest.h"
+#include "track/beatfactory.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+
+class AnalyzerBeatsPreviewTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pTrack = Track::newTemporary();
+        m_pTrack->setAudioProperties(
+                mixxx::audio::ChannelCount(2),
+                kSampleRate,
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(180));
+        BeatDetectionSettings settings(config());
+        settings.setBpmDetectionEnabled(true);
+        settings.setPreviewAnalysis(true);
+        settings.setReanalyzeWhenSettingsChange(false);
+    }
+
+    static mixxx::BeatsPointer makeBeats(const QHash<QString, QString>& extraVersionInfo) {
+        return mixxx::Beats::fromConstTempo(kSampleRate,
+                mixxx::audio::FramePos(1000),
+                mixxx::Bpm(120),
+                BeatFactory::getPreferredSubVersion(extraVersionInfo));
+    }
+
+    bool initializeAnalyzerBeats() {
+        AnalyzerBeats analyzer(config());
+        const bool shouldAnalyze = analyzer.initialize(
+                AnalyzerTrack(m_pTrack), kSampleRate, 180 * kSampleRate);
+        analyzer.cleanup();
+        return shouldAnalyze;
+    }
+
+    TrackPointer m_pTrack;
+};
+
+TEST_F(AnalyzerBeatsPreviewTest, IsPreview) {
+    EXPECT_TRUE(AnalyzerBeatsPreview::isPreview(*makeBeats({{"preview", "1"}})));
+    EXPECT_TRUE(AnalyzerBeatsPreview::isPreview(
+            *makeBeats({{"vamp_plugin_id", "mixxxbpmdetection"}, {"preview", "1"}})));
+    EXPECT_FALSE(AnalyzerBeatsPreview::isPreview(
+            *makeBeats({{"vamp_plugin_id", "mixxxbpmdetection"}})));
+    EXPECT_FALSE(AnalyzerBeatsPreview::isPreview(*makeBeats({})));
+}
+
+TEST_F(AnalyzerBeatsPreviewTest, ShouldAnalyzeOnlyTracksWithoutBeats) {
+    BeatDetectionSettings settings(config());
+    EXPECT_TRUE(AnalyzerBeatsPreview::shouldAnalyze(settings, m_pTrack));
+
+    settings.setPreviewAnalysis(false);
+    EXPECT_FALSE(AnalyzerBeatsPreview::shouldAnalyze(settings, m_pTrack));
+    settings.setPreviewAnalysis(true);
+
+    m_pTrack->setBpmLocked(true);
+    EXPECT_FALSE(AnalyzerBeatsPreview::shouldAnalyze(settings, m_pTrack));
+    m_pTrack->setBpmLocked(false);
+
+    ASSERT_TRUE(m_pTrack->trySetBeats(makeBeats({{"preview", "1"}})));
+    EXPECT_FALSE(AnalyzerBeatsPreview::shouldAnalyze(settings, m_pTrack));
+}
+
+TEST_F(AnalyzerBeatsPreviewTest, PreviewIsRefined) {
+    // An outdated grid is kept according to the preference settings
+    ASSERT_TRUE(m_pTrack->trySetBeats(makeBeats({{"vamp_plugin_id", "outdated"}})));
+    EXPECT_FALSE(initializeAnalyzerBeats());
+
+    ASSERT_TRUE(m_pTrack->trySetBeats(makeBeats({{"preview", "1"}})));
+    EXPECT_TRUE(initializeAnalyzerBeats());
+}
+
+} // namespace
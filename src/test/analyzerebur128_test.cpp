@@ -0,0 +1,88 @@
+#include "analyzer/analyzerebur128.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kChunkFrames = 4096;
+
+class AnalyzerEbur128Test : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ReplayGainSettings rgSettings(config());
+        rgSettings.setReplayGainAnalyzerEnabled(true);
+        rgSettings.setReplayGainAnalyzerVersion(2);
+    }
+
+    /// A sine with a gain change in the middle, so the loudness of the
+    /// segments differs
+    static std::vector<CSAMPLE> generateSamples(SINT frames) {
+        std::vector<CSAMPLE> samples(frames * mixxx::kAnalysisChannels);
+        for (SINT frame = 0; frame < frames; ++frame) {
+            const CSAMPLE amplitude = frame < frames / 2 ? 0.5f : 0.25f;
+            const auto value = static_cast<CSAMPLE>(amplitude *
+                    std::sin(2 * M_PI * 1000 * frame / kSampleRate.value()));
+            samples[frame * 2] = value;
+            samples[frame * 2 + 1] = value;
+        }
+        return samples;
+    }
+
+    /// Measures the integrated loudness in a single pass
+    static double measureLufs(const std::vector<CSAMPLE>& samples) {
+        ebur128_state* pState = ebur128_init(
+                mixxx::kAnalysisChannels, kSampleRate, EBUR128_MODE_I);
+        ebur128_add_frames_float(pState,
+                samples.data(),
+                samples.size() / mixxx::kAnalysisChannels);
+        double lufs = 0;
+        ebur128_loudness_global(pState, &lufs);
+        ebur128_destroy(&pState);
+        return lufs;
+    }
+
+    mixxx::ReplayGain analyze(const std::vector<CSAMPLE>& samples) {
+        const SINT frames = samples.size() / mixxx::kAnalysisChannels;
+        TrackPointer pTrack = Track::newTemporary();
+        AnalyzerEbur128 analyzer(config());
+        EXPECT_TRUE(analyzer.initialize(AnalyzerTrack(pTrack), kSampleRate, frames));
+        for (SINT frame = 0; frame < frames; frame += kChunkFrames) {
+            const SINT chunkFrames = math_min(kChunkFrames, frames - frame);
+            EXPECT_TRUE(analyzer.processSamples(
+                    samples.data() + frame * mixxx::kAnalysisChannels,
+                    chunkFrames * mixxx::kAnalysisChannels));
+        }
+        analyzer.storeResults(pTrack);
+        analyzer.cleanup();
+        return pTrack->getReplayGain();
+    }
+};
+
+TEST_F(AnalyzerEbur128Test, ShortTrack) {
+    const auto samples = generateSamples(10 * kSampleRate.value());
+    const auto replayGain = analyze(samples);
+    ASSERT_TRUE(replayGain.hasRatio());
+    EXPECT_NEAR(-18 - measureLufs(samples), ratio2db(replayGain.getRatio()), 1e-6);
+    EXPECT_NEAR(0.5, replayGain.getPeak(), 1e-3);
+}
+
+TEST_F(AnalyzerEbur128Test, SegmentedTrack) {
+    // Measured in 5 segments
+    const auto samples = generateSamples(90 * kSampleRate.value());
+    const auto replayGain = analyze(samples);
+    ASSERT_TRUE(replayGain.hasRatio());
+    EXPECT_NEAR(-18 - measureLufs(samples), ratio2db(replayGain.getRatio()), 0.1);
+    EXPECT_NEAR(0.5, replayGain.getPeak(), 1e-3);
+}
+
+} // namespace
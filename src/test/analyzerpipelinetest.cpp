@@ -0,0 +1,189 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr int kNumChunks = 50;
+
+struct AnalyzerResult {
+    SINT numSamples = 0;
+    double sum = 0;
+    double downmixSum = 0;
+    bool stored = false;
+    bool cleanedUp = false;
+};
+
+// Sums up all samples, optionally failing after some samples
+class SummingAnalyzer : public Analyzer {
+  public:
+    SummingAnalyzer(AnalyzerResult* pResult, SINT failAfterSamples = -1)
+            : m_pResult(pResult),
+              m_failAfterSamples(failAfterSamples) {
+    }
+
+    bool initialize(const AnalyzerTrack&, mixxx::audio::SampleRate, SINT) override {
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        for (SINT i = 0; i < count; ++i) {
+            m_pResult->sum += pIn[i];
+        }
+        m_pResult->numSamples += count;
+        return m_failAfterSamples < 0 || m_pResult->numSamples < m_failAfterSamples;
+    }
+
+    bool processDownmixedSamples(
+            const CSAMPLE* pIn, const double* pDownmix, SINT count) override {
+        for (SINT i = 0; i < count / mixxx::kAnalysisChannels; ++i) {
+            m_pResult->downmixSum += pDownmix[i];
+        }
+        return processSamples(pIn, count);
+    }
+
+    void storeResults(TrackPointer) override {
+        m_pResult->stored = true;
+    }
+
+    void cleanup() override {
+        m_pResult->cleanedUp = true;
+    }
+
+  private:
+    AnalyzerResult* const m_pResult;
+    const SINT m_failAfterSamples;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pTrack = Track::newTemporary();
+        m_samples.resize(mixxx::kAnalysisSamplesPerChunk);
+        m_results.resize(4);
+        for (auto& result : m_results) {
+            m_analyzers.push_back(AnalyzerWithState(
+                    std::make_unique<SummingAnalyzer>(&result)));
+        }
+    }
+
+    void initializeAnalyzers() {
+        for (auto& analyzer : m_analyzers) {
+            analyzer.initialize(AnalyzerTrack(m_pTrack), mixxx::audio::SampleRate(44100), 0);
+        }
+    }
+
+    // Every chunk is filled with a different value
+    double processChunks(AnalyzerPipeline* pPipeline) {
+        double expectedSum = 0;
+        for (int chunk = 0; chunk < kNumChunks; ++chunk) {
+            const CSAMPLE value = static_cast<CSAMPLE>(chunk + 1);
+            std::fill(m_samples.begin(), m_samples.end(), value);
+            pPipeline->process(m_samples.data(), static_cast<SINT>(m_samples.size()));
+            expectedSum += value * m_samples.size();
+        }
+        return expectedSum;
+    }
+
+    TrackPointer m_pTrack;
+    std::vector<CSAMPLE> m_samples;
+    std::vector<AnalyzerResult> m_results;
+    std::vector<AnalyzerWithState> m_analyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, AllAnalyzersReceiveAllChunks) {
+    AnalyzerPipeline pipeline;
+    // The same pipeline is reused for subsequent tracks with a different
+    // number of helper threads
+    for (int numHelpers : {0, 1, 3, 2}) {
+        for (auto& result : m_results) {
+            result = AnalyzerResult();
+        }
+        initializeAnalyzers();
+        EXPECT_EQ(numHelpers, pipeline.start(&m_analyzers, numHelpers));
+        const double expectedSum = processChunks(&pipeline);
+        pipeline.finish();
+        for (auto& analyzer : m_analyzers) {
+            analyzer.finish(AnalyzerTrack(m_pTrack));
+        }
+
+        for (const auto& result : m_results) {
+            EXPECT_EQ(kNumChunks * mixxx::kAnalysisSamplesPerChunk, result.numSamples)
+                    << numHelpers << " helpers";
+            EXPECT_DOUBLE_EQ(expectedSum, result.sum) << numHelpers << " helpers";
+            // All samples of a chunk have the same value
+            EXPECT_DOUBLE_EQ(expectedSum / mixxx::kAnalysisChannels, result.downmixSum)
+                    << numHelpers << " helpers";
+            EXPECT_TRUE(result.stored);
+            EXPECT_TRUE(result.cleanedUp);
+        }
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, HelpersAreLimitedByActiveAnalyzers) {
+    initializeAnalyzers();
+    m_analyzers[0].cancel();
+    m_analyzers[1].cancel();
+
+    AnalyzerPipeline pipeline;
+    EXPECT_EQ(1, pipeline.start(&m_analyzers, 8));
+    processChunks(&pipeline);
+    pipeline.finish();
+
+    EXPECT_EQ(0, m_results[0].numSamples);
+    EXPECT_EQ(0, m_results[1].numSamples);
+    EXPECT_EQ(kNumChunks * mixxx::kAnalysisSamplesPerChunk, m_results[2].numSamples);
+    EXPECT_EQ(kNumChunks * mixxx::kAnalysisSamplesPerChunk, m_results[3].numSamples);
+    for (auto& analyzer : m_analyzers) {
+        analyzer.cancel();
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, FailingAnalyzerStopsEarly) {
+    AnalyzerResult failingResult;
+    m_analyzers.push_back(AnalyzerWithState(std::make_unique<SummingAnalyzer>(
+            &failingResult, 3 * mixxx::kAnalysisSamplesPerChunk)));
+    initializeAnalyzers();
+
+    AnalyzerPipeline pipeline;
+    pipeline.start(&m_analyzers, 2);
+    processChunks(&pipeline);
+    pipeline.finish();
+
+    EXPECT_EQ(3 * mixxx::kAnalysisSamplesPerChunk, failingResult.numSamples);
+    EXPECT_TRUE(failingResult.cleanedUp);
+    EXPECT_FALSE(m_analyzers.back().isActive());
+    for (auto& analyzer : m_analyzers) {
+        analyzer.cancel();
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, Cancel) {
+    initializeAnalyzers();
+
+    AnalyzerPipeline pipeline;
+    pipeline.start(&m_analyzers, 3);
+    processChunks(&pipeline);
+    pipeline.cancel();
+    for (auto& analyzer : m_analyzers) {
+        analyzer.cancel();
+    }
+
+    // The lane that is processed by the calling thread is never cancelled
+    EXPECT_EQ(kNumChunks * mixxx::kAnalysisSamplesPerChunk, m_results[0].numSamples);
+    for (const auto& result : m_results) {
+        EXPECT_LE(result.numSamples, kNumChunks * mixxx::kAnalysisSamplesPerChunk);
+        EXPECT_FALSE(result.stored);
+        EXPECT_TRUE(result.cleanedUp);
+    }
+}
+
+} // namespace
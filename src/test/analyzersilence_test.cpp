@@ -244,4 +244,24 @@ TEST_F(AnalyzerSilenceTest, verifyFirstSound) {
                     mixxx::audio::ChannelCount::stereo()));
 }
 
+TEST_F(AnalyzerSilenceTest, findSoundInChunk) {
+    // Sound that is not aligned to the blocks of silence that are skipped
+    std::vector<CSAMPLE> samples(1000, 0.0005f);
+    EXPECT_EQ(1000, AnalyzerSilence::findFirstSoundInChunk(samples));
+    EXPECT_EQ(1000, AnalyzerSilence::findLastSoundInChunk(samples));
+
+    samples[131] = -0.001f;
+    samples[867] = 0.5f;
+    EXPECT_EQ(131, AnalyzerSilence::findFirstSoundInChunk(samples));
+    EXPECT_EQ(867, AnalyzerSilence::findLastSoundInChunk(samples));
+
+    samples[0] = 0.01f;
+    samples[999] = -0.01f;
+    EXPECT_EQ(0, AnalyzerSilence::findFirstSoundInChunk(samples));
+    EXPECT_EQ(999, AnalyzerSilence::findLastSoundInChunk(samples));
+
+    EXPECT_EQ(0, AnalyzerSilence::findFirstSoundInChunk({}));
+    EXPECT_EQ(0, AnalyzerSilence::findLastSoundInChunk({}));
+}
+
 } // namespace
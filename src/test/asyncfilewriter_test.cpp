@@ -0,0 +1,61 @@
+#include "util/asyncfilewriter.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class AsyncFileWriterTest : public testing::Test {
+  protected:
+    QByteArray readFile() const {
+        QFile file(m_fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QByteArray();
+        }
+        return file.readAll();
+    }
+
+    QTemporaryDir m_tempDir;
+    const QString m_fileName = m_tempDir.filePath(QStringLiteral("recording.wav"));
+};
+
+TEST_F(AsyncFileWriterTest, WritesSequentialData) {
+    mixxx::AsyncFileWriter writer;
+    ASSERT_TRUE(writer.open(m_fileName));
+    writer.write("abc", 3);
+    writer.write("def", 3);
+    EXPECT_EQ(6, writer.pos());
+    EXPECT_EQ(6, writer.size());
+    writer.close();
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_EQ(QByteArray("abcdef"), readFile());
+}
+
+TEST_F(AsyncFileWriterTest, RewritesHeaderAfterSeek) {
+    mixxx::AsyncFileWriter writer;
+    ASSERT_TRUE(writer.open(m_fileName));
+    writer.write("0000", 4);
+    writer.write("data", 4);
+    // Like libsndfile when updating the header
+    writer.seek(0);
+    writer.write("head", 4);
+    EXPECT_EQ(4, writer.pos());
+    EXPECT_EQ(8, writer.size());
+    writer.seek(writer.size());
+    writer.write("more", 4);
+    writer.close();
+    EXPECT_EQ(QByteArray("headdatamore"), readFile());
+}
+
+TEST_F(AsyncFileWriterTest, WaitForBytesWritten) {
+    mixxx::AsyncFileWriter writer;
+    ASSERT_TRUE(writer.open(m_fileName));
+    writer.write("abc", 3);
+    writer.waitForBytesWritten();
+    EXPECT_EQ(QByteArray("abc"), readFile());
+    writer.close();
+}
+
+} // namespace
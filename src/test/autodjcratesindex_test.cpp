@@ -0,0 +1,93 @@
+#include "library/autodj/autodjcratesindex.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const QString kEarlier = QStringLiteral("2024-01-01 10:00:00");
+const QString kLater = QStringLiteral("2024-02-01 10:00:00");
+
+AutoDJCratesIndex::Entry entry(int id,
+        int timesPlayed,
+        const QString& lastPlayed = QString(),
+        int autoDjRefs = 0) {
+    return AutoDJCratesIndex::Entry{TrackId(QVariant(id)), timesPlayed, lastPlayed, autoDjRefs};
+}
+
+TEST(AutoDJCratesIndexTest, OrderByTimesPlayed) {
+    AutoDJCratesIndex index;
+    index.reset({
+            entry(1, 2, kEarlier),
+            entry(2, 0),
+            entry(3, 1, kLater),
+            entry(4, 1, kEarlier),
+            entry(5, 0, QString(), 1),
+    });
+
+    EXPECT_EQ(5, index.size());
+    // Track 5 is queued
+    ASSERT_EQ(4, index.activeCount());
+    EXPECT_EQ(1, index.unplayedActiveCount());
+    EXPECT_EQ(TrackId(QVariant(2)), index.activeTrackAt(0));
+    EXPECT_EQ(TrackId(QVariant(4)), index.activeTrackAt(1));
+    EXPECT_EQ(TrackId(QVariant(3)), index.activeTrackAt(2));
+    EXPECT_EQ(TrackId(QVariant(1)), index.activeTrackAt(3));
+    EXPECT_EQ(2, index.activeCountPlayedBefore(kLater));
+}
+
+TEST(AutoDJCratesIndexTest, OrderByLastPlayed) {
+    AutoDJCratesIndex index(true);
+    index.reset({
+            entry(1, 2, kEarlier),
+            entry(2, 0),
+            entry(3, 1, kLater),
+    });
+
+    ASSERT_EQ(3, index.activeCount());
+    EXPECT_EQ(TrackId(QVariant(2)), index.activeTrackAt(0));
+    EXPECT_EQ(TrackId(QVariant(1)), index.activeTrackAt(1));
+    EXPECT_EQ(TrackId(QVariant(3)), index.activeTrackAt(2));
+    EXPECT_EQ(0, index.activeCountPlayedBefore(kEarlier));
+    EXPECT_EQ(1, index.activeCountPlayedBefore(kLater));
+
+    index.setOrderByLastPlayed(false);
+    EXPECT_EQ(TrackId(QVariant(3)), index.activeTrackAt(1));
+    EXPECT_EQ(TrackId(QVariant(1)), index.activeTrackAt(2));
+}
+
+TEST(AutoDJCratesIndexTest, UpdateTracks) {
+    AutoDJCratesIndex index;
+    index.reset({
+            entry(1, 0),
+            entry(2, 0),
+    });
+    ASSERT_EQ(2, index.unplayedActiveCount());
+
+    // Queued
+    index.addAutoDjRefs(TrackId(QVariant(1)), 1);
+    EXPECT_EQ(1, index.activeCount());
+    EXPECT_EQ(1, index.unplayedActiveCount());
+    EXPECT_EQ(TrackId(QVariant(2)), index.activeTrackAt(0));
+
+    // Played and unqueued
+    index.setTimesPlayed(TrackId(QVariant(1)), 1);
+    index.addAutoDjRefs(TrackId(QVariant(1)), -1);
+    ASSERT_EQ(2, index.activeCount());
+    EXPECT_EQ(1, index.unplayedActiveCount());
+    EXPECT_EQ(TrackId(QVariant(1)), index.activeTrackAt(1));
+
+    // Added to and removed from the crates
+    index.insert(entry(3, 0));
+    EXPECT_EQ(3, index.activeCount());
+    EXPECT_EQ(2, index.unplayedActiveCount());
+    index.remove(TrackId(QVariant(2)));
+    EXPECT_EQ(2, index.activeCount());
+    EXPECT_EQ(1, index.unplayedActiveCount());
+    EXPECT_FALSE(index.contains(TrackId(QVariant(2))));
+
+    // Not contained
+    index.addAutoDjRefs(TrackId(QVariant(4)), 1);
+    EXPECT_EQ(2, index.size());
+}
+
+} // namespace
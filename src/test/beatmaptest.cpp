@@ -251,4 +251,37 @@ TEST_F(BeatMapTest, HasBeatInRangeWithFractionalPos) {
             mixxx::audio::kStartFramePos + 0.2));
 }
 
+TEST_F(BeatMapTest, FindNextBeatWithVaryingTempo) {
+    // Alternating beat lengths result in a new marker for each beat
+    const mixxx::audio::FrameDiff_t beatLengthsFrames[] = {10000, 9000, 11000};
+    constexpr int numBeats = 60;
+    QVector<mixxx::audio::FramePos> beats;
+    mixxx::audio::FramePos beatPos = mixxx::audio::FramePos(100);
+    for (int i = 0; i < numBeats; ++i) {
+        beats.append(beatPos);
+        beatPos += beatLengthsFrames[i % 3];
+    }
+    const auto pMap = Beats::fromBeatPositions(m_pTrack->getSampleRate(), beats);
+
+    const auto expectNextBeat = [&](int beatIndex) {
+        const mixxx::audio::FramePos beat = beats[beatIndex];
+        EXPECT_EQ(beat, pMap->findNextBeat(beat));
+        if (beatIndex > 0) {
+            const mixxx::audio::FramePos prevBeat = beats[beatIndex - 1];
+            EXPECT_EQ(beat, pMap->findNextBeat(prevBeat + (beat - prevBeat) / 2));
+            EXPECT_EQ(beat, pMap->findNextBeat(beat - 1));
+        }
+    };
+    // Lookups during playback, after seeking backwards and at random
+    for (int i = 0; i < numBeats; ++i) {
+        expectNextBeat(i);
+    }
+    for (int i = numBeats - 1; i >= 0; --i) {
+        expectNextBeat(i);
+    }
+    for (int i = 0; i < numBeats; ++i) {
+        expectNextBeat((i * 37) % numBeats);
+    }
+}
+
 }  // namespace
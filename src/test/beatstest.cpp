@@ -410,6 +410,33 @@ TEST(BeatsTest, NonConstTempoSerialization) {
     EXPECT_EQ(byteArray, pBeats->toByteArray());
 }
 
+TEST(BeatsTest, ShareDeserializedBeats) {
+    const QByteArray byteArray = kNonConstTempoBeats.toByteArray();
+
+    auto pBeats = Beats::fromByteArray(kSampleRate, BEAT_MAP_VERSION, QString(), byteArray);
+    ASSERT_NE(nullptr, pBeats);
+    EXPECT_EQ(pBeats,
+            Beats::fromByteArray(kSampleRate, BEAT_MAP_VERSION, QString(), byteArray));
+
+    auto pOtherBeats = Beats::fromByteArray(
+            kSampleRate, BEAT_MAP_VERSION, QStringLiteral("Other"), byteArray);
+    ASSERT_NE(nullptr, pOtherBeats);
+    EXPECT_NE(pBeats, pOtherBeats);
+    EXPECT_EQ(*pBeats, *pOtherBeats);
+}
+
+TEST(BeatsTest, SerializeLegacyBeatGrid) {
+    const double legacyData[] = {kBpm.value(), kStartPosition.value()};
+    const QByteArray byteArray(
+            reinterpret_cast<const char*>(legacyData), sizeof(legacyData));
+
+    auto pBeats = Beats::fromByteArray(kSampleRate, BEAT_GRID_1_VERSION, QString(), byteArray);
+    ASSERT_NE(nullptr, pBeats);
+    EXPECT_EQ(BEAT_GRID_2_VERSION, pBeats->getVersion());
+    // Serialized in the current format instead of returning the legacy data
+    EXPECT_EQ(kConstTempoBeats.toByteArray(), pBeats->toByteArray());
+}
+
 TEST(BeatsTest, NonConstTempoFromBeatPositions) {
     QVector<audio::FramePos> beatPositions;
     const audio::FrameDiff_t beatLengthFrames = 60.0 * kSampleRate.value() / kBpm.value();
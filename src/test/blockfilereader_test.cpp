@@ -0,0 +1,81 @@
+#include "sources/blockfilereader.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <algorithm>
+
+namespace mixxx {
+
+class BlockFileReaderTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        // Spans more blocks than are cached
+        m_content = QByteArray(
+                (BlockFileReader::kMaxCachedBlocks + 3) * BlockFileReader::kBlockSize + 17,
+                '\0');
+        for (int i = 0; i < m_content.size(); ++i) {
+            m_content[i] = static_cast<char>(i % 251);
+        }
+        m_filePath = m_tempDir.filePath(QStringLiteral("content"));
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_EQ(m_content.size(), file.write(m_content));
+    }
+
+    QByteArray readAt(BlockFileReader* pReader, qint64 pos, qint64 size) {
+        EXPECT_TRUE(pReader->seek(pos));
+        QByteArray data(static_cast<int>(size), '\0');
+        const qint64 readSize = pReader->read(data.data(), size);
+        EXPECT_GE(readSize, 0);
+        data.truncate(static_cast<int>(readSize));
+        return data;
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+    QByteArray m_content;
+};
+
+TEST_F(BlockFileReaderTest, readSequentially) {
+    BlockFileReader reader(m_filePath);
+    ASSERT_TRUE(reader.open());
+    EXPECT_EQ(m_content.size(), reader.size());
+
+    QByteArray data;
+    char buffer[4093];
+    qint64 readSize;
+    while ((readSize = reader.read(buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, static_cast<int>(readSize));
+    }
+    EXPECT_EQ(0, readSize);
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_EQ(m_content, data);
+}
+
+TEST_F(BlockFileReaderTest, readAcrossBlocks) {
+    BlockFileReader reader(m_filePath);
+    ASSERT_TRUE(reader.open());
+
+    const qint64 blockSize = BlockFileReader::kBlockSize;
+    const qint64 positions[] = {
+            blockSize - 5,
+            0,
+            m_content.size() - 100,
+            3 * blockSize + 1,
+            blockSize - 5,
+    };
+    for (const qint64 pos : positions) {
+        EXPECT_EQ(m_content.mid(static_cast<int>(pos), 1000),
+                readAt(&reader, pos, 1000));
+        EXPECT_EQ(std::min(pos + 1000, reader.size()), reader.pos());
+    }
+
+    // Seeking to the end is allowed, but not beyond
+    EXPECT_EQ(QByteArray(), readAt(&reader, reader.size(), 10));
+    EXPECT_FALSE(reader.seek(reader.size() + 1));
+}
+
+} // namespace mixxx
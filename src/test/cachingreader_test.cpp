@@ -0,0 +1,235 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <memory>
+#include <vector>
+
+#include "engine/cachingreader/cachingreader.h"
+#include "engine/cachingreader/cachingreaderchunktable.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+// The table only stores the pointers, so any distinct address will do
+CachingReaderChunkForOwner* fakeChunk(std::vector<char>* pStorage, SINT i) {
+    return reinterpret_cast<CachingReaderChunkForOwner*>(pStorage->data() + i);
+}
+
+TEST(CachingReaderChunkTableTest, insertFindRemove) {
+    constexpr SINT kMaxSize = 80;
+    std::vector<char> storage(kMaxSize);
+    CachingReaderChunkTable table(kMaxSize);
+
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_TRUE(table.insert(i, fakeChunk(&storage, i)));
+    }
+    EXPECT_EQ(kMaxSize, table.size());
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_EQ(fakeChunk(&storage, i), table.find(i));
+    }
+    EXPECT_EQ(nullptr, table.find(kMaxSize));
+
+    // Remove every other entry and verify that the remaining entries
+    // are still found
+    for (SINT i = 0; i < kMaxSize; i += 2) {
+        EXPECT_EQ(1, table.remove(i));
+        EXPECT_EQ(0, table.remove(i));
+    }
+    EXPECT_EQ(kMaxSize / 2, table.size());
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_EQ(i % 2 == 0 ? nullptr : fakeChunk(&storage, i), table.find(i));
+    }
+
+    table.clear();
+    EXPECT_EQ(0, table.size());
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_EQ(nullptr, table.find(i));
+    }
+}
+
+TEST(CachingReaderChunkTableTest, collidingIndices) {
+    constexpr SINT kMaxSize = 16;
+    std::vector<char> storage(kMaxSize);
+    CachingReaderChunkTable table(kMaxSize);
+
+    // All indices are multiples of the capacity and share the same home slot,
+    // including wrap around at the end of the table.
+    const SINT kStride = 32;
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_TRUE(table.insert(kStride * i + kStride - 2, fakeChunk(&storage, i)));
+    }
+    for (SINT i = 0; i < kMaxSize; i += 3) {
+        EXPECT_EQ(1, table.remove(kStride * i + kStride - 2));
+    }
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_EQ(i % 3 == 0 ? nullptr : fakeChunk(&storage, i),
+                table.find(kStride * i + kStride - 2))
+                << "index " << i;
+    }
+}
+
+TEST(CachingReaderChunkTableTest, replace) {
+    std::vector<char> storage(2);
+    CachingReaderChunkTable table(4);
+    EXPECT_TRUE(table.insert(7, fakeChunk(&storage, 0)));
+    EXPECT_TRUE(table.insert(7, fakeChunk(&storage, 1)));
+    EXPECT_EQ(1, table.size());
+    EXPECT_EQ(fakeChunk(&storage, 1), table.find(7));
+}
+
+// Loads a short test track into a CachingReader and waits until the first
+// chunks are cached.
+class CachingReaderBenchmarkScope : public SoundSourceProviderRegistration {
+  public:
+    explicit CachingReaderBenchmarkScope(bool preloadAllTracks = false)
+            : m_reader(QStringLiteral("[Channel1]"),
+                      UserSettingsPointer(),
+                      mixxx::audio::ChannelCount::stereo()) {
+        m_scheduler.start();
+        m_reader.setScheduler(&m_scheduler);
+        m_reader.setPreloadAllTracks(preloadAllTracks);
+        m_reader.newTrack(Track::newTemporary(
+                MixxxTest::getOrInitTestDir().filePath(QStringLiteral("sine-30.wav"))));
+    }
+
+    ~CachingReaderBenchmarkScope() {
+        m_reader.newTrack(TrackPointer());
+    }
+
+    // Returns false if the frames could not be cached in time
+    bool cacheFrames(SINT frameCount) {
+        HintVector hints;
+        Hint hint;
+        hint.frame = 0;
+        hint.frameCount = frameCount;
+        hint.type = Hint::Type::CurrentPosition;
+        hints.append(hint);
+        return hintUntilCached(hints, 0, frameCount);
+    }
+
+    // Repeats the hints like the engine callback until the frames are
+    // cached. Returns false if the frames could not be cached in time.
+    bool hintUntilCached(const HintVector& hints, SINT frame, SINT frameCount) {
+        mixxx::SampleBuffer buffer(
+                CachingReaderChunk::frames2samples(
+                        frameCount, mixxx::audio::ChannelCount::stereo()));
+        for (int attempt = 0; attempt < 1000; ++attempt) {
+            m_reader.hintAndMaybeWake(hints);
+            m_scheduler.runWorkers();
+            if (read(frame, frameCount, buffer.data()) == CachingReader::ReadResult::AVAILABLE) {
+                return true;
+            }
+            QThread::msleep(10);
+        }
+        return false;
+    }
+
+    CachingReader::ReadResult read(SINT frame, SINT frameCount, CSAMPLE* pBuffer) {
+        return m_reader.read(
+                CachingReaderChunk::frames2samples(
+                        frame, mixxx::audio::ChannelCount::stereo()),
+                CachingReaderChunk::frames2samples(
+                        frameCount, mixxx::audio::ChannelCount::stereo()),
+                false,
+                pBuffer,
+                mixxx::audio::ChannelCount::stereo());
+    }
+
+  private:
+    EngineWorkerScheduler m_scheduler;
+    CachingReader m_reader;
+};
+
+constexpr SINT kCachedFrames = 4 * CachingReaderChunk::kDefaultFrames;
+
+TEST(CachingReaderTest, preloadHints) {
+    EXPECT_FALSE(Hint::isPreload(Hint::Type::CurrentPosition));
+    EXPECT_FALSE(Hint::isPreload(Hint::Type::LoopEndEnabled));
+    EXPECT_TRUE(Hint::isPreload(Hint::Type::HotCue));
+    EXPECT_TRUE(Hint::isPreload(Hint::Type::BeatJump));
+
+    CachingReaderBenchmarkScope scope;
+    HintVector hints;
+    // Many preload hints, each in a different chunk
+    constexpr int kNumHotCues = 16;
+    for (int i = 1; i <= kNumHotCues; ++i) {
+        hints.append({/*.frame =*/i * CachingReaderChunk::kMaxFrames,
+                /*.frameCount =*/Hint::kFrameCountForward,
+                /*.type =*/Hint::Type::HotCue});
+    }
+    hints.append({/*.frame =*/0,
+            /*.frameCount =*/kCachedFrames,
+            /*.type =*/Hint::Type::CurrentPosition});
+
+    // The current position is cached although it has been hinted last
+    EXPECT_TRUE(scope.hintUntilCached(hints, 0, kCachedFrames));
+    // The preload hints are cached eventually
+    EXPECT_TRUE(scope.hintUntilCached(hints,
+            kNumHotCues * CachingReaderChunk::kMaxFrames,
+            CachingReaderChunk::kDefaultFrames / 8));
+}
+
+TEST(CachingReaderTest, preloadAllTracks) {
+    CachingReaderBenchmarkScope scope(/*preloadAllTracks*/ true);
+    // No hints are needed once the track has been loaded
+    EXPECT_TRUE(scope.hintUntilCached(HintVector(), 0, kCachedFrames));
+    mixxx::SampleBuffer buffer(CachingReaderChunk::frames2samples(
+            kCachedFrames, mixxx::audio::ChannelCount::stereo()));
+    EXPECT_EQ(CachingReader::ReadResult::AVAILABLE,
+            scope.read(20 * 44100, kCachedFrames, buffer.data()));
+}
+
+TEST(CachingReaderTest, primeMainCue) {
+    CachingReaderBenchmarkScope scope;
+    constexpr SINT kFrames = CachingReaderChunk::kDefaultFrames / 8;
+    // The track has no main cue, so the start of the track has been decoded
+    // when loading it and is available without any hints
+    EXPECT_TRUE(scope.hintUntilCached(HintVector(), 0, kFrames));
+    // The rest of the track is streamed in chunks
+    mixxx::SampleBuffer buffer(CachingReaderChunk::frames2samples(
+            kFrames, mixxx::audio::ChannelCount::stereo()));
+    EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE,
+            scope.read(20 * 44100, kFrames, buffer.data()));
+}
+
+static void BM_CachingReaderReadHit(benchmark::State& state) {
+    CachingReaderBenchmarkScope scope;
+    if (!scope.cacheFrames(kCachedFrames)) {
+        state.SkipWithError("Failed to cache the test track");
+        return;
+    }
+    const SINT frameCount = static_cast<SINT>(state.range(0));
+    mixxx::SampleBuffer buffer(CachingReaderChunk::frames2samples(
+            frameCount, mixxx::audio::ChannelCount::stereo()));
+    SINT frame = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scope.read(frame, frameCount, buffer.data()));
+        // Walk through the cached chunks like a playing deck
+        frame = (frame + frameCount) % (kCachedFrames - frameCount);
+    }
+}
+BENCHMARK(BM_CachingReaderReadHit)->Range(64, 4096);
+
+static void BM_CachingReaderReadMiss(benchmark::State& state) {
+    CachingReaderBenchmarkScope scope;
+    if (!scope.cacheFrames(kCachedFrames)) {
+        state.SkipWithError("Failed to cache the test track");
+        return;
+    }
+    const SINT frameCount = static_cast<SINT>(state.range(0));
+    mixxx::SampleBuffer buffer(CachingReaderChunk::frames2samples(
+            frameCount, mixxx::audio::ChannelCount::stereo()));
+    // The chunk after the cached region has never been requested
+    const SINT frame = kCachedFrames + CachingReaderChunk::kMaxFrames;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scope.read(frame, frameCount, buffer.data()));
+    }
+}
+BENCHMARK(BM_CachingReaderReadMiss)->Range(64, 4096);
+
+} // namespace
@@ -0,0 +1,132 @@
+#include "engine/cachingreader/cachingreaderpcmcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <algorithm>
+#include <vector>
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+const QString kTrackLocation = QStringLiteral("id3-test-data/cover-test.wav");
+
+constexpr SINT kFramesPerRead = 4096;
+
+class CachingReaderPcmCacheTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_cacheDir.isValid());
+        m_pCache = std::make_unique<CachingReaderPcmCache>(
+                m_cacheDir.path(), 100 * 1024 * 1024);
+        m_pTrack = Track::newTemporary(getTestDir().filePath(kTrackLocation));
+    }
+
+    mixxx::AudioSourcePointer openTrack() const {
+        mixxx::AudioSource::OpenParams config;
+        config.setChannelCount(mixxx::audio::ChannelCount::stereo());
+        return SoundSourceProxy(m_pTrack).openAudioSource(config);
+    }
+
+    static std::vector<CSAMPLE> readAll(const mixxx::AudioSourcePointer& pAudioSource) {
+        std::vector<CSAMPLE> samples(
+                pAudioSource->getSignalInfo().frames2samples(pAudioSource->frameLength()));
+        const auto readable = pAudioSource->readSampleFrames(mixxx::WritableSampleFrames(
+                pAudioSource->frameIndexRange(),
+                mixxx::SampleBuffer::WritableSlice(samples.data(), samples.size())));
+        samples.resize(readable.readableLength());
+        return samples;
+    }
+
+    QTemporaryDir m_cacheDir;
+    std::unique_ptr<CachingReaderPcmCache> m_pCache;
+    TrackPointer m_pTrack;
+};
+
+TEST_F(CachingReaderPcmCacheTest, FedWriterSupersedesDecodingWriter) {
+    auto pDecodingWriter = m_pCache->newWriter(
+            m_pTrack, mixxx::audio::ChannelCount::stereo());
+    ASSERT_NE(nullptr, pDecodingWriter);
+
+    const auto pAudioSource = openTrack();
+    ASSERT_NE(nullptr, pAudioSource);
+    // Stem decks and the analysis share the cache file of a stereo track
+    auto pFedWriter = m_pCache->newFedWriter(
+            m_pTrack, mixxx::audio::ChannelCount::stem(), pAudioSource);
+    ASSERT_NE(nullptr, pFedWriter);
+
+    EXPECT_FALSE(pDecodingWriter->writeNext());
+    EXPECT_EQ(nullptr,
+            m_pCache->newWriter(m_pTrack, mixxx::audio::ChannelCount::stereo()));
+    EXPECT_EQ(nullptr,
+            m_pCache->newFedWriter(
+                    m_pTrack, mixxx::audio::ChannelCount::stereo(), pAudioSource));
+
+    // Feed the writer in chunks like the analysis
+    mixxx::SampleBuffer buffer(
+            pAudioSource->getSignalInfo().frames2samples(kFramesPerRead));
+    mixxx::IndexRange remaining = pAudioSource->frameIndexRange();
+    while (!remaining.empty()) {
+        const auto chunk = remaining.splitAndShrinkFront(
+                std::min(kFramesPerRead, remaining.length()));
+        const auto readable = pAudioSource->readSampleFrames(mixxx::WritableSampleFrames(
+                chunk, mixxx::SampleBuffer::WritableSlice(buffer)));
+        ASSERT_TRUE(pFedWriter->append(readable));
+    }
+    pFedWriter->finish();
+    pFedWriter.reset();
+
+    const auto pCached = m_pCache->openAudioSource(
+            m_pTrack, mixxx::audio::ChannelCount::stereo());
+    ASSERT_NE(nullptr, pCached);
+    EXPECT_EQ(pAudioSource->frameIndexRange(), pCached->frameIndexRange());
+    EXPECT_EQ(readAll(openTrack()), readAll(pCached));
+}
+
+TEST_F(CachingReaderPcmCacheTest, FedWriterDiscardsGaps) {
+    const auto pAudioSource = openTrack();
+    ASSERT_NE(nullptr, pAudioSource);
+    auto pFedWriter = m_pCache->newFedWriter(
+            m_pTrack, mixxx::audio::ChannelCount::stereo(), pAudioSource);
+    ASSERT_NE(nullptr, pFedWriter);
+
+    mixxx::SampleBuffer buffer(
+            pAudioSource->getSignalInfo().frames2samples(kFramesPerRead));
+    const auto chunk = mixxx::IndexRange::forward(
+            pAudioSource->frameIndexMin() + kFramesPerRead, kFramesPerRead);
+    const auto readable = pAudioSource->readSampleFrames(mixxx::WritableSampleFrames(
+            chunk, mixxx::SampleBuffer::WritableSlice(buffer)));
+    EXPECT_FALSE(pFedWriter->append(readable));
+    pFedWriter->finish();
+
+    EXPECT_EQ(nullptr,
+            m_pCache->openAudioSource(m_pTrack, mixxx::audio::ChannelCount::stereo()));
+}
+
+TEST_F(CachingReaderPcmCacheTest, FedWriterDiscardsTruncatedFile) {
+    const auto pAudioSource = openTrack();
+    ASSERT_NE(nullptr, pAudioSource);
+    ASSERT_GT(pAudioSource->frameLength(), kFramesPerRead);
+    auto pFedWriter = m_pCache->newFedWriter(
+            m_pTrack, mixxx::audio::ChannelCount::stereo(), pAudioSource);
+    ASSERT_NE(nullptr, pFedWriter);
+
+    // Only the first chunk, like an analysis that stopped reading early
+    mixxx::SampleBuffer buffer(
+            pAudioSource->getSignalInfo().frames2samples(kFramesPerRead));
+    const auto chunk = mixxx::IndexRange::forward(
+            pAudioSource->frameIndexMin(), kFramesPerRead);
+    const auto readable = pAudioSource->readSampleFrames(mixxx::WritableSampleFrames(
+            chunk, mixxx::SampleBuffer::WritableSlice(buffer)));
+    ASSERT_TRUE(pFedWriter->append(readable));
+    pFedWriter->finish();
+
+    EXPECT_EQ(nullptr,
+            m_pCache->openAudioSource(m_pTrack, mixxx::audio::ChannelCount::stereo()));
+}
+
+} // namespace
@@ -0,0 +1,78 @@
+#include "engine/cachingreader/cachingreaderprimecache.h"
+
+#include <gtest/gtest.h>
+
+#include <QThreadPool>
+
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+const QString kTrackLocation = QStringLiteral("id3-test-data/cover-test.wav");
+
+class CachingReaderPrimeCacheTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    static CachingReaderPrimeCache::EntryPointer newEntry(SINT frames) {
+        auto pEntry = std::make_shared<CachingReaderPrimeCache::Entry>();
+        pEntry->frameIndexRange = mixxx::IndexRange::forward(0, frames);
+        mixxx::SampleBuffer(frames * 2).swap(pEntry->samples);
+        return pEntry;
+    }
+};
+
+TEST_F(CachingReaderPrimeCacheTest, EvictLeastRecentlyUsed) {
+    const auto channelCount = mixxx::audio::ChannelCount::stereo();
+    CachingReaderPrimeCache cache(2);
+    cache.insert(QStringLiteral("a"), channelCount, newEntry(1));
+    cache.insert(QStringLiteral("b"), channelCount, newEntry(2));
+    EXPECT_NE(nullptr, cache.lookup(QStringLiteral("a"), channelCount));
+
+    cache.insert(QStringLiteral("c"), channelCount, newEntry(3));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_NE(nullptr, cache.lookup(QStringLiteral("a"), channelCount));
+    EXPECT_EQ(nullptr, cache.lookup(QStringLiteral("b"), channelCount));
+    EXPECT_NE(nullptr, cache.lookup(QStringLiteral("c"), channelCount));
+    // Entries of different channel counts are kept apart
+    EXPECT_EQ(nullptr, cache.lookup(QStringLiteral("c"), mixxx::audio::ChannelCount::stem()));
+}
+
+TEST_F(CachingReaderPrimeCacheTest, PrefetchFromStart) {
+    const auto channelCount = mixxx::audio::ChannelCount::stereo();
+    const TrackPointer pTrack = Track::newTemporary(getTestDir().filePath(kTrackLocation));
+    CachingReaderPrimeCache cache;
+    cache.prefetch(pTrack, channelCount);
+    QThreadPool::globalInstance()->waitForDone();
+
+    const auto pEntry = cache.lookup(pTrack->getLocation(), channelCount);
+    ASSERT_NE(nullptr, pEntry);
+
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(channelCount);
+    const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    ASSERT_NE(nullptr, pAudioSource);
+    EXPECT_EQ(pAudioSource->getSignalInfo(), pEntry->signalInfo);
+    EXPECT_EQ(pAudioSource->frameIndexRange().start(), pEntry->frameIndexRange.start());
+    EXPECT_TRUE(pEntry->frameIndexRange.isSubrangeOf(pAudioSource->frameIndexRange()));
+    EXPECT_FALSE(pEntry->frameIndexRange.empty());
+
+    // The mono file is decoded as stereo like the chunks
+    ASSERT_EQ(mixxx::audio::ChannelCount::mono(),
+            pAudioSource->getSignalInfo().getChannelCount());
+    mixxx::SampleBuffer tempReadBuffer(pEntry->frameIndexRange.length());
+    mixxx::AudioSourceStereoProxy stereoAudioSource(
+            pAudioSource, mixxx::SampleBuffer::WritableSlice(tempReadBuffer));
+    mixxx::SampleBuffer samples(pEntry->samples.size());
+    const auto readable = stereoAudioSource.readSampleFrames(mixxx::WritableSampleFrames(
+            pEntry->frameIndexRange,
+            mixxx::SampleBuffer::WritableSlice(samples)));
+    ASSERT_EQ(pEntry->frameIndexRange, readable.frameIndexRange());
+    for (SINT i = 0; i < samples.size(); ++i) {
+        EXPECT_EQ(samples[i], pEntry->samples[i]);
+    }
+}
+
+} // namespace
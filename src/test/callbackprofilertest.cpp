@@ -0,0 +1,115 @@
+#include "util/callbackprofiler.h"
+
+#include <gtest/gtest.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "test/mockedenginebackendtest.h"
+
+namespace {
+
+class CallbackProfilerTest : public MockedEngineBackendTest {
+  protected:
+    void SetUp() override {
+        MockedEngineBackendTest::SetUp();
+        CallbackProfiler::instance().drain();
+        CallbackProfiler::instance().reset();
+    }
+
+    void TearDown() override {
+        CallbackProfiler::instance().setEnabled(false);
+        CallbackProfiler::instance().reset();
+        MockedEngineBackendTest::TearDown();
+    }
+
+    static const CallbackProfiler::StageStatistics* findStage(
+            const QList<CallbackProfiler::StageStatistics>& statistics,
+            const QString& name) {
+        for (const auto& stage : statistics) {
+            if (stage.name == name) {
+                return &stage;
+            }
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(CallbackProfilerTest, RegisterStageTwice) {
+    CallbackProfiler& profiler = CallbackProfiler::instance();
+    const auto stage = profiler.registerStage(QStringLiteral("CallbackProfilerTest"));
+    EXPECT_NE(CallbackProfiler::kInvalidStage, stage);
+    EXPECT_EQ(stage, profiler.registerStage(QStringLiteral("CallbackProfilerTest")));
+}
+
+TEST_F(CallbackProfilerTest, Percentiles) {
+    CallbackProfiler& profiler = CallbackProfiler::instance();
+    const auto stage = profiler.registerStage(QStringLiteral("CallbackProfilerTest"));
+
+    for (int i = 1; i <= 100; ++i) {
+        profiler.record(stage, 1000000, 1000000 + i * 1000);
+    }
+    EXPECT_EQ(100, profiler.drain());
+
+    const auto statistics = profiler.statistics();
+    const auto* pStage = findStage(statistics, QStringLiteral("CallbackProfilerTest"));
+    ASSERT_NE(nullptr, pStage);
+    EXPECT_EQ(100, pStage->count);
+    EXPECT_EQ(50000, pStage->p50Ns);
+    EXPECT_EQ(99000, pStage->p99Ns);
+    EXPECT_EQ(100000, pStage->maxNs);
+
+    profiler.reset();
+    EXPECT_EQ(nullptr,
+            findStage(profiler.statistics(), QStringLiteral("CallbackProfilerTest")));
+}
+
+TEST_F(CallbackProfilerTest, ScopeOnlyRecordsWhenEnabled) {
+    CallbackProfiler& profiler = CallbackProfiler::instance();
+    const auto stage = profiler.registerStage(QStringLiteral("CallbackProfilerTest"));
+
+    { const CallbackProfiler::Scope scope(stage); }
+    EXPECT_EQ(0, profiler.drain());
+
+    profiler.setEnabled(true);
+    { const CallbackProfiler::Scope scope(stage); }
+    EXPECT_EQ(1, profiler.drain());
+}
+
+TEST_F(CallbackProfilerTest, EngineStages) {
+    CallbackProfiler& profiler = CallbackProfiler::instance();
+    profiler.setEnabled(true);
+    for (int i = 0; i < 10; ++i) {
+        m_pEngineMixer->process(kProcessBufferSize);
+    }
+    profiler.setEnabled(false);
+    EXPECT_GT(profiler.drain(), 0);
+    EXPECT_GT(profiler.deadlineNs(), 0);
+
+    const auto statistics = profiler.statistics();
+    const auto* pMixer = findStage(statistics, QStringLiteral("EngineMixer::process"));
+    ASSERT_NE(nullptr, pMixer);
+    EXPECT_EQ(10, pMixer->count);
+}
+
+TEST_F(CallbackProfilerTest, ChromeTrace) {
+    CallbackProfiler& profiler = CallbackProfiler::instance();
+    const auto stage = profiler.registerStage(QStringLiteral("CallbackProfilerTest"));
+    profiler.record(stage, 1000000, 1002500);
+    profiler.record(stage, 2000000, 2001000);
+    profiler.drain();
+
+    QJsonParseError error;
+    const auto document = QJsonDocument::fromJson(profiler.chromeTraceJson(), &error);
+    ASSERT_EQ(QJsonParseError::NoError, error.error);
+    const QJsonArray traceEvents = document.object().value("traceEvents").toArray();
+    ASSERT_EQ(2, traceEvents.size());
+    const QJsonObject event = traceEvents.first().toObject();
+    EXPECT_EQ(QStringLiteral("CallbackProfilerTest"), event.value("name").toString());
+    EXPECT_EQ(QStringLiteral("X"), event.value("ph").toString());
+    EXPECT_DOUBLE_EQ(1000.0, event.value("ts").toDouble());
+    EXPECT_DOUBLE_EQ(2.5, event.value("dur").toDouble());
+}
+
+} // namespace
@@ -139,4 +139,17 @@ TEST_F(ConfigObjectTest, Save) {
     }
 }
 
+TEST_F(ConfigObjectTest, SaveDeferred) {
+    const QString fileName = getTestDataDir().filePath("deferred.cfg");
+    const auto ck = ConfigKey("[Test]", "deferred");
+    {
+        UserSettings settings(fileName);
+        settings.setValue(ck, 5);
+        settings.saveDeferred();
+        // The pending save is written when the ConfigObject is destroyed
+    }
+    UserSettings settings(fileName);
+    EXPECT_EQ(5, settings.getValue<int>(ck, -1));
+}
+
 }  // namespace
@@ -0,0 +1,78 @@
+#include "control/controlchangecoalescer.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <memory>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlChangeCoalescerTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ControlChangeCoalescer::setEnabled(true);
+        m_key = ConfigKey("[Channel1]", "coalesced");
+        m_pControl = std::make_unique<ControlObject>(m_key);
+        m_pProxy = std::make_unique<ControlProxy>(m_key);
+        m_pProxy->connectValueChanged(m_pProxy.get(), [this](double value) {
+            m_receivedValues.append(value);
+        });
+    }
+
+    void TearDown() override {
+        m_pProxy.reset();
+        ControlChangeCoalescer::setEnabled(false);
+    }
+
+    ConfigKey m_key;
+    std::unique_ptr<ControlObject> m_pControl;
+    std::unique_ptr<ControlProxy> m_pProxy;
+    QList<double> m_receivedValues;
+};
+
+TEST_F(ControlChangeCoalescerTest, OnlyLatestValueIsDispatched) {
+    m_pControl->set(1.0);
+    m_pControl->set(2.0);
+    m_pControl->set(3.0);
+    EXPECT_TRUE(m_receivedValues.isEmpty());
+
+    ControlChangeCoalescer::dispatch();
+    EXPECT_EQ(QList<double>{3.0}, m_receivedValues);
+
+    // Nothing changed in the meantime
+    ControlChangeCoalescer::dispatch();
+    EXPECT_EQ(1, m_receivedValues.size());
+}
+
+TEST_F(ControlChangeCoalescerTest, OwnChangesAreNotDispatched) {
+    m_pProxy->set(1.0);
+    ControlChangeCoalescer::dispatch();
+    EXPECT_TRUE(m_receivedValues.isEmpty());
+    EXPECT_DOUBLE_EQ(1.0, m_pProxy->get());
+}
+
+TEST_F(ControlChangeCoalescerTest, DeletedProxyIsUnsubscribed) {
+    m_pControl->set(1.0);
+    m_pProxy.reset();
+    // Must not access the deleted proxy
+    ControlChangeCoalescer::dispatch();
+    EXPECT_TRUE(m_receivedValues.isEmpty());
+}
+
+TEST_F(ControlChangeCoalescerTest, DisabledDeliversEveryChange) {
+    ControlChangeCoalescer::setEnabled(false);
+    ControlProxy proxy(m_key);
+    QList<double> values;
+    proxy.connectValueChanged(&proxy, [&values](double value) {
+        values.append(value);
+    });
+    m_pControl->set(1.0);
+    m_pControl->set(2.0);
+    EXPECT_EQ((QList<double>{1.0, 2.0}), values);
+}
+
+} // namespace
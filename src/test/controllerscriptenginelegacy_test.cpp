@@ -96,7 +96,7 @@ class ControllerScriptEngineLegacyTest : public ControllerScriptEngineLegacy, pu
             const LegacyControllerMapping::ScreenInfo& screeninfo,
             const QImage& frame,
             const QDateTime& timestamp) {
-        handleScreenFrame(screeninfo, frame, timestamp);
+        handleScreenFrame(screeninfo, frame, timestamp, frame.rect());
     }
 
     TransformScreenFrameFunction newTransformScreenFrameFunction(
@@ -132,6 +132,19 @@ TEST_F(ControllerScriptEngineLegacyTest, getValue_InvalidControl) {
     EXPECT_TRUE(evaluateAndAssert("engine.getValue('[Nothing]', 'nothing');"));
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, getValue_ControlCreatedLater) {
+    // The failed lookup is cached, but must not hide the control once it
+    // has been created.
+    EXPECT_TRUE(evaluateAndAssert("engine.getValue('[Test]', 'later');"));
+    EXPECT_TRUE(evaluateAndAssert("engine.getValue('[Test]', 'later');"));
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "later"));
+    co->set(5.0);
+    EXPECT_TRUE(
+            evaluateAndAssert("engine.setValue('[Test]', 'later', "
+                              "engine.getValue('[Test]', 'later') + 1);"));
+    EXPECT_DOUBLE_EQ(6.0, co->get());
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, setValue_IgnoresNaN) {
     auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
     co->set(10.0);
@@ -659,6 +672,48 @@ TEST_F(ControllerScriptEngineLegacyTest, connectionExecutesWithCorrectThisObject
     EXPECT_DOUBLE_EQ(1.0, pass->get());
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, incomingDataIsPassedAsUint8Array) {
+    auto sum = std::make_unique<ControlObject>(ConfigKey("[Test]", "sum"));
+    auto length = std::make_unique<ControlObject>(ConfigKey("[Test]", "length"));
+    m_incomingDataFunctions.append(evaluate(
+            "(function(data, length) {"
+            "  if (data instanceof Uint8Array) {"
+            "    engine.setValue('[Test]', 'sum', data[0] + data[1] + data[2]);"
+            "  }"
+            "  engine.setValue('[Test]', 'length', length);"
+            "})"));
+
+    EXPECT_TRUE(handleIncomingData(QByteArray::fromHex("0102ff")));
+    EXPECT_DOUBLE_EQ(258.0, sum->get());
+    EXPECT_DOUBLE_EQ(3.0, length->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, skipUnchangedIncomingData) {
+    auto counter = std::make_unique<ControlObject>(ConfigKey("[Test]", "counter"));
+    m_incomingDataFunctions.append(evaluate(
+            "(function(data, length) {"
+            "  engine.setValue('[Test]', 'counter',"
+            "      engine.getValue('[Test]', 'counter') + 1);"
+            "})"));
+
+    const QByteArray data = QByteArray::fromHex("0102");
+    EXPECT_TRUE(handleIncomingData(data));
+    EXPECT_TRUE(handleIncomingData(data));
+    EXPECT_DOUBLE_EQ(2.0, counter->get());
+
+    EXPECT_TRUE(evaluateAndAssert("engine.skipUnchangedIncomingData(true);"));
+    EXPECT_TRUE(handleIncomingData(data));
+    EXPECT_TRUE(handleIncomingData(data));
+    EXPECT_DOUBLE_EQ(3.0, counter->get());
+    EXPECT_TRUE(handleIncomingData(QByteArray::fromHex("0103")));
+    EXPECT_TRUE(handleIncomingData(data));
+    EXPECT_DOUBLE_EQ(5.0, counter->get());
+
+    EXPECT_TRUE(evaluateAndAssert("engine.skipUnchangedIncomingData(false);"));
+    EXPECT_TRUE(handleIncomingData(data));
+    EXPECT_DOUBLE_EQ(6.0, counter->get());
+}
+
 #ifdef MIXXX_USE_QML
 class MockScreenRender : public ControllerRenderingEngine {
   public:
@@ -0,0 +1,80 @@
+#include "controllers/scripting/controllerscriptsourcecache.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+void writeFile(const QString& filePath, const QByteArray& contents) {
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(contents);
+}
+
+} // anonymous namespace
+
+class ControllerScriptSourceCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_filePath = m_tempDir.filePath(QStringLiteral("script.js"));
+        ControllerScriptSourceCache::clear();
+    }
+
+    void TearDown() override {
+        ControllerScriptSourceCache::clear();
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+};
+
+TEST_F(ControllerScriptSourceCacheTest, readSourceCode) {
+    writeFile(m_filePath, "var a = 1;");
+    QString sourceCode;
+    QString errorString;
+    ASSERT_TRUE(ControllerScriptSourceCache::readSourceCode(
+            m_filePath, &sourceCode, &errorString));
+    EXPECT_EQ(QStringLiteral("var a = 1;\n"), sourceCode);
+}
+
+TEST_F(ControllerScriptSourceCacheTest, missingFile) {
+    QString sourceCode;
+    QString errorString;
+    EXPECT_FALSE(ControllerScriptSourceCache::readSourceCode(
+            m_tempDir.filePath(QStringLiteral("missing.js")),
+            &sourceCode,
+            &errorString));
+    EXPECT_FALSE(errorString.isEmpty());
+}
+
+TEST_F(ControllerScriptSourceCacheTest, invalidate) {
+    writeFile(m_filePath, "var a = 1;");
+    QString sourceCode;
+    QString errorString;
+    ASSERT_TRUE(ControllerScriptSourceCache::readSourceCode(
+            m_filePath, &sourceCode, &errorString));
+
+    // Same size and possibly the same modification time, which can't be
+    // detected without an explicit invalidation.
+    writeFile(m_filePath, "var b = 2;");
+    ControllerScriptSourceCache::invalidate(m_filePath);
+    ASSERT_TRUE(ControllerScriptSourceCache::readSourceCode(
+            m_filePath, &sourceCode, &errorString));
+    EXPECT_EQ(QStringLiteral("var b = 2;\n"), sourceCode);
+}
+
+TEST_F(ControllerScriptSourceCacheTest, changedSize) {
+    writeFile(m_filePath, "var a = 1;");
+    QString sourceCode;
+    QString errorString;
+    ASSERT_TRUE(ControllerScriptSourceCache::readSourceCode(
+            m_filePath, &sourceCode, &errorString));
+
+    writeFile(m_filePath, "var abc = 1;");
+    ASSERT_TRUE(ControllerScriptSourceCache::readSourceCode(
+            m_filePath, &sourceCode, &errorString));
+    EXPECT_EQ(QStringLiteral("var abc = 1;\n"), sourceCode);
+}
@@ -0,0 +1,77 @@
+#include "control/controlsnapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlSnapshotTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ck1 = ConfigKey("[Channel1]", "co1");
+        ck2 = ConfigKey("[Channel1]", "co2");
+        co1 = std::make_unique<ControlObject>(ck1);
+        co2 = std::make_unique<ControlObject>(ck2);
+    }
+
+    ConfigKey ck1, ck2;
+    std::unique_ptr<ControlObject> co1;
+    std::unique_ptr<ControlObject> co2;
+};
+
+TEST_F(ControlSnapshotTest, ValuesChangeOnlyOnUpdate) {
+    co1->set(1.0);
+    ControlSnapshot snapshot;
+    const auto proxy1 = snapshot.subscribe(ck1);
+    const auto proxy2 = snapshot.subscribe(ck2);
+    EXPECT_TRUE(proxy1.isSubscribed());
+    EXPECT_DOUBLE_EQ(1.0, proxy1.get());
+    EXPECT_DOUBLE_EQ(0.0, proxy2.get());
+
+    co1->set(2.0);
+    co2->set(3.0);
+    EXPECT_DOUBLE_EQ(1.0, proxy1.get());
+    EXPECT_DOUBLE_EQ(0.0, proxy2.get());
+
+    snapshot.update();
+    EXPECT_DOUBLE_EQ(2.0, proxy1.get());
+    EXPECT_DOUBLE_EQ(3.0, proxy2.get());
+    EXPECT_TRUE(proxy2.toBool());
+}
+
+TEST_F(ControlSnapshotTest, SubscribeTwice) {
+    ControlSnapshot snapshot;
+    snapshot.subscribe(ck1);
+    snapshot.subscribe(ck2);
+    const auto proxy = snapshot.subscribe(ck1);
+    EXPECT_EQ(2, snapshot.size());
+
+    co1->set(4.0);
+    snapshot.update();
+    EXPECT_DOUBLE_EQ(4.0, proxy.get());
+}
+
+TEST_F(ControlSnapshotTest, MissingControl) {
+    ControlSnapshot snapshot;
+    const auto proxy = snapshot.subscribe(ConfigKey("[Channel1]", "missing"),
+            ControlFlag::AllowMissingOrInvalid);
+    snapshot.update();
+    EXPECT_DOUBLE_EQ(0.0, proxy.get());
+    EXPECT_FALSE(proxy.toBool());
+}
+
+TEST_F(ControlSnapshotTest, OutlivesControlObject) {
+    ControlSnapshot snapshot;
+    const auto proxy = snapshot.subscribe(ck1);
+    co1->set(5.0);
+    co1.reset();
+    // The snapshot keeps the control alive
+    snapshot.update();
+    EXPECT_DOUBLE_EQ(5.0, proxy.get());
+}
+
+} // namespace
@@ -310,3 +310,57 @@ TEST_F(CoverArtUtilTest, searchImage) {
         QFile::remove(loc);
     }
 }
+
+TEST_F(CoverArtUtilTest, guessCoverInfoFromCache) {
+    QTemporaryDir tempTrackDir;
+    ASSERT_TRUE(tempTrackDir.isValid());
+    const QString trackDir = tempTrackDir.path();
+    const mixxx::FileInfo trackFile1(trackDir + QStringLiteral("/track1.mp3"));
+    const mixxx::FileInfo trackFile2(trackDir + QStringLiteral("/track2.mp3"));
+    const mixxx::FileInfo trackFile3(trackDir + QStringLiteral("/track3.mp3"));
+    const QString albumName = QStringLiteral("album_name");
+
+    const QImage img(getTestDir().filePath(kReferencePNGLocationTest));
+    ASSERT_FALSE(img.isNull());
+
+    CoverInfoGuesser coverInfoGuesser;
+
+    // Identical embedded covers of different tracks
+    CoverInfoRelative expectedEmbedded;
+    expectedEmbedded.source = CoverInfo::GUESSED;
+    expectedEmbedded.type = CoverInfo::METADATA;
+    expectedEmbedded.setImageDigest(img);
+    EXPECT_EQ(expectedEmbedded,
+            coverInfoGuesser.guessCoverInfo(trackFile1, albumName, img));
+    EXPECT_EQ(expectedEmbedded,
+            coverInfoGuesser.guessCoverInfo(trackFile2, albumName, img.copy()));
+
+    // A different embedded cover must not be mistaken for the cached one
+    const QImage scaledImg = img.scaled(10, 10);
+    CoverInfoRelative expectedScaled;
+    expectedScaled.source = CoverInfo::GUESSED;
+    expectedScaled.type = CoverInfo::METADATA;
+    expectedScaled.setImageDigest(scaledImg);
+    EXPECT_EQ(expectedScaled,
+            coverInfoGuesser.guessCoverInfo(trackFile3, albumName, scaledImg));
+
+    // The cover file of the folder is loaded once for all tracks. The
+    // folder is visited anew to list the cover file that has been saved
+    // after visiting it first.
+    coverInfoGuesser = CoverInfoGuesser();
+    const QString coverLocation = trackDir + QStringLiteral("/cover.jpg");
+    ASSERT_TRUE(img.save(coverLocation, "jpg"));
+    CoverInfoRelative expectedFile;
+    expectedFile.source = CoverInfo::GUESSED;
+    expectedFile.type = CoverInfo::FILE;
+    expectedFile.coverLocation = QStringLiteral("cover.jpg");
+    expectedFile.setImageDigest(QImage(coverLocation));
+    EXPECT_EQ(expectedFile,
+            coverInfoGuesser.guessCoverInfo(trackFile1, albumName, QImage()));
+
+    // Overwriting the cover file during a scan does not affect the
+    // tracks of the same folder
+    ASSERT_TRUE(img.scaled(10, 10).save(coverLocation, "jpg"));
+    EXPECT_EQ(expectedFile,
+            coverInfoGuesser.guessCoverInfo(trackFile2, albumName, QImage()));
+}
@@ -0,0 +1,101 @@
+#include "library/coverthumbnailpack.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr qint64 kMaxFileSize = 1024 * 1024;
+
+class CoverThumbnailPackTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_packDir.isValid());
+    }
+
+    QString packFilePath() const {
+        return m_packDir.filePath(QStringLiteral("coverthumbnails.pack"));
+    }
+
+    static QImage newImage(int width, QColor color) {
+        QImage image(width, width, QImage::Format_RGB32);
+        image.fill(color);
+        return image;
+    }
+
+    QTemporaryDir m_packDir;
+};
+
+TEST_F(CoverThumbnailPackTest, storeAndLoad) {
+    CoverThumbnailPack pack(packFilePath(), kMaxFileSize);
+    ASSERT_TRUE(pack.isOpen());
+
+    EXPECT_TRUE(pack.load(1, 32).isNull());
+
+    pack.store(1, 32, newImage(32, Qt::red));
+    pack.store(1, 64, newImage(64, Qt::green));
+
+    const QImage image = pack.load(1, 32);
+    ASSERT_FALSE(image.isNull());
+    EXPECT_EQ(QSize(32, 32), image.size());
+    EXPECT_EQ(QSize(64, 64), pack.load(1, 64).size());
+    // Unknown widths and cache keys
+    EXPECT_TRUE(pack.load(1, 16).isNull());
+    EXPECT_TRUE(pack.load(2, 32).isNull());
+}
+
+TEST_F(CoverThumbnailPackTest, persistAcrossInstances) {
+    {
+        CoverThumbnailPack pack(packFilePath(), kMaxFileSize);
+        pack.store(1, 32, newImage(32, Qt::red));
+        pack.store(2, 32, newImage(32, Qt::blue));
+    }
+    CoverThumbnailPack pack(packFilePath(), kMaxFileSize);
+    ASSERT_TRUE(pack.isOpen());
+    EXPECT_EQ(QSize(32, 32), pack.load(1, 32).size());
+    EXPECT_EQ(QSize(32, 32), pack.load(2, 32).size());
+}
+
+TEST_F(CoverThumbnailPackTest, dropIncompleteRecord) {
+    {
+        CoverThumbnailPack pack(packFilePath(), kMaxFileSize);
+        pack.store(1, 32, newImage(32, Qt::red));
+        pack.store(2, 32, newImage(32, Qt::blue));
+    }
+    // Cut off the end of the last record
+    {
+        QFile file(packFilePath());
+        ASSERT_TRUE(file.resize(file.size() - 1));
+    }
+    CoverThumbnailPack pack(packFilePath(), kMaxFileSize);
+    ASSERT_TRUE(pack.isOpen());
+    EXPECT_FALSE(pack.load(1, 32).isNull());
+    EXPECT_TRUE(pack.load(2, 32).isNull());
+
+    // Appending after the dropped record still works
+    pack.store(3, 32, newImage(32, Qt::green));
+    EXPECT_FALSE(pack.load(3, 32).isNull());
+}
+
+TEST_F(CoverThumbnailPackTest, discardWhenExceedingMaxFileSize) {
+    const QImage image = newImage(32, Qt::red);
+    CoverThumbnailPack pack(packFilePath(), kMaxFileSize);
+    mixxx::cache_key_t cacheKey = 1;
+    pack.store(cacheKey, 32, image);
+    const qint64 recordSize = QFile(packFilePath()).size();
+    ASSERT_GT(recordSize, 0);
+    // Fill the pack until it has been discarded once
+    const auto recordCount = kMaxFileSize / recordSize + 1;
+    for (int i = 0; i < recordCount; ++i) {
+        pack.store(++cacheKey, 32, image);
+    }
+    EXPECT_TRUE(pack.load(1, 32).isNull());
+    EXPECT_FALSE(pack.load(cacheKey, 32).isNull());
+    EXPECT_LE(QFile(packFilePath()).size(), kMaxFileSize);
+}
+
+} // namespace
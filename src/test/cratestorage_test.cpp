@@ -65,3 +65,57 @@ TEST_F(CrateStorageTest, persistentLifecycle) {
     EXPECT_FALSE(m_crateStorage.readCrateByName(kNewCrateName));
     EXPECT_EQ(kNumCrates - 1, m_crateStorage.countCrates());
 }
+
+TEST_F(CrateStorageTest, trackIndex) {
+    CrateId crateIdA;
+    CrateId crateIdB;
+    {
+        Crate crate;
+        crate.setName(QStringLiteral("Crate A"));
+        ASSERT_TRUE(m_crateStorage.onInsertingCrate(crate, &crateIdA));
+        crate.setName(QStringLiteral("Crate B"));
+        ASSERT_TRUE(m_crateStorage.onInsertingCrate(crate, &crateIdB));
+    }
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+    const TrackId trackId3(QVariant(3));
+
+    ASSERT_TRUE(m_crateStorage.onAddingCrateTracks(crateIdA, {trackId1, trackId2}));
+    m_crateStorage.afterAddingCrateTracks(crateIdA, {trackId1, trackId2});
+    ASSERT_TRUE(m_crateStorage.onAddingCrateTracks(crateIdB, {trackId2}));
+    m_crateStorage.afterAddingCrateTracks(crateIdB, {trackId2});
+
+    EXPECT_EQ(2u, m_crateStorage.countCrateTracks(crateIdA));
+    EXPECT_EQ(1u, m_crateStorage.countCrateTracks(crateIdB));
+    EXPECT_EQ(1u, m_crateStorage.countCrateTracks(crateIdA, {trackId2, trackId3}));
+    EXPECT_TRUE(m_crateStorage.isTrackInCrate(crateIdA, trackId1));
+    EXPECT_FALSE(m_crateStorage.isTrackInCrate(crateIdB, trackId1));
+    EXPECT_TRUE(m_crateStorage.isTrackInAnyCrate(trackId2));
+    EXPECT_FALSE(m_crateStorage.isTrackInAnyCrate(trackId3));
+    EXPECT_EQ(QSet<CrateId>({crateIdA, crateIdB}),
+            m_crateStorage.collectCrateIdsOfTracks({trackId2, trackId3}));
+    EXPECT_EQ(QList<CrateId>{crateIdB},
+            m_crateStorage.collectCrateIdsByNameLike(QStringLiteral("B")));
+
+    // The index is restored from the database
+    m_crateStorage.disconnectDatabase();
+    m_crateStorage.connectDatabase(dbConnection());
+    EXPECT_EQ(2u, m_crateStorage.countCrateTracks(crateIdA));
+    EXPECT_TRUE(m_crateStorage.isTrackInCrate(crateIdB, trackId2));
+
+    ASSERT_TRUE(m_crateStorage.onRemovingCrateTracks(crateIdA, {trackId1}));
+    m_crateStorage.afterRemovingCrateTracks(crateIdA, {trackId1});
+    EXPECT_FALSE(m_crateStorage.isTrackInAnyCrate(trackId1));
+    EXPECT_EQ(1u, m_crateStorage.countCrateTracks(crateIdA));
+
+    ASSERT_TRUE(m_crateStorage.onDeletingCrate(crateIdA));
+    m_crateStorage.afterDeletingCrate(crateIdA);
+    EXPECT_EQ(0u, m_crateStorage.countCrateTracks(crateIdA));
+    // Still contained in crate B
+    EXPECT_TRUE(m_crateStorage.isTrackInAnyCrate(trackId2));
+
+    ASSERT_TRUE(m_crateStorage.onPurgingTracks({trackId2}));
+    m_crateStorage.afterPurgingTracks({trackId2});
+    EXPECT_FALSE(m_crateStorage.isTrackInAnyCrate(trackId2));
+    EXPECT_EQ(0u, m_crateStorage.countCrateTracks(crateIdB));
+}
@@ -0,0 +1,69 @@
+#include "util/db/dbwritequeue.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+#include <memory>
+
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+class DbWriteQueueTest : public MixxxDbTest {
+  protected:
+    DbWriteQueueTest()
+            : MixxxDbTest(true) {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "CREATE TABLE db_write_queue_test (value INTEGER UNIQUE)")));
+    }
+
+    static mixxx::DbWriteQueue::Write insertValue(int value) {
+        return [value](const QSqlDatabase& database) {
+            QSqlQuery query(database);
+            query.prepare(QStringLiteral(
+                    "INSERT INTO db_write_queue_test (value) VALUES (:value)"));
+            query.bindValue(QStringLiteral(":value"), value);
+            return query.exec();
+        };
+    }
+
+    QList<int> selectValues() const {
+        QList<int> values;
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "SELECT value FROM db_write_queue_test ORDER BY value")));
+        while (query.next()) {
+            values.append(query.value(0).toInt());
+        }
+        return values;
+    }
+};
+
+TEST_F(DbWriteQueueTest, PendingWritesAreExecutedBeforeDestruction) {
+    auto pWriteQueue = std::make_unique<mixxx::DbWriteQueue>(dbConnectionPooler());
+    pWriteQueue->start();
+    for (int i = 0; i < mixxx::DbWriteQueue::kMaxBatchSize + 1; ++i) {
+        pWriteQueue->enqueue(insertValue(i));
+    }
+    pWriteQueue.reset();
+
+    EXPECT_EQ(mixxx::DbWriteQueue::kMaxBatchSize + 1, selectValues().size());
+}
+
+TEST_F(DbWriteQueueTest, FailingWritesDontAffectOthers) {
+    auto pWriteQueue = std::make_unique<mixxx::DbWriteQueue>(dbConnectionPooler());
+    pWriteQueue->enqueue(insertValue(1));
+    pWriteQueue->enqueue([](const QSqlDatabase& database) {
+        // Partially applied before failing
+        return insertValue(2)(database) && insertValue(1)(database);
+    });
+    pWriteQueue->enqueue(insertValue(3));
+    // All writes are committed together after starting
+    pWriteQueue->start();
+    pWriteQueue.reset();
+
+    EXPECT_EQ(QList<int>({1, 3}), selectValues());
+}
+
+} // namespace
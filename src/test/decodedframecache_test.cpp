@@ -0,0 +1,91 @@
+#include "sources/decodedframecache.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const mixxx::audio::SignalInfo kSignalInfo(
+        mixxx::audio::ChannelCount::mono(),
+        mixxx::audio::SampleRate(1000));
+
+class DecodedFrameCacheTest : public testing::Test {
+  protected:
+    // The sample value of each frame equals its index
+    void record(mixxx::DecodedFrameCache* pCache, mixxx::IndexRange range) {
+        mixxx::SampleBuffer buffer(range.length());
+        for (SINT i = 0; i < range.length(); ++i) {
+            buffer.data()[i] = static_cast<CSAMPLE>(range.start() + i);
+        }
+        pCache->record(mixxx::ReadableSampleFrames(range,
+                mixxx::SampleBuffer::ReadableSlice(buffer.data(), buffer.size())));
+    }
+
+    // Returns the remaining range that has not been served
+    mixxx::IndexRange read(mixxx::DecodedFrameCache* pCache, mixxx::IndexRange range) {
+        mixxx::SampleBuffer buffer(range.length());
+        const auto remaining = pCache->read(mixxx::WritableSampleFrames(range,
+                mixxx::SampleBuffer::WritableSlice(buffer)));
+        const SINT servedCount = remaining.frameIndexRange().start() - range.start();
+        for (SINT i = 0; i < servedCount; ++i) {
+            EXPECT_EQ(static_cast<CSAMPLE>(range.start() + i), buffer.data()[i]);
+        }
+        return remaining.frameIndexRange();
+    }
+};
+
+TEST_F(DecodedFrameCacheTest, history) {
+    mixxx::DecodedFrameCache cache(kSignalInfo, 100, 0, 0);
+    record(&cache, mixxx::IndexRange::between(0, 50));
+    record(&cache, mixxx::IndexRange::between(50, 150));
+
+    // Only the last 100 frames are kept
+    EXPECT_EQ(mixxx::IndexRange::between(40, 60),
+            read(&cache, mixxx::IndexRange::between(40, 60)));
+    EXPECT_EQ(mixxx::IndexRange::between(80, 80),
+            read(&cache, mixxx::IndexRange::between(60, 80)));
+    EXPECT_EQ(mixxx::IndexRange::between(150, 160),
+            read(&cache, mixxx::IndexRange::between(140, 160)));
+
+    // Serving from the history doesn't truncate it
+    record(&cache, mixxx::IndexRange::between(60, 80));
+    EXPECT_EQ(mixxx::IndexRange::between(150, 150),
+            read(&cache, mixxx::IndexRange::between(100, 150)));
+
+    // A discontinuity starts a new history
+    record(&cache, mixxx::IndexRange::between(1000, 1010));
+    EXPECT_EQ(mixxx::IndexRange::between(60, 80),
+            read(&cache, mixxx::IndexRange::between(60, 80)));
+}
+
+TEST_F(DecodedFrameCacheTest, seekTargets) {
+    mixxx::DecodedFrameCache cache(kSignalInfo, 10, 50, 2);
+    cache.beginSeekTarget(1000);
+    record(&cache, mixxx::IndexRange::between(1000, 1030));
+    record(&cache, mixxx::IndexRange::between(1030, 1100));
+    cache.beginSeekTarget(2000);
+    record(&cache, mixxx::IndexRange::between(2000, 2100));
+
+    // Only the beginning of each seek target is kept
+    EXPECT_EQ(mixxx::IndexRange::between(1050, 1060),
+            read(&cache, mixxx::IndexRange::between(1000, 1060)));
+    EXPECT_EQ(mixxx::IndexRange::between(2050, 2050),
+            read(&cache, mixxx::IndexRange::between(2000, 2050)));
+
+    // Continuing after a seek target is not a new seek target
+    cache.beginSeekTarget(1050);
+    record(&cache, mixxx::IndexRange::between(1050, 1100));
+    EXPECT_EQ(mixxx::IndexRange::between(1050, 1050),
+            read(&cache, mixxx::IndexRange::between(1000, 1050)));
+
+    // The least recently used seek target is replaced
+    cache.beginSeekTarget(3000);
+    record(&cache, mixxx::IndexRange::between(3000, 3050));
+    EXPECT_EQ(mixxx::IndexRange::between(2000, 2050),
+            read(&cache, mixxx::IndexRange::between(2000, 2050)));
+    EXPECT_EQ(mixxx::IndexRange::between(1050, 1050),
+            read(&cache, mixxx::IndexRange::between(1000, 1050)));
+    EXPECT_EQ(mixxx::IndexRange::between(3050, 3050),
+            read(&cache, mixxx::IndexRange::between(3000, 3050)));
+}
+
+} // namespace
@@ -0,0 +1,150 @@
+#include "soundio/driftcompensator.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <deque>
+#include <vector>
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr SINT kFramesPerBuffer = 256;
+constexpr double kSampleRate = 48000;
+
+class DriftCompensatorTest : public testing::Test {
+  protected:
+    static CSAMPLE sine(SINT frame) {
+        return static_cast<CSAMPLE>(std::sin(2 * M_PI * 440 * frame / kSampleRate));
+    }
+
+    /// Simulates the output path to a secondary device: the clock reference
+    /// writes buffers of a sine to the FIFO, the secondary device with a
+    /// clock that differs by drift reads and resamples them. Returns the
+    /// number of underflows after the controller has settled.
+    int simulateOutput(double drift, double seconds) {
+        const SINT targetFill = kFramesPerBuffer * 3 / 2;
+        DriftCompensator compensator(DriftCompensator::Direction::Output,
+                kChannels,
+                kFramesPerBuffer,
+                targetFill);
+        std::deque<CSAMPLE> fifo(targetFill * kChannels, CSAMPLE_ZERO);
+        // The resampler may require a few frames more than it outputs
+        std::vector<CSAMPLE> buffer(2 * kFramesPerBuffer * kChannels);
+        std::vector<CSAMPLE> output;
+
+        const double writePeriod = kFramesPerBuffer / kSampleRate;
+        const double readPeriod = writePeriod / (1.0 + drift);
+        double nextWrite = 0;
+        double lastWrite = 0;
+        // Start in the middle between two writes
+        double nextRead = writePeriod / 2;
+        SINT writtenFrames = 0;
+        int underflows = 0;
+        while (nextRead < seconds) {
+            if (nextWrite <= nextRead) {
+                for (SINT i = 0; i < kFramesPerBuffer; ++i) {
+                    for (int ch = 0; ch < kChannels; ++ch) {
+                        fifo.push_back(sine(writtenFrames));
+                    }
+                    ++writtenFrames;
+                }
+                lastWrite = nextWrite;
+                nextWrite += writePeriod;
+                continue;
+            }
+            const SINT fill = static_cast<SINT>(fifo.size()) / kChannels;
+            const double periodFraction = (nextRead - lastWrite) / writePeriod;
+            compensator.updateRatio(fill, kFramesPerBuffer, periodFraction);
+            m_lastFill = fill - kFramesPerBuffer * (1.0 - periodFraction);
+            const SINT required = compensator.inputFramesRequired(kFramesPerBuffer);
+            if (required > fill) {
+                if (nextRead > seconds / 2) {
+                    ++underflows;
+                }
+            }
+            const SINT frames = std::min(required, fill);
+            for (SINT i = 0; i < frames * kChannels; ++i) {
+                buffer[i] = fifo.front();
+                fifo.pop_front();
+            }
+            compensator.addInput(buffer.data(), frames);
+            const SINT outputFrames = compensator.process(buffer.data(), kFramesPerBuffer);
+            output.insert(output.end(), buffer.begin(), buffer.begin() + outputFrames * kChannels);
+            nextRead += readPeriod;
+        }
+        m_lastRatio = compensator.ratio();
+        m_output = std::move(output);
+        return underflows;
+    }
+
+    /// The fill level of the FIFO before the last read, as if the clock
+    /// reference wrote continuously
+    double m_lastFill = 0;
+    double m_lastRatio = 0;
+    std::vector<CSAMPLE> m_output;
+};
+
+TEST_F(DriftCompensatorTest, UnityRatioIsTransparent) {
+    DriftCompensator compensator(DriftCompensator::Direction::Output,
+            kChannels,
+            kFramesPerBuffer,
+            kFramesPerBuffer);
+    std::vector<CSAMPLE> input(kFramesPerBuffer * kChannels);
+    for (SINT i = 0; i < kFramesPerBuffer; ++i) {
+        input[i * kChannels] = sine(i);
+        input[i * kChannels + 1] = -sine(i);
+    }
+    // The input frames are needed up to two frames after the last position
+    EXPECT_EQ(kFramesPerBuffer + 2, compensator.inputFramesRequired(kFramesPerBuffer));
+    compensator.addInput(input.data(), kFramesPerBuffer);
+    std::vector<CSAMPLE> output(kFramesPerBuffer * kChannels);
+    const SINT frames = compensator.process(output.data(), kFramesPerBuffer);
+    ASSERT_EQ(kFramesPerBuffer - 2, frames);
+    for (SINT i = 0; i < frames * kChannels; ++i) {
+        EXPECT_FLOAT_EQ(input[i], output[i]);
+    }
+}
+
+TEST_F(DriftCompensatorTest, RatioIsLimited) {
+    DriftCompensator compensator(DriftCompensator::Direction::Output,
+            kChannels,
+            kFramesPerBuffer,
+            kFramesPerBuffer);
+    for (int i = 0; i < 100000; ++i) {
+        compensator.updateRatio(3 * kFramesPerBuffer, kFramesPerBuffer, 1.0);
+    }
+    EXPECT_DOUBLE_EQ(1.0 + DriftCompensator::kMaxDeviation, compensator.ratio());
+    for (int i = 0; i < 100000; ++i) {
+        compensator.updateRatio(0, kFramesPerBuffer, 1.0);
+    }
+    EXPECT_DOUBLE_EQ(1.0 - DriftCompensator::kMaxDeviation, compensator.ratio());
+}
+
+TEST_F(DriftCompensatorTest, FollowsFastSecondaryClock) {
+    const double drift = 200e-6;
+    EXPECT_EQ(0, simulateOutput(drift, 120));
+    // The faster device consumes fewer frames per output frame
+    EXPECT_NEAR(1.0 / (1.0 + drift), m_lastRatio, 20e-6);
+    EXPECT_NEAR(kFramesPerBuffer * 3 / 2, m_lastFill, kFramesPerBuffer / 8);
+}
+
+TEST_F(DriftCompensatorTest, FollowsSlowSecondaryClock) {
+    const double drift = -200e-6;
+    EXPECT_EQ(0, simulateOutput(drift, 120));
+    EXPECT_NEAR(1.0 / (1.0 + drift), m_lastRatio, 20e-6);
+    EXPECT_NEAR(kFramesPerBuffer * 3 / 2, m_lastFill, kFramesPerBuffer / 8);
+}
+
+TEST_F(DriftCompensatorTest, OutputIsContinuous) {
+    simulateOutput(100e-6, 20);
+    // Without frame slips the difference between adjacent samples of the
+    // sine never exceeds the slope of the sine.
+    const double maxStep = 2 * M_PI * 440 / kSampleRate * 1.01;
+    for (size_t i = kFramesPerBuffer * kChannels; i + kChannels < m_output.size();
+            i += kChannels) {
+        ASSERT_LE(std::abs(m_output[i + kChannels] - m_output[i]), maxStep) << i;
+    }
+}
+
+} // namespace
@@ -0,0 +1,151 @@
+#include "effects/effectsmessenger.h"
+
+#include <gtest/gtest.h>
+
+#include "effects/backends/effectprocessor.h"
+#include "engine/effects/engineeffectsmanager.h"
+
+namespace {
+
+constexpr int kFifoSize = 64;
+
+class CountingEffectState : public EffectState {
+  public:
+    explicit CountingEffectState(int* pDeleted)
+            : EffectState(mixxx::EngineParameters(
+                      mixxx::audio::SampleRate(44100), 1024)),
+              m_pDeleted(pDeleted) {
+    }
+    ~CountingEffectState() override {
+        ++(*m_pDeleted);
+    }
+
+  private:
+    int* m_pDeleted;
+};
+
+class EffectsMessengerTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        auto [pRequestPipe, pResponsePipe] = TwoWayMessagePipe<EffectsRequest*,
+                EffectsResponse>::makeTwoWayMessagePipe(kFifoSize, kFifoSize);
+        m_pMessenger = std::make_unique<EffectsMessenger>(std::move(pRequestPipe));
+        m_pResponsePipe = std::move(pResponsePipe);
+    }
+
+    // Answers all requests like EngineEffectsManager does
+    int respond() {
+        int numRequests = 0;
+        EffectsRequest* pRequest = nullptr;
+        while (m_pResponsePipe->readMessage(&pRequest)) {
+            m_pResponsePipe->writeMessage(EffectsResponse(*pRequest, true));
+            ++numRequests;
+        }
+        return numRequests;
+    }
+
+    EffectsRequest* newDisableRequest() {
+        EffectsRequest* pRequest = m_pMessenger->newRequest();
+        pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        pRequest->SetEffectParameters.enabled = false;
+        return pRequest;
+    }
+
+    std::unique_ptr<EffectsMessenger> m_pMessenger;
+    std::unique_ptr<EffectsResponsePipe> m_pResponsePipe;
+};
+
+TEST_F(EffectsMessengerTest, RequestsAreRecycled) {
+    EffectsRequest* pRequest = newDisableRequest();
+    EXPECT_TRUE(m_pMessenger->writeRequest(pRequest));
+    EXPECT_EQ(1, respond());
+    m_pMessenger->processEffectsResponses();
+
+    EffectsRequest* pRecycled = m_pMessenger->newRequest();
+    EXPECT_EQ(pRequest, pRecycled);
+    EXPECT_EQ(EffectsRequest::NUM_REQUEST_TYPES, pRecycled->type);
+    EXPECT_EQ(1, pRecycled->batchSize);
+    EXPECT_TRUE(m_pMessenger->writeRequest(pRecycled));
+}
+
+TEST_F(EffectsMessengerTest, BatchIsSentAtOnce) {
+    {
+        const EffectsMessenger::ScopedBatch batch(m_pMessenger.get());
+        m_pMessenger->writeRequest(newDisableRequest());
+        {
+            const EffectsMessenger::ScopedBatch nestedBatch(m_pMessenger.get());
+            m_pMessenger->writeRequest(newDisableRequest());
+        }
+        m_pMessenger->writeRequest(newDisableRequest());
+        EXPECT_EQ(0, m_pResponsePipe->messageCount());
+    }
+    ASSERT_EQ(3, m_pResponsePipe->messageCount());
+
+    EffectsRequest* pRequest = nullptr;
+    ASSERT_TRUE(m_pResponsePipe->readMessage(&pRequest));
+    EXPECT_EQ(3, pRequest->batchSize);
+    ASSERT_TRUE(m_pResponsePipe->readMessage(&pRequest));
+    EXPECT_EQ(1, pRequest->batchSize);
+}
+
+TEST_F(EffectsMessengerTest, StatesOfDisabledInputChannelAreDeleted) {
+    ChannelHandleFactory channelHandleFactory;
+    const ChannelHandle inputChannel = channelHandleFactory.getOrCreateHandle("[Channel1]");
+    const ChannelHandle outputChannel = channelHandleFactory.getOrCreateHandle("[Master]");
+    // Only compared, never dereferenced
+    auto* pChain = reinterpret_cast<EngineEffectChain*>(0x1);
+
+    EffectsRequest* pDisable = m_pMessenger->newRequest();
+    pDisable->type = EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+    pDisable->pTargetChain = pChain;
+    pDisable->DisableInputChannelForChain.channelHandle = inputChannel;
+    ASSERT_TRUE(m_pMessenger->writeRequest(pDisable));
+    EXPECT_EQ(1, respond());
+
+    // The response to the disable request is followed by a request which
+    // returns the EffectStates of the input channel
+    m_pMessenger->processEffectsResponses();
+    ASSERT_EQ(1, m_pResponsePipe->messageCount());
+    EffectsRequest* pDelete = nullptr;
+    ASSERT_TRUE(m_pResponsePipe->readMessage(&pDelete));
+    EXPECT_EQ(EffectsRequest::DELETE_EFFECT_STATES_FOR_INPUT_CHANNEL, pDelete->type);
+    EXPECT_EQ(pChain, pDelete->pTargetChain);
+    EXPECT_EQ(inputChannel, pDelete->DeleteEffectStatesForInputChannel.channelHandle);
+    ASSERT_NE(nullptr, pDelete->DeleteEffectStatesForInputChannel.pEffectStatesMapArray);
+
+    // Returned by the engine like EngineEffectChain does
+    int deleted = 0;
+    auto& effectStatesMapArray = *pDelete->DeleteEffectStatesForInputChannel.pEffectStatesMapArray;
+    effectStatesMapArray[0].insert(outputChannel, new CountingEffectState(&deleted));
+    effectStatesMapArray[2].insert(outputChannel, new CountingEffectState(&deleted));
+    m_pResponsePipe->writeMessage(EffectsResponse(*pDelete, true));
+
+    m_pMessenger->processEffectsResponses();
+    EXPECT_EQ(2, deleted);
+    // Deleting the states does not trigger further requests
+    EXPECT_EQ(0, m_pResponsePipe->messageCount());
+}
+
+TEST_F(EffectsMessengerTest, EngineWaitsForCompleteBatch) {
+    auto [pRequestPipe, pResponsePipe] = TwoWayMessagePipe<EffectsRequest*,
+            EffectsResponse>::makeTwoWayMessagePipe(kFifoSize, kFifoSize);
+    EngineEffectsManager engineEffectsManager(std::move(pResponsePipe));
+
+    // Requests of an unknown type are answered without touching any chain
+    EffectsRequest requests[3];
+    for (int i = 0; i < 3; ++i) {
+        requests[i].request_id = i;
+    }
+    requests[0].batchSize = 3;
+
+    ASSERT_TRUE(pRequestPipe->writeMessage(&requests[0]));
+    ASSERT_TRUE(pRequestPipe->writeMessage(&requests[1]));
+    engineEffectsManager.onCallbackStart();
+    EXPECT_EQ(0, pRequestPipe->messageCount());
+
+    ASSERT_TRUE(pRequestPipe->writeMessage(&requests[2]));
+    engineEffectsManager.onCallbackStart();
+    EXPECT_EQ(3, pRequestPipe->messageCount());
+}
+
+} // namespace
@@ -1,3 +1,4 @@
+#include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -9,6 +10,7 @@
 #include "test/mixxxtest.h"
 #include "util/math.h"
 #include "util/sample.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 using ::testing::StrictMock;
@@ -305,4 +307,35 @@ TEST_F(EngineBufferScaleLinearTest, TestRepeatedScaleCalls) {
     SampleUtil::free(pOutput);
 }
 
+static void BM_ScaleBufferRampingRate(benchmark::State& state) {
+    const auto channelCount = mixxx::audio::ChannelCount::fromInt(
+            static_cast<int>(state.range(0)));
+    const SINT bufferSize = channelCount * 1024;
+
+    ::testing::NiceMock<ReadAheadManagerMock> readAheadManager;
+    mixxx::SampleBuffer readBuffer(bufferSize);
+    readBuffer.fill(0.5f);
+    readAheadManager.setReadBuffer(readBuffer.data(), bufferSize);
+    ON_CALL(readAheadManager, getNextSamples(_, _, _, _))
+            .WillByDefault(Invoke(&readAheadManager,
+                    &ReadAheadManagerMock::getNextSamplesFake));
+
+    EngineBufferScaleLinear scaler(&readAheadManager);
+    scaler.setSignal(mixxx::audio::SampleRate(44100), channelCount);
+    mixxx::SampleBuffer output(bufferSize);
+
+    double rate = 0.5;
+    for (auto _ : state) {
+        // The rate changes with every buffer while scratching
+        rate = rate < 1.5 ? rate + 0.1 : 0.5;
+        double tempoRatio = rate;
+        double pitchRatio = rate;
+        scaler.setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+        benchmark::DoNotOptimize(scaler.scaleBuffer(output.data(), bufferSize));
+    }
+}
+BENCHMARK(BM_ScaleBufferRampingRate)
+        ->Arg(mixxx::audio::ChannelCount::stereo())
+        ->Arg(mixxx::audio::ChannelCount::stem());
+
 }  // namespace
@@ -178,6 +178,30 @@ TEST_F(EngineBufferTest, ScalerNoTransport) {
     EXPECT_EQ(m_pMockScaleVinyl1, m_pChannel1->getEngineBuffer()->m_pScale);
 }
 
+TEST_F(EngineBufferTest, IdleDeckWakesUp) {
+    EngineBuffer* pEngineBuffer = m_pChannel1->getEngineBuffer();
+
+    // A paused deck comes to rest and is not processed anymore
+    ProcessBuffer();
+    ProcessBuffer();
+    ProcessBuffer();
+    EXPECT_TRUE(pEngineBuffer->m_bAtRest);
+
+    // Seeking wakes the deck
+    pEngineBuffer->queueNewPlaypos(mixxx::audio::FramePos(500), EngineBuffer::SEEK_EXACT);
+    ProcessBuffer();
+    EXPECT_EQ(mixxx::audio::FramePos(500), pEngineBuffer->getExactPlayPos());
+    EXPECT_FALSE(pEngineBuffer->m_bAtRest);
+    ProcessBuffer();
+    EXPECT_TRUE(pEngineBuffer->m_bAtRest);
+
+    // Playing wakes the deck
+    ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+    ProcessBuffer();
+    EXPECT_FALSE(pEngineBuffer->m_bAtRest);
+    EXPECT_EQ(m_pMockScaleVinyl1->getProcessedTempo(), 1.0);
+}
+
 TEST_F(EngineBufferTest, VinylScalerRampZero) {
     // scratch in play mode
     ControlObject::set(ConfigKey(m_sGroup1, "scratch2_enable"), 1.0);
@@ -0,0 +1,96 @@
+#include "engine/effects/engineeffectsmanager.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/groupfeaturestate.h"
+
+namespace {
+
+constexpr int kFifoSize = 64;
+constexpr unsigned int kNumSamples = 256;
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+class EngineEffectsManagerTest : public testing::Test {
+  protected:
+    EngineEffectsManagerTest()
+            : m_inputChannel(m_factory.getOrCreateHandle(QStringLiteral("[Channel1]")),
+                      QStringLiteral("[Channel1]")),
+              m_outputChannel(m_factory.getOrCreateHandle(QStringLiteral("[Main]")),
+                      QStringLiteral("[Main]")) {
+    }
+
+    void SetUp() override {
+        auto [pRequestPipe, pResponsePipe] = TwoWayMessagePipe<EffectsRequest*,
+                EffectsResponse>::makeTwoWayMessagePipe(kFifoSize, kFifoSize);
+        m_pRequestPipe = std::move(pRequestPipe);
+        m_pEngineEffectsManager = std::make_unique<EngineEffectsManager>(
+                std::move(pResponsePipe));
+        m_pChain = std::make_unique<EngineEffectChain>(QStringLiteral("[EffectRack1_EffectUnit1]"),
+                QSet<ChannelHandleAndGroup>{m_inputChannel},
+                QSet<ChannelHandleAndGroup>{m_outputChannel});
+    }
+
+    void TearDown() override {
+        // Drain the responses
+        EffectsResponse response;
+        while (m_pRequestPipe->readMessage(&response)) {
+        }
+    }
+
+    void sendRequest(EffectsRequest* pRequest) {
+        ASSERT_TRUE(m_pRequestPipe->writeMessage(pRequest));
+        m_pEngineEffectsManager->onCallbackStart();
+    }
+
+    ChannelHandleFactory m_factory;
+    ChannelHandleAndGroup m_inputChannel;
+    ChannelHandleAndGroup m_outputChannel;
+    std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
+    std::unique_ptr<EngineEffectsManager> m_pEngineEffectsManager;
+    std::unique_ptr<EngineEffectChain> m_pChain;
+};
+
+TEST_F(EngineEffectsManagerTest, IdleChainIsSkipped) {
+    EffectsRequest addChain;
+    addChain.type = EffectsRequest::ADD_EFFECT_CHAIN;
+    addChain.AddEffectChain.pChain = m_pChain.get();
+    addChain.AddEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+    sendRequest(&addChain);
+
+    EffectsRequest enableChain;
+    enableChain.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+    enableChain.pTargetChain = m_pChain.get();
+    enableChain.EnableInputChannelForChain.channelHandle = m_inputChannel.handle();
+    sendRequest(&enableChain);
+
+    // A chain without effects leaves nothing to process
+    EXPECT_TRUE(m_pChain->isIdle());
+    EXPECT_TRUE(m_pEngineEffectsManager->bypassPostFader(
+            m_inputChannel.handle(), m_outputChannel.handle()));
+
+    std::vector<CSAMPLE> input(kNumSamples, 0.5f);
+    std::vector<CSAMPLE> output(kNumSamples, 0.25f);
+    m_pEngineEffectsManager->processPostFaderAndMix(m_inputChannel.handle(),
+            m_outputChannel.handle(),
+            input.data(),
+            output.data(),
+            kNumSamples,
+            kSampleRate,
+            GroupFeatureState(),
+            0.5f,
+            0.5f);
+    for (unsigned int i = 0; i < kNumSamples; ++i) {
+        ASSERT_FLOAT_EQ(0.5f, output[i]) << "sample " << i;
+    }
+
+    EffectsRequest removeChain;
+    removeChain.type = EffectsRequest::REMOVE_EFFECT_CHAIN;
+    removeChain.RemoveEffectChain.pChain = m_pChain.get();
+    removeChain.RemoveEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+    sendRequest(&removeChain);
+}
+
+} // namespace
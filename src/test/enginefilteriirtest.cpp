@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefilterbutterworth4.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "util/types.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr int kBufferSize = 1024;
+
+// Different signals on both channels reveal mixed up lanes
+std::vector<CSAMPLE> stereoTestSignal(int numSamples) {
+    std::vector<CSAMPLE> signal(numSamples);
+    for (int i = 0; i < numSamples; i += 2) {
+        signal[i] = static_cast<CSAMPLE>(0.5 * std::sin(i * 0.01));
+        signal[i + 1] = static_cast<CSAMPLE>(((i / 2) % 64 < 32) ? 0.25 : -0.25);
+    }
+    return signal;
+}
+
+class EngineFilterIIRTest : public testing::Test {
+  protected:
+    // Runs the same filter on one channel of the signal with fidlib
+    static std::vector<double> fidlibReference(const char* spec,
+            double freq,
+            const std::vector<CSAMPLE>& signal,
+            int channel) {
+        char spec_d[FIDSPEC_LENGTH];
+        std::strncpy(spec_d, spec, sizeof(spec_d));
+        FidFilter* pFilter = fid_design(spec_d, kSampleRate, freq, 0, 0, nullptr);
+        double (*pRunFunction)(void*, double);
+        void* pRun = fid_run_new(pFilter, &pRunFunction);
+        void* pRunBuffer = fid_run_newbuf(pRun);
+
+        std::vector<double> result;
+        for (std::size_t i = channel; i < signal.size(); i += 2) {
+            result.push_back(pRunFunction(pRunBuffer, signal[i]));
+        }
+
+        fid_run_freebuf(pRunBuffer);
+        fid_run_free(pRun);
+        free(pFilter);
+        return result;
+    }
+};
+
+TEST_F(EngineFilterIIRTest, ButterworthLowPassMatchesFidlib) {
+    constexpr double kFreq = 1000;
+    const std::vector<CSAMPLE> input = stereoTestSignal(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+
+    EngineFilterButterworth4Low filter(kSampleRate, kFreq);
+    filter.assumeSettled();
+    filter.process(input.data(), output.data(), kBufferSize);
+
+    for (int channel = 0; channel < 2; ++channel) {
+        const std::vector<double> expected =
+                fidlibReference("LpBu4", kFreq, input, channel);
+        for (std::size_t frame = 0; frame < expected.size(); ++frame) {
+            ASSERT_NEAR(expected[frame], output[frame * 2 + channel], 1e-4)
+                    << "channel " << channel << " frame " << frame;
+        }
+    }
+}
+
+TEST_F(EngineFilterIIRTest, InPlaceProcessing) {
+    const std::vector<CSAMPLE> input = stereoTestSignal(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+    std::vector<CSAMPLE> inPlace = input;
+
+    EngineFilterButterworth4High filter1(kSampleRate, 500);
+    filter1.assumeSettled();
+    filter1.process(input.data(), output.data(), kBufferSize);
+
+    EngineFilterButterworth4High filter2(kSampleRate, 500);
+    filter2.assumeSettled();
+    filter2.process(inPlace.data(), inPlace.data(), kBufferSize);
+
+    for (int i = 0; i < kBufferSize; ++i) {
+        ASSERT_EQ(output[i], inPlace[i]) << "sample " << i;
+    }
+}
+
+TEST_F(EngineFilterIIRTest, RampingIsFinite) {
+    const std::vector<CSAMPLE> input = stereoTestSignal(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+
+    EngineFilterButterworth4Band filter(kSampleRate, 200, 2000);
+    filter.process(input.data(), output.data(), kBufferSize);
+    filter.setFrequencyCorners(kSampleRate, 400, 4000);
+    filter.process(input.data(), output.data(), kBufferSize);
+
+    for (int i = 0; i < kBufferSize; ++i) {
+        ASSERT_TRUE(std::isfinite(output[i])) << "sample " << i;
+    }
+}
+
+template<typename Filter>
+static void runFilterBenchmark(benchmark::State& state, Filter* pFilter) {
+    const SINT bufferSize = static_cast<SINT>(state.range(0));
+    const std::vector<CSAMPLE> input = stereoTestSignal(bufferSize);
+    std::vector<CSAMPLE> output(bufferSize);
+    pFilter->assumeSettled();
+
+    for (auto _ : state) {
+        pFilter->process(input.data(), output.data(), bufferSize);
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+static void BM_Butterworth4Low(benchmark::State& state) {
+    EngineFilterButterworth4Low filter(kSampleRate, 1000);
+    runFilterBenchmark(state, &filter);
+}
+BENCHMARK(BM_Butterworth4Low)->Range(64, 4 << 10);
+
+static void BM_Butterworth4Band(benchmark::State& state) {
+    EngineFilterButterworth4Band filter(kSampleRate, 200, 2000);
+    runFilterBenchmark(state, &filter);
+}
+BENCHMARK(BM_Butterworth4Band)->Range(64, 4 << 10);
+
+static void BM_LinkwitzRiley8Low(benchmark::State& state) {
+    EngineFilterLinkwitzRiley8Low filter(kSampleRate, 1000);
+    runFilterBenchmark(state, &filter);
+}
+BENCHMARK(BM_LinkwitzRiley8Low)->Range(64, 4 << 10);
+
+static void BM_BiquadPeaking(benchmark::State& state) {
+    EngineFilterBiquad1Peaking filter(kSampleRate, 1000, 1.75);
+    filter.setFrequencyCorners(kSampleRate, 1000, 1.75, 6);
+    runFilterBenchmark(state, &filter);
+}
+BENCHMARK(BM_BiquadPeaking)->Range(64, 4 << 10);
+
+} // namespace
@@ -0,0 +1,334 @@
+#include "test/enginemixerbenchmark.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/builtin/builtinbackend.h"
+#include "effects/effectchain.h"
+#include "effects/effectslot.h"
+#include "sources/soundsourceproxy.h"
+#include "test/signalpathtest.h"
+#include "track/beats.h"
+#include "util/performancetimer.h"
+
+// Runs complete EngineMixer::process() callbacks with playing decks, like
+// the sound device would, and reports the percentiles of the callback times
+// together with the time the callback must not exceed. Run them with
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_EngineMixer
+//
+// or build the mixxx-engine-benchmark target.
+
+namespace {
+
+constexpr double kSampleRate = 44100.0;
+
+// All decks play slightly faster than the track, so the keylock engines
+// have to time stretch.
+constexpr double kRate = 1.02;
+
+// The tempo of the first deck. The others are a bit faster, so sync has
+// to adjust them.
+constexpr double kBaseBpm = 120.0;
+
+// Callbacks before the measurement, so the CachingReader can fill the
+// chunks around the play positions.
+constexpr int kWarmupCallbacks = 100;
+
+constexpr int kKeylockOff = -1;
+
+/// Creates the engine with the given number of decks. The decks of
+/// BaseSignalPathTest are reused and more decks are added if needed.
+class EngineMixerBenchmarkScope : public BaseSignalPathTest {
+  public:
+    explicit EngineMixerBenchmarkScope(int deckCount) {
+        BaseSignalPathTest::SetUp();
+        m_decks = {m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3};
+        for (int i = static_cast<int>(m_decks.size()) + 1; i <= deckCount; ++i) {
+            auto pDeck = std::make_unique<Deck>(nullptr,
+                    m_pConfig,
+                    m_pEngineMixer,
+                    m_pEffectsManager,
+                    EngineChannel::CENTER,
+                    m_pEngineMixer->registerChannelGroup(
+                            QStringLiteral("[Channel%1]").arg(i)));
+            addDeck(pDeck->getEngineDeck());
+            m_decks.push_back(pDeck.get());
+            m_addedDecks.push_back(std::move(pDeck));
+        }
+        // Only the first deckCount decks play
+        m_decks.resize(std::min(static_cast<int>(m_decks.size()), deckCount));
+    }
+
+    ~EngineMixerBenchmarkScope() override {
+        // The added decks must be deleted before the engine
+        m_addedDecks.clear();
+        BaseSignalPathTest::TearDown();
+    }
+
+    void TestBody() override {
+    }
+
+    /// Sets the keylock engine of all decks, or disables keylock if
+    /// keylockEngine is kKeylockOff.
+    void setKeylock(int keylockEngine) {
+        if (keylockEngine != kKeylockOff) {
+            ControlObject::set(ConfigKey(QStringLiteral("[App]"),
+                                       QStringLiteral("keylock_engine")),
+                    static_cast<double>(keylockEngine));
+        }
+        for (Deck* pDeck : m_decks) {
+            ControlObject::set(ConfigKey(pDeck->getGroup(), QStringLiteral("keylock")),
+                    keylockEngine != kKeylockOff ? 1.0 : 0.0);
+        }
+    }
+
+    /// Loads the file into all decks and starts them. Returns false if a
+    /// deck failed to load the file.
+    bool loadAndPlay(const QString& filePath, bool sync) {
+        for (std::size_t i = 0; i < m_decks.size(); ++i) {
+            Deck* pDeck = m_decks[i];
+            TrackPointer pTrack = Track::newTemporary(filePath);
+            loadTrack(pDeck, pTrack);
+            if (!pDeck->getEngineDeck()->getEngineBuffer()->isTrackLoaded()) {
+                return false;
+            }
+            pTrack->trySetBeats(mixxx::Beats::fromConstTempo(
+                    pTrack->getSampleRate(),
+                    mixxx::audio::kStartFramePos,
+                    mixxx::Bpm(kBaseBpm + i)));
+            const QString& group = pDeck->getGroup();
+            ControlObject::set(ConfigKey(group, QStringLiteral("repeat")), 1.0);
+            ControlObject::set(ConfigKey(group, QStringLiteral("rate")),
+                    getRateSliderValue(kRate));
+            if (sync) {
+                ControlObject::set(ConfigKey(group, QStringLiteral("sync_enabled")), 1.0);
+            }
+            ControlObject::set(ConfigKey(group, QStringLiteral("play")), 1.0);
+        }
+        return true;
+    }
+
+    /// Creates the standard effect units and routes all decks through
+    /// all of them with the chains fully wet.
+    void setupEffectUnits() {
+        m_pEffectsManager->setup();
+        for (int unit = 0; unit < kNumStandardEffectUnits; ++unit) {
+            const EffectChainPointer pChain = m_pEffectsManager->getStandardEffectChain(unit);
+            ControlObject::set(ConfigKey(pChain->group(), QStringLiteral("mix")), 1.0);
+            for (Deck* pDeck : m_decks) {
+                ControlObject::set(ConfigKey(pChain->group(),
+                                           QStringLiteral("group_%1_enable")
+                                                   .arg(pDeck->getGroup())),
+                        1.0);
+            }
+            // Unload the default effects of the units
+            for (const auto& pSlot : pChain->getEffectSlots()) {
+                pSlot->loadEffectFromPreset(EffectPresetPointer());
+            }
+        }
+    }
+
+    /// Loads the effect into the next free slot of the standard effect
+    /// units and enables it. Returns false if all slots are used.
+    bool loadEffect(const EffectManifestPointer& pManifest) {
+        const int unit = m_loadedEffectCount / kNumEffectsPerUnit;
+        if (unit >= kNumStandardEffectUnits) {
+            return false;
+        }
+        const EffectSlotPointer pSlot =
+                m_pEffectsManager->getStandardEffectChain(unit)->getEffectSlot(
+                        m_loadedEffectCount % kNumEffectsPerUnit);
+        pSlot->loadEffectWithDefaults(pManifest);
+        pSlot->setEnabled(true);
+        ++m_loadedEffectCount;
+        return true;
+    }
+
+    EffectManifestPointer manifest(const QString& effectId,
+            EffectBackendType backendType) const {
+        return m_pEffectsManager->getBackendManager()->getManifest(
+                effectId, backendType);
+    }
+
+    QList<EffectManifestPointer> builtInManifests() const {
+        return m_pEffectsManager->getBackendManager()->getManifestsForBackend(
+                EffectBackendType::BuiltIn);
+    }
+
+    /// Runs the callbacks of the benchmark and reports the percentiles of
+    /// the callback times in ns and their ratio to the buffer duration.
+    void run(benchmark::State& state) {
+        for (int i = 0; i < kWarmupCallbacks; ++i) {
+            m_pEngineMixer->process(kProcessBufferSize);
+            QTest::qSleep(1);
+        }
+
+        std::vector<double> callbackNanos;
+        PerformanceTimer timer;
+        for (auto _ : state) {
+            timer.start();
+            m_pEngineMixer->process(kProcessBufferSize);
+            callbackNanos.push_back(static_cast<double>(timer.elapsed().toIntegerNanos()));
+        }
+
+        // The buffer holds interleaved stereo samples
+        const double deadlineNanos = kProcessBufferSize / 2 / kSampleRate * 1e9;
+        const double p50 = percentile(&callbackNanos, 0.5);
+        const double p99 = percentile(&callbackNanos, 0.99);
+        state.counters["p50_ns"] = p50;
+        state.counters["p99_ns"] = p99;
+        state.counters["max_ns"] = percentile(&callbackNanos, 1.0);
+        state.counters["deadline_ns"] = deadlineNanos;
+        state.counters["p99_load"] = p99 / deadlineNanos;
+    }
+
+  private:
+    static double percentile(std::vector<double>* pValues, double percentile) {
+        if (pValues->empty()) {
+            return 0.0;
+        }
+        const auto index = static_cast<std::size_t>(
+                percentile * static_cast<double>(pValues->size() - 1));
+        std::nth_element(pValues->begin(), pValues->begin() + index, pValues->end());
+        return (*pValues)[index];
+    }
+
+    std::vector<Deck*> m_decks;
+    std::vector<std::unique_ptr<Deck>> m_addedDecks;
+    int m_loadedEffectCount = 0;
+};
+
+QString sineTrackPath() {
+    return MixxxTest::getOrInitTestDir().filePath(QStringLiteral("sine-30.wav"));
+}
+
+/// The first argument is the number of decks, the second one the keylock
+/// engine or -1 if keylock is off, the third one whether sync is enabled.
+void BM_EngineMixer(benchmark::State& state) {
+    EngineMixerBenchmarkScope scope(static_cast<int>(state.range(0)));
+    scope.setKeylock(static_cast<int>(state.range(1)));
+    if (!scope.loadAndPlay(sineTrackPath(), state.range(2) != 0)) {
+        state.SkipWithError("Failed to load the track");
+        return;
+    }
+    scope.run(state);
+}
+
+void engineMixerArguments(benchmark::internal::Benchmark* pBenchmark) {
+    for (const int deckCount : {2, 4, 8}) {
+        pBenchmark->Args({deckCount, kKeylockOff, 0});
+        for (const auto keylockEngine : EngineBuffer::kKeylockEngines) {
+            pBenchmark->Args({deckCount, static_cast<int>(keylockEngine), 0});
+        }
+        pBenchmark->Args({deckCount, kKeylockOff, 1});
+    }
+    pBenchmark->ArgNames({"decks", "keylock", "sync"});
+    pBenchmark->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_EngineMixer)->Apply(engineMixerArguments);
+
+/// Plays a stem file, which is mixed from its stems in the engine, in the
+/// given number of decks.
+void BM_EngineMixerStems(benchmark::State& state) {
+    EngineMixerBenchmarkScope scope(static_cast<int>(state.range(0)));
+    if (!SoundSourceProxy::isFileTypeSupported(QStringLiteral("stem.mp4"))) {
+        state.SkipWithError("Stem files are not supported");
+        return;
+    }
+    if (!scope.loadAndPlay(MixxxTest::getOrInitTestDir().filePath(
+                                   QStringLiteral("stems/test.stem.mp4")),
+                false)) {
+        state.SkipWithError("Failed to load the stem file");
+        return;
+    }
+    scope.run(state);
+}
+
+BENCHMARK(BM_EngineMixerStems)
+        ->ArgName("decks")
+        ->Arg(2)
+        ->Arg(4)
+        ->Unit(benchmark::kMicrosecond);
+
+/// Fills all slots of the standard effect units with the builtin effects
+/// in their order and routes the given number of decks through all units.
+void BM_EngineMixerEffectUnits(benchmark::State& state) {
+    EngineMixerBenchmarkScope scope(static_cast<int>(state.range(0)));
+    scope.setupEffectUnits();
+    const QList<EffectManifestPointer> manifests = scope.builtInManifests();
+    for (const auto& pManifest : manifests) {
+        if (!scope.loadEffect(pManifest)) {
+            break;
+        }
+    }
+    if (!scope.loadAndPlay(sineTrackPath(), false)) {
+        state.SkipWithError("Failed to load the track");
+        return;
+    }
+    scope.run(state);
+}
+
+BENCHMARK(BM_EngineMixerEffectUnits)
+        ->ArgName("decks")
+        ->Arg(2)
+        ->Arg(4)
+        ->Arg(8)
+        ->Unit(benchmark::kMicrosecond);
+
+/// Plays four decks through a single effect
+void BM_EngineMixerEffect(benchmark::State& state,
+        const QString& effectId,
+        EffectBackendType backendType) {
+    EngineMixerBenchmarkScope scope(4);
+    scope.setupEffectUnits();
+    const EffectManifestPointer pManifest = scope.manifest(effectId, backendType);
+    if (!pManifest || !scope.loadEffect(pManifest)) {
+        state.SkipWithError("Failed to load the effect");
+        return;
+    }
+    if (!scope.loadAndPlay(sineTrackPath(), false)) {
+        state.SkipWithError("Failed to load the track");
+        return;
+    }
+    scope.run(state);
+}
+
+} // namespace
+
+void registerEngineMixerBenchmarks() {
+    const BuiltInBackend backend;
+    const QList<EffectManifestPointer> manifests = backend.getManifests();
+    for (const auto& pManifest : manifests) {
+        benchmark::RegisterBenchmark(
+                (QStringLiteral("BM_EngineMixerEffect/") + pManifest->id())
+                        .toStdString()
+                        .c_str(),
+                BM_EngineMixerEffect,
+                pManifest->id(),
+                EffectBackendType::BuiltIn)
+                ->Unit(benchmark::kMicrosecond);
+    }
+
+    // Scanning all installed LV2 plugins is slow and their results are not
+    // comparable between machines, so only the plugins with the URIs in
+    // MIXXX_BENCHMARK_LV2_PLUGINS, separated by spaces, are compared with
+    // the builtin effects.
+    const QStringList lv2PluginUris =
+            qEnvironmentVariable("MIXXX_BENCHMARK_LV2_PLUGINS")
+                    .split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    for (const auto& pluginUri : lv2PluginUris) {
+        benchmark::RegisterBenchmark(
+                (QStringLiteral("BM_EngineMixerEffect/") + pluginUri)
+                        .toStdString()
+                        .c_str(),
+                BM_EngineMixerEffect,
+                pluginUri,
+                EffectBackendType::LV2)
+                ->Unit(benchmark::kMicrosecond);
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+/// Registers the engine benchmarks of all builtin effects and of the LV2
+/// plugins listed in MIXXX_BENCHMARK_LV2_PLUGINS. The effects are only known
+/// at runtime, so the benchmarks need to be registered after the
+/// application has been initialized and before running the benchmarks.
+void registerEngineMixerBenchmarks();
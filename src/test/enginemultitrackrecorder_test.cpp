@@ -0,0 +1,101 @@
+#include "engine/sidechain/enginemultitrackrecorder.h"
+
+#include <gtest/gtest.h>
+#include <sndfile.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <vector>
+
+namespace {
+
+constexpr int kFrames = 64;
+
+class EngineMultitrackRecorderTest : public testing::Test {
+  protected:
+    EngineMultitrackRecorderTest()
+            : m_baseFileName(m_tempDir.filePath(QStringLiteral("recording"))) {
+        for (int i = 0; i < kFrames * 2; ++i) {
+            m_deck1[i] = 0.25f;
+            m_deck2[i] = (i % 2) ? -0.5f : 0.5f;
+        }
+    }
+
+    void recordBuffers(EngineMultitrackRecorder::Mode mode) {
+        EngineMultitrackRecorder recorder;
+        ASSERT_TRUE(recorder.startRecording(m_baseFileName,
+                mode,
+                false,
+                QStringList{QStringLiteral("[Channel1]"),
+                        QStringLiteral("[Channel2]"),
+                        QStringLiteral("[Microphone]")},
+                mixxx::audio::SampleRate(44100)));
+        EXPECT_TRUE(recorder.isRecording());
+        // The microphone is not active and recorded as silence
+        const CSAMPLE* buffers[] = {m_deck1, m_deck2, nullptr};
+        recorder.process(buffers, 3, kFrames);
+        recorder.process(buffers, 3, kFrames);
+        recorder.stopRecording();
+        EXPECT_FALSE(recorder.isRecording());
+    }
+
+    std::vector<float> readFile(const QString& fileName, int* pChannels) {
+        SF_INFO info{};
+        SNDFILE* pFile = sf_open(QFile::encodeName(fileName).constData(), SFM_READ, &info);
+        if (!pFile) {
+            return {};
+        }
+        std::vector<float> samples(info.frames * info.channels);
+        sf_readf_float(pFile, samples.data(), info.frames);
+        sf_close(pFile);
+        *pChannels = info.channels;
+        return samples;
+    }
+
+    QTemporaryDir m_tempDir;
+    const QString m_baseFileName;
+    CSAMPLE m_deck1[kFrames * 2];
+    CSAMPLE m_deck2[kFrames * 2];
+};
+
+TEST_F(EngineMultitrackRecorderTest, MultichannelFile) {
+    recordBuffers(EngineMultitrackRecorder::Mode::MultichannelFile);
+
+    int channels = 0;
+    const auto samples = readFile(m_baseFileName + QStringLiteral("_stems.wav"), &channels);
+    ASSERT_EQ(6, channels);
+    ASSERT_EQ(static_cast<size_t>(2 * kFrames * 6), samples.size());
+    for (int frame = 0; frame < 2 * kFrames; ++frame) {
+        EXPECT_FLOAT_EQ(0.25f, samples[frame * 6]);
+        EXPECT_FLOAT_EQ(0.25f, samples[frame * 6 + 1]);
+        EXPECT_FLOAT_EQ(0.5f, samples[frame * 6 + 2]);
+        EXPECT_FLOAT_EQ(-0.5f, samples[frame * 6 + 3]);
+        EXPECT_FLOAT_EQ(0.0f, samples[frame * 6 + 4]);
+        EXPECT_FLOAT_EQ(0.0f, samples[frame * 6 + 5]);
+    }
+}
+
+TEST_F(EngineMultitrackRecorderTest, FilePerChannel) {
+    recordBuffers(EngineMultitrackRecorder::Mode::FilePerChannel);
+
+    int channels = 0;
+    const auto deck2 = readFile(m_baseFileName + QStringLiteral("_Channel2.wav"), &channels);
+    ASSERT_EQ(2, channels);
+    ASSERT_EQ(static_cast<size_t>(2 * kFrames * 2), deck2.size());
+    EXPECT_FLOAT_EQ(0.5f, deck2[0]);
+    EXPECT_FLOAT_EQ(-0.5f, deck2[1]);
+
+    const auto microphone = readFile(
+            m_baseFileName + QStringLiteral("_Microphone.wav"), &channels);
+    ASSERT_EQ(static_cast<size_t>(2 * kFrames * 2), microphone.size());
+    EXPECT_FLOAT_EQ(0.0f, microphone[0]);
+}
+
+TEST_F(EngineMultitrackRecorderTest, IgnoresBuffersWhileNotRecording) {
+    EngineMultitrackRecorder recorder;
+    const CSAMPLE* buffers[] = {m_deck1};
+    recorder.process(buffers, 1, kFrames);
+    EXPECT_FALSE(recorder.isRecording());
+}
+
+} // namespace
@@ -0,0 +1,145 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "engine/enginesidechaincompressor.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr CSAMPLE kThreshold = 0.1f;
+constexpr CSAMPLE kStrength = 0.5f;
+constexpr unsigned int kAttackFrames = 256;
+constexpr unsigned int kDecayFrames = 1024;
+constexpr int kFrames = 1024;
+
+// A key signal that is silent until the given frame and loud afterwards
+std::vector<CSAMPLE> keySignal(int frames, int loudFromFrame) {
+    std::vector<CSAMPLE> key(frames * 2, 0.0f);
+    for (int i = loudFromFrame * 2; i < frames * 2; ++i) {
+        key[i] = 0.5f;
+    }
+    return key;
+}
+
+class EngineSideChainCompressorTest : public testing::Test {
+  protected:
+    EngineSideChainCompressorTest()
+            : m_compressor(QStringLiteral("[Test]")) {
+        m_compressor.setParameters(kThreshold, kStrength, kAttackFrames, kDecayFrames);
+    }
+
+    EngineSideChainCompressor m_compressor;
+};
+
+TEST_F(EngineSideChainCompressorTest, SilentKeyDoesNotDuck) {
+    const std::vector<CSAMPLE> key = keySignal(kFrames, kFrames);
+    std::vector<CSAMPLE_GAIN> gains(kFrames);
+    EXPECT_FALSE(m_compressor.calculateCompressedGains(gains.data(), key.data(), kFrames));
+}
+
+TEST_F(EngineSideChainCompressorTest, AttackFollowsKeyWithinBuffer) {
+    constexpr int kLoudFromFrame = 512;
+    const std::vector<CSAMPLE> key = keySignal(kFrames, kLoudFromFrame);
+    std::vector<CSAMPLE_GAIN> gains(kFrames);
+    EXPECT_TRUE(m_compressor.calculateCompressedGains(gains.data(), key.data(), kFrames));
+
+    for (int i = 0; i < kLoudFromFrame; ++i) {
+        ASSERT_FLOAT_EQ(1.0f, gains[i]) << "frame " << i;
+    }
+    for (int i = kLoudFromFrame + 1; i < kFrames; ++i) {
+        ASSERT_LE(gains[i], gains[i - 1]) << "frame " << i;
+        ASSERT_GE(gains[i], kStrength) << "frame " << i;
+    }
+    EXPECT_FLOAT_EQ(kStrength, gains[kLoudFromFrame + kAttackFrames]);
+    EXPECT_FLOAT_EQ(kStrength, gains[kFrames - 1]);
+}
+
+TEST_F(EngineSideChainCompressorTest, LookaheadStartsAttackEarlier) {
+    constexpr int kLoudFromFrame = 512;
+    constexpr unsigned int kLookaheadFrames = 64;
+    m_compressor.setLookahead(kLookaheadFrames);
+    const std::vector<CSAMPLE> key = keySignal(kFrames, kLoudFromFrame);
+    std::vector<CSAMPLE_GAIN> gains(kFrames);
+    EXPECT_TRUE(m_compressor.calculateCompressedGains(gains.data(), key.data(), kFrames));
+
+    EXPECT_FLOAT_EQ(1.0f, gains[kLoudFromFrame - kLookaheadFrames - 1]);
+    EXPECT_LT(gains[kLoudFromFrame - kLookaheadFrames], 1.0f);
+    EXPECT_LT(gains[kLoudFromFrame], 1.0f);
+}
+
+TEST_F(EngineSideChainCompressorTest, DecayWithoutKey) {
+    const std::vector<CSAMPLE> key = keySignal(kFrames, 0);
+    std::vector<CSAMPLE_GAIN> gains(kFrames);
+    m_compressor.calculateCompressedGains(gains.data(), key.data(), kFrames);
+    ASSERT_FLOAT_EQ(kStrength, gains[kFrames - 1]);
+
+    // Without a key the state of the end of the last buffer is kept
+    m_compressor.setAboveThreshold(false);
+    EXPECT_TRUE(m_compressor.calculateCompressedGains(gains.data(), nullptr, kFrames));
+    for (int i = 1; i < kFrames; ++i) {
+        ASSERT_GE(gains[i], gains[i - 1]) << "frame " << i;
+    }
+    EXPECT_FLOAT_EQ(1.0f, gains[kDecayFrames - 1]);
+}
+
+TEST_F(EngineSideChainCompressorTest, MatchesPerBufferGainAtBufferEnd) {
+    EngineSideChainCompressor perBuffer(QStringLiteral("[Test]"));
+    perBuffer.setParameters(kThreshold, kStrength, kAttackFrames, kDecayFrames);
+    perBuffer.setAboveThreshold(true);
+    m_compressor.setAboveThreshold(true);
+
+    constexpr int kBufferFrames = 64;
+    std::vector<CSAMPLE_GAIN> gains(kBufferFrames);
+    for (int buffer = 0; buffer < 8; ++buffer) {
+        m_compressor.calculateCompressedGains(gains.data(), nullptr, kBufferFrames);
+        EXPECT_NEAR(perBuffer.calculateCompressedGain(kBufferFrames),
+                gains[kBufferFrames - 1],
+                1e-5)
+                << "buffer " << buffer;
+    }
+}
+
+// Ducks the given number of stereo channels with the gains of the key
+// signal, like EngineMixer does for talkover ducking
+static void BM_SideChainCompressorDucking(benchmark::State& state) {
+    const int frames = static_cast<int>(state.range(0));
+    const int channels = static_cast<int>(state.range(1));
+    EngineSideChainCompressor compressor(QStringLiteral("[Test]"));
+    compressor.setParameters(kThreshold, kStrength, kAttackFrames, kDecayFrames);
+    compressor.setLookahead(kAttackFrames / 2);
+
+    // Alternate between loud and silent buffers, so the compressor
+    // attacks and decays all the time
+    const std::vector<CSAMPLE> loudKey = keySignal(frames, frames / 2);
+    const std::vector<CSAMPLE> silentKey = keySignal(frames, frames);
+    std::vector<CSAMPLE_GAIN> gains(frames);
+    std::vector<CSAMPLE*> buffers;
+    for (int i = 0; i < channels; ++i) {
+        buffers.push_back(SampleUtil::alloc(frames * 2));
+        SampleUtil::fill(buffers.back(), 0.5f, frames * 2);
+    }
+
+    bool loud = false;
+    for (auto _ : state) {
+        loud = !loud;
+        if (compressor.calculateCompressedGains(gains.data(),
+                    loud ? loudKey.data() : silentKey.data(),
+                    frames)) {
+            for (CSAMPLE* pBuffer : buffers) {
+                SampleUtil::applyStereoGainCurve(pBuffer, gains.data(), frames);
+            }
+        }
+        benchmark::DoNotOptimize(buffers.data());
+    }
+
+    for (CSAMPLE* pBuffer : buffers) {
+        SampleUtil::free(pBuffer);
+    }
+}
+BENCHMARK(BM_SideChainCompressorDucking)
+        ->ArgNames({"frames", "channels"})
+        ->ArgsProduct({{64, 512, 4096}, {2, 4, 8}});
+
+} // namespace
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "engine/engineworker.h"
+#include "engine/engineworkerscheduler.h"
+
+namespace {
+
+// The worker thread is never started, the test only checks whether the
+// scheduler has released the run semaphore.
+class TestEngineWorker : public EngineWorker {
+  public:
+    bool waitForWake(int timeoutMillis) {
+        return m_semaRun.tryAcquire(1, timeoutMillis);
+    }
+};
+
+class EngineWorkerSchedulerTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        m_pScheduler = std::make_unique<EngineWorkerScheduler>();
+        m_pScheduler->start();
+        // Span more than one word of the ready bit set
+        for (int i = 0; i < 100; ++i) {
+            m_workers.push_back(std::make_unique<TestEngineWorker>());
+            m_workers.back()->setScheduler(m_pScheduler.get());
+        }
+    }
+
+    void TearDown() override {
+        m_pScheduler.reset();
+        m_workers.clear();
+    }
+
+    std::unique_ptr<EngineWorkerScheduler> m_pScheduler;
+    std::vector<std::unique_ptr<TestEngineWorker>> m_workers;
+};
+
+TEST_F(EngineWorkerSchedulerTest, wakesOnlyReadyWorkers) {
+    const std::vector<int> readyWorkers = {0, 5, 63, 64, 99};
+    for (int i : readyWorkers) {
+        m_workers[i]->workReady();
+    }
+    // The audible worker is woken first
+    m_workers[64]->setSchedulingPriority(EngineWorker::SchedulingPriority::Audible);
+    m_pScheduler->runWorkers();
+
+    for (int i : readyWorkers) {
+        EXPECT_TRUE(m_workers[i]->waitForWake(5000)) << "worker " << i;
+    }
+    // All ready workers are woken in a single pass
+    for (int i = 0; i < static_cast<int>(m_workers.size()); ++i) {
+        EXPECT_FALSE(m_workers[i]->waitForWake(0)) << "worker " << i;
+    }
+}
+
+TEST_F(EngineWorkerSchedulerTest, wakesAgainAfterRunWorkers) {
+    for (int round = 0; round < 10; ++round) {
+        m_workers[42]->workReady();
+        m_pScheduler->runWorkers();
+        EXPECT_TRUE(m_workers[42]->waitForWake(5000)) << "round " << round;
+    }
+}
+
+TEST_F(EngineWorkerSchedulerTest, runWorkersWithoutReadyWorkers) {
+    m_pScheduler->runWorkers();
+    for (int i = 0; i < static_cast<int>(m_workers.size()); ++i) {
+        EXPECT_FALSE(m_workers[i]->waitForWake(10)) << "worker " << i;
+    }
+}
+
+} // namespace
@@ -0,0 +1,74 @@
+#include "library/externallibraryfingerprint.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class ExternalLibraryFingerprintTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_filePath = m_tempDir.filePath(QStringLiteral("collection.xml"));
+        writeFile(QByteArrayLiteral("<collection/>"));
+    }
+
+    void writeFile(const QByteArray& content) {
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        ASSERT_EQ(content.size(), file.write(content));
+    }
+
+    void setLastModified(const QDateTime& lastModified) {
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        ASSERT_TRUE(file.setFileTime(lastModified, QFileDevice::FileModificationTime));
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+};
+
+TEST_F(ExternalLibraryFingerprintTest, roundTrip) {
+    const auto fingerprint = ExternalLibraryFingerprint::ofFile(m_filePath);
+    ASSERT_TRUE(fingerprint.isValid());
+    EXPECT_EQ(fingerprint,
+            ExternalLibraryFingerprint::fromString(fingerprint.toString()));
+    EXPECT_FALSE(ExternalLibraryFingerprint::fromString(QString()).isValid());
+    EXPECT_FALSE(ExternalLibraryFingerprint::fromString(
+            QStringLiteral("garbage")).isValid());
+}
+
+TEST_F(ExternalLibraryFingerprintTest, missingFile) {
+    EXPECT_FALSE(ExternalLibraryFingerprint::ofFile(
+            m_tempDir.filePath(QStringLiteral("missing.xml")))
+                         .isValid());
+    EXPECT_FALSE(ExternalLibraryFingerprint().matchesFile(m_filePath));
+}
+
+TEST_F(ExternalLibraryFingerprintTest, detectChanges) {
+    const QDateTime lastModified = QDateTime::currentDateTimeUtc().addDays(-1);
+    setLastModified(lastModified);
+    const auto fingerprint = ExternalLibraryFingerprint::ofFile(m_filePath);
+    ASSERT_TRUE(fingerprint.isValid());
+    EXPECT_TRUE(fingerprint.matchesFile(m_filePath));
+
+    // Same content, but modified again
+    writeFile(QByteArrayLiteral("<collection/>"));
+    setLastModified(lastModified.addSecs(60));
+    EXPECT_TRUE(fingerprint.matchesFile(m_filePath));
+
+    // Same size, different content
+    writeFile(QByteArrayLiteral("<COLLECTION/>"));
+    setLastModified(lastModified.addSecs(120));
+    EXPECT_FALSE(fingerprint.matchesFile(m_filePath));
+
+    // Different size
+    writeFile(QByteArrayLiteral("<collection></collection>"));
+    EXPECT_FALSE(fingerprint.matchesFile(m_filePath));
+}
+
+} // namespace
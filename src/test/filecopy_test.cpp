@@ -0,0 +1,75 @@
+#include "util/filecopy.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace mixxx {
+
+class FileCopyTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+    }
+
+    QString writeFile(const QString& fileName, const QByteArray& content) {
+        const QString filePath = m_tempDir.filePath(fileName);
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        EXPECT_EQ(content.size(), file.write(content));
+        return filePath;
+    }
+
+    static QByteArray readFile(const QString& filePath) {
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::ReadOnly));
+        return file.readAll();
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(FileCopyTest, copyContent) {
+    // Larger than a single buffer
+    QByteArray content(5 * 1024 * 1024 + 17, '\0');
+    for (int i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>(i % 251);
+    }
+    const QString sourcePath = writeFile(QStringLiteral("source"), content);
+    const QString destPath = m_tempDir.filePath(QStringLiteral("dest"));
+
+    QString errorMessage;
+    EXPECT_TRUE(copyFile(sourcePath, destPath, &errorMessage));
+    EXPECT_TRUE(errorMessage.isEmpty());
+    EXPECT_EQ(content, readFile(destPath));
+}
+
+TEST_F(FileCopyTest, copyEmptyFile) {
+    const QString sourcePath = writeFile(QStringLiteral("source"), QByteArray());
+    const QString destPath = m_tempDir.filePath(QStringLiteral("dest"));
+
+    EXPECT_TRUE(copyFile(sourcePath, destPath));
+    EXPECT_TRUE(QFile::exists(destPath));
+    EXPECT_TRUE(readFile(destPath).isEmpty());
+}
+
+TEST_F(FileCopyTest, failIfDestinationExists) {
+    const QString sourcePath = writeFile(QStringLiteral("source"), "source");
+    const QString destPath = writeFile(QStringLiteral("dest"), "dest");
+
+    QString errorMessage;
+    EXPECT_FALSE(copyFile(sourcePath, destPath, &errorMessage));
+    EXPECT_FALSE(errorMessage.isEmpty());
+    EXPECT_EQ(QByteArray("dest"), readFile(destPath));
+}
+
+TEST_F(FileCopyTest, failIfSourceIsMissing) {
+    const QString sourcePath = m_tempDir.filePath(QStringLiteral("missing"));
+    const QString destPath = m_tempDir.filePath(QStringLiteral("dest"));
+
+    EXPECT_FALSE(copyFile(sourcePath, destPath));
+    EXPECT_FALSE(QFile::exists(destPath));
+}
+
+} // namespace mixxx
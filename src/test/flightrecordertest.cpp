@@ -0,0 +1,93 @@
+#include "util/flightrecorder.h"
+
+#include <gtest/gtest.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+constexpr std::uint64_t kRingSize = 16;
+
+TEST(FlightRecorderTest, RegisterNameTwice) {
+    FlightRecorder recorder(kRingSize);
+    const auto name = recorder.registerName(QStringLiteral("FlightRecorderTest"));
+    EXPECT_NE(FlightRecorder::kInvalidName, name);
+    EXPECT_EQ(name, recorder.registerName(QStringLiteral("FlightRecorderTest")));
+}
+
+TEST(FlightRecorderTest, KeepsMostRecentEvents) {
+    FlightRecorder recorder(kRingSize);
+    const auto name = recorder.registerName(QStringLiteral("FlightRecorderTest"));
+    for (int i = 0; i < 3 * static_cast<int>(kRingSize); ++i) {
+        recorder.recordSpan(name, i * 1000, i * 1000 + 500);
+    }
+    const auto events = recorder.snapshot(0);
+    ASSERT_EQ(kRingSize, events.size());
+    EXPECT_EQ((2 * static_cast<int>(kRingSize)) * 1000, events.front().startNs);
+    EXPECT_EQ((3 * static_cast<int>(kRingSize) - 1) * 1000, events.back().startNs);
+    EXPECT_EQ(500, events.back().durationNs);
+}
+
+TEST(FlightRecorderTest, SnapshotSince) {
+    FlightRecorder recorder(kRingSize);
+    const auto name = recorder.registerName(QStringLiteral("FlightRecorderTest"));
+    recorder.recordSpan(name, 1000, 2000);
+    recorder.recordSpan(name, 3000, 5000);
+    recorder.recordSpan(name, 6000, 7000);
+    // Spans that end within the window are included
+    const auto events = recorder.snapshot(4000);
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(3000, events[0].startNs);
+    EXPECT_EQ(6000, events[1].startNs);
+}
+
+TEST(FlightRecorderTest, InvalidNameIsIgnored) {
+    FlightRecorder recorder(kRingSize);
+    recorder.recordSpan(FlightRecorder::kInvalidName, 1000, 2000);
+    recorder.recordInstant(FlightRecorder::kInvalidName);
+    EXPECT_TRUE(recorder.snapshot(0).empty());
+}
+
+TEST(FlightRecorderTest, ChromeTrace) {
+    FlightRecorder recorder(kRingSize);
+    const auto span = recorder.registerName(QStringLiteral("Span"));
+    const auto instant = recorder.registerName(QStringLiteral("[Channel1],play"));
+    recorder.nameCurrentThread(QStringLiteral("FlightRecorderTest"));
+    recorder.recordSpan(span, 1000, 3000);
+    recorder.recordInstant(instant, 1.0);
+
+    const QJsonArray traceEvents =
+            QJsonDocument::fromJson(recorder.chromeTraceJson(recorder.snapshot(0)))
+                    .object()
+                    .value(QStringLiteral("traceEvents"))
+                    .toArray();
+    ASSERT_EQ(3, traceEvents.size());
+
+    const QJsonObject threadName = traceEvents[0].toObject();
+    EXPECT_EQ(QStringLiteral("M"), threadName.value(QStringLiteral("ph")).toString());
+    EXPECT_EQ(QStringLiteral("FlightRecorderTest"),
+            threadName.value(QStringLiteral("args"))
+                    .toObject()
+                    .value(QStringLiteral("name"))
+                    .toString());
+
+    const QJsonObject spanEvent = traceEvents[1].toObject();
+    EXPECT_EQ(QStringLiteral("Span"), spanEvent.value(QStringLiteral("name")).toString());
+    EXPECT_EQ(QStringLiteral("X"), spanEvent.value(QStringLiteral("ph")).toString());
+    EXPECT_DOUBLE_EQ(1.0, spanEvent.value(QStringLiteral("ts")).toDouble());
+    EXPECT_DOUBLE_EQ(2.0, spanEvent.value(QStringLiteral("dur")).toDouble());
+
+    const QJsonObject instantEvent = traceEvents[2].toObject();
+    EXPECT_EQ(QStringLiteral("[Channel1],play"),
+            instantEvent.value(QStringLiteral("name")).toString());
+    EXPECT_EQ(QStringLiteral("i"), instantEvent.value(QStringLiteral("ph")).toString());
+    EXPECT_DOUBLE_EQ(1.0,
+            instantEvent.value(QStringLiteral("args"))
+                    .toObject()
+                    .value(QStringLiteral("value"))
+                    .toDouble());
+}
+
+} // namespace
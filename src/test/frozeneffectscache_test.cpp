@@ -0,0 +1,147 @@
+#include "engine/effects/frozeneffectscache.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "engine/engine.h"
+#include "util/types.h"
+
+namespace {
+
+constexpr SINT kCapacityFrames = 64;
+constexpr SINT kLoopPeriodFrames = 16;
+constexpr SINT kBufferFrames = 4;
+constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelOutputCount;
+
+class FrozenEffectsCacheTest : public testing::Test {
+  protected:
+    FrozenEffectsCacheTest()
+            : m_cache(kCapacityFrames),
+              m_position(0) {
+    }
+
+    // Fills the buffer with the next frames of a periodic input
+    void nextInput(std::vector<CSAMPLE>* pBuffer) {
+        pBuffer->resize(kBufferSamples);
+        for (SINT i = 0; i < kBufferFrames; ++i) {
+            const CSAMPLE value = static_cast<CSAMPLE>(m_position) /
+                    kLoopPeriodFrames;
+            (*pBuffer)[i * 2] = value;
+            (*pBuffer)[i * 2 + 1] = -value;
+            m_position = (m_position + 1) % kLoopPeriodFrames;
+        }
+    }
+
+    // Processes a buffer like a chain applying a gain of 0.5 and returns
+    // whether the output has been replayed.
+    bool processBuffer(FrozenEffectsCache::Slot* pSlot,
+            quint64 revision,
+            std::vector<CSAMPLE>* pOutput) {
+        std::vector<CSAMPLE> input;
+        nextInput(&input);
+        pOutput->assign(kBufferSamples, 0);
+        if (pSlot->beginBuffer(input.data(),
+                    kBufferSamples,
+                    kLoopPeriodFrames,
+                    revision,
+                    CSAMPLE_GAIN_ONE,
+                    CSAMPLE_GAIN_ONE)) {
+            pSlot->replay(pOutput->data(), false);
+            return true;
+        }
+        for (SINT i = 0; i < kBufferSamples; ++i) {
+            (*pOutput)[i] = input[i] * 0.5f;
+        }
+        pSlot->endBuffer(pOutput->data());
+        return false;
+    }
+
+    FrozenEffectsCache m_cache;
+    SINT m_position;
+};
+
+TEST_F(FrozenEffectsCacheTest, FreezesAfterRepeatedPeriod) {
+    FrozenEffectsCache::Slot* pSlot = m_cache.slot(
+            SignalProcessingStage::Prefader, ChannelHandle());
+    ASSERT_NE(nullptr, pSlot);
+
+    std::vector<CSAMPLE> output;
+    // One period is recorded, the next one is compared to it
+    for (SINT i = 0; i < 2 * kLoopPeriodFrames / kBufferFrames; ++i) {
+        EXPECT_FALSE(processBuffer(pSlot, 1, &output));
+    }
+    EXPECT_TRUE(pSlot->isFrozen());
+
+    // The replayed output continues the loop
+    for (SINT i = 0; i < kLoopPeriodFrames / kBufferFrames; ++i) {
+        const SINT position = m_position;
+        EXPECT_TRUE(processBuffer(pSlot, 1, &output));
+        EXPECT_FLOAT_EQ(0.5f * position / kLoopPeriodFrames, output[0]);
+        EXPECT_FLOAT_EQ(-0.5f * position / kLoopPeriodFrames, output[1]);
+    }
+}
+
+TEST_F(FrozenEffectsCacheTest, UnfreezesOnRevisionChange) {
+    FrozenEffectsCache::Slot* pSlot = m_cache.slot(
+            SignalProcessingStage::Prefader, ChannelHandle());
+    ASSERT_NE(nullptr, pSlot);
+
+    std::vector<CSAMPLE> output;
+    for (SINT i = 0; i < 2 * kLoopPeriodFrames / kBufferFrames; ++i) {
+        processBuffer(pSlot, 1, &output);
+    }
+    ASSERT_TRUE(pSlot->isFrozen());
+
+    // The live output is processed again, which matches the replayed output
+    // here, so the crossfade does not change it
+    const SINT position = m_position;
+    EXPECT_FALSE(processBuffer(pSlot, 2, &output));
+    EXPECT_FALSE(pSlot->isFrozen());
+    EXPECT_FLOAT_EQ(0.5f * position / kLoopPeriodFrames, output[0]);
+
+    // Frozen again after the output has repeated for a whole period
+    for (SINT i = 1; i < kLoopPeriodFrames / kBufferFrames; ++i) {
+        EXPECT_FALSE(processBuffer(pSlot, 2, &output));
+    }
+    EXPECT_TRUE(pSlot->isFrozen());
+    EXPECT_TRUE(processBuffer(pSlot, 2, &output));
+}
+
+TEST_F(FrozenEffectsCacheTest, NoFreezeWithoutLoop) {
+    FrozenEffectsCache::Slot* pSlot = m_cache.slot(
+            SignalProcessingStage::Prefader, ChannelHandle());
+    ASSERT_NE(nullptr, pSlot);
+
+    std::vector<CSAMPLE> input;
+    std::vector<CSAMPLE> output(kBufferSamples);
+    for (SINT i = 0; i < 4 * kLoopPeriodFrames / kBufferFrames; ++i) {
+        nextInput(&input);
+        EXPECT_FALSE(pSlot->beginBuffer(input.data(),
+                kBufferSamples,
+                0,
+                1,
+                CSAMPLE_GAIN_ONE,
+                CSAMPLE_GAIN_ONE));
+        pSlot->endBuffer(output.data());
+    }
+    EXPECT_FALSE(pSlot->isFrozen());
+}
+
+TEST_F(FrozenEffectsCacheTest, LimitedSlots) {
+    ChannelHandleFactory factory;
+    for (int i = 0; i < FrozenEffectsCache::kMaxSlots; ++i) {
+        EXPECT_NE(nullptr,
+                m_cache.slot(SignalProcessingStage::Postfader,
+                        factory.getOrCreateHandle(QStringLiteral("[Bus%1]").arg(i))));
+    }
+    EXPECT_EQ(nullptr,
+            m_cache.slot(SignalProcessingStage::Postfader,
+                    factory.getOrCreateHandle(QStringLiteral("[Main]"))));
+    // Assigned slots are still found
+    EXPECT_NE(nullptr,
+            m_cache.slot(SignalProcessingStage::Postfader,
+                    factory.getOrCreateHandle(QStringLiteral("[Bus0]"))));
+}
+
+} // namespace
@@ -0,0 +1,71 @@
+#include "util/db/fwdsqlquery.h"
+
+#include <gtest/gtest.h>
+
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+const QString kInsertStatement =
+        QStringLiteral("INSERT INTO temp.fwd_sql_query_test (value) VALUES (:value)");
+
+const QString kSelectStatement =
+        QStringLiteral("SELECT value FROM temp.fwd_sql_query_test ORDER BY value");
+
+class FwdSqlQueryTest : public MixxxDbTest {
+  protected:
+    FwdSqlQueryTest()
+            : MixxxDbTest(true) {
+        FwdSqlQuery query(dbConnection(),
+                QStringLiteral("CREATE TEMP TABLE fwd_sql_query_test (value INTEGER)"));
+        EXPECT_TRUE(query.execPrepared());
+    }
+
+    void insertValues(int count) {
+        for (int i = 0; i < count; ++i) {
+            FwdSqlQuery query = FwdSqlQuery::prepareCached(dbConnection(), kInsertStatement);
+            ASSERT_TRUE(query.isPrepared());
+            query.bindValue(QStringLiteral(":value"), i);
+            ASSERT_TRUE(query.execPrepared());
+        }
+    }
+};
+
+TEST_F(FwdSqlQueryTest, CachedStatementsAreReused) {
+    insertValues(3);
+
+    FwdSqlQuery query = FwdSqlQuery::prepareCached(dbConnection(), kSelectStatement);
+    ASSERT_TRUE(query.execPrepared());
+    int count = 0;
+    while (query.next()) {
+        EXPECT_EQ(count, query.fieldValue(0).toInt());
+        ++count;
+    }
+    EXPECT_EQ(3, count);
+}
+
+TEST_F(FwdSqlQueryTest, CachedStatementsInUseAreNotShared) {
+    insertValues(2);
+
+    FwdSqlQuery outer = FwdSqlQuery::prepareCached(dbConnection(), kSelectStatement);
+    ASSERT_TRUE(outer.execPrepared());
+    ASSERT_TRUE(outer.next());
+    EXPECT_EQ(0, outer.fieldValue(0).toInt());
+
+    // Executing the same statement again must not reset the outer query
+    {
+        FwdSqlQuery inner = FwdSqlQuery::prepareCached(dbConnection(), kSelectStatement);
+        ASSERT_TRUE(inner.execPrepared());
+        int count = 0;
+        while (inner.next()) {
+            ++count;
+        }
+        EXPECT_EQ(2, count);
+    }
+
+    ASSERT_TRUE(outer.next());
+    EXPECT_EQ(1, outer.fieldValue(0).toInt());
+    EXPECT_FALSE(outer.next());
+}
+
+} // namespace
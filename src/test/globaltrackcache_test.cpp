@@ -30,7 +30,10 @@ class TrackTitleThread: public QThread {
             m_recentTrackPtr.reset();
             // Try to resolve the next track by guessing the id
             const TrackId trackId(QVariant(loopCount % 2));
-            auto track = GlobalTrackCacheLocker().lookupTrackById(trackId);
+            // Alternate between both kinds of lookups
+            auto track = (loopCount % 4 < 2)
+                    ? GlobalTrackCacheLocker().lookupTrackById(trackId)
+                    : GlobalTrackCache::lookupTrackById(trackId);
             if (track) {
                 ASSERT_EQ(trackId, track->getId());
                 // #9097: Accessing the track from multiple threads is
@@ -139,6 +142,51 @@ TEST_F(GlobalTrackCacheTest, resolveByFileInfo) {
     }
 }
 
+TEST_F(GlobalTrackCacheTest, lookupTrackByIdWithoutLocking) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const TrackId trackId(QVariant(1));
+    EXPECT_EQ(TrackPointer(), GlobalTrackCache::lookupTrackById(trackId));
+
+    TrackPointer track;
+    {
+        auto testFileAccess = mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile)));
+        GlobalTrackCacheResolver resolver(testFileAccess);
+        track = resolver.getTrack();
+        ASSERT_TRUE(static_cast<bool>(track));
+        resolver.initTrackIdAndUnlockCache(trackId);
+    }
+
+    // The cache is not locked by the lookup, i.e. it succeeds
+    // even while another thread is locking the cache
+    {
+        std::atomic<bool> locked(false);
+        std::atomic<bool> unlock(false);
+        QThread* pLockingThread = QThread::create([&locked, &unlock] {
+            GlobalTrackCacheLocker cacheLocker;
+            locked.store(true);
+            while (!unlock.load()) {
+                QThread::yieldCurrentThread();
+            }
+        });
+        pLockingThread->start();
+        while (!locked.load()) {
+            QThread::yieldCurrentThread();
+        }
+        EXPECT_EQ(track, GlobalTrackCache::lookupTrackById(trackId));
+        EXPECT_EQ(TrackPointer(), GlobalTrackCache::lookupTrackById(TrackId(QVariant(2))));
+        unlock.store(true);
+        pLockingThread->wait();
+        delete pLockingThread;
+    }
+
+    GlobalTrackCacheLocker().purgeTrackId(trackId);
+    EXPECT_EQ(TrackPointer(), GlobalTrackCache::lookupTrackById(trackId));
+
+    track.reset();
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
+
 TEST_F(GlobalTrackCacheTest, concurrentDelete) {
     ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
 
@@ -0,0 +1,71 @@
+#include "waveform/guiframescheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "test/mixxxtest.h"
+#include "waveform/guitick.h"
+
+namespace {
+
+class GuiFrameSchedulerTest : public MixxxTest {
+};
+
+TEST_F(GuiFrameSchedulerTest, Inactive) {
+    EXPECT_FALSE(GuiFrameScheduler::isActive());
+    {
+        GuiTick guiTick;
+        EXPECT_TRUE(GuiFrameScheduler::isActive());
+    }
+    EXPECT_FALSE(GuiFrameScheduler::isActive());
+}
+
+TEST_F(GuiFrameSchedulerTest, DispatchUntilRemoved) {
+    GuiTick guiTick;
+    auto pReceiver = std::make_unique<QObject>();
+    auto pDestroyedReceiver = std::make_unique<QObject>();
+    int frames = 0;
+    int destroyedFrames = 0;
+    GuiFrameScheduler::add(pReceiver.get(),
+            GuiFrameScheduler::Rate::EveryFrame,
+            [&frames](double) { ++frames; });
+    GuiFrameScheduler::add(pDestroyedReceiver.get(),
+            GuiFrameScheduler::Rate::EveryFrame,
+            [&destroyedFrames](double) { ++destroyedFrames; });
+
+    guiTick.process();
+    EXPECT_EQ(1, frames);
+    EXPECT_EQ(1, destroyedFrames);
+
+    pDestroyedReceiver.reset();
+    guiTick.process();
+    EXPECT_EQ(2, frames);
+    EXPECT_EQ(1, destroyedFrames);
+
+    GuiFrameScheduler::remove(pReceiver.get());
+    guiTick.process();
+    EXPECT_EQ(2, frames);
+}
+
+TEST_F(GuiFrameSchedulerTest, AddWhileDispatching) {
+    GuiTick guiTick;
+    QObject receiver;
+    int addedFrames = 0;
+    GuiFrameScheduler::add(&receiver,
+            GuiFrameScheduler::Rate::EveryFrame,
+            [&receiver, &addedFrames](double) {
+                GuiFrameScheduler::add(&receiver,
+                        GuiFrameScheduler::Rate::EveryFrame,
+                        [&addedFrames](double) { ++addedFrames; });
+            });
+
+    // Added callbacks are invoked from the next frame on
+    guiTick.process();
+    EXPECT_EQ(0, addedFrames);
+    guiTick.process();
+    EXPECT_EQ(1, addedFrames);
+    GuiFrameScheduler::remove(&receiver);
+}
+
+} // namespace
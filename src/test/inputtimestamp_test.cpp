@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "util/inputtimestamp.h"
+
+namespace mixxx {
+
+class InputTimestampTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        Time::setTestMode(true);
+        Time::setTestElapsedTime(Duration::fromMillis(100));
+    }
+
+    void TearDown() override {
+        Time::setTestMode(false);
+    }
+};
+
+TEST_F(InputTimestampTest, currentTimeWithoutInput) {
+    EXPECT_FALSE(InputTimestamp::isActive());
+    EXPECT_EQ(Duration::fromMillis(100), InputTimestamp::current());
+}
+
+TEST_F(InputTimestampTest, nestedInputs) {
+    {
+        const ScopedInputTimestamp outer(Duration::fromMillis(90));
+        EXPECT_TRUE(InputTimestamp::isActive());
+        EXPECT_EQ(Duration::fromMillis(90), InputTimestamp::current());
+        {
+            const ScopedInputTimestamp inner(Duration::fromMillis(95));
+            EXPECT_EQ(Duration::fromMillis(95), InputTimestamp::current());
+        }
+        EXPECT_EQ(Duration::fromMillis(90), InputTimestamp::current());
+    }
+    EXPECT_FALSE(InputTimestamp::isActive());
+    EXPECT_EQ(Duration::fromMillis(100), InputTimestamp::current());
+}
+
+} // namespace mixxx
@@ -2,6 +2,8 @@
 
 #include "errordialoghandler.h"
 #include "mixxxtest.h"
+#include "test/enginemixerbenchmark.h"
+#include "test/soundsourcebenchmark.h"
 #include "util/logging.h"
 
 int main(int argc, char **argv) {
@@ -28,6 +30,10 @@ int main(int argc, char **argv) {
     MixxxTest::ApplicationScope applicationScope(argc, argv);
 
     if (run_benchmarks) {
+        // Depend on the registered providers, the builtin effects and the
+        // available test files
+        registerSoundSourceBenchmarks();
+        registerEngineMixerBenchmarks();
         benchmark::RunSpecifiedBenchmarks();
         return 0;
     } else {
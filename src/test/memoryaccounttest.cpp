@@ -0,0 +1,34 @@
+#include "util/memoryaccount.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(MemoryAccountTest, TracksPeakBytes) {
+    MemoryAccount account(QStringLiteral("Test"));
+    EXPECT_EQ(0, account.bytes());
+    EXPECT_EQ(0, account.peakBytes());
+
+    account.add(100);
+    account.add(50);
+    account.subtract(120);
+    EXPECT_EQ(30, account.bytes());
+    EXPECT_EQ(150, account.peakBytes());
+
+    account.set(200);
+    account.set(10);
+    EXPECT_EQ(10, account.bytes());
+    EXPECT_EQ(200, account.peakBytes());
+}
+
+TEST(MemoryAccountTest, ReportWithoutStatsManager) {
+    {
+        MemoryAccount account(QStringLiteral("Destroyed"));
+        account.add(1);
+    }
+    MemoryAccount account(QStringLiteral("Test"));
+    account.add(1);
+    MemoryAccount::reportAll();
+}
+
+} // namespace
@@ -0,0 +1,80 @@
+#include "sources/metadatacache.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace mixxx {
+
+class MetadataCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_filePath = m_tempDir.filePath(QStringLiteral("track.mp3"));
+        writeFile(QByteArrayLiteral("content"));
+    }
+
+    void TearDown() override {
+        MetadataCache::remove(m_filePath);
+    }
+
+    void writeFile(const QByteArray& content) {
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_EQ(content.size(), file.write(content));
+    }
+
+    static TrackMetadata metadataWithTitle(const QString& title) {
+        TrackMetadata trackMetadata;
+        trackMetadata.refTrackInfo().setTitle(title);
+        return trackMetadata;
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+};
+
+TEST_F(MetadataCacheTest, importUnmodifiedFile) {
+    const auto existing = metadataWithTitle(QStringLiteral("existing"));
+    const auto imported = metadataWithTitle(QStringLiteral("imported"));
+    const auto fileKey = MetadataCache::fileKey(m_filePath);
+    ASSERT_TRUE(fileKey.isValid());
+    MetadataCache::store(m_filePath, fileKey, false, existing, imported);
+
+    // Both the existing and the imported metadata result in the
+    // imported metadata
+    auto trackMetadata = existing;
+    EXPECT_TRUE(MetadataCache::import(m_filePath, fileKey, false, &trackMetadata));
+    EXPECT_EQ(imported, trackMetadata);
+    EXPECT_TRUE(MetadataCache::import(m_filePath, fileKey, false, &trackMetadata));
+    EXPECT_EQ(imported, trackMetadata);
+
+    // The result depends on other existing metadata
+    trackMetadata = metadataWithTitle(QStringLiteral("other"));
+    EXPECT_FALSE(MetadataCache::import(m_filePath, fileKey, false, &trackMetadata));
+    EXPECT_EQ(metadataWithTitle(QStringLiteral("other")), trackMetadata);
+
+    // ...and on resetting missing tags
+    trackMetadata = existing;
+    EXPECT_FALSE(MetadataCache::import(m_filePath, fileKey, true, &trackMetadata));
+}
+
+TEST_F(MetadataCacheTest, discardModifiedFile) {
+    const auto existing = metadataWithTitle(QStringLiteral("existing"));
+    const auto fileKey = MetadataCache::fileKey(m_filePath);
+    MetadataCache::store(m_filePath,
+            fileKey,
+            false,
+            existing,
+            metadataWithTitle(QStringLiteral("imported")));
+
+    writeFile(QByteArrayLiteral("modified content"));
+    const auto modifiedFileKey = MetadataCache::fileKey(m_filePath);
+    ASSERT_NE(fileKey.size, modifiedFileKey.size);
+    auto trackMetadata = existing;
+    EXPECT_FALSE(MetadataCache::import(m_filePath, modifiedFileKey, false, &trackMetadata));
+    EXPECT_EQ(existing, trackMetadata);
+}
+
+} // namespace mixxx
@@ -0,0 +1,106 @@
+#include "controllers/midi/midiinputdispatchtable.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "control/controlobject.h"
+#include "control/controlpotmeter.h"
+#include "controllers/softtakeover.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class MidiInputDispatchTableTest : public MixxxTest {
+  protected:
+    MidiInputDispatchTable m_table;
+};
+
+TEST_F(MidiInputDispatchTableTest, FindMappings) {
+    QMultiHash<uint16_t, MidiInputMapping> mappings;
+    const MidiKey key1(0x90, 0x10);
+    const MidiKey key2(0xB0, 0x10);
+    mappings.insert(key1.key,
+            MidiInputMapping(key1, MidiOption::None, ConfigKey("[Test]", "a")));
+    mappings.insert(key1.key,
+            MidiInputMapping(key1, MidiOption::None, ConfigKey("[Test]", "b")));
+    mappings.insert(key2.key,
+            MidiInputMapping(key2, MidiOption::None, ConfigKey("[Test]", "c")));
+    m_table.compile(mappings);
+
+    const auto entries1 = m_table.find(key1.status, key1.control);
+    ASSERT_EQ(2u, entries1.size());
+    // Same order as the multi-hash
+    auto it = mappings.constFind(key1.key);
+    EXPECT_EQ(it.value(), entries1[0].mapping());
+    ++it;
+    EXPECT_EQ(it.value(), entries1[1].mapping());
+
+    const auto entries2 = m_table.find(key2.status, key2.control);
+    ASSERT_EQ(1u, entries2.size());
+    EXPECT_EQ(ConfigKey("[Test]", "c"), std::get<ConfigKey>(entries2[0].mapping().control));
+
+    EXPECT_TRUE(m_table.find(0x90, 0x11).empty());
+    EXPECT_TRUE(m_table.find(0x91, 0x10).empty());
+
+    m_table.clear();
+    EXPECT_TRUE(m_table.find(key1.status, key1.control).empty());
+}
+
+TEST_F(MidiInputDispatchTableTest, ResolveControl) {
+    QMultiHash<uint16_t, MidiInputMapping> mappings;
+    const MidiKey controlKey(0xB0, 0x01);
+    const MidiKey scriptKey(0xB0, 0x02);
+    mappings.insert(controlKey.key,
+            MidiInputMapping(controlKey, MidiOption::None, ConfigKey("[Test]", "co")));
+    mappings.insert(scriptKey.key,
+            MidiInputMapping(scriptKey, MidiOption::Script, ConfigKey("[Test]", "co")));
+    m_table.compile(mappings);
+
+    auto pControl = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    auto entries = m_table.find(controlKey.status, controlKey.control);
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ(pControl.get(), entries[0].control());
+
+    // Script mappings have no target control
+    auto scriptEntries = m_table.find(scriptKey.status, scriptKey.control);
+    ASSERT_EQ(1u, scriptEntries.size());
+    EXPECT_EQ(nullptr, scriptEntries[0].control());
+
+    // A control that has been deleted is looked up again
+    pControl.reset();
+    auto pRecreatedControl = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    EXPECT_EQ(pRecreatedControl.get(), entries[0].control());
+}
+
+TEST_F(MidiInputDispatchTableTest, ResolveSoftTakeover) {
+    QMultiHash<uint16_t, MidiInputMapping> mappings;
+    const MidiKey softTakeoverKey(0xB0, 0x01);
+    const MidiKey plainKey(0xB0, 0x02);
+    mappings.insert(softTakeoverKey.key,
+            MidiInputMapping(softTakeoverKey,
+                    MidiOption::SoftTakeover,
+                    ConfigKey("[Test]", "pot")));
+    mappings.insert(plainKey.key,
+            MidiInputMapping(plainKey, MidiOption::None, ConfigKey("[Test]", "pot")));
+    m_table.compile(mappings);
+
+    SoftTakeoverCtrl softTakeoverCtrl;
+    auto entries = m_table.find(softTakeoverKey.status, softTakeoverKey.control);
+    ASSERT_EQ(1u, entries.size());
+    // Nothing to enable before the control exists
+    EXPECT_EQ(nullptr, entries[0].softTakeover(&softTakeoverCtrl));
+
+    auto pControl = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "pot"));
+    SoftTakeover* pSoftTakeover = entries[0].softTakeover(&softTakeoverCtrl);
+    ASSERT_NE(nullptr, pSoftTakeover);
+    // The state is shared with other users of the same control
+    EXPECT_EQ(pSoftTakeover, softTakeoverCtrl.enable(pControl.get()));
+    EXPECT_EQ(pSoftTakeover, entries[0].softTakeover(&softTakeoverCtrl));
+
+    auto plainEntries = m_table.find(plainKey.status, plainKey.control);
+    ASSERT_EQ(1u, plainEntries.size());
+    EXPECT_EQ(nullptr, plainEntries[0].softTakeover(&softTakeoverCtrl));
+}
+
+} // namespace
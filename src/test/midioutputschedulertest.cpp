@@ -0,0 +1,80 @@
+#include "controllers/midi/midioutputscheduler.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const mixxx::Duration kNow = mixxx::Duration::fromSeconds(10);
+
+class MidiOutputSchedulerTest : public testing::Test {
+  protected:
+    MidiOutputScheduler m_scheduler;
+};
+
+TEST_F(MidiOutputSchedulerTest, CoalesceMessagesForSameTarget) {
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x10, 0x01}, kNow));
+    EXPECT_TRUE(m_scheduler.schedule({0x90, 0x20, 0x7F}, kNow));
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x10, 0x02}, kNow));
+    // A note off replaces the note on for the same note
+    EXPECT_TRUE(m_scheduler.schedule({0x80, 0x20, 0x00}, kNow));
+    // Different channel
+    EXPECT_TRUE(m_scheduler.schedule({0xB1, 0x10, 0x03}, kNow));
+
+    const auto messages = m_scheduler.take(10, kNow);
+    ASSERT_EQ(3, messages.size());
+    EXPECT_EQ((MidiShortMessage{0xB0, 0x10, 0x02}), messages[0]);
+    EXPECT_EQ((MidiShortMessage{0x80, 0x20, 0x00}), messages[1]);
+    EXPECT_EQ((MidiShortMessage{0xB1, 0x10, 0x03}), messages[2]);
+    EXPECT_TRUE(m_scheduler.isEmpty());
+}
+
+TEST_F(MidiOutputSchedulerTest, OldestPendingSince) {
+    const auto later = kNow + mixxx::Duration::fromMillis(5);
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x10, 0x01}, kNow));
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x11, 0x01}, later));
+    // Replacing a pending message keeps the time of its target
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x10, 0x02}, later));
+    EXPECT_EQ(kNow, m_scheduler.oldestPendingSince());
+
+    EXPECT_EQ(1, m_scheduler.take(1, later).size());
+    EXPECT_EQ(later, m_scheduler.oldestPendingSince());
+}
+
+TEST_F(MidiOutputSchedulerTest, DropRedundantMessages) {
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x10, 0x01}, kNow));
+    EXPECT_EQ(1, m_scheduler.take(10, kNow).size());
+
+    EXPECT_FALSE(m_scheduler.schedule({0xB0, 0x10, 0x01}, kNow));
+    EXPECT_TRUE(m_scheduler.isEmpty());
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x10, 0x02}, kNow));
+
+    // Resend after a while or if the device state might have changed
+    m_scheduler.take(10, kNow);
+    EXPECT_TRUE(m_scheduler.schedule(
+            {0xB0, 0x10, 0x02}, kNow + mixxx::Duration::fromSeconds(2)));
+    m_scheduler.take(10, kNow);
+    m_scheduler.clearSentValues();
+    EXPECT_TRUE(m_scheduler.schedule({0xB0, 0x10, 0x02}, kNow));
+}
+
+TEST_F(MidiOutputSchedulerTest, KeepSystemMessages) {
+    EXPECT_TRUE(m_scheduler.schedule({0xFA, 0x00, 0x00}, kNow));
+    EXPECT_TRUE(m_scheduler.schedule({0xFA, 0x00, 0x00}, kNow));
+    EXPECT_EQ(2, m_scheduler.take(10, kNow).size());
+    EXPECT_TRUE(m_scheduler.schedule({0xFA, 0x00, 0x00}, kNow));
+}
+
+TEST_F(MidiOutputSchedulerTest, TakeInBatches) {
+    for (unsigned char control = 0; control < 10; ++control) {
+        m_scheduler.schedule({0xB0, control, 0x01}, kNow);
+    }
+    EXPECT_EQ(4, m_scheduler.take(4, kNow).size());
+    // Still coalesced with the pending message after a partial take
+    m_scheduler.schedule({0xB0, 0x09, 0x02}, kNow);
+    const auto messages = m_scheduler.take(10, kNow);
+    ASSERT_EQ(6, messages.size());
+    EXPECT_EQ((MidiShortMessage{0xB0, 0x04, 0x01}), messages.first());
+    EXPECT_EQ((MidiShortMessage{0xB0, 0x09, 0x02}), messages.last());
+}
+
+} // namespace
@@ -0,0 +1,143 @@
+#include "util/mpscqueue.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "rigtorp/SPSCQueue.h"
+#include "util/fifo.h"
+
+namespace {
+
+TEST(MpscQueueTest, RoundsUpCapacity) {
+    mixxx::MpscQueue<int> queue(5);
+    EXPECT_EQ(8u, queue.capacity());
+}
+
+TEST(MpscQueueTest, PopsInPushOrder) {
+    mixxx::MpscQueue<int> queue(4);
+    int value = 0;
+    EXPECT_FALSE(queue.tryPop(&value));
+
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    ASSERT_TRUE(queue.tryPop(&value));
+    EXPECT_EQ(1, value);
+    ASSERT_TRUE(queue.tryPop(&value));
+    EXPECT_EQ(2, value);
+    EXPECT_FALSE(queue.tryPop(&value));
+}
+
+TEST(MpscQueueTest, FailsWhenFull) {
+    mixxx::MpscQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+
+    // Wrap around after a slot has been consumed
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(&value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(queue.tryPush(4));
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(queue.tryPop(&value));
+        EXPECT_EQ(i, value);
+    }
+}
+
+TEST(MpscQueueTest, ConcurrentProducers) {
+    constexpr int kProducerCount = 4;
+    constexpr int kValuesPerProducer = 10000;
+    mixxx::MpscQueue<int> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kProducerCount; ++producer) {
+        producers.emplace_back([&queue, producer] {
+            for (int i = 0; i < kValuesPerProducer; ++i) {
+                const int value = producer * kValuesPerProducer + i;
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // The values of each producer must arrive in order
+    std::vector<int> nextValues(kProducerCount, 0);
+    int poppedCount = 0;
+    while (poppedCount < kProducerCount * kValuesPerProducer) {
+        int value = 0;
+        if (!queue.tryPop(&value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int producer = value / kValuesPerProducer;
+        EXPECT_EQ(nextValues[producer], value % kValuesPerProducer);
+        ++nextValues[producer];
+        ++poppedCount;
+    }
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+}
+
+// A message of the size of the CachingReader requests
+struct Message {
+    void* pointer;
+    int value;
+};
+
+constexpr int kMessageBatchSize = 64;
+
+static void BM_MpscQueuePushPop(benchmark::State& state) {
+    mixxx::MpscQueue<Message> queue(kMessageBatchSize);
+    Message message{nullptr, 0};
+    for (auto _ : state) {
+        for (int i = 0; i < kMessageBatchSize; ++i) {
+            queue.tryPush(message);
+        }
+        while (queue.tryPop(&message)) {
+            benchmark::DoNotOptimize(message);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kMessageBatchSize);
+}
+BENCHMARK(BM_MpscQueuePushPop);
+
+static void BM_SpscQueuePushPop(benchmark::State& state) {
+    rigtorp::SPSCQueue<Message> queue(kMessageBatchSize);
+    Message message{nullptr, 0};
+    for (auto _ : state) {
+        for (int i = 0; i < kMessageBatchSize; ++i) {
+            benchmark::DoNotOptimize(queue.try_push(message));
+        }
+        while (const auto* pFront = queue.front()) {
+            message = *pFront;
+            queue.pop();
+            benchmark::DoNotOptimize(message);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kMessageBatchSize);
+}
+BENCHMARK(BM_SpscQueuePushPop);
+
+static void BM_FifoWriteRead(benchmark::State& state) {
+    FIFO<Message> fifo(kMessageBatchSize);
+    Message message{nullptr, 0};
+    for (auto _ : state) {
+        for (int i = 0; i < kMessageBatchSize; ++i) {
+            fifo.write(&message, 1);
+        }
+        while (fifo.read(&message, 1) == 1) {
+            benchmark::DoNotOptimize(message);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kMessageBatchSize);
+}
+BENCHMARK(BM_FifoWriteRead);
+
+} // namespace
@@ -0,0 +1,86 @@
+#include "recording/offlinerenderer.h"
+
+#include <gtest/gtest.h>
+#include <sndfile.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "recording/defs_recording.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+constexpr SINT kBlockFrames = 1024;
+
+class OfflineRendererTest : public SignalPathTest {
+  protected:
+    void SetUp() override {
+        SignalPathTest::SetUp();
+        m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "Encoding"),
+                ConfigValue(QStringLiteral(ENCODING_WAVE)));
+        m_fileName = m_tempDir.filePath(QStringLiteral("mix.wav"));
+    }
+
+    std::vector<float> readFile(int* pChannels) {
+        SF_INFO info{};
+        SNDFILE* pFile = sf_open(QFile::encodeName(m_fileName).constData(), SFM_READ, &info);
+        if (!pFile) {
+            return {};
+        }
+        std::vector<float> samples(info.frames * info.channels);
+        sf_readf_float(pFile, samples.data(), info.frames);
+        sf_close(pFile);
+        *pChannels = info.channels;
+        return samples;
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_fileName;
+};
+
+TEST_F(OfflineRendererTest, RendersWithoutGaps) {
+    // The reader is not given any time to read ahead between the buffers
+    ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+
+    const SINT frames = 50 * kBlockFrames;
+    {
+        OfflineRenderer renderer(m_pConfig, m_pEngineMixer);
+        QString errorMessage;
+        ASSERT_TRUE(renderer.open(m_fileName, &errorMessage)) << errorMessage.toStdString();
+        EXPECT_EQ(frames, renderer.render(frames));
+        EXPECT_GT(renderer.speedFactor(), 0.0);
+        renderer.close();
+    }
+
+    int channels = 0;
+    const auto samples = readFile(&channels);
+    ASSERT_EQ(mixxx::kEngineChannelOutputCount, channels);
+    ASSERT_EQ(static_cast<size_t>(frames * channels), samples.size());
+    // Every block of the sine contains audible samples, i.e. no chunk has
+    // been missed
+    for (SINT block = 0; block < frames / kBlockFrames; ++block) {
+        float peak = 0;
+        for (SINT i = 0; i < kBlockFrames * channels; ++i) {
+            peak = std::max(peak, std::abs(samples[block * kBlockFrames * channels + i]));
+        }
+        EXPECT_GT(peak, 0.01f) << "block " << block;
+    }
+}
+
+TEST_F(OfflineRendererTest, Stop) {
+    OfflineRenderer renderer(m_pConfig, m_pEngineMixer);
+    QString errorMessage;
+    ASSERT_TRUE(renderer.open(m_fileName, &errorMessage)) << errorMessage.toStdString();
+    // Stops after the buffer in which the signal is handled
+    QObject::connect(&renderer,
+            &OfflineRenderer::framesRendered,
+            &renderer,
+            &OfflineRenderer::stop);
+    EXPECT_EQ(kBlockFrames, renderer.render(10 * kBlockFrames));
+}
+
+} // namespace
@@ -0,0 +1,140 @@
+#include "engine/filters/partitionedconvolver.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+
+// Interleaved stereo white noise
+std::vector<CSAMPLE> noise(SINT frames, unsigned int seed) {
+    std::minstd_rand generator(seed);
+    std::uniform_real_distribution<CSAMPLE> distribution(-0.5f, 0.5f);
+    std::vector<CSAMPLE> samples(frames * 2);
+    for (auto& sample : samples) {
+        sample = distribution(generator);
+    }
+    return samples;
+}
+
+// The impulse response with the given id is noise of that many frames
+std::vector<CSAMPLE> loadNoise(int impulseResponse, int sampleRate) {
+    Q_UNUSED(sampleRate);
+    return noise(impulseResponse, 42);
+}
+
+double directConvolution(const std::vector<CSAMPLE>& input,
+        const std::vector<CSAMPLE>& impulseResponse,
+        SINT frame,
+        int channel) {
+    double sum = 0;
+    const SINT impulseResponseFrames = impulseResponse.size() / 2;
+    for (SINT i = 0; i < impulseResponseFrames && i <= frame; ++i) {
+        sum += impulseResponse[i * 2 + channel] * input[(frame - i) * 2 + channel];
+    }
+    return sum;
+}
+
+class PartitionedConvolverTest : public testing::Test {
+  protected:
+    PartitionedConvolverTest()
+            : m_convolver(loadNoise) {
+    }
+
+    void loadImpulseResponse(SINT frames) {
+        m_convolver.setImpulseResponse(static_cast<int>(frames), kSampleRate);
+        m_convolver.waitForWorker();
+    }
+
+    // Processes the input in buffers of varying size and waits for the
+    // worker after each buffer, so it is never late
+    std::vector<CSAMPLE> process(const std::vector<CSAMPLE>& input) {
+        std::vector<CSAMPLE> output(input.size());
+        const SINT frames = input.size() / 2;
+        const SINT bufferFrames[] = {100, 37, 256, 1024, 5};
+        SINT frame = 0;
+        for (int buffer = 0; frame < frames; ++buffer) {
+            const SINT numFrames = math_min(bufferFrames[buffer % 5], frames - frame);
+            m_convolver.process(&output[frame * 2], &input[frame * 2], numFrames);
+            m_convolver.waitForWorker();
+            frame += numFrames;
+        }
+        return output;
+    }
+
+    PartitionedConvolver m_convolver;
+};
+
+TEST_F(PartitionedConvolverTest, SilentWithoutImpulseResponse) {
+    const std::vector<CSAMPLE> input = noise(4 * PartitionedConvolver::kTailBlockFrames, 1);
+    const std::vector<CSAMPLE> output = process(input);
+    for (CSAMPLE sample : output) {
+        ASSERT_EQ(CSAMPLE_ZERO, sample);
+    }
+}
+
+TEST_F(PartitionedConvolverTest, MatchesDirectConvolution) {
+    // The head and several tail partitions, the last one partially
+    constexpr SINT kImpulseResponseFrames = 5 * PartitionedConvolver::kTailBlockFrames + 77;
+    loadImpulseResponse(kImpulseResponseFrames);
+    const std::vector<CSAMPLE> impulseResponse = loadNoise(kImpulseResponseFrames, kSampleRate);
+    const std::vector<CSAMPLE> input = noise(10 * PartitionedConvolver::kTailBlockFrames, 2);
+
+    const std::vector<CSAMPLE> output = process(input);
+
+    EXPECT_EQ(0, m_convolver.missedTailBlocks());
+    const SINT frames = input.size() / 2;
+    for (SINT frame = 0; frame < PartitionedConvolver::kHeadBlockFrames; ++frame) {
+        ASSERT_EQ(CSAMPLE_ZERO, output[frame * 2]);
+    }
+    for (SINT frame = PartitionedConvolver::kHeadBlockFrames; frame < frames; frame += 7) {
+        for (int channel = 0; channel < 2; ++channel) {
+            const double expected = directConvolution(input,
+                    impulseResponse,
+                    frame - PartitionedConvolver::kHeadBlockFrames,
+                    channel);
+            ASSERT_NEAR(expected, output[frame * 2 + channel], 1e-3)
+                    << "frame " << frame << " channel " << channel;
+        }
+    }
+}
+
+TEST_F(PartitionedConvolverTest, ResetClearsTail) {
+    loadImpulseResponse(6 * PartitionedConvolver::kTailBlockFrames);
+    process(noise(5 * PartitionedConvolver::kTailBlockFrames + 300, 3));
+
+    m_convolver.reset();
+    const std::vector<CSAMPLE> silence(2 * 8 * PartitionedConvolver::kTailBlockFrames);
+    const std::vector<CSAMPLE> output = process(silence);
+    for (SINT i = 0; i < static_cast<SINT>(output.size()); ++i) {
+        ASSERT_EQ(CSAMPLE_ZERO, output[i]) << "sample " << i;
+    }
+}
+
+// The CPU load of the engine thread, the tail is calculated on the worker
+static void BM_PartitionedConvolver(benchmark::State& state) {
+    const SINT frames = static_cast<SINT>(state.range(0));
+    const SINT impulseResponseFrames = static_cast<SINT>(state.range(1)) * kSampleRate;
+    PartitionedConvolver convolver(loadNoise);
+    convolver.setImpulseResponse(static_cast<int>(impulseResponseFrames), kSampleRate);
+    convolver.waitForWorker();
+    const std::vector<CSAMPLE> input = noise(frames, 1);
+    std::vector<CSAMPLE> output(frames * 2);
+
+    for (auto _ : state) {
+        convolver.process(output.data(), input.data(), frames);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.counters["missed"] = convolver.missedTailBlocks();
+}
+BENCHMARK(BM_PartitionedConvolver)
+        ->ArgNames({"frames", "seconds"})
+        ->ArgsProduct({{64, 512, 4096}, {1, 4}});
+
+} // namespace
@@ -0,0 +1,151 @@
+#include "engine/filters/polyphaseoversampler.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr SINT kFrames = 1024;
+constexpr double kSampleRate = 44100;
+
+std::vector<CSAMPLE> stereoSine(double frequency, SINT frames) {
+    std::vector<CSAMPLE> sine(frames * 2);
+    for (SINT i = 0; i < frames; ++i) {
+        const CSAMPLE sample = static_cast<CSAMPLE>(
+                0.5 * std::sin(2 * M_PI * frequency * i / kSampleRate));
+        sine[i * 2] = sample;
+        sine[i * 2 + 1] = -sample;
+    }
+    return sine;
+}
+
+class PolyphaseOversamplerTest : public testing::TestWithParam<int> {
+};
+
+TEST_P(PolyphaseOversamplerTest, ImpulseIsDelayedByLatency) {
+    PolyphaseOversampler oversampler(kFrames, GetParam());
+    std::vector<CSAMPLE> buffer(kFrames * 2, CSAMPLE_ZERO);
+    buffer[0] = 1;
+    buffer[1] = -1;
+
+    oversampler.upsample(buffer.data(), kFrames);
+    oversampler.downsample(buffer.data(), kFrames);
+
+    const SINT latency = oversampler.latencyFrames();
+    SINT peakFrame = 0;
+    for (SINT i = 0; i < kFrames; ++i) {
+        if (std::abs(buffer[i * 2]) > std::abs(buffer[peakFrame * 2])) {
+            peakFrame = i;
+        }
+    }
+    EXPECT_EQ(latency, peakFrame);
+    EXPECT_NEAR(1, buffer[latency * 2], 0.1);
+    EXPECT_NEAR(-1, buffer[latency * 2 + 1], 0.1);
+}
+
+TEST_P(PolyphaseOversamplerTest, MatchesDelayedDry) {
+    PolyphaseOversampler oversampler(kFrames, GetParam());
+    // Up to about 15 kHz the filters have unity gain
+    for (double frequency : {100.0, 1000.0, 15000.0}) {
+        oversampler.reset();
+        const std::vector<CSAMPLE> input = stereoSine(frequency, kFrames);
+        std::vector<CSAMPLE> output(kFrames * 2);
+        std::vector<CSAMPLE> dry(kFrames * 2);
+
+        oversampler.upsample(input.data(), kFrames);
+        oversampler.downsample(output.data(), kFrames);
+        oversampler.delayDry(dry.data(), input.data(), kFrames);
+
+        // Skip the transient of the filters at the start of the delayed sine
+        for (SINT i = 4 * oversampler.latencyFrames(); i < kFrames * 2; ++i) {
+            ASSERT_NEAR(dry[i], output[i], 0.01)
+                    << "frequency " << frequency << " sample " << i;
+        }
+    }
+}
+
+TEST_P(PolyphaseOversamplerTest, SplitBuffers) {
+    // The result must not depend on the buffer size
+    PolyphaseOversampler whole(kFrames, GetParam());
+    PolyphaseOversampler split(kFrames, GetParam());
+    const std::vector<CSAMPLE> input = stereoSine(1000, kFrames);
+    std::vector<CSAMPLE> wholeOutput(kFrames * 2);
+    std::vector<CSAMPLE> splitOutput(kFrames * 2);
+
+    whole.upsample(input.data(), kFrames);
+    whole.downsample(wholeOutput.data(), kFrames);
+
+    constexpr SINT kSplitFrames = 100;
+    for (SINT offset = 0; offset < kFrames; offset += kSplitFrames) {
+        const SINT frames = math_min(kSplitFrames, kFrames - offset);
+        split.upsample(&input[offset * 2], frames);
+        split.downsample(&splitOutput[offset * 2], frames);
+    }
+
+    for (SINT i = 0; i < kFrames * 2; ++i) {
+        ASSERT_NEAR(wholeOutput[i], splitOutput[i], 1e-6) << "sample " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(PolyphaseOversamplerFactors,
+        PolyphaseOversamplerTest,
+        testing::Values(1, 2, 4));
+
+TEST(PolyphaseOversamplerFactorTest, AttenuatesAliasing) {
+    // A hard clipped 10 kHz sine has harmonics at 30 kHz, 50 kHz, ...
+    // which alias to 14.1 kHz, 5.9 kHz, ... without oversampling.
+    // Compare the energy at 5.9 kHz with and without oversampling.
+    const std::vector<CSAMPLE> input = stereoSine(10000, kFrames);
+    const auto aliasingLevel = [&input](int factor) {
+        PolyphaseOversampler oversampler(kFrames, factor);
+        std::vector<CSAMPLE> output(kFrames * 2);
+        CSAMPLE* pOversampled = oversampler.upsample(input.data(), kFrames);
+        for (SINT i = 0; i < kFrames * 2 * factor; ++i) {
+            pOversampled[i] = CSAMPLE_clamp(4 * pOversampled[i]);
+        }
+        oversampler.downsample(output.data(), kFrames);
+
+        constexpr double aliasFrequency = 5 * 10000 - kSampleRate;
+        double re = 0;
+        double im = 0;
+        for (SINT i = oversampler.latencyFrames(); i < kFrames; ++i) {
+            const double phase = 2 * M_PI * aliasFrequency * i / kSampleRate;
+            re += output[i * 2] * std::cos(phase);
+            im += output[i * 2] * std::sin(phase);
+        }
+        return std::sqrt(re * re + im * im);
+    };
+    EXPECT_LT(aliasingLevel(2), 0.1 * aliasingLevel(1));
+    EXPECT_LT(aliasingLevel(4), 0.1 * aliasingLevel(1));
+}
+
+// Round trip of a hard clipping waveshaper, like the Distortion effect
+static void BM_PolyphaseOversamplerWaveshaper(benchmark::State& state) {
+    const SINT frames = static_cast<SINT>(state.range(0));
+    const int factor = static_cast<int>(state.range(1));
+    PolyphaseOversampler oversampler(frames, factor);
+    const std::vector<CSAMPLE> input = stereoSine(1000, frames);
+    std::vector<CSAMPLE> output(frames * 2);
+
+    for (auto _ : state) {
+        CSAMPLE* pOversampled = oversampler.upsample(input.data(), frames);
+        const SINT numOversampledSamples = frames * 2 * factor;
+        for (SINT i = 0; i < numOversampledSamples; ++i) {
+            pOversampled[i] = CSAMPLE_clamp(4 * pOversampled[i]);
+        }
+        oversampler.downsample(output.data(), frames);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(BM_PolyphaseOversamplerWaveshaper)
+        ->ArgNames({"frames", "factor"})
+        ->ArgsProduct({{64, 512, 4096}, {1, 2, 4}});
+
+} // namespace
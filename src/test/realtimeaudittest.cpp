@@ -0,0 +1,69 @@
+#include "util/realtimeaudit.h"
+
+#include <gtest/gtest.h>
+
+#include <QString>
+
+#include "control/controlobject.h"
+#include "test/mockedenginebackendtest.h"
+
+namespace {
+
+class RealtimeAuditTest : public MockedEngineBackendTest {
+  protected:
+    void SetUp() override {
+        MockedEngineBackendTest::SetUp();
+        if (!mixxx::realtimeaudit::kEnabled) {
+            GTEST_SKIP() << "Requires the build option REALTIME_AUDIT";
+        }
+    }
+
+    void processBuffers(int count) {
+        for (int i = 0; i < count; ++i) {
+            m_pEngineMixer->process(kProcessBufferSize);
+        }
+    }
+};
+
+TEST_F(RealtimeAuditTest, DetectsAllocationInCallback) {
+    int violations = mixxx::realtimeaudit::violationCount();
+    {
+        // Outside of the callback allocations are fine
+        const QString string = QString::number(12345.678);
+        EXPECT_FALSE(string.isEmpty());
+    }
+    EXPECT_EQ(violations, mixxx::realtimeaudit::violationCount());
+
+    {
+        const mixxx::realtimeaudit::CallbackScope callbackScope;
+        const QString string = QString::number(12345.678);
+        EXPECT_FALSE(string.isEmpty());
+    }
+    EXPECT_LT(violations, mixxx::realtimeaudit::violationCount());
+
+    violations = mixxx::realtimeaudit::violationCount();
+    {
+        const mixxx::realtimeaudit::CallbackScope callbackScope;
+        const mixxx::realtimeaudit::SuspendScope suspendScope;
+        const QString string = QString::number(12345.678);
+        EXPECT_FALSE(string.isEmpty());
+    }
+    EXPECT_EQ(violations, mixxx::realtimeaudit::violationCount());
+}
+
+TEST_F(RealtimeAuditTest, EngineMixerProcessDoesNotAllocate) {
+    ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup2, "play"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup2, "keylock"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup3, "pfl"), 1.0);
+
+    // The first callbacks may initialize some state lazily
+    processBuffers(10);
+
+    const int violations = mixxx::realtimeaudit::violationCount();
+    processBuffers(100);
+    // See the stack traces on stderr for the offending code
+    EXPECT_EQ(violations, mixxx::realtimeaudit::violationCount());
+}
+
+} // namespace
@@ -129,6 +129,40 @@ TEST_F(RingDelayBufferTest, ReadWriteDelayTest) {
             mixxx::spanutil::spanFromPtrLen(thirdExpectedResult, numSamples));
 }
 
+TEST_F(RingDelayBufferTest, ReadCrossfadedTest) {
+    const SINT numSamples = 4;
+    RingDelayBuffer ringDelayBuffer(m_ringDelayBufferSize, false);
+
+    const CSAMPLE firstInput[] = {1.0, 2.0, 3.0, 4.0};
+    const CSAMPLE secondInput[] = {5.0, 6.0, 7.0, 8.0};
+    const CSAMPLE thirdInput[] = {9.0, 10.0};
+    const CSAMPLE firstExpectedResult[] = {1.0, 1.5, 2.0, 2.5};
+    const CSAMPLE secondExpectedResult[] = {3.0, 3.5, 4.0, 4.5};
+    const CSAMPLE thirdExpectedResult[] = {7.0, 7.5, 8.0, 8.5};
+
+    mixxx::SampleBuffer output(numSamples);
+    std::span<CSAMPLE> outputSpan = output.span();
+
+    // Without fading in, the first chunk is written unmodified and
+    // the items before it are silent.
+    ringDelayBuffer.write(mixxx::spanutil::spanFromPtrLen(firstInput, numSamples));
+    EXPECT_EQ(ringDelayBuffer.readCrossfaded(outputSpan, 0, 2), numSamples);
+    AssertIdenticalBufferEquals(outputSpan,
+            mixxx::spanutil::spanFromPtrLen(firstExpectedResult, numSamples));
+
+    // Cross-fade only the second half of the ramp.
+    ringDelayBuffer.write(mixxx::spanutil::spanFromPtrLen(secondInput, numSamples));
+    EXPECT_EQ(ringDelayBuffer.readCrossfaded(outputSpan, 0, 4, 0.5f, 1.0f), numSamples);
+    AssertIdenticalBufferEquals(outputSpan,
+            mixxx::spanutil::spanFromPtrLen(secondExpectedResult, numSamples));
+
+    // The items with the shorter delay circle around.
+    ringDelayBuffer.write(mixxx::spanutil::spanFromPtrLen(thirdInput, 2));
+    EXPECT_EQ(ringDelayBuffer.readCrossfaded(outputSpan, 0, 2), numSamples);
+    AssertIdenticalBufferEquals(outputSpan,
+            mixxx::spanutil::spanFromPtrLen(thirdExpectedResult, numSamples));
+}
+
 static void BM_WriteReadWholeBufferNoDelay(benchmark::State& state) {
     const SINT ringDelayBufferSize = static_cast<SINT>(state.range(0));
     const SINT numSamples = ringDelayBufferSize / 2;
@@ -183,4 +217,26 @@ static void BM_WriteReadWholeBufferDelay(benchmark::State& state) {
     }
 }
 BENCHMARK(BM_WriteReadWholeBufferDelay)->Range(64, 4 << 10);
+
+static void BM_WriteReadCrossfaded(benchmark::State& state) {
+    const SINT ringDelayBufferSize = static_cast<SINT>(state.range(0));
+    const SINT numSamples = ringDelayBufferSize / 4;
+
+    RingDelayBuffer m_ringDelayBuffer(ringDelayBufferSize, false);
+
+    mixxx::SampleBuffer input(numSamples);
+    mixxx::SampleBuffer output(numSamples);
+
+    std::span<CSAMPLE> inputSpan = input.span();
+    std::span<CSAMPLE> outputSpan = output.span();
+
+    input.fill(0.0f);
+
+    for (auto _ : state) {
+        // The write position moves, so the reads circle around
+        m_ringDelayBuffer.write(inputSpan);
+        m_ringDelayBuffer.readCrossfaded(outputSpan, numSamples, numSamples * 2);
+    }
+}
+BENCHMARK(BM_WriteReadCrossfaded)->Range(64, 4 << 10);
 } // namespace
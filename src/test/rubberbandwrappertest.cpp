@@ -0,0 +1,132 @@
+#include "engine/bufferscalers/rubberbandwrapper.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kBlockFrames = 512;
+constexpr SINT kMaxInputFrames = 16384;
+
+class RubberBandWrapperTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        RubberBandWorkerPool::createInstance();
+        const auto channelCount = mixxx::audio::ChannelCount::stem();
+        for (int ch = 0; ch < channelCount; ch++) {
+            m_input.emplace_back(kMaxInputFrames);
+            m_output.emplace_back(kBlockFrames);
+        }
+        for (int ch = 0; ch < channelCount; ch++) {
+            m_inputPtrs.push_back(m_input[ch].data());
+            m_outputPtrs.push_back(m_output[ch].data());
+        }
+        m_wrapper.setup(kSampleRate, channelCount, RubberBandStretcher::OptionProcessRealTime);
+        m_wrapper.setTimeRatio(1.0);
+        m_wrapper.reset();
+    }
+
+    void TearDown() override {
+        m_wrapper.clear();
+        RubberBandWorkerPool::destroy();
+    }
+
+    // Feeds the same sine to all channels until a block can be retrieved
+    void processBlock() {
+        while (m_wrapper.available() < kBlockFrames) {
+            const SINT frames = math_clamp(
+                    static_cast<SINT>(m_wrapper.getSamplesRequired()),
+                    SINT{1},
+                    kMaxInputFrames);
+            for (SINT frame = 0; frame < frames; ++frame) {
+                const auto value = static_cast<CSAMPLE>(0.5 *
+                        std::sin(2 * M_PI * 100 * (m_inputFrames + frame) / kSampleRate));
+                for (auto& buffer : m_input) {
+                    buffer.data()[frame] = value;
+                }
+            }
+            m_wrapper.process(m_inputPtrs.data(), frames, false);
+            m_inputFrames += frames;
+        }
+        ASSERT_EQ(static_cast<size_t>(kBlockFrames),
+                m_wrapper.retrieve(m_outputPtrs.data(), kBlockFrames, kBlockFrames));
+    }
+
+    CSAMPLE maxAbsDifference(int channel1, int channel2) const {
+        CSAMPLE result = 0;
+        for (SINT frame = 0; frame < kBlockFrames; ++frame) {
+            result = math_max(result,
+                    std::abs(m_output[channel1].data()[frame] -
+                            m_output[channel2].data()[frame]));
+        }
+        return result;
+    }
+
+    RubberBandWrapper m_wrapper;
+    std::vector<mixxx::SampleBuffer> m_input;
+    std::vector<mixxx::SampleBuffer> m_output;
+    std::vector<const float*> m_inputPtrs;
+    std::vector<float*> m_outputPtrs;
+    SINT m_inputFrames = 0;
+};
+
+TEST_F(RubberBandWrapperTest, InactiveChannelPairs) {
+    if (RubberBandWorkerPool::instance()->channelPerTask(
+                mixxx::audio::ChannelCount::stem()) > 4) {
+        GTEST_SKIP() << "All channels are stretched by a single instance";
+    }
+
+    for (int i = 0; i < 50; ++i) {
+        processBlock();
+    }
+
+    // The last two stereo pairs are not stretched and silent
+    m_wrapper.setActiveChannelPairs(0b0011);
+    for (int i = 0; i < 20; ++i) {
+        processBlock();
+        EXPECT_GT(SampleUtil::maxAbsAmplitude(m_output[0].data(), kBlockFrames), 0.1f);
+        for (int ch = 4; ch < mixxx::audio::ChannelCount::stem(); ch++) {
+            EXPECT_EQ(0.0f, SampleUtil::maxAbsAmplitude(m_output[ch].data(), kBlockFrames));
+        }
+    }
+
+    // After the restart, the output is aligned with the other pairs
+    m_wrapper.setActiveChannelPairs(0b1111);
+    for (int i = 0; i < 100; ++i) {
+        processBlock();
+    }
+    EXPECT_LT(maxAbsDifference(0, 4), 0.05f);
+    EXPECT_LT(maxAbsDifference(1, 7), 0.05f);
+}
+
+TEST_F(RubberBandWrapperTest, SwitchChannelPairs) {
+    if (RubberBandWorkerPool::instance()->channelPerTask(
+                mixxx::audio::ChannelCount::stem()) > 4) {
+        GTEST_SKIP() << "All channels are stretched by a single instance";
+    }
+
+    m_wrapper.setActiveChannelPairs(0b0001);
+    for (int i = 0; i < 50; ++i) {
+        processBlock();
+    }
+
+    // The output continues while the restarted pair catches up, but the
+    // deactivated pair is silent immediately
+    m_wrapper.setActiveChannelPairs(0b0100);
+    for (int i = 0; i < 20; ++i) {
+        processBlock();
+        EXPECT_EQ(0.0f, SampleUtil::maxAbsAmplitude(m_output[0].data(), kBlockFrames));
+    }
+    EXPECT_GT(SampleUtil::maxAbsAmplitude(m_output[4].data(), kBlockFrames), 0.1f);
+}
+
+} // namespace
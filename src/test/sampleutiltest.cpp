@@ -4,6 +4,7 @@
 #include <QList>
 #include <QPair>
 #include <QtDebug>
+#include <limits>
 #include <vector>
 
 #include "util/sample.h"
@@ -107,6 +108,24 @@ TEST_F(SampleUtilTest, applyAlternatingGain) {
     }
 }
 
+TEST_F(SampleUtilTest, applyStereoGainCurve) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int j = evenBuffers[i];
+        CSAMPLE* buffer = buffers[j];
+        int size = sizes[j];
+        FillBuffer(buffer, 1.0f, size);
+        std::vector<CSAMPLE_GAIN> gains(size / 2);
+        for (int f = 0; f < size / 2; ++f) {
+            gains[f] = static_cast<CSAMPLE_GAIN>(f % 7) * 0.1f;
+        }
+        SampleUtil::applyStereoGainCurve(buffer, gains.data(), size / 2);
+        for (int s = 0; s < size; s += 2) {
+            EXPECT_FLOAT_EQ(buffer[s], gains[s / 2]);
+            EXPECT_FLOAT_EQ(buffer[s + 1], gains[s / 2]);
+        }
+    }
+}
+
 TEST_F(SampleUtilTest, addWithGain) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -289,6 +308,31 @@ TEST_F(SampleUtilTest, convertS16ToFloat32) {
     }
 }
 
+TEST_F(SampleUtilTest, convertS32ToFloat32) {
+    const CSAMPLE scaleFactor = 1.0f / 2147483648.0f;
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        auto s32 = std::vector<int32_t>(size);
+        for (int j = 0; j < size; ++j) {
+            s32[j] = (j % 2) ? std::numeric_limits<int32_t>::min() : 0;
+        }
+        SampleUtil::convertS32ToFloat32(buffer, s32.data(), scaleFactor, size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ((j % 2) ? -1.0f : 0.0f, buffer[j]);
+        }
+        // In-place
+        for (int j = 0; j < size; ++j) {
+            reinterpret_cast<int32_t*>(buffer)[j] = j;
+        }
+        SampleUtil::convertS32ToFloat32(
+                buffer, reinterpret_cast<const int32_t*>(buffer), 0.5f, size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(j * 0.5f, buffer[j]);
+        }
+    }
+}
+
 TEST_F(SampleUtilTest, sumAbsPerChannel) {
     for (int i = 0; i < evenBuffers.size(); ++i) {
         int j = evenBuffers[i];
@@ -303,6 +347,39 @@ TEST_F(SampleUtilTest, sumAbsPerChannel) {
     }
 }
 
+TEST_F(SampleUtilTest, maxAbsPerChannel) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int j = evenBuffers[i];
+        CSAMPLE* buffer = buffers[j];
+        int size = sizes[j];
+        FillBuffer(buffer, -0.25f, size);
+        SampleUtil::applyAlternatingGain(buffer, 1.0, 2.0, size);
+        buffer[size - 2] = 0.75f;
+        // The maxima are only raised
+        CSAMPLE fMaxL = 0.5f, fMaxR = 0.0f;
+        SampleUtil::maxAbsPerChannel(&fMaxL, &fMaxR, buffer, size);
+        EXPECT_FLOAT_EQ(fMaxL, 0.75f);
+        EXPECT_FLOAT_EQ(fMaxR, 0.5f);
+        fMaxL = 1.0f;
+        SampleUtil::maxAbsPerChannel(&fMaxL, &fMaxR, buffer, size);
+        EXPECT_FLOAT_EQ(fMaxL, 1.0f);
+    }
+}
+
+TEST_F(SampleUtilTest, maxMid) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int j = evenBuffers[i];
+        CSAMPLE* buffer = buffers[j];
+        int size = sizes[j];
+        FillBuffer(buffer, -0.5f, size);
+        EXPECT_FLOAT_EQ(-0.5f, SampleUtil::maxMid(buffer, size));
+        // Only the mid of the frame counts, not the single samples
+        buffer[size - 2] = 0.75f;
+        buffer[size - 1] = 0.25f;
+        EXPECT_FLOAT_EQ(0.5f, SampleUtil::maxMid(buffer, size));
+    }
+}
+
 TEST_F(SampleUtilTest, interleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -325,6 +402,82 @@ TEST_F(SampleUtilTest, interleaveBuffer) {
     }
 }
 
+TEST_F(SampleUtilTest, interleavePlanarBuffer) {
+    for (int numChannels = 1; numChannels <= 6; ++numChannels) {
+        const SINT numFrames = 37;
+        std::vector<std::vector<CSAMPLE>> planes(numChannels);
+        std::vector<const CSAMPLE*> pPlanes(numChannels);
+        for (int c = 0; c < numChannels; ++c) {
+            planes[c].resize(numFrames);
+            for (SINT j = 0; j < numFrames; ++j) {
+                planes[c][j] = static_cast<CSAMPLE>(c * 1000 + j);
+            }
+            pPlanes[c] = planes[c].data();
+        }
+        std::vector<CSAMPLE> interleaved(numChannels * numFrames);
+        SampleUtil::interleavePlanarBuffer(
+                interleaved.data(), pPlanes.data(), numChannels, numFrames);
+        for (SINT j = 0; j < numFrames; ++j) {
+            for (int c = 0; c < numChannels; ++c) {
+                EXPECT_FLOAT_EQ(static_cast<CSAMPLE>(c * 1000 + j),
+                        interleaved[j * numChannels + c]);
+            }
+        }
+    }
+}
+
+TEST_F(SampleUtilTest, interleaveStereoPairsClamp) {
+    for (int numPairs = 1; numPairs <= 6; ++numPairs) {
+        const SINT numFrames = 37;
+        std::vector<std::vector<CSAMPLE>> pairs(numPairs);
+        std::vector<const CSAMPLE*> pPairs(numPairs);
+        for (int p = 0; p < numPairs; ++p) {
+            pairs[p].resize(numFrames * 2);
+            for (SINT j = 0; j < numFrames; ++j) {
+                pairs[p][j * 2] = static_cast<CSAMPLE>(p * 0.1 + j * 0.001);
+                pairs[p][j * 2 + 1] = -static_cast<CSAMPLE>(p * 0.1 + j * 0.001);
+            }
+            pPairs[p] = pairs[p].data();
+        }
+        // Out of range
+        pairs[0][0] = 2.0f;
+        std::vector<CSAMPLE> interleaved(numPairs * 2 * numFrames);
+        SampleUtil::interleaveStereoPairsClamp(
+                interleaved.data(), pPairs.data(), numPairs, numFrames);
+        for (SINT j = 0; j < numFrames; ++j) {
+            for (int p = 0; p < numPairs; ++p) {
+                EXPECT_FLOAT_EQ(SampleUtil::clampSample(pairs[p][j * 2]),
+                        interleaved[j * numPairs * 2 + p * 2]);
+                EXPECT_FLOAT_EQ(pairs[p][j * 2 + 1],
+                        interleaved[j * numPairs * 2 + p * 2 + 1]);
+            }
+        }
+        EXPECT_FLOAT_EQ(1.0f, interleaved[0]);
+    }
+}
+
+TEST_F(SampleUtilTest, copyStereoToMultiClamp) {
+    const SINT numFrames = 37;
+    const int numChannels = 6;
+    std::vector<CSAMPLE> stereo(numFrames * 2);
+    for (SINT j = 0; j < numFrames; ++j) {
+        stereo[j * 2] = static_cast<CSAMPLE>(j * 0.01);
+        stereo[j * 2 + 1] = -static_cast<CSAMPLE>(j * 0.01);
+    }
+    stereo[1] = -3.0f;
+    std::vector<CSAMPLE> multi(numFrames * numChannels, 0.5f);
+    SampleUtil::copyStereoToMultiClamp(multi.data(), stereo.data(), numChannels, 3, numFrames);
+    for (SINT j = 0; j < numFrames; ++j) {
+        for (int c = 0; c < numChannels; ++c) {
+            const CSAMPLE expected = c == 3
+                    ? stereo[j * 2]
+                    : (c == 4 ? SampleUtil::clampSample(stereo[j * 2 + 1]) : 0.5f);
+            EXPECT_FLOAT_EQ(expected, multi[j * numChannels + c]);
+        }
+    }
+    EXPECT_FLOAT_EQ(-1.0f, multi[4]);
+}
+
 TEST_F(SampleUtilTest, deinterleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -426,6 +579,155 @@ TEST_F(SampleUtilTest, copyReverseStem) {
     EXPECT_FLOAT_EQ(destination[15], 0.7f);
 }
 
+TEST_F(SampleUtilTest, kernelVariantsMatchBaseline) {
+    const SampleUtil::KernelVariant initialVariant = SampleUtil::kernelVariant();
+    constexpr SINT kSize = 1024;
+    std::vector<CSAMPLE> source(kSize);
+    for (SINT i = 0; i < kSize; ++i) {
+        source[i] = static_cast<CSAMPLE>(i % 37) * 0.05f - 0.9f;
+    }
+
+    auto runKernels = [&source](std::vector<CSAMPLE>* pResult) {
+        pResult->assign(kSize, 0.5f);
+        CSAMPLE* pDest = pResult->data();
+        SampleUtil::applyRampingGain(pDest, 0.3f, 0.9f, kSize);
+        std::vector<CSAMPLE_GAIN> gains(kSize / 2);
+        for (SINT i = 0; i < kSize / 2; ++i) {
+            gains[i] = 1.0f - static_cast<CSAMPLE_GAIN>(i) / kSize;
+        }
+        SampleUtil::applyStereoGainCurve(pDest, gains.data(), kSize / 2);
+        SampleUtil::addWithGain(pDest, source.data(), 0.7f, kSize);
+        SampleUtil::addWithRampingGain(pDest, source.data(), 0.2f, 0.6f, kSize);
+        SampleUtil::add2WithGain(pDest, source.data(), 0.1f, source.data(), 0.2f, kSize);
+        SampleUtil::add3WithGain(pDest,
+                source.data(),
+                0.1f,
+                source.data(),
+                0.2f,
+                source.data(),
+                0.3f,
+                kSize);
+        SampleUtil::linearCrossfadeBuffersOut(pDest,
+                source.data(),
+                kSize,
+                mixxx::audio::ChannelCount::stem());
+        CSAMPLE absL;
+        CSAMPLE absR;
+        SampleUtil::sumAbsPerChannel(&absL, &absR, pDest, kSize);
+        pResult->push_back(absL);
+        pResult->push_back(absR);
+        CSAMPLE maxL = 0;
+        CSAMPLE maxR = 0;
+        SampleUtil::maxAbsPerChannel(&maxL, &maxR, pDest, kSize);
+        pResult->push_back(maxL);
+        pResult->push_back(maxR);
+    };
+
+    ASSERT_TRUE(SampleUtil::setKernelVariant(SampleUtil::KernelVariant::Baseline));
+    std::vector<CSAMPLE> expected;
+    runKernels(&expected);
+
+    for (auto variant : {SampleUtil::KernelVariant::Avx2, SampleUtil::KernelVariant::Avx512}) {
+        if (!SampleUtil::setKernelVariant(variant)) {
+            continue;
+        }
+        std::vector<CSAMPLE> actual;
+        runKernels(&actual);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            // The order of the floating point operations differs, so the
+            // results are only approximately equal.
+            EXPECT_NEAR(expected[i], actual[i], 1e-3f) << "at index " << i;
+        }
+    }
+
+    SampleUtil::setKernelVariant(initialVariant);
+}
+
+TEST_F(SampleUtilTest, addMultipleWithRampingGainMatchesSequential) {
+    constexpr SINT kSize = 1024;
+    constexpr int kMaxSources = 10;
+    std::vector<std::vector<CSAMPLE>> sources(kMaxSources, std::vector<CSAMPLE>(kSize));
+    std::vector<const CSAMPLE*> sourcePointers;
+    std::vector<CSAMPLE_GAIN> oldGains;
+    std::vector<CSAMPLE_GAIN> newGains;
+    for (int source = 0; source < kMaxSources; ++source) {
+        for (SINT i = 0; i < kSize; ++i) {
+            sources[source][i] = static_cast<CSAMPLE>((i + 7 * source) % 41) * 0.04f - 0.8f;
+        }
+        sourcePointers.push_back(sources[source].data());
+        oldGains.push_back(0.1f * source);
+        newGains.push_back(1.0f - 0.05f * source);
+    }
+
+    // Cover a single pass, a full pass and a partial second pass
+    for (int numSources = 0; numSources <= kMaxSources; ++numSources) {
+        std::vector<CSAMPLE> expected(kSize, 0.25f);
+        for (int source = 0; source < numSources; ++source) {
+            SampleUtil::addWithRampingGain(expected.data(),
+                    sourcePointers[source],
+                    oldGains[source],
+                    newGains[source],
+                    kSize);
+        }
+        std::vector<CSAMPLE> actual(kSize, 0.25f);
+        SampleUtil::addMultipleWithRampingGain(actual.data(),
+                sourcePointers.data(),
+                oldGains.data(),
+                newGains.data(),
+                numSources,
+                kSize);
+        for (SINT i = 0; i < kSize; ++i) {
+            EXPECT_NEAR(expected[i], actual[i], 1e-4f)
+                    << "with " << numSources << " sources at index " << i;
+        }
+    }
+}
+
+TEST_F(SampleUtilTest, mixMultiToStereoWithRampingGain) {
+    constexpr SINT kNumFrames = 512;
+    const auto channelCount = mixxx::audio::ChannelCount::stem();
+    constexpr int kNumPairs = 4;
+    std::vector<CSAMPLE> source(kNumFrames * channelCount);
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<CSAMPLE>(i % 29) * 0.06f - 0.8f;
+    }
+    // A ramping, a constant, a muted and a fading out pair
+    const CSAMPLE_GAIN oldGains[kNumPairs] = {0.2f, 0.5f, 0.0f, 1.0f};
+    const CSAMPLE_GAIN newGains[kNumPairs] = {0.8f, 0.5f, 0.0f, 0.0f};
+
+    std::vector<CSAMPLE> expected(kNumFrames * 2, 0.0f);
+    for (SINT frame = 0; frame < kNumFrames; ++frame) {
+        for (int pair = 0; pair < kNumPairs; ++pair) {
+            const CSAMPLE_GAIN gain = oldGains[pair] +
+                    (newGains[pair] - oldGains[pair]) * (frame + 1) / kNumFrames;
+            expected[frame * 2] += source[frame * channelCount + pair * 2] * gain;
+            expected[frame * 2 + 1] += source[frame * channelCount + pair * 2 + 1] * gain;
+        }
+    }
+
+    std::vector<CSAMPLE> actual(kNumFrames * 2, 0.25f);
+    SampleUtil::mixMultiToStereoWithRampingGain(actual.data(),
+            source.data(),
+            oldGains,
+            newGains,
+            kNumFrames,
+            channelCount);
+    for (SINT i = 0; i < kNumFrames * 2; ++i) {
+        EXPECT_NEAR(expected[i], actual[i], 1e-4f) << "at index " << i;
+    }
+
+    // Silent pairs do not contribute and the output is overwritten
+    const CSAMPLE_GAIN silentGains[kNumPairs] = {0.0f, 0.0f, 0.0f, 0.0f};
+    SampleUtil::mixMultiToStereoWithRampingGain(actual.data(),
+            source.data(),
+            silentGains,
+            silentGains,
+            kNumFrames,
+            channelCount);
+    AssertWholeBufferEquals(actual.data(), 0.0f, kNumFrames * 2);
+}
+
 static void BM_MemCpy(benchmark::State& state) {
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -612,4 +914,392 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+// Benchmarks for each of the runtime selected kernel variants. Variants which
+// are not supported by the CPU are skipped.
+class ScopedKernelVariant {
+  public:
+    explicit ScopedKernelVariant(SampleUtil::KernelVariant variant)
+            : m_previousVariant(SampleUtil::kernelVariant()),
+              m_supported(SampleUtil::setKernelVariant(variant)) {
+    }
+    ~ScopedKernelVariant() {
+        SampleUtil::setKernelVariant(m_previousVariant);
+    }
+    bool isSupported() const {
+        return m_supported;
+    }
+
+  private:
+    const SampleUtil::KernelVariant m_previousVariant;
+    const bool m_supported;
+};
+
+#define BENCHMARK_KERNEL_VARIANTS(func)                                                   \
+    BENCHMARK_CAPTURE(func, Baseline, SampleUtil::KernelVariant::Baseline)->Range(64, 4096); \
+    BENCHMARK_CAPTURE(func, Avx2, SampleUtil::KernelVariant::Avx2)->Range(64, 4096);         \
+    BENCHMARK_CAPTURE(func, Avx512, SampleUtil::KernelVariant::Avx512)->Range(64, 4096)
+
+static void BM_ApplyRampingGain(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::applyRampingGain(buffer, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_ApplyRampingGain);
+
+static void BM_ApplyStereoGainCurve(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    std::vector<CSAMPLE_GAIN> gains(size / 2, 1.0f);
+
+    while (state.KeepRunning()) {
+        SampleUtil::applyStereoGainCurve(buffer, gains.data(), size / 2);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_ApplyStereoGainCurve);
+
+static void BM_AddWithGain(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addWithGain(buffer, buffer2, 1.1f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_AddWithGain);
+
+static void BM_AddWithRampingGain(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addWithRampingGain(buffer, buffer2, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_AddWithRampingGain);
+
+static void BM_AddMultipleWithRampingGain(
+        benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    // A typical four deck setup with sampler and microphone
+    constexpr int kNumSources = 6;
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    std::vector<CSAMPLE*> sources;
+    for (int i = 0; i < kNumSources; ++i) {
+        sources.push_back(SampleUtil::alloc(size));
+        SampleUtil::fill(sources.back(), 0.5f, size);
+    }
+    const std::vector<const CSAMPLE*> constSources(sources.begin(), sources.end());
+    const std::vector<CSAMPLE_GAIN> oldGains(kNumSources, 1.1f);
+    const std::vector<CSAMPLE_GAIN> newGains(kNumSources, 1.2f);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addMultipleWithRampingGain(buffer,
+                constSources.data(),
+                oldGains.data(),
+                newGains.data(),
+                kNumSources,
+                size);
+    }
+
+    SampleUtil::free(buffer);
+    for (CSAMPLE* pSource : sources) {
+        SampleUtil::free(pSource);
+    }
+}
+BENCHMARK_KERNEL_VARIANTS(BM_AddMultipleWithRampingGain);
+
+static void BM_Add2WithGain(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::add2WithGain(buffer, buffer2, 1.1f, buffer3, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_Add2WithGain);
+
+static void BM_Add3WithGain(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.5f, size);
+    CSAMPLE* buffer4 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer4, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::add3WithGain(buffer, buffer2, 1.1f, buffer3, 1.2f, buffer4, 1.3f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+    SampleUtil::free(buffer4);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_Add3WithGain);
+
+static void BM_CopyMultiToStereo(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT numFrames = static_cast<SINT>(state.range(0)) / 2;
+    const auto channelCount = mixxx::audio::ChannelCount::stem();
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.0f, numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames * channelCount);
+    SampleUtil::fill(buffer2, 0.5f, numFrames * channelCount);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyMultiToStereo(buffer, buffer2, numFrames, channelCount);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_CopyMultiToStereo);
+
+static void BM_InterleaveStereoPairsClamp(
+        benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    // Four decks routed to the channels of an external mixer
+    constexpr int kNumPairs = 4;
+    SINT numFrames = static_cast<SINT>(state.range(0)) / 2;
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * kNumPairs * 2);
+    std::vector<CSAMPLE*> pairs(kNumPairs);
+    for (auto& pPair : pairs) {
+        pPair = SampleUtil::alloc(numFrames * 2);
+        SampleUtil::fill(pPair, 0.5f, numFrames * 2);
+    }
+    const std::vector<const CSAMPLE*> pPairs(pairs.begin(), pairs.end());
+
+    while (state.KeepRunning()) {
+        SampleUtil::interleaveStereoPairsClamp(buffer, pPairs.data(), kNumPairs, numFrames);
+    }
+
+    SampleUtil::free(buffer);
+    for (auto* pPair : pairs) {
+        SampleUtil::free(pPair);
+    }
+}
+BENCHMARK_KERNEL_VARIANTS(BM_InterleaveStereoPairsClamp);
+
+static void BM_InterleaveBuffer(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT numFrames = static_cast<SINT>(state.range(0)) / 2;
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.0f, numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer2, 0.5f, numFrames);
+    CSAMPLE* buffer3 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer3, 0.5f, numFrames);
+
+    while (state.KeepRunning()) {
+        SampleUtil::interleaveBuffer(buffer, buffer2, buffer3, numFrames);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_InterleaveBuffer);
+
+static void BM_InterleaveStemBuffer(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT numFrames = static_cast<SINT>(state.range(0)) / 8;
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 8);
+    SampleUtil::fill(buffer, 0.0f, numFrames * 8);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer2, 0.5f, numFrames);
+
+    while (state.KeepRunning()) {
+        SampleUtil::interleaveBuffer(buffer,
+                buffer2,
+                buffer2,
+                buffer2,
+                buffer2,
+                buffer2,
+                buffer2,
+                buffer2,
+                buffer2,
+                numFrames);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_InterleaveStemBuffer);
+
+static void BM_SumAbsPerChannel(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    CSAMPLE absL;
+    CSAMPLE absR;
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(SampleUtil::sumAbsPerChannel(&absL, &absR, buffer, size));
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_SumAbsPerChannel);
+
+static void BM_MaxAbsPerChannel(benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    CSAMPLE maxL = 0;
+    CSAMPLE maxR = 0;
+
+    while (state.KeepRunning()) {
+        SampleUtil::maxAbsPerChannel(&maxL, &maxR, buffer, size);
+        benchmark::DoNotOptimize(maxL);
+        benchmark::DoNotOptimize(maxR);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_MaxAbsPerChannel);
+
+static void BM_LinearCrossfadeStemBuffersOut(
+        benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::linearCrossfadeBuffersOut(
+                buffer, buffer2, size, mixxx::audio::ChannelCount::stem());
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_LinearCrossfadeStemBuffersOut);
+
+static void BM_MixMultiToStereoWithRampingGain(
+        benchmark::State& state, SampleUtil::KernelVariant variant) {
+    ScopedKernelVariant scopedVariant(variant);
+    if (!scopedVariant.isSupported()) {
+        state.SkipWithError("Kernel variant not supported");
+        return;
+    }
+    SINT numFrames = static_cast<SINT>(state.range(0)) / 2;
+    const auto channelCount = mixxx::audio::ChannelCount::stem();
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.0f, numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames * channelCount);
+    SampleUtil::fill(buffer2, 0.5f, numFrames * channelCount);
+    const CSAMPLE_GAIN oldGains[] = {1.0f, 0.5f, 0.8f, 0.3f};
+    const CSAMPLE_GAIN newGains[] = {1.0f, 0.6f, 0.8f, 0.2f};
+
+    while (state.KeepRunning()) {
+        SampleUtil::mixMultiToStereoWithRampingGain(
+                buffer, buffer2, oldGains, newGains, numFrames, channelCount);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_MixMultiToStereoWithRampingGain);
+
 }  // namespace
@@ -5,7 +5,17 @@
 #include "library/dao/settingsdao.h"
 #include "test/mixxxdbtest.h"
 
-class SchemaManagerTest : public MixxxDbTest {};
+class SchemaManagerTest : public MixxxDbTest {
+  protected:
+    bool indexExists(const QString& name) const {
+        QSqlQuery query(dbConnection());
+        query.prepare(QStringLiteral(
+                "SELECT COUNT(*) FROM sqlite_master "
+                "WHERE type='index' AND name=:name"));
+        query.bindValue(QStringLiteral(":name"), name);
+        return query.exec() && query.next() && query.value(0).toInt() > 0;
+    }
+};
 
 TEST_F(SchemaManagerTest, UpgradeFromPreviousToNextVersion) {
     // Verify that all schema migrations work as expected
@@ -91,3 +101,32 @@ TEST_F(SchemaManagerTest, UpgradeFailed) {
             MixxxDb::kRequiredSchemaVersion, MixxxDb::kDefaultSchemaFile);
     EXPECT_EQ(SchemaManager::Result::UpgradeFailed, result);
 }
+
+TEST_F(SchemaManagerTest, DeferredStatements) {
+    SchemaManager schemaManager(dbConnection());
+    ASSERT_EQ(SchemaManager::Result::UpgradeSucceeded,
+            schemaManager.upgradeToSchemaVersion(
+                    MixxxDb::kRequiredSchemaVersion, MixxxDb::kDefaultSchemaFile));
+
+    // Not executed during the upgrade
+    EXPECT_FALSE(SchemaManager::readDeferredStatements(
+            MixxxDb::kRequiredSchemaVersion, MixxxDb::kDefaultSchemaFile)
+                         .isEmpty());
+    EXPECT_FALSE(indexExists(QStringLiteral("idx_Playlists_hidden_date_created")));
+
+    EXPECT_TRUE(MixxxDb::executeDeferredSchemaStatements(dbConnection()));
+    EXPECT_TRUE(indexExists(QStringLiteral("idx_Playlists_hidden_date_created")));
+    EXPECT_TRUE(indexExists(QStringLiteral("idx_crate_tracks_track_id")));
+
+    // Executed again on every startup
+    EXPECT_TRUE(MixxxDb::executeDeferredSchemaStatements(dbConnection()));
+    EXPECT_TRUE(MixxxDb::checkDatabaseIntegrity(dbConnection()));
+
+    // Only the statements up to the requested version
+    EXPECT_TRUE(SchemaManager::readDeferredStatements(
+            33, MixxxDb::kDefaultSchemaFile)
+                        .isEmpty());
+    EXPECT_TRUE(SchemaManager::readDeferredStatements(
+            MixxxDb::kRequiredSchemaVersion, ":file_doesnt_exist.xml")
+                        .isEmpty());
+}
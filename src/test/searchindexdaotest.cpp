@@ -0,0 +1,122 @@
+#include "library/dao/searchindexdao.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "library/searchquery.h"
+#include "library/searchqueryparser.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+namespace {
+
+class SearchIndexDAOTest : public LibraryTest {
+  protected:
+    void SetUp() override {
+        if (!searchIndex().isAvailable()) {
+            GTEST_SKIP() << "SQLite does not support FTS5 with the trigram tokenizer";
+        }
+    }
+
+    const SearchIndexDAO& searchIndex() const {
+        return internalCollection()->getSearchIndexDAO();
+    }
+
+    TrackPointer addTrack(
+            const QString& trackLocation,
+            const QString& artist,
+            const QString& title) {
+        TrackPointer pTrack = getOrAddTrackByLocation(getTestDir().filePath(trackLocation));
+        if (!pTrack) {
+            return pTrack;
+        }
+        pTrack->setArtist(artist);
+        pTrack->setTitle(title);
+        EXPECT_TRUE(internalCollection()->getTrackDAO().saveTrack(pTrack.get()));
+        return pTrack;
+    }
+
+    QString toSql(const QString& query) const {
+        SearchQueryParser parser(internalCollection(), QStringList{"artist", "title"});
+        parser.setSearchIndex(&searchIndex());
+        return parser.parseQuery(query, QString())->toSql();
+    }
+
+    QList<TrackId> search(const QString& query) const {
+        QList<TrackId> trackIds;
+        QSqlQuery sqlQuery(dbConnection());
+        EXPECT_TRUE(sqlQuery.exec(QStringLiteral("SELECT id FROM library WHERE ") +
+                toSql(query)));
+        while (sqlQuery.next()) {
+            trackIds.append(TrackId(sqlQuery.value(0)));
+        }
+        return trackIds;
+    }
+};
+
+TEST_F(SearchIndexDAOTest, SubstringMatch) {
+    const auto pTrack1 = addTrack(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"),
+            QStringLiteral("Daft Punk"),
+            QStringLiteral("One More Time"));
+    const auto pTrack2 = addTrack(
+            QStringLiteral("id3-test-data/cover-test-png.mp3"),
+            QStringLiteral("Beyoncé"),
+            QStringLiteral("Halo"));
+    ASSERT_TRUE(pTrack1);
+    ASSERT_TRUE(pTrack2);
+
+    EXPECT_THAT(toSql(QStringLiteral("punk")), ::testing::HasSubstr("MATCH"));
+    EXPECT_THAT(search(QStringLiteral("punk")), UnorderedElementsAre(pTrack1->getId()));
+    EXPECT_THAT(search(QStringLiteral("ORE TI")), UnorderedElementsAre(pTrack1->getId()));
+    // Case and diacritics are folded like by LIKE
+    EXPECT_THAT(search(QStringLiteral("BEYONCE")), UnorderedElementsAre(pTrack2->getId()));
+    EXPECT_THAT(search(QStringLiteral("artist:yonc")), UnorderedElementsAre(pTrack2->getId()));
+    EXPECT_THAT(search(QStringLiteral("title:yonc")), IsEmpty());
+    EXPECT_THAT(search(QStringLiteral("-punk")), UnorderedElementsAre(pTrack2->getId()));
+}
+
+TEST_F(SearchIndexDAOTest, ShortTermsFallBackToLike) {
+    const auto pTrack = addTrack(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"),
+            QStringLiteral("Daft Punk"),
+            QStringLiteral("One More Time"));
+    ASSERT_TRUE(pTrack);
+
+    EXPECT_THAT(toSql(QStringLiteral("pu")), ::testing::Not(::testing::HasSubstr("MATCH")));
+    EXPECT_THAT(search(QStringLiteral("pu")), UnorderedElementsAre(pTrack->getId()));
+    EXPECT_THAT(toSql(QStringLiteral("artist:=\"Daft Punk\"")),
+            ::testing::Not(::testing::HasSubstr("MATCH")));
+    EXPECT_THAT(search(QStringLiteral("artist:=\"Daft Punk\"")),
+            UnorderedElementsAre(pTrack->getId()));
+}
+
+TEST_F(SearchIndexDAOTest, UpdatedAndPurgedTracks) {
+    const auto pTrack = addTrack(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"),
+            QStringLiteral("Daft Punk"),
+            QStringLiteral("One More Time"));
+    ASSERT_TRUE(pTrack);
+    const TrackId trackId = pTrack->getId();
+
+    pTrack->setTitle(QStringLiteral("Around the World"));
+    ASSERT_TRUE(internalCollection()->getTrackDAO().saveTrack(pTrack.get()));
+    EXPECT_THAT(search(QStringLiteral("world")), UnorderedElementsAre(trackId));
+    EXPECT_THAT(search(QStringLiteral("more")), IsEmpty());
+
+    trackCollectionManager()->purgeTracks(
+            {TrackRef::fromFileInfo(pTrack->getFileInfo(), trackId)});
+    EXPECT_THAT(search(QStringLiteral("punk")), IsEmpty());
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "SELECT COUNT(*) FROM library_search_index")));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(0, query.value(0).toInt());
+}
+
+} // namespace
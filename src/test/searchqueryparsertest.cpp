@@ -1188,6 +1188,54 @@ TEST_F(SearchQueryParserTest, QueryIsLessSpecific) {
             QStringLiteral("crate:\"a b c\"")));
 }
 
+TEST_F(SearchQueryParserTest, QueryIsMoreSpecific) {
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QLatin1String(""),
+            QStringLiteral("s")));
+
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("searchm"),
+            QStringLiteral("searchme")));
+
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("A B"),
+            QStringLiteral("A B C")));
+
+    EXPECT_TRUE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("A B "),
+            QStringLiteral("A B bpm:120")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("A B C"),
+            QStringLiteral("A B")));
+
+    // Only the last word may be extended
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("A B C"),
+            QStringLiteral("A Bb C")));
+
+    // Extending a filter or a negated term may match more tracks
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("bpm:12"),
+            QStringLiteral("bpm:120")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("-abc"),
+            QStringLiteral("-abcd")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("artist:"),
+            QStringLiteral("artist: abc")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("A"),
+            QStringLiteral("A | B")));
+
+    EXPECT_FALSE(SearchQueryParser::queryIsMoreSpecific(
+            QStringLiteral("\"a b"),
+            QStringLiteral("\"a b c")));
+}
+
 TEST_F(SearchQueryParserTest, EmptyOrOperator) {
     auto pQuery = m_parser.parseQuery("|", QString());
 
@@ -0,0 +1,65 @@
+#include "sources/seektablecache.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+const QString kDecoder = QStringLiteral("test");
+
+class SeekTableCacheTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_cacheDir.isValid());
+        ASSERT_TRUE(m_audioDir.isValid());
+        mixxx::SeekTableCache::setDirectory(m_cacheDir.path());
+        m_audioFilePath = m_audioDir.filePath(QStringLiteral("audio.bin"));
+        writeAudioFile('a');
+    }
+
+    void TearDown() override {
+        mixxx::SeekTableCache::setDirectory(QString());
+    }
+
+    void writeAudioFile(char fill) {
+        QFile file(m_audioFilePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_EQ(256 * 1024, file.write(QByteArray(256 * 1024, fill)));
+    }
+
+    QTemporaryDir m_cacheDir;
+    QTemporaryDir m_audioDir;
+    QString m_audioFilePath;
+};
+
+TEST_F(SeekTableCacheTest, storeAndLoad) {
+    const QByteArray data = QByteArrayLiteral("seek table");
+    EXPECT_TRUE(mixxx::SeekTableCache::load(m_audioFilePath, kDecoder, 1).isEmpty());
+    mixxx::SeekTableCache::store(m_audioFilePath, kDecoder, 1, data);
+    EXPECT_EQ(data, mixxx::SeekTableCache::load(m_audioFilePath, kDecoder, 1));
+    // Other versions and decoders
+    EXPECT_TRUE(mixxx::SeekTableCache::load(m_audioFilePath, kDecoder, 2).isEmpty());
+    EXPECT_TRUE(mixxx::SeekTableCache::load(
+            m_audioFilePath, QStringLiteral("other"), 1)
+                        .isEmpty());
+}
+
+TEST_F(SeekTableCacheTest, ignoreModifiedFile) {
+    mixxx::SeekTableCache::store(
+            m_audioFilePath, kDecoder, 1, QByteArrayLiteral("seek table"));
+    writeAudioFile('b');
+    EXPECT_TRUE(mixxx::SeekTableCache::load(m_audioFilePath, kDecoder, 1).isEmpty());
+}
+
+TEST_F(SeekTableCacheTest, disabled) {
+    mixxx::SeekTableCache::setDirectory(QString());
+    mixxx::SeekTableCache::store(
+            m_audioFilePath, kDecoder, 1, QByteArrayLiteral("seek table"));
+    EXPECT_TRUE(mixxx::SeekTableCache::load(m_audioFilePath, kDecoder, 1).isEmpty());
+}
+
+} // namespace
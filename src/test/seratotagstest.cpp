@@ -341,3 +341,31 @@ TEST_F(SeratoTagsTest, Markers2RoundTrip) {
         }
     }
 }
+
+TEST_F(SeratoTagsTest, Markers2ParseIdenticalTags) {
+    const auto filetype = mixxx::taglib::FileType::MP3;
+    QDir dir(MixxxTest::getOrInitTestDir().filePath(QStringLiteral("serato/data/mp3/markers2/")));
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << "*.octet-stream");
+    const QFileInfoList fileList = dir.entryInfoList();
+    for (const QFileInfo& fileInfo : fileList) {
+        auto file = QFile(fileInfo.filePath());
+        const bool openOk = file.open(QIODevice::ReadOnly);
+        EXPECT_TRUE(openOk);
+        const QByteArray inputData = file.readAll();
+
+        // The second tag is parsed from the cached result of the first one
+        mixxx::SeratoTags seratoTags;
+        EXPECT_TRUE(seratoTags.parseMarkers2(inputData, filetype));
+        mixxx::SeratoTags identicalSeratoTags;
+        EXPECT_TRUE(identicalSeratoTags.parseMarkers2(
+                QByteArray(inputData.constData(), inputData.size()), filetype));
+        EXPECT_EQ(seratoTags.getCueInfos(), identicalSeratoTags.getCueInfos());
+        EXPECT_EQ(seratoTags.dumpMarkers2(filetype),
+                identicalSeratoTags.dumpMarkers2(filetype));
+
+        // Modifying one of them must not affect the other
+        seratoTags.setCueInfos({});
+        EXPECT_EQ(inputData, identicalSeratoTags.dumpMarkers2(filetype));
+    }
+}
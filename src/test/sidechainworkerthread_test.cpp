@@ -0,0 +1,76 @@
+#include "engine/sidechain/sidechainworkerthread.h"
+
+#include <gtest/gtest.h>
+
+#include <QSemaphore>
+#include <atomic>
+
+#include "engine/sidechain/sidechainworker.h"
+
+namespace {
+
+class CountingSideChainWorker : public SideChainWorker {
+  public:
+    void process(const CSAMPLE* pBuffer, const int iBufferSize) override {
+        for (int i = 0; i < iBufferSize; ++i) {
+            m_sum += pBuffer[i];
+        }
+        m_samples += iBufferSize;
+    }
+    void shutdown() override {
+    }
+
+    std::atomic<int> m_samples{0};
+    CSAMPLE m_sum = 0;
+};
+
+class BlockingSideChainWorker : public SideChainWorker {
+  public:
+    void process(const CSAMPLE*, const int) override {
+        m_unblock.acquire();
+    }
+    void shutdown() override {
+    }
+
+    QSemaphore m_unblock;
+};
+
+TEST(SideChainWorkerThreadTest, ProcessesAllSamplesBeforeStopping) {
+    CountingSideChainWorker worker;
+    const CSAMPLE buffer[4] = {1, 2, 3, 4};
+    {
+        SideChainWorkerThread thread(&worker, 1024);
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_TRUE(thread.writeSamples(buffer, 4));
+        }
+        thread.stop();
+    }
+    EXPECT_EQ(40, worker.m_samples.load());
+    EXPECT_EQ(100, worker.m_sum);
+}
+
+TEST(SideChainWorkerThreadTest, SlowWorkerDoesNotDelayOthers) {
+    BlockingSideChainWorker slowWorker;
+    CountingSideChainWorker worker;
+    const CSAMPLE buffer[256] = {};
+    SideChainWorkerThread slowThread(&slowWorker, 256);
+    SideChainWorkerThread thread(&worker, 256);
+
+    // The slow worker blocks in the first buffer and its FIFO overflows,
+    // while the other worker keeps processing
+    bool slowOverflowed = false;
+    for (int i = 0; i < 4; ++i) {
+        slowOverflowed |= !slowThread.writeSamples(buffer, 256);
+        EXPECT_TRUE(thread.writeSamples(buffer, 256));
+        while (worker.m_samples.load() < (i + 1) * 256) {
+            QThread::yieldCurrentThread();
+        }
+    }
+    EXPECT_TRUE(slowOverflowed);
+
+    slowWorker.m_unblock.release(16);
+    slowThread.stop();
+    thread.stop();
+}
+
+} // namespace
@@ -0,0 +1,62 @@
+#include "util/smoothedparameter.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(SmoothedParameterTest, UnchangedValueIsNotApplied) {
+    SmoothedParameter<double> parameter(1000.0);
+    EXPECT_FALSE(parameter.update(1000.0));
+    parameter.commit();
+    EXPECT_FALSE(parameter.update(1000.0));
+}
+
+TEST(SmoothedParameterTest, ChangesAreAppliedWithoutTolerance) {
+    SmoothedParameter<double> parameter(1000.0);
+    EXPECT_TRUE(parameter.update(1000.5));
+    EXPECT_DOUBLE_EQ(1000.5, parameter.applied());
+    EXPECT_TRUE(parameter.changed());
+    parameter.commit();
+    EXPECT_FALSE(parameter.changed());
+}
+
+TEST(SmoothedParameterTest, SmallChangesAreSkippedWhileMoving) {
+    SmoothedParameter<double> parameter(1000.0, 0.01);
+    EXPECT_FALSE(parameter.update(1005.0));
+    EXPECT_DOUBLE_EQ(1000.0, parameter.applied());
+    EXPECT_DOUBLE_EQ(1005.0, parameter.value());
+    parameter.commit();
+
+    // Exceeds the tolerance
+    EXPECT_TRUE(parameter.update(1011.0));
+    EXPECT_DOUBLE_EQ(1011.0, parameter.applied());
+    parameter.commit();
+
+    EXPECT_FALSE(parameter.update(1015.0));
+    parameter.commit();
+
+    // The knob has stopped, so the exact value is applied
+    EXPECT_TRUE(parameter.update(1015.0));
+    EXPECT_DOUBLE_EQ(1015.0, parameter.applied());
+    parameter.commit();
+    EXPECT_FALSE(parameter.update(1015.0));
+}
+
+TEST(SmoothedParameterTest, AbsoluteTolerance) {
+    SmoothedParameter<double> parameter(0.0, 0.0, 0.1);
+    EXPECT_FALSE(parameter.update(0.05));
+    parameter.commit();
+    EXPECT_TRUE(parameter.update(0.2));
+    EXPECT_DOUBLE_EQ(0.2, parameter.applied());
+}
+
+TEST(SmoothedParameterTest, RampFromPreviousValue) {
+    SmoothedParameter<float> parameter(0.0f);
+    parameter.update(1.0f);
+    const RampingValue<float> ramp = parameter.ramp(4);
+    EXPECT_FLOAT_EQ(0.0f, ramp.getNth(0));
+    EXPECT_FLOAT_EQ(0.5f, ramp.getNth(2));
+    EXPECT_FLOAT_EQ(1.0f, ramp.getNth(4));
+}
+
+} // namespace
@@ -3,6 +3,7 @@
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
+#include "sources/audiosourceparallelproxy.h"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
@@ -198,6 +199,99 @@ TEST_F(SoundSourceProxyTest, open) {
     }
 }
 
+TEST_F(SoundSourceProxyTest, reopenClosedAudioSource) {
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        mixxx::AudioSourcePointer pAudioSource = openAudioSource(filePath);
+        if (!pAudioSource) {
+            // skip test file
+            continue;
+        }
+        const auto readRange = mixxx::IndexRange::forward(
+                pAudioSource->frameIndexMin(),
+                math_min(pAudioSource->frameLength(), kMaxReadFrameCount));
+        const SINT sampleCount =
+                pAudioSource->getSignalInfo().frames2samples(readRange.length());
+        mixxx::SampleBuffer expectedBuffer(sampleCount);
+        EXPECT_EQ(readRange,
+                pAudioSource
+                        ->readSampleFrames(mixxx::WritableSampleFrames(readRange,
+                                mixxx::SampleBuffer::WritableSlice(expectedBuffer)))
+                        .frameIndexRange());
+        // Seek away from the start before returning the decoder
+        // into the pool
+        mixxx::SampleBuffer skipBuffer(sampleCount);
+        pAudioSource->readSampleFrames(mixxx::WritableSampleFrames(
+                mixxx::IndexRange::between(
+                        pAudioSource->frameIndexMax() - readRange.length(),
+                        pAudioSource->frameIndexMax()),
+                mixxx::SampleBuffer::WritableSlice(skipBuffer)));
+        pAudioSource->close();
+
+        // The decoder of the closed audio source is reused
+        pAudioSource = openAudioSource(filePath);
+        ASSERT_TRUE(pAudioSource);
+        mixxx::SampleBuffer actualBuffer(sampleCount);
+        EXPECT_EQ(readRange,
+                pAudioSource
+                        ->readSampleFrames(mixxx::WritableSampleFrames(readRange,
+                                mixxx::SampleBuffer::WritableSlice(actualBuffer)))
+                        .frameIndexRange());
+        expectDecodedSamplesEqual(
+                sampleCount,
+                expectedBuffer.data(),
+                actualBuffer.data(),
+                "Reading from reopened audio source");
+        pAudioSource->close();
+    }
+}
+
+TEST_F(SoundSourceProxyTest, parallelDecoding) {
+    const QString filePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test.flac"));
+    mixxx::AudioSourcePointer pExpectedSource = openAudioSource(filePath);
+    ASSERT_TRUE(pExpectedSource);
+    mixxx::AudioSourcePointer pActualSource =
+            mixxx::AudioSourceParallelProxy::create(
+                    openAudioSource(filePath),
+                    [filePath]() {
+                        return openAudioSource(filePath);
+                    },
+                    2);
+    ASSERT_EQ(pExpectedSource->frameIndexRange(), pActualSource->frameIndexRange());
+
+    mixxx::SampleBuffer expectedBuffer(
+            pExpectedSource->getSignalInfo().frames2samples(kMaxReadFrameCount));
+    mixxx::SampleBuffer actualBuffer(expectedBuffer.size());
+    // Read sequentially with odd chunk sizes that don't
+    // match the segment boundaries
+    SINT frameIndex = pExpectedSource->frameIndexMin();
+    int bufferSizeIndex = 0;
+    while (frameIndex < pExpectedSource->frameIndexMax()) {
+        const auto readRange = mixxx::IndexRange::between(frameIndex,
+                math_min(frameIndex + kBufferSizes[bufferSizeIndex] - 1,
+                        pExpectedSource->frameIndexMax()));
+        bufferSizeIndex = (bufferSizeIndex + 1) %
+                static_cast<int>(sizeof(kBufferSizes) / sizeof(kBufferSizes[0]));
+        const auto expectedFrames = pExpectedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(readRange,
+                        mixxx::SampleBuffer::WritableSlice(expectedBuffer)));
+        const auto actualFrames = pActualSource->readSampleFrames(
+                mixxx::WritableSampleFrames(readRange,
+                        mixxx::SampleBuffer::WritableSlice(actualBuffer)));
+        ASSERT_EQ(expectedFrames.frameIndexRange(), actualFrames.frameIndexRange());
+        ASSERT_FALSE(actualFrames.frameIndexRange().empty());
+        expectDecodedSamplesEqual(
+                actualFrames.readableLength(),
+                expectedFrames.readableData(),
+                actualFrames.readableData(),
+                "Reading sequentially from parallel decoders");
+        frameIndex = actualFrames.frameIndexRange().end();
+    }
+    pActualSource->close();
+    pExpectedSource->close();
+}
+
 TEST_F(SoundSourceProxyTest, openEmptyFile) {
     const QStringList fileNameSuffixes = getFileNameSuffixes();
 
@@ -0,0 +1,199 @@
+#include "test/soundsourcebenchmark.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <algorithm>
+#include <random>
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+// Measures the open time, the sequential decoding throughput and the
+// latency of random seeks for every SoundSource provider and every test
+// file that the provider supports. Each result is labeled with the file
+// type and the priority of the provider for this file type. Run them with
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_SoundSource
+//
+// or build the mixxx-soundsource-benchmark target.
+//
+// The files generated by soundFileFormats/generateFiles.sh cover all
+// supported bit depths and sample rates. Otherwise the checked in test
+// files of all formats are used.
+
+namespace {
+
+// Read size of a deck, see CachingReaderChunk::kDefaultFrames
+constexpr SINT kDecodeFrames = 8192;
+
+// Seeking is followed by reading a few frames like when jumping to a cue
+constexpr SINT kSeekReadFrames = 64;
+
+struct SoundSourceBenchmarkCase {
+    QString filePath;
+    QString fileType;
+    mixxx::SoundSourceProviderPointer pProvider;
+    mixxx::SoundSourceProviderPriority providerPriority;
+};
+
+QString labelOf(const SoundSourceBenchmarkCase& benchmarkCase) {
+    return QStringLiteral("%1, %2, priority %3")
+            .arg(benchmarkCase.fileType,
+                    benchmarkCase.pProvider->getDisplayName(),
+                    QString::number(static_cast<int>(benchmarkCase.providerPriority)));
+}
+
+mixxx::SoundSourcePointer openSoundSource(
+        const SoundSourceBenchmarkCase& benchmarkCase) {
+    auto pSoundSource = benchmarkCase.pProvider->newSoundSource(
+            QUrl::fromLocalFile(benchmarkCase.filePath));
+    if (!pSoundSource ||
+            pSoundSource->open(mixxx::AudioSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams()) !=
+                    mixxx::AudioSource::OpenResult::Succeeded) {
+        return nullptr;
+    }
+    return pSoundSource;
+}
+
+void BM_SoundSourceOpen(benchmark::State& state,
+        const SoundSourceBenchmarkCase& benchmarkCase) {
+    state.SetLabel(labelOf(benchmarkCase).toStdString());
+    for (auto _ : state) {
+        auto pSoundSource = openSoundSource(benchmarkCase);
+        if (!pSoundSource) {
+            state.SkipWithError("Failed to open the file");
+            return;
+        }
+        state.PauseTiming();
+        pSoundSource->close();
+        pSoundSource.reset();
+        state.ResumeTiming();
+    }
+}
+
+void BM_SoundSourceDecode(benchmark::State& state,
+        const SoundSourceBenchmarkCase& benchmarkCase) {
+    state.SetLabel(labelOf(benchmarkCase).toStdString());
+    auto pSoundSource = openSoundSource(benchmarkCase);
+    if (!pSoundSource || pSoundSource->frameIndexRange().empty()) {
+        state.SkipWithError("Failed to open the file");
+        return;
+    }
+    mixxx::SampleBuffer buffer(
+            pSoundSource->getSignalInfo().frames2samples(kDecodeFrames));
+    const auto frameIndexRange = pSoundSource->frameIndexRange();
+    SINT frameIndex = frameIndexRange.start();
+    int64_t decodedFrames = 0;
+    for (auto _ : state) {
+        const auto readRange = mixxx::IndexRange::between(frameIndex,
+                std::min(frameIndex + kDecodeFrames, frameIndexRange.end()));
+        const auto readableFrames = pSoundSource->readSampleFrames(
+                mixxx::WritableSampleFrames(readRange,
+                        mixxx::SampleBuffer::WritableSlice(buffer.data(),
+                                pSoundSource->getSignalInfo().frames2samples(
+                                        readRange.length()))));
+        if (readableFrames.frameIndexRange().empty()) {
+            state.SkipWithError("Failed to decode the file");
+            break;
+        }
+        decodedFrames += readableFrames.frameLength();
+        frameIndex = readableFrames.frameIndexRange().end();
+        if (frameIndex >= frameIndexRange.end()) {
+            // Start over, which costs a single seek per pass
+            frameIndex = frameIndexRange.start();
+        }
+    }
+    state.counters["frames/s"] = benchmark::Counter(
+            static_cast<double>(decodedFrames), benchmark::Counter::kIsRate);
+    pSoundSource->close();
+}
+
+void BM_SoundSourceSeek(benchmark::State& state,
+        const SoundSourceBenchmarkCase& benchmarkCase) {
+    state.SetLabel(labelOf(benchmarkCase).toStdString());
+    auto pSoundSource = openSoundSource(benchmarkCase);
+    if (!pSoundSource || pSoundSource->frameLength() <= kSeekReadFrames) {
+        state.SkipWithError("Failed to open the file");
+        return;
+    }
+    mixxx::SampleBuffer buffer(
+            pSoundSource->getSignalInfo().frames2samples(kSeekReadFrames));
+    const auto frameIndexRange = pSoundSource->frameIndexRange();
+    // The same sequence of positions for all providers
+    std::minstd_rand randomEngine;
+    std::uniform_int_distribution<SINT> frameIndexDistribution(
+            frameIndexRange.start(), frameIndexRange.end() - kSeekReadFrames);
+    for (auto _ : state) {
+        const auto readRange = mixxx::IndexRange::forward(
+                frameIndexDistribution(randomEngine), kSeekReadFrames);
+        const auto readableFrames = pSoundSource->readSampleFrames(
+                mixxx::WritableSampleFrames(readRange,
+                        mixxx::SampleBuffer::WritableSlice(buffer)));
+        if (readableFrames.frameIndexRange().empty()) {
+            state.SkipWithError("Failed to decode the file after seeking");
+            break;
+        }
+    }
+    pSoundSource->close();
+}
+
+QFileInfoList supportedFiles(const QDir& dir, const QStringList& nameFilters) {
+    QFileInfoList files;
+    const auto entries = dir.entryInfoList(nameFilters, QDir::Files, QDir::Name);
+    for (const auto& fileInfo : entries) {
+        if (SoundSourceProxy::isFileNameSupported(fileInfo.fileName())) {
+            files.append(fileInfo);
+        }
+    }
+    return files;
+}
+
+} // anonymous namespace
+
+void registerSoundSourceBenchmarks() {
+    if (!SoundSourceProxy::isFileSuffixSupported(QStringLiteral("wav")) &&
+            !SoundSourceProxy::registerProviders()) {
+        return;
+    }
+    const QDir& testDir = MixxxTest::getOrInitTestDir();
+    QFileInfoList files = supportedFiles(
+            QDir(testDir.filePath(QStringLiteral("soundFileFormats"))),
+            QStringList());
+    if (files.isEmpty()) {
+        files = supportedFiles(
+                QDir(testDir.filePath(QStringLiteral("id3-test-data"))),
+                QStringList{QStringLiteral("cover-test*")});
+    }
+    for (const auto& fileInfo : std::as_const(files)) {
+        const QUrl url = QUrl::fromLocalFile(fileInfo.absoluteFilePath());
+        const auto registrations = SoundSourceProxy::allProviderRegistrationsForUrl(url);
+        for (const auto& registration : registrations) {
+            const SoundSourceBenchmarkCase benchmarkCase{
+                    fileInfo.absoluteFilePath(),
+                    fileInfo.suffix().toLower(),
+                    registration.getProvider(),
+                    registration.getProviderPriority()};
+            const QString name = QStringLiteral("/%1/%2").arg(
+                    fileInfo.fileName(),
+                    registration.getProvider()->getDisplayName());
+            benchmark::RegisterBenchmark(
+                    (QStringLiteral("BM_SoundSourceOpen") + name).toStdString().c_str(),
+                    BM_SoundSourceOpen,
+                    benchmarkCase)
+                    ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(
+                    (QStringLiteral("BM_SoundSourceDecode") + name).toStdString().c_str(),
+                    BM_SoundSourceDecode,
+                    benchmarkCase)
+                    ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(
+                    (QStringLiteral("BM_SoundSourceSeek") + name).toStdString().c_str(),
+                    BM_SoundSourceSeek,
+                    benchmarkCase)
+                    ->Unit(benchmark::kMicrosecond);
+        }
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+/// Registers the decoding benchmarks of all registered SoundSource providers
+/// for all test files that they support. The files and providers are only
+/// known at runtime, so the benchmarks need to be registered after the
+/// application has been initialized and before running the benchmarks.
+void registerSoundSourceBenchmarks();
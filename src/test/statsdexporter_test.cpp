@@ -0,0 +1,90 @@
+#include "util/statsdexporter.h"
+
+#include <gtest/gtest.h>
+
+namespace mixxx {
+
+namespace {
+
+class StatsdExporterTest : public testing::Test {
+  protected:
+    StatsdExporterTest()
+            : m_exporter(QHostAddress::LocalHost, 8125) {
+    }
+
+    void report(const QString& tag,
+            Stat::StatType type,
+            Stat::ComputeFlags compute,
+            double value) {
+        Stat& stat = m_stats[tag];
+        stat.m_tag = tag;
+        stat.m_type = type;
+        stat.m_compute = compute;
+        StatReport statReport;
+        statReport.tag = tag;
+        statReport.time = 0;
+        statReport.type = type;
+        statReport.compute = compute;
+        statReport.value = value;
+        stat.processReport(statReport);
+    }
+
+    StatsdExporter m_exporter;
+    QMap<QString, Stat> m_stats;
+};
+
+TEST_F(StatsdExporterTest, MetricName) {
+    EXPECT_EQ(QByteArray("mixxx.EngineMixer_process"),
+            StatsdExporter::metricName(QStringLiteral("mixxx"),
+                    QStringLiteral("EngineMixer::process")));
+    EXPECT_EQ(QByteArray("mixxx.CachingReader_chunk_hits"),
+            StatsdExporter::metricName(QStringLiteral("mixxx"),
+                    QStringLiteral("CachingReader chunk hits ")));
+}
+
+TEST_F(StatsdExporterTest, CounterIncrements) {
+    const QString tag = QStringLiteral("counter");
+    report(tag, Stat::COUNTER, Stat::COUNT | Stat::SUM, 3);
+    report(tag, Stat::COUNTER, Stat::COUNT | Stat::SUM, 2);
+    EXPECT_EQ(QList<QByteArray>{"mixxx.counter:5|c"}, m_exporter.formatStats(m_stats));
+
+    // Unchanged stats are not exported again
+    EXPECT_TRUE(m_exporter.formatStats(m_stats).isEmpty());
+
+    report(tag, Stat::COUNTER, Stat::COUNT | Stat::SUM, 4);
+    EXPECT_EQ(QList<QByteArray>{"mixxx.counter:4|c"}, m_exporter.formatStats(m_stats));
+}
+
+TEST_F(StatsdExporterTest, DurationInMillis) {
+    const QString tag = QStringLiteral("duration");
+    const Stat::ComputeFlags compute = Stat::COUNT | Stat::AVERAGE |
+            Stat::MIN | Stat::MAX | Stat::HISTOGRAM;
+    for (int i = 1; i <= 100; ++i) {
+        report(tag, Stat::DURATION_NANOSEC, compute, i * 1000000.0);
+    }
+    const QList<QByteArray> expectedLines{
+            "mixxx.duration.count:100|c",
+            "mixxx.duration.avg:50.5|g",
+            "mixxx.duration.min:1|g",
+            "mixxx.duration.max:100|g",
+            "mixxx.duration.p50:50|g",
+            "mixxx.duration.p99:99|g",
+    };
+    EXPECT_EQ(expectedLines, m_exporter.formatStats(m_stats));
+}
+
+TEST_F(StatsdExporterTest, ParseTarget) {
+    QHostAddress address;
+    quint16 port = 0;
+    EXPECT_TRUE(StatsdExporter::parseTarget(QStringLiteral("127.0.0.1:8125"), &address, &port));
+    EXPECT_EQ(QHostAddress(QHostAddress::LocalHost), address);
+    EXPECT_EQ(8125, port);
+
+    EXPECT_FALSE(StatsdExporter::parseTarget(QStringLiteral("127.0.0.1"), &address, &port));
+    EXPECT_FALSE(StatsdExporter::parseTarget(QStringLiteral("127.0.0.1:0"), &address, &port));
+    EXPECT_FALSE(StatsdExporter::parseTarget(QStringLiteral(":8125"), &address, &port));
+}
+
+} // namespace
+
+} // namespace mixxx
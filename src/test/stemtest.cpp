@@ -152,4 +152,43 @@ TEST_F(StemTest, OpenStem) {
             sourceStem.getSignalInfo());
 }
 
+TEST_F(StemTest, SelectChannelPairs) {
+    SoundSourceSTEM sourceStem(QUrl::fromLocalFile(getTestDir().filePath("stems/test.stem.mp4")));
+
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(mixxx::audio::ChannelCount(8));
+    ASSERT_EQ(sourceStem.open(AudioSource::OpenMode::Strict, config),
+            AudioSource::OpenResult::Succeeded);
+
+    EXPECT_EQ(AudioSource::kAllChannelPairs, sourceStem.selectChannelPairs(0b1111));
+    EXPECT_EQ(AudioSource::kPremixedChannelPairs,
+            sourceStem.selectChannelPairs(AudioSource::kPremixedChannelPairs));
+
+    // The main mix is decoded into the first stem, all other stems are silent
+    SampleBuffer buffer(512 * 8);
+    ASSERT_EQ(sourceStem.readSampleFrames(WritableSampleFrames(
+                                                  IndexRange::between(0, 512),
+                                                  SampleBuffer::WritableSlice(buffer)))
+                      .readableLength(),
+            buffer.size());
+    for (SINT i = 0; i < buffer.size(); ++i) {
+        if (i % 8 >= 2) {
+            EXPECT_EQ(CSAMPLE_ZERO, buffer[i]);
+        }
+    }
+
+    // Only the selected stems are decoded
+    EXPECT_EQ(AudioSource::ChannelPairs{0b0100}, sourceStem.selectChannelPairs(0b0100));
+    ASSERT_EQ(sourceStem.readSampleFrames(WritableSampleFrames(
+                                                  IndexRange::between(0, 512),
+                                                  SampleBuffer::WritableSlice(buffer)))
+                      .readableLength(),
+            buffer.size());
+    for (SINT i = 0; i < buffer.size(); ++i) {
+        if (i % 8 < 4 || i % 8 >= 6) {
+            EXPECT_EQ(CSAMPLE_ZERO, buffer[i]);
+        }
+    }
+}
+
 } // namespace
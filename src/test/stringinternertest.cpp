@@ -0,0 +1,31 @@
+#include "util/stringinterner.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(StringInternerTest, SharesEqualStrings) {
+    StringInterner interner;
+    const QString first = interner.intern(QString("Artist"));
+    const QString second = interner.intern(QString("Artist"));
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.constData(), second.constData());
+    EXPECT_NE(first.constData(),
+            interner.intern(QString("Other Artist")).constData());
+    EXPECT_EQ(2, interner.size());
+}
+
+TEST(StringInternerTest, PurgeUnreferencedStrings) {
+    StringInterner interner;
+    const QString referenced = interner.intern(QString("Referenced"));
+    interner.intern(QString("Unreferenced"));
+    interner.intern(QString());
+    EXPECT_EQ(2, interner.size());
+
+    interner.purge();
+    EXPECT_EQ(1, interner.size());
+    EXPECT_EQ(referenced.constData(),
+            interner.intern(QString("Referenced")).constData());
+}
+
+} // namespace
@@ -0,0 +1,71 @@
+#include "util/threadplacement.h"
+
+#include <gtest/gtest.h>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+using mixxx::ThreadPlacement;
+
+class ThreadPlacementTest : public MixxxTest {
+  protected:
+    void TearDown() override {
+        // Reset the placement of all roles for the following tests
+        for (int i = 0; i < ThreadPlacement::kNumRoles; ++i) {
+            const QString name = ThreadPlacement::roleName(
+                    static_cast<ThreadPlacement::Role>(i));
+            config()->remove(ConfigKey("[ThreadPlacement]", name + "Priority"));
+            config()->remove(ConfigKey("[ThreadPlacement]", name + "Cpus"));
+        }
+        ThreadPlacement::init(config());
+    }
+};
+
+TEST_F(ThreadPlacementTest, ParsePriorityClass) {
+    EXPECT_EQ(ThreadPlacement::PriorityClass::Default,
+            ThreadPlacement::parsePriorityClass(QString()));
+    EXPECT_EQ(ThreadPlacement::PriorityClass::Low,
+            ThreadPlacement::parsePriorityClass("low"));
+    EXPECT_EQ(ThreadPlacement::PriorityClass::High,
+            ThreadPlacement::parsePriorityClass(" High "));
+    EXPECT_EQ(ThreadPlacement::PriorityClass::Realtime,
+            ThreadPlacement::parsePriorityClass("realtime"));
+    EXPECT_FALSE(ThreadPlacement::parsePriorityClass("urgent"));
+}
+
+TEST_F(ThreadPlacementTest, ParseCpuList) {
+    EXPECT_EQ(QList<int>(), ThreadPlacement::parseCpuList(""));
+    EXPECT_EQ(QList<int>({0, 2, 3, 4}), ThreadPlacement::parseCpuList("3-4, 0,2,3"));
+    EXPECT_FALSE(ThreadPlacement::parseCpuList("1,a"));
+    EXPECT_FALSE(ThreadPlacement::parseCpuList("4-2"));
+    EXPECT_FALSE(ThreadPlacement::parseCpuList("-1"));
+    EXPECT_FALSE(ThreadPlacement::parseCpuList("1-2-3"));
+    EXPECT_FALSE(ThreadPlacement::parseCpuList("0-100000"));
+}
+
+TEST_F(ThreadPlacementTest, ReadsConfig) {
+    config()->setValue(ConfigKey("[ThreadPlacement]", "AudioPriority"),
+            QStringLiteral("realtime"));
+    config()->setValue(ConfigKey("[ThreadPlacement]", "AudioCpus"), QStringLiteral("2-3"));
+    config()->setValue(ConfigKey("[ThreadPlacement]", "AnalysisPriority"),
+            QStringLiteral("bogus"));
+    config()->setValue(ConfigKey("[ThreadPlacement]", "AnalysisCpus"), QStringLiteral("0"));
+    ThreadPlacement::init(config());
+
+    const auto audio = ThreadPlacement::placement(ThreadPlacement::Role::Audio);
+    EXPECT_EQ(ThreadPlacement::PriorityClass::Realtime, audio.priority);
+    EXPECT_EQ(QList<int>({2, 3}), audio.cpus);
+    EXPECT_TRUE(ThreadPlacement::hasConfiguredPriority(ThreadPlacement::Role::Audio));
+
+    // An invalid priority is ignored without dropping the CPUs
+    const auto analysis = ThreadPlacement::placement(ThreadPlacement::Role::Analysis);
+    EXPECT_EQ(ThreadPlacement::PriorityClass::Default, analysis.priority);
+    EXPECT_EQ(QList<int>({0}), analysis.cpus);
+
+    EXPECT_FALSE(ThreadPlacement::hasConfiguredPriority(ThreadPlacement::Role::RubberBand));
+    // Without any configuration placing a thread is a no-op
+    EXPECT_TRUE(ThreadPlacement::applyToCurrentThread(ThreadPlacement::Role::RubberBand));
+}
+
+} // namespace
@@ -56,3 +56,142 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, getTrackFields) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    mixxx::FileInfo file1(QDir(QDir::tempPath()), QStringLiteral("file1.mp3"));
+    mixxx::FileInfo file2(QDir(QDir::tempPath()), QStringLiteral("file2.mp3"));
+
+    TrackPointer pTrack1 = Track::newTemporary(mixxx::FileAccess(file1));
+    TrackPointer pTrack2 = Track::newTemporary(mixxx::FileAccess(file2));
+    pTrack1->setTitle(QStringLiteral("Title 1"));
+    pTrack2->setTitle(QStringLiteral("Title 2"));
+
+    const TrackId trackId1 = internalCollection()->addTrack(pTrack1, false);
+    const TrackId trackId2 = internalCollection()->addTrack(pTrack2, false);
+    const TrackId missingTrackId(QVariant(trackId2.toVariant().toInt() + 1));
+
+    const auto fields = trackDAO.getTrackFields(
+            QSet<TrackId>{trackId1, trackId2, missingTrackId},
+            {QStringLiteral("track_locations.location"), QStringLiteral("title")});
+    ASSERT_EQ(2, fields.size());
+    EXPECT_EQ((QVariantList{file1.location(), QStringLiteral("Title 1")}),
+            fields.value(trackId1));
+    EXPECT_EQ((QVariantList{file2.location(), QStringLiteral("Title 2")}),
+            fields.value(trackId2));
+    EXPECT_FALSE(fields.contains(missingTrackId));
+
+    EXPECT_TRUE(trackDAO.getTrackFields({}, {QStringLiteral("title")}).isEmpty());
+}
+
+TEST_F(TrackDAOTest, saveTracksInBatch) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    mixxx::FileInfo file1(QDir(QDir::tempPath()), QStringLiteral("file1.mp3"));
+    mixxx::FileInfo file2(QDir(QDir::tempPath()), QStringLiteral("file2.mp3"));
+
+    TrackPointer pTrack1 = Track::newTemporary(mixxx::FileAccess(file1));
+    TrackPointer pTrack2 = Track::newTemporary(mixxx::FileAccess(file2));
+    const TrackId trackId1 = internalCollection()->addTrack(pTrack1, false);
+    const TrackId trackId2 = internalCollection()->addTrack(pTrack2, false);
+    pTrack1->setTitle(QStringLiteral("Title 1"));
+    pTrack2->setTitle(QStringLiteral("Title 2"));
+
+    QSet<TrackId> cleanTrackIds;
+    QObject::connect(&trackDAO,
+            &TrackDAO::tracksClean,
+            [&cleanTrackIds](const QSet<TrackId>& trackIds) {
+                cleanTrackIds += trackIds;
+            });
+
+    trackDAO.beginSaveTracks();
+    EXPECT_TRUE(trackDAO.saveTrack(pTrack1.get()));
+    EXPECT_TRUE(trackDAO.saveTrack(pTrack2.get()));
+    // Notified once after all tracks have been committed
+    EXPECT_TRUE(cleanTrackIds.isEmpty());
+    EXPECT_TRUE(pTrack1->isDirty());
+    EXPECT_TRUE(pTrack2->isDirty());
+    trackDAO.finishSaveTracks();
+    EXPECT_THAT(cleanTrackIds, UnorderedElementsAre(trackId1, trackId2));
+    EXPECT_FALSE(pTrack1->isDirty());
+    EXPECT_FALSE(pTrack2->isDirty());
+
+    const auto fields = trackDAO.getTrackFields(
+            QSet<TrackId>{trackId1, trackId2},
+            {QStringLiteral("title")});
+    EXPECT_EQ(QVariantList{QStringLiteral("Title 1")}, fields.value(trackId1));
+    EXPECT_EQ(QVariantList{QStringLiteral("Title 2")}, fields.value(trackId2));
+}
+
+TEST_F(TrackDAOTest, saveCuesInBatch) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    mixxx::FileInfo file1(QDir(QDir::tempPath()), QStringLiteral("file1.mp3"));
+    mixxx::FileInfo file2(QDir(QDir::tempPath()), QStringLiteral("file2.mp3"));
+
+    TrackPointer pTrack1 = Track::newTemporary(mixxx::FileAccess(file1));
+    TrackPointer pTrack2 = Track::newTemporary(mixxx::FileAccess(file2));
+    const auto pRemovedCue = pTrack1->createAndAddCue(mixxx::CueType::HotCue,
+            0,
+            mixxx::audio::FramePos(1000),
+            mixxx::audio::kInvalidFramePos);
+    const auto pChangedCue = pTrack1->createAndAddCue(mixxx::CueType::HotCue,
+            1,
+            mixxx::audio::FramePos(2000),
+            mixxx::audio::kInvalidFramePos);
+    const auto pUnchangedCue = pTrack2->createAndAddCue(mixxx::CueType::HotCue,
+            0,
+            mixxx::audio::FramePos(3000),
+            mixxx::audio::kInvalidFramePos);
+    const TrackId trackId1 = internalCollection()->addTrack(pTrack1, false);
+    const TrackId trackId2 = internalCollection()->addTrack(pTrack2, false);
+    ASSERT_TRUE(pChangedCue->getId().isValid());
+    const DbId unchangedCueId = pUnchangedCue->getId();
+    ASSERT_TRUE(unchangedCueId.isValid());
+
+    pTrack1->removeCue(pRemovedCue);
+    pChangedCue->setStartPosition(mixxx::audio::FramePos(2500));
+    const auto pNewCue1 = pTrack1->createAndAddCue(mixxx::CueType::HotCue,
+            2,
+            mixxx::audio::FramePos(4000),
+            mixxx::audio::kInvalidFramePos);
+    const auto pNewCue2 = pTrack2->createAndAddCue(mixxx::CueType::HotCue,
+            1,
+            mixxx::audio::FramePos(5000),
+            mixxx::audio::kInvalidFramePos);
+
+    trackDAO.beginSaveTracks();
+    EXPECT_TRUE(trackDAO.saveTrack(pTrack1.get()));
+    EXPECT_TRUE(trackDAO.saveTrack(pTrack2.get()));
+    trackDAO.finishSaveTracks();
+
+    EXPECT_TRUE(pNewCue1->getId().isValid());
+    EXPECT_TRUE(pNewCue2->getId().isValid());
+    EXPECT_NE(pNewCue1->getId(), pNewCue2->getId());
+    EXPECT_EQ(unchangedCueId, pUnchangedCue->getId());
+    EXPECT_FALSE(pChangedCue->isDirty());
+    EXPECT_FALSE(pNewCue1->isDirty());
+
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "SELECT id, track_id, position FROM cues ORDER BY position")));
+    QList<QVariantList> rows;
+    while (query.next()) {
+        rows.append(QVariantList{
+                query.value(0).toInt(),
+                query.value(1).toInt(),
+                query.value(2).toDouble()});
+    }
+    const auto row = [](DbId id, TrackId trackId, double framePos) {
+        return QVariantList{id.toVariant().toInt(),
+                trackId.toVariant().toInt(),
+                framePos * mixxx::kEngineChannelOutputCount};
+    };
+    EXPECT_EQ((QList<QVariantList>{
+                      row(pChangedCue->getId(), trackId1, 2500),
+                      row(unchangedCueId, trackId2, 3000),
+                      row(pNewCue1->getId(), trackId1, 4000),
+                      row(pNewCue2->getId(), trackId2, 5000)}),
+            rows);
+}
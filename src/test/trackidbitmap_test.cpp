@@ -0,0 +1,80 @@
+#include "library/trackset/trackidbitmap.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TrackId trackIdOf(int value) {
+    return TrackId(QVariant(value));
+}
+
+TEST(TrackIdBitmapTest, insertAndRemove) {
+    TrackIdBitmap bitmap;
+    EXPECT_TRUE(bitmap.isEmpty());
+    EXPECT_FALSE(bitmap.contains(trackIdOf(1)));
+
+    EXPECT_TRUE(bitmap.insert(trackIdOf(1)));
+    EXPECT_FALSE(bitmap.insert(trackIdOf(1)));
+    EXPECT_TRUE(bitmap.insert(trackIdOf(70000)));
+    EXPECT_EQ(2, bitmap.size());
+    EXPECT_TRUE(bitmap.contains(trackIdOf(1)));
+    EXPECT_TRUE(bitmap.contains(trackIdOf(70000)));
+    EXPECT_FALSE(bitmap.contains(trackIdOf(2)));
+    EXPECT_FALSE(bitmap.contains(TrackId()));
+
+    EXPECT_TRUE(bitmap.remove(trackIdOf(1)));
+    EXPECT_FALSE(bitmap.remove(trackIdOf(1)));
+    EXPECT_FALSE(bitmap.contains(trackIdOf(1)));
+    EXPECT_EQ(1, bitmap.size());
+
+    bitmap.clear();
+    EXPECT_TRUE(bitmap.isEmpty());
+    EXPECT_FALSE(bitmap.contains(trackIdOf(70000)));
+}
+
+TEST(TrackIdBitmapTest, convertBetweenArrayAndBitmap) {
+    // Exceed the maximum size of an array chunk
+    constexpr int kCount = 10000;
+    TrackIdBitmap bitmap;
+    for (int i = 1; i <= kCount; ++i) {
+        ASSERT_TRUE(bitmap.insert(trackIdOf(2 * i)));
+    }
+    EXPECT_EQ(kCount, bitmap.size());
+    for (int i = 1; i <= kCount; ++i) {
+        EXPECT_TRUE(bitmap.contains(trackIdOf(2 * i)));
+        EXPECT_FALSE(bitmap.contains(trackIdOf(2 * i + 1)));
+    }
+
+    // Shrink below the minimum size of a bitmap chunk
+    for (int i = 1; i <= kCount - 100; ++i) {
+        ASSERT_TRUE(bitmap.remove(trackIdOf(2 * i)));
+    }
+    EXPECT_EQ(100, bitmap.size());
+    EXPECT_FALSE(bitmap.contains(trackIdOf(2)));
+    EXPECT_TRUE(bitmap.contains(trackIdOf(2 * kCount)));
+}
+
+TEST(TrackIdBitmapTest, toListAndCountContained) {
+    const QList<TrackId> trackIds = {
+            trackIdOf(3),
+            trackIdOf(5),
+            trackIdOf(65536),
+            trackIdOf(200000),
+    };
+    TrackIdBitmap bitmap;
+    // Insert in reverse order
+    for (auto it = trackIds.crbegin(); it != trackIds.crend(); ++it) {
+        bitmap.insert(*it);
+    }
+    EXPECT_EQ(trackIds, bitmap.toList());
+
+    EXPECT_EQ(2,
+            bitmap.countContained({
+                    trackIdOf(1),
+                    trackIdOf(5),
+                    trackIdOf(200000),
+            }));
+    EXPECT_EQ(0, bitmap.countContained({}));
+}
+
+} // namespace
@@ -0,0 +1,95 @@
+#include "library/trackinfocolumns.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+
+namespace {
+
+class TrackInfoColumnsTest : public testing::Test {
+  protected:
+    TrackInfoColumnsTest()
+            : m_columns(3) {
+    }
+
+    TrackInfoColumns m_columns;
+};
+
+TEST_F(TrackInfoColumnsTest, TypedValues) {
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+    const int row1 = m_columns.insert(trackId1);
+    const int row2 = m_columns.insert(trackId2);
+    EXPECT_EQ(row1, m_columns.insert(trackId1));
+    EXPECT_EQ(2, m_columns.size());
+
+    m_columns.setValue(row1, 0, QVariant(QStringLiteral("Artist")));
+    m_columns.setValue(row2, 0, QVariant(QStringLiteral("Artist")));
+    m_columns.setValue(row1, 1, QVariant(qlonglong(42)));
+    // Integers of a different type are returned with the column type
+    m_columns.setValue(row2, 1, QVariant(7));
+    m_columns.setValue(row1, 2, QVariant(128.5));
+
+    EXPECT_EQ(QVariant(QStringLiteral("Artist")), m_columns.value(trackId1, 0));
+    EXPECT_EQ(QVariant(QStringLiteral("Artist")), m_columns.value(trackId2, 0));
+    EXPECT_EQ(QVariant(qlonglong(42)), m_columns.value(trackId1, 1));
+    EXPECT_EQ(QVariant(qlonglong(7)), m_columns.value(trackId2, 1));
+    EXPECT_EQ(QVariant(128.5), m_columns.value(trackId1, 2));
+
+    // Unset values are null
+    EXPECT_TRUE(m_columns.value(trackId2, 2).isNull());
+    // Unknown tracks and columns are invalid
+    EXPECT_FALSE(m_columns.value(TrackId(QVariant(3)), 0).isValid());
+    EXPECT_FALSE(m_columns.value(trackId1, 3).isValid());
+}
+
+TEST_F(TrackInfoColumnsTest, NullValuesKeepTheirType) {
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+    const int row1 = m_columns.insert(trackId1);
+    const int row2 = m_columns.insert(trackId2);
+
+    m_columns.setValue(row1, 0, QVariant(QMetaType(QMetaType::QString)));
+    m_columns.setValue(row2, 0, QVariant(QStringLiteral("Title")));
+    EXPECT_TRUE(m_columns.value(trackId1, 0).isNull());
+    EXPECT_EQ(QMetaType(QMetaType::QString), m_columns.value(trackId1, 0).metaType());
+
+    m_columns.setValue(row2, 0, QVariant(QMetaType(QMetaType::QString)));
+    EXPECT_TRUE(m_columns.value(trackId2, 0).isNull());
+}
+
+TEST_F(TrackInfoColumnsTest, MixedTypesFallBackToVariants) {
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+    const int row1 = m_columns.insert(trackId1);
+    const int row2 = m_columns.insert(trackId2);
+
+    m_columns.setValue(row1, 0, QVariant(1.5));
+    m_columns.setValue(row2, 0, QVariant(QStringLiteral("text")));
+    EXPECT_EQ(QVariant(1.5), m_columns.value(trackId1, 0));
+    EXPECT_EQ(QVariant(QStringLiteral("text")), m_columns.value(trackId2, 0));
+
+    const QDateTime dateTime = QDateTime::fromSecsSinceEpoch(1000000000);
+    m_columns.setValue(row1, 1, QVariant(dateTime));
+    EXPECT_EQ(QVariant(dateTime), m_columns.value(trackId1, 1));
+}
+
+TEST_F(TrackInfoColumnsTest, RemovedRowsAreReused) {
+    const TrackId trackId1(QVariant(1));
+    const TrackId trackId2(QVariant(2));
+    const int row1 = m_columns.insert(trackId1);
+    m_columns.setValue(row1, 0, QVariant(QStringLiteral("Removed")));
+
+    m_columns.remove(trackId1);
+    EXPECT_FALSE(m_columns.contains(trackId1));
+    EXPECT_EQ(0, m_columns.size());
+
+    EXPECT_EQ(row1, m_columns.insert(trackId2));
+    EXPECT_TRUE(m_columns.value(trackId2, 0).isNull());
+
+    m_columns.clear();
+    EXPECT_FALSE(m_columns.contains(trackId2));
+    EXPECT_EQ(0, m_columns.insert(trackId1));
+}
+
+} // namespace
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+class TrackSnapshotTest : public MixxxTest {
+};
+
+TEST_F(TrackSnapshotTest, publishModifications) {
+    const TrackPointer pTrack = Track::newTemporary();
+    const auto pInitialSnapshot = pTrack->getSnapshot();
+    ASSERT_NE(nullptr, pInitialSnapshot);
+    EXPECT_EQ(nullptr, pInitialSnapshot->pBeats);
+    EXPECT_TRUE(pInitialSnapshot->cuePoints.isEmpty());
+
+    pTrack->setDuration(120.0);
+    pTrack->setReplayGain(mixxx::ReplayGain(0.5, 0.25));
+    const auto pCue = pTrack->createAndAddCue(mixxx::CueType::HotCue,
+            0,
+            mixxx::audio::FramePos(1000),
+            mixxx::audio::kInvalidFramePos);
+
+    const auto pSnapshot = pTrack->getSnapshot();
+    EXPECT_EQ(120.0, pSnapshot->duration.toDoubleSeconds());
+    EXPECT_EQ(mixxx::ReplayGain(0.5, 0.25), pSnapshot->replayGain);
+    EXPECT_EQ(QList<CuePointer>{pCue}, pSnapshot->cuePoints);
+    EXPECT_EQ(120.0, pTrack->getDuration());
+    EXPECT_EQ(pSnapshot->cuePoints, pTrack->getCuePoints());
+
+    // Snapshots that have been obtained before are not modified
+    EXPECT_EQ(mixxx::Duration::empty(), pInitialSnapshot->duration);
+    EXPECT_TRUE(pInitialSnapshot->cuePoints.isEmpty());
+}
+
+TEST_F(TrackSnapshotTest, keepSnapshotIfUnmodified) {
+    const TrackPointer pTrack = Track::newTemporary();
+    pTrack->setDuration(120.0);
+    const auto pSnapshot = pTrack->getSnapshot();
+
+    // Properties that are not part of the snapshot
+    pTrack->setTitle(QStringLiteral("Title"));
+    pTrack->markDirty();
+    pTrack->markClean();
+
+    EXPECT_EQ(pSnapshot, pTrack->getSnapshot());
+}
@@ -0,0 +1,90 @@
+#include "waveform/waveformcache.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const QString kVersion = QStringLiteral("Test");
+
+constexpr auto kWaveform = WaveformCache::Type::Waveform;
+
+ConstWaveformPointer createWaveform() {
+    auto pWaveform = WaveformPointer::create(44100, 44100, 441, -1);
+    pWaveform->setVersion(kVersion);
+    return pWaveform;
+}
+
+class WaveformCacheTest : public testing::Test {
+  protected:
+    const TrackId m_trackId1{QVariant(1)};
+    const TrackId m_trackId2{QVariant(2)};
+    const TrackId m_trackId3{QVariant(3)};
+};
+
+TEST_F(WaveformCacheTest, LookupByVersion) {
+    WaveformCache cache;
+    const ConstWaveformPointer pWaveform = createWaveform();
+    cache.insert(m_trackId1, kWaveform, pWaveform);
+
+    EXPECT_EQ(pWaveform, cache.lookup(m_trackId1, kWaveform, kVersion));
+    EXPECT_TRUE(cache.lookup(m_trackId1, WaveformCache::Type::Summary, kVersion).isNull());
+    EXPECT_TRUE(cache.lookup(m_trackId2, kWaveform, kVersion).isNull());
+    // Another version invalidates the entry
+    EXPECT_TRUE(cache.lookup(m_trackId1, kWaveform, QStringLiteral("Other")).isNull());
+    EXPECT_TRUE(cache.lookup(m_trackId1, kWaveform, kVersion).isNull());
+    EXPECT_EQ(0u, cache.bytesInUse());
+}
+
+TEST_F(WaveformCacheTest, KeepsWaveformsAlive) {
+    WaveformCache cache;
+    cache.insert(m_trackId1, kWaveform, createWaveform());
+    EXPECT_FALSE(cache.lookup(m_trackId1, kWaveform, kVersion).isNull());
+    EXPECT_GT(cache.bytesInUse(), 0u);
+
+    cache.remove(m_trackId1);
+    EXPECT_TRUE(cache.lookup(m_trackId1, kWaveform, kVersion).isNull());
+    EXPECT_EQ(0u, cache.bytesInUse());
+}
+
+TEST_F(WaveformCacheTest, EvictsLeastRecentlyUsed) {
+    const std::size_t waveformBytes = WaveformCache::memoryUsageOf(*createWaveform());
+    WaveformCache cache(2 * waveformBytes);
+    cache.insert(m_trackId1, kWaveform, createWaveform());
+    cache.insert(m_trackId2, kWaveform, createWaveform());
+    // Track 1 is used more recently than track 2
+    ASSERT_FALSE(cache.lookup(m_trackId1, kWaveform, kVersion).isNull());
+    cache.insert(m_trackId3, kWaveform, createWaveform());
+
+    EXPECT_EQ(2 * waveformBytes, cache.bytesInUse());
+    EXPECT_TRUE(cache.lookup(m_trackId2, kWaveform, kVersion).isNull());
+    EXPECT_FALSE(cache.lookup(m_trackId1, kWaveform, kVersion).isNull());
+    EXPECT_FALSE(cache.lookup(m_trackId3, kWaveform, kVersion).isNull());
+}
+
+TEST_F(WaveformCacheTest, ShrinksToMaxBytes) {
+    const std::size_t waveformBytes = WaveformCache::memoryUsageOf(*createWaveform());
+    WaveformCache cache(2 * waveformBytes);
+    cache.insert(m_trackId1, kWaveform, createWaveform());
+    cache.insert(m_trackId2, kWaveform, createWaveform());
+    ASSERT_EQ(2 * waveformBytes, cache.bytesInUse());
+
+    cache.setMaxBytes(waveformBytes);
+    EXPECT_EQ(waveformBytes, cache.bytesInUse());
+    EXPECT_TRUE(cache.lookup(m_trackId1, kWaveform, kVersion).isNull());
+    EXPECT_FALSE(cache.lookup(m_trackId2, kWaveform, kVersion).isNull());
+}
+
+TEST_F(WaveformCacheTest, SharesEvictedWaveformsWhileOwned) {
+    const ConstWaveformPointer pOwned = createWaveform();
+    WaveformCache cache(WaveformCache::memoryUsageOf(*pOwned));
+    cache.insert(m_trackId1, kWaveform, pOwned);
+    cache.insert(m_trackId2, kWaveform, createWaveform());
+
+    // Evicted from the memory limit, but still owned by someone else
+    EXPECT_EQ(pOwned, cache.lookup(m_trackId1, kWaveform, kVersion));
+    EXPECT_EQ(WaveformCache::memoryUsageOf(*pOwned), cache.bytesInUse());
+    // Track 2 has been evicted and has no other owner
+    EXPECT_TRUE(cache.lookup(m_trackId2, kWaveform, kVersion).isNull());
+}
+
+} // namespace
@@ -0,0 +1,56 @@
+#include "waveform/waveformframeratethrottle.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class WaveformFrameRateThrottleTest : public testing::Test {
+  protected:
+    WaveformFrameRateThrottle m_throttle{60};
+};
+
+TEST_F(WaveformFrameRateThrottleTest, FrameRateFollowsAudioLatencyUsage) {
+    EXPECT_FALSE(m_throttle.update(0.2, 0.1));
+    EXPECT_EQ(60, m_throttle.frameRate());
+    EXPECT_FALSE(m_throttle.isThrottled());
+
+    // High usage reduces the frame rate step by step down to the minimum
+    EXPECT_TRUE(m_throttle.update(0.9, 0.1));
+    EXPECT_EQ(60 - WaveformFrameRateThrottle::kFrameRateStep, m_throttle.frameRate());
+    EXPECT_TRUE(m_throttle.isThrottled());
+    for (int i = 0; i < 20; ++i) {
+        m_throttle.update(0.9, 0.1);
+    }
+    EXPECT_EQ(WaveformFrameRateThrottle::kMinFrameRate, m_throttle.frameRate());
+
+    // Moderate usage keeps the frame rate
+    EXPECT_FALSE(m_throttle.update(0.6, 0.1));
+    EXPECT_EQ(WaveformFrameRateThrottle::kMinFrameRate, m_throttle.frameRate());
+
+    // Low usage restores the configured frame rate
+    for (int i = 0; i < 20; ++i) {
+        m_throttle.update(0.2, 0.1);
+    }
+    EXPECT_EQ(60, m_throttle.frameRate());
+    EXPECT_FALSE(m_throttle.isThrottled());
+}
+
+TEST_F(WaveformFrameRateThrottleTest, FrameRateFollowsRenderLoad) {
+    EXPECT_TRUE(m_throttle.update(0.2, 0.8));
+    EXPECT_TRUE(m_throttle.isThrottled());
+
+    // Both measurements need to be low to recover
+    EXPECT_FALSE(m_throttle.update(0.2, 0.4));
+    EXPECT_TRUE(m_throttle.update(0.2, 0.1));
+    EXPECT_FALSE(m_throttle.isThrottled());
+}
+
+TEST_F(WaveformFrameRateThrottleTest, ConfiguredFrameRateIsNotExceeded) {
+    m_throttle.setConfiguredFrameRate(10);
+    EXPECT_FALSE(m_throttle.update(0.9, 0.9));
+    EXPECT_EQ(10, m_throttle.frameRate());
+    EXPECT_FALSE(m_throttle.update(0.2, 0.1));
+    EXPECT_EQ(10, m_throttle.frameRate());
+}
+
+} // namespace
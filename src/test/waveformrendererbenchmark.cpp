@@ -0,0 +1,266 @@
+#include <benchmark/benchmark.h>
+
+#include <QDomDocument>
+#include <QImage>
+#include <QPainter>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "control/controlobject.h"
+#include "skin/legacy/skincontext.h"
+#include "track/track.h"
+#include "util/performancetimer.h"
+#include "waveform/renderers/waveformrendererfilteredsignal.h"
+#include "waveform/renderers/waveformrendererhsv.h"
+#include "waveform/renderers/waveformrendererrgb.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/visualplayposition.h"
+#include "waveform/waveform.h"
+#include "waveform/waveformwidgetfactory.h"
+
+// Renders the software waveform renderers offscreen into a QImage, so their
+// frame times can be compared between renderer types, zoom levels and deck
+// counts. Run them with
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_RenderWaveform
+//
+// or build the mixxx-waveform-benchmark target.
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kTrackSeconds = 300;
+constexpr int kVisualSampleRate = 441;
+constexpr int kFramesPerSecond = 60;
+constexpr int kWidth = 1024;
+constexpr int kHeight = 128;
+
+const QString kEffectGroupFormat = QStringLiteral("[EqualizerRack1_%1_Effect1]");
+
+/// Creates a waveform of a track with a beat every 0.5 s and slowly
+/// changing bands, which is cheap to generate but not trivial to draw.
+WaveformPointer createSyntheticWaveform() {
+    constexpr SINT frameLength = kTrackSeconds * kSampleRate;
+    auto pWaveform = WaveformPointer(
+            new Waveform(kSampleRate, frameLength, kVisualSampleRate, -1));
+    WaveformData* pData = pWaveform->data();
+    const int dataSize = pWaveform->getDataSize();
+    for (int i = 0; i < dataSize; ++i) {
+        const int visualFrame = i / 2;
+        const int beatPhase = visualFrame % (kVisualSampleRate / 2);
+        const int envelope = std::max(0, 255 - 4 * beatPhase);
+        pData[i].filtered.low = static_cast<unsigned char>(envelope);
+        pData[i].filtered.mid = static_cast<unsigned char>((visualFrame * 7) % 160);
+        pData[i].filtered.high = static_cast<unsigned char>((visualFrame * 13) % 96);
+        pData[i].filtered.all = static_cast<unsigned char>(
+                std::max(envelope, (visualFrame * 7) % 160));
+    }
+    pWaveform->setCompletion(dataSize);
+    pWaveform->buildMipLevels();
+    return pWaveform;
+}
+
+/// The controls, the track and the renderer of a single deck.
+class BenchmarkDeck {
+  public:
+    BenchmarkDeck(const QString& group, const WaveformPointer& pWaveform)
+            : m_group(group),
+              m_image(kWidth, kHeight, QImage::Format_ARGB32_Premultiplied) {
+        const double trackSamples = static_cast<double>(kTrackSeconds) *
+                kSampleRate * mixxx::kAnalysisChannels;
+        addControl(m_group, QStringLiteral("rate_ratio"), 1.0);
+        addControl(m_group, QStringLiteral("total_gain"), 1.0);
+        addControl(m_group, QStringLiteral("track_samples"), trackSamples);
+        addControl(m_group, QStringLiteral("filterWaveformEnable"), 0.0);
+        const QString effectGroup = kEffectGroupFormat.arg(m_group);
+        addControl(effectGroup, QStringLiteral("parameter1"), 1.0);
+        addControl(effectGroup, QStringLiteral("parameter2"), 1.0);
+        addControl(effectGroup, QStringLiteral("parameter3"), 1.0);
+        addControl(effectGroup, QStringLiteral("button_parameter1"), 0.0);
+        addControl(effectGroup, QStringLiteral("button_parameter2"), 0.0);
+
+        m_pTrack = Track::newTemporary();
+        m_pTrack->setAudioProperties(
+                mixxx::kAnalysisChannels,
+                mixxx::audio::SampleRate(kSampleRate),
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(kTrackSeconds));
+        m_pTrack->setWaveform(pWaveform);
+
+        m_pVisualPlayPosition = VisualPlayPosition::getVisualPlayPosition(m_group);
+        m_pRenderer = std::make_unique<WaveformWidgetRenderer>(m_group);
+    }
+
+    ~BenchmarkDeck() {
+        m_pVisualPlayPosition->setInvalid();
+    }
+
+    template<class T_Renderer>
+    bool init(const QDomNode& node, const SkinContext& context) {
+        m_pRenderer->addRenderer<T_Renderer>();
+        if (!m_pRenderer->init()) {
+            return false;
+        }
+        m_pRenderer->setup(node, context);
+        m_pRenderer->resizeRenderer(kWidth, kHeight, 1.0f);
+        m_pRenderer->setTrack(m_pTrack);
+        return true;
+    }
+
+    void setZoom(double zoom) {
+        m_pRenderer->setZoom(zoom);
+    }
+
+    /// Publishes the play position like the engine does after each callback
+    void setPlayPosition(double playPosition) {
+        const double trackSamples = static_cast<double>(kTrackSeconds) *
+                kSampleRate * mixxx::kAnalysisChannels;
+        m_pVisualPlayPosition->set(playPosition,
+                1.0,
+                mixxx::kAnalysisChannels / trackSamples,
+                playPosition,
+                1.0,
+                SlipModeState::Disabled,
+                false,
+                false,
+                false,
+                0.0,
+                1.0,
+                kTrackSeconds,
+                0.0,
+                1.0,
+                trackSamples);
+    }
+
+    void render() {
+        // Without an audio buffer duration the position is not
+        // extrapolated, so no VSyncThread is needed.
+        m_pRenderer->onPreRender(nullptr);
+        m_image.fill(Qt::black);
+        QPainter painter(&m_image);
+        m_pRenderer->draw(&painter, nullptr);
+    }
+
+  private:
+    void addControl(const QString& group, const QString& item, double value) {
+        auto pControl = std::make_unique<ControlObject>(ConfigKey(group, item));
+        pControl->set(value);
+        m_controls.push_back(std::move(pControl));
+    }
+
+    const QString m_group;
+    std::vector<std::unique_ptr<ControlObject>> m_controls;
+    TrackPointer m_pTrack;
+    QSharedPointer<VisualPlayPosition> m_pVisualPlayPosition;
+    std::unique_ptr<WaveformWidgetRenderer> m_pRenderer;
+    QImage m_image;
+};
+
+double percentileMicros(std::vector<double>* pFrameTimes, double percentile) {
+    if (pFrameTimes->empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(
+            percentile * static_cast<double>(pFrameTimes->size() - 1));
+    std::nth_element(pFrameTimes->begin(),
+            pFrameTimes->begin() + index,
+            pFrameTimes->end());
+    return (*pFrameTimes)[index];
+}
+
+/// Renders one frame of all decks per iteration. The first argument is
+/// the zoom factor, the second one the number of decks. Besides the real
+/// and the CPU time reported by the benchmark library, the percentiles of
+/// the frame times are reported as counters in microseconds.
+template<class T_Renderer>
+void BM_RenderWaveform(benchmark::State& state) {
+    const double zoom = static_cast<double>(state.range(0));
+    const int deckCount = static_cast<int>(state.range(1));
+
+    // The signal renderers read the visual gain from the factory
+    WaveformWidgetFactory::createInstance();
+
+    const QTemporaryDir settingsDir;
+    const SkinContext context(
+            UserSettingsPointer(new UserSettings(
+                    settingsDir.filePath(QStringLiteral("mixxx.cfg")))),
+            QString());
+    QDomDocument document;
+    QDomElement node = document.createElement(QStringLiteral("Visual"));
+    const auto addColor = [&](const QString& name, const QString& color) {
+        QDomElement element = document.createElement(name);
+        element.appendChild(document.createTextNode(color));
+        node.appendChild(element);
+    };
+    addColor(QStringLiteral("SignalColor"), QStringLiteral("#2f6fdf"));
+    addColor(QStringLiteral("SignalLowColor"), QStringLiteral("#ff3000"));
+    addColor(QStringLiteral("SignalMidColor"), QStringLiteral("#30ff00"));
+    addColor(QStringLiteral("SignalHighColor"), QStringLiteral("#0030ff"));
+    addColor(QStringLiteral("AxesColor"), QStringLiteral("#404040"));
+
+    const WaveformPointer pWaveform = createSyntheticWaveform();
+    std::vector<std::unique_ptr<BenchmarkDeck>> decks;
+    for (int i = 0; i < deckCount; ++i) {
+        auto pDeck = std::make_unique<BenchmarkDeck>(
+                QStringLiteral("[Channel%1]").arg(i + 1), pWaveform);
+        if (!pDeck->init<T_Renderer>(node, context)) {
+            state.SkipWithError("Failed to initialize the renderer");
+            break;
+        }
+        pDeck->setZoom(zoom);
+        decks.push_back(std::move(pDeck));
+    }
+
+    std::vector<double> frameTimesMicros;
+    PerformanceTimer timer;
+    // The play position advances in real time, starting at a different
+    // position in each deck
+    const double positionStep = 1.0 / (kTrackSeconds * kFramesPerSecond);
+    double playPosition = 0.1;
+    for (auto _ : state) {
+        timer.start();
+        for (std::size_t i = 0; i < decks.size(); ++i) {
+            double deckPosition = playPosition + 0.2 * i;
+            deckPosition -= static_cast<int>(deckPosition);
+            decks[i]->setPlayPosition(deckPosition);
+            decks[i]->render();
+        }
+        frameTimesMicros.push_back(timer.elapsed().toDoubleMicros());
+        playPosition += positionStep;
+        if (playPosition >= 1.0) {
+            playPosition = 0.0;
+        }
+    }
+
+    state.counters["p50_us"] = percentileMicros(&frameTimesMicros, 0.5);
+    state.counters["p95_us"] = percentileMicros(&frameTimesMicros, 0.95);
+    state.counters["p99_us"] = percentileMicros(&frameTimesMicros, 0.99);
+
+    decks.clear();
+    WaveformWidgetFactory::destroy();
+}
+
+void renderWaveformArguments(benchmark::internal::Benchmark* pBenchmark) {
+    for (const int zoom : {1, 3, 10}) {
+        for (const int deckCount : {1, 2, 4}) {
+            pBenchmark->Args({zoom, deckCount});
+        }
+    }
+    pBenchmark->ArgNames({"zoom", "decks"});
+    pBenchmark->Unit(benchmark::kMicrosecond);
+}
+
+// Filtered
+BENCHMARK_TEMPLATE(BM_RenderWaveform, WaveformRendererFilteredSignal)
+        ->Apply(renderWaveformArguments);
+// HSV
+BENCHMARK_TEMPLATE(BM_RenderWaveform, WaveformRendererHSV)
+        ->Apply(renderWaveformArguments);
+// RGB
+BENCHMARK_TEMPLATE(BM_RenderWaveform, WaveformRendererRGB)
+        ->Apply(renderWaveformArguments);
+
+} // namespace
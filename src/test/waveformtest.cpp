@@ -0,0 +1,60 @@
+#include "waveform/waveform.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+
+TEST(WaveformTest, MipLevelsHoldMaxima) {
+    Waveform waveform(44100, 44100, 441, -1);
+    const int dataSize = waveform.getDataSize();
+    ASSERT_GT(dataSize, 4);
+    EXPECT_EQ(1, waveform.getMipLevelCount());
+    for (int i = 0; i < dataSize; ++i) {
+        WaveformData& datum = waveform.data()[i];
+        datum.filtered.low = static_cast<unsigned char>(i % 7);
+        datum.filtered.mid = static_cast<unsigned char>(i % 11);
+        datum.filtered.high = static_cast<unsigned char>(i % 13);
+        datum.filtered.all = static_cast<unsigned char>(i % 251);
+    }
+
+    waveform.buildMipLevels();
+    ASSERT_GT(waveform.getMipLevelCount(), 1);
+    // The coarsest level is a single frame
+    EXPECT_EQ(2, waveform.getMipLevelDataSize(waveform.getMipLevelCount() - 1));
+
+    const WaveformData* pPrevData = waveform.mipLevelData(0);
+    for (int level = 1; level < waveform.getMipLevelCount(); ++level) {
+        const int prevDataSize = waveform.getMipLevelDataSize(level - 1);
+        const WaveformData* pData = waveform.mipLevelData(level);
+        ASSERT_EQ((prevDataSize / 2 + 1) / 2 * 2, waveform.getMipLevelDataSize(level));
+        for (int i = 0; i < waveform.getMipLevelDataSize(level); ++i) {
+            // Interleaved left and right channel
+            const int first = (i / 2) * 4 + i % 2;
+            const int second = first + 2 < prevDataSize ? first + 2 : first;
+            EXPECT_EQ(std::max(pPrevData[first].filtered.low,
+                              pPrevData[second].filtered.low),
+                    pData[i].filtered.low);
+            EXPECT_EQ(std::max(pPrevData[first].filtered.all,
+                              pPrevData[second].filtered.all),
+                    pData[i].filtered.all);
+        }
+        pPrevData = pData;
+    }
+}
+
+TEST(WaveformTest, FindMipLevel) {
+    Waveform waveform(44100, 44100, 441, -1);
+    EXPECT_EQ(0, waveform.findMipLevel(100.0));
+
+    waveform.buildMipLevels();
+    EXPECT_EQ(0, waveform.findMipLevel(0.5));
+    EXPECT_EQ(0, waveform.findMipLevel(1.9));
+    EXPECT_EQ(1, waveform.findMipLevel(2.0));
+    EXPECT_EQ(2, waveform.findMipLevel(7.9));
+    // Limited by the available levels
+    EXPECT_EQ(waveform.getMipLevelCount() - 1, waveform.findMipLevel(1e9));
+}
+
+} // namespace
@@ -0,0 +1,110 @@
+#include "waveform/waveformthumbnailstore.h"
+
+#include <gtest/gtest.h>
+
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "waveform/waveform.h"
+
+namespace {
+
+WaveformThumbnailStore::Strip createStrip(uchar offset) {
+    WaveformThumbnailStore::Strip strip;
+    for (int i = 0; i < WaveformThumbnailStore::kStripWidth; ++i) {
+        strip[i] = static_cast<uchar>(offset + i);
+    }
+    return strip;
+}
+
+class WaveformThumbnailStoreTest : public testing::Test {
+  protected:
+    QString filePath() const {
+        return m_tempDir.filePath(QStringLiteral("thumbnails.pack"));
+    }
+
+    QTemporaryDir m_tempDir;
+    const TrackId m_trackId1{QVariant(1)};
+    const TrackId m_trackId2{QVariant(2)};
+    const TrackId m_trackId3{QVariant(3)};
+};
+
+TEST_F(WaveformThumbnailStoreTest, Persistent) {
+    {
+        WaveformThumbnailStore store(filePath());
+        EXPECT_EQ(0, store.size());
+        store.insert(m_trackId1, createStrip(1));
+        store.insert(m_trackId2, createStrip(2));
+    }
+    {
+        // Mapped records are overwritten in place
+        WaveformThumbnailStore store(filePath());
+        EXPECT_EQ(2, store.size());
+        store.insert(m_trackId2, createStrip(20));
+        store.insert(m_trackId3, createStrip(3));
+    }
+    WaveformThumbnailStore store(filePath());
+    EXPECT_EQ(3, store.size());
+    WaveformThumbnailStore::Strip strip;
+    ASSERT_TRUE(store.lookup(m_trackId1, &strip));
+    EXPECT_EQ(createStrip(1), strip);
+    ASSERT_TRUE(store.lookup(m_trackId2, &strip));
+    EXPECT_EQ(createStrip(20), strip);
+    ASSERT_TRUE(store.lookup(m_trackId3, &strip));
+    EXPECT_EQ(createStrip(3), strip);
+}
+
+TEST_F(WaveformThumbnailStoreTest, ReuseRemovedRecords) {
+    {
+        WaveformThumbnailStore store(filePath());
+        store.insert(m_trackId1, createStrip(1));
+        store.insert(m_trackId2, createStrip(2));
+        store.remove(m_trackId1);
+    }
+    const qint64 fileSize = QFileInfo(filePath()).size();
+    {
+        WaveformThumbnailStore store(filePath());
+        EXPECT_EQ(1, store.size());
+        EXPECT_FALSE(store.contains(m_trackId1));
+        store.insert(m_trackId3, createStrip(3));
+    }
+    EXPECT_EQ(fileSize, QFileInfo(filePath()).size());
+
+    WaveformThumbnailStore store(filePath());
+    EXPECT_EQ(2, store.size());
+    WaveformThumbnailStore::Strip strip;
+    EXPECT_FALSE(store.lookup(m_trackId1, &strip));
+    ASSERT_TRUE(store.lookup(m_trackId3, &strip));
+    EXPECT_EQ(createStrip(3), strip);
+
+    store.clear();
+    EXPECT_EQ(0, store.size());
+    EXPECT_FALSE(store.lookup(m_trackId2, &strip));
+}
+
+TEST_F(WaveformThumbnailStoreTest, StripFromSummary) {
+    // About two visual frames per column
+    Waveform summary(44100,
+            44100,
+            441,
+            2 * 2 * WaveformThumbnailStore::kStripWidth);
+    const int visualFrames = summary.getDataSize() / 2;
+    ASSERT_GE(visualFrames, WaveformThumbnailStore::kStripWidth);
+    for (int frame = 0; frame < visualFrames; ++frame) {
+        summary.data()[2 * frame].filtered.all = 10;
+        summary.data()[2 * frame + 1].filtered.all = 0;
+    }
+    // The peak of both channels
+    summary.data()[1].filtered.all = 100;
+    summary.data()[2 * (visualFrames - 1)].filtered.all = 200;
+
+    const WaveformThumbnailStore::Strip strip =
+            WaveformThumbnailStore::stripFromSummary(summary);
+    EXPECT_EQ(100, strip.front());
+    EXPECT_EQ(200, strip.back());
+    for (int column = 1; column < WaveformThumbnailStore::kStripWidth - 1; ++column) {
+        EXPECT_EQ(10, strip[column]);
+    }
+}
+
+} // namespace
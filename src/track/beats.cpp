@@ -1,16 +1,22 @@
 #include "track/beats.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iterator>
 #include <unordered_map>
 #include <vector>
 
+#include <QCache>
+#include <QMutex>
+#include <google/protobuf/arena.h>
+
 #include "audio/frame.h"
 #include "proto/beats.pb.h"
 #include "track/beats.h"
 #include "track/beatutils.h"
 #include "track/bpm.h"
 #include "util/assert.h"
+#include "util/compatibility/qmutex.h"
 
 namespace {
 
@@ -21,6 +27,71 @@ struct BeatGridV1Data {
 
 constexpr double kEpsilon = 0.01;
 
+// The serializations of all cached beats must not exceed this limit
+constexpr int kMaxDeserializedBeatsCacheBytes = 8 * 1024 * 1024;
+
+/// Caches the deserialized beats by their serialization.
+///
+/// Tracks that are evicted from the GlobalTrackCache are often loaded
+/// again, e.g. when browsing back and forth in the library. The beats are
+/// immutable, so all tracks with the same serialization share them.
+class DeserializedBeatsCache {
+  public:
+    DeserializedBeatsCache() {
+        m_cache.setMaxCost(kMaxDeserializedBeatsCacheBytes);
+    }
+
+    mixxx::BeatsPointer lookup(
+            mixxx::audio::SampleRate sampleRate,
+            const QString& version,
+            const QString& subVersion,
+            const QByteArray& byteArray) {
+        const auto locker = lockMutex(&m_mutex);
+        const Entry* pEntry = m_cache.object(byteArray);
+        if (!pEntry ||
+                pEntry->sampleRate != sampleRate ||
+                pEntry->version != version ||
+                pEntry->subVersion != subVersion) {
+            return nullptr;
+        }
+        return pEntry->pBeats;
+    }
+
+    void insert(
+            mixxx::audio::SampleRate sampleRate,
+            const QString& version,
+            const QString& subVersion,
+            const QByteArray& byteArray,
+            mixxx::BeatsPointer pBeats) {
+        auto* pEntry = new Entry{sampleRate, version, subVersion, std::move(pBeats)};
+        const auto locker = lockMutex(&m_mutex);
+        m_cache.insert(byteArray, pEntry, static_cast<int>(byteArray.size()));
+    }
+
+  private:
+    struct Entry {
+        mixxx::audio::SampleRate sampleRate;
+        QString version;
+        QString subVersion;
+        mixxx::BeatsPointer pBeats;
+    };
+
+    QMutex m_mutex;
+    QCache<QByteArray, Entry> m_cache;
+};
+
+// Serializes without the intermediate copy of a std::string
+QByteArray serializeToByteArray(const google::protobuf::MessageLite& message) {
+    QByteArray byteArray(static_cast<int>(message.ByteSizeLong()), Qt::Uninitialized);
+    message.SerializeToArray(byteArray.data(), static_cast<int>(byteArray.size()));
+    return byteArray;
+}
+
+DeserializedBeatsCache& deserializedBeatsCache() {
+    static DeserializedBeatsCache s_cache;
+    return s_cache;
+}
+
 } // namespace
 
 namespace mixxx {
@@ -262,7 +333,11 @@ mixxx::BeatsPointer Beats::fromByteArray(
     VERIFY_OR_DEBUG_ASSERT(!beatsVersion.isEmpty()) {
         return nullptr;
     }
-    mixxx::BeatsPointer pBeats = nullptr;
+    mixxx::BeatsPointer pBeats = deserializedBeatsCache().lookup(
+            sampleRate, beatsVersion, beatsSubVersion, byteArray);
+    if (pBeats) {
+        return pBeats;
+    }
     if (beatsVersion == BEAT_GRID_1_VERSION || beatsVersion == BEAT_GRID_2_VERSION) {
         pBeats = fromBeatGridByteArray(sampleRate, beatsSubVersion, byteArray);
     } else if (beatsVersion == BEAT_MAP_VERSION) {
@@ -279,6 +354,14 @@ mixxx::BeatsPointer Beats::fromByteArray(
         return nullptr;
     }
 
+    if (pBeats->getVersion() == beatsVersion) {
+        // Not shared with anyone yet. Beats in a legacy format are
+        // serialized again in the current format.
+        std::const_pointer_cast<Beats>(pBeats)->m_byteArray = byteArray;
+    }
+    deserializedBeatsCache().insert(
+            sampleRate, beatsVersion, beatsSubVersion, byteArray, pBeats);
+
     qDebug().nospace() << "Successfully deserialized Beats (" << beatsVersion << ")";
     return pBeats;
 }
@@ -322,15 +405,18 @@ BeatsPointer Beats::fromBeatMapByteArray(
         return nullptr;
     }
 
-    track::io::BeatMap map;
-    if (!map.ParseFromArray(byteArray.constData(), byteArray.size())) {
+    // Parsed directly from the buffer of the byte array. The arena avoids
+    // a heap allocation for each of the many beats of a beat map.
+    google::protobuf::Arena arena;
+    auto* pMap = google::protobuf::Arena::CreateMessage<track::io::BeatMap>(&arena);
+    if (!pMap->ParseFromArray(byteArray.constData(), byteArray.size())) {
         return nullptr;
     }
 
     QVector<audio::FramePos> beatPositions;
-    beatPositions.reserve(map.beat_size());
-    for (int i = 0; i < map.beat_size(); i++) {
-        beatPositions.append(audio::FramePos(map.beat(i).frame_position()));
+    beatPositions.reserve(pMap->beat_size());
+    for (const auto& beat : pMap->beat()) {
+        beatPositions.append(audio::FramePos(beat.frame_position()));
     }
 
     if (beatPositions.size() < 2) {
@@ -343,6 +429,9 @@ BeatsPointer Beats::fromBeatMapByteArray(
 }
 
 QByteArray Beats::toByteArray() const {
+    if (!m_byteArray.isEmpty()) {
+        return m_byteArray;
+    }
     if (hasConstantTempo()) {
         return toBeatGridByteArray();
     }
@@ -359,23 +448,19 @@ QByteArray Beats::toBeatGridByteArray() const {
                     m_lastMarkerPosition.toLowerFrameBoundary().value()));
     grid.mutable_bpm()->set_bpm(m_lastMarkerBpm.value());
 
-    std::string output;
-    grid.SerializeToString(&output);
-    return QByteArray(output.data(), static_cast<int>(output.length()));
+    return serializeToByteArray(grid);
 };
 
 QByteArray Beats::toBeatMapByteArray() const {
-    mixxx::track::io::BeatMap map;
+    google::protobuf::Arena arena;
+    auto* pMap = google::protobuf::Arena::CreateMessage<track::io::BeatMap>(&arena);
     for (auto it = cfirstmarker(); it != clastmarker() + 1; it++) {
         const auto position = (*it).toLowerFrameBoundary();
-        track::io::Beat beat;
-        beat.set_frame_position(static_cast<google::protobuf::int32>(position.value()));
-        map.add_beat()->CopyFrom(beat);
+        pMap->add_beat()->set_frame_position(
+                static_cast<google::protobuf::int32>(position.value()));
     }
 
-    std::string output;
-    map.SerializeToString(&output);
-    return QByteArray(output.data(), static_cast<int>(output.length()));
+    return serializeToByteArray(*pMap);
 };
 
 QString Beats::getVersion() const {
@@ -465,13 +550,63 @@ Beats::ConstIterator Beats::iteratorFrom(audio::FramePos position) const {
         it -= static_cast<int>(n);
         it = previousIfNeeded(it, position);
     } else {
-        it = std::lower_bound(cfirstmarker(), clastmarker() + 1, position);
+        it = iteratorFromMarkers(position);
     }
     DEBUG_ASSERT(it == cbegin() || it == cend() || *it >= position);
     DEBUG_ASSERT(it == cbegin() || it == cend() || *it > *std::prev(it));
     return it;
 }
 
+Beats::ConstIterator Beats::iteratorFromMarkers(audio::FramePos position) const {
+    DEBUG_ASSERT(!m_markers.empty());
+    DEBUG_ASSERT(position >= m_markers.front().position());
+    DEBUG_ASSERT(position <= m_lastMarkerPosition);
+
+    const auto sectionContains = [this, position](std::size_t index) {
+        if (index >= m_markers.size() || position < m_markers[index].position()) {
+            return false;
+        }
+        const audio::FramePos nextMarkerPosition = (index + 1 < m_markers.size())
+                ? m_markers[index + 1].position()
+                : m_lastMarkerPosition;
+        return position < nextMarkerPosition;
+    };
+
+    // Try the section of the last lookup and the following section before
+    // searching all markers
+    std::size_t index = m_lookupMarkerIndex.load(std::memory_order_relaxed);
+    if (!sectionContains(index)) {
+        if (sectionContains(index + 1)) {
+            ++index;
+        } else {
+            const auto nextMarker = std::upper_bound(m_markers.cbegin(),
+                    m_markers.cend(),
+                    position,
+                    [](audio::FramePos position, const BeatMarker& marker) {
+                        return position < marker.position();
+                    });
+            DEBUG_ASSERT(nextMarker != m_markers.cbegin());
+            index = std::distance(m_markers.cbegin(), nextMarker) - 1;
+        }
+        m_lookupMarkerIndex.store(index, std::memory_order_relaxed);
+    }
+
+    // The beats between two markers are equidistant
+    auto it = ConstIterator(this, m_markers.cbegin() + index, 0);
+    const double n = std::ceil((position - *it) / it.beatLengthFrames());
+    it += static_cast<int>(n);
+    // Compensate rounding errors like the other cases in iteratorFrom()
+    if (*it < position) {
+        ++it;
+    } else if (it != cfirstmarker()) {
+        const auto previousBeatIt = std::prev(it);
+        if (*previousBeatIt >= position) {
+            it = previousBeatIt;
+        }
+    }
+    return it;
+}
+
 audio::FramePos Beats::findNthBeat(audio::FramePos position, int n) const {
     if (n == 0) {
         return audio::kInvalidFramePos;
@@ -4,6 +4,7 @@
 #include <QList>
 #include <QString>
 #include <QVector>
+#include <atomic>
 #include <memory>
 #include <optional>
 
@@ -229,6 +230,8 @@ class Beats : private std::enable_shared_from_this<Beats> {
         return shared_from_this();
     }
 
+    /// Deserialized beats are cached by their serialization, so loading
+    /// the same beats again returns the same immutable instance.
     static mixxx::BeatsPointer fromByteArray(
             mixxx::audio::SampleRate sampleRate,
             const QString& beatsVersion,
@@ -282,6 +285,9 @@ class Beats : private std::enable_shared_from_this<Beats> {
     }
 
     /// Serialize beats to QByteArray.
+    ///
+    /// Beats that have been deserialized by fromByteArray() return the
+    /// original serialization.
     QByteArray toByteArray() const;
 
     /// A string representing the version of the beat-processing code that
@@ -429,6 +435,10 @@ class Beats : private std::enable_shared_from_this<Beats> {
     mixxx::audio::FrameDiff_t firstBeatLengthFrames() const;
     mixxx::audio::FrameDiff_t lastBeatLengthFrames() const;
 
+    /// Find the next beat at or after a position between the first and
+    /// the last marker
+    ConstIterator iteratorFromMarkers(audio::FramePos position) const;
+
     std::vector<BeatMarker> m_markers;
     mixxx::audio::FramePos m_lastMarkerPosition;
     mixxx::Bpm m_lastMarkerBpm;
@@ -436,6 +446,16 @@ class Beats : private std::enable_shared_from_this<Beats> {
 
     // The sub-version of this beatgrid.
     const QString m_subVersion;
+
+    /// The serialization these beats have been deserialized from, if it is
+    /// in the format of getVersion(). Returned by toByteArray() instead of
+    /// serializing the beats again.
+    QByteArray m_byteArray;
+
+    /// The index of the marker section of the last lookup. The position
+    /// of subsequent lookups, e.g. from the engine controls of a deck
+    /// during playback, is usually in the same or in the next section.
+    mutable std::atomic<std::size_t> m_lookupMarkerIndex{0};
 };
 
 } // namespace mixxx
@@ -314,7 +314,8 @@ GlobalTrackCache::GlobalTrackCache(
 #endif
           m_pSaver(pSaver),
           m_deleteTrackFn(deleteTrackFn),
-          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun),
+          m_tracksByCanonicalLocation(kUnorderedCollectionMinCapacity) {
     DEBUG_ASSERT(m_pSaver);
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
 }
@@ -323,6 +324,69 @@ GlobalTrackCache::~GlobalTrackCache() {
     deactivate();
 }
 
+//static
+TrackPointer GlobalTrackCache::lookupTrackById(
+        const TrackId& trackId) {
+    DEBUG_ASSERT(s_pInstance);
+    if (!trackId.isValid()) {
+        return TrackPointer();
+    }
+    TrackPointer trackPtr;
+    switch (s_pInstance->tracksByIdShard(trackId).lookup(trackId, &trackPtr)) {
+    case TracksByIdShard::LookupResult::Hit:
+        DEBUG_ASSERT(trackPtr);
+        return trackPtr;
+    case TracksByIdShard::LookupResult::Miss:
+        return TrackPointer();
+    case TracksByIdShard::LookupResult::Expired:
+        break;
+    }
+    // The track is about to be evicted and needs to be revived
+    return GlobalTrackCacheLocker().lookupTrackById(trackId);
+}
+
+GlobalTrackCache::TracksByIdShard::TracksByIdShard()
+        : m_tracks(kUnorderedCollectionMinCapacity / kTracksByIdShardCount,
+                  DbId::hash_fun) {
+}
+
+GlobalTrackCache::TracksByIdShard::LookupResult
+GlobalTrackCache::TracksByIdShard::lookup(
+        const TrackId& trackId,
+        TrackPointer* pTrack) const {
+    DEBUG_ASSERT(pTrack);
+    const auto locker = lockMutex(&m_mutex);
+    const auto i = m_tracks.find(trackId);
+    if (i == m_tracks.end()) {
+        return LookupResult::Miss;
+    }
+    *pTrack = i->second.lock();
+    return *pTrack ? LookupResult::Hit : LookupResult::Expired;
+}
+
+void GlobalTrackCache::TracksByIdShard::insert(
+        const TrackId& trackId,
+        const TrackPointer& strongPtr) {
+    const auto locker = lockMutex(&m_mutex);
+    m_tracks.insert_or_assign(trackId, TrackWeakPointer(strongPtr));
+}
+
+void GlobalTrackCache::TracksByIdShard::remove(
+        const TrackId& trackId) {
+    const auto locker = lockMutex(&m_mutex);
+    m_tracks.erase(trackId);
+}
+
+void GlobalTrackCache::TracksByIdShard::clear() {
+    const auto locker = lockMutex(&m_mutex);
+    m_tracks.clear();
+}
+
+GlobalTrackCache::TracksByIdShard& GlobalTrackCache::tracksByIdShard(
+        const TrackId& trackId) {
+    return m_tracksByIdShards[DbId::hash_fun(trackId) % kTracksByIdShardCount];
+}
+
 void GlobalTrackCache::relocateTracks(
         GlobalTrackCacheRelocator* pRelocator) {
     if (debugLogEnabled()) {
@@ -407,6 +471,10 @@ void GlobalTrackCache::deactivate() {
             << m_tracksByCanonicalLocation.size()
             << "tracks from cache";
 
+    for (auto& tracksByIdShard : m_tracksByIdShards) {
+        tracksByIdShard.clear();
+    }
+
     while (!m_tracksById.empty()) {
         auto i = m_tracksById.begin();
         Track* plainPtr= i->second->getPlainPtr();
@@ -548,6 +616,10 @@ TrackPointer GlobalTrackCache::revive(
     savingPtr = TrackPointer(entryPtr->getPlainPtr(),
             EvictAndSaveFunctor(entryPtr));
     entryPtr->init(savingPtr);
+    const TrackId trackId = savingPtr->getId();
+    if (trackId.isValid()) {
+        tracksByIdShard(trackId).insert(trackId, savingPtr);
+    }
     DEBUG_ASSERT(!savingPtr->signalsBlocked());
     return savingPtr;
 }
@@ -659,6 +731,7 @@ void GlobalTrackCache::resolve(
         m_tracksById.insert(std::make_pair(
                 trackRef.getId(),
                 cacheEntryPtr));
+        tracksByIdShard(trackRef.getId()).insert(trackRef.getId(), savingPtr);
     }
     if (trackRef.hasCanonicalLocation()) {
         // Insert item by track location
@@ -700,6 +773,7 @@ TrackRef GlobalTrackCache::initTrackId(
     m_tracksById.insert(std::make_pair(
             trackId,
             pDel->getCacheEntryPointer()));
+    tracksByIdShard(trackId).insert(trackId, strongPtr);
 
     strongPtr->initId(trackId);
     DEBUG_ASSERT(createTrackRef(*strongPtr) == trackRefWithId);
@@ -716,6 +790,7 @@ void GlobalTrackCache::purgeTrackId(TrackId trackId) {
         Track* track = trackById->second->getPlainPtr();
         track->resetId();
         m_tracksById.erase(trackById);
+        tracksByIdShard(trackId).remove(trackId);
     }
 }
 
@@ -786,6 +861,7 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
         if (trackById != m_tracksById.end()) {
             if (trackById->second->getPlainPtr() == plainPtr) {
                 m_tracksById.erase(trackById);
+                tracksByIdShard(trackRef.getId()).remove(trackRef.getId());
                 evicted = true;
             } else {
                 notEvicted = true;
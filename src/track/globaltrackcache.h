@@ -1,6 +1,7 @@
 #pragma once
 
-#include <map>
+#include <QMutex>
+#include <array>
 #include <unordered_map>
 
 #include "track/track_decl.h"
@@ -220,6 +221,13 @@ class GlobalTrackCache : public QObject {
     // Deleter callbacks for the smart-pointer
     static void evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
+    /// Lookup an existing Track object in the cache by id. In contrast
+    /// to GlobalTrackCacheLocker::lookupTrackById() the cache is only
+    /// locked if the track needs to be revived, i.e. cache hits of
+    /// referenced tracks and cache misses don't block each other.
+    static TrackPointer lookupTrackById(
+            const TrackId& trackId);
+
   private slots:
     void slotEvictAndSave(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
@@ -272,6 +280,43 @@ class GlobalTrackCache : public QObject {
 
     void saveEvictedTrack(Track* pEvictedTrack) const;
 
+    /// A lock-striped index of the cached tracks by id for looking
+    /// them up without locking the whole cache. Each shard has its own
+    /// lock and stores weak pointers to the tracks. The shards are only
+    /// modified while the cache is locked and always contain the same
+    /// ids as m_tracksById.
+    class TracksByIdShard final {
+      public:
+        enum class LookupResult {
+            Hit,
+            // Cached, but no longer referenced. Needs to be revived
+            // while the cache is locked.
+            Expired,
+            Miss,
+        };
+
+        TracksByIdShard();
+
+        LookupResult lookup(
+                const TrackId& trackId,
+                TrackPointer* pTrack) const;
+
+        void insert(
+                const TrackId& trackId,
+                const TrackPointer& strongPtr);
+        void remove(
+                const TrackId& trackId);
+        void clear();
+
+      private:
+        mutable QMutex m_mutex;
+        std::unordered_map<TrackId, TrackWeakPointer, TrackId::hash_fun_t> m_tracks;
+    };
+
+    static constexpr std::size_t kTracksByIdShardCount = 16;
+
+    TracksByIdShard& tracksByIdShard(const TrackId& trackId);
+
     // Managed by GlobalTrackCacheLocker
     mutable QT_RECURSIVE_MUTEX m_mutex;
 
@@ -283,7 +328,9 @@ class GlobalTrackCache : public QObject {
     typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
     TracksById m_tracksById;
 
+    std::array<TracksByIdShard, kTracksByIdShardCount> m_tracksByIdShards;
+
     // This caches the unsaved Tracks by location
-    typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
+    typedef std::unordered_map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
     TracksByCanonicalLocation m_tracksByCanonicalLocation;
 };
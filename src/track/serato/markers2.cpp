@@ -1,6 +1,7 @@
 #include "track/serato/markers2.h"
 
 #include <QtEndian>
+#include <algorithm>
 
 #include "util/logger.h"
 
@@ -382,7 +383,10 @@ bool SeratoMarkers2::parseID3(
         return false;
     }
 
-    if (!parseCommon(seratoMarkers2, outerData.mid(2))) {
+    // A view of the remaining bytes, which are only read while parsing
+    if (!parseCommon(seratoMarkers2,
+                QByteArray::fromRawData(
+                        outerData.constData() + 2, outerData.size() - 2))) {
         return false;
     }
 
@@ -407,7 +411,8 @@ bool SeratoMarkers2::parseCommon(
     int entryTypeEndPos;
     while ((entryTypeEndPos = data.indexOf('\x00', offset)) >= 0) {
         // Entry Name
-        QString entryType(data.mid(offset, entryTypeEndPos - offset));
+        const auto entryType = QString::fromUtf8(
+                data.constData() + offset, entryTypeEndPos - offset);
         offset = entryTypeEndPos + 1;
 
         if (entryType.isEmpty()) {
@@ -421,10 +426,18 @@ bool SeratoMarkers2::parseCommon(
         }
 
         // Entry Size
-        auto entrySize = qFromBigEndian<quint32>(data.mid(offset, 4));
+        if (offset + 4 > data.size()) {
+            kLogger.warning() << "Parsing SeratoMarkers2 failed:"
+                              << "Missing size of entry" << entryType;
+            return false;
+        }
+        const auto entrySize = qFromBigEndian<quint32>(data.constData() + offset);
         offset += 4;
 
-        QByteArray entryData = data.mid(offset, entrySize);
+        // The entries are parsed from a view of the decoded data without
+        // copying it. Entries that need to keep it must copy it.
+        const auto entryData = QByteArray::fromRawData(data.constData() + offset,
+                static_cast<int>(std::min<qint64>(entrySize, data.size() - offset)));
         offset += entrySize;
 
         // Entry Content
@@ -438,7 +451,8 @@ bool SeratoMarkers2::parseCommon(
         } else if (entryType.compare("LOOP") == 0) {
             pEntry = SeratoMarkers2LoopEntry::parse(entryData);
         } else {
-            pEntry = SeratoMarkers2EntryPointer(new SeratoMarkers2UnknownEntry(entryType, entryData));
+            pEntry = SeratoMarkers2EntryPointer(new SeratoMarkers2UnknownEntry(
+                    entryType, QByteArray(entryData.constData(), entryData.size())));
             kLogger.trace() << "SeratoMarkers2UnknownEntry" << *pEntry;
         }
 
@@ -471,7 +485,9 @@ bool SeratoMarkers2::parseBase64Encoded(
     DEBUG_ASSERT(decodedData.size() >= kSeratoMarkers2Base64EncodedPrefix.size());
     if (!parseID3(
                 seratoMarkers2,
-                decodedData.mid(kSeratoMarkers2Base64EncodedPrefix.size()))) {
+                QByteArray::fromRawData(
+                        decodedData.constData() + kSeratoMarkers2Base64EncodedPrefix.size(),
+                        decodedData.size() - kSeratoMarkers2Base64EncodedPrefix.size()))) {
         kLogger.warning() << "Parsing base64encoded SeratoMarkers2 failed!";
         return false;
     }
@@ -2,6 +2,8 @@
 
 #include <mp3guessenc.h>
 
+#include <QCache>
+#include <QMutex>
 #include <optional>
 
 #include "sources/soundsourceproxy.h"
@@ -18,6 +20,7 @@
 #include "track/serato/cueinfoimporter.h"
 #include "track/taglib/trackmetadata_file.h"
 #include "util/color/predefinedcolorpalettes.h"
+#include "util/compatibility/qmutex.h"
 
 namespace {
 
@@ -67,10 +70,91 @@ bool isCueInfoValid(const mixxx::CueInfo& cueInfo) {
     return true;
 }
 
+// The raw tag data of all cached results must not exceed this limit
+constexpr int kMaxParsedTagCacheBytes = 4 * 1024 * 1024;
+
+/// Caches the parsed Serato tags by their raw contents.
+///
+/// Decoding the base64 encoded tags of a file is more expensive than
+/// looking up its contents, and the tags of a file rarely change between
+/// imports. Failures are cached, too.
+template<typename T>
+class ParsedTagCache {
+  public:
+    using ParseFunc = bool (*)(T*, const QByteArray&, mixxx::taglib::FileType);
+
+    explicit ParsedTagCache(ParseFunc parseFunc)
+            : m_parseFunc(parseFunc) {
+        m_cache.setMaxCost(kMaxParsedTagCacheBytes);
+    }
+
+    bool parse(T* pParsed, const QByteArray& data, mixxx::taglib::FileType fileType) {
+        if (data.isEmpty()) {
+            return m_parseFunc(pParsed, data, fileType);
+        }
+        {
+            const auto locker = lockMutex(&m_mutex);
+            const Entry* pEntry = m_cache.object(data);
+            if (pEntry && pEntry->fileType == fileType) {
+                if (pEntry->success) {
+                    *pParsed = pEntry->parsed;
+                }
+                return pEntry->success;
+            }
+        }
+        const bool success = m_parseFunc(pParsed, data, fileType);
+        auto* pEntry = new Entry{success ? *pParsed : T(), fileType, success};
+        const auto locker = lockMutex(&m_mutex);
+        // The data might only be a view of the buffers of the file's tags
+        m_cache.insert(QByteArray(data.constData(), data.size()),
+                pEntry,
+                static_cast<int>(data.size()));
+        return success;
+    }
+
+  private:
+    struct Entry {
+        T parsed;
+        mixxx::taglib::FileType fileType;
+        bool success;
+    };
+
+    const ParseFunc m_parseFunc;
+    QMutex m_mutex;
+    QCache<QByteArray, Entry> m_cache;
+};
+
+template<typename T>
+ParsedTagCache<T>& parsedTagCache() {
+    static ParsedTagCache<T> s_cache(&T::parse);
+    return s_cache;
+}
+
 } // namespace
 
 namespace mixxx {
 
+bool SeratoTags::parseBeatGrid(const QByteArray& data, taglib::FileType fileType) {
+    bool success = parsedTagCache<SeratoBeatGrid>().parse(
+            &m_seratoBeatGrid, data, fileType);
+    m_seratoBeatGridParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
+    return success;
+}
+
+bool SeratoTags::parseMarkers(const QByteArray& data, taglib::FileType fileType) {
+    bool success = parsedTagCache<SeratoMarkers>().parse(
+            &m_seratoMarkers, data, fileType);
+    m_seratoMarkersParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
+    return success;
+}
+
+bool SeratoTags::parseMarkers2(const QByteArray& data, taglib::FileType fileType) {
+    bool success = parsedTagCache<SeratoMarkers2>().parse(
+            &m_seratoMarkers2, data, fileType);
+    m_seratoMarkers2ParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
+    return success;
+}
+
 double SeratoTags::guessTimingOffsetMillis(
         const QString& filePath,
         const audio::SignalInfo& signalInfo) {
@@ -54,23 +54,12 @@ class SeratoTags final {
         return ParserStatus::Parsed;
     }
 
-    bool parseBeatGrid(const QByteArray& data, taglib::FileType fileType) {
-        bool success = SeratoBeatGrid::parse(&m_seratoBeatGrid, data, fileType);
-        m_seratoBeatGridParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
-        return success;
-    }
-
-    bool parseMarkers(const QByteArray& data, taglib::FileType fileType) {
-        bool success = SeratoMarkers::parse(&m_seratoMarkers, data, fileType);
-        m_seratoMarkersParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
-        return success;
-    }
-
-    bool parseMarkers2(const QByteArray& data, taglib::FileType fileType) {
-        bool success = SeratoMarkers2::parse(&m_seratoMarkers2, data, fileType);
-        m_seratoMarkers2ParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
-        return success;
-    }
+    /// The parse functions reuse the results of tags with identical
+    /// contents that have been parsed recently, e.g. when re-importing the
+    /// metadata of a file whose Serato tags have not changed.
+    bool parseBeatGrid(const QByteArray& data, taglib::FileType fileType);
+    bool parseMarkers(const QByteArray& data, taglib::FileType fileType);
+    bool parseMarkers2(const QByteArray& data, taglib::FileType fileType);
 
     QByteArray dumpBeatGrid(taglib::FileType fileType) const {
         return m_seratoBeatGrid.dump(fileType);
@@ -90,7 +90,8 @@ Track::Track(
           m_record(trackId),
           m_bDirty(false),
           m_bMarkedForMetadataExport(false),
-          m_undoingBeatsChange(false) {
+          m_undoingBeatsChange(false),
+          m_pSnapshot(std::make_shared<const Snapshot>()) {
     if (kLogStats && kLogger.debugEnabled()) {
         long numberOfInstancesBefore = s_numberOfInstances.fetch_add(1);
         kLogger.debug()
@@ -195,7 +196,7 @@ void Track::replaceMetadataFromSource(
         auto beatsAndBpmModified = false;
         if (importedBpm.isValid() &&
                 (!m_pBeats ||
-                        !getBeatsPointerBpm(m_pBeats, getDuration())
+                        !getBeatsPointerBpm(m_pBeats, getDurationWhileLocked())
                                  .isValid())) {
             // Only use the imported BPM if the current beat grid is either
             // missing or not valid! The BPM value in the metadata might be
@@ -350,8 +351,7 @@ bool Track::replaceRecord(
 }
 
 mixxx::ReplayGain Track::getReplayGain() const {
-    const auto locked = lockMutex(&m_qMutex);
-    return m_record.getMetadata().getTrackInfo().getReplayGain();
+    return getSnapshot()->replayGain;
 }
 
 void Track::setReplayGain(const mixxx::ReplayGain& replayGain) {
@@ -375,7 +375,7 @@ void Track::adjustReplayGainFromPregain(double gain) {
 mixxx::Bpm Track::getBpmWhileLocked() const {
     // BPM values must be synchronized at all times!
     DEBUG_ASSERT(m_record.getMetadata().getTrackInfo().getBpm() ==
-            getBeatsPointerBpm(m_pBeats, getDuration()));
+            getBeatsPointerBpm(m_pBeats, getDurationWhileLocked()));
     return m_record.getMetadata().getTrackInfo().getBpm();
 }
 
@@ -394,7 +394,7 @@ bool Track::trySetBpmWhileLocked(mixxx::Bpm bpm) {
                 cuePosition,
                 bpm);
         return trySetBeatsWhileLocked(pBeats);
-    } else if (getBeatsPointerBpm(m_pBeats, getDuration()) != bpm) {
+    } else if (getBeatsPointerBpm(m_pBeats, getDurationWhileLocked()) != bpm) {
         // Continue with the regular cases
         const auto newBeats = m_pBeats->trySetBpm(bpm);
         if (newBeats) {
@@ -454,7 +454,7 @@ bool Track::setBeatsWhileLocked(mixxx::BeatsPointer pBeats) {
     }
 
     m_pBeats = std::move(pBeats);
-    m_record.refMetadata().refTrackInfo().setBpm(getBeatsPointerBpm(m_pBeats, getDuration()));
+    m_record.refMetadata().refTrackInfo().setBpm(getBeatsPointerBpm(m_pBeats, getDurationWhileLocked()));
     return true;
 }
 
@@ -492,8 +492,7 @@ bool Track::trySetBeatsMarkDirtyAndUnlock(
 }
 
 mixxx::BeatsPointer Track::getBeats() const {
-    const auto locked = lockMutex(&m_qMutex);
-    return m_pBeats;
+    return getSnapshot()->pBeats;
 }
 
 void Track::undoBeatsChange() {
@@ -621,8 +620,7 @@ void Track::setDuration(double duration) {
 }
 
 double Track::getDuration() const {
-    const auto locked = lockMutex(&m_qMutex);
-    return m_record.getMetadata().getStreamInfo().getDuration().toDoubleSeconds();
+    return getSnapshot()->duration.toDoubleSeconds();
 }
 
 int Track::getDurationSecondsInt() const {
@@ -1370,10 +1368,35 @@ void Track::markClean() {
     setDirtyAndUnlock(&locked, false);
 }
 
+void Track::updateSnapshotWhileLocked() {
+    const auto& keys = m_record.getKeys();
+    const auto replayGain = m_record.getMetadata().getTrackInfo().getReplayGain();
+    const auto duration = m_record.getMetadata().getStreamInfo().getDuration();
+    const auto pSnapshot = m_pSnapshot.load();
+    DEBUG_ASSERT(pSnapshot);
+    if (pSnapshot->pBeats == m_pBeats &&
+            pSnapshot->cuePoints == m_cuePoints &&
+            pSnapshot->keys == keys &&
+            pSnapshot->replayGain == replayGain &&
+            pSnapshot->duration == duration) {
+        return;
+    }
+    m_pSnapshot.store(std::make_shared<const Snapshot>(Snapshot{
+            m_pBeats,
+            m_cuePoints,
+            keys,
+            replayGain,
+            duration,
+    }));
+}
+
 void Track::setDirtyAndUnlock(QT_RECURSIVE_MUTEX_LOCKER* pLock, bool bDirty) {
     const bool dirtyChanged = m_bDirty != bDirty;
     m_bDirty = bDirty;
 
+    // Publish the modifications before unlocking
+    updateSnapshotWhileLocked();
+
     const auto trackId = m_record.getId();
 
     // Unlock before emitting any signals!
@@ -1443,8 +1466,7 @@ void Track::resetKeys() {
 }
 
 Keys Track::getKeys() const {
-    const auto locked = lockMutex(&m_qMutex);
-    return m_record.getKeys();
+    return getSnapshot()->keys;
 }
 
 void Track::setKey(mixxx::track::io::key::ChromaticKey key,
@@ -1815,6 +1837,10 @@ void Track::updateStreamInfoFromSource(
             && !stemsImported
 #endif
     ) {
+        if (updated) {
+            markDirtyAndUnlock(&locked);
+            emit durationChanged();
+        }
         return;
     }
 
@@ -18,6 +18,7 @@
 #include "track/track_decl.h"
 #include "track/trackrecord.h"
 #include "util/color/predefinedcolorpalettes.h"
+#include "util/compatibility/atomicsharedptr.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
 #include "util/performancetimer.h"
@@ -53,6 +54,25 @@ class Track : public QObject {
             const QString& filePath,
             TrackId trackId);
 
+    /// An immutable copy of the properties that are read frequently from
+    /// different threads, e.g. by the engine controls, the waveform
+    /// renderers and the analyzers.
+    ///
+    /// A new snapshot is published whenever one of these properties has
+    /// been modified. Reading the latest snapshot never blocks behind a
+    /// writer that holds the lock of the track, e.g. while importing cues
+    /// or reloading the metadata from file tags.
+    struct Snapshot {
+        mixxx::BeatsPointer pBeats;
+        QList<CuePointer> cuePoints;
+        Keys keys;
+        mixxx::ReplayGain replayGain;
+        mixxx::Duration duration;
+    };
+    std::shared_ptr<const Snapshot> getSnapshot() const {
+        return m_pSnapshot.load();
+    }
+
     Q_PROPERTY(QString artist READ getArtist WRITE setArtist NOTIFY artistChanged)
     Q_PROPERTY(QString title READ getTitle WRITE setTitle NOTIFY titleChanged)
     Q_PROPERTY(QString album READ getAlbum WRITE setAlbum NOTIFY albumChanged)
@@ -325,9 +345,7 @@ class Track : public QObject {
     void removeCue(const CuePointer& pCue);
     void removeCuesOfType(mixxx::CueType);
     QList<CuePointer> getCuePoints() const {
-        const QMutexLocker lock(&m_qMutex);
-        // lock thread-unsafe copy constructors of QList
-        return m_cuePoints;
+        return getSnapshot()->cuePoints;
     }
 
     void setCuePoints(const QList<CuePointer>& cuePoints);
@@ -493,6 +511,10 @@ class Track : public QObject {
     }
     void setDirtyAndUnlock(QT_RECURSIVE_MUTEX_LOCKER* pLock, bool bDirty);
 
+    /// Publishes a new snapshot if any of its properties has been modified.
+    /// Invoked by setDirtyAndUnlock() that concludes all modifications.
+    void updateSnapshotWhileLocked();
+
     void afterKeysUpdated(QT_RECURSIVE_MUTEX_LOCKER* pLock);
 
     void afterBeatsAndBpmUpdated(QT_RECURSIVE_MUTEX_LOCKER* pLock);
@@ -531,6 +553,9 @@ class Track : public QObject {
 #endif
 
     mixxx::Bpm getBpmWhileLocked() const;
+    double getDurationWhileLocked() const {
+        return m_record.getMetadata().getStreamInfo().getDuration().toDoubleSeconds();
+    }
     bool trySetBpmWhileLocked(mixxx::Bpm bpm);
     bool trySetBeatsWhileLocked(
             mixxx::BeatsPointer pBeats,
@@ -612,6 +637,9 @@ class Track : public QObject {
     mixxx::BeatsImporterPointer m_pBeatsImporterPending;
     std::unique_ptr<mixxx::CueInfoImporter> m_pCueInfoImporterPending;
 
+    // Never null, replaced while locked
+    mixxx::AtomicSharedPtr<const Snapshot> m_pSnapshot;
+
     friend class TrackDAO;
     void setHeaderParsedFromTrackDAO(bool headerParsed) {
         // Always operating on a newly created, exclusive instance! No need
@@ -0,0 +1,181 @@
+#include "util/asyncfilewriter.h"
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("AsyncFileWriter");
+
+// The writing thread blocks if the disk falls this far behind, instead of
+// growing the memory without limits. This is more than a minute of
+// uncompressed stereo audio at 96 kHz.
+constexpr qint64 kMaxPendingBytes = 64 * 1024 * 1024;
+
+// Size of the file system extents that are reserved ahead of the data
+constexpr qint64 kPreallocationSize = 64 * 1024 * 1024;
+
+} // namespace
+
+AsyncFileWriter::AsyncFileWriter()
+        : m_pos(0),
+          m_size(0),
+          m_pendingBytes(0),
+          m_writing(false),
+          m_stop(false),
+          m_preallocatedEnd(0) {
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+bool AsyncFileWriter::open(const QString& fileName) {
+    DEBUG_ASSERT(!isOpen());
+    DEBUG_ASSERT(!isRunning());
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    m_pos = 0;
+    m_size = 0;
+    m_pendingBytes = 0;
+    m_writing = false;
+    m_stop = false;
+    m_preallocatedEnd = 0;
+    // Same priority as the side chain that produces the data
+    start(QThread::HighPriority);
+    return true;
+}
+
+void AsyncFileWriter::close() {
+    if (!isRunning()) {
+        if (isOpen()) {
+            m_file.close();
+        }
+        return;
+    }
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_stop = true;
+        m_chunksAvailable.wakeAll();
+    }
+    // The I/O thread writes all pending chunks before it exits
+    wait();
+    m_file.close();
+}
+
+void AsyncFileWriter::write(const char* pData, qint64 size) {
+    VERIFY_OR_DEBUG_ASSERT(isOpen()) {
+        return;
+    }
+    if (size <= 0) {
+        return;
+    }
+    {
+        auto locker = lockMutex(&m_mutex);
+        while (m_pendingBytes > kMaxPendingBytes) {
+            kLogger.warning() << "Waiting for" << m_pendingBytes
+                              << "pending bytes to be written to" << m_file.fileName();
+            m_chunksWritten.wait(&m_mutex);
+        }
+        // Sequential writes are merged into a single chunk
+        if (!m_pendingChunks.empty() &&
+                m_pendingChunks.back().offset + m_pendingChunks.back().data.size() == m_pos) {
+            m_pendingChunks.back().data.append(pData, static_cast<int>(size));
+        } else {
+            m_pendingChunks.push_back(Chunk{m_pos, QByteArray(pData, static_cast<int>(size))});
+        }
+        m_pendingBytes += size;
+        m_chunksAvailable.wakeAll();
+    }
+    m_pos += size;
+    m_size = std::max(m_size, m_pos);
+}
+
+void AsyncFileWriter::seek(qint64 pos) {
+    DEBUG_ASSERT(pos >= 0);
+    m_pos = pos;
+}
+
+void AsyncFileWriter::waitForBytesWritten() {
+    auto locker = lockMutex(&m_mutex);
+    while (isRunning() && (!m_pendingChunks.empty() || m_writing)) {
+        m_chunksWritten.wait(&m_mutex);
+    }
+}
+
+void AsyncFileWriter::run() {
+    QThread::currentThread()->setObjectName(
+            QStringLiteral("AsyncFileWriter %1").arg(m_file.fileName()));
+    std::vector<Chunk> chunks;
+    while (true) {
+        bool stop;
+        {
+            auto locker = lockMutex(&m_mutex);
+            m_writing = false;
+            m_chunksWritten.wakeAll();
+            while (m_pendingChunks.empty() && !m_stop) {
+                m_chunksAvailable.wait(&m_mutex);
+            }
+            // Double buffering: the writing thread continues with an empty
+            // list while this thread writes the swapped out chunks
+            chunks.swap(m_pendingChunks);
+            m_pendingBytes = 0;
+            m_writing = !chunks.empty();
+            stop = m_stop;
+        }
+        writeChunks(chunks);
+        chunks.clear();
+        if (stop) {
+            break;
+        }
+    }
+    const auto locker = lockMutex(&m_mutex);
+    m_writing = false;
+    m_chunksWritten.wakeAll();
+}
+
+void AsyncFileWriter::writeChunks(const std::vector<Chunk>& chunks) {
+    for (const auto& chunk : chunks) {
+        const qint64 end = chunk.offset + chunk.data.size();
+        if (end > m_preallocatedEnd) {
+            preallocate(end);
+        }
+        if (m_file.pos() != chunk.offset && !m_file.seek(chunk.offset)) {
+            kLogger.warning() << "Failed to seek in" << m_file.fileName()
+                              << m_file.errorString();
+            continue;
+        }
+        if (m_file.write(chunk.data) != chunk.data.size()) {
+            kLogger.warning() << "Failed to write to" << m_file.fileName()
+                              << m_file.errorString();
+        }
+    }
+    // Hand the data over to the operating system, so it reaches the disk
+    // even if Mixxx crashes
+    m_file.flush();
+}
+
+void AsyncFileWriter::preallocate(qint64 end) {
+    m_preallocatedEnd = end + kPreallocationSize;
+#ifdef Q_OS_LINUX
+    // Reserves the space without changing the size of the file. Not all
+    // file systems support this, which is fine.
+    (void)fallocate(m_file.handle(),
+            FALLOC_FL_KEEP_SIZE,
+            end,
+            m_preallocatedEnd - end);
+#endif
+}
+
+} // namespace mixxx
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <vector>
+
+namespace mixxx {
+
+/// Writes a file from a dedicated I/O thread.
+///
+/// The writing thread only copies the data into memory, so stalls of the
+/// file system, e.g. when a slow USB disk flushes its cache, don't delay
+/// it. Seeking is supported, because encoders like libsndfile rewrite the
+/// header at the beginning of the file. The position and size are tracked
+/// by the writing thread and reflect all data written so far, independent
+/// of what has already reached the disk.
+///
+/// On Linux the file system space is reserved ahead of the written data in
+/// large extents, which keeps long recordings from fragmenting.
+///
+/// All methods except the I/O thread itself must be called from the same
+/// thread.
+class AsyncFileWriter : public QThread {
+  public:
+    AsyncFileWriter();
+    ~AsyncFileWriter() override;
+
+    bool open(const QString& fileName);
+    /// Writes all pending data and closes the file.
+    void close();
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+    QString errorString() const {
+        return m_file.errorString();
+    }
+
+    void write(const char* pData, qint64 size);
+    void seek(qint64 pos);
+    qint64 pos() const {
+        return m_pos;
+    }
+    qint64 size() const {
+        return m_size;
+    }
+
+    /// Blocks until all data that has been written so far reached the file.
+    void waitForBytesWritten();
+
+  private:
+    struct Chunk {
+        qint64 offset;
+        QByteArray data;
+    };
+
+    void run() override;
+    void writeChunks(const std::vector<Chunk>& chunks);
+    void preallocate(qint64 end);
+
+    QFile m_file;
+    qint64 m_pos;
+    qint64 m_size;
+
+    // Shared with the I/O thread
+    QMutex m_mutex;
+    QWaitCondition m_chunksAvailable;
+    QWaitCondition m_chunksWritten;
+    std::vector<Chunk> m_pendingChunks;
+    qint64 m_pendingBytes;
+    bool m_writing;
+    bool m_stop;
+
+    // Only accessed by the I/O thread
+    qint64 m_preallocatedEnd;
+};
+
+} // namespace mixxx
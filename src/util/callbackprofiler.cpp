@@ -0,0 +1,180 @@
+#include "util/callbackprofiler.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <chrono>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+// Assigned on first use, because the ids of std::thread and QThread are
+// neither small nor stable across runs.
+thread_local int t_threadIndex = -1;
+
+qint64 percentile(const std::vector<qint64>& sortedValues, int percent) {
+    DEBUG_ASSERT(!sortedValues.empty());
+    const auto index = (sortedValues.size() - 1) * percent / 100;
+    return sortedValues[index];
+}
+
+} // anonymous namespace
+
+// static
+CallbackProfiler& CallbackProfiler::instance() {
+    static CallbackProfiler s_instance;
+    return s_instance;
+}
+
+// static
+qint64 CallbackProfiler::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+CallbackProfiler::CallbackProfiler()
+        : m_enabled(false),
+          m_deadlineNs(0),
+          m_droppedEvents(0),
+          m_numThreads(0),
+          m_ring(new Slot[kRingSize]),
+          m_writePosition(0),
+          m_readPosition(0),
+          m_numStages(0) {
+    for (std::uint64_t i = 0; i < kRingSize; ++i) {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+CallbackProfiler::StageId CallbackProfiler::registerStage(const QString& name) {
+    const auto locker = lockMutex(&m_mutex);
+    for (int i = 0; i < m_numStages; ++i) {
+        if (m_stageNames[i] == name) {
+            return i;
+        }
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_numStages < kMaxStages) {
+        return kInvalidStage;
+    }
+    m_stageNames[m_numStages] = name;
+    m_windows[m_numStages].durationsNs.resize(kStatisticsWindow);
+    return m_numStages++;
+}
+
+void CallbackProfiler::record(StageId stage, qint64 startNs, qint64 endNs) {
+    DEBUG_ASSERT(stage >= 0 && stage < kMaxStages);
+    if (t_threadIndex < 0) {
+        t_threadIndex = m_numThreads.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::uint64_t position = m_writePosition.load(std::memory_order_relaxed);
+    Slot* pSlot;
+    while (true) {
+        pSlot = &m_ring[position & (kRingSize - 1)];
+        const std::uint64_t sequence = pSlot->sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            if (m_writePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (sequence < position) {
+            // The consumer did not keep up
+            m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = m_writePosition.load(std::memory_order_relaxed);
+        }
+    }
+    pSlot->event = Event{stage, t_threadIndex, startNs, endNs - startNs};
+    pSlot->sequence.store(position + 1, std::memory_order_release);
+}
+
+bool CallbackProfiler::pop(Event* pEvent) {
+    Slot* pSlot = &m_ring[m_readPosition & (kRingSize - 1)];
+    if (pSlot->sequence.load(std::memory_order_acquire) != m_readPosition + 1) {
+        return false;
+    }
+    *pEvent = pSlot->event;
+    pSlot->sequence.store(m_readPosition + kRingSize, std::memory_order_release);
+    ++m_readPosition;
+    return true;
+}
+
+int CallbackProfiler::drain() {
+    const auto locker = lockMutex(&m_mutex);
+    int numEvents = 0;
+    Event event;
+    while (pop(&event)) {
+        ++numEvents;
+        StageWindow& window = m_windows[event.stage];
+        if (window.durationsNs.empty()) {
+            // Recorded for a stage that has not been registered
+            continue;
+        }
+        window.durationsNs[window.next] = event.durationNs;
+        window.next = (window.next + 1) % kStatisticsWindow;
+        window.count = std::min(window.count + 1, kStatisticsWindow);
+        m_trace.push_back(event);
+        if (m_trace.size() > kMaxTraceEvents) {
+            m_trace.pop_front();
+        }
+    }
+    return numEvents;
+}
+
+QList<CallbackProfiler::StageStatistics> CallbackProfiler::statistics() const {
+    const auto locker = lockMutex(&m_mutex);
+    QList<StageStatistics> result;
+    for (int i = 0; i < m_numStages; ++i) {
+        const StageWindow& window = m_windows[i];
+        if (window.count == 0) {
+            continue;
+        }
+        std::vector<qint64> sortedDurations(
+                window.durationsNs.begin(), window.durationsNs.begin() + window.count);
+        std::sort(sortedDurations.begin(), sortedDurations.end());
+        result.append(StageStatistics{m_stageNames[i],
+                window.count,
+                percentile(sortedDurations, 50),
+                percentile(sortedDurations, 99),
+                sortedDurations.back()});
+    }
+    return result;
+}
+
+QByteArray CallbackProfiler::chromeTraceJson() const {
+    const auto locker = lockMutex(&m_mutex);
+    QJsonArray traceEvents;
+    for (const auto& event : m_trace) {
+        // Timestamps and durations are in microseconds
+        traceEvents.append(QJsonObject{
+                {QStringLiteral("name"), m_stageNames[event.stage]},
+                {QStringLiteral("ph"), QStringLiteral("X")},
+                {QStringLiteral("ts"), event.startNs / 1000.0},
+                {QStringLiteral("dur"), event.durationNs / 1000.0},
+                {QStringLiteral("pid"), 1},
+                {QStringLiteral("tid"), event.thread},
+        });
+    }
+    return QJsonDocument(QJsonObject{
+                                 {QStringLiteral("traceEvents"), traceEvents},
+                                 {QStringLiteral("displayTimeUnit"), QStringLiteral("ns")},
+                         })
+            .toJson(QJsonDocument::Compact);
+}
+
+void CallbackProfiler::reset() {
+    const auto locker = lockMutex(&m_mutex);
+    Event event;
+    while (pop(&event)) {
+    }
+    for (auto& window : m_windows) {
+        window.next = 0;
+        window.count = 0;
+    }
+    m_trace.clear();
+    m_droppedEvents.store(0, std::memory_order_relaxed);
+}
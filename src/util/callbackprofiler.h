@@ -0,0 +1,152 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/// Records how long the stages of the audio callback take, e.g. each channel,
+/// effect and buffer scaler.
+///
+/// Stages are registered once outside of the audio callback. While enabled,
+/// each Scope pushes a timestamped event into a lock-free ring buffer that
+/// is shared by all threads working on the callback. The developer tools
+/// drain the ring buffer periodically, compute percentiles per stage and
+/// export the recorded events as a Chrome trace (chrome://tracing).
+///
+/// When disabled the overhead of a Scope is a single relaxed atomic load.
+class CallbackProfiler final {
+  public:
+    typedef int StageId;
+    static constexpr StageId kInvalidStage = -1;
+    static constexpr int kMaxStages = 512;
+
+    struct Event {
+        StageId stage;
+        int thread;
+        qint64 startNs;
+        qint64 durationNs;
+    };
+
+    struct StageStatistics {
+        QString name;
+        int count;
+        qint64 p50Ns;
+        qint64 p99Ns;
+        qint64 maxNs;
+    };
+
+    /// Measures the lifetime of the scope as one event of the stage.
+    class Scope final {
+      public:
+        explicit Scope(StageId stage)
+                : m_stage(stage),
+                  m_startNs(instance().isEnabled() && stage != kInvalidStage
+                                  ? nowNs()
+                                  : 0) {
+        }
+        ~Scope() {
+            if (m_startNs != 0) {
+                instance().record(m_stage, m_startNs, nowNs());
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        const StageId m_stage;
+        const qint64 m_startNs;
+    };
+
+    static CallbackProfiler& instance();
+
+    static qint64 nowNs();
+
+    /// Returns the existing id if a stage with this name has already been
+    /// registered, or kInvalidStage if there are too many stages.
+    /// Must not be called from the audio callback.
+    StageId registerStage(const QString& name);
+
+    void setEnabled(bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+    bool isEnabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// The duration of the audio buffer, i.e. the deadline for every
+    /// callback. Called from the audio callback.
+    void setDeadlineNs(qint64 deadlineNs) {
+        m_deadlineNs.store(deadlineNs, std::memory_order_relaxed);
+    }
+    qint64 deadlineNs() const {
+        return m_deadlineNs.load(std::memory_order_relaxed);
+    }
+
+    /// Lock-free. Events are dropped if the ring buffer is full.
+    void record(StageId stage, qint64 startNs, qint64 endNs);
+
+    /// The number of events that have been dropped because the ring buffer
+    /// was full.
+    int droppedEvents() const {
+        return m_droppedEvents.load(std::memory_order_relaxed);
+    }
+
+    /// Moves all events from the ring buffer into the statistics and the
+    /// trace. Returns the number of events.
+    int drain();
+
+    /// Percentiles of the most recent events of all stages.
+    QList<StageStatistics> statistics() const;
+
+    /// All events that have been drained since the last reset in the
+    /// Chrome trace event format.
+    QByteArray chromeTraceJson() const;
+
+    /// Discards all events and statistics. Registered stages are kept.
+    void reset();
+
+  private:
+    CallbackProfiler();
+
+    static constexpr std::uint64_t kRingSize = 1 << 16;
+    static constexpr int kStatisticsWindow = 1024;
+    static constexpr std::size_t kMaxTraceEvents = 200000;
+
+    // A bounded multi-producer, single-consumer queue. The sequence of a
+    // slot tells whether it is ready for writing or reading.
+    struct Slot {
+        std::atomic<std::uint64_t> sequence;
+        Event event;
+    };
+
+    struct StageWindow {
+        std::vector<qint64> durationsNs;
+        int next = 0;
+        int count = 0;
+    };
+
+    bool pop(Event* pEvent);
+
+    std::atomic<bool> m_enabled;
+    std::atomic<qint64> m_deadlineNs;
+    std::atomic<int> m_droppedEvents;
+    std::atomic<int> m_numThreads;
+
+    const std::unique_ptr<Slot[]> m_ring;
+    std::atomic<std::uint64_t> m_writePosition;
+    std::uint64_t m_readPosition;
+
+    // Guards the stage names and the consumer side
+    mutable QMutex m_mutex;
+    std::array<QString, kMaxStages> m_stageNames;
+    int m_numStages;
+    std::array<StageWindow, kMaxStages> m_windows;
+    std::deque<Event> m_trace;
+};
@@ -222,6 +222,25 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     parser.addOption(timelinePath);
     parser.addOption(timelinePathDeprecated);
 
+    const QCommandLineOption statsdTarget(QStringLiteral("statsd"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Send performance statistics like audio "
+                                      "callback durations and buffer underflows "
+                                      "in the statsd format to the given UDP "
+                                      "host and port every 10 seconds.")
+                            : QString(),
+            QStringLiteral("host:port"));
+    parser.addOption(statsdTarget);
+
+    const QCommandLineOption analyzeCrate(QStringLiteral("analyze"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Analyze all tracks of the given crate and quit "
+                                      "when done. An interrupted analysis is resumed "
+                                      "on the next start.")
+                            : QString(),
+            QStringLiteral("crate"));
+    parser.addOption(analyzeCrate);
+
     const QCommandLineOption enableLegacyVuMeter(QStringLiteral("enable-legacy-vumeter"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Use legacy vu meter")
@@ -411,6 +430,14 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_timelinePath = parser.value(timelinePathDeprecated);
     }
 
+    if (parser.isSet(statsdTarget)) {
+        m_statsdTarget = parser.value(statsdTarget);
+    }
+
+    if (parser.isSet(analyzeCrate)) {
+        m_analyzeCrate = parser.value(analyzeCrate);
+    }
+
     m_useLegacyVuMeter = parser.isSet(enableLegacyVuMeter);
     m_useLegacySpinny = parser.isSet(enableLegacySpinny);
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
@@ -70,6 +70,13 @@ class CmdlineArgs final {
     }
     const QString& getResourcePath() const { return m_resourcePath; }
     const QString& getTimelinePath() const { return m_timelinePath; }
+    /// The host:port the stats are sent to, see StatsdExporter
+    const QString& getStatsdTarget() const {
+        return m_statsdTarget;
+    }
+    const QString& getAnalyzeCrate() const {
+        return m_analyzeCrate;
+    }
 
     void setScaleFactor(double scaleFactor) {
         m_scaleFactor = scaleFactor;
@@ -110,4 +117,6 @@ class CmdlineArgs final {
     QString m_settingsPath;
     QString m_resourcePath;
     QString m_timelinePath;
+    QString m_statsdTarget;
+    QString m_analyzeCrate; // Crate to analyze before quitting
 };
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace mixxx {
+
+/// Transitional wrapper for std::atomic<std::shared_ptr<T>> that has been
+/// introduced in C++20, but is not yet provided by all standard libraries
+/// that are supported by Mixxx, e.g. libc++. Falls back to the atomic
+/// free functions for std::shared_ptr that are deprecated since C++20.
+template<typename T>
+class AtomicSharedPtr final {
+  public:
+    AtomicSharedPtr() = default;
+    explicit AtomicSharedPtr(std::shared_ptr<T> ptr)
+            : m_ptr(std::move(ptr)) {
+    }
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+    std::shared_ptr<T> load() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return m_ptr.load(std::memory_order_acquire);
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        return std::atomic_load_explicit(&m_ptr, std::memory_order_acquire);
+#pragma GCC diagnostic pop
+#endif
+    }
+
+    void store(std::shared_ptr<T> ptr) {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        m_ptr.store(std::move(ptr), std::memory_order_release);
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        std::atomic_store_explicit(&m_ptr, std::move(ptr), std::memory_order_release);
+#pragma GCC diagnostic pop
+#endif
+    }
+
+  private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<T>> m_ptr;
+#else
+    std::shared_ptr<T> m_ptr;
+#endif
+};
+
+} // namespace mixxx
@@ -0,0 +1,74 @@
+#include "util/controllerlatency.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "util/stat.h"
+#include "util/statsmanager.h"
+#include "util/time.h"
+
+namespace mixxx {
+
+namespace {
+
+const QString kInputLatencyTag =
+        QStringLiteral("ControllerLatency input to audio callback");
+const QString kOutputLatencyTag =
+        QStringLiteral("ControllerLatency output request to device");
+
+// The arrival time in nanoseconds of the oldest input event that changed a
+// control since the last audio callback, or 0 if there is none. Written by
+// the controller threads and consumed by the engine thread.
+std::atomic<qint64> s_pendingInputNanos{0};
+
+void trackLatency(const QString& tag, Duration latency) {
+    // The histogram stores distinct values, so they are rounded to 0.5 ms
+    const double latencyMillis = std::round(latency.toDoubleMillis() * 2) / 2;
+    Stat::track(tag,
+            Stat::DURATION_MSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE |
+                    Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX |
+                    Stat::HISTOGRAM),
+            latencyMillis);
+}
+
+} // anonymous namespace
+
+// static
+void ControllerLatency::markInputPending(Duration inputTimestamp) {
+    if (!StatsManager::s_bStatsManagerEnabled) {
+        return;
+    }
+    // 0 is reserved for no pending input
+    const qint64 inputNanos = std::max<qint64>(inputTimestamp.toIntegerNanos(), 1);
+    qint64 expected = 0;
+    // Keep the oldest input if another one is already pending
+    s_pendingInputNanos.compare_exchange_strong(expected,
+            inputNanos,
+            std::memory_order_release,
+            std::memory_order_relaxed);
+}
+
+// static
+void ControllerLatency::audioCallbackStarted() {
+    if (s_pendingInputNanos.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    const qint64 inputNanos = s_pendingInputNanos.exchange(0, std::memory_order_acquire);
+    if (inputNanos == 0) {
+        return;
+    }
+    trackLatency(kInputLatencyTag,
+            Time::elapsed() - Duration::fromNanos(inputNanos));
+}
+
+// static
+void ControllerLatency::outputSent(Duration requestTime) {
+    if (!StatsManager::s_bStatsManagerEnabled) {
+        return;
+    }
+    trackLatency(kOutputLatencyTag, Time::elapsed() - requestTime);
+}
+
+} // namespace mixxx
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "util/duration.h"
+#include "util/inputtimestamp.h"
+
+namespace mixxx {
+
+/// Measures the latency of controller input and output for tuning the audio
+/// buffer size and the controller polling. The latencies are reported to the
+/// StatsManager with a histogram of 0.5 ms buckets and are shown on the
+/// Stats tab of the developer tools:
+///
+/// - "ControllerLatency input to audio callback" is the time from the
+///   arrival of a controller input event that changed a control until the
+///   start of the next audio callback, which is the first one that can
+///   process the change. The latency of the audio buffer adds to this.
+/// - "ControllerLatency output request to device" is the time from the
+///   first request of an output, e.g. an LED update, until it has been
+///   written to the device.
+class ControllerLatency {
+  public:
+    /// Called for every change of a control. Only the changes made while
+    /// processing a controller input event are measured.
+    static void controlChanged() {
+        if (InputTimestamp::isActive()) {
+            markInputPending(InputTimestamp::current());
+        }
+    }
+
+    /// Called by the engine at the start of every audio callback.
+    static void audioCallbackStarted();
+
+    /// Called after an output that has been requested at requestTime has
+    /// been written to the device.
+    static void outputSent(Duration requestTime);
+
+  private:
+    static void markInputPending(Duration inputTimestamp);
+};
+
+} // namespace mixxx
@@ -1,5 +1,6 @@
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -7,6 +8,7 @@
 
 #include "util/db/dbconnection.h"
 
+#include "util/db/fwdsqlquery.h"
 #include "util/db/sqllikewildcards.h"
 #include "util/logger.h"
 #include "util/assert.h"
@@ -230,6 +232,30 @@ void sqliteLikeUtf8(sqlite3_context* context,
     return;
 }
 
+// This implements the DbConnection::kLatinLowFunction SQL function, which
+// is used to fill the full-text search index with the same strings that
+// are compared by the like() function.
+//static
+void sqliteLatinLowUtf8(sqlite3_context* context,
+        int aArgc,
+        sqlite3_value** aArgv) {
+    VERIFY_OR_DEBUG_ASSERT(aArgc == 1) {
+        return;
+    }
+
+    const char* a = reinterpret_cast<const char*>(
+            sqlite3_value_text(aArgv[0]));
+    if (!a) {
+        sqlite3_result_null(context);
+        return;
+    }
+
+    QString string = QString::fromUtf8(a);
+    DbConnection::makeStringLatinLow(&string);
+    const QByteArray utf8 = string.toUtf8();
+    sqlite3_result_text(context, utf8.constData(), utf8.size(), SQLITE_TRANSIENT);
+}
+
 #endif // __SQLITE3__
 
 bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator) {
@@ -304,6 +330,21 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
                 << "Failed to install custom 3-arg LIKE function for SQLite3:"
                 << result;
     }
+
+    result = sqlite3_create_function(
+            handle,
+            DbConnection::kLatinLowFunction,
+            1,
+            SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+            nullptr,
+            sqliteLatinLowUtf8,
+            nullptr,
+            nullptr);
+    VERIFY_OR_DEBUG_ASSERT(result == SQLITE_OK) {
+        kLogger.warning()
+                << "Failed to install custom latin low function for SQLite3:"
+                << result;
+    }
 #else
     Q_UNUSED(database);
     Q_UNUSED(pCollator);
@@ -311,18 +352,46 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
     return true;
 }
 
+void execStatements(
+        const QSqlDatabase& database,
+        const QStringList& statements) {
+    for (const auto& statement : statements) {
+        QSqlQuery query(database);
+        if (!query.exec(statement)) {
+            // The statements only configure the connection and
+            // failures are not fatal
+            kLogger.warning()
+                    << "Failed to execute"
+                    << statement
+                    << ":"
+                    << query.lastError();
+            continue;
+        }
+        if (kLogger.debugEnabled() && query.next()) {
+            kLogger.debug()
+                    << statement
+                    << "->"
+                    << query.value(0);
+        }
+    }
+}
+
 } // anonymous namespace
 
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_openStatements(params.openStatements),
+      m_closeStatements(params.closeStatements) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_openStatements(prototype.m_openStatements),
+      m_closeStatements(prototype.m_closeStatements) {
 }
 
 DbConnection::~DbConnection() {
@@ -350,6 +419,7 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+    execStatements(m_sqlDatabase, m_openStatements);
     return true;
 }
 
@@ -368,6 +438,8 @@ void DbConnection::close() {
                     << "Closing database connection:"
                     << *this;
         }
+        FwdSqlQuery::releaseCachedStatements(m_sqlDatabase);
+        execStatements(m_sqlDatabase, m_closeStatements);
         m_sqlDatabase.close();
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <QStringList>
 #include <QtDebug>
 
 #include "util/string.h"
@@ -22,6 +23,10 @@ class DbConnection final {
 
     static void makeStringLatinLow(QString* string);
 
+    // The name of a custom SQL function (SQLite3) with a single string
+    // argument that returns the string folded by makeStringLatinLow().
+    static constexpr char kLatinLowFunction[] = "mixxx_latin_low";
+
     struct Params {
         QString type;
         QString connectOptions;
@@ -29,6 +34,11 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        // Executed after opening each connection, e.g. PRAGMAs
+        // for configuring the connection
+        QStringList openStatements;
+        // Executed before closing each connection
+        QStringList closeStatements;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -62,6 +72,8 @@ class DbConnection final {
     DbConnection(const DbConnection&&) = delete;
 
     QSqlDatabase m_sqlDatabase;
+    const QStringList m_openStatements;
+    const QStringList m_closeStatements;
     mixxx::StringCollator m_collator;
 };
 
@@ -0,0 +1,145 @@
+#include "util/db/dbwritequeue.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "moc_dbwritequeue.cpp"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("DbWriteQueue");
+
+bool execStatement(const QSqlDatabase& database, const QString& statement) {
+    QSqlQuery query(database);
+    if (!query.exec(statement)) {
+        kLogger.warning()
+                << "Failed to execute"
+                << statement
+                << ":"
+                << query.lastError();
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+DbWriteQueue::DbWriteQueue(DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_stopping(false) {
+    setObjectName(QStringLiteral("DbWriteQueue"));
+}
+
+DbWriteQueue::~DbWriteQueue() {
+    {
+        const std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    wait();
+}
+
+void DbWriteQueue::enqueue(Write write,
+        QObject* pReceiver,
+        OnDone onDone) {
+    VERIFY_OR_DEBUG_ASSERT(write) {
+        return;
+    }
+    DEBUG_ASSERT(!onDone || pReceiver);
+    {
+        const std::lock_guard lock(m_mutex);
+        DEBUG_ASSERT(!m_stopping);
+        m_pendingRequests.append(Request{
+                std::move(write),
+                QPointer<QObject>(pReceiver),
+                std::move(onDone)});
+    }
+    m_condition.notify_one();
+}
+
+void DbWriteQueue::run() {
+    kLogger.debug() << "Entering thread";
+    const DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    const QSqlDatabase database = DbConnectionPooled(m_pDbConnectionPool);
+    while (true) {
+        QList<Request> batch;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] {
+                return m_stopping || !m_pendingRequests.isEmpty();
+            });
+            if (m_pendingRequests.isEmpty()) {
+                DEBUG_ASSERT(m_stopping);
+                break;
+            }
+            const int batchSize = std::min(
+                    kMaxBatchSize, static_cast<int>(m_pendingRequests.size()));
+            batch = m_pendingRequests.mid(0, batchSize);
+            m_pendingRequests.remove(0, batchSize);
+        }
+        executeBatch(database, std::move(batch));
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+void DbWriteQueue::executeBatch(
+        const QSqlDatabase& database, QList<Request>&& batch) const {
+    QList<bool> results;
+    results.reserve(batch.size());
+    // Acquire the write lock immediately instead of upgrading a read
+    // transaction, which would fail if another connection has written
+    // in the meantime. SQLite retries while another connection holds
+    // the lock.
+    bool committed = database.isOpen() &&
+            execStatement(database, QStringLiteral("BEGIN IMMEDIATE"));
+    if (committed) {
+        for (const auto& request : std::as_const(batch)) {
+            bool success = execStatement(database, QStringLiteral("SAVEPOINT write"));
+            if (success) {
+                success = request.write(database);
+                if (!success) {
+                    execStatement(database, QStringLiteral("ROLLBACK TO write"));
+                }
+                execStatement(database, QStringLiteral("RELEASE write"));
+            }
+            results.append(success);
+        }
+        committed = execStatement(database, QStringLiteral("COMMIT"));
+        if (!committed) {
+            execStatement(database, QStringLiteral("ROLLBACK"));
+        }
+    }
+    if (!committed) {
+        kLogger.warning()
+                << "Failed to commit"
+                << batch.size()
+                << "writes";
+    }
+    for (int i = 0; i < batch.size(); ++i) {
+        const auto& request = batch[i];
+        if (!request.onDone) {
+            continue;
+        }
+        const bool success = committed && results[i];
+        // The receiver lives in the same thread as this object and
+        // must only be checked there
+        QMetaObject::invokeMethod(
+                const_cast<DbWriteQueue*>(this),
+                [pReceiver = request.pReceiver,
+                        onDone = request.onDone,
+                        success]() {
+                    if (pReceiver) {
+                        onDone(success);
+                    }
+                },
+                Qt::QueuedConnection);
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QList>
+#include <QPointer>
+#include <QSqlDatabase>
+#include <QThread>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "util/db/dbconnectionpool.h"
+
+namespace mixxx {
+
+/// DbWriteQueue executes database writes one after another on its own
+/// thread and connection, so the thread that enqueues them never blocks
+/// on disk or on the single writer lock of SQLite.
+///
+/// All writes that are pending when the thread wakes up are executed
+/// within a single transaction. Each write is wrapped into a savepoint,
+/// i.e. a failing write is rolled back without affecting the others.
+///
+/// Writes must only access the database that is passed to them. Their
+/// completion callbacks are invoked after the batch has been committed
+/// in the thread that created the queue, which must be the thread of
+/// the receiver. Nothing is invoked after the receiver has been deleted.
+/// All pending writes are executed before the queue is destroyed.
+class DbWriteQueue : public QThread {
+    Q_OBJECT
+  public:
+    typedef std::function<bool(const QSqlDatabase& database)> Write;
+    typedef std::function<void(bool success)> OnDone;
+
+    /// The maximum number of writes that are committed together.
+    static constexpr int kMaxBatchSize = 100;
+
+    explicit DbWriteQueue(DbConnectionPoolPtr pDbConnectionPool);
+    ~DbWriteQueue() override;
+
+    void enqueue(Write write,
+            QObject* pReceiver = nullptr,
+            OnDone onDone = nullptr);
+
+  protected:
+    void run() override;
+
+  private:
+    struct Request {
+        Write write;
+        QPointer<QObject> pReceiver;
+        OnDone onDone;
+    };
+
+    void executeBatch(const QSqlDatabase& database, QList<Request>&& batch) const;
+
+    const DbConnectionPoolPtr m_pDbConnectionPool;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    QList<Request> m_pendingRequests;
+    bool m_stopping;
+};
+
+} // namespace mixxx
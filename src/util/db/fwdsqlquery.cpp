@@ -1,5 +1,9 @@
 #include "util/db/fwdsqlquery.h"
 
+#include <QSqlDriver>
+#include <unordered_map>
+#include <utility>
+
 #include "util/performancetimer.h"
 #include "util/logger.h"
 #include "util/assert.h"
@@ -28,13 +32,22 @@ bool prepareQuery(QSqlQuery& query, const QString& statement) {
     }
 }
 
+// The prepared statements that are currently not in use, by statement
+// and driver. Each driver belongs to a single connection and all
+// connections are only accessed from the thread that opened them.
+// QSqlQuery should not be copied and QHash would require copyable values.
+thread_local std::unordered_map<const QSqlDriver*,
+        std::unordered_map<QString, QSqlQuery>>
+        s_cachedQueries;
+
 } // anonymous namespace
 
 FwdSqlQuery::FwdSqlQuery(
         const QSqlDatabase& database,
         const QString& statement)
         : QSqlQuery(database),
-          m_prepared(prepareQuery(*this, statement)) {
+          m_prepared(prepareQuery(*this, statement)),
+          m_cached(false) {
     if (!m_prepared) {
         DEBUG_ASSERT(!database.isOpen() || hasError());
         if (hasDuplicateColumnNameError()) {
@@ -56,6 +69,78 @@ FwdSqlQuery::FwdSqlQuery(
     }
 }
 
+FwdSqlQuery::FwdSqlQuery(QSqlQuery&& cachedQuery)
+        : QSqlQuery(std::move(cachedQuery)),
+          m_prepared(true),
+          m_cached(true) {
+}
+
+FwdSqlQuery::FwdSqlQuery(FwdSqlQuery&& other)
+        : QSqlQuery(std::move(other)),
+          m_prepared(std::exchange(other.m_prepared, false)),
+          m_cached(std::exchange(other.m_cached, false)) {
+}
+
+FwdSqlQuery::~FwdSqlQuery() {
+    if (m_cached) {
+        returnToCache();
+    }
+}
+
+FwdSqlQuery& FwdSqlQuery::operator=(FwdSqlQuery&& other) {
+    if (this != &other) {
+        if (m_cached) {
+            returnToCache();
+        }
+        QSqlQuery::operator=(std::move(other));
+        m_prepared = std::exchange(other.m_prepared, false);
+        m_cached = std::exchange(other.m_cached, false);
+    }
+    return *this;
+}
+
+//static
+FwdSqlQuery FwdSqlQuery::prepareCached(
+        const QSqlDatabase& database,
+        const QString& statement) {
+    const auto cachedQueries = s_cachedQueries.find(database.driver());
+    if (cachedQueries != s_cachedQueries.end()) {
+        const auto cachedQuery = cachedQueries->second.find(statement);
+        if (cachedQuery != cachedQueries->second.end()) {
+            FwdSqlQuery query(std::move(cachedQuery->second));
+            cachedQueries->second.erase(cachedQuery);
+            return query;
+        }
+    }
+    // Either the statement has not been prepared yet or it is still in
+    // use by another query, e.g. when selecting recursively
+    FwdSqlQuery query(database, statement);
+    query.m_cached = query.isPrepared();
+    return query;
+}
+
+//static
+void FwdSqlQuery::releaseCachedStatements(
+        const QSqlDatabase& database) {
+    s_cachedQueries.erase(database.driver());
+}
+
+void FwdSqlQuery::returnToCache() {
+    DEBUG_ASSERT(m_cached);
+    m_cached = false;
+    const QSqlDriver* pDriver = driver();
+    if (!pDriver || !pDriver->isOpen() || hasError()) {
+        // Discard the statement
+        return;
+    }
+    // Reset the statement to release all locks, while keeping it prepared
+    finish();
+    // Keep the statement that has been returned first, if the same
+    // statement has been prepared twice while still in use
+    s_cachedQueries[pDriver].try_emplace(
+            lastQuery(), std::move(*static_cast<QSqlQuery*>(this)));
+}
+
 bool FwdSqlQuery::hasDuplicateColumnNameError() const {
     return hasError() &&
             lastError().databaseText().startsWith(
@@ -39,16 +39,36 @@ class FwdSqlQuery final : protected QSqlQuery {
 
   public:
     FwdSqlQuery()
-            : m_prepared(false) {
+            : m_prepared(false),
+              m_cached(false) {
     }
     FwdSqlQuery(
             const QSqlDatabase& database,
             const QString& statement);
     // The copy constructor of QSqlQuery is marked as deprecated in Qt6
     FwdSqlQuery(const FwdSqlQuery&) = delete;
-    FwdSqlQuery(FwdSqlQuery&&) = default;
+    FwdSqlQuery(FwdSqlQuery&& other);
+    ~FwdSqlQuery();
+
+    FwdSqlQuery& operator=(FwdSqlQuery&& other);
+
+    /// Returns a query for a statement that is executed repeatedly, e.g.
+    /// once per track. The statement is only prepared once per database
+    /// connection and reused by all subsequent queries with the same
+    /// statement after the previous query has been destroyed. Values that
+    /// have been bound by the previous query must be bound again.
+    ///
+    /// Only use this for statements with a constant text that don't
+    /// contain any values, otherwise the cache would grow unbounded.
+    static FwdSqlQuery prepareCached(
+            const QSqlDatabase& database,
+            const QString& statement);
 
-    FwdSqlQuery& operator=(FwdSqlQuery&&) = default;
+    /// Finalizes all cached statements of the database connection.
+    /// Must be invoked from the thread of the connection before
+    /// closing it.
+    static void releaseCachedStatements(
+            const QSqlDatabase& database);
 
     bool isPrepared() const {
         return m_prepared;
@@ -118,5 +138,11 @@ class FwdSqlQuery final : protected QSqlQuery {
     bool fieldValueBoolean(DbFieldIndex fieldIndex) const;
 
   private:
+    explicit FwdSqlQuery(QSqlQuery&& cachedQuery);
+
+    void returnToCache();
+
     bool m_prepared;
+    // Returned to the cache of the connection when destroyed
+    bool m_cached;
 };
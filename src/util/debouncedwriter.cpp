@@ -0,0 +1,59 @@
+#include "util/debouncedwriter.h"
+
+#include "util/compatibility/qmutex.h"
+
+namespace mixxx {
+
+DebouncedWriter::DebouncedWriter(
+        std::function<void()> write, std::chrono::milliseconds delay)
+        : m_write(std::move(write)),
+          m_delay(delay),
+          m_pending(false),
+          m_stop(false) {
+    start(QThread::LowPriority);
+}
+
+DebouncedWriter::~DebouncedWriter() {
+    stop();
+}
+
+void DebouncedWriter::schedule() {
+    const auto locker = lockMutex(&m_mutex);
+    m_pending = true;
+    m_deadline.setRemainingTime(m_delay);
+    m_scheduled.wakeAll();
+}
+
+void DebouncedWriter::stop() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_stop = true;
+        m_scheduled.wakeAll();
+    }
+    wait();
+    if (m_pending) {
+        m_pending = false;
+        m_write();
+    }
+}
+
+void DebouncedWriter::run() {
+    auto locker = lockMutex(&m_mutex);
+    while (!m_stop) {
+        if (!m_pending) {
+            m_scheduled.wait(&m_mutex);
+            continue;
+        }
+        if (!m_deadline.hasExpired()) {
+            // Wait until the deadline, which moves with every schedule()
+            m_scheduled.wait(&m_mutex, m_deadline);
+            continue;
+        }
+        m_pending = false;
+        locker.unlock();
+        m_write();
+        locker.relock();
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QDeadlineTimer>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <chrono>
+#include <functional>
+
+namespace mixxx {
+
+/// Runs a write function on a background thread once no further write has
+/// been scheduled for the given delay.
+///
+/// A burst of changes, e.g. while dragging a slider in the preferences,
+/// results in a single write after the last change. schedule() never waits
+/// for a write in progress, so it can be called on the GUI thread.
+class DebouncedWriter : public QThread {
+  public:
+    DebouncedWriter(std::function<void()> write, std::chrono::milliseconds delay);
+    /// Runs a pending write before returning
+    ~DebouncedWriter() override;
+
+    /// Runs the write after the delay, unless it is scheduled again
+    void schedule();
+
+    /// Stops the thread and runs a pending write on the calling thread
+    void stop();
+
+  private:
+    void run() override;
+
+    const std::function<void()> m_write;
+    const std::chrono::milliseconds m_delay;
+
+    QMutex m_mutex;
+    QWaitCondition m_scheduled;
+    QDeadlineTimer m_deadline;
+    bool m_pending;
+    bool m_stop;
+};
+
+} // namespace mixxx
@@ -21,7 +21,10 @@ constexpr unsigned int kMaxEngineChannels = 2;
 constexpr unsigned int kMaxEngineSamples = kMaxEngineChannels * kMaxEngineFrames;
 constexpr unsigned int MAX_BUFFER_LEN = 160000;
 
-constexpr int kMaxNumberOfDecks = 4;
+// Decks beyond the 4 decks of the skins are controlled by controllers or
+// scripts, e.g. for automation. Decks that are not playing are not
+// processed and their caching reader only keeps a minimum of chunks.
+constexpr int kMaxNumberOfDecks = 16;
 
 // Keyboard shortcut components for showing the Track Properties dialog and
 // for displaying the shortcut in the track context menu
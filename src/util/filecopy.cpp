@@ -0,0 +1,230 @@
+#include "util/filecopy.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+
+#include "util/logger.h"
+
+#if defined(__LINUX__)
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#elif defined(__WINDOWS__)
+#include <Windows.h>
+
+#include <QDir>
+#endif
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("FileCopy");
+
+// Large enough to keep USB and NVMe drives busy
+constexpr qint64 kBufferSize = 4 * 1024 * 1024;
+
+bool copyFileBuffered(
+        const QString& sourcePath,
+        const QString& destPath,
+        QString* pErrorMessage) {
+    QFile sourceFile(sourcePath);
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        *pErrorMessage = sourceFile.errorString();
+        return false;
+    }
+    QFile destFile(destPath);
+    if (!destFile.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+        *pErrorMessage = destFile.errorString();
+        return false;
+    }
+    QByteArray buffer(static_cast<int>(std::min(kBufferSize, sourceFile.size()) + 1), '\0');
+    while (true) {
+        const qint64 bytesRead = sourceFile.read(buffer.data(), buffer.size());
+        if (bytesRead == 0) {
+            break;
+        }
+        if (bytesRead < 0) {
+            *pErrorMessage = sourceFile.errorString();
+            destFile.remove();
+            return false;
+        }
+        if (destFile.write(buffer.constData(), bytesRead) != bytesRead) {
+            *pErrorMessage = destFile.errorString();
+            destFile.remove();
+            return false;
+        }
+    }
+    // Preserve the permissions like QFile::copy()
+    destFile.setPermissions(sourceFile.permissions());
+    return true;
+}
+
+#if defined(__LINUX__)
+
+enum class CopyResult {
+    Succeeded,
+    Failed,
+    // The destination file is still empty, another method could be tried
+    Unsupported,
+};
+
+CopyResult copyFileInKernel(
+        int sourceFd,
+        int destFd,
+        off_t size,
+        QString* pErrorMessage) {
+    off_t copied = 0;
+    // copy_file_range() has been added in glibc 2.27
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    while (copied < size) {
+        const ssize_t result = copy_file_range(
+                sourceFd, nullptr, destFd, nullptr, size - copied, 0);
+        if (result < 0) {
+            if (copied == 0 &&
+                    (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                            errno == EOPNOTSUPP)) {
+                // Not supported between these file systems or kernels
+                break;
+            }
+            *pErrorMessage = QString::fromLocal8Bit(std::strerror(errno));
+            return CopyResult::Failed;
+        }
+        if (result == 0) {
+            break;
+        }
+        copied += result;
+    }
+    if (copied > 0) {
+        return copied == size ? CopyResult::Succeeded : CopyResult::Failed;
+    }
+#endif
+    while (copied < size) {
+        const ssize_t result = sendfile(destFd, sourceFd, nullptr, size - copied);
+        if (result < 0) {
+            if (copied == 0 && (errno == EINVAL || errno == ENOSYS)) {
+                return CopyResult::Unsupported;
+            }
+            *pErrorMessage = QString::fromLocal8Bit(std::strerror(errno));
+            return CopyResult::Failed;
+        }
+        if (result == 0) {
+            // The file has been truncated while copying
+            *pErrorMessage = QStringLiteral("Unexpected end of file");
+            return CopyResult::Failed;
+        }
+        copied += result;
+    }
+    return CopyResult::Succeeded;
+}
+
+#endif
+
+} // anonymous namespace
+
+bool copyFile(
+        const QString& sourcePath,
+        const QString& destPath,
+        QString* pErrorMessage) {
+    QString errorMessage;
+    if (!pErrorMessage) {
+        pErrorMessage = &errorMessage;
+    }
+    if (QFileInfo::exists(destPath)) {
+        *pErrorMessage = QStringLiteral("Destination file already exists");
+        return false;
+    }
+#if defined(__LINUX__)
+    const QByteArray sourcePathEncoded = QFile::encodeName(sourcePath);
+    const QByteArray destPathEncoded = QFile::encodeName(destPath);
+    const int sourceFd = open(sourcePathEncoded.constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        *pErrorMessage = QString::fromLocal8Bit(std::strerror(errno));
+        return false;
+    }
+    struct stat sourceStat;
+    if (fstat(sourceFd, &sourceStat) != 0) {
+        *pErrorMessage = QString::fromLocal8Bit(std::strerror(errno));
+        close(sourceFd);
+        return false;
+    }
+    const int destFd = open(destPathEncoded.constData(),
+            O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+            sourceStat.st_mode & 0777);
+    if (destFd < 0) {
+        *pErrorMessage = QString::fromLocal8Bit(std::strerror(errno));
+        close(sourceFd);
+        return false;
+    }
+    const CopyResult result = copyFileInKernel(
+            sourceFd, destFd, sourceStat.st_size, pErrorMessage);
+    close(sourceFd);
+    if (close(destFd) != 0 && result == CopyResult::Succeeded) {
+        *pErrorMessage = QString::fromLocal8Bit(std::strerror(errno));
+        unlink(destPathEncoded.constData());
+        return false;
+    }
+    switch (result) {
+    case CopyResult::Succeeded:
+        return true;
+    case CopyResult::Failed:
+        kLogger.warning()
+                << "Failed to copy"
+                << sourcePath
+                << "to"
+                << destPath
+                << *pErrorMessage;
+        unlink(destPathEncoded.constData());
+        return false;
+    case CopyResult::Unsupported:
+        // Nothing has been written, start over with the buffered copy
+        unlink(destPathEncoded.constData());
+        break;
+    }
+#elif defined(__APPLE__)
+    if (clonefile(QFile::encodeName(sourcePath).constData(),
+                QFile::encodeName(destPath).constData(),
+                0) == 0) {
+        return true;
+    }
+    // Not supported by the file system or across volumes
+#elif defined(__WINDOWS__)
+    BOOL cancel = FALSE;
+    if (CopyFileExW(reinterpret_cast<LPCWSTR>(
+                            QDir::toNativeSeparators(sourcePath).utf16()),
+                reinterpret_cast<LPCWSTR>(
+                        QDir::toNativeSeparators(destPath).utf16()),
+                nullptr,
+                nullptr,
+                &cancel,
+                COPY_FILE_FAIL_IF_EXISTS)) {
+        return true;
+    }
+    kLogger.debug()
+            << "CopyFileEx failed with error"
+            << GetLastError()
+            << "for"
+            << sourcePath;
+    // Remove a partially written file
+    QFile::remove(destPath);
+#endif
+    if (!copyFileBuffered(sourcePath, destPath, pErrorMessage)) {
+        kLogger.warning()
+                << "Failed to copy"
+                << sourcePath
+                << "to"
+                << destPath
+                << *pErrorMessage;
+        return false;
+    }
+    return true;
+}
+
+} // namespace mixxx
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QString>
+
+namespace mixxx {
+
+/// Copies a file with the fastest method that the platform offers:
+///
+///  - Linux: copy_file_range() that avoids copying the data through user
+///    space and may even share extents on file systems like Btrfs or XFS,
+///    falling back to sendfile().
+///  - macOS: clonefile() that creates a copy-on-write clone on APFS.
+///  - Windows: CopyFileEx() that lets the OS manage the I/O.
+///
+/// Otherwise the data is copied with large buffers.
+///
+/// The destination file must not exist. A partially written destination
+/// file is removed on failure. Thread-safe, i.e. multiple files can be
+/// copied in parallel.
+bool copyFile(
+        const QString& sourcePath,
+        const QString& destPath,
+        QString* pErrorMessage = nullptr);
+
+} // namespace mixxx
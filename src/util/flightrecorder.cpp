@@ -0,0 +1,172 @@
+#include "util/flightrecorder.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <chrono>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+// Shared by all instances, so each thread has the same index in all traces
+std::atomic<int> s_numThreads{0};
+thread_local int t_threadIndex = -1;
+thread_local int t_callbackDepth = 0;
+
+int currentThreadIndex() {
+    if (t_threadIndex < 0) {
+        t_threadIndex = s_numThreads.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t_threadIndex;
+}
+
+} // anonymous namespace
+
+FlightRecorder::CallbackScope::CallbackScope() {
+    ++t_callbackDepth;
+}
+
+FlightRecorder::CallbackScope::~CallbackScope() {
+    --t_callbackDepth;
+}
+
+// static
+bool FlightRecorder::isInCallback() {
+    return t_callbackDepth > 0;
+}
+
+FlightRecorder::FlightRecorder(std::uint64_t ringSize)
+        : m_ringSize(ringSize),
+          m_ring(new Slot[ringSize]),
+          m_writePosition(0) {
+    DEBUG_ASSERT(ringSize > 0 && (ringSize & (ringSize - 1)) == 0);
+    for (std::uint64_t i = 0; i < m_ringSize; ++i) {
+        m_ring[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+// static
+FlightRecorder& FlightRecorder::instance() {
+    static FlightRecorder s_instance;
+    return s_instance;
+}
+
+// static
+qint64 FlightRecorder::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+FlightRecorder::NameId FlightRecorder::registerName(const QString& name) {
+    const auto locker = lockMutex(&m_mutex);
+    const auto it = m_nameIds.constFind(name);
+    if (it != m_nameIds.constEnd()) {
+        return it.value();
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_names.size() < kMaxNames) {
+        return kInvalidName;
+    }
+    const NameId nameId = static_cast<NameId>(m_names.size());
+    m_names.append(name);
+    m_nameIds.insert(name, nameId);
+    return nameId;
+}
+
+void FlightRecorder::nameCurrentThread(const QString& name) {
+    const int thread = currentThreadIndex();
+    const auto locker = lockMutex(&m_mutex);
+    m_threadNames.insert(thread, name);
+}
+
+void FlightRecorder::recordSpan(NameId name, qint64 startNs, qint64 endNs) {
+    if (name == kInvalidName) {
+        return;
+    }
+    record(Event{name, currentThreadIndex(), startNs, endNs - startNs, 0.0});
+}
+
+void FlightRecorder::recordInstant(NameId name, double value) {
+    if (name == kInvalidName) {
+        return;
+    }
+    record(Event{name, currentThreadIndex(), nowNs(), kInstant, value});
+}
+
+void FlightRecorder::record(const Event& event) {
+    const std::uint64_t position = m_writePosition.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_ring[position & (m_ringSize - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.sequence.store(position + 1, std::memory_order_release);
+}
+
+std::vector<FlightRecorder::Event> FlightRecorder::snapshot(qint64 sinceNs) const {
+    const std::uint64_t end = m_writePosition.load(std::memory_order_acquire);
+    const std::uint64_t begin = end > m_ringSize ? end - m_ringSize : 0;
+    std::vector<Event> events;
+    events.reserve(end - begin);
+    for (std::uint64_t position = begin; position < end; ++position) {
+        const Slot& slot = m_ring[position & (m_ringSize - 1)];
+        const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != position + 1) {
+            // Still being written or already overwritten
+            continue;
+        }
+        const Event event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        const qint64 endNs = event.startNs + std::max<qint64>(event.durationNs, 0);
+        if (endNs >= sinceNs) {
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+QByteArray FlightRecorder::chromeTraceJson(const std::vector<Event>& events) const {
+    const auto locker = lockMutex(&m_mutex);
+    QJsonArray traceEvents;
+    for (auto it = m_threadNames.constBegin(); it != m_threadNames.constEnd(); ++it) {
+        traceEvents.append(QJsonObject{
+                {QStringLiteral("name"), QStringLiteral("thread_name")},
+                {QStringLiteral("ph"), QStringLiteral("M")},
+                {QStringLiteral("pid"), 1},
+                {QStringLiteral("tid"), it.key()},
+                {QStringLiteral("args"), QJsonObject{{QStringLiteral("name"), it.value()}}},
+        });
+    }
+    for (const auto& event : events) {
+        VERIFY_OR_DEBUG_ASSERT(event.name >= 0 && event.name < m_names.size()) {
+            continue;
+        }
+        // Timestamps and durations are in microseconds
+        QJsonObject traceEvent{
+                {QStringLiteral("name"), m_names[event.name]},
+                {QStringLiteral("ts"), event.startNs / 1000.0},
+                {QStringLiteral("pid"), 1},
+                {QStringLiteral("tid"), event.thread},
+        };
+        if (event.durationNs == kInstant) {
+            traceEvent.insert(QStringLiteral("ph"), QStringLiteral("i"));
+            traceEvent.insert(QStringLiteral("s"), QStringLiteral("t"));
+            traceEvent.insert(QStringLiteral("args"),
+                    QJsonObject{{QStringLiteral("value"), event.value}});
+        } else {
+            traceEvent.insert(QStringLiteral("ph"), QStringLiteral("X"));
+            traceEvent.insert(QStringLiteral("dur"), event.durationNs / 1000.0);
+        }
+        traceEvents.append(traceEvent);
+    }
+    return QJsonDocument(QJsonObject{
+                                 {QStringLiteral("traceEvents"), traceEvents},
+                                 {QStringLiteral("displayTimeUnit"), QStringLiteral("ns")},
+                         })
+            .toJson(QJsonDocument::Compact);
+}
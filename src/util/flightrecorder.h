@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Keeps the most recent events of all threads for analyzing audio buffer
+/// underflows after they happened, like the flight recorder of an aircraft.
+///
+/// Unlike the CallbackProfiler it is always enabled. The events are written
+/// into a fixed size ring buffer that overwrites the oldest events, so it
+/// never needs to be drained. Recording an event is lock-free and wait-free
+/// and costs a few atomic operations. Recorded are the audio callbacks,
+/// the work of the CachingReaderWorkers including disk I/O, stalls of the
+/// GUI thread, control changes from the GUI and controllers, and the
+/// underflows themselves.
+///
+/// The SoundManager writes the events of the last seconds as a Chrome trace
+/// (chrome://tracing or ui.perfetto.dev) after each underflow.
+class FlightRecorder final {
+  public:
+    typedef int NameId;
+    static constexpr NameId kInvalidName = -1;
+    static constexpr int kMaxNames = 16384;
+    static constexpr std::uint64_t kDefaultRingSize = 1 << 16;
+
+    struct Event {
+        NameId name;
+        int thread;
+        qint64 startNs;
+        // kInstant for events without a duration
+        qint64 durationNs;
+        double value;
+    };
+    static constexpr qint64 kInstant = -1;
+
+    /// Records the lifetime of the scope as a span.
+    class Scope final {
+      public:
+        explicit Scope(NameId name)
+                : m_name(name),
+                  m_startNs(name != kInvalidName ? nowNs() : 0) {
+        }
+        ~Scope() {
+            if (m_name != kInvalidName) {
+                instance().recordSpan(m_name, m_startNs, nowNs());
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        const NameId m_name;
+        const qint64 m_startNs;
+    };
+
+    /// Marks the current thread as processing the audio callback. Control
+    /// changes are not recorded inside, because the engine changes many
+    /// controls in every callback. Scopes may be nested.
+    class CallbackScope final {
+      public:
+        CallbackScope();
+        ~CallbackScope();
+        CallbackScope(const CallbackScope&) = delete;
+        CallbackScope& operator=(const CallbackScope&) = delete;
+    };
+
+    static bool isInCallback();
+
+    /// The ring size must be a power of 2
+    explicit FlightRecorder(std::uint64_t ringSize = kDefaultRingSize);
+
+    static FlightRecorder& instance();
+
+    static qint64 nowNs();
+
+    /// Returns the existing id if the name has already been registered,
+    /// or kInvalidName if there are too many names. Must not be called
+    /// from the audio callback.
+    NameId registerName(const QString& name);
+
+    /// Names the current thread in the trace. Must not be called from the
+    /// audio callback.
+    void nameCurrentThread(const QString& name);
+
+    /// Lock-free. Ignores kInvalidName.
+    void recordSpan(NameId name, qint64 startNs, qint64 endNs);
+    void recordInstant(NameId name, double value = 0.0);
+
+    /// A copy of all events that ended at or after sinceNs, ordered by
+    /// the time of recording. Events that are overwritten while copying
+    /// them are skipped.
+    std::vector<Event> snapshot(qint64 sinceNs) const;
+
+    /// The events in the Chrome trace event format
+    QByteArray chromeTraceJson(const std::vector<Event>& events) const;
+
+  private:
+    // Each slot is guarded by its sequence like a seqlock. The sequence is
+    // 0 while the event is written and the write position + 1 afterwards.
+    struct Slot {
+        std::atomic<std::uint64_t> sequence;
+        Event event;
+    };
+
+    void record(const Event& event);
+
+    const std::uint64_t m_ringSize;
+    const std::unique_ptr<Slot[]> m_ring;
+    std::atomic<std::uint64_t> m_writePosition;
+
+    // Guards the names
+    mutable QMutex m_mutex;
+    QStringList m_names;
+    QHash<QString, NameId> m_nameIds;
+    QHash<int, QString> m_threadNames;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "util/duration.h"
+#include "util/time.h"
+
+namespace mixxx {
+
+/// The arrival time of the controller input event that is processed by the
+/// calling thread, in the time base of mixxx::Time::elapsed().
+///
+/// Controls that are changed by controller mappings can use it instead of
+/// the time of the change, which lags behind the arrival by the poll
+/// interval and the run time of the mapping scripts.
+class InputTimestamp {
+  public:
+    /// Returns the arrival time of the current input event or the current
+    /// time if the calling thread does not process an input event.
+    static Duration current() {
+        if (s_active) {
+            return s_timestamp;
+        }
+        return Time::elapsed();
+    }
+
+    /// Whether the calling thread processes an input event.
+    static bool isActive() {
+        return s_active;
+    }
+
+  private:
+    friend class ScopedInputTimestamp;
+
+    static inline thread_local bool s_active = false;
+    static inline thread_local Duration s_timestamp;
+};
+
+/// Publishes the arrival time of an input event to
+/// InputTimestamp::current() while it is being processed.
+class ScopedInputTimestamp {
+  public:
+    explicit ScopedInputTimestamp(Duration timestamp)
+            : m_wasActive(InputTimestamp::s_active),
+              m_previousTimestamp(InputTimestamp::s_timestamp) {
+        InputTimestamp::s_active = true;
+        InputTimestamp::s_timestamp = timestamp;
+    }
+    ~ScopedInputTimestamp() {
+        InputTimestamp::s_active = m_wasActive;
+        InputTimestamp::s_timestamp = m_previousTimestamp;
+    }
+
+    ScopedInputTimestamp(const ScopedInputTimestamp&) = delete;
+    ScopedInputTimestamp& operator=(const ScopedInputTimestamp&) = delete;
+
+  private:
+    const bool m_wasActive;
+    const Duration m_previousTimestamp;
+};
+
+} // namespace mixxx
@@ -13,15 +13,18 @@
 #include <QString>
 #include <QTextStream>
 #include <QThread>
+#include <atomic>
 #include <string_view>
 
 #include "util/assert.h"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qmutex.h"
+#include "util/mpscqueue.h"
 
 namespace {
 
-/// Mutex guarding s_logfile.
+/// Mutex guarding s_logfile. It is also held while writing the pending
+/// messages of the asynchronous writer, which keeps them in order.
 QMutex s_mutexLogfile;
 
 /// Mutex guarding stderr.
@@ -146,18 +149,32 @@ inline QString formatLogFileMessage(
     return QStringLiteral("%1 %2 [%3] %4").arg(timestamp, levelName, threadName, message);
 }
 
-/// Actually write a log message to a file.
-inline void writeToFile(
+/// Format a log message for the log file.
+inline QByteArray formatFileMessage(
         QtMsgType type,
         const QString& message,
-        const QString& threadName,
-        bool flush) {
-    QString formattedMessageStr =
-            formatLogFileMessage(type, message, threadName) +
-            QChar('\n');
-    QByteArray formattedMessage = formattedMessageStr.toLocal8Bit();
+        const QString& threadName) {
+    const QString formattedMessage =
+            formatLogFileMessage(type, message, threadName) + QChar('\n');
+    return formattedMessage.toLocal8Bit();
+}
 
-    const auto locked = lockMutex(&s_mutexLogfile);
+/// Format a log message for stderr, according to QT_MESSAGE_PATTERN.
+inline QByteArray formatStdErrMessage(
+        QtMsgType type,
+        const QMessageLogContext& context,
+        const QString& message,
+        const QString& threadName) {
+    QString formattedMessage = qFormatLogMessage(type, context, message) + QChar('\n');
+    return formattedMessage.replace(kThreadNamePattern, threadName).toLocal8Bit();
+}
+
+/// Actually write formatted log messages to a file.
+///
+/// s_mutexLogfile must be held by the caller.
+inline void writeToFile(
+        const QByteArray& formattedMessage,
+        bool flush) {
     // Writing to a closed QFile could cause an infinite recursive loop
     // by logging to qWarning!
     if (s_logfile.isOpen()) {
@@ -172,18 +189,10 @@ inline void writeToFile(
     }
 }
 
-/// Actually write a log message to stderr.
+/// Actually write formatted log messages to stderr.
 inline void writeToStdErr(
-        QtMsgType type,
-        const QMessageLogContext& context,
-        const QString& message,
-        const QString& threadName,
+        const QByteArray& formattedMessage,
         bool flush) {
-    QString formattedMessageStr = qFormatLogMessage(type, context, message) + QChar('\n');
-    const QByteArray formattedMessage =
-            formattedMessageStr.replace(kThreadNamePattern, threadName)
-                    .toLocal8Bit();
-
     const auto locked = lockMutex(&s_mutexStdErr);
     const std::size_t written = fwrite(
             formattedMessage.constData(), sizeof(char), formattedMessage.size(), stderr);
@@ -200,6 +209,101 @@ inline void writeToStdErr(
     }
 }
 
+/// A log message that has been formatted by the logging thread. Either of
+/// the outputs may be empty.
+struct PendingMessage {
+    QByteArray stdErr;
+    QByteArray file;
+};
+
+/// The number of messages that may be pending before further messages are
+/// dropped.
+constexpr std::size_t kPendingMessageCapacity = 4096;
+
+/// The interval in which the pending messages are written in a batch.
+constexpr unsigned long kWriteIntervalMillis = 20;
+
+/// Writes log messages from a dedicated thread, so logging never waits for
+/// stderr or the file system, e.g. on the controller thread while debugging
+/// a mapping.
+///
+/// The logging threads only format the message and push it into a lock-free
+/// queue. Messages that need to be flushed are written synchronously after
+/// all pending messages, so nothing is lost on a crash.
+class AsyncLogWriter : public QThread {
+  public:
+    AsyncLogWriter()
+            : m_pendingMessages(kPendingMessageCapacity),
+              m_droppedMessages(0),
+              m_stop(false) {
+        setObjectName(QStringLiteral("Logging"));
+    }
+
+    /// Never blocks. The message is dropped if too many messages are pending.
+    void enqueue(PendingMessage message) {
+        if (!m_pendingMessages.tryPush(std::move(message))) {
+            m_droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Writes all pending messages in a batch.
+    ///
+    /// s_mutexLogfile must be held by the caller.
+    void writePendingMessages() {
+        m_stdErrBatch.resize(0);
+        m_fileBatch.resize(0);
+        PendingMessage message;
+        while (m_pendingMessages.tryPop(&message)) {
+            m_stdErrBatch += message.stdErr;
+            m_fileBatch += message.file;
+        }
+        const int droppedMessages = m_droppedMessages.exchange(0, std::memory_order_relaxed);
+        if (droppedMessages > 0) {
+            const QByteArray droppedMessage = formatFileMessage(QtWarningMsg,
+                    QStringLiteral("%1 log messages have been dropped")
+                            .arg(droppedMessages),
+                    objectName());
+            m_stdErrBatch += droppedMessage;
+            m_fileBatch += droppedMessage;
+        }
+        if (!m_stdErrBatch.isEmpty()) {
+            writeToStdErr(m_stdErrBatch, false);
+        }
+        if (!m_fileBatch.isEmpty()) {
+            writeToFile(m_fileBatch, false);
+        }
+    }
+
+    void stop() {
+        m_stop.store(true, std::memory_order_release);
+        wait();
+        m_stop.store(false, std::memory_order_relaxed);
+    }
+
+  private:
+    void run() override {
+        while (!m_stop.load(std::memory_order_acquire)) {
+            msleep(kWriteIntervalMillis);
+            const auto locked = lockMutex(&s_mutexLogfile);
+            writePendingMessages();
+        }
+    }
+
+    mixxx::MpscQueue<PendingMessage> m_pendingMessages;
+    std::atomic<int> m_droppedMessages;
+    std::atomic<bool> m_stop;
+
+    // Only accessed with s_mutexLogfile held
+    QByteArray m_stdErrBatch;
+    QByteArray m_fileBatch;
+};
+
+AsyncLogWriter s_asyncLogWriter;
+
+/// Whether messages that don't need to be flushed are written by
+/// s_asyncLogWriter.
+std::atomic<bool> s_writeAsync = false;
+
 /// Rotate existing logfiles and get the file path of the log file to write to.
 /// May return an invalid/empty QString if the log directory does not exist.
 QString rotateLogFilesAndGetFilePath(const QString& logDirPath) {
@@ -254,12 +358,28 @@ inline void writeToLog(
         textStream << QThread::currentThread();
     }
 
-    const bool flush = flags & WriteFlag::Flush;
+    PendingMessage formattedMessage;
     if (flags & WriteFlag::StdErr) {
-        writeToStdErr(type, context, message, threadName, flush);
+        formattedMessage.stdErr = formatStdErrMessage(type, context, message, threadName);
     }
     if (flags & WriteFlag::File) {
-        writeToFile(type, message, threadName, flush);
+        formattedMessage.file = formatFileMessage(type, message, threadName);
+    }
+
+    const bool flush = flags & WriteFlag::Flush;
+    if (!flush && s_writeAsync.load(std::memory_order_acquire)) {
+        s_asyncLogWriter.enqueue(std::move(formattedMessage));
+        return;
+    }
+
+    const auto locked = lockMutex(&s_mutexLogfile);
+    // Keep the order of the messages
+    s_asyncLogWriter.writePendingMessages();
+    if (!formattedMessage.stdErr.isEmpty()) {
+        writeToStdErr(formattedMessage.stdErr, flush);
+    }
+    if (!formattedMessage.file.isEmpty()) {
+        writeToFile(formattedMessage.file, flush);
     }
 }
 
@@ -406,6 +526,9 @@ void Logging::initialize(
         qSetMessagePattern(kDefaultMessagePattern);
     }
 
+    s_asyncLogWriter.start();
+    s_writeAsync.store(true, std::memory_order_release);
+
     // Install the Qt message handler.
     qInstallMessageHandler(handleMessage);
 
@@ -445,8 +568,12 @@ void Logging::shutdown() {
     qInstallMessageHandler(nullptr);
 
     // Even though we uninstalled the message handler, other threads may have
-    // already entered it.
+    // already entered it. Their messages are written synchronously from now on.
+    s_writeAsync.store(false, std::memory_order_release);
+    s_asyncLogWriter.stop();
+
     const auto locker = lockMutex(&s_mutexLogfile);
+    s_asyncLogWriter.writePendingMessages();
     if (s_logfile.isOpen()) {
         s_logfile.close();
     }
@@ -455,6 +582,7 @@ void Logging::shutdown() {
 // static
 void Logging::flushLogFile() {
     QMutexLocker locker(&s_mutexLogfile);
+    s_asyncLogWriter.writePendingMessages();
     if (s_logfile.isOpen()) {
         s_logfile.flush();
     }
@@ -0,0 +1,63 @@
+#include "util/memoryaccount.h"
+
+#include <QList>
+#include <QMutex>
+#include <utility>
+
+#include "util/compatibility/qmutex.h"
+#include "util/stat.h"
+
+namespace {
+
+struct Registry {
+    QMutex mutex;
+    QList<MemoryAccount*> accounts;
+};
+
+// Created by the first account, so it outlives the accounts of
+// function-static caches
+Registry& registry() {
+    static Registry s_registry;
+    return s_registry;
+}
+
+const QString kBytesTagPattern = QStringLiteral("Memory %1 [bytes]");
+const QString kPeakBytesTagPattern = QStringLiteral("Memory %1 peak [bytes]");
+
+} // anonymous namespace
+
+MemoryAccount::MemoryAccount(const QString& name)
+        : m_name(name),
+          m_bytesTag(kBytesTagPattern.arg(name)),
+          m_peakBytesTag(kPeakBytesTagPattern.arg(name)),
+          m_bytes(0),
+          m_peakBytes(0) {
+    Registry& accounts = registry();
+    const auto locker = lockMutex(&accounts.mutex);
+    accounts.accounts.append(this);
+}
+
+MemoryAccount::~MemoryAccount() {
+    Registry& accounts = registry();
+    const auto locker = lockMutex(&accounts.mutex);
+    accounts.accounts.removeOne(this);
+}
+
+void MemoryAccount::updatePeak(qint64 bytes) {
+    qint64 peakBytes = m_peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peakBytes &&
+            !m_peakBytes.compare_exchange_weak(
+                    peakBytes, bytes, std::memory_order_relaxed)) {
+    }
+}
+
+// static
+void MemoryAccount::reportAll() {
+    const Stat::ComputeFlags flags = Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX;
+    Registry& accounts = registry();
+    const auto locker = lockMutex(&accounts.mutex);
+    for (const MemoryAccount* pAccount : std::as_const(accounts.accounts)) {
+        Stat::track(pAccount->m_bytesTag, Stat::UNSPECIFIED, flags, pAccount->bytes());
+        Stat::track(pAccount->m_peakBytesTag, Stat::UNSPECIFIED, flags, pAccount->peakBytes());
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+#include "util/class.h"
+
+/// Tracks the memory that a subsystem holds, e.g. the chunks of a
+/// CachingReader or the waveforms that are kept alive by a cache.
+///
+/// Every account reports its current and peak bytes to the StatsManager,
+/// so they are shown by the developer tools and logged on shutdown. The
+/// owner of an account is responsible for keeping it in sync with its
+/// allocations and for evicting down to its budget.
+///
+/// Updating an account is lock-free and may be done from the audio thread.
+/// Accounts must be created and destroyed outside of the audio thread.
+class MemoryAccount final {
+  public:
+    explicit MemoryAccount(const QString& name);
+    ~MemoryAccount();
+
+    const QString& name() const {
+        return m_name;
+    }
+
+    qint64 bytes() const {
+        return m_bytes.load(std::memory_order_relaxed);
+    }
+    qint64 peakBytes() const {
+        return m_peakBytes.load(std::memory_order_relaxed);
+    }
+
+    void add(qint64 bytes) {
+        updatePeak(m_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+    void subtract(qint64 bytes) {
+        m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    void set(qint64 bytes) {
+        m_bytes.store(bytes, std::memory_order_relaxed);
+        updatePeak(bytes);
+    }
+
+    /// Reports the current and peak bytes of all existing accounts.
+    static void reportAll();
+
+  private:
+    void updatePeak(qint64 bytes);
+
+    const QString m_name;
+    const QString m_bytesTag;
+    const QString m_peakBytesTag;
+    std::atomic<qint64> m_bytes;
+    std::atomic<qint64> m_peakBytes;
+
+    DISALLOW_COPY_AND_ASSIGN(MemoryAccount);
+};
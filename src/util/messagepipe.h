@@ -28,6 +28,13 @@ class MessagePipe {
         return m_sender_messages.size();
     }
 
+    // Returns the number of SenderMessageType messages that can be written
+    // without failing. Since the receiver may read concurrently, the actual
+    // free capacity may be larger. Non-blocking.
+    int writeCapacity() const {
+        return static_cast<int>(m_receiver_messages.capacity() - m_receiver_messages.size());
+    }
+
     // Try to read read a ReceiverMessageType written by the receiver
     // addressed to the sender. Non-blocking.
     bool readMessage(ReceiverMessageType* message) {
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "util/assert.h"
+
+namespace mixxx {
+
+/// A bounded queue for multiple producers and a single consumer.
+///
+/// Producers claim a slot with a single compare-and-swap and never wait
+/// for each other or for the consumer. If the queue is full, tryPush()
+/// fails immediately instead. Each slot carries a sequence number that
+/// tells whether it is free for the next producer or filled for the
+/// consumer (see Dmitry Vyukov's bounded MPMC queue).
+///
+/// Only a single thread at a time may call tryPop().
+template<typename T>
+class MpscQueue {
+  public:
+    /// The capacity is rounded up to the next power of 2
+    explicit MpscQueue(std::size_t capacity)
+            : m_capacity(roundUpToPowerOf2(capacity)),
+              m_slots(std::make_unique<Slot[]>(m_capacity)),
+              m_pushPos(0),
+              m_popPos(0) {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+
+    /// Returns false without blocking if the queue is full
+    bool tryPush(T value) {
+        std::size_t pos = m_pushPos.load(std::memory_order_relaxed);
+        Slot* pSlot;
+        while (true) {
+            pSlot = &m_slots[pos & (m_capacity - 1)];
+            const std::size_t sequence = pSlot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) -
+                    static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                // The slot is free, try to claim it
+                if (m_pushPos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // The slot has not been consumed yet
+                return false;
+            } else {
+                // Another producer has claimed the slot
+                pos = m_pushPos.load(std::memory_order_relaxed);
+            }
+        }
+        pSlot->value = std::move(value);
+        pSlot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Returns false if the queue is empty or the next value is still
+    /// being pushed.
+    bool tryPop(T* pValue) {
+        DEBUG_ASSERT(pValue);
+        Slot* pSlot = &m_slots[m_popPos & (m_capacity - 1)];
+        const std::size_t sequence = pSlot->sequence.load(std::memory_order_acquire);
+        if (sequence != m_popPos + 1) {
+            return false;
+        }
+        *pValue = std::move(pSlot->value);
+        // Release the resources of the value here instead of on the
+        // producer thread that overwrites the slot.
+        pSlot->value = T();
+        pSlot->sequence.store(m_popPos + m_capacity, std::memory_order_release);
+        ++m_popPos;
+        return true;
+    }
+
+  private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    static std::size_t roundUpToPowerOf2(std::size_t value) {
+        std::size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t m_capacity;
+    const std::unique_ptr<Slot[]> m_slots;
+    // Producers and the consumer modify their positions concurrently
+    alignas(64) std::atomic<std::size_t> m_pushPos;
+    alignas(64) std::size_t m_popPos;
+};
+
+} // namespace mixxx
@@ -0,0 +1,213 @@
+#include "util/realtimeaudit.h"
+
+#ifdef MIXXX_REALTIME_AUDIT
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define MIXXX_REALTIME_AUDIT_BACKTRACE
+#endif
+
+#if defined(__GLIBC__)
+#include <pthread.h>
+#endif
+
+namespace mixxx {
+
+namespace realtimeaudit {
+
+namespace {
+
+constexpr int kMaxBacktraceFrames = 32;
+
+// Only trivial types here, because these are accessed from the allocator
+// hooks, possibly before any constructors have run.
+thread_local int t_callbackDepth = 0;
+thread_local int t_suspendDepth = 0;
+thread_local const char* t_pObjectKind = nullptr;
+thread_local const QString* t_pObjectName = nullptr;
+
+std::atomic<int> s_violationCount{0};
+
+void reportViolation(const char* pWhat) {
+    if (t_callbackDepth == 0 || t_suspendDepth > 0) {
+        return;
+    }
+    // Reporting itself allocates
+    ++t_suspendDepth;
+    s_violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (t_pObjectName) {
+        std::fprintf(stderr,
+                "Realtime audit: %s in audio callback while processing %s %s\n",
+                pWhat,
+                t_pObjectKind,
+                qPrintable(*t_pObjectName));
+    } else {
+        std::fprintf(stderr, "Realtime audit: %s in audio callback\n", pWhat);
+    }
+#ifdef MIXXX_REALTIME_AUDIT_BACKTRACE
+    void* frames[kMaxBacktraceFrames];
+    const int numFrames = backtrace(frames, kMaxBacktraceFrames);
+    // Skip this function
+    backtrace_symbols_fd(frames + 1, numFrames - 1, fileno(stderr));
+#endif
+    std::fflush(stderr);
+    --t_suspendDepth;
+}
+
+} // anonymous namespace
+
+CallbackScope::CallbackScope() {
+    ++t_callbackDepth;
+}
+
+CallbackScope::~CallbackScope() {
+    --t_callbackDepth;
+}
+
+ObjectScope::ObjectScope(const char* pKind, const QString& name)
+        : m_pPrevKind(t_pObjectKind),
+          m_pPrevName(t_pObjectName) {
+    t_pObjectKind = pKind;
+    t_pObjectName = &name;
+}
+
+ObjectScope::~ObjectScope() {
+    t_pObjectKind = m_pPrevKind;
+    t_pObjectName = m_pPrevName;
+}
+
+SuspendScope::SuspendScope() {
+    ++t_suspendDepth;
+}
+
+SuspendScope::~SuspendScope() {
+    --t_suspendDepth;
+}
+
+void mutexLocked() {
+    reportViolation("mutex lock");
+}
+
+int violationCount() {
+    return s_violationCount.load(std::memory_order_relaxed);
+}
+
+} // namespace realtimeaudit
+
+} // namespace mixxx
+
+using mixxx::realtimeaudit::reportViolation;
+
+#if defined(__GLIBC__)
+
+// Interpose the C allocator of glibc, which also covers operator new and
+// all allocations in Qt and external libraries.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+int __pthread_mutex_lock(pthread_mutex_t* mutex);
+
+void* malloc(size_t size) {
+    reportViolation("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    reportViolation("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    reportViolation("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    reportViolation("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    reportViolation("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pPtr, size_t alignment, size_t size) {
+    reportViolation("posix_memalign");
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *pPtr = ptr;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        reportViolation("free");
+    }
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    reportViolation("pthread_mutex_lock");
+    return __pthread_mutex_lock(mutex);
+}
+} // extern "C"
+
+#else
+
+// Other platforms do not allow to interpose the C allocator easily, so
+// only C++ allocations are detected.
+void* operator new(std::size_t size) {
+    reportViolation("operator new");
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    reportViolation("operator new");
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        reportViolation("operator delete");
+    }
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+#endif
+
+#endif // MIXXX_REALTIME_AUDIT
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QString>
+
+/// Detection of operations that are not real-time safe in the audio callback.
+///
+/// When built with the CMake option REALTIME_AUDIT, all heap allocations and
+/// mutex locks are intercepted. If one happens on a thread while it is inside
+/// a CallbackScope, the violation is reported on stderr with a stack trace
+/// and the engine object that is currently being processed.
+///
+/// Without the option all functions are no-ops that compile to nothing.
+namespace mixxx {
+
+namespace realtimeaudit {
+
+#ifdef MIXXX_REALTIME_AUDIT
+
+constexpr bool kEnabled = true;
+
+/// Marks the current thread as executing the audio callback. Scopes may
+/// be nested.
+class CallbackScope final {
+  public:
+    CallbackScope();
+    ~CallbackScope();
+    CallbackScope(const CallbackScope&) = delete;
+    CallbackScope& operator=(const CallbackScope&) = delete;
+};
+
+/// Names the engine object that is processed on the current thread, e.g.
+/// a channel or an effect. The name is only referenced and must outlive
+/// the scope.
+class ObjectScope final {
+  public:
+    ObjectScope(const char* pKind, const QString& name);
+    ~ObjectScope();
+    ObjectScope(const ObjectScope&) = delete;
+    ObjectScope& operator=(const ObjectScope&) = delete;
+
+  private:
+    const char* const m_pPrevKind;
+    const QString* const m_pPrevName;
+};
+
+/// Temporarily suspends the detection on the current thread, e.g. for
+/// known and accepted code paths.
+class SuspendScope final {
+  public:
+    SuspendScope();
+    ~SuspendScope();
+    SuspendScope(const SuspendScope&) = delete;
+    SuspendScope& operator=(const SuspendScope&) = delete;
+};
+
+/// Reports a mutex lock, if called inside a CallbackScope.
+void mutexLocked();
+
+/// The total number of violations on all threads.
+int violationCount();
+
+#else
+
+constexpr bool kEnabled = false;
+
+class CallbackScope final {
+  public:
+    CallbackScope() = default;
+};
+
+class ObjectScope final {
+  public:
+    ObjectScope(const char* /*pKind*/, const QString& /*name*/) {
+    }
+};
+
+class SuspendScope final {
+  public:
+    SuspendScope() = default;
+};
+
+inline void mutexLocked() {
+}
+
+inline int violationCount() {
+    return 0;
+}
+
+#endif
+
+} // namespace realtimeaudit
+
+} // namespace mixxx
@@ -70,8 +70,9 @@ SINT copyRing(const std::span<const CSAMPLE> sourceBuffer,
 
 } // anonymous namespace
 
-RingDelayBuffer::RingDelayBuffer(SINT bufferSize)
-        : m_firstInputChunk(true),
+RingDelayBuffer::RingDelayBuffer(SINT bufferSize, bool fadeInFirstChunk)
+        : m_fadeInFirstChunk(fadeInFirstChunk),
+          m_firstInputChunk(fadeInFirstChunk),
           m_writePos(0),
           m_buffer(bufferSize) {
     // Set the ring buffer items to 0.
@@ -88,14 +89,9 @@ SINT RingDelayBuffer::read(std::span<CSAMPLE> destinationBuffer, const SINT dela
         return 0;
     }
 
-    SINT readPos = m_writePos - shift;
-
-    // The reading position crossed the left bound of the ring buffer.
-    // Add the size of the ring buffer to move the position around and keep it
-    // in the valid index range.
-    if (readPos < 0) {
-        readPos = readPos + m_buffer.size();
-    }
+    // If the reading position crossed the left bound of the ring buffer,
+    // it is moved around to keep it in the valid index range.
+    const SINT readPos = readPosition(shift);
 
     return copyRing(mixxx::spanutil::spanFromPtrLen(m_buffer.data(), m_buffer.size()),
             readPos,
@@ -104,6 +100,55 @@ SINT RingDelayBuffer::read(std::span<CSAMPLE> destinationBuffer, const SINT dela
             itemsToRead);
 }
 
+SINT RingDelayBuffer::readCrossfaded(std::span<CSAMPLE> destinationBuffer,
+        const SINT fromDelayItems,
+        const SINT toDelayItems,
+        const CSAMPLE_GAIN startMix,
+        const CSAMPLE_GAIN endMix) {
+    const SINT itemsToRead = destinationBuffer.size();
+    const SINT bufferSize = m_buffer.size();
+
+    VERIFY_OR_DEBUG_ASSERT(itemsToRead + fromDelayItems <= bufferSize &&
+            itemsToRead + toDelayItems <= bufferSize) {
+        return 0;
+    }
+    if (itemsToRead == 0) {
+        return 0;
+    }
+
+    SINT fromPos = readPosition(itemsToRead + fromDelayItems);
+    SINT toPos = readPosition(itemsToRead + toDelayItems);
+    const CSAMPLE_GAIN mixIncrement = (endMix - startMix) / itemsToRead;
+
+    SINT destPos = 0;
+    while (destPos < itemsToRead) {
+        // Both read positions wrap around at most once, so there are
+        // at most three contiguous blocks.
+        const SINT numItems = math_min(itemsToRead - destPos,
+                math_min(bufferSize - fromPos, bufferSize - toPos));
+        const CSAMPLE* pFrom = m_buffer.data() + fromPos;
+        const CSAMPLE* pTo = m_buffer.data() + toPos;
+        CSAMPLE* pDest = destinationBuffer.data() + destPos;
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numItems; ++i) {
+            const CSAMPLE_GAIN mix = startMix + mixIncrement * (destPos + i);
+            pDest[i] = pFrom[i] * (1.0f - mix) + pTo[i] * mix;
+        }
+
+        destPos += numItems;
+        fromPos += numItems;
+        if (fromPos == bufferSize) {
+            fromPos = 0;
+        }
+        toPos += numItems;
+        if (toPos == bufferSize) {
+            toPos = 0;
+        }
+    }
+
+    return itemsToRead;
+}
+
 SINT RingDelayBuffer::write(std::span<const CSAMPLE> sourceBuffer) {
     const SINT itemsToWrite = sourceBuffer.size();
 
@@ -30,9 +30,12 @@
 /// that should be read and the delay of the reading position
 /// against the write position. The reading is optimized this way
 /// for the use case of the effect chain delay handling.
+///
+/// Users which fill the ring buffer continuously, like an effect that
+/// feeds back its delayed signal, may disable the fading-in.
 class RingDelayBuffer final {
   public:
-    RingDelayBuffer(SINT bufferSize);
+    RingDelayBuffer(SINT bufferSize, bool fadeInFirstChunk = true);
 
     /// The method clears the ring delay buffer. That means,
     /// that the ring buffer is filled with zero "silence" samples,
@@ -40,7 +43,7 @@ class RingDelayBuffer final {
     /// and as last, the flag for the first input buffer is set in the state,
     /// that the next chunk of data that will be written, will be faded-in.
     void clear() {
-        m_firstInputChunk = true;
+        m_firstInputChunk = m_fadeInFirstChunk;
         m_writePos = 0;
 
         m_buffer.fill(0);
@@ -61,6 +64,19 @@ class RingDelayBuffer final {
     /// are not read and the method returns the zero value.
     SINT read(std::span<CSAMPLE> destinationBuffer, const SINT delayItems);
 
+    /// The method reads items like read(), but cross-fades from the items
+    /// delayed by fromDelayItems to the items delayed by toDelayItems.
+    /// The share of the latter ramps linearly from startMix for the first
+    /// item towards endMix, which would be reached by the item after the
+    /// last one. This allows to change the delay within a buffer without
+    /// clicks. The ring buffer is processed in contiguous blocks, without
+    /// any wrap-around checks per item.
+    SINT readCrossfaded(std::span<CSAMPLE> destinationBuffer,
+            const SINT fromDelayItems,
+            const SINT toDelayItems,
+            const CSAMPLE_GAIN startMix = 0.0f,
+            const CSAMPLE_GAIN endMix = 1.0f);
+
     /// The method writes items from the pBuffer into the ring buffer.
     /// The number of items that will be written is passed through
     /// the itemsToWrite parameter. This value has to be smaller or equal
@@ -71,6 +87,13 @@ class RingDelayBuffer final {
     SINT write(std::span<const CSAMPLE> sourceBuffer);
 
   private:
+    /// Returns the position of the item shift items before the write position.
+    SINT readPosition(SINT shift) const {
+        const SINT readPos = m_writePos - shift;
+        return readPos < 0 ? readPos + m_buffer.size() : readPos;
+    }
+
+    bool m_fadeInFirstChunk;
     // This flag ensures the "fading in" for the first input chunk
     // into the clear ring delay buffer. It is done to avoid
     // a "crackling" sound when the input samples are read after reading
@@ -1,6 +1,7 @@
 #include "util/rotary.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 constexpr int kiRotaryFilterMaxLen = 50;
 
@@ -43,6 +44,12 @@ double Rotary::filter(double dValue) {
     return dMagnitude;
 }
 
+bool Rotary::isAtRest() const {
+    return std::all_of(m_pFilter.cbegin(),
+            m_pFilter.cbegin() + m_iFilterLength,
+            [](double value) { return value == 0.; });
+}
+
 double Rotary::fillBuffer(double dValue) {
     for (int i=0; i<m_iFilterLength; ++i)
     {
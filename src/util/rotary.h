@@ -16,6 +16,8 @@ class Rotary {
     double getCalibration();
     // Low pass filtered rotary event
     double filter(double dValue);
+    // True if the filter has decayed to 0
+    bool isAtRest() const;
     // Hard set event value
     double fillBuffer(double dValue);
     // Collect calibration data
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <limits>
 
 #include "engine/engine.h"
 #include "util/math.h"
@@ -38,8 +39,791 @@ constexpr bool useAlignedAlloc() {
             sizeof(CSAMPLE*) == sizeof(size_t);
 }
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && \
+        !defined(__EMSCRIPTEN__)
+// GCC and Clang allow to compile single functions for a specific instruction
+// set. The kernels below are inlined into these functions, so the compiler
+// is able to vectorize them with the wider registers. The first variant that
+// is supported by the CPU is selected at startup.
+// On other targets (e.g. aarch64 with NEON as baseline) only the baseline
+// variant of the build is available.
+#define MIXXX_SAMPLE_KERNEL_DISPATCH
+#define SAMPLE_KERNEL_INLINE inline __attribute__((always_inline))
+#define SAMPLE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SAMPLE_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx2,fma")))
+#else
+#define SAMPLE_KERNEL_INLINE inline
+#endif
+
+// The bodies of the performance critical functions which are compiled once
+// per supported instruction set. The special cases (zero or unity gain) are
+// handled by the public SampleUtil functions before.
+
+SAMPLE_KERNEL_INLINE void applyRampingGainKernel(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    if (gain_delta != 0) {
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples / 2; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
+            // a loop counter i += 2 prevents vectorizing.
+            pBuffer[i * 2] *= gain;
+            pBuffer[i * 2 + 1] *= gain;
+        }
+    } else {
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples; ++i) {
+            pBuffer[i] *= old_gain;
+        }
+    }
+}
+
+SAMPLE_KERNEL_INLINE void applyStereoGainCurveKernel(CSAMPLE* M_RESTRICT pBuffer,
+        const CSAMPLE_GAIN* M_RESTRICT pGains,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pBuffer[i * 2] *= pGains[i];
+        pBuffer[i * 2 + 1] *= pGains[i];
+    }
+}
+
+SAMPLE_KERNEL_INLINE void addWithGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void addWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    if (gain_delta != 0) {
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples / 2; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
+            pDest[i * 2] += pSrc[i * 2] * gain;
+            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+        }
+    } else {
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples; ++i) {
+            pDest[i] += pSrc[i] * old_gain;
+        }
+    }
+}
+
+// Adds N buffers with individually ramped gains to pDest. The loop over the
+// sources is unrolled, so pDest is only read and written once per sample and
+// the loop over the samples is vectorized.
+template<int N>
+SAMPLE_KERNEL_INLINE void addNWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        const CSAMPLE_GAIN* pOldGain,
+        const CSAMPLE_GAIN* pNewGain,
+        SINT numSamples) {
+    const CSAMPLE* M_RESTRICT src[N];
+    CSAMPLE_GAIN startGain[N];
+    CSAMPLE_GAIN gainDelta[N];
+    for (int k = 0; k < N; ++k) {
+        src[k] = pSrc[k];
+        gainDelta[k] = (pNewGain[k] - pOldGain[k]) / CSAMPLE_GAIN(numSamples / 2);
+        startGain[k] = pOldGain[k] + gainDelta[k];
+    }
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples / 2; ++i) {
+        CSAMPLE left = pDest[i * 2];
+        CSAMPLE right = pDest[i * 2 + 1];
+        for (int k = 0; k < N; ++k) {
+            const CSAMPLE_GAIN gain = startGain[k] + gainDelta[k] * i;
+            left += src[k][i * 2] * gain;
+            right += src[k][i * 2 + 1] * gain;
+        }
+        pDest[i * 2] = left;
+        pDest[i * 2 + 1] = right;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void addMultipleWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        const CSAMPLE_GAIN* pOldGain,
+        const CSAMPLE_GAIN* pNewGain,
+        int numSources,
+        SINT numSamples) {
+    // More than 8 sources are mixed in multiple passes of up to 8 sources
+    constexpr int kMaxSourcesPerPass = 8;
+    while (numSources > 0) {
+        const int numSourcesInPass = std::min(numSources, kMaxSourcesPerPass);
+        switch (numSourcesInPass) {
+        case 1:
+            addNWithRampingGainKernel<1>(pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        case 2:
+            addNWithRampingGainKernel<2>(pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        case 3:
+            addNWithRampingGainKernel<3>(pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        case 4:
+            addNWithRampingGainKernel<4>(pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        case 5:
+            addNWithRampingGainKernel<5>(pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        case 6:
+            addNWithRampingGainKernel<6>(pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        case 7:
+            addNWithRampingGainKernel<7>(pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        default:
+            addNWithRampingGainKernel<kMaxSourcesPerPass>(
+                    pDest, pSrc, pOldGain, pNewGain, numSamples);
+            break;
+        }
+        pSrc += numSourcesInPass;
+        pOldGain += numSourcesInPass;
+        pNewGain += numSourcesInPass;
+        numSources -= numSourcesInPass;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void add2WithGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void add3WithGainKernel(CSAMPLE* pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+SAMPLE_KERNEL_INLINE SampleUtil::CLIP_STATUS sumAbsPerChannelKernel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE clippedL = 0;
+    CSAMPLE clippedR = 0;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    if (clippedL > 0) {
+        clipping |= SampleUtil::CLIPPING_LEFT;
+    }
+    if (clippedR > 0) {
+        clipping |= SampleUtil::CLIPPING_RIGHT;
+    }
+    return clipping;
+}
+
+SAMPLE_KERNEL_INLINE void maxAbsPerChannelKernel(CSAMPLE* pfMaxL,
+        CSAMPLE* pfMaxR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    CSAMPLE fMaxL = *pfMaxL;
+    CSAMPLE fMaxR = *pfMaxR;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE absl = fabs(pBuffer[i * 2]);
+        const CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fMaxL = absl > fMaxL ? absl : fMaxL;
+        fMaxR = absr > fMaxR ? absr : fMaxR;
+    }
+
+    *pfMaxL = fMaxL;
+    *pfMaxR = fMaxR;
+}
+
+SAMPLE_KERNEL_INLINE void interleaveStereoBufferKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+SAMPLE_KERNEL_INLINE void interleaveStemBufferKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        const CSAMPLE* M_RESTRICT pSrc4,
+        const CSAMPLE* M_RESTRICT pSrc5,
+        const CSAMPLE* M_RESTRICT pSrc6,
+        const CSAMPLE* M_RESTRICT pSrc7,
+        const CSAMPLE* M_RESTRICT pSrc8,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[8 * i] = pSrc1[i];
+        pDest[8 * i + 1] = pSrc2[i];
+        pDest[8 * i + 2] = pSrc3[i];
+        pDest[8 * i + 3] = pSrc4[i];
+        pDest[8 * i + 4] = pSrc5[i];
+        pDest[8 * i + 5] = pSrc6[i];
+        pDest[8 * i + 6] = pSrc7[i];
+        pDest[8 * i + 7] = pSrc8[i];
+    }
+}
+
+SAMPLE_KERNEL_INLINE void linearCrossfadeStemBuffersOutKernel(
+        CSAMPLE* M_RESTRICT pDestSrcFadeOut,
+        const CSAMPLE* M_RESTRICT pSrcFadeIn,
+        SINT numSamples) {
+    const CSAMPLE_GAIN cross_inc = CSAMPLE_GAIN_ONE / CSAMPLE_GAIN(numSamples / 8);
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples / 8; ++i) {
+        const CSAMPLE_GAIN cross_mix = cross_inc * i;
+        pDestSrcFadeOut[i * 8] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8] += pSrcFadeIn[i * 8] * cross_mix;
+        pDestSrcFadeOut[i * 8 + 1] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8 + 1] += pSrcFadeIn[i * 8 + 1] * cross_mix;
+        pDestSrcFadeOut[i * 8 + 2] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8 + 2] += pSrcFadeIn[i * 8 + 2] * cross_mix;
+        pDestSrcFadeOut[i * 8 + 3] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8 + 3] += pSrcFadeIn[i * 8 + 3] * cross_mix;
+        pDestSrcFadeOut[i * 8 + 4] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8 + 4] += pSrcFadeIn[i * 8 + 4] * cross_mix;
+        pDestSrcFadeOut[i * 8 + 5] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8 + 5] += pSrcFadeIn[i * 8 + 5] * cross_mix;
+        pDestSrcFadeOut[i * 8 + 6] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8 + 6] += pSrcFadeIn[i * 8 + 6] * cross_mix;
+        pDestSrcFadeOut[i * 8 + 7] *= (CSAMPLE_GAIN_ONE - cross_mix);
+        pDestSrcFadeOut[i * 8 + 7] += pSrcFadeIn[i * 8 + 7] * cross_mix;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void interleavePlanarBufferKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        int numChannels,
+        SINT numFrames) {
+    switch (numChannels) {
+    case 1:
+        std::copy(pSrc[0], pSrc[0] + numFrames, pDest);
+        break;
+    case 2:
+        interleaveStereoBufferKernel(pDest, pSrc[0], pSrc[1], numFrames);
+        break;
+    default:
+        // Strided stores, one channel after another
+        for (int channel = 0; channel < numChannels; ++channel) {
+            const CSAMPLE* M_RESTRICT pChannel = pSrc[channel];
+            for (SINT i = 0; i < numFrames; ++i) {
+                pDest[i * numChannels + channel] = pChannel[i];
+            }
+        }
+        break;
+    }
+}
+
+// Interleaves the stereo buffers pSrc[0] to pSrc[numPairs - 1] into
+// consecutive channel pairs of pDest. pDest is written once and in order,
+// which suits the device buffers of multi-channel sound cards.
+template<int N>
+SAMPLE_KERNEL_INLINE void interleaveNStereoPairsClampKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        SINT numFrames) {
+    const CSAMPLE* M_RESTRICT pPairs[N];
+    for (int pair = 0; pair < N; ++pair) {
+        pPairs[pair] = pSrc[pair];
+    }
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        for (int pair = 0; pair < N; ++pair) {
+            pDest[i * 2 * N + pair * 2] = SampleUtil::clampSample(pPairs[pair][i * 2]);
+            pDest[i * 2 * N + pair * 2 + 1] = SampleUtil::clampSample(pPairs[pair][i * 2 + 1]);
+        }
+    }
+}
+
+SAMPLE_KERNEL_INLINE void interleaveStereoPairsClampKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        int numPairs,
+        SINT numFrames) {
+    switch (numPairs) {
+    case 1:
+        interleaveNStereoPairsClampKernel<1>(pDest, pSrc, numFrames);
+        break;
+    case 2:
+        interleaveNStereoPairsClampKernel<2>(pDest, pSrc, numFrames);
+        break;
+    case 3:
+        interleaveNStereoPairsClampKernel<3>(pDest, pSrc, numFrames);
+        break;
+    case 4:
+        interleaveNStereoPairsClampKernel<4>(pDest, pSrc, numFrames);
+        break;
+    default:
+        for (SINT i = 0; i < numFrames; ++i) {
+            for (int pair = 0; pair < numPairs; ++pair) {
+                pDest[i * 2 * numPairs + pair * 2] =
+                        SampleUtil::clampSample(pSrc[pair][i * 2]);
+                pDest[i * 2 * numPairs + pair * 2 + 1] =
+                        SampleUtil::clampSample(pSrc[pair][i * 2 + 1]);
+            }
+        }
+        break;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void copyStereoToMultiClampKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        int numChannels,
+        int channelOffset,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[i * numChannels + channelOffset] = SampleUtil::clampSample(pSrc[i * 2]);
+        pDest[i * numChannels + channelOffset + 1] = SampleUtil::clampSample(pSrc[i * 2 + 1]);
+    }
+}
+
+SAMPLE_KERNEL_INLINE void convertS16ToFloat32Kernel(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    // SAMPLE_MIN = -32768 is a valid low sample, whereas SAMPLE_MAX = 32767
+    // is the highest valid sample. Note that this means that although some
+    // sample values convert to -1.0, none will convert to +1.0.
+    const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) / kConversionFactor;
+    }
+}
+
+// pDest and pSrc may point to the same memory for converting in place,
+// the loop only accesses the element at the same index.
+SAMPLE_KERNEL_INLINE void convertS32ToFloat32Kernel(CSAMPLE* pDest,
+        const int32_t* pSrc,
+        CSAMPLE scaleFactor,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) * scaleFactor;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void copyMultiToStereoKernel(
+        CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames,
+        int numChannels) {
+    // forward loop
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[i * 2] = pSrc[i * numChannels];
+        pDest[i * 2 + 1] = pSrc[i * numChannels + 1];
+    }
+}
+
+// Mixes N stereo channel pairs of the interleaved multi-channel frames in pSrc
+// with individually ramped gains into pDest. Like addNWithRampingGainKernel,
+// pDest is only written once per sample.
+template<int N>
+SAMPLE_KERNEL_INLINE void mixNChannelPairsWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        const int* pChannelOffset,
+        const CSAMPLE_GAIN* pOldGain,
+        const CSAMPLE_GAIN* pNewGain,
+        SINT numFrames,
+        int numChannels,
+        bool accumulate) {
+    int offset[N];
+    CSAMPLE_GAIN startGain[N];
+    CSAMPLE_GAIN gainDelta[N];
+    for (int k = 0; k < N; ++k) {
+        offset[k] = pChannelOffset[k];
+        gainDelta[k] = (pNewGain[k] - pOldGain[k]) / CSAMPLE_GAIN(numFrames);
+        startGain[k] = pOldGain[k] + gainDelta[k];
+    }
+    for (SINT i = 0; i < numFrames; ++i) {
+        const CSAMPLE* pFrame = pSrc + i * numChannels;
+        CSAMPLE left = accumulate ? pDest[i * 2] : CSAMPLE_ZERO;
+        CSAMPLE right = accumulate ? pDest[i * 2 + 1] : CSAMPLE_ZERO;
+        for (int k = 0; k < N; ++k) {
+            const CSAMPLE_GAIN gain = startGain[k] + gainDelta[k] * i;
+            left += pFrame[offset[k]] * gain;
+            right += pFrame[offset[k] + 1] * gain;
+        }
+        pDest[i * 2] = left;
+        pDest[i * 2 + 1] = right;
+    }
+}
+
+SAMPLE_KERNEL_INLINE void mixMultiToStereoWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        const int* pChannelOffset,
+        const CSAMPLE_GAIN* pOldGain,
+        const CSAMPLE_GAIN* pNewGain,
+        int numPairs,
+        SINT numFrames,
+        int numChannels) {
+    // Stem files have up to 4 stereo pairs, more are mixed in multiple passes
+    constexpr int kMaxPairsPerPass = 4;
+    bool accumulate = false;
+    while (numPairs > 0) {
+        const int numPairsInPass = std::min(numPairs, kMaxPairsPerPass);
+        switch (numPairsInPass) {
+        case 1:
+            mixNChannelPairsWithRampingGainKernel<1>(pDest,
+                    pSrc,
+                    pChannelOffset,
+                    pOldGain,
+                    pNewGain,
+                    numFrames,
+                    numChannels,
+                    accumulate);
+            break;
+        case 2:
+            mixNChannelPairsWithRampingGainKernel<2>(pDest,
+                    pSrc,
+                    pChannelOffset,
+                    pOldGain,
+                    pNewGain,
+                    numFrames,
+                    numChannels,
+                    accumulate);
+            break;
+        case 3:
+            mixNChannelPairsWithRampingGainKernel<3>(pDest,
+                    pSrc,
+                    pChannelOffset,
+                    pOldGain,
+                    pNewGain,
+                    numFrames,
+                    numChannels,
+                    accumulate);
+            break;
+        default:
+            mixNChannelPairsWithRampingGainKernel<kMaxPairsPerPass>(pDest,
+                    pSrc,
+                    pChannelOffset,
+                    pOldGain,
+                    pNewGain,
+                    numFrames,
+                    numChannels,
+                    accumulate);
+            break;
+        }
+        pChannelOffset += numPairsInPass;
+        pOldGain += numPairsInPass;
+        pNewGain += numPairsInPass;
+        numPairs -= numPairsInPass;
+        accumulate = true;
+    }
+}
+
+struct SampleKernels {
+    void (*applyRampingGain)(CSAMPLE*, CSAMPLE_GAIN, CSAMPLE_GAIN, SINT);
+    void (*applyStereoGainCurve)(CSAMPLE*, const CSAMPLE_GAIN*, SINT);
+    void (*addWithGain)(CSAMPLE*, const CSAMPLE*, CSAMPLE_GAIN, SINT);
+    void (*addWithRampingGain)(CSAMPLE*, const CSAMPLE*, CSAMPLE_GAIN, CSAMPLE_GAIN, SINT);
+    void (*addMultipleWithRampingGain)(CSAMPLE*,
+            const CSAMPLE* const*,
+            const CSAMPLE_GAIN*,
+            const CSAMPLE_GAIN*,
+            int,
+            SINT);
+    void (*add2WithGain)(CSAMPLE*,
+            const CSAMPLE*,
+            CSAMPLE_GAIN,
+            const CSAMPLE*,
+            CSAMPLE_GAIN,
+            SINT);
+    void (*add3WithGain)(CSAMPLE*,
+            const CSAMPLE*,
+            CSAMPLE_GAIN,
+            const CSAMPLE*,
+            CSAMPLE_GAIN,
+            const CSAMPLE*,
+            CSAMPLE_GAIN,
+            SINT);
+    SampleUtil::CLIP_STATUS (*sumAbsPerChannel)(CSAMPLE*, CSAMPLE*, const CSAMPLE*, SINT);
+    void (*maxAbsPerChannel)(CSAMPLE*, CSAMPLE*, const CSAMPLE*, SINT);
+    void (*interleaveStereoBuffer)(CSAMPLE*, const CSAMPLE*, const CSAMPLE*, SINT);
+    void (*interleaveStemBuffer)(CSAMPLE*,
+            const CSAMPLE*,
+            const CSAMPLE*,
+            const CSAMPLE*,
+            const CSAMPLE*,
+            const CSAMPLE*,
+            const CSAMPLE*,
+            const CSAMPLE*,
+            const CSAMPLE*,
+            SINT);
+    void (*linearCrossfadeStemBuffersOut)(CSAMPLE*, const CSAMPLE*, SINT);
+    void (*copyMultiToStereo)(CSAMPLE*, const CSAMPLE*, SINT, int);
+    void (*mixMultiToStereoWithRampingGain)(CSAMPLE*,
+            const CSAMPLE*,
+            const int*,
+            const CSAMPLE_GAIN*,
+            const CSAMPLE_GAIN*,
+            int,
+            SINT,
+            int);
+    void (*interleavePlanarBuffer)(CSAMPLE*, const CSAMPLE* const*, int, SINT);
+    void (*interleaveStereoPairsClamp)(CSAMPLE*, const CSAMPLE* const*, int, SINT);
+    void (*copyStereoToMultiClamp)(CSAMPLE*, const CSAMPLE*, int, int, SINT);
+    void (*convertS16ToFloat32)(CSAMPLE*, const SAMPLE*, SINT);
+    void (*convertS32ToFloat32)(CSAMPLE*, const int32_t*, CSAMPLE, SINT);
+};
+
+// Defines a namespace with one function per kernel compiled with the given
+// target attribute and a SampleKernels table pointing to them.
+#define SAMPLE_KERNEL_VARIANT(NAMESPACE, TARGET)                                                  \
+    namespace NAMESPACE {                                                                         \
+    TARGET void applyRampingGain(                                                                 \
+            CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain, SINT numSamples) {    \
+        applyRampingGainKernel(pBuffer, old_gain, new_gain, numSamples);                          \
+    }                                                                                             \
+    TARGET void applyStereoGainCurve(                                                             \
+            CSAMPLE* pBuffer, const CSAMPLE_GAIN* pGains, SINT numFrames) {                       \
+        applyStereoGainCurveKernel(pBuffer, pGains, numFrames);                                   \
+    }                                                                                             \
+    TARGET void addWithGain(                                                                      \
+            CSAMPLE* pDest, const CSAMPLE* pSrc, CSAMPLE_GAIN gain, SINT numSamples) {            \
+        addWithGainKernel(pDest, pSrc, gain, numSamples);                                         \
+    }                                                                                             \
+    TARGET void addWithRampingGain(CSAMPLE* pDest,                                                \
+            const CSAMPLE* pSrc,                                                                  \
+            CSAMPLE_GAIN old_gain,                                                                \
+            CSAMPLE_GAIN new_gain,                                                                \
+            SINT numSamples) {                                                                    \
+        addWithRampingGainKernel(pDest, pSrc, old_gain, new_gain, numSamples);                    \
+    }                                                                                             \
+    TARGET void addMultipleWithRampingGain(CSAMPLE* pDest,                                        \
+            const CSAMPLE* const* pSrc,                                                           \
+            const CSAMPLE_GAIN* pOldGain,                                                         \
+            const CSAMPLE_GAIN* pNewGain,                                                         \
+            int numSources,                                                                       \
+            SINT numSamples) {                                                                    \
+        addMultipleWithRampingGainKernel(                                                         \
+                pDest, pSrc, pOldGain, pNewGain, numSources, numSamples);                         \
+    }                                                                                             \
+    TARGET void add2WithGain(CSAMPLE* pDest,                                                      \
+            const CSAMPLE* pSrc1,                                                                 \
+            CSAMPLE_GAIN gain1,                                                                   \
+            const CSAMPLE* pSrc2,                                                                 \
+            CSAMPLE_GAIN gain2,                                                                   \
+            SINT numSamples) {                                                                    \
+        add2WithGainKernel(pDest, pSrc1, gain1, pSrc2, gain2, numSamples);                        \
+    }                                                                                             \
+    TARGET void add3WithGain(CSAMPLE* pDest,                                                      \
+            const CSAMPLE* pSrc1,                                                                 \
+            CSAMPLE_GAIN gain1,                                                                   \
+            const CSAMPLE* pSrc2,                                                                 \
+            CSAMPLE_GAIN gain2,                                                                   \
+            const CSAMPLE* pSrc3,                                                                 \
+            CSAMPLE_GAIN gain3,                                                                   \
+            SINT numSamples) {                                                                    \
+        add3WithGainKernel(pDest, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, numSamples);          \
+    }                                                                                             \
+    TARGET SampleUtil::CLIP_STATUS sumAbsPerChannel(                                              \
+            CSAMPLE* pfAbsL, CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {          \
+        return sumAbsPerChannelKernel(pfAbsL, pfAbsR, pBuffer, numSamples);                       \
+    }                                                                                             \
+    TARGET void maxAbsPerChannel(                                                                 \
+            CSAMPLE* pfMaxL, CSAMPLE* pfMaxR, const CSAMPLE* pBuffer, SINT numSamples) {          \
+        maxAbsPerChannelKernel(pfMaxL, pfMaxR, pBuffer, numSamples);                              \
+    }                                                                                             \
+    TARGET void interleaveStereoBuffer(                                                           \
+            CSAMPLE* pDest, const CSAMPLE* pSrc1, const CSAMPLE* pSrc2, SINT numFrames) {         \
+        interleaveStereoBufferKernel(pDest, pSrc1, pSrc2, numFrames);                             \
+    }                                                                                             \
+    TARGET void interleaveStemBuffer(CSAMPLE* pDest,                                              \
+            const CSAMPLE* pSrc1,                                                                 \
+            const CSAMPLE* pSrc2,                                                                 \
+            const CSAMPLE* pSrc3,                                                                 \
+            const CSAMPLE* pSrc4,                                                                 \
+            const CSAMPLE* pSrc5,                                                                 \
+            const CSAMPLE* pSrc6,                                                                 \
+            const CSAMPLE* pSrc7,                                                                 \
+            const CSAMPLE* pSrc8,                                                                 \
+            SINT numFrames) {                                                                     \
+        interleaveStemBufferKernel(                                                               \
+                pDest, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, numFrames);        \
+    }                                                                                             \
+    TARGET void linearCrossfadeStemBuffersOut(                                                    \
+            CSAMPLE* pDestSrcFadeOut, const CSAMPLE* pSrcFadeIn, SINT numSamples) {               \
+        linearCrossfadeStemBuffersOutKernel(pDestSrcFadeOut, pSrcFadeIn, numSamples);             \
+    }                                                                                             \
+    TARGET void copyMultiToStereo(                                                                \
+            CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numFrames, int numChannels) {               \
+        copyMultiToStereoKernel(pDest, pSrc, numFrames, numChannels);                             \
+    }                                                                                             \
+    TARGET void interleavePlanarBuffer(                                                           \
+            CSAMPLE* pDest, const CSAMPLE* const* pSrc, int numChannels, SINT numFrames) {        \
+        interleavePlanarBufferKernel(pDest, pSrc, numChannels, numFrames);                        \
+    }                                                                                             \
+    TARGET void interleaveStereoPairsClamp(                                                       \
+            CSAMPLE* pDest, const CSAMPLE* const* pSrc, int numPairs, SINT numFrames) {           \
+        interleaveStereoPairsClampKernel(pDest, pSrc, numPairs, numFrames);                       \
+    }                                                                                             \
+    TARGET void copyStereoToMultiClamp(CSAMPLE* pDest,                                            \
+            const CSAMPLE* pSrc,                                                                  \
+            int numChannels,                                                                      \
+            int channelOffset,                                                                    \
+            SINT numFrames) {                                                                     \
+        copyStereoToMultiClampKernel(pDest, pSrc, numChannels, channelOffset, numFrames);         \
+    }                                                                                             \
+    TARGET void convertS16ToFloat32(CSAMPLE* pDest, const SAMPLE* pSrc, SINT numSamples) {        \
+        convertS16ToFloat32Kernel(pDest, pSrc, numSamples);                                       \
+    }                                                                                             \
+    TARGET void convertS32ToFloat32(                                                              \
+            CSAMPLE* pDest, const int32_t* pSrc, CSAMPLE scaleFactor, SINT numSamples) {          \
+        convertS32ToFloat32Kernel(pDest, pSrc, scaleFactor, numSamples);                          \
+    }                                                                                             \
+    TARGET void mixMultiToStereoWithRampingGain(CSAMPLE* pDest,                                   \
+            const CSAMPLE* pSrc,                                                                  \
+            const int* pChannelOffset,                                                            \
+            const CSAMPLE_GAIN* pOldGain,                                                         \
+            const CSAMPLE_GAIN* pNewGain,                                                         \
+            int numPairs,                                                                         \
+            SINT numFrames,                                                                       \
+            int numChannels) {                                                                    \
+        mixMultiToStereoWithRampingGainKernel(pDest,                                              \
+                pSrc,                                                                             \
+                pChannelOffset,                                                                   \
+                pOldGain,                                                                         \
+                pNewGain,                                                                         \
+                numPairs,                                                                         \
+                numFrames,                                                                        \
+                numChannels);                                                                     \
+    }                                                                                             \
+    constexpr SampleKernels kKernels = {                                                          \
+            &applyRampingGain,                                                                    \
+            &applyStereoGainCurve,                                                                \
+            &addWithGain,                                                                         \
+            &addWithRampingGain,                                                                  \
+            &addMultipleWithRampingGain,                                                          \
+            &add2WithGain,                                                                        \
+            &add3WithGain,                                                                        \
+            &sumAbsPerChannel,                                                                    \
+            &maxAbsPerChannel,                                                                    \
+            &interleaveStereoBuffer,                                                              \
+            &interleaveStemBuffer,                                                                \
+            &linearCrossfadeStemBuffersOut,                                                       \
+            &copyMultiToStereo,                                                                   \
+            &mixMultiToStereoWithRampingGain,                                                     \
+            &interleavePlanarBuffer,                                                              \
+            &interleaveStereoPairsClamp,                                                          \
+            &copyStereoToMultiClamp,                                                              \
+            &convertS16ToFloat32,                                                                 \
+            &convertS32ToFloat32,                                                                 \
+    };                                                                                            \
+    } // namespace NAMESPACE
+
+SAMPLE_KERNEL_VARIANT(baseline, )
+#ifdef MIXXX_SAMPLE_KERNEL_DISPATCH
+SAMPLE_KERNEL_VARIANT(avx2, SAMPLE_TARGET_AVX2)
+SAMPLE_KERNEL_VARIANT(avx512, SAMPLE_TARGET_AVX512)
+#endif
+
+// Constant initialized, so SampleUtil is usable during static initialization
+// before the best variant has been selected below.
+const SampleKernels* s_pKernels = &baseline::kKernels;
+SampleUtil::KernelVariant s_kernelVariant = SampleUtil::KernelVariant::Baseline;
+
 } // anonymous namespace
 
+namespace {
+// Selects the best kernel variant once at startup
+[[maybe_unused]] const bool s_kernelVariantSelected =
+        SampleUtil::setKernelVariant(SampleUtil::detectKernelVariant());
+} // anonymous namespace
+
+// static
+SampleUtil::KernelVariant SampleUtil::detectKernelVariant() {
+#ifdef MIXXX_SAMPLE_KERNEL_DISPATCH
+    // Required when called during static initialization
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) {
+        return KernelVariant::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return KernelVariant::Avx2;
+    }
+#endif
+    return KernelVariant::Baseline;
+}
+
+// static
+SampleUtil::KernelVariant SampleUtil::kernelVariant() {
+    return s_kernelVariant;
+}
+
+// static
+bool SampleUtil::isKernelVariantSupported(KernelVariant variant) {
+    return variant <= detectKernelVariant();
+}
+
+// static
+bool SampleUtil::setKernelVariant(KernelVariant variant) {
+    if (!isKernelVariantSupported(variant)) {
+        return false;
+    }
+    switch (variant) {
+#ifdef MIXXX_SAMPLE_KERNEL_DISPATCH
+    case KernelVariant::Avx512:
+        s_pKernels = &avx512::kKernels;
+        break;
+    case KernelVariant::Avx2:
+        s_pKernels = &avx2::kKernels;
+        break;
+#endif
+    default:
+        s_pKernels = &baseline::kKernels;
+        break;
+    }
+    s_kernelVariant = variant;
+    return true;
+}
+
 // static
 CSAMPLE* SampleUtil::alloc(SINT size) {
     // To speed up vectorization we align our sample buffers to 16-byte (128
@@ -137,24 +921,14 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
         clear(pBuffer, numSamples);
         return;
     }
+    s_pKernels->applyRampingGain(pBuffer, old_gain, new_gain, numSamples);
+}
 
-    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
-            / CSAMPLE_GAIN(numSamples / 2);
-    if (gain_delta != 0) {
-        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
-    } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pBuffer[i] *= old_gain;
-        }
-    }
+// static
+void SampleUtil::applyStereoGainCurve(CSAMPLE* pBuffer,
+        const CSAMPLE_GAIN* pGains,
+        SINT numFrames) {
+    s_pKernels->applyStereoGainCurve(pBuffer, pGains, numFrames);
 }
 
 CSAMPLE SampleUtil::copyWithRampingNormalization(CSAMPLE* pDest,
@@ -248,11 +1022,7 @@ void SampleUtil::addWithGain(CSAMPLE* M_RESTRICT pDest,
     if (gain == CSAMPLE_GAIN_ZERO) {
         return;
     }
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc[i] * gain;
-    }
+    s_pKernels->addWithGain(pDest, pSrc, gain, numSamples);
 }
 
 void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
@@ -262,23 +1032,22 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
     if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
         return;
     }
+    s_pKernels->addWithRampingGain(pDest, pSrc, old_gain, new_gain, numSamples);
+}
 
-    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
-            / CSAMPLE_GAIN(numSamples / 2);
-    if (gain_delta != 0) {
-        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
-    } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pDest[i] += pSrc[i] * old_gain;
-        }
+// static
+void SampleUtil::addMultipleWithRampingGain(CSAMPLE* pDest,
+        const CSAMPLE* const* pSrc,
+        const CSAMPLE_GAIN* pOldGain,
+        const CSAMPLE_GAIN* pNewGain,
+        int numSources,
+        SINT numSamples) {
+    DEBUG_ASSERT(numSources >= 0);
+    if (numSources <= 0) {
+        return;
     }
+    s_pKernels->addMultipleWithRampingGain(
+            pDest, pSrc, pOldGain, pNewGain, numSources, numSamples);
 }
 
 // static
@@ -293,11 +1062,7 @@ void SampleUtil::add2WithGain(CSAMPLE* M_RESTRICT pDest,
         addWithGain(pDest, pSrc1, gain1, numSamples);
         return;
     }
-
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
-    }
+    s_pKernels->add2WithGain(pDest, pSrc1, gain1, pSrc2, gain2, numSamples);
 }
 
 // static
@@ -316,11 +1081,7 @@ void SampleUtil::add3WithGain(CSAMPLE* pDest,
         add2WithGain(pDest, pSrc1, gain1, pSrc2, gain2, numSamples);
         return;
     }
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
-    }
+    s_pKernels->add3WithGain(pDest, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, numSamples);
 }
 
 // static
@@ -386,15 +1147,14 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
 // static
 void SampleUtil::convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
         const SAMPLE* M_RESTRICT pSrc, SINT numSamples) {
-    // SAMPLE_MIN = -32768 is a valid low sample, whereas SAMPLE_MAX = 32767
-    // is the highest valid sample. Note that this means that although some
-    // sample values convert to -1.0, none will convert to +1.0.
     DEBUG_ASSERT(-SAMPLE_MINIMUM >= SAMPLE_MAXIMUM);
-    const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] = CSAMPLE(pSrc[i]) / kConversionFactor;
-    }
+    s_pKernels->convertS16ToFloat32(pDest, pSrc, numSamples);
+}
+
+// static
+void SampleUtil::convertS32ToFloat32(CSAMPLE* pDest,
+        const int32_t* pSrc, CSAMPLE scaleFactor, SINT numSamples) {
+    s_pKernels->convertS32ToFloat32(pDest, pSrc, scaleFactor, numSamples);
 }
 
 //static
@@ -415,32 +1175,13 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
-    CSAMPLE clippedL = 0;
-    CSAMPLE clippedR = 0;
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
+    return s_pKernels->sumAbsPerChannel(pfAbsL, pfAbsR, pBuffer, numSamples);
+}
 
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
-    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
-    if (clippedL > 0) {
-        clipping |= SampleUtil::CLIPPING_LEFT;
-    }
-    if (clippedR > 0) {
-        clipping |= SampleUtil::CLIPPING_RIGHT;
-    }
-    return clipping;
+// static
+void SampleUtil::maxAbsPerChannel(CSAMPLE* pfMaxL,
+        CSAMPLE* pfMaxR, const CSAMPLE* pBuffer, SINT numSamples) {
+    s_pKernels->maxAbsPerChannel(pfMaxL, pfMaxR, pBuffer, numSamples);
 }
 
 // static
@@ -461,7 +1202,7 @@ CSAMPLE SampleUtil::rms(const CSAMPLE* pBuffer, SINT numSamples) {
 }
 
 CSAMPLE SampleUtil::maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE max = pBuffer[0];
+    CSAMPLE max = abs(pBuffer[0]);
     // note: LOOP VECTORIZED.
     for (SINT i = 1; i < numSamples; ++i) {
         CSAMPLE absValue = abs(pBuffer[i]);
@@ -472,6 +1213,17 @@ CSAMPLE SampleUtil::maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
     return max;
 }
 
+// static
+CSAMPLE SampleUtil::maxMid(const CSAMPLE* pBuffer, SINT numSamples) {
+    CSAMPLE max = std::numeric_limits<CSAMPLE>::lowest();
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE mid = (pBuffer[i * 2] + pBuffer[i * 2 + 1]) / 2;
+        max = mid > max ? mid : max;
+    }
+    return max;
+}
+
 // static
 void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
@@ -486,11 +1238,35 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    s_pKernels->interleaveStereoBuffer(pDest, pSrc1, pSrc2, numFrames);
+}
+
+// static
+void SampleUtil::interleavePlanarBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        int numChannels,
+        SINT numFrames) {
+    DEBUG_ASSERT(numChannels > 0);
+    s_pKernels->interleavePlanarBuffer(pDest, pSrc, numChannels, numFrames);
+}
+
+// static
+void SampleUtil::interleaveStereoPairsClamp(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        int numPairs,
+        SINT numFrames) {
+    DEBUG_ASSERT(numPairs > 0);
+    s_pKernels->interleaveStereoPairsClamp(pDest, pSrc, numPairs, numFrames);
+}
+
+// static
+void SampleUtil::copyStereoToMultiClamp(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        int numChannels,
+        int channelOffset,
+        SINT numFrames) {
+    DEBUG_ASSERT(channelOffset >= 0 && channelOffset + 2 <= numChannels);
+    s_pKernels->copyStereoToMultiClamp(pDest, pSrc, numChannels, channelOffset, numFrames);
 }
 
 // static
@@ -504,17 +1280,16 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc7,
         const CSAMPLE* M_RESTRICT pSrc8,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[8 * i] = pSrc1[i];
-        pDest[8 * i + 1] = pSrc2[i];
-        pDest[8 * i + 2] = pSrc3[i];
-        pDest[8 * i + 3] = pSrc4[i];
-        pDest[8 * i + 4] = pSrc5[i];
-        pDest[8 * i + 5] = pSrc6[i];
-        pDest[8 * i + 6] = pSrc7[i];
-        pDest[8 * i + 7] = pSrc8[i];
-    }
+    s_pKernels->interleaveStemBuffer(pDest,
+            pSrc1,
+            pSrc2,
+            pSrc3,
+            pSrc4,
+            pSrc5,
+            pSrc6,
+            pSrc7,
+            pSrc8,
+            numFrames);
 }
 
 // static
@@ -580,28 +1355,7 @@ void SampleUtil::linearCrossfadeStemBuffersOut(
         CSAMPLE* M_RESTRICT pDestSrcFadeOut,
         const CSAMPLE* M_RESTRICT pSrcFadeIn,
         SINT numSamples) {
-    // M_RESTRICT unoptimizes the function for some reason.
-    const CSAMPLE_GAIN cross_inc = CSAMPLE_GAIN_ONE / CSAMPLE_GAIN(numSamples / 8);
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < numSamples / 8; ++i) {
-        const CSAMPLE_GAIN cross_mix = cross_inc * i;
-        pDestSrcFadeOut[i * 8] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8] += pSrcFadeIn[i * 8] * cross_mix;
-        pDestSrcFadeOut[i * 8 + 1] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8 + 1] += pSrcFadeIn[i * 8 + 1] * cross_mix;
-        pDestSrcFadeOut[i * 8 + 2] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8 + 2] += pSrcFadeIn[i * 8 + 2] * cross_mix;
-        pDestSrcFadeOut[i * 8 + 3] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8 + 3] += pSrcFadeIn[i * 8 + 3] * cross_mix;
-        pDestSrcFadeOut[i * 8 + 4] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8 + 4] += pSrcFadeIn[i * 8 + 4] * cross_mix;
-        pDestSrcFadeOut[i * 8 + 5] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8 + 5] += pSrcFadeIn[i * 8 + 5] * cross_mix;
-        pDestSrcFadeOut[i * 8 + 6] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8 + 6] += pSrcFadeIn[i * 8 + 6] * cross_mix;
-        pDestSrcFadeOut[i * 8 + 7] *= (CSAMPLE_GAIN_ONE - cross_mix);
-        pDestSrcFadeOut[i * 8 + 7] += pSrcFadeIn[i * 8 + 7] * cross_mix;
-    }
+    s_pKernels->linearCrossfadeStemBuffersOut(pDestSrcFadeOut, pSrcFadeIn, numSamples);
 }
 
 // static
@@ -823,12 +1577,51 @@ void SampleUtil::copyMultiToStereo(
         SINT numFrames,
         mixxx::audio::ChannelCount numChannels) {
     DEBUG_ASSERT(numChannels > mixxx::audio::ChannelCount::stereo());
-    // forward loop
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[i * 2] = pSrc[i * numChannels];
-        pDest[i * 2 + 1] = pSrc[i * numChannels + 1];
+    s_pKernels->copyMultiToStereo(pDest, pSrc, numFrames, numChannels);
+}
+
+// static
+void SampleUtil::mixMultiToStereoWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        const CSAMPLE_GAIN* pOldGain,
+        const CSAMPLE_GAIN* pNewGain,
+        SINT numFrames,
+        mixxx::audio::ChannelCount numChannels) {
+    DEBUG_ASSERT(numChannels % mixxx::audio::ChannelCount::stereo() == 0);
+    constexpr int kMaxPairs = mixxx::kMaxEngineChannelInputCount /
+            mixxx::audio::ChannelCount::stereo();
+    const int numPairs = numChannels / mixxx::audio::ChannelCount::stereo();
+    VERIFY_OR_DEBUG_ASSERT(numPairs <= kMaxPairs) {
+        clear(pDest, numFrames * mixxx::audio::ChannelCount::stereo());
+        return;
+    }
+
+    // Silent pairs are skipped and not even read
+    int channelOffset[kMaxPairs];
+    CSAMPLE_GAIN oldGain[kMaxPairs];
+    CSAMPLE_GAIN newGain[kMaxPairs];
+    int numAudiblePairs = 0;
+    for (int pair = 0; pair < numPairs; ++pair) {
+        if (pOldGain[pair] == CSAMPLE_GAIN_ZERO && pNewGain[pair] == CSAMPLE_GAIN_ZERO) {
+            continue;
+        }
+        channelOffset[numAudiblePairs] = pair * mixxx::audio::ChannelCount::stereo();
+        oldGain[numAudiblePairs] = pOldGain[pair];
+        newGain[numAudiblePairs] = pNewGain[pair];
+        ++numAudiblePairs;
+    }
+    if (numAudiblePairs == 0) {
+        clear(pDest, numFrames * mixxx::audio::ChannelCount::stereo());
+        return;
     }
+    s_pKernels->mixMultiToStereoWithRampingGain(pDest,
+            pSrc,
+            channelOffset,
+            oldGain,
+            newGain,
+            numAudiblePairs,
+            numFrames,
+            numChannels);
 }
 
 // static
@@ -2,6 +2,7 @@
 
 #include <QFlags>
 #include <algorithm>
+#include <cstdint>
 #include <cstring> // memset
 
 #include "audio/types.h"
@@ -25,6 +26,24 @@ class SampleUtil {
     // This is some legacy, we cannot easily revert.
     static constexpr double kPlayPositionChannels = 2.0;
 
+    // Instruction set variants of the hot mixing and metering kernels. The
+    // best variant supported by the CPU is selected at startup, so builds for
+    // the SSE2 baseline can still use wider registers. Ordered by capability.
+    enum class KernelVariant {
+        Baseline = 0, // the instruction set of the build
+        Avx2,
+        Avx512,
+    };
+
+    // Returns the best kernel variant supported by the CPU and the compiler.
+    static KernelVariant detectKernelVariant();
+    static bool isKernelVariantSupported(KernelVariant variant);
+    static KernelVariant kernelVariant();
+    // Selects the kernel variant used by all subsequent calls. Returns false
+    // if the variant is not supported. This is not thread-safe and only
+    // intended for tests and benchmarks.
+    static bool setKernelVariant(KernelVariant variant);
+
     // Allocated a buffer of CSAMPLE's with length size. Ensures that the buffer
     // is 16-byte aligned for SSE enhancement.
     [[nodiscard]] static CSAMPLE* alloc(SINT size);
@@ -157,6 +176,13 @@ class SampleUtil {
     static void applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             CSAMPLE_GAIN new_gain, SINT numSamples);
 
+    // Multiply both samples of each stereo frame in pBuffer with the gain of
+    // the frame in pGains, which must contain numFrames gains. This allows to
+    // share a gain curve between many buffers.
+    static void applyStereoGainCurve(CSAMPLE* pBuffer,
+            const CSAMPLE_GAIN* pGains,
+            SINT numFrames);
+
     // Apply the necessary ramping gain to normalize the signal to a given amplitude,
     // i.e make the biggest sample have the given amplitude.
     //
@@ -193,6 +219,17 @@ class SampleUtil {
             CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain,
             SINT numSamples);
 
+    // Add each of the numSources stereo buffers pSrc[i], multiplied by a gain
+    // ramping from pOldGain[i] to pNewGain[i], to pDest. In contrast to
+    // calling addWithRampingGain for each buffer, pDest is written only once
+    // per sample.
+    static void addMultipleWithRampingGain(CSAMPLE* pDest,
+            const CSAMPLE* const* pSrc,
+            const CSAMPLE_GAIN* pOldGain,
+            const CSAMPLE_GAIN* pNewGain,
+            int numSources,
+            SINT numSamples);
+
     // Add to each sample of pDest, pSrc1 multiplied by gain1 plus pSrc2
     // multiplied by gain2
     static void add2WithGain(CSAMPLE* pDest, const CSAMPLE* pSrc1,
@@ -210,6 +247,12 @@ class SampleUtil {
     static void convertS16ToFloat32(CSAMPLE* pDest, const SAMPLE* pSrc,
             SINT numSamples);
 
+    // Convert a buffer of signed 32-bit integer samples to CSAMPLEs by
+    // multiplying them with scaleFactor, e.g. 1 / 2^31 for the full range.
+    // pDest may point to the same memory as pSrc for converting in place.
+    static void convertS32ToFloat32(CSAMPLE* pDest, const int32_t* pSrc,
+            CSAMPLE scaleFactor, SINT numSamples);
+
     // Convert and normalize a buffer of CSAMPLEs in the range [-1.0, 1.0]
     // to a buffer of SAMPLEs in the range [-SAMPLE_MAX, SAMPLE_MAX].
     static void convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
@@ -222,6 +265,13 @@ class SampleUtil {
     static CLIP_STATUS sumAbsPerChannel(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
             const CSAMPLE* pBuffer, SINT numSamples);
 
+    // For each pair of samples in pBuffer (l,r) -- raises pfMaxL to the
+    // absolute value of l and pfMaxR to the absolute value of r if greater.
+    // Both maxima must be initialized by the caller, which allows to
+    // accumulate the maxima over subsequent buffers.
+    static void maxAbsPerChannel(CSAMPLE* pfMaxL, CSAMPLE* pfMaxR,
+            const CSAMPLE* pBuffer, SINT numSamples);
+
     // Returns the sum of the squared values of the buffer.
     static CSAMPLE sumSquared(const CSAMPLE* pBuffer, SINT numSamples);
 
@@ -230,6 +280,10 @@ class SampleUtil {
 
     static CSAMPLE maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples);
 
+    // Returns the maximum of the mid values (l + r) / 2 of the stereo frames
+    // in pBuffer, or the lowest CSAMPLE value if the buffer is empty.
+    static CSAMPLE maxMid(const CSAMPLE* pBuffer, SINT numSamples);
+
     // Copies every sample in pSrc to pDest, limiting the values in pDest
     // to the valid range of CSAMPLE. pDest and pSrc must not overlap.
     static void copyClampBuffer(CSAMPLE* pDest, const CSAMPLE* pSrc,
@@ -256,6 +310,33 @@ class SampleUtil {
             const CSAMPLE* pSrc8,
             SINT numFrames);
 
+    // Interleave the planar buffers pSrc[0] to pSrc[numChannels - 1], each
+    // with numFrames samples, into pDest. pDest must not be an alias of any
+    // of the planar buffers.
+    static void interleavePlanarBuffer(CSAMPLE* pDest,
+            const CSAMPLE* const* pSrc,
+            int numChannels,
+            SINT numFrames);
+
+    // Interleave the stereo buffers pSrc[0] to pSrc[numPairs - 1], each with
+    // numFrames * 2 samples, into consecutive channel pairs of pDest, which
+    // has numPairs * 2 channels. The values are limited to the valid range
+    // of CSAMPLE. pDest must not be an alias of any of the stereo buffers.
+    static void interleaveStereoPairsClamp(CSAMPLE* pDest,
+            const CSAMPLE* const* pSrc,
+            int numPairs,
+            SINT numFrames);
+
+    // Copy the stereo buffer pSrc with numFrames * 2 samples into the
+    // channels channelOffset and channelOffset + 1 of the interleaved
+    // multi-channel buffer pDest, limiting the values to the valid range of
+    // CSAMPLE. The other channels of pDest are not touched.
+    static void copyStereoToMultiClamp(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            int numChannels,
+            int channelOffset,
+            SINT numFrames);
+
     // Deinterleave the samples in pSrc alternately into pDest1 and
     // pDest2 (stereo). numFrames must be the number of samples in pDest1 and pDest2,
     // and pSrc must have at least numFrames*2 samples. Neither pDest1 or
@@ -351,6 +432,20 @@ class SampleUtil {
             SINT numFrames,
             mixxx::audio::ChannelCount numChannels);
 
+    // Mixes the stereo channel pairs of the interleaved multi-channel samples
+    // in pSrc down to stereo samples into pDest in a single pass. Each pair is
+    // multiplied by a gain ramping from pOldGain[i] to pNewGain[i]. Pairs that
+    // are silent during the whole buffer are not read at all.
+    // pSrc must contain (numFrames * numChannels) samples and the gains
+    // (numChannels / 2) values.
+    // (numFrames * 2) samples will be written into pDest
+    static void mixMultiToStereoWithRampingGain(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            const CSAMPLE_GAIN* pOldGain,
+            const CSAMPLE_GAIN* pNewGain,
+            SINT numFrames,
+            mixxx::audio::ChannelCount numChannels);
+
     // reverses stereo sample in place
     static void reverse(CSAMPLE* pBuffer, SINT numSamples);
 
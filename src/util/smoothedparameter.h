@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/rampingvalue.h"
+
+/// The value of an effect parameter across engine callbacks.
+///
+/// Effects process each callback with value(). Gains and other values that
+/// are cheap to apply per sample are ramped from previousValue() with ramp().
+///
+/// Values that are expensive to derive from the parameter, like filter
+/// coefficients, only need to be recalculated for applied() when update()
+/// returns true. While the knob is moving, changes within the tolerance
+/// are skipped, which is the larger of the absolute tolerance and the
+/// relative tolerance of the applied value. The exact value is applied as
+/// soon as the knob stops.
+template<typename T>
+class SmoothedParameter {
+  public:
+    explicit constexpr SmoothedParameter(T initial,
+            T relativeTolerance = 0,
+            T absoluteTolerance = 0)
+            : m_value(initial),
+              m_previousValue(initial),
+              m_applied(initial),
+              m_relativeTolerance(relativeTolerance),
+              m_absoluteTolerance(absoluteTolerance) {
+    }
+
+    /// Sets the value of the current callback. Returns true if applied()
+    /// has changed, so the derived values need to be recalculated.
+    bool update(T value) {
+        m_value = value;
+        if (value == m_applied) {
+            return false;
+        }
+        const bool stopped = value == m_previousValue;
+        const T tolerance = std::max(m_absoluteTolerance,
+                m_relativeTolerance * std::abs(m_applied));
+        if (stopped || std::abs(value - m_applied) > tolerance) {
+            m_applied = value;
+            return true;
+        }
+        return false;
+    }
+
+    /// Ends the current callback
+    void commit() {
+        m_previousValue = m_value;
+    }
+
+    [[nodiscard]] constexpr T value() const {
+        return m_value;
+    }
+
+    [[nodiscard]] constexpr T previousValue() const {
+        return m_previousValue;
+    }
+
+    /// The value the derived values have been calculated for
+    [[nodiscard]] constexpr T applied() const {
+        return m_applied;
+    }
+
+    [[nodiscard]] constexpr bool changed() const {
+        return m_value != m_previousValue;
+    }
+
+    /// Ramps from the value of the previous callback to the current value
+    [[nodiscard]] constexpr RampingValue<T> ramp(int steps) const {
+        return RampingValue<T>(m_previousValue, m_value, steps);
+    }
+
+  private:
+    T m_value;
+    T m_previousValue;
+    T m_applied;
+    T m_relativeTolerance;
+    T m_absoluteTolerance;
+};
@@ -0,0 +1,97 @@
+#include "util/startuptasks.h"
+
+#include <QtConcurrentRun>
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+namespace mixxx {
+
+StartupTasks::StartupTasks()
+        : m_stepEntryIndex(-1) {
+    m_timer.start();
+}
+
+StartupTasks::~StartupTasks() {
+    endStep();
+    waitForAll();
+}
+
+StartupTasks::TaskId StartupTasks::run(const QString& name, std::function<void()> task) {
+    const TaskId id = static_cast<TaskId>(m_tasks.size());
+    m_tasks.append(QtConcurrent::run(&m_threadPool, [this, name, task = std::move(task)] {
+        const int entryIndex = beginEntry(name, true);
+        task();
+        endEntry(entryIndex);
+    }));
+    return id;
+}
+
+void StartupTasks::beginStep(const QString& name, const QList<TaskId>& dependencies) {
+    endStep();
+    m_stepEntryIndex = beginEntry(name, false);
+    for (const TaskId id : dependencies) {
+        VERIFY_OR_DEBUG_ASSERT(id >= 0 && id < m_tasks.size()) {
+            continue;
+        }
+        m_tasks[id].waitForFinished();
+    }
+    const auto locker = lockMutex(&m_entriesMutex);
+    Entry& entry = m_entries[m_stepEntryIndex];
+    entry.wait = m_timer.elapsed() - entry.start;
+}
+
+void StartupTasks::endStep() {
+    if (m_stepEntryIndex < 0) {
+        return;
+    }
+    endEntry(m_stepEntryIndex);
+    m_stepEntryIndex = -1;
+}
+
+void StartupTasks::waitForAll() {
+    for (auto& task : m_tasks) {
+        task.waitForFinished();
+    }
+}
+
+QStringList StartupTasks::timeline() const {
+    QList<Entry> entries;
+    {
+        const auto locker = lockMutex(&m_entriesMutex);
+        entries = m_entries;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.start < rhs.start;
+    });
+
+    QStringList lines;
+    lines.reserve(entries.size());
+    for (const auto& entry : std::as_const(entries)) {
+        QString line = QStringLiteral("%1 ms - %2 ms %3 %4")
+                               .arg(entry.start.toDoubleMillis(), 8, 'f', 1)
+                               .arg(entry.end.toDoubleMillis(), 8, 'f', 1)
+                               .arg(entry.background ? QStringLiteral("[background]")
+                                                     : QStringLiteral("[main]      "),
+                                       entry.name);
+        if (entry.wait > Duration::empty()) {
+            line += QStringLiteral(" (waited %1 ms)").arg(entry.wait.toDoubleMillis(), 0, 'f', 1);
+        }
+        lines.append(line);
+    }
+    return lines;
+}
+
+int StartupTasks::beginEntry(const QString& name, bool background) {
+    const auto locker = lockMutex(&m_entriesMutex);
+    m_entries.append(Entry{name, background, m_timer.elapsed(), Duration::empty(), Duration::empty()});
+    return static_cast<int>(m_entries.size()) - 1;
+}
+
+void StartupTasks::endEntry(int entryIndex) {
+    const auto locker = lockMutex(&m_entriesMutex);
+    m_entries[entryIndex].end = m_timer.elapsed();
+}
+
+} // namespace mixxx
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <functional>
+
+#include "util/duration.h"
+#include "util/performancetimer.h"
+
+namespace mixxx {
+
+/// Runs the independent parts of the startup in parallel and records a
+/// timeline of all startup steps.
+///
+/// Tasks that do not depend on objects of the main thread, like scanning
+/// for plugins or loading fonts, are started with run() and run in the
+/// background right away. The main thread records its consecutive steps
+/// with beginStep(), which first waits for the tasks the step depends on.
+class StartupTasks {
+  public:
+    using TaskId = int;
+
+    StartupTasks();
+    /// Waits for all tasks
+    ~StartupTasks();
+
+    /// Starts the task in the background
+    TaskId run(const QString& name, std::function<void()> task);
+
+    /// Begins the next step of the main thread and ends the previous one
+    void beginStep(const QString& name, const QList<TaskId>& dependencies = {});
+    /// Ends the current step of the main thread
+    void endStep();
+
+    void waitForAll();
+
+    /// One line per task and step, ordered by the start time
+    QStringList timeline() const;
+
+  private:
+    struct Entry {
+        QString name;
+        bool background;
+        Duration start;
+        Duration end;
+        /// The time a step waited for its dependencies
+        Duration wait;
+    };
+
+    int beginEntry(const QString& name, bool background);
+    void endEntry(int entryIndex);
+
+    PerformanceTimer m_timer;
+    QThreadPool m_threadPool;
+    QList<QFuture<void>> m_tasks;
+    /// The entry of the current step of the main thread or -1
+    int m_stepEntryIndex;
+
+    mutable QMutex m_entriesMutex;
+    QList<Entry> m_entries;
+};
+
+} // namespace mixxx
@@ -0,0 +1,172 @@
+#include "util/statsdexporter.h"
+
+#include <QHostInfo>
+
+#include "util/assert.h"
+
+namespace mixxx {
+
+namespace {
+
+// Stays below the typical MTU, larger datagrams might be fragmented or
+// dropped on the way.
+constexpr int kMaxDatagramSize = 1432;
+
+double millisFactor(Stat::StatType type) {
+    switch (type) {
+    case Stat::DURATION_NANOSEC:
+        return 1e-6;
+    case Stat::DURATION_SEC:
+        return 1e3;
+    default:
+        return 1.0;
+    }
+}
+
+double histogramPercentile(const QMap<double, double>& histogram,
+        double reportCount,
+        double percentile) {
+    const double rank = percentile * reportCount;
+    double count = 0.0;
+    for (auto it = histogram.constBegin(); it != histogram.constEnd(); ++it) {
+        count += it.value();
+        if (count >= rank) {
+            return it.key();
+        }
+    }
+    return histogram.isEmpty() ? 0.0 : histogram.lastKey();
+}
+
+QByteArray formatLine(const QByteArray& name, double value, const char* type) {
+    return name + ':' + QByteArray::number(value, 'g', 10) + '|' + type;
+}
+
+} // anonymous namespace
+
+StatsdExporter::StatsdExporter(const QHostAddress& address,
+        quint16 port,
+        const QString& prefix)
+        : m_address(address),
+          m_port(port),
+          m_prefix(prefix) {
+}
+
+// static
+bool StatsdExporter::parseTarget(
+        const QString& target, QHostAddress* pAddress, quint16* pPort) {
+    DEBUG_ASSERT(pAddress);
+    DEBUG_ASSERT(pPort);
+    const int separator = target.lastIndexOf(QChar(':'));
+    if (separator <= 0) {
+        return false;
+    }
+    bool ok = false;
+    const uint port = target.mid(separator + 1).toUInt(&ok);
+    if (!ok || port == 0 || port > 65535) {
+        return false;
+    }
+    QString host = target.left(separator);
+    if (host.startsWith(QChar('[')) && host.endsWith(QChar(']'))) {
+        // IPv6 address
+        host = host.mid(1, host.size() - 2);
+    }
+    if (!pAddress->setAddress(host)) {
+        const QHostInfo hostInfo = QHostInfo::fromName(host);
+        if (hostInfo.addresses().isEmpty()) {
+            return false;
+        }
+        *pAddress = hostInfo.addresses().first();
+    }
+    *pPort = static_cast<quint16>(port);
+    return true;
+}
+
+// static
+QByteArray StatsdExporter::metricName(const QString& prefix, const QString& tag) {
+    QByteArray name = prefix.toUtf8();
+    name.reserve(name.size() + 1 + tag.size());
+    name += '.';
+    bool lastWasSeparator = true;
+    for (const QChar c : tag) {
+        if ((c >= QChar('a') && c <= QChar('z')) ||
+                (c >= QChar('A') && c <= QChar('Z')) ||
+                (c >= QChar('0') && c <= QChar('9'))) {
+            name += static_cast<char>(c.unicode());
+            lastWasSeparator = false;
+        } else if (!lastWasSeparator) {
+            name += '_';
+            lastWasSeparator = true;
+        }
+    }
+    while (name.endsWith('_')) {
+        name.chop(1);
+    }
+    return name;
+}
+
+QList<QByteArray> StatsdExporter::formatStats(const QMap<QString, Stat>& stats) {
+    QList<QByteArray> lines;
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const Stat& stat = it.value();
+        ExportedStat& exported = m_exportedStats[it.key()];
+        const double newReports = stat.m_report_count - exported.reportCount;
+        if (newReports <= 0) {
+            continue;
+        }
+        const QByteArray name = metricName(m_prefix, it.key());
+        if (stat.m_type == Stat::COUNTER) {
+            lines.append(formatLine(name, stat.m_sum - exported.sum, "c"));
+        } else {
+            const double factor = millisFactor(stat.m_type);
+            lines.append(formatLine(name + ".count", newReports, "c"));
+            if (stat.m_compute & Stat::AVERAGE) {
+                lines.append(formatLine(name + ".avg",
+                        factor * stat.m_sum / stat.m_report_count,
+                        "g"));
+            }
+            if (stat.m_compute & Stat::MIN) {
+                lines.append(formatLine(name + ".min", factor * stat.m_min, "g"));
+            }
+            if (stat.m_compute & Stat::MAX) {
+                lines.append(formatLine(name + ".max", factor * stat.m_max, "g"));
+            }
+            if (stat.m_compute & Stat::HISTOGRAM) {
+                lines.append(formatLine(name + ".p50",
+                        factor *
+                                histogramPercentile(stat.m_histogram,
+                                        stat.m_report_count,
+                                        0.5),
+                        "g"));
+                lines.append(formatLine(name + ".p99",
+                        factor *
+                                histogramPercentile(stat.m_histogram,
+                                        stat.m_report_count,
+                                        0.99),
+                        "g"));
+            }
+        }
+        exported.reportCount = stat.m_report_count;
+        exported.sum = stat.m_sum;
+    }
+    return lines;
+}
+
+void StatsdExporter::exportStats(const QMap<QString, Stat>& stats) {
+    const QList<QByteArray> lines = formatStats(stats);
+    QByteArray datagram;
+    for (const auto& line : lines) {
+        if (!datagram.isEmpty() && datagram.size() + 1 + line.size() > kMaxDatagramSize) {
+            m_socket.writeDatagram(datagram, m_address, m_port);
+            datagram.clear();
+        }
+        if (!datagram.isEmpty()) {
+            datagram += '\n';
+        }
+        datagram += line;
+    }
+    if (!datagram.isEmpty()) {
+        m_socket.writeDatagram(datagram, m_address, m_port);
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QUdpSocket>
+
+#include "util/stat.h"
+
+namespace mixxx {
+
+/// Sends the stats of the StatsManager in the statsd text format over UDP,
+/// so they can be collected centrally, e.g. by Telegraf or a statsd server.
+///
+/// Only the stats that received reports since the previous export are sent.
+/// Counters are sent as the increment since the previous export. For all
+/// other stats the number of reports is sent as a counter and the average,
+/// minimum and maximum as gauges, together with the median and the 99th
+/// percentile if the stat keeps a histogram. Durations are converted to
+/// milliseconds.
+///
+/// The socket is used synchronously, so the exporter can be used from a
+/// thread without an event loop.
+class StatsdExporter {
+  public:
+    StatsdExporter(const QHostAddress& address,
+            quint16 port,
+            const QString& prefix = QStringLiteral("mixxx"));
+
+    /// Parses "host:port" and resolves the host. Returns false if the
+    /// target is invalid or the host cannot be resolved.
+    static bool parseTarget(const QString& target, QHostAddress* pAddress, quint16* pPort);
+
+    /// Sends the stats that changed since the previous export
+    void exportStats(const QMap<QString, Stat>& stats);
+
+    /// The lines of all stats that changed since the previous export. Each
+    /// stat is only reported once by either formatStats() or exportStats().
+    QList<QByteArray> formatStats(const QMap<QString, Stat>& stats);
+
+    /// Replaces all characters of the tag that have a special meaning in
+    /// statsd or in the metric names of common backends.
+    static QByteArray metricName(const QString& prefix, const QString& tag);
+
+  private:
+    struct ExportedStat {
+        double reportCount = 0.0;
+        double sum = 0.0;
+    };
+
+    const QHostAddress m_address;
+    const quint16 m_port;
+    const QString m_prefix;
+    QUdpSocket m_socket;
+    QHash<QString, ExportedStat> m_exportedStats;
+};
+
+} // namespace mixxx
@@ -8,14 +8,28 @@
 #include "moc_statsmanager.cpp"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qmutex.h"
+#include "util/memoryaccount.h"
+#include "util/performancetimer.h"
+#include "util/statsdexporter.h"
 
 // In practice we process stats pipes about once a minute @1ms latency.
 constexpr int kStatsPipeSize = 1 << 10;
 constexpr int kProcessLength = kStatsPipeSize * 4 / 5;
 
+// The interval of processing and exporting the stats if they are sent to a
+// statsd server. Common statsd servers flush every 10 s.
+constexpr int kStatsdExportIntervalMillis = 10000;
+
+// The prefix of the stats that are logged for each audio buffer underflow
+const QString kCachingReaderTagPrefix = QStringLiteral("CachingReader ");
+
 // static
 bool StatsManager::s_bStatsManagerEnabled = false;
 
+// static
+const QString StatsManager::kAudioOverloadTag =
+        QStringLiteral("SoundManager audio latency overload");
+
 StatsPipe::StatsPipe(StatsManager* pManager)
         : m_pManager(pManager),
           m_queue(kStatsPipeSize) {
@@ -233,20 +247,70 @@ void StatsManager::processIncomingStatReports() {
                 event.m_time = mixxx::Duration::fromNanos(report.time);
                 m_events.append(event);
             }
+
+            if (tag == kAudioOverloadTag) {
+                logCachingReaderStats();
+            }
         }
     }
 }
 
+void StatsManager::logCachingReaderStats() const {
+    // The reports of the engine thread are processed in order, so the stats
+    // of the CachingReaders are those up to the underflow. The stats of the
+    // workers may already include later reports.
+    qInfo() << "StatsManager: Audio buffer underflow, CachingReader stats:";
+    for (auto it = m_stats.lowerBound(kCachingReaderTagPrefix);
+            it != m_stats.constEnd() && it.key().startsWith(kCachingReaderTagPrefix);
+            ++it) {
+        qInfo() << it.value();
+    }
+}
+
+std::unique_ptr<mixxx::StatsdExporter> StatsManager::createStatsdExporter() {
+    const QString& target = CmdlineArgs::Instance().getStatsdTarget();
+    if (target.isEmpty()) {
+        return nullptr;
+    }
+    QHostAddress address;
+    quint16 port;
+    if (!mixxx::StatsdExporter::parseTarget(target, &address, &port)) {
+        qWarning() << "StatsManager: Invalid statsd target" << target;
+        return nullptr;
+    }
+    qInfo() << "StatsManager: Sending stats to" << address << port;
+    return std::make_unique<mixxx::StatsdExporter>(address, port);
+}
+
 void StatsManager::run() {
     qDebug() << "StatsManager thread starting up.";
+    // Created here, because the socket must be used on this thread
+    const std::unique_ptr<mixxx::StatsdExporter> pStatsdExporter = createStatsdExporter();
+    PerformanceTimer exportTimer;
+    exportTimer.start();
     while (true) {
         m_statsPipeLock.lock();
-        m_statsPipeCondition.wait(&m_statsPipeLock);
+        if (pStatsdExporter) {
+            m_statsPipeCondition.wait(&m_statsPipeLock, kStatsdExportIntervalMillis);
+        } else {
+            m_statsPipeCondition.wait(&m_statsPipeLock);
+        }
+        // Reporting may register the pipe of this thread, which takes the lock
+        m_statsPipeLock.unlock();
+        MemoryAccount::reportAll();
+        m_statsPipeLock.lock();
         // We want to process reports even when we are about to quit since we
         // want to print the most accurate stat report on shutdown.
         processIncomingStatReports();
         m_statsPipeLock.unlock();
 
+        if (pStatsdExporter &&
+                (exportTimer.elapsed().toIntegerMillis() >= kStatsdExportIntervalMillis ||
+                        m_quit.loadAcquire() == 1)) {
+            pStatsdExporter->exportStats(m_stats);
+            exportTimer.restart();
+        }
+
         if (m_emitAllStats.loadAcquire() == 1) {
             for (auto it = m_stats.constBegin();
                  it != m_stats.constEnd(); ++it) {
@@ -10,6 +10,7 @@
 #include <QWaitCondition>
 #include <QThreadStorage>
 #include <QList>
+#include <memory>
 
 #include "rigtorp/SPSCQueue.h"
 
@@ -19,6 +20,10 @@
 
 class StatsManager;
 
+namespace mixxx {
+class StatsdExporter;
+} // namespace mixxx
+
 class StatsPipe final {
   public:
     explicit StatsPipe(StatsManager* pManager);
@@ -58,6 +63,11 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
 
     static bool s_bStatsManagerEnabled;
 
+    // The counter of audio buffer underflows. The stats of all CachingReaders
+    // are logged when it is reported, to tell cache misses from other causes
+    // of dropouts.
+    static const QString kAudioOverloadTag;
+
     // Tell the StatsManager to emit statUpdated for every stat that exists.
     void emitAllStats() {
         m_emitAllStats = 1;
@@ -75,9 +85,13 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
 
   private:
     void processIncomingStatReports();
+    void logCachingReaderStats() const;
     StatsPipe* getStatsPipeForThread();
     void onStatsPipeDestroyed(StatsPipe* pPipe);
     void writeTimeline(const QString& filename);
+    /// Returns nullptr unless a statsd target has been passed on the
+    /// command line
+    static std::unique_ptr<mixxx::StatsdExporter> createStatsdExporter();
 
     QAtomicInt m_emitAllStats;
     QAtomicInt m_quit;
@@ -0,0 +1,61 @@
+#include "util/stringinterner.h"
+
+#include <algorithm>
+
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+// Avoids purging small sets of strings over and over again
+constexpr int kMinPurgeSize = 1024;
+
+} // anonymous namespace
+
+StringInterner::StringInterner()
+        : m_purgeSize(kMinPurgeSize) {
+}
+
+// static
+StringInterner& StringInterner::instance() {
+    static StringInterner s_instance;
+    return s_instance;
+}
+
+QString StringInterner::intern(const QString& string) {
+    if (string.isEmpty()) {
+        // Empty strings do not allocate anything
+        return string;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    const auto it = m_strings.constFind(string);
+    if (it != m_strings.constEnd()) {
+        return *it;
+    }
+    if (m_strings.size() >= m_purgeSize) {
+        purgeLocked();
+    }
+    m_strings.insert(string);
+    return string;
+}
+
+int StringInterner::size() const {
+    const auto locker = lockMutex(&m_mutex);
+    return static_cast<int>(m_strings.size());
+}
+
+void StringInterner::purge() {
+    const auto locker = lockMutex(&m_mutex);
+    purgeLocked();
+}
+
+void StringInterner::purgeLocked() {
+    for (auto it = m_strings.begin(); it != m_strings.end();) {
+        // Detached means that no one else refers to the data
+        if (it->isDetached()) {
+            it = m_strings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_purgeSize = std::max(kMinPurgeSize, static_cast<int>(m_strings.size()) * 2);
+}
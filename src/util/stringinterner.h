@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+/// Shares the data of equal strings, e.g. of metadata fields like the
+/// artist, the album or the genre that are repeated for many tracks.
+///
+/// Qt strings are implicitly shared, so all strings that are returned for
+/// equal values refer to a single buffer until they are modified. Strings
+/// that are not referenced outside of the interner anymore are released
+/// when the number of interned strings has doubled since the last purge.
+///
+/// All functions are thread-safe.
+class StringInterner final {
+  public:
+    StringInterner();
+
+    /// The interner of the metadata of tracks
+    static StringInterner& instance();
+
+    /// Returns a string that is equal to the given string and shares its
+    /// data with all other interned strings of the same value.
+    QString intern(const QString& string);
+
+    int size() const;
+
+    /// Releases the strings that are only referenced by the interner.
+    void purge();
+
+  private:
+    void purgeLocked();
+
+    mutable QMutex m_mutex;
+    QSet<QString> m_strings;
+    int m_purgeSize;
+};
@@ -0,0 +1,397 @@
+#include "util/threadplacement.h"
+
+#include <QThread>
+#include <algorithm>
+#include <array>
+
+#if defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <QtDBus>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+// windows.h must be included first
+#include <avrt.h>
+#endif
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("ThreadPlacement");
+
+const QString kConfigGroup = QStringLiteral("[ThreadPlacement]");
+
+// Upper bound for CPU indices, which also limits the length of ranges
+constexpr int kMaxCpus = 1024;
+
+std::array<ThreadPlacement::Placement, ThreadPlacement::kNumRoles> s_placements;
+bool s_useSystemScheduler = false;
+
+thread_local bool t_placed = false;
+
+#if !defined(Q_OS_LINUX)
+QThread::Priority qThreadPriority(ThreadPlacement::PriorityClass priority) {
+    switch (priority) {
+    case ThreadPlacement::PriorityClass::Low:
+        return QThread::LowPriority;
+    case ThreadPlacement::PriorityClass::High:
+        return QThread::HighestPriority;
+    case ThreadPlacement::PriorityClass::Realtime:
+        return QThread::TimeCriticalPriority;
+    case ThreadPlacement::PriorityClass::Default:
+    case ThreadPlacement::PriorityClass::Normal:
+        break;
+    }
+    return QThread::NormalPriority;
+}
+#endif
+
+#if defined(Q_OS_LINUX)
+/// Real-time priorities relative to each other. The channel and RubberBand
+/// workers are waited for by the audio callback and therefore run right
+/// below it.
+int realtimePriority(ThreadPlacement::Role role) {
+    switch (role) {
+    case ThreadPlacement::Role::Audio:
+        return 70;
+    case ThreadPlacement::Role::ChannelWorker:
+    case ThreadPlacement::Role::RubberBand:
+        return 69;
+    case ThreadPlacement::Role::VinylControl:
+        return 60;
+    case ThreadPlacement::Role::Controller:
+        return 50;
+    case ThreadPlacement::Role::EngineWorker:
+        return 40;
+    case ThreadPlacement::Role::SideChain:
+        return 30;
+    case ThreadPlacement::Role::Analysis:
+        break;
+    }
+    return 1;
+}
+
+const QString kRtkitService = QStringLiteral("org.freedesktop.RealtimeKit1");
+const QString kRtkitPath = QStringLiteral("/org/freedesktop/RealtimeKit1");
+
+std::optional<qlonglong> rtkitProperty(const QString& name) {
+    QDBusMessage msg = QDBusMessage::createMethodCall(kRtkitService,
+            kRtkitPath,
+            QStringLiteral("org.freedesktop.DBus.Properties"),
+            QStringLiteral("Get"));
+    msg << kRtkitService << name;
+    const QDBusMessage response = QDBusConnection::systemBus().call(msg);
+    if (response.type() == QDBusMessage::ErrorMessage ||
+            response.arguments().isEmpty()) {
+        return std::nullopt;
+    }
+    bool ok = false;
+    const qlonglong value = response.arguments()
+                                    .first()
+                                    .value<QDBusVariant>()
+                                    .variant()
+                                    .toLongLong(&ok);
+    if (!ok) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+bool callRtkit(const QString& method, pid_t tid, const QVariant& argument) {
+    QDBusMessage msg = QDBusMessage::createMethodCall(
+            kRtkitService, kRtkitPath, kRtkitService, method);
+    msg << QVariant::fromValue(static_cast<quint64>(tid)) << argument;
+    const QDBusMessage response = QDBusConnection::systemBus().call(msg);
+    if (response.type() == QDBusMessage::ErrorMessage) {
+        kLogger.warning() << "rtkit" << method << "failed:" << response.errorMessage();
+        return false;
+    }
+    return true;
+}
+
+bool makeRealtimeWithRtkit(pid_t tid, int priority) {
+    // rtkit only grants real-time scheduling to processes that limit the
+    // CPU time a real-time thread may consume without blocking.
+    const auto maxRtTime = rtkitProperty(QStringLiteral("RTTimeUSecMax"));
+    struct rlimit rlim;
+    if (maxRtTime && getrlimit(RLIMIT_RTTIME, &rlim) == 0 &&
+            (rlim.rlim_max == RLIM_INFINITY ||
+                    rlim.rlim_max > static_cast<rlim_t>(*maxRtTime))) {
+        rlim.rlim_cur = static_cast<rlim_t>(*maxRtTime);
+        rlim.rlim_max = static_cast<rlim_t>(*maxRtTime);
+        if (setrlimit(RLIMIT_RTTIME, &rlim) != 0) {
+            kLogger.warning() << "Failed to limit the real-time CPU time for rtkit";
+            return false;
+        }
+    }
+    const auto maxPriority = rtkitProperty(QStringLiteral("MaxRealtimePriority"));
+    if (maxPriority) {
+        priority = std::min(priority, static_cast<int>(*maxPriority));
+    }
+    return callRtkit(QStringLiteral("MakeThreadRealtime"),
+            tid,
+            QVariant::fromValue(static_cast<quint32>(priority)));
+}
+
+int niceValue(ThreadPlacement::PriorityClass priority) {
+    switch (priority) {
+    case ThreadPlacement::PriorityClass::Low:
+        return 10;
+    case ThreadPlacement::PriorityClass::High:
+        return -10;
+    default:
+        break;
+    }
+    return 0;
+}
+
+bool applyAffinity(const QList<int>& cpus) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+bool applyPriority(ThreadPlacement::Role role,
+        ThreadPlacement::PriorityClass priority,
+        bool useSystemScheduler) {
+    const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    if (priority == ThreadPlacement::PriorityClass::Realtime) {
+        struct sched_param param = {};
+        param.sched_priority = std::clamp(realtimePriority(role),
+                sched_get_priority_min(SCHED_FIFO),
+                sched_get_priority_max(SCHED_FIFO));
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) {
+            return true;
+        }
+        return useSystemScheduler && makeRealtimeWithRtkit(tid, param.sched_priority);
+    }
+    // Return to the default policy, e.g. for a thread of the audio backend
+    struct sched_param param = {};
+    if (pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) != 0) {
+        return false;
+    }
+    // The nice value is per thread on Linux, QThread::setPriority() has no
+    // effect on threads with the default policy.
+    const int nice = niceValue(priority);
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice) == 0) {
+        return true;
+    }
+    return useSystemScheduler &&
+            callRtkit(QStringLiteral("MakeThreadHighPriority"),
+                    tid,
+                    QVariant::fromValue(static_cast<qint32>(nice)));
+}
+#elif defined(Q_OS_WIN)
+bool isAudioPath(ThreadPlacement::Role role) {
+    return role == ThreadPlacement::Role::Audio ||
+            role == ThreadPlacement::Role::ChannelWorker ||
+            role == ThreadPlacement::Role::RubberBand;
+}
+
+bool applyAffinity(const QList<int>& cpus) {
+    DWORD_PTR mask = 0;
+    for (const int cpu : cpus) {
+        if (cpu < static_cast<int>(sizeof(mask) * 8)) {
+            mask |= DWORD_PTR{1} << cpu;
+        }
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+bool applyPriority(ThreadPlacement::Role role,
+        ThreadPlacement::PriorityClass priority,
+        bool useSystemScheduler) {
+    if (priority == ThreadPlacement::PriorityClass::Realtime && useSystemScheduler) {
+        // The Multimedia Class Scheduler Service boosts the thread without
+        // starving the rest of the system.
+        DWORD taskIndex = 0;
+        const HANDLE hTask = AvSetMmThreadCharacteristicsW(L"Pro Audio", &taskIndex);
+        if (hTask) {
+            return AvSetMmThreadPriority(hTask,
+                           isAudioPath(role) ? AVRT_PRIORITY_CRITICAL
+                                             : AVRT_PRIORITY_HIGH) != 0;
+        }
+        kLogger.warning() << "MMCSS registration failed with error" << GetLastError();
+    }
+    QThread::currentThread()->setPriority(qThreadPriority(priority));
+    return true;
+}
+#else
+bool applyAffinity(const QList<int>& cpus) {
+    Q_UNUSED(cpus);
+    kLogger.warning() << "Setting the CPU affinity is not supported on this platform";
+    return false;
+}
+
+bool applyPriority(ThreadPlacement::Role role,
+        ThreadPlacement::PriorityClass priority,
+        bool useSystemScheduler) {
+    Q_UNUSED(role);
+    Q_UNUSED(useSystemScheduler);
+    QThread::currentThread()->setPriority(qThreadPriority(priority));
+    return true;
+}
+#endif
+
+} // anonymous namespace
+
+// static
+void ThreadPlacement::init(UserSettingsPointer pConfig) {
+    s_useSystemScheduler = pConfig->getValue(
+            ConfigKey(kConfigGroup, QStringLiteral("UseSystemScheduler")), false);
+    for (int i = 0; i < kNumRoles; ++i) {
+        const auto role = static_cast<Role>(i);
+        const QString name = roleName(role);
+        Placement placement;
+
+        const QString priorityValue = pConfig->getValueString(
+                ConfigKey(kConfigGroup, name + QStringLiteral("Priority")));
+        const auto priority = parsePriorityClass(priorityValue);
+        if (priority) {
+            placement.priority = *priority;
+        } else {
+            kLogger.warning() << "Ignoring invalid priority" << priorityValue
+                              << "for" << name;
+        }
+
+        const QString cpusValue = pConfig->getValueString(
+                ConfigKey(kConfigGroup, name + QStringLiteral("Cpus")));
+        const auto cpus = parseCpuList(cpusValue);
+        if (cpus) {
+            placement.cpus = *cpus;
+        } else {
+            kLogger.warning() << "Ignoring invalid CPU list" << cpusValue
+                              << "for" << name;
+        }
+
+        if (placement.priority != PriorityClass::Default || !placement.cpus.isEmpty()) {
+            kLogger.info() << name << "threads are placed with priority"
+                           << priorityValue << "on CPUs" << placement.cpus;
+        }
+        s_placements[i] = placement;
+    }
+}
+
+// static
+ThreadPlacement::Placement ThreadPlacement::placement(Role role) {
+    return s_placements[static_cast<int>(role)];
+}
+
+// static
+bool ThreadPlacement::applyToCurrentThread(Role role) {
+    return applyToCurrentThread(role, s_useSystemScheduler);
+}
+
+// static
+void ThreadPlacement::applyToCurrentThreadOnce(Role role) {
+    if (t_placed) {
+        return;
+    }
+    t_placed = true;
+    applyToCurrentThread(role, false);
+}
+
+// static
+bool ThreadPlacement::applyToCurrentThread(Role role, bool useSystemScheduler) {
+    const Placement& placement = s_placements[static_cast<int>(role)];
+    bool success = true;
+    if (!placement.cpus.isEmpty() && !applyAffinity(placement.cpus)) {
+        kLogger.warning() << "Failed to bind" << QThread::currentThread()->objectName()
+                          << "to CPUs" << placement.cpus;
+        success = false;
+    }
+    if (placement.priority != PriorityClass::Default &&
+            !applyPriority(role, placement.priority, useSystemScheduler)) {
+        kLogger.warning() << "Failed to change the priority of"
+                          << QThread::currentThread()->objectName();
+        success = false;
+    }
+    return success;
+}
+
+// static
+QString ThreadPlacement::roleName(Role role) {
+    switch (role) {
+    case Role::Audio:
+        return QStringLiteral("Audio");
+    case Role::ChannelWorker:
+        return QStringLiteral("ChannelWorker");
+    case Role::RubberBand:
+        return QStringLiteral("RubberBand");
+    case Role::EngineWorker:
+        return QStringLiteral("EngineWorker");
+    case Role::SideChain:
+        return QStringLiteral("SideChain");
+    case Role::Controller:
+        return QStringLiteral("Controller");
+    case Role::VinylControl:
+        return QStringLiteral("VinylControl");
+    case Role::Analysis:
+        return QStringLiteral("Analysis");
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QString();
+}
+
+// static
+std::optional<ThreadPlacement::PriorityClass> ThreadPlacement::parsePriorityClass(
+        const QString& value) {
+    const QString priority = value.trimmed().toLower();
+    if (priority.isEmpty() || priority == QLatin1String("default")) {
+        return PriorityClass::Default;
+    } else if (priority == QLatin1String("low")) {
+        return PriorityClass::Low;
+    } else if (priority == QLatin1String("normal")) {
+        return PriorityClass::Normal;
+    } else if (priority == QLatin1String("high")) {
+        return PriorityClass::High;
+    } else if (priority == QLatin1String("realtime")) {
+        return PriorityClass::Realtime;
+    }
+    return std::nullopt;
+}
+
+// static
+std::optional<QList<int>> ThreadPlacement::parseCpuList(const QString& value) {
+    QList<int> cpus;
+    if (value.trimmed().isEmpty()) {
+        return cpus;
+    }
+    const QStringList items = value.split(QChar(','));
+    for (const auto& item : items) {
+        const QStringList bounds = item.split(QChar('-'));
+        if (bounds.size() > 2) {
+            return std::nullopt;
+        }
+        bool firstOk = false;
+        bool lastOk = false;
+        const int first = bounds.first().trimmed().toInt(&firstOk);
+        const int last = bounds.last().trimmed().toInt(&lastOk);
+        if (!firstOk || !lastOk || first < 0 || last < first ||
+                last >= kMaxCpus) {
+            return std::nullopt;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            if (!cpus.contains(cpu)) {
+                cpus.append(cpu);
+            }
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    return cpus;
+}
+
+} // namespace mixxx
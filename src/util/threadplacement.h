@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <optional>
+
+#include "preferences/usersettings.h"
+
+namespace mixxx {
+
+/// Applies the configured scheduling priority and CPU affinity to the
+/// threads of the engine and its workers.
+///
+/// Each thread calls applyToCurrentThread() with its role once it is
+/// running. The placement of all roles is read from the [ThreadPlacement]
+/// section of the configuration by init(), which has to be called before
+/// any of these threads is started:
+///
+///   <Role>Priority = default|low|normal|high|realtime
+///   <Role>Cpus = 2,3 or 2-3 (empty = all CPUs)
+///   UseSystemScheduler = 1 to request the real-time priority from
+///                        rtkit (Linux) or MMCSS (Windows)
+///
+/// Roles without a configured priority keep the priority chosen by the
+/// thread itself, which is the behavior without any configuration.
+class ThreadPlacement {
+  public:
+    enum class Role {
+        Audio,
+        ChannelWorker,
+        RubberBand,
+        EngineWorker,
+        SideChain,
+        Controller,
+        VinylControl,
+        Analysis,
+    };
+    static constexpr int kNumRoles = static_cast<int>(Role::Analysis) + 1;
+
+    enum class PriorityClass {
+        Default,
+        Low,
+        Normal,
+        High,
+        Realtime,
+    };
+
+    struct Placement {
+        PriorityClass priority = PriorityClass::Default;
+        QList<int> cpus;
+    };
+
+    static void init(UserSettingsPointer pConfig);
+
+    static Placement placement(Role role);
+
+    /// Whether the priority of the role is configured and must not be
+    /// overridden by the thread itself.
+    static bool hasConfiguredPriority(Role role) {
+        return placement(role).priority != PriorityClass::Default;
+    }
+
+    /// Applies the placement of the role to the calling thread. This may
+    /// block on a D-Bus call to rtkit and must not be called from the
+    /// audio callback.
+    static bool applyToCurrentThread(Role role);
+
+    /// Applies the placement once per thread, for threads of a pool that
+    /// are not started by Mixxx. Subsequent calls are real-time safe. The
+    /// system scheduler service is not used, because the first call may
+    /// happen while processing audio.
+    static void applyToCurrentThreadOnce(Role role);
+
+    static QString roleName(Role role);
+    static std::optional<PriorityClass> parsePriorityClass(const QString& value);
+    /// Parses a list of CPU indices like "0,2-3". Returns std::nullopt
+    /// if the list is malformed.
+    static std::optional<QList<int>> parseCpuList(const QString& value);
+
+  private:
+    static bool applyToCurrentThread(Role role, bool useSystemScheduler);
+};
+
+} // namespace mixxx
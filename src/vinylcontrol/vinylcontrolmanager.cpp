@@ -8,7 +8,6 @@
 #include "mixer/playermanager.h"
 #include "moc_vinylcontrolmanager.cpp"
 #include "soundio/soundmanager.h"
-#include "util/defs.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "vinylcontrol/vinylcontrolprocessor.h"
 
@@ -73,11 +72,12 @@ void VinylControlManager::slotNumDecksChanged(double dNumDecks) {
     int num_decks = static_cast<int>(dNumDecks);
 
     // Complain if we try to create more decks than we can handle.
-    if (num_decks > kMaxNumberOfDecks) {
+    if (num_decks > kMaximumVinylControlInputs) {
         qWarning() << "Number of decks increased to " << num_decks << ", but Mixxx only supports "
-                   << kMaxNumberOfDecks << " vinyl inputs.  Decks above the maximum will not have "
+                   << kMaximumVinylControlInputs
+                   << " vinyl inputs.  Decks above the maximum will not have "
                    << " vinyl control";
-        num_decks = kMaxNumberOfDecks;
+        num_decks = kMaximumVinylControlInputs;
     }
 
     if (num_decks <= m_iNumConfiguredDecks) {
@@ -1,9 +1,14 @@
 #include "vinylcontrol/vinylcontrolprocessor.h"
 
+#include <array>
+
+#include "audio/types.h"
 #include "control/controlpushbutton.h"
 #include "moc_vinylcontrolprocessor.cpp"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
+#include "util/threadplacement.h"
 #include "util/timer.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "vinylcontrol/vinylcontrol.h"
@@ -12,6 +17,20 @@
 #define SIGNAL_QUALITY_FIFO_SIZE 256
 #define SAMPLE_PIPE_FIFO_SIZE 65536
 
+namespace {
+
+// The share of the buffer duration that decoding one deck may take in the
+// engine callback. With 4 decks this leaves more than half of the buffer
+// for the engine.
+constexpr double kCallbackDecodeMaxLoad = 0.1;
+
+// A deck falls back to the thread after this number of consecutive buffers
+// that exceeded the budget. A single slow buffer is tolerated, because the
+// first lookups after a needle drop are slower.
+constexpr int kMaxCallbackOverBudgetBuffers = 3;
+
+} // anonymous namespace
+
 VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPointer pConfig)
         : QThread(pParent),
           m_pConfig(pConfig),
@@ -22,7 +41,9 @@ VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPoint
           m_signalQualityFifo(SIGNAL_QUALITY_FIFO_SIZE),
           m_bReportSignalQuality(false),
           m_bQuit(false),
-          m_bReloadConfig(false) {
+          m_bReloadConfig(false),
+          m_bDecodeInCallback(false),
+          m_callbackBudgetNanosPerFrame(0) {
     connect(m_pToggle,
             &ControlPushButton::valueChanged,
             this,
@@ -31,7 +52,13 @@ VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPoint
 
     for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
         m_samplePipes[i] = new FIFO<CSAMPLE>(SAMPLE_PIPE_FIFO_SIZE);
+        m_pCallbackWorkBuffers[i] = SampleUtil::alloc(MAX_BUFFER_LEN);
+        m_callbackOverBudgetCount[i] = 0;
+        m_callbackFallback[i].store(false);
+        m_callbackFallbackReported[i] = false;
+        m_deckBusy[i].store(false);
     }
+    reloadConfig();
 
     start(QThread::HighPriority);
 }
@@ -53,6 +80,9 @@ VinylControlProcessor::~VinylControlProcessor() {
 
             delete m_samplePipes[i];
             m_samplePipes[i] = nullptr;
+
+            SampleUtil::free(m_pCallbackWorkBuffers[i]);
+            m_pCallbackWorkBuffers[i] = nullptr;
         }
     }
 
@@ -78,6 +108,7 @@ void VinylControlProcessor::requestReloadConfig() {
 void VinylControlProcessor::run() {
     unsigned static id = 0; //the id of this thread, for debugging purposes //XXX copypasta (should factor this out somehow), -kousu 2/2009
     QThread::currentThread()->setObjectName(QString("VinylControlProcessor %1").arg(++id));
+    mixxx::ThreadPlacement::applyToCurrentThread(mixxx::ThreadPlacement::Role::VinylControl);
 
     while (!m_bQuit) {
         if (m_bReloadConfig) {
@@ -85,11 +116,22 @@ void VinylControlProcessor::run() {
             m_bReloadConfig = false;
         }
 
+        // Take the processors of all decks at once instead of locking for
+        // each deck, then drain the sample pipes of all decks in one pass.
+        std::array<VinylControl*, kMaximumVinylControlInputs> processors;
+        {
+            const auto locker = lockMutex(&m_processorsLock);
+            std::copy(m_processors.cbegin(), m_processors.cend(), processors.begin());
+        }
+
         for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
-            auto locker = lockMutex(&m_processorsLock);
-            VinylControl* pProcessor = m_processors[i];
-            locker.unlock();
+            VinylControl* pProcessor = processors[i];
             FIFO<CSAMPLE>* pSamplePipe = m_samplePipes[i];
+            if (!tryClaimDeck(i)) {
+                // The deck is decoded by the engine callback right now, which
+                // wakes us up again.
+                continue;
+            }
 
             if (pSamplePipe->readAvailable() > 0) {
                 int samplesRead = pSamplePipe->read(m_pWorkBuffer, MAX_BUFFER_LEN);
@@ -119,6 +161,17 @@ void VinylControlProcessor::run() {
                     }
                 }
             }
+            releaseDeck(i);
+
+            if (m_callbackFallback[i].load(std::memory_order_relaxed) &&
+                    !m_callbackFallbackReported[i]) {
+                // Reported here, because the engine callback must not log
+                m_callbackFallbackReported[i] = true;
+                qWarning() << "VinylControlProcessor: Decoding in the audio "
+                              "callback takes too long, falling back to the "
+                              "thread for VC index:"
+                           << i;
+            }
         }
 
         if (m_bQuit) {
@@ -134,6 +187,21 @@ void VinylControlProcessor::run() {
 }
 
 void VinylControlProcessor::reloadConfig() {
+    const auto sampleRate = mixxx::audio::SampleRate(
+            m_pConfig->getValueString(ConfigKey("[Soundcard]", "Samplerate"))
+                    .toUInt());
+    if (sampleRate.isValid()) {
+        m_callbackBudgetNanosPerFrame.store(
+                1e9 / sampleRate.toDouble() * kCallbackDecodeMaxLoad);
+    }
+    m_bDecodeInCallback.store(m_pConfig->getValue<bool>(
+            ConfigKey(VINYL_PREF_KEY, "decode_in_audio_callback"), false));
+    // Give all decks another chance after the preferences have changed
+    for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
+        m_callbackFallback[i].store(false);
+        m_callbackFallbackReported[i] = false;
+    }
+
     for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
         auto locker = lockMutex(&m_processorsLock);
         VinylControl* pCurrent = m_processors[i];
@@ -224,6 +292,14 @@ void VinylControlProcessor::receiveBuffer(const AudioInput& input,
         return;
     }
 
+    if (analyzeSamplesInCallback(vcIndex, pBuffer, nFrames)) {
+        // Wake up the thread for the signal quality report
+        if (m_bReportSignalQuality) {
+            m_samplesAvailableSignal.wakeAll();
+        }
+        return;
+    }
+
     constexpr int kChannels = 2;
     const int nSamples = nFrames * kChannels;
     int samplesWritten = pSamplePipe->write(pBuffer, nSamples);
@@ -236,6 +312,63 @@ void VinylControlProcessor::receiveBuffer(const AudioInput& input,
     m_samplesAvailableSignal.wakeAll();
 }
 
+bool VinylControlProcessor::analyzeSamplesInCallback(
+        int vcIndex, const CSAMPLE* pBuffer, unsigned int nFrames) {
+    constexpr int kChannels = 2;
+    if (!m_bDecodeInCallback.load(std::memory_order_relaxed) ||
+            m_callbackFallback[vcIndex].load(std::memory_order_relaxed) ||
+            nFrames * kChannels > MAX_BUFFER_LEN) {
+        return false;
+    }
+    // Samples queued for the thread need to be decoded first to keep the
+    // order of the samples.
+    if (m_samplePipes[vcIndex]->readAvailable() > 0) {
+        return false;
+    }
+    // Never wait in the callback, the thread is responsible if the
+    // processors are being replaced.
+    if (!m_processorsLock.tryLock()) {
+        return false;
+    }
+    VinylControl* pProcessor = m_processors[vcIndex];
+    if (!pProcessor || !tryClaimDeck(vcIndex)) {
+        m_processorsLock.unlock();
+        return false;
+    }
+
+    PerformanceTimer timer;
+    timer.start();
+    CSAMPLE* pWorkBuffer = m_pCallbackWorkBuffers[vcIndex];
+    SampleUtil::copy(pWorkBuffer, pBuffer, nFrames * kChannels);
+    pProcessor->analyzeSamples(pWorkBuffer, nFrames);
+    const auto elapsed = timer.elapsed();
+
+    releaseDeck(vcIndex);
+    m_processorsLock.unlock();
+
+    if (elapsed.toDoubleNanos() >
+            m_callbackBudgetNanosPerFrame.load(std::memory_order_relaxed) * nFrames) {
+        if (++m_callbackOverBudgetCount[vcIndex] >= kMaxCallbackOverBudgetBuffers) {
+            m_callbackOverBudgetCount[vcIndex] = 0;
+            m_callbackFallback[vcIndex].store(true);
+            // Let the thread report the fallback
+            m_samplesAvailableSignal.wakeAll();
+        }
+    } else {
+        m_callbackOverBudgetCount[vcIndex] = 0;
+    }
+    return true;
+}
+
+bool VinylControlProcessor::tryClaimDeck(int vcIndex) {
+    bool expected = false;
+    return m_deckBusy[vcIndex].compare_exchange_strong(expected, true);
+}
+
+void VinylControlProcessor::releaseDeck(int vcIndex) {
+    m_deckBusy[vcIndex].store(false);
+}
+
 void VinylControlProcessor::toggleDeck(double value) {
     if (value == 0) {
         return;
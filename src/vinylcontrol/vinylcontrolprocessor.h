@@ -3,6 +3,7 @@
 #include <QThread>
 #include <QVector>
 #include <QWaitCondition>
+#include <atomic>
 
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
@@ -18,6 +19,10 @@ class QObject;
 // the engine callback and feeding those samples to the VinylControl
 // classes. The most important thing is that the connection between the engine
 // callback and VinylControlProcessor (the receiveBuffer method) is lock-free.
+//
+// Optionally the samples are decoded directly in the engine callback, which
+// saves the latency of handing the samples over to the thread. Decks fall
+// back to the thread if the decoding takes too long.
 class VinylControlProcessor : public QThread, public AudioDestination {
     Q_OBJECT
   public:
@@ -44,7 +49,8 @@ class VinylControlProcessor : public QThread, public AudioDestination {
     virtual void onInputUnconfigured(const AudioInput& input);
 
     // Called by the engine callback. Must not touch any state in
-    // VinylControlProcessor except for m_samplePipes. NOTE:
+    // VinylControlProcessor except for m_samplePipes and the state for
+    // decoding in the callback. NOTE:
 
     // This is called by SoundManager whenever there are new samples from the
     // configured input to be processed. This is run in the callback thread of
@@ -62,6 +68,11 @@ class VinylControlProcessor : public QThread, public AudioDestination {
 
   private:
     void reloadConfig();
+    // Called from the engine callback. Returns false if the samples need to
+    // be passed to the thread.
+    bool analyzeSamplesInCallback(int vcIndex, const CSAMPLE* pBuffer, unsigned int iNumFrames);
+    bool tryClaimDeck(int vcIndex);
+    void releaseDeck(int vcIndex);
 
     UserSettingsPointer m_pConfig;
     ControlPushButton* m_pToggle;
@@ -78,4 +89,17 @@ class VinylControlProcessor : public QThread, public AudioDestination {
     volatile bool m_bReportSignalQuality;
     volatile bool m_bQuit;
     volatile bool m_bReloadConfig;
+
+    // Decoding in the engine callback
+    std::atomic<bool> m_bDecodeInCallback;
+    // The time budget for decoding one frame of one deck in the callback
+    std::atomic<double> m_callbackBudgetNanosPerFrame;
+    CSAMPLE* m_pCallbackWorkBuffers[kMaximumVinylControlInputs];
+    // Only accessed by the engine callback
+    int m_callbackOverBudgetCount[kMaximumVinylControlInputs];
+    std::atomic<bool> m_callbackFallback[kMaximumVinylControlInputs];
+    // Only accessed by the thread
+    bool m_callbackFallbackReported[kMaximumVinylControlInputs];
+    // Set while a deck is decoded, either by the callback or the thread
+    std::atomic<bool> m_deckBusy[kMaximumVinylControlInputs];
 };
@@ -1,6 +1,7 @@
 #include "vinylcontrol/vinylcontrolxwax.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "audio/types.h"
 #include "control/controlobject.h"
@@ -217,17 +218,15 @@ void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
         m_workBufferSize = samplesSize;
     }
 
-    // Convert CSAMPLE samples to shorts, preventing overflow.
-    for (int i = 0; i < static_cast<int>(samplesSize); ++i) {
-        CSAMPLE sample = pSamples[i] * gain * SAMPLE_MAXIMUM;
-
-        if (sample > SAMPLE_MAXIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MAXIMUM;
-        } else if (sample < SAMPLE_MINIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MINIMUM;
-        } else {
-            m_pWorkBuffer[i] = static_cast<short>(sample);
-        }
+    // Convert CSAMPLE samples to shorts, preventing overflow. The loop is
+    // kept free of branches so that the compiler can vectorize it.
+    const CSAMPLE scale = gain * SAMPLE_MAXIMUM;
+    short* pWorkBuffer = m_pWorkBuffer.data();
+    for (size_t i = 0; i < samplesSize; ++i) {
+        const CSAMPLE sample = pSamples[i] * scale;
+        pWorkBuffer[i] = static_cast<short>(std::max(
+                std::min(sample, static_cast<CSAMPLE>(SAMPLE_MAXIMUM)),
+                static_cast<CSAMPLE>(SAMPLE_MINIMUM)));
     }
 
     // Submit the samples to the xwax timecode processor. The size argument is
@@ -0,0 +1,113 @@
+#include "waveform/guiframescheduler.h"
+
+#include <QPointer>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "util/assert.h"
+
+namespace {
+
+struct Registration {
+    QPointer<QObject> pReceiver;
+    GuiFrameScheduler::Rate rate;
+    GuiFrameScheduler::Callback callback;
+};
+
+bool s_active = false;
+bool s_dispatching = false;
+std::vector<Registration> s_registrations;
+// Registrations that have been added while dispatching
+std::vector<Registration> s_addedRegistrations;
+
+bool isDue(GuiFrameScheduler::Rate rate, bool tick50ms, bool tick1s) {
+    switch (rate) {
+    case GuiFrameScheduler::Rate::EveryFrame:
+        return true;
+    case GuiFrameScheduler::Rate::Every50ms:
+        return tick50ms;
+    case GuiFrameScheduler::Rate::Every1s:
+        return tick1s;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return false;
+}
+
+void removeDeadRegistrations() {
+    s_registrations.erase(std::remove_if(s_registrations.begin(),
+                                  s_registrations.end(),
+                                  [](const Registration& registration) {
+                                      return registration.pReceiver.isNull();
+                                  }),
+            s_registrations.end());
+}
+
+} // anonymous namespace
+
+// static
+bool GuiFrameScheduler::isActive() {
+    return s_active;
+}
+
+// static
+void GuiFrameScheduler::setActive(bool active) {
+    s_active = active;
+}
+
+// static
+void GuiFrameScheduler::add(QObject* pReceiver, Rate rate, Callback callback) {
+    VERIFY_OR_DEBUG_ASSERT(pReceiver && callback) {
+        return;
+    }
+    Registration registration{pReceiver, rate, std::move(callback)};
+    if (s_dispatching) {
+        // Adding to s_registrations would invalidate the running callback
+        s_addedRegistrations.push_back(std::move(registration));
+    } else {
+        s_registrations.push_back(std::move(registration));
+    }
+}
+
+// static
+void GuiFrameScheduler::remove(QObject* pReceiver) {
+    for (auto* pRegistrations : {&s_registrations, &s_addedRegistrations}) {
+        for (auto& registration : *pRegistrations) {
+            if (registration.pReceiver == pReceiver) {
+                // Erased after dispatching
+                registration.pReceiver.clear();
+            }
+        }
+    }
+    if (!s_dispatching) {
+        removeDeadRegistrations();
+    }
+}
+
+// static
+void GuiFrameScheduler::dispatch(double frameTimeSeconds, bool tick50ms, bool tick1s) {
+    VERIFY_OR_DEBUG_ASSERT(!s_dispatching) {
+        return;
+    }
+    s_dispatching = true;
+    bool hasDeadRegistrations = false;
+    for (const auto& registration : s_registrations) {
+        if (registration.pReceiver.isNull()) {
+            hasDeadRegistrations = true;
+            continue;
+        }
+        if (isDue(registration.rate, tick50ms, tick1s)) {
+            registration.callback(frameTimeSeconds);
+        }
+    }
+    s_dispatching = false;
+    if (hasDeadRegistrations) {
+        removeDeadRegistrations();
+    }
+    if (!s_addedRegistrations.empty()) {
+        std::move(s_addedRegistrations.begin(),
+                s_addedRegistrations.end(),
+                std::back_inserter(s_registrations));
+        s_addedRegistrations.clear();
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QObject>
+#include <functional>
+
+/// Dispatches the periodic updates of the GUI within the frames that are
+/// driven by GuiTick.
+///
+/// Widgets that refresh periodically register a callback with a rate class
+/// instead of starting their own QTimer. All callbacks that are due are
+/// invoked within the same frame, so the main thread does not wake up
+/// in between frames for each of them. The callbacks of a rate class are
+/// invoked on the same frames as the `gui_tick_*` controls.
+///
+/// Must only be used from the main thread.
+class GuiFrameScheduler {
+  public:
+    enum class Rate {
+        EveryFrame,
+        Every50ms,
+        Every1s,
+    };
+
+    /// Receives the time of the frame in seconds, see
+    /// [App],gui_tick_full_period_s
+    using Callback = std::function<void(double)>;
+
+    /// Returns false if no GuiTick drives the frames, e.g. in tests. Then
+    /// consumers must fall back to their own timers.
+    static bool isActive();
+
+    /// Invokes the callback for every frame of the rate class until
+    /// pReceiver is destroyed or removed.
+    static void add(QObject* pReceiver, Rate rate, Callback callback);
+    static void remove(QObject* pReceiver);
+
+  private:
+    friend class GuiTick;
+
+    static void setActive(bool active);
+    static void dispatch(double frameTimeSeconds, bool tick50ms, bool tick1s);
+};
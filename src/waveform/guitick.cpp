@@ -1,13 +1,21 @@
 #include "waveform/guitick.h"
 
+#include "control/controlchangecoalescer.h"
 #include "control/controlobject.h"
+#include "waveform/guiframescheduler.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
 const QString kLegacyGroup = QStringLiteral("[Master]");
+
+// Longer intervals between two ticks are recorded as stalls of the GUI thread
+constexpr auto kStallThreshold = mixxx::Duration::fromMillis(100);
 } // namespace
 
-GuiTick::GuiTick() {
+GuiTick::GuiTick()
+        : m_stallName(FlightRecorder::instance().registerName(
+                  QStringLiteral("GUI thread stall"))) {
+    FlightRecorder::instance().nameCurrentThread(QStringLiteral("GUI"));
     m_pCOGuiTickTime = std::make_unique<ControlObject>(
             ConfigKey(kAppGroup, QStringLiteral("gui_tick_full_period_s")));
     m_pCOGuiTickTime->addAlias(ConfigKey(kLegacyGroup, QStringLiteral("guiTickTime")));
@@ -15,17 +23,38 @@ GuiTick::GuiTick() {
             ConfigKey(kAppGroup, QStringLiteral("gui_tick_50ms_period_s")));
     m_pCOGuiTick50ms->addAlias(ConfigKey(kLegacyGroup, QStringLiteral("guiTick50ms")));
     m_cpuTimer.start();
+    GuiFrameScheduler::setActive(true);
+}
+
+GuiTick::~GuiTick() {
+    GuiFrameScheduler::setActive(false);
 }
 
 // this is called from WaveformWidgetFactory::render in the main thread with the
 // configured waveform frame rate
 void GuiTick::process() {
-    m_cpuTimeLastTick += m_cpuTimer.restart();
+    const mixxx::Duration interval = m_cpuTimer.restart();
+    m_cpuTimeLastTick += interval;
+    if (interval > kStallThreshold) {
+        const qint64 nowNs = FlightRecorder::nowNs();
+        FlightRecorder::instance().recordSpan(
+                m_stallName, nowNs - interval.toIntegerNanos(), nowNs);
+    }
     double cpuTimeLastTickSeconds = m_cpuTimeLastTick.toDoubleSeconds();
     m_pCOGuiTickTime->set(cpuTimeLastTickSeconds);
 
-    if (m_cpuTimeLastTick - m_lastUpdateTime >= mixxx::Duration::fromMillis(50)) {
+    const bool tick50ms =
+            m_cpuTimeLastTick - m_lastUpdateTime >= mixxx::Duration::fromMillis(50);
+    if (tick50ms) {
         m_lastUpdateTime = m_cpuTimeLastTick;
         m_pCOGuiTick50ms->set(cpuTimeLastTickSeconds);
     }
+    const bool tick1s =
+            m_cpuTimeLastTick - m_lastSecondUpdateTime >= mixxx::Duration::fromSeconds(1);
+    if (tick1s) {
+        m_lastSecondUpdateTime = m_cpuTimeLastTick;
+    }
+
+    ControlChangeCoalescer::dispatch();
+    GuiFrameScheduler::dispatch(cpuTimeLastTickSeconds, tick50ms, tick1s);
 }
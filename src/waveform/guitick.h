@@ -4,14 +4,16 @@
 
 #include "control/controlobject.h"
 #include "util/duration.h"
+#include "util/flightrecorder.h"
 #include "util/performancetimer.h"
 
 /// A helper class that manages the `gui_Tick` COs, that drive updates of the
 /// GUI from the `VSyncThread` at the user's configured FPS (possibly
-/// downsampled).
+/// downsampled). It also dispatches the callbacks of the GuiFrameScheduler.
 class GuiTick {
   public:
     GuiTick();
+    ~GuiTick();
     void process();
 
   private:
@@ -19,5 +21,7 @@ class GuiTick {
     std::unique_ptr<ControlObject> m_pCOGuiTick50ms;
     PerformanceTimer m_cpuTimer;
     mixxx::Duration m_lastUpdateTime;
+    mixxx::Duration m_lastSecondUpdateTime;
     mixxx::Duration m_cpuTimeLastTick;
+    const FlightRecorder::NameId m_stallName;
 };
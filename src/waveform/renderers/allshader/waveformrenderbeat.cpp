@@ -1,6 +1,7 @@
 #include "waveform/renderers/allshader/waveformrenderbeat.h"
 
 #include <QDomNode>
+#include <algorithm>
 
 #include "skin/legacy/skincontext.h"
 #include "track/track.h"
@@ -26,6 +27,33 @@ void WaveformRenderBeat::setup(const QDomNode& node, const SkinContext& context)
     m_color = WSkinColor::getCorrectColor(m_color).toRgb();
 }
 
+void WaveformRenderBeat::updateBeatPositions(const mixxx::BeatsPointer& pBeats,
+        mixxx::audio::FramePos startPosition,
+        mixxx::audio::FramePos endPosition,
+        mixxx::audio::FramePos trackEndPosition) {
+    if (pBeats == m_pBeatPositionsBeats &&
+            m_beatPositionsStart.isValid() &&
+            startPosition >= m_beatPositionsStart &&
+            endPosition <= m_beatPositionsEnd) {
+        return;
+    }
+
+    // Cover the whole track plus the currently displayed range on both
+    // sides, which is usually sufficient for the lifetime of the beats
+    const auto displayedLength = endPosition - startPosition;
+    m_beatPositionsStart = std::min(startPosition, mixxx::audio::kStartFramePos) -
+            displayedLength;
+    m_beatPositionsEnd = std::max(endPosition, trackEndPosition) + displayedLength;
+    m_pBeatPositionsBeats = pBeats;
+
+    m_beatPositions.clear();
+    for (auto it = pBeats->iteratorFrom(m_beatPositionsStart);
+            it != pBeats->cend() && *it <= m_beatPositionsEnd;
+            ++it) {
+        m_beatPositions.push_back(it->toEngineSamplePos());
+    }
+}
+
 void WaveformRenderBeat::paintGL() {
     TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
 
@@ -76,28 +104,25 @@ void WaveformRenderBeat::paintGL() {
 
     const int numVerticesPerLine = 6; // 2 triangles
 
-    // Count the number of beats in the range to reserve space in the m_vertices vector.
-    // Note that we could also use
-    //   int numBearsInRange = trackBeats->numBeatsInRange(startPosition, endPosition);
-    // for this, but there have been reports of that method failing with a DEBUG_ASSERT.
-    int numBeatsInRange = 0;
-    for (auto it = trackBeats->iteratorFrom(startPosition);
-            it != trackBeats->cend() && *it <= endPosition;
-            ++it) {
-        numBeatsInRange++;
-    }
-
-    const int reserved = numBeatsInRange * numVerticesPerLine;
+    updateBeatPositions(trackBeats,
+            startPosition,
+            endPosition,
+            mixxx::audio::FramePos::fromEngineSamplePos(trackSamples));
+    const auto beginIt = std::lower_bound(m_beatPositions.cbegin(),
+            m_beatPositions.cend(),
+            startPosition.toEngineSamplePos());
+    const auto endIt = std::upper_bound(beginIt,
+            m_beatPositions.cend(),
+            endPosition.toEngineSamplePos());
+
+    const int reserved = static_cast<int>(std::distance(beginIt, endIt)) * numVerticesPerLine;
     m_vertices.clear();
     m_vertices.reserve(reserved);
 
-    for (auto it = trackBeats->iteratorFrom(startPosition);
-            it != trackBeats->cend() && *it <= endPosition;
-            ++it) {
-        double beatPosition = it->toEngineSamplePos();
+    for (auto it = beginIt; it != endIt; ++it) {
         double xBeatPoint =
                 m_waveformRenderer->transformSamplePositionInRendererWorld(
-                        beatPosition, positionType);
+                        *it, positionType);
 
         xBeatPoint = qRound(xBeatPoint * devicePixelRatio) / devicePixelRatio;
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <QColor>
+#include <vector>
 
 #include "shaders/unicolorshader.h"
+#include "track/beats.h"
 #include "util/class.h"
 #include "waveform/renderers/allshader/vertexdata.h"
 #include "waveform/renderers/allshader/waveformrenderer.h"
@@ -25,10 +27,27 @@ class allshader::WaveformRenderBeat final : public allshader::WaveformRenderer {
     void initializeGL() override;
 
   private:
+    /// Makes sure that m_beatPositions contains all beats between
+    /// startPosition and endPosition.
+    void updateBeatPositions(const mixxx::BeatsPointer& pBeats,
+            mixxx::audio::FramePos startPosition,
+            mixxx::audio::FramePos endPosition,
+            mixxx::audio::FramePos trackEndPosition);
+
     mixxx::UnicolorShader m_shader;
     QColor m_color;
     VertexData m_vertices;
 
+    // Sorted engine sample positions of the beats between m_beatPositionsStart
+    // and m_beatPositionsEnd, so the visible beats can be found by a binary
+    // search instead of iterating the beats on every frame. The beats are
+    // immutable, so the cache only needs to be updated when the pointer
+    // changes.
+    mixxx::BeatsPointer m_pBeatPositionsBeats;
+    mixxx::audio::FramePos m_beatPositionsStart;
+    mixxx::audio::FramePos m_beatPositionsEnd;
+    std::vector<double> m_beatPositions;
+
     bool m_isSlipRenderer;
 
     DISALLOW_COPY_AND_ASSIGN(WaveformRenderBeat);
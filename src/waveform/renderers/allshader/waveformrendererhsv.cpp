@@ -34,19 +34,24 @@ void WaveformRendererHSV::paintGL() {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
-    if (dataSize <= 1) {
+    if (waveform->getDataSize() <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
+    if (waveform->data() == nullptr) {
         return;
     }
 
     const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
     const int length = static_cast<int>(m_waveformRenderer->getLength() * devicePixelRatio);
 
+    const int mipLevel = waveform->findMipLevelForDisplay(
+            m_waveformRenderer->getFirstDisplayedPosition(),
+            m_waveformRenderer->getLastDisplayedPosition(),
+            length);
+    const int dataSize = waveform->getMipLevelDataSize(mipLevel);
+    const WaveformData* data = waveform->mipLevelData(mipLevel);
+
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
     const int visualFramesSize = dataSize / 2;
     const double firstVisualFrame =
@@ -33,19 +33,24 @@ void WaveformRendererSimple::paintGL() {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
-    if (dataSize <= 1) {
+    if (waveform->getDataSize() <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
-    if (data == nullptr) {
+    if (waveform->data() == nullptr) {
         return;
     }
 
     const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
     const int length = static_cast<int>(m_waveformRenderer->getLength() * devicePixelRatio);
 
+    const int mipLevel = waveform->findMipLevelForDisplay(
+            m_waveformRenderer->getFirstDisplayedPosition(),
+            m_waveformRenderer->getLastDisplayedPosition(),
+            length);
+    const int dataSize = waveform->getMipLevelDataSize(mipLevel);
+    const WaveformData* data = waveform->mipLevelData(mipLevel);
+
     // Note that waveform refers to the visual waveform, not to audio samples.
     //
     // WaveformData* data contains the L and R waveform values interleaved. In the calculations
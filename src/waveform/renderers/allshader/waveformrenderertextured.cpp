@@ -7,6 +7,8 @@
 
 #include "moc_waveformrenderertextured.cpp"
 #include "track/track.h"
+#include "util/colorcomponents.h"
+#include "util/math.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
 
@@ -17,6 +19,8 @@ QString WaveformRendererTextured::fragShaderForType(::WaveformWidgetType::Type t
     switch (t) {
     case ::WaveformWidgetType::Filtered:
         return QLatin1String(":/shaders/filteredsignal.frag");
+    case ::WaveformWidgetType::HSV:
+        return QLatin1String(":/shaders/hsvsignal.frag");
     case ::WaveformWidgetType::RGB:
         return QLatin1String(":/shaders/rgbsignal.frag");
     case ::WaveformWidgetType::Stacked:
@@ -158,6 +162,44 @@ bool WaveformRendererTextured::loadTexture() {
     return true;
 }
 
+void WaveformRendererTextured::updateTexture(int firstIndex, int lastIndex) {
+    ConstWaveformPointer pWaveform = m_waveformRenderer->getWaveform();
+    if (!pWaveform || m_textureId == 0) {
+        loadTexture();
+        return;
+    }
+    DEBUG_ASSERT(firstIndex <= lastIndex);
+
+    // Only the rows of the texture that contain the analyzed data since
+    // the last upload are replaced, which keeps the cost of following the
+    // progress of an analysis independent of the length of the track.
+    const int textureStride = pWaveform->getTextureStride();
+    const int firstRow = firstIndex / textureStride;
+    const int lastRow = math_min(
+            (lastIndex + textureStride - 1) / textureStride,
+            pWaveform->getTextureSize() / textureStride);
+    if (firstRow >= lastRow) {
+        return;
+    }
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, m_textureId);
+    glTexSubImage2D(GL_TEXTURE_2D,
+            0,
+            0,
+            firstRow,
+            textureStride,
+            lastRow - firstRow,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            pWaveform->data() + firstRow * textureStride);
+    int error = glGetError();
+    if (error) {
+        qDebug() << "WaveformRendererTextured::updateTexture - glTexSubImage2D error" << error;
+    }
+    glDisable(GL_TEXTURE_2D);
+}
+
 void WaveformRendererTextured::createGeometry() {
     if (m_unitQuadListId != -1) {
         return;
@@ -310,7 +352,11 @@ void WaveformRendererTextured::paintGL() {
     // do not remove currenCompletion temp variable !
     const int currentCompletion = pWaveform->getCompletion();
     if (m_textureRenderedWaveformCompletion < currentCompletion) {
-        loadTexture();
+        if (m_textureRenderedWaveformCompletion == 0) {
+            loadTexture();
+        } else {
+            updateTexture(m_textureRenderedWaveformCompletion, currentCompletion);
+        }
         m_textureRenderedWaveformCompletion = currentCompletion;
     }
 
@@ -378,6 +424,14 @@ void WaveformRendererTextured::paintGL() {
                         static_cast<GLfloat>(m_axesColor_b),
                         static_cast<GLfloat>(m_axesColor_a)));
 
+        if (m_type == ::WaveformWidgetType::HSV) {
+            // Only the hue of the low color is used, the saturation and the
+            // value are derived from the bands
+            float h, s, v;
+            getHsvF(m_pColors->getLowColor(), &h, &s, &v);
+            m_frameShaderProgram->setUniformValue("baseColorHue", h);
+        }
+
         if (m_type == ::WaveformWidgetType::Stacked) {
             m_frameShaderProgram->setUniformValue("lowFilteredColor",
                     QVector4D(static_cast<GLfloat>(m_rgbLowFilteredColor_r),
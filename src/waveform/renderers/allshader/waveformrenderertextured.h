@@ -46,6 +46,8 @@ class allshader::WaveformRendererTextured : public QObject,
     static QString fragShaderForType(WaveformWidgetType::Type t);
     bool loadShaders();
     bool loadTexture();
+    // Uploads the rows of the texture that contain the range of the data
+    void updateTexture(int firstIndex, int lastIndex);
 
     void createGeometry();
     void createFrameBuffers();
@@ -1,7 +1,9 @@
 #include "waveform/renderers/allshader/waveformrendermark.h"
 
 #include <QOpenGLTexture>
+#include <QPainter>
 #include <QPainterPath>
+#include <vector>
 
 #include "track/track.h"
 #include "util/colorcomponents.h"
@@ -18,19 +20,21 @@
 //
 // This renderer does use QPainter (indirectly, in WaveformMark::generateImage), but
 // only to draw on a QImage. This is only done once when needed and the images are
-// then used as textures to be drawn with a GLSL shader.
+// then packed into a single texture atlas to be drawn with a GLSL shader.
 
-class TextureGraphics : public WaveformMark::Graphics {
+class AtlasGraphics : public WaveformMark::Graphics {
   public:
-    TextureGraphics(const QImage& image) {
-        m_texture.setData(image);
+    AtlasGraphics(QImage image)
+            : m_image(std::move(image)) {
     }
-    QOpenGLTexture* texture() {
-        return &m_texture;
+    const QImage& image() const {
+        return m_image;
     }
+    // The normalized location of the image in the atlas texture
+    QRectF m_textureRect;
 
   private:
-    OpenGLTexture2D m_texture;
+    QImage m_image;
 };
 
 // Both allshader::WaveformRenderMark and the non-GL ::WaveformRenderMark derive
@@ -46,6 +50,13 @@ class TextureGraphics : public WaveformMark::Graphics {
 // that updateMarkImages should not be called immediately.
 
 namespace {
+// Maximum width of the mark atlas in pixels. It is exceeded only if a single
+// image is wider, which does not happen for usual mark images.
+constexpr int kMaxAtlasWidth = 2048;
+// Transparent space between the images in the atlas, to avoid that the linear
+// texture filtering blends in the neighboring images
+constexpr int kAtlasPadding = 1;
+
 QString timeSecToString(double timeSec) {
     int hundredths = std::lround(timeSec * 100.0);
     int seconds = hundredths / 100;
@@ -62,6 +73,7 @@ allshader::WaveformRenderMark::WaveformRenderMark(
         WaveformWidgetRenderer* waveformWidget,
         ::WaveformRendererAbstract::PositionSource type)
         : ::WaveformRenderMarkBase(waveformWidget, false),
+          m_markAtlasDirty(true),
           m_beatsUntilMark(0),
           m_timeUntilMark(0.0),
           m_pTimeRemainingControl(nullptr),
@@ -80,9 +92,8 @@ void allshader::WaveformRenderMark::initializeGL() {
     m_rgbaShader.init();
     m_textureShader.init();
 
-    // Will create textures so requires OpenGL context
     updateMarkImages();
-    updatePlayPosMarkTexture();
+    updatePlayPosMarkImage();
     const auto untilMarkTextPointSize =
             WaveformWidgetFactory::instance()->getUntilMarkTextPointSize();
     m_digitsRenderer.updateTexture(untilMarkTextPointSize,
@@ -90,21 +101,32 @@ void allshader::WaveformRenderMark::initializeGL() {
             m_waveformRenderer->getDevicePixelRatio());
 }
 
-void allshader::WaveformRenderMark::drawTexture(
-        const QMatrix4x4& matrix, float x, float y, QOpenGLTexture* texture) {
+void allshader::WaveformRenderMark::addAtlasImage(VertexData* pPosVertices,
+        VertexData* pTexVertices,
+        float x,
+        float y,
+        const QSize& imageSize,
+        const QRectF& textureRect) {
     const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
-    const float texx1 = 0.f;
-    const float texy1 = 0.f;
-    const float texx2 = 1.f;
-    const float texy2 = 1.f;
 
     const float posx1 = x;
-    const float posx2 = x + static_cast<float>(texture->width() / devicePixelRatio);
+    const float posx2 = x + static_cast<float>(imageSize.width() / devicePixelRatio);
     const float posy1 = y;
-    const float posy2 = y + static_cast<float>(texture->height() / devicePixelRatio);
+    const float posy2 = y + static_cast<float>(imageSize.height() / devicePixelRatio);
 
-    const float posarray[] = {posx1, posy1, posx2, posy1, posx1, posy2, posx2, posy2};
-    const float texarray[] = {texx1, texy1, texx2, texy1, texx1, texy2, texx2, texy2};
+    pPosVertices->addRectangle(posx1, posy1, posx2, posy2);
+    pTexVertices->addRectangle(static_cast<float>(textureRect.left()),
+            static_cast<float>(textureRect.top()),
+            static_cast<float>(textureRect.right()),
+            static_cast<float>(textureRect.bottom()));
+}
+
+void allshader::WaveformRenderMark::drawAtlasImages(const QMatrix4x4& matrix,
+        const VertexData& posVertices,
+        const VertexData& texVertices) {
+    if (posVertices.size() == 0 || !m_markAtlasTexture.isStorageAllocated()) {
+        return;
+    }
 
     m_textureShader.bind();
 
@@ -117,26 +139,28 @@ void allshader::WaveformRenderMark::drawTexture(
 
     m_textureShader.enableAttributeArray(positionLocation);
     m_textureShader.setAttributeArray(
-            positionLocation, GL_FLOAT, posarray, 2);
+            positionLocation, GL_FLOAT, posVertices.constData(), 2);
     m_textureShader.enableAttributeArray(texcoordLocation);
     m_textureShader.setAttributeArray(
-            texcoordLocation, GL_FLOAT, texarray, 2);
+            texcoordLocation, GL_FLOAT, texVertices.constData(), 2);
 
     m_textureShader.setUniformValue(textureLocation, 0);
 
-    texture->bind();
+    m_markAtlasTexture.bind();
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDrawArrays(GL_TRIANGLES, 0, posVertices.size());
 
-    texture->release();
+    m_markAtlasTexture.release();
 
     m_textureShader.disableAttributeArray(positionLocation);
     m_textureShader.disableAttributeArray(texcoordLocation);
     m_textureShader.release();
 }
 
-void allshader::WaveformRenderMark::drawMark(
-        const QMatrix4x4& matrix, const QRectF& rect, QColor color) {
+void allshader::WaveformRenderMark::addMarkRange(VertexData* pVertices,
+        RGBAData* pColors,
+        const QRectF& rect,
+        QColor color) {
     // draw a gradient towards transparency at the upper and lower 25% of the waveform view
 
     const float qh = static_cast<float>(std::floor(rect.height() * 0.25));
@@ -151,15 +175,19 @@ void allshader::WaveformRenderMark::drawMark(
 
     getRgbF(color, &r, &g, &b, &a);
 
-    VertexData vertices;
-    vertices.reserve(12); // 4 triangles
-    vertices.addRectangle(posx1, posy1, posx2, posy2);
-    vertices.addRectangle(posx1, posy4, posx2, posy3);
+    pVertices->addRectangle(posx1, posy1, posx2, posy2);
+    pVertices->addRectangle(posx1, posy4, posx2, posy3);
+
+    pColors->addForRectangleGradient(r, g, b, a, r, g, b, 0.f);
+    pColors->addForRectangleGradient(r, g, b, a, r, g, b, 0.f);
+}
 
-    RGBAData rgbaData;
-    rgbaData.reserve(12); // 4 triangles
-    rgbaData.addForRectangleGradient(r, g, b, a, r, g, b, 0.f);
-    rgbaData.addForRectangleGradient(r, g, b, a, r, g, b, 0.f);
+void allshader::WaveformRenderMark::drawMarkRanges(const QMatrix4x4& matrix,
+        const VertexData& vertices,
+        const RGBAData& colors) {
+    if (vertices.size() == 0) {
+        return;
+    }
 
     m_rgbaShader.bind();
 
@@ -174,7 +202,7 @@ void allshader::WaveformRenderMark::drawMark(
             positionLocation, GL_FLOAT, vertices.constData(), 2);
     m_rgbaShader.enableAttributeArray(colorLocation);
     m_rgbaShader.setAttributeArray(
-            colorLocation, GL_FLOAT, rgbaData.constData(), 4);
+            colorLocation, GL_FLOAT, colors.constData(), 4);
 
     glDrawArrays(GL_TRIANGLES, 0, vertices.size());
 
@@ -183,6 +211,66 @@ void allshader::WaveformRenderMark::drawMark(
     m_rgbaShader.release();
 }
 
+void allshader::WaveformRenderMark::updateMarkAtlas() {
+    struct AtlasEntry {
+        const QImage* pImage;
+        QRectF* pTextureRect;
+        QPoint position;
+    };
+    std::vector<AtlasEntry> entries;
+    if (!m_playPosMarkImage.isNull()) {
+        entries.push_back(AtlasEntry{&m_playPosMarkImage, &m_playPosMarkTextureRect, QPoint()});
+    }
+    for (const auto& pMark : std::as_const(m_marks)) {
+        auto* pGraphics = static_cast<AtlasGraphics*>(pMark->m_pGraphics.get());
+        if (pGraphics && !pGraphics->image().isNull()) {
+            entries.push_back(AtlasEntry{&pGraphics->image(), &pGraphics->m_textureRect, QPoint()});
+        }
+    }
+
+    // Place the images in rows from left to right
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    int atlasWidth = 0;
+    for (auto& entry : entries) {
+        const int width = entry.pImage->width() + kAtlasPadding;
+        if (x > 0 && x + width > kMaxAtlasWidth) {
+            y += rowHeight;
+            x = 0;
+            rowHeight = 0;
+        }
+        entry.position = QPoint(x, y);
+        x += width;
+        rowHeight = std::max(rowHeight, entry.pImage->height() + kAtlasPadding);
+        atlasWidth = std::max(atlasWidth, x);
+    }
+    const int atlasHeight = y + rowHeight;
+    m_markAtlasDirty = false;
+    if (atlasWidth == 0 || atlasHeight == 0) {
+        m_markAtlasTexture.destroy();
+        return;
+    }
+
+    QImage atlas(atlasWidth, atlasHeight, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(QColor(0, 0, 0, 0).rgba());
+    {
+        QPainter painter(&atlas);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for (const auto& entry : entries) {
+            const QRect imageRect(entry.position, entry.pImage->size());
+            // The images are copied pixel by pixel, ignoring their device pixel ratio
+            painter.drawImage(imageRect, *entry.pImage, entry.pImage->rect());
+            *entry.pTextureRect = QRectF(
+                    static_cast<double>(imageRect.x()) / atlasWidth,
+                    static_cast<double>(imageRect.y()) / atlasHeight,
+                    static_cast<double>(imageRect.width()) / atlasWidth,
+                    static_cast<double>(imageRect.height()) / atlasHeight);
+        }
+    }
+    m_markAtlasTexture.setData(atlas);
+}
+
 void allshader::WaveformRenderMark::paintGL() {
     if (m_isSlipRenderer && !m_waveformRenderer->isSlipActive()) {
         return;
@@ -202,11 +290,21 @@ void allshader::WaveformRenderMark::paintGL() {
         pMark->setBreadth(slipActive ? m_waveformRenderer->getBreadth() / 2
                                      : m_waveformRenderer->getBreadth());
     }
-    // Will create textures so requires OpenGL context
     updateMarkImages();
+    if (m_markAtlasDirty) {
+        // Will create a texture so requires OpenGL context
+        updateMarkAtlas();
+    }
 
     QMatrix4x4 matrix = matrixForWidgetGeometry(m_waveformRenderer, false);
 
+    // All marks are collected first and drawn with one draw call for the
+    // ranges and one for the images
+    VertexData rangeVertices;
+    RGBAData rangeColors;
+    VertexData imagePosVertices;
+    VertexData imageTexVertices;
+
     const double playPosition = m_waveformRenderer->getTruePosSample(positionType);
     double nextMarkPosition = std::numeric_limits<double>::max();
 
@@ -221,9 +319,8 @@ void allshader::WaveformRenderMark::paintGL() {
             continue;
         }
 
-        QOpenGLTexture* pTexture =
-                static_cast<TextureGraphics*>(pMark->m_pGraphics.get())
-                        ->texture();
+        const auto* pGraphics = static_cast<const AtlasGraphics*>(pMark->m_pGraphics.get());
+        const QSize imageSize = pGraphics->image().size();
 
         const float currentMarkPoint =
                 std::round(
@@ -243,7 +340,7 @@ void allshader::WaveformRenderMark::paintGL() {
         // Pixmaps are expected to have the mark stroke at the center,
         // and preferably have an odd width in order to have the stroke
         // exactly at the sample position.
-        const float markHalfWidth = pTexture->width() / devicePixelRatio / 2.f;
+        const float markHalfWidth = imageSize.width() / devicePixelRatio / 2.f;
         const float drawOffset = currentMarkPoint - markHalfWidth;
 
         bool visible = false;
@@ -251,12 +348,16 @@ void allshader::WaveformRenderMark::paintGL() {
         if (drawOffset > -markHalfWidth &&
                 drawOffset < m_waveformRenderer->getLength() +
                                 markHalfWidth) {
-            drawTexture(matrix,
-                    drawOffset,
-                    !m_isSlipRenderer && slipActive
-                            ? m_waveformRenderer->getBreadth() / 2
-                            : 0,
-                    pTexture);
+            if (!imageSize.isEmpty()) {
+                addAtlasImage(&imagePosVertices,
+                        &imageTexVertices,
+                        drawOffset,
+                        !m_isSlipRenderer && slipActive
+                                ? m_waveformRenderer->getBreadth() / 2
+                                : 0,
+                        imageSize,
+                        pGraphics->m_textureRect);
+            }
             visible = true;
         }
 
@@ -273,7 +374,8 @@ void allshader::WaveformRenderMark::paintGL() {
                 QColor color = pMark->fillColor();
                 color.setAlphaF(0.4f);
 
-                drawMark(matrix,
+                addMarkRange(&rangeVertices,
+                        &rangeColors,
                         QRectF(QPointF(currentMarkPoint, 0),
                                 QPointF(currentMarkEndPoint,
                                         m_waveformRenderer
@@ -298,13 +400,21 @@ void allshader::WaveformRenderMark::paintGL() {
                     devicePixelRatio) /
             devicePixelRatio;
 
-    if (m_playPosMarkTexture.isStorageAllocated()) {
-        const float markHalfWidth = m_playPosMarkTexture.width() / devicePixelRatio / 2.f;
+    if (!m_playPosMarkImage.isNull()) {
+        const float markHalfWidth = m_playPosMarkImage.width() / devicePixelRatio / 2.f;
         const float drawOffset = currentMarkPoint - markHalfWidth;
 
-        drawTexture(matrix, drawOffset, 0.f, &m_playPosMarkTexture);
+        addAtlasImage(&imagePosVertices,
+                &imageTexVertices,
+                drawOffset,
+                0.f,
+                m_playPosMarkImage.size(),
+                m_playPosMarkTextureRect);
     }
 
+    drawMarkRanges(matrix, rangeVertices, rangeColors);
+    drawAtlasImages(matrix, imagePosVertices, imageTexVertices);
+
     if (WaveformWidgetFactory::instance()->getUntilMarkShowBeats() ||
             WaveformWidgetFactory::instance()->getUntilMarkShowTime()) {
         updateUntilMark(playPosition, nextMarkPosition);
@@ -366,10 +476,10 @@ void allshader::WaveformRenderMark::drawUntilMark(const QMatrix4x4& matrix, floa
     }
 }
 
-// Generate the texture used to draw the play position marker.
+// Generate the image used to draw the play position marker.
 // Note that in the legacy waveform widgets this is drawn directly
 // in the WaveformWidgetRenderer itself. Doing it here is cleaner.
-void allshader::WaveformRenderMark::updatePlayPosMarkTexture() {
+void allshader::WaveformRenderMark::updatePlayPosMarkImage() {
     float imgwidth;
     float imgheight;
 
@@ -430,7 +540,8 @@ void allshader::WaveformRenderMark::updatePlayPosMarkTexture() {
     }
     painter.end();
 
-    m_playPosMarkTexture.setData(image);
+    m_playPosMarkImage = image;
+    m_markAtlasDirty = true;
 }
 
 void allshader::WaveformRenderMark::drawTriangle(QPainter* painter,
@@ -448,14 +559,14 @@ void allshader::WaveformRenderMark::drawTriangle(QPainter* painter,
 }
 
 void allshader::WaveformRenderMark::resizeGL(int, int) {
-    // Will create textures so requires OpenGL context
     updateMarkImages();
-    updatePlayPosMarkTexture();
+    updatePlayPosMarkImage();
 }
 
 void allshader::WaveformRenderMark::updateMarkImage(WaveformMarkPointer pMark) {
-    pMark->m_pGraphics = std::make_unique<TextureGraphics>(
+    pMark->m_pGraphics = std::make_unique<AtlasGraphics>(
             pMark->generateImage(m_waveformRenderer->getDevicePixelRatio()));
+    m_markAtlasDirty = true;
 }
 
 void allshader::WaveformRenderMark::updateUntilMark(
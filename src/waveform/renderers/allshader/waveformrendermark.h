@@ -1,17 +1,19 @@
 #pragma once
 
 #include <QColor>
+#include <QImage>
 
 #include "shaders/rgbashader.h"
 #include "shaders/textureshader.h"
 #include "util/opengltexture2d.h"
+#include "waveform/renderers/allshader/rgbadata.h"
+#include "waveform/renderers/allshader/vertexdata.h"
 #include "waveform/renderers/allshader/digitsrenderer.h"
 #include "waveform/renderers/allshader/waveformrendererabstract.h"
 #include "waveform/renderers/waveformrendermarkbase.h"
 
 class QDomNode;
 class SkinContext;
-class QOpenGLTexture;
 
 namespace allshader {
 class WaveformRenderMark;
@@ -42,7 +44,10 @@ class allshader::WaveformRenderMark : public ::WaveformRenderMarkBase,
   private:
     void updateMarkImage(WaveformMarkPointer pMark) override;
 
-    void updatePlayPosMarkTexture();
+    void updatePlayPosMarkImage();
+    // Packs the images of all marks and the play position marker into
+    // m_markAtlasTexture, so they can be drawn with a single draw call
+    void updateMarkAtlas();
 
     void drawTriangle(QPainter* painter,
             const QBrush& fillColor,
@@ -50,15 +55,32 @@ class allshader::WaveformRenderMark : public ::WaveformRenderMarkBase,
             QPointF p2,
             QPointF p3);
 
-    void drawMark(const QMatrix4x4& matrix, const QRectF& rect, QColor color);
-    void drawTexture(const QMatrix4x4& matrix, float x, float y, QOpenGLTexture* texture);
+    void addMarkRange(VertexData* pVertices,
+            RGBAData* pColors,
+            const QRectF& rect,
+            QColor color);
+    void drawMarkRanges(const QMatrix4x4& matrix,
+            const VertexData& vertices,
+            const RGBAData& colors);
+    void addAtlasImage(VertexData* pPosVertices,
+            VertexData* pTexVertices,
+            float x,
+            float y,
+            const QSize& imageSize,
+            const QRectF& textureRect);
+    void drawAtlasImages(const QMatrix4x4& matrix,
+            const VertexData& posVertices,
+            const VertexData& texVertices);
     void updateUntilMark(double playPosition, double markerPosition);
     void drawUntilMark(const QMatrix4x4& matrix, float x);
     float getMaxHeightForText() const;
 
     mixxx::RGBAShader m_rgbaShader;
     mixxx::TextureShader m_textureShader;
-    OpenGLTexture2D m_playPosMarkTexture;
+    OpenGLTexture2D m_markAtlasTexture;
+    bool m_markAtlasDirty;
+    QImage m_playPosMarkImage;
+    QRectF m_playPosMarkTextureRect;
     DigitsRenderer m_digitsRenderer;
     int m_beatsUntilMark;
     double m_timeUntilMark;
@@ -117,15 +117,30 @@ void WaveformWidgetRenderer::onPreRender(VSyncThread* vsyncThread) {
         return;
     }
 
+    // Fetch the position, the tempo and the track length from the same
+    // engine callback, so they are consistent with each other. While no
+    // audio has been processed yet the controls are used instead.
+    VisualPlayPositionSnapshot snapshot;
+    double truePos[2]{0};
+    double rateRatio;
+    if (m_visualPlayPosition->getSnapshotAtNextVSync(vsyncThread, &snapshot) &&
+            snapshot.trackSamples > 0) {
+        m_trackSamples = snapshot.trackSamples;
+        rateRatio = snapshot.rateRatio;
+        truePos[::WaveformRendererAbstract::Play] = snapshot.playPosition;
+        truePos[::WaveformRendererAbstract::Slip] = snapshot.slipPosition;
+    } else {
+        m_trackSamples = m_pTrackSamplesControlObject->get();
+        rateRatio = m_pRateRatioCO->get();
+        m_visualPlayPosition->getPlaySlipAtNextVSync(vsyncThread,
+                truePos + ::WaveformRendererAbstract::Play,
+                truePos + ::WaveformRendererAbstract::Slip);
+    }
     // For a valid track to render we need
-    m_trackSamples = m_pTrackSamplesControlObject->get();
     if (m_trackSamples <= 0) {
         return;
     }
 
-    //Fetch parameters before rendering in order the display all sub-renderers with the same values
-    double rateRatio = m_pRateRatioCO->get();
-
     m_gain = m_pGainControlObject->get();
 
     // Compute visual sample to pixel ratio
@@ -143,10 +158,6 @@ void WaveformWidgetRenderer::onPreRender(VSyncThread* vsyncThread) {
         }
     }
 
-    double truePos[2]{0};
-    m_visualPlayPosition->getPlaySlipAtNextVSync(vsyncThread,
-            truePos + ::WaveformRendererAbstract::Play,
-            truePos + ::WaveformRendererAbstract::Slip);
     // truePlayPos = -1 happens, when a new track is in buffer but m_visualPlayPosition was not updated
 
     if (m_audioSamplePerPixel > 0) {
@@ -33,7 +33,9 @@ void VisualPlayPosition::set(
         double loopStartPosition,
         double loopEndPosition,
         double tempoTrackSeconds,
-        double audioBufferMicroS) {
+        double audioBufferMicroS,
+        double rateRatio,
+        double trackSamples) {
     VisualPlayPositionData data;
     data.m_referenceTime = m_timeInfoTime;
     data.m_callbackEntrytoDac = static_cast<int>(m_dCallbackEntryToDacSecs * 1000000); // s to µs
@@ -50,6 +52,8 @@ void VisualPlayPosition::set(
     data.m_loopEndPos = loopEndPosition;
     data.m_tempoTrackSeconds = tempoTrackSeconds;
     data.m_audioBufferMicroS = audioBufferMicroS;
+    data.m_rateRatio = rateRatio;
+    data.m_trackSamples = trackSamples;
 
     // Atomic write
     m_data.setValue(data);
@@ -189,6 +193,25 @@ void VisualPlayPosition::getPlaySlipAtNextVSync(VSyncThread* pVSyncThread,
     }
 }
 
+bool VisualPlayPosition::getSnapshotAtNextVSync(VSyncThread* pVSyncThread,
+        VisualPlayPositionSnapshot* pSnapshot) {
+    if (!m_valid) {
+        return false;
+    }
+    const VisualPlayPositionData data = m_data.getValue();
+    const double offset = calcOffsetAtNextVSync(pVSyncThread, data);
+
+    pSnapshot->playPosition = determinePlayPosInLoopBoundries(data, offset);
+    if (data.m_slipModeState == SlipModeState::Running) {
+        pSnapshot->slipPosition = data.m_slipPos + offset * data.m_slipRate;
+    } else {
+        pSnapshot->slipPosition = pSnapshot->playPosition;
+    }
+    pSnapshot->rateRatio = data.m_rateRatio;
+    pSnapshot->trackSamples = data.m_trackSamples;
+    return true;
+}
+
 double VisualPlayPosition::getEnginePlayPos() {
     if (m_valid) {
         VisualPlayPositionData data = m_data.getValue();
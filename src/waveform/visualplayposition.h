@@ -25,7 +25,10 @@ class VSyncThread;
 //               ^Render Waveform sample X            |  ^VSync (New waveform is displayed
 //                by use usFromTimerToNextSync        ^swap Buffer
 
-class VisualPlayPositionData {
+// The data is published once per audio callback by the engine thread.
+// It is aligned to a cache line, so the engine does not invalidate the cache
+// line of a slot that is concurrently read by a render thread.
+class alignas(64) VisualPlayPositionData {
   public:
     PerformanceTimer m_referenceTime;
     int m_callbackEntrytoDac; // Time from Audio Callback Entry to first sample of Buffer is transferred to DAC
@@ -42,6 +45,17 @@ class VisualPlayPositionData {
     double m_loopEndPos;
     double m_tempoTrackSeconds; // total track time, taking the current tempo into account
     double m_audioBufferMicroS;
+    double m_rateRatio;    // tempo ratio, equals the value of the rate_ratio control
+    double m_trackSamples; // track length in samples, equals the track_samples control
+};
+
+// All values a waveform renderer needs for a frame, interpolated from a single
+// consistent engine snapshot
+struct VisualPlayPositionSnapshot {
+    double playPosition;
+    double slipPosition;
+    double rateRatio;
+    double trackSamples;
 };
 
 
@@ -65,12 +79,18 @@ class VisualPlayPosition : public QObject {
             double loopStartPos,
             double loopEndPos,
             double tempoTrackSeconds,
-            double audioBufferMicroS);
+            double audioBufferMicroS,
+            double rateRatio,
+            double trackSamples);
 
     double getAtNextVSync(VSyncThread* pVSyncThread);
     void getPlaySlipAtNextVSync(VSyncThread* pVSyncThread,
             double* playPosition,
             double* slipPosition);
+    // Returns false and leaves pSnapshot untouched while no valid data
+    // has been published
+    bool getSnapshotAtNextVSync(VSyncThread* pVSyncThread,
+            VisualPlayPositionSnapshot* pSnapshot);
     double determinePlayPosInLoopBoundries(
             const VisualPlayPositionData& data, const double& offset);
     double getEnginePlayPos();
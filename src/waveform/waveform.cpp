@@ -1,13 +1,35 @@
 #include "waveform/waveform.h"
 
+#include <QDataStream>
 #include <QtDebug>
+#include <algorithm>
+#include <cstring>
 
 #include "analyzer/constants.h"
 #include "engine/engine.h"
 #include "proto/waveform.pb.h"
+#include "util/assert.h"
 
 using namespace mixxx::track;
 
+namespace {
+
+// The compact format starts with a byte that is invalid as the first tag
+// of a protobuf message to distinguish it from the previous format
+constexpr char kCompactFormatMagic[] = {'\0', 'M', 'W', 'F'};
+constexpr quint32 kCompactFormatVersion = 1;
+// magic, version, visual sample rate, audio visual ratio, data size
+constexpr int kCompactFormatHeaderSize = sizeof(kCompactFormatMagic) +
+        sizeof(quint32) + 2 * sizeof(double) + sizeof(quint32);
+
+// Enough for 2^31 visual frames
+constexpr int kMaxMipLevels = 31;
+
+static_assert(sizeof(WaveformData) == 4,
+        "The compact format stores the in-memory layout of WaveformData");
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -25,7 +47,8 @@ Waveform::Waveform(const QByteArray& data)
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
-          m_completion(-1) {
+          m_completion(-1),
+          m_mipLevelCount(0) {
     readByteArray(data);
 }
 
@@ -40,7 +63,8 @@ Waveform::Waveform(
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
-          m_completion(-1) {
+          m_completion(-1),
+          m_mipLevelCount(0) {
     int numberOfVisualSamples = 0;
     if (audioSampleRate > 0) {
         if (maxVisualSamples == -1) {
@@ -75,68 +99,44 @@ Waveform::~Waveform() {
 }
 
 QByteArray Waveform::toByteArray() const {
-    io::Waveform waveform;
-    waveform.set_visual_sample_rate(m_visualSampleRate);
-    waveform.set_audio_visual_ratio(m_audioVisualRatio);
-
-    io::Waveform::Signal* all = waveform.mutable_signal_all();
-    io::Waveform::FilteredSignal* filtered = waveform.mutable_signal_filtered();
-    // TODO(rryan) get the actual cutoff values from analyzerwaveform.cpp so
-    // that if they change we don't have to remember to update these.
-
-    // Frequency cutoffs for butterworth filters:
-    // filtered->set_low_cutoff_frequency(200);
-    // filtered->set_mid_low_cutoff_frequency(200);
-    // filtered->set_mid_high_cutoff_frequency(2000);
-    // filtered->set_high_cutoff_frequency(2000);
-
-    // Frequency cutoff for bessel_lowpass4
-    filtered->set_low_cutoff_frequency(600);
-    // Frequency cutoff for bessel_bandpass
-    filtered->set_mid_low_cutoff_frequency(600);
-    filtered->set_mid_high_cutoff_frequency(4000);
-    // Frequency cutoff for bessel_highpass4
-    filtered->set_high_cutoff_frequency(4000);
-
-    io::Waveform::Signal* low = filtered->mutable_low();
-    io::Waveform::Signal* mid = filtered->mutable_mid();
-    io::Waveform::Signal* high = filtered->mutable_high();
-
-    // TODO(vrince) set max/min for each signal
-    all->set_units(io::Waveform::RMS);
-    all->set_channels(mixxx::kEngineChannelOutputCount);
-    low->set_units(io::Waveform::RMS);
-    low->set_channels(mixxx::kEngineChannelOutputCount);
-    mid->set_units(io::Waveform::RMS);
-    mid->set_channels(mixxx::kEngineChannelOutputCount);
-    high->set_units(io::Waveform::RMS);
-    high->set_channels(mixxx::kEngineChannelOutputCount);
-
-    int dataSize = getDataSize();
-    for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
-        all->add_value(datum.filtered.all);
-        low->add_value(datum.filtered.low);
-        mid->add_value(datum.filtered.mid);
-        high->add_value(datum.filtered.high);
+    const int dataSize = getDataSize();
+    QByteArray output;
+    output.reserve(kCompactFormatHeaderSize +
+            dataSize * static_cast<int>(sizeof(WaveformData)));
+    {
+        QDataStream header(&output, QIODevice::WriteOnly);
+        header.setByteOrder(QDataStream::LittleEndian);
+        header.setFloatingPointPrecision(QDataStream::DoublePrecision);
+        header.writeRawData(kCompactFormatMagic, sizeof(kCompactFormatMagic));
+        header << kCompactFormatVersion
+               << m_visualSampleRate
+               << m_audioVisualRatio
+               << static_cast<quint32>(dataSize);
     }
+    DEBUG_ASSERT(output.size() == kCompactFormatHeaderSize);
+    // The filtered signals are stored interleaved exactly as they are
+    // kept in memory, so reading them is a single copy
+    output.append(reinterpret_cast<const char*>(m_data.data()),
+            dataSize * static_cast<int>(sizeof(WaveformData)));
 
-    qDebug() << "Writing waveform from byte array:"
+    qDebug() << "Writing waveform to byte array:"
              << "dataSize" << dataSize
-             << "allSignalSize" << all->value_size()
-             << "visualSampleRate" << waveform.visual_sample_rate()
-             << "audioVisualRatio" << waveform.audio_visual_ratio();
-
-    std::string output;
-    waveform.SerializeToString(&output);
-    return QByteArray(output.data(), static_cast<int>(output.length()));
+             << "visualSampleRate" << m_visualSampleRate
+             << "audioVisualRatio" << m_audioVisualRatio;
+    return output;
 }
 
 void Waveform::readByteArray(const QByteArray& data) {
     if (data.isNull()) {
         return;
     }
+    if (data.startsWith(QByteArray::fromRawData(
+                kCompactFormatMagic, sizeof(kCompactFormatMagic)))) {
+        readCompactByteArray(data);
+        return;
+    }
 
+    // Waveforms that have been stored by previous versions
     io::Waveform waveform;
 
     if (!waveform.ParseFromArray(data.constData(), data.size())) {
@@ -201,6 +201,119 @@ void Waveform::readByteArray(const QByteArray& data) {
     }
     m_completion = dataSize;
     m_saveState = SaveState::Saved;
+    buildMipLevels();
+}
+
+void Waveform::readCompactByteArray(const QByteArray& data) {
+    if (data.size() < kCompactFormatHeaderSize) {
+        qDebug() << "ERROR: Waveform data is truncated. Skipping.";
+        return;
+    }
+    quint32 version;
+    double visualSampleRate;
+    double audioVisualRatio;
+    quint32 dataSize;
+    {
+        QDataStream header(data);
+        header.setByteOrder(QDataStream::LittleEndian);
+        header.setFloatingPointPrecision(QDataStream::DoublePrecision);
+        header.skipRawData(sizeof(kCompactFormatMagic));
+        header >> version >> visualSampleRate >> audioVisualRatio >> dataSize;
+    }
+    if (version != kCompactFormatVersion) {
+        qDebug() << "ERROR: Unsupported waveform format version" << version;
+        return;
+    }
+    if (static_cast<qint64>(dataSize) * static_cast<qint64>(sizeof(WaveformData)) !=
+            data.size() - kCompactFormatHeaderSize) {
+        qDebug() << "ERROR: Waveform data size" << dataSize
+                 << "does not match byte array of size" << data.size();
+        return;
+    }
+
+    qDebug() << "Reading waveform from byte array:"
+             << "dataSize" << dataSize
+             << "visualSampleRate" << visualSampleRate
+             << "audioVisualRatio" << audioVisualRatio;
+
+    resize(static_cast<int>(dataSize));
+    m_visualSampleRate = visualSampleRate;
+    m_audioVisualRatio = audioVisualRatio;
+    std::memcpy(m_data.data(),
+            data.constData() + kCompactFormatHeaderSize,
+            dataSize * sizeof(WaveformData));
+    m_completion = m_dataSize;
+    m_saveState = SaveState::Saved;
+    buildMipLevels();
+}
+
+void Waveform::buildMipLevels() {
+    if (m_mipLevelCount.loadAcquire() > 0) {
+        // Already built, the levels must not be modified while they
+        // might be read
+        return;
+    }
+    m_mipLevels.reserve(kMaxMipLevels);
+    const WaveformData* pPrevData = m_data.data();
+    int prevFrames = m_dataSize / ChannelCount;
+    while (prevFrames > 1 && static_cast<int>(m_mipLevels.size()) < kMaxMipLevels) {
+        const int frames = (prevFrames + 1) / 2;
+        std::vector<WaveformData> level(frames * ChannelCount);
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int chn = 0; chn < ChannelCount; ++chn) {
+                // The last frame of an odd number of frames has no partner
+                const WaveformData& first = pPrevData[2 * frame * ChannelCount + chn];
+                const WaveformData& second = (2 * frame + 1 < prevFrames)
+                        ? pPrevData[(2 * frame + 1) * ChannelCount + chn]
+                        : first;
+                WaveformData& datum = level[frame * ChannelCount + chn];
+                datum.filtered.low = std::max(first.filtered.low, second.filtered.low);
+                datum.filtered.mid = std::max(first.filtered.mid, second.filtered.mid);
+                datum.filtered.high = std::max(first.filtered.high, second.filtered.high);
+                datum.filtered.all = std::max(first.filtered.all, second.filtered.all);
+            }
+        }
+        m_mipLevels.push_back(std::move(level));
+        pPrevData = m_mipLevels.back().data();
+        prevFrames = frames;
+    }
+    m_mipLevelCount.storeRelease(static_cast<int>(m_mipLevels.size()));
+}
+
+int Waveform::findMipLevel(double visualFramesPerPixel) const {
+    const int levelCount = getMipLevelCount();
+    int level = 0;
+    while (level + 1 < levelCount &&
+            static_cast<double>(1 << (level + 1)) <= visualFramesPerPixel) {
+        ++level;
+    }
+    return level;
+}
+
+int Waveform::findMipLevelForDisplay(double firstDisplayedPosition,
+        double lastDisplayedPosition,
+        int length) const {
+    if (length <= 0) {
+        return 0;
+    }
+    return findMipLevel((lastDisplayedPosition - firstDisplayedPosition) *
+            (getDataSize() / 2) / static_cast<double>(length));
+}
+
+int Waveform::getMipLevelDataSize(int level) const {
+    DEBUG_ASSERT(level >= 0 && level < getMipLevelCount());
+    if (level == 0) {
+        return m_dataSize;
+    }
+    return static_cast<int>(m_mipLevels[level - 1].size());
+}
+
+const WaveformData* Waveform::mipLevelData(int level) const {
+    DEBUG_ASSERT(level >= 0 && level < getMipLevelCount());
+    if (level == 0) {
+        return m_data.data();
+    }
+    return m_mipLevels[level - 1].data();
 }
 
 void Waveform::resize(int size) {
@@ -5,9 +5,11 @@
 #include <QMutex>
 #include <QSharedPointer>
 #include <QString>
+#include <atomic>
 #include <vector>
 
 #include "audio/signalinfo.h"
+#include "util/assert.h"
 #include "util/class.h"
 #include "util/compatibility/qmutex.h"
 
@@ -32,6 +34,8 @@ class Waveform {
     enum class SaveState {
         NotSaved = 0,
         SavePending,
+        // Claimed by a thread that saves it, see tryBeginSave()
+        Saving,
         Saved
     };
 
@@ -74,6 +78,9 @@ class Waveform {
         m_description = description;
     }
 
+    // Serializes the waveform into the compact format, i.e. a small header
+    // followed by the interleaved WaveformData. Waveforms in the previous
+    // protobuf format can still be read.
     QByteArray toByteArray() const;
 
     SaveState saveState() const {
@@ -86,6 +93,19 @@ class Waveform {
         m_saveState = eState;
     }
 
+    /// Claims a pending waveform for saving, so it is not saved again by
+    /// another thread at the same time. Returns false if it is not pending.
+    bool tryBeginSave() const {
+        SaveState expected = SaveState::SavePending;
+        return m_saveState.compare_exchange_strong(expected, SaveState::Saving);
+    }
+    /// Finishes saving a waveform claimed by tryBeginSave(), which remains
+    /// pending if it could not be saved.
+    void finishSave(bool saved) const {
+        DEBUG_ASSERT(m_saveState == SaveState::Saving);
+        m_saveState = saved ? SaveState::Saved : SaveState::SavePending;
+    }
+
     // We do not lock the mutex since m_audioVisualRatio is not changed after
     // the constructor runs.
     double getAudioVisualRatio() const {
@@ -128,10 +148,38 @@ class Waveform {
     // constructor runs.
     const WaveformData* data() const { return &m_data[0];}
 
+    // Computes the mip levels of the completed waveform. Each level holds
+    // the maximum of two consecutive visual frames of the previous level,
+    // so renderers can find the maxima of a pixel column in constant time
+    // at any zoom. Level 0 is the waveform data itself.
+    void buildMipLevels();
+
+    // Atomically get the number of available mip levels, which is 1 until
+    // buildMipLevels() has been invoked.
+    int getMipLevelCount() const {
+        return m_mipLevelCount.loadAcquire() + 1;
+    }
+
+    // Returns the coarsest available mip level in which a visual frame does
+    // not cover more than the given number of visual frames of level 0.
+    int findMipLevel(double visualFramesPerPixel) const;
+
+    // Returns the mip level for rendering the normalized range between the
+    // first and the last displayed position onto the given number of pixels.
+    // Zoomed out, a pixel covers many visual frames, whose maxima are read
+    // from a coarser mip level to keep the cost per pixel constant.
+    int findMipLevelForDisplay(double firstDisplayedPosition,
+            double lastDisplayedPosition,
+            int length) const;
+
+    int getMipLevelDataSize(int level) const;
+    const WaveformData* mipLevelData(int level) const;
+
     void dump() const;
 
   private:
     void readByteArray(const QByteArray& data);
+    void readCompactByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size, int value = 0);
 
@@ -145,7 +193,7 @@ class Waveform {
     // If stored in the database, the ID of the waveform.
     int m_id;
     // mutable since AnalysisDAO needs to be able to set the waveform as saved.
-    mutable SaveState m_saveState;
+    mutable std::atomic<SaveState> m_saveState;
     QString m_version;
     QString m_description;
 
@@ -173,6 +221,12 @@ class Waveform {
     // the mutex. The completion of the waveform calculation.
     QAtomicInt m_completion;
 
+    // The mip levels 1..n, reserved in advance so they can be read while
+    // further levels are added. Only the first m_mipLevelCount levels are
+    // published to readers.
+    std::vector<std::vector<WaveformData>> m_mipLevels;
+    QAtomicInt m_mipLevelCount;
+
     mutable QMutex m_mutex;
 
     DISALLOW_COPY_AND_ASSIGN(Waveform);
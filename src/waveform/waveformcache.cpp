@@ -0,0 +1,166 @@
+#include "waveform/waveformcache.h"
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+WaveformCache::WaveformCache(std::size_t maxBytes)
+        : m_maxBytes(maxBytes),
+          m_bytesInUse(0),
+          m_useCounter(0),
+          m_memoryAccount(QStringLiteral("WaveformCache")) {
+}
+
+// static
+WaveformCache& WaveformCache::instance() {
+    static WaveformCache s_instance;
+    return s_instance;
+}
+
+// static
+std::size_t WaveformCache::memoryUsageOf(const Waveform& waveform) {
+    std::size_t dataSize = 0;
+    for (int level = 0; level < waveform.getMipLevelCount(); ++level) {
+        dataSize += static_cast<std::size_t>(waveform.getMipLevelDataSize(level));
+    }
+    return dataSize * sizeof(WaveformData);
+}
+
+ConstWaveformPointer WaveformCache::lookup(
+        TrackId trackId,
+        Type type,
+        const QString& version) {
+    if (!trackId.isValid()) {
+        return {};
+    }
+    const auto locker = lockMutex(&m_mutex);
+    QHash<TrackId, Entry>& typeEntries = entries(type);
+    const auto it = typeEntries.find(trackId);
+    if (it == typeEntries.end()) {
+        return {};
+    }
+    if (it->version != version) {
+        releaseStrong(&it.value());
+        typeEntries.erase(it);
+        return {};
+    }
+    ConstWaveformPointer pWaveform = it->pWeak.toStrongRef();
+    if (!pWaveform) {
+        typeEntries.erase(it);
+        return {};
+    }
+    if (!it->pStrong) {
+        // Used again, so it counts against the memory limit again
+        it->pStrong = pWaveform;
+        m_bytesInUse += it->bytes;
+    }
+    it->lastUsed = ++m_useCounter;
+    evict();
+    return pWaveform;
+}
+
+void WaveformCache::insert(
+        TrackId trackId,
+        Type type,
+        const ConstWaveformPointer& pWaveform) {
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid() && pWaveform) {
+        return;
+    }
+    const std::size_t bytes = memoryUsageOf(*pWaveform);
+    const auto locker = lockMutex(&m_mutex);
+    Entry& entry = entries(type)[trackId];
+    releaseStrong(&entry);
+    entry.pWeak = pWaveform;
+    entry.version = pWaveform->getVersion();
+    entry.bytes = bytes;
+    entry.lastUsed = ++m_useCounter;
+    if (bytes <= m_maxBytes) {
+        entry.pStrong = pWaveform;
+        m_bytesInUse += bytes;
+        evict();
+    }
+}
+
+void WaveformCache::remove(TrackId trackId) {
+    const auto locker = lockMutex(&m_mutex);
+    for (auto* pEntries : {&m_waveforms, &m_summaries}) {
+        const auto it = pEntries->find(trackId);
+        if (it != pEntries->end()) {
+            releaseStrong(&it.value());
+            pEntries->erase(it);
+        }
+    }
+}
+
+void WaveformCache::removeAll(Type type) {
+    const auto locker = lockMutex(&m_mutex);
+    QHash<TrackId, Entry>& typeEntries = entries(type);
+    for (auto& entry : typeEntries) {
+        releaseStrong(&entry);
+    }
+    typeEntries.clear();
+}
+
+std::size_t WaveformCache::bytesInUse() const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_bytesInUse;
+}
+
+std::size_t WaveformCache::maxBytes() const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_maxBytes;
+}
+
+void WaveformCache::setMaxBytes(std::size_t maxBytes) {
+    const auto locker = lockMutex(&m_mutex);
+    m_maxBytes = maxBytes;
+    evict();
+}
+
+void WaveformCache::releaseStrong(Entry* pEntry) {
+    if (pEntry->pStrong) {
+        DEBUG_ASSERT(m_bytesInUse >= pEntry->bytes);
+        m_bytesInUse -= pEntry->bytes;
+        m_memoryAccount.set(static_cast<qint64>(m_bytesInUse));
+        pEntry->pStrong.reset();
+    }
+}
+
+void WaveformCache::evict() {
+    // Invoked after every allocation, so the peak is accounted before
+    // evicting
+    m_memoryAccount.set(static_cast<qint64>(m_bytesInUse));
+    if (m_bytesInUse <= m_maxBytes) {
+        return;
+    }
+    // Forget the waveforms that are not owned by anyone anymore first.
+    // Erasing moves the entries of a QHash, so this is done before taking
+    // pointers to them.
+    for (auto* pEntries : {&m_waveforms, &m_summaries}) {
+        for (auto it = pEntries->begin(); it != pEntries->end();) {
+            if (!it->pStrong && it->pWeak.isNull()) {
+                it = pEntries->erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    while (m_bytesInUse > m_maxBytes) {
+        // The number of cached tracks is small, so a linear search for the
+        // least recently used waveform is cheap compared to loading one
+        Entry* pOldest = nullptr;
+        for (auto* pEntries : {&m_waveforms, &m_summaries}) {
+            for (auto& entry : *pEntries) {
+                if (entry.pStrong && (!pOldest || entry.lastUsed < pOldest->lastUsed)) {
+                    pOldest = &entry;
+                }
+            }
+        }
+        VERIFY_OR_DEBUG_ASSERT(pOldest) {
+            m_bytesInUse = 0;
+            m_memoryAccount.set(0);
+            return;
+        }
+        // Keep the weak reference, another owner may still hold it
+        releaseStrong(pOldest);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWeakPointer>
+#include <cstddef>
+
+#include "track/trackid.h"
+#include "util/memoryaccount.h"
+#include "waveform/waveform.h"
+
+/// A process-wide cache of the completed waveforms of tracks, keyed by the
+/// TrackId, the type and the analysis version.
+///
+/// While a track is loaded, its decks and overviews already share the
+/// waveforms of the Track object. Once the Track has been evicted from the
+/// GlobalTrackCache, reloading it would read and decompress the stored
+/// analyses again. The cache avoids this by keeping the most recently used
+/// waveforms alive up to a memory limit. Waveforms that have been evicted
+/// from that limit are still found by a weak reference as long as any
+/// other owner holds them.
+///
+/// Only completed waveforms must be inserted. They are never modified
+/// afterwards, so they can be shared between threads. All functions are
+/// thread-safe.
+class WaveformCache final {
+  public:
+    enum class Type {
+        Waveform,
+        Summary,
+    };
+
+    static constexpr std::size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
+    explicit WaveformCache(std::size_t maxBytes = kDefaultMaxBytes);
+
+    static WaveformCache& instance();
+
+    /// Returns null if there is no waveform of the given version.
+    ConstWaveformPointer lookup(
+            TrackId trackId,
+            Type type,
+            const QString& version);
+    /// Replaces any waveform of the same track and type.
+    void insert(
+            TrackId trackId,
+            Type type,
+            const ConstWaveformPointer& pWaveform);
+    /// Drops both waveforms of the track, e.g. when its analyses have been
+    /// deleted.
+    void remove(TrackId trackId);
+    void removeAll(Type type);
+
+    /// The memory of the waveforms that are kept alive by the cache
+    std::size_t bytesInUse() const;
+
+    std::size_t maxBytes() const;
+    /// Evicts the least recently used waveforms down to the new limit.
+    void setMaxBytes(std::size_t maxBytes);
+
+    static std::size_t memoryUsageOf(const Waveform& waveform);
+
+  private:
+    struct Entry {
+        QWeakPointer<const Waveform> pWeak;
+        // Null if the entry has been evicted from the memory limit
+        ConstWaveformPointer pStrong;
+        QString version;
+        std::size_t bytes;
+        quint64 lastUsed;
+    };
+
+    QHash<TrackId, Entry>& entries(Type type) {
+        return type == Type::Waveform ? m_waveforms : m_summaries;
+    }
+
+    void releaseStrong(Entry* pEntry);
+    void evict();
+
+    std::size_t m_maxBytes;
+
+    mutable QMutex m_mutex;
+    QHash<TrackId, Entry> m_waveforms;
+    QHash<TrackId, Entry> m_summaries;
+    std::size_t m_bytesInUse;
+    quint64 m_useCounter;
+    MemoryAccount m_memoryAccount;
+};
@@ -0,0 +1,43 @@
+#include "waveform/waveformframeratethrottle.h"
+
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+const mixxx::Logger kLogger("WaveformFrameRateThrottle");
+
+} // anonymous namespace
+
+WaveformFrameRateThrottle::WaveformFrameRateThrottle(int configuredFrameRate)
+        : m_configuredFrameRate(configuredFrameRate),
+          m_frameRate(configuredFrameRate) {
+}
+
+void WaveformFrameRateThrottle::setConfiguredFrameRate(int frameRate) {
+    m_configuredFrameRate = frameRate;
+    m_frameRate = frameRate;
+}
+
+bool WaveformFrameRateThrottle::update(double audioLatencyUsage, double renderLoad) {
+    // Never throttle below the configured frame rate if it is already lower
+    const int minFrameRate = math_min(kMinFrameRate, m_configuredFrameRate);
+    int frameRate = m_frameRate;
+    if (audioLatencyUsage > kHighAudioLatencyUsage || renderLoad > kHighRenderLoad) {
+        frameRate = math_max(minFrameRate, frameRate - kFrameRateStep);
+    } else if (audioLatencyUsage < kLowAudioLatencyUsage && renderLoad < kLowRenderLoad) {
+        frameRate = math_min(m_configuredFrameRate, frameRate + kFrameRateStep);
+    }
+    if (frameRate == m_frameRate) {
+        return false;
+    }
+    if (frameRate < m_frameRate) {
+        kLogger.debug() << "Reducing waveform frame rate to" << frameRate
+                        << "audio latency usage:" << audioLatencyUsage
+                        << "render load:" << renderLoad;
+    } else {
+        kLogger.debug() << "Increasing waveform frame rate to" << frameRate;
+    }
+    m_frameRate = frameRate;
+    return true;
+}
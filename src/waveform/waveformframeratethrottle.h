@@ -0,0 +1,42 @@
+#pragma once
+
+/// WaveformFrameRateThrottle lowers the frame rate of the waveforms while
+/// the audio engine or the waveform rendering itself is busy, so the GUI
+/// does not compete with the engine for the CPU on slow machines.
+///
+/// It is updated periodically with the share of the audio callback time
+/// budget that is used and with the share of the GUI thread time that is
+/// spent rendering. The frame rate is reduced by kFrameRateStep down to
+/// kMinFrameRate while one of them is high, and restored step by step
+/// to the configured frame rate once both are low again.
+class WaveformFrameRateThrottle {
+  public:
+    static constexpr double kHighAudioLatencyUsage = 0.7;
+    static constexpr double kLowAudioLatencyUsage = 0.5;
+    static constexpr double kHighRenderLoad = 0.5;
+    static constexpr double kLowRenderLoad = 0.25;
+    static constexpr int kMinFrameRate = 15;
+    static constexpr int kFrameRateStep = 5;
+
+    explicit WaveformFrameRateThrottle(int configuredFrameRate = 60);
+
+    /// Sets the frame rate that is used without pressure and resets
+    /// the throttle to it.
+    void setConfiguredFrameRate(int frameRate);
+
+    /// Updates the throttle from the current measurements. Returns true
+    /// if frameRate() has changed.
+    bool update(double audioLatencyUsage, double renderLoad);
+
+    int frameRate() const {
+        return m_frameRate;
+    }
+
+    bool isThrottled() const {
+        return m_frameRate < m_configuredFrameRate;
+    }
+
+  private:
+    int m_configuredFrameRate;
+    int m_frameRate;
+};
@@ -0,0 +1,285 @@
+#include "waveform/waveformthumbnailstore.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "waveform/waveform.h"
+
+namespace {
+
+const mixxx::Logger kLogger("WaveformThumbnailStore");
+
+constexpr char kMagic[8] = {'M', 'I', 'X', 'X', 'X', 'W', 'T', 'S'};
+constexpr quint32 kVersion = 1;
+
+// The pack file is only used on the machine that has written it, so all
+// values are stored in native byte order.
+struct PackFileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 stripWidth;
+};
+static_assert(sizeof(PackFileHeader) == 16);
+
+struct PackFileRecord {
+    // The TrackId or -1 if the record is free
+    qint32 trackId;
+    WaveformThumbnailStore::Strip strip;
+};
+static_assert(sizeof(PackFileRecord) ==
+        sizeof(qint32) + WaveformThumbnailStore::kStripWidth);
+
+constexpr qint64 kRecordSize = sizeof(PackFileRecord);
+
+constexpr qint64 recordOffset(int slot) {
+    return static_cast<qint64>(sizeof(PackFileHeader)) + slot * kRecordSize;
+}
+
+std::mutex s_instanceMutex;
+std::shared_ptr<WaveformThumbnailStore> s_pInstance;
+
+} // anonymous namespace
+
+WaveformThumbnailStore::WaveformThumbnailStore(const QString& filePath)
+        : m_file(filePath),
+          m_pMapped(nullptr),
+          m_mappedSlots(0),
+          m_slotCount(0) {
+    open();
+}
+
+WaveformThumbnailStore::~WaveformThumbnailStore() {
+    close();
+}
+
+// static
+void WaveformThumbnailStore::openInstance(const QString& filePath) {
+    auto pStore = std::make_shared<WaveformThumbnailStore>(filePath);
+    const std::lock_guard lock(s_instanceMutex);
+    s_pInstance = std::move(pStore);
+}
+
+// static
+void WaveformThumbnailStore::closeInstance() {
+    std::shared_ptr<WaveformThumbnailStore> pStore;
+    {
+        const std::lock_guard lock(s_instanceMutex);
+        pStore.swap(s_pInstance);
+    }
+    // The file is closed by the last owner
+}
+
+// static
+std::shared_ptr<WaveformThumbnailStore> WaveformThumbnailStore::instance() {
+    const std::lock_guard lock(s_instanceMutex);
+    return s_pInstance;
+}
+
+// static
+WaveformThumbnailStore::Strip WaveformThumbnailStore::stripFromSummary(
+        const Waveform& summary) {
+    Strip strip{};
+    // The left and right channel are interleaved
+    const int visualFrames = summary.getDataSize() / 2;
+    if (visualFrames <= 0) {
+        return strip;
+    }
+    const WaveformData* pData = summary.data();
+    for (int column = 0; column < kStripWidth; ++column) {
+        const int firstFrame = column * visualFrames / kStripWidth;
+        const int lastFrame = std::max(
+                (column + 1) * visualFrames / kStripWidth, firstFrame + 1);
+        uchar peak = 0;
+        for (int frame = firstFrame; frame < lastFrame && frame < visualFrames; ++frame) {
+            peak = std::max({peak,
+                    pData[2 * frame].filtered.all,
+                    pData[2 * frame + 1].filtered.all});
+        }
+        strip[column] = peak;
+    }
+    return strip;
+}
+
+void WaveformThumbnailStore::open() {
+    QDir().mkpath(QFileInfo(m_file).absolutePath());
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        kLogger.warning() << "Failed to open" << m_file.fileName()
+                          << m_file.errorString();
+        return;
+    }
+
+    PackFileHeader header;
+    const bool validHeader = m_file.read(reinterpret_cast<char*>(&header),
+                                     sizeof(header)) ==
+                    static_cast<qint64>(sizeof(header)) &&
+            std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+            header.version == kVersion &&
+            header.stripWidth == static_cast<quint32>(kStripWidth);
+    if (!validHeader) {
+        if (m_file.size() > 0) {
+            kLogger.warning() << "Discarding invalid pack file" << m_file.fileName();
+        }
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.stripWidth = kStripWidth;
+        if (!m_file.resize(0) ||
+                !m_file.seek(0) ||
+                m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) !=
+                        static_cast<qint64>(sizeof(header))) {
+            kLogger.warning() << "Failed to write" << m_file.fileName()
+                              << m_file.errorString();
+            m_file.close();
+        }
+        return;
+    }
+
+    // Drop a partially written record at the end
+    m_slotCount = static_cast<int>((m_file.size() - recordOffset(0)) / kRecordSize);
+    m_file.resize(recordOffset(m_slotCount));
+    if (m_slotCount == 0) {
+        return;
+    }
+    m_pMapped = m_file.map(0, recordOffset(m_slotCount));
+    if (!m_pMapped) {
+        kLogger.warning() << "Failed to map" << m_file.fileName()
+                          << m_file.errorString();
+        m_file.close();
+        m_slotCount = 0;
+        return;
+    }
+    m_mappedSlots = m_slotCount;
+
+    m_slotsByTrackId.reserve(m_slotCount);
+    for (int slot = 0; slot < m_slotCount; ++slot) {
+        qint32 trackIdValue;
+        std::memcpy(&trackIdValue, m_pMapped + recordOffset(slot), sizeof(trackIdValue));
+        if (trackIdValue < 0) {
+            m_freeSlots.append(slot);
+            continue;
+        }
+        const TrackId trackId(QVariant(trackIdValue));
+        if (m_slotsByTrackId.contains(trackId)) {
+            m_freeSlots.append(slot);
+            continue;
+        }
+        m_slotsByTrackId.insert(trackId, slot);
+    }
+    kLogger.debug() << "Opened" << m_file.fileName()
+                    << "with" << m_slotsByTrackId.size() << "strips";
+}
+
+void WaveformThumbnailStore::close() {
+    if (m_pMapped) {
+        m_file.unmap(m_pMapped);
+        m_pMapped = nullptr;
+    }
+    m_file.close();
+}
+
+const uchar* WaveformThumbnailStore::mappedStrip(int slot) const {
+    DEBUG_ASSERT(slot < m_mappedSlots);
+    return m_pMapped + recordOffset(slot) + offsetof(PackFileRecord, strip);
+}
+
+void WaveformThumbnailStore::writeRecord(
+        int slot, TrackId trackId, const Strip& strip) {
+    PackFileRecord record;
+    record.trackId = trackId.isValid() ? trackId.toVariant().toInt() : -1;
+    record.strip = strip;
+    if (slot < m_mappedSlots) {
+        // Written back to the file by the operating system
+        std::memcpy(m_pMapped + recordOffset(slot), &record, sizeof(record));
+        return;
+    }
+    if (trackId.isValid()) {
+        m_appendedStrips.insert(slot, strip);
+    } else {
+        m_appendedStrips.remove(slot);
+    }
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (!m_file.seek(recordOffset(slot)) ||
+            m_file.write(reinterpret_cast<const char*>(&record), sizeof(record)) !=
+                    static_cast<qint64>(sizeof(record))) {
+        kLogger.warning() << "Failed to write" << m_file.fileName()
+                          << m_file.errorString();
+    }
+}
+
+int WaveformThumbnailStore::size() const {
+    const auto locker = lockMutex(&m_mutex);
+    return static_cast<int>(m_slotsByTrackId.size());
+}
+
+bool WaveformThumbnailStore::contains(TrackId trackId) const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_slotsByTrackId.contains(trackId);
+}
+
+bool WaveformThumbnailStore::lookup(TrackId trackId, Strip* pStrip) const {
+    const auto locker = lockMutex(&m_mutex);
+    const auto it = m_slotsByTrackId.constFind(trackId);
+    if (it == m_slotsByTrackId.constEnd()) {
+        return false;
+    }
+    const int slot = it.value();
+    if (slot < m_mappedSlots) {
+        std::memcpy(pStrip->data(), mappedStrip(slot), kStripWidth);
+    } else {
+        *pStrip = m_appendedStrips.value(slot);
+    }
+    return true;
+}
+
+void WaveformThumbnailStore::insert(TrackId trackId, const Strip& strip) {
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    int slot = m_slotsByTrackId.value(trackId, -1);
+    if (slot < 0) {
+        if (m_freeSlots.isEmpty()) {
+            slot = m_slotCount++;
+        } else {
+            slot = m_freeSlots.takeLast();
+        }
+        m_slotsByTrackId.insert(trackId, slot);
+    }
+    writeRecord(slot, trackId, strip);
+}
+
+void WaveformThumbnailStore::remove(TrackId trackId) {
+    const auto locker = lockMutex(&m_mutex);
+    const auto it = m_slotsByTrackId.find(trackId);
+    if (it == m_slotsByTrackId.end()) {
+        return;
+    }
+    const int slot = it.value();
+    m_slotsByTrackId.erase(it);
+    writeRecord(slot, TrackId(), Strip{});
+    m_freeSlots.append(slot);
+}
+
+void WaveformThumbnailStore::clear() {
+    const auto locker = lockMutex(&m_mutex);
+    m_slotsByTrackId.clear();
+    m_appendedStrips.clear();
+    m_freeSlots.clear();
+    if (m_pMapped) {
+        m_file.unmap(m_pMapped);
+        m_pMapped = nullptr;
+    }
+    m_mappedSlots = 0;
+    m_slotCount = 0;
+    if (m_file.isOpen()) {
+        m_file.resize(recordOffset(0));
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <memory>
+
+#include "track/trackid.h"
+
+class Waveform;
+
+/// Stores a tiny strip of the overview waveform of every analyzed track,
+/// which the library draws in the waveform column.
+///
+/// The strips are computed from the waveform summary at analysis time and
+/// stored in a single pack file of fixed size records. The file is mapped
+/// into memory and indexed by TrackId when it is opened, so painting a row
+/// does neither access the database nor the file system. 100k tracks need
+/// less than 7 MB.
+///
+/// Records of removed tracks are reused for tracks that are inserted later.
+/// All functions are thread-safe.
+class WaveformThumbnailStore final {
+  public:
+    /// The number of columns of a strip
+    static constexpr int kStripWidth = 64;
+    /// The peak amplitude of each column, 0 to 255
+    using Strip = std::array<uchar, kStripWidth>;
+
+    /// Opens or creates the pack file. Falls back to keeping the strips in
+    /// memory if the file cannot be opened.
+    explicit WaveformThumbnailStore(const QString& filePath);
+    ~WaveformThumbnailStore();
+
+    /// Opens the store of the application, which is used by the analyzers
+    /// and the library until closeInstance() is invoked.
+    static void openInstance(const QString& filePath);
+    static void closeInstance();
+    /// Returns null if no store has been opened, e.g. in tests.
+    static std::shared_ptr<WaveformThumbnailStore> instance();
+
+    static Strip stripFromSummary(const Waveform& summary);
+
+    int size() const;
+    bool contains(TrackId trackId) const;
+    /// Returns false if there is no strip for the track.
+    bool lookup(TrackId trackId, Strip* pStrip) const;
+    void insert(TrackId trackId, const Strip& strip);
+    void remove(TrackId trackId);
+    void clear();
+
+  private:
+    void open();
+    void close();
+    void writeRecord(int slot, TrackId trackId, const Strip& strip);
+    const uchar* mappedStrip(int slot) const;
+
+    mutable QMutex m_mutex;
+    QFile m_file;
+    uchar* m_pMapped;
+    // The number of records that are mapped into memory. Records that have
+    // been appended after opening the file are kept in m_appendedStrips.
+    int m_mappedSlots;
+    int m_slotCount;
+    QHash<TrackId, int> m_slotsByTrackId;
+    QHash<int, Strip> m_appendedStrips;
+    QList<int> m_freeSlots;
+};
@@ -8,6 +8,8 @@
 #include <QGLShaderProgram>
 #endif
 
+#include <QCoreApplication>
+#include <QEvent>
 #include <QOpenGLFunctions>
 #include <QRegularExpression>
 #include <QStringList>
@@ -57,6 +59,22 @@ bool shouldRenderWaveform(WaveformWidgetAbstract* pWaveformWidget) {
 }
 
 const QRegularExpression openGLVersionRegex(QStringLiteral("^(\\d+)\\.(\\d+).*$"));
+
+// The vsync slots are delivered as posted events with a high priority
+// instead of queued signals. They are dispatched before all other events
+// and queued invocations that are pending in the main thread, e.g. the
+// many updates of the library and the analysis, which would otherwise
+// delay the next frame.
+const QEvent::Type kVSyncRenderEvent =
+        static_cast<QEvent::Type>(QEvent::registerEventType());
+const QEvent::Type kVSyncSwapEvent =
+        static_cast<QEvent::Type>(QEvent::registerEventType());
+const QEvent::Type kVSyncSwapAndRenderEvent =
+        static_cast<QEvent::Type>(QEvent::registerEventType());
+
+void postVSyncEvent(QObject* pReceiver, QEvent::Type type) {
+    QCoreApplication::postEvent(pReceiver, new QEvent(type), Qt::HighEventPriority);
+}
 }  // anonymous namespace
 
 ///////////////////////////////////////////
@@ -94,6 +112,8 @@ WaveformWidgetFactory::WaveformWidgetFactory()
           m_config(nullptr),
           m_skipRender(false),
           m_frameRate(60),
+          m_adaptiveFrameRate(false),
+          m_frameRateThrottle(m_frameRate),
           m_endOfTrackWarningTime(30),
           m_defaultZoom(WaveformWidgetRenderer::s_waveformDefaultZoom),
           m_zoomSync(true),
@@ -340,6 +360,9 @@ bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
 
     int frameRate = m_config->getValue(ConfigKey("[Waveform]","FrameRate"), m_frameRate);
     m_frameRate = math_clamp(frameRate, 1, 120);
+    m_frameRateThrottle.setConfiguredFrameRate(m_frameRate);
+    m_adaptiveFrameRate = m_config->getValue(
+            ConfigKey("[Waveform]", "AdaptiveFrameRate"), m_adaptiveFrameRate);
 
 
     int endTime = m_config->getValueString(ConfigKey("[Waveform]","EndOfTrackWarningTime")).toInt(&ok);
@@ -513,8 +536,44 @@ void WaveformWidgetFactory::setFrameRate(int frameRate) {
     if (m_config) {
         m_config->set(ConfigKey("[Waveform]","FrameRate"), ConfigValue(m_frameRate));
     }
+    m_frameRateThrottle.setConfiguredFrameRate(m_frameRate);
+    applyFrameRate();
+}
+
+void WaveformWidgetFactory::setAdaptiveFrameRate(bool adaptive) {
+    m_adaptiveFrameRate = adaptive;
+    if (m_config) {
+        m_config->setValue(ConfigKey("[Waveform]", "AdaptiveFrameRate"), m_adaptiveFrameRate);
+    }
+    if (!m_adaptiveFrameRate) {
+        m_frameRateThrottle.setConfiguredFrameRate(m_frameRate);
+        applyFrameRate();
+    }
+}
+
+void WaveformWidgetFactory::applyFrameRate() {
     if (m_vsyncThread) {
-        m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / m_frameRate));
+        m_vsyncThread->setSyncIntervalTimeMicros(
+                static_cast<int>(1e6 / m_frameRateThrottle.frameRate()));
+    }
+}
+
+void WaveformWidgetFactory::updateFrameRateThrottle(mixxx::Duration elapsed) {
+    if (!m_adaptiveFrameRate || elapsed <= mixxx::Duration::empty()) {
+        return;
+    }
+    // The control is created by the engine, which might not exist yet
+    // when the first frames are rendered
+    if (!m_pAudioLatencyUsage || !m_pAudioLatencyUsage->valid()) {
+        m_pAudioLatencyUsage = std::make_unique<PollingControlProxy>(
+                QStringLiteral("[App]"),
+                QStringLiteral("audio_latency_usage"),
+                ControlFlag::AllowMissingOrInvalid);
+    }
+    const double audioLatencyUsage = m_pAudioLatencyUsage->get();
+    const double renderLoad = m_renderTime.toDoubleSeconds() / elapsed.toDoubleSeconds();
+    if (m_frameRateThrottle.update(audioLatencyUsage, renderLoad)) {
+        applyFrameRate();
     }
 }
 
@@ -717,6 +776,8 @@ void WaveformWidgetFactory::renderSelf() {
             static_cast<int>(m_waveformWidgetHolders.size()));
 
     if (!m_skipRender) {
+        PerformanceTimer renderTimer;
+        renderTimer.start();
         if (m_type) {   // no regular updates for an empty waveform
             // next rendered frame is displayed after next buffer swap and than after VSync
             QVarLengthArray<bool, 10> shouldRenderWaveforms(
@@ -764,6 +825,7 @@ void WaveformWidgetFactory::renderSelf() {
         //int t1 = m_vsyncThread->elapsed();
         emit waveformUpdateTick();
         //qDebug() << "emit" << m_vsyncThread->elapsed() - t1;
+        m_renderTime += renderTimer.elapsed();
 
         m_frameCnt += 1.0f;
         mixxx::Duration timeCnt = m_time.elapsed();
@@ -772,6 +834,8 @@ void WaveformWidgetFactory::renderSelf() {
             m_frameCnt = m_frameCnt * 1000 / timeCnt.toIntegerMillis(); // latency correction
             emit waveformMeasured(m_frameCnt, m_vsyncThread->droppedFrames());
             m_frameCnt = 0.0;
+            updateFrameRateThrottle(timeCnt);
+            m_renderTime = mixxx::Duration::empty();
         }
     }
 
@@ -781,6 +845,22 @@ void WaveformWidgetFactory::renderSelf() {
     //qDebug() << "refresh end" << m_vsyncThread->elapsed();
 }
 
+bool WaveformWidgetFactory::event(QEvent* pEvent) {
+    if (pEvent->type() == kVSyncRenderEvent) {
+        render();
+        return true;
+    }
+    if (pEvent->type() == kVSyncSwapEvent) {
+        swap();
+        return true;
+    }
+    if (pEvent->type() == kVSyncSwapAndRenderEvent) {
+        swapAndRender();
+        return true;
+    }
+    return QObject::event(pEvent);
+}
+
 void WaveformWidgetFactory::render() {
     renderSelf();
     m_vsyncThread->vsyncSlotFinished();
@@ -1172,7 +1252,8 @@ void WaveformWidgetFactory::startVSync(GuiTick* pGuiTick, VisualsManager* pVisua
     m_pVisualsManager = pVisualsManager;
     m_vsyncThread = new VSyncThread(this, vSyncMode);
     m_vsyncThread->setObjectName(QStringLiteral("VSync"));
-    m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / m_frameRate));
+    m_vsyncThread->setSyncIntervalTimeMicros(
+            static_cast<int>(1e6 / m_frameRateThrottle.frameRate()));
 
 #ifdef MIXXX_USE_QOPENGL
     if (m_vsyncThread->vsyncMode() == VSyncThread::ST_PLL) {
@@ -1186,18 +1267,31 @@ void WaveformWidgetFactory::startVSync(GuiTick* pGuiTick, VisualsManager* pVisua
     }
 #endif
 
-    connect(m_vsyncThread,
+    // The signals are emitted from the vsync thread and posted from there
+    connect(
+            m_vsyncThread,
             &VSyncThread::vsyncRender,
             this,
-            &WaveformWidgetFactory::render);
-    connect(m_vsyncThread,
+            [this] {
+                postVSyncEvent(this, kVSyncRenderEvent);
+            },
+            Qt::DirectConnection);
+    connect(
+            m_vsyncThread,
             &VSyncThread::vsyncSwap,
             this,
-            &WaveformWidgetFactory::swap);
-    connect(m_vsyncThread,
+            [this] {
+                postVSyncEvent(this, kVSyncSwapEvent);
+            },
+            Qt::DirectConnection);
+    connect(
+            m_vsyncThread,
             &VSyncThread::vsyncSwapAndRender,
             this,
-            &WaveformWidgetFactory::swapAndRender);
+            [this] {
+                postVSyncEvent(this, kVSyncSwapAndRenderEvent);
+            },
+            Qt::DirectConnection);
 
     m_vsyncThread->start(QThread::NormalPriority);
 }
@@ -3,13 +3,17 @@
 #include <QObject>
 #include <QSurfaceFormat>
 #include <QVector>
+#include <memory>
 #include <vector>
 
+#include "control/pollingcontrolproxy.h"
 #include "preferences/usersettings.h"
 #include "skin/legacy/skincontext.h"
+#include "util/duration.h"
 #include "util/performancetimer.h"
 #include "util/singleton.h"
 #include "waveform/renderers/allshader/waveformrenderersignalbase.h"
+#include "waveform/waveformframeratethrottle.h"
 #include "waveform/widgets/waveformwidgettype.h"
 #include "waveform/widgets/waveformwidgetvars.h"
 
@@ -122,6 +126,12 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
 
     void setFrameRate(int frameRate);
     int getFrameRate() const { return m_frameRate;}
+    /// If enabled, the frame rate is lowered temporarily while the audio
+    /// engine or the rendering is busy, see WaveformFrameRateThrottle
+    void setAdaptiveFrameRate(bool adaptive);
+    bool isAdaptiveFrameRate() const {
+        return m_adaptiveFrameRate;
+    }
 //    bool getVSync() const { return m_vSyncType;}
     void setEndOfTrackWarningTime(int endTime);
     int getEndOfTrackWarningTime() const { return m_endOfTrackWarningTime;}
@@ -227,6 +237,8 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
 
     friend class Singleton<WaveformWidgetFactory>;
 
+    bool event(QEvent* pEvent) override;
+
   private slots:
     void render();
     void swap();
@@ -235,6 +247,8 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
 
   private:
     void renderSelf();
+    void updateFrameRateThrottle(mixxx::Duration elapsed);
+    void applyFrameRate();
     void swapSelf();
 
     void addHandle(
@@ -266,6 +280,11 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
 
     bool m_skipRender;
     int m_frameRate;
+    bool m_adaptiveFrameRate;
+    WaveformFrameRateThrottle m_frameRateThrottle;
+    std::unique_ptr<PollingControlProxy> m_pAudioLatencyUsage;
+    // Time spent rendering since m_time has been started
+    mixxx::Duration m_renderTime;
     int m_endOfTrackWarningTime;
     double m_defaultZoom;
     bool m_zoomSync;
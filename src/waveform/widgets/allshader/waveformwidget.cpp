@@ -70,6 +70,7 @@ WaveformWidget::addWaveformSignalRenderer(WaveformWidgetType::Type type,
         switch (type) {
         case ::WaveformWidgetType::RGB:
         case ::WaveformWidgetType::Filtered:
+        case ::WaveformWidgetType::HSV:
         case ::WaveformWidgetType::Stacked:
             return addRenderer<WaveformRendererTextured>(type, positionSource, options);
         default:
@@ -159,6 +160,9 @@ WaveformRendererSignalBase::Options WaveformWidget::supportedOptions(
     case WaveformWidgetType::Type::Filtered:
         options = WaveformRendererSignalBase::Option::HighDetail;
         break;
+    case WaveformWidgetType::Type::HSV:
+        options = WaveformRendererSignalBase::Option::HighDetail;
+        break;
     case WaveformWidgetType::Type::Stacked:
         options = WaveformRendererSignalBase::Option::HighDetail;
         break;
@@ -11,6 +11,7 @@
 
 #include "util/math.h"
 #include "util/painterscope.h"
+#include "widget/svgrastercache.h"
 #include "widget/wpixmapstore.h"
 
 // static
@@ -61,17 +62,10 @@ Paintable::Paintable(const PixmapSource& source, DrawMode mode, double scaleFact
             }
             m_pPixmap = std::move(pPixmap);
     } else {
-        auto pSvg = std::make_unique<QSvgRenderer>();
         if (source.getPath().isEmpty()) {
                 return;
         }
 
-        if (!pSvg->load(source.getPath())) {
-                // The above line already logs a warning
-                return;
-        }
-
-        m_pSvg = std::move(pSvg);
 #ifdef __APPLE__
         // Apple does Retina scaling behind the scenes, so we also pass a
         // DrawMode::Fixed image. On the other targets, it is better to
@@ -85,17 +79,23 @@ Paintable::Paintable(const PixmapSource& source, DrawMode mode, double scaleFact
 #endif
             // The SVG renderer doesn't directly support tiling, so we render
             // it to a pixmap which will then get tiled.
-                QImage copy_buffer(m_pSvg->defaultSize() * scaleFactor,
-                        QImage::Format_ARGB32_Premultiplied);
-                // The constructor doesn't initialize the image with data,
-                // so we need to fill it before we can draw on it.
-                copy_buffer.fill(Qt::transparent);
-                QPainter painter(&copy_buffer);
-                m_pSvg->render(&painter);
-                WPixmapStore::correctImageColors(&copy_buffer);
-
-                m_pPixmap = std::make_unique<QPixmap>(QPixmap::fromImage(copy_buffer));
+            const QImage image = SvgRasterCache::render(source.getPath(),
+                    scaleFactor,
+                    WPixmapStore::colorSchemeKey(),
+                    &WPixmapStore::correctImageColors);
+            if (image.isNull()) {
+                return;
+            }
+            m_pPixmap = std::make_unique<QPixmap>(QPixmap::fromImage(image));
+            return;
+        }
+
+        auto pSvg = std::make_unique<QSvgRenderer>();
+        if (!pSvg->load(source.getPath())) {
+                // The above line already logs a warning
+                return;
         }
+        m_pSvg = std::move(pSvg);
     }
 }
 
@@ -0,0 +1,155 @@
+#include "widget/svgrastercache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QPainter>
+#include <QReadWriteLock>
+#include <QSaveFile>
+#include <QSvgRenderer>
+#include <cstring>
+
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SvgRasterCache");
+
+const QByteArray kMagic = QByteArrayLiteral("MXSR");
+// Increment when the rendering or the file format changes
+constexpr int kVersion = 1;
+
+QReadWriteLock s_directoryLock;
+QString s_directoryPath;
+
+QString directoryPath() {
+    QReadLocker locker(&s_directoryLock);
+    return s_directoryPath;
+}
+
+QByteArray calculateKey(
+        const QByteArray& svgData,
+        double scaleFactor,
+        const QString& colorSchemeKey) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(kVersion));
+    hash.addData(svgData);
+    hash.addData(QByteArray::number(scaleFactor, 'g', 17));
+    hash.addData(colorSchemeKey.toUtf8());
+    return hash.result();
+}
+
+QString cacheFilePath(const QString& dirPath, const QByteArray& key) {
+    return QDir(dirPath).filePath(QString::fromLatin1(key.toHex()));
+}
+
+/// The pixels are stored uncompressed, because decoding them would take
+/// about as long as rendering the SVG.
+QImage loadImage(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QImage();
+    }
+    QDataStream stream(&file);
+    QByteArray magic;
+    qint32 width;
+    qint32 height;
+    qint32 format;
+    QByteArray pixels;
+    stream >> magic >> width >> height >> format >> pixels;
+    if (stream.status() != QDataStream::Ok || magic != kMagic ||
+            format != QImage::Format_ARGB32_Premultiplied) {
+        return QImage();
+    }
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull() || image.sizeInBytes() != pixels.size()) {
+        kLogger.info() << "Ignoring invalid image" << filePath;
+        return QImage();
+    }
+    std::memcpy(image.bits(), pixels.constData(), pixels.size());
+    return image;
+}
+
+void storeImage(const QString& filePath, const QImage& image) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open"
+                << file.fileName()
+                << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream << kMagic
+           << static_cast<qint32>(image.width())
+           << static_cast<qint32>(image.height())
+           << static_cast<qint32>(image.format())
+           << QByteArray::fromRawData(reinterpret_cast<const char*>(image.constBits()),
+                      static_cast<int>(image.sizeInBytes()));
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write"
+                << file.fileName()
+                << file.errorString();
+    }
+}
+
+} // anonymous namespace
+
+// static
+void SvgRasterCache::setDirectory(const QString& dirPath) {
+    if (!dirPath.isEmpty() && !QDir().mkpath(dirPath)) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << dirPath;
+        return;
+    }
+    QWriteLocker locker(&s_directoryLock);
+    s_directoryPath = dirPath;
+}
+
+// static
+QImage SvgRasterCache::render(
+        const QString& svgFilePath,
+        double scaleFactor,
+        const QString& colorSchemeKey,
+        CorrectImageColors pCorrectColors) {
+    const QString dirPath = directoryPath();
+    QString filePath;
+    if (!dirPath.isEmpty()) {
+        QFile svgFile(svgFilePath);
+        if (svgFile.open(QIODevice::ReadOnly)) {
+            filePath = cacheFilePath(dirPath,
+                    calculateKey(svgFile.readAll(), scaleFactor, colorSchemeKey));
+            QImage image = loadImage(filePath);
+            if (!image.isNull()) {
+                return image;
+            }
+        }
+    }
+
+    QSvgRenderer renderer;
+    // Loading from the path resolves images that are referenced by the SVG
+    // relative to its directory.
+    if (!renderer.load(svgFilePath)) {
+        // The above line already logs a warning
+        return QImage();
+    }
+    QImage image(renderer.defaultSize() * scaleFactor,
+            QImage::Format_ARGB32_Premultiplied);
+    // The constructor doesn't initialize the image with data,
+    // so we need to fill it before we can draw on it.
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        renderer.render(&painter);
+    }
+    if (pCorrectColors) {
+        pCorrectColors(&image);
+    }
+    if (!filePath.isEmpty() && !image.isNull()) {
+        storeImage(filePath, image);
+    }
+    return image;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+/// SvgRasterCache persists the images that are rendered from the SVG files
+/// of a skin, because rendering them takes most of the time of loading a
+/// skin.
+///
+/// The cache entries are keyed by a hash of the content of the SVG file,
+/// the scale factor and the color scheme, so they don't need to be
+/// invalidated when a skin is updated or switched.
+///
+/// The cache is disabled until a directory has been set. All functions are
+/// thread-safe.
+class SvgRasterCache final {
+  public:
+    using CorrectImageColors = void (*)(QImage* pImage);
+
+    /// Enables the cache. An empty path disables it.
+    static void setDirectory(const QString& dirPath);
+
+    /// Renders the SVG file in its default size multiplied by scaleFactor,
+    /// unless it has been rendered before. pCorrectColors is applied to the
+    /// rendered image if not null, colorSchemeKey identifies the colors it
+    /// produces. Returns a null image if the file could not be rendered.
+    static QImage render(
+            const QString& svgFilePath,
+            double scaleFactor,
+            const QString& colorSchemeKey = QString(),
+            CorrectImageColors pCorrectColors = nullptr);
+};
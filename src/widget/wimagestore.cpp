@@ -1,10 +1,9 @@
 #include "widget/wimagestore.h"
 
 #include <QtDebug>
-#include <QSvgRenderer>
-#include <QPainter>
 
 #include "skin/legacy/imgloader.h"
+#include "widget/svgrastercache.h"
 
 // static
 QHash<ImageKey, std::weak_ptr<QImage>> WImageStore::m_dictionary;
@@ -57,23 +56,14 @@ std::shared_ptr<QImage> WImageStore::getImage(const PixmapSource& source, double
 // static
 QImage* WImageStore::getImageNoCache(const PixmapSource& source, double scaleFactor) {
     if (source.isSVG()) {
-        QSvgRenderer renderer;
-
-        if (!source.getPath().isEmpty()) {
-            if (!renderer.load(source.getPath())) {
-                // The above line already logs a warning
-                return nullptr;
-            }
-        } else {
+        if (source.getPath().isEmpty()) {
             return nullptr;
         }
-
-        auto* pImage = new QImage(renderer.defaultSize() * scaleFactor,
-                QImage::Format_ARGB32_Premultiplied);
-        pImage->fill(Qt::transparent);
-        QPainter painter(pImage);
-        renderer.render(&painter);
-        return pImage;
+        QImage image = SvgRasterCache::render(source.getPath(), scaleFactor);
+        if (image.isNull()) {
+            return nullptr;
+        }
+        return new QImage(std::move(image));
     } else {
         return m_loader->getImage(source.getPath(), scaleFactor);
     }
@@ -56,7 +56,11 @@ WOverview::WOverview(
           m_analyzerProgress(kAnalyzerProgressUnknown),
           m_trackLoaded(false),
           m_pHoveredMark(nullptr),
-          m_scaleFactor(1.0) {
+          m_scaleFactor(1.0),
+          m_dirtyColumnsBegin(0),
+          m_dirtyColumnsEnd(0),
+          m_marksLayersDirty(true),
+          m_marksLayersGain(0) {
     m_endOfTrackControl = make_parented<ControlProxy>(
             m_group, QStringLiteral("end_of_track"), this, ControlFlag::NoAssertIfMissing);
     m_endOfTrackControl->connectValueChanged(this, &WOverview::onEndOfTrackChange);
@@ -350,6 +354,7 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
     m_actualCompletion = 0;
     m_waveformPeak = -1.0;
     m_pixmapDone = false;
+    invalidateMarksLayers();
     // Note: Here we already have the new track, but the engine and it's
     // Control Objects may still have the old one until the slotTrackLoaded()
     // signal has been received.
@@ -391,11 +396,14 @@ void WOverview::onMarkChanged(double v) {
 void WOverview::onMarkRangeChange(double v) {
     Q_UNUSED(v);
     //qDebug() << "WOverview::onMarkRangeChange()" << v;
+    invalidateMarksLayers();
     update();
 }
 
 void WOverview::onRateRatioChange(double v) {
     Q_UNUSED(v);
+    // The durations of the mark ranges depend on the tempo
+    invalidateMarksLayers();
     update();
 }
 
@@ -459,6 +467,7 @@ void WOverview::updateCues(const QList<CuePointer> &loadedCues) {
     }
 
     m_marks.update();
+    invalidateMarksLayers();
 }
 
 // connecting the tracks cuesUpdated and onMarkChanged is not possible
@@ -644,11 +653,22 @@ void WOverview::paintEvent(QPaintEvent* pEvent) {
             const auto gain = static_cast<CSAMPLE_GAIN>(length() - 2) /
                     static_cast<CSAMPLE_GAIN>(trackSamples);
 
-            drawRangeMarks(&painter, offset, gain);
-            drawMarks(&painter, offset, gain);
-            drawPickupPosition(&painter);
-            drawTimeRuler(&painter);
-            drawMarkLabels(&painter, offset, gain);
+            if (canUseMarksLayers()) {
+                if (m_marksLayersDirty || m_marksLayersGain != gain) {
+                    renderMarksLayers(offset, gain);
+                }
+                painter.drawPixmap(0, 0, m_marksLayer);
+                drawPickupPosition(&painter);
+                painter.drawPixmap(0, 0, m_markLabelsLayer);
+            } else {
+                drawRangeMarks(&painter, offset, gain);
+                drawMarks(&painter, offset, gain);
+                drawPickupPosition(&painter);
+                drawTimeRuler(&painter);
+                drawMarkLabels(&painter, offset, gain);
+                // The labels have been prerendered for the hovered state
+                invalidateMarksLayers();
+            }
         }
     }
 
@@ -693,7 +713,8 @@ void WOverview::drawWaveformPixmap(QPainter* pPainter) {
             diffGain = 255.0f - (255.0f / visualGain);
         }
 
-        if (m_diffGain != diffGain || m_waveformImageScaled.isNull()) {
+        if (m_diffGain != diffGain || m_waveformImageScaled.isNull() ||
+                m_waveformImageScaled.size() != size() * m_devicePixelRatio) {
             QRect sourceRect(0,
                     static_cast<int>(diffGain),
                     m_waveformSourceImage.width(),
@@ -708,12 +729,69 @@ void WOverview::drawWaveformPixmap(QPainter* pPainter) {
                     Qt::IgnoreAspectRatio,
                     Qt::SmoothTransformation);
             m_diffGain = diffGain;
+            m_dirtyColumnsBegin = 0;
+            m_dirtyColumnsEnd = 0;
+        } else if (m_dirtyColumnsBegin < m_dirtyColumnsEnd) {
+            updateWaveformImageScaledColumns(diffGain);
         }
 
         pPainter->drawImage(rect(), m_waveformImageScaled);
     }
 }
 
+void WOverview::updateWaveformImageScaledColumns(float diffGain) {
+    ScopedTimer t(QStringLiteral("WOverview::updateWaveformImageScaledColumns"));
+    const int sourceLength = m_waveformSourceImage.width();
+    const int scaledLength = m_orientation == Qt::Horizontal
+            ? m_waveformImageScaled.width()
+            : m_waveformImageScaled.height();
+    const int scaledBreadth = m_orientation == Qt::Horizontal
+            ? m_waveformImageScaled.height()
+            : m_waveformImageScaled.width();
+    if (sourceLength <= 0 || scaledLength <= 0) {
+        return;
+    }
+    const double scaledPerSource = static_cast<double>(scaledLength) / sourceLength;
+
+    // Extend the range by one pixel on both sides, because the smooth
+    // transformation blends neighboring columns into each other
+    const int scaledBegin = math_max(0,
+            static_cast<int>(std::floor(m_dirtyColumnsBegin * scaledPerSource)) - 1);
+    const int scaledEnd = math_min(scaledLength,
+            static_cast<int>(std::ceil(m_dirtyColumnsEnd * scaledPerSource)) + 1);
+    m_dirtyColumnsBegin = 0;
+    m_dirtyColumnsEnd = 0;
+    if (scaledBegin >= scaledEnd) {
+        return;
+    }
+    const int sourceBegin = static_cast<int>(std::floor(scaledBegin / scaledPerSource));
+    const int sourceEnd = math_min(sourceLength,
+            static_cast<int>(std::ceil(scaledEnd / scaledPerSource)));
+
+    QRect sourceRect(sourceBegin,
+            static_cast<int>(diffGain),
+            sourceEnd - sourceBegin,
+            m_waveformSourceImage.height() - 2 * static_cast<int>(diffGain));
+    QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
+    QPoint scaledPos;
+    QSize scaledSize;
+    if (m_orientation == Qt::Vertical) {
+        croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
+        scaledPos = QPoint(0, scaledBegin);
+        scaledSize = QSize(scaledBreadth, scaledEnd - scaledBegin);
+    } else {
+        scaledPos = QPoint(scaledBegin, 0);
+        scaledSize = QSize(scaledEnd - scaledBegin, scaledBreadth);
+    }
+    const QImage scaledPart = croppedImage.scaled(scaledSize,
+            Qt::IgnoreAspectRatio,
+            Qt::SmoothTransformation);
+
+    QPainter painter(&m_waveformImageScaled);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(scaledPos, scaledPart);
+}
+
 void WOverview::drawMinuteMarkers(QPainter* pPainter) {
     if (!m_trackLoaded) {
         return;
@@ -1099,6 +1177,32 @@ void WOverview::drawMarks(QPainter* pPainter, const float offset, const float ga
     }
 }
 
+void WOverview::renderMarksLayers(const float offset, const float gain) {
+    ScopedTimer t(QStringLiteral("WOverview::renderMarksLayers"));
+    // The time ruler is inactive, so its labels must not hide mark labels
+    m_timeRulerPositionLabel.clear();
+    m_timeRulerDistanceLabel.clear();
+    m_marksLayer = QPixmap(size() * m_devicePixelRatio);
+    m_marksLayer.setDevicePixelRatio(m_devicePixelRatio);
+    m_marksLayer.fill(Qt::transparent);
+    m_markLabelsLayer = QPixmap(size() * m_devicePixelRatio);
+    m_markLabelsLayer.setDevicePixelRatio(m_devicePixelRatio);
+    m_markLabelsLayer.fill(Qt::transparent);
+    {
+        QPainter painter(&m_marksLayer);
+        painter.setFont(font());
+        drawRangeMarks(&painter, offset, gain);
+        drawMarks(&painter, offset, gain);
+    }
+    {
+        QPainter painter(&m_markLabelsLayer);
+        painter.setFont(font());
+        drawMarkLabels(&painter, offset, gain);
+    }
+    m_marksLayersDirty = false;
+    m_marksLayersGain = gain;
+}
+
 void WOverview::drawPickupPosition(QPainter* pPainter) {
     PainterScope painterScope(pPainter);
 
@@ -1314,6 +1418,8 @@ bool WOverview::drawNextPixmapPart() {
                 2 * 255,
                 QImage::Format_ARGB32_Premultiplied);
         m_waveformSourceImage.fill(QColor(0, 0, 0, 0).value());
+        // The scaled image still shows the previous track
+        m_waveformImageScaled = QImage();
         if (dataSize / 2 != m_waveformSourceImage.width()) {
             qWarning() << "Track duration has changed since last analysis"
                        << m_waveformSourceImage.width() << "!=" << dataSize / 2;
@@ -1340,6 +1446,17 @@ bool WOverview::drawNextPixmapPart() {
     //  << "waveformCompletion:" << waveformCompletion
     //  << "completionIncrement:" << completionIncrement;
 
+    // Only the columns that are drawn now need to be rescaled
+    const int firstDirtyColumn = m_actualCompletion / 2;
+    const int lastDirtyColumn = nextCompletion / 2 + 1;
+    if (m_dirtyColumnsBegin < m_dirtyColumnsEnd) {
+        m_dirtyColumnsBegin = math_min(m_dirtyColumnsBegin, firstDirtyColumn);
+        m_dirtyColumnsEnd = math_max(m_dirtyColumnsEnd, lastDirtyColumn);
+    } else {
+        m_dirtyColumnsBegin = firstDirtyColumn;
+        m_dirtyColumnsEnd = lastDirtyColumn;
+    }
+
     QPainter painter(&m_waveformSourceImage);
     painter.translate(0.0, static_cast<double>(m_waveformSourceImage.height()) / 2.0);
 
@@ -1351,9 +1468,6 @@ bool WOverview::drawNextPixmapPart() {
         drawNextPixmapPartRGB(&painter, pWaveform, nextCompletion);
     }
 
-    m_waveformImageScaled = QImage();
-    m_diffGain = 0;
-
     // Test if the complete waveform is done
     if (m_actualCompletion >= dataSize - 2) {
         m_pixmapDone = true;
@@ -1622,6 +1736,7 @@ void WOverview::resizeEvent(QResizeEvent* pEvent) {
 
     m_waveformImageScaled = QImage();
     m_diffGain = 0;
+    invalidateMarksLayers();
     Init();
 }
 
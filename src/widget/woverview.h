@@ -86,6 +86,9 @@ class WOverview : public WWidget, public TrackDropTarget {
     void drawEndOfTrackBackground(QPainter* pPainter);
     void drawAxis(QPainter* pPainter);
     void drawWaveformPixmap(QPainter* pPainter);
+    // Rescales only the columns of the source image that have been drawn
+    // since the scaled image was updated the last time
+    void updateWaveformImageScaledColumns(float diffGain);
     void drawMinuteMarkers(QPainter* pPainter);
     void drawPlayedOverlay(QPainter* pPainter);
     void drawPlayPosition(QPainter* pPainter);
@@ -96,6 +99,17 @@ class WOverview : public WWidget, public TrackDropTarget {
     void drawPickupPosition(QPainter* pPainter);
     void drawTimeRuler(QPainter* pPainter);
     void drawMarkLabels(QPainter* pPainter, const float offset, const float gain);
+    // Renders the marks and their labels into m_marksLayer and
+    // m_markLabelsLayer
+    void renderMarksLayers(const float offset, const float gain);
+    bool canUseMarksLayers() const {
+        // While hovering or dragging the labels depend on the mouse
+        // position and the play position, so they are drawn directly
+        return m_pHoveredMark == nullptr && !m_bTimeRulerActive;
+    }
+    void invalidateMarksLayers() {
+        m_marksLayersDirty = true;
+    }
     void drawPassthroughOverlay(QPainter* pPainter);
     void paintText(const QString& text, QPainter* pPainter);
     double samplePositionToSeconds(double sample);
@@ -173,6 +187,18 @@ class WOverview : public WWidget, public TrackDropTarget {
 
     QImage m_waveformSourceImage;
     QImage m_waveformImageScaled;
+    // The range of columns in m_waveformSourceImage that have been drawn
+    // but not yet rescaled into m_waveformImageScaled
+    int m_dirtyColumnsBegin;
+    int m_dirtyColumnsEnd;
+
+    // The marks are drawn below the play position and the labels above it.
+    // Both only change on cue edits, so they are cached while the play
+    // position moves.
+    QPixmap m_marksLayer;
+    QPixmap m_markLabelsLayer;
+    bool m_marksLayersDirty;
+    float m_marksLayersGain;
 
     WaveformSignalColors m_signalColors;
 
@@ -6,6 +6,7 @@
 // static
 QHash<PixmapKey, WeakPaintablePointer> WPixmapStore::m_paintableCache;
 std::shared_ptr<ImgSource> WPixmapStore::m_loader = std::make_shared<ImgLoader>();
+QString WPixmapStore::m_colorSchemeKey;
 
 // static
 PaintablePointer WPixmapStore::getPaintable(const PixmapSource& source,
@@ -49,8 +50,9 @@ bool WPixmapStore::willCorrectColors() {
     return m_loader->willCorrectColors();
 }
 
-void WPixmapStore::setLoader(std::shared_ptr<ImgSource> ld) {
+void WPixmapStore::setLoader(std::shared_ptr<ImgSource> ld, const QString& colorSchemeKey) {
     m_loader = ld;
+    m_colorSchemeKey = colorSchemeKey;
 
     // We shouldn't hand out pointers to existing pixmaps anymore since our
     // loader has changed. The pixmaps will get freed once all the widgets
@@ -42,11 +42,18 @@ class WPixmapStore {
     static std::unique_ptr<QPixmap> getPixmapNoCache(
             const QString& fileName,
             double scaleFactor);
-    static void setLoader(std::shared_ptr<ImgSource> ld);
+    /// colorSchemeKey identifies the colors corrected by the loader in
+    /// the SvgRasterCache
+    static void setLoader(std::shared_ptr<ImgSource> ld,
+            const QString& colorSchemeKey = QString());
     static void correctImageColors(QImage* p);
     static bool willCorrectColors();
+    static const QString& colorSchemeKey() {
+        return m_colorSchemeKey;
+    }
 
   private:
     static QHash<PixmapKey, WeakPaintablePointer> m_paintableCache;
     static std::shared_ptr<ImgSource> m_loader;
+    static QString m_colorSchemeKey;
 };
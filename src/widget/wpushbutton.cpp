@@ -12,6 +12,7 @@
 #include "control/controlpushbutton.h"
 #include "moc_wpushbutton.cpp"
 #include "util/debug.h"
+#include "waveform/guiframescheduler.h"
 #include "widget/controlwidgetconnection.h"
 #include "widget/wpixmapstore.h"
 
@@ -551,13 +552,14 @@ void WPushButton::updateSlot() {
 }
 
 WPushButton::LongPressLatching::LongPressLatching(WPushButton* pButton)
-        : m_pButton(pButton) {
+        : m_pButton(pButton),
+          m_animating(false) {
     // To animate the long press latching
     connect(&m_animTimer, &QTimer::timeout, m_pButton, &WPushButton::updateSlot);
 }
 
 void WPushButton::LongPressLatching::paint(QPainter* p) {
-    if (m_animTimer.isActive()) {
+    if (m_animating) {
         // Animate the long press latching by capturing the off state in a pixmap
         // and gradually draw less of it over the duration of the long press latching.
 
@@ -567,7 +569,7 @@ void WPushButton::LongPressLatching::paint(QPainter* p) {
                                 m_sinceStart.elapsed().toIntegerMillis()));
 
         if (remainingTime == 0) {
-            m_animTimer.stop();
+            stop();
         } else {
             qreal x = m_pButton->width() * static_cast<qreal>(remainingTime) /
                     static_cast<qreal>(ControlPushButtonBehavior::
@@ -583,7 +585,7 @@ void WPushButton::LongPressLatching::paint(QPainter* p) {
 }
 
 void WPushButton::LongPressLatching::start() {
-    if (m_animTimer.isActive()) {
+    if (m_animating) {
         // already running
         return;
     }
@@ -596,9 +598,24 @@ void WPushButton::LongPressLatching::start() {
     m_pButton->paintOnDevice(&m_preLongPressPixmap, 0);
     // ... and start the long press latching animation
     m_sinceStart.start();
-    m_animTimer.start(1000 / 60);
+    m_animating = true;
+    if (GuiFrameScheduler::isActive()) {
+        // Repaint with every GUI frame
+        WPushButton* pButton = m_pButton;
+        GuiFrameScheduler::add(pButton,
+                GuiFrameScheduler::Rate::EveryFrame,
+                [pButton](double) { pButton->update(); });
+    } else {
+        m_animTimer.start(1000 / 60);
+    }
 }
 
 void WPushButton::LongPressLatching::stop() {
+    if (!m_animating) {
+        return;
+    }
+    m_animating = false;
     m_animTimer.stop();
+    // The button has no other callbacks
+    GuiFrameScheduler::remove(m_pButton);
 }
@@ -130,6 +130,8 @@ class WPushButton : public WWidget {
         WPushButton* m_pButton;
         QPixmap m_preLongPressPixmap;
         PerformanceTimer m_sinceStart;
+        bool m_animating;
+        // Only used if there is no GuiFrameScheduler
         QTimer m_animTimer;
     };
 
@@ -59,6 +59,8 @@ WSpinnyBase::WSpinnyBase(
           m_dRotationsPerSecond(MIXXX_VINYL_SPEED_33_NUM / 60),
           m_bClampFailedWarning(false),
           m_bGhostPlayback(false),
+          m_bRedrawNeeded(true),
+          m_bSwapNeeded(false),
           m_pPlayer(pPlayer),
           m_pCoverMenu(new WCoverArtMenu(this)),
           m_pDlgCoverArt(new DlgCoverArtFullSize(this, pPlayer, m_pCoverMenu)) {
@@ -128,6 +130,7 @@ void WSpinnyBase::onVinylSignalQualityUpdate(const VinylSignalQualityReport& rep
 
     updateVinylSignalQualityImage(qual_color, report.scope);
     m_bDrawVinylSignalQuality = true;
+    invalidateRendering();
 #else
     Q_UNUSED(report);
 #endif
@@ -172,6 +175,7 @@ void WSpinnyBase::setup(const QDomNode& node,
                 this,
                 [this](double v) {
                     m_bShowCover = v > 0.0;
+                    invalidateRendering();
                 });
         m_bShowCover = m_pShowCoverProxy->get() > 0.0;
     } else {
@@ -237,6 +241,7 @@ void WSpinnyBase::setup(const QDomNode& node,
 void WSpinnyBase::setLoadedCover(const QPixmap& pixmap) {
     m_loadedCover = pixmap;
     m_loadedCoverScaled = scaleToSize(pixmap);
+    invalidateRendering();
 }
 
 void WSpinnyBase::slotLoadTrack(TrackPointer pTrack) {
@@ -316,6 +321,8 @@ void WSpinnyBase::paintEvent(QPaintEvent* e) {
 
 void WSpinnyBase::render(VSyncThread* vSyncThread) {
     if (!shouldRender()) {
+        // Draw again as soon as the widget is exposed
+        invalidateRendering();
         return;
     }
 
@@ -327,22 +334,39 @@ void WSpinnyBase::render(VSyncThread* vSyncThread) {
     }
 
     if (m_dAngleCurrentPlaypos != m_dAngleLastPlaypos) {
-        m_fAngle = static_cast<float>(calculateAngle(m_dAngleCurrentPlaypos));
+        const auto angle = static_cast<float>(calculateAngle(m_dAngleCurrentPlaypos));
+        if (angle != m_fAngle) {
+            m_fAngle = angle;
+            invalidateRendering();
+        }
         m_dAngleLastPlaypos = m_dAngleCurrentPlaypos;
     }
 
     if (m_dGhostAngleCurrentPlaypos != m_dGhostAngleLastPlaypos) {
-        m_fGhostAngle = static_cast<float>(calculateAngle(m_dGhostAngleCurrentPlaypos));
+        const auto ghostAngle = static_cast<float>(
+                calculateAngle(m_dGhostAngleCurrentPlaypos));
+        if (ghostAngle != m_fGhostAngle) {
+            m_fGhostAngle = ghostAngle;
+            if (m_bGhostPlayback) {
+                invalidateRendering();
+            }
+        }
         m_dGhostAngleLastPlaypos = m_dGhostAngleCurrentPlaypos;
     }
 
+    if (!m_bRedrawNeeded) {
+        return;
+    }
+    m_bRedrawNeeded = false;
+    m_bSwapNeeded = true;
     draw();
 }
 
 void WSpinnyBase::swap() {
-    if (!shouldRender()) {
+    if (!shouldRender() || !m_bSwapNeeded) {
         return;
     }
+    m_bSwapNeeded = false;
     makeCurrentIfNeeded();
     swapBuffers();
     doneCurrent();
@@ -378,6 +402,7 @@ void WSpinnyBase::resizeEvent(QResizeEvent* event) {
     m_loadedCoverScaled = scaleToSize(m_loadedCover);
     m_fgImageScaled = scaleToSize(m_pFgImage);
     m_ghostImageScaled = scaleToSize(m_pGhostImage);
+    invalidateRendering();
 
     WGLWidget::resizeEvent(event);
 }
@@ -487,6 +512,7 @@ void WSpinnyBase::updateVinylControlSignalEnabled(double enabled) {
         m_pVCManager->removeSignalQualityListener(this);
         m_bDrawVinylSignalQuality = false;
     }
+    invalidateRendering();
 #else
     Q_UNUSED(enabled);
 #endif
@@ -494,10 +520,12 @@ void WSpinnyBase::updateVinylControlSignalEnabled(double enabled) {
 
 void WSpinnyBase::updateVinylControlEnabled(double enabled) {
     m_bVinylActive = enabled != 0;
+    invalidateRendering();
 }
 
 void WSpinnyBase::updateSlipEnabled(double enabled) {
     m_bGhostPlayback = static_cast<bool>(enabled);
+    invalidateRendering();
 }
 
 void WSpinnyBase::mouseMoveEvent(QMouseEvent* e) {
@@ -623,6 +651,7 @@ void WSpinnyBase::mouseReleaseEvent(QMouseEvent* e) {
 
 void WSpinnyBase::showEvent(QShowEvent* event) {
     Q_UNUSED(event);
+    invalidateRendering();
     WGLWidget::showEvent(event);
 #ifdef __VINYLCONTROL__
     // If we want to draw the VC signal on this widget then register for
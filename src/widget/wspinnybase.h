@@ -88,6 +88,12 @@ class WSpinnyBase : public WGLWidget,
 
     bool shouldDrawVinylQuality() const;
 
+    /// Requests that the widget is drawn with the next render() call,
+    /// even if the rotation has not changed
+    void invalidateRendering() {
+        m_bRedrawNeeded = true;
+    }
+
   private:
     virtual void draw() = 0;
     virtual void coverChanged() = 0;
@@ -147,6 +153,10 @@ class WSpinnyBase : public WGLWidget,
     double m_dRotationsPerSecond;
     bool m_bClampFailedWarning;
     bool m_bGhostPlayback;
+    // A paused deck shows the same image in every frame, so drawing and
+    // swapping is skipped until something visible has changed
+    bool m_bRedrawNeeded;
+    bool m_bSwapNeeded;
 
     BaseTrackPlayer* m_pPlayer;
     WCoverArtMenu* m_pCoverMenu;
@@ -6,6 +6,7 @@
 
 #include "moc_wtime.cpp"
 #include "skin/legacy/skincontext.h"
+#include "waveform/guiframescheduler.h"
 
 WTime::WTime(QWidget* parent)
         : WLabel(parent),
@@ -21,8 +22,17 @@ WTime::~WTime() {
 void WTime::setup(const QDomNode& node, const SkinContext& context) {
     WLabel::setup(node, context);
     setTimeFormat(node, context);
-    m_pTimer->start(m_interval);
-    connect(m_pTimer, &QTimer::timeout, this, &WTime::refreshTime);
+    if (GuiFrameScheduler::isActive()) {
+        // Refresh within the GUI frames instead of waking up in between
+        GuiFrameScheduler::add(this,
+                m_interval == s_iSecondInterval
+                        ? GuiFrameScheduler::Rate::Every50ms
+                        : GuiFrameScheduler::Rate::Every1s,
+                [this](double) { refreshTime(); });
+    } else {
+        m_pTimer->start(m_interval);
+        connect(m_pTimer, &QTimer::timeout, this, &WTime::refreshTime);
+    }
     refreshTime();
 }
 
@@ -27,13 +27,14 @@
 #include "library/trackprocessing.h"
 #include "library/trackset/crate/crate.h"
 #include "library/trackset/crate/cratefeaturehelper.h"
-#include "library/trackset/crate/cratesummary.h"
+#include "library/trackset/crate/cratestorage.h"
 #include "mixer/playerinfo.h"
 #include "mixer/playermanager.h"
 #include "moc_wtrackmenu.cpp"
 #include "preferences/colorpalettesettings.h"
 #include "preferences/configobject.h"
 #include "preferences/dialog/dlgprefdeck.h"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/defs.h"
@@ -1294,6 +1295,11 @@ class ImportMetadataFromFileTagsTrackPointerOperation : public mixxx::TrackPoint
             : m_params(SyncTrackMetadataParams::readFromUserSettings(userSettings)) {
     }
 
+    // Parsing the file tags dominates and is done in parallel
+    bool isThreadSafe() const override {
+        return true;
+    }
+
   private:
     void doApply(
             const TrackPointer& pTrack) const override {
@@ -1480,13 +1486,11 @@ void WTrackMenu::slotPopulateCrateMenu() {
     m_pCrateMenu->clear();
     const TrackIdList trackIds = getTrackIds();
 
-    CrateSummarySelectResult allCrates(
-            m_pLibrary->trackCollectionManager()
-                    ->internalCollection()
-                    ->crates()
-                    .selectCratesWithTrackCount(trackIds));
+    const CrateStorage& crateStorage =
+            m_pLibrary->trackCollectionManager()->internalCollection()->crates();
+    CrateSelectResult allCrates(crateStorage.selectCrates());
 
-    CrateSummary crate;
+    Crate crate;
     while (allCrates.populateNext(&crate)) {
         auto pAction = make_parented<QWidgetAction>(
                 m_pCrateMenu);
@@ -1512,9 +1516,11 @@ void WTrackMenu::slotPopulateCrateMenu() {
         pAction->setEnabled(!crate.isLocked());
         pAction->setDefaultWidget(pCheckBox.get());
 
-        if (crate.getTrackCount() == 0) {
+        // The memberships are looked up in the in-memory index
+        const uint trackCount = crateStorage.countCrateTracks(crate.getId(), trackIds);
+        if (trackCount == 0) {
             pCheckBox->setChecked(false);
-        } else if (crate.getTrackCount() == (uint)trackIds.length()) {
+        } else if (trackCount == (uint)trackIds.length()) {
             pCheckBox->setChecked(true);
         } else {
             pCheckBox->setTristate(true);
@@ -2228,6 +2234,8 @@ class RemoveTrackFilesFromDiskTrackPointerOperation : public mixxx::TrackPointer
             return;
         }
         QString location = pTrack->getLocation();
+        // Release the file handles of decoders that are kept for reuse
+        mixxx::SoundSourcePool::evict(location);
         QFile file(location);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
         if (file.exists() && !file.moveToTrash()) {
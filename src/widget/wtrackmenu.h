@@ -202,7 +202,7 @@ class WTrackMenu : public QMenu {
             const QString& progressLabelText,
             const mixxx::TrackPointerOperation* pTrackPointerOperation,
             mixxx::ModalTrackBatchOperationProcessor::Mode operationMode =
-                    mixxx::ModalTrackBatchOperationProcessor::Mode::Apply) const;
+                    mixxx::ModalTrackBatchOperationProcessor::Mode::ApplyAndSave) const;
 
     bool isEmpty() const {
         return getTrackCount() == 0;
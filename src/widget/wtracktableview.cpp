@@ -7,6 +7,7 @@
 #include <QUrl>
 
 #include "control/controlobject.h"
+#include "engine/cachingreader/cachingreaderprimecache.h"
 #include "library/dao/trackschema.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
@@ -88,7 +89,7 @@ WTrackTableView::~WTrackTableView() {
 void WTrackTableView::enableCachedOnly() {
     if (!m_loadCachedOnly) {
         // don't try to load and search covers, drawing only
-        // covers which are already in the QPixmapCache.
+        // covers which are already in the CoverArtCache.
         emit onlyCachedCoverArt(true);
         m_loadCachedOnly = true;
     }
@@ -137,6 +138,7 @@ void WTrackTableView::slotGuiTick50ms(double /*unused*/) {
                     TrackPointer pTrack = trackModel->getTrack(indices.first());
                     if (pTrack) {
                         emit trackSelected(pTrack);
+                        prefetchPreviews(indices.first(), pTrack);
                     }
                 }
             } else {
@@ -153,6 +155,30 @@ void WTrackTableView::slotGuiTick50ms(double /*unused*/) {
     }
 }
 
+void WTrackTableView::prefetchPreviews(
+        const QModelIndex& index, const TrackPointer& pTrack) {
+    if (PlayerManager::numPreviewDecks() == 0 ||
+            !m_pConfig->getValue(mixxx::library::prefs::kPreviewPrefetchConfigKey,
+                    mixxx::library::prefs::kPreviewPrefetchDefault)) {
+        return;
+    }
+    // Preview decks are no primary decks and always play stereo
+    const auto channelCount = mixxx::audio::ChannelCount::stereo();
+    CachingReaderPrimeCache::instance().prefetch(pTrack, channelCount);
+    // The neighbors are previewed next when browsing with the arrow keys
+    TrackModel* pTrackModel = getTrackModel();
+    for (const int row : {index.row() - 1, index.row() + 1}) {
+        const QModelIndex neighborIndex = index.sibling(row, index.column());
+        if (!neighborIndex.isValid()) {
+            continue;
+        }
+        const TrackPointer pNeighborTrack = pTrackModel->getTrack(neighborIndex);
+        if (pNeighborTrack) {
+            CachingReaderPrimeCache::instance().prefetch(pNeighborTrack, channelCount);
+        }
+    }
+}
+
 // slot
 void WTrackTableView::pasteFromSidebar() {
     pasteTracks(QModelIndex());
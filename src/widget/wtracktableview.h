@@ -142,6 +142,9 @@ class WTrackTableView : public WLibraryTableView {
     void dropEvent(QDropEvent * event) override;
 
     void enableCachedOnly();
+    // Decodes the start of the selected track and its neighbors in the
+    // background, so previewing them starts instantly.
+    void prefetchPreviews(const QModelIndex& index, const TrackPointer& pTrack);
     void selectionChanged(const QItemSelection &selected,
                           const QItemSelection &deselected) override;
 
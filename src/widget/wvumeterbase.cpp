@@ -139,6 +139,17 @@ void WVuMeterBase::setPeak(double parameter) {
     }
 }
 
+int WVuMeterBase::devicePixelPosition(double parameter) const {
+    const int length = m_bHorizontal ? width() : height();
+    return static_cast<int>(std::lround(parameter * length * devicePixelRatioF()));
+}
+
+bool WVuMeterBase::isChangeVisible() const {
+    return devicePixelPosition(m_dParameter) != devicePixelPosition(m_dLastParameter) ||
+            devicePixelPosition(m_dPeakParameter) !=
+            devicePixelPosition(m_dLastPeakParameter);
+}
+
 void WVuMeterBase::updateState(mixxx::Duration elapsed) {
     double msecsElapsed = elapsed.toDoubleMillis();
     // If we're holding at a peak then don't update anything
@@ -185,7 +196,7 @@ void WVuMeterBase::render(VSyncThread* vSyncThread) {
 
     updateState(vSyncThread->sinceLastSwap());
 
-    if (m_dParameter != m_dLastParameter || m_dPeakParameter != m_dLastPeakParameter) {
+    if (isChangeVisible()) {
         m_iPendingRenders = 2;
     }
 
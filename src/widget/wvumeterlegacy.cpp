@@ -127,6 +127,17 @@ void WVuMeterLegacy::setPeak(double parameter) {
     }
 }
 
+int WVuMeterLegacy::devicePixelPosition(double parameter) const {
+    const int length = m_bHorizontal ? width() : height();
+    return static_cast<int>(std::lround(parameter * length * devicePixelRatioF()));
+}
+
+bool WVuMeterLegacy::isChangeVisible() const {
+    return devicePixelPosition(m_dParameter) != devicePixelPosition(m_dLastParameter) ||
+            devicePixelPosition(m_dPeakParameter) !=
+            devicePixelPosition(m_dLastPeakParameter);
+}
+
 void WVuMeterLegacy::updateState(mixxx::Duration elapsed) {
     double msecsElapsed = elapsed.toDoubleMillis();
     // If we're holding at a peak then don't update anything
@@ -147,8 +158,10 @@ void WVuMeterLegacy::updateState(mixxx::Duration elapsed) {
 }
 
 void WVuMeterLegacy::maybeUpdate() {
-    if (m_dParameter != m_dLastParameter || m_dPeakParameter != m_dLastPeakParameter) {
-        repaint();
+    if (isChangeVisible()) {
+        // Instead of painting each meter immediately with repaint(), all
+        // meters that have changed are painted within a single pass
+        update();
     }
 }
 
@@ -34,6 +34,11 @@ class WVuMeterLegacy : public WWidget {
     void paintEvent(QPaintEvent* /*unused*/) override;
     void showEvent(QShowEvent* /*unused*/) override;
     void setPeak(double parameter);
+    /// The position of the parameter along the meter in device pixels
+    int devicePixelPosition(double parameter) const;
+    /// True if the meter or the peak has moved by at least a device pixel
+    /// since the last rendering. Smaller changes are not visible.
+    bool isChangeVisible() const;
 
     // Current parameter and peak parameter.
     double m_dParameter;
@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Compares the results of the Mixxx benchmarks with a stored baseline.
+
+The results are written by the mixxx-benchmark-json target, i.e. by
+`mixxx-test --benchmark --benchmark_out=<file> --benchmark_out_format=json`.
+They are converted into a stable schema that only contains the name, the
+times in nanoseconds and the user counters of each benchmark, so that
+baselines do not change with the version of Google Benchmark:
+
+    {
+        "schema_version": 1,
+        "context": {"host_name": ..., "num_cpus": ..., ...},
+        "benchmarks": {
+            "<name>": {
+                "real_time_ns": <float>,
+                "cpu_time_ns": <float>,
+                "counters": {"<counter>": <float>, ...}
+            }
+        }
+    }
+
+If the benchmarks have been run with repetitions, the median is used.
+
+The baseline file has the same schema plus the tolerances. The metric of a
+benchmark is either "real_time_ns", "cpu_time_ns" or one of its counters. A
+regression is reported if the metric exceeds the baseline by more than the
+tolerance, given as a fraction of the baseline. The first matching entry of
+"rules" (fnmatch patterns) applies, otherwise the defaults:
+
+    "tolerances": {
+        "default": {"metric": "real_time_ns", "tolerance": 0.1},
+        "rules": [
+            {"pattern": "BM_EngineMixer*", "metric": "p99_ns",
+             "tolerance": 0.15},
+            ...
+        ]
+    }
+
+Usage:
+    benchmark_compare.py export RESULTS [-o OUTPUT]
+    benchmark_compare.py compare RESULTS BASELINE
+    benchmark_compare.py update RESULTS BASELINE [--filter PATTERN]
+
+"compare" exits with status 1 if any benchmark has regressed. "update"
+stores the results as the new baseline values and keeps the tolerances.
+"""
+import argparse
+import fnmatch
+import json
+import sys
+
+SCHEMA_VERSION = 1
+
+TIME_UNIT_NANOS = {
+    "ns": 1.0,
+    "us": 1e3,
+    "ms": 1e6,
+    "s": 1e9,
+}
+
+# Keys of a Google Benchmark run that are not user counters
+RUN_KEYS = {
+    "name",
+    "family_index",
+    "per_family_instance_index",
+    "run_name",
+    "run_type",
+    "repetitions",
+    "repetition_index",
+    "threads",
+    "iterations",
+    "real_time",
+    "cpu_time",
+    "time_unit",
+    "aggregate_name",
+    "aggregate_unit",
+    "error_occurred",
+    "error_message",
+    "label",
+}
+
+CONTEXT_KEYS = [
+    "host_name",
+    "executable",
+    "num_cpus",
+    "mhz_per_cpu",
+    "cpu_scaling_enabled",
+    "library_build_type",
+]
+
+DEFAULT_TOLERANCE = {"metric": "real_time_ns", "tolerance": 0.1}
+
+
+def convert_run(run):
+    scale = TIME_UNIT_NANOS[run.get("time_unit", "ns")]
+    return {
+        "real_time_ns": run["real_time"] * scale,
+        "cpu_time_ns": run["cpu_time"] * scale,
+        "counters": {
+            key: value
+            for key, value in run.items()
+            if key not in RUN_KEYS and isinstance(value, (int, float))
+        },
+    }
+
+
+def convert_results(raw):
+    """Converts the output of Google Benchmark into the stable schema"""
+    if "schema_version" in raw:
+        return raw
+    benchmarks = {}
+    medians = {}
+    for run in raw.get("benchmarks", []):
+        if run.get("error_occurred"):
+            continue
+        name = run.get("run_name", run["name"])
+        if run.get("run_type") == "aggregate":
+            if run.get("aggregate_name") == "median":
+                medians[name] = convert_run(run)
+        elif name not in benchmarks:
+            benchmarks[name] = convert_run(run)
+    benchmarks.update(medians)
+    context = raw.get("context", {})
+    return {
+        "schema_version": SCHEMA_VERSION,
+        "context": {
+            key: context[key] for key in CONTEXT_KEYS if key in context
+        },
+        "benchmarks": dict(sorted(benchmarks.items())),
+    }
+
+
+def load_results(filename):
+    with open(filename, encoding="utf-8") as f:
+        results = convert_results(json.load(f))
+    if results["schema_version"] != SCHEMA_VERSION:
+        raise ValueError(
+            "{}: unsupported schema version {}".format(
+                filename, results["schema_version"]
+            )
+        )
+    return results
+
+
+def write_json(data, filename):
+    if filename == "-":
+        json.dump(data, sys.stdout, indent=4)
+        sys.stdout.write("\n")
+        return
+    with open(filename, "w", encoding="utf-8") as f:
+        json.dump(data, f, indent=4)
+        f.write("\n")
+
+
+def tolerance_for(name, tolerances):
+    default = dict(DEFAULT_TOLERANCE)
+    default.update(tolerances.get("default", {}))
+    for rule in tolerances.get("rules", []):
+        if fnmatch.fnmatchcase(name, rule["pattern"]):
+            result = dict(default)
+            result.update(rule)
+            return result
+    return default
+
+
+def metric_value(benchmark, metric):
+    if metric in ("real_time_ns", "cpu_time_ns"):
+        return benchmark[metric]
+    return benchmark["counters"].get(metric)
+
+
+def compare(results, baseline):
+    """Returns the number of regressions and prints a report"""
+    regressions = 0
+    tolerances = baseline.get("tolerances", {})
+    current = results["benchmarks"]
+    for name, reference in sorted(baseline["benchmarks"].items()):
+        rule = tolerance_for(name, tolerances)
+        metric = rule["metric"]
+        if name not in current:
+            print("MISSING  {}".format(name))
+            continue
+        reference_value = metric_value(reference, metric)
+        value = metric_value(current[name], metric)
+        if reference_value is None or value is None:
+            print("MISSING  {} ({})".format(name, metric))
+            continue
+        if reference_value <= 0:
+            continue
+        change = value / reference_value - 1.0
+        if change > rule["tolerance"]:
+            status = "REGRESS"
+            regressions += 1
+        elif change < -rule["tolerance"]:
+            status = "IMPROVE"
+        else:
+            status = "OK"
+        print(
+            "{:8} {} {}: {:.6g} -> {:.6g} ({:+.1%}, tolerance {:.0%})".format(
+                status,
+                name,
+                metric,
+                reference_value,
+                value,
+                change,
+                rule["tolerance"],
+            )
+        )
+    for name in sorted(set(current) - set(baseline["benchmarks"])):
+        print("NEW      {}".format(name))
+    return regressions
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+    )
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    export_parser = subparsers.add_parser(
+        "export", help="Convert results into the stable schema"
+    )
+    export_parser.add_argument("results")
+    export_parser.add_argument("-o", "--output", default="-")
+
+    compare_parser = subparsers.add_parser(
+        "compare", help="Report regressions against the baseline"
+    )
+    compare_parser.add_argument("results")
+    compare_parser.add_argument("baseline")
+
+    update_parser = subparsers.add_parser(
+        "update", help="Store the results as the new baseline values"
+    )
+    update_parser.add_argument("results")
+    update_parser.add_argument("baseline")
+    update_parser.add_argument(
+        "--filter",
+        default="*",
+        help="Only update the benchmarks that match this pattern",
+    )
+
+    args = parser.parse_args(argv)
+    results = load_results(args.results)
+
+    if args.command == "export":
+        write_json(results, args.output)
+        return 0
+
+    with open(args.baseline, encoding="utf-8") as f:
+        baseline = json.load(f)
+
+    if args.command == "compare":
+        regressions = compare(results, baseline)
+        if regressions:
+            print("{} benchmark(s) regressed".format(regressions))
+            return 1
+        return 0
+
+    baseline["schema_version"] = SCHEMA_VERSION
+    baseline["context"] = results["context"]
+    benchmarks = baseline.get("benchmarks", {})
+    for name, benchmark in results["benchmarks"].items():
+        if fnmatch.fnmatchcase(name, args.filter):
+            benchmarks[name] = benchmark
+    baseline["benchmarks"] = dict(sorted(benchmarks.items()))
+    write_json(baseline, args.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())